@@ -0,0 +1,296 @@
+<#
+
+.SYNOPSIS
+This script runs a matrix of secnetperf scenarios several times each, and
+compares the results against a stored baseline, failing if any of them
+regressed by a statistically significant amount.
+
+.DESCRIPTION
+Each combination of scenario, execution profile and IO mode is run Runs times,
+with the client writing its results with -json. The samples of every metric
+are compared against the baseline's with Welch's t-test; a metric regressed if
+the difference is significant (95% confidence) AND worse than Threshold. The
+95% confidence interval of each difference is printed, so noisy metrics (whose
+intervals are wide) stand out even when they don't fail the run.
+
+Without a Target, a server is started locally for each combination, except for
+the loopback IO mode, where secnetperf runs its server in-process.
+
+.PARAMETER SecNetPerfPath
+    Specifies the secnetperf binary to use.
+
+.PARAMETER Target
+    The remote server to run against. It must already be running secnetperf
+    with the matching options. If not set, a server is started locally.
+
+.PARAMETER Scenarios
+    The scenario profiles to run.
+
+.PARAMETER ExecProfiles
+    The execution profiles to run each scenario with.
+
+.PARAMETER IoModes
+    The IO modes to run each scenario with.
+
+.PARAMETER Runs
+    The number of times each combination is run.
+
+.PARAMETER BaselineFile
+    The baseline results to compare against.
+
+.PARAMETER OutputFile
+    Where to write this run's results, in the baseline file's format.
+
+.PARAMETER UpdateBaseline
+    Writes this run's results to BaselineFile instead of comparing them.
+
+.PARAMETER Threshold
+    The relative change (in percent) a significant difference must exceed to
+    be a regression.
+
+.PARAMETER ExtraArgs
+    Additional arguments passed to both the client and the server.
+
+.EXAMPLE
+    perf-regression.ps1 -SecNetPerfPath ./artifacts/bin/linux/x64_Release_openssl/secnetperf -IoModes loopback -UpdateBaseline
+
+.EXAMPLE
+    perf-regression.ps1 -SecNetPerfPath ./artifacts/bin/linux/x64_Release_openssl/secnetperf -IoModes loopback
+
+#>
+
+param (
+    [Parameter(Mandatory = $true)]
+    [string]$SecNetPerfPath,
+
+    [Parameter(Mandatory = $false)]
+    [string]$Target = "",
+
+    [Parameter(Mandatory = $false)]
+    [ValidateSet("upload", "download", "hps", "rps", "rps-multi", "latency")]
+    [string[]]$Scenarios = @("upload", "download", "hps", "rps", "latency"),
+
+    [Parameter(Mandatory = $false)]
+    [ValidateSet("lowlat", "maxtput", "scavenger", "realtime")]
+    [string[]]$ExecProfiles = @("maxtput", "lowlat"),
+
+    [Parameter(Mandatory = $false)]
+    [ValidateSet("iocp", "rio", "xdp", "qtip", "epoll", "iouring", "kqueue", "loopback")]
+    [string[]]$IoModes = @("loopback"),
+
+    [Parameter(Mandatory = $false)]
+    [ValidateRange(2, 100)]
+    [Int32]$Runs = 5,
+
+    [Parameter(Mandatory = $false)]
+    [string]$BaselineFile = "perf-baseline.json",
+
+    [Parameter(Mandatory = $false)]
+    [string]$OutputFile = "perf-results.json",
+
+    [Parameter(Mandatory = $false)]
+    [switch]$UpdateBaseline = $false,
+
+    [Parameter(Mandatory = $false)]
+    [double]$Threshold = 2.0,
+
+    [Parameter(Mandatory = $false)]
+    [string]$ExtraArgs = ""
+)
+
+Set-StrictMode -Version 'Latest'
+$PSDefaultParameterValues['*:ErrorAction'] = 'Stop'
+
+# The metrics compared for each scenario, and whether higher values are better.
+$ScenarioMetrics = @{
+    "upload"    = @(@{ Name = "uploadKbps"; HigherIsBetter = $true })
+    "download"  = @(@{ Name = "downloadKbps"; HigherIsBetter = $true })
+    "hps"       = @(@{ Name = "hps"; HigherIsBetter = $true })
+    "rps"       = @(@{ Name = "rps"; HigherIsBetter = $true })
+    "rps-multi" = @(@{ Name = "rps"; HigherIsBetter = $true })
+    "latency"   = @(@{ Name = "latencyUs.p50"; HigherIsBetter = $false },
+                    @{ Name = "latencyUs.p99"; HigherIsBetter = $false })
+}
+
+# Two-sided 95% critical values of Student's t distribution, by degrees of
+# freedom (1 to 30). Beyond 30, the normal distribution's 1.96 is used.
+$TCritical95 = @(
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042)
+
+function Get-TCritical([double]$Df) {
+    $Index = [Math]::Max(1, [Math]::Floor($Df))
+    if ($Index -gt $TCritical95.Count) { return 1.96 }
+    return $TCritical95[$Index - 1]
+}
+
+function Get-Stats([double[]]$Samples) {
+    $Mean = ($Samples | Measure-Object -Average).Average
+    $Variance = 0.0
+    foreach ($Sample in $Samples) { $Variance += ($Sample - $Mean) * ($Sample - $Mean) }
+    if ($Samples.Count -gt 1) { $Variance /= ($Samples.Count - 1) }
+    return @{ Count = $Samples.Count; Mean = $Mean; Variance = $Variance }
+}
+
+# Compares two sets of samples with Welch's t-test (which doesn't assume equal
+# variances), returning the relative change of the mean, its 95% confidence
+# interval, and whether it's significant.
+function Compare-Samples([double[]]$Baseline, [double[]]$Current) {
+    $B = Get-Stats $Baseline
+    $C = Get-Stats $Current
+    $Delta = $C.Mean - $B.Mean
+    $VB = $B.Variance / $B.Count
+    $VC = $C.Variance / $C.Count
+    $StdErr = [Math]::Sqrt($VB + $VC)
+    if ($StdErr -eq 0) {
+        $Df = $B.Count + $C.Count - 2
+        $Significant = $Delta -ne 0
+    } else {
+        # Welch-Satterthwaite approximation of the degrees of freedom.
+        $Denominator = 0.0
+        if ($B.Count -gt 1) { $Denominator += $VB * $VB / ($B.Count - 1) }
+        if ($C.Count -gt 1) { $Denominator += $VC * $VC / ($C.Count - 1) }
+        $Df = if ($Denominator -gt 0) { ($VB + $VC) * ($VB + $VC) / $Denominator } else { 1 }
+        $Significant = [Math]::Abs($Delta / $StdErr) -gt (Get-TCritical $Df)
+    }
+    $Margin = (Get-TCritical $Df) * $StdErr
+    $Scale = if ($B.Mean -ne 0) { 100.0 / [Math]::Abs($B.Mean) } else { 0.0 }
+    return @{
+        BaselineMean = $B.Mean
+        CurrentMean = $C.Mean
+        ChangePercent = $Delta * $Scale
+        CiLowPercent = ($Delta - $Margin) * $Scale
+        CiHighPercent = ($Delta + $Margin) * $Scale
+        Significant = $Significant
+    }
+}
+
+# Reads a (possibly nested, like "latencyUs.p50") metric from a result.
+function Get-Metric($Result, [string]$Name) {
+    $Value = $Result
+    foreach ($Part in $Name.Split('.', 2)) {
+        if ($null -eq $Value -or !($Value.PSObject.Properties.Name -contains $Part)) { return $null }
+        $Value = $Value.$Part
+    }
+    return [double]$Value
+}
+
+function Invoke-Run([string]$Scenario, [string]$Exec, [string]$Io, [string]$JsonFile) {
+    $CommonArgs = "-scenario:$Scenario -exec:$Exec -io:$Io"
+    if ($ExtraArgs -ne "") { $CommonArgs += " $ExtraArgs" }
+
+    $Server = $null
+    if ($Io -eq "loopback") {
+        $ClientArgs = "$CommonArgs -target:localhost"
+    } elseif ($Target -ne "") {
+        $ClientArgs = "$CommonArgs -target:$Target"
+    } else {
+        $Server = Start-Process -FilePath $SecNetPerfPath -ArgumentList $CommonArgs -PassThru -NoNewWindow -RedirectStandardOutput ([System.IO.Path]::GetTempFileName())
+        Start-Sleep -Seconds 1
+        $ClientArgs = "$CommonArgs -target:localhost"
+    }
+
+    try {
+        if (Test-Path $JsonFile) { Remove-Item $JsonFile }
+        $Output = & $SecNetPerfPath $ClientArgs.Split(' ') "-json:$JsonFile" -trimout 2>&1
+        if ($LASTEXITCODE -ne 0 -or !(Test-Path $JsonFile)) {
+            Write-Host ($Output | Out-String)
+            throw "secnetperf $ClientArgs failed ($LASTEXITCODE)"
+        }
+        return Get-Content $JsonFile -Raw | ConvertFrom-Json
+    } finally {
+        if ($null -ne $Server) {
+            Stop-Process -Id $Server.Id -Force -ErrorAction Ignore
+            $Server.WaitForExit()
+        }
+    }
+}
+
+# Run the matrix, collecting every metric's samples by configuration.
+$Results = [ordered]@{}
+$JsonFile = Join-Path ([System.IO.Path]::GetTempPath()) "secnetperf-$PID.json"
+foreach ($Scenario in $Scenarios) {
+    foreach ($Exec in $ExecProfiles) {
+        foreach ($Io in $IoModes) {
+            $Config = "$Scenario/$Exec/$Io"
+            $Samples = [ordered]@{}
+            foreach ($Metric in $ScenarioMetrics[$Scenario]) {
+                $Samples[$Metric.Name] = [System.Collections.ArrayList]@()
+            }
+            for ($i = 1; $i -le $Runs; $i++) {
+                Write-Host "> $Config run $i of $Runs"
+                $Result = Invoke-Run $Scenario $Exec $Io $JsonFile
+                foreach ($Metric in $ScenarioMetrics[$Scenario]) {
+                    $Value = Get-Metric $Result $Metric.Name
+                    if ($null -eq $Value) { throw "$Config didn't report $($Metric.Name)" }
+                    $Samples[$Metric.Name].Add($Value) | Out-Null
+                }
+            }
+            $Results[$Config] = $Samples
+        }
+    }
+}
+Remove-Item $JsonFile -ErrorAction Ignore
+
+$Document = [ordered]@{ version = 1; runs = $Runs; results = $Results }
+$Document | ConvertTo-Json -Depth 5 | Set-Content $OutputFile
+Write-Host "Results written to $OutputFile"
+
+if ($UpdateBaseline) {
+    $Document | ConvertTo-Json -Depth 5 | Set-Content $BaselineFile
+    Write-Host "Baseline written to $BaselineFile"
+    exit 0
+}
+
+if (!(Test-Path $BaselineFile)) {
+    Write-Error "Baseline '$BaselineFile' not found! Run with -UpdateBaseline to create it."
+}
+$Baseline = (Get-Content $BaselineFile -Raw | ConvertFrom-Json).results
+
+# Compare every metric against the baseline.
+$Regressions = 0
+$Rows = @()
+foreach ($Config in $Results.Keys) {
+    $Scenario = $Config.Split('/')[0]
+    foreach ($Metric in $ScenarioMetrics[$Scenario]) {
+        $Current = [double[]]$Results[$Config][$Metric.Name]
+        $BaselineSamples = $null
+        if ($Baseline.PSObject.Properties.Name -contains $Config -and
+            $Baseline.$Config.PSObject.Properties.Name -contains $Metric.Name) {
+            $BaselineSamples = [double[]]$Baseline.$Config.($Metric.Name)
+        }
+        if ($null -eq $BaselineSamples -or $BaselineSamples.Count -lt 2) {
+            $Rows += [PSCustomObject]@{ Config = $Config; Metric = $Metric.Name; Verdict = "NO BASELINE" }
+            continue
+        }
+
+        $Comparison = Compare-Samples $BaselineSamples $Current
+        $Worse = if ($Metric.HigherIsBetter) { -$Comparison.ChangePercent } else { $Comparison.ChangePercent }
+        $Verdict = "ok"
+        if ($Comparison.Significant -and $Worse -gt $Threshold) {
+            $Verdict = "REGRESSION"
+            $Regressions++
+        } elseif ($Comparison.Significant -and -$Worse -gt $Threshold) {
+            $Verdict = "improved"
+        } elseif (!$Comparison.Significant) {
+            $Verdict = "ok (not significant)"
+        }
+        $Rows += [PSCustomObject]@{
+            Config = $Config
+            Metric = $Metric.Name
+            Baseline = [Math]::Round($Comparison.BaselineMean, 1)
+            Current = [Math]::Round($Comparison.CurrentMean, 1)
+            "Change%" = [Math]::Round($Comparison.ChangePercent, 2)
+            "95% CI" = "[{0:N2}, {1:N2}]" -f $Comparison.CiLowPercent, $Comparison.CiHighPercent
+            Verdict = $Verdict
+        }
+    }
+}
+$Rows | Format-Table -AutoSize | Out-String | Write-Host
+
+if ($Regressions -ne 0) {
+    Write-Host "$Regressions metric(s) regressed by more than $Threshold%!"
+    exit 1
+}
+Write-Host "No significant regressions."
@@ -55,6 +55,12 @@ QuicAckTrackerInitialize(
     QuicRangeInitialize(
         QUIC_MAX_RANGE_ACK_PACKETS,
         &Tracker->PacketNumbersToAck);
+
+    Tracker->RecentPacketNumbersBase = 0;
+    CxPlatZeroMemory(Tracker->RecentPacketNumbers, sizeof(Tracker->RecentPacketNumbers));
+    Tracker->ReceiveTimestamps = NULL;
+    Tracker->ReceiveTimestampCount = 0;
+    Tracker->EncodedAckBlocksValid = FALSE;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -65,6 +71,10 @@ QuicAckTrackerUninitialize(
 {
     QuicRangeUninitialize(&Tracker->PacketNumbersToAck);
     QuicRangeUninitialize(&Tracker->PacketNumbersReceived);
+    if (Tracker->ReceiveTimestamps != NULL) {
+        CXPLAT_FREE(Tracker->ReceiveTimestamps, QUIC_POOL_RECEIVE_TIMESTAMPS);
+        Tracker->ReceiveTimestamps = NULL;
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -78,11 +88,79 @@ QuicAckTrackerReset(
     Tracker->LargestPacketNumberRecvTime = 0;
     Tracker->AlreadyWrittenAckFrame = FALSE;
     Tracker->NonZeroRecvECN = FALSE;
+    Tracker->EncodedAckBlocksValid = FALSE;
     CxPlatZeroMemory(&Tracker->ReceivedECN, sizeof(Tracker->ReceivedECN));
+    Tracker->ReceiveTimestampCount = 0;
+    Tracker->RecentPacketNumbersBase = 0;
+    CxPlatZeroMemory(Tracker->RecentPacketNumbers, sizeof(Tracker->RecentPacketNumbers));
     QuicRangeReset(&Tracker->PacketNumbersToAck);
     QuicRangeReset(&Tracker->PacketNumbersReceived);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicAckTrackerCompact(
+    _Inout_ QUIC_ACK_TRACKER* Tracker
+    )
+{
+    QuicRangeCompact(&Tracker->PacketNumbersToAck);
+    QuicRangeCompact(&Tracker->PacketNumbersReceived);
+    Tracker->EncodedAckBlocksValid = FALSE;
+    if (Tracker->ReceiveTimestamps != NULL) {
+        CXPLAT_FREE(Tracker->ReceiveTimestamps, QUIC_POOL_RECEIVE_TIMESTAMPS);
+        Tracker->ReceiveTimestamps = NULL;
+        Tracker->ReceiveTimestampCount = 0;
+    }
+}
+
+//
+// Moves the packet numbers tracked by one word of the recent packet number
+// bitmap to the range of older packet numbers, and clears the word.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicAckTrackerRetireRecentWord(
+    _Inout_ QUIC_ACK_TRACKER* Tracker,
+    _In_ uint64_t WordIndex
+    )
+{
+    uint64_t* Word =
+        &Tracker->RecentPacketNumbers[WordIndex % ARRAYSIZE(Tracker->RecentPacketNumbers)];
+    const uint64_t Low = WordIndex * 64;
+    uint64_t Bits = *Word;
+    *Word = 0;
+
+    if (Bits == UINT64_MAX) {
+        //
+        // Common case: all packets were received.
+        //
+        BOOLEAN DontCare;
+        (void)QuicRangeAddRange(&Tracker->PacketNumbersReceived, Low, 64, &DontCare);
+        return;
+    }
+
+    //
+    // Add each run of received packet numbers as a single range. Allocation
+    // failures are ignored; just like packet numbers dropped from the range
+    // when it hits its size limit, they are no longer tracked.
+    //
+    uint32_t i = 0;
+    while (Bits != 0) {
+        while (!(Bits & 1)) {
+            Bits >>= 1;
+            i++;
+        }
+        uint32_t Start = i;
+        while (Bits & 1) {
+            Bits >>= 1;
+            i++;
+        }
+        BOOLEAN DontCare;
+        (void)QuicRangeAddRange(
+            &Tracker->PacketNumbersReceived, Low + Start, i - Start, &DontCare);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicAckTrackerAddPacketNumber(
@@ -90,10 +168,43 @@ QuicAckTrackerAddPacketNumber(
     _In_ uint64_t PacketNumber
     )
 {
-    BOOLEAN RangeUpdated;
-    return
-        QuicRangeAddRange(&Tracker->PacketNumbersReceived, PacketNumber, 1, &RangeUpdated) == NULL ||
-        !RangeUpdated;
+    if (PacketNumber < Tracker->RecentPacketNumbersBase) {
+        //
+        // Too old for the bitmap. Fall back to the range.
+        //
+        BOOLEAN RangeUpdated;
+        return
+            QuicRangeAddRange(&Tracker->PacketNumbersReceived, PacketNumber, 1, &RangeUpdated) == NULL ||
+            !RangeUpdated;
+    }
+
+    const uint64_t WordIndex = PacketNumber / 64;
+    if (PacketNumber >= Tracker->RecentPacketNumbersBase + QUIC_RECENT_PACKET_NUMBER_COUNT) {
+        //
+        // Slide the window forward so that the packet number is in its last
+        // word, retiring the words that fall out of it.
+        //
+        const uint64_t NewBaseWordIndex =
+            WordIndex + 1 - ARRAYSIZE(Tracker->RecentPacketNumbers);
+        uint64_t RetireWordIndex = Tracker->RecentPacketNumbersBase / 64;
+        const uint64_t RetireEnd =
+            CXPLAT_MIN(
+                NewBaseWordIndex,
+                RetireWordIndex + ARRAYSIZE(Tracker->RecentPacketNumbers));
+        for (; RetireWordIndex < RetireEnd; ++RetireWordIndex) {
+            QuicAckTrackerRetireRecentWord(Tracker, RetireWordIndex);
+        }
+        Tracker->RecentPacketNumbersBase = NewBaseWordIndex * 64;
+    }
+
+    uint64_t* Word =
+        &Tracker->RecentPacketNumbers[WordIndex % ARRAYSIZE(Tracker->RecentPacketNumbers)];
+    const uint64_t Bit = 1ull << (PacketNumber % 64);
+    if (*Word & Bit) {
+        return TRUE;
+    }
+    *Word |= Bit;
+    return FALSE;
 }
 
 //
@@ -163,6 +274,88 @@ QuicAckTrackerDidHitReorderingThreshold(
     return FALSE;
 }
 
+//
+// Records the packet's receive time for the next ACK frame. Failing to
+// allocate the ring just means no receive timestamps are sent.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicAckTrackerAddReceiveTimestamp(
+    _Inout_ QUIC_ACK_TRACKER* Tracker,
+    _In_ uint64_t PacketNumber,
+    _In_ uint64_t RecvTimeUs
+    )
+{
+    if (Tracker->ReceiveTimestamps == NULL) {
+        Tracker->ReceiveTimestamps =
+            CXPLAT_ALLOC_NONPAGED(
+                QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK * sizeof(QUIC_ACK_RECEIVE_TIMESTAMP),
+                QUIC_POOL_RECEIVE_TIMESTAMPS);
+        if (Tracker->ReceiveTimestamps == NULL) {
+            return;
+        }
+        Tracker->ReceiveTimestampCount = 0;
+    }
+
+    QUIC_ACK_RECEIVE_TIMESTAMP* Entry =
+        &Tracker->ReceiveTimestamps[
+            Tracker->ReceiveTimestampCount % QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+    Entry->PacketNumber = PacketNumber;
+    Entry->RecvTime = RecvTimeUs;
+    Tracker->ReceiveTimestampCount++;
+}
+
+//
+// Keeps the encoded ACK blocks up to date after PacketNumber was added to
+// PacketNumbersToAck, whose largest subrange was PrevLargest (out of PrevCount
+// subranges). In the common cases, the packet number extends the largest
+// subrange, which leaves the blocks as is, or starts a new largest subrange,
+// which makes the previous one the first block. Anything else invalidates
+// them.
+//
+static
+void
+QuicAckTrackerUpdateEncodedAckBlocks(
+    _Inout_ QUIC_ACK_TRACKER* Tracker,
+    _In_ uint32_t PrevCount,
+    _In_ const QUIC_SUBRANGE* PrevLargest,
+    _In_ uint64_t PacketNumber
+    )
+{
+    if (!Tracker->EncodedAckBlocksValid) {
+        return;
+    }
+
+    const uint32_t Count = QuicRangeSize(&Tracker->PacketNumbersToAck);
+    const uint64_t PrevHigh = QuicRangeGetHigh(PrevLargest);
+
+    if (Count == PrevCount &&
+        PacketNumber >= PrevLargest->Low && PacketNumber <= PrevHigh + 1) {
+        return;
+    }
+
+    if (Count == PrevCount + 1 && PacketNumber > PrevHigh + 1) {
+        uint8_t Encoded[sizeof(QUIC_ACK_BLOCK_EX)]; // Two var ints of up to 8 bytes
+        uint16_t EncodedLength = 0;
+        QUIC_ACK_BLOCK_EX Block = {
+            PacketNumber - PrevHigh - 2,    // Gap
+            PrevLargest->Count - 1          // AckBlock
+        };
+        if (QuicAckBlockEncode(&Block, &EncodedLength, sizeof(Encoded), Encoded) &&
+            Tracker->EncodedAckBlocksLength + EncodedLength <= sizeof(Tracker->EncodedAckBlocks)) {
+            CxPlatMoveMemory(
+                Tracker->EncodedAckBlocks + EncodedLength,
+                Tracker->EncodedAckBlocks,
+                Tracker->EncodedAckBlocksLength);
+            CxPlatCopyMemory(Tracker->EncodedAckBlocks, Encoded, EncodedLength);
+            Tracker->EncodedAckBlocksLength += EncodedLength;
+            return;
+        }
+    }
+
+    Tracker->EncodedAckBlocksValid = FALSE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicAckTrackerAckPacket(
@@ -173,7 +366,8 @@ QuicAckTrackerAckPacket(
     _In_ QUIC_ACK_TYPE AckType
     )
 {
-    QUIC_CONNECTION* Connection = QuicAckTrackerGetPacketSpace(Tracker)->Connection;
+    QUIC_PACKET_SPACE* PacketSpace = QuicAckTrackerGetPacketSpace(Tracker);
+    QUIC_CONNECTION* Connection = PacketSpace->Connection;
     _Analysis_assume_(Connection != NULL);
 
     //
@@ -193,14 +387,27 @@ QuicAckTrackerAckPacket(
         Connection->Stats.Recv.ReorderedPackets++;
     }
 
+    const uint32_t PrevCount = QuicRangeSize(&Tracker->PacketNumbersToAck);
+    QUIC_SUBRANGE PrevLargest = { 0, 0 };
+    if (PrevCount != 0) {
+        PrevLargest = *QuicRangeGet(&Tracker->PacketNumbersToAck, PrevCount - 1);
+    }
+
     if (!QuicRangeAddValue(&Tracker->PacketNumbersToAck, PacketNumber)) {
         //
         // Allocation failure. Fatal error for the connection in this case.
         //
+        Tracker->EncodedAckBlocksValid = FALSE;
         QuicConnTransportError(Connection, QUIC_ERROR_INTERNAL_ERROR);
         return;
     }
 
+    if (PrevCount != 0) {
+        QuicAckTrackerUpdateEncodedAckBlocks(Tracker, PrevCount, &PrevLargest, PacketNumber);
+    } else {
+        Tracker->EncodedAckBlocksValid = FALSE;
+    }
+
     QuicTraceLogVerbose(
         PacketRxMarkedForAck,
         "[%c][RX][%llu] Marked for ACK (ECN=%hhu)",
@@ -214,6 +421,11 @@ QuicAckTrackerAckPacket(
         Tracker->LargestPacketNumberRecvTime = RecvTimeUs;
     }
 
+    if (Connection->State.ReceiveTimestampsSendNegotiated &&
+        PacketSpace->EncryptLevel == QUIC_ENCRYPT_LEVEL_1_RTT) {
+        QuicAckTrackerAddReceiveTimestamp(Tracker, PacketNumber, RecvTimeUs);
+    }
+
     switch (ECN) {
         case CXPLAT_ECN_ECT_1:
             Tracker->NonZeroRecvECN = TRUE;
@@ -260,7 +472,7 @@ QuicAckTrackerAckPacket(
     //
 
     if (AckType == QUIC_ACK_TYPE_ACK_IMMEDIATE ||
-        Connection->Settings.MaxAckDelayMs == 0 ||
+        Connection->MaxAckDelayMs == 0 ||
         (Tracker->AckElicitingPacketsToAcknowledge >= (uint16_t)Connection->PacketTolerance) ||
         (NewLargestPacketNumber && 
         QuicAckTrackerDidHitReorderingThreshold(Tracker, Connection->ReorderingThreshold))) {
@@ -309,8 +521,79 @@ QuicAckTrackerAckFrameEncode(
         }
     }
 
-    if (!QuicAckFrameEncode(
+    //
+    // When the peer asked for receive timestamps, report those of the newest
+    // packets, in descending packet number order and relative to the start
+    // of the connection. Packets received out of order, already acknowledged
+    // or received before the start are left out. The frame has no ECN
+    // counts, so a plain ACK frame is sent instead while they are needed.
+    //
+    //
+    // Only the frame header is encoded from scratch when the ACK blocks below
+    // the largest subrange haven't changed since the last ACK frame.
+    //
+    if (!Tracker->EncodedAckBlocksValid) {
+        Tracker->EncodedAckBlocksLength = 0;
+        Tracker->EncodedAckBlocksValid =
+            QuicAckBlocksEncode(
+                &Tracker->PacketNumbersToAck,
+                &Tracker->EncodedAckBlocksLength,
+                sizeof(Tracker->EncodedAckBlocks),
+                Tracker->EncodedAckBlocks);
+    }
+    const QUIC_ENCODED_ACK_BLOCKS EncodedBlocks = {
+        Tracker->EncodedAckBlocks,
+        Tracker->EncodedAckBlocksLength
+    };
+    const QUIC_ENCODED_ACK_BLOCKS* CachedBlocks =
+        Tracker->EncodedAckBlocksValid ? &EncodedBlocks : NULL;
+
+    QUIC_ACK_RECEIVE_TIMESTAMP Timestamps[QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+    uint32_t TimestampCount = 0;
+    if (Tracker->ReceiveTimestampCount != 0 &&
+        Builder->EncryptLevel == QUIC_ENCRYPT_LEVEL_1_RTT &&
+        !Tracker->NonZeroRecvECN) {
+        const uint64_t MaxCount =
+            CXPLAT_MIN(
+                Builder->Connection->PeerTransportParams.MaxReceiveTimestampsPerAck,
+                QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK);
+        const uint32_t Available =
+            CXPLAT_MIN(Tracker->ReceiveTimestampCount, QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK);
+        const uint64_t Basis = Builder->Connection->Stats.Timing.Start;
+        const uint64_t Smallest = QuicRangeGetMin(&Tracker->PacketNumbersToAck);
+        for (uint32_t i = 0; i < Available && TimestampCount < MaxCount; ++i) {
+            const QUIC_ACK_RECEIVE_TIMESTAMP* Entry =
+                &Tracker->ReceiveTimestamps[
+                    (Tracker->ReceiveTimestampCount - 1 - i) % QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+            if (Entry->PacketNumber < Smallest ||
+                Entry->RecvTime < Basis ||
+                (TimestampCount != 0 &&
+                 (Entry->PacketNumber >= Timestamps[TimestampCount - 1].PacketNumber ||
+                  Entry->RecvTime - Basis > Timestamps[TimestampCount - 1].RecvTime))) {
+                continue;
+            }
+            Timestamps[TimestampCount].PacketNumber = Entry->PacketNumber;
+            Timestamps[TimestampCount].RecvTime = Entry->RecvTime - Basis;
+            TimestampCount++;
+        }
+    }
+
+    if (TimestampCount != 0) {
+        if (!QuicAckReceiveTimestampsFrameEncode(
+                &Tracker->PacketNumbersToAck,
+                CachedBlocks,
+                AckDelay,
+                Timestamps,
+                TimestampCount,
+                QUIC_RECEIVE_TIMESTAMPS_EXPONENT,
+                &Builder->DatagramLength,
+                (uint16_t)Builder->Datagram->Length - Builder->EncryptionOverhead,
+                Builder->Datagram->Buffer)) {
+            return FALSE;
+        }
+    } else if (!QuicAckFrameEncode(
             &Tracker->PacketNumbersToAck,
+            CachedBlocks,
             AckDelay,
             Tracker->NonZeroRecvECN ?
                 &Tracker->ReceivedECN :
@@ -327,6 +610,7 @@ QuicAckTrackerAckFrameEncode(
     }
 
     Tracker->AlreadyWrittenAckFrame = TRUE;
+    Tracker->ReceiveTimestampCount = 0;
     Tracker->LargestPacketNumberAcknowledged =
         Builder->Metadata->Frames[Builder->Metadata->FrameCount].ACK.LargestAckedPacketNumber =
         QuicRangeGetMax(&Tracker->PacketNumbersToAck);
@@ -351,6 +635,7 @@ QuicAckTrackerOnAckFrameAcked(
     QuicRangeSetMin(
         &Tracker->PacketNumbersToAck,
         LargestAckedPacketNumber + 1);
+    Tracker->EncodedAckBlocksValid = FALSE;
 
     if (!QuicAckTrackerHasPacketsToAck(Tracker) &&
         Tracker->AckElicitingPacketsToAcknowledge) {
@@ -12,12 +12,29 @@ extern "C" {
 typedef struct QUIC_ACK_TRACKER {
 
     //
-    // Range of packet numbers we have received. Used for duplicate packet
-    // detection. The range's growth is limited to QUIC_MAX_RANGE_DUPLICATE_PACKETS
-    // bytes. When this limit is hit, older packets are silently dropped.
+    // Range of packet numbers we have received, older than the ones tracked by
+    // RecentPacketNumbers. Used for duplicate packet detection. The range's
+    // growth is limited to QUIC_MAX_RANGE_DUPLICATE_PACKETS bytes. When this
+    // limit is hit, older packets are silently dropped.
     //
     QUIC_RANGE PacketNumbersReceived;
 
+    //
+    // The first packet number (always a multiple of 64) tracked by
+    // RecentPacketNumbers.
+    //
+    uint64_t RecentPacketNumbersBase;
+
+    //
+    // Circular bitmap of the QUIC_RECENT_PACKET_NUMBER_COUNT packet numbers
+    // starting at RecentPacketNumbersBase, with a bit set for each one that
+    // has been received. Packet number N is tracked by bit N % 64 of word
+    // (N / 64) % ARRAYSIZE(RecentPacketNumbers). As larger packet numbers are
+    // received, the window slides forward and the received packet numbers it
+    // leaves behind are moved to PacketNumbersReceived.
+    //
+    uint64_t RecentPacketNumbers[QUIC_RECENT_PACKET_NUMBER_COUNT / 64];
+
     //
     // Range of packet numbers we have received and should ACK. The range's
     // growth is limited to QUIC_MAX_RANGE_ACK_PACKETS bytes. When this limit is
@@ -25,6 +42,15 @@ typedef struct QUIC_ACK_TRACKER {
     //
     QUIC_RANGE PacketNumbersToAck;
 
+    //
+    // The additional ACK blocks of PacketNumbersToAck (all but its largest
+    // subrange), encoded for the next ACK frame. Updated in place as packet
+    // numbers extend the largest subrange or start a new one above it, and
+    // re-encoded on the next ACK frame after anything else changes them.
+    //
+    uint8_t EncodedAckBlocks[QUIC_MAX_ENCODED_ACK_BLOCKS_LENGTH];
+    uint16_t EncodedAckBlocksLength;
+
     //
     // The current count of recieved ECNs
     //
@@ -40,6 +66,17 @@ typedef struct QUIC_ACK_TRACKER {
     //
     uint64_t LargestPacketNumberRecvTime;
 
+    //
+    // The packet numbers and receive times of the latest 1-RTT packets
+    // received since the last ACK frame was written, kept when the peer asked
+    // for receive timestamps (draft-smith-quic-receive-ts). A ring of
+    // QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK entries, allocated on first use;
+    // ReceiveTimestampCount counts all the packets, so the newest one is at
+    // (ReceiveTimestampCount - 1) % QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK.
+    //
+    QUIC_ACK_RECEIVE_TIMESTAMP* ReceiveTimestamps;
+    uint32_t ReceiveTimestampCount;
+
     //
     // The number of ACK eliciting packets that need to be acknowledged.
     //
@@ -56,6 +93,11 @@ typedef struct QUIC_ACK_TRACKER {
     //
     BOOLEAN NonZeroRecvECN : 1;
 
+    //
+    // Indicates EncodedAckBlocks matches PacketNumbersToAck.
+    //
+    BOOLEAN EncodedAckBlocksValid : 1;
+
 } QUIC_ACK_TRACKER;
 
 //
@@ -85,6 +127,16 @@ QuicAckTrackerReset(
     _Inout_ QUIC_ACK_TRACKER* Tracker
     );
 
+//
+// Frees the memory the tracker's ranges grew into, while the connection is
+// idle. The oldest packet numbers may no longer be tracked afterwards.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicAckTrackerCompact(
+    _Inout_ QUIC_ACK_TRACKER* Tracker
+    );
+
 //
 // Returns TRUE if the packet is a duplicate.
 //
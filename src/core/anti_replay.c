@@ -0,0 +1,198 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    0-RTT anti-replay uses ClientHello recording (RFC 8446, Section 8.2). Each
+    ClientHello that presents a resumption ticket is identified by a digest of
+    its random, which a legitimate client never reuses, and recorded in a
+    Bloom filter. A ClientHello already in the filter is a replay, and its
+    ticket is refused.
+
+    The filter is split into shards, each with its own lock, so servers with
+    many partitions don't contend on it. Each shard keeps two generations of
+    its filter and starts a new one every window, so a ClientHello is
+    remembered for between one and two windows in bounded memory. The TLS
+    library's ticket age check rejects early data outside of its own freshness
+    window, which the filter's window must cover.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "anti_replay.c.clog.h"
+#endif
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicAntiReplayInitialize(
+    _Out_ QUIC_ANTI_REPLAY* AntiReplay
+    )
+{
+    CxPlatZeroMemory(AntiReplay, sizeof(*AntiReplay));
+    for (uint32_t i = 0; i < QUIC_ANTI_REPLAY_SHARD_COUNT; ++i) {
+        CxPlatDispatchLockInitialize(&AntiReplay->Shards[i].Lock);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicAntiReplayUninitialize(
+    _In_ QUIC_ANTI_REPLAY* AntiReplay
+    )
+{
+    for (uint32_t i = 0; i < QUIC_ANTI_REPLAY_SHARD_COUNT; ++i) {
+        CxPlatDispatchLockUninitialize(&AntiReplay->Shards[i].Lock);
+    }
+    if (AntiReplay->Bits != NULL) {
+        CXPLAT_FREE(AntiReplay->Bits, QUIC_POOL_ANTI_REPLAY);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicAntiReplaySetConfig(
+    _In_ QUIC_ANTI_REPLAY* AntiReplay,
+    _In_ const QUIC_ZERORTT_ANTI_REPLAY_CONFIG* Config
+    )
+{
+    uint64_t* Bits = NULL;
+    uint32_t FilterWords = 0;
+
+    if (Config->FilterBytes != 0) {
+        //
+        // Two generations of a filter per shard.
+        //
+        FilterWords =
+            Config->FilterBytes / (2 * QUIC_ANTI_REPLAY_SHARD_COUNT * sizeof(uint64_t));
+        if (FilterWords == 0) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        const size_t BitsLength =
+            (size_t)FilterWords * 2 * QUIC_ANTI_REPLAY_SHARD_COUNT * sizeof(uint64_t);
+        Bits = CXPLAT_ALLOC_NONPAGED(BitsLength, QUIC_POOL_ANTI_REPLAY);
+        if (Bits == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "anti-replay filter",
+                BitsLength);
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        CxPlatZeroMemory(Bits, BitsLength);
+    }
+
+    if (AntiReplay->Bits != NULL) {
+        CXPLAT_FREE(AntiReplay->Bits, QUIC_POOL_ANTI_REPLAY);
+    }
+
+    const uint64_t Now = CxPlatTimeUs64();
+    for (uint32_t i = 0; i < QUIC_ANTI_REPLAY_SHARD_COUNT; ++i) {
+        QUIC_ANTI_REPLAY_SHARD* Shard = &AntiReplay->Shards[i];
+        Shard->GenerationStart = Now;
+        Shard->Current = 0;
+        Shard->Filters[0] = Bits != NULL ? Bits + (2 * i) * FilterWords : NULL;
+        Shard->Filters[1] = Bits != NULL ? Bits + (2 * i + 1) * FilterWords : NULL;
+    }
+
+    AntiReplay->Bits = Bits;
+    AntiReplay->FilterWords = FilterWords;
+    AntiReplay->Config.FilterBytes = Config->FilterBytes;
+    AntiReplay->Config.WindowMs =
+        Config->WindowMs != 0 ? Config->WindowMs : QUIC_DEFAULT_ZERORTT_ANTI_REPLAY_WINDOW_MS;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// The splitmix64 finalizer, so structured digests still spread evenly.
+//
+QUIC_INLINE
+QUIC_NO_SANITIZE("unsigned-integer-overflow")
+uint64_t
+QuicAntiReplayMix(
+    _In_ uint64_t z
+    )
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+QUIC_INLINE
+BOOLEAN
+QuicAntiReplayFilterContains(
+    _In_ const uint64_t* Filter,
+    _In_reads_(QUIC_ANTI_REPLAY_HASH_COUNT)
+        const uint32_t* Indexes
+    )
+{
+    for (uint32_t i = 0; i < QUIC_ANTI_REPLAY_HASH_COUNT; ++i) {
+        if (!(Filter[Indexes[i] / 64] & (1ull << (Indexes[i] % 64)))) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicAntiReplayCheck(
+    _In_ QUIC_ANTI_REPLAY* AntiReplay,
+    _In_ uint64_t ClientHelloDigest
+    )
+{
+    //
+    // The filter indexes come from double hashing the two halves of the mixed
+    // digest, and the shard from mixing it again.
+    //
+    const uint32_t FilterBits = AntiReplay->FilterWords * 64;
+    const uint64_t Hash = QuicAntiReplayMix(ClientHelloDigest);
+    const uint32_t Hash1 = (uint32_t)Hash;
+    const uint32_t Hash2 = (uint32_t)(Hash >> 32) | 1;
+    uint32_t Indexes[QUIC_ANTI_REPLAY_HASH_COUNT];
+    for (uint32_t i = 0; i < QUIC_ANTI_REPLAY_HASH_COUNT; ++i) {
+        Indexes[i] = (uint32_t)(((uint64_t)Hash1 + (uint64_t)i * Hash2) % FilterBits);
+    }
+    QUIC_ANTI_REPLAY_SHARD* Shard =
+        &AntiReplay->Shards[QuicAntiReplayMix(Hash) % QUIC_ANTI_REPLAY_SHARD_COUNT];
+
+    const uint64_t Now = CxPlatTimeUs64();
+    const uint64_t Window = MS_TO_US((uint64_t)AntiReplay->Config.WindowMs);
+    BOOLEAN Fresh;
+
+    CxPlatDispatchLockAcquire(&Shard->Lock);
+
+    const uint64_t Elapsed = CxPlatTimeDiff64(Shard->GenerationStart, Now);
+    if (Elapsed >= Window) {
+        //
+        // Start a new generation. The previous one is dropped too if nothing
+        // has been checked for a whole window.
+        //
+        if (Elapsed >= 2 * Window) {
+            CxPlatZeroMemory(
+                Shard->Filters[Shard->Current], AntiReplay->FilterWords * sizeof(uint64_t));
+        }
+        Shard->Current ^= 1;
+        CxPlatZeroMemory(
+            Shard->Filters[Shard->Current], AntiReplay->FilterWords * sizeof(uint64_t));
+        Shard->GenerationStart = Now;
+    }
+
+    Fresh =
+        !QuicAntiReplayFilterContains(Shard->Filters[0], Indexes) &&
+        !QuicAntiReplayFilterContains(Shard->Filters[1], Indexes);
+
+    if (Fresh) {
+        uint64_t* Filter = Shard->Filters[Shard->Current];
+        for (uint32_t i = 0; i < QUIC_ANTI_REPLAY_HASH_COUNT; ++i) {
+            Filter[Indexes[i] / 64] |= 1ull << (Indexes[i] % 64);
+        }
+    }
+
+    CxPlatDispatchLockRelease(&Shard->Lock);
+
+    return Fresh;
+}
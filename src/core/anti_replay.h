@@ -0,0 +1,117 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A registration's record of recently seen ClientHellos that presented a
+    resumption ticket, used to refuse resumption (and so 0-RTT) to a replayed
+    ClientHello.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The number of independently locked shards. A ClientHello always maps to the
+// same shard, whichever partition processes it.
+//
+#define QUIC_ANTI_REPLAY_SHARD_COUNT    16
+
+//
+// The number of filter bits set for each ClientHello.
+//
+#define QUIC_ANTI_REPLAY_HASH_COUNT     4
+
+typedef struct QUIC_ANTI_REPLAY_SHARD {
+
+    CXPLAT_DISPATCH_LOCK Lock;
+
+    //
+    // Time (in microseconds) the current generation started.
+    //
+    uint64_t GenerationStart;
+
+    //
+    // Index of the current generation in Filters. The other one is the
+    // previous generation, which is only checked.
+    //
+    uint8_t Current;
+
+    uint64_t* Filters[2];
+
+} QUIC_ANTI_REPLAY_SHARD;
+
+typedef struct QUIC_ANTI_REPLAY {
+
+    //
+    // Only changed while the registration has no connections.
+    //
+    QUIC_ZERORTT_ANTI_REPLAY_CONFIG Config;
+
+    //
+    // The number of 64-bit words in each shard's generation filter. Zero when
+    // disabled.
+    //
+    uint32_t FilterWords;
+
+    //
+    // All the shards' filters, in one allocation.
+    //
+    uint64_t* Bits;
+
+    QUIC_ANTI_REPLAY_SHARD Shards[QUIC_ANTI_REPLAY_SHARD_COUNT];
+
+} QUIC_ANTI_REPLAY;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicAntiReplayInitialize(
+    _Out_ QUIC_ANTI_REPLAY* AntiReplay
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicAntiReplayUninitialize(
+    _In_ QUIC_ANTI_REPLAY* AntiReplay
+    );
+
+//
+// Replaces the filter with an empty one sized for the new configuration. Must
+// not be called concurrently with QuicAntiReplayCheck.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicAntiReplaySetConfig(
+    _In_ QUIC_ANTI_REPLAY* AntiReplay,
+    _In_ const QUIC_ZERORTT_ANTI_REPLAY_CONFIG* Config
+    );
+
+QUIC_INLINE
+BOOLEAN
+QuicAntiReplayIsEnabled(
+    _In_ const QUIC_ANTI_REPLAY* AntiReplay
+    )
+{
+    return AntiReplay->FilterWords != 0;
+}
+
+//
+// Records the ClientHello and returns FALSE if it has (probably) been seen
+// within the window already. False positives only cost a full handshake.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicAntiReplayCheck(
+    _In_ QUIC_ANTI_REPLAY* AntiReplay,
+    _In_ uint64_t ClientHelloDigest
+    );
+
+#if defined(__cplusplus)
+}
+#endif
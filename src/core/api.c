@@ -854,6 +854,26 @@ Error:
 }
 #pragma warning(pop)
 
+//
+// Returns TRUE if the current thread is the connection's worker, processing
+// the connection (e.g. from a callback), so that an API call can be executed
+// inline instead of queuing an operation.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+BOOLEAN
+QuicConnCanExecuteInline(
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+#pragma warning(push)
+#pragma warning(disable:6240) // CXPLAT_AT_DISPATCH only really does anything for kernel mode
+    return
+        !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
+        Connection->WorkerThreadID == CxPlatCurThreadID();
+#pragma warning(pop)
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -897,6 +917,26 @@ MsQuicStreamStart(
         goto Exit;
     }
 
+    if (QuicConnCanExecuteInline(Connection) &&
+        !(Flags & QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL)) {
+        //
+        // Start the stream inline if called on the worker thread. Only start
+        // complete is indicated back to the app, which is allowed, so a start
+        // that would shut the stream down on failure is still queued.
+        //
+        CXPLAT_PASSIVE_CODE();
+
+        BOOLEAN AlreadyInline = Connection->State.InlineApiExecution;
+        if (!AlreadyInline) {
+            Connection->State.InlineApiExecution = TRUE;
+        }
+        Status = QuicStreamStart(Stream, Flags, FALSE);
+        if (!AlreadyInline) {
+            Connection->State.InlineApiExecution = FALSE;
+        }
+        goto Exit;
+    }
+
     QUIC_OPERATION* Oper =
         QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
     if (Oper == NULL) {
@@ -1060,51 +1100,100 @@ Error:
     return Status;
 }
 
+
+//
+// Appends a send request to the stream's pending API sends, freeing it on
+// failure. On success, FlushNeeded indicates the caller must flush the stream's
+// sends, because none were pending already. If not sending inline, a stream
+// reference is then held for the operation that will do so.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
+static
 QUIC_STATUS
-QUIC_API
-MsQuicStreamSend(
-    _In_ _Pre_defensive_ HQUIC Handle,
-    _In_reads_(BufferCount) _Pre_defensive_
-        const QUIC_BUFFER * const Buffers,
-    _In_ uint32_t BufferCount,
-    _In_ QUIC_SEND_FLAGS Flags,
-    _In_opt_ void* ClientSendContext
+QuicStreamQueueApiSendRequest(
+    _In_ QUIC_STREAM* Stream,
+    _In_ __drv_aliasesMem QUIC_SEND_REQUEST* SendRequest,
+    _In_ BOOLEAN SendInline,
+    _Out_ BOOLEAN* FlushNeeded
     )
 {
     QUIC_STATUS Status;
-    QUIC_STREAM* Stream;
-    QUIC_CONNECTION* Connection;
-    uint64_t TotalLength;
-    QUIC_SEND_REQUEST* SendRequest;
-    BOOLEAN QueueOper = TRUE;
-    const BOOLEAN IsPriority = !!(Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
-    BOOLEAN SendInline;
-    QUIC_OPERATION* Oper;
+    QUIC_CONNECTION* Connection = Stream->Connection;
 
     QuicTraceEvent(
-        ApiEnter,
-        "[ api] Enter %u (%p).",
-        QUIC_TRACE_API_STREAM_SEND,
-        Handle);
+        StreamAppSend,
+        "[strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]",
+        Stream,
+        SendRequest->TotalLength,
+        SendRequest->BufferCount,
+        SendRequest->Flags);
 
-    if (!IS_STREAM_HANDLE(Handle) ||
-        (Buffers == NULL && BufferCount != 0)) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Exit;
+    SendRequest->Next = NULL;
+    SendRequest->QueueTime = CxPlatTimeUs64();
+
+    CxPlatDispatchLockAcquire(&Stream->ApiSendRequestLock);
+    if (!Stream->Flags.SendEnabled) {
+        Status =
+            (Connection->State.ClosedRemotely || Stream->Flags.ReceivedStopSending) ?
+                QUIC_STATUS_ABORTED :
+                QUIC_STATUS_INVALID_STATE;
+    } else {
+        BOOLEAN QueueOper = TRUE;
+        QUIC_SEND_REQUEST** ApiSendRequestsTail = &Stream->ApiSendRequests;
+        while (*ApiSendRequestsTail != NULL) {
+            ApiSendRequestsTail = &((*ApiSendRequestsTail)->Next);
+            QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
+        }
+        *ApiSendRequestsTail = SendRequest;
+        Status = QUIC_STATUS_SUCCESS;
+
+        if (!SendInline && QueueOper) {
+            //
+            // Async stream operations need to hold a ref on the stream so that
+            // the stream isn't freed before the operation can be processed. The
+            // ref is released after the operation is processed.
+            //
+            QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+        }
+        *FlushNeeded = QueueOper;
     }
+    CxPlatDispatchLockRelease(&Stream->ApiSendRequestLock);
 
-#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
-    Stream = (QUIC_STREAM*)Handle;
+    if (QUIC_FAILED(Status)) {
+        CxPlatPoolFree(SendRequest);
+    }
 
-    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
-    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+    return Status;
+}
 
-    Connection = Stream->Connection;
+//
+// Validates an app send and appends it to the stream's pending API sends. On
+// success, FlushNeeded indicates the caller must flush the stream's sends,
+// because none were pending already. If not sending inline, a stream reference
+// is then held for the operation that will do so.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_STATUS
+QuicStreamQueueApiSend(
+    _In_ QUIC_STREAM* Stream,
+    _In_reads_(BufferCount)
+        const QUIC_BUFFER * const Buffers,
+    _In_ uint32_t BufferCount,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext,
+    _In_ BOOLEAN SendInline,
+    _Out_ BOOLEAN* FlushNeeded
+    )
+{
+    QUIC_CONNECTION* Connection = Stream->Connection;
+    uint64_t TotalLength;
+    QUIC_SEND_REQUEST* SendRequest;
+
+    *FlushNeeded = FALSE;
 
     if (Connection->State.ClosedRemotely) {
-        Status = QUIC_STATUS_ABORTED;
-        goto Exit;
+        return QUIC_STATUS_ABORTED;
     }
 
     TotalLength = 0;
@@ -1118,94 +1207,73 @@ MsQuicStreamSend(
             "[strm][%p] ERROR, %s.",
             Stream,
             "Send request total length exceeds max");
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Exit;
+        return QUIC_STATUS_INVALID_PARAMETER;
     }
 
 #pragma prefast(suppress: __WARNING_6014, "Memory is correctly freed (QuicStreamCompleteSendRequest).")
     SendRequest = CxPlatPoolAlloc(&Connection->Partition->SendRequestPool);
     if (SendRequest == NULL) {
-        Status = QUIC_STATUS_OUT_OF_MEMORY;
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
             "Stream Send request",
             0);
-        goto Exit;
+        return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
-    QuicTraceEvent(
-        StreamAppSend,
-        "[strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]",
-        Stream,
-        TotalLength,
-        BufferCount,
-        Flags);
-
-    SendRequest->Next = NULL;
     SendRequest->Buffers = Buffers;
     SendRequest->BufferCount = BufferCount;
     SendRequest->Flags = Flags & ~QUIC_SEND_FLAGS_INTERNAL;
     SendRequest->TotalLength = TotalLength;
     SendRequest->ClientContext = ClientSendContext;
 
-#pragma warning(push)
-#pragma warning(disable:6240) // CXPLAT_AT_DISPATCH only really does anything for kernel mode
-    SendInline =
-        !Connection->Settings.SendBufferingEnabled &&
-        !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
-        Connection->WorkerThreadID == CxPlatCurThreadID();
-#pragma warning(pop)
+    return
+        QuicStreamQueueApiSendRequest(
+            Stream, SendRequest, SendInline, FlushNeeded);
+}
 
-    CxPlatDispatchLockAcquire(&Stream->ApiSendRequestLock);
-    if (!Stream->Flags.SendEnabled) {
-        Status =
-            (Connection->State.ClosedRemotely || Stream->Flags.ReceivedStopSending) ?
-                QUIC_STATUS_ABORTED :
-                QUIC_STATUS_INVALID_STATE;
-    } else {
-        QUIC_SEND_REQUEST** ApiSendRequestsTail = &Stream->ApiSendRequests;
-        while (*ApiSendRequestsTail != NULL) {
-            ApiSendRequestsTail = &((*ApiSendRequestsTail)->Next);
-            QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
-        }
-        *ApiSendRequestsTail = SendRequest;
-        Status = QUIC_STATUS_SUCCESS;
+//
+// Flushes the stream's pending API sends inline on the connection's worker.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicStreamFlushApiSendInline(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    CXPLAT_PASSIVE_CODE();
 
-        if (!SendInline && QueueOper) {
-            //
-            // Async stream operations need to hold a ref on the stream so that
-            // the stream isn't freed before the operation can be processed. The
-            // ref is released after the operation is processed.
-            //
-            QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
-        }
+    QUIC_CONNECTION* Connection = Stream->Connection;
+    BOOLEAN AlreadyInline = Connection->State.InlineApiExecution;
+    if (!AlreadyInline) {
+        Connection->State.InlineApiExecution = TRUE;
     }
-    CxPlatDispatchLockRelease(&Stream->ApiSendRequestLock);
-
-    if (QUIC_FAILED(Status)) {
-        CxPlatPoolFree(SendRequest);
-        goto Exit;
+    QuicStreamSendFlush(Stream);
+    if (!AlreadyInline) {
+        Connection->State.InlineApiExecution = FALSE;
     }
+}
 
-    //
-    // From here on, we cannot fail the call because the stream has been queued
-    // and possibly already started to be processed.
-    //
-    Status = QUIC_STATUS_PENDING;
+//
+// Gets the stream's newly queued API sends flushed, either inline or by queuing
+// a STRM_SEND operation.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicStreamFlushApiSend(
+    _In_ QUIC_STREAM* Stream,
+    _In_ BOOLEAN IsPriority,
+    _In_ BOOLEAN SendInline,
+    _In_ BOOLEAN QueueOper
+    )
+{
+    QUIC_CONNECTION* Connection = Stream->Connection;
+    QUIC_OPERATION* Oper;
 
     if (SendInline) {
-
-        CXPLAT_PASSIVE_CODE();
-
-        BOOLEAN AlreadyInline = Connection->State.InlineApiExecution;
-        if (!AlreadyInline) {
-            Connection->State.InlineApiExecution = TRUE;
-        }
-        QuicStreamSendFlush(Stream);
-        if (!AlreadyInline) {
-            Connection->State.InlineApiExecution = FALSE;
-        }
+        QuicStreamFlushApiSendInline(Stream);
 
     } else if (QueueOper) {
         Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
@@ -1229,7 +1297,7 @@ MsQuicStreamSend(
             //
             if (InterlockedCompareExchange16(
                     (short*)&Connection->BackUpOperUsed, 1, 0) != 0) {
-                goto Exit; // It's already started the shutdown.
+                return; // It's already started the shutdown.
             }
             Oper = &Connection->BackUpOper;
             Oper->FreeAfterProcess = FALSE;
@@ -1242,7 +1310,7 @@ MsQuicStreamSend(
             Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = FALSE;
             Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = TRUE;
             QuicConnQueueHighestPriorityOper(Connection, Oper);
-            goto Exit;
+            return;
         }
 
         Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_SEND;
@@ -1258,6 +1326,467 @@ MsQuicStreamSend(
         }
     }
 
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamSend(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_reads_(BufferCount) _Pre_defensive_
+        const QUIC_BUFFER * const Buffers,
+    _In_ uint32_t BufferCount,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_STREAM* Stream;
+    QUIC_CONNECTION* Connection;
+    BOOLEAN QueueOper;
+    const BOOLEAN IsPriority = !!(Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+    BOOLEAN SendInline;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_STREAM_SEND,
+        Handle);
+
+    if (!IS_STREAM_HANDLE(Handle) ||
+        (Buffers == NULL && BufferCount != 0)) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Exit;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Stream = (QUIC_STREAM*)Handle;
+
+    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+
+    Connection = Stream->Connection;
+    SendInline = QuicConnCanExecuteInline(Connection);
+
+    Status =
+        QuicStreamQueueApiSend(
+            Stream,
+            Buffers,
+            BufferCount,
+            Flags,
+            ClientSendContext,
+            SendInline,
+            &QueueOper);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    //
+    // From here on, we cannot fail the call because the stream has been queued
+    // and possibly already started to be processed.
+    //
+    Status = QUIC_STATUS_PENDING;
+
+    QuicStreamFlushApiSend(Stream, IsPriority, SendInline, QueueOper);
+
+Exit:
+
+    QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+
+    return Status;
+}
+
+#ifndef _KERNEL_MODE
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamSendFile(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t FileOffset,
+    _In_ uint64_t Length,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_STREAM* Stream;
+    QUIC_CONNECTION* Connection;
+    QUIC_SEND_REQUEST* SendRequest;
+    BOOLEAN QueueOper;
+    const BOOLEAN IsPriority = !!(Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+    BOOLEAN SendInline;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_STREAM_SEND_FILE,
+        Handle);
+
+    if (!IS_STREAM_HANDLE(Handle) ||
+        File == QUIC_FILE_HANDLE_INVALID ||
+        Length > UINT32_MAX ||
+        FileOffset > UINT64_MAX - Length) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Exit;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Stream = (QUIC_STREAM*)Handle;
+
+    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+
+    Connection = Stream->Connection;
+    if (Connection->State.ClosedRemotely) {
+        Status = QUIC_STATUS_ABORTED;
+        goto Exit;
+    }
+
+#pragma prefast(suppress: __WARNING_6014, "Memory is correctly freed (QuicStreamCompleteSendRequest).")
+    SendRequest = CxPlatPoolAlloc(&Connection->Partition->SendRequestPool);
+    if (SendRequest == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Stream Send request",
+            0);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    //
+    // The request is described as a single buffer without data, which is only
+    // read from the file as it is framed. It is never buffered.
+    //
+    SendRequest->InternalBuffer.Buffer = NULL;
+    SendRequest->InternalBuffer.Length = (uint32_t)Length;
+    SendRequest->Buffers = &SendRequest->InternalBuffer;
+    SendRequest->BufferCount = 1;
+    SendRequest->Flags = (Flags & ~QUIC_SEND_FLAGS_INTERNAL) | QUIC_SEND_FLAG_FROM_FILE;
+    SendRequest->TotalLength = Length;
+    SendRequest->ClientContext = ClientSendContext;
+    SendRequest->File = File;
+    SendRequest->FileOffset = FileOffset;
+
+    SendInline = QuicConnCanExecuteInline(Connection);
+
+    Status =
+        QuicStreamQueueApiSendRequest(
+            Stream, SendRequest, SendInline, &QueueOper);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    Status = QUIC_STATUS_PENDING;
+
+    QuicStreamFlushApiSend(Stream, IsPriority, SendInline, QueueOper);
+
+Exit:
+
+    QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+
+    return Status;
+}
+#endif // _KERNEL_MODE
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionSendBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ uint32_t EntryCount,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_SEND_BATCH_ENTRY* Entries
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_CONNECTION* Connection;
+    BOOLEAN SendInline;
+    BOOLEAN IsPriority = FALSE;
+    QUIC_OPERATION* Oper = NULL;
+    QUIC_STREAM** Streams = NULL;
+    uint32_t StreamCount = 0;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_CONNECTION_SEND_BATCH,
+        Handle);
+
+    if (!IS_CONN_HANDLE(Handle) ||
+        Entries == NULL ||
+        EntryCount == 0) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Exit;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Connection = (QUIC_CONNECTION*)Handle;
+
+    CXPLAT_TEL_ASSERT(!Connection->State.Freed);
+
+    SendInline = QuicConnCanExecuteInline(Connection);
+
+    if (!SendInline) {
+        //
+        // Allocate everything needed to flush the sends up front, so that once
+        // any are queued nothing can fail.
+        //
+        Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
+        if (Oper == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "CONN_SEND_BATCH operation",
+                0);
+            goto Exit;
+        }
+
+        Streams =
+            CXPLAT_ALLOC_NONPAGED(
+                sizeof(QUIC_STREAM*) * (size_t)EntryCount,
+                QUIC_POOL_SEND_BATCH);
+        if (Streams == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "CONN_SEND_BATCH streams",
+                sizeof(QUIC_STREAM*) * (size_t)EntryCount);
+            Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SEND_BATCH;
+            Oper->API_CALL.Context->CONN_SEND_BATCH.Streams = NULL;
+            Oper->API_CALL.Context->CONN_SEND_BATCH.StreamCount = 0;
+            QuicOperationFree(Oper);
+            goto Exit;
+        }
+    }
+
+    Status = QUIC_STATUS_PENDING;
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        QUIC_SEND_BATCH_ENTRY* Entry = &Entries[i];
+        QUIC_STREAM* Stream = (QUIC_STREAM*)Entry->Stream;
+        BOOLEAN FlushNeeded;
+
+        if (!IS_STREAM_HANDLE(Entry->Stream) ||
+            Stream->Connection != Connection ||
+            (Entry->Buffers == NULL && Entry->BufferCount != 0)) {
+            Entry->Status = QUIC_STATUS_INVALID_PARAMETER;
+        } else {
+            CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+            CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+            Entry->Status =
+                QuicStreamQueueApiSend(
+                    Stream,
+                    Entry->Buffers,
+                    Entry->BufferCount,
+                    Entry->Flags,
+                    Entry->ClientSendContext,
+                    SendInline,
+                    &FlushNeeded);
+        }
+
+        if (QUIC_FAILED(Entry->Status)) {
+            if (Status == QUIC_STATUS_PENDING) {
+                Status = Entry->Status;
+            }
+            continue;
+        }
+
+        Entry->Status = QUIC_STATUS_PENDING;
+        if (Entry->Flags & QUIC_SEND_FLAG_PRIORITY_WORK) {
+            IsPriority = TRUE;
+        }
+
+        if (SendInline) {
+            QuicStreamFlushApiSendInline(Stream);
+        } else if (FlushNeeded) {
+            Streams[StreamCount++] = Stream;
+        }
+    }
+
+    if (Oper != NULL) {
+        Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SEND_BATCH;
+        Oper->API_CALL.Context->CONN_SEND_BATCH.Streams = Streams;
+        Oper->API_CALL.Context->CONN_SEND_BATCH.StreamCount = StreamCount;
+
+        if (StreamCount == 0) {
+            QuicOperationFree(Oper); // Every stream already had a flush pending.
+        } else if (IsPriority) {
+            QuicConnQueuePriorityOper(Connection, Oper);
+        } else {
+            QuicConnQueueOper(Connection, Oper);
+        }
+    }
+
+Exit:
+
+    QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamOpenBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ QUIC_STREAM_OPEN_FLAGS OpenFlags,
+    _In_ QUIC_STREAM_START_FLAGS StartFlags,
+    _In_ _Pre_defensive_ QUIC_STREAM_CALLBACK_HANDLER Handler,
+    _In_ uint32_t EntryCount,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_STREAM_OPEN_BATCH_ENTRY* Entries
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_CONNECTION* Connection;
+    BOOLEAN IsPriority = !!(StartFlags & QUIC_STREAM_START_FLAG_PRIORITY_WORK);
+    QUIC_OPERATION* Oper;
+    QUIC_STREAM** Streams;
+    uint32_t StreamCount = 0;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_STREAM_OPEN_BATCH,
+        Handle);
+
+    if (!IS_CONN_HANDLE(Handle) ||
+        Handler == NULL ||
+        Entries == NULL ||
+        EntryCount == 0) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Exit;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Connection = (QUIC_CONNECTION*)Handle;
+
+    QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+
+    BOOLEAN ClosedLocally = Connection->State.ClosedLocally;
+    if (ClosedLocally || Connection->State.ClosedRemotely) {
+        Status =
+            ClosedLocally ?
+            QUIC_STATUS_INVALID_STATE :
+            QUIC_STATUS_ABORTED;
+        goto Exit;
+    }
+
+    //
+    // Allocate everything needed to start the streams up front, so that once
+    // any are opened nothing can fail.
+    //
+    Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
+    if (Oper == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "STRM_START_BATCH operation",
+            0);
+        goto Exit;
+    }
+
+    Streams =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_STREAM*) * (size_t)EntryCount,
+            QUIC_POOL_SEND_BATCH);
+    if (Streams == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "STRM_START_BATCH streams",
+            sizeof(QUIC_STREAM*) * (size_t)EntryCount);
+        Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_START_BATCH;
+        Oper->API_CALL.Context->STRM_START_BATCH.Streams = NULL;
+        Oper->API_CALL.Context->STRM_START_BATCH.StreamCount = 0;
+        QuicOperationFree(Oper);
+        goto Exit;
+    }
+
+    Status = QUIC_STATUS_PENDING;
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        QUIC_STREAM_OPEN_BATCH_ENTRY* Entry = &Entries[i];
+        QUIC_STREAM* Stream;
+        BOOLEAN FlushNeeded;
+
+        Entry->Stream = NULL;
+
+        if (Entry->Buffers == NULL && Entry->BufferCount != 0) {
+            Entry->Status = QUIC_STATUS_INVALID_PARAMETER;
+            goto EntryFailed;
+        }
+
+        Entry->Status = QuicStreamInitialize(Connection, FALSE, OpenFlags, &Stream);
+        if (QUIC_FAILED(Entry->Status)) {
+            goto EntryFailed;
+        }
+
+        Stream->ClientCallbackHandler = Handler;
+        Stream->ClientContext = Entry->Context;
+        Entry->Stream = (HQUIC)Stream;
+
+        if (Entry->BufferCount != 0 || Entry->Flags != QUIC_SEND_FLAG_NONE) {
+            Entry->Status =
+                QuicStreamQueueApiSend(
+                    Stream,
+                    Entry->Buffers,
+                    Entry->BufferCount,
+                    Entry->Flags,
+                    Entry->ClientSendContext,
+                    TRUE, // The operation takes its own reference below.
+                    &FlushNeeded);
+            if (QUIC_FAILED(Entry->Status)) {
+                goto EntryFailed; // Opened but not started; the app still closes it.
+            }
+            if (Entry->Flags & QUIC_SEND_FLAG_PRIORITY_WORK) {
+                IsPriority = TRUE;
+            }
+        }
+
+        //
+        // The operation holds a ref on each stream until it is processed.
+        //
+        QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+        Streams[StreamCount++] = Stream;
+        Entry->Status = QUIC_STATUS_PENDING;
+        continue;
+
+EntryFailed:
+
+        if (Status == QUIC_STATUS_PENDING) {
+            Status = Entry->Status;
+        }
+    }
+
+    Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_START_BATCH;
+    Oper->API_CALL.Context->STRM_START_BATCH.Streams = Streams;
+    Oper->API_CALL.Context->STRM_START_BATCH.StreamCount = StreamCount;
+    Oper->API_CALL.Context->STRM_START_BATCH.Flags = StartFlags;
+
+    if (StreamCount == 0) {
+        QuicOperationFree(Oper);
+    } else if (IsPriority) {
+        QuicConnQueuePriorityOper(Connection, Oper);
+    } else {
+        QuicConnQueueOper(Connection, Oper);
+    }
+
 Exit:
 
     QuicTraceEvent(
@@ -1903,6 +2432,7 @@ MsQuicDatagramSend(
     SendRequest->Flags = Flags;
     SendRequest->TotalLength = TotalLength;
     SendRequest->ClientContext = ClientSendContext;
+    SendRequest->QueueTime = CxPlatTimeUs64();
 
     Status = QuicDatagramQueueSend(&Connection->Datagram, SendRequest);
 
@@ -38,6 +38,16 @@ MsQuicExecutionPoll(
     _In_ QUIC_EXECUTION* Execution
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+QUIC_API
+MsQuicExecutionPollBatch(
+    _In_ uint32_t Count,
+    _In_reads_(Count) QUIC_EXECUTION** Executions,
+    _In_ uint32_t TimeBudgetUs,
+    _In_ uint32_t RunBudget
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -263,6 +273,43 @@ MsQuicStreamSend(
     _In_opt_ void* ClientSendContext
     );
 
+#ifndef _KERNEL_MODE
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamSendFile(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t FileOffset,
+    _In_ uint64_t Length,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    );
+#endif
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionSendBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ uint32_t EntryCount,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_SEND_BATCH_ENTRY* Entries
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamOpenBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ QUIC_STREAM_OPEN_FLAGS OpenFlags,
+    _In_ QUIC_STREAM_START_FLAGS StartFlags,
+    _In_ _Pre_defensive_ QUIC_STREAM_CALLBACK_HANDLER Handler,
+    _In_ uint32_t EntryCount,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_STREAM_OPEN_BATCH_ENTRY* Entries
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QUIC_API
@@ -0,0 +1,111 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The arena carves objects out of fixed size chunks by simply bumping an
+    offset, so most allocations don't call into the allocator at all. A chunk
+    is only ever carved from while it is the newest one; whatever is left of
+    it is wasted once a new chunk is needed. This is fine for the small number
+    of small objects the arena is meant for.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "arena.c.clog.h"
+#endif
+
+struct QUIC_ARENA_CHUNK {
+
+    QUIC_ARENA_CHUNK* Next;
+
+    //
+    // The number of bytes in the chunk's buffer, and how many are in use.
+    //
+    uint32_t Length;
+    uint32_t Used;
+
+};
+
+#define QUIC_ARENA_ALIGN(Length) \
+    (((Length) + QUIC_ARENA_ALIGNMENT - 1) & ~(QUIC_ARENA_ALIGNMENT - 1))
+
+//
+// The buffer follows the chunk header, aligned.
+//
+#define QUIC_ARENA_CHUNK_HEADER_SIZE QUIC_ARENA_ALIGN(sizeof(QUIC_ARENA_CHUNK))
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicArenaInitialize(
+    _Out_ QUIC_ARENA* Arena
+    )
+{
+    Arena->Chunks = NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+_Post_writable_byte_size_(Size)
+void*
+QuicArenaAlloc(
+    _Inout_ QUIC_ARENA* Arena,
+    _In_ uint32_t Size
+    )
+{
+    CXPLAT_DBG_ASSERT(Size != 0);
+    if (Size > UINT32_MAX - QUIC_ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    const uint32_t AlignedSize = QUIC_ARENA_ALIGN(Size);
+
+    QUIC_ARENA_CHUNK* Chunk = Arena->Chunks;
+    if (Chunk == NULL || Chunk->Length - Chunk->Used < AlignedSize) {
+        const uint32_t Length = CXPLAT_MAX(AlignedSize, QUIC_ARENA_CHUNK_SIZE);
+        Chunk =
+            CXPLAT_ALLOC_NONPAGED(
+                (size_t)QUIC_ARENA_CHUNK_HEADER_SIZE + Length,
+                QUIC_POOL_ARENA);
+        if (Chunk == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "arena chunk",
+                (uint64_t)QUIC_ARENA_CHUNK_HEADER_SIZE + Length);
+            return NULL;
+        }
+        Chunk->Length = Length;
+        Chunk->Used = 0;
+
+        if (Arena->Chunks != NULL && AlignedSize > QUIC_ARENA_CHUNK_SIZE) {
+            //
+            // Keep carving from the current chunk after a large object.
+            //
+            Chunk->Next = Arena->Chunks->Next;
+            Arena->Chunks->Next = Chunk;
+        } else {
+            Chunk->Next = Arena->Chunks;
+            Arena->Chunks = Chunk;
+        }
+    }
+
+    void* Object = (uint8_t*)Chunk + QUIC_ARENA_CHUNK_HEADER_SIZE + Chunk->Used;
+    Chunk->Used += AlignedSize;
+    return Object;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicArenaReset(
+    _Inout_ QUIC_ARENA* Arena
+    )
+{
+    while (Arena->Chunks != NULL) {
+        QUIC_ARENA_CHUNK* Chunk = Arena->Chunks;
+        Arena->Chunks = Chunk->Next;
+        CXPLAT_FREE(Chunk, QUIC_POOL_ARENA);
+    }
+}
@@ -0,0 +1,72 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A simple bump allocator for objects that share a lifetime, such as those
+    only needed for the duration of a connection's handshake. Objects can't be
+    freed individually; they are all freed at once when the arena is reset.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The size of the chunks the arena allocates. Larger objects get a chunk of
+// their own.
+//
+#define QUIC_ARENA_CHUNK_SIZE       512
+
+//
+// All objects are aligned to this.
+//
+#define QUIC_ARENA_ALIGNMENT        16
+
+typedef struct QUIC_ARENA_CHUNK QUIC_ARENA_CHUNK;
+
+typedef struct QUIC_ARENA {
+
+    //
+    // The chunks allocated so far, newest first. Objects are only carved from
+    // the newest one.
+    //
+    QUIC_ARENA_CHUNK* Chunks;
+
+} QUIC_ARENA;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicArenaInitialize(
+    _Out_ QUIC_ARENA* Arena
+    );
+
+//
+// Allocates an uninitialized object, which stays valid until the next reset.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+_Post_writable_byte_size_(Size)
+void*
+QuicArenaAlloc(
+    _Inout_ QUIC_ARENA* Arena,
+    _In_ uint32_t Size
+    );
+
+//
+// Frees all the objects allocated from the arena.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicArenaReset(
+    _Inout_ QUIC_ARENA* Arena
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -39,7 +39,7 @@ typedef enum RECOVERY_STATE {
 //
 // Bandwidth is measured as (bytes / BW_UNIT) per second
 //
-#define BW_UNIT 8 // 1 << 3
+#define BW_UNIT QUIC_DELIVERY_RATE_UNIT // 1 << 3
 
 //
 // Gain is measured as (1 / GAIN_UNIT)
@@ -121,8 +121,6 @@ BbrBandwidthFilterOnPacketAcked(
         b->AppLimited = FALSE;
     }
 
-    uint64_t TimeNow = AckEvent->TimeNow;
-
     QUIC_SENT_PACKET_METADATA* AckedPacketsIterator = AckEvent->AckedPackets;
     while (AckedPacketsIterator != NULL) {
         QUIC_SENT_PACKET_METADATA* AckedPacket = AckedPacketsIterator;
@@ -132,47 +130,12 @@ BbrBandwidthFilterOnPacketAcked(
             continue;
         }
 
-        uint64_t SendRate = UINT64_MAX;
-        uint64_t AckRate = UINT64_MAX;
-
-        if (AckedPacket->Flags.HasLastAckedPacketInfo) {
-            CXPLAT_DBG_ASSERT(AckedPacket->TotalBytesSent >= AckedPacket->LastAckedPacketInfo.TotalBytesSent);
-            CXPLAT_DBG_ASSERT(CxPlatTimeAtOrBefore64(AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime));
-
-            uint64_t AckElapsed = 0;
-            uint64_t SendElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime);
-
-            if (SendElapsed) {
-                SendRate = (kMicroSecsInSec * BW_UNIT *
-                    (AckedPacket->TotalBytesSent - AckedPacket->LastAckedPacketInfo.TotalBytesSent) /
-                    SendElapsed);
-            }
-
-            if (!CxPlatTimeAtOrBefore64(AckEvent->AdjustedAckTime, AckedPacket->LastAckedPacketInfo.AdjustedAckTime)) {
-                AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AdjustedAckTime, AckEvent->AdjustedAckTime);
-            } else {
-                AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AckTime, TimeNow);
-            }
-
-            CXPLAT_DBG_ASSERT(AckEvent->NumTotalAckedRetransmittableBytes >= AckedPacket->LastAckedPacketInfo.TotalBytesAcked);
-            if (AckElapsed) {
-                AckRate = (kMicroSecsInSec * BW_UNIT *
-                           (AckEvent->NumTotalAckedRetransmittableBytes - AckedPacket->LastAckedPacketInfo.TotalBytesAcked) /
-                           AckElapsed);
-            }
-        } else if (!CxPlatTimeAtOrBefore64(TimeNow, AckedPacket->SentTime)) {
-            CXPLAT_DBG_ASSERT(CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow) != 0);
-            SendRate = (kMicroSecsInSec * BW_UNIT *
-                        AckEvent->NumTotalAckedRetransmittableBytes /
-                        CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow));
-        }
-
-        if (SendRate == UINT64_MAX && AckRate == UINT64_MAX) {
+        uint64_t DeliveryRate =
+            QuicCongestionControlSampleDeliveryRate(AckedPacket, AckEvent);
+        if (DeliveryRate == UINT64_MAX) {
             continue;
         }
 
-        uint64_t DeliveryRate = CXPLAT_MIN(SendRate, AckRate);
-
         QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry = (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY) { .Value = 0, .Time = 0 };
         QUIC_STATUS Status = QuicSlidingWindowExtremumGet(&b->WindowedMaxFilter, &Entry);
 
@@ -637,7 +600,7 @@ BbrCongestionControlGetSendAllowance(
 
     } else if (
         !TimeSinceLastSendValid ||
-        !Connection->Settings.PacingEnabled ||
+        !Connection->Settings->PacingEnabled ||
         Bbr->MinRtt == UINT32_MAX ||
         Bbr->MinRtt < QUIC_SEND_PACING_INTERVAL) {
         //
@@ -670,6 +633,33 @@ BbrCongestionControlGetSendAllowance(
     return SendAllowance;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+BbrCongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_CONGESTION_CONTROL_BBR* Bbr = &Cc->Bbr;
+
+    if (!Connection->Settings->PacingEnabled ||
+        Bbr->MinRtt == UINT32_MAX ||
+        Bbr->MinRtt < QUIC_SEND_PACING_INTERVAL) {
+        return 0;
+    }
+
+    return BbrCongestionControlGetBandwidth(Cc) * Bbr->PacingGain / GAIN_UNIT / BW_UNIT;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+BbrCongestionControlGetDeliveryRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return BbrCongestionControlGetBandwidth(Cc) / BW_UNIT;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 BbrCongestionControlTransitToProbeRtt(
@@ -783,7 +773,7 @@ BbrCongestionControlOnDataAcknowledged(
         BbrCongestionControlUpdateCongestionWindow(
             Cc, AckEvent->NumTotalAckedRetransmittableBytes, AckEvent->NumRetransmittableBytes);
 
-        if (Connection->Settings.NetStatsEventEnabled) {
+        if (Connection->Settings->NetStatsEventEnabled) {
             BbrCongestionControlIndicateConnectionEvent(Connection, Cc);
         }
         return BbrCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
@@ -817,6 +807,7 @@ BbrCongestionControlOnDataAcknowledged(
         AckEvent->AckedPackets == NULL ? FALSE : AckEvent->IsLargestAckedPacketAppLimited;
 
     BbrBandwidthFilterOnPacketAcked(&Bbr->BandwidthFilter, AckEvent, Bbr->RoundTripCounter);
+    QuicSendBufferConnectionAdjust(Connection);
 
     if (BbrCongestionControlInRecovery(Cc)) {
         CXPLAT_DBG_ASSERT(Bbr->EndOfRecoveryValid);
@@ -895,7 +886,7 @@ BbrCongestionControlOnDataAcknowledged(
     BbrCongestionControlUpdateCongestionWindow(
         Cc, AckEvent->NumTotalAckedRetransmittableBytes, AckEvent->NumRetransmittableBytes);
 
-    if (Connection->Settings.NetStatsEventEnabled) {
+    if (Connection->Settings->NetStatsEventEnabled) {
         BbrCongestionControlIndicateConnectionEvent(Connection, Cc);
     }
 
@@ -920,6 +911,7 @@ BbrCongestionControlOnDataLost(
         "[conn][%p] Congestion event: IsEcn=%hu",
         Connection,
         FALSE);
+    QuicTraceProbe(congestion_event, Connection, FALSE);
     Connection->Stats.Send.CongestionCount++;
 
     BOOLEAN PreviousCanSendState = BbrCongestionControlCanSend(Cc);
@@ -1065,10 +1057,13 @@ BbrCongestionControlReset(
 
 static const QUIC_CONGESTION_CONTROL QuicCongestionControlBbr = {
     .Name = "BBR",
+    .Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR,
     .QuicCongestionControlCanSend = BbrCongestionControlCanSend,
     .QuicCongestionControlSetExemption = BbrCongestionControlSetExemption,
     .QuicCongestionControlReset = BbrCongestionControlReset,
     .QuicCongestionControlGetSendAllowance = BbrCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = BbrCongestionControlGetPacingRate,
+    .QuicCongestionControlGetDeliveryRate = BbrCongestionControlGetDeliveryRate,
     .QuicCongestionControlGetCongestionWindow = BbrCongestionControlGetCongestionWindow,
     .QuicCongestionControlOnDataSent = BbrCongestionControlOnDataSent,
     .QuicCongestionControlOnDataInvalidated = BbrCongestionControlOnDataInvalidated,
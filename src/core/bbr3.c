@@ -0,0 +1,1609 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Bottleneck Bandwidth and RTT version 3 (BBRv3) congestion control.
+
+    Compared to BBR (bbr.c), BBRv3 reacts to loss and ECN: it keeps a long
+    term upper bound on inflight (InflightHi) learned when bandwidth probing
+    causes a loss rate above kBbr3LossThresh or ECN marks, and short term
+    lower bounds (InflightLo, BwLo) that back off each round with congestion.
+    ProbeBW is split into the DOWN, CRUISE, REFILL and UP phases.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "bbr3.c.clog.h"
+#endif
+
+//
+// Bandwidth is measured as (bytes / BW_UNIT) per second
+//
+#define BW_UNIT QUIC_DELIVERY_RATE_UNIT // 1 << 3
+
+//
+// Gain is measured as (1 / GAIN_UNIT)
+//
+#define GAIN_UNIT 256 // 1 << 8
+
+const uint64_t kBbr3QuantaFactor = 3;
+
+const uint32_t kBbr3MinCwndInMss = 4;
+
+const uint64_t kBbr3MicroSecsInSec = 1000000;
+
+const uint64_t kBbr3MilliSecsInSec = 1000;
+
+const uint64_t kBbr3LowPacingRateThresholdBytesPerSecond = 1200ULL * 1000;
+
+const uint64_t kBbr3HighPacingRateThresholdBytesPerSecond = 24ULL * 1000 * 1000;
+
+const uint32_t kBbr3StartupPacingGain = GAIN_UNIT * 277 / 100 + 1; // 4 * ln(2)
+
+const uint32_t kBbr3StartupCwndGain = GAIN_UNIT * 2;
+
+const uint32_t kBbr3DrainPacingGain = GAIN_UNIT * 35 / 100;
+
+const uint32_t kBbr3ProbeBwCwndGain = GAIN_UNIT * 2;
+
+const uint32_t kBbr3ProbeBwDownPacingGain = GAIN_UNIT * 90 / 100;
+
+const uint32_t kBbr3ProbeBwUpPacingGain = GAIN_UNIT * 5 / 4;
+
+const uint32_t kBbr3ProbeRttCwndGain = GAIN_UNIT / 2;
+
+//
+// The maximum tolerated per-round loss rate while probing for bandwidth.
+//
+const uint32_t kBbr3LossThresh = GAIN_UNIT * 2 / 100;
+
+//
+// The number of loss events in a round required to exit STARTUP on loss.
+//
+const uint32_t kBbr3StartupFullLossCount = 6;
+
+//
+// The multiplicative decrease applied to the lower bounds on congestion.
+//
+const uint32_t kBbr3Beta = GAIN_UNIT * 7 / 10;
+
+//
+// Fraction of InflightHi left unused while cruising, so other flows can grab
+// bandwidth.
+//
+const uint32_t kBbr3Headroom = GAIN_UNIT * 15 / 100;
+
+//
+// The expected of bandwidth growth in each round trip time during STARTUP
+//
+const uint32_t kBbr3StartupGrowthTarget = GAIN_UNIT * 5 / 4;
+
+//
+// How many rounds of rtt to stay in STARTUP when the bandwidth isn't growing as
+// fast as kBbr3StartupGrowthTarget
+//
+const uint8_t kBbr3StartupSlowGrowRoundLimit = 3;
+
+//
+// Upper bound on the number of rounds between bandwidth probes, used to stay
+// fair with Reno/Cubic flows.
+//
+const uint32_t kBbr3MaxRenoCoexistenceRounds = 63;
+
+//
+// Base and random part of the wall clock time between bandwidth probes.
+//
+const uint64_t kBbr3ProbeWaitBaseInUs = S_TO_US(2);
+const uint32_t kBbr3ProbeWaitRandomInUs = 1000 * 1000;
+
+//
+// During ProbeRtt, we need to stay in low inflight condition for at least
+// kBbr3ProbeRttTimeInUs
+//
+const uint32_t kBbr3ProbeRttTimeInUs = 200 * 1000;
+
+//
+// How often to enter ProbeRtt when the min RTT isn't refreshed otherwise.
+//
+const uint64_t kBbr3ProbeRttIntervalInUs = S_TO_US(5);
+
+//
+// Time until a MinRtt measurement is expired.
+//
+const uint64_t kBbr3MinRttExpirationInUs = S_TO_US(10);
+
+//
+// The max bandwidth filter covers the current and the previous ProbeBW cycle.
+//
+const uint32_t kBbr3MaxBwFilterLen = 1;
+
+const uint32_t kBbr3ExtraAckedFilterLen = 10;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetMinCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    return kBbr3MinCwndInMss * QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetMaxBandwidth(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry = (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY) { .Value = 0, .Time = 0 };
+    QUIC_STATUS Status = QuicSlidingWindowExtremumGet(&Cc->Bbr3.MaxBwFilter, &Entry);
+    if (QUIC_SUCCEEDED(Status)) {
+        return Entry.Value;
+    }
+    return 0;
+}
+
+//
+// The bandwidth used by the model: the max bandwidth, bounded by the short
+// term lower bound learned from congestion.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetBandwidth(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return CXPLAT_MIN(Bbr3CongestionControlGetMaxBandwidth(Cc), Cc->Bbr3.BwLo);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.AppLimited;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsProbingBandwidth(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return
+        Cc->Bbr3.State == BBR3_STATE_STARTUP ||
+        Cc->Bbr3.State == BBR3_STATE_PROBE_BW_REFILL ||
+        Cc->Bbr3.State == BBR3_STATE_PROBE_BW_UP;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnLogBbr3(
+    _In_ QUIC_CONNECTION* const Connection
+    )
+{
+    QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    QuicTraceEvent(
+        ConnBbr,
+        "[conn][%p] BBR: State=%u RState=%u CongestionWindow=%u BytesInFlight=%u BytesInFlightMax=%u MinRttEst=%lu EstBw=%lu AppLimited=%u",
+        Connection,
+        Bbr3->State,
+        Bbr3->InRecovery,
+        Bbr3CongestionControlGetCongestionWindow(Cc),
+        Bbr3->BytesInFlight,
+        Bbr3->BytesInFlightMax,
+        Bbr3->MinRtt,
+        Bbr3CongestionControlGetBandwidth(Cc) / BW_UNIT,
+        Bbr3CongestionControlIsAppLimited(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlGetNetworkStatistics(
+    _In_ const QUIC_CONNECTION* const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL* const Cc,
+    _Out_ QUIC_NETWORK_STATISTICS* NetworkStatistics
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+    const QUIC_PATH* Path = &Connection->Paths[0];
+
+    NetworkStatistics->BytesInFlight = Bbr3->BytesInFlight;
+    NetworkStatistics->PostedBytes = Connection->SendBuffer.PostedBytes;
+    NetworkStatistics->IdealBytes = Connection->SendBuffer.IdealBytes;
+    NetworkStatistics->SmoothedRTT = Path->SmoothedRtt;
+    NetworkStatistics->CongestionWindow = Bbr3CongestionControlGetCongestionWindow(Cc);
+    NetworkStatistics->Bandwidth = Bbr3CongestionControlGetBandwidth(Cc) / BW_UNIT;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlIndicateConnectionEvent(
+    _In_ QUIC_CONNECTION* const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONNECTION_EVENT Event;
+    Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+
+    Bbr3CongestionControlGetNetworkStatistics(Connection, Cc, &Event.NETWORK_STATISTICS);
+
+    QuicTraceLogConnVerbose(
+        IndicateDataAcked,
+        Connection,
+        "Indicating QUIC_CONNECTION_EVENT_NETWORK_STATISTICS [BytesInFlight=%u,PostedBytes=%llu,IdealBytes=%llu,SmoothedRTT=%llu,CongestionWindow=%u,Bandwidth=%llu]",
+        Event.NETWORK_STATISTICS.BytesInFlight,
+        Event.NETWORK_STATISTICS.PostedBytes,
+        Event.NETWORK_STATISTICS.IdealBytes,
+        Event.NETWORK_STATISTICS.SmoothedRTT,
+        Event.NETWORK_STATISTICS.CongestionWindow,
+        Event.NETWORK_STATISTICS.Bandwidth);
+    QuicConnIndicateEvent(Connection, &Event);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return
+        Cc->Bbr3.BytesInFlight < Bbr3CongestionControlGetCongestionWindow(Cc) ||
+        Cc->Bbr3.Exemptions > 0;
+}
+
+void
+Bbr3CongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Bbr3->BytesInFlight,
+        Bbr3->CongestionWindow,
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+
+    if (PreviousCanSendState != Bbr3CongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+Bbr3CongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Bbr3.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    if (!Bbr3->BytesInFlight && Bbr3CongestionControlIsAppLimited(Cc)) {
+        Bbr3->ExitingQuiescence = TRUE;
+    }
+
+    Bbr3->BytesInFlight += NumRetransmittableBytes;
+    if (Bbr3->BytesInFlightMax < Bbr3->BytesInFlight) {
+        Bbr3->BytesInFlightMax = Bbr3->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (Bbr3->Exemptions > 0) {
+        --Bbr3->Exemptions;
+    }
+
+    Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Bbr3->BytesInFlight >= NumRetransmittableBytes);
+    Bbr3->BytesInFlight -= NumRetransmittableBytes;
+
+    return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+//
+// The estimated BDP scaled by Gain, in bytes.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetBdp(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t Gain
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    uint64_t Bandwidth = Bbr3CongestionControlGetBandwidth(Cc);
+
+    if (!Bandwidth || Bbr3->MinRtt == UINT64_MAX) {
+        return (uint64_t)Gain * Bbr3->InitialCongestionWindow / GAIN_UNIT;
+    }
+
+    uint64_t Bdp = Bandwidth * Bbr3->MinRtt / kBbr3MicroSecsInSec / BW_UNIT;
+    return Bdp * Gain / GAIN_UNIT;
+}
+
+//
+// The inflight needed to fully use the estimated BDP scaled by Gain, including
+// the allowance for send/ack aggregation in the stack.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetTargetInflight(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t Gain
+    )
+{
+    return Bbr3CongestionControlGetBdp(Cc, Gain) + kBbr3QuantaFactor * Cc->Bbr3.SendQuantum;
+}
+
+//
+// InflightHi minus some headroom, used while cruising so that new flows can
+// grab bandwidth.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetInflightWithHeadroom(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (Bbr3->InflightHi == UINT32_MAX) {
+        return UINT32_MAX;
+    }
+
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    uint32_t Headroom = (uint32_t)((uint64_t)Bbr3->InflightHi * kBbr3Headroom / GAIN_UNIT);
+    Headroom = CXPLAT_MAX(Headroom, DatagramPayloadLength);
+
+    uint32_t MinCongestionWindow = Bbr3CongestionControlGetMinCongestionWindow(Cc);
+    return
+        Bbr3->InflightHi > Headroom + MinCongestionWindow ?
+            Bbr3->InflightHi - Headroom : MinCongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartRound(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    Cc->Bbr3.EndOfRoundTrip = Connection->LossDetection.LargestSentPacketNumber;
+    Cc->Bbr3.EndOfRoundTripValid = TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlResetLowerBounds(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    Cc->Bbr3.BwLo = UINT64_MAX;
+    Cc->Bbr3.InflightLo = UINT32_MAX;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlResetCongestionSignals(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3->LossInRound = FALSE;
+    Bbr3->EcnInRound = FALSE;
+    Bbr3->DeliveredInRound = 0;
+    Bbr3->LostInRound = 0;
+    Bbr3->LossEventsInRound = 0;
+    Bbr3->BwLatest = 0;
+    Bbr3->InflightLatest = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlEnterStartup(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    Cc->Bbr3.State = BBR3_STATE_STARTUP;
+    Cc->Bbr3.PacingGain = kBbr3StartupPacingGain;
+    Cc->Bbr3.CwndGain = kBbr3StartupCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlEnterDrain(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    Cc->Bbr3.State = BBR3_STATE_DRAIN;
+    Cc->Bbr3.PacingGain = kBbr3DrainPacingGain;
+    Cc->Bbr3.CwndGain = kBbr3StartupCwndGain;
+}
+
+//
+// Randomize the time until the next bandwidth probe so that flows sharing a
+// bottleneck don't probe in lockstep.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlPickProbeWait(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    uint32_t RandomValue = 0;
+    CxPlatRandom(sizeof(uint32_t), &RandomValue);
+
+    Cc->Bbr3.RoundsSinceBwProbe = RandomValue & 1;
+    Cc->Bbr3.BwProbeWait =
+        kBbr3ProbeWaitBaseInUs + ((RandomValue >> 1) % kBbr3ProbeWaitRandomInUs);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwDown(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3CongestionControlResetCongestionSignals(Cc);
+    Bbr3->ProbeUpCount = UINT32_MAX;
+    Bbr3CongestionControlPickProbeWait(Cc);
+    Bbr3->CycleStart = TimeNow;
+    Bbr3->CycleCount++; // Advances the max bandwidth filter.
+    Bbr3CongestionControlStartRound(Cc);
+
+    Bbr3->State = BBR3_STATE_PROBE_BW_DOWN;
+    Bbr3->PacingGain = kBbr3ProbeBwDownPacingGain;
+    Bbr3->CwndGain = kBbr3ProbeBwCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwCruise(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    Cc->Bbr3.State = BBR3_STATE_PROBE_BW_CRUISE;
+    Cc->Bbr3.PacingGain = GAIN_UNIT;
+    Cc->Bbr3.CwndGain = kBbr3ProbeBwCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwRefill(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3CongestionControlResetLowerBounds(Cc);
+    Bbr3->BwProbeUpRounds = 0;
+    Bbr3->BwProbeUpAcks = 0;
+    Bbr3->BwProbeSamples = FALSE;
+    Bbr3CongestionControlStartRound(Cc);
+
+    Bbr3->State = BBR3_STATE_PROBE_BW_REFILL;
+    Bbr3->PacingGain = GAIN_UNIT;
+    Bbr3->CwndGain = kBbr3ProbeBwCwndGain;
+}
+
+//
+// Doubles the per-round growth of InflightHi each round spent in ProbeBW_UP.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlRaiseInflightHiSlope(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    uint64_t GrowthThisRound = (uint64_t)DatagramPayloadLength << Bbr3->BwProbeUpRounds;
+    Bbr3->BwProbeUpRounds = CXPLAT_MIN(Bbr3->BwProbeUpRounds + 1, 30);
+    Bbr3->ProbeUpCount =
+        (uint32_t)CXPLAT_MAX(Bbr3->CongestionWindow / GrowthThisRound, 1);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwUp(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3->BwProbeSamples = TRUE;
+    Bbr3CongestionControlStartRound(Cc);
+    Bbr3->CycleStart = TimeNow;
+
+    Bbr3->State = BBR3_STATE_PROBE_BW_UP;
+    Bbr3->PacingGain = kBbr3ProbeBwUpPacingGain;
+    Bbr3->CwndGain = kBbr3ProbeBwCwndGain;
+
+    Bbr3CongestionControlRaiseInflightHiSlope(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlEnterProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (!Bbr3->InRecovery) {
+        Bbr3->PriorCongestionWindow = Bbr3->CongestionWindow;
+    }
+
+    Bbr3->State = BBR3_STATE_PROBE_RTT;
+    Bbr3->PacingGain = GAIN_UNIT;
+    Bbr3->CwndGain = kBbr3ProbeRttCwndGain;
+    Bbr3->ProbeRttDoneTimestampValid = FALSE;
+    Bbr3->ProbeRttRoundDone = FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlExitProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3CongestionControlResetLowerBounds(Cc);
+    Bbr3->CongestionWindow = CXPLAT_MAX(Bbr3->CongestionWindow, Bbr3->PriorCongestionWindow);
+
+    if (Bbr3->FilledPipe) {
+        Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+        Bbr3CongestionControlStartProbeBwCruise(Cc);
+    } else {
+        Bbr3CongestionControlEnterStartup(Cc);
+    }
+}
+
+//
+// Reacts to a loss rate above kBbr3LossThresh (or ECN marks) caused by a
+// bandwidth probe: InflightHi is lowered to what the path could carry.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlHandleInflightTooHigh(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t TxInFlight
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3->BwProbeSamples = FALSE;
+
+    if (!Bbr3->AppLimited) {
+        uint64_t Target =
+            Bbr3CongestionControlGetTargetInflight(Cc, GAIN_UNIT) * kBbr3Beta / GAIN_UNIT;
+        Bbr3->InflightHi =
+            (uint32_t)CXPLAT_MIN(CXPLAT_MAX(TxInFlight, Target), UINT32_MAX - 1);
+    }
+
+    if (Bbr3->State == BBR3_STATE_PROBE_BW_UP) {
+        Bbr3CongestionControlStartProbeBwDown(Cc, CxPlatTimeUs64());
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsInflightTooHigh(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    return
+        Bbr3->LostInRound * GAIN_UNIT >
+            (Bbr3->DeliveredInRound + Bbr3->LostInRound) * kBbr3LossThresh;
+}
+
+//
+// A congestion signal (loss above the threshold, or ECN) was received. While
+// probing, this bounds InflightHi; in STARTUP it also means the pipe is full.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnCongestionSignal(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t TxInFlight
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (Bbr3->State == BBR3_STATE_STARTUP) {
+        Bbr3->FilledPipe = TRUE;
+        Bbr3->InflightHi = (uint32_t)CXPLAT_MIN(
+            CXPLAT_MAX(Bbr3CongestionControlGetBdp(Cc, GAIN_UNIT), Bbr3->InflightLatest),
+            UINT32_MAX - 1);
+        Bbr3CongestionControlEnterDrain(Cc);
+
+    } else if (Bbr3->BwProbeSamples) {
+        Bbr3CongestionControlHandleInflightTooHigh(Cc, TxInFlight);
+    }
+}
+
+//
+// Once per round with congestion outside of bandwidth probing, back off the
+// short term bounds to the latest delivery signals.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlAdaptLowerBounds(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (Bbr3CongestionControlIsProbingBandwidth(Cc) ||
+        (!Bbr3->LossInRound && !Bbr3->EcnInRound)) {
+        return;
+    }
+
+    if (Bbr3->BwLo == UINT64_MAX) {
+        Bbr3->BwLo = Bbr3CongestionControlGetMaxBandwidth(Cc);
+    }
+    if (Bbr3->InflightLo == UINT32_MAX) {
+        Bbr3->InflightLo = Bbr3->CongestionWindow;
+    }
+
+    Bbr3->BwLo = CXPLAT_MAX(Bbr3->BwLatest, Bbr3->BwLo * kBbr3Beta / GAIN_UNIT);
+    Bbr3->InflightLo = (uint32_t)CXPLAT_MAX(
+        Bbr3->InflightLatest,
+        (uint64_t)Bbr3->InflightLo * kBbr3Beta / GAIN_UNIT);
+}
+
+//
+// Grows InflightHi while probing in ProbeBW_UP, with the growth per round
+// doubling every round (see Bbr3CongestionControlRaiseInflightHiSlope).
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlProbeInflightHiUpward(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t PrevInflightBytes,
+    _In_ uint32_t AckedBytes,
+    _In_ BOOLEAN NewRoundTrip
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    if (PrevInflightBytes + DatagramPayloadLength < Bbr3->CongestionWindow ||
+        Bbr3->CongestionWindow < Bbr3->InflightHi) {
+        return; // Not fully using InflightHi, so don't grow it.
+    }
+
+    Bbr3->BwProbeUpAcks += AckedBytes;
+    if (Bbr3->BwProbeUpAcks >= Bbr3->ProbeUpCount) {
+        uint32_t Delta = Bbr3->BwProbeUpAcks / Bbr3->ProbeUpCount;
+        Bbr3->BwProbeUpAcks -= Delta * Bbr3->ProbeUpCount;
+        Bbr3->InflightHi =
+            (uint32_t)CXPLAT_MIN(
+                (uint64_t)Bbr3->InflightHi + (uint64_t)Delta * DatagramPayloadLength,
+                UINT32_MAX - 1);
+    }
+
+    if (NewRoundTrip) {
+        Bbr3CongestionControlRaiseInflightHiSlope(Cc);
+    }
+}
+
+//
+// Without loss or ECN while probing, InflightHi only ever grows.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlAdaptUpperBounds(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t PrevInflightBytes,
+    _In_ uint32_t AckedBytes,
+    _In_ BOOLEAN NewRoundTrip
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (Bbr3->InflightHi == UINT32_MAX ||
+        Bbr3CongestionControlIsInflightTooHigh(Cc) ||
+        Bbr3->EcnInRound) {
+        return;
+    }
+
+    if (PrevInflightBytes > Bbr3->InflightHi) {
+        Bbr3->InflightHi = PrevInflightBytes;
+    }
+
+    if (Bbr3->State == BBR3_STATE_PROBE_BW_UP) {
+        Bbr3CongestionControlProbeInflightHiUpward(
+            Cc, PrevInflightBytes, AckedBytes, NewRoundTrip);
+    }
+}
+
+//
+// Probe for bandwidth at least as often as a Reno flow with the same BDP would
+// grow its window back, to coexist with loss based flows.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsRenoCoexistenceProbeTime(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    uint64_t RenoRounds =
+        Bbr3CongestionControlGetTargetInflight(Cc, GAIN_UNIT) / DatagramPayloadLength;
+    RenoRounds = CXPLAT_MIN(RenoRounds, kBbr3MaxRenoCoexistenceRounds);
+    return Cc->Bbr3.RoundsSinceBwProbe >= RenoRounds;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlCheckTimeToProbeBw(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (CxPlatTimeDiff64(Bbr3->CycleStart, TimeNow) > Bbr3->BwProbeWait ||
+        Bbr3CongestionControlIsRenoCoexistenceProbeTime(Cc)) {
+        Bbr3CongestionControlStartProbeBwRefill(Cc);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateProbeBwCyclePhase(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow,
+    _In_ BOOLEAN NewRoundTrip
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (!Bbr3->FilledPipe) {
+        return;
+    }
+
+    if (NewRoundTrip) {
+        Bbr3->RoundsSinceBwProbe++;
+    }
+
+    switch (Bbr3->State) {
+    case BBR3_STATE_PROBE_BW_DOWN:
+        if (Bbr3CongestionControlCheckTimeToProbeBw(Cc, TimeNow)) {
+            break;
+        }
+        if (Bbr3->BytesInFlight <= Bbr3CongestionControlGetInflightWithHeadroom(Cc) &&
+            Bbr3->BytesInFlight <= Bbr3CongestionControlGetTargetInflight(Cc, GAIN_UNIT)) {
+            Bbr3CongestionControlStartProbeBwCruise(Cc);
+        }
+        break;
+
+    case BBR3_STATE_PROBE_BW_CRUISE:
+        Bbr3CongestionControlCheckTimeToProbeBw(Cc, TimeNow);
+        break;
+
+    case BBR3_STATE_PROBE_BW_REFILL:
+        //
+        // After one round of refilling the pipe at the current rate, start
+        // probing above it.
+        //
+        if (NewRoundTrip) {
+            Bbr3CongestionControlStartProbeBwUp(Cc, TimeNow);
+        }
+        break;
+
+    case BBR3_STATE_PROBE_BW_UP:
+        if (CxPlatTimeDiff64(Bbr3->CycleStart, TimeNow) > Bbr3->MinRtt &&
+            Bbr3->BytesInFlight >
+                Bbr3CongestionControlGetTargetInflight(Cc, kBbr3ProbeBwUpPacingGain)) {
+            Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateDeliverySignals(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (Bbr3->AppLimited && Bbr3->AppLimitedExitTarget < AckEvent->LargestAck) {
+        Bbr3->AppLimited = FALSE;
+    }
+
+    QUIC_SENT_PACKET_METADATA* AckedPacketsIterator = AckEvent->AckedPackets;
+    while (AckedPacketsIterator != NULL) {
+        QUIC_SENT_PACKET_METADATA* AckedPacket = AckedPacketsIterator;
+        AckedPacketsIterator = AckedPacketsIterator->Next;
+
+        if (AckedPacket->PacketLength == 0) {
+            continue;
+        }
+
+        uint64_t DeliveryRate =
+            QuicCongestionControlSampleDeliveryRate(AckedPacket, AckEvent);
+        if (DeliveryRate == UINT64_MAX) {
+            continue;
+        }
+
+        if (DeliveryRate > Bbr3->BwLatest) {
+            Bbr3->BwLatest = DeliveryRate;
+        }
+
+        if (DeliveryRate >= Bbr3CongestionControlGetMaxBandwidth(Cc) ||
+            !AckedPacket->Flags.IsAppLimited) {
+            QuicSlidingWindowExtremumUpdateMax(&Bbr3->MaxBwFilter, DeliveryRate, Bbr3->CycleCount);
+        }
+    }
+
+    Bbr3->DeliveredInRound += AckEvent->NumRetransmittableBytes;
+    if (Bbr3->DeliveredInRound > Bbr3->InflightLatest) {
+        Bbr3->InflightLatest = Bbr3->DeliveredInRound;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateAckAggregation(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (!Bbr3->AckAggregationStartTimeValid) {
+        Bbr3->AckAggregationStartTime = AckEvent->TimeNow;
+        Bbr3->AckAggregationStartTimeValid = TRUE;
+        return;
+    }
+
+    uint64_t ExpectedAckBytes = Bbr3CongestionControlGetMaxBandwidth(Cc) *
+                                CxPlatTimeDiff64(Bbr3->AckAggregationStartTime, AckEvent->TimeNow) /
+                                kBbr3MicroSecsInSec /
+                                BW_UNIT;
+
+    //
+    // Reset current ack aggregation status when we witness ack arrival rate being less or equal than
+    // estimated bandwidth
+    //
+    if (Bbr3->AggregatedAckBytes <= ExpectedAckBytes) {
+        Bbr3->AggregatedAckBytes = AckEvent->NumRetransmittableBytes;
+        Bbr3->AckAggregationStartTime = AckEvent->TimeNow;
+        return;
+    }
+
+    Bbr3->AggregatedAckBytes += AckEvent->NumRetransmittableBytes;
+
+    QuicSlidingWindowExtremumUpdateMax(&Bbr3->ExtraAckedFilter,
+        Bbr3->AggregatedAckBytes - ExpectedAckBytes, Bbr3->RoundTripCounter);
+}
+
+//
+// Returns TRUE if the ProbeRTT min delay expired and a new ProbeRTT is due.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlUpdateMinRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    BOOLEAN ProbeRttExpired =
+        CxPlatTimeAtOrBefore64(
+            Bbr3->ProbeRttMinTimestamp + kBbr3ProbeRttIntervalInUs, AckEvent->TimeNow);
+
+    if (AckEvent->MinRttValid &&
+        (AckEvent->MinRtt < Bbr3->ProbeRttMinDelay || ProbeRttExpired)) {
+        Bbr3->ProbeRttMinDelay = AckEvent->MinRtt;
+        Bbr3->ProbeRttMinTimestamp = AckEvent->TimeNow;
+    }
+
+    BOOLEAN MinRttExpired =
+        CxPlatTimeAtOrBefore64(
+            Bbr3->MinRttTimestamp + kBbr3MinRttExpirationInUs, AckEvent->TimeNow);
+
+    if (Bbr3->ProbeRttMinDelay < Bbr3->MinRtt || MinRttExpired) {
+        Bbr3->MinRtt = Bbr3->ProbeRttMinDelay;
+        Bbr3->MinRttTimestamp = Bbr3->ProbeRttMinTimestamp;
+    }
+
+    return ProbeRttExpired;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetProbeRttCwnd(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return (uint32_t)CXPLAT_MAX(
+        Bbr3CongestionControlGetTargetInflight(Cc, kBbr3ProbeRttCwndGain),
+        Bbr3CongestionControlGetMinCongestionWindow(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlHandleProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN NewRoundTrip,
+    _In_ uint64_t LargestSentPacketNumber,
+    _In_ uint64_t AckTime
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3->AppLimited = TRUE;
+    Bbr3->AppLimitedExitTarget = LargestSentPacketNumber;
+
+    if (!Bbr3->ProbeRttDoneTimestampValid &&
+        Bbr3->BytesInFlight <= Bbr3CongestionControlGetProbeRttCwnd(Cc)) {
+        Bbr3->ProbeRttDoneTimestamp = AckTime + kBbr3ProbeRttTimeInUs;
+        Bbr3->ProbeRttDoneTimestampValid = TRUE;
+        Bbr3->ProbeRttRoundDone = FALSE;
+        Bbr3CongestionControlStartRound(Cc);
+        return;
+    }
+
+    if (Bbr3->ProbeRttDoneTimestampValid) {
+        if (NewRoundTrip) {
+            Bbr3->ProbeRttRoundDone = TRUE;
+        }
+        if (Bbr3->ProbeRttRoundDone &&
+            CxPlatTimeAtOrBefore64(Bbr3->ProbeRttDoneTimestamp, AckTime)) {
+            Bbr3->ProbeRttMinTimestamp = AckTime;
+            Bbr3CongestionControlExitProbeRtt(Cc, AckTime);
+        }
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetSendQuantum(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    uint64_t PacingRate =
+        Bbr3CongestionControlGetBandwidth(Cc) * Bbr3->PacingGain / GAIN_UNIT / BW_UNIT;
+
+    if (PacingRate < kBbr3LowPacingRateThresholdBytesPerSecond) {
+        Bbr3->SendQuantum = (uint64_t)DatagramPayloadLength;
+    } else if (PacingRate < kBbr3HighPacingRateThresholdBytesPerSecond) {
+        Bbr3->SendQuantum = (uint64_t)DatagramPayloadLength * 2;
+    } else {
+        Bbr3->SendQuantum = CXPLAT_MIN(PacingRate / kBbr3MilliSecsInSec, 64 * 1024 /* 64k */);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateCongestionWindow(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TotalBytesAcked,
+    _In_ uint64_t AckedBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3CongestionControlSetSendQuantum(Cc);
+
+    uint64_t MaxInflight = Bbr3CongestionControlGetTargetInflight(Cc, Bbr3->CwndGain);
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry = (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY) { .Value = 0, .Time = 0 };
+    if (QUIC_SUCCEEDED(QuicSlidingWindowExtremumGet(&Bbr3->ExtraAckedFilter, &Entry))) {
+        MaxInflight += Entry.Value;
+    }
+
+    uint64_t CongestionWindow = Bbr3->CongestionWindow;
+    uint32_t MinCongestionWindow = Bbr3CongestionControlGetMinCongestionWindow(Cc);
+
+    if (Bbr3->PacketConservation) {
+        CongestionWindow = CXPLAT_MAX(CongestionWindow, Bbr3->BytesInFlight + AckedBytes);
+    } else if (Bbr3->FilledPipe) {
+        CongestionWindow = CXPLAT_MIN(MaxInflight, CongestionWindow + AckedBytes);
+    } else if (CongestionWindow < MaxInflight || TotalBytesAcked < Bbr3->InitialCongestionWindow) {
+        CongestionWindow += AckedBytes;
+    }
+
+    CongestionWindow = CXPLAT_MAX(CongestionWindow, MinCongestionWindow);
+
+    if (Bbr3->State == BBR3_STATE_PROBE_RTT) {
+        CongestionWindow = CXPLAT_MIN(CongestionWindow, Bbr3CongestionControlGetProbeRttCwnd(Cc));
+    }
+
+    //
+    // Bound the window by what the model learned from loss and ECN. InflightHi
+    // applies in ProbeBW, with headroom while cruising (and in ProbeRTT) so
+    // that other flows can grab bandwidth. InflightLo always applies.
+    //
+    uint64_t Cap = UINT64_MAX;
+    if (Bbr3->State == BBR3_STATE_PROBE_BW_CRUISE || Bbr3->State == BBR3_STATE_PROBE_RTT) {
+        Cap = Bbr3CongestionControlGetInflightWithHeadroom(Cc);
+    } else if (Bbr3->State >= BBR3_STATE_PROBE_BW_DOWN && Bbr3->State <= BBR3_STATE_PROBE_BW_UP) {
+        Cap = Bbr3->InflightHi;
+    }
+    Cap = CXPLAT_MIN(Cap, Bbr3->InflightLo);
+    Cap = CXPLAT_MAX(Cap, MinCongestionWindow);
+
+    Bbr3->CongestionWindow = (uint32_t)CXPLAT_MIN(CongestionWindow, Cap);
+
+    QuicConnLogBbr3(QuicCongestionControlGetConnection(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    if (AckEvent->IsImplicit) {
+        Bbr3CongestionControlUpdateCongestionWindow(
+            Cc, AckEvent->NumTotalAckedRetransmittableBytes, AckEvent->NumRetransmittableBytes);
+
+        if (Connection->Settings->NetStatsEventEnabled) {
+            Bbr3CongestionControlIndicateConnectionEvent(Connection, Cc);
+        }
+        return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+    }
+
+    uint32_t PrevInflightBytes = Bbr3->BytesInFlight;
+
+    CXPLAT_DBG_ASSERT(Bbr3->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+    Bbr3->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+
+    BOOLEAN NewRoundTrip = FALSE;
+    if (!Bbr3->EndOfRoundTripValid || Bbr3->EndOfRoundTrip < AckEvent->LargestAck) {
+        Bbr3->RoundTripCounter++;
+        Bbr3->EndOfRoundTripValid = TRUE;
+        Bbr3->EndOfRoundTrip = AckEvent->LargestSentPacketNumber;
+        NewRoundTrip = TRUE;
+    }
+
+    BOOLEAN LastAckedPacketAppLimited =
+        AckEvent->AckedPackets == NULL ? FALSE : AckEvent->IsLargestAckedPacketAppLimited;
+
+    Bbr3CongestionControlUpdateDeliverySignals(Cc, AckEvent);
+    QuicSendBufferConnectionAdjust(Connection);
+
+    if (Bbr3->InRecovery) {
+        if (NewRoundTrip) {
+            Bbr3->PacketConservation = FALSE;
+        }
+        if (!AckEvent->HasLoss && Bbr3->EndOfRecovery < AckEvent->LargestAck) {
+            Bbr3->InRecovery = FALSE;
+            Bbr3->PacketConservation = FALSE;
+            Bbr3->CongestionWindow =
+                CXPLAT_MAX(Bbr3->CongestionWindow, Bbr3->PriorCongestionWindow);
+            QuicTraceEvent(
+                ConnRecoveryExit,
+                "[conn][%p] Recovery complete",
+                Connection);
+        }
+    }
+
+    Bbr3CongestionControlAdaptUpperBounds(
+        Cc, PrevInflightBytes, AckEvent->NumRetransmittableBytes, NewRoundTrip);
+
+    if (NewRoundTrip) {
+        Bbr3CongestionControlAdaptLowerBounds(Cc);
+        Bbr3CongestionControlResetCongestionSignals(Cc);
+    }
+
+    Bbr3CongestionControlUpdateAckAggregation(Cc, AckEvent);
+
+    if (!Bbr3->FilledPipe && NewRoundTrip && !LastAckedPacketAppLimited) {
+        uint64_t BandwidthTarget =
+            Bbr3->LastEstimatedStartupBandwidth * kBbr3StartupGrowthTarget / GAIN_UNIT;
+        uint64_t CurrentBandwidth = Bbr3CongestionControlGetMaxBandwidth(Cc);
+
+        if (CurrentBandwidth >= BandwidthTarget) {
+            Bbr3->LastEstimatedStartupBandwidth = CurrentBandwidth;
+            Bbr3->SlowStartupRoundCounter = 0;
+        } else if (++Bbr3->SlowStartupRoundCounter >= kBbr3StartupSlowGrowRoundLimit) {
+            Bbr3->FilledPipe = TRUE;
+        }
+    }
+
+    if (Bbr3->State == BBR3_STATE_STARTUP && Bbr3->FilledPipe) {
+        Bbr3CongestionControlEnterDrain(Cc);
+    }
+
+    if (Bbr3->State == BBR3_STATE_DRAIN &&
+        Bbr3->BytesInFlight <= Bbr3CongestionControlGetTargetInflight(Cc, GAIN_UNIT)) {
+        Bbr3CongestionControlStartProbeBwDown(Cc, AckEvent->TimeNow);
+    }
+
+    Bbr3CongestionControlUpdateProbeBwCyclePhase(Cc, AckEvent->TimeNow, NewRoundTrip);
+
+    BOOLEAN ProbeRttExpired = Bbr3CongestionControlUpdateMinRtt(Cc, AckEvent);
+
+    if (Bbr3->State != BBR3_STATE_PROBE_RTT &&
+        !Bbr3->ExitingQuiescence &&
+        ProbeRttExpired) {
+        Bbr3CongestionControlEnterProbeRtt(Cc);
+    }
+
+    Bbr3->ExitingQuiescence = FALSE;
+
+    if (Bbr3->State == BBR3_STATE_PROBE_RTT) {
+        Bbr3CongestionControlHandleProbeRtt(
+            Cc, NewRoundTrip, AckEvent->LargestSentPacketNumber, AckEvent->TimeNow);
+    }
+
+    Bbr3CongestionControlUpdateCongestionWindow(
+        Cc, AckEvent->NumTotalAckedRetransmittableBytes, AckEvent->NumRetransmittableBytes);
+
+    if (Connection->Settings->NetStatsEventEnabled) {
+        Bbr3CongestionControlIndicateConnectionEvent(Connection, Cc);
+    }
+
+    return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    QuicTraceEvent(
+        ConnCongestionV2,
+        "[conn][%p] Congestion event: IsEcn=%hu",
+        Connection,
+        FALSE);
+    QuicTraceProbe(congestion_event, Connection, FALSE);
+    Connection->Stats.Send.CongestionCount++;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(LossEvent->NumRetransmittableBytes > 0);
+
+    uint32_t TxInFlight = Bbr3->BytesInFlight;
+
+    CXPLAT_DBG_ASSERT(Bbr3->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Bbr3->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    Bbr3->LossInRound = TRUE;
+    Bbr3->LostInRound += LossEvent->NumRetransmittableBytes;
+    Bbr3->LossEventsInRound++;
+
+    if (Bbr3CongestionControlIsInflightTooHigh(Cc) &&
+        (Bbr3->State != BBR3_STATE_STARTUP ||
+         Bbr3->LossEventsInRound >= kBbr3StartupFullLossCount)) {
+        Bbr3CongestionControlOnCongestionSignal(Cc, TxInFlight);
+    }
+
+    uint32_t MinCongestionWindow = Bbr3CongestionControlGetMinCongestionWindow(Cc);
+
+    if (!Bbr3->InRecovery) {
+        if (Bbr3->State != BBR3_STATE_PROBE_RTT) {
+            Bbr3->PriorCongestionWindow = Bbr3->CongestionWindow;
+        }
+        Bbr3->InRecovery = TRUE;
+        Bbr3->PacketConservation = TRUE;
+        Bbr3CongestionControlStartRound(Cc);
+    }
+    Bbr3->EndOfRecovery = LossEvent->LargestSentPacketNumber;
+
+    if (LossEvent->PersistentCongestion) {
+        Bbr3->CongestionWindow = MinCongestionWindow;
+
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+    } else {
+        Bbr3->CongestionWindow =
+            Bbr3->CongestionWindow > LossEvent->NumRetransmittableBytes + MinCongestionWindow
+            ? Bbr3->CongestionWindow - LossEvent->NumRetransmittableBytes
+            : MinCongestionWindow;
+    }
+
+    Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+    QuicConnLogBbr3(Connection);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    UNREFERENCED_PARAMETER(EcnEvent);
+
+    QuicTraceEvent(
+        ConnCongestionV2,
+        "[conn][%p] Congestion event: IsEcn=%hu",
+        Connection,
+        TRUE);
+    QuicTraceProbe(congestion_event, Connection, TRUE);
+    Connection->Stats.Send.EcnCongestionCount++;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    //
+    // Unlike loss, CE marks are an explicit signal that the probe overshot, so
+    // no loss rate threshold applies. The lower bounds back off at the end of
+    // the round (see Bbr3CongestionControlAdaptLowerBounds).
+    //
+    Bbr3->EcnInRound = TRUE;
+    Bbr3CongestionControlOnCongestionSignal(Cc, Bbr3->BytesInFlight);
+
+    Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+    QuicConnLogBbr3(Connection);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    uint32_t CongestionWindow = Bbr3CongestionControlGetCongestionWindow(Cc);
+
+    uint32_t SendAllowance = 0;
+
+    if (Bbr3->BytesInFlight >= CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        !TimeSinceLastSendValid ||
+        !Connection->Settings->PacingEnabled ||
+        Bbr3->MinRtt == UINT64_MAX ||
+        Bbr3->MinRtt < QUIC_SEND_PACING_INTERVAL) {
+        //
+        // We're not in the necessary state to pace.
+        //
+        SendAllowance = CongestionWindow - Bbr3->BytesInFlight;
+
+    } else {
+        //
+        // We are pacing, so send what the pacing rate allows since the last
+        // send, but no more than a quarter of the window at once.
+        //
+        uint64_t PacingRate =
+            Bbr3CongestionControlGetBandwidth(Cc) * Bbr3->PacingGain / GAIN_UNIT;
+        uint64_t Allowance = PacingRate * TimeSinceLastSend / kBbr3MicroSecsInSec / BW_UNIT;
+
+        if (Bbr3->State == BBR3_STATE_STARTUP) {
+            Allowance = CXPLAT_MAX(
+                Allowance,
+                (uint64_t)CongestionWindow * Bbr3->PacingGain / GAIN_UNIT - Bbr3->BytesInFlight);
+        }
+
+        if (Allowance > CongestionWindow - Bbr3->BytesInFlight) {
+            Allowance = CongestionWindow - Bbr3->BytesInFlight;
+        }
+
+        if (Allowance > (CongestionWindow >> 2)) {
+            Allowance = CongestionWindow >> 2; // Don't send more than a quarter of the current window.
+        }
+
+        SendAllowance = (uint32_t)Allowance;
+    }
+    return SendAllowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    if (!Connection->Settings->PacingEnabled ||
+        Bbr3->MinRtt == UINT64_MAX ||
+        Bbr3->MinRtt < QUIC_SEND_PACING_INTERVAL) {
+        return 0;
+    }
+
+    return Bbr3CongestionControlGetBandwidth(Cc) * Bbr3->PacingGain / GAIN_UNIT / BW_UNIT;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetDeliveryRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Bbr3CongestionControlGetBandwidth(Cc) / BW_UNIT;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    uint64_t LargestSentPacketNumber = Connection->LossDetection.LargestSentPacketNumber;
+
+    if (Bbr3->BytesInFlight > Bbr3CongestionControlGetCongestionWindow(Cc)) {
+        return;
+    }
+
+    Bbr3->AppLimited = TRUE;
+    Bbr3->AppLimitedExitTarget = LargestSentPacketNumber;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    Bbr3->CongestionWindow = Bbr3->InitialCongestionWindowPackets * DatagramPayloadLength;
+    Bbr3->InitialCongestionWindow = Bbr3->InitialCongestionWindowPackets * DatagramPayloadLength;
+    Bbr3->PriorCongestionWindow = Bbr3->CongestionWindow;
+    Bbr3->BytesInFlightMax = Bbr3->CongestionWindow / 2;
+
+    if (FullReset) {
+        Bbr3->BytesInFlight = 0;
+    }
+    Bbr3->Exemptions = 0;
+
+    Bbr3->FilledPipe = FALSE;
+    Bbr3->ExitingQuiescence = FALSE;
+    Bbr3->InRecovery = FALSE;
+    Bbr3->PacketConservation = FALSE;
+    Bbr3->BwProbeSamples = FALSE;
+    Bbr3->AppLimited = FALSE;
+    Bbr3->AppLimitedExitTarget = 0;
+
+    Bbr3CongestionControlEnterStartup(Cc);
+    Bbr3->SendQuantum = 0;
+    Bbr3->SlowStartupRoundCounter = 0;
+    Bbr3->LastEstimatedStartupBandwidth = 0;
+
+    Bbr3->RoundTripCounter = 0;
+    Bbr3->EndOfRoundTripValid = FALSE;
+    Bbr3->EndOfRoundTrip = 0;
+    Bbr3->EndOfRecovery = 0;
+
+    Bbr3CongestionControlResetCongestionSignals(Cc);
+    Bbr3CongestionControlResetLowerBounds(Cc);
+    Bbr3->InflightHi = UINT32_MAX;
+
+    Bbr3->CycleCount = 0;
+    Bbr3->CycleStart = 0;
+    Bbr3->BwProbeWait = 0;
+    Bbr3->RoundsSinceBwProbe = 0;
+    Bbr3->BwProbeUpRounds = 0;
+    Bbr3->BwProbeUpAcks = 0;
+    Bbr3->ProbeUpCount = UINT32_MAX;
+
+    Bbr3->AckAggregationStartTimeValid = FALSE;
+    Bbr3->AckAggregationStartTime = CxPlatTimeUs64();
+    Bbr3->AggregatedAckBytes = 0;
+
+    Bbr3->MinRtt = UINT64_MAX;
+    Bbr3->MinRttTimestamp = CxPlatTimeUs64();
+    Bbr3->ProbeRttMinDelay = UINT64_MAX;
+    Bbr3->ProbeRttMinTimestamp = Bbr3->MinRttTimestamp;
+    Bbr3->ProbeRttDoneTimestampValid = FALSE;
+    Bbr3->ProbeRttRoundDone = FALSE;
+    Bbr3->ProbeRttDoneTimestamp = 0;
+
+    QuicSlidingWindowExtremumReset(&Bbr3->MaxBwFilter);
+    QuicSlidingWindowExtremumReset(&Bbr3->ExtraAckedFilter);
+
+    Bbr3CongestionControlLogOutFlowStatus(Cc);
+    QuicConnLogBbr3(Connection);
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlBbr3 = {
+    .Name = "BBR3",
+    .Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3,
+    .QuicCongestionControlCanSend = Bbr3CongestionControlCanSend,
+    .QuicCongestionControlSetExemption = Bbr3CongestionControlSetExemption,
+    .QuicCongestionControlReset = Bbr3CongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = Bbr3CongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = Bbr3CongestionControlGetPacingRate,
+    .QuicCongestionControlGetDeliveryRate = Bbr3CongestionControlGetDeliveryRate,
+    .QuicCongestionControlGetCongestionWindow = Bbr3CongestionControlGetCongestionWindow,
+    .QuicCongestionControlOnDataSent = Bbr3CongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = Bbr3CongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = Bbr3CongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = Bbr3CongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = Bbr3CongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = Bbr3CongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = Bbr3CongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = Bbr3CongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = Bbr3CongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = Bbr3CongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = Bbr3CongestionControlSetAppLimited,
+    .QuicCongestionControlGetNetworkStatistics = Bbr3CongestionControlGetNetworkStatistics
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    *Cc = QuicCongestionControlBbr3;
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Cc->Bbr3;
+
+    Bbr3->InitialCongestionWindowPackets = Settings->InitialWindowPackets;
+
+    Bbr3->MaxBwFilter = QuicSlidingWindowExtremumInitialize(
+            kBbr3MaxBwFilterLen, kBbr3DefaultFilterCapacity, Bbr3->MaxBwFilterEntries);
+    Bbr3->ExtraAckedFilter = QuicSlidingWindowExtremumInitialize(
+            kBbr3ExtraAckedFilterLen, kBbr3DefaultFilterCapacity, Bbr3->ExtraAckedFilterEntries);
+
+    Bbr3CongestionControlReset(Cc, TRUE);
+}
@@ -0,0 +1,248 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#include "sliding_window_extremum.h"
+
+#define kBbr3DefaultFilterCapacity 3
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef enum BBR3_STATE {
+
+    BBR3_STATE_STARTUP,
+
+    BBR3_STATE_DRAIN,
+
+    BBR3_STATE_PROBE_BW_DOWN,
+
+    BBR3_STATE_PROBE_BW_CRUISE,
+
+    BBR3_STATE_PROBE_BW_REFILL,
+
+    BBR3_STATE_PROBE_BW_UP,
+
+    BBR3_STATE_PROBE_RTT
+
+} BBR3_STATE;
+
+typedef struct QUIC_CONGESTION_CONTROL_BBR3 {
+
+    //
+    // Whether the bottleneck bandwidth has been detected (pipe is full)
+    //
+    BOOLEAN FilledPipe : 1;
+
+    //
+    // TRUE when exiting quiescence
+    //
+    BOOLEAN ExitingQuiescence : 1;
+
+    //
+    // TRUE while in loss recovery
+    //
+    BOOLEAN InRecovery : 1;
+
+    //
+    // TRUE during the first round of recovery, where cwnd follows packet
+    // conservation
+    //
+    BOOLEAN PacketConservation : 1;
+
+    //
+    // If TRUE, EndOfRoundTrip is valid
+    //
+    BOOLEAN EndOfRoundTripValid : 1;
+
+    //
+    // If TRUE, AckAggregationStartTime is valid
+    //
+    BOOLEAN AckAggregationStartTimeValid : 1;
+
+    //
+    // If TRUE, ProbeRttDoneTimestamp is valid
+    //
+    BOOLEAN ProbeRttDoneTimestampValid : 1;
+
+    //
+    // TRUE once a full round has elapsed at the ProbeRTT inflight target
+    //
+    BOOLEAN ProbeRttRoundDone : 1;
+
+    //
+    // TRUE if bandwidth is limited by the application
+    //
+    BOOLEAN AppLimited : 1;
+
+    //
+    // TRUE if a loss or ECN congestion signal was seen in the current round
+    //
+    BOOLEAN LossInRound : 1;
+    BOOLEAN EcnInRound : 1;
+
+    //
+    // TRUE while acks still carry samples from the current bandwidth probe,
+    // i.e. a loss or ECN signal should be treated as the probe overshooting
+    //
+    BOOLEAN BwProbeSamples : 1;
+
+    //
+    // The size of the initial congestion window in packets
+    //
+    uint32_t InitialCongestionWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+
+    uint32_t InitialCongestionWindow; // bytes
+
+    //
+    // The congestion window before entering recovery, restored on exit.
+    //
+    uint32_t PriorCongestionWindow; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    //
+    // Counter of continuous round trips in STARTUP without enough growth
+    //
+    uint8_t SlowStartupRoundCounter;
+
+    //
+    // Current state of the BBR3 state machine (BBR3_STATE)
+    //
+    uint32_t State;
+
+    //
+    // The dynamic gain factors applied to the BDP (cwnd) and to the bandwidth
+    // estimate (pacing rate)
+    //
+    uint32_t CwndGain;
+    uint32_t PacingGain;
+
+    //
+    // The dynamic send quantum specifies the maximum size of transmission
+    // aggregates
+    //
+    uint64_t SendQuantum;
+
+    //
+    // Count of packet-timed round trips, and the packet number that ends the
+    // current round
+    //
+    uint64_t RoundTripCounter;
+    uint64_t EndOfRoundTrip;
+
+    //
+    // Receiving acknowledgment of a packet after EndOfRecovery will cause
+    // BBR3 to exit recovery
+    //
+    uint64_t EndOfRecovery;
+
+    //
+    // Target packet number to quit the AppLimited state
+    //
+    uint64_t AppLimitedExitTarget;
+
+    //
+    // Bytes delivered and lost in the current round, used to compute the
+    // per-round loss rate
+    //
+    uint64_t DeliveredInRound;
+    uint64_t LostInRound;
+    uint32_t LossEventsInRound;
+
+    //
+    // The bandwidth of last round during STARTUP state
+    //
+    uint64_t LastEstimatedStartupBandwidth;
+
+    //
+    // ProbeBW cycle bookkeeping. CycleCount keys the max bandwidth filter.
+    //
+    uint64_t CycleCount;
+    uint64_t CycleStart; // microseconds
+    uint64_t BwProbeWait; // microseconds
+    uint32_t RoundsSinceBwProbe;
+    uint32_t BwProbeUpRounds;
+    uint32_t BwProbeUpAcks;
+    uint32_t ProbeUpCount;
+
+    //
+    // Long term upper bound on inflight, learned from loss/ECN while probing.
+    // UINT32_MAX when unset.
+    //
+    uint32_t InflightHi;
+
+    //
+    // Short term lower bounds on inflight and bandwidth, adapted every round
+    // with congestion. UINT32_MAX / UINT64_MAX when unset.
+    //
+    uint32_t InflightLo;
+    uint64_t BwLo;
+
+    //
+    // Latest round's maximum delivery rate and delivered bytes.
+    //
+    uint64_t BwLatest;
+    uint64_t InflightLatest;
+
+    //
+    // Starting time of ack aggregation, and bytes acked during it
+    //
+    uint64_t AckAggregationStartTime;
+    uint64_t AggregatedAckBytes;
+
+    //
+    // Max filter on recent delivery rate samples, keyed by CycleCount
+    //
+    QUIC_SLIDING_WINDOW_EXTREMUM MaxBwFilter;
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY MaxBwFilterEntries[kBbr3DefaultFilterCapacity];
+
+    //
+    // Max filter on the recent degree of ack aggregation, keyed by round
+    //
+    QUIC_SLIDING_WINDOW_EXTREMUM ExtraAckedFilter;
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY ExtraAckedFilterEntries[kBbr3DefaultFilterCapacity];
+
+    uint64_t MinRtt; // microseconds
+    uint64_t MinRttTimestamp; // microseconds
+
+    //
+    // The shorter window min RTT used to schedule ProbeRTT.
+    //
+    uint64_t ProbeRttMinDelay; // microseconds
+    uint64_t ProbeRttMinTimestamp; // microseconds
+
+    //
+    // Earliest time to exit ProbeRTT state
+    //
+    uint64_t ProbeRttDoneTimestamp; // microseconds
+
+} QUIC_CONGESTION_CONTROL_BBR3;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,90 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for variable length integer and frame encoding/decoding.
+
+--*/
+
+#include "main.h"
+
+//
+// Encodes and decodes a batch of values that take Arg bytes each.
+//
+QUIC_BENCH(VarIntEncodeDecode, 1, 2, 4, 8) {
+    const uint64_t Values[] = { 0, 0x3F, 0x3FFF, 0, 0x3FFFFFFF, 0, 0, 0, 0x3FFFFFFFFFFFFFFFull };
+    const QUIC_VAR_INT Value = Values[State.GetArg()];
+    uint8_t Buffer[64 * 8];
+    while (State.KeepRunning()) {
+        uint8_t* End = Buffer;
+        for (uint32_t i = 0; i < 64; ++i) {
+            End = QuicVarIntEncode(Value - i % 2, End);
+        }
+        uint16_t Offset = 0;
+        for (uint32_t i = 0; i < 64; ++i) {
+            QUIC_VAR_INT Decoded = 0;
+            BenchDoNotOptimize(
+                QuicVarIntDecode((uint16_t)(End - Buffer), Buffer, &Offset, &Decoded));
+            BenchDoNotOptimize(Decoded);
+        }
+    }
+    State.SetItemsProcessed(State.GetIterations() * 64);
+}
+
+//
+// Decodes a STREAM frame with an Arg byte payload.
+//
+QUIC_BENCH(StreamFrameDecode, 0, 1200, 16384) {
+    static uint8_t Data[16384];
+    QUIC_STREAM_EX Frame = {};
+    Frame.StreamID = 4;
+    Frame.Offset = 0x12345;
+    Frame.ExplicitLength = TRUE;
+    Frame.Length = State.GetArg();
+    Frame.Data = Data;
+    static uint8_t Buffer[16384 + 32];
+    uint16_t Length = 0;
+    CXPLAT_FRE_ASSERT(QuicStreamFrameEncode(&Frame, &Length, sizeof(Buffer), Buffer));
+    while (State.KeepRunning()) {
+        uint16_t Offset = 1;
+        QUIC_STREAM_EX Decoded;
+        BenchDoNotOptimize(
+            QuicStreamFrameDecode(
+                (QUIC_FRAME_TYPE)Buffer[0], Length, Buffer, &Offset, &Decoded));
+        BenchDoNotOptimize(Decoded);
+    }
+    State.SetItemsProcessed(State.GetIterations());
+}
+
+//
+// Decodes an ACK frame with Arg ACK ranges, as sent for a lossy path.
+//
+QUIC_BENCH(AckFrameDecode, 1, 8, 64, 256) {
+    QUIC_RANGE AckRanges, Decoded;
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &AckRanges);
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &Decoded);
+    for (uint64_t i = 0; i < State.GetArg(); ++i) {
+        BOOLEAN Updated;
+        CXPLAT_FRE_ASSERT(QuicRangeAddRange(&AckRanges, 1000 + i * 10, 8, &Updated) != nullptr);
+    }
+    uint8_t Buffer[4096];
+    uint16_t Length = 0;
+    CXPLAT_FRE_ASSERT(
+        QuicAckFrameEncode(&AckRanges, nullptr, 25, nullptr, &Length, sizeof(Buffer), Buffer));
+    while (State.KeepRunning()) {
+        uint16_t Offset = 1;
+        BOOLEAN InvalidFrame;
+        uint64_t AckDelay;
+        QuicRangeReset(&Decoded);
+        BenchDoNotOptimize(
+            QuicAckFrameDecode(
+                QUIC_FRAME_ACK, Length, Buffer, &Offset, &InvalidFrame,
+                &Decoded, nullptr, &AckDelay));
+    }
+    State.SetItemsProcessed(State.GetIterations());
+    QuicRangeUninitialize(&Decoded);
+    QuicRangeUninitialize(&AckRanges);
+}
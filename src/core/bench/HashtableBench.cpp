@@ -0,0 +1,118 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for CXPLAT_HASHTABLE, chained and with open addressing,
+    swept over the number of entries, up to a million.
+
+--*/
+
+#include "main.h"
+
+struct BenchHashtable {
+    CXPLAT_HASHTABLE* Table {nullptr};
+    std::vector<CXPLAT_HASHTABLE_ENTRY> Entries;
+
+    BenchHashtable(uint64_t Count, uint32_t Flags) : Entries((size_t)Count) {
+        CXPLAT_FRE_ASSERT(
+            CxPlatHashtableInitializeWithFlags(&Table, CXPLAT_HASH_MIN_SIZE, Flags));
+        for (uint64_t i = 0; i < Count; ++i) {
+            CxPlatHashtableInsert(Table, &Entries[(size_t)i], Signature(i), nullptr);
+        }
+    }
+    ~BenchHashtable() {
+        for (auto& Entry : Entries) {
+            CxPlatHashtableRemove(Table, &Entry, nullptr);
+        }
+        CxPlatHashtableUninitialize(Table);
+    }
+
+    //
+    // Well mixed, distinct signatures, like the hashes of connection IDs.
+    //
+    static uint64_t Signature(uint64_t i) { return (i + 1) * 0x9E3779B97F4A7C15ull; }
+};
+
+static
+void
+HashtableLookup(
+    _In_ BenchState& State,
+    _In_ uint32_t Flags
+    )
+{
+    BenchHashtable Table(State.GetArg(), Flags);
+    BenchRandom Random;
+    while (State.KeepRunning()) {
+        BenchDoNotOptimize(
+            CxPlatHashtableLookup(
+                Table.Table, BenchHashtable::Signature(Random.Next(State.GetArg())), nullptr));
+    }
+    State.SetItemsProcessed(State.GetIterations());
+}
+
+static
+void
+HashtableLookupMiss(
+    _In_ BenchState& State,
+    _In_ uint32_t Flags
+    )
+{
+    BenchHashtable Table(State.GetArg(), Flags);
+    BenchRandom Random;
+    while (State.KeepRunning()) {
+        BenchDoNotOptimize(
+            CxPlatHashtableLookup(
+                Table.Table,
+                BenchHashtable::Signature(State.GetArg() + Random.Next(State.GetArg())),
+                nullptr));
+    }
+    State.SetItemsProcessed(State.GetIterations());
+}
+
+//
+// Removes a random entry and inserts it back, as connections come and go.
+//
+static
+void
+HashtableInsertRemove(
+    _In_ BenchState& State,
+    _In_ uint32_t Flags
+    )
+{
+    BenchHashtable Table(State.GetArg(), Flags);
+    BenchRandom Random;
+    while (State.KeepRunning()) {
+        const uint64_t i = Random.Next(State.GetArg());
+        CxPlatHashtableRemove(Table.Table, &Table.Entries[(size_t)i], nullptr);
+        CxPlatHashtableInsert(
+            Table.Table, &Table.Entries[(size_t)i], BenchHashtable::Signature(i), nullptr);
+    }
+    State.SetItemsProcessed(State.GetIterations() * 2);
+}
+
+QUIC_BENCH(HashtableLookupChained, 16, 1024, 65536, 1048576) {
+    HashtableLookup(State, 0);
+}
+
+QUIC_BENCH(HashtableLookupOpen, 16, 1024, 65536, 1048576) {
+    HashtableLookup(State, CXPLAT_HASH_OPEN_ADDRESSING);
+}
+
+QUIC_BENCH(HashtableLookupMissChained, 16, 1024, 65536, 1048576) {
+    HashtableLookupMiss(State, 0);
+}
+
+QUIC_BENCH(HashtableLookupMissOpen, 16, 1024, 65536, 1048576) {
+    HashtableLookupMiss(State, CXPLAT_HASH_OPEN_ADDRESSING);
+}
+
+QUIC_BENCH(HashtableInsertRemoveChained, 16, 1024, 65536, 1048576) {
+    HashtableInsertRemove(State, 0);
+}
+
+QUIC_BENCH(HashtableInsertRemoveOpen, 16, 1024, 65536, 1048576) {
+    HashtableInsertRemove(State, CXPLAT_HASH_OPEN_ADDRESSING);
+}
@@ -0,0 +1,79 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for QUIC_RANGE, swept over the number of subranges.
+
+--*/
+
+#include "main.h"
+
+struct BenchRange {
+    QUIC_RANGE Range;
+    BenchRange() { QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range); }
+    ~BenchRange() { QuicRangeUninitialize(&Range); }
+
+    //
+    // Fills the range with Count single value subranges: 0, 2, 4, ...
+    //
+    void FillGaps(uint64_t Count) {
+        for (uint64_t i = 0; i < Count; ++i) {
+            CXPLAT_FRE_ASSERT(QuicRangeAddValue(&Range, i * 2));
+        }
+    }
+};
+
+//
+// In order values, as for packets received without loss: each one extends the
+// last subrange.
+//
+QUIC_BENCH(RangeAddValueInOrder, 64, 1024, 16384) {
+    BenchRange Range;
+    const uint64_t Count = State.GetArg();
+    while (State.KeepRunning()) {
+        for (uint64_t i = 0; i < Count; ++i) {
+            BenchDoNotOptimize(QuicRangeAddValue(&Range.Range, i));
+        }
+        QuicRangeReset(&Range.Range);
+    }
+    State.SetItemsProcessed(State.GetIterations() * Count);
+}
+
+//
+// Fills a gap between two subranges, merging them, then punches it out again,
+// splitting them. This is the subrange insert/remove a lost or reordered
+// packet costs.
+//
+QUIC_BENCH(RangeFillAndPunchGap, 1, 16, 256, 4096) {
+    BenchRange Range;
+    BenchRandom Random;
+    const uint64_t Count = State.GetArg() + 1;
+    Range.FillGaps(Count);
+    while (State.KeepRunning()) {
+        const uint64_t Gap = Random.Next(Count - 1) * 2 + 1;
+        BenchDoNotOptimize(QuicRangeAddValue(&Range.Range, Gap));
+        BenchDoNotOptimize(QuicRangeRemoveRange(&Range.Range, Gap, 1));
+    }
+    State.SetItemsProcessed(State.GetIterations() * 2);
+}
+
+//
+// Looks up a random value in a range of N subranges.
+//
+QUIC_BENCH(RangeGetRange, 1, 16, 256, 4096) {
+    BenchRange Range;
+    BenchRandom Random;
+    const uint64_t Count = State.GetArg();
+    Range.FillGaps(Count);
+    while (State.KeepRunning()) {
+        uint64_t RangeCount;
+        BOOLEAN IsLast;
+        BenchDoNotOptimize(
+            QuicRangeGetRange(&Range.Range, Random.Next(Count) * 2, &RangeCount, &IsLast));
+        BenchDoNotOptimize(RangeCount);
+    }
+    State.SetItemsProcessed(State.GetIterations());
+}
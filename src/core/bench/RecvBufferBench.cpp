@@ -0,0 +1,182 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for QUIC_RECV_BUFFER, swept over the size of the writes
+    (STREAM frame payloads), for each receive mode.
+
+--*/
+
+#include "main.h"
+
+#define BENCH_RECV_WRITES 16
+
+struct BenchRecvBuffer {
+    QUIC_RECV_BUFFER RecvBuf {0};
+    CXPLAT_POOL ChunkPools[QUIC_RECV_CHUNK_POOL_CLASS_COUNT] {};
+
+    BenchRecvBuffer(QUIC_RECV_BUF_MODE Mode) {
+        for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_CLASS_COUNT; ++i) {
+            CxPlatPoolInitialize(
+                FALSE,
+                sizeof(QUIC_RECV_CHUNK) + (QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE << i),
+                QUIC_POOL_RECVBUF,
+                &ChunkPools[i]);
+        }
+        CXPLAT_FRE_ASSERT(
+            QUIC_SUCCEEDED(
+            QuicRecvBufferInitialize(
+                &RecvBuf,
+                QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE,
+                1024 * 1024,
+                Mode,
+                ChunkPools,
+                FALSE)));
+    }
+    ~BenchRecvBuffer() {
+        QuicRecvBufferUninitialize(&RecvBuf);
+        for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_CLASS_COUNT; ++i) {
+            CxPlatPoolUninitialize(&ChunkPools[i]);
+        }
+    }
+
+    void Write(uint64_t Offset, uint16_t Length, const uint8_t* Data) {
+        uint64_t QuotaConsumed, SizeNeeded;
+        BOOLEAN NewDataReady;
+        CXPLAT_FRE_ASSERT(
+            QUIC_SUCCEEDED(
+            QuicRecvBufferWrite(
+                &RecvBuf, Offset, Length, Data, UINT64_MAX,
+                &QuotaConsumed, &NewDataReady, &SizeNeeded)));
+    }
+
+    //
+    // Reads and drains everything written, as the app would.
+    //
+    void ReadAll() {
+        QUIC_BUFFER Buffers[3];
+        do {
+            uint64_t Offset;
+            uint32_t BufferCount = ARRAYSIZE(Buffers);
+            QuicRecvBufferRead(&RecvBuf, &Offset, &BufferCount, Buffers);
+            uint64_t Length = 0;
+            for (uint32_t i = 0; i < BufferCount; ++i) {
+                BenchDoNotOptimize(Buffers[i].Buffer[0]);
+                Length += Buffers[i].Length;
+            }
+            if (QuicRecvBufferDrain(&RecvBuf, Length)) {
+                break;
+            }
+        } while (QuicRecvBufferHasUnreadData(&RecvBuf));
+    }
+};
+
+//
+// Each iteration writes BENCH_RECV_WRITES frames of Arg bytes, then reads
+// and drains them. Reordered writes swap each pair of frames, so every other
+// write lands beyond the contiguous data.
+//
+static
+void
+RecvBufferWriteRead(
+    _In_ BenchState& State,
+    _In_ QUIC_RECV_BUF_MODE Mode,
+    _In_ bool Reordered
+    )
+{
+    BenchRecvBuffer RecvBuffer(Mode);
+    static uint8_t Data[UINT16_MAX];
+    const uint16_t Length = (uint16_t)State.GetArg();
+    uint64_t Offset = 0;
+    while (State.KeepRunning()) {
+        for (uint32_t i = 0; i < BENCH_RECV_WRITES; ++i) {
+            const uint32_t Index = Reordered ? (i ^ 1) : i;
+            RecvBuffer.Write(Offset + (uint64_t)Index * Length, Length, Data);
+        }
+        Offset += (uint64_t)BENCH_RECV_WRITES * Length;
+        RecvBuffer.ReadAll();
+    }
+    State.SetItemsProcessed(State.GetIterations() * BENCH_RECV_WRITES);
+    State.SetBytesProcessed(State.GetIterations() * BENCH_RECV_WRITES * Length);
+}
+
+QUIC_BENCH(RecvBufferSingleInOrder, 64, 256, 1200, 16384) {
+    RecvBufferWriteRead(State, QUIC_RECV_BUF_MODE_SINGLE, false);
+}
+
+QUIC_BENCH(RecvBufferSingleReordered, 64, 256, 1200, 16384) {
+    RecvBufferWriteRead(State, QUIC_RECV_BUF_MODE_SINGLE, true);
+}
+
+QUIC_BENCH(RecvBufferCircularInOrder, 64, 256, 1200, 16384) {
+    RecvBufferWriteRead(State, QUIC_RECV_BUF_MODE_CIRCULAR, false);
+}
+
+QUIC_BENCH(RecvBufferCircularReordered, 64, 256, 1200, 16384) {
+    RecvBufferWriteRead(State, QUIC_RECV_BUF_MODE_CIRCULAR, true);
+}
+
+QUIC_BENCH(RecvBufferMultipleInOrder, 64, 256, 1200, 16384) {
+    RecvBufferWriteRead(State, QUIC_RECV_BUF_MODE_MULTIPLE, false);
+}
+
+QUIC_BENCH(RecvBufferMultipleReordered, 64, 256, 1200, 16384) {
+    RecvBufferWriteRead(State, QUIC_RECV_BUF_MODE_MULTIPLE, true);
+}
+
+//
+// Each iteration runs a short lived receive buffer through its whole life:
+// initialize, grow to Arg bytes with 1 KB writes, read, drain, uninitialize.
+// This is what the chunk pools speed up.
+//
+static
+void
+RecvBufferChurn(
+    _In_ BenchState& State,
+    _In_ bool UsePools
+    )
+{
+    BenchRecvBuffer Pools(QUIC_RECV_BUF_MODE_CIRCULAR);
+    static uint8_t Data[1024];
+    const uint32_t TotalLength = (uint32_t)State.GetArg();
+    while (State.KeepRunning()) {
+        QUIC_RECV_BUFFER RecvBuf;
+        CXPLAT_FRE_ASSERT(
+            QUIC_SUCCEEDED(
+            QuicRecvBufferInitialize(
+                &RecvBuf,
+                QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE,
+                TotalLength,
+                QUIC_RECV_BUF_MODE_CIRCULAR,
+                UsePools ? Pools.ChunkPools : NULL,
+                FALSE)));
+        for (uint32_t Offset = 0; Offset < TotalLength; Offset += sizeof(Data)) {
+            uint64_t QuotaConsumed, SizeNeeded;
+            BOOLEAN NewDataReady;
+            CXPLAT_FRE_ASSERT(
+                QUIC_SUCCEEDED(
+                QuicRecvBufferWrite(
+                    &RecvBuf, Offset, sizeof(Data), Data, UINT64_MAX,
+                    &QuotaConsumed, &NewDataReady, &SizeNeeded)));
+        }
+        uint64_t ReadOffset;
+        QUIC_BUFFER Buffers[3];
+        uint32_t BufferCount = ARRAYSIZE(Buffers);
+        QuicRecvBufferRead(&RecvBuf, &ReadOffset, &BufferCount, Buffers);
+        QuicRecvBufferDrain(&RecvBuf, TotalLength);
+        QuicRecvBufferUninitialize(&RecvBuf);
+    }
+    State.SetItemsProcessed(State.GetIterations());
+    State.SetBytesProcessed(State.GetIterations() * TotalLength);
+}
+
+QUIC_BENCH(RecvBufferChurnGeneral, 4096, 16384, 32768) {
+    RecvBufferChurn(State, false);
+}
+
+QUIC_BENCH(RecvBufferChurnPooled, 4096, 16384, 32768) {
+    RecvBufferChurn(State, true);
+}
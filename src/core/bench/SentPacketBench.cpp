@@ -0,0 +1,89 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for sent packet metadata allocation, from the partition's
+    pools and from the per-connection ring, swept over the number of packets
+    in flight.
+
+--*/
+
+#include "main.h"
+
+//
+// Tracks packets the way loss detection does: each iteration sends a packet
+// (allocating and filling in its metadata) and, once Arg packets are in
+// flight, acknowledges the oldest one (returning its metadata).
+//
+static
+void
+SentPacketSendAndAck(
+    _In_ BenchState& State,
+    _In_ uint32_t RingSize
+    )
+{
+    auto Connection =
+        (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+    CXPLAT_FRE_ASSERT(Connection != nullptr);
+    CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+    QUIC_SENT_PACKET_RING* Ring = &Connection->LossDetection.SentPacketRing;
+    if (RingSize != 0) {
+        CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(QuicSentPacketRingInitialize(Ring, RingSize)));
+    }
+    QUIC_SENT_PACKET_POOL Pool;
+    QuicSentPacketPoolInitialize(&Pool);
+
+    QUIC_MAX_SENT_PACKET_METADATA TempBuffer;
+    CxPlatZeroMemory(&TempBuffer, sizeof(TempBuffer));
+    QUIC_SENT_PACKET_METADATA* Temp = &TempBuffer.Metadata;
+    Temp->Flags.KeyType = QUIC_PACKET_KEY_1_RTT;
+    Temp->FrameCount = 2; // Zeroed frames are PADDING, so have nothing to release.
+
+    const size_t InFlight = (size_t)State.GetArg();
+    std::vector<QUIC_SENT_PACKET_METADATA*> Packets(InFlight, nullptr);
+    size_t Next = 0;
+    while (State.KeepRunning()) {
+        if (Packets[Next] != nullptr) {
+            QuicSentPacketPoolReturnPacketMetadata(Packets[Next], Connection);
+        }
+        QUIC_SENT_PACKET_METADATA* Packet =
+            QuicSentPacketRingGetPacketMetadata(Ring, Temp->FrameCount);
+        if (Packet == nullptr) {
+            Packet = QuicSentPacketPoolGetPacketMetadata(&Pool, Temp->FrameCount);
+        }
+        CXPLAT_FRE_ASSERT(Packet != nullptr);
+        CxPlatCopyMemory(
+            Packet,
+            Temp,
+            SIZEOF_QUIC_SENT_PACKET_METADATA(Temp->FrameCount));
+        Temp->PacketNumber++;
+        Packets[Next] = Packet;
+        Next = (Next + 1) % InFlight;
+    }
+    State.SetItemsProcessed(State.GetIterations());
+
+    for (auto Packet : Packets) {
+        if (Packet != nullptr) {
+            QuicSentPacketPoolReturnPacketMetadata(Packet, Connection);
+        }
+    }
+    QuicSentPacketPoolUninitialize(&Pool);
+    if (RingSize != 0) {
+        QuicSentPacketRingUninitialize(Ring);
+    }
+    CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+}
+
+QUIC_BENCH(SentPacketPool, 1, 64, 1024, 16384) {
+    SentPacketSendAndAck(State, 0);
+}
+
+//
+// A 1024 slot ring, so larger windows overflow into the pools.
+//
+QUIC_BENCH(SentPacketRing, 1, 64, 1024, 16384) {
+    SentPacketSendAndAck(State, 1024);
+}
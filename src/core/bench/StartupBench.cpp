@@ -0,0 +1,32 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for library startup, swept over the ticket cache size each
+    partition allocates.
+
+--*/
+
+#include "main.h"
+
+//
+// The lazy initialization the first registration triggers: partitions, the
+// datapath and the library's threads, undone again each iteration. The worker
+// pool is created by the first iteration and then kept, as it is by the
+// library, so its threads are only counted once.
+//
+QUIC_BENCH(LibraryLazyInitialize, 0, 1024) {
+    const uint32_t TicketCacheSize = MsQuicLib.TicketCacheSize;
+    MsQuicLib.TicketCacheSize = (uint32_t)State.GetArg();
+    while (State.KeepRunning()) {
+        CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(QuicLibraryLazyInitialize(TRUE)));
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        MsQuicLibraryLazyUninitialize();
+        CxPlatLockRelease(&MsQuicLib.Lock);
+    }
+    MsQuicLib.TicketCacheSize = TicketCacheSize;
+    State.SetItemsProcessed(State.GetIterations());
+}
@@ -0,0 +1,248 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Runs the core microbenchmarks.
+
+    Each benchmark is run with a growing number of iterations until it takes
+    at least --min_time seconds, then repeated --repetitions times; the median
+    repetition is reported.
+
+--*/
+
+#include "main.h"
+
+#include <algorithm>
+#include <string>
+
+extern "C" {
+void
+MsQuicLibraryLoad(
+    void
+    );
+
+QUIC_STATUS
+MsQuicAddRef(
+    void
+    );
+
+void
+MsQuicRelease(
+    void
+    );
+
+void
+MsQuicLibraryUnload(
+    void
+    );
+}
+
+struct BenchResult {
+    std::string Name;
+    uint64_t Iterations;
+    double RealNs;      // Per iteration
+    double CpuNs;       // Per iteration
+    double ItemsPerSecond;
+    double BytesPerSecond;
+};
+
+static
+BenchResult
+RunBenchmark(
+    _In_ const BenchRegistration* Bench,
+    _In_ uint64_t Arg,
+    _In_ double MinTime,
+    _In_ uint32_t Repetitions
+    )
+{
+    //
+    // Grow the iteration count until a run takes long enough to measure.
+    //
+    uint64_t Iterations = 1;
+    while (true) {
+        BenchState State(Arg, Iterations);
+        Bench->Fn(State);
+        const double Seconds = State.RealNs / 1e9;
+        if (Seconds >= MinTime || Iterations >= 1000000000ull) {
+            break;
+        }
+        double Multiplier = Seconds <= 0 ? 10 : MinTime * 1.4 / Seconds;
+        Multiplier = std::min(std::max(Multiplier, 2.0), 10.0);
+        Iterations = (uint64_t)(Iterations * Multiplier);
+    }
+
+    std::vector<BenchState> Runs;
+    for (uint32_t i = 0; i < Repetitions; ++i) {
+        BenchState State(Arg, Iterations);
+        Bench->Fn(State);
+        Runs.push_back(State);
+    }
+    std::sort(Runs.begin(), Runs.end(),
+        [](const BenchState& A, const BenchState& B) { return A.RealNs < B.RealNs; });
+    const BenchState& Median = Runs[Runs.size() / 2];
+
+    BenchResult Result;
+    Result.Name = Bench->Name;
+    Result.Name += "/" + std::to_string(Arg);
+    Result.Iterations = Iterations;
+    Result.RealNs = Median.RealNs / Iterations;
+    Result.CpuNs = Median.CpuNs / Iterations;
+    Result.ItemsPerSecond =
+        Median.RealNs > 0 ? Median.ItemsProcessed * 1e9 / Median.RealNs : 0;
+    Result.BytesPerSecond =
+        Median.RealNs > 0 ? Median.BytesProcessed * 1e9 / Median.RealNs : 0;
+    return Result;
+}
+
+static
+bool
+WriteJson(
+    _In_z_ const char* Path,
+    _In_ const std::vector<BenchResult>& Results,
+    _In_ uint32_t Repetitions
+    )
+{
+    FILE* File = fopen(Path, "w");
+    if (File == nullptr) {
+        printf("Failed to open '%s'!\n", Path);
+        return false;
+    }
+
+    char Date[64] = "";
+    time_t Now = time(nullptr);
+    struct tm* Local = localtime(&Now);
+    if (Local != nullptr) {
+        strftime(Date, sizeof(Date), "%Y-%m-%dT%H:%M:%S", Local);
+    }
+
+    fprintf(File, "{\n  \"context\": {\n");
+    fprintf(File, "    \"date\": \"%s\",\n", Date);
+    fprintf(File, "    \"executable\": \"msquiccorebench\",\n");
+    fprintf(File, "    \"num_cpus\": %u,\n", CxPlatProcCount());
+#if DEBUG
+    fprintf(File, "    \"library_build_type\": \"debug\"\n");
+#else
+    fprintf(File, "    \"library_build_type\": \"release\"\n");
+#endif
+    fprintf(File, "  },\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < Results.size(); ++i) {
+        const BenchResult& Result = Results[i];
+        fprintf(File, "    {\n");
+        fprintf(File, "      \"name\": \"%s\",\n", Result.Name.c_str());
+        fprintf(File, "      \"run_name\": \"%s\",\n", Result.Name.c_str());
+        fprintf(File, "      \"run_type\": \"iteration\",\n");
+        fprintf(File, "      \"repetitions\": %u,\n", Repetitions);
+        fprintf(File, "      \"iterations\": %llu,\n", (unsigned long long)Result.Iterations);
+        fprintf(File, "      \"real_time\": %.4f,\n", Result.RealNs);
+        fprintf(File, "      \"cpu_time\": %.4f,\n", Result.CpuNs);
+        fprintf(File, "      \"time_unit\": \"ns\"");
+        if (Result.ItemsPerSecond > 0) {
+            fprintf(File, ",\n      \"items_per_second\": %.4f", Result.ItemsPerSecond);
+        }
+        if (Result.BytesPerSecond > 0) {
+            fprintf(File, ",\n      \"bytes_per_second\": %.4f", Result.BytesPerSecond);
+        }
+        fprintf(File, "\n    }%s\n", i + 1 < Results.size() ? "," : "");
+    }
+    fprintf(File, "  ]\n}\n");
+    fclose(File);
+    return true;
+}
+
+static
+void
+PrintUsage(
+    )
+{
+    printf(
+        "Usage: msquiccorebench [options]\n"
+        "\n"
+        "  --filter=<substring>    Only run the benchmarks whose name contains this.\n"
+        "  --list                  List the benchmarks instead of running them.\n"
+        "  --min_time=<seconds>    The minimum time for each run. Default 0.5.\n"
+        "  --repetitions=<count>   The number of runs to report the median of. Default 3.\n"
+        "  --json=<path>           Also write the results to a file, in Google Benchmark's format.\n");
+}
+
+int QUIC_MAIN_EXPORT main(int argc, char** argv) {
+    const char* Filter = nullptr;
+    const char* JsonPath = nullptr;
+    double MinTime = 0.5;
+    uint32_t Repetitions = 3;
+    bool List = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* Arg = argv[i];
+        if (!strncmp(Arg, "--filter=", 9)) {
+            Filter = Arg + 9;
+        } else if (!strncmp(Arg, "--json=", 7)) {
+            JsonPath = Arg + 7;
+        } else if (!strncmp(Arg, "--min_time=", 11)) {
+            MinTime = atof(Arg + 11);
+        } else if (!strncmp(Arg, "--repetitions=", 14)) {
+            Repetitions = (uint32_t)atoi(Arg + 14);
+            if (Repetitions == 0) {
+                Repetitions = 1;
+            }
+        } else if (!strcmp(Arg, "--list")) {
+            List = true;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    MsQuicLibraryLoad();
+    if (QUIC_FAILED(MsQuicAddRef())) {
+        printf("Failed to initialize the library!\n");
+        MsQuicLibraryUnload();
+        return 1;
+    }
+
+    if (!List) {
+        printf("%-44s %14s %14s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+    }
+
+    std::vector<BenchResult> Results;
+    for (const BenchRegistration* Bench : BenchRegistration::List()) {
+        for (uint64_t Arg : Bench->Args) {
+            std::string Name = Bench->Name;
+            Name += "/" + std::to_string(Arg);
+            if (Filter != nullptr && Name.find(Filter) == std::string::npos) {
+                continue;
+            }
+            if (List) {
+                printf("%s\n", Name.c_str());
+                continue;
+            }
+            BenchResult Result = RunBenchmark(Bench, Arg, MinTime, Repetitions);
+            printf(
+                "%-44s %14.1f %14.1f %12llu",
+                Result.Name.c_str(),
+                Result.RealNs,
+                Result.CpuNs,
+                (unsigned long long)Result.Iterations);
+            if (Result.ItemsPerSecond > 0) {
+                printf(" items/s=%.3fM", Result.ItemsPerSecond / 1e6);
+            }
+            if (Result.BytesPerSecond > 0) {
+                printf(" bytes/s=%.3fG", Result.BytesPerSecond / 1e9);
+            }
+            printf("\n");
+            fflush(stdout);
+            Results.push_back(Result);
+        }
+    }
+
+    int ExitCode = 0;
+    if (JsonPath != nullptr && !WriteJson(JsonPath, Results, Repetitions)) {
+        ExitCode = 1;
+    }
+
+    MsQuicRelease();
+    MsQuicLibraryUnload();
+    return ExitCode;
+}
@@ -0,0 +1,152 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A minimal microbenchmark harness for the core library's hot path
+    primitives. Benchmarks are written and reported the way Google Benchmark
+    does it, so results (and the --json output) can be compared with tools
+    built for it, without taking a dependency on it.
+
+    A benchmark is declared with the arguments it's swept over:
+
+        QUIC_BENCH(RangeAddValue, 1, 64, 4096) {
+            ... // Setup for State.GetArg()
+            while (State.KeepRunning()) {
+                ... // Timed operation
+            }
+            State.SetItemsProcessed(State.GetIterations());
+        }
+
+--*/
+
+#pragma once
+
+#include "precomp.h"
+
+#undef min // STL headers conflict with previous definitions of min/max.
+#undef max
+#include <chrono>
+#include <ctime>
+#include <vector>
+
+class BenchState {
+
+    typedef std::chrono::steady_clock Clock;
+
+    uint64_t Arg;
+    uint64_t Iterations;
+    uint64_t Remaining;
+    Clock::time_point RealStart;
+    std::clock_t CpuStart {0};
+    bool Running {false};
+
+public:
+
+    double RealNs {0};
+    double CpuNs {0};
+    uint64_t ItemsProcessed {0};
+    uint64_t BytesProcessed {0};
+
+    BenchState(uint64_t Arg, uint64_t Iterations) :
+        Arg(Arg), Iterations(Iterations), Remaining(Iterations) { }
+
+    uint64_t GetArg() const { return Arg; }
+    uint64_t GetIterations() const { return Iterations; }
+
+    //
+    // Returns true while there are iterations left to run. Timing starts on
+    // the first call and stops on the last.
+    //
+    bool KeepRunning() {
+        if (Remaining == 0) {
+            if (Running) {
+                PauseTiming();
+            }
+            return false;
+        }
+        if (Remaining-- == Iterations) {
+            ResumeTiming();
+        }
+        return true;
+    }
+
+    //
+    // Excludes per-iteration setup from the measurement. Only use it around
+    // work that is long compared to reading the clock.
+    //
+    void PauseTiming() {
+        RealNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - RealStart).count();
+        CpuNs += (double)(std::clock() - CpuStart) * 1e9 / CLOCKS_PER_SEC;
+        Running = false;
+    }
+
+    void ResumeTiming() {
+        Running = true;
+        CpuStart = std::clock();
+        RealStart = Clock::now();
+    }
+
+    void SetItemsProcessed(uint64_t Items) { ItemsProcessed = Items; }
+    void SetBytesProcessed(uint64_t Bytes) { BytesProcessed = Bytes; }
+};
+
+typedef void (*BENCH_FN)(BenchState& State);
+
+struct BenchRegistration {
+    const char* Name;
+    BENCH_FN Fn;
+    std::vector<uint64_t> Args;
+
+    BenchRegistration(const char* Name, BENCH_FN Fn, std::initializer_list<uint64_t> Args) :
+        Name(Name), Fn(Fn), Args(Args) {
+        List().push_back(this);
+    }
+
+    static std::vector<BenchRegistration*>& List() {
+        static std::vector<BenchRegistration*> Registrations;
+        return Registrations;
+    }
+};
+
+#define QUIC_BENCH(Name, ...) \
+    static void Name(BenchState& State); \
+    static BenchRegistration Name##Registration(#Name, Name, {__VA_ARGS__}); \
+    static void Name(BenchState& State)
+
+//
+// Keeps the compiler from optimizing away a result that's otherwise unused.
+//
+template <typename T>
+QUIC_INLINE
+void
+BenchDoNotOptimize(
+    T const& Value
+    )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    volatile char Sink = *(volatile const char*)&Value;
+    (void)Sink;
+#else
+    __asm__ volatile("" : : "r,m"(Value) : "memory");
+#endif
+}
+
+//
+// A fast, deterministic random number generator (xorshift64), so that runs
+// are repeatable and the generator costs little next to what's measured.
+//
+struct BenchRandom {
+    uint64_t Seed;
+    BenchRandom(uint64_t Seed = 0x9E3779B97F4A7C15ull) : Seed(Seed) { }
+    uint64_t Next() {
+        Seed ^= Seed << 13;
+        Seed ^= Seed >> 7;
+        Seed ^= Seed << 17;
+        return Seed;
+    }
+    uint64_t Next(uint64_t Bound) { return Next() % Bound; }
+};
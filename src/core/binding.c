@@ -64,9 +64,11 @@ QuicBindingInitialize(
         Binding->PartitionIndex = UdpConfig->PartitionIndex;
     }
     Binding->StatelessOperCount = 0;
+    Binding->StatelessRateSketch = NULL;
     CxPlatDispatchRwLockInitialize(&Binding->RwLock);
     CxPlatDispatchLockInitialize(&Binding->StatelessOperLock);
     CxPlatListInitializeHead(&Binding->Listeners);
+    Binding->ListenerIndex = NULL;
     QuicLookupInitialize(&Binding->Lookup);
 #if DEBUG
     QuicLibraryTrackDbgObject(QUIC_DBG_OBJECT_TYPE_BINDING, &Binding->DbgObjectLink);
@@ -207,6 +209,7 @@ QuicBindingUninitialize(
 
     CXPLAT_TEL_ASSERT(Binding->RefCount == 0);
     CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&Binding->Listeners));
+    CXPLAT_DBG_ASSERT(Binding->ListenerIndex == NULL);
 
     //
     // Delete the datapath binding. This function blocks until all receive
@@ -234,6 +237,10 @@ QuicBindingUninitialize(
     CXPLAT_DBG_ASSERT(Binding->StatelessOperCount == 0);
     CXPLAT_DBG_ASSERT(Binding->StatelessOperTable.NumEntries == 0);
 
+    if (Binding->StatelessRateSketch != NULL) {
+        CXPLAT_FREE(Binding->StatelessRateSketch, QUIC_POOL_STATELESS_RATE);
+    }
+
     QuicLookupUninitialize(&Binding->Lookup);
     CxPlatDispatchLockUninitialize(&Binding->StatelessOperLock);
     CxPlatHashtableUninitialize(&Binding->StatelessOperTable);
@@ -312,6 +319,224 @@ QuicBindingGetRemoteAddress(
 #endif
 }
 
+//
+// The listener index flattens the binding's listener list into address groups
+// (the distinct family/wildcard/address combinations, in list order) and a
+// hash table of every listener ALPN, keyed by group and ALPN. Registration
+// forbids ALPN overlap between listeners of the same group, so a connection's
+// listener is found by probing the table with each of the client's ALPNs, for
+// the first group its local address matches.
+//
+
+typedef struct QUIC_LISTENER_INDEX_ENTRY {
+    QUIC_LISTENER* Listener; // NULL for an empty slot
+    const uint8_t* Alpn;     // Length prefixed, in the listener's ALPN list
+    uint32_t Hash;
+    uint32_t Group;
+    uint32_t Position;       // Of the listener in the binding's list
+} QUIC_LISTENER_INDEX_ENTRY;
+
+typedef struct QUIC_LISTENER_INDEX {
+    uint32_t GroupCount;
+    uint32_t EntryMask;
+    const QUIC_LISTENER** Groups; // First listener of each group
+    QUIC_LISTENER_INDEX_ENTRY* Entries;
+} QUIC_LISTENER_INDEX;
+
+QUIC_INLINE
+uint32_t
+QuicListenerIndexHash(
+    _In_ uint32_t Group,
+    _In_ uint8_t AlpnLength,
+    _In_reads_(AlpnLength) const uint8_t* Alpn
+    )
+{
+    uint32_t Hash = 2166136261u ^ (Group * 0x9E3779B9u); // FNV-1a
+    for (uint8_t i = 0; i < AlpnLength; ++i) {
+        Hash = (Hash ^ Alpn[i]) * 16777619u;
+    }
+    return Hash;
+}
+
+//
+// Returns TRUE if both listeners are in the same address group, i.e. have the
+// same family, wildcard and address.
+//
+QUIC_INLINE
+BOOLEAN
+QuicListenerIndexSameGroup(
+    _In_ const QUIC_LISTENER* Listener1,
+    _In_ const QUIC_LISTENER* Listener2
+    )
+{
+    const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(&Listener1->LocalAddress);
+    return
+        Family == QuicAddrGetFamily(&Listener2->LocalAddress) &&
+        Listener1->WildCard == Listener2->WildCard &&
+        (Family == QUIC_ADDRESS_FAMILY_UNSPEC ||
+         QuicAddrCompareIp(&Listener1->LocalAddress, &Listener2->LocalAddress));
+}
+
+//
+// Rebuilds the listener index from the list of listeners. Called with the
+// binding's lock held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingRebuildListenerIndex(
+    _In_ QUIC_BINDING* Binding
+    )
+{
+    QUIC_LISTENER_INDEX* OldIndex = Binding->ListenerIndex;
+    QUIC_LISTENER_INDEX* Index = NULL;
+    Binding->ListenerIndex = NULL;
+
+    uint32_t ListenerCount = 0;
+    uint32_t AlpnCount = 0;
+    for (CXPLAT_LIST_ENTRY* Link = Binding->Listeners.Flink;
+        Link != &Binding->Listeners;
+        Link = Link->Flink) {
+        const QUIC_LISTENER* Listener = CXPLAT_CONTAINING_RECORD(Link, QUIC_LISTENER, Link);
+        const uint8_t* Alpn = Listener->AlpnList;
+        const uint8_t* AlpnEnd = Alpn + Listener->AlpnListLength;
+        for (; Alpn < AlpnEnd; Alpn += Alpn[0] + 1) {
+            AlpnCount++;
+        }
+        ListenerCount++;
+    }
+
+    if (ListenerCount == 0) {
+        goto Exit;
+    }
+
+    uint32_t EntryCount = 8;
+    while (EntryCount < 2 * AlpnCount) {
+        EntryCount <<= 1;
+    }
+
+    //
+    // The groups can be at most one per listener.
+    //
+    const size_t Size =
+        sizeof(QUIC_LISTENER_INDEX) +
+        EntryCount * sizeof(QUIC_LISTENER_INDEX_ENTRY) +
+        ListenerCount * sizeof(QUIC_LISTENER*);
+    Index = CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_LISTENER_INDEX);
+    if (Index == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "listener index",
+            Size);
+        goto Exit; // Fall back to searching the list.
+    }
+    CxPlatZeroMemory(Index, Size);
+    Index->EntryMask = EntryCount - 1;
+    Index->Entries = (QUIC_LISTENER_INDEX_ENTRY*)(Index + 1);
+    Index->Groups = (const QUIC_LISTENER**)(Index->Entries + EntryCount);
+
+    uint32_t Position = 0;
+    for (CXPLAT_LIST_ENTRY* Link = Binding->Listeners.Flink;
+        Link != &Binding->Listeners;
+        Link = Link->Flink, Position++) {
+        QUIC_LISTENER* Listener = CXPLAT_CONTAINING_RECORD(Link, QUIC_LISTENER, Link);
+
+        uint32_t Group = 0;
+        while (Group < Index->GroupCount &&
+               !QuicListenerIndexSameGroup(Index->Groups[Group], Listener)) {
+            Group++;
+        }
+        if (Group == Index->GroupCount) {
+            Index->Groups[Index->GroupCount++] = Listener;
+        }
+
+        const uint8_t* Alpn = Listener->AlpnList;
+        const uint8_t* AlpnEnd = Alpn + Listener->AlpnListLength;
+        for (; Alpn < AlpnEnd; Alpn += Alpn[0] + 1) {
+            const uint32_t Hash = QuicListenerIndexHash(Group, Alpn[0], Alpn + 1);
+            uint32_t Slot = Hash & Index->EntryMask;
+            while (Index->Entries[Slot].Listener != NULL) {
+                Slot = (Slot + 1) & Index->EntryMask;
+            }
+            QUIC_LISTENER_INDEX_ENTRY* Entry = &Index->Entries[Slot];
+            Entry->Listener = Listener;
+            Entry->Alpn = Alpn;
+            Entry->Hash = Hash;
+            Entry->Group = Group;
+            Entry->Position = Position;
+        }
+    }
+
+    Binding->ListenerIndex = Index;
+
+Exit:
+
+    if (OldIndex != NULL) {
+        CXPLAT_FREE(OldIndex, QUIC_POOL_LISTENER_INDEX);
+    }
+}
+
+//
+// Finds the first listener in the binding's list that matches the local
+// address and any of the client's ALPNs, using the listener index. Called with
+// the binding's lock held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_LISTENER*
+QuicBindingIndexLookupListener(
+    _In_ const QUIC_LISTENER_INDEX* Index,
+    _In_ const QUIC_NEW_CONNECTION_INFO* Info,
+    _Out_ BOOLEAN* AddrMatched
+    )
+{
+    const QUIC_ADDR* Addr = Info->LocalAddress;
+    const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(Addr);
+    *AddrMatched = FALSE;
+
+    for (uint32_t Group = 0; Group < Index->GroupCount; ++Group) {
+        const QUIC_LISTENER* First = Index->Groups[Group];
+        const QUIC_ADDRESS_FAMILY GroupFamily = QuicAddrGetFamily(&First->LocalAddress);
+        if (GroupFamily != QUIC_ADDRESS_FAMILY_UNSPEC) {
+            if (Family != GroupFamily ||
+                (!First->WildCard && !QuicAddrCompareIp(Addr, &First->LocalAddress))) {
+                continue; // No IP match.
+            }
+        }
+        *AddrMatched = TRUE;
+
+        QUIC_LISTENER* Best = NULL;
+        uint32_t BestPosition = UINT32_MAX;
+        const uint8_t* Alpn = Info->ClientAlpnList;
+        uint16_t AlpnListLength = Info->ClientAlpnListLength;
+        while (AlpnListLength != 0 && Alpn[0] + 1 <= AlpnListLength) {
+            const uint32_t Hash = QuicListenerIndexHash(Group, Alpn[0], Alpn + 1);
+            for (uint32_t Slot = Hash & Index->EntryMask;
+                Index->Entries[Slot].Listener != NULL;
+                Slot = (Slot + 1) & Index->EntryMask) {
+                const QUIC_LISTENER_INDEX_ENTRY* Entry = &Index->Entries[Slot];
+                if (Entry->Hash == Hash &&
+                    Entry->Group == Group &&
+                    Entry->Alpn[0] == Alpn[0] &&
+                    memcmp(Entry->Alpn + 1, Alpn + 1, Alpn[0]) == 0) {
+                    if (Entry->Position < BestPosition) {
+                        Best = Entry->Listener;
+                        BestPosition = Entry->Position;
+                    }
+                    break;
+                }
+            }
+            AlpnListLength -= Alpn[0] + 1;
+            Alpn += Alpn[0] + 1;
+        }
+
+        if (Best != NULL) {
+            return Best;
+        }
+    }
+
+    return NULL;
+}
+
 //
 // Returns TRUE if there are any registered listeners on this binding.
 //
@@ -406,6 +631,8 @@ QuicBindingRegisterListener(
             NewListener->Link.Blink->Flink = &NewListener->Link;
             Link->Blink = &NewListener->Link;
         }
+
+        QuicBindingRebuildListenerIndex(Binding);
     }
 
     CxPlatDispatchRwLockReleaseExclusive(&Binding->RwLock, PrevIrql);
@@ -438,6 +665,20 @@ QuicBindingGetListener(
 
     CxPlatDispatchRwLockAcquireShared(&Binding->RwLock, PrevIrql);
 
+    if (Binding->ListenerIndex != NULL) {
+        BOOLEAN AddrMatched;
+        QUIC_LISTENER* ExistingListener =
+            QuicBindingIndexLookupListener(Binding->ListenerIndex, Info, &AddrMatched);
+        FailedAddrMatch = !AddrMatched;
+        if (ExistingListener == NULL) {
+            FailedAlpnMatch = AddrMatched;
+        } else if (QuicListenerMatchesAlpn(ExistingListener, Info) && // Sets the negotiated ALPN
+            CxPlatRefIncrementNonZero(&ExistingListener->StartRefCount, 1)) {
+            Listener = ExistingListener;
+        }
+        goto Done;
+    }
+
     for (CXPLAT_LIST_ENTRY* Link = Binding->Listeners.Flink;
         Link != &Binding->Listeners;
         Link = Link->Flink) {
@@ -499,6 +740,7 @@ QuicBindingUnregisterListener(
 {
     CxPlatDispatchRwLockAcquireExclusive(&Binding->RwLock, PrevIrql);
     CxPlatListEntryRemove(&Listener->Link);
+    QuicBindingRebuildListenerIndex(Binding);
     CxPlatDispatchRwLockReleaseExclusive(&Binding->RwLock, PrevIrql);
 }
 
@@ -612,6 +854,28 @@ QuicBindingMoveSourceConnectionIDs(
         &BindingSrc->Lookup, &BindingDest->Lookup, Connection);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicBindingAddStandbyConnection(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    return
+        Binding->Exclusive &&
+        QuicLookupAddStandbyConnection(&Binding->Lookup, Connection);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingRemoveStandbyConnection(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QuicLookupRemoveStandbyConnection(&Binding->Lookup, Connection);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicBindingOnConnectionHandshakeConfirmed(
@@ -624,6 +888,121 @@ QuicBindingOnConnectionHandshakeConfirmed(
     }
 }
 
+//
+// Stateless responses are rate limited per source address prefix, so that a
+// spoofed flood can neither use the binding to reflect traffic at a victim
+// network nor keep it busy building responses, while other clients still get
+// theirs. The responses sent to each prefix in the current interval are
+// counted in a count-min sketch: each prefix maps to one counter per row and
+// its count is estimated as the smallest of them, which can only over-count
+// (when all of them are shared with other prefixes). That makes the limit a
+// token bucket of QUIC_STATELESS_RATE_PER_PREFIX responses, refilled every
+// QUIC_STATELESS_RATE_INTERVAL_MS, in a fixed amount of memory.
+//
+// The sketch is updated from any receive thread without locks. Lost updates
+// only make the limit a bit less strict.
+//
+typedef struct QUIC_STATELESS_RATE_SKETCH {
+    uint64_t Seed;
+    long volatile IntervalStartMs;
+    uint8_t Counts[QUIC_STATELESS_RATE_SKETCH_DEPTH][QUIC_STATELESS_RATE_SKETCH_WIDTH];
+} QUIC_STATELESS_RATE_SKETCH;
+
+CXPLAT_STATIC_ASSERT(
+    QUIC_STATELESS_RATE_PER_PREFIX < UINT8_MAX,
+    "Counts must not overflow");
+CXPLAT_STATIC_ASSERT(
+    IS_POWER_OF_TWO(QUIC_STATELESS_RATE_SKETCH_WIDTH),
+    "Width must be a power of 2");
+
+//
+// Returns TRUE if a stateless response may be sent to the source of the
+// packet, and counts it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicBindingAllowStatelessResponse(
+    _In_ QUIC_BINDING* Binding,
+    _In_ const QUIC_RX_PACKET* Packet
+    )
+{
+    const uint32_t TimeMs = CxPlatTimeMs32();
+    QUIC_STATELESS_RATE_SKETCH* Sketch = Binding->StatelessRateSketch;
+    if (Sketch == NULL) {
+        QUIC_STATELESS_RATE_SKETCH* NewSketch =
+            CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_STATELESS_RATE_SKETCH), QUIC_POOL_STATELESS_RATE);
+        if (NewSketch == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "stateless rate sketch",
+                sizeof(QUIC_STATELESS_RATE_SKETCH));
+            return TRUE; // Still bounded by the stateless operation limits.
+        }
+        CxPlatZeroMemory(NewSketch, sizeof(QUIC_STATELESS_RATE_SKETCH));
+        CxPlatRandom(sizeof(NewSketch->Seed), &NewSketch->Seed);
+        NewSketch->Seed |= 1;
+        NewSketch->IntervalStartMs = (long)TimeMs;
+        Sketch =
+            InterlockedCompareExchangePointer(
+                (void* volatile*)&Binding->StatelessRateSketch, NewSketch, NULL);
+        if (Sketch == NULL) {
+            Sketch = NewSketch;
+        } else {
+            CXPLAT_FREE(NewSketch, QUIC_POOL_STATELESS_RATE); // Lost the race.
+        }
+    }
+
+    const long IntervalStartMs = Sketch->IntervalStartMs;
+    if (CxPlatTimeDiff32((uint32_t)IntervalStartMs, TimeMs) >= QUIC_STATELESS_RATE_INTERVAL_MS &&
+        InterlockedCompareExchange(
+            &Sketch->IntervalStartMs, (long)TimeMs, IntervalStartMs) == IntervalStartMs) {
+        CxPlatZeroMemory(Sketch->Counts, sizeof(Sketch->Counts));
+    }
+
+    //
+    // The key is the /24 or /48 prefix of the source address.
+    //
+    const QUIC_ADDR* RemoteAddress = &Packet->Route->RemoteAddress;
+    uint64_t Key = 0;
+    if (QuicAddrGetFamily(RemoteAddress) == QUIC_ADDRESS_FAMILY_INET) {
+        CxPlatCopyMemory(&Key, &RemoteAddress->Ipv4.sin_addr, 3);
+    } else {
+        CxPlatCopyMemory(&Key, &RemoteAddress->Ipv6.sin6_addr, 6);
+        Key |= 1ull << 63;
+    }
+
+    uint8_t* Counters[QUIC_STATELESS_RATE_SKETCH_DEPTH];
+    uint8_t Min = UINT8_MAX;
+    for (uint32_t i = 0; i < QUIC_STATELESS_RATE_SKETCH_DEPTH; ++i) {
+        //
+        // An independent multiplicative hash per row, from the top bits.
+        //
+        const uint64_t Hash = (Key ^ (Sketch->Seed * (i + 1))) * (Sketch->Seed + 2 * i);
+        Counters[i] =
+            &Sketch->Counts[i][(Hash >> 40) & (QUIC_STATELESS_RATE_SKETCH_WIDTH - 1)];
+        if (*Counters[i] < Min) {
+            Min = *Counters[i];
+        }
+    }
+
+    if (Min >= QUIC_STATELESS_RATE_PER_PREFIX) {
+        return FALSE;
+    }
+
+    //
+    // Conservative update: only raise the counters at the minimum, which keeps
+    // the over-counting of prefixes sharing them lower.
+    //
+    for (uint32_t i = 0; i < QUIC_STATELESS_RATE_SKETCH_DEPTH; ++i) {
+        if (*Counters[i] == Min) {
+            *Counters[i] = Min + 1;
+        }
+    }
+
+    return TRUE;
+}
+
 //
 // This attempts to add a new stateless operation (for a given remote endpoint)
 // to the tracking structures in the binding. It first ages out any old
@@ -762,6 +1141,11 @@ QuicBindingQueueStatelessOperation(
         return FALSE;
     }
 
+    if (!QuicBindingAllowStatelessResponse(Binding, Packet)) {
+        QuicPacketLogDrop(Binding, Packet, "Stateless response rate limited");
+        return FALSE;
+    }
+
     QUIC_WORKER* Worker = QuicLibraryGetWorker(Packet);
     if (QuicWorkerIsOverloaded(Worker)) {
         QuicPacketLogDrop(Binding, Packet, "Stateless worker overloaded (stateless oper)");
@@ -969,98 +1353,140 @@ QuicBindingProcessStatelessOperation(
 
         QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_SEND_STATELESS_RESET);
 
-    } else if (OperationType == QUIC_OPER_TYPE_RETRY) {
+    } else {
+        CXPLAT_TEL_ASSERT(FALSE); // Should be unreachable code.
+        goto Exit;
+    }
+
+    QuicBindingSend(
+        Binding,
+        Partition,
+        RecvPacket->Route,
+        SendData,
+        SendDatagram->Length,
+        1);
+    SendData = NULL;
 
-        CXPLAT_DBG_ASSERT(RecvPacket->DestCid != NULL);
-        CXPLAT_DBG_ASSERT(RecvPacket->SourceCid != NULL);
+Exit:
 
-        uint16_t PacketLength = QuicPacketMaxBufferSizeForRetryV1();
-        SendDatagram =
-            CxPlatSendDataAllocBuffer(SendData, PacketLength);
-        if (SendDatagram == NULL) {
-            QuicTraceEvent(
-                AllocFailure,
-                "Allocation of '%s' failed. (%llu bytes)",
-                "retry datagram",
-                PacketLength);
-            goto Exit;
-        }
+    if (SendData != NULL) {
+        CxPlatSendDataFree(SendData);
+    }
+}
 
-        uint8_t NewDestCid[QUIC_CID_MAX_LENGTH];
-        CXPLAT_DBG_ASSERT(sizeof(NewDestCid) >= MsQuicLib.CidTotalLength);
-        CxPlatRandom(sizeof(NewDestCid), NewDestCid);
+//
+// Sends a Retry for a new connection's Initial packet. Unlike the other
+// stateless responses, this runs inline on the receive path: it needs no
+// per-remote tracking (a Retry is smaller than the Initial that triggers it)
+// and only takes the receiving partition's retry key lock, so Retry rate
+// scales with the number of receive queues.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingSendRetry(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_RX_PACKET* RecvPacket
+    )
+{
+    QUIC_PARTITION* Partition = &MsQuicLib.Partitions[RecvPacket->PartitionIndex];
+    QUIC_BUFFER* SendDatagram = NULL;
+
+    CXPLAT_DBG_ASSERT(RecvPacket->DestCid != NULL);
+    CXPLAT_DBG_ASSERT(RecvPacket->SourceCid != NULL);
+
+    CXPLAT_SEND_CONFIG SendConfig = { RecvPacket->Route, 0, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0 };
+    CXPLAT_SEND_DATA* SendData = CxPlatSendDataAlloc(Binding->Socket, &SendConfig);
+    if (SendData == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "stateless send data",
+            0);
+        goto Exit;
+    }
 
-        QUIC_TOKEN_CONTENTS Token = { 0 };
-        Token.Authenticated.Timestamp = (uint64_t)CxPlatTimeEpochMs64();
-        Token.Authenticated.IsNewToken = FALSE;
+    uint16_t PacketLength = QuicPacketMaxBufferSizeForRetryV1();
+    SendDatagram =
+        CxPlatSendDataAllocBuffer(SendData, PacketLength);
+    if (SendDatagram == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "retry datagram",
+            PacketLength);
+        goto Exit;
+    }
 
-        Token.Encrypted.RemoteAddress = RecvPacket->Route->RemoteAddress;
-        CxPlatCopyMemory(Token.Encrypted.OrigConnId, RecvPacket->DestCid, RecvPacket->DestCidLen);
-        Token.Encrypted.OrigConnIdLength = RecvPacket->DestCidLen;
+    uint8_t NewDestCid[QUIC_CID_MAX_LENGTH];
+    CXPLAT_DBG_ASSERT(sizeof(NewDestCid) >= MsQuicLib.CidTotalLength);
+    CxPlatRandom(sizeof(NewDestCid), NewDestCid);
 
-        uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
-        if (MsQuicLib.CidTotalLength >= CXPLAT_IV_LENGTH) {
-            CxPlatCopyMemory(Iv, NewDestCid, CXPLAT_IV_LENGTH);
-            for (uint8_t i = CXPLAT_IV_LENGTH; i < MsQuicLib.CidTotalLength; ++i) {
-                Iv[i % CXPLAT_IV_LENGTH] ^= NewDestCid[i];
-            }
-        } else {
-            CxPlatZeroMemory(Iv, CXPLAT_IV_LENGTH);
-            CxPlatCopyMemory(Iv, NewDestCid, MsQuicLib.CidTotalLength);
-        }
+    QUIC_TOKEN_CONTENTS Token = { 0 };
+    Token.Authenticated.Timestamp = (uint64_t)CxPlatTimeEpochMs64();
+    Token.Authenticated.IsNewToken = FALSE;
 
-        CxPlatDispatchLockAcquire(&Partition->StatelessRetryKeysLock);
+    Token.Encrypted.RemoteAddress = RecvPacket->Route->RemoteAddress;
+    CxPlatCopyMemory(Token.Encrypted.OrigConnId, RecvPacket->DestCid, RecvPacket->DestCidLen);
+    Token.Encrypted.OrigConnIdLength = RecvPacket->DestCidLen;
 
-        CXPLAT_KEY* StatelessRetryKey =
-            QuicPartitionGetCurrentStatelessRetryKey(Partition);
-        if (StatelessRetryKey == NULL) {
-            CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
-            goto Exit;
+    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+    if (MsQuicLib.CidTotalLength >= CXPLAT_IV_LENGTH) {
+        CxPlatCopyMemory(Iv, NewDestCid, CXPLAT_IV_LENGTH);
+        for (uint8_t i = CXPLAT_IV_LENGTH; i < MsQuicLib.CidTotalLength; ++i) {
+            Iv[i % CXPLAT_IV_LENGTH] ^= NewDestCid[i];
         }
+    } else {
+        CxPlatZeroMemory(Iv, CXPLAT_IV_LENGTH);
+        CxPlatCopyMemory(Iv, NewDestCid, MsQuicLib.CidTotalLength);
+    }
 
-        QUIC_STATUS Status =
-            CxPlatEncrypt(
-                StatelessRetryKey,
-                Iv,
-                sizeof(Token.Authenticated), (uint8_t*) &Token.Authenticated,
-                sizeof(Token.Encrypted) + sizeof(Token.EncryptionTag), (uint8_t*)&(Token.Encrypted));
+    CxPlatDispatchLockAcquire(&Partition->StatelessRetryKeysLock);
 
+    CXPLAT_KEY* StatelessRetryKey =
+        QuicPartitionGetCurrentStatelessRetryKey(Partition);
+    if (StatelessRetryKey == NULL) {
         CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
-        if (QUIC_FAILED(Status)) {
-            goto Exit;
-        }
-
-        SendDatagram->Length =
-            QuicPacketEncodeRetryV1(
-                RecvPacket->LH->Version,
-                RecvPacket->SourceCid, RecvPacket->SourceCidLen,
-                NewDestCid, MsQuicLib.CidTotalLength,
-                RecvPacket->DestCid, RecvPacket->DestCidLen,
-                sizeof(Token),
-                (uint8_t*)&Token,
-                (uint16_t)SendDatagram->Length,
-                SendDatagram->Buffer);
-        if (SendDatagram->Length == 0) {
-            CXPLAT_DBG_ASSERT(CxPlatIsRandomMemoryFailureEnabled());
-            goto Exit;
-        }
+        goto Exit;
+    }
 
-        QuicTraceLogVerbose(
-            PacketTxRetry,
-            "[S][TX][-] LH Ver:0x%x DestCid:%s SrcCid:%s Type:R OrigDestCid:%s (Token %hu bytes)",
-            RecvPacket->LH->Version,
-            QuicCidBufToStr(RecvPacket->SourceCid, RecvPacket->SourceCidLen).Buffer,
-            QuicCidBufToStr(NewDestCid, MsQuicLib.CidTotalLength).Buffer,
-            QuicCidBufToStr(RecvPacket->DestCid, RecvPacket->DestCidLen).Buffer,
-            (uint16_t)sizeof(Token));
+    QUIC_STATUS Status =
+        CxPlatEncrypt(
+            StatelessRetryKey,
+            Iv,
+            sizeof(Token.Authenticated), (uint8_t*) &Token.Authenticated,
+            sizeof(Token.Encrypted) + sizeof(Token.EncryptionTag), (uint8_t*)&(Token.Encrypted));
 
-        QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_SEND_STATELESS_RETRY);
+    CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
 
-    } else {
-        CXPLAT_TEL_ASSERT(FALSE); // Should be unreachable code.
+    SendDatagram->Length =
+        QuicPacketEncodeRetryV1(
+            RecvPacket->LH->Version,
+            RecvPacket->SourceCid, RecvPacket->SourceCidLen,
+            NewDestCid, MsQuicLib.CidTotalLength,
+            RecvPacket->DestCid, RecvPacket->DestCidLen,
+            sizeof(Token),
+            (uint8_t*)&Token,
+            (uint16_t)SendDatagram->Length,
+            SendDatagram->Buffer);
+    if (SendDatagram->Length == 0) {
+        CXPLAT_DBG_ASSERT(CxPlatIsRandomMemoryFailureEnabled());
         goto Exit;
     }
 
+    QuicTraceLogVerbose(
+        PacketTxRetry,
+        "[S][TX][-] LH Ver:0x%x DestCid:%s SrcCid:%s Type:R OrigDestCid:%s (Token %hu bytes)",
+        RecvPacket->LH->Version,
+        QuicCidBufToStr(RecvPacket->SourceCid, RecvPacket->SourceCidLen).Buffer,
+        QuicCidBufToStr(NewDestCid, MsQuicLib.CidTotalLength).Buffer,
+        QuicCidBufToStr(RecvPacket->DestCid, RecvPacket->DestCidLen).Buffer,
+        (uint16_t)sizeof(Token));
+
+    QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_SEND_STATELESS_RETRY);
+
     QuicBindingSend(
         Binding,
         Partition,
@@ -1205,6 +1631,12 @@ QuicBindingPreprocessPacket(
         }
     }
 
+    //
+    // Hash the destination CID once, while the header is still hot in cache,
+    // so the subchain grouping and the lookup don't each compute it.
+    //
+    Packet->DestCidHash = CxPlatHashSimple(Packet->DestCidLen, Packet->DestCid);
+
     *ReleaseDatagram = FALSE;
 
     return TRUE;
@@ -1255,6 +1687,34 @@ QuicBindingShouldRetryConnection(
     return MsQuicLib.CurrentHandshakeMemoryUsage >= CurrentMemoryLimit;
 }
 
+//
+// Returns TRUE if the client is resuming: it either sent 0-RTT along with its
+// Initial, or a valid token from a previous connection or Retry.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+BOOLEAN
+QuicBindingIsResumption(
+    _In_ const QUIC_RX_PACKET* Packets
+    )
+{
+    if (Packets->ValidToken) {
+        return TRUE;
+    }
+
+    for (const QUIC_RX_PACKET* Packet = Packets;
+         Packet != NULL;
+         Packet = (const QUIC_RX_PACKET*)Packet->Next) {
+        if (Packet->ValidatedHeaderInv &&
+            Packet->Invariant->IsLongHeader &&
+            !QuicPacketIsHandshake(Packet->Invariant)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicBindingCreateConnection(
@@ -1271,10 +1731,18 @@ QuicBindingCreateConnection(
     //
     // Pick a stateless worker to process the client hello and if successful,
     // the connection will later be moved to the correct registration's worker.
+    // Resuming clients are admitted ahead of fresh handshakes.
     //
+    const BOOLEAN IsResumption = QuicBindingIsResumption(Packet);
     QUIC_WORKER* Worker = QuicLibraryGetWorker(Packet);
-    if (QuicWorkerIsOverloaded(Worker)) {
-        QuicPacketLogDrop(Binding, Packet, "Stateless worker overloaded");
+    if (!QuicWorkerCanAdmitConnection(Worker, IsResumption)) {
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QuicWorkerIsOverloaded(Worker) ?
+                "Stateless worker overloaded" :
+                "Stateless worker handshake admission");
+        QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_LOAD_REJECT);
         return NULL;
     }
 
@@ -1302,6 +1770,9 @@ QuicBindingCreateConnection(
 
     QuicConnAddRef(NewConnection, QUIC_CONN_REF_LOOKUP_RESULT);
 
+    NewConnection->State.HandshakeQueued = TRUE;
+    InterlockedIncrement(&Worker->HandshakeQueueCount);
+
     //
     // Even though the new connection might not end up being put in this
     // binding's lookup table, it must be completely set up before it is
@@ -1333,7 +1804,11 @@ QuicBindingCreateConnection(
         goto Exit;
     }
 
-    QuicWorkerQueueConnection(NewConnection->Worker, NewConnection);
+    if (IsResumption) {
+        QuicWorkerQueuePriorityConnection(NewConnection->Worker, NewConnection);
+    } else {
+        QuicWorkerQueueConnection(NewConnection->Worker, NewConnection);
+    }
 
     return NewConnection;
 
@@ -1365,6 +1840,8 @@ Exit:
 #pragma warning(pop)
 
     } else {
+        NewConnection->State.HandshakeQueued = FALSE;
+        InterlockedDecrement(&Worker->HandshakeQueueCount);
         NewConnection->SourceCids.Next = NULL;
         CXPLAT_FREE(SourceCid, QUIC_POOL_CIDHASH);
         QuicConnRelease(NewConnection, QUIC_CONN_REF_LOOKUP_RESULT);
@@ -1467,7 +1944,8 @@ QuicBindingDeliverPackets(
             QuicLookupFindConnectionByLocalCid(
                 &Binding->Lookup,
                 Packets->DestCid,
-                Packets->DestCidLen);
+                Packets->DestCidLen,
+                Packets->DestCidHash);
     } else {
         Connection =
             QuicLookupFindConnectionByRemoteHash(
@@ -1576,9 +2054,12 @@ QuicBindingDeliverPackets(
         BOOLEAN DropPacket = FALSE;
         if (QuicBindingShouldRetryConnection(
                 Binding, Packets, TokenLength, Token, &DropPacket)) {
-            return
-                QuicBindingQueueStatelessOperation(
-                    Binding, QUIC_OPER_TYPE_RETRY, Packets);
+            if (QuicBindingAllowStatelessResponse(Binding, Packets)) {
+                QuicBindingSendRetry(Binding, Packets);
+            } else {
+                QuicPacketLogDrop(Binding, Packets, "Stateless response rate limited");
+            }
+            return FALSE; // The packets can be returned right away.
         }
 
         if (!DropPacket) {
@@ -1590,6 +2071,22 @@ QuicBindingDeliverPackets(
         return FALSE;
     }
 
+#ifndef _KERNEL_MODE
+    //
+    // Stage the packets on the current partition, so that the connection's
+    // packets from all the receive indications processed by this thread are
+    // queued to it together.
+    //
+    if (QuicPartitionStageRecvPackets(
+            QuicLibraryGetCurrentPartition(),
+            Connection,
+            Packets,
+            PacketChainLength,
+            PacketChainByteLength)) {
+        return TRUE;
+    }
+#endif
+
     QuicConnQueueRecvPackets(
         Connection, Packets, PacketChainLength, PacketChainByteLength);
     QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
@@ -1597,6 +2094,34 @@ QuicBindingDeliverPackets(
     return TRUE;
 }
 
+//
+// A set of received datagrams with the same destination CID, with any
+// handshake packets ordered first.
+//
+typedef struct QUIC_RECV_SUBCHAIN {
+    CXPLAT_RECV_DATA* Head;
+    CXPLAT_RECV_DATA** Tail;     // End of the leading handshake packets
+    CXPLAT_RECV_DATA** DataTail; // End of the whole chain
+    uint32_t Length;
+    uint32_t Bytes;
+} QUIC_RECV_SUBCHAIN;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicBindingDeliverSubChain(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_RECV_SUBCHAIN* SubChain,
+    _Inout_ CXPLAT_RECV_DATA*** ReleaseChainTail
+    )
+{
+    if (!QuicBindingDeliverPackets(
+            Binding, (QUIC_RX_PACKET*)SubChain->Head, SubChain->Length, SubChain->Bytes)) {
+        **ReleaseChainTail = SubChain->Head;
+        *ReleaseChainTail = SubChain->DataTail;
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Function_class_(CXPLAT_DATAPATH_RECEIVE_CALLBACK)
 void
@@ -1613,19 +2138,23 @@ QuicBindingReceive(
     QUIC_BINDING* Binding = (QUIC_BINDING*)RecvCallbackContext;
     CXPLAT_RECV_DATA* ReleaseChain = NULL;
     CXPLAT_RECV_DATA** ReleaseChainTail = &ReleaseChain;
-    CXPLAT_RECV_DATA* SubChain = NULL;
-    CXPLAT_RECV_DATA** SubChainTail = &SubChain;
-    CXPLAT_RECV_DATA** SubChainDataTail = &SubChain;
-    uint32_t SubChainLength = 0;
-    uint32_t SubChainBytes = 0;
+    QUIC_RECV_SUBCHAIN SubChains[QUIC_MAX_RECEIVE_SUBCHAIN_COUNT];
+    uint32_t SubChainCount = 0;
+    uint32_t NextSubChainEvict = 0;
     uint32_t TotalChainLength = 0;
     uint32_t TotalDatagramBytes = 0;
 
     CXPLAT_DBG_ASSERT(Socket == Binding->Socket);
 
+    if (MsQuicLib.RecvCapture.File != NULL) {
+        QuicRecvCaptureDatagrams(DatagramChain);
+    }
+
     //
     // Breaks the chain of datagrams into subchains by destination CID and
-    // delivers the subchains.
+    // delivers the subchains. Datagrams from different connections are often
+    // interleaved (e.g. multiple peers' GRO batches in one receive), so a few
+    // subchains are gathered at once to give each connection longer batches.
     //
     // NB: All packets in a datagram are required to have the same destination
     // CID, so we don't split datagrams here. Later on, the packet handling
@@ -1704,61 +2233,73 @@ QuicBindingReceive(
         CXPLAT_DBG_ASSERT(Packet->ValidatedHeaderInv);
 
         //
-        // If the next datagram doesn't match the current subchain, deliver the
-        // current subchain and start a new one.
+        // Find the subchain for the datagram's destination CID. If there isn't
+        // one and all are in use, deliver the oldest one to make room.
         // (If the binding is exclusively owned, all datagrams are delivered to
         // the same connection and this chain-splitting step is skipped.)
         //
-        if (!Binding->Exclusive && SubChain != NULL) {
-            QUIC_RX_PACKET* SubChainPacket = (QUIC_RX_PACKET*)SubChain;
-            if ((Packet->DestCidLen != SubChainPacket->DestCidLen ||
-                 memcmp(Packet->DestCid, SubChainPacket->DestCid, Packet->DestCidLen) != 0)) {
-                if (!QuicBindingDeliverPackets(Binding, (QUIC_RX_PACKET*)SubChain, SubChainLength, SubChainBytes)) {
-                    *ReleaseChainTail = SubChain;
-                    ReleaseChainTail = SubChainDataTail;
+        QUIC_RECV_SUBCHAIN* SubChain = NULL;
+        if (Binding->Exclusive) {
+            if (SubChainCount != 0) {
+                SubChain = &SubChains[0];
+            }
+        } else {
+            for (uint32_t i = 0; i < SubChainCount; ++i) {
+                QUIC_RX_PACKET* SubChainPacket = (QUIC_RX_PACKET*)SubChains[i].Head;
+                if (Packet->DestCidHash == SubChainPacket->DestCidHash &&
+                    Packet->DestCidLen == SubChainPacket->DestCidLen &&
+                    memcmp(Packet->DestCid, SubChainPacket->DestCid, Packet->DestCidLen) == 0) {
+                    SubChain = &SubChains[i];
+                    break;
                 }
-                SubChain = NULL;
-                SubChainTail = &SubChain;
-                SubChainDataTail = &SubChain;
-                SubChainLength = 0;
-                SubChainBytes = 0;
             }
         }
+        if (SubChain == NULL) {
+            if (SubChainCount < QUIC_MAX_RECEIVE_SUBCHAIN_COUNT) {
+                SubChain = &SubChains[SubChainCount++];
+            } else {
+                SubChain = &SubChains[NextSubChainEvict];
+                NextSubChainEvict = (NextSubChainEvict + 1) % QUIC_MAX_RECEIVE_SUBCHAIN_COUNT;
+                QuicBindingDeliverSubChain(Binding, SubChain, &ReleaseChainTail);
+            }
+            SubChain->Head = NULL;
+            SubChain->Tail = &SubChain->Head;
+            SubChain->DataTail = &SubChain->Head;
+            SubChain->Length = 0;
+            SubChain->Bytes = 0;
+        }
 
         //
-        // Insert the datagram into the current chain, with handshake packets
-        // first (we assume handshake packets don't come after non-handshake
-        // packets in a datagram).
+        // Insert the datagram into the chain, with handshake packets first (we
+        // assume handshake packets don't come after non-handshake packets in a
+        // datagram).
         // We do this so that we can more easily determine if the chain of
         // packets can create a new connection.
         //
 
-        SubChainLength++;
-        SubChainBytes += Datagram->BufferLength;
+        SubChain->Length++;
+        SubChain->Bytes += Datagram->BufferLength;
         if (!QuicPacketIsHandshake(Packet->Invariant)) {
-            *SubChainDataTail = Datagram;
-            SubChainDataTail = &Datagram->Next;
+            *SubChain->DataTail = Datagram;
+            SubChain->DataTail = &Datagram->Next;
         } else {
-            if (*SubChainTail == NULL) {
-                *SubChainTail = Datagram;
-                SubChainTail = &Datagram->Next;
-                SubChainDataTail = &Datagram->Next;
+            if (*SubChain->Tail == NULL) {
+                *SubChain->Tail = Datagram;
+                SubChain->Tail = &Datagram->Next;
+                SubChain->DataTail = &Datagram->Next;
             } else {
-                Datagram->Next = *SubChainTail;
-                *SubChainTail = Datagram;
-                SubChainTail = &Datagram->Next;
+                Datagram->Next = *SubChain->Tail;
+                *SubChain->Tail = Datagram;
+                SubChain->Tail = &Datagram->Next;
             }
         }
     }
 
-    if (SubChain != NULL) {
-        //
-        // Deliver the last subchain.
-        //
-        if (!QuicBindingDeliverPackets(Binding, (QUIC_RX_PACKET*)SubChain, SubChainLength, SubChainBytes)) {
-            *ReleaseChainTail = SubChain;
-            ReleaseChainTail = SubChainTail; // cppcheck-suppress unreadVariable; NOLINT
-        }
+    //
+    // Deliver the remaining subchains.
+    //
+    for (uint32_t i = 0; i < SubChainCount; ++i) {
+        QuicBindingDeliverSubChain(Binding, &SubChains[i], &ReleaseChainTail);
     }
 
     if (ReleaseChain != NULL) {
@@ -1840,6 +2381,51 @@ QuicBindingSend(
     QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_UDP_SEND_CALLS);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingSendBatch(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_PARTITION* Partition,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count,
+    _In_ uint32_t BytesToSend,
+    _In_ uint32_t DatagramsToSend
+    )
+{
+#if QUIC_TEST_DATAPATH_HOOKS_ENABLED
+    if (MsQuicLib.TestDatapathHooks != NULL) {
+        //
+        // The test hooks inspect (and may drop) each send individually.
+        //
+        for (uint32_t i = 0; i < Count; ++i) {
+            CXPLAT_ROUTE RouteCopy = Routes[i];
+            if (MsQuicLib.TestDatapathHooks->Send(
+                    &RouteCopy.RemoteAddress,
+                    &RouteCopy.LocalAddress,
+                    SendData[i])) {
+                QuicTraceLogVerbose(
+                    BindingSendTestDrop,
+                    "[bind][%p] Test dropped packet",
+                    Binding);
+                CxPlatSendDataFree(SendData[i]);
+            } else {
+                CxPlatSocketSend(Binding->Socket, &RouteCopy, SendData[i]);
+            }
+            QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_UDP_SEND_CALLS);
+        }
+    } else {
+#endif
+        CxPlatSocketSendBatch(Binding->Socket, Routes, SendData, Count);
+        QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_UDP_SEND_CALLS);
+#if QUIC_TEST_DATAPATH_HOOKS_ENABLED
+    }
+#endif
+
+    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_UDP_SEND, DatagramsToSend);
+    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_UDP_SEND_BYTES, BytesToSend);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicBindingHandleDosModeStateChange(
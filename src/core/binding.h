@@ -7,6 +7,8 @@
 
 typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
 typedef struct QUIC_STATELESS_CONTEXT QUIC_STATELESS_CONTEXT;
+typedef struct QUIC_LISTENER_INDEX QUIC_LISTENER_INDEX;
+typedef struct QUIC_STATELESS_RATE_SKETCH QUIC_STATELESS_RATE_SKETCH;
 
 //
 // Structure that MsQuic servers use for encoding data for stateless retries and
@@ -90,12 +92,27 @@ typedef struct QUIC_RX_PACKET {
     //
     uint16_t PayloadLength;
 
+    //
+    // The range of the payload holding stream data that was decrypted straight
+    // into the stream's app-owned receive buffer, instead of in place. Only
+    // valid if PlacedStreamDataLength is non-zero.
+    //
+    uint16_t PlacedStreamDataOffset;
+    uint16_t PlacedStreamDataLength;
+
     //
     // Lengths of the destination and source connection IDs
     //
     uint8_t DestCidLen;
     uint8_t SourceCidLen;
 
+    //
+    // Hash of the destination connection ID, computed once when the datagram
+    // is first parsed on the receive path. Reused for grouping datagrams by
+    // CID and for the local CID lookup.
+    //
+    uint32_t DestCidHash;
+
     //
     // The type of key used to decrypt the packet.
     //
@@ -190,6 +207,11 @@ typedef struct QUIC_BINDING {
     //
     CXPLAT_LIST_ENTRY Link;
 
+    //
+    // The entry in the library's binding table, keyed by local port.
+    //
+    CXPLAT_HASHTABLE_ENTRY TableEntry;
+
     //
     // Indicates whether the binding is exclusively owned already. Defaults
     // to TRUE.
@@ -255,6 +277,13 @@ typedef struct QUIC_BINDING {
     //
     CXPLAT_LIST_ENTRY Listeners;
 
+    //
+    // Index of the registered listeners by address and ALPN, rebuilt whenever
+    // they change. NULL if there are none, or the index couldn't be allocated,
+    // in which case the list is searched instead.
+    //
+    QUIC_LISTENER_INDEX* ListenerIndex;
+
     //
     // Lookup tables for connection IDs.
     //
@@ -269,6 +298,12 @@ typedef struct QUIC_BINDING {
     CXPLAT_POOL StatelessOperCtxPool;
     uint32_t StatelessOperCount;
 
+    //
+    // Per source prefix counts of recent stateless responses, to rate limit
+    // them. Allocated with the first response.
+    //
+    QUIC_STATELESS_RATE_SKETCH* volatile StatelessRateSketch;
+
     struct {
 
         struct {
@@ -429,6 +464,27 @@ QuicBindingMoveSourceConnectionIDs(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Delivers packets received on an exclusive binding to a connection whose
+// source CIDs live in another binding's lookup table. Used for standby paths.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicBindingAddStandbyConnection(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Stops delivering packets received on the binding to a standby connection.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingRemoveStandbyConnection(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Indicates to the binding that the connection is no longer accepting
 // handshake/long header packets.
@@ -486,6 +542,22 @@ QuicBindingSend(
     _In_ uint32_t DatagramsToSend
     );
 
+//
+// Sends several send data objects, from possibly different connections, to
+// their remote hosts in one datapath call.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingSendBatch(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_PARTITION* Partition,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count,
+    _In_ uint32_t BytesToSend,
+    _In_ uint32_t DatagramsToSend
+    );
+
 
 //
 // Indicates Dos mode state change for each listener
@@ -10,9 +10,10 @@ Abstract:
 --*/
 
 //
-// The maximum CID server ID length used by MsQuic.
+// The maximum CID server ID length used by MsQuic. The largest encoding is a
+// QUIC-LB first octet followed by the (possibly encrypted) server ID and nonce.
 //
-#define QUIC_MAX_CID_SID_LENGTH                 5
+#define QUIC_MAX_CID_SID_LENGTH                 (1 + QUIC_LB_MAX_ENCODED_LENGTH)
 
 //
 // The index of the byte we use for partition ID lookup, in the connection ID.
@@ -165,7 +166,7 @@ typedef struct QUIC_CID_LIST_ENTRY {
 
 typedef struct QUIC_CID_HASH_ENTRY {
 
-    CXPLAT_HASHTABLE_ENTRY Entry;
+    uint32_t Hash; // Set when inserted in a partitioned lookup table.
     CXPLAT_SLIST_ENTRY Link;
     QUIC_CONNECTION* Connection;
     QUIC_CID CID;
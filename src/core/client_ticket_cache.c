@@ -0,0 +1,511 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The client ticket cache is a hash table of copied tickets, plus a list of
+    the same entries in insertion order used to expire and evict the oldest
+    first. A lookup removes the entry it returns: TLS 1.3 tickets shouldn't be
+    reused, and a server normally issues a new one on each resumed connection.
+
+    Negotiated versions are kept in a second table and list, one entry per
+    server, and are not removed by a lookup. They are limited to MaxEntries
+    servers and expire after the same lifetime as tickets.
+
+    The cache is only accessed when a client connection starts, when it
+    connects and when it receives a ticket, so a single lock is enough.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "client_ticket_cache.c.clog.h"
+#endif
+
+static
+QUIC_NO_SANITIZE("unsigned-integer-overflow")
+uint32_t
+QuicClientTicketCacheHashBytes(
+    _In_ uint32_t Hash,
+    _In_ uint32_t Length,
+    _In_reads_(Length)
+        const uint8_t* Buffer
+    )
+{
+    for (uint32_t i = 0; i < Length; ++i) {
+        Hash = ((Hash << 5) - Hash) + Buffer[i];
+    }
+    return Hash;
+}
+
+static
+uint64_t
+QuicClientTicketCacheHashKey(
+    _In_ uint16_t ServerNameLength,
+    _In_reads_(ServerNameLength)
+        const uint8_t* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint16_t AlpnListLength,
+    _In_reads_(AlpnListLength)
+        const uint8_t* AlpnList
+    )
+{
+    uint32_t Hash = 5387;
+    Hash = QuicClientTicketCacheHashBytes(Hash, ServerNameLength, ServerName);
+    Hash = QuicClientTicketCacheHashBytes(Hash, sizeof(ServerPort), (const uint8_t*)&ServerPort);
+    Hash = QuicClientTicketCacheHashBytes(Hash, AlpnListLength, AlpnList);
+    return Hash;
+}
+
+//
+// Must be called with the lock held.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicClientTicketCacheRemove(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry
+    )
+{
+    CxPlatHashtableRemove(&Cache->Table, &Entry->TableEntry, NULL);
+    CxPlatListEntryRemove(&Entry->Link);
+    Cache->Stats.Entries--;
+    Cache->Stats.Bytes -= Entry->AllocLength;
+}
+
+//
+// Drops expired entries, and then the oldest entries until the cache has room
+// for a new entry of NewLength bytes (if NewLength is non-zero), or is within
+// its limits. Must be called with the lock held.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicClientTicketCacheTrim(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ uint32_t NewLength
+    )
+{
+    const uint64_t Now = CxPlatTimeUs64();
+    const uint32_t MaxEntries = Cache->Config.MaxEntries - (NewLength != 0 ? 1 : 0);
+    const uint32_t MaxBytes = Cache->Config.MaxBytes - NewLength;
+
+    while (!CxPlatListIsEmpty(&Cache->Entries)) {
+        QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Cache->Entries.Flink, QUIC_CLIENT_TICKET_CACHE_ENTRY, Link);
+        if (Entry->ExpirationTime <= Now) {
+            Cache->Stats.Expired++;
+        } else if (Cache->Stats.Entries > MaxEntries || Cache->Stats.Bytes > MaxBytes) {
+            Cache->Stats.Evicted++;
+        } else {
+            break;
+        }
+        QuicClientTicketCacheRemove(Cache, Entry);
+        QuicClientTicketCacheEntryFree(Entry);
+    }
+}
+
+//
+// Must be called with the lock held.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicClientTicketCacheRemoveVersion(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ QUIC_CLIENT_VERSION_CACHE_ENTRY* Entry
+    )
+{
+    CxPlatHashtableRemove(&Cache->VersionTable, &Entry->TableEntry, NULL);
+    CxPlatListEntryRemove(&Entry->Link);
+    Cache->Stats.VersionEntries--;
+}
+
+//
+// Drops expired versions, and then the least recently stored ones until there
+// is room for a new one (if Adding), or the cache is within its limit. Must be
+// called with the lock held.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicClientTicketCacheTrimVersions(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ BOOLEAN Adding
+    )
+{
+    const uint64_t Now = CxPlatTimeUs64();
+    const uint32_t MaxEntries = Cache->Config.MaxEntries - (Adding ? 1 : 0);
+
+    while (!CxPlatListIsEmpty(&Cache->VersionEntries)) {
+        QUIC_CLIENT_VERSION_CACHE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Cache->VersionEntries.Flink, QUIC_CLIENT_VERSION_CACHE_ENTRY, Link);
+        if (Entry->ExpirationTime > Now && Cache->Stats.VersionEntries <= MaxEntries) {
+            break;
+        }
+        QuicClientTicketCacheRemoveVersion(Cache, Entry);
+        CXPLAT_FREE(Entry, QUIC_POOL_CLIENT_TICKET_CACHE);
+    }
+}
+
+//
+// Must be called with the lock held.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_CLIENT_VERSION_CACHE_ENTRY*
+QuicClientTicketCacheFindVersion(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ uint16_t ServerNameLength,
+    _In_reads_(ServerNameLength)
+        const char* ServerName,
+    _In_ uint16_t ServerPort
+    )
+{
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    CXPLAT_HASHTABLE_ENTRY* TableEntry =
+        CxPlatHashtableLookup(
+            &Cache->VersionTable,
+            QuicClientTicketCacheHashKey(
+                ServerNameLength, (const uint8_t*)ServerName, ServerPort, 0, NULL),
+            &Context);
+
+    while (TableEntry != NULL) {
+        QUIC_CLIENT_VERSION_CACHE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_CLIENT_VERSION_CACHE_ENTRY, TableEntry);
+        if (Entry->ServerPort == ServerPort &&
+            Entry->ServerNameLength == ServerNameLength &&
+            memcmp(Entry->ServerName, ServerName, ServerNameLength) == 0) {
+            return Entry;
+        }
+        TableEntry = CxPlatHashtableLookupNext(&Cache->VersionTable, &Context);
+    }
+
+    return NULL;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheInitialize(
+    _Out_ QUIC_CLIENT_TICKET_CACHE* Cache
+    )
+{
+    CxPlatZeroMemory(Cache, sizeof(*Cache));
+    CxPlatLockInitialize(&Cache->Lock);
+    CxPlatListInitializeHead(&Cache->Entries);
+    CxPlatListInitializeHead(&Cache->VersionEntries);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheUninitialize(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache
+    )
+{
+    while (!CxPlatListIsEmpty(&Cache->Entries)) {
+        QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Cache->Entries.Flink, QUIC_CLIENT_TICKET_CACHE_ENTRY, Link);
+        QuicClientTicketCacheRemove(Cache, Entry);
+        QuicClientTicketCacheEntryFree(Entry);
+    }
+    while (!CxPlatListIsEmpty(&Cache->VersionEntries)) {
+        QUIC_CLIENT_VERSION_CACHE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Cache->VersionEntries.Flink, QUIC_CLIENT_VERSION_CACHE_ENTRY, Link);
+        QuicClientTicketCacheRemoveVersion(Cache, Entry);
+        CXPLAT_FREE(Entry, QUIC_POOL_CLIENT_TICKET_CACHE);
+    }
+    if (Cache->TableInitialized) {
+        CxPlatHashtableUninitialize(&Cache->Table);
+        CxPlatHashtableUninitialize(&Cache->VersionTable);
+    }
+    CxPlatLockUninitialize(&Cache->Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicClientTicketCacheSetConfig(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ const QUIC_CLIENT_TICKET_CACHE_CONFIG* Config
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    CxPlatLockAcquire(&Cache->Lock);
+
+    if (Config->MaxEntries != 0 && !Cache->TableInitialized) {
+        if (!CxPlatHashtableInitializeEx(&Cache->Table, CXPLAT_HASH_MIN_SIZE)) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+        if (!CxPlatHashtableInitializeEx(&Cache->VersionTable, CXPLAT_HASH_MIN_SIZE)) {
+            CxPlatHashtableUninitialize(&Cache->Table);
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+        Cache->TableInitialized = TRUE;
+    }
+
+    Cache->Config.MaxEntries = Config->MaxEntries;
+    Cache->Config.MaxBytes =
+        Config->MaxBytes != 0 ? Config->MaxBytes : QUIC_CLIENT_TICKET_CACHE_DEFAULT_MAX_BYTES;
+    Cache->Config.LifetimeMs =
+        Config->LifetimeMs != 0 ? Config->LifetimeMs : QUIC_CLIENT_TICKET_CACHE_DEFAULT_LIFETIME_MS;
+
+    //
+    // Entries already cached keep their original expiration. A shorter
+    // lifetime only applies to new tickets.
+    //
+    QuicClientTicketCacheTrim(Cache, 0);
+    QuicClientTicketCacheTrimVersions(Cache, FALSE);
+
+Exit:
+
+    CxPlatLockRelease(&Cache->Lock);
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheGetConfig(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _Out_ QUIC_CLIENT_TICKET_CACHE_CONFIG* Config
+    )
+{
+    CxPlatLockAcquire(&Cache->Lock);
+    *Config = Cache->Config;
+    CxPlatLockRelease(&Cache->Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheGetStatistics(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _Out_ QUIC_CLIENT_TICKET_CACHE_STATISTICS* Stats
+    )
+{
+    CxPlatLockAcquire(&Cache->Lock);
+    *Stats = Cache->Stats;
+    CxPlatLockRelease(&Cache->Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheInsert(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint16_t AlpnListLength,
+    _In_reads_(AlpnListLength)
+        const uint8_t* AlpnList,
+    _In_ uint32_t TicketLength,
+    _In_reads_(TicketLength)
+        const uint8_t* Ticket
+    )
+{
+    const uint16_t ServerNameLength = (uint16_t)strnlen(ServerName, QUIC_MAX_SNI_LENGTH);
+    const uint32_t AllocLength =
+        sizeof(QUIC_CLIENT_TICKET_CACHE_ENTRY) + ServerNameLength + AlpnListLength + TicketLength;
+
+    CxPlatLockAcquire(&Cache->Lock);
+
+    if (Cache->Config.MaxEntries == 0 || AllocLength > Cache->Config.MaxBytes) {
+        goto Exit;
+    }
+
+    QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry = CXPLAT_ALLOC_NONPAGED(AllocLength, QUIC_POOL_CLIENT_TICKET_CACHE);
+    if (Entry == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "ticket cache entry",
+            AllocLength);
+        goto Exit;
+    }
+
+    Entry->ExpirationTime = CxPlatTimeUs64() + MS_TO_US((uint64_t)Cache->Config.LifetimeMs);
+    Entry->AllocLength = AllocLength;
+    Entry->TicketLength = TicketLength;
+    Entry->ServerPort = ServerPort;
+    Entry->ServerNameLength = ServerNameLength;
+    Entry->AlpnListLength = AlpnListLength;
+    CxPlatCopyMemory(Entry->Data, ServerName, ServerNameLength);
+    CxPlatCopyMemory(Entry->Data + ServerNameLength, AlpnList, AlpnListLength);
+    CxPlatCopyMemory(
+        Entry->Data + ServerNameLength + AlpnListLength, Ticket, TicketLength);
+
+    QuicClientTicketCacheTrim(Cache, AllocLength);
+
+    CxPlatHashtableInsert(
+        &Cache->Table,
+        &Entry->TableEntry,
+        QuicClientTicketCacheHashKey(
+            ServerNameLength, (const uint8_t*)ServerName, ServerPort, AlpnListLength, AlpnList),
+        NULL);
+    CxPlatListInsertTail(&Cache->Entries, &Entry->Link);
+    Cache->Stats.Entries++;
+    Cache->Stats.Bytes += AllocLength;
+    Cache->Stats.Stored++;
+
+Exit:
+
+    CxPlatLockRelease(&Cache->Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(return != NULL)
+QUIC_CLIENT_TICKET_CACHE_ENTRY*
+QuicClientTicketCacheTake(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint16_t AlpnListLength,
+    _In_reads_(AlpnListLength)
+        const uint8_t* AlpnList
+    )
+{
+    QUIC_CLIENT_TICKET_CACHE_ENTRY* Found = NULL;
+    const uint16_t ServerNameLength = (uint16_t)strnlen(ServerName, QUIC_MAX_SNI_LENGTH);
+
+    CxPlatLockAcquire(&Cache->Lock);
+
+    if (Cache->Config.MaxEntries == 0) {
+        goto Exit;
+    }
+
+    QuicClientTicketCacheTrim(Cache, 0);
+
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    CXPLAT_HASHTABLE_ENTRY* TableEntry =
+        CxPlatHashtableLookup(
+            &Cache->Table,
+            QuicClientTicketCacheHashKey(
+                ServerNameLength, (const uint8_t*)ServerName, ServerPort, AlpnListLength, AlpnList),
+            &Context);
+
+    while (TableEntry != NULL) {
+        QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_CLIENT_TICKET_CACHE_ENTRY, TableEntry);
+        if (Entry->ServerPort == ServerPort &&
+            Entry->ServerNameLength == ServerNameLength &&
+            Entry->AlpnListLength == AlpnListLength &&
+            memcmp(Entry->Data, ServerName, ServerNameLength) == 0 &&
+            memcmp(Entry->Data + ServerNameLength, AlpnList, AlpnListLength) == 0) {
+            Found = Entry;
+            break;
+        }
+        TableEntry = CxPlatHashtableLookupNext(&Cache->Table, &Context);
+    }
+
+    if (Found != NULL) {
+        QuicClientTicketCacheRemove(Cache, Found);
+        Cache->Stats.Hits++;
+    } else {
+        Cache->Stats.Misses++;
+    }
+
+Exit:
+
+    CxPlatLockRelease(&Cache->Lock);
+
+    return Found;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheInsertVersion(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint32_t QuicVersion
+    )
+{
+    const uint16_t ServerNameLength = (uint16_t)strnlen(ServerName, QUIC_MAX_SNI_LENGTH);
+
+    CxPlatLockAcquire(&Cache->Lock);
+
+    if (Cache->Config.MaxEntries == 0) {
+        goto Exit;
+    }
+
+    QUIC_CLIENT_VERSION_CACHE_ENTRY* Entry =
+        QuicClientTicketCacheFindVersion(Cache, ServerNameLength, ServerName, ServerPort);
+    if (Entry != NULL) {
+        //
+        // Refresh the existing entry, moving it to the end of the list.
+        //
+        CxPlatListEntryRemove(&Entry->Link);
+
+    } else {
+        const uint32_t AllocLength = sizeof(QUIC_CLIENT_VERSION_CACHE_ENTRY) + ServerNameLength;
+        Entry = CXPLAT_ALLOC_NONPAGED(AllocLength, QUIC_POOL_CLIENT_TICKET_CACHE);
+        if (Entry == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "version cache entry",
+                AllocLength);
+            goto Exit;
+        }
+        Entry->ServerPort = ServerPort;
+        Entry->ServerNameLength = ServerNameLength;
+        CxPlatCopyMemory(Entry->ServerName, ServerName, ServerNameLength);
+
+        QuicClientTicketCacheTrimVersions(Cache, TRUE);
+
+        CxPlatHashtableInsert(
+            &Cache->VersionTable,
+            &Entry->TableEntry,
+            QuicClientTicketCacheHashKey(
+                ServerNameLength, (const uint8_t*)ServerName, ServerPort, 0, NULL),
+            NULL);
+        Cache->Stats.VersionEntries++;
+    }
+
+    Entry->ExpirationTime = CxPlatTimeUs64() + MS_TO_US((uint64_t)Cache->Config.LifetimeMs);
+    Entry->QuicVersion = QuicVersion;
+    CxPlatListInsertTail(&Cache->VersionEntries, &Entry->Link);
+
+Exit:
+
+    CxPlatLockRelease(&Cache->Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicClientTicketCacheLookupVersion(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _Out_ uint32_t* QuicVersion
+    )
+{
+    BOOLEAN Found = FALSE;
+    const uint16_t ServerNameLength = (uint16_t)strnlen(ServerName, QUIC_MAX_SNI_LENGTH);
+
+    CxPlatLockAcquire(&Cache->Lock);
+
+    if (Cache->Config.MaxEntries == 0) {
+        goto Exit;
+    }
+
+    QuicClientTicketCacheTrimVersions(Cache, FALSE);
+
+    const QUIC_CLIENT_VERSION_CACHE_ENTRY* Entry =
+        QuicClientTicketCacheFindVersion(Cache, ServerNameLength, ServerName, ServerPort);
+    if (Entry != NULL) {
+        *QuicVersion = Entry->QuicVersion;
+        Cache->Stats.VersionHits++;
+        Found = TRUE;
+    }
+
+Exit:
+
+    CxPlatLockRelease(&Cache->Lock);
+
+    return Found;
+}
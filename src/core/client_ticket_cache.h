@@ -0,0 +1,244 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A registration's cache of client resumption tickets, so new connections to
+    a server the registration has already connected to can resume (and send
+    0-RTT) without the app having to save and replay the tickets itself.
+
+    The cache also remembers the QUIC version last negotiated with each
+    server, so new connections to it start with that version instead of
+    being moved to it by version negotiation again.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_CLIENT_TICKET_CACHE_ENTRY {
+
+    //
+    // Link in the cache's table. The signature is the hash of the key.
+    //
+    CXPLAT_HASHTABLE_ENTRY TableEntry;
+
+    //
+    // Link in the cache's insertion ordered list.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // Time (in microseconds) after which the ticket is no longer used.
+    //
+    uint64_t ExpirationTime;
+
+    uint32_t AllocLength;
+    uint32_t TicketLength;
+    uint16_t ServerPort;
+    uint16_t ServerNameLength;
+    uint16_t AlpnListLength;
+
+    //
+    // The server name, ALPN list and then the ticket.
+    //
+    _Field_size_bytes_(ServerNameLength + AlpnListLength + TicketLength)
+    uint8_t Data[0];
+
+} QUIC_CLIENT_TICKET_CACHE_ENTRY;
+
+//
+// The version last negotiated with a server. Unlike a ticket, it doesn't
+// depend on the ALPN and isn't used up.
+//
+typedef struct QUIC_CLIENT_VERSION_CACHE_ENTRY {
+
+    //
+    // Link in the cache's version table. The signature is the hash of the key.
+    //
+    CXPLAT_HASHTABLE_ENTRY TableEntry;
+
+    //
+    // Link in the cache's list of versions, least recently stored first.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // Time (in microseconds) after which the version is no longer used.
+    //
+    uint64_t ExpirationTime;
+
+    uint32_t QuicVersion;
+    uint16_t ServerPort;
+    uint16_t ServerNameLength;
+
+    _Field_size_bytes_(ServerNameLength)
+    uint8_t ServerName[0];
+
+} QUIC_CLIENT_VERSION_CACHE_ENTRY;
+
+QUIC_INLINE
+const uint8_t*
+QuicClientTicketCacheEntryTicket(
+    _In_ const QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry
+    )
+{
+    return Entry->Data + Entry->ServerNameLength + Entry->AlpnListLength;
+}
+
+typedef struct QUIC_CLIENT_TICKET_CACHE {
+
+    //
+    // Protects everything below.
+    //
+    CXPLAT_LOCK Lock;
+
+    //
+    // Whether Table and VersionTable have been initialized. They aren't until
+    // the cache is first enabled.
+    //
+    BOOLEAN TableInitialized;
+
+    QUIC_CLIENT_TICKET_CACHE_CONFIG Config;
+
+    //
+    // Entries by key. A key may have several entries, since a server may
+    // send more than one ticket and each is only used once.
+    //
+    CXPLAT_HASHTABLE Table;
+
+    //
+    // All entries, oldest first. As all entries have the same lifetime, this
+    // is also the order they expire in.
+    //
+    CXPLAT_LIST_ENTRY Entries;
+
+    //
+    // Negotiated versions by server name and port, at most one per server and
+    // MaxEntries in all.
+    //
+    CXPLAT_HASHTABLE VersionTable;
+
+    //
+    // All version entries, least recently stored first.
+    //
+    CXPLAT_LIST_ENTRY VersionEntries;
+
+    QUIC_CLIENT_TICKET_CACHE_STATISTICS Stats;
+
+} QUIC_CLIENT_TICKET_CACHE;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheInitialize(
+    _Out_ QUIC_CLIENT_TICKET_CACHE* Cache
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheUninitialize(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache
+    );
+
+//
+// Applies a new configuration, dropping entries to fit the new limits.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicClientTicketCacheSetConfig(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_ const QUIC_CLIENT_TICKET_CACHE_CONFIG* Config
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheGetConfig(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _Out_ QUIC_CLIENT_TICKET_CACHE_CONFIG* Config
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheGetStatistics(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _Out_ QUIC_CLIENT_TICKET_CACHE_STATISTICS* Stats
+    );
+
+//
+// Saves a copy of an encoded client ticket. Does nothing if the cache is
+// disabled.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheInsert(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint16_t AlpnListLength,
+    _In_reads_(AlpnListLength)
+        const uint8_t* AlpnList,
+    _In_ uint32_t TicketLength,
+    _In_reads_(TicketLength)
+        const uint8_t* Ticket
+    );
+
+//
+// Removes and returns an unexpired entry for the key, if there is one. The
+// caller frees the entry with QuicClientTicketCacheEntryFree.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(return != NULL)
+QUIC_CLIENT_TICKET_CACHE_ENTRY*
+QuicClientTicketCacheTake(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint16_t AlpnListLength,
+    _In_reads_(AlpnListLength)
+        const uint8_t* AlpnList
+    );
+
+//
+// Saves the version negotiated with a server, replacing any previous one. Does
+// nothing if the cache is disabled.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicClientTicketCacheInsertVersion(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint32_t QuicVersion
+    );
+
+//
+// Returns the unexpired version last negotiated with the server, if there is
+// one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicClientTicketCacheLookupVersion(
+    _In_ QUIC_CLIENT_TICKET_CACHE* Cache,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _Out_ uint32_t* QuicVersion
+    );
+
+QUIC_INLINE
+void
+QuicClientTicketCacheEntryFree(
+    _In_ __drv_freesMem(Mem) QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry
+    )
+{
+    CXPLAT_FREE(Entry, QUIC_POOL_CLIENT_TICKET_CACHE);
+}
+
+#if defined(__cplusplus)
+}
+#endif
@@ -84,6 +84,7 @@ MsQuicConfigurationOpen(
     Configuration->ClientContext = Context;
     Configuration->Registration = Registration;
     CxPlatRefInitialize(&Configuration->RefCount);
+    CxPlatLockInitialize(&Configuration->SharedSettingsLock);
 #if DEBUG
     CxPlatRefInitializeMultiple(Configuration->RefTypeBiasedCount, QUIC_CONF_REF_COUNT);
     CxPlatRefIncrement(&Configuration->RefTypeBiasedCount[QUIC_CONF_REF_HANDLE]);
@@ -224,6 +225,7 @@ Error:
 #if DEBUG
         QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_CONFIGURATION, &Configuration->DbgObjectLink);
 #endif
+        CxPlatLockUninitialize(&Configuration->SharedSettingsLock);
         CXPLAT_FREE(Configuration, QUIC_POOL_CONFIG);
     }
 
@@ -235,6 +237,62 @@ Error:
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SHARED_SETTINGS*
+QuicConfigurationGetSharedSettings(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    CxPlatLockAcquire(&Configuration->SharedSettingsLock);
+    if (Configuration->SharedSettings == NULL) {
+        //
+        // Build the settings exactly as a connection with none of its own
+        // would: the global values, overridden by the ones set here.
+        //
+        QUIC_SHARED_SETTINGS* SharedSettings = QuicLibraryGetSharedSettings();
+        if (SharedSettings != NULL) {
+            Configuration->SharedSettings =
+                QuicSharedSettingsAlloc(&SharedSettings->Settings);
+            QuicSharedSettingsRelease(SharedSettings);
+        }
+        if (Configuration->SharedSettings != NULL &&
+            !QuicSettingApply(
+                &Configuration->SharedSettings->Settings,
+                FALSE,
+                TRUE,
+                &Configuration->Settings)) {
+            QuicSharedSettingsRelease(Configuration->SharedSettings);
+            Configuration->SharedSettings = NULL;
+        }
+    }
+    QUIC_SHARED_SETTINGS* SharedSettings = Configuration->SharedSettings;
+    if (SharedSettings != NULL) {
+        QuicSharedSettingsAddRef(SharedSettings);
+    }
+    CxPlatLockRelease(&Configuration->SharedSettingsLock);
+    return SharedSettings;
+}
+
+//
+// Drops the shared settings after the configuration's settings change.
+// Connections already using them keep their reference.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConfigurationResetSharedSettings(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    CxPlatLockAcquire(&Configuration->SharedSettingsLock);
+    QUIC_SHARED_SETTINGS* SharedSettings = Configuration->SharedSettings;
+    Configuration->SharedSettings = NULL;
+    CxPlatLockRelease(&Configuration->SharedSettingsLock);
+    if (SharedSettings != NULL) {
+        QuicSharedSettingsRelease(SharedSettings);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConfigurationUninitialize(
@@ -266,6 +324,8 @@ QuicConfigurationUninitialize(
     QuicProcessRelease(Configuration->OwningProcess);
 #endif
 
+    QuicConfigurationResetSharedSettings(Configuration);
+    CxPlatLockUninitialize(&Configuration->SharedSettingsLock);
     QuicSettingsCleanup(&Configuration->Settings);
 
     QuicRegistrationRundownRelease(Configuration->Registration, QUIC_REG_REF_CONFIGURATION);
@@ -368,6 +428,14 @@ MsQuicConfigurationLoadCredential(
             Configuration->Settings.ServerResumptionLevel == QUIC_SERVER_NO_RESUME) {
             TlsCredFlags |= CXPLAT_TLS_CREDENTIAL_FLAG_DISABLE_RESUMPTION;
         }
+        if (!(CredConfig->Flags & QUIC_CREDENTIAL_FLAG_CLIENT) &&
+            MsQuicLib.HandshakeThreadCount != 0) {
+            //
+            // The first flight runs on the handshake threads, which can wait
+            // on an async crypto engine without stalling connection workers.
+            //
+            TlsCredFlags |= CXPLAT_TLS_CREDENTIAL_FLAG_ASYNC_CRYPTO;
+        }
 
         QuicConfigurationAddRef(Configuration, QUIC_CONF_REF_LOAD_CRED);
 
@@ -430,6 +498,8 @@ QuicConfigurationSettingsChanged(
         QuicSettingsLoad(&Configuration->Settings, Configuration->AppSpecificStorage);
     }
 
+    QuicConfigurationResetSharedSettings(Configuration);
+
     QuicTraceLogInfo(
         ConfigurationSettingsUpdated,
         "[cnfg][%p] Settings %p Updated",
@@ -508,15 +578,16 @@ QuicConfigurationParamSet(
             return Status;
         }
 
-        if (!QuicSettingApply(
+        Status =
+            QuicSettingApply(
                 &Configuration->Settings,
                 TRUE,
                 TRUE,
-                &InternalSettings)) {
-            return QUIC_STATUS_INVALID_PARAMETER;
-        }
+                &InternalSettings) ?
+            QUIC_STATUS_SUCCESS : QUIC_STATUS_INVALID_PARAMETER;
+        QuicConfigurationResetSharedSettings(Configuration);
 
-        return QUIC_STATUS_SUCCESS;
+        return Status;
 
     case QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS:
 
@@ -538,17 +609,17 @@ QuicConfigurationParamSet(
             return Status;
         }
 
-        if (!QuicSettingApply(
+        Status =
+            QuicSettingApply(
                 &Configuration->Settings,
                 TRUE,
                 TRUE,
-                &InternalSettings)) {
-            QuicSettingsCleanup(&InternalSettings);
-            return QUIC_STATUS_INVALID_PARAMETER;
-        }
+                &InternalSettings) ?
+            QUIC_STATUS_SUCCESS : QUIC_STATUS_INVALID_PARAMETER;
         QuicSettingsCleanup(&InternalSettings);
+        QuicConfigurationResetSharedSettings(Configuration);
 
-        return QUIC_STATUS_SUCCESS;
+        return Status;
 
     case QUIC_PARAM_CONFIGURATION_TICKET_KEYS:
 
@@ -576,6 +647,7 @@ QuicConfigurationParamSet(
 
         Configuration->Settings.IsSet.VersionNegotiationExtEnabled = TRUE;
         Configuration->Settings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
+        QuicConfigurationResetSharedSettings(Configuration);
 
         return QUIC_STATUS_SUCCESS;
 
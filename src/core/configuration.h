@@ -15,6 +15,7 @@ typedef enum QUIC_CONFIGURATION_REF {
     QUIC_CONF_REF_LOAD_CRED,
     QUIC_CONF_REF_CONN_START_OP,
     QUIC_CONF_REF_CONN_SET_OP,
+    QUIC_CONF_REF_LISTENER_SNI,
 
     QUIC_CONF_REF_COUNT
 } QUIC_CONFIGURATION_REF;
@@ -98,6 +99,14 @@ typedef struct QUIC_CONFIGURATION {
     //
     QUIC_SETTINGS_INTERNAL Settings;
 
+    //
+    // The settings of a connection using this configuration and no settings of
+    // its own, shared by all such connections. Created on first use after any
+    // change to Settings.
+    //
+    QUIC_SHARED_SETTINGS* SharedSettings;
+    CXPLAT_LOCK SharedSettingsLock;
+
     uint16_t AlpnListLength;
     uint8_t AlpnList[0];
 
@@ -187,6 +196,16 @@ QuicConfigurationSettingsChanged(
     _Inout_ QUIC_CONFIGURATION* Configuration
     );
 
+//
+// Returns a reference to the settings shared by connections using the
+// configuration, or NULL on allocation failure.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SHARED_SETTINGS*
+QuicConfigurationGetSharedSettings(
+    _In_ QUIC_CONFIGURATION* Configuration
+    );
+
 //
 // Gets a configuration parameter.
 //
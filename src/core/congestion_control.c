@@ -40,5 +40,68 @@ QuicCongestionControlInitialize(
     case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
         BbrCongestionControlInitialize(Cc, Settings);
         break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3:
+        Bbr3CongestionControlInitialize(Cc, Settings);
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM:
+        if (!CustomCongestionControlInitialize(Cc, Settings)) {
+            QuicTraceLogConnWarning(
+                CustomCongestionControlMissing,
+                QuicCongestionControlGetConnection(Cc),
+                "No custom congestion control provided, fallback to Cubic");
+            CubicCongestionControlInitialize(Cc, Settings);
+        }
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE:
+        PragueCongestionControlInitialize(Cc, Settings);
+        break;
     }
 }
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicCongestionControlSampleDeliveryRate(
+    _In_ const QUIC_SENT_PACKET_METADATA* AckedPacket,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    uint64_t SendRate = UINT64_MAX;
+    uint64_t AckRate = UINT64_MAX;
+
+    if (AckedPacket->Flags.HasLastAckedPacketInfo) {
+        CXPLAT_DBG_ASSERT(AckedPacket->TotalBytesSent >= AckedPacket->LastAckedPacketInfo.TotalBytesSent);
+        CXPLAT_DBG_ASSERT(CxPlatTimeAtOrBefore64(AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime));
+
+        uint64_t AckElapsed = 0;
+        uint64_t SendElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime);
+
+        if (SendElapsed) {
+            SendRate = (S_TO_US(1ull) * QUIC_DELIVERY_RATE_UNIT *
+                (AckedPacket->TotalBytesSent - AckedPacket->LastAckedPacketInfo.TotalBytesSent) /
+                SendElapsed);
+        }
+
+        if (!CxPlatTimeAtOrBefore64(AckEvent->AdjustedAckTime, AckedPacket->LastAckedPacketInfo.AdjustedAckTime)) {
+            AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AdjustedAckTime, AckEvent->AdjustedAckTime);
+        } else {
+            AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AckTime, AckEvent->TimeNow);
+        }
+
+        CXPLAT_DBG_ASSERT(AckEvent->NumTotalAckedRetransmittableBytes >= AckedPacket->LastAckedPacketInfo.TotalBytesAcked);
+        if (AckElapsed) {
+            AckRate = (S_TO_US(1ull) * QUIC_DELIVERY_RATE_UNIT *
+                       (AckEvent->NumTotalAckedRetransmittableBytes - AckedPacket->LastAckedPacketInfo.TotalBytesAcked) /
+                       AckElapsed);
+        }
+    } else if (!CxPlatTimeAtOrBefore64(AckEvent->TimeNow, AckedPacket->SentTime)) {
+        SendRate = (S_TO_US(1ull) * QUIC_DELIVERY_RATE_UNIT *
+                    AckEvent->NumTotalAckedRetransmittableBytes /
+                    CxPlatTimeDiff64(AckedPacket->SentTime, AckEvent->TimeNow));
+    }
+
+    //
+    // The rate can't be any higher than either the rate the data was sent at
+    // or the rate it was acknowledged at.
+    //
+    return CXPLAT_MIN(SendRate, AckRate);
+}
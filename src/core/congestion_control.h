@@ -6,7 +6,14 @@
 --*/
 
 #include "bbr.h"
+#include "bbr3.h"
+#include "custom_cc.h"
 #include "cubic.h"
+#include "prague.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
 
 typedef struct QUIC_ACK_EVENT {
 
@@ -45,6 +52,21 @@ typedef struct QUIC_ACK_EVENT {
     //
     uint64_t AdjustedAckTime;
 
+    //
+    // ECN feedback newly reported by this ACK, in packets: the number of
+    // packets reported as received with any ECN codepoint (ECT or CE), and
+    // the subset of those which were CE marked.
+    //
+    uint32_t EcnPackets;
+    uint32_t EcnCePackets;
+
+    //
+    // The connection's delivery rate sample for this ACK, in bits per second,
+    // taken from the most recently sent packet acknowledged. Zero if there
+    // is no sample.
+    //
+    uint64_t DeliveryRate;
+
     BOOLEAN IsImplicit : 1;
 
     BOOLEAN HasLoss : 1;
@@ -53,6 +75,12 @@ typedef struct QUIC_ACK_EVENT {
 
     BOOLEAN MinRttValid : 1;
 
+    //
+    // The delivery rate sample was limited by the application rather than
+    // the network.
+    //
+    BOOLEAN IsDeliveryRateAppLimited : 1;
+
 } QUIC_ACK_EVENT;
 
 typedef struct QUIC_LOSS_EVENT {
@@ -75,6 +103,8 @@ typedef struct QUIC_ECN_EVENT {
 
 } QUIC_ECN_EVENT;
 
+typedef struct QUIC_CONN_CAREFUL_RESUME_V1 QUIC_CONN_CAREFUL_RESUME_STATE;
+
 typedef struct QUIC_CONGESTION_CONTROL {
 
     //
@@ -82,6 +112,12 @@ typedef struct QUIC_CONGESTION_CONTROL {
     //
     const char* Name;
 
+    //
+    // The algorithm the function table belongs to. The hottest calls are made
+    // directly, rather than through the table, for the built-in CUBIC and BBR.
+    //
+    QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm;
+
     BOOLEAN (*QuicCongestionControlCanSend)(
         _In_ struct QUIC_CONGESTION_CONTROL* Cc
         );
@@ -102,6 +138,14 @@ typedef struct QUIC_CONGESTION_CONTROL {
         _In_ BOOLEAN TimeSinceLastSendValid
         );
 
+    uint64_t (*QuicCongestionControlGetPacingRate)(
+        _In_ const struct QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    uint64_t (*QuicCongestionControlGetDeliveryRate)(
+        _In_ const struct QUIC_CONGESTION_CONTROL* Cc
+        );
+
     void (*QuicCongestionControlOnDataSent)(
         _In_ struct QUIC_CONGESTION_CONTROL* Cc,
         _In_ uint32_t NumRetransmittableBytes
@@ -161,12 +205,24 @@ typedef struct QUIC_CONGESTION_CONTROL {
         _Out_ struct QUIC_NETWORK_STATISTICS* NetworkStatistics
         );
 
+    CXPLAT_ECN_TYPE (*QuicCongestionControlGetEcnCodepoint)(
+        _In_ const struct QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    void (*QuicCongestionControlSetCarefulResumeState)(
+        _In_ struct QUIC_CONGESTION_CONTROL* Cc,
+        _In_ const QUIC_CONN_CAREFUL_RESUME_STATE* State
+        );
+
     //
     // Algorithm specific state.
     //
     union {
         QUIC_CONGESTION_CONTROL_CUBIC Cubic;
         QUIC_CONGESTION_CONTROL_BBR Bbr;
+        QUIC_CONGESTION_CONTROL_BBR3 Bbr3;
+        QUIC_CONGESTION_CONTROL_CUSTOM Custom;
+        QUIC_CONGESTION_CONTROL_PRAGUE Prague;
     };
 
 } QUIC_CONGESTION_CONTROL;
@@ -205,8 +261,6 @@ typedef struct QUIC_CONN_CAREFUL_RESUME_V1 {
 
 } QUIC_CONN_CAREFUL_RESUME_V1;
 
-typedef struct QUIC_CONN_CAREFUL_RESUME_V1 QUIC_CONN_CAREFUL_RESUME_STATE;
-
 //
 // Initializes the algorithm specific congestion control algorithm.
 //
@@ -217,6 +271,86 @@ QuicCongestionControlInitialize(
     _In_ const QUIC_SETTINGS_INTERNAL* Settings
     );
 
+//
+// Delivery rate samples are in bits per second.
+//
+#define QUIC_DELIVERY_RATE_UNIT 8
+
+//
+// Computes a delivery rate sample from a newly acknowledged packet, using the
+// delivery state recorded when it was sent. Returns UINT64_MAX if the packet
+// doesn't produce a sample.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicCongestionControlSampleDeliveryRate(
+    _In_ const QUIC_SENT_PACKET_METADATA* AckedPacket,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    );
+
+//
+// The functions called per packet sent or acknowledged, for the built-in
+// algorithms the wrappers below call directly. Direct calls avoid the indirect
+// branch (and its control flow guard check), and let link time code generation
+// inline them into the send and ACK processing loops.
+//
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CubicCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+CubicCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CubicCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CubicCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+BbrCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+BbrCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    );
+
 //
 // Returns TRUE if more bytes can be sent on the network.
 //
@@ -227,7 +361,14 @@ QuicCongestionControlCanSend(
     _In_ QUIC_CONGESTION_CONTROL* Cc
     )
 {
-    return Cc->QuicCongestionControlCanSend(Cc);
+    switch (Cc->Algorithm) {
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC:
+        return CubicCongestionControlCanSend(Cc);
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
+        return BbrCongestionControlCanSend(Cc);
+    default:
+        return Cc->QuicCongestionControlCanSend(Cc);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -264,7 +405,80 @@ QuicCongestionControlGetSendAllowance(
     _In_ BOOLEAN TimeSinceLastSendValid
     )
 {
-    return Cc->QuicCongestionControlGetSendAllowance(Cc, TimeSinceLastSend, TimeSinceLastSendValid);
+    switch (Cc->Algorithm) {
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC:
+        return CubicCongestionControlGetSendAllowance(Cc, TimeSinceLastSend, TimeSinceLastSendValid);
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
+        return BbrCongestionControlGetSendAllowance(Cc, TimeSinceLastSend, TimeSinceLastSendValid);
+    default:
+        return Cc->QuicCongestionControlGetSendAllowance(Cc, TimeSinceLastSend, TimeSinceLastSendValid);
+    }
+}
+
+//
+// Returns the rate (in bytes per second) that sends should be spread out at,
+// or zero if sends shouldn't currently be paced.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicCongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->QuicCongestionControlGetPacingRate(Cc);
+}
+
+//
+// Returns the measured delivery rate in bytes per second, or zero if the
+// algorithm doesn't measure one (or has no samples yet).
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicCongestionControlGetDeliveryRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    if (Cc->QuicCongestionControlGetDeliveryRate) {
+        return Cc->QuicCongestionControlGetDeliveryRate(Cc);
+    }
+    return 0;
+}
+
+//
+// Returns the ECT codepoint to mark packets with, when ECN is in use on the
+// path. Scalable (L4S) algorithms use ECT(1); everything else uses ECT(0).
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+CXPLAT_ECN_TYPE
+QuicCongestionControlGetEcnCodepoint(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    if (Cc->QuicCongestionControlGetEcnCodepoint) {
+        return Cc->QuicCongestionControlGetEcnCodepoint(Cc);
+    }
+    return CXPLAT_ECN_ECT_0;
+}
+
+//
+// Passes the congestion state saved from a previous connection on the same
+// path, to jump-start the congestion window (Careful Resume). Ignored by
+// algorithms that don't support it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicCongestionControlSetCarefulResumeState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_CONN_CAREFUL_RESUME_STATE* State
+    )
+{
+    if (Cc->QuicCongestionControlSetCarefulResumeState) {
+        Cc->QuicCongestionControlSetCarefulResumeState(Cc, State);
+    }
 }
 
 //
@@ -278,7 +492,17 @@ QuicCongestionControlOnDataSent(
     _In_ uint32_t NumRetransmittableBytes
     )
 {
-    Cc->QuicCongestionControlOnDataSent(Cc, NumRetransmittableBytes);
+    switch (Cc->Algorithm) {
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC:
+        CubicCongestionControlOnDataSent(Cc, NumRetransmittableBytes);
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
+        BbrCongestionControlOnDataSent(Cc, NumRetransmittableBytes);
+        break;
+    default:
+        Cc->QuicCongestionControlOnDataSent(Cc, NumRetransmittableBytes);
+        break;
+    }
 }
 
 //
@@ -307,7 +531,14 @@ QuicCongestionControlOnDataAcknowledged(
     _In_ const QUIC_ACK_EVENT* AckEvent
     )
 {
-    return Cc->QuicCongestionControlOnDataAcknowledged(Cc, AckEvent);
+    switch (Cc->Algorithm) {
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC:
+        return CubicCongestionControlOnDataAcknowledged(Cc, AckEvent);
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
+        return BbrCongestionControlOnDataAcknowledged(Cc, AckEvent);
+    default:
+        return Cc->QuicCongestionControlOnDataAcknowledged(Cc, AckEvent);
+    }
 }
 
 //
@@ -412,3 +643,7 @@ QuicCongestionControlSetAppLimited(
 {
     Cc->QuicCongestionControlSetAppLimited(Cc);
 }
+
+#if defined(__cplusplus)
+}
+#endif
@@ -16,7 +16,7 @@ Abstract:
     The only requirement here is that this function is not called in parallel
     on multiple threads. The function will drain up to QUIC_SETTINGS_INTERNAL's
     MaxOperationsPerDrain operations per call, so as to not starve any other
-    work.
+    work. The worker scales that up while no other connections are waiting.
 
     While most of the connection specific work is managed by other modules,
     the following things are managed in this file:
@@ -51,6 +51,37 @@ QuicConnApplyNewSettings(
     _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnOnNewSettings(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ BOOLEAN OverWrite,
+    _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnApplyConfigurationSettings(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_CONFIGURATION* Configuration
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SETTINGS_INTERNAL*
+QuicConnGetPrivateSettings(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnRecvDatagrams(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packets,
+    _In_ uint32_t PacketChainCount,
+    _In_ uint32_t PacketChainByteCount,
+    _In_ BOOLEAN IsDeferred
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Must_inspect_result_
 _Success_(return == QUIC_STATUS_SUCCESS)
@@ -71,6 +102,11 @@ QuicConnAlloc(
     const uint16_t PartitionId = QuicPartitionIdCreate(Partition->Index);
     CXPLAT_DBG_ASSERT(Partition->Index == QuicPartitionIdGetIndex(PartitionId));
 
+    QUIC_SHARED_SETTINGS* SharedSettings = QuicLibraryGetSharedSettings();
+    if (SharedSettings == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
     QUIC_CONNECTION* Connection = CxPlatPoolAlloc(&Partition->ConnectionPool);
     if (Connection == NULL) {
         QuicTraceEvent(
@@ -78,6 +114,7 @@ QuicConnAlloc(
             "Allocation of '%s' failed. (%llu bytes)",
             "connection",
             sizeof(QUIC_CONNECTION));
+        QuicSharedSettingsRelease(SharedSettings);
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
@@ -90,6 +127,7 @@ QuicConnAlloc(
 #endif
     QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_CREATED);
     QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_ACTIVE);
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_CONNECTION, sizeof(QUIC_CONNECTION));
 
     Connection->Stats.CorrelationId =
         InterlockedIncrement64((int64_t*)&MsQuicLib.ConnectionCorrelationId) - 1;
@@ -99,6 +137,7 @@ QuicConnAlloc(
         Connection,
         IsServer,
         Connection->Stats.CorrelationId);
+    QuicQlogOnConnectionCreated(Connection, IsServer);
 
     Connection->RefCount = 1;
 #if DEBUG
@@ -118,15 +157,17 @@ QuicConnAlloc(
     Connection->PeerReorderingThreshold = QUIC_MIN_REORDERING_THRESHOLD;
     Connection->PeerTransportParams.AckDelayExponent = QUIC_TP_ACK_DELAY_EXPONENT_DEFAULT;
     Connection->ReceiveQueueTail = &Connection->ReceiveQueue;
-    QuicSettingsCopy(&Connection->Settings, &MsQuicLib.Settings);
-    Connection->Settings.IsSetFlags = 0; // Just grab the global values, not IsSet flags.
+    QuicArenaInitialize(&Connection->HandshakeArena);
+    Connection->SharedSettings = SharedSettings;
+    Connection->Settings = &SharedSettings->Settings;
+    Connection->MaxAckDelayMs = Connection->Settings->MaxAckDelayMs;
     CxPlatDispatchLockInitialize(&Connection->ReceiveQueueLock);
     CxPlatListInitializeHead(&Connection->DestCids);
     QuicStreamSetInitialize(&Connection->Streams);
     QuicSendBufferInitialize(&Connection->SendBuffer);
     QuicOperationQueueInitialize(&Connection->OperQ);
-    QuicSendInitialize(&Connection->Send, &Connection->Settings);
-    QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+    QuicSendInitialize(&Connection->Send, Connection->Settings);
+    QuicCongestionControlInitialize(&Connection->CongestionControl, Connection->Settings);
     QuicLossDetectionInitialize(&Connection->LossDetection);
     QuicDatagramInitialize(&Connection->Datagram);
     QuicRangeInitialize(
@@ -354,6 +395,7 @@ QuicConnFree(
     QuicConnUnregister(Connection);
     if (Connection->Worker != NULL) {
         QuicTimerWheelRemoveConnection(&Connection->Worker->TimerWheel, Connection);
+        QuicPacingQueueRemoveConnection(&Connection->Worker->PacingQueue, Connection);
         QuicOperationQueueClear(&Connection->OperQ, Partition);
     }
     if (Connection->ReceiveQueue != NULL) {
@@ -391,16 +433,20 @@ QuicConnFree(
     if (Connection->RemoteServerName != NULL) {
         CXPLAT_FREE(Connection->RemoteServerName, QUIC_POOL_SERVERNAME);
     }
-    if (Connection->OrigDestCID != NULL) {
-        CXPLAT_FREE(Connection->OrigDestCID, QUIC_POOL_CID);
-    }
+    Connection->OrigDestCID = NULL;
+    Connection->PreferredAddress = NULL;
+    QuicArenaReset(&Connection->HandshakeArena);
     if (Connection->HandshakeTP != NULL) {
         QuicCryptoTlsCleanupTransportParameters(Connection->HandshakeTP);
         CxPlatPoolFree(Connection->HandshakeTP);
         Connection->HandshakeTP = NULL;
     }
+    if (Connection->HandoffState != NULL) {
+        QuicConnHandoffStateFree(Connection->HandoffState);
+        Connection->HandoffState = NULL;
+    }
     QuicCryptoTlsCleanupTransportParameters(&Connection->PeerTransportParams);
-    QuicSettingsCleanup(&Connection->Settings);
+    QuicSharedSettingsRelease(Connection->SharedSettings);
     if (Connection->State.Started && !Connection->State.Connected) {
         QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_CONN_HANDSHAKE_FAIL);
     }
@@ -413,6 +459,10 @@ QuicConnFree(
     if (Connection->CloseReasonPhrase != NULL) {
         CXPLAT_FREE(Connection->CloseReasonPhrase, QUIC_POOL_CLOSE_REASON);
     }
+    if (Connection->PeerStreamsStarted != NULL) {
+        CXPLAT_DBG_ASSERT(Connection->PeerStreamsStartedCount == 0);
+        CXPLAT_FREE(Connection->PeerStreamsStarted, QUIC_POOL_PEER_STREAMS_STARTED);
+    }
     Connection->State.Freed = TRUE;
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_CONNECTION, &Connection->DbgObjectLink);
@@ -421,12 +471,17 @@ QuicConnFree(
         ConnDestroyed,
         "[conn][%p] Destroyed",
         Connection);
+    const BOOLEAN Hibernating = Connection->State.Hibernating;
     CxPlatPoolFree(Connection);
 
 #if DEBUG
     InterlockedDecrement(&MsQuicLib.ConnectionCount);
 #endif
     QuicPerfCounterDecrement(Partition, QUIC_PERF_COUNTER_CONN_ACTIVE);
+    if (Hibernating) {
+        QuicPerfCounterDecrement(Partition, QUIC_PERF_COUNTER_CONN_HIBERNATING);
+    }
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_CONNECTION, -(int64_t)sizeof(QUIC_CONNECTION));
 #ifdef QUIC_SILO
     QuicConfigurationDetachSilo();
     QuicSiloRelease(Silo);
@@ -687,6 +742,13 @@ QuicConnIndicateEvent(
 {
     CXPLAT_PASSIVE_CODE();
     QUIC_STATUS Status;
+
+    //
+    // The app may read or shut down streams from the callback, so any pending
+    // received stream data must be written first.
+    //
+    QuicStreamRecvRunFlush(&Connection->RecvRun);
+
     if (Connection->ClientCallbackHandler != NULL) {
         //
         // MsQuic shouldn't indicate reentrancy to the app when at all possible.
@@ -1202,6 +1264,42 @@ QuicGetEarliestExpirationTime(
     return EarliestExpirationTime;
 }
 
+//
+// Moves the connection in the timer wheel if its earliest timer changed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnTimerUpdateWheel(
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    uint64_t NewEarliestExpirationTime = QuicGetEarliestExpirationTime(Connection);
+    if (NewEarliestExpirationTime != Connection->EarliestExpirationTime) {
+        //
+        // We've either found a new earliest expiration time, or there will be no timers scheduled.
+        //
+        Connection->EarliestExpirationTime = NewEarliestExpirationTime;
+        QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
+    }
+}
+
+//
+// Called when a timer change may have changed the earliest timer.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_INLINE
+void
+QuicConnTimerChanged(
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->State.DeferTimerWheelUpdate) {
+        Connection->State.TimerWheelUpdatePending = TRUE;
+    } else {
+        QuicConnTimerUpdateWheel(Connection);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnTimerSetEx(
@@ -1220,11 +1318,16 @@ QuicConnTimerSetEx(
         (uint8_t)Type,
         Delay);
 
+    const uint64_t OldExpirationTime = Connection->ExpirationTimes[Type];
     Connection->ExpirationTimes[Type] = NewExpirationTime;
-    uint64_t NewEarliestExpirationTime  = QuicGetEarliestExpirationTime(Connection);
-    if (NewEarliestExpirationTime != Connection->EarliestExpirationTime) {
-        Connection->EarliestExpirationTime = NewEarliestExpirationTime;
-        QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
+
+    //
+    // The earliest timer only changes if this one is now earlier than it, or
+    // this one was it.
+    //
+    if (NewExpirationTime < Connection->EarliestExpirationTime ||
+        OldExpirationTime == Connection->EarliestExpirationTime) {
+        QuicConnTimerChanged(Connection);
     }
 }
 
@@ -1235,32 +1338,26 @@ QuicConnTimerCancel(
     _In_ QUIC_CONN_TIMER_TYPE Type
     )
 {
-    CXPLAT_DBG_ASSERT(Connection->EarliestExpirationTime <= Connection->ExpirationTimes[Type]);
+    CXPLAT_DBG_ASSERT(
+        Connection->State.DeferTimerWheelUpdate ||
+        Connection->EarliestExpirationTime <= Connection->ExpirationTimes[Type]);
 
-    if (Connection->EarliestExpirationTime == UINT64_MAX) {
+    if (Connection->ExpirationTimes[Type] == UINT64_MAX) {
         //
-        // No timers are currently scheduled.
+        // The timer isn't set.
         //
         return;
     }
 
-    if (Connection->ExpirationTimes[Type] == Connection->EarliestExpirationTime) {
-        //
-        // We might be canceling the earliest timer, so we need to find the new
-        // expiration time for this connection.
-        //
-        Connection->ExpirationTimes[Type] = UINT64_MAX;
-        uint64_t NewEarliestExpirationTime = QuicGetEarliestExpirationTime(Connection);
-
-        if (NewEarliestExpirationTime != Connection->EarliestExpirationTime) {
-            //
-            // We've either found a new earliest expiration time, or there will be no timers scheduled.
-            //
-            Connection->EarliestExpirationTime = NewEarliestExpirationTime;
-            QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
-        }
-    } else {
-        Connection->ExpirationTimes[Type] = UINT64_MAX;
+    //
+    // If this was the earliest timer, we need to find the new expiration time
+    // for this connection.
+    //
+    const BOOLEAN WasEarliest =
+        Connection->ExpirationTimes[Type] == Connection->EarliestExpirationTime;
+    Connection->ExpirationTimes[Type] = UINT64_MAX;
+    if (WasEarliest) {
+        QuicConnTimerChanged(Connection);
     }
 }
 
@@ -1273,12 +1370,12 @@ QuicConnTimerExpired(
 {
     BOOLEAN FlushSendImmediate = FALSE;
 
-    Connection->EarliestExpirationTime = UINT64_MAX;
-
     //
-    // Queue up operations for all expired timers and update the earliest expiration time
-    // on the fly. Note that we must not call any functions that might update the timer wheel.
+    // Queue up operations for all expired timers. The connection was taken out
+    // of the timer wheel, so any timers changed meanwhile are only recorded,
+    // and the connection is put back once all are processed.
     //
+    Connection->State.DeferTimerWheelUpdate = TRUE;
     for (QUIC_CONN_TIMER_TYPE Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
         if (Connection->ExpirationTimes[Type] <= TimeNow) {
             Connection->ExpirationTimes[Type] = UINT64_MAX;
@@ -1319,11 +1416,12 @@ QuicConnTimerExpired(
                         0);
                 }
             }
-        } else if (Connection->ExpirationTimes[Type] < Connection->EarliestExpirationTime) {
-            Connection->EarliestExpirationTime = Connection->ExpirationTimes[Type];
         }
     }
+    Connection->State.DeferTimerWheelUpdate = FALSE;
+    Connection->State.TimerWheelUpdatePending = FALSE;
 
+    Connection->EarliestExpirationTime = QuicGetEarliestExpirationTime(Connection);
     QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
 
     if (FlushSendImmediate) {
@@ -1385,11 +1483,17 @@ QuicConnOnShutdownComplete(
         "[conn][%p] Shutdown complete, PeerFailedToAcknowledged=%hhu.",
         Connection,
         Connection->State.ShutdownCompleteTimedOut);
+    if (Connection->State.QlogEnabled) {
+        QuicQlogOnConnectionClosed(Connection);
+    }
 
     //
     // Clean up any pending state that is irrelevant now.
     //
     QUIC_PATH* Path = &Connection->Paths[0];
+    if (Path->GotFirstRttSample) {
+        QuicLatencyRecord(Connection->Partition->Latency.SmoothedRtt, Path->SmoothedRtt);
+    }
     if (Path->Binding != NULL) {
         if (Path->EncryptionOffloading) {
             QuicPathUpdateQeo(Connection, Path, CXPLAT_QEO_OPERATION_REMOVE);
@@ -1402,10 +1506,17 @@ QuicConnOnShutdownComplete(
         QuicBindingRemoveConnection(Connection->Paths[0].Binding, Connection);
     }
 
+    for (uint8_t i = Connection->PathsCount - 1; i > 0; i--) {
+        if (Connection->Paths[i].IsStandby) {
+            QuicPathRemove(Connection, i); // Releases the standby's binding.
+        }
+    }
+
     //
     // Clean up the rest of the internal state.
     //
     QuicTimerWheelRemoveConnection(&Connection->Worker->TimerWheel, Connection);
+    QuicPacingQueueRemoveConnection(&Connection->Worker->PacingQueue, Connection);
     QuicLossDetectionUninitialize(&Connection->LossDetection);
     QuicSendUninitialize(&Connection->Send);
     QuicDatagramSendShutdown(&Connection->Datagram);
@@ -1770,6 +1881,40 @@ QuicConnOnQuicVersionSet(
     }
 }
 
+//
+// Decodes a client resumption ticket and applies the server's saved transport
+// parameters, before the connection is started.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicConnSetResumptionTicket(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint16_t TicketLength,
+    _In_reads_(TicketLength)
+        const uint8_t* Ticket
+    )
+{
+    QUIC_STATUS Status =
+        QuicCryptoDecodeClientTicket(
+            Connection,
+            TicketLength,
+            Ticket,
+            &Connection->PeerTransportParams,
+            &Connection->Crypto.ResumptionTicket,
+            &Connection->Crypto.ResumptionTicketLength,
+            &Connection->Stats.QuicVersion);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    QuicConnOnQuicVersionSet(Connection);
+    Status = QuicConnProcessPeerTransportParameters(Connection, TRUE);
+    CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status));
+
+    return Status;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicConnStart(
@@ -1811,10 +1956,7 @@ QuicConnStart(
 
     CXPLAT_TEL_ASSERT(Path->Binding == NULL);
 
-    QuicConnApplyNewSettings(
-        Connection,
-        FALSE,
-        &Configuration->Settings);
+    QuicConnApplyConfigurationSettings(Connection, Configuration);
 
     if (!Connection->State.RemoteAddressSet) {
 
@@ -1838,14 +1980,46 @@ QuicConnStart(
         }
 #endif
 
-        //
-        // Resolve the server name to IP address.
-        //
-        Status =
-            CxPlatDataPathResolveAddress(
-                MsQuicLib.Datapath,
-                ServerName,
-                &Path->Route.RemoteAddress);
+        if (Family == QUIC_ADDRESS_FAMILY_UNSPEC &&
+            Connection->HappyEyeballsDelayMs != 0 &&
+            !Connection->State.ShareBinding &&
+            !Connection->State.LocalAddressSet) {
+            //
+            // Happy eyeballs (RFC 8305): resolve the server name for both
+            // families, start with IPv6 and keep the IPv4 address around to
+            // race against it, if IPv6 turns out to be slow (or broken).
+            //
+            QuicAddrSetFamily(&Path->Route.RemoteAddress, QUIC_ADDRESS_FAMILY_INET6);
+            QuicAddrSetFamily(&Connection->HappyEyeballsAddress, QUIC_ADDRESS_FAMILY_INET);
+            QUIC_STATUS Ipv6Status =
+                CxPlatDataPathResolveAddress(
+                    MsQuicLib.Datapath,
+                    ServerName,
+                    &Path->Route.RemoteAddress);
+            Status =
+                CxPlatDataPathResolveAddress(
+                    MsQuicLib.Datapath,
+                    ServerName,
+                    &Connection->HappyEyeballsAddress);
+            if (QUIC_FAILED(Ipv6Status)) {
+                Path->Route.RemoteAddress = Connection->HappyEyeballsAddress;
+            } else if (QUIC_FAILED(Status)) {
+                Status = Ipv6Status;
+            } else {
+                QuicAddrSetPort(&Connection->HappyEyeballsAddress, ServerPort);
+                Connection->State.HappyEyeballsPending = TRUE;
+            }
+
+        } else {
+            //
+            // Resolve the server name to IP address.
+            //
+            Status =
+                CxPlatDataPathResolveAddress(
+                    MsQuicLib.Datapath,
+                    ServerName,
+                    &Path->Route.RemoteAddress);
+        }
 
 #ifdef QUIC_COMPARTMENT_ID
         if (RevertCompartmentId) {
@@ -1893,12 +2067,15 @@ QuicConnStart(
     if (Connection->State.ShareBinding) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_SHARE;
     }
-    if (Connection->Settings.XdpEnabled) {
+    if (Connection->Settings->XdpEnabled) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
     }
-    if (Connection->Settings.QTIPEnabled) {
+    if (Connection->Settings->QTIPEnabled) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
     }
+    if (Connection->Settings->RioEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_RIO;
+    }
     if (Connection->State.Partitioned) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_PARTITIONED;
     }
@@ -1963,8 +2140,51 @@ QuicConnStart(
     // Save the server name.
     //
     Connection->RemoteServerName = ServerName;
+    Connection->RemoteServerPort = ServerPort;
     ServerName = NULL;
 
+    if (Connection->RemoteServerName != NULL &&
+        Connection->Crypto.ResumptionTicket == NULL) {
+        //
+        // The app didn't set a resumption ticket, so use one saved by an
+        // earlier connection to the same server, if there is one.
+        //
+        QUIC_CLIENT_TICKET_CACHE_ENTRY* Entry =
+            QuicClientTicketCacheTake(
+                &Connection->Registration->ClientTicketCache,
+                Connection->RemoteServerName,
+                ServerPort,
+                Configuration->AlpnListLength,
+                Configuration->AlpnList);
+        if (Entry != NULL) {
+            (void)QuicConnSetResumptionTicket(
+                Connection,
+                (uint16_t)Entry->TicketLength,
+                QuicClientTicketCacheEntryTicket(Entry));
+            QuicClientTicketCacheEntryFree(Entry);
+        }
+    }
+
+    uint32_t CachedVersion;
+    if (Connection->RemoteServerName != NULL &&
+        Connection->Crypto.ResumptionTicket == NULL &&
+        QuicClientTicketCacheLookupVersion(
+            &Connection->Registration->ClientTicketCache,
+            Connection->RemoteServerName,
+            ServerPort,
+            &CachedVersion) &&
+        CachedVersion != Connection->Stats.QuicVersion &&
+        QuicVersionNegotiationExtIsVersionClientSupported(Connection, CachedVersion)) {
+        //
+        // Without a ticket (which carries its own version), start with the
+        // version last negotiated with the server, rather than having version
+        // negotiation, or a compatible version upgrade, move the connection to
+        // it again.
+        //
+        Connection->Stats.QuicVersion = CachedVersion;
+        QuicConnOnQuicVersionSet(Connection);
+    }
+
     Status = QuicCryptoInitialize(&Connection->Crypto);
     if (QUIC_FAILED(Status)) {
         goto Exit;
@@ -1978,6 +2198,13 @@ QuicConnStart(
         goto Exit;
     }
 
+    if (Connection->State.HappyEyeballsPending) {
+        QuicConnTimerSet(
+            Connection,
+            QUIC_CONN_TIMER_PATH_PROBE,
+            MS_TO_US(Connection->HappyEyeballsDelayMs));
+    }
+
 Exit:
 
     if (ServerName != NULL) {
@@ -2018,7 +2245,7 @@ QuicConnRestart(
         //
         QUIC_PATH* Path = &Connection->Paths[0];
         Path->GotFirstRttSample = FALSE;
-        Path->SmoothedRtt = MS_TO_US(Connection->Settings.InitialRttMs);
+        Path->SmoothedRtt = MS_TO_US(Connection->Settings->InitialRttMs);
         Path->RttVariance = Path->SmoothedRtt / 2;
     }
 
@@ -2057,92 +2284,387 @@ QuicConnRestart(
     }
 }
 
+//
+// Makes a (client) happy eyeballs path the active path. The previously active
+// path keeps its own binding bound to the connection, like a standby path, so
+// it can still receive the server's response.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
-QUIC_STATUS
-QuicConnSendResumptionTicket(
+static
+void
+QuicConnSwapHappyEyeballsPath(
     _In_ QUIC_CONNECTION* Connection,
-    _In_ uint16_t AppDataLength,
-    _In_reads_bytes_opt_(AppDataLength)
-        const uint8_t* AppResumptionData
+    _In_ QUIC_PATH* Path
     )
 {
-    QUIC_STATUS Status;
-    uint8_t* TicketBuffer = NULL;
-    uint32_t TicketLength = 0;
-    uint8_t AlpnLength = Connection->Crypto.TlsState.NegotiatedAlpn[0];
+    CXPLAT_DBG_ASSERT(Path != &Connection->Paths[0]);
+    CXPLAT_DBG_ASSERT(Path->IsRacing);
+
+    QuicBindingRemoveStandbyConnection(Path->Binding, Connection);
+    QuicBindingMoveSourceConnectionIDs(
+        Connection->Paths[0].Binding, Path->Binding, Connection);
+    BOOLEAN Result =
+        QuicBindingAddStandbyConnection(Connection->Paths[0].Binding, Connection);
+    CXPLAT_DBG_ASSERT(Result); // Happy eyeballs requires exclusive bindings.
+    UNREFERENCED_PARAMETER(Result);
+
+    QUIC_PATH PrevActivePath = Connection->Paths[0];
+    PrevActivePath.IsActive = FALSE;
+    PrevActivePath.IsStandby = TRUE;
+    PrevActivePath.IsRacing = TRUE;
+    Path->IsActive = TRUE;
+    Path->IsStandby = FALSE;
+    Path->IsRacing = FALSE;
+    Connection->Paths[0] = *Path;
+    *Path = PrevActivePath;
+    Connection->SpinRtt.LastEdgeTime = 0;
 
-    if (Connection->HandshakeTP == NULL) {
-        Status = QUIC_STATUS_OUT_OF_MEMORY;
-        goto Error;
-    }
+    QuicTraceLogConnInfo(
+        PathActive,
+        Connection,
+        "Path[%hhu] Set active (rebind=%hhu)",
+        Connection->Paths[0].ID,
+        FALSE);
 
-    Status =
-        QuicCryptoEncodeServerTicket(
-            Connection,
-            Connection->Stats.QuicVersion,
-            AppDataLength,
-            AppResumptionData,
-            Connection->HandshakeTP,
-            NULL,    // No Careful Resumption data
-            AlpnLength,
-            Connection->Crypto.TlsState.NegotiatedAlpn + 1,
-            &TicketBuffer,
-            &TicketLength);
-    if (QUIC_FAILED(Status)) {
-        goto Error;
+    QuicCongestionControlReset(&Connection->CongestionControl, FALSE);
+}
+
+//
+// Starts the (client) happy eyeballs attempt to the server's other address
+// family, if the first attempt hasn't been answered within the connection
+// attempt delay. The new attempt, over its own binding, becomes the active
+// path and resends what was already sent, starting with the ClientHello TLS
+// already produced, like after a Retry. The first attempt's binding is kept
+// so a late response to it can still win the race.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnStartHappyEyeballs(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    Connection->State.HappyEyeballsPending = FALSE;
+    if (QuicConnIsClosed(Connection) ||
+        Connection->State.GotFirstServerResponse ||
+        Connection->PathsCount == QUIC_MAX_PATH_COUNT) {
+        return;
     }
 
-    Status = QuicCryptoProcessAppData(&Connection->Crypto, TicketLength, TicketBuffer);
+    CXPLAT_UDP_CONFIG UdpConfig = {0};
+    UdpConfig.LocalAddress = NULL;
+    UdpConfig.RemoteAddress = &Connection->HappyEyeballsAddress;
+    UdpConfig.Flags = CXPLAT_SOCKET_FLAG_NONE;
+    UdpConfig.InterfaceIndex = 0;
+    UdpConfig.PartitionIndex = QuicPartitionIdGetIndex(Connection->PartitionID);
+#ifdef QUIC_COMPARTMENT_ID
+    UdpConfig.CompartmentId = Connection->Configuration->CompartmentId;
+#endif
+#ifdef QUIC_OWNING_PROCESS
+    UdpConfig.OwningProcess = Connection->Configuration->OwningProcess;
+#endif
+    if (Connection->Settings->XdpEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
+    }
+    if (Connection->Settings->QTIPEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
+    }
+    if (Connection->Settings->RioEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_RIO;
+    }
+    if (Connection->State.Partitioned) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_PARTITIONED;
+    }
 
-Error:
-    if (TicketBuffer != NULL) {
-        CXPLAT_FREE(TicketBuffer, QUIC_POOL_SERVER_CRYPTO_TICKET);
+    QUIC_BINDING* Binding;
+    QUIC_STATUS Status = QuicLibraryGetBinding(&UdpConfig, &Binding);
+    if (QUIC_FAILED(Status)) {
+        QuicTraceEvent(
+            ConnErrorStatus,
+            "[conn][%p] ERROR, %u, %s.",
+            Connection,
+            Status,
+            "Starting happy eyeballs attempt");
+        return;
     }
 
-    if (AppResumptionData != NULL) {
-        CXPLAT_FREE(AppResumptionData, QUIC_POOL_APP_RESUMPTION_DATA);
+    if (!QuicBindingAddStandbyConnection(Binding, Connection)) {
+        QuicLibraryReleaseBinding(Binding);
+        return;
     }
 
-    return Status;
+    QUIC_PATH* Path = &Connection->Paths[Connection->PathsCount++];
+    QuicPathInitialize(Connection, Path);
+    Path->IsStandby = TRUE;
+    Path->IsRacing = TRUE;
+    Path->IsPeerValidated = TRUE;
+    Path->Allowance = UINT32_MAX; // Only servers are amplification limited.
+    Path->Binding = Binding;
+    Path->Route.State = RouteUnresolved;
+    Path->Route.RemoteAddress = Connection->HappyEyeballsAddress;
+    QuicBindingGetLocalAddress(Binding, &Path->Route.LocalAddress);
+
+    //
+    // Both attempts use the same initial destination CID (and so the same
+    // Initial keys). The path doesn't own it, so it isn't assigned to it.
+    //
+    Path->DestCid = Connection->Paths[0].DestCid;
+
+    QuicTraceEvent(
+        ConnRemoteAddrAdded,
+        "[conn][%p] New Remote IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.RemoteAddress), &Path->Route.RemoteAddress));
+
+    QuicConnSwapHappyEyeballsPath(Connection, Path);
+    Connection->State.HappyEyeballsRacing = TRUE;
+    QuicConnRestart(Connection, FALSE);
 }
 
+//
+// Returns the (client) happy eyeballs path that got the first valid response
+// from the server, if any.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
-BOOLEAN
-QuicConnRecvResumptionTicket(
-    _In_ QUIC_CONNECTION* Connection,
-    _In_ uint16_t TicketLength,
-    _In_reads_(TicketLength)
-        const uint8_t* Ticket
+QUIC_INLINE
+_Ret_maybenull_
+QUIC_PATH*
+QuicConnGetHappyEyeballsWinner(
+    _In_ QUIC_CONNECTION* Connection
     )
 {
-    BOOLEAN ResumptionAccepted = FALSE;
-    QUIC_TRANSPORT_PARAMETERS ResumedTP = {0};
-    CxPlatZeroMemory(&ResumedTP, sizeof(ResumedTP));
-    if (QuicConnIsServer(Connection)) {
-        if (Connection->Crypto.TicketValidationRejecting) {
-            QuicTraceEvent(
-                ConnError,
-                "[conn][%p] ERROR, %s.",
-                Connection,
-                "Resumption Ticket rejected by server app asynchronously");
-            Connection->Crypto.TicketValidationRejecting = FALSE;
-            Connection->Crypto.TicketValidationPending = FALSE;
-            goto Error;
+    for (uint8_t i = 0; i < Connection->PathsCount; ++i) {
+        if (Connection->Paths[i].GotValidPacket) {
+            return &Connection->Paths[i];
         }
-        Connection->Crypto.TicketValidationPending = TRUE;
-
-        const uint8_t* AppData = NULL;
-        uint32_t AppDataLength = 0;
+    }
+    return NULL;
+}
 
-        QUIC_STATUS Status =
-            QuicCryptoDecodeServerTicket(
-                Connection,
+//
+// Ends the (client) happy eyeballs race once an attempt got a valid response,
+// by making it the active path and dropping the other attempt. Called once
+// received packets are processed, so no path moves while they are.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnCompleteHappyEyeballs(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_PATH* Winner = QuicConnGetHappyEyeballsWinner(Connection);
+    if (Winner == NULL) {
+        return;
+    }
+
+    if (Connection->State.HappyEyeballsPending) {
+        //
+        // The first attempt was answered before the other one started.
+        //
+        Connection->State.HappyEyeballsPending = FALSE;
+        QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_PATH_PROBE);
+        return;
+    }
+
+    Connection->State.HappyEyeballsRacing = FALSE;
+    if (Winner->IsRacing) {
+        QuicConnSwapHappyEyeballsPath(Connection, Winner);
+    }
+
+    for (uint8_t i = Connection->PathsCount - 1; i > 0; i--) {
+        if (Connection->Paths[i].IsRacing) {
+            QuicPathRemove(Connection, i); // Releases the attempt's binding.
+        }
+    }
+
+    QuicTraceEvent(
+        ConnRemoteAddrAdded,
+        "[conn][%p] New Remote IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Connection->Paths[0].Route.RemoteAddress), &Connection->Paths[0].Route.RemoteAddress));
+}
+
+//
+// Uses the congestion state saved in an accepted resumption ticket, if it is
+// still valid for the connection's path.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnApplyCarefulResumeState(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_CONN_CAREFUL_RESUME_STATE* State
+    )
+{
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    if (!Connection->Settings->CarefulResumeEnabled ||
+        State->CongestionWindow == 0 ||
+        State->Algorithm != Connection->Settings->CongestionControlAlgorithm ||
+        State->Expiration < MS_TO_US((uint64_t)CxPlatTimeEpochMs64()) ||
+        !QuicAddrCompareIp(&State->RemoteEndpoint, &Path->Route.RemoteAddress)) {
+        return;
+    }
+
+    QuicCongestionControlSetCarefulResumeState(&Connection->CongestionControl, State);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnSendResumptionTicket(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint16_t AppDataLength,
+    _In_reads_bytes_opt_(AppDataLength)
+        const uint8_t* AppResumptionData
+    )
+{
+    QUIC_STATUS Status;
+    uint8_t* TicketBuffer = NULL;
+    uint32_t TicketLength = 0;
+    uint8_t AlpnLength = Connection->Crypto.TlsState.NegotiatedAlpn[0];
+
+    if (Connection->HandshakeTP == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+
+    //
+    // Save the path's congestion state in the ticket, so a resumed connection
+    // from the same client can jump-start its window.
+    //
+    QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState;
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const BOOLEAN SaveCarefulResumeState =
+        Connection->Settings->CarefulResumeEnabled && Path->GotFirstRttSample;
+    if (SaveCarefulResumeState) {
+        CxPlatZeroMemory(&CarefulResumeState, sizeof(CarefulResumeState));
+        CarefulResumeState.SmoothedRtt = Path->SmoothedRtt;
+        CarefulResumeState.MinRtt = Path->MinRtt;
+        CarefulResumeState.RemoteEndpoint = Path->Route.RemoteAddress;
+        CarefulResumeState.Expiration =
+            MS_TO_US((uint64_t)CxPlatTimeEpochMs64()) +
+            S_TO_US((uint64_t)QUIC_CAREFUL_RESUME_STATE_LIFETIME_S);
+        CarefulResumeState.Algorithm =
+            (QUIC_CONGESTION_CONTROL_ALGORITHM)Connection->Settings->CongestionControlAlgorithm;
+        CarefulResumeState.CongestionWindow =
+            QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl);
+    }
+
+    Status =
+        QuicCryptoEncodeServerTicket(
+            Connection,
+            Connection->Stats.QuicVersion,
+            AppDataLength,
+            AppResumptionData,
+            Connection->HandshakeTP,
+            SaveCarefulResumeState ? &CarefulResumeState : NULL,
+            AlpnLength,
+            Connection->Crypto.TlsState.NegotiatedAlpn + 1,
+            &TicketBuffer,
+            &TicketLength);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    uint8_t TicketRef[QUIC_TICKET_CACHE_REF_LENGTH];
+    if (QuicTicketCacheInsert(
+            &Connection->Partition->TicketCache,
+            Connection->Partition->Index,
+            TicketLength,
+            TicketBuffer,
+            TicketRef)) {
+        //
+        // The ticket is cached, so only a reference to it goes to the client.
+        //
+        Status = QuicCryptoProcessAppData(&Connection->Crypto, sizeof(TicketRef), TicketRef);
+        goto Error;
+    }
+
+    Status = QuicCryptoProcessAppData(&Connection->Crypto, TicketLength, TicketBuffer);
+
+Error:
+    if (TicketBuffer != NULL) {
+        CXPLAT_FREE(TicketBuffer, QUIC_POOL_SERVER_CRYPTO_TICKET);
+    }
+
+    if (AppResumptionData != NULL) {
+        CXPLAT_FREE(AppResumptionData, QUIC_POOL_APP_RESUMPTION_DATA);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvResumptionTicket(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint16_t TicketLength,
+    _In_reads_(TicketLength)
+        const uint8_t* Ticket
+    )
+{
+    BOOLEAN ResumptionAccepted = FALSE;
+    QUIC_TRANSPORT_PARAMETERS ResumedTP = {0};
+    CxPlatZeroMemory(&ResumedTP, sizeof(ResumedTP));
+    if (QuicConnIsServer(Connection)) {
+        if (Connection->Crypto.TicketValidationRejecting) {
+            QuicTraceEvent(
+                ConnError,
+                "[conn][%p] ERROR, %s.",
+                Connection,
+                "Resumption Ticket rejected by server app asynchronously");
+            Connection->Crypto.TicketValidationRejecting = FALSE;
+            Connection->Crypto.TicketValidationPending = FALSE;
+            goto Error;
+        }
+        Connection->Crypto.TicketValidationPending = TRUE;
+
+        uint8_t CachedTicket[QUIC_TICKET_CACHE_MAX_TICKET_LENGTH];
+        uint16_t PartitionIndex;
+        if (QuicTicketCacheIsRef(TicketLength, Ticket, &PartitionIndex)) {
+            if (PartitionIndex >= MsQuicLib.PartitionCount ||
+                !QuicTicketCacheLookup(
+                    &MsQuicLib.Partitions[PartitionIndex].TicketCache,
+                    Ticket,
+                    CachedTicket,
+                    &TicketLength)) {
+                QuicTraceEvent(
+                    ConnError,
+                    "[conn][%p] ERROR, %s.",
+                    Connection,
+                    "Resumption Ticket not in server ticket cache");
+                Connection->Crypto.TicketValidationPending = FALSE;
+                goto Error;
+            }
+            Ticket = CachedTicket;
+
+        } else if (MsQuicLib.TicketCacheSize != 0 &&
+                   TicketLength <= QUIC_TICKET_CACHE_MAX_TICKET_LENGTH) {
+            //
+            // A ticket this small would have been cached. Only accept it from
+            // the cache, so flushing it revokes resumption.
+            //
+            QuicTraceEvent(
+                ConnError,
+                "[conn][%p] ERROR, %s.",
+                Connection,
+                "Stateless Resumption Ticket with server ticket cache enabled");
+            Connection->Crypto.TicketValidationPending = FALSE;
+            goto Error;
+        }
+
+        const uint8_t* AppData = NULL;
+        uint32_t AppDataLength = 0;
+        QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState;
+
+        QUIC_STATUS Status =
+            QuicCryptoDecodeServerTicket(
+                Connection,
                 TicketLength,
                 Ticket,
                 Connection->Configuration->AlpnList,
                 Connection->Configuration->AlpnListLength,
                 &ResumedTP,
-                NULL,    // No Careful Resumption data
+                &CarefulResumeState,
                 &AppData,
                 &AppDataLength);
         if (QUIC_FAILED(Status)) {
@@ -2154,9 +2676,9 @@ QuicConnRecvResumptionTicket(
         //
         if (ResumedTP.ActiveConnectionIdLimit > QUIC_ACTIVE_CONNECTION_ID_LIMIT ||
             ResumedTP.InitialMaxData > Connection->Send.MaxData ||
-            ResumedTP.InitialMaxStreamDataBidiLocal > Connection->Settings.StreamRecvWindowBidiLocalDefault ||
-            ResumedTP.InitialMaxStreamDataBidiRemote > Connection->Settings.StreamRecvWindowBidiRemoteDefault ||
-            ResumedTP.InitialMaxStreamDataUni > Connection->Settings.StreamRecvWindowUnidiDefault ||
+            ResumedTP.InitialMaxStreamDataBidiLocal > Connection->Settings->StreamRecvWindowBidiLocalDefault ||
+            ResumedTP.InitialMaxStreamDataBidiRemote > Connection->Settings->StreamRecvWindowBidiRemoteDefault ||
+            ResumedTP.InitialMaxStreamDataUni > Connection->Settings->StreamRecvWindowUnidiDefault ||
             ResumedTP.InitialMaxUniStreams > Connection->Streams.Types[STREAM_ID_FLAG_IS_CLIENT | STREAM_ID_FLAG_IS_UNI_DIR].MaxTotalStreamCount ||
             ResumedTP.InitialMaxBidiStreams > Connection->Streams.Types[STREAM_ID_FLAG_IS_CLIENT | STREAM_ID_FLAG_IS_BI_DIR].MaxTotalStreamCount) {
             //
@@ -2171,6 +2693,33 @@ QuicConnRecvResumptionTicket(
             goto Error;
         }
 
+        if (Connection->Settings->ServerResumptionLevel == QUIC_SERVER_RESUME_AND_ZERORTT &&
+            QuicAntiReplayIsEnabled(&Connection->Registration->AntiReplay)) {
+            //
+            // Refuse the ticket, and with it any 0-RTT data, if the same
+            // ClientHello has already been seen.
+            //
+            if (!Connection->Crypto.AntiReplayChecked) {
+                Connection->Crypto.AntiReplayChecked = TRUE;
+                Connection->Crypto.AntiReplayRefused =
+                    !QuicAntiReplayCheck(
+                        &Connection->Registration->AntiReplay,
+                        Connection->Crypto.ClientHelloDigest);
+                if (Connection->Crypto.AntiReplayRefused) {
+                    QuicPerfCounterIncrement(
+                        Connection->Partition, QUIC_PERF_COUNTER_ZERORTT_REPLAY_REJECT);
+                }
+            }
+            if (Connection->Crypto.AntiReplayRefused) {
+                QuicTraceEvent(
+                    ConnError,
+                    "[conn][%p] ERROR, %s.",
+                    Connection,
+                    "Resumption Ticket in replayed ClientHello");
+                goto Error;
+            }
+        }
+
         QUIC_CONNECTION_EVENT Event;
         Event.Type = QUIC_CONNECTION_EVENT_RESUMED;
         Event.RESUMED.ResumptionStateLength = (uint16_t)AppDataLength;
@@ -2187,6 +2736,7 @@ QuicConnRecvResumptionTicket(
                 Connection);
             ResumptionAccepted = TRUE;
             Connection->Crypto.TicketValidationPending = FALSE;
+            QuicConnApplyCarefulResumeState(Connection, &CarefulResumeState);
         } else if (Status == QUIC_STATUS_PENDING) {
             QuicTraceEvent(
                 ConnServerResumeTicket,
@@ -2220,6 +2770,18 @@ QuicConnRecvResumptionTicket(
                 &ClientTicket,
                 &ClientTicketLength))) {
 
+            if (Connection->RemoteServerName != NULL &&
+                ClientTicketLength <= UINT16_MAX) {
+                QuicClientTicketCacheInsert(
+                    &Connection->Registration->ClientTicketCache,
+                    Connection->RemoteServerName,
+                    Connection->RemoteServerPort,
+                    Connection->Configuration->AlpnListLength,
+                    Connection->Configuration->AlpnList,
+                    ClientTicketLength,
+                    ClientTicket);
+            }
+
             QUIC_CONNECTION_EVENT Event;
             Event.Type = QUIC_CONNECTION_EVENT_RESUMPTION_TICKET_RECEIVED;
             Event.RESUMPTION_TICKET_RECEIVED.ResumptionTicketLength = ClientTicketLength;
@@ -2298,9 +2860,10 @@ QuicConnGenerateLocalTransportParameters(
             Link);
 
     LocalTP->InitialMaxData = Connection->Send.MaxData;
-    LocalTP->InitialMaxStreamDataBidiLocal = Connection->Settings.StreamRecvWindowBidiLocalDefault;
-    LocalTP->InitialMaxStreamDataBidiRemote = Connection->Settings.StreamRecvWindowBidiRemoteDefault;
-    LocalTP->InitialMaxStreamDataUni = Connection->Settings.StreamRecvWindowUnidiDefault;
+    Connection->Send.MaxDataSent = Connection->Send.MaxData;
+    LocalTP->InitialMaxStreamDataBidiLocal = Connection->Settings->StreamRecvWindowBidiLocalDefault;
+    LocalTP->InitialMaxStreamDataBidiRemote = Connection->Settings->StreamRecvWindowBidiRemoteDefault;
+    LocalTP->InitialMaxStreamDataUni = Connection->Settings->StreamRecvWindowUnidiDefault;
     LocalTP->MaxUdpPayloadSize =
         MaxUdpPayloadSizeFromMTU(
             CxPlatSocketGetLocalMtu(
@@ -2322,9 +2885,9 @@ QuicConnGenerateLocalTransportParameters(
         QUIC_TP_FLAG_MIN_ACK_DELAY |
         QUIC_TP_FLAG_ACTIVE_CONNECTION_ID_LIMIT;
 
-    if (Connection->Settings.IdleTimeoutMs != 0) {
+    if (Connection->Settings->IdleTimeoutMs != 0) {
         LocalTP->Flags |= QUIC_TP_FLAG_IDLE_TIMEOUT;
-        LocalTP->IdleTimeout = Connection->Settings.IdleTimeoutMs;
+        LocalTP->IdleTimeout = Connection->Settings->IdleTimeoutMs;
     }
 
     if (Connection->AckDelayExponent != QUIC_TP_ACK_DELAY_EXPONENT_DEFAULT) {
@@ -2339,7 +2902,7 @@ QuicConnGenerateLocalTransportParameters(
         SourceCid->CID.Data,
         SourceCid->CID.Length);
 
-    if (Connection->Settings.DatagramReceiveEnabled) {
+    if (Connection->Settings->DatagramReceiveEnabled) {
         LocalTP->Flags |= QUIC_TP_FLAG_MAX_DATAGRAM_FRAME_SIZE;
         LocalTP->MaxDatagramFrameSize = QUIC_DEFAULT_MAX_DATAGRAM_LENGTH;
     }
@@ -2354,7 +2917,7 @@ QuicConnGenerateLocalTransportParameters(
         LocalTP->CibirOffset = Connection->CibirId[1];
     }
 
-    if (Connection->Settings.VersionNegotiationExtEnabled
+    if (Connection->Settings->VersionNegotiationExtEnabled
 #if QUIC_TEST_DISABLE_VNE_TP_GENERATION
         && !Connection->State.DisableVneTp
 #endif
@@ -2370,17 +2933,21 @@ QuicConnGenerateLocalTransportParameters(
         }
     }
 
-    if (Connection->Settings.GreaseQuicBitEnabled) {
+    if (Connection->Settings->GreaseQuicBitEnabled) {
         LocalTP->Flags |= QUIC_TP_FLAG_GREASE_QUIC_BIT;
     }
 
-    if (Connection->Settings.ReliableResetEnabled) {
+    if (Connection->Settings->ReliableResetEnabled) {
         LocalTP->Flags |= QUIC_TP_FLAG_RELIABLE_RESET_ENABLED;
     }
 
-    if (Connection->Settings.OneWayDelayEnabled) {
+    if (Connection->Settings->OneWayDelayEnabled) {
         LocalTP->Flags |= QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED |
                           QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED;
+        LocalTP->Flags |= QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK |
+                          QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT;
+        LocalTP->MaxReceiveTimestampsPerAck = QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK;
+        LocalTP->ReceiveTimestampsExponent = QUIC_RECEIVE_TIMESTAMPS_EXPONENT;
     }
 
     if (QuicConnIsServer(Connection)) {
@@ -2397,7 +2964,7 @@ QuicConnGenerateLocalTransportParameters(
                 Connection->Streams.Types[STREAM_ID_FLAG_IS_CLIENT | STREAM_ID_FLAG_IS_UNI_DIR].MaxTotalStreamCount;
         }
 
-        if (!Connection->Settings.MigrationEnabled) {
+        if (!Connection->Settings->MigrationEnabled) {
             LocalTP->Flags |= QUIC_TP_FLAG_DISABLE_ACTIVE_MIGRATION;
         }
 
@@ -2443,6 +3010,40 @@ QuicConnGenerateLocalTransportParameters(
             }
         }
 
+        if (Connection->PreferredAddress != NULL) {
+            //
+            // The preferred address comes with its own CID (sequence number
+            // 1), which the client learns from the transport parameter rather
+            // than a NEW_CONNECTION_ID frame.
+            //
+            QUIC_CID_HASH_ENTRY* PreferredCid =
+                QuicConnGenerateNewSourceCid(Connection, FALSE);
+            if (PreferredCid != NULL) {
+                PreferredCid->CID.NeedsToSend = FALSE;
+                Status =
+                    QuicLibraryGenerateStatelessResetToken(
+                        Connection->Partition,
+                        PreferredCid->CID.Data,
+                        LocalTP->PreferredAddressResetToken);
+                if (QUIC_FAILED(Status)) {
+                    QuicTraceEvent(
+                        ConnErrorStatus,
+                        "[conn][%p] ERROR, %u, %s.",
+                        Connection,
+                        Status,
+                        "QuicLibraryGenerateStatelessResetToken");
+                    return Status;
+                }
+                LocalTP->Flags |= QUIC_TP_FLAG_PREFERRED_ADDRESS;
+                LocalTP->PreferredAddress = *Connection->PreferredAddress;
+                LocalTP->PreferredAddressCidLength = PreferredCid->CID.Length;
+                CxPlatCopyMemory(
+                    LocalTP->PreferredAddressCid,
+                    PreferredCid->CID.Data,
+                    PreferredCid->CID.Length);
+            }
+        }
+
     } else {
 
         if (Connection->Streams.Types[STREAM_ID_FLAG_IS_SERVER | STREAM_ID_FLAG_IS_BI_DIR].MaxTotalStreamCount) {
@@ -2490,10 +3091,23 @@ QuicConnSetConfiguration(
     Connection->Configuration = Configuration;
 
     if (QuicConnIsServer(Connection)) {
-        QuicConnApplyNewSettings(
-            Connection,
-            FALSE,
-            &Configuration->Settings);
+        QuicConnApplyConfigurationSettings(Connection, Configuration);
+    }
+
+    if (Connection->HandoffState != NULL) {
+        //
+        // The handshake already happened in another process. Pick up where it
+        // left off instead of starting a new one.
+        //
+        Status = QuicConnHandoffImport(Connection);
+        if (QUIC_FAILED(Status)) {
+            QuicConnCloseLocally(
+                Connection,
+                QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
+                (uint64_t)Status,
+                NULL);
+        }
+        goto Error;
     }
 
     if (QuicConnIsClient(Connection)) {
@@ -2522,10 +3136,10 @@ QuicConnSetConfiguration(
         // Save the original CID for later validation in the TP.
         //
         Connection->OrigDestCID =
-            CXPLAT_ALLOC_NONPAGED(
+            QuicArenaAlloc(
+                &Connection->HandshakeArena,
                 sizeof(QUIC_CID) +
-                DestCid->CID.Length,
-                QUIC_POOL_CID);
+                DestCid->CID.Length);
         if (Connection->OrigDestCID == NULL) {
             QuicTraceEvent(
                 AllocFailure,
@@ -2953,7 +3567,7 @@ QuicConnProcessPeerTransportParameters(
     }
 
     if (!FromResumptionTicket) {
-        if (Connection->Settings.VersionNegotiationExtEnabled &&
+        if (Connection->Settings->VersionNegotiationExtEnabled &&
             Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION) {
             Status = QuicConnProcessPeerVersionNegotiationTP(Connection);
             if (QUIC_FAILED(Status)) {
@@ -2992,18 +3606,42 @@ QuicConnProcessPeerTransportParameters(
         }
 
         if (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
-            /*QuicTraceLogConnInfo(
-                PeerPreferredAddress,
-                Connection,
-                "Peer configured preferred address %!ADDR!",
-                CASTED_CLOG_BYTEARRAY(sizeof(Connection->PeerTransportParams.PreferredAddress), &Connection->PeerTransportParams.PreferredAddress));*/
-
+            CXPLAT_DBG_ASSERT(QuicConnIsClient(Connection));
             //
-            // TODO - Implement preferred address feature.
+            // The preferred address's CID has sequence number 1. It's only
+            // used once the client migrates to the preferred address, after
+            // the handshake is confirmed.
             //
+            QUIC_CID_LIST_ENTRY* DestCid =
+                QuicCidNewDestination(
+                    Connection->PeerTransportParams.PreferredAddressCidLength,
+                    Connection->PeerTransportParams.PreferredAddressCid);
+            if (DestCid == NULL) {
+                QuicTraceEvent(
+                    AllocFailure,
+                    "Allocation of '%s' failed. (%llu bytes)",
+                    "preferred address DestCid",
+                    sizeof(QUIC_CID_LIST_ENTRY) + Connection->PeerTransportParams.PreferredAddressCidLength);
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+                goto Error;
+            }
+            DestCid->CID.HasResetToken = TRUE;
+            DestCid->CID.SequenceNumber = 1;
+            CxPlatCopyMemory(
+                DestCid->ResetToken,
+                Connection->PeerTransportParams.PreferredAddressResetToken,
+                QUIC_STATELESS_RESET_TOKEN_LENGTH);
+            QuicTraceEvent(
+                ConnDestCidAdded,
+                "[conn][%p] (SeqNum=%llu) New Destination CID: %!CID!",
+                Connection,
+                DestCid->CID.SequenceNumber,
+                CASTED_CLOG_BYTEARRAY(DestCid->CID.Length, DestCid->CID.Data));
+            CxPlatListInsertTail(&Connection->DestCids, &DestCid->Link);
+            Connection->DestCidCount++;
         }
 
-        if (Connection->Settings.GreaseQuicBitEnabled &&
+        if (Connection->Settings->GreaseQuicBitEnabled &&
             (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_GREASE_QUIC_BIT) > 0) {
             //
             // Endpoints that receive the grease_quic_bit transport parameter from
@@ -3016,7 +3654,7 @@ QuicConnProcessPeerTransportParameters(
             Connection->Stats.GreaseBitNegotiated = TRUE;
         }
 
-        if (Connection->Settings.ReliableResetEnabled) {
+        if (Connection->Settings->ReliableResetEnabled) {
             Connection->State.ReliableResetStreamNegotiated =
                 !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_RELIABLE_RESET_ENABLED);
 
@@ -3035,11 +3673,16 @@ QuicConnProcessPeerTransportParameters(
             QuicConnIndicateEvent(Connection, &Event);
         }
 
-        if (Connection->Settings.OneWayDelayEnabled) {
+        if (Connection->Settings->OneWayDelayEnabled) {
             Connection->State.TimestampSendNegotiated = // Peer wants to recv, so we can send
                 !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED);
             Connection->State.TimestampRecvNegotiated = // Peer wants to send, so we can recv
                 !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED);
+            Connection->State.ReceiveTimestampsSendNegotiated = // Peer wants receive timestamps
+                !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK) &&
+                Connection->PeerTransportParams.MaxReceiveTimestampsPerAck != 0;
+            Connection->State.ReceiveTimestampsRecvNegotiated = // Peer supports sending them
+                !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK);
 
             //
             // Send event to app to indicate result of negotiation if app cares.
@@ -3207,6 +3850,81 @@ QuicConnPeerCertReceived(
     return TRUE; // Treat pending as success to the TLS layer.
 }
 
+#ifndef _KERNEL_MODE // Receives are indicated at DISPATCH_LEVEL in kernel mode
+//
+// When short header packets are indicated on the thread that runs the
+// connection's worker (i.e. the worker shares its thread with the datapath)
+// and the connection is otherwise idle, process them right away instead of
+// round tripping through the operation queue. Returns FALSE if the packets
+// must be queued instead.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicConnTryRecvPacketsInline(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packets,
+    _In_ uint32_t PacketChainLength,
+    _In_ uint32_t PacketChainByteLength
+    )
+{
+    QUIC_WORKER* Worker = Connection->Worker;
+    if (!Packets->IsShortHeader ||
+        !Connection->State.HandshakeConfirmed ||
+        Connection->State.ShutdownComplete ||
+        Connection->State.UpdateWorker ||
+        Worker == NULL ||
+        Worker->ThreadID != CxPlatCurThreadID() ||
+        Connection->ReceiveQueueCount != 0 ||
+        !QuicWorkerTryClaimConnection(Worker, Connection)) {
+        return FALSE;
+    }
+
+    //
+    // Packets queued (by another thread) before the connection was claimed
+    // must be processed first.
+    //
+    CxPlatDispatchLockAcquire(&Connection->ReceiveQueueLock);
+    const BOOLEAN ReceiveQueueEmpty = Connection->ReceiveQueueCount == 0;
+    CxPlatDispatchLockRelease(&Connection->ReceiveQueueLock);
+    if (!ReceiveQueueEmpty) {
+        QuicWorkerReleaseClaimedConnection(Worker, Connection);
+        return FALSE;
+    }
+
+    QuicTraceLogConnVerbose(
+        RecvDatagramsInline,
+        Connection,
+        "Processing %u UDP datagrams inline",
+        PacketChainLength);
+
+    QuicConfigurationAttachSilo(Connection->Configuration);
+    Connection->WorkerThreadID = CxPlatCurThreadID();
+
+    QuicConnRecvDatagrams(
+        Connection, Packets, PacketChainLength, PacketChainByteLength, FALSE);
+    QuicWorkerFlushRecvData(Worker);
+    QuicSendBufferFillDeferred(Connection);
+
+    if (Connection->State.ProcessShutdownComplete) {
+        QuicConnOnShutdownComplete(Connection);
+    }
+    QuicStreamSetDrainClosedStreams(&Connection->Streams);
+    QuicConnValidate(Connection);
+
+    Connection->WorkerThreadID = 0;
+    QuicConfigurationDetachSilo();
+
+    //
+    // Anything the packets triggered (e.g. sending an ACK or the app's
+    // response) was queued as an operation, so hand the connection back to
+    // the worker for that.
+    //
+    QuicWorkerReleaseClaimedConnection(Worker, Connection);
+    return TRUE;
+}
+#endif
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicConnQueueRecvPackets(
@@ -3225,13 +3943,20 @@ QuicConnQueueRecvPackets(
         PacketsTail = (QUIC_RX_PACKET**)&((*PacketsTail)->Next);
     }
 
+#ifndef _KERNEL_MODE
+    if (QuicConnTryRecvPacketsInline(
+            Connection, Packets, PacketChainLength, PacketChainByteLength)) {
+        return;
+    }
+#endif
+
     //
     // Base the limit of queued packets on the connection-wide flow control, but
     // allow at least a few packets even if the app configured an extremely
     // tiny FC window.
     //
     const uint32_t QueueLimit =
-        CXPLAT_MAX(10, Connection->Settings.ConnFlowControlWindow >> 10);
+        CXPLAT_MAX(10, Connection->Settings->ConnFlowControlWindow >> 10);
 
     QuicTraceLogConnVerbose(
         QueueDatagrams,
@@ -3630,8 +4355,8 @@ QuicConnRecvRetry(
     // Cache the Retry token.
     //
 
-    Connection->Send.InitialToken = CXPLAT_ALLOC_PAGED(TokenLength, QUIC_POOL_INITIAL_TOKEN);
-    if (Connection->Send.InitialToken == NULL) {
+    uint8_t* InitialToken = QuicArenaAlloc(&Connection->HandshakeArena, TokenLength);
+    if (InitialToken == NULL) {
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
@@ -3641,8 +4366,9 @@ QuicConnRecvRetry(
         return;
     }
 
+    memcpy(InitialToken, Token, TokenLength);
+    Connection->Send.InitialToken = InitialToken;
     Connection->Send.InitialTokenLength = TokenLength;
-    memcpy((uint8_t*)Connection->Send.InitialToken, Token, TokenLength);
 
     //
     // Update the (destination) server's CID.
@@ -3877,7 +4603,7 @@ QuicConnRecvHeader(
                 Packet,
                 &TokenBuffer,
                 &TokenLength,
-                Connection->Settings.GreaseQuicBitEnabled)) {
+                Connection->Settings->GreaseQuicBitEnabled)) {
             return FALSE;
         }
 
@@ -3916,15 +4642,14 @@ QuicConnRecvHeader(
                 CXPLAT_DBG_ASSERT(Token.Encrypted.OrigConnIdLength <= sizeof(Token.Encrypted.OrigConnId));
                 CXPLAT_DBG_ASSERT(QuicAddrCompare(&Path->Route.RemoteAddress, &Token.Encrypted.RemoteAddress));
 
-                if (Connection->OrigDestCID != NULL) {
-                    CXPLAT_FREE(Connection->OrigDestCID, QUIC_POOL_CID);
-                }
-
+                //
+                // Any previous OrigDestCID is left to the handshake arena.
+                //
                 Connection->OrigDestCID =
-                    CXPLAT_ALLOC_NONPAGED(
+                    QuicArenaAlloc(
+                        &Connection->HandshakeArena,
                         sizeof(QUIC_CID) +
-                        Token.Encrypted.OrigConnIdLength,
-                        QUIC_POOL_CID);
+                        Token.Encrypted.OrigConnIdLength);
                 if (Connection->OrigDestCID == NULL) {
                     QuicTraceEvent(
                         AllocFailure,
@@ -3949,10 +4674,10 @@ QuicConnRecvHeader(
         if (Connection->OrigDestCID == NULL) {
 
             Connection->OrigDestCID =
-                CXPLAT_ALLOC_NONPAGED(
+                QuicArenaAlloc(
+                    &Connection->HandshakeArena,
                     sizeof(QUIC_CID) +
-                    Packet->DestCidLen,
-                    QUIC_POOL_CID);
+                    Packet->DestCidLen);
             if (Connection->OrigDestCID == NULL) {
                 QuicTraceEvent(
                     AllocFailure,
@@ -3980,7 +4705,7 @@ QuicConnRecvHeader(
     } else {
 
         if (!Packet->ValidatedHeaderVer &&
-            !QuicPacketValidateShortHeaderV1(Connection, Packet, Connection->Settings.GreaseQuicBitEnabled)) {
+            !QuicPacketValidateShortHeaderV1(Connection, Packet, Connection->Settings->GreaseQuicBitEnabled)) {
             return FALSE;
         }
 
@@ -4022,9 +4747,9 @@ QuicConnRecvHeader(
 }
 
 //
-// Decodes and decompresses the packet number. If necessary, updates the key
-// phase accordingly, to allow for decryption as the next step. Returns TRUE if
-// the packet should continue to be processed further.
+// Decodes and decompresses the packet number, to allow for key selection and
+// decryption as the next steps. Returns TRUE if the packet should continue to
+// be processed further.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
@@ -4113,10 +4838,41 @@ QuicConnRecvPrepareDecrypt(
         return FALSE;
     }
 
-    QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
-    if (Packet->IsShortHeader && EncryptLevel == QUIC_ENCRYPT_LEVEL_1_RTT &&
-        Packet->SH->KeyPhase != PacketSpace->CurrentKeyPhase) {
-        if (Packet->PacketNumber < PacketSpace->ReadKeyPhaseStartPacketNumber) {
+    return TRUE;
+}
+
+//
+// Returns TRUE if the packet's key phase bit doesn't match the current key
+// phase, meaning the read key to use depends on the current key phase state.
+//
+QUIC_INLINE
+BOOLEAN
+QuicConnRecvIsOtherKeyPhase(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ const QUIC_RX_PACKET* Packet
+    )
+{
+    return
+        Packet->IsShortHeader &&
+        Packet->KeyType == QUIC_PACKET_KEY_1_RTT &&
+        Packet->SH->KeyPhase != Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT]->CurrentKeyPhase;
+}
+
+//
+// If necessary, updates the packet's key type (and key phase) according to
+// its key phase bit. Returns TRUE if the packet should continue to be
+// processed further.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvSelectReadKey(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packet
+    )
+{
+    QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    if (QuicConnRecvIsOtherKeyPhase(Connection, Packet)) {
+        if (Packet->PacketNumber < PacketSpace->ReadKeyPhaseStartPacketNumber) {
             //
             // The packet doesn't match our current key phase and the packet number
             // is less than the start of the current key phase, so this is likely
@@ -4154,125 +4910,119 @@ QuicConnRecvPrepareDecrypt(
 }
 
 //
-// Decrypts the packet's payload and authenticates the whole packet. On
-// successful authentication of the packet, does some final processing of the
-// packet header (key and CID updates). Returns TRUE if the packet should
-// continue to be processed further.
+// Returns TRUE if the packet could be a stateless reset, in which case the end
+// of it needs to be saved before decryption is attempted, as a failed
+// decryption trashes the stateless reset token.
 //
-_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_INLINE
 BOOLEAN
-QuicConnRecvDecryptAndAuthenticate(
-    _In_ QUIC_CONNECTION* Connection,
-    _In_ QUIC_PATH* Path,
-    _In_ QUIC_RX_PACKET* Packet
+QuicConnRecvCanBeStatelessReset(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ const QUIC_RX_PACKET* Packet
     )
 {
-    CXPLAT_DBG_ASSERT(Packet->AvailBufferLength >= Packet->HeaderLength + Packet->PayloadLength);
-
-    const uint8_t* Payload = Packet->AvailBuffer + Packet->HeaderLength;
-
-    //
-    // We need to copy the end of the packet before trying decryption, as a
-    // failed decryption trashes the stateless reset token.
-    //
-    BOOLEAN CanCheckForStatelessReset = FALSE;
-    uint8_t PacketResetToken[QUIC_STATELESS_RESET_TOKEN_LENGTH];
-    if (QuicConnIsClient(Connection) &&
+    return
+        QuicConnIsClient(Connection) &&
         Packet->IsShortHeader &&
-        Packet->HeaderLength + Packet->PayloadLength >= QUIC_MIN_STATELESS_RESET_PACKET_LENGTH) {
-        CanCheckForStatelessReset = TRUE;
-        CxPlatCopyMemory(
-            PacketResetToken,
-            Payload + Packet->PayloadLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
-            QUIC_STATELESS_RESET_TOKEN_LENGTH);
-    }
-
-    CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
-
-    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
-    QuicCryptoCombineIvAndPacketNumber(
-        Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->Iv,
-        (uint8_t*)&Packet->PacketNumber,
-        Iv);
+        Packet->HeaderLength + Packet->PayloadLength >= QUIC_MIN_STATELESS_RESET_PACKET_LENGTH;
+}
 
+//
+// Handles a packet that failed decryption. Checks whether the packet is
+// actually a stateless reset (against the token saved before decryption) and
+// otherwise accounts for the decryption failure.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnRecvDecryptFailure(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_reads_(QUIC_STATELESS_RESET_TOKEN_LENGTH)
+        const uint8_t* PacketResetToken
+    )
+{
     //
-    // Decrypt the payload with the appropriate key.
+    // Check for a stateless reset packet.
     //
-    if (Packet->Encrypted) {
-        QuicTraceEvent(
-            PacketDecrypt,
-            "[pack][%llu] Decrypting",
-            Packet->PacketId);
-        if (QUIC_FAILED(
-            CxPlatDecrypt(
-                Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->PacketKey,
-                Iv,
-                Packet->HeaderLength,   // HeaderLength
-                Packet->AvailBuffer,    // Header
-                Packet->PayloadLength,  // BufferLength
-                (uint8_t*)Payload))) {  // Buffer
-
+    if (QuicConnRecvCanBeStatelessReset(Connection, Packet)) {
+        for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
+                Entry != &Connection->DestCids;
+                Entry = Entry->Flink) {
             //
-            // Check for a stateless reset packet.
+            // Loop through all our stored stateless reset tokens to see if
+            // we have a match.
             //
-            if (CanCheckForStatelessReset) {
-                for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
-                        Entry != &Connection->DestCids;
-                        Entry = Entry->Flink) {
-                    //
-                    // Loop through all our stored stateless reset tokens to see if
-                    // we have a match.
-                    //
-                    QUIC_CID_LIST_ENTRY* DestCid =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_LIST_ENTRY,
-                            Link);
-                    if (DestCid->CID.HasResetToken &&
-                        !DestCid->CID.Retired &&
-                        memcmp(
-                            DestCid->ResetToken,
-                            PacketResetToken,
-                            QUIC_STATELESS_RESET_TOKEN_LENGTH) == 0) {
-                        QuicTraceLogVerbose(
-                            PacketRxStatelessReset,
-                            "[S][RX][-] SR %s",
-                            QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
-                        QuicTraceLogConnInfo(
-                            RecvStatelessReset,
-                            Connection,
-                            "Received stateless reset");
-                        QuicConnCloseLocally(
-                            Connection,
-                            QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
-                            (uint64_t)QUIC_STATUS_ABORTED,
-                            NULL);
-                        return FALSE;
-                    }
-                }
-            }
-
-            if (QuicTraceLogVerboseEnabled()) {
-                QuicPacketLogHeader(
+            QUIC_CID_LIST_ENTRY* DestCid =
+                CXPLAT_CONTAINING_RECORD(
+                    Entry,
+                    QUIC_CID_LIST_ENTRY,
+                    Link);
+            if (DestCid->CID.HasResetToken &&
+                !DestCid->CID.Retired &&
+                memcmp(
+                    DestCid->ResetToken,
+                    PacketResetToken,
+                    QUIC_STATELESS_RESET_TOKEN_LENGTH) == 0) {
+                QuicTraceLogVerbose(
+                    PacketRxStatelessReset,
+                    "[S][RX][-] SR %s",
+                    QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
+                QuicTraceLogConnInfo(
+                    RecvStatelessReset,
                     Connection,
-                    TRUE,
-                    Connection->State.ShareBinding ? MsQuicLib.CidTotalLength : 0,
-                    Packet->PacketNumber,
-                    Packet->HeaderLength,
-                    Packet->AvailBuffer,
-                    Connection->Stats.QuicVersion);
-            }
-            Connection->Stats.Recv.DecryptionFailures++;
-            QuicPacketLogDrop(Connection, Packet, "Decryption failure");
-            QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL);
-            if (Connection->Stats.Recv.DecryptionFailures >= CXPLAT_AEAD_INTEGRITY_LIMIT) {
-                QuicConnTransportError(Connection, QUIC_ERROR_AEAD_LIMIT_REACHED);
+                    "Received stateless reset");
+                QuicConnCloseLocally(
+                    Connection,
+                    QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
+                    (uint64_t)QUIC_STATUS_ABORTED,
+                    NULL);
+                return;
             }
-
-            return FALSE;
         }
     }
 
+    if (QuicTraceLogVerboseEnabled()) {
+        QuicPacketLogHeader(
+            Connection,
+            TRUE,
+            Connection->State.ShareBinding ? MsQuicLib.CidTotalLength : 0,
+            Packet->PacketNumber,
+            Packet->HeaderLength,
+            Packet->AvailBuffer,
+            Connection->Stats.QuicVersion);
+    }
+    Connection->Stats.Recv.DecryptionFailures++;
+    QuicTraceProbe(decrypt_failed, Connection, Packet->PacketNumber);
+    QuicPacketLogDrop(Connection, Packet, "Decryption failure");
+    QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL);
+    if (Connection->Stats.Recv.DecryptionFailures >= CXPLAT_AEAD_INTEGRITY_LIMIT) {
+        QuicConnTransportError(Connection, QUIC_ERROR_AEAD_LIMIT_REACHED);
+    }
+}
+
+//
+// The state of each packet of a receive batch, after the decryption stage.
+//
+typedef enum QUIC_RECV_DECRYPT_STATE {
+    QUIC_RECV_DECRYPT_PENDING,
+    QUIC_RECV_DECRYPT_AUTHENTICATED,
+    QUIC_RECV_DECRYPT_FAILED,   // Failure is handled when the packet is processed.
+    QUIC_RECV_DECRYPT_DROPPED   // Already dropped.
+} QUIC_RECV_DECRYPT_STATE;
+
+//
+// Authenticates a successfully decrypted packet and does some final processing
+// of the packet header (key and CID updates). Returns TRUE if the packet
+// should continue to be processed further.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvAuthenticate(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ QUIC_RX_PACKET* Packet
+    )
+{
     Connection->Stats.Recv.ValidPackets++;
 
     //
@@ -4359,6 +5109,14 @@ QuicConnRecvDecryptAndAuthenticate(
         Packet->PacketNumber,
         Packet->IsShortHeader ? QUIC_TRACE_PACKET_ONE_RTT : (Packet->LH->Type + 1),
         Packet->HeaderLength + Packet->PayloadLength);
+    QuicTraceProbe(
+        packet_decrypted,
+        Connection,
+        Packet->PacketNumber,
+        Packet->HeaderLength + Packet->PayloadLength);
+    if (Connection->State.QlogEnabled) {
+        QuicQlogOnPacketReceived(Connection, Packet);
+    }
 
     //
     // Process any connection ID updates as necessary.
@@ -4431,6 +5189,223 @@ QuicConnRecvDecryptAndAuthenticate(
     return TRUE;
 }
 
+//
+// The ranges of stream data decrypted straight into app-owned receive buffers
+// in a receive batch. Placed ranges must not overlap each other, so that a
+// packet failing authentication can't corrupt the data placed by another one.
+//
+typedef struct QUIC_RECV_PLACEMENTS {
+    uint8_t Count;
+    struct {
+        uint64_t StreamId;
+        uint64_t Offset;
+        uint16_t Length;
+    } Ranges[QUIC_MAX_CRYPTO_BATCH_COUNT];
+} QUIC_RECV_PLACEMENTS;
+
+//
+// Looks at the start of a packet's payload for a STREAM frame whose data can
+// be decrypted straight into the stream's app-owned receive buffer, saving the
+// copy out of the packet when the frame is processed. Only the first frame is
+// considered, which is where the data is in bulk transfers. None of this is
+// trusted until the packet is authenticated; until then, only buffer space
+// the app can't read yet is written to.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnRecvPlaceStreamData(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PACKET_KEY* Key,
+    _In_ QUIC_RX_PACKET* Packet,
+    _Inout_ QUIC_RECV_PLACEMENTS* Placements,
+    _Out_writes_(QUIC_MAX_RECV_PLACEMENT_SEGMENTS)
+        CXPLAT_CRYPT_SEGMENT* Segments,
+    _Inout_ CXPLAT_CRYPT_PACKET* CryptPacket
+    )
+{
+    uint8_t Prefix[sizeof(uint8_t) + 3 * sizeof(uint64_t)]; // Max STREAM frame header
+    const uint16_t PayloadLength = Packet->PayloadLength - CXPLAT_ENCRYPTION_OVERHEAD;
+
+    if (PayloadLength < QUIC_MIN_RECV_PLACEMENT_LENGTH ||
+        QUIC_FAILED(
+        CxPlatDecryptPrefix(
+            Key->PacketKey,
+            CryptPacket->Iv,
+            sizeof(Prefix),
+            CryptPacket->Buffer,
+            Prefix))) {
+        return;
+    }
+
+    uint16_t Offset = 0;
+    QUIC_VAR_INT FrameType;
+    QUIC_VAR_INT StreamId;
+    QUIC_VAR_INT StreamOffset = 0;
+    QUIC_VAR_INT Length;
+    if (!QuicVarIntDecode(sizeof(Prefix), Prefix, &Offset, &FrameType) ||
+        FrameType < QUIC_FRAME_STREAM || FrameType > QUIC_FRAME_STREAM_7) {
+        return;
+    }
+    QUIC_STREAM_FRAME_TYPE Type = { .Type = (uint8_t)FrameType };
+    if (!QuicVarIntDecode(sizeof(Prefix), Prefix, &Offset, &StreamId) ||
+        (Type.OFF && !QuicVarIntDecode(sizeof(Prefix), Prefix, &Offset, &StreamOffset))) {
+        return;
+    }
+    if (Type.LEN) {
+        if (!QuicVarIntDecode(sizeof(Prefix), Prefix, &Offset, &Length) ||
+            Length > (uint64_t)(PayloadLength - Offset)) {
+            return;
+        }
+    } else {
+        Length = PayloadLength - Offset;
+    }
+    if (Length < QUIC_MIN_RECV_PLACEMENT_LENGTH) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < Placements->Count; ++i) {
+        if (Placements->Ranges[i].StreamId == StreamId &&
+            Placements->Ranges[i].Offset < StreamOffset + Length &&
+            StreamOffset < Placements->Ranges[i].Offset + Placements->Ranges[i].Length) {
+            return;
+        }
+    }
+
+    QUIC_STREAM* Stream = QuicStreamSetLookupStream(&Connection->Streams, StreamId);
+    QUIC_BUFFER Buffers[QUIC_MAX_RECV_PLACEMENT_SEGMENTS];
+    uint32_t BufferCount = ARRAYSIZE(Buffers);
+    if (Stream == NULL ||
+        !QuicStreamRecvGetPlacement(
+            Stream, StreamOffset, (uint16_t)Length, &BufferCount, Buffers)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        Segments[i].Destination = Buffers[i].Buffer;
+        Segments[i].Offset = Offset;
+        Segments[i].Length = (uint16_t)Buffers[i].Length;
+        Offset += (uint16_t)Buffers[i].Length;
+    }
+    CryptPacket->Segments = Segments;
+    CryptPacket->SegmentCount = (uint8_t)BufferCount;
+
+    Packet->PlacedStreamDataOffset = Segments[0].Offset;
+    Packet->PlacedStreamDataLength = (uint16_t)Length;
+
+    Placements->Ranges[Placements->Count].StreamId = StreamId;
+    Placements->Ranges[Placements->Count].Offset = StreamOffset;
+    Placements->Ranges[Placements->Count].Length = (uint16_t)Length;
+    Placements->Count++;
+}
+
+//
+// Decrypts the payloads of a run of prepared packets (skipping any already
+// dropped), all protected with the same key, in one batch and then
+// authenticates each of them in order. Packets that fail decryption are only
+// marked as such here, with the end of the packet saved to 'ResetTokens' if it
+// may be a stateless reset. Stream data may be decrypted straight into
+// app-owned receive buffers.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnRecvDecryptAndAuthenticate(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ uint8_t RunCount,
+    _In_reads_(RunCount) QUIC_RX_PACKET** Packets,
+    _Inout_updates_(RunCount) QUIC_RECV_DECRYPT_STATE* States,
+    _Out_writes_(RunCount * QUIC_STATELESS_RESET_TOKEN_LENGTH)
+        uint8_t* ResetTokens,
+    _Inout_ QUIC_RECV_PLACEMENTS* Placements
+    )
+{
+    CXPLAT_CRYPT_PACKET CryptPackets[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    CXPLAT_CRYPT_SEGMENT Segments[QUIC_MAX_CRYPTO_BATCH_COUNT][QUIC_MAX_RECV_PLACEMENT_SEGMENTS];
+    QUIC_STATUS Results[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t Ivs[QUIC_MAX_CRYPTO_BATCH_COUNT][CXPLAT_MAX_IV_LENGTH];
+    QUIC_PACKET_KEY* Key = NULL;
+    uint8_t CryptCount = 0;
+
+    CXPLAT_DBG_ASSERT(RunCount <= QUIC_MAX_CRYPTO_BATCH_COUNT);
+
+    for (uint8_t i = 0; i < RunCount; ++i) {
+        if (States[i] != QUIC_RECV_DECRYPT_PENDING) {
+            continue;
+        }
+
+        QUIC_RX_PACKET* Packet = Packets[i];
+        CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
+        CXPLAT_DBG_ASSERT(Packet->AvailBufferLength >= Packet->HeaderLength + Packet->PayloadLength);
+        CXPLAT_DBG_ASSERT(Key == NULL || Key == Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]);
+        Key = Connection->Crypto.TlsState.ReadKeys[Packet->KeyType];
+        Packet->PlacedStreamDataLength = 0;
+
+        if (!Packet->Encrypted) {
+            continue;
+        }
+
+        uint8_t* Payload = (uint8_t*)Packet->AvailBuffer + Packet->HeaderLength;
+        if (QuicConnRecvCanBeStatelessReset(Connection, Packet)) {
+            CxPlatCopyMemory(
+                ResetTokens + i * QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                Payload + Packet->PayloadLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                QUIC_STATELESS_RESET_TOKEN_LENGTH);
+        }
+
+        QuicCryptoCombineIvAndPacketNumber(
+            Key->Iv,
+            (uint8_t*)&Packet->PacketNumber,
+            Ivs[CryptCount]);
+
+        QuicTraceEvent(
+            PacketDecrypt,
+            "[pack][%llu] Decrypting",
+            Packet->PacketId);
+
+        CXPLAT_CRYPT_PACKET* CryptPacket = &CryptPackets[CryptCount++];
+        CryptPacket->Iv = Ivs[CryptCount - 1];
+        CryptPacket->AuthData = Packet->AvailBuffer;
+        CryptPacket->AuthDataLength = Packet->HeaderLength;
+        CryptPacket->Buffer = Payload;
+        CryptPacket->BufferLength = Packet->PayloadLength;
+        CryptPacket->Segments = NULL;
+        CryptPacket->SegmentCount = 0;
+
+        if (Packet->IsShortHeader && Connection->State.AppOwnedRecvBuffers) {
+            QuicConnRecvPlaceStreamData(
+                Connection,
+                Key,
+                Packet,
+                Placements,
+                Segments[CryptCount - 1],
+                CryptPacket);
+        }
+    }
+
+    if (CryptCount != 0) {
+        //
+        // The per-packet results are checked below.
+        //
+        (void)CxPlatDecryptBatch(Key->PacketKey, CryptCount, CryptPackets, Results);
+    }
+
+    CryptCount = 0;
+    for (uint8_t i = 0; i < RunCount; ++i) {
+        if (States[i] != QUIC_RECV_DECRYPT_PENDING) {
+            continue;
+        }
+
+        QUIC_RX_PACKET* Packet = Packets[i];
+        if (Packet->Encrypted && QUIC_FAILED(Results[CryptCount++])) {
+            States[i] = QUIC_RECV_DECRYPT_FAILED;
+        } else if (QuicConnRecvAuthenticate(Connection, Path, Packet)) {
+            States[i] = QUIC_RECV_DECRYPT_AUTHENTICATED;
+        } else {
+            States[i] = QUIC_RECV_DECRYPT_DROPPED;
+        }
+    }
+}
+
 //
 // Reads the frames in a packet, and if everything is successful marks the
 // packet for acknowledgement and returns TRUE.
@@ -4537,6 +5512,7 @@ QuicConnRecvFrames(
             //
             case QUIC_FRAME_ACK:
             case QUIC_FRAME_ACK_1:
+            case QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS:
             case QUIC_FRAME_HANDSHAKE_DONE:
                 QuicTraceEvent(
                     ConnErrorStatus,
@@ -4578,7 +5554,18 @@ QuicConnRecvFrames(
         }
 
         case QUIC_FRAME_ACK:
-        case QUIC_FRAME_ACK_1: {
+        case QUIC_FRAME_ACK_1:
+        case QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS: {
+            if (FrameType == QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS &&
+                !Connection->State.ReceiveTimestampsRecvNegotiated) {
+                QuicTraceEvent(
+                    ConnError,
+                    "[conn][%p] ERROR, %s.",
+                    Connection,
+                    "Received ACK_RECEIVE_TIMESTAMPS frame when not negotiated");
+                QuicConnTransportError(Connection, QUIC_ERROR_PROTOCOL_VIOLATION);
+                return FALSE;
+            }
             BOOLEAN InvalidAckFrame;
             if (!QuicLossDetectionProcessAckFrame(
                     &Connection->LossDetection,
@@ -4751,6 +5738,17 @@ QuicConnRecvFrames(
                 }
             }
 
+            if (Connection->RecvRun.Stream != NULL &&
+                (Connection->RecvRun.Stream->ID != StreamId ||
+                 FrameType < QUIC_FRAME_STREAM ||
+                 FrameType > QUIC_FRAME_STREAM_7)) {
+                //
+                // Only STREAM frames for the same stream may be added to the
+                // pending receive run, so write it out before anything else.
+                //
+                QuicStreamRecvRunFlush(&Connection->RecvRun);
+            }
+
             BOOLEAN FatalError;
             QUIC_STREAM* Stream =
                 QuicStreamSetGetStreamForPeer(
@@ -4949,9 +5947,8 @@ QuicConnRecvFrames(
                 (Frame.BidirectionalStreams ?
                  STREAM_ID_FLAG_IS_BI_DIR : STREAM_ID_FLAG_IS_UNI_DIR);
 
-            const QUIC_STREAM_TYPE_INFO* Info = &Connection->Streams.Types[Type];
-
-            if (Info->MaxTotalStreamCount > Frame.StreamLimit) {
+            if (!QuicStreamSetOnPeerStreamsBlocked(
+                    &Connection->Streams, Type, Frame.StreamLimit)) {
                 break;
             }
 
@@ -5150,11 +6147,26 @@ QuicConnRecvFrames(
             CXPLAT_DBG_ASSERT(Connection->PathsCount <= QUIC_MAX_PATH_COUNT);
             for (uint8_t i = 0; i < Connection->PathsCount; ++i) {
                 QUIC_PATH* TempPath = &Connection->Paths[i];
-                if (!TempPath->IsPeerValidated &&
+                if ((!TempPath->IsPeerValidated || TempPath->StandbyProbePending) &&
                     !memcmp(Frame.Data, TempPath->Challenge, sizeof(Frame.Data))) {
-                    QuicPerfCounterIncrement(
-                        Connection->Partition, QUIC_PERF_COUNTER_PATH_VALIDATED);
-                    QuicPathSetValid(Connection, TempPath, QUIC_PATH_VALID_PATH_RESPONSE);
+                    if (TempPath->IsStandby) {
+                        //
+                        // Standby paths carry no other traffic, so their
+                        // challenges are their only source of RTT samples.
+                        //
+                        QuicConnUpdateRtt(
+                            Connection,
+                            TempPath,
+                            CxPlatTimeDiff64(TempPath->ChallengeSentTime, CxPlatTimeUs64()),
+                            UINT64_MAX,
+                            UINT64_MAX);
+                        TempPath->StandbyProbePending = FALSE;
+                    }
+                    if (!TempPath->IsPeerValidated) {
+                        QuicPerfCounterIncrement(
+                            Connection->Partition, QUIC_PERF_COUNTER_PATH_VALIDATED);
+                        QuicPathSetValid(Connection, TempPath, QUIC_PATH_VALID_PATH_RESPONSE);
+                    }
                     break;
                 }
             }
@@ -5247,7 +6259,7 @@ QuicConnRecvFrames(
 
         case QUIC_FRAME_DATAGRAM:
         case QUIC_FRAME_DATAGRAM_1: {
-            if (!Connection->Settings.DatagramReceiveEnabled) {
+            if (!Connection->Settings->DatagramReceiveEnabled) {
                 QuicTraceEvent(
                     ConnError,
                     "[conn][%p] ERROR, %s.",
@@ -5308,12 +6320,12 @@ QuicConnRecvFrames(
 
             Connection->NextRecvAckFreqSeqNum = Frame.SequenceNumber + 1;
             if (Frame.RequestedMaxAckDelay == 0) {
-                Connection->Settings.MaxAckDelayMs = 0;
+                Connection->MaxAckDelayMs = 0;
             } else if (Frame.RequestedMaxAckDelay < 1000) {
-                Connection->Settings.MaxAckDelayMs = 1;
+                Connection->MaxAckDelayMs = 1;
             } else {
                 CXPLAT_DBG_ASSERT(US_TO_MS(Frame.RequestedMaxAckDelay) <= UINT32_MAX);
-                Connection->Settings.MaxAckDelayMs = (uint32_t)US_TO_MS(Frame.RequestedMaxAckDelay);
+                Connection->MaxAckDelayMs = (uint32_t)US_TO_MS(Frame.RequestedMaxAckDelay);
             }
             if (Frame.AckElicitingThreshold < UINT8_MAX) {
                 Connection->PacketTolerance = (uint8_t)Frame.AckElicitingThreshold;
@@ -5402,10 +6414,19 @@ Done:
             AckType = QUIC_ACK_TYPE_NON_ACK_ELICITING;
         }
 
+        //
+        // Prefer the datapath's receive time so that the time the packet spent
+        // queued for the worker is included in the reported ACK delay.
+        //
+        uint64_t AckRecvTime = RecvTime;
+        if (Packet->RecvTime != 0 && CxPlatTimeAtOrBefore64(Packet->RecvTime, RecvTime)) {
+            AckRecvTime = Packet->RecvTime;
+        }
+
         QuicAckTrackerAckPacket(
             &Connection->Packets[EncryptLevel]->AckTracker,
             Packet->PacketNumber,
-            RecvTime,
+            AckRecvTime,
             ECN,
             AckType);
     }
@@ -5446,7 +6467,7 @@ QuicConnRecvPostProcessing(
     if (!(*Path)->GotValidPacket) {
         (*Path)->GotValidPacket = TRUE;
 
-        if (!(*Path)->IsActive) {
+        if (!(*Path)->IsActive && !(*Path)->IsStandby) {
 
             //
             // This is the first valid packet received on this non-active path.
@@ -5520,7 +6541,8 @@ QuicConnRecvPostProcessing(
 
     if (Packet->HasNonProbingFrame &&
         Packet->NewLargestPacketNumber &&
-        !(*Path)->IsActive) {
+        !(*Path)->IsActive &&
+        !(*Path)->IsStandby) {
         //
         // The peer has sent a non-probing frame on a path other than the active
         // one. This signals their intent to switch active paths.
@@ -5543,6 +6565,51 @@ QuicConnRecvPostProcessing(
             "Indicating QUIC_CONNECTION_EVENT_PEER_ADDRESS_CHANGED");
         (void)QuicConnIndicateEvent(Connection, &Event);
     }
+
+    if ((*Path)->IsPreferredAddress && (*Path)->IsPeerValidated) {
+        //
+        // The server's preferred address answered our challenge. Move over to
+        // it and drop the path to the address the handshake used.
+        //
+        const uint8_t PathIndex = (uint8_t)(*Path - Connection->Paths);
+        (*Path)->IsPreferredAddress = FALSE;
+        QuicPathSetActive(Connection, *Path);
+        QUIC_PATH* OldPath = &Connection->Paths[PathIndex];
+        if (OldPath->DestCid->CID.Length != 0) {
+            QUIC_CID_CLEAR_PATH(OldPath->DestCid);
+            QuicConnRetireCid(Connection, OldPath->DestCid);
+            OldPath->DestCid = NULL;
+        }
+        QuicPathRemove(Connection, PathIndex); // Releases the old binding.
+        *Path = &Connection->Paths[0];
+    }
+}
+
+//
+// Called when the peer's spin bit changes on the active path. The spin bit
+// flips once per round trip, so the time between edges is an RTT sample, taken
+// without any extra state in the packets themselves.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnOnSpinBitEdge(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t RecvTime
+    )
+{
+    const uint64_t TimeNow = RecvTime != 0 ? RecvTime : CxPlatTimeUs64();
+    if (Connection->SpinRtt.LastEdgeTime != 0) {
+        const uint64_t Sample =
+            CxPlatTimeDiff64(Connection->SpinRtt.LastEdgeTime, TimeNow);
+        Connection->SpinRtt.Latest = (uint32_t)CXPLAT_MIN(Sample, UINT32_MAX);
+        if (Connection->SpinRtt.SampleCount == 0 ||
+            Connection->SpinRtt.Latest < Connection->SpinRtt.Min) {
+            Connection->SpinRtt.Min = Connection->SpinRtt.Latest;
+        }
+        Connection->SpinRtt.SampleCount++;
+    }
+    Connection->SpinRtt.LastEdgeTime = TimeNow;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -5573,6 +6640,13 @@ QuicConnRecvDatagramBatch(
         return;
     }
 
+    if (Connection->State.HappyEyeballsRacing &&
+        !Path->GotValidPacket &&
+        QuicConnGetHappyEyeballsWinner(Connection) != NULL) {
+        QuicPacketLogDrop(Connection, Packet, "Lost happy eyeballs race");
+        return;
+    }
+
     if (Packet->Encrypted &&
         Connection->State.HeaderProtectionEnabled) {
         if (QUIC_FAILED(
@@ -5588,47 +6662,155 @@ QuicConnRecvDatagramBatch(
         CxPlatZeroMemory(HpMask, BatchCount * CXPLAT_HP_SAMPLE_LENGTH);
     }
 
+    //
+    // The batch is processed in two stages: first all the packets are
+    // unprotected and decrypted, and then the frames of all the authenticated
+    // packets are processed. Packets are decrypted in runs protected with the
+    // same key. Key selection depends on the key phase state updated by
+    // authentication, so a run is finished before selecting the key of any
+    // packet not in the current key phase, and right after a packet that
+    // (possibly) updates the key phase.
+    //
+    // Packet numbers are decompressed against the largest packet number
+    // processed before the batch. Since nothing in the batch could have been
+    // acknowledged yet, the peer must have encoded them to be decodable
+    // against it.
+    //
+    QUIC_RECV_DECRYPT_STATE States[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t ResetTokens[QUIC_STATELESS_RESET_TOKEN_LENGTH * QUIC_MAX_CRYPTO_BATCH_COUNT];
+    QUIC_RECV_PLACEMENTS Placements;
+    Placements.Count = 0;
+    uint8_t RunStart = 0;
+
     for (uint8_t i = 0; i < BatchCount; ++i) {
         CXPLAT_DBG_ASSERT(Packets[i]->Allocated);
-        CXPLAT_ECN_TYPE ECN = CXPLAT_ECN_FROM_TOS(Packets[i]->TypeOfService);
         Packet = Packets[i];
         CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
+        States[i] = QUIC_RECV_DECRYPT_DROPPED;
+
         if (!QuicConnRecvPrepareDecrypt(
-                Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH) ||
-            !QuicConnRecvDecryptAndAuthenticate(Connection, Path, Packet)) {
-            if (Connection->State.CompatibleVerNegotiationAttempted &&
-                !Connection->State.CompatibleVerNegotiationCompleted) {
-                //
-                // The packet which initiated compatible version negotation failed
-                // decryption, so undo the version change.
-                //
-                Connection->Stats.QuicVersion = Connection->OriginalQuicVersion;
-                Connection->State.CompatibleVerNegotiationAttempted = FALSE;
-            }
-        } else if (QuicConnRecvFrames(Connection, Path, Packet, ECN)) {
+                Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH)) {
+            continue;
+        }
 
-            QuicConnRecvPostProcessing(Connection, &Path, Packet);
-            RecvState->ResetIdleTimeout |= Packet->CompletelyValid;
+        if (RunStart < i &&
+            (QuicConnRecvIsOtherKeyPhase(Connection, Packet) ||
+             Packets[RunStart]->KeyType != Packet->KeyType)) {
+            QuicConnRecvDecryptAndAuthenticate(
+                Connection,
+                Path,
+                i - RunStart,
+                Packets + RunStart,
+                States + RunStart,
+                ResetTokens + RunStart * QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                &Placements);
+            RunStart = i;
+        }
 
-            if (Connection->Registration != NULL && !Connection->Registration->NoPartitioning &&
-                !Path->Binding->Partitioned && !Connection->State.Partitioned && Path->IsActive &&
-                !Path->PartitionUpdated && Packet->CompletelyValid &&
-                (Packets[i]->PartitionIndex % MsQuicLib.PartitionCount) != RecvState->PartitionIndex) {
-                RecvState->PartitionIndex = Packets[i]->PartitionIndex % MsQuicLib.PartitionCount;
-                RecvState->UpdatePartitionId = TRUE;
-                Path->PartitionUpdated = TRUE;
-            }
+        if (!QuicConnRecvSelectReadKey(Connection, Packet)) {
+            continue;
+        }
+
+        if (RunStart < i && Packets[RunStart]->KeyType != Packet->KeyType) {
+            QuicConnRecvDecryptAndAuthenticate(
+                Connection,
+                Path,
+                i - RunStart,
+                Packets + RunStart,
+                States + RunStart,
+                ResetTokens + RunStart * QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                &Placements);
+            RunStart = i;
+        }
 
-            if (Packet->IsShortHeader && Packet->NewLargestPacketNumber) {
+        States[i] = QUIC_RECV_DECRYPT_PENDING;
 
-                if (QuicConnIsServer(Connection)) {
-                    Path->SpinBit = Packet->SH->SpinBit;
-                } else {
-                    Path->SpinBit = !Packet->SH->SpinBit;
+        if (Packet->KeyType == QUIC_PACKET_KEY_1_RTT_NEW) {
+            QuicConnRecvDecryptAndAuthenticate(
+                Connection,
+                Path,
+                i + 1 - RunStart,
+                Packets + RunStart,
+                States + RunStart,
+                ResetTokens + RunStart * QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                &Placements);
+            RunStart = i + 1;
+        }
+    }
+
+    if (RunStart < BatchCount) {
+        QuicConnRecvDecryptAndAuthenticate(
+            Connection,
+            Path,
+            BatchCount - RunStart,
+            Packets + RunStart,
+            States + RunStart,
+            ResetTokens + RunStart * QUIC_STATELESS_RESET_TOKEN_LENGTH,
+            &Placements);
+    }
+
+    for (uint8_t i = 0; i < BatchCount; ++i) {
+        CXPLAT_ECN_TYPE ECN = CXPLAT_ECN_FROM_TOS(Packets[i]->TypeOfService);
+        Packet = Packets[i];
+        if (States[i] != QUIC_RECV_DECRYPT_AUTHENTICATED) {
+            if (States[i] == QUIC_RECV_DECRYPT_FAILED) {
+                QuicConnRecvDecryptFailure(
+                    Connection,
+                    Packet,
+                    ResetTokens + i * QUIC_STATELESS_RESET_TOKEN_LENGTH);
+            }
+            if (Connection->State.CompatibleVerNegotiationAttempted &&
+                !Connection->State.CompatibleVerNegotiationCompleted) {
+                //
+                // The packet which initiated compatible version negotation failed
+                // decryption, so undo the version change.
+                //
+                Connection->Stats.QuicVersion = Connection->OriginalQuicVersion;
+                Connection->State.CompatibleVerNegotiationAttempted = FALSE;
+            }
+        } else if (QuicConnRecvFrames(Connection, Path, Packet, ECN)) {
+
+            QuicConnRecvPostProcessing(Connection, &Path, Packet);
+            RecvState->ResetIdleTimeout |= Packet->CompletelyValid;
+
+            if (Connection->Registration != NULL && !Connection->Registration->NoPartitioning &&
+                !Path->Binding->Partitioned && !Connection->State.Partitioned && Path->IsActive &&
+                !Path->PartitionUpdated && Packet->CompletelyValid &&
+                (MsQuicLib.RssPartitioning.Config != NULL || !MsQuicLib.EnableSoftwareRss)) {
+                const uint16_t PartitionIndex = QuicLibraryGetPacketPartitionIndex(Packets[i]);
+                if (PartitionIndex != RecvState->PartitionIndex) {
+                    RecvState->PartitionIndex = PartitionIndex;
+                    RecvState->UpdatePartitionId = TRUE;
+                    Path->PartitionUpdated = TRUE;
+                } else if (MsQuicLib.RssPartitioning.Config != NULL) {
+                    //
+                    // The RSS partition only depends on the path's 4-tuple, so
+                    // it doesn't need to be checked again.
+                    //
+                    Path->PartitionUpdated = TRUE;
+                }
+            }
+
+            if (Packet->IsShortHeader && Packet->NewLargestPacketNumber &&
+                !Path->SpinBitDisabled) {
+
+                const BOOLEAN SpinBit =
+                    QuicConnIsServer(Connection) ?
+                        Packet->SH->SpinBit : !Packet->SH->SpinBit;
+                if (SpinBit != Path->SpinBit) {
+                    Path->SpinBit = SpinBit;
+                    if (Path->IsActive) {
+                        QuicConnOnSpinBitEdge(Connection, Packet->RecvTime);
+                    }
                 }
             }
         }
     }
+
+    //
+    // Write any STREAM frame data the batch left pending.
+    //
+    QuicStreamRecvRunFlush(&Connection->RecvRun);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -5747,6 +6929,7 @@ QuicConnRecvDatagrams(
                 Packet->AvailBufferLength =
                     Packet->BufferLength - (uint16_t)(Packet->AvailBuffer - Packet->Buffer);
             }
+            QuicTraceProbe(packet_recv, Connection, Packet->AvailBufferLength);
 
             if (!QuicConnRecvHeader(
                     Connection,
@@ -5840,7 +7023,11 @@ QuicConnRecvDatagrams(
                         &RecvState);
                     BatchCount = 0;
                 }
-                CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+                QuicWorkerReturnRecvData(
+                    Connection->Worker,
+                    (CXPLAT_RECV_DATA*)ReleaseChain,
+                    (CXPLAT_RECV_DATA**)ReleaseChainTail,
+                    ReleaseChainCount);
                 ReleaseChain = NULL;
                 ReleaseChainTail = &ReleaseChain;
                 ReleaseChainCount = 0;
@@ -5859,6 +7046,11 @@ QuicConnRecvDatagrams(
         BatchCount = 0; // cppcheck-suppress unreadVariable; NOLINT
     }
 
+    if (Connection->State.HappyEyeballsPending ||
+        Connection->State.HappyEyeballsRacing) {
+        QuicConnCompleteHappyEyeballs(Connection);
+    }
+
     if (Connection->State.DelayedApplicationError && Connection->CloseStatus == 0) {
         //
         // We received transport APPLICATION_ERROR, but didn't receive the expected
@@ -5873,12 +7065,24 @@ QuicConnRecvDatagrams(
             (uint16_t)0);
     }
 
+    if (Connection->PeerStreamsStartedCount != 0) {
+        //
+        // Tell the app about all the peer streams the datagrams started at
+        // once.
+        //
+        QuicStreamSetIndicatePeerStreamsStarted(&Connection->Streams);
+    }
+
     if (RecvState.ResetIdleTimeout) {
         QuicConnResetIdleTimeout(Connection);
     }
 
     if (ReleaseChain != NULL) {
-        CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+        QuicWorkerReturnRecvData(
+            Connection->Worker,
+            (CXPLAT_RECV_DATA*)ReleaseChain,
+            (CXPLAT_RECV_DATA**)ReleaseChainTail,
+            ReleaseChainCount);
     }
 
     if (QuicConnIsServer(Connection) &&
@@ -6136,12 +7340,12 @@ QuicConnResetIdleTimeout(
         //
         IdleTimeoutMs = Connection->PeerTransportParams.IdleTimeout;
         if (IdleTimeoutMs == 0 ||
-            (Connection->Settings.IdleTimeoutMs != 0 &&
-             Connection->Settings.IdleTimeoutMs < IdleTimeoutMs)) {
-            IdleTimeoutMs = Connection->Settings.IdleTimeoutMs;
+            (Connection->Settings->IdleTimeoutMs != 0 &&
+             Connection->Settings->IdleTimeoutMs < IdleTimeoutMs)) {
+            IdleTimeoutMs = Connection->Settings->IdleTimeoutMs;
         }
     } else {
-        IdleTimeoutMs = Connection->Settings.HandshakeIdleTimeoutMs;
+        IdleTimeoutMs = Connection->Settings->HandshakeIdleTimeoutMs;
     }
 
     if (IdleTimeoutMs != 0) {
@@ -6168,12 +7372,62 @@ QuicConnResetIdleTimeout(
         QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_IDLE);
     }
 
-    if (Connection->Settings.KeepAliveIntervalMs != 0) {
+    if (Connection->Settings->KeepAliveIntervalMs != 0) {
         QuicConnTimerSet(
             Connection,
             QUIC_CONN_TIMER_KEEP_ALIVE,
-            MS_TO_US(Connection->Settings.KeepAliveIntervalMs));
+            MS_TO_US(Connection->Settings->KeepAliveIntervalMs));
+    }
+
+    if (Connection->State.Hibernating) {
+        //
+        // Nothing to rehydrate explicitly; the ranges and buffers grow back
+        // on demand.
+        //
+        Connection->State.Hibernating = FALSE;
+        QuicPerfCounterDecrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_HIBERNATING);
+    }
+
+    if (Connection->State.Connected && Connection->Settings->HibernateTimeoutMs != 0) {
+        QuicConnTimerSet(
+            Connection,
+            QUIC_CONN_TIMER_HIBERNATE,
+            MS_TO_US(Connection->Settings->HibernateTimeoutMs));
+    }
+}
+
+//
+// Releases the memory an idle connection doesn't need right now: ACK ranges
+// grown by past reordering or loss and empty receive buffers grown by past
+// bursts are shrunk back to their initial sizes. All state needed to resume
+// is kept, so the connection doesn't need to do anything special on wake up.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnHibernate(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (QuicConnIsClosed(Connection) || Connection->State.Hibernating) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < ARRAYSIZE(Connection->Packets); ++i) {
+        if (Connection->Packets[i] != NULL) {
+            QuicAckTrackerCompact(&Connection->Packets[i]->AckTracker);
+        }
+    }
+    QuicRangeCompact(&Connection->DecodedAckRanges);
+    QuicStreamSetHibernate(&Connection->Streams);
+    if (Connection->State.HandshakeConfirmed) {
+        QuicRecvBufferShrink(
+            &Connection->Crypto.RecvBuffer,
+            QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE);
     }
+
+    Connection->State.Hibernating = TRUE;
+    QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_HIBERNATING);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -6210,7 +7464,174 @@ QuicConnProcessKeepAliveOperation(
     QuicConnTimerSet(
         Connection,
         QUIC_CONN_TIMER_KEEP_ALIVE,
-        MS_TO_US(Connection->Settings.KeepAliveIntervalMs));
+        MS_TO_US(Connection->Settings->KeepAliveIntervalMs));
+}
+
+//
+// Creates a standby path, with its own binding, and starts validating it in
+// the background, so the connection can later switch over to it immediately.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicConnAddStandbyPath(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_opt_ const QUIC_ADDR* LocalAddress,
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ QUIC_CID_LIST_ENTRY* DestCid
+    )
+{
+    CXPLAT_DBG_ASSERT(!Connection->State.ShareBinding); // Standby paths need exclusive bindings.
+    if (Connection->PathsCount == QUIC_MAX_PATH_COUNT) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    CXPLAT_UDP_CONFIG UdpConfig = {0};
+    UdpConfig.LocalAddress = LocalAddress;
+    UdpConfig.RemoteAddress = RemoteAddress;
+    UdpConfig.Flags = CXPLAT_SOCKET_FLAG_NONE;
+    UdpConfig.InterfaceIndex = 0;
+#ifdef QUIC_COMPARTMENT_ID
+    UdpConfig.CompartmentId = Connection->Configuration->CompartmentId;
+#endif
+#ifdef QUIC_OWNING_PROCESS
+    UdpConfig.OwningProcess = Connection->Configuration->OwningProcess;
+#endif
+    if (Connection->Settings->XdpEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
+    }
+    if (Connection->Settings->QTIPEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
+    }
+    if (Connection->Settings->RioEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_RIO;
+    }
+
+    QUIC_BINDING* Binding;
+    QUIC_STATUS Status = QuicLibraryGetBinding(&UdpConfig, &Binding);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    if (!QuicBindingAddStandbyConnection(Binding, Connection)) {
+        QuicLibraryReleaseBinding(Binding);
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    QUIC_PATH* Path = &Connection->Paths[Connection->PathsCount++];
+    QuicPathInitialize(Connection, Path);
+    Path->IsStandby = TRUE;
+    Path->Allowance = UINT32_MAX; // Only servers are amplification limited.
+    Path->Binding = Binding;
+    Path->Route.State = RouteUnresolved;
+    Path->Route.RemoteAddress = *RemoteAddress;
+    QuicBindingGetLocalAddress(Binding, &Path->Route.LocalAddress);
+
+    Path->DestCid = DestCid;
+    if (DestCid->CID.Length != 0) {
+        QUIC_CID_SET_PATH(Connection, DestCid, Path);
+        DestCid->CID.UsedLocally = TRUE;
+    }
+    QuicPathValidate(Path);
+
+    QuicTraceEvent(
+        ConnLocalAddrAdded,
+        "[conn][%p] New Local IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.LocalAddress), &Path->Route.LocalAddress));
+
+    Path->SendChallenge = TRUE;
+    Path->PathValidationStartTime = CxPlatTimeUs64();
+    CxPlatRandom(sizeof(Path->Challenge), Path->Challenge);
+    QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PATH_CHALLENGE);
+
+    QuicConnTimerSet(
+        Connection,
+        QUIC_CONN_TIMER_PATH_PROBE,
+        MS_TO_US(QUIC_STANDBY_PATH_PROBE_INTERVAL_MS));
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Re-challenges the validated standby paths, so a standby that stopped working
+// is dropped (when its challenge is lost) before it is needed for failover.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnProbeStandbyPaths(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (QuicConnIsClosed(Connection)) {
+        return;
+    }
+
+    BOOLEAN HasStandby = FALSE;
+    for (uint8_t i = 1; i < Connection->PathsCount; ++i) {
+        QUIC_PATH* Path = &Connection->Paths[i];
+        if (!Path->IsStandby) {
+            continue;
+        }
+        HasStandby = TRUE;
+        if (Path->IsPeerValidated && !Path->StandbyProbePending) {
+            Path->StandbyProbePending = TRUE;
+            Path->SendChallenge = TRUE;
+            Path->PathValidationStartTime = CxPlatTimeUs64();
+            CxPlatRandom(sizeof(Path->Challenge), Path->Challenge);
+            QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PATH_CHALLENGE);
+        }
+    }
+
+    if (HasStandby) {
+        QuicConnTimerSet(
+            Connection,
+            QUIC_CONN_TIMER_PATH_PROBE,
+            MS_TO_US(QUIC_STANDBY_PATH_PROBE_INTERVAL_MS));
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnMigrateToPreferredAddress(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CXPLAT_DBG_ASSERT(QuicConnIsClient(Connection));
+    if (!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) ||
+        Connection->State.ShareBinding ||
+        !Connection->Settings->MigrationEnabled ||
+        QuicConnIsClosed(Connection)) {
+        return;
+    }
+
+    QUIC_CID_LIST_ENTRY* DestCid = QuicConnGetDestCidFromSeq(Connection, 1, FALSE);
+    if (DestCid == NULL || DestCid->CID.UsedLocally || DestCid->CID.Retired) {
+        return;
+    }
+
+    //
+    // The preferred address is validated like a standby path, over its own
+    // binding, and the client only moves to it once it answers.
+    //
+    QUIC_STATUS Status =
+        QuicConnAddStandbyPath(
+            Connection,
+            NULL,
+            &Connection->PeerTransportParams.PreferredAddress,
+            DestCid);
+    if (QUIC_FAILED(Status)) {
+        QuicTraceEvent(
+            ConnErrorStatus,
+            "[conn][%p] ERROR, %u, %s.",
+            Connection,
+            Status,
+            "Migrating to preferred address");
+        return;
+    }
+
+    Connection->Paths[Connection->PathsCount - 1].IsPreferredAddress = TRUE;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -6277,6 +7698,27 @@ QuicConnParamSet(
             break;
         }
 
+        if (Connection->State.Started) {
+            //
+            // Switching to an already validated standby path is immediate.
+            //
+            QUIC_PATH* StandbyPath = NULL;
+            for (uint8_t i = 1; i < Connection->PathsCount; ++i) {
+                if (Connection->Paths[i].IsStandby &&
+                    Connection->Paths[i].IsPeerValidated &&
+                    QuicAddrCompare(LocalAddress, &Connection->Paths[i].Route.LocalAddress)) {
+                    StandbyPath = &Connection->Paths[i];
+                    break;
+                }
+            }
+            if (StandbyPath != NULL) {
+                QuicPathSetActive(Connection, StandbyPath);
+                QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PING);
+                Status = QUIC_STATUS_SUCCESS;
+                break;
+            }
+        }
+
         Connection->State.LocalAddressSet = TRUE;
         CxPlatCopyMemory(&Connection->Paths[0].Route.LocalAddress, Buffer, sizeof(QUIC_ADDR));
         QuicTraceEvent(
@@ -6307,12 +7749,15 @@ QuicConnParamSet(
             if (Connection->State.ShareBinding) {
                 UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_SHARE;
             }
-            if (Connection->Settings.XdpEnabled) {
+            if (Connection->Settings->XdpEnabled) {
                 UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
             }
-            if (Connection->Settings.QTIPEnabled) {
+            if (Connection->Settings->QTIPEnabled) {
                 UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
             }
+            if (Connection->Settings->RioEnabled) {
+                UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_RIO;
+            }
             Status =
                 QuicLibraryGetBinding(
                     &UdpConfig,
@@ -6514,6 +7959,10 @@ QuicConnParamSet(
 
         Connection->State.UseRoundRobinStreamScheduling =
             Scheme == QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN;
+        Connection->State.UseExtensibleStreamScheduling =
+            Scheme == QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE;
+        Connection->State.UseWeightedStreamScheduling =
+            Scheme == QUIC_STREAM_SCHEDULING_SCHEME_WEIGHTED;
 
         QuicTraceLogConnInfo(
             UpdateStreamSchedulingScheme,
@@ -6525,7 +7974,7 @@ QuicConnParamSet(
         break;
     }
 
-    case QUIC_PARAM_CONN_DATAGRAM_RECEIVE_ENABLED:
+    case QUIC_PARAM_CONN_DATAGRAM_RECEIVE_ENABLED: {
 
         if (BufferLength != sizeof(BOOLEAN)) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
@@ -6537,17 +7986,24 @@ QuicConnParamSet(
             break;
         }
 
-        Connection->Settings.DatagramReceiveEnabled = *(BOOLEAN*)Buffer;
-        Connection->Settings.IsSet.DatagramReceiveEnabled = TRUE;
+        QUIC_SETTINGS_INTERNAL* Settings = QuicConnGetPrivateSettings(Connection);
+        if (Settings == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            break;
+        }
+
+        Settings->DatagramReceiveEnabled = *(BOOLEAN*)Buffer;
+        Settings->IsSet.DatagramReceiveEnabled = TRUE;
         Status = QUIC_STATUS_SUCCESS;
 
         QuicTraceLogConnVerbose(
             DatagramReceiveEnableUpdated,
             Connection,
             "Updated datagram receive enabled to %hhu",
-            Connection->Settings.DatagramReceiveEnabled);
+            Connection->Settings->DatagramReceiveEnabled);
 
         break;
+    }
 
     case QUIC_PARAM_CONN_DISABLE_1RTT_ENCRYPTION:
 
@@ -6597,22 +8053,10 @@ QuicConnParamSet(
         }
 
         Status =
-            QuicCryptoDecodeClientTicket(
+            QuicConnSetResumptionTicket(
                 Connection,
                 (uint16_t)BufferLength,
-                Buffer,
-                &Connection->PeerTransportParams,
-                &Connection->Crypto.ResumptionTicket,
-                &Connection->Crypto.ResumptionTicketLength,
-                &Connection->Stats.QuicVersion);
-        if (QUIC_FAILED(Status)) {
-            break;
-        }
-
-        QuicConnOnQuicVersionSet(Connection);
-        Status = QuicConnProcessPeerTransportParameters(Connection, TRUE);
-        CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status));
-
+                (const uint8_t*)Buffer);
         break;
     }
 
@@ -6734,30 +8178,271 @@ QuicConnParamSet(
             "Connection DSCP set to %hhu",
             Connection->DSCP);
 
-        Status = QUIC_STATUS_SUCCESS;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_ACK_ONLY_DSCP: {
+        if (BufferLength != sizeof(uint8_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        uint8_t DSCP = *(uint8_t*)Buffer;
+
+        if (DSCP > CXPLAT_MAX_DSCP) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->AckOnlyDSCP = DSCP;
+        Connection->State.AckOnlyDSCPSet = TRUE;
+
+        QuicTraceLogConnInfo(
+            ConnAckOnlyDscpSet,
+            Connection,
+            "Connection ACK-only DSCP set to %hhu",
+            Connection->AckOnlyDSCP);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_CLOSE_ASYNC:
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Connection->State.HandleClosed) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        Connection->State.CloseAsync = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+
+        QuicTraceLogConnVerbose(
+            CloseAsyncUpdated,
+            Connection,
+            "Updated CloseAsync to %hhu",
+            Connection->State.CloseAsync);
+
+        break;
+
+    case QUIC_PARAM_CONN_CUSTOM_CONGESTION_CONTROL: {
+
+        if (BufferLength != sizeof(QUIC_CUSTOM_CONGESTION_CONTROL) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // The congestion controller is selected when the configuration is
+        // applied, so the callbacks must be provided before that.
+        //
+        if (Connection->Configuration != NULL ||
+            QUIC_CONN_BAD_START_STATE(Connection)) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const QUIC_CUSTOM_CONGESTION_CONTROL* Custom =
+            (const QUIC_CUSTOM_CONGESTION_CONTROL*)Buffer;
+        if (Custom->Callbacks != NULL &&
+            (Custom->Callbacks->CanSend == NULL ||
+             Custom->Callbacks->GetSendAllowance == NULL ||
+             Custom->Callbacks->GetCongestionWindow == NULL ||
+             Custom->Callbacks->OnDataSent == NULL ||
+             Custom->Callbacks->OnDataAcknowledged == NULL ||
+             Custom->Callbacks->OnDataLost == NULL)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->CustomCongestionControl = *Custom;
+
+        QuicTraceLogConnVerbose(
+            CustomCongestionControlSet,
+            Connection,
+            "Custom congestion control %s",
+            Custom->Callbacks != NULL ? "set" : "cleared");
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT:
+
+        if (BufferLength != sizeof(uint32_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->Datagram.SendTimeoutMs = *(uint32_t*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_SEND_RATE_LIMIT:
+
+        if (BufferLength != sizeof(uint64_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QuicSendRateLimitSet(
+            &Connection->SendRateLimit, *(uint64_t*)Buffer, CxPlatTimeUs64());
+        if (Connection->State.Started) {
+            QuicSendQueueFlush(&Connection->Send, REASON_SCHEDULING);
+        }
+
+        QuicTraceLogConnVerbose(
+            SendRateLimitSet,
+            Connection,
+            "Send rate limit set to %llu bytes/s",
+            Connection->SendRateLimit.Rate);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY: {
+
+        if (BufferLength != sizeof(uint32_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (QuicConnIsServer(Connection) || QUIC_CONN_BAD_START_STATE(Connection)) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const uint32_t DelayMs = *(uint32_t*)Buffer;
+        if (DelayMs != 0 && DelayMs < QUIC_HAPPY_EYEBALLS_MIN_DELAY_MS) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->HappyEyeballsDelayMs = DelayMs;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE: {
+
+        if (BufferLength != sizeof(QUIC_PEER_STREAM_TEMPLATE) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_PEER_STREAM_TEMPLATE* Template =
+            (const QUIC_PEER_STREAM_TEMPLATE*)Buffer;
+        if (Template->Flags &
+                ~(QUIC_STREAM_OPEN_FLAG_APP_OWNED_BUFFERS |
+                  QUIC_STREAM_OPEN_FLAG_DELAY_ID_FC_UPDATES)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Template->Handler != NULL && Connection->PeerStreamsStarted == NULL) {
+            Connection->PeerStreamsStarted =
+                CXPLAT_ALLOC_NONPAGED(
+                    QUIC_PEER_STREAMS_STARTED_BATCH_MAX * sizeof(QUIC_PEER_STREAM_STARTED_DATA),
+                    QUIC_POOL_PEER_STREAMS_STARTED);
+            if (Connection->PeerStreamsStarted == NULL) {
+                QuicTraceEvent(
+                    AllocFailure,
+                    "Allocation of '%s' failed. (%llu bytes)",
+                    "Peer streams started",
+                    QUIC_PEER_STREAMS_STARTED_BATCH_MAX * sizeof(QUIC_PEER_STREAM_STARTED_DATA));
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+                break;
+            }
+        }
+
+        Connection->PeerStreamTemplate = *Template;
+
+        QuicTraceLogConnVerbose(
+            PeerStreamTemplateSet,
+            Connection,
+            "Peer stream template %s",
+            Template->Handler != NULL ? "set" : "cleared");
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS: {
+
+        if (BufferLength != sizeof(QUIC_ADDR) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (QuicConnIsServer(Connection) ||
+            !Connection->State.HandshakeConfirmed ||
+            Connection->State.ClosedLocally) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const QUIC_ADDR* LocalAddress = (const QUIC_ADDR*)Buffer;
+        if (!QuicAddrIsValid(LocalAddress) ||
+            QuicAddrIsWildCard(LocalAddress)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Connection->State.ShareBinding) {
+            Status = QUIC_STATUS_NOT_SUPPORTED; // Standby paths need exclusive bindings.
+            break;
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        for (uint8_t i = 0; i < Connection->PathsCount; ++i) {
+            if (QuicAddrCompare(LocalAddress, &Connection->Paths[i].Route.LocalAddress)) {
+                Status = QUIC_STATUS_INVALID_STATE;
+                break;
+            }
+        }
+        if (QUIC_FAILED(Status)) {
+            break;
+        }
+
+        QUIC_CID_LIST_ENTRY* DestCid = Connection->Paths[0].DestCid;
+        if (DestCid->CID.Length != 0) {
+            DestCid = QuicConnGetUnusedDestCid(Connection);
+            if (DestCid == NULL) {
+                Status = QUIC_STATUS_INVALID_STATE;
+                break;
+            }
+        }
+
+        Status =
+            QuicConnAddStandbyPath(
+                Connection,
+                LocalAddress,
+                &Connection->Paths[0].Route.RemoteAddress,
+                DestCid);
         break;
     }
 
-    case QUIC_PARAM_CONN_CLOSE_ASYNC:
-        if (BufferLength != sizeof(BOOLEAN)) {
+    case QUIC_PARAM_CONN_HANDOFF_STATE:
+
+        if (BufferLength == 0 || Buffer == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
-        if (Connection->State.HandleClosed) {
+        if (QUIC_CONN_BAD_START_STATE(Connection) ||
+            QuicConnIsServer(Connection) ||
+            Connection->Configuration != NULL ||
+            Connection->HandoffState != NULL) {
             Status = QUIC_STATUS_INVALID_STATE;
             break;
         }
 
-        Connection->State.CloseAsync = *(BOOLEAN*)Buffer;
-        Status = QUIC_STATUS_SUCCESS;
-
-        QuicTraceLogConnVerbose(
-            CloseAsyncUpdated,
-            Connection,
-            "Updated CloseAsync to %hhu",
-            Connection->State.CloseAsync);
-
+        Status = QuicConnHandoffSetState(Connection, BufferLength, (const uint8_t*)Buffer);
         break;
 
     //
@@ -6974,6 +8659,35 @@ QuicConnGetV2Statistics(
     if (STATISTICS_HAS_FIELD(*StatsLength, RttVariance)) {
         Stats->RttVariance = (uint32_t)Path->RttVariance;
     }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendDeliveryRate)) {
+        Stats->SendDeliveryRate =
+            Connection->LossDetection.DeliveryRate / QUIC_DELIVERY_RATE_UNIT;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, ProcessingTime)) {
+        Stats->ProcessingTime = Connection->Stats.Schedule.ProcessingTime;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendBlockedByStreamIdFlowControlUs)) {
+        const uint64_t Now = CxPlatTimeUs64();
+        Stats->SendBlockedBySchedulingUs =
+            QuicFlowBlockedTimingGet(&Connection->BlockedTimings.Scheduling, Now);
+        Stats->SendBlockedByPacingUs =
+            QuicFlowBlockedTimingGet(&Connection->BlockedTimings.Pacing, Now);
+        Stats->SendBlockedByAmplificationProtUs =
+            QuicFlowBlockedTimingGet(&Connection->BlockedTimings.AmplificationProt, Now);
+        Stats->SendBlockedByCongestionControlUs =
+            QuicFlowBlockedTimingGet(&Connection->BlockedTimings.CongestionControl, Now);
+        Stats->SendBlockedByConnFlowControlUs =
+            QuicFlowBlockedTimingGet(&Connection->BlockedTimings.FlowControl, Now);
+        QuicStreamSetGetBlockedTimings(
+            &Connection->Streams,
+            &Stats->SendBlockedByStreamFlowControlUs,
+            &Stats->SendBlockedByStreamIdFlowControlUs);
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SpinRttMinUs)) {
+        Stats->SpinRttSampleCount = Connection->SpinRtt.SampleCount;
+        Stats->SpinRttLatestUs = Connection->SpinRtt.Latest;
+        Stats->SpinRttMinUs = Connection->SpinRtt.Min;
+    }
 
     *StatsLength = CXPLAT_MIN(*StatsLength, sizeof(QUIC_STATISTICS_V2));
 
@@ -7007,6 +8721,109 @@ QuicConnGetNetworkStatistics(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnGetPathTelemetry(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow,
+    _Out_ QUIC_PATH_TELEMETRY* Snapshot
+    )
+{
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_PATH_TELEMETRY_CONFIG* Config = &Connection->Registration->Telemetry;
+
+    QUIC_NETWORK_STATISTICS NetStats;
+    CxPlatZeroMemory(&NetStats, sizeof(NetStats));
+    Connection->CongestionControl.QuicCongestionControlGetNetworkStatistics(
+        Connection, &Connection->CongestionControl, &NetStats);
+
+    Snapshot->CorrelationId = Connection->Stats.CorrelationId;
+    Snapshot->ConnectionContext = Connection->ClientContext;
+    Snapshot->DeliveryRate =
+        Connection->LossDetection.DeliveryRate / QUIC_DELIVERY_RATE_UNIT;
+    Snapshot->CongestionWindow = NetStats.CongestionWindow;
+    Snapshot->BytesInFlight = NetStats.BytesInFlight;
+    Snapshot->SmoothedRtt = (uint32_t)Path->SmoothedRtt;
+    Snapshot->RttVariance = (uint32_t)Path->RttVariance;
+    Snapshot->SentPackets =
+        (uint32_t)(Connection->Stats.Send.TotalPackets - Connection->Telemetry.SentPackets);
+    Snapshot->LostPackets =
+        (uint32_t)(Connection->Stats.Send.SuspectedLostPackets - Connection->Telemetry.LostPackets);
+    Snapshot->EcnCongestionEvents =
+        Connection->Stats.Send.EcnCongestionCount - Connection->Telemetry.EcnCongestionCount;
+
+    Connection->Telemetry.SentPackets = Connection->Stats.Send.TotalPackets;
+    Connection->Telemetry.LostPackets = Connection->Stats.Send.SuspectedLostPackets;
+    Connection->Telemetry.EcnCongestionCount = Connection->Stats.Send.EcnCongestionCount;
+
+    const uint64_t Interval =
+        CXPLAT_MAX(
+            MS_TO_US((uint64_t)Config->IntervalMs),
+            (uint64_t)Config->IntervalRtts * Path->SmoothedRtt);
+    Connection->Telemetry.NextTimeUs = TimeNow + Interval;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicConnGetMemoryUsage(
+    _In_ QUIC_CONNECTION* Connection,
+    _Inout_ uint32_t* UsageLength,
+    _Out_writes_bytes_opt_(*UsageLength)
+        QUIC_MEMORY_USAGE* Usage
+    )
+{
+    if (*UsageLength < sizeof(QUIC_MEMORY_USAGE)) {
+        *UsageLength = sizeof(QUIC_MEMORY_USAGE);
+        return QUIC_STATUS_BUFFER_TOO_SMALL;
+    }
+
+    if (Usage == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    CxPlatZeroMemory(Usage, sizeof(QUIC_MEMORY_USAGE));
+    Usage->Connections = sizeof(QUIC_CONNECTION);
+    QuicStreamSetGetMemoryUsage(&Connection->Streams, Usage);
+    if (Connection->Crypto.Initialized) {
+        Usage->RecvBuffers += QuicRecvBufferGetMemoryUsage(&Connection->Crypto.RecvBuffer);
+    }
+    Usage->SendBuffers = Connection->SendBuffer.BufferedBytes;
+    Usage->SentPacketMetadata = QuicLossDetectionGetMemoryUsage(&Connection->LossDetection);
+
+    *UsageLength = sizeof(QUIC_MEMORY_USAGE);
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicConnGetStreamCreditStatistics(
+    _In_ QUIC_CONNECTION* Connection,
+    _Inout_ uint32_t* StatsLength,
+    _Out_writes_bytes_opt_(*StatsLength)
+        QUIC_STREAM_CREDIT_STATISTICS* Stats
+    )
+{
+    if (*StatsLength < sizeof(QUIC_STREAM_CREDIT_STATISTICS)) {
+        *StatsLength = sizeof(QUIC_STREAM_CREDIT_STATISTICS);
+        return QUIC_STATUS_BUFFER_TOO_SMALL;
+    }
+
+    if (Stats == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    QuicStreamSetGetCreditStatistics(&Connection->Streams, Stats);
+    Stats->MaxStreamsFramesSent = Connection->StreamCredit.MaxStreamsFramesSent;
+    Stats->StreamsBlockedFramesReceived =
+        Connection->StreamCredit.StreamsBlockedFramesReceived;
+    Stats->StreamCountGrowths = Connection->StreamCredit.StreamCountGrowths;
+
+    *StatsLength = sizeof(QUIC_STREAM_CREDIT_STATISTICS);
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicConnParamGet(
@@ -7115,14 +8932,33 @@ QuicConnParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_CONN_PARTITION_INDEX:
+
+        if (*BufferLength < sizeof(uint16_t)) {
+            *BufferLength = sizeof(uint16_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint16_t);
+        *(uint16_t*)Buffer = Connection->Partition->Index;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     case QUIC_PARAM_CONN_SETTINGS:
 
-        Status = QuicSettingsGetSettings(&Connection->Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
+        Status = QuicSettingsGetSettings(Connection->Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
         break;
 
     case QUIC_PARAM_CONN_VERSION_SETTINGS:
 
-        Status = QuicSettingsGetVersionSettings(&Connection->Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
+        Status = QuicSettingsGetVersionSettings(Connection->Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
         break;
 
     case QUIC_PARAM_CONN_STATISTICS:
@@ -7296,9 +9132,15 @@ QuicConnParamGet(
         }
 
         *BufferLength = sizeof(QUIC_STREAM_SCHEDULING_SCHEME);
-        *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer =
-            Connection->State.UseRoundRobinStreamScheduling ?
-                QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN : QUIC_STREAM_SCHEDULING_SCHEME_FIFO;
+        if (Connection->State.UseRoundRobinStreamScheduling) {
+            *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer = QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN;
+        } else if (Connection->State.UseExtensibleStreamScheduling) {
+            *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer = QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE;
+        } else if (Connection->State.UseWeightedStreamScheduling) {
+            *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer = QUIC_STREAM_SCHEDULING_SCHEME_WEIGHTED;
+        } else {
+            *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer = QUIC_STREAM_SCHEDULING_SCHEME_FIFO;
+        }
 
         Status = QUIC_STATUS_SUCCESS;
         break;
@@ -7317,7 +9159,7 @@ QuicConnParamGet(
         }
 
         *BufferLength = sizeof(BOOLEAN);
-        *(BOOLEAN*)Buffer = Connection->Settings.DatagramReceiveEnabled;
+        *(BOOLEAN*)Buffer = Connection->Settings->DatagramReceiveEnabled;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
@@ -7425,11 +9267,119 @@ QuicConnParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_CONN_ACK_ONLY_DSCP:
+
+        if (*BufferLength < sizeof(uint8_t)) {
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            *BufferLength = sizeof(uint8_t);
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *(uint8_t*)Buffer =
+            Connection->State.AckOnlyDSCPSet ?
+                Connection->AckOnlyDSCP : Connection->DSCP;
+
+        *BufferLength = sizeof(uint8_t);
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     case QUIC_PARAM_CONN_NETWORK_STATISTICS:
         Status =
             QuicConnGetNetworkStatistics(Connection, BufferLength, (QUIC_NETWORK_STATISTICS *)Buffer);
         break;
 
+    case QUIC_PARAM_CONN_MEMORY_USAGE:
+        Status =
+            QuicConnGetMemoryUsage(Connection, BufferLength, (QUIC_MEMORY_USAGE*)Buffer);
+        break;
+
+    case QUIC_PARAM_CONN_STREAM_CREDIT_STATISTICS:
+        Status =
+            QuicConnGetStreamCreditStatistics(
+                Connection, BufferLength, (QUIC_STREAM_CREDIT_STATISTICS*)Buffer);
+        break;
+
+    case QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT:
+
+        if (*BufferLength < sizeof(uint32_t)) {
+            *BufferLength = sizeof(uint32_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint32_t);
+        *(uint32_t*)Buffer = Connection->Datagram.SendTimeoutMs;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_SEND_RATE_LIMIT:
+
+        if (*BufferLength < sizeof(uint64_t)) {
+            *BufferLength = sizeof(uint64_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint64_t);
+        *(uint64_t*)Buffer = Connection->SendRateLimit.Rate;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY:
+
+        if (*BufferLength < sizeof(uint32_t)) {
+            *BufferLength = sizeof(uint32_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint32_t);
+        *(uint32_t*)Buffer = Connection->HappyEyeballsDelayMs;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE:
+
+        if (*BufferLength < sizeof(QUIC_PEER_STREAM_TEMPLATE)) {
+            *BufferLength = sizeof(QUIC_PEER_STREAM_TEMPLATE);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_PEER_STREAM_TEMPLATE);
+        *(QUIC_PEER_STREAM_TEMPLATE*)Buffer = Connection->PeerStreamTemplate;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     case QUIC_PARAM_CONN_CLOSE_ASYNC:
 
         if (*BufferLength < sizeof(BOOLEAN)) {
@@ -7449,6 +9399,22 @@ QuicConnParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_CONN_HANDOFF_STATE:
+        Status = QuicConnHandoffExport(Connection, BufferLength, (uint8_t*)Buffer);
+        if (QUIC_SUCCEEDED(Status)) {
+            //
+            // The connection carries on in the process that imports the state,
+            // so this one must never send again; it would reuse packet numbers
+            // (and so AEAD nonces).
+            //
+            QuicConnCloseLocally(
+                Connection,
+                QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
+                (uint64_t)QUIC_STATUS_ABORTED,
+                NULL);
+        }
+        break;
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -7457,6 +9423,69 @@ QuicConnParamGet(
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnSetSharedSettings(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_SHARED_SETTINGS* SharedSettings,
+    _In_ BOOLEAN Private
+    )
+{
+    QuicSharedSettingsRelease(Connection->SharedSettings);
+    Connection->SharedSettings = SharedSettings;
+    Connection->Settings = &SharedSettings->Settings;
+    Connection->State.PrivateSettings = Private;
+}
+
+//
+// Returns settings the connection may modify, first copying the shared ones
+// if the connection doesn't have its own yet.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SETTINGS_INTERNAL*
+QuicConnGetPrivateSettings(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (!Connection->State.PrivateSettings) {
+        QUIC_SHARED_SETTINGS* SharedSettings =
+            QuicSharedSettingsAlloc(Connection->Settings);
+        if (SharedSettings == NULL) {
+            return NULL;
+        }
+        QuicConnSetSharedSettings(Connection, SharedSettings, TRUE);
+    }
+    return &Connection->SharedSettings->Settings;
+}
+
+//
+// Applies the configuration's settings to a connection that hasn't started.
+// Unless the application already gave the connection settings of its own,
+// the connection just shares the configuration's merged copy.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnApplyConfigurationSettings(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    if (!Connection->State.PrivateSettings) {
+        QUIC_SHARED_SETTINGS* SharedSettings =
+            QuicConfigurationGetSharedSettings(Configuration);
+        if (SharedSettings != NULL) {
+            QuicConnSetSharedSettings(Connection, SharedSettings, FALSE);
+            QuicConnOnNewSettings(Connection, FALSE, &Configuration->Settings);
+            return;
+        }
+    }
+
+    QuicConnApplyNewSettings(
+        Connection,
+        FALSE,
+        &Configuration->Settings);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicConnApplyNewSettings(
@@ -7465,26 +9494,47 @@ QuicConnApplyNewSettings(
     _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
     )
 {
-    QuicTraceLogConnInfo(
-        ApplySettings,
-        Connection,
-        "Applying new settings");
+    QUIC_SETTINGS_INTERNAL* Settings = QuicConnGetPrivateSettings(Connection);
+    if (Settings == NULL) {
+        return FALSE;
+    }
 
     if (!QuicSettingApply(
-            &Connection->Settings,
+            Settings,
             OverWrite,
             !Connection->State.Started,
             NewSettings)) {
         return FALSE;
     }
 
+    return QuicConnOnNewSettings(Connection, OverWrite, NewSettings);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnOnNewSettings(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ BOOLEAN OverWrite,
+    _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
+    )
+{
+    QuicTraceLogConnInfo(
+        ApplySettings,
+        Connection,
+        "Applying new settings");
+
+    if (!Connection->State.Started || NewSettings->IsSet.MaxAckDelayMs) {
+        Connection->MaxAckDelayMs = Connection->Settings->MaxAckDelayMs;
+    }
+
     if (!Connection->State.Started) {
 
-        Connection->Paths[0].SmoothedRtt = MS_TO_US(Connection->Settings.InitialRttMs);
+        Connection->Paths[0].SmoothedRtt = MS_TO_US(Connection->Settings->InitialRttMs);
         Connection->Paths[0].RttVariance = Connection->Paths[0].SmoothedRtt / 2;
-        Connection->Paths[0].Mtu = Connection->Settings.MinimumMtu;
+        Connection->Paths[0].Mtu = Connection->Settings->MinimumMtu;
+        QuicPathInitSpinBit(Connection, &Connection->Paths[0]);
 
-        if (Connection->Settings.ServerResumptionLevel > QUIC_SERVER_NO_RESUME &&
+        if (Connection->Settings->ServerResumptionLevel > QUIC_SERVER_NO_RESUME &&
             Connection->HandshakeTP == NULL) {
             CXPLAT_DBG_ASSERT(!Connection->State.Started);
             Connection->HandshakeTP =
@@ -7501,11 +9551,11 @@ QuicConnApplyNewSettings(
             }
         }
 
-        QuicSendApplyNewSettings(&Connection->Send, &Connection->Settings);
-        QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+        QuicSendApplyNewSettings(&Connection->Send, Connection->Settings);
+        QuicCongestionControlInitialize(&Connection->CongestionControl, Connection->Settings);
 
-        if (QuicConnIsClient(Connection) && Connection->Settings.IsSet.VersionSettings) {
-            Connection->Stats.QuicVersion = Connection->Settings.VersionSettings->FullyDeployedVersions[0];
+        if (QuicConnIsClient(Connection) && Connection->Settings->IsSet.VersionSettings) {
+            Connection->Stats.QuicVersion = Connection->Settings->VersionSettings->FullyDeployedVersions[0];
             QuicConnOnQuicVersionSet(Connection);
             //
             // The version has changed AFTER the crypto layer has been initialized,
@@ -7518,7 +9568,7 @@ QuicConnApplyNewSettings(
         }
 
         if (QuicConnIsServer(Connection) &&
-            Connection->Settings.GreaseQuicBitEnabled &&
+            Connection->Settings->GreaseQuicBitEnabled &&
             (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_GREASE_QUIC_BIT) > 0) {
             //
             // Endpoints that receive the grease_quic_bit transport parameter from
@@ -7531,7 +9581,7 @@ QuicConnApplyNewSettings(
             Connection->Stats.GreaseBitNegotiated = TRUE;
         }
 
-        if (QuicConnIsServer(Connection) && Connection->Settings.ReliableResetEnabled) {
+        if (QuicConnIsServer(Connection) && Connection->Settings->ReliableResetEnabled) {
             Connection->State.ReliableResetStreamNegotiated =
                 !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_RELIABLE_RESET_ENABLED);
 
@@ -7550,11 +9600,16 @@ QuicConnApplyNewSettings(
             QuicConnIndicateEvent(Connection, &Event);
         }
 
-        if (QuicConnIsServer(Connection) && Connection->Settings.OneWayDelayEnabled) {
+        if (QuicConnIsServer(Connection) && Connection->Settings->OneWayDelayEnabled) {
             Connection->State.TimestampSendNegotiated = // Peer wants to recv, so we can send
                 !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED);
             Connection->State.TimestampRecvNegotiated = // Peer wants to send, so we can recv
                 !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED);
+            Connection->State.ReceiveTimestampsSendNegotiated = // Peer wants receive timestamps
+                !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK) &&
+                Connection->PeerTransportParams.MaxReceiveTimestampsPerAck != 0;
+            Connection->State.ReceiveTimestampsRecvNegotiated = // Peer supports sending them
+                !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK);
 
             //
             // Send event to app to indicate result of negotiation if app cares.
@@ -7573,14 +9628,14 @@ QuicConnApplyNewSettings(
             QuicConnIndicateEvent(Connection, &Event);
         }
 
-        if (Connection->Settings.EcnEnabled) {
+        if (Connection->Settings->EcnEnabled) {
             QUIC_PATH* Path = &Connection->Paths[0];
             Path->EcnValidationState = ECN_VALIDATION_TESTING;
         }
     }
 
     if (Connection->State.Started &&
-        (Connection->Settings.EncryptionOffloadAllowed ^ Connection->Paths[0].EncryptionOffloading)) {
+        (Connection->Settings->EncryptionOffloadAllowed ^ Connection->Paths[0].EncryptionOffloading)) {
         // TODO: enable/disable after start
         CXPLAT_FRE_ASSERT(FALSE);
     }
@@ -7593,17 +9648,17 @@ QuicConnApplyNewSettings(
         QuicStreamSetUpdateMaxCount(
             &Connection->Streams,
             PeerStreamType | STREAM_ID_FLAG_IS_BI_DIR,
-            Connection->Settings.PeerBidiStreamCount);
+            Connection->Settings->PeerBidiStreamCount);
     }
     if (NewSettings->IsSet.PeerUnidiStreamCount) {
         QuicStreamSetUpdateMaxCount(
             &Connection->Streams,
             PeerStreamType | STREAM_ID_FLAG_IS_UNI_DIR,
-            Connection->Settings.PeerUnidiStreamCount);
+            Connection->Settings->PeerUnidiStreamCount);
     }
 
     if (NewSettings->IsSet.KeepAliveIntervalMs && Connection->State.Started) {
-        if (Connection->Settings.KeepAliveIntervalMs != 0) {
+        if (Connection->Settings->KeepAliveIntervalMs != 0) {
             QuicConnProcessKeepAliveOperation(Connection);
         } else {
             QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_KEEP_ALIVE);
@@ -7613,7 +9668,7 @@ QuicConnApplyNewSettings(
     if (OverWrite) {
         QuicSettingsDumpNew(NewSettings);
     } else {
-        QuicSettingsDump(&Connection->Settings); // TODO - Really necessary?
+        QuicSettingsDump(Connection->Settings); // TODO - Really necessary?
     }
 
     return TRUE;
@@ -7723,6 +9778,19 @@ QuicConnProcessApiOperation(
             ApiCtx->STRM_SEND.Stream);
         break;
 
+    case QUIC_API_TYPE_CONN_SEND_BATCH:
+        for (uint32_t i = 0; i < ApiCtx->CONN_SEND_BATCH.StreamCount; ++i) {
+            QuicStreamSendFlush(ApiCtx->CONN_SEND_BATCH.Streams[i]);
+        }
+        break;
+
+    case QUIC_API_TYPE_STRM_START_BATCH:
+        QuicStreamStartBatch(
+            ApiCtx->STRM_START_BATCH.Streams,
+            ApiCtx->STRM_START_BATCH.StreamCount,
+            ApiCtx->STRM_START_BATCH.Flags);
+        break;
+
     case QUIC_API_TYPE_STRM_RECV_COMPLETE:
         QuicStreamReceiveCompletePending(
             ApiCtx->STRM_RECV_COMPLETE.Stream);
@@ -7807,6 +9875,16 @@ QuicConnProcessExpiredTimer(
     case QUIC_CONN_TIMER_KEEP_ALIVE:
         QuicConnProcessKeepAliveOperation(Connection);
         break;
+    case QUIC_CONN_TIMER_HIBERNATE:
+        QuicConnHibernate(Connection);
+        break;
+    case QUIC_CONN_TIMER_PATH_PROBE:
+        if (Connection->State.HappyEyeballsPending) {
+            QuicConnStartHappyEyeballs(Connection);
+        } else {
+            QuicConnProbeStandbyPaths(Connection);
+        }
+        break;
     case QUIC_CONN_TIMER_SHUTDOWN:
         QuicConnProcessShutdownTimerOperation(Connection);
         break;
@@ -7820,17 +9898,22 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicConnDrainOperations(
     _In_ QUIC_CONNECTION* Connection,
+    _In_ uint32_t MaxOperationCount,
     _Inout_ BOOLEAN* StillHasPriorityWork
     )
 {
     QUIC_OPERATION* Oper;
-    const uint32_t MaxOperationCount =
-        Connection->Settings.MaxOperationsPerDrain;
     uint32_t OperationCount = 0;
     BOOLEAN HasMoreWorkToDo = TRUE;
 
     CXPLAT_PASSIVE_CODE();
 
+    //
+    // Operations can change the same timers over and over, so only update the
+    // connection in the timer wheel once they're all processed.
+    //
+    Connection->State.DeferTimerWheelUpdate = TRUE;
+
     if (!Connection->State.Initialized && !Connection->State.ShutdownComplete) {
         //
         // TODO - Try to move this only after the connection is accepted by the
@@ -7846,11 +9929,11 @@ QuicConnDrainOperations(
                 ConnInitializeComplete,
                 "[conn][%p] Initialize complete",
                 Connection);
-            if (Connection->Settings.KeepAliveIntervalMs != 0) {
+            if (Connection->Settings->KeepAliveIntervalMs != 0) {
                 QuicConnTimerSet(
                     Connection,
                     QUIC_CONN_TIMER_KEEP_ALIVE,
-                    MS_TO_US(Connection->Settings.KeepAliveIntervalMs));
+                    MS_TO_US(Connection->Settings->KeepAliveIntervalMs));
             }
         }
     }
@@ -7907,6 +9990,21 @@ QuicConnDrainOperations(
             QuicStreamRecvFlush(Oper->FLUSH_STREAM_RECEIVE.Stream);
             break;
 
+        case QUIC_OPER_TYPE_FLUSH_STREAMS_RECV:
+            if (Connection->State.ShutdownComplete) {
+                QuicStreamRecvFlushBatchCancel(Connection);
+                break;
+            }
+            if (!QuicStreamRecvFlushBatch(Connection)) {
+                //
+                // Still have more streams to indicate. Put the operation back
+                // on the queue.
+                //
+                FreeOper = FALSE;
+                (void)QuicOperationEnqueue(&Connection->OperQ, Connection->Partition, Oper);
+            }
+            break;
+
         case QUIC_OPER_TYPE_FLUSH_SEND:
             if (Connection->State.ShutdownComplete) {
                 break; // Ignore if already shutdown
@@ -7945,11 +10043,16 @@ QuicConnDrainOperations(
                 Connection, Oper->ROUTE.PhysicalAddress, Oper->ROUTE.PathId, Oper->ROUTE.Succeeded);
             break;
 
+        case QUIC_OPER_TYPE_HANDSHAKE_COMPLETION:
+            QuicCryptoHandshakeOffloadComplete(&Connection->Crypto);
+            break;
+
         default:
             CXPLAT_FRE_ASSERT(FALSE);
             break;
         }
 
+        QuicSendBufferFillDeferred(Connection);
         QuicConnValidate(Connection);
 
         if (FreeOper) {
@@ -7978,6 +10081,12 @@ QuicConnDrainOperations(
 
     QuicStreamSetDrainClosedStreams(&Connection->Streams);
 
+    Connection->State.DeferTimerWheelUpdate = FALSE;
+    if (Connection->State.TimerWheelUpdatePending) {
+        Connection->State.TimerWheelUpdatePending = FALSE;
+        QuicConnTimerUpdateWheel(Connection);
+    }
+
     QuicConnValidate(Connection);
 
     if (HasMoreWorkToDo) {
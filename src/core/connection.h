@@ -142,6 +142,18 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN UseRoundRobinStreamScheduling : 1;
 
+        //
+        // Indicates the connection is using the RFC 9218 extensible priority
+        // stream scheduling scheme.
+        //
+        BOOLEAN UseExtensibleStreamScheduling : 1;
+
+        //
+        // Indicates the connection is using the weighted (deficit round robin)
+        // stream scheduling scheme.
+        //
+        BOOLEAN UseWeightedStreamScheduling : 1;
+
         //
         // Indicates that this connection has resumption enabled and needs to
         // keep the TLS state and transport parameters until it is done sending
@@ -191,12 +203,81 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN TimestampRecvNegotiated : 1;
 
+        //
+        // The peer asked for receive timestamps in our 1-RTT ACK frames.
+        //
+        BOOLEAN ReceiveTimestampsSendNegotiated : 1;
+
+        //
+        // We asked for receive timestamps in the peer's 1-RTT ACK frames.
+        //
+        BOOLEAN ReceiveTimestampsRecvNegotiated : 1;
+
         //
         // Indicates we received APPLICATION_ERROR transport error and are checking also
         // later packets in case they contain CONNECTION_CLOSE frame with application-layer error.
         //
         BOOLEAN DelayedApplicationError : 1;
 
+        //
+        // Indicates a stream has used app-owned receive buffers, so received
+        // stream data may be decrypted straight into them.
+        //
+        BOOLEAN AppOwnedRecvBuffers : 1;
+
+        //
+        // Timer changes are only recorded, and the connection's place in the
+        // timer wheel is updated once, when operations are done draining.
+        //
+        BOOLEAN DeferTimerWheelUpdate : 1;
+
+        //
+        // The earliest timer may have changed while timer wheel updates were
+        // deferred.
+        //
+        BOOLEAN TimerWheelUpdatePending : 1;
+
+        //
+        // The (client) server name resolved to both address families. The
+        // attempt to the other family starts if the first attempt hasn't been
+        // answered within the happy eyeballs delay.
+        //
+        BOOLEAN HappyEyeballsPending : 1;
+
+        //
+        // The attempts to both address families are racing. The first one to
+        // get a valid response wins and the other is dropped.
+        //
+        BOOLEAN HappyEyeballsRacing : 1;
+
+        //
+        // The application set a separate DSCP value for ACK-only datagrams.
+        //
+        BOOLEAN AckOnlyDSCPSet : 1;
+
+        //
+        // The new server connection is counted in its worker's handshake
+        // queue until the worker first processes it.
+        //
+        BOOLEAN HandshakeQueued : 1;
+
+        //
+        // The connection has been idle long enough to release its grown
+        // buffers and tracking state. Cleared on the next send or receive.
+        //
+        BOOLEAN Hibernating : 1;
+
+        //
+        // The connection was sampled for qlog capture.
+        //
+        BOOLEAN QlogEnabled : 1;
+
+        //
+        // The connection has its own copy of the settings instead of sharing
+        // the library's or configuration's.
+        //
+        BOOLEAN PrivateSettings : 1;
+
 #ifdef CxPlatVerifierEnabledByAddr
         //
         // The calling app is being verified (app or driver verifier).
@@ -228,6 +309,8 @@ typedef enum QUIC_CONNECTION_REF {
     QUIC_CONN_REF_TIMER_WHEEL,          // The timer wheel is tracking the connection.
     QUIC_CONN_REF_ROUTE,                // Route resolution is undergoing.
     QUIC_CONN_REF_STREAM,               // A stream depends on the connection.
+    QUIC_CONN_REF_HANDSHAKE,            // TLS processing is offloaded.
+    QUIC_CONN_REF_PACING_QUEUE,         // The pacing queue is tracking the connection.
 
     QUIC_CONN_REF_COUNT
 
@@ -266,6 +349,7 @@ typedef struct QUIC_CONN_STATS {
         uint32_t LastQueueTime;         // Time the connection last entered the work queue.
         uint64_t DrainCount;            // Sum of drain calls
         uint64_t OperationCount;        // Sum of operations processed
+        uint64_t ProcessingTime;        // Sum of time spent draining, in microseconds
     } Schedule;
 
     struct {
@@ -322,18 +406,6 @@ typedef struct QUIC_CONNECTION {
     struct QUIC_HANDLE;
 #endif
 
-    //
-    // Link into the registrations's list of connections.
-    //
-    CXPLAT_LIST_ENTRY RegistrationLink;
-
-#if DEBUG
-    //
-    // Link into the global debug object tracker.
-    //
-    CXPLAT_LIST_ENTRY DbgObjectLink;
-#endif
-
     //
     // Link in the worker's connection queue.
     // N.B. Multi-threaded access, synchronized by worker's connection lock.
@@ -345,6 +417,11 @@ typedef struct QUIC_CONNECTION {
     //
     CXPLAT_LIST_ENTRY TimerLink;
 
+    //
+    // Link in the worker's pacing queue.
+    //
+    CXPLAT_LIST_ENTRY PacingLink;
+
     //
     // The worker that is processing this connection.
     //
@@ -357,21 +434,14 @@ typedef struct QUIC_CONNECTION {
     //
     QUIC_PARTITION* Partition;
 
-    //
-    // The top level registration this connection is a part of.
-    //
-    QUIC_REGISTRATION* Registration;
-
-    //
-    // The configuration for this connection.
-    //
-    QUIC_CONFIGURATION* Configuration;
-
     //
     // The settings for this connection. Some values may be inherited from the
     // global settings, the configuration setting or explicitly set by the app.
+    // Until the app sets any of its own, these are shared with other
+    // connections (see QuicConnGetPrivateSettings) and must not be modified.
     //
-    QUIC_SETTINGS_INTERNAL Settings;
+    const QUIC_SETTINGS_INTERNAL* Settings;
+    QUIC_SHARED_SETTINGS* SharedSettings;
 
     //
     // Number of references to the handle.
@@ -398,9 +468,14 @@ typedef struct QUIC_CONNECTION {
     CXPLAT_THREAD_ID WorkerThreadID;
 
     //
-    // The server ID for the connection ID.
+    // Worker rebalancing state: the worker load interval the connection's
+    // processing time is being counted for, the time spent processing it in
+    // that interval in microseconds, and when it was last moved to another
+    // worker.
     //
-    uint8_t ServerID[QUIC_MAX_CID_SID_LENGTH];
+    uint64_t RebalanceIntervalStart;
+    uint64_t RebalanceIntervalTime;
+    uint64_t LastRebalanceTime;
 
     //
     // The partition ID for the connection ID.
@@ -466,6 +541,12 @@ typedef struct QUIC_CONNECTION {
     //
     uint8_t PeerPacketTolerance;
 
+    //
+    // The maximum time to delay an acknowledgment. Starts at the MaxAckDelayMs
+    // setting, and may be updated by the peer via the ACK_FREQUENCY frame.
+    //
+    uint32_t MaxAckDelayMs;
+
     //
     // The maximum number of packets that can be out of order before an immediate
     // acknowledgment (ACK) is triggered. If no specific instructions (ACK_FREQUENCY
@@ -487,6 +568,12 @@ typedef struct QUIC_CONNECTION {
     //
     uint8_t DSCP;
 
+    //
+    // DSCP value to set on datagrams carrying only ACK frames, if
+    // AckOnlyDSCPSet. Otherwise they use DSCP too.
+    //
+    uint8_t AckOnlyDSCP;
+
     //
     // The ACK frequency sequence number we are currently using to send.
     //
@@ -525,18 +612,6 @@ typedef struct QUIC_CONNECTION {
     //
     CXPLAT_LIST_ENTRY DestCids;
 
-    //
-    // The original CID used by the Client in its first Initial packet.
-    //
-    QUIC_CID* OrigDestCID;
-
-    //
-    // An app configured prefix for all connection IDs. The first byte indicates
-    // the length of the ID, the second byte the offset of the ID in the CID and
-    // the rest payload of the identifier.
-    //
-    uint8_t CibirId[2 + QUIC_MAX_CIBIR_LENGTH];
-
     //
     // Expiration time (absolute time in us) for each timer type. We use UINT64_MAX as a sentinel
     // to indicate that the timer is not set.
@@ -548,12 +623,6 @@ typedef struct QUIC_CONNECTION {
     //
     uint64_t EarliestExpirationTime;
 
-    //
-    // Timestamp (us) of when we last queued up a connection close (or
-    // application close) response to be sent.
-    //
-    uint64_t LastCloseResponseTimeUs;
-
     //
     // Receive packet queue.
     //
@@ -567,91 +636,183 @@ typedef struct QUIC_CONNECTION {
     // The queue of operations to process.
     //
     QUIC_OPERATION_QUEUE OperQ;
-    QUIC_OPERATION BackUpOper;
-    QUIC_API_CONTEXT BackupApiContext;
-    uint16_t BackUpOperUsed;
-    QUIC_OPERATION CloseOper;
-    QUIC_API_CONTEXT CloseApiContext;
 
     //
-    // The status code used for indicating transport closed notifications.
+    // Working space for decoded ACK ranges. All ACK frames that are received
+    // are first decoded into this range.
     //
-    QUIC_STATUS CloseStatus;
+    QUIC_RANGE DecodedAckRanges;
 
     //
-    // The locally set error code we use for sending the connection close.
+    // All the information and management logic for streams.
     //
-    QUIC_VAR_INT CloseErrorCode;
+    QUIC_STREAM_SET Streams;
 
     //
-    // The human readable reason for the connection close. UTF-8
+    // STREAM frame data received in the current batch of packets which has
+    // not yet been written to the stream's receive buffer.
     //
-    _Null_terminated_
-    char* CloseReasonPhrase;
+    QUIC_STREAM_RECV_RUN RecvRun;
 
     //
-    // The name of the remote server.
+    // Congestion control state.
     //
-    _Field_z_
-    const char* RemoteServerName;
+    QUIC_CONGESTION_CONTROL CongestionControl;
 
     //
-    // The entry into the remote hash lookup table, which is used only during the
-    // handshake.
+    // Application provided congestion control, used when the settings select
+    // QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM.
     //
-    QUIC_REMOTE_HASH_ENTRY* RemoteHashEntry;
+    QUIC_CUSTOM_CONGESTION_CONTROL CustomCongestionControl;
 
     //
-    // Transport parameters received from the peer.
+    // Manages all the information for outstanding sent packets.
     //
-    QUIC_TRANSPORT_PARAMETERS PeerTransportParams;
+    QUIC_LOSS_DETECTION LossDetection;
 
     //
-    // Working space for decoded ACK ranges. All ACK frames that are received
-    // are first decoded into this range.
+    // Per-encryption level packet space information.
     //
-    QUIC_RANGE DecodedAckRanges;
+    QUIC_PACKET_SPACE* Packets[QUIC_ENCRYPT_LEVEL_COUNT];
 
     //
-    // All the information and management logic for streams.
+    // Manages the stream of cryptographic TLS data sent and received.
     //
-    QUIC_STREAM_SET Streams;
+    QUIC_CRYPTO Crypto;
 
     //
-    // Congestion control state.
+    // The send manager for the connection.
     //
-    QUIC_CONGESTION_CONTROL CongestionControl;
+    QUIC_SEND Send;
+    QUIC_SEND_BUFFER SendBuffer;
 
     //
-    // Manages all the information for outstanding sent packets.
+    // The handler for the API client's callbacks.
     //
-    QUIC_LOSS_DETECTION LossDetection;
+    QUIC_CONNECTION_CALLBACK_HANDLER ClientCallbackHandler;
 
     //
-    // Per-encryption level packet space information.
+    // Statistics
     //
-    QUIC_PACKET_SPACE* Packets[QUIC_ENCRYPT_LEVEL_COUNT];
+    QUIC_CONN_STATS Stats;
 
     //
-    // Manages the stream of cryptographic TLS data sent and received.
+    // Everything above is touched while processing packets and timers, and is
+    // kept together to need as few cache lines as possible. Everything below
+    // is only needed by the handshake, the API, closing or diagnostics.
     //
-    QUIC_CRYPTO Crypto;
 
     //
-    // The send manager for the connection.
+    // Link into the registrations's list of connections.
     //
-    QUIC_SEND Send;
-    QUIC_SEND_BUFFER SendBuffer;
+    CXPLAT_LIST_ENTRY RegistrationLink;
 
+#if DEBUG
     //
-    // Manages datagrams for the connection.
+    // Link into the global debug object tracker.
     //
-    QUIC_DATAGRAM Datagram;
+    CXPLAT_LIST_ENTRY DbgObjectLink;
+#endif
 
     //
-    // The handler for the API client's callbacks.
+    // The top level registration this connection is a part of.
     //
-    QUIC_CONNECTION_CALLBACK_HANDLER ClientCallbackHandler;
+    QUIC_REGISTRATION* Registration;
+
+    //
+    // The configuration for this connection.
+    //
+    QUIC_CONFIGURATION* Configuration;
+
+    //
+    // The server ID for the connection ID.
+    //
+    uint8_t ServerID[QUIC_MAX_CID_SID_LENGTH];
+
+    //
+    // The original CID used by the Client in its first Initial packet.
+    // Allocated from the handshake arena.
+    //
+    QUIC_CID* OrigDestCID;
+
+    //
+    // The server's preferred address, copied from the listener. Allocated
+    // from the handshake arena.
+    //
+    QUIC_ADDR* PreferredAddress;
+
+    //
+    // Objects only needed until the handshake is confirmed, all freed at once
+    // then. Since it isn't freed before, the arena must only be used for a
+    // bounded number of small objects.
+    //
+    QUIC_ARENA HandshakeArena;
+
+    //
+    // An app configured prefix for all connection IDs. The first byte indicates
+    // the length of the ID, the second byte the offset of the ID in the CID and
+    // the rest payload of the identifier.
+    //
+    uint8_t CibirId[2 + QUIC_MAX_CIBIR_LENGTH];
+
+    //
+    // Timestamp (us) of when we last queued up a connection close (or
+    // application close) response to be sent.
+    //
+    uint64_t LastCloseResponseTimeUs;
+
+    //
+    // Operations reserved up front, so that failing to allocate one can always
+    // be reported, and closing the handle can't fail.
+    //
+    QUIC_OPERATION BackUpOper;
+    QUIC_API_CONTEXT BackupApiContext;
+    uint16_t BackUpOperUsed;
+    QUIC_OPERATION CloseOper;
+    QUIC_API_CONTEXT CloseApiContext;
+
+    //
+    // The status code used for indicating transport closed notifications.
+    //
+    QUIC_STATUS CloseStatus;
+
+    //
+    // The locally set error code we use for sending the connection close.
+    //
+    QUIC_VAR_INT CloseErrorCode;
+
+    //
+    // The human readable reason for the connection close. UTF-8
+    //
+    _Null_terminated_
+    char* CloseReasonPhrase;
+
+    //
+    // The name of the remote server.
+    //
+    _Field_z_
+    const char* RemoteServerName;
+
+    //
+    // The port the connection was started with. Host byte order.
+    //
+    uint16_t RemoteServerPort;
+
+    //
+    // The entry into the remote hash lookup table, which is used only during the
+    // handshake.
+    //
+    QUIC_REMOTE_HASH_ENTRY* RemoteHashEntry;
+
+    //
+    // Transport parameters received from the peer.
+    //
+    QUIC_TRANSPORT_PARAMETERS PeerTransportParams;
+
+    //
+    // Manages datagrams for the connection.
+    //
+    QUIC_DATAGRAM Datagram;
 
     //
     // (Server-only) Transport parameters used during handshake.
@@ -660,9 +821,10 @@ typedef struct QUIC_CONNECTION {
     QUIC_TRANSPORT_PARAMETERS* HandshakeTP;
 
     //
-    // Statistics
+    // State handed off from another process, set on a connection that hasn't
+    // started yet and applied once its configuration is set.
     //
-    QUIC_CONN_STATS Stats;
+    struct QUIC_CONN_HANDOFF_STATE* HandoffState;
 
     //
     // Mostly test specific state.
@@ -691,6 +853,17 @@ typedef struct QUIC_CONNECTION {
     //
     uint16_t KeepAlivePadding;
 
+    //
+    // When the next path telemetry snapshot is due, and the counters as of the
+    // last one, if the registration has telemetry enabled.
+    //
+    struct {
+        uint64_t NextTimeUs;
+        uint64_t SentPackets;
+        uint64_t LostPackets;
+        uint32_t EcnCongestionCount;
+    } Telemetry;
+
     //
     // Connection blocked timings.
     //
@@ -702,8 +875,73 @@ typedef struct QUIC_CONNECTION {
         QUIC_FLOW_BLOCKED_TIMING_TRACKER FlowControl;
     } BlockedTimings;
 
+    //
+    // Stream ID credit statistics for the peer's streams.
+    //
+    struct {
+        uint32_t MaxStreamsFramesSent;
+        uint32_t StreamsBlockedFramesReceived;
+        uint32_t StreamCountGrowths;
+    } StreamCredit;
+
+    //
+    // The application configured limit on the rate of the connection's
+    // ack-eliciting packets.
+    //
+    QUIC_SEND_RATE_LIMIT SendRateLimit;
+
+    //
+    // The (client) happy eyeballs connection attempt delay, in milliseconds,
+    // and the server's address of the other family to race against the first
+    // attempt.
+    //
+    uint32_t HappyEyeballsDelayMs;
+    QUIC_ADDR HappyEyeballsAddress;
+
+    //
+    // RTT samples, in microseconds, taken passively from the time between
+    // edges of the peer's latency spin bit on the active path.
+    //
+    struct {
+        uint64_t LastEdgeTime;          // Zero until an edge is seen on the current path.
+        uint64_t SampleCount;
+        uint32_t Latest;
+        uint32_t Min;
+    } SpinRtt;
+
+    //
+    // The app's template for new peer streams; Handler is NULL when not set.
+    // The peer streams started with it that haven't been indicated yet, in
+    // an array of QUIC_PEER_STREAMS_STARTED_BATCH_MAX allocated along with
+    // the template.
+    //
+    QUIC_PEER_STREAM_TEMPLATE PeerStreamTemplate;
+    QUIC_PEER_STREAM_STARTED_DATA* PeerStreamsStarted;
+    uint32_t PeerStreamsStartedCount;
+
 } QUIC_CONNECTION;
 
+//
+// The part of the connection touched while processing packets and timers must
+// stay within 64 cache lines. Before growing it, consider whether the new
+// state really is needed per packet, or belongs in the cold part.
+//
+#define QUIC_CONN_HOT_SIZE_MAX (64 * 64)
+
+//
+// Debug builds also keep the detailed ref counts in the hot part.
+//
+#if DEBUG
+#define QUIC_CONN_HOT_DEBUG_SIZE (QUIC_CONN_REF_COUNT * sizeof(CXPLAT_REF_COUNT))
+#else
+#define QUIC_CONN_HOT_DEBUG_SIZE 0
+#endif
+
+CXPLAT_STATIC_ASSERT(
+    FIELD_OFFSET(QUIC_CONNECTION, RegistrationLink) <=
+        QUIC_CONN_HOT_SIZE_MAX + QUIC_CONN_HOT_DEBUG_SIZE,
+    "Connection state used per packet must stay compact");
+
 typedef struct QUIC_SERIALIZED_RESUMPTION_STATE {
 
     uint32_t QuicVersion;
@@ -1183,17 +1421,48 @@ QuicConnIndicateEvent(
     );
 
 //
-// Allows the connection to drain some operations that it currently has
-// queued up. Returns TRUE if there are still work to do after the function
-// returns.
+// Allows the connection to drain up to MaxOperationCount operations that it
+// currently has queued up. Returns TRUE if there are still work to do after
+// the function returns.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicConnDrainOperations(
     _In_ QUIC_CONNECTION* Connection,
+    _In_ uint32_t MaxOperationCount,
     _Inout_ BOOLEAN* StillHasPriorityWork
     );
 
+//
+// Returns TRUE if the registration wants a path telemetry snapshot of the
+// connection now.
+//
+QUIC_INLINE
+BOOLEAN
+QuicConnTelemetryDue(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow
+    )
+{
+    return
+        Connection->Registration != NULL &&
+        Connection->Registration->Telemetry.Callback != NULL &&
+        Connection->State.Connected &&
+        !Connection->State.ShutdownComplete &&
+        TimeNow >= Connection->Telemetry.NextTimeUs;
+}
+
+//
+// Takes a path telemetry snapshot of the connection and schedules the next.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnGetPathTelemetry(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow,
+    _Out_ QUIC_PATH_TELEMETRY* Snapshot
+    );
+
 //
 // Queues a new operation on the connection and queues the connection on a
 // worker if necessary.
@@ -1434,17 +1703,17 @@ QuicConnGetAckDelay(
     _In_ const QUIC_CONNECTION* Connection
     )
 {
-    if (Connection->Settings.MaxAckDelayMs &&
+    if (Connection->MaxAckDelayMs &&
         (MsQuicLib.ExecutionConfig == NULL ||
-         Connection->Settings.MaxAckDelayMs > US_TO_MS(MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs))) {
+         Connection->MaxAckDelayMs > US_TO_MS(MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs))) {
         //
         // If we are using delayed ACKs, and the ACK delay is greater than the
         // polling timeout, then we need to account for delay resulting from
         // from the timer resolution.
         //
-        return (uint64_t)Connection->Settings.MaxAckDelayMs + (uint64_t)MsQuicLib.TimerResolutionMs;
+        return (uint64_t)Connection->MaxAckDelayMs + (uint64_t)MsQuicLib.TimerResolutionMs;
     }
-    return (uint64_t)Connection->Settings.MaxAckDelayMs;
+    return (uint64_t)Connection->MaxAckDelayMs;
 }
 
 //
@@ -1643,6 +1912,16 @@ QuicConnQueueRouteCompletion(
     _In_ BOOLEAN Succeeded
     );
 
+//
+// Starts migrating the (client) connection to the server's preferred address,
+// if the server provided one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnMigrateToPreferredAddress(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Queues up an update to the packet tolerance we want the peer to use.
 //
@@ -1707,7 +1986,7 @@ QuicConnGetMaxMtuForPath(
                 QuicAddrGetFamily(&Path->Route.RemoteAddress),
                 (uint16_t)Connection->PeerTransportParams.MaxUdpPayloadSize);
     }
-    uint16_t SettingsMtu = Connection->Settings.MaximumMtu;
+    uint16_t SettingsMtu = Connection->Settings->MaximumMtu;
     return CXPLAT_MIN(CXPLAT_MIN(LocalMtu, RemoteMtu), SettingsMtu);
 }
 
@@ -1723,7 +2002,7 @@ QuicMtuDiscoveryCheckSearchCompleteTimeout(
     _In_ uint64_t TimeNow
     )
 {
-    uint64_t TimeoutTime = Connection->Settings.MtuDiscoverySearchCompleteTimeoutUs;
+    uint64_t TimeoutTime = Connection->Settings->MtuDiscoverySearchCompleteTimeoutUs;
     for (uint8_t i = 0; i < Connection->PathsCount; i++) {
         //
         // Only trigger a new send if we're in Search Complete and enough time has
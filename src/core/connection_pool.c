@@ -538,6 +538,17 @@ MsQuicConnectionPoolCreate(
         }
     }
 
+    if (MsQuicLib.Settings.RioEnabled) {
+        SocketFlags |= CXPLAT_SOCKET_FLAG_RIO;
+    }
+    if (ConnectionConfig->Settings.IsSet.RioEnabled) {
+        if (ConnectionConfig->Settings.RioEnabled) {
+            SocketFlags |= CXPLAT_SOCKET_FLAG_RIO;
+        } else {
+            SocketFlags &= ~CXPLAT_SOCKET_FLAG_RIO;
+        }
+    }
+
     //
     // Get the local address and a port to start from.
     //
@@ -33,6 +33,65 @@ CXPLAT_TLS_CALLBACKS QuicTlsCallbacks = {
     QuicConnPeerCertReceived
 };
 
+//
+// A TLS process call run on a handshake thread. TLS writes its output into a
+// private copy of the process state, which is merged back into the
+// connection's state on the worker once the call completes.
+//
+typedef struct QUIC_CRYPTO_HANDSHAKE_OFFLOAD {
+
+    //
+    // Entry in the library's handshake queue.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    QUIC_CRYPTO* Crypto;
+
+    //
+    // Bit masks of the key slots that were empty when the job was queued, and
+    // so are owned by the job if TLS fills them in.
+    //
+    uint8_t NewReadKeys;
+    uint8_t NewWriteKeys;
+
+    //
+    // The TLS results of the call.
+    //
+    CXPLAT_TLS_RESULT_FLAGS ResultFlags;
+    CXPLAT_TLS_PROCESS_STATE TlsState;
+
+    //
+    // In: the length of the copied TLS data. Out: the length TLS consumed.
+    //
+    uint32_t BufferLength;
+    uint8_t Buffer[0];
+
+} QUIC_CRYPTO_HANDSHAKE_OFFLOAD;
+
+CXPLAT_STATIC_ASSERT(
+    QUIC_PACKET_KEY_COUNT <= 8,
+    "NewReadKeys and NewWriteKeys hold a bit per key type");
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoFreeHandshakeOffload(
+    _In_ QUIC_CRYPTO_HANDSHAKE_OFFLOAD* Job
+    )
+{
+    for (size_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
+        if (Job->NewReadKeys & (1 << i)) {
+            QuicPacketKeyFree(Job->TlsState.ReadKeys[i]);
+        }
+        if (Job->NewWriteKeys & (1 << i)) {
+            QuicPacketKeyFree(Job->TlsState.WriteKeys[i]);
+        }
+    }
+    if (Job->TlsState.Buffer != NULL) {
+        CXPLAT_FREE(Job->TlsState.Buffer, QUIC_POOL_TLS_BUFFER);
+    }
+    CXPLAT_FREE(Job, QUIC_POOL_HANDSHAKE_OFFLOAD);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicCryptoDumpSendState(
@@ -98,6 +157,86 @@ QuicCryptoValidate(
 #define QuicCryptoValidate(Crypto)
 #endif
 
+//
+// Creates the Initial read and write keys, re-keying Initial keys retired by
+// earlier connections on the partition in place when there are any, so an
+// Initial that fails to decrypt doesn't cost cipher context allocations.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoCreateInitialKeys(
+    _In_ QUIC_CRYPTO* Crypto,
+    _In_ const QUIC_VERSION_INFO* VersionInfo,
+    _In_ uint8_t CidLength,
+    _In_reads_(CidLength)
+        const uint8_t* const Cid
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    QUIC_PACKET_KEY* ReadKey = QuicPartitionAcquireInitialKey(Connection->Partition);
+    QUIC_PACKET_KEY* WriteKey = NULL;
+
+    CXPLAT_DBG_ASSERT(Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL] == NULL);
+    CXPLAT_DBG_ASSERT(Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL] == NULL);
+
+    if (ReadKey != NULL) {
+        WriteKey = QuicPartitionAcquireInitialKey(Connection->Partition);
+        if (WriteKey == NULL) {
+            QuicPartitionReleaseInitialKey(Connection->Partition, ReadKey);
+            ReadKey = NULL;
+        }
+    }
+
+    if (ReadKey != NULL) {
+        QUIC_STATUS Status =
+            QuicPacketKeyRekeyInitial(
+                QuicConnIsServer(Connection),
+                &VersionInfo->HkdfLabels,
+                VersionInfo->Salt,
+                CidLength,
+                Cid,
+                ReadKey,
+                WriteKey);
+        if (QUIC_SUCCEEDED(Status)) {
+            Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL] = ReadKey;
+            Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL] = WriteKey;
+            return QUIC_STATUS_SUCCESS;
+        }
+        QuicPacketKeyFree(ReadKey);
+        QuicPacketKeyFree(WriteKey);
+    }
+
+    return
+        QuicPacketKeyCreateInitial(
+            QuicConnIsServer(Connection),
+            &VersionInfo->HkdfLabels,
+            VersionInfo->Salt,
+            CidLength,
+            Cid,
+            &Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL],
+            &Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL]);
+}
+
+//
+// Hands the Initial read and write keys back to the partition's cache.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoReleaseInitialKeys(
+    _In_ QUIC_CRYPTO* Crypto
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    QuicPartitionReleaseInitialKey(
+        Connection->Partition,
+        Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL]);
+    Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL] = NULL;
+    QuicPartitionReleaseInitialKey(
+        Connection->Partition,
+        Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL]);
+    Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL] = NULL;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicCryptoInitialize(
@@ -149,7 +288,8 @@ QuicCryptoInitialize(
             InitialRecvBufferLength,
             QUIC_DEFAULT_STREAM_FC_WINDOW_SIZE / 2,
             QUIC_RECV_BUF_MODE_SINGLE,
-            NULL);
+            Connection->Partition->RecvChunkPools,
+            FALSE);
     if (QUIC_FAILED(Status)) {
         goto Exit;
     }
@@ -179,14 +319,11 @@ QuicCryptoInitialize(
     }
 
     Status =
-        QuicPacketKeyCreateInitial(
-            QuicConnIsServer(Connection),
-            &VersionInfo->HkdfLabels,
-            VersionInfo->Salt,
+        QuicCryptoCreateInitialKeys(
+            Crypto,
+            VersionInfo,
             HandshakeCidLength,
-            HandshakeCid,
-            &Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL],
-            &Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL]);
+            HandshakeCid);
     if (QUIC_FAILED(Status)) {
         QuicTraceEvent(
             ConnErrorStatus,
@@ -229,12 +366,25 @@ QuicCryptoUninitialize(
     _In_ QUIC_CRYPTO* Crypto
     )
 {
+    if (Crypto->HandshakeOffload != NULL) {
+        //
+        // The completion operation was dropped with the rest of the queue.
+        //
+        CXPLAT_DBG_ASSERT(!Crypto->HandshakeOffloadPending);
+        QuicCryptoFreeHandshakeOffload(Crypto->HandshakeOffload);
+        Crypto->HandshakeOffload = NULL;
+    }
+    QuicCryptoReleaseInitialKeys(Crypto);
     for (size_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
         QuicPacketKeyFree(Crypto->TlsState.ReadKeys[i]);
         Crypto->TlsState.ReadKeys[i] = NULL;
         QuicPacketKeyFree(Crypto->TlsState.WriteKeys[i]);
         Crypto->TlsState.WriteKeys[i] = NULL;
     }
+    QuicPacketKeyFree(Crypto->SpareReadKey);
+    Crypto->SpareReadKey = NULL;
+    QuicPacketKeyFree(Crypto->SpareWriteKey);
+    Crypto->SpareWriteKey = NULL;
     if (Crypto->TLS != NULL) {
         CxPlatTlsUninitialize(Crypto->TLS);
         Crypto->TLS = NULL;
@@ -435,21 +585,15 @@ QuicCryptoOnVersionChange(
 
     if (Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL] != NULL) {
         CXPLAT_FRE_ASSERT(Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL] != NULL);
-        QuicPacketKeyFree(Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL]);
-        QuicPacketKeyFree(Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL]);
-        Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL] = NULL;
-        Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL] = NULL;
+        QuicCryptoReleaseInitialKeys(Crypto);
     }
 
     Status =
-        QuicPacketKeyCreateInitial(
-            QuicConnIsServer(Connection),
-            &VersionInfo->HkdfLabels,
-            VersionInfo->Salt,
+        QuicCryptoCreateInitialKeys(
+            Crypto,
+            VersionInfo,
             HandshakeCidLength,
-            HandshakeCid,
-            &Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL],
-            &Crypto->TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL]);
+            HandshakeCid);
     if (QUIC_FAILED(Status)) {
         QuicTraceEvent(
             ConnErrorStatus,
@@ -495,6 +639,19 @@ QuicCryptoHandshakeConfirmed(
     }
 
     QuicCryptoDiscardKeys(Crypto, QUIC_PACKET_KEY_HANDSHAKE);
+
+    //
+    // Nothing allocated from the handshake arena is needed anymore.
+    //
+    Connection->OrigDestCID = NULL;
+    Connection->PreferredAddress = NULL;
+    Connection->Send.InitialToken = NULL;
+    Connection->Send.InitialTokenLength = 0;
+    QuicArenaReset(&Connection->HandshakeArena);
+
+    if (QuicConnIsClient(Connection)) {
+        QuicConnMigrateToPreferredAddress(Connection);
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -519,10 +676,14 @@ QuicCryptoDiscardKeys(
         "Discarding key type = %hhu",
         (uint8_t)KeyType);
 
-    QuicPacketKeyFree(Crypto->TlsState.WriteKeys[KeyType]);
-    QuicPacketKeyFree(Crypto->TlsState.ReadKeys[KeyType]);
-    Crypto->TlsState.WriteKeys[KeyType] = NULL;
-    Crypto->TlsState.ReadKeys[KeyType] = NULL;
+    if (KeyType == QUIC_PACKET_KEY_INITIAL) {
+        QuicCryptoReleaseInitialKeys(Crypto);
+    } else {
+        QuicPacketKeyFree(Crypto->TlsState.WriteKeys[KeyType]);
+        QuicPacketKeyFree(Crypto->TlsState.ReadKeys[KeyType]);
+        Crypto->TlsState.WriteKeys[KeyType] = NULL;
+        Crypto->TlsState.ReadKeys[KeyType] = NULL;
+    }
 
     QUIC_ENCRYPT_LEVEL EncryptLevel = QuicKeyTypeToEncryptLevel(KeyType);
     _Analysis_assume_(EncryptLevel >= 0);
@@ -1643,6 +1804,9 @@ QuicCryptoProcessTlsCompletion(
         //
         Connection->State.Connected = TRUE;
         QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_CONNECTED);
+        QuicLatencyRecord(
+            Connection->Partition->Latency.Handshake,
+            CxPlatTimeDiff64(Connection->Stats.Timing.Start, CxPlatTimeUs64()));
 
         QuicConnGenerateNewSourceCids(Connection, FALSE);
 
@@ -1660,6 +1824,14 @@ QuicCryptoProcessTlsCompletion(
                     Crypto->TlsState.NegotiatedAlpn[0],
                     Crypto->TlsState.NegotiatedAlpn + 1);
             CXPLAT_TEL_ASSERT(Crypto->TlsState.NegotiatedAlpn != NULL);
+
+            if (Connection->RemoteServerName != NULL) {
+                QuicClientTicketCacheInsertVersion(
+                    &Connection->Registration->ClientTicketCache,
+                    Connection->RemoteServerName,
+                    Connection->RemoteServerPort,
+                    Connection->Stats.QuicVersion);
+            }
         }
 
         QUIC_CONNECTION_EVENT Event;
@@ -1682,7 +1854,7 @@ QuicCryptoProcessTlsCompletion(
         QUIC_PATH* Path = &Connection->Paths[0];
         CXPLAT_DBG_ASSERT(Path->IsActive);
 
-        if (Connection->Settings.EncryptionOffloadAllowed) {
+        if (Connection->Settings->EncryptionOffloadAllowed) {
             QuicPathUpdateQeo(Connection, Path, CXPLAT_QEO_OPERATION_ADD);
         }
 
@@ -1834,6 +2006,237 @@ QuicCryptoCustomTicketValidationComplete(
     Crypto->PendingValidationBufferLength = 0;
 }
 
+//
+// Queues the TLS processing of the server's first flight to a handshake
+// thread. Only this flight is offloaded: without resumption, TLS makes no
+// callbacks into the connection while processing the ClientHello, and the
+// server's signature dominates the cost of the handshake.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicCryptoOffloadHandshake(
+    _In_ QUIC_CRYPTO* Crypto,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+
+    if (MsQuicLib.HandshakeThreadsStarted == 0 ||
+        QuicConnIsClient(Connection) ||
+        Connection->State.ResumptionEnabled ||
+        Crypto->TlsState.ReadKey != QUIC_PACKET_KEY_INITIAL) {
+        return FALSE;
+    }
+
+    QUIC_CRYPTO_HANDSHAKE_OFFLOAD* Job =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_CRYPTO_HANDSHAKE_OFFLOAD) + BufferLength,
+            QUIC_POOL_HANDSHAKE_OFFLOAD);
+    if (Job == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "handshake offload",
+            sizeof(QUIC_CRYPTO_HANDSHAKE_OFFLOAD) + BufferLength);
+        return FALSE; // Process inline instead.
+    }
+
+    Job->TlsState = Crypto->TlsState;
+    Job->TlsState.BufferLength = 0;
+    Job->TlsState.Buffer =
+        CXPLAT_ALLOC_NONPAGED(Job->TlsState.BufferAllocLength, QUIC_POOL_TLS_BUFFER);
+    if (Job->TlsState.Buffer == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "handshake offload buffer",
+            Job->TlsState.BufferAllocLength);
+        CXPLAT_FREE(Job, QUIC_POOL_HANDSHAKE_OFFLOAD);
+        return FALSE; // Process inline instead.
+    }
+
+    Job->Crypto = Crypto;
+    Job->NewReadKeys = 0;
+    Job->NewWriteKeys = 0;
+    for (size_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
+        if (Crypto->TlsState.ReadKeys[i] == NULL) {
+            Job->NewReadKeys |= (uint8_t)(1 << i);
+        }
+        if (Crypto->TlsState.WriteKeys[i] == NULL) {
+            Job->NewWriteKeys |= (uint8_t)(1 << i);
+        }
+    }
+    Job->ResultFlags = 0;
+    Job->BufferLength = BufferLength;
+    CxPlatCopyMemory(Job->Buffer, Buffer, BufferLength);
+
+    Crypto->HandshakeOffload = Job;
+    Crypto->HandshakeOffloadPending = TRUE;
+    QuicConnAddRef(Connection, QUIC_CONN_REF_HANDSHAKE);
+    QuicLibraryQueueHandshakeOffload(&Job->Link);
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoProcessHandshakeOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    )
+{
+    QUIC_CRYPTO_HANDSHAKE_OFFLOAD* Job =
+        CXPLAT_CONTAINING_RECORD(Link, QUIC_CRYPTO_HANDSHAKE_OFFLOAD, Link);
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Job->Crypto);
+
+    Job->ResultFlags =
+        CxPlatTlsProcessData(
+            Job->Crypto->TLS,
+            CXPLAT_TLS_CRYPTO_DATA,
+            Job->Buffer,
+            &Job->BufferLength,
+            &Job->TlsState);
+
+    QUIC_OPERATION* ConnOper =
+        QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_HANDSHAKE_COMPLETION);
+    if (ConnOper != NULL) {
+        QuicConnQueueOper(Connection, ConnOper);
+    } else if (InterlockedCompareExchange16((short*)&Connection->BackUpOperUsed, 1, 0) == 0) {
+        QUIC_OPERATION* Oper = &Connection->BackUpOper;
+        Oper->FreeAfterProcess = FALSE;
+        Oper->Type = QUIC_OPER_TYPE_API_CALL;
+        Oper->API_CALL.Context = &Connection->BackupApiContext;
+        Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SHUTDOWN;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.ErrorCode = QUIC_ERROR_INTERNAL_ERROR;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = FALSE;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = TRUE;
+        QuicConnQueueHighestPriorityOper(Connection, Oper);
+    }
+
+    QuicConnRelease(Connection, QUIC_CONN_REF_HANDSHAKE);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoHandshakeOffloadComplete(
+    _In_ QUIC_CRYPTO* Crypto
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    QUIC_CRYPTO_HANDSHAKE_OFFLOAD* Job = Crypto->HandshakeOffload;
+    CXPLAT_DBG_ASSERT(Job != NULL);
+    CXPLAT_DBG_ASSERT(Crypto->HandshakeOffloadPending);
+
+    Crypto->HandshakeOffload = NULL;
+    Crypto->HandshakeOffloadPending = FALSE;
+
+    if (Connection->State.ShutdownComplete) {
+        QuicCryptoFreeHandshakeOffload(Job);
+        return;
+    }
+
+    CXPLAT_TLS_PROCESS_STATE* State = &Job->TlsState;
+    CXPLAT_TLS_RESULT_FLAGS ResultFlags = Job->ResultFlags;
+    uint32_t BufferConsumed = Job->BufferLength;
+
+    for (size_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
+        if (Job->NewReadKeys & (1 << i)) {
+            CXPLAT_DBG_ASSERT(Crypto->TlsState.ReadKeys[i] == NULL);
+            Crypto->TlsState.ReadKeys[i] = State->ReadKeys[i];
+        }
+        if (Job->NewWriteKeys & (1 << i)) {
+            CXPLAT_DBG_ASSERT(Crypto->TlsState.WriteKeys[i] == NULL);
+            Crypto->TlsState.WriteKeys[i] = State->WriteKeys[i];
+        }
+    }
+    Job->NewReadKeys = 0;
+    Job->NewWriteKeys = 0;
+
+    if (State->BufferLength != 0) {
+        if (Crypto->TlsState.BufferLength == 0) {
+            //
+            // Nothing is left to send from before, so just take the buffer.
+            //
+            CXPLAT_FREE(Crypto->TlsState.Buffer, QUIC_POOL_TLS_BUFFER);
+            Crypto->TlsState.Buffer = State->Buffer;
+            Crypto->TlsState.BufferAllocLength = State->BufferAllocLength;
+            Crypto->TlsState.BufferLength = State->BufferLength;
+            State->Buffer = NULL;
+
+        } else {
+            uint32_t NewBufferLength =
+                (uint32_t)Crypto->TlsState.BufferLength + State->BufferLength;
+            if (NewBufferLength > (uint32_t)Crypto->TlsState.BufferAllocLength) {
+                uint32_t NewBufferAllocLength = Crypto->TlsState.BufferAllocLength;
+                while (NewBufferLength > NewBufferAllocLength) {
+                    NewBufferAllocLength <<= 1;
+                }
+                if (NewBufferAllocLength > UINT16_MAX) {
+                    NewBufferAllocLength = UINT16_MAX;
+                }
+                uint8_t* NewBuffer =
+                    NewBufferLength > NewBufferAllocLength ?
+                        NULL :
+                        CXPLAT_ALLOC_NONPAGED(NewBufferAllocLength, QUIC_POOL_TLS_BUFFER);
+                if (NewBuffer == NULL) {
+                    QuicTraceEvent(
+                        AllocFailure,
+                        "Allocation of '%s' failed. (%llu bytes)",
+                        "New crypto Buffer",
+                        NewBufferAllocLength);
+                    ResultFlags |= CXPLAT_TLS_RESULT_ERROR;
+                    goto Exit;
+                }
+                CxPlatCopyMemory(
+                    NewBuffer,
+                    Crypto->TlsState.Buffer,
+                    Crypto->TlsState.BufferLength);
+                CXPLAT_FREE(Crypto->TlsState.Buffer, QUIC_POOL_TLS_BUFFER);
+                Crypto->TlsState.Buffer = NewBuffer;
+                Crypto->TlsState.BufferAllocLength = (uint16_t)NewBufferAllocLength;
+            }
+            CxPlatCopyMemory(
+                Crypto->TlsState.Buffer + Crypto->TlsState.BufferLength,
+                State->Buffer,
+                State->BufferLength);
+            Crypto->TlsState.BufferLength = (uint16_t)NewBufferLength;
+        }
+    }
+
+    Crypto->TlsState.HandshakeComplete = State->HandshakeComplete;
+    Crypto->TlsState.SessionResumed = State->SessionResumed;
+    Crypto->TlsState.EarlyDataState = State->EarlyDataState;
+    Crypto->TlsState.ReadKey = State->ReadKey;
+    Crypto->TlsState.WriteKey = State->WriteKey;
+    Crypto->TlsState.AlertCode = State->AlertCode;
+    Crypto->TlsState.BufferTotalLength = State->BufferTotalLength;
+    Crypto->TlsState.BufferOffsetHandshake = State->BufferOffsetHandshake;
+    Crypto->TlsState.BufferOffset1Rtt = State->BufferOffset1Rtt;
+
+Exit:
+
+    QuicCryptoFreeHandshakeOffload(Job);
+
+    Crypto->ResultFlags = ResultFlags;
+    QuicCryptoProcessDataComplete(Crypto, BufferConsumed);
+
+    //
+    // Anything held back while TLS was busy, such as the ACK of the client's
+    // Initial, goes out now along with the new flight.
+    //
+    QuicSendQueueFlush(&Connection->Send, REASON_CONNECTION_FLAGS);
+
+    if (!(ResultFlags & CXPLAT_TLS_RESULT_ERROR) &&
+        QuicRecvBufferHasUnreadData(&Crypto->RecvBuffer)) {
+        //
+        // More data was received while TLS was busy.
+        //
+        QuicCryptoProcessData(Crypto, FALSE);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicCryptoProcessData(
@@ -1853,6 +2256,14 @@ QuicCryptoProcessData(
         return Status;
     }
 
+    if (Crypto->HandshakeOffloadPending) {
+        //
+        // TLS is busy on a handshake thread. Any newly received data is
+        // processed once that completes.
+        //
+        return Status;
+    }
+
     if (IsClientInitial) {
         Buffer.Length = 0;
         Buffer.Buffer = NULL;
@@ -1918,6 +2329,9 @@ QuicCryptoProcessData(
             QuicRecvBufferDrain(&Crypto->RecvBuffer, 0);
             QuicCryptoValidate(Crypto);
 
+            Crypto->ClientHelloDigest =
+                QuicCryptoTlsGetClientRandomDigest(Buffer.Buffer, Buffer.Length);
+
             Info.QuicVersion = Connection->Stats.QuicVersion;
             Info.LocalAddress = &Connection->Paths[0].Route.LocalAddress;
             Info.RemoteAddress = &Connection->Paths[0].Route.RemoteAddress;
@@ -1955,6 +2369,10 @@ QuicCryptoProcessData(
 
     QuicCryptoValidate(Crypto);
 
+    if (QuicCryptoOffloadHandshake(Crypto, Buffer.Buffer, Buffer.Length)) {
+        return Status;
+    }
+
     Crypto->ResultFlags =
         CxPlatTlsProcessData(
             Crypto->TLS,
@@ -2010,6 +2428,36 @@ Error:
     return Status;
 }
 
+//
+// Derives the next phase's packet key, re-keying the spare key from the
+// previous key phase in place if there is one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoDeriveNextKey(
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_ QUIC_PACKET_KEY* CurrentKey,
+    _Inout_ QUIC_PACKET_KEY** SpareKey,
+    _Out_ QUIC_PACKET_KEY** NewKey
+    )
+{
+    if (*SpareKey == NULL) {
+        return QuicPacketKeyUpdate(HkdfLabels, CurrentKey, NewKey);
+    }
+
+    QUIC_PACKET_KEY* Key = *SpareKey;
+    *SpareKey = NULL;
+
+    QUIC_STATUS Status = QuicPacketKeyUpdateInPlace(HkdfLabels, CurrentKey, Key);
+    if (QUIC_FAILED(Status)) {
+        QuicPacketKeyFree(Key);
+        return Status;
+    }
+
+    *NewKey = Key;
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicCryptoGenerateNewKeys(
@@ -2038,9 +2486,10 @@ QuicCryptoGenerateNewKeys(
         // Make New packet key.
         //
         Status =
-            QuicPacketKeyUpdate(
+            QuicCryptoDeriveNextKey(
                 &VersionInfo->HkdfLabels,
                 Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT],
+                &Connection->Crypto.SpareReadKey,
                 NewReadKey);
         if (QUIC_FAILED(Status)) {
             QuicTraceEvent(
@@ -2053,9 +2502,10 @@ QuicCryptoGenerateNewKeys(
         }
 
         Status =
-            QuicPacketKeyUpdate(
+            QuicCryptoDeriveNextKey(
                 &VersionInfo->HkdfLabels,
                 Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT],
+                &Connection->Crypto.SpareWriteKey,
                 NewWriteKey);
         if (QUIC_FAILED(Status)) {
             QuicTraceEvent(
@@ -2091,10 +2541,12 @@ QuicCryptoUpdateKeyPhase(
     )
 {
     //
-    // Free the old read key state (if it exists).
+    // Retire the old read key state (if it exists) as the spare for the next
+    // key phase.
     //
     QUIC_PACKET_KEY** Old = &Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT_OLD];
-    QuicPacketKeyFree(*Old);
+    QuicPacketKeyFree(Connection->Crypto.SpareReadKey);
+    Connection->Crypto.SpareReadKey = *Old;
 
     QUIC_PACKET_KEY** Current = &Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT];
     QUIC_PACKET_KEY** New = &Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT_NEW];
@@ -2116,10 +2568,12 @@ QuicCryptoUpdateKeyPhase(
     *New = NULL;
 
     //
-    // Free the old write key state (if it exists).
+    // Retire the old write key state (if it exists) as the spare for the next
+    // key phase.
     //
     Old = &Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT_OLD];
-    QuicPacketKeyFree(*Old);
+    QuicPacketKeyFree(Connection->Crypto.SpareWriteKey);
+    Connection->Crypto.SpareWriteKey = *Old;
 
     Current = &Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT];
     New = &Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT_NEW];
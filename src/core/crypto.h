@@ -39,11 +39,29 @@ typedef struct QUIC_CRYPTO {
     //
     BOOLEAN CertValidationPending : 1;
 
+    //
+    // Indicates TLS is processing received data on a handshake thread.
+    //
+    BOOLEAN HandshakeOffloadPending : 1;
+
     //
     // The TLS context for processing handshake messages.
     //
     CXPLAT_TLS* TLS;
 
+    //
+    // The handshake thread job, outstanding or waiting to be merged back on
+    // the connection's worker.
+    //
+    struct QUIC_CRYPTO_HANDSHAKE_OFFLOAD* HandshakeOffload;
+
+    //
+    // 1-RTT packet keys retired by the last key phase change, kept to be
+    // re-keyed in place into the next phase's keys instead of reallocated.
+    //
+    QUIC_PACKET_KEY* SpareReadKey;
+    QUIC_PACKET_KEY* SpareWriteKey;
+
     //
     // Send State
     //
@@ -97,8 +115,21 @@ typedef struct QUIC_CRYPTO {
     //
     BOOLEAN TicketValidationPending : 1;
     BOOLEAN TicketValidationRejecting : 1;
+
+    //
+    // Indicates the ClientHello has been checked against the registration's
+    // 0-RTT anti-replay filter. A second ClientHello, after a
+    // HelloRetryRequest, has the same random and isn't checked again.
+    //
+    BOOLEAN AntiReplayChecked : 1;
+    BOOLEAN AntiReplayRefused : 1;
     uint32_t PendingValidationBufferLength;
 
+    //
+    // Server side digest of the ClientHello's random, for 0-RTT anti-replay.
+    //
+    uint64_t ClientHelloDigest;
+
     //
     // The offset the current receive encryption level starts.
     //
@@ -276,6 +307,25 @@ QuicCryptoCustomCertValidationComplete(
     _In_ QUIC_TLS_ALERT_CODES TlsAlert
     );
 
+//
+// Runs an offloaded TLS process call. Invoked on a handshake thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoProcessHandshakeOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    );
+
+//
+// Merges the result of an offloaded TLS process call back into the
+// connection's crypto state. Invoked on the connection's worker.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoHandshakeOffloadComplete(
+    _In_ QUIC_CRYPTO* Crypto
+    );
+
 //
 // Invoked when the app has completed its custom resumption ticket validation.
 //
@@ -327,7 +377,20 @@ QuicCryptoTlsReadClientRandom(
     );
 
 //
-// Generates new 1-RTT read and write keys, unless they already exist.
+// Returns a digest of the ClientRandom in the initial CRYPTO data.
+// MUST ONLY BE CALLED AFTER QuicCryptoTlsReadInitial!!
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicCryptoTlsGetClientRandomDigest(
+    _In_reads_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    );
+
+//
+// Generates new 1-RTT read and write keys, unless they already exist. Spare
+// keys from the previous key phase are reused if available.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -336,8 +399,8 @@ QuicCryptoGenerateNewKeys(
     );
 
 //
-// Shift 1-RTT keys, freeing the old keys and replacing them with the current
-// keys, replacing the current keys with the new keys; update the start packet
+// Shift 1-RTT keys, retiring the old keys as spares and replacing them with the
+// current keys, replacing the current keys with the new keys; update the start packet
 // number; and invert the key phase bit.
 // If the shift is locally-initiated, then set the flag to await confirmation
 // of the key update from the peer.
@@ -68,6 +68,9 @@ typedef enum eSniNameType {
 #define QUIC_TP_ID_GREASE_QUIC_BIT                          0x2AB2          // N/A
 #define QUIC_TP_ID_RELIABLE_RESET_ENABLED                   0x17f7586d2cb570   // varint
 #define QUIC_TP_ID_ENABLE_TIMESTAMP                         0x7158          // varint
+#define QUIC_TP_ID_INITIAL_MAX_PATH_ID                      0x0f739bbc1b666d0cULL // varint
+#define QUIC_TP_ID_MAX_RECEIVE_TIMESTAMPS_PER_ACK           0xff0a002       // varint
+#define QUIC_TP_ID_RECEIVE_TIMESTAMPS_EXPONENT              0xff0a003       // varint
 
 BOOLEAN
 QuicTpIdIsReserved(
@@ -715,6 +718,34 @@ QuicCryptoTlsReadClientRandom(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicCryptoTlsGetClientRandomDigest(
+    _In_reads_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    )
+{
+    UNREFERENCED_PARAMETER(BufferLength);
+    CXPLAT_DBG_ASSERT(
+        BufferLength >=
+        TLS_MESSAGE_HEADER_LENGTH + sizeof(uint16_t) + TLS_RANDOM_LENGTH);
+
+    //
+    // The random is unpredictable for any legitimate client, so folding it is
+    // enough. A peer choosing its random to collide with another ClientHello
+    // can only get that one's ticket refused, as replaying it would.
+    //
+    Buffer += TLS_MESSAGE_HEADER_LENGTH + sizeof(uint16_t);
+    uint64_t Digest = 0;
+    for (uint32_t i = 0; i < TLS_RANDOM_LENGTH; i += sizeof(uint64_t)) {
+        uint64_t Word;
+        memcpy(&Word, Buffer + i, sizeof(Word));
+        Digest ^= Word;
+    }
+    return Digest;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != NULL)
 const uint8_t*
@@ -823,7 +854,11 @@ QuicCryptoTlsEncodeTransportParameters(
     }
     if (TransportParams->Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
         CXPLAT_DBG_ASSERT(IsServerTP);
-        CXPLAT_FRE_ASSERT(FALSE); // TODO - Implement
+        CXPLAT_FRE_ASSERT(TransportParams->PreferredAddressCidLength <= QUIC_MAX_CONNECTION_ID_LENGTH_V1);
+        RequiredTPLen +=
+            TlsTransportParamLength(
+                QUIC_TP_ID_PREFERRED_ADDRESS,
+                QUIC_TP_PREFERRED_ADDRESS_LENGTH(TransportParams->PreferredAddressCidLength));
     }
     if (TransportParams->Flags & QUIC_TP_FLAG_ACTIVE_CONNECTION_ID_LIMIT) {
         RequiredTPLen +=
@@ -904,6 +939,24 @@ QuicCryptoTlsEncodeTransportParameters(
                 QUIC_TP_ID_ENABLE_TIMESTAMP,
                 QuicVarIntSize(value));
     }
+    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_PATH_ID) {
+        RequiredTPLen +=
+            TlsTransportParamLength(
+                QUIC_TP_ID_INITIAL_MAX_PATH_ID,
+                QuicVarIntSize(TransportParams->InitialMaxPathId));
+    }
+    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK) {
+        RequiredTPLen +=
+            TlsTransportParamLength(
+                QUIC_TP_ID_MAX_RECEIVE_TIMESTAMPS_PER_ACK,
+                QuicVarIntSize(TransportParams->MaxReceiveTimestampsPerAck));
+    }
+    if (TransportParams->Flags & QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT) {
+        RequiredTPLen +=
+            TlsTransportParamLength(
+                QUIC_TP_ID_RECEIVE_TIMESTAMPS_EXPONENT,
+                QuicVarIntSize(TransportParams->ReceiveTimestampsExponent));
+    }
     if (TestParam != NULL) {
         RequiredTPLen +=
             TlsTransportParamLength(
@@ -1095,7 +1148,41 @@ QuicCryptoTlsEncodeTransportParameters(
     }
     if (TransportParams->Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
         CXPLAT_DBG_ASSERT(IsServerTP);
-        CXPLAT_FRE_ASSERT(FALSE); // TODO - Implement
+        //
+        // Only the family of the configured address is filled in; the other
+        // is left all zero, which marks it as absent.
+        //
+        uint8_t PreferredAddress[QUIC_TP_PREFERRED_ADDRESS_LENGTH(QUIC_MAX_CONNECTION_ID_LENGTH_V1)];
+        const QUIC_ADDR* Addr = &TransportParams->PreferredAddress;
+        const uint16_t Port = QuicAddrGetPort(Addr);
+        uint8_t* Cursor = PreferredAddress;
+        CxPlatZeroMemory(PreferredAddress, 4 + 2 + 16 + 2);
+        if (QuicAddrGetFamily(Addr) == QUIC_ADDRESS_FAMILY_INET) {
+            CxPlatCopyMemory(Cursor, &Addr->Ipv4.sin_addr, 4);
+            Cursor[4] = (uint8_t)(Port >> 8);
+            Cursor[5] = (uint8_t)Port;
+        } else {
+            CxPlatCopyMemory(Cursor + 6, &Addr->Ipv6.sin6_addr, 16);
+            Cursor[22] = (uint8_t)(Port >> 8);
+            Cursor[23] = (uint8_t)Port;
+        }
+        Cursor += 4 + 2 + 16 + 2;
+        *Cursor++ = TransportParams->PreferredAddressCidLength;
+        CxPlatCopyMemory(
+            Cursor,
+            TransportParams->PreferredAddressCid,
+            TransportParams->PreferredAddressCidLength);
+        Cursor += TransportParams->PreferredAddressCidLength;
+        CxPlatCopyMemory(
+            Cursor,
+            TransportParams->PreferredAddressResetToken,
+            QUIC_STATELESS_RESET_TOKEN_LENGTH);
+        TPBuf =
+            TlsWriteTransportParam(
+                QUIC_TP_ID_PREFERRED_ADDRESS,
+                (uint16_t)QUIC_TP_PREFERRED_ADDRESS_LENGTH(TransportParams->PreferredAddressCidLength),
+                PreferredAddress,
+                TPBuf);
         QuicTraceLogConnVerbose(
             EncodeTPPreferredAddress,
             Connection,
@@ -1246,6 +1333,42 @@ QuicCryptoTlsEncodeTransportParameters(
             "TP: Timestamp (%u)",
             value);
     }
+    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_PATH_ID) {
+        TPBuf =
+            TlsWriteTransportParamVarInt(
+                QUIC_TP_ID_INITIAL_MAX_PATH_ID,
+                TransportParams->InitialMaxPathId,
+                TPBuf);
+        QuicTraceLogConnVerbose(
+            EncodeTPInitialMaxPathId,
+            Connection,
+            "TP: Initial Max Path ID (%llu)",
+            TransportParams->InitialMaxPathId);
+    }
+    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK) {
+        TPBuf =
+            TlsWriteTransportParamVarInt(
+                QUIC_TP_ID_MAX_RECEIVE_TIMESTAMPS_PER_ACK,
+                TransportParams->MaxReceiveTimestampsPerAck,
+                TPBuf);
+        QuicTraceLogConnVerbose(
+            EncodeTPMaxReceiveTimestampsPerAck,
+            Connection,
+            "TP: Max Receive Timestamps Per ACK (%llu)",
+            TransportParams->MaxReceiveTimestampsPerAck);
+    }
+    if (TransportParams->Flags & QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT) {
+        TPBuf =
+            TlsWriteTransportParamVarInt(
+                QUIC_TP_ID_RECEIVE_TIMESTAMPS_EXPONENT,
+                TransportParams->ReceiveTimestampsExponent,
+                TPBuf);
+        QuicTraceLogConnVerbose(
+            EncodeTPReceiveTimestampsExponent,
+            Connection,
+            "TP: Receive Timestamps Exponent (%llu)",
+            TransportParams->ReceiveTimestampsExponent);
+    }
     if (TestParam != NULL) {
         TPBuf =
             TlsWriteTransportParam(
@@ -1691,11 +1814,67 @@ QuicCryptoTlsDecodeTransportParameters( // NOLINT(readability-function-size, goo
                     "Client incorrectly provided preferred address");
                 goto Exit;
             }
+            if (Length < QUIC_TP_PREFERRED_ADDRESS_LENGTH(1) ||
+                Length > QUIC_TP_PREFERRED_ADDRESS_LENGTH(QUIC_MAX_CONNECTION_ID_LENGTH_V1) ||
+                Length != QUIC_TP_PREFERRED_ADDRESS_LENGTH(TPBuf[Offset + 4 + 2 + 16 + 2])) {
+                QuicTraceEvent(
+                    ConnErrorStatus,
+                    "[conn][%p] ERROR, %u, %s.",
+                    Connection,
+                    Length,
+                    "Invalid length of QUIC_TP_ID_PREFERRED_ADDRESS");
+                goto Exit;
+            } else {
+                const uint8_t* Ipv4 = TPBuf + Offset;
+                const uint8_t* Ipv6 = Ipv4 + 4 + 2;
+                const uint8_t* CidField = Ipv6 + 16 + 2;
+                const uint8_t Zero[16 + 2] = { 0 };
+                const BOOLEAN HasIpv4 = memcmp(Ipv4, Zero, 4 + 2) != 0;
+                const BOOLEAN HasIpv6 = memcmp(Ipv6, Zero, 16 + 2) != 0;
+                if (!HasIpv4 && !HasIpv6) {
+                    QuicTraceEvent(
+                        ConnError,
+                        "[conn][%p] ERROR, %s.",
+                        Connection,
+                        "Preferred address has no address");
+                    goto Exit;
+                }
+                //
+                // Keep the address of the family the connection is already
+                // using, if the server offered one.
+                //
+                BOOLEAN UseIpv6 = !HasIpv4;
+                if (HasIpv4 && HasIpv6 && Connection != NULL) {
+                    UseIpv6 =
+                        QuicAddrGetFamily(&Connection->Paths[0].Route.RemoteAddress) ==
+                            QUIC_ADDRESS_FAMILY_INET6;
+                }
+                QUIC_ADDR* Addr = &TransportParams->PreferredAddress;
+                CxPlatZeroMemory(Addr, sizeof(*Addr));
+                if (UseIpv6) {
+                    QuicAddrSetFamily(Addr, QUIC_ADDRESS_FAMILY_INET6);
+                    CxPlatCopyMemory(&Addr->Ipv6.sin6_addr, Ipv6, 16);
+                    QuicAddrSetPort(Addr, (uint16_t)((Ipv6[16] << 8) | Ipv6[17]));
+                } else {
+                    QuicAddrSetFamily(Addr, QUIC_ADDRESS_FAMILY_INET);
+                    CxPlatCopyMemory(&Addr->Ipv4.sin_addr, Ipv4, 4);
+                    QuicAddrSetPort(Addr, (uint16_t)((Ipv4[4] << 8) | Ipv4[5]));
+                }
+                TransportParams->PreferredAddressCidLength = CidField[0];
+                CxPlatCopyMemory(
+                    TransportParams->PreferredAddressCid,
+                    CidField + 1,
+                    CidField[0]);
+                CxPlatCopyMemory(
+                    TransportParams->PreferredAddressResetToken,
+                    CidField + 1 + CidField[0],
+                    QUIC_STATELESS_RESET_TOKEN_LENGTH);
+            }
+            TransportParams->Flags |= QUIC_TP_FLAG_PREFERRED_ADDRESS;
             QuicTraceLogConnVerbose(
                 DecodeTPPreferredAddress,
                 Connection,
                 "TP: Preferred Address");
-            // TODO - Implement
             break;
 
         case QUIC_TP_ID_ACTIVE_CONNECTION_ID_LIMIT:
@@ -1953,6 +2132,76 @@ QuicCryptoTlsDecodeTransportParameters( // NOLINT(readability-function-size, goo
             break;
         }
 
+        case QUIC_TP_ID_INITIAL_MAX_PATH_ID:
+            if (!TRY_READ_VAR_INT(TransportParams->InitialMaxPathId)) {
+                QuicTraceEvent(
+                    ConnErrorStatus,
+                    "[conn][%p] ERROR, %u, %s.",
+                    Connection,
+                    Length,
+                    "Invalid length of QUIC_TP_ID_INITIAL_MAX_PATH_ID");
+                goto Exit;
+            }
+            if (TransportParams->InitialMaxPathId > QUIC_TP_MAX_PATH_ID_MAX) {
+                QuicTraceEvent(
+                    ConnError,
+                    "[conn][%p] ERROR, %s.",
+                    Connection,
+                    "Invalid value of QUIC_TP_ID_INITIAL_MAX_PATH_ID");
+                goto Exit;
+            }
+            TransportParams->Flags |= QUIC_TP_FLAG_INITIAL_MAX_PATH_ID;
+            QuicTraceLogConnVerbose(
+                DecodeTPInitialMaxPathId,
+                Connection,
+                "TP: Initial Max Path ID (%llu)",
+                TransportParams->InitialMaxPathId);
+            break;
+
+        case QUIC_TP_ID_MAX_RECEIVE_TIMESTAMPS_PER_ACK:
+            if (!TRY_READ_VAR_INT(TransportParams->MaxReceiveTimestampsPerAck)) {
+                QuicTraceEvent(
+                    ConnErrorStatus,
+                    "[conn][%p] ERROR, %u, %s.",
+                    Connection,
+                    Length,
+                    "Invalid length of QUIC_TP_ID_MAX_RECEIVE_TIMESTAMPS_PER_ACK");
+                goto Exit;
+            }
+            TransportParams->Flags |= QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK;
+            QuicTraceLogConnVerbose(
+                DecodeTPMaxReceiveTimestampsPerAck,
+                Connection,
+                "TP: Max Receive Timestamps Per ACK (%llu)",
+                TransportParams->MaxReceiveTimestampsPerAck);
+            break;
+
+        case QUIC_TP_ID_RECEIVE_TIMESTAMPS_EXPONENT:
+            if (!TRY_READ_VAR_INT(TransportParams->ReceiveTimestampsExponent)) {
+                QuicTraceEvent(
+                    ConnErrorStatus,
+                    "[conn][%p] ERROR, %u, %s.",
+                    Connection,
+                    Length,
+                    "Invalid length of QUIC_TP_ID_RECEIVE_TIMESTAMPS_EXPONENT");
+                goto Exit;
+            }
+            if (TransportParams->ReceiveTimestampsExponent > QUIC_TP_RECEIVE_TIMESTAMPS_EXPONENT_MAX) {
+                QuicTraceEvent(
+                    ConnError,
+                    "[conn][%p] ERROR, %s.",
+                    Connection,
+                    "Invalid value of QUIC_TP_ID_RECEIVE_TIMESTAMPS_EXPONENT");
+                goto Exit;
+            }
+            TransportParams->Flags |= QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT;
+            QuicTraceLogConnVerbose(
+                DecodeTPReceiveTimestampsExponent,
+                Connection,
+                "TP: Receive Timestamps Exponent (%llu)",
+                TransportParams->ReceiveTimestampsExponent);
+            break;
+
         default:
             if (QuicTpIdIsReserved(Id)) {
                 QuicTraceLogConnWarning(
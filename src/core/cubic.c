@@ -86,7 +86,7 @@ CubicCongestionHyStartChangeState(
     )
 {
     QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
-    if (!Connection->Settings.HyStartEnabled) {
+    if (!Connection->Settings->HyStartEnabled) {
         return;
     }
     QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Cc->Cubic;
@@ -163,6 +163,7 @@ CubicCongestionControlReset(
     CubicCongestionHyStartChangeState(Cc, HYSTART_NOT_STARTED);
     Cubic->IsInRecovery = FALSE;
     Cubic->HasHadCongestionEvent = FALSE;
+    Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
     Cubic->CongestionWindow = DatagramPayloadLength * Cubic->InitialWindowPackets;
     Cubic->BytesInFlightMax = Cubic->CongestionWindow / 2;
     Cubic->LastSendAllowance = 0;
@@ -174,6 +175,32 @@ CubicCongestionControlReset(
     QuicConnLogCubic(Connection);
 }
 
+//
+// Since the window grows via ACK feedback and since we defer packets when
+// pacing, using the current window to calculate the pacing interval can slow
+// the growth of the window. So instead, use the predicted window of the next
+// round trip. In slowstart, this is double the current window. In congestion
+// avoidance the growth function is more complicated, and we use a simple
+// estimate of 25% growth.
+//
+QUIC_INLINE
+uint64_t
+CubicCongestionControlGetEstimatedWindow(
+    _In_ const QUIC_CONGESTION_CONTROL_CUBIC* Cubic
+    )
+{
+    uint64_t EstimatedWnd;
+    if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
+        EstimatedWnd = (uint64_t)Cubic->CongestionWindow << 1;
+        if (EstimatedWnd > Cubic->SlowStartThreshold) {
+            EstimatedWnd = Cubic->SlowStartThreshold;
+        }
+    } else {
+        EstimatedWnd = Cubic->CongestionWindow + (Cubic->CongestionWindow >> 2); // CongestionWindow * 1.25
+    }
+    return EstimatedWnd;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 uint32_t
 CubicCongestionControlGetSendAllowance(
@@ -194,7 +221,7 @@ CubicCongestionControlGetSendAllowance(
 
     } else if (
         !TimeSinceLastSendValid ||
-        !Connection->Settings.PacingEnabled ||
+        !Connection->Settings->PacingEnabled ||
         !Connection->Paths[0].GotFirstRttSample ||
         Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
         //
@@ -210,23 +237,7 @@ CubicCongestionControlGetSendAllowance(
         // size) as the time since the last send times the pacing rate (CWND / RTT).
         //
 
-        //
-        // Since the window grows via ACK feedback and since we defer packets
-        // when pacing, using the current window to calculate the pacing
-        // interval can slow the growth of the window. So instead, use the
-        // predicted window of the next round trip. In slowstart, this is double
-        // the current window. In congestion avoidance the growth function is
-        // more complicated, and we use a simple estimate of 25% growth.
-        //
-        uint64_t EstimatedWnd;
-        if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
-            EstimatedWnd = (uint64_t)Cubic->CongestionWindow << 1;
-            if (EstimatedWnd > Cubic->SlowStartThreshold) {
-                EstimatedWnd = Cubic->SlowStartThreshold;
-            }
-        } else {
-            EstimatedWnd = Cubic->CongestionWindow + (Cubic->CongestionWindow >> 2); // CongestionWindow * 1.25
-        }
+        uint64_t EstimatedWnd = CubicCongestionControlGetEstimatedWindow(Cubic);
 
         SendAllowance =
             Cubic->LastSendAllowance +
@@ -241,6 +252,29 @@ CubicCongestionControlGetSendAllowance(
     return SendAllowance;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+CubicCongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Cc->Cubic;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    if (!Connection->Settings->PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+        return 0;
+    }
+
+    //
+    // The same rate GetSendAllowance paces at: the estimated window per RTT.
+    //
+    return
+        S_TO_US(CubicCongestionControlGetEstimatedWindow(Cubic)) /
+        Connection->Paths[0].SmoothedRtt;
+}
+
 //
 // Returns TRUE if we became unblocked.
 //
@@ -285,6 +319,7 @@ CubicCongestionControlOnCongestionEvent(
         "[conn][%p] Congestion event: IsEcn=%hu",
         Connection,
         Ecn);
+    QuicTraceProbe(congestion_event, Connection, Ecn);
     Connection->Stats.Send.CongestionCount++;
 
     Cubic->IsInRecovery = TRUE;
@@ -433,6 +468,92 @@ CubicCongestionControlGetNetworkStatistics(
     NetworkStatistics->Bandwidth = Cubic->CongestionWindow / Path->SmoothedRtt;
 }
 
+//
+// Called on loss or ECN while Careful Resume is in progress. After the jump,
+// the window falls back to what the path has been seen to deliver rather than
+// being derived from the (possibly too large) jump window.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CubicCongestionControlCarefulResumeOnCongestion(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Cc->Cubic;
+
+    if (Cubic->CarefulResumePhase == CAREFUL_RESUME_UNVALIDATED ||
+        Cubic->CarefulResumePhase == CAREFUL_RESUME_VALIDATING) {
+        //
+        // Safe retreat.
+        //
+        Cubic->CongestionWindow = Cubic->CarefulResumePipeSize;
+    }
+    Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
+}
+
+//
+// Advances the Careful Resume phases on ACK. Returns TRUE if the window must
+// not grow from this ACK.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CubicCongestionControlCarefulResumeOnAck(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Cc->Cubic;
+
+    switch (Cubic->CarefulResumePhase) {
+    case CAREFUL_RESUME_RECONNAISSANCE:
+        //
+        // Only jump if the current RTT confirms the saved one is still
+        // representative of the path, and slow start hasn't ended already.
+        //
+        if (AckEvent->SmoothedRtt < Cubic->CarefulResumeSavedRtt / 2 ||
+            AckEvent->SmoothedRtt > Cubic->CarefulResumeSavedRtt * 10 ||
+            Cubic->CongestionWindow >= Cubic->SlowStartThreshold ||
+            Cubic->CongestionWindow >= Cubic->CarefulResumeJumpWindow) {
+            Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
+            return FALSE;
+        }
+        Cubic->CarefulResumePipeSize = Cubic->CongestionWindow;
+        Cubic->CongestionWindow = Cubic->CarefulResumeJumpWindow;
+        Cubic->BytesInFlightMax =
+            CXPLAT_MAX(Cubic->BytesInFlightMax, Cubic->CongestionWindow / 2);
+        Cubic->CarefulResumePacketNumber = AckEvent->LargestSentPacketNumber;
+        Cubic->CarefulResumePhase = CAREFUL_RESUME_UNVALIDATED;
+        return TRUE;
+
+    case CAREFUL_RESUME_UNVALIDATED:
+        Cubic->CarefulResumePipeSize += AckEvent->NumRetransmittableBytes;
+        if (AckEvent->LargestAck > Cubic->CarefulResumePacketNumber) {
+            //
+            // The first packet sent after the jump was acknowledged. Reduce
+            // the window to what is actually in use and wait for the rest of
+            // the data sent with the jump window to be acknowledged.
+            //
+            Cubic->CongestionWindow =
+                CXPLAT_MIN(
+                    Cubic->CongestionWindow,
+                    CXPLAT_MAX(Cubic->CarefulResumePipeSize, Cubic->BytesInFlight));
+            Cubic->CarefulResumePacketNumber = AckEvent->LargestSentPacketNumber;
+            Cubic->CarefulResumePhase = CAREFUL_RESUME_VALIDATING;
+        }
+        return TRUE;
+
+    case CAREFUL_RESUME_VALIDATING:
+        Cubic->CarefulResumePipeSize += AckEvent->NumRetransmittableBytes;
+        if (AckEvent->LargestAck >= Cubic->CarefulResumePacketNumber) {
+            Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
+        }
+        return FALSE;
+
+    default:
+        return FALSE;
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 CubicCongestionControlOnDataAcknowledged(
@@ -470,10 +591,15 @@ CubicCongestionControlOnDataAcknowledged(
         goto Exit;
     }
 
+    if (Cubic->CarefulResumePhase != CAREFUL_RESUME_NONE &&
+        CubicCongestionControlCarefulResumeOnAck(Cc, AckEvent)) {
+        goto Exit;
+    }
+
     //
     // Update HyStart++ RTT sample.
     //
-    if (Connection->Settings.HyStartEnabled && Cubic->HyStartState != HYSTART_DONE) {
+    if (Connection->Settings->HyStartEnabled && Cubic->HyStartState != HYSTART_DONE) {
         if (AckEvent->MinRttValid) {
             //
             // Update Min RTT for the first N ACKs.
@@ -652,8 +778,8 @@ CubicCongestionControlOnDataAcknowledged(
             Cubic->AimdAccumulator += BytesAcked;
         }
         if (Cubic->AimdAccumulator > Cubic->AimdWindow) {
-            Cubic->AimdWindow += DatagramPayloadLength;
             Cubic->AimdAccumulator -= Cubic->AimdWindow;
+            Cubic->AimdWindow += DatagramPayloadLength;
         }
 
         if (Cubic->AimdWindow > CubicWindow) {
@@ -689,7 +815,7 @@ Exit:
     Cubic->TimeOfLastAck = TimeNowUs;
     Cubic->TimeOfLastAckValid = TRUE;
 
-    if (Connection->Settings.NetStatsEventEnabled) {
+    if (Connection->Settings->NetStatsEventEnabled) {
         const QUIC_PATH* Path = &Connection->Paths[0];
         QUIC_CONNECTION_EVENT Event;
         Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
@@ -736,6 +862,9 @@ CubicCongestionControlOnDataLost(
         LossEvent->LargestPacketNumberLost > Cubic->RecoverySentPacketNumber) {
 
         Cubic->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
+        if (Cubic->CarefulResumePhase != CAREFUL_RESUME_NONE) {
+            CubicCongestionControlCarefulResumeOnCongestion(Cc);
+        }
         CubicCongestionControlOnCongestionEvent(
             Cc,
             LossEvent->PersistentCongestion,
@@ -772,6 +901,9 @@ CubicCongestionControlOnEcn(
 
         Cubic->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
         QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
+        if (Cubic->CarefulResumePhase != CAREFUL_RESUME_NONE) {
+            CubicCongestionControlCarefulResumeOnCongestion(Cc);
+        }
         CubicCongestionControlOnCongestionEvent(
             Cc,
             FALSE,
@@ -889,12 +1021,41 @@ CubicCongestionControlSetAppLimited(
     UNREFERENCED_PARAMETER(Cc);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CubicCongestionControlSetCarefulResumeState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_CONN_CAREFUL_RESUME_STATE* State
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Cc->Cubic;
+
+    //
+    // Only jump to half the saved window, and only if that is actually an
+    // increase and the connection is still in its first slow start.
+    //
+    const uint32_t JumpWindow = State->CongestionWindow / 2;
+    if (Cubic->HasHadCongestionEvent ||
+        State->SmoothedRtt == 0 ||
+        JumpWindow <= Cubic->CongestionWindow) {
+        return;
+    }
+
+    Cubic->CarefulResumeJumpWindow = JumpWindow;
+    Cubic->CarefulResumeSavedRtt = State->SmoothedRtt;
+    Cubic->CarefulResumePipeSize = 0;
+    Cubic->CarefulResumePhase = CAREFUL_RESUME_RECONNAISSANCE;
+}
+
 static const QUIC_CONGESTION_CONTROL QuicCongestionControlCubic = {
     .Name = "Cubic",
+    .Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC,
     .QuicCongestionControlCanSend = CubicCongestionControlCanSend,
     .QuicCongestionControlSetExemption = CubicCongestionControlSetExemption,
     .QuicCongestionControlReset = CubicCongestionControlReset,
     .QuicCongestionControlGetSendAllowance = CubicCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = CubicCongestionControlGetPacingRate,
+    .QuicCongestionControlGetDeliveryRate = NULL,
     .QuicCongestionControlOnDataSent = CubicCongestionControlOnDataSent,
     .QuicCongestionControlOnDataInvalidated = CubicCongestionControlOnDataInvalidated,
     .QuicCongestionControlOnDataAcknowledged = CubicCongestionControlOnDataAcknowledged,
@@ -907,7 +1068,8 @@ static const QUIC_CONGESTION_CONTROL QuicCongestionControlCubic = {
     .QuicCongestionControlIsAppLimited = CubicCongestionControlIsAppLimited,
     .QuicCongestionControlSetAppLimited = CubicCongestionControlSetAppLimited,
     .QuicCongestionControlGetCongestionWindow = CubicCongestionControlGetCongestionWindow,
-    .QuicCongestionControlGetNetworkStatistics = CubicCongestionControlGetNetworkStatistics
+    .QuicCongestionControlGetNetworkStatistics = CubicCongestionControlGetNetworkStatistics,
+    .QuicCongestionControlSetCarefulResumeState = CubicCongestionControlSetCarefulResumeState
 };
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -17,6 +17,16 @@ typedef enum QUIC_CUBIC_HYSTART_STATE {
     HYSTART_DONE = 2
 } QUIC_CUBIC_HYSTART_STATE;
 
+//
+// Careful Resume phases (draft-ietf-tsvwg-careful-resume).
+//
+typedef enum QUIC_CUBIC_CAREFUL_RESUME_PHASE {
+    CAREFUL_RESUME_NONE = 0,            // Not used, or finished.
+    CAREFUL_RESUME_RECONNAISSANCE = 1,  // Waiting to confirm the saved state.
+    CAREFUL_RESUME_UNVALIDATED = 2,     // Jumped, waiting for ACKs of jump data.
+    CAREFUL_RESUME_VALIDATING = 3       // Waiting for the rest of the jump data.
+} QUIC_CUBIC_CAREFUL_RESUME_PHASE;
+
 typedef struct QUIC_CONGESTION_CONTROL_CUBIC {
 
     //
@@ -107,6 +117,19 @@ typedef struct QUIC_CONGESTION_CONTROL_CUBIC {
     uint32_t CWndSlowStartGrowthDivisor;
     uint32_t ConservativeSlowStartRounds;
 
+    //
+    // Careful Resume state. The window jumps to CarefulResumeJumpWindow (half
+    // the saved one) once the current RTT confirms the saved one. Until all
+    // packets sent after the jump are acknowledged, CarefulResumePipeSize
+    // tracks the bytes the path has been seen to deliver, and loss reduces the
+    // window based on it rather than on the unvalidated jump window.
+    //
+    QUIC_CUBIC_CAREFUL_RESUME_PHASE CarefulResumePhase;
+    uint32_t CarefulResumeJumpWindow; // bytes
+    uint32_t CarefulResumePipeSize; // bytes
+    uint64_t CarefulResumeSavedRtt; // microseconds
+    uint64_t CarefulResumePacketNumber; // Largest packet sent at phase change
+
     //
     // This variable tracks the largest packet that was outstanding at the time
     // the last congestion event occurred. An ACK for any packet number greater
@@ -0,0 +1,428 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Application defined congestion control. Adapts the internal congestion
+    control interface to the QUIC_CONGESTION_CONTROL_CALLBACKS the application
+    provided with QUIC_PARAM_CONN_CUSTOM_CONGESTION_CONTROL.
+
+    The callbacks are invoked inline on the connection's worker thread. Events
+    are converted on the stack, so there is no allocation per ACK.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "custom_cc.c.clog.h"
+#endif
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+    return
+        Custom->Exemptions > 0 ||
+        Custom->Callbacks->CanSend(Custom->Context, Custom->BytesInFlight);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+CustomCongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Custom.Callbacks->GetCongestionWindow(Cc->Custom.Context);
+}
+
+void
+CustomCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Custom->BytesInFlight,
+        CustomCongestionControlGetCongestionWindow(Cc),
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+    if (PreviousCanSendState != CustomCongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Custom.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+CustomCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Custom.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+CustomCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Custom.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+
+    if (FullReset) {
+        Custom->BytesInFlight = 0;
+    }
+    Custom->Exemptions = 0;
+
+    if (Custom->Callbacks->Reset != NULL) {
+        Custom->Callbacks->Reset(Custom->Context, FullReset);
+    }
+    Custom->BytesInFlightMax = CustomCongestionControlGetCongestionWindow(Cc) / 2;
+
+    QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+CustomCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    const QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+    return
+        Custom->Callbacks->GetSendAllowance(
+            Custom->Context,
+            Custom->BytesInFlight,
+            TimeSinceLastSend,
+            TimeSinceLastSendValid);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+CustomCongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    //
+    // The application paces through GetSendAllowance.
+    //
+    UNREFERENCED_PARAMETER(Cc);
+    return 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+
+    BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+    Custom->BytesInFlight += NumRetransmittableBytes;
+    if (Custom->BytesInFlightMax < Custom->BytesInFlight) {
+        Custom->BytesInFlightMax = Custom->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    Custom->Callbacks->OnDataSent(
+        Custom->Context, NumRetransmittableBytes, Custom->BytesInFlight);
+
+    if (Custom->Exemptions > 0) {
+        --Custom->Exemptions;
+    }
+
+    CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+
+    BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Custom->BytesInFlight >= NumRetransmittableBytes);
+    Custom->BytesInFlight -= NumRetransmittableBytes;
+
+    return CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+
+    BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+    if (!AckEvent->IsImplicit) {
+        CXPLAT_DBG_ASSERT(Custom->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+        Custom->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+    }
+
+    const QUIC_CONGESTION_CONTROL_ACK_INFO Info = {
+        .TimeNow = AckEvent->TimeNow,
+        .LargestAck = AckEvent->LargestAck,
+        .LargestSentPacketNumber = AckEvent->LargestSentPacketNumber,
+        .TotalBytesAcked = AckEvent->NumTotalAckedRetransmittableBytes,
+        .SmoothedRtt = AckEvent->SmoothedRtt,
+        .MinRtt = AckEvent->MinRtt,
+        .OneWayDelay = AckEvent->OneWayDelay,
+        .BytesAcked = AckEvent->NumRetransmittableBytes,
+        .BytesInFlight = Custom->BytesInFlight,
+        .IsImplicit = AckEvent->IsImplicit,
+        .HasLoss = AckEvent->HasLoss,
+        .MinRttValid = AckEvent->MinRttValid,
+        .IsLargestAckedPacketAppLimited = AckEvent->IsLargestAckedPacketAppLimited
+    };
+    Custom->Callbacks->OnDataAcknowledged(Custom->Context, &Info);
+
+    return CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    QuicTraceEvent(
+        ConnCongestionV2,
+        "[conn][%p] Congestion event: IsEcn=%hu",
+        Connection,
+        FALSE);
+    QuicTraceProbe(congestion_event, Connection, FALSE);
+    Connection->Stats.Send.CongestionCount++;
+    if (LossEvent->PersistentCongestion) {
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+    }
+
+    BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Custom->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Custom->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    const QUIC_CONGESTION_CONTROL_LOSS_INFO Info = {
+        .LargestPacketNumberLost = LossEvent->LargestPacketNumberLost,
+        .LargestSentPacketNumber = LossEvent->LargestSentPacketNumber,
+        .BytesLost = LossEvent->NumRetransmittableBytes,
+        .BytesInFlight = Custom->BytesInFlight,
+        .PersistentCongestion = LossEvent->PersistentCongestion
+    };
+    Custom->Callbacks->OnDataLost(Custom->Context, &Info);
+
+    CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    if (Custom->Callbacks->OnEcn == NULL) {
+        return;
+    }
+
+    QuicTraceEvent(
+        ConnCongestionV2,
+        "[conn][%p] Congestion event: IsEcn=%hu",
+        Connection,
+        TRUE);
+    QuicTraceProbe(congestion_event, Connection, TRUE);
+    Connection->Stats.Send.EcnCongestionCount++;
+
+    BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+    const QUIC_CONGESTION_CONTROL_ECN_INFO Info = {
+        .LargestPacketNumberAcked = EcnEvent->LargestPacketNumberAcked,
+        .LargestSentPacketNumber = EcnEvent->LargestSentPacketNumber,
+        .BytesInFlight = Custom->BytesInFlight
+    };
+    Custom->Callbacks->OnEcn(Custom->Context, &Info);
+
+    CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CustomCongestionControlGetNetworkStatistics(
+    _In_ const QUIC_CONNECTION* const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL* const Cc,
+    _Out_ QUIC_NETWORK_STATISTICS* NetworkStatistics
+    )
+{
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const uint32_t CongestionWindow = CustomCongestionControlGetCongestionWindow(Cc);
+
+    NetworkStatistics->BytesInFlight = Cc->Custom.BytesInFlight;
+    NetworkStatistics->PostedBytes = Connection->SendBuffer.PostedBytes;
+    NetworkStatistics->IdealBytes = Connection->SendBuffer.IdealBytes;
+    NetworkStatistics->SmoothedRTT = Path->SmoothedRtt;
+    NetworkStatistics->CongestionWindow = CongestionWindow;
+    NetworkStatistics->Bandwidth =
+        Path->SmoothedRtt == 0 ? 0 : CongestionWindow / Path->SmoothedRtt;
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlCustom = {
+    .Name = "Custom",
+    .Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM,
+    .QuicCongestionControlCanSend = CustomCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = CustomCongestionControlSetExemption,
+    .QuicCongestionControlReset = CustomCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = CustomCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = CustomCongestionControlGetPacingRate,
+    .QuicCongestionControlGetDeliveryRate = NULL,
+    .QuicCongestionControlOnDataSent = CustomCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = CustomCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = CustomCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = CustomCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = CustomCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = CustomCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = CustomCongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = CustomCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = CustomCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = CustomCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = CustomCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow = CustomCongestionControlGetCongestionWindow,
+    .QuicCongestionControlGetNetworkStatistics = CustomCongestionControlGetNetworkStatistics
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    UNREFERENCED_PARAMETER(Settings);
+
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_CUSTOM_CONGESTION_CONTROL* App = &Connection->CustomCongestionControl;
+
+    if (App->Callbacks == NULL) {
+        return FALSE;
+    }
+
+    *Cc = QuicCongestionControlCustom;
+
+    QUIC_CONGESTION_CONTROL_CUSTOM* Custom = &Cc->Custom;
+    Custom->Callbacks = App->Callbacks;
+    Custom->Context = App->Context;
+    Custom->BytesInFlight = 0;
+    Custom->Exemptions = 0;
+    Custom->BytesInFlightMax = CustomCongestionControlGetCongestionWindow(Cc) / 2;
+
+    QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+    return TRUE;
+}
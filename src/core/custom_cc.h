@@ -0,0 +1,51 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_CONGESTION_CONTROL_CUSTOM {
+
+    //
+    // The application's callbacks and context, copied from the connection's
+    // QUIC_PARAM_CONN_CUSTOM_CONGESTION_CONTROL.
+    //
+    const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks;
+    void* Context;
+
+    //
+    // The number of bytes considered to be still in the network. Tracked here
+    // so the application doesn't have to mirror the loss detection accounting.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // A count of packets which can be sent ignoring the application's window.
+    // This is used to send probe packets for loss recovery.
+    //
+    uint8_t Exemptions;
+
+} QUIC_CONGESTION_CONTROL_CUSTOM;
+
+//
+// Returns FALSE if the connection has no valid application callbacks, in which
+// case the caller falls back to another algorithm.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
+
+#if defined(__cplusplus)
+}
+#endif
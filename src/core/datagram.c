@@ -23,6 +23,12 @@ Abstract:
     DATAGRAM_FRAME_HEADER_LENGTH \
 )
 
+//
+// The number of queued datagrams too big for the rest of a packet that are
+// passed over looking for smaller ones to pack in behind them.
+//
+#define QUIC_DATAGRAM_MAX_PACKING_SKIPS 8
+
 #if DEBUG
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -53,6 +59,19 @@ QuicDatagramValidate(
             SendRequest = SendRequest->Next;
         }
     }
+
+    //
+    // Each lane's tail must be reachable from, and no earlier than, the one
+    // before it, and the last one must be the end of the queue.
+    //
+    QUIC_SEND_REQUEST* const* Tail = &Datagram->SendQueue;
+    for (uint32_t i = 0; i < QUIC_DATAGRAM_LANE_COUNT; ++i) {
+        while (Tail != Datagram->LaneTails[i]) {
+            CXPLAT_DBG_ASSERT(*Tail != NULL);
+            Tail = &((*Tail)->Next);
+        }
+    }
+    CXPLAT_DBG_ASSERT(*Tail == NULL);
 }
 #else
 #define QuicDatagramValidate(Datagram)
@@ -79,8 +98,9 @@ QuicDatagramInitialize(
 {
     Datagram->SendEnabled = TRUE;
     Datagram->MaxSendLength = UINT16_MAX;
-    Datagram->PrioritySendQueueTail = &Datagram->SendQueue;
-    Datagram->SendQueueTail = &Datagram->SendQueue;
+    for (uint32_t i = 0; i < QUIC_DATAGRAM_LANE_COUNT; ++i) {
+        Datagram->LaneTails[i] = &Datagram->SendQueue;
+    }
     CxPlatDispatchLockInitialize(&Datagram->ApiQueueLock);
     QuicDatagramValidate(Datagram);
 }
@@ -138,6 +158,67 @@ QuicDatagramCompleteSend(
     CxPlatPoolFree(SendRequest);
 }
 
+QUIC_INLINE
+QUIC_DATAGRAM_LANE
+QuicDatagramGetLane(
+    _In_ const QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    if (SendRequest->Flags & QUIC_SEND_FLAG_DGRAM_PRIORITY) {
+        return QUIC_DATAGRAM_LANE_PRIORITY;
+    }
+    if (SendRequest->Flags & QUIC_SEND_FLAG_DGRAM_LOW_PRIORITY) {
+        return QUIC_DATAGRAM_LANE_LOW;
+    }
+    return QUIC_DATAGRAM_LANE_NORMAL;
+}
+
+//
+// Appends the send request to the end of its lane.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramEnqueue(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    const QUIC_DATAGRAM_LANE Lane = QuicDatagramGetLane(SendRequest);
+    QUIC_SEND_REQUEST** Tail = Datagram->LaneTails[Lane];
+
+    SendRequest->Next = *Tail;
+    *Tail = SendRequest;
+
+    //
+    // Any lower lanes that are empty end where this one now does.
+    //
+    for (uint32_t i = Lane; i < QUIC_DATAGRAM_LANE_COUNT; ++i) {
+        if (Datagram->LaneTails[i] == Tail) {
+            Datagram->LaneTails[i] = &SendRequest->Next;
+        }
+    }
+}
+
+//
+// Unlinks the send request that Link points to from the send queue.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SEND_REQUEST*
+QuicDatagramDequeue(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ QUIC_SEND_REQUEST** Link
+    )
+{
+    QUIC_SEND_REQUEST* SendRequest = *Link;
+    *Link = SendRequest->Next;
+    for (uint32_t i = 0; i < QUIC_DATAGRAM_LANE_COUNT; ++i) {
+        if (Datagram->LaneTails[i] == &SendRequest->Next) {
+            Datagram->LaneTails[i] = Link;
+        }
+    }
+    return SendRequest;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicDatagramUninitialize(
@@ -183,8 +264,9 @@ QuicDatagramSendShutdown(
         Datagram->SendQueue = SendRequest->Next;
         QuicDatagramCancelSend(Connection, SendRequest);
     }
-    Datagram->PrioritySendQueueTail = &Datagram->SendQueue;
-    Datagram->SendQueueTail = &Datagram->SendQueue;
+    for (uint32_t i = 0; i < QUIC_DATAGRAM_LANE_COUNT; ++i) {
+        Datagram->LaneTails[i] = &Datagram->SendQueue;
+    }
 
     while (ApiQueue != NULL) {
         QUIC_SEND_REQUEST* SendRequest = ApiQueue;
@@ -209,17 +291,11 @@ QuicDatagramOnMaxSendLengthChanged(
     QUIC_SEND_REQUEST** SendQueue = &Datagram->SendQueue;
     while (*SendQueue != NULL) {
         if ((*SendQueue)->TotalLength > (uint64_t)Datagram->MaxSendLength) {
-            QUIC_SEND_REQUEST* SendRequest = *SendQueue;
-            if (Datagram->PrioritySendQueueTail == &SendRequest->Next) {
-                Datagram->PrioritySendQueueTail = SendQueue;
-            }
-            *SendQueue = SendRequest->Next;
-            QuicDatagramCancelSend(Connection, SendRequest);
+            QuicDatagramCancelSend(Connection, QuicDatagramDequeue(Datagram, SendQueue));
         } else {
             SendQueue = &((*SendQueue)->Next);
         }
     }
-    Datagram->SendQueueTail = SendQueue;
 
     if (Datagram->SendQueue != NULL) {
         QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
@@ -432,17 +508,7 @@ QuicDatagramSendFlush(
         }
         TotalBytesSent += SendRequest->TotalLength;
 
-        if (SendRequest->Flags & QUIC_SEND_FLAG_DGRAM_PRIORITY) {
-            SendRequest->Next = *Datagram->PrioritySendQueueTail;
-            *Datagram->PrioritySendQueueTail = SendRequest;
-            if (Datagram->SendQueueTail == Datagram->PrioritySendQueueTail) {
-                Datagram->SendQueueTail = &SendRequest->Next;
-            }
-            Datagram->PrioritySendQueueTail = &SendRequest->Next;
-        } else {
-            *Datagram->SendQueueTail = SendRequest;
-            Datagram->SendQueueTail = &SendRequest->Next;
-        }
+        QuicDatagramEnqueue(Datagram, SendRequest);
 
         QuicTraceLogConnVerbose(
             DatagramSendQueued,
@@ -465,6 +531,36 @@ QuicDatagramSendFlush(
         TotalBytesSent);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramExpire(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (Datagram->SendTimeoutMs == 0) {
+        return;
+    }
+
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+    const uint64_t SendTimeoutUs = MS_TO_US((uint64_t)Datagram->SendTimeoutMs);
+
+    QUIC_SEND_REQUEST** SendQueue = &Datagram->SendQueue;
+    while (*SendQueue != NULL) {
+        if (CxPlatTimeDiff64((*SendQueue)->QueueTime, TimeNow) >= SendTimeoutUs) {
+            QuicDatagramCancelSend(Connection, QuicDatagramDequeue(Datagram, SendQueue));
+        } else {
+            SendQueue = &((*SendQueue)->Next);
+        }
+    }
+
+    if (Datagram->SendQueue == NULL) {
+        QuicSendClearSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
+    }
+
+    QuicDatagramValidate(Datagram);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicDatagramWriteFrame(
@@ -478,8 +574,11 @@ QuicDatagramWriteFrame(
 
     QuicDatagramValidate(Datagram);
 
-    while (Datagram->SendQueue != NULL) {
-        QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueue;
+    QUIC_SEND_REQUEST** SendQueue = &Datagram->SendQueue;
+    uint32_t SkipCount = 0;
+
+    while (*SendQueue != NULL) {
+        QUIC_SEND_REQUEST* SendRequest = *SendQueue;
 
         if (Builder->Metadata->Flags.KeyType == QUIC_PACKET_KEY_0_RTT &&
             !(SendRequest->Flags & QUIC_SEND_FLAG_ALLOW_0_RTT)) {
@@ -513,16 +612,22 @@ QuicDatagramWriteFrame(
                 Builder->Metadata->FrameCount != 0 ||
                 Builder->PacketStart != 0);
             Result = TRUE;
-            goto Exit;
-        }
 
-        if (Datagram->PrioritySendQueueTail == &SendRequest->Next) {
-            Datagram->PrioritySendQueueTail = &Datagram->SendQueue;
-        }
-        if (Datagram->SendQueueTail == &SendRequest->Next) {
-            Datagram->SendQueueTail = &Datagram->SendQueue;
+            //
+            // Leave it at the front of the queue for the next packet, but look
+            // a little further for smaller datagrams that still fit in this
+            // one, so small (e.g. voice) datagrams aren't held up behind large
+            // ones.
+            //
+            if (++SkipCount == QUIC_DATAGRAM_MAX_PACKING_SKIPS ||
+                AvailableBufferLength - Builder->DatagramLength < DATAGRAM_FRAME_HEADER_LENGTH) {
+                goto Exit;
+            }
+            SendQueue = &SendRequest->Next;
+            continue;
         }
-        Datagram->SendQueue = SendRequest->Next;
+
+        (void)QuicDatagramDequeue(Datagram, SendQueue);
 
         Builder->Metadata->Flags.IsAckEliciting = TRUE;
         Builder->Metadata->Frames[Builder->Metadata->FrameCount].Type = QUIC_FRAME_DATAGRAM;
@@ -560,7 +665,7 @@ QuicDatagramProcessFrame(
     )
 {
     QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
-    CXPLAT_DBG_ASSERT(Connection->Settings.DatagramReceiveEnabled);
+    CXPLAT_DBG_ASSERT(Connection->Settings->DatagramReceiveEnabled);
 
     QUIC_DATAGRAM_EX Frame;
     if (!QuicDatagramFrameDecode(FrameType, BufferLength, Buffer, Offset, &Frame)) {
@@ -610,19 +715,12 @@ QuicDatagramCancelBlocked(
 
     do {
         if ((*SendQueue)->Flags & QUIC_SEND_FLAG_CANCEL_ON_BLOCKED) {
-            QUIC_SEND_REQUEST* SendRequest = *SendQueue;
-            if (Datagram->PrioritySendQueueTail == &SendRequest->Next) {
-                Datagram->PrioritySendQueueTail = SendQueue;
-            }
-            *SendQueue = SendRequest->Next;
-            QuicDatagramCancelSend(Connection, SendRequest);
+            QuicDatagramCancelSend(Connection, QuicDatagramDequeue(Datagram, SendQueue));
         } else {
             SendQueue = &((*SendQueue)->Next);
         }
     } while (*SendQueue != NULL);
 
-    Datagram->SendQueueTail = SendQueue;
-
     if (Datagram->SendQueue != NULL) {
         QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
     } else {
@@ -5,14 +5,24 @@
 
 --*/
 
+//
+// The send queue lanes, in the order they are drained.
+//
+typedef enum QUIC_DATAGRAM_LANE {
+    QUIC_DATAGRAM_LANE_PRIORITY,    // QUIC_SEND_FLAG_DGRAM_PRIORITY
+    QUIC_DATAGRAM_LANE_NORMAL,
+    QUIC_DATAGRAM_LANE_LOW,         // QUIC_SEND_FLAG_DGRAM_LOW_PRIORITY
+    QUIC_DATAGRAM_LANE_COUNT
+} QUIC_DATAGRAM_LANE;
+
 typedef struct QUIC_DATAGRAM {
 
     //
-    // Datagram send queue.
+    // Datagram send queue, ordered by lane. LaneTails[i] is the tail of the
+    // datagrams in lanes 0 through i.
     //
     QUIC_SEND_REQUEST* SendQueue;
-    QUIC_SEND_REQUEST** PrioritySendQueueTail;
-    QUIC_SEND_REQUEST** SendQueueTail;
+    QUIC_SEND_REQUEST** LaneTails[QUIC_DATAGRAM_LANE_COUNT];
 
     //
     // API calls to DatagramSend queue the send request here and then queue the
@@ -27,6 +37,12 @@ typedef struct QUIC_DATAGRAM {
     //
     // TODO - Allow this to be configurable.
 
+    //
+    // How long a datagram may stay queued before it is canceled instead of
+    // sent. Zero means datagrams never expire.
+    //
+    uint32_t SendTimeoutMs;
+
     //
     // The maximum length of data that we can fit in an outgoing datagram frame.
     //
@@ -77,6 +93,13 @@ QuicDatagramSendFlush(
     _In_ QUIC_DATAGRAM* Datagram
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramExpire(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t TimeNow
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicDatagramWriteFrame(
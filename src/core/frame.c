@@ -49,15 +49,15 @@ QuicUint8tDecode(
 _Success_(return != FALSE)
 BOOLEAN
 QuicAckHeaderEncode(
+    _In_ QUIC_FRAME_TYPE FrameType,
     _In_ const QUIC_ACK_EX * const Frame,
-    _In_opt_ QUIC_ACK_ECN_EX* Ecn,
     _Inout_ uint16_t* Offset,
     _In_ uint16_t BufferLength,
     _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
     )
 {
     uint16_t RequiredLength =
-        sizeof(uint8_t) +     // Type
+        QuicVarIntSize(FrameType) +
         QuicVarIntSize(Frame->LargestAcknowledged) +
         QuicVarIntSize(Frame->AckDelay) +
         QuicVarIntSize(Frame->AdditionalAckBlockCount) +
@@ -68,7 +68,7 @@ QuicAckHeaderEncode(
     }
 
     Buffer = Buffer + *Offset;
-    Buffer = QuicUint8Encode(Ecn == NULL ? QUIC_FRAME_ACK : QUIC_FRAME_ACK + 1, Buffer);
+    Buffer = QuicVarIntEncode(FrameType, Buffer);
     Buffer = QuicVarIntEncode(Frame->LargestAcknowledged, Buffer);
     Buffer = QuicVarIntEncode(Frame->AckDelay, Buffer);
     Buffer = QuicVarIntEncode(Frame->AdditionalAckBlockCount, Buffer);
@@ -187,10 +187,8 @@ QuicAckEcnDecode(
 
 _Success_(return != FALSE)
 BOOLEAN
-QuicAckFrameEncode(
+QuicAckBlocksEncode(
     _In_ const QUIC_RANGE * const AckBlocks,
-    _In_ uint64_t AckDelay,
-    _In_opt_ QUIC_ACK_ECN_EX* Ecn,
     _Inout_ uint16_t* Offset,
     _In_ uint16_t BufferLength,
     _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
@@ -202,23 +200,6 @@ QuicAckFrameEncode(
     uint64_t Largest = QuicRangeGetHigh(LastSub);
     uint64_t Count = LastSub->Count;
 
-    //
-    // Write the ACK Frame Header
-    //
-    QUIC_ACK_EX Frame = {
-        Largest,                // LargestAcknowledged
-        AckDelay,               // AckDelay
-        i,                      // AdditionalAckBlockCount
-        Count - 1               // FirstAckBlock
-    };
-
-    if (!QuicAckHeaderEncode(&Frame, Ecn, Offset, BufferLength, Buffer)) {
-        return FALSE;
-    }
-
-    //
-    // Write any additional ACK Blocks
-    //
     while (i != 0) {
 
         CXPLAT_DBG_ASSERT(Largest >= Count);
@@ -237,7 +218,6 @@ QuicAckFrameEncode(
         };
 
         if (!QuicAckBlockEncode(&Block, Offset, BufferLength, Buffer)) {
-            CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
             return FALSE;
         }
 
@@ -245,6 +225,93 @@ QuicAckFrameEncode(
         i--;
     }
 
+    return TRUE;
+}
+
+//
+// Writes the frame type, the ACK frame header and all the ACK blocks.
+//
+static
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckFrameEncodeBlocks(
+    _In_ QUIC_FRAME_TYPE FrameType,
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_opt_ const QUIC_ENCODED_ACK_BLOCKS* EncodedBlocks,
+    _In_ uint64_t AckDelay,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
+    )
+{
+    const uint32_t i = QuicRangeSize(AckBlocks) - 1;
+    QUIC_SUBRANGE* LastSub = QuicRangeGet(AckBlocks, i);
+
+    //
+    // Write the ACK Frame Header
+    //
+    QUIC_ACK_EX Frame = {
+        QuicRangeGetHigh(LastSub),  // LargestAcknowledged
+        AckDelay,                   // AckDelay
+        i,                          // AdditionalAckBlockCount
+        LastSub->Count - 1          // FirstAckBlock
+    };
+
+    if (!QuicAckHeaderEncode(FrameType, &Frame, Offset, BufferLength, Buffer)) {
+        return FALSE;
+    }
+
+    //
+    // Write any additional ACK Blocks
+    //
+    if (EncodedBlocks != NULL) {
+#if DEBUG
+        uint8_t Expected[QUIC_MAX_ENCODED_ACK_BLOCKS_LENGTH];
+        uint16_t ExpectedLength = 0;
+        const BOOLEAN Encoded =
+            QuicAckBlocksEncode(AckBlocks, &ExpectedLength, sizeof(Expected), Expected);
+        CXPLAT_DBG_ASSERT(Encoded);
+        CXPLAT_DBG_ASSERT(ExpectedLength == EncodedBlocks->Length);
+        CXPLAT_DBG_ASSERT(memcmp(Expected, EncodedBlocks->Buffer, ExpectedLength) == 0);
+#endif
+        if (BufferLength < *Offset + EncodedBlocks->Length) {
+            CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
+            return FALSE;
+        }
+        CxPlatCopyMemory(Buffer + *Offset, EncodedBlocks->Buffer, EncodedBlocks->Length);
+        *Offset += EncodedBlocks->Length;
+
+    } else if (!QuicAckBlocksEncode(AckBlocks, Offset, BufferLength, Buffer)) {
+        CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckFrameEncode(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_opt_ const QUIC_ENCODED_ACK_BLOCKS* EncodedBlocks,
+    _In_ uint64_t AckDelay,
+    _In_opt_ QUIC_ACK_ECN_EX* Ecn,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
+    )
+{
+    if (!QuicAckFrameEncodeBlocks(
+            Ecn == NULL ? QUIC_FRAME_ACK : QUIC_FRAME_ACK_1,
+            AckBlocks,
+            EncodedBlocks,
+            AckDelay,
+            Offset,
+            BufferLength,
+            Buffer)) {
+        return FALSE;
+    }
+
     if (Ecn != NULL) {
         if (!QuicAckEcnEncode(Ecn, Offset, BufferLength, Buffer)) {
             return FALSE;
@@ -254,6 +321,105 @@ QuicAckFrameEncode(
     return TRUE;
 }
 
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckReceiveTimestampsFrameEncode(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_opt_ const QUIC_ENCODED_ACK_BLOCKS* EncodedBlocks,
+    _In_ uint64_t AckDelay,
+    _In_reads_(TimestampCount)
+        const QUIC_ACK_RECEIVE_TIMESTAMP* Timestamps,
+    _In_ uint32_t TimestampCount,
+    _In_ uint8_t Exponent,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
+    )
+{
+    const uint64_t Largest =
+        QuicRangeGetHigh(QuicRangeGet(AckBlocks, QuicRangeSize(AckBlocks) - 1));
+
+    //
+    // The timestamps are grouped into ranges of contiguous packet numbers.
+    // Each range starts with the gap from the range before it (or from the
+    // largest acknowledged packet number), followed by its delta count and
+    // its deltas. The first delta is from the timestamp basis and the others
+    // are each from the timestamp before them. Times are scaled down before
+    // taking the differences so the rounding doesn't accumulate.
+    //
+    uint64_t RangeCount = 0;
+    uint16_t RequiredLength = 0;
+    uint64_t PrevTime = 0;
+    uint32_t RangeStart = 0;
+    for (uint32_t i = 0; i < TimestampCount; ++i) {
+        CXPLAT_DBG_ASSERT(Timestamps[i].PacketNumber <= Largest);
+        const uint64_t Time = Timestamps[i].RecvTime >> Exponent;
+        if (i == 0 || Timestamps[i].PacketNumber + 1 != Timestamps[i - 1].PacketNumber) {
+            if (i != 0) {
+                RequiredLength += QuicVarIntSize(i - RangeStart);
+            }
+            const uint64_t Gap =
+                i == 0 ?
+                    Largest - Timestamps[i].PacketNumber :
+                    Timestamps[i - 1].PacketNumber - Timestamps[i].PacketNumber - 2;
+            RequiredLength += QuicVarIntSize(Gap);
+            RangeStart = i;
+            RangeCount++;
+        }
+        CXPLAT_DBG_ASSERT(i == 0 || Time <= PrevTime);
+        const uint64_t Delta = i == 0 ? Time : PrevTime - Time;
+        RequiredLength += QuicVarIntSize(Delta);
+        PrevTime = Time;
+    }
+    if (TimestampCount != 0) {
+        RequiredLength += QuicVarIntSize(TimestampCount - RangeStart);
+    }
+    RequiredLength += QuicVarIntSize(RangeCount);
+
+    const uint16_t StartOffset = *Offset;
+    if (!QuicAckFrameEncodeBlocks(
+            QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS,
+            AckBlocks,
+            EncodedBlocks,
+            AckDelay,
+            Offset,
+            BufferLength,
+            Buffer)) {
+        *Offset = StartOffset;
+        return FALSE;
+    }
+
+    if (BufferLength < *Offset + RequiredLength) {
+        *Offset = StartOffset;
+        return FALSE;
+    }
+
+    uint8_t* Write = Buffer + *Offset;
+    Write = QuicVarIntEncode(RangeCount, Write);
+    for (uint32_t i = 0; i < TimestampCount; ++i) {
+        const uint64_t Time = Timestamps[i].RecvTime >> Exponent;
+        if (i == 0 || Timestamps[i].PacketNumber + 1 != Timestamps[i - 1].PacketNumber) {
+            const uint64_t Gap =
+                i == 0 ?
+                    Largest - Timestamps[i].PacketNumber :
+                    Timestamps[i - 1].PacketNumber - Timestamps[i].PacketNumber - 2;
+            uint32_t RangeEnd = i + 1;
+            while (RangeEnd < TimestampCount &&
+                   Timestamps[RangeEnd].PacketNumber + 1 == Timestamps[RangeEnd - 1].PacketNumber) {
+                RangeEnd++;
+            }
+            Write = QuicVarIntEncode(Gap, Write);
+            Write = QuicVarIntEncode(RangeEnd - i, Write);
+        }
+        const uint64_t Delta = i == 0 ? Time : PrevTime - Time;
+        Write = QuicVarIntEncode(Delta, Write);
+        PrevTime = Time;
+    }
+    *Offset += RequiredLength;
+
+    return TRUE;
+}
+
 //
 // Given that the max UDP packet is 64k, this is a reasonable upper bound for
 // the number of ACK blocks possible.
@@ -281,6 +447,7 @@ QuicAckFrameDecode(
 {
     *InvalidFrame = FALSE;
     CXPLAT_DBG_ASSERT(AckRanges->SubRanges); // Should be pre-initialized.
+    CXPLAT_DBG_ASSERT(QuicRangeSize(AckRanges) == 0); // And empty.
 
     //
     // Decode the ACK frame header.
@@ -292,26 +459,28 @@ QuicAckFrameDecode(
     }
 
     //
-    // Insert the largest/first block into the range.
+    // Every block is lower than the one before it and separated from it by at
+    // least one unacknowledged packet number, so the blocks are decoded in a
+    // single pass straight into the range's array, largest first, and the
+    // array is reversed into ascending order at the end. This avoids inserting
+    // each block at the front of the array, which moves all the others.
     //
 
     uint64_t Largest = Frame.LargestAcknowledged;
     uint64_t Count = Frame.FirstAckBlock + 1;
 
-    BOOLEAN DontCare;
-    if (!QuicRangeAddRange(AckRanges, Largest + 1 - Count, Count, &DontCare)) {
+    QUIC_SUBRANGE* Sub = QuicRangeAppendSubrange(AckRanges);
+    if (Sub == NULL) {
         return FALSE;
     }
+    Sub->Low = Largest + 1 - Count;
+    Sub->Count = Count;
 
     if (Frame.AdditionalAckBlockCount >= QUIC_MAX_NUMBER_ACK_BLOCKS) {
         *InvalidFrame = TRUE;
         return FALSE;
     }
 
-    //
-    // Insert all the rest of the blocks (if any) into the range.
-    //
-
     for (uint32_t i = 0; i < (uint32_t)Frame.AdditionalAckBlockCount; i++) {
 
         if (Count > Largest) {
@@ -335,18 +504,23 @@ QuicAckFrameDecode(
         Largest -= (Block.Gap + 1);
         Count = Block.AckBlock + 1;
 
-        //
-        // N.B. The efficiency here isn't great because we are always inserting
-        // values less than the current minimum, which requires a complete
-        // memmove of the current array. A circular buffer that allows both
-        // forward and backward growth would fix this.
-        //
+        if (Count > Largest + 1) {
+            //
+            // The block would go below zero.
+            //
+            *InvalidFrame = TRUE;
+            return FALSE;
+        }
 
-        if (!QuicRangeAddRange(AckRanges, Largest - Count + 1, Count, &DontCare)) {
+        if ((Sub = QuicRangeAppendSubrange(AckRanges)) == NULL) {
             return FALSE;
         }
+        Sub->Low = Largest - Count + 1;
+        Sub->Count = Count;
     }
 
+    QuicRangeReverse(AckRanges);
+
     *AckDelay = Frame.AckDelay;
 
     if (FrameType == QUIC_FRAME_ACK_1) {
@@ -361,6 +535,79 @@ QuicAckFrameDecode(
     return TRUE;
 }
 
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckReceiveTimestampsDecode(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_ uint16_t* Offset,
+    _In_ uint64_t LargestAcknowledged,
+    _In_ uint8_t Exponent,
+    _In_ uint32_t MaxTimestampCount,
+    _Out_writes_bytes_opt_(MaxTimestampCount * sizeof(QUIC_ACK_RECEIVE_TIMESTAMP))
+        QUIC_ACK_RECEIVE_TIMESTAMP* Timestamps,
+    _Out_ uint32_t* TimestampCount
+    )
+{
+    *TimestampCount = 0;
+
+    QUIC_VAR_INT RangeCount;
+    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &RangeCount) ||
+        RangeCount >= QUIC_MAX_NUMBER_ACK_BLOCKS) {
+        return FALSE;
+    }
+
+    //
+    // PacketNumber is one past the next packet number a range may start at,
+    // and Time is the previous (scaled) receive time.
+    //
+    uint64_t PacketNumber = LargestAcknowledged + 1;
+    uint64_t Time = 0;
+    for (uint32_t i = 0; i < (uint32_t)RangeCount; ++i) {
+        QUIC_VAR_INT Gap, DeltaCount;
+        if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Gap) ||
+            !QuicVarIntDecode(BufferLength, Buffer, Offset, &DeltaCount) ||
+            DeltaCount == 0) {
+            return FALSE;
+        }
+
+        //
+        // The first range's gap is from the largest acknowledged packet
+        // number and every other one is from two below the previous range.
+        //
+        const uint64_t Skip = i == 0 ? Gap + 1 : Gap + 2;
+        if (Skip > PacketNumber || DeltaCount > PacketNumber - Skip + 1) {
+            return FALSE;
+        }
+        PacketNumber -= Skip;
+
+        for (uint64_t j = 0; j < DeltaCount; ++j) {
+            QUIC_VAR_INT Delta;
+            if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Delta)) {
+                return FALSE;
+            }
+            if (i == 0 && j == 0) {
+                Time = Delta;
+            } else if (Delta > Time) {
+                return FALSE;
+            } else {
+                Time -= Delta;
+            }
+
+            if (Timestamps != NULL && *TimestampCount < MaxTimestampCount) {
+                Timestamps[*TimestampCount].PacketNumber = PacketNumber;
+                Timestamps[*TimestampCount].RecvTime = Time << Exponent;
+                (*TimestampCount)++;
+            }
+            PacketNumber--;
+        }
+        PacketNumber++;
+    }
+
+    return TRUE;
+}
+
 _Success_(return != FALSE)
 BOOLEAN
 QuicResetStreamFrameEncode(
@@ -1389,7 +1636,8 @@ QuicFrameLog(
     }
 
     case QUIC_FRAME_ACK:
-    case QUIC_FRAME_ACK_1: {
+    case QUIC_FRAME_ACK_1:
+    case QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS: {
         QUIC_ACK_EX Frame;
         if (!QuicAckHeaderDecode(PacketLength, Packet, Offset, &Frame)) {
             QuicTraceLogVerbose(
@@ -1429,6 +1677,7 @@ QuicFrameLog(
                 Frame.LargestAcknowledged);
         }
 
+        const uint64_t LargestAcknowledged = Frame.LargestAcknowledged;
         Frame.LargestAcknowledged -= (Frame.FirstAckBlock + 1);
 
         for (uint64_t i = 0; i < Frame.AdditionalAckBlockCount; i++) {
@@ -1491,6 +1740,26 @@ QuicFrameLog(
                 Ecn.CE_Count);
         }
 
+        if (FrameType == QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS) {
+            uint32_t TimestampCount;
+            if (!QuicAckReceiveTimestampsDecode(
+                    PacketLength, Packet, Offset, LargestAcknowledged, 0, 0, NULL, &TimestampCount)) {
+                QuicTraceLogVerbose(
+                    FrameLogAckReceiveTimestampsInvalid,
+                    "[%c][%cX][%llu]     Timestamps [Invalid]",
+                    PtkConnPre(Connection),
+                    PktRxPre(Rx),
+                    PacketNumber);
+                return FALSE;
+            }
+            QuicTraceLogVerbose(
+                FrameLogAckReceiveTimestamps,
+                "[%c][%cX][%llu]     Timestamps",
+                PtkConnPre(Connection),
+                PktRxPre(Rx),
+                PacketNumber);
+        }
+
         break;
     }
 
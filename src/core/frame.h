@@ -159,6 +159,8 @@ typedef enum QUIC_FRAME_TYPE {
     QUIC_FRAME_IMMEDIATE_ACK        = 0x1fULL,
     /* 0xaf to 0x2f4 are unused currently */
     QUIC_FRAME_TIMESTAMP            = 0x2f5ULL,
+    /* 0x2f6 to 0xff9f are unused currently */
+    QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS = 0xffa0ULL,
 
     QUIC_FRAME_MAX_SUPPORTED
 
@@ -177,7 +179,8 @@ CXPLAT_STATIC_ASSERT(
      (X >= QUIC_FRAME_DATAGRAM && X <= QUIC_FRAME_DATAGRAM_1) || \
       X == QUIC_FRAME_ACK_FREQUENCY || X == QUIC_FRAME_IMMEDIATE_ACK || \
       X == QUIC_FRAME_RELIABLE_RESET_STREAM || \
-      X == QUIC_FRAME_TIMESTAMP \
+      X == QUIC_FRAME_TIMESTAMP || \
+      X == QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS \
     )
 
 //
@@ -208,10 +211,48 @@ typedef struct QUIC_ACK_ECN_EX {
 
 } QUIC_ACK_ECN_EX;
 
+//
+// The additional ACK blocks of a range (all but its largest subrange), as
+// written by QuicAckBlocksEncode. They only change when packet numbers below
+// the largest subrange do, so they can be encoded once and reused across ACK
+// frames.
+//
+typedef struct QUIC_ENCODED_ACK_BLOCKS {
+
+    const uint8_t* Buffer;
+    uint16_t Length;
+
+} QUIC_ENCODED_ACK_BLOCKS;
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckBlockEncode(
+    _In_ const QUIC_ACK_BLOCK_EX * const Block,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckBlocksEncode(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
+//
+// If EncodedBlocks is set, it's copied in place of encoding the additional
+// ACK blocks of AckBlocks.
+//
 _Success_(return != FALSE)
 BOOLEAN
 QuicAckFrameEncode(
     _In_ const QUIC_RANGE * const AckBlocks,
+    _In_opt_ const QUIC_ENCODED_ACK_BLOCKS* EncodedBlocks,
     _In_ uint64_t AckDelay,
     _In_opt_ QUIC_ACK_ECN_EX* Ecn,
     _Inout_ uint16_t* Offset,
@@ -235,6 +276,61 @@ QuicAckFrameDecode(
     _Out_ uint64_t* AckDelay
     );
 
+//
+// QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS Encoding/Decoding
+//
+// The frame is an ACK frame (without ECN counts) followed by the receive
+// times of some of the acknowledged packets (draft-smith-quic-receive-ts).
+//
+
+typedef struct QUIC_ACK_RECEIVE_TIMESTAMP {
+
+    uint64_t PacketNumber;
+    uint64_t RecvTime; // In microseconds since the receiver's timestamp basis
+
+} QUIC_ACK_RECEIVE_TIMESTAMP;
+
+//
+// Timestamps must be in descending packet number order, with receive times
+// that don't increase, and none greater than the largest acknowledged packet
+// number.
+//
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckReceiveTimestampsFrameEncode(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_opt_ const QUIC_ENCODED_ACK_BLOCKS* EncodedBlocks,
+    _In_ uint64_t AckDelay,
+    _In_reads_(TimestampCount)
+        const QUIC_ACK_RECEIVE_TIMESTAMP* Timestamps,
+    _In_ uint32_t TimestampCount,
+    _In_ uint8_t Exponent,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
+//
+// Decodes the timestamp section that follows the ACK ranges. At most
+// MaxTimestampCount timestamps are returned, in descending packet number
+// order; any others are skipped.
+//
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckReceiveTimestampsDecode(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_ uint16_t* Offset,
+    _In_ uint64_t LargestAcknowledged,
+    _In_ uint8_t Exponent,
+    _In_ uint32_t MaxTimestampCount,
+    _Out_writes_bytes_opt_(MaxTimestampCount * sizeof(QUIC_ACK_RECEIVE_TIMESTAMP))
+        QUIC_ACK_RECEIVE_TIMESTAMP* Timestamps,
+    _Out_ uint32_t* TimestampCount
+    );
+
 //
 // QUIC_FRAME_RESET_STREAM Encoding/Decoding
 //
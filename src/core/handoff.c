@@ -0,0 +1,1035 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Connection state handoff moves an established server connection to another
+    process, so a server can restart without dropping its connections. The old
+    process exports the connection's state (its 1-RTT secrets, packet numbers,
+    flow control, CIDs and path state) and silently abandons the connection.
+    The new process imports the state into a newly opened connection, which
+    takes over the connection's CIDs on its own binding and carries on from
+    where the old process left off. The peer never takes part.
+
+    Only quiescent connections are handed off: no open streams, nothing in
+    flight or queued to send, and no key update yet. The TLS session isn't
+    handed off, so the imported connection can't send resumption tickets.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "handoff.c.clog.h"
+#endif
+
+//
+// Exported state format:
+//   Format Version (QUIC_VAR_INT)
+//   QUIC Version (network byte order) [4]
+//   Local Address, Remote Address:
+//     Family (QUIC_VAR_INT), Port (QUIC_VAR_INT), Address [4 or 16]
+//   Negotiated ALPN length (QUIC_VAR_INT), Negotiated ALPN [...]
+//   1-RTT Read Secret, 1-RTT Write Secret:
+//     Hash (QUIC_VAR_INT), AEAD (QUIC_VAR_INT), Secret [hash length]
+//   Next Send Packet Number, Next Recv Packet Number,
+//   Current Key Phase Bytes Sent (QUIC_VAR_INT)
+//   Max Data, Peer Max Data, Stream Bytes Received, Stream Bytes Sent (QUIC_VAR_INT)
+//   Max Total and Total Stream Count, for each stream type (QUIC_VAR_INT)
+//   Smoothed RTT, Min RTT, Max RTT, RTT Variance, Latest RTT, MTU (QUIC_VAR_INT)
+//   Congestion Control Algorithm, Congestion Window (QUIC_VAR_INT)
+//   Next Source CID Sequence Number, Retire Prior To (QUIC_VAR_INT)
+//   Source CID count (QUIC_VAR_INT), then for each:
+//     Sequence Number (QUIC_VAR_INT), Length (QUIC_VAR_INT), CID [...],
+//     Retired (QUIC_VAR_INT)
+//   Destination CID count (QUIC_VAR_INT), active one first, then for each:
+//     Sequence Number (QUIC_VAR_INT), Length (QUIC_VAR_INT), CID [...],
+//     Has Reset Token (QUIC_VAR_INT), Reset Token (if present) [16]
+//   Peer Transport Parameters length (QUIC_VAR_INT), Transport Parameters [...]
+//
+
+typedef struct QUIC_HANDOFF_WRITER {
+    uint8_t* Buffer;
+    uint32_t BufferLength;
+    uint32_t Offset; // Keeps counting past BufferLength.
+} QUIC_HANDOFF_WRITER;
+
+typedef struct QUIC_HANDOFF_READER {
+    const uint8_t* Buffer;
+    uint16_t BufferLength;
+    uint16_t Offset;
+} QUIC_HANDOFF_READER;
+
+static
+void
+QuicHandoffWriteBytes(
+    _Inout_ QUIC_HANDOFF_WRITER* Writer,
+    _In_reads_bytes_(Length)
+        const void* Data,
+    _In_ uint32_t Length
+    )
+{
+    if (Writer->Buffer != NULL &&
+        Writer->Offset + Length <= Writer->BufferLength) {
+        CxPlatCopyMemory(Writer->Buffer + Writer->Offset, Data, Length);
+    }
+    Writer->Offset += Length;
+}
+
+static
+void
+QuicHandoffWriteVarInt(
+    _Inout_ QUIC_HANDOFF_WRITER* Writer,
+    _In_ QUIC_VAR_INT Value
+    )
+{
+    uint8_t Encoded[sizeof(uint64_t)];
+    const uint8_t* End = QuicVarIntEncode(Value, Encoded);
+    QuicHandoffWriteBytes(Writer, Encoded, (uint32_t)(End - Encoded));
+}
+
+static
+void
+QuicHandoffWriteAddress(
+    _Inout_ QUIC_HANDOFF_WRITER* Writer,
+    _In_ const QUIC_ADDR* Address
+    )
+{
+    const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(Address);
+    QuicHandoffWriteVarInt(Writer, Family);
+    QuicHandoffWriteVarInt(Writer, QuicAddrGetPort(Address));
+    if (Family == QUIC_ADDRESS_FAMILY_INET) {
+        QuicHandoffWriteBytes(Writer, &Address->Ipv4.sin_addr, 4);
+    } else {
+        QuicHandoffWriteBytes(Writer, &Address->Ipv6.sin6_addr, 16);
+    }
+}
+
+static
+void
+QuicHandoffWriteSecret(
+    _Inout_ QUIC_HANDOFF_WRITER* Writer,
+    _In_ const CXPLAT_SECRET* Secret
+    )
+{
+    QuicHandoffWriteVarInt(Writer, Secret->Hash);
+    QuicHandoffWriteVarInt(Writer, Secret->Aead);
+    QuicHandoffWriteBytes(Writer, Secret->Secret, CxPlatHashLength(Secret->Hash));
+}
+
+static
+BOOLEAN
+QuicHandoffReadBytes(
+    _Inout_ QUIC_HANDOFF_READER* Reader,
+    _Out_writes_bytes_(Length)
+        void* Data,
+    _In_ uint16_t Length
+    )
+{
+    if (Reader->BufferLength - Reader->Offset < Length) {
+        return FALSE;
+    }
+    CxPlatCopyMemory(Data, Reader->Buffer + Reader->Offset, Length);
+    Reader->Offset += Length;
+    return TRUE;
+}
+
+static
+BOOLEAN
+QuicHandoffReadVarInt(
+    _Inout_ QUIC_HANDOFF_READER* Reader,
+    _In_ QUIC_VAR_INT Max,
+    _Out_ QUIC_VAR_INT* Value
+    )
+{
+    return
+        QuicVarIntDecode(Reader->BufferLength, Reader->Buffer, &Reader->Offset, Value) &&
+        *Value <= Max;
+}
+
+static
+BOOLEAN
+QuicHandoffReadAddress(
+    _Inout_ QUIC_HANDOFF_READER* Reader,
+    _Out_ QUIC_ADDR* Address
+    )
+{
+    QUIC_VAR_INT Family, Port;
+    CxPlatZeroMemory(Address, sizeof(*Address));
+    if (!QuicHandoffReadVarInt(Reader, UINT16_MAX, &Family) ||
+        !QuicHandoffReadVarInt(Reader, UINT16_MAX, &Port)) {
+        return FALSE;
+    }
+    if (Family == QUIC_ADDRESS_FAMILY_INET) {
+        QuicAddrSetFamily(Address, QUIC_ADDRESS_FAMILY_INET);
+        if (!QuicHandoffReadBytes(Reader, &Address->Ipv4.sin_addr, 4)) {
+            return FALSE;
+        }
+    } else if (Family == QUIC_ADDRESS_FAMILY_INET6) {
+        QuicAddrSetFamily(Address, QUIC_ADDRESS_FAMILY_INET6);
+        if (!QuicHandoffReadBytes(Reader, &Address->Ipv6.sin6_addr, 16)) {
+            return FALSE;
+        }
+    } else {
+        return FALSE;
+    }
+    QuicAddrSetPort(Address, (uint16_t)Port);
+    return TRUE;
+}
+
+static
+BOOLEAN
+QuicHandoffReadSecret(
+    _Inout_ QUIC_HANDOFF_READER* Reader,
+    _Out_ CXPLAT_SECRET* Secret
+    )
+{
+    QUIC_VAR_INT Hash, Aead;
+    if (!QuicHandoffReadVarInt(Reader, CXPLAT_HASH_SHA512, &Hash) ||
+        !QuicHandoffReadVarInt(Reader, CXPLAT_AEAD_CHACHA20_POLY1305, &Aead)) {
+        return FALSE;
+    }
+    Secret->Hash = (CXPLAT_HASH_TYPE)Hash;
+    Secret->Aead = (CXPLAT_AEAD_TYPE)Aead;
+    return QuicHandoffReadBytes(Reader, Secret->Secret, CxPlatHashLength(Secret->Hash));
+}
+
+static
+BOOLEAN
+QuicHandoffReadCid(
+    _Inout_ QUIC_HANDOFF_READER* Reader,
+    _In_ BOOLEAN IsSource,
+    _Out_ QUIC_CONN_HANDOFF_CID* Cid
+    )
+{
+    QUIC_VAR_INT SequenceNumber, Length, Flag;
+    if (!QuicHandoffReadVarInt(Reader, QUIC_VAR_INT_MAX, &SequenceNumber) ||
+        !QuicHandoffReadVarInt(Reader, QUIC_MAX_CONNECTION_ID_LENGTH_V1, &Length) ||
+        !QuicHandoffReadBytes(Reader, Cid->Data, (uint16_t)Length) ||
+        !QuicHandoffReadVarInt(Reader, 1, &Flag)) {
+        return FALSE;
+    }
+    Cid->SequenceNumber = SequenceNumber;
+    Cid->Length = (uint8_t)Length;
+    Cid->Flag = (BOOLEAN)Flag;
+    if (IsSource) {
+        //
+        // Source CIDs have to route to this process just like the ones it
+        // generates itself.
+        //
+        return Cid->Length == MsQuicLib.CidTotalLength;
+    }
+    return
+        !Cid->Flag ||
+        QuicHandoffReadBytes(Reader, Cid->ResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH);
+}
+
+static
+BOOLEAN
+QuicConnHandoffCanExport(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const QUIC_PACKET_SPACE* Packets = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    if (!QuicConnIsServer(Connection) ||
+        !Connection->State.Connected ||
+        !Connection->State.HandshakeConfirmed ||
+        QuicConnIsClosed(Connection) ||
+        !Connection->State.ShareBinding ||
+        Connection->State.Disable1RttEncrytion ||
+        Connection->PathsCount != 1 ||
+        Connection->Paths[0].EncryptionOffloading ||
+        Connection->Stats.Misc.KeyUpdateCount != 0 ||
+        Packets == NULL ||
+        Packets->CurrentKeyPhase ||
+        Packets->AwaitingKeyPhaseConfirmation ||
+        Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT] == NULL ||
+        Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT] == NULL) {
+        return FALSE;
+    }
+
+    for (uint8_t Type = 0; Type < NUMBER_OF_STREAM_TYPES; ++Type) {
+        if (Connection->Streams.Types[Type].CurrentStreamCount != 0) {
+            return FALSE;
+        }
+    }
+
+    //
+    // Anything still in flight or waiting to be sent would be lost. Pending
+    // ACKs are fine to drop; the peer just retransmits.
+    //
+    if (!CxPlatListIsEmpty(&Connection->Streams.WaitingStreams) ||
+        Connection->LossDetection.PacketsInFlight != 0 ||
+        Connection->LossDetection.SentPackets != NULL ||
+        Connection->LossDetection.LostPackets != NULL ||
+        Connection->Datagram.SendQueue != NULL ||
+        (Connection->Send.SendFlags &
+            ~(QUIC_CONN_SEND_FLAG_ACK | QUIC_CONN_SEND_FLAG_PING |
+              QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK | QUIC_CONN_SEND_FLAG_DPLPMTUD)) != 0) {
+        return FALSE;
+    }
+
+    uint32_t SourceCidCount = 0;
+    for (CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
+            Entry != NULL;
+            Entry = Entry->Next) {
+        ++SourceCidCount;
+    }
+    if (SourceCidCount == 0 || SourceCidCount > QUIC_CONN_HANDOFF_MAX_CIDS) {
+        return FALSE;
+    }
+
+    uint32_t DestCidCount = 0;
+    for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
+            Entry != &Connection->DestCids;
+            Entry = Entry->Flink) {
+        const QUIC_CID_LIST_ENTRY* DestCid =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CID_LIST_ENTRY, Link);
+        if (DestCid->CID.Retired) {
+            return FALSE; // Its retirement hasn't been acknowledged yet.
+        }
+        ++DestCidCount;
+    }
+    return DestCidCount <= QUIC_CONN_HANDOFF_MAX_CIDS;
+}
+
+static
+void
+QuicHandoffWriteDestCid(
+    _Inout_ QUIC_HANDOFF_WRITER* Writer,
+    _In_ const QUIC_CID_LIST_ENTRY* DestCid
+    )
+{
+    QuicHandoffWriteVarInt(Writer, DestCid->CID.SequenceNumber);
+    QuicHandoffWriteVarInt(Writer, DestCid->CID.Length);
+    QuicHandoffWriteBytes(Writer, DestCid->CID.Data, DestCid->CID.Length);
+    QuicHandoffWriteVarInt(Writer, DestCid->CID.HasResetToken);
+    if (DestCid->CID.HasResetToken) {
+        QuicHandoffWriteBytes(Writer, DestCid->ResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnHandoffExport(
+    _In_ QUIC_CONNECTION* Connection,
+    _Inout_ uint32_t* BufferLength,
+    _Out_writes_bytes_opt_(*BufferLength)
+        uint8_t* Buffer
+    )
+{
+    if (!QuicConnHandoffCanExport(Connection)) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    uint32_t EncodedTPLength = 0;
+    const uint8_t* EncodedTP =
+        QuicCryptoTlsEncodeTransportParameters(
+            Connection,
+            FALSE,  // IsServerTP
+            &Connection->PeerTransportParams,
+            NULL,
+            &EncodedTPLength);
+    if (EncodedTP == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    EncodedTPLength -= CxPlatTlsTPHeaderSize;
+
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const CXPLAT_TLS_PROCESS_STATE* TlsState = &Connection->Crypto.TlsState;
+    const QUIC_PACKET_SPACE* Packets = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+
+    QUIC_HANDOFF_WRITER Writer = { Buffer, *BufferLength, 0 };
+    QuicHandoffWriteVarInt(&Writer, QUIC_CONN_HANDOFF_VERSION);
+    QuicHandoffWriteBytes(&Writer, &Connection->Stats.QuicVersion, sizeof(uint32_t));
+    QuicHandoffWriteAddress(&Writer, &Path->Route.LocalAddress);
+    QuicHandoffWriteAddress(&Writer, &Path->Route.RemoteAddress);
+    QuicHandoffWriteVarInt(&Writer, TlsState->NegotiatedAlpn[0]);
+    QuicHandoffWriteBytes(&Writer, TlsState->NegotiatedAlpn + 1, TlsState->NegotiatedAlpn[0]);
+    QuicHandoffWriteSecret(&Writer, TlsState->ReadKeys[QUIC_PACKET_KEY_1_RTT]->TrafficSecret);
+    QuicHandoffWriteSecret(&Writer, TlsState->WriteKeys[QUIC_PACKET_KEY_1_RTT]->TrafficSecret);
+
+    QuicHandoffWriteVarInt(&Writer, Connection->Send.NextPacketNumber);
+    QuicHandoffWriteVarInt(&Writer, Packets->NextRecvPacketNumber);
+    QuicHandoffWriteVarInt(&Writer, Packets->CurrentKeyPhaseBytesSent);
+
+    QuicHandoffWriteVarInt(&Writer, Connection->Send.MaxData);
+    QuicHandoffWriteVarInt(&Writer, Connection->Send.PeerMaxData);
+    QuicHandoffWriteVarInt(&Writer, Connection->Send.OrderedStreamBytesReceived);
+    QuicHandoffWriteVarInt(&Writer, Connection->Send.OrderedStreamBytesSent);
+    for (uint8_t Type = 0; Type < NUMBER_OF_STREAM_TYPES; ++Type) {
+        QuicHandoffWriteVarInt(&Writer, Connection->Streams.Types[Type].MaxTotalStreamCount);
+        QuicHandoffWriteVarInt(&Writer, Connection->Streams.Types[Type].TotalStreamCount);
+    }
+
+    QuicHandoffWriteVarInt(&Writer, Path->SmoothedRtt);
+    QuicHandoffWriteVarInt(&Writer, Path->MinRtt);
+    QuicHandoffWriteVarInt(&Writer, Path->MaxRtt);
+    QuicHandoffWriteVarInt(&Writer, Path->RttVariance);
+    QuicHandoffWriteVarInt(&Writer, Path->LatestRttSample);
+    QuicHandoffWriteVarInt(&Writer, Path->Mtu);
+    QuicHandoffWriteVarInt(&Writer, Connection->Settings->CongestionControlAlgorithm);
+    QuicHandoffWriteVarInt(
+        &Writer, QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl));
+
+    QuicHandoffWriteVarInt(&Writer, Connection->NextSourceCidSequenceNumber);
+    QuicHandoffWriteVarInt(&Writer, Connection->RetirePriorTo);
+
+    uint8_t SourceCidCount = 0;
+    for (CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
+            Entry != NULL;
+            Entry = Entry->Next) {
+        ++SourceCidCount;
+    }
+    QuicHandoffWriteVarInt(&Writer, SourceCidCount);
+    for (CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
+            Entry != NULL;
+            Entry = Entry->Next) {
+        const QUIC_CID_HASH_ENTRY* SourceCid =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CID_HASH_ENTRY, Link);
+        QuicHandoffWriteVarInt(&Writer, SourceCid->CID.SequenceNumber);
+        QuicHandoffWriteVarInt(&Writer, SourceCid->CID.Length);
+        QuicHandoffWriteBytes(&Writer, SourceCid->CID.Data, SourceCid->CID.Length);
+        QuicHandoffWriteVarInt(&Writer, SourceCid->CID.Retired);
+    }
+
+    QuicHandoffWriteVarInt(&Writer, Connection->DestCidCount);
+    QuicHandoffWriteDestCid(&Writer, Path->DestCid);
+    for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
+            Entry != &Connection->DestCids;
+            Entry = Entry->Flink) {
+        const QUIC_CID_LIST_ENTRY* DestCid =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CID_LIST_ENTRY, Link);
+        if (DestCid != Path->DestCid) {
+            QuicHandoffWriteDestCid(&Writer, DestCid);
+        }
+    }
+
+    QuicHandoffWriteVarInt(&Writer, EncodedTPLength);
+    QuicHandoffWriteBytes(&Writer, EncodedTP + CxPlatTlsTPHeaderSize, EncodedTPLength);
+    CXPLAT_FREE(EncodedTP, QUIC_POOL_TLS_TRANSPARAMS);
+
+    if (Writer.Offset > UINT16_MAX) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    if (*BufferLength < Writer.Offset) {
+        *BufferLength = Writer.Offset;
+        return QUIC_STATUS_BUFFER_TOO_SMALL;
+    }
+
+    if (Buffer == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    *BufferLength = Writer.Offset;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnHandoffSetState(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint32_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t* Buffer
+    )
+{
+    if (BufferLength > UINT16_MAX) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    QUIC_CONN_HANDOFF_STATE* State =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONN_HANDOFF_STATE), QUIC_POOL_CONN_HANDOFF);
+    if (State == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "handoff state",
+            sizeof(QUIC_CONN_HANDOFF_STATE));
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    CxPlatZeroMemory(State, sizeof(QUIC_CONN_HANDOFF_STATE));
+
+    QUIC_HANDOFF_READER Reader = { Buffer, (uint16_t)BufferLength, 0 };
+    QUIC_VAR_INT Value, Value2;
+    uint32_t QuicVersion;
+
+    if (!QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &Value) ||
+        Value != QUIC_CONN_HANDOFF_VERSION ||
+        !QuicHandoffReadBytes(&Reader, &QuicVersion, sizeof(QuicVersion)) ||
+        !QuicVersionNegotiationExtIsVersionServerSupported(QuicVersion) ||
+        !QuicHandoffReadAddress(&Reader, &State->LocalAddress) ||
+        !QuicHandoffReadAddress(&Reader, &State->RemoteAddress) ||
+        !QuicHandoffReadVarInt(&Reader, UINT8_MAX, &Value) ||
+        Value == 0 ||
+        !QuicHandoffReadBytes(&Reader, State->Alpn + 1, (uint16_t)Value) ||
+        !QuicHandoffReadSecret(&Reader, &State->ReadSecret) ||
+        !QuicHandoffReadSecret(&Reader, &State->WriteSecret)) {
+        goto Error;
+    }
+    State->Alpn[0] = (uint8_t)Value;
+
+    if (!QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->NextSendPacketNumber) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->NextRecvPacketNumber) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->CurrentKeyPhaseBytesSent) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->MaxData) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->PeerMaxData) ||
+        !QuicHandoffReadVarInt(&Reader, State->MaxData, &State->OrderedStreamBytesReceived) ||
+        !QuicHandoffReadVarInt(&Reader, State->PeerMaxData, &State->OrderedStreamBytesSent)) {
+        goto Error;
+    }
+
+    for (uint8_t Type = 0; Type < NUMBER_OF_STREAM_TYPES; ++Type) {
+        if (!QuicHandoffReadVarInt(
+                &Reader, QUIC_TP_MAX_STREAMS_MAX, &State->MaxTotalStreamCount[Type]) ||
+            !QuicHandoffReadVarInt(
+                &Reader, State->MaxTotalStreamCount[Type], &State->TotalStreamCount[Type])) {
+            goto Error;
+        }
+    }
+
+    if (!QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->SmoothedRtt) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->MinRtt) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->MaxRtt) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->RttVariance) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->LatestRttSample) ||
+        !QuicHandoffReadVarInt(&Reader, UINT16_MAX, &Value) ||
+        !QuicHandoffReadVarInt(&Reader, UINT16_MAX, &Value2)) {
+        goto Error;
+    }
+    State->Mtu = (uint16_t)Value;
+    State->CongestionControlAlgorithm = (uint16_t)Value2;
+
+    if (!QuicHandoffReadVarInt(&Reader, UINT32_MAX, &Value) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->NextSourceCidSequenceNumber) ||
+        !QuicHandoffReadVarInt(&Reader, QUIC_VAR_INT_MAX, &State->RetirePriorTo)) {
+        goto Error;
+    }
+    State->CongestionWindow = (uint32_t)Value;
+
+    if (!QuicHandoffReadVarInt(&Reader, QUIC_CONN_HANDOFF_MAX_CIDS, &Value) || Value == 0) {
+        goto Error;
+    }
+    State->SourceCidCount = (uint8_t)Value;
+    for (uint8_t i = 0; i < State->SourceCidCount; ++i) {
+        if (!QuicHandoffReadCid(&Reader, TRUE, &State->SourceCids[i])) {
+            goto Error;
+        }
+    }
+
+    if (!QuicHandoffReadVarInt(&Reader, QUIC_CONN_HANDOFF_MAX_CIDS, &Value) || Value == 0) {
+        goto Error;
+    }
+    State->DestCidCount = (uint8_t)Value;
+    for (uint8_t i = 0; i < State->DestCidCount; ++i) {
+        if (!QuicHandoffReadCid(&Reader, FALSE, &State->DestCids[i])) {
+            goto Error;
+        }
+    }
+
+    if (!QuicHandoffReadVarInt(&Reader, UINT16_MAX, &Value) ||
+        Reader.Offset + Value != Reader.BufferLength) {
+        goto Error;
+    }
+
+    //
+    // The peer's transport parameters go straight into the connection, where
+    // they are cleaned up with it.
+    //
+    if (!QuicCryptoTlsDecodeTransportParameters(
+            Connection,
+            FALSE,  // IsServerTP
+            Buffer + Reader.Offset,
+            (uint16_t)Value,
+            &Connection->PeerTransportParams)) {
+        QuicCryptoTlsCleanupTransportParameters(&Connection->PeerTransportParams);
+        CxPlatZeroMemory(
+            &Connection->PeerTransportParams,
+            sizeof(Connection->PeerTransportParams));
+        goto Error;
+    }
+
+    Connection->Type = QUIC_HANDLE_TYPE_CONNECTION_SERVER;
+    Connection->Stats.QuicVersion = QuicVersion;
+    QuicConnOnQuicVersionSet(Connection);
+    Connection->HandoffState = State;
+
+    return QUIC_STATUS_SUCCESS;
+
+Error:
+
+    QuicTraceEvent(
+        ConnError,
+        "[conn][%p] ERROR, %s.",
+        Connection,
+        "Invalid handoff state");
+    QuicConnHandoffStateFree(State);
+
+    return QUIC_STATUS_INVALID_PARAMETER;
+}
+
+//
+// Takes over the handed off source CIDs on a server owned binding for the
+// local port, shared with any listener on it.
+//
+static
+QUIC_STATUS
+QuicConnHandoffImportSourceCids(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_CONN_HANDOFF_STATE* State
+    )
+{
+    QUIC_PATH* Path = &Connection->Paths[0];
+
+    QUIC_ADDR BindingLocalAddress = {0};
+    QuicAddrSetFamily(&BindingLocalAddress, QUIC_ADDRESS_FAMILY_INET6);
+    QuicAddrSetPort(&BindingLocalAddress, QuicAddrGetPort(&State->LocalAddress));
+
+    CXPLAT_UDP_CONFIG UdpConfig = {0};
+    UdpConfig.LocalAddress = &BindingLocalAddress;
+    UdpConfig.RemoteAddress = NULL;
+    UdpConfig.Flags = CXPLAT_SOCKET_FLAG_SHARE | CXPLAT_SOCKET_SERVER_OWNED;
+    UdpConfig.InterfaceIndex = 0;
+#ifdef QUIC_COMPARTMENT_ID
+    UdpConfig.CompartmentId = QuicCompartmentIdGetCurrent();
+#endif
+#ifdef QUIC_OWNING_PROCESS
+    UdpConfig.OwningProcess = NULL;
+#endif
+    UdpConfig.CibirIdOffsetSrc = MsQuicLib.CidServerIdLength + 2;
+    UdpConfig.CibirIdOffsetDst = MsQuicLib.CidServerIdLength + 2;
+    if (MsQuicLib.EnableCidSteering) {
+        UdpConfig.CidPartitionCount = MsQuicLib.PartitionCount;
+        UdpConfig.CidPartitionMask = MsQuicLib.PartitionMask;
+        UdpConfig.CidPartitionIdOffset = MsQuicLib.CidServerIdLength;
+    }
+    if (MsQuicLib.Settings.XdpEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
+    }
+    if (MsQuicLib.Settings.QTIPEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
+    }
+    if (MsQuicLib.Settings.RioEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_RIO;
+    }
+
+    QUIC_STATUS Status = QuicLibraryGetBinding(&UdpConfig, &Path->Binding);
+    if (QUIC_FAILED(Status)) {
+        QuicTraceEvent(
+            ConnErrorStatus,
+            "[conn][%p] ERROR, %u, %s.",
+            Connection,
+            Status,
+            "Get binding");
+        return Status;
+    }
+    Connection->State.ShareBinding = TRUE;
+
+    //
+    // New CIDs keep the handed off server ID, so they route the same way.
+    //
+    CxPlatCopyMemory(
+        Connection->ServerID,
+        State->SourceCids[0].Data,
+        MsQuicLib.CidServerIdLength);
+
+    CXPLAT_SLIST_ENTRY** Tail = &Connection->SourceCids.Next;
+    for (uint8_t i = 0; i < State->SourceCidCount; ++i) {
+        const QUIC_CONN_HANDOFF_CID* Cid = &State->SourceCids[i];
+        QUIC_CID_HASH_ENTRY* SourceCid =
+            QuicCidNewSource(Connection, Cid->Length, Cid->Data);
+        if (SourceCid == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "handoff Src CID",
+                sizeof(QUIC_CID_HASH_ENTRY) + Cid->Length);
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        SourceCid->CID.SequenceNumber = Cid->SequenceNumber;
+        SourceCid->CID.Acknowledged = TRUE;
+        SourceCid->CID.UsedByPeer = TRUE;
+        SourceCid->CID.Retired = Cid->Flag;
+
+        if (!QuicBindingAddSourceConnectionID(Path->Binding, SourceCid)) {
+            //
+            // Most likely the old process's connection still has it.
+            //
+            CXPLAT_FREE(SourceCid, QUIC_POOL_CIDHASH);
+            QuicTraceEvent(
+                ConnError,
+                "[conn][%p] ERROR, %s.",
+                Connection,
+                "Handoff source CID already in use");
+            return QUIC_STATUS_ADDRESS_IN_USE;
+        }
+
+        *Tail = &SourceCid->Link;
+        SourceCid->Link.Next = NULL;
+        Tail = &SourceCid->Link.Next;
+        QuicTraceEvent(
+            ConnSourceCidAdded,
+            "[conn][%p] (SeqNum=%llu) New Source CID: %!CID!",
+            Connection,
+            SourceCid->CID.SequenceNumber,
+            CASTED_CLOG_BYTEARRAY(SourceCid->CID.Length, SourceCid->CID.Data));
+    }
+    Connection->NextSourceCidSequenceNumber = State->NextSourceCidSequenceNumber;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Replaces the random destination CID picked when the connection was opened
+// with the handed off ones.
+//
+static
+QUIC_STATUS
+QuicConnHandoffImportDestCids(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_CONN_HANDOFF_STATE* State
+    )
+{
+    CXPLAT_LIST_ENTRY DestCids;
+    CxPlatListInitializeHead(&DestCids);
+    for (uint8_t i = 0; i < State->DestCidCount; ++i) {
+        const QUIC_CONN_HANDOFF_CID* Cid = &State->DestCids[i];
+        QUIC_CID_LIST_ENTRY* DestCid = QuicCidNewDestination(Cid->Length, Cid->Data);
+        if (DestCid == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "handoff Dest CID",
+                sizeof(QUIC_CID_LIST_ENTRY) + Cid->Length);
+            while (!CxPlatListIsEmpty(&DestCids)) {
+                CXPLAT_FREE(
+                    CXPLAT_CONTAINING_RECORD(
+                        CxPlatListRemoveHead(&DestCids),
+                        QUIC_CID_LIST_ENTRY,
+                        Link),
+                    QUIC_POOL_CIDLIST);
+            }
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        DestCid->CID.SequenceNumber = Cid->SequenceNumber;
+        if (Cid->Flag) {
+            DestCid->CID.HasResetToken = TRUE;
+            CxPlatCopyMemory(
+                DestCid->ResetToken,
+                Cid->ResetToken,
+                QUIC_STATELESS_RESET_TOKEN_LENGTH);
+        }
+        CxPlatListInsertTail(&DestCids, &DestCid->Link);
+    }
+
+    while (!CxPlatListIsEmpty(&Connection->DestCids)) {
+        CXPLAT_FREE(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Connection->DestCids),
+                QUIC_CID_LIST_ENTRY,
+                Link),
+            QUIC_POOL_CIDLIST);
+    }
+    CxPlatListMoveItems(&DestCids, &Connection->DestCids);
+    Connection->DestCidCount = State->DestCidCount;
+    Connection->RetirePriorTo = State->RetirePriorTo;
+
+    QUIC_PATH* Path = &Connection->Paths[0];
+    Path->DestCid =
+        CXPLAT_CONTAINING_RECORD(
+            Connection->DestCids.Flink,
+            QUIC_CID_LIST_ENTRY,
+            Link);
+    QUIC_CID_SET_PATH(Connection, Path->DestCid, Path);
+    Path->DestCid->CID.UsedLocally = TRUE;
+
+    for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
+            Entry != &Connection->DestCids;
+            Entry = Entry->Flink) {
+        const QUIC_CID_LIST_ENTRY* DestCid =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CID_LIST_ENTRY, Link);
+        QuicTraceEvent(
+            ConnDestCidAdded,
+            "[conn][%p] (SeqNum=%llu) New Destination CID: %!CID!",
+            Connection,
+            DestCid->CID.SequenceNumber,
+            CASTED_CLOG_BYTEARRAY(DestCid->CID.Length, DestCid->CID.Data));
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+static
+QUIC_STATUS
+QuicConnHandoffImportKeys(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_CONN_HANDOFF_STATE* State
+    )
+{
+    CXPLAT_TLS_PROCESS_STATE* TlsState = &Connection->Crypto.TlsState;
+
+    const QUIC_VERSION_INFO* VersionInfo = &QuicSupportedVersionList[0];
+    for (uint32_t i = 0; i < ARRAYSIZE(QuicSupportedVersionList); ++i) {
+        if (QuicSupportedVersionList[i].Number == Connection->Stats.QuicVersion) {
+            VersionInfo = &QuicSupportedVersionList[i];
+            break;
+        }
+    }
+
+    QUIC_STATUS Status =
+        QuicPacketKeyDerive(
+            QUIC_PACKET_KEY_1_RTT,
+            &VersionInfo->HkdfLabels,
+            &State->ReadSecret,
+            "handoff read secret",
+            TRUE,
+            &TlsState->ReadKeys[QUIC_PACKET_KEY_1_RTT]);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    Status =
+        QuicPacketKeyDerive(
+            QUIC_PACKET_KEY_1_RTT,
+            &VersionInfo->HkdfLabels,
+            &State->WriteSecret,
+            "handoff write secret",
+            TRUE,
+            &TlsState->WriteKeys[QUIC_PACKET_KEY_1_RTT]);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    TlsState->ReadKey = QUIC_PACKET_KEY_1_RTT;
+    TlsState->WriteKey = QUIC_PACKET_KEY_1_RTT;
+    TlsState->HandshakeComplete = TRUE;
+
+    //
+    // Nothing is ever sent or received in the handshake packet spaces.
+    //
+    for (uint32_t i = QUIC_ENCRYPT_LEVEL_INITIAL; i < QUIC_ENCRYPT_LEVEL_1_RTT; ++i) {
+        if (Connection->Packets[i] != NULL) {
+            QuicPacketSpaceUninitialize(Connection->Packets[i]);
+            Connection->Packets[i] = NULL;
+        }
+    }
+
+    Connection->Send.NextPacketNumber = State->NextSendPacketNumber;
+    uint16_t RandomSkip = 0;
+    CxPlatRandom(sizeof(RandomSkip), &RandomSkip);
+    Connection->Send.NextSkippedPacketNumber = State->NextSendPacketNumber + RandomSkip;
+
+    //
+    // Treat every packet number the old process could have received as a
+    // duplicate, so nothing it already processed is processed again.
+    //
+    QUIC_PACKET_SPACE* Packets = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    Packets->NextRecvPacketNumber = State->NextRecvPacketNumber;
+    Packets->CurrentKeyPhaseBytesSent = State->CurrentKeyPhaseBytesSent;
+    if (State->NextRecvPacketNumber != 0) {
+        BOOLEAN RangeUpdated;
+        if (QuicRangeAddRange(
+                &Packets->AckTracker.PacketNumbersReceived,
+                0,
+                State->NextRecvPacketNumber,
+                &RangeUpdated) == NULL) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        Packets->AckTracker.RecentPacketNumbersBase =
+            (State->NextRecvPacketNumber + 63) / 64 * 64;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnHandoffImport(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_CONN_HANDOFF_STATE* State = Connection->HandoffState;
+    QUIC_PATH* Path = &Connection->Paths[0];
+    CXPLAT_TLS_PROCESS_STATE* TlsState = &Connection->Crypto.TlsState;
+    QUIC_STATUS Status;
+
+    CXPLAT_DBG_ASSERT(QuicConnIsServer(Connection));
+    CXPLAT_DBG_ASSERT(!Connection->State.Started);
+
+    if (CxPlatTlsAlpnFindInList(
+            Connection->Configuration->AlpnListLength,
+            Connection->Configuration->AlpnList,
+            State->Alpn[0],
+            State->Alpn + 1) == NULL) {
+        QuicTraceEvent(
+            ConnError,
+            "[conn][%p] ERROR, %s.",
+            Connection,
+            "Handoff ALPN not in configuration");
+        Status = QUIC_STATUS_ALPN_NEG_FAILURE;
+        goto Exit;
+    }
+
+    //
+    // The TLS session wasn't handed off, so there's nothing to resume from.
+    //
+    Connection->State.ResumptionEnabled = FALSE;
+    QuicConnCleanupServerResumptionState(Connection);
+
+    Status = QuicConnProcessPeerTransportParameters(Connection, TRUE);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    Path->Route.State = RouteUnresolved;
+    Path->Route.LocalAddress = State->LocalAddress;
+    Path->Route.RemoteAddress = State->RemoteAddress;
+    Connection->State.LocalAddressSet = TRUE;
+    Connection->State.RemoteAddressSet = TRUE;
+    QuicTraceEvent(
+        ConnLocalAddrAdded,
+        "[conn][%p] New Local IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.LocalAddress), &Path->Route.LocalAddress));
+    QuicTraceEvent(
+        ConnRemoteAddrAdded,
+        "[conn][%p] New Remote IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.RemoteAddress), &Path->Route.RemoteAddress));
+
+    Status = QuicConnHandoffImportDestCids(Connection, State);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    Status = QuicConnHandoffImportSourceCids(Connection, State);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    Status = QuicConnHandoffImportKeys(Connection, State);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    uint16_t NegotiatedAlpnLength = 1 + State->Alpn[0];
+    uint8_t* NegotiatedAlpn;
+    if (NegotiatedAlpnLength <= TLS_SMALL_ALPN_BUFFER_SIZE) {
+        NegotiatedAlpn = TlsState->SmallAlpnBuffer;
+    } else {
+        NegotiatedAlpn = CXPLAT_ALLOC_NONPAGED(NegotiatedAlpnLength, QUIC_POOL_ALPN);
+        if (NegotiatedAlpn == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "NegotiatedAlpn",
+                NegotiatedAlpnLength);
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+    }
+    CxPlatCopyMemory(NegotiatedAlpn, State->Alpn, NegotiatedAlpnLength);
+    TlsState->NegotiatedAlpn = NegotiatedAlpn;
+
+    //
+    // Flow control picks up exactly where it was. The peer may open streams up
+    // to the advertised limit, raised if this process allows more at once.
+    //
+    Connection->Send.MaxData = State->MaxData;
+    Connection->Send.MaxDataSent = State->MaxData;
+    Connection->Send.PeerMaxData = State->PeerMaxData;
+    Connection->Send.OrderedStreamBytesReceived = State->OrderedStreamBytesReceived;
+    Connection->Send.OrderedStreamBytesSent = State->OrderedStreamBytesSent;
+    for (uint8_t Type = 0; Type < NUMBER_OF_STREAM_TYPES; ++Type) {
+        QUIC_STREAM_TYPE_INFO* Info = &Connection->Streams.Types[Type];
+        Info->MaxTotalStreamCount = State->MaxTotalStreamCount[Type];
+        Info->TotalStreamCount = State->TotalStreamCount[Type];
+        if (STREAM_ID_IS_CLIENT(Type) &&
+            Info->TotalStreamCount + Info->MaxCurrentStreamCount > Info->MaxTotalStreamCount) {
+            Info->MaxTotalStreamCount = Info->TotalStreamCount + Info->MaxCurrentStreamCount;
+            QuicSendSetSendFlag(
+                &Connection->Send,
+                STREAM_ID_IS_UNI_DIR(Type) ?
+                    QUIC_CONN_SEND_FLAG_MAX_STREAMS_UNI :
+                    QUIC_CONN_SEND_FLAG_MAX_STREAMS_BIDI);
+        }
+    }
+
+    Path->SmoothedRtt = State->SmoothedRtt;
+    Path->MinRtt = State->MinRtt;
+    Path->MaxRtt = State->MaxRtt;
+    Path->RttVariance = State->RttVariance;
+    Path->LatestRttSample = State->LatestRttSample;
+    Path->GotFirstRttSample = TRUE;
+    Path->IsMinMtuValidated = TRUE;
+    uint16_t Mtu = CXPLAT_MAX(State->Mtu, Connection->Settings->MinimumMtu);
+    Path->Mtu = CXPLAT_MIN(Mtu, QuicConnGetMaxMtuForPath(Connection, Path));
+
+    //
+    // Restart congestion control for the path's MTU and jump back towards the
+    // handed off window, through careful resume's validation.
+    //
+    QuicCongestionControlInitialize(&Connection->CongestionControl, Connection->Settings);
+    if (State->CongestionWindow != 0 &&
+        State->CongestionControlAlgorithm == Connection->Settings->CongestionControlAlgorithm) {
+        QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState;
+        CxPlatZeroMemory(&CarefulResumeState, sizeof(CarefulResumeState));
+        CarefulResumeState.SmoothedRtt = State->SmoothedRtt;
+        CarefulResumeState.MinRtt = State->MinRtt;
+        CarefulResumeState.RemoteEndpoint = State->RemoteAddress;
+        CarefulResumeState.Expiration = UINT64_MAX;
+        CarefulResumeState.Algorithm =
+            (QUIC_CONGESTION_CONTROL_ALGORITHM)State->CongestionControlAlgorithm;
+        CarefulResumeState.CongestionWindow = State->CongestionWindow;
+        QuicCongestionControlSetCarefulResumeState(
+            &Connection->CongestionControl, &CarefulResumeState);
+    }
+
+    Connection->State.Disable1RttEncrytion = FALSE;
+    Connection->State.Started = TRUE;
+    Connection->State.Connected = TRUE;
+    Connection->State.HandshakeConfirmed = TRUE;
+    Connection->Stats.Timing.Start = CxPlatTimeUs64();
+    QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_CONNECTED);
+
+    QUIC_CONNECTION_EVENT Event;
+    Event.Type = QUIC_CONNECTION_EVENT_CONNECTED;
+    Event.CONNECTED.SessionResumed = FALSE;
+    Event.CONNECTED.NegotiatedAlpnLength = TlsState->NegotiatedAlpn[0];
+    Event.CONNECTED.NegotiatedAlpn = TlsState->NegotiatedAlpn + 1;
+    QuicTraceLogConnVerbose(
+        IndicateConnected,
+        Connection,
+        "Indicating QUIC_CONNECTION_EVENT_CONNECTED (Resume=%hhu)",
+        Event.CONNECTED.SessionResumed);
+    (void)QuicConnIndicateEvent(Connection, &Event);
+
+    QuicConnGenerateNewSourceCids(Connection, FALSE);
+    QuicMtuDiscoveryPeerValidated(&Path->MtuDiscovery, Connection);
+    QuicConnResetIdleTimeout(Connection);
+    if (Connection->Settings->KeepAliveIntervalMs != 0) {
+        QuicConnTimerSet(
+            Connection,
+            QUIC_CONN_TIMER_KEEP_ALIVE,
+            MS_TO_US(Connection->Settings->KeepAliveIntervalMs));
+    }
+
+Exit:
+
+    Connection->HandoffState = NULL;
+    QuicConnHandoffStateFree(State);
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnHandoffStateFree(
+    _In_ __drv_freesMem(Mem) QUIC_CONN_HANDOFF_STATE* State
+    )
+{
+    CxPlatSecureZeroMemory(State, sizeof(*State));
+    CXPLAT_FREE(State, QUIC_POOL_CONN_HANDOFF);
+}
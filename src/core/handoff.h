@@ -0,0 +1,143 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Connection state handoff, which moves an established server connection to
+    another process (for instance, the new instance during a hot restart)
+    without the peer noticing.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The version of the exported state format.
+//
+#define QUIC_CONN_HANDOFF_VERSION       1
+
+//
+// The most source or destination CIDs a handoff can carry.
+//
+#define QUIC_CONN_HANDOFF_MAX_CIDS      (2 * QUIC_ACTIVE_CONNECTION_ID_LIMIT)
+
+typedef struct QUIC_CONN_HANDOFF_CID {
+
+    QUIC_VAR_INT SequenceNumber;
+    uint8_t Length;
+
+    //
+    // For source CIDs, the CID has been retired. For destination CIDs, the
+    // CID came with a stateless reset token.
+    //
+    BOOLEAN Flag;
+
+    uint8_t Data[QUIC_MAX_CONNECTION_ID_LENGTH_V1];
+    uint8_t ResetToken[QUIC_STATELESS_RESET_TOKEN_LENGTH];
+
+} QUIC_CONN_HANDOFF_CID;
+
+//
+// Decoded handoff state, kept on the connection until its configuration is set.
+// The peer's transport parameters are decoded straight into the connection.
+//
+typedef struct QUIC_CONN_HANDOFF_STATE {
+
+    QUIC_ADDR LocalAddress;
+    QUIC_ADDR RemoteAddress;
+
+    //
+    // Length prefixed, like CXPLAT_TLS_PROCESS_STATE's NegotiatedAlpn.
+    //
+    uint8_t Alpn[1 + UINT8_MAX];
+
+    //
+    // The 1-RTT traffic secrets.
+    //
+    CXPLAT_SECRET ReadSecret;
+    CXPLAT_SECRET WriteSecret;
+
+    uint64_t NextSendPacketNumber;
+    uint64_t NextRecvPacketNumber;
+    uint64_t CurrentKeyPhaseBytesSent;
+
+    uint64_t MaxData;
+    uint64_t PeerMaxData;
+    uint64_t OrderedStreamBytesReceived;
+    uint64_t OrderedStreamBytesSent;
+
+    uint64_t MaxTotalStreamCount[NUMBER_OF_STREAM_TYPES];
+    uint64_t TotalStreamCount[NUMBER_OF_STREAM_TYPES];
+
+    uint64_t SmoothedRtt;
+    uint64_t MinRtt;
+    uint64_t MaxRtt;
+    uint64_t RttVariance;
+    uint64_t LatestRttSample;
+    uint16_t Mtu;
+
+    uint16_t CongestionControlAlgorithm;
+    uint32_t CongestionWindow;
+
+    QUIC_VAR_INT NextSourceCidSequenceNumber;
+    QUIC_VAR_INT RetirePriorTo;
+
+    uint8_t SourceCidCount;
+    uint8_t DestCidCount;
+    QUIC_CONN_HANDOFF_CID SourceCids[QUIC_CONN_HANDOFF_MAX_CIDS];
+    QUIC_CONN_HANDOFF_CID DestCids[QUIC_CONN_HANDOFF_MAX_CIDS]; // Active one first.
+
+} QUIC_CONN_HANDOFF_STATE;
+
+//
+// Writes the state of a connected server connection to the buffer. Only
+// quiescent connections can be exported: nothing in flight or queued, no open
+// streams, and no key update yet.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnHandoffExport(
+    _In_ QUIC_CONNECTION* Connection,
+    _Inout_ uint32_t* BufferLength,
+    _Out_writes_bytes_opt_(*BufferLength)
+        uint8_t* Buffer
+    );
+
+//
+// Decodes exported state onto a connection that hasn't started yet, turning it
+// into a server connection. The state is applied by QuicConnHandoffImport.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnHandoffSetState(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint32_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t* Buffer
+    );
+
+//
+// Applies the decoded handoff state once the configuration is set, leaving the
+// connection connected.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnHandoffImport(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnHandoffStateFree(
+    _In_ __drv_freesMem(Mem) QUIC_CONN_HANDOFF_STATE* State
+    );
+
+#if defined(__cplusplus)
+}
+#endif
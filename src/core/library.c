@@ -30,8 +30,28 @@ QuicLibraryEvaluateSendRetryState(
     void
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryResetSharedSettings(
+    void
+    );
+
 CXPLAT_THREAD_CALLBACK(RegistrationCleanupWorker, Context);
 
+CXPLAT_THREAD_CALLBACK(HandshakeWorker, Context);
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryStartHandshakeThreads(
+    void
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryStopHandshakeThreads(
+    void
+    );
+
 CXPLAT_DATAPATH_FEATURES
 QuicLibraryGetDatapathFeatures(
     void
@@ -61,6 +81,8 @@ MsQuicLibraryLoad(
         CxPlatSystemLoad();
         CxPlatLockInitialize(&MsQuicLib.Lock);
         CxPlatDispatchLockInitialize(&MsQuicLib.DatapathLock);
+        CxPlatDispatchLockInitialize(&MsQuicLib.SharedSettingsLock);
+        QuicRecvCaptureInitialize();
 #if DEBUG
         QuicLibraryInitializeDbg();
 #endif
@@ -93,6 +115,8 @@ MsQuicLibraryUnload(
 #if DEBUG
         QuicLibraryUninitializeDbg();
 #endif
+        QuicRecvCaptureUninitialize();
+        CxPlatDispatchLockUninitialize(&MsQuicLib.SharedSettingsLock);
         CxPlatDispatchLockUninitialize(&MsQuicLib.DatapathLock);
         CxPlatLockUninitialize(&MsQuicLib.Lock);
         CxPlatSystemUnload();
@@ -135,6 +159,74 @@ MsQuicLibraryFreePartitions(
     }
 }
 
+//
+// A contiguous block of partitions initialized by a single thread.
+//
+typedef struct QUIC_PARTITION_INIT_BLOCK {
+
+    CXPLAT_THREAD Thread;
+    BOOLEAN ThreadCreated;
+
+    const uint16_t* ProcessorList;
+    const uint8_t* ResetHashKey;
+    uint32_t ResetHashKeyLength;
+
+    uint16_t Start;
+    uint16_t End;
+    uint16_t Initialized; // Number initialized, from Start.
+    QUIC_STATUS Status;
+
+} QUIC_PARTITION_INIT_BLOCK;
+
+static
+uint16_t
+QuicLibraryGetPartitionProcessor(
+    _In_opt_ const uint16_t* ProcessorList,
+    _In_ uint16_t Index
+    )
+{
+#ifndef _KERNEL_MODE
+    return
+        ProcessorList ? ProcessorList[Index] :
+            (MsQuicLib.CustomPartitions ?
+                (uint16_t)CxPlatWorkerPoolGetIdealProcessor(MsQuicLib.WorkerPool, Index) :
+                Index);
+#else
+    return ProcessorList ? ProcessorList[Index] : Index;
+#endif
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLibraryInitializePartitionBlock(
+    _Inout_ QUIC_PARTITION_INIT_BLOCK* Block
+    )
+{
+    for (uint16_t i = Block->Start; i < Block->End; ++i) {
+        Block->Status =
+            QuicPartitionInitialize(
+                &MsQuicLib.Partitions[i],
+                i,
+                QuicLibraryGetPartitionProcessor(Block->ProcessorList, i),
+                CXPLAT_HASH_SHA256,
+                Block->ResetHashKey,
+                Block->ResetHashKeyLength,
+                MsQuicLib.TicketCacheSize,
+                &MsQuicLib.PoolReserve);
+        if (QUIC_FAILED(Block->Status)) {
+            break;
+        }
+        Block->Initialized++;
+    }
+}
+
+CXPLAT_THREAD_CALLBACK(PartitionInitWorker, Context)
+{
+    QuicLibraryInitializePartitionBlock((QUIC_PARTITION_INIT_BLOCK*)Context);
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicLibraryInitializePartitions(
@@ -145,7 +237,7 @@ QuicLibraryInitializePartitions(
     MsQuicLib.PartitionCount = (uint16_t)CxPlatProcCount();
     CXPLAT_FRE_ASSERT(MsQuicLib.PartitionCount > 0);
 
-    uint16_t* ProcessorList = NULL;
+    const uint16_t* ProcessorList = NULL;
 #ifndef _KERNEL_MODE
     if (MsQuicLib.WorkerPool != NULL) {
         MsQuicLib.CustomPartitions = TRUE;
@@ -165,6 +257,16 @@ QuicLibraryInitializePartitions(
         MsQuicLib.PartitionCount = (uint16_t)MsQuicLib.ExecutionConfig->ProcessorCount;
         ProcessorList = MsQuicLib.ExecutionConfig->ProcessorList;
 
+    } else if (CxPlatProcDefaultList() != NULL) {
+        //
+        // The process is restricted to fewer processors than the system has
+        // (e.g. by a container's cpuset or CPU quota), so only create
+        // partitions for the ones it can actually use.
+        //
+        MsQuicLib.CustomPartitions = TRUE;
+        MsQuicLib.PartitionCount = (uint16_t)CxPlatProcDefaultCount();
+        ProcessorList = CxPlatProcDefaultList();
+
     } else {
         MsQuicLib.CustomPartitions = FALSE;
 
@@ -217,28 +319,80 @@ QuicLibraryInitializePartitions(
     CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(Status));
     CxPlatSecureZeroMemory(RetrySecret, sizeof(RetrySecret));
 
-    uint16_t i;
-    for (i = 0; i < MsQuicLib.PartitionCount; ++i) {
-        Status =
-            QuicPartitionInitialize(
-                &MsQuicLib.Partitions[i],
-                i,
-#ifndef _KERNEL_MODE
-                ProcessorList ? ProcessorList[i] :
-                    (MsQuicLib.CustomPartitions ?
-                        (uint16_t)CxPlatWorkerPoolGetIdealProcessor(MsQuicLib.WorkerPool, i) :
-                        i),
-#else
-                ProcessorList ? ProcessorList[i] : i,
-#endif
-                CXPLAT_HASH_SHA256,
-                ResetHashKey,
-                sizeof(ResetHashKey));
-        if (QUIC_FAILED(Status)) {
-            goto Error;
+    //
+    // Each block of partitions after the first is initialized on its own
+    // thread, on the processor of its first partition, so that the partitions'
+    // memory is also first touched on their NUMA node. The first block is
+    // initialized on this thread.
+    //
+    const uint16_t BlockCount =
+        (uint16_t)((MsQuicLib.PartitionCount + QUIC_PARTITION_INIT_BLOCK_SIZE - 1) /
+            QUIC_PARTITION_INIT_BLOCK_SIZE);
+    const size_t BlocksSize = BlockCount * sizeof(QUIC_PARTITION_INIT_BLOCK);
+    QUIC_PARTITION_INIT_BLOCK* Blocks =
+        CXPLAT_ALLOC_NONPAGED(BlocksSize, QUIC_POOL_PERPROC);
+    if (Blocks == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Partition init blocks",
+            BlocksSize);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    CxPlatZeroMemory(Blocks, BlocksSize);
+
+    for (uint16_t i = 0; i < BlockCount; ++i) {
+        QUIC_PARTITION_INIT_BLOCK* Block = &Blocks[i];
+        Block->ProcessorList = ProcessorList;
+        Block->ResetHashKey = ResetHashKey;
+        Block->ResetHashKeyLength = sizeof(ResetHashKey);
+        Block->Start = (uint16_t)(i * QUIC_PARTITION_INIT_BLOCK_SIZE);
+        Block->End =
+            (uint16_t)CXPLAT_MIN(
+                (uint32_t)Block->Start + QUIC_PARTITION_INIT_BLOCK_SIZE,
+                MsQuicLib.PartitionCount);
+        Block->Status = QUIC_STATUS_SUCCESS;
+        if (i == 0) {
+            continue;
+        }
+
+        CXPLAT_THREAD_CONFIG ThreadConfig = {
+            CXPLAT_THREAD_FLAG_SET_IDEAL_PROC,
+            QuicLibraryGetPartitionProcessor(ProcessorList, Block->Start),
+            "PartitionInit",
+            PartitionInitWorker,
+            Block
+        };
+        if (QUIC_SUCCEEDED(CxPlatThreadCreate(&ThreadConfig, &Block->Thread))) {
+            Block->ThreadCreated = TRUE;
+        }
+    }
+
+    for (uint16_t i = 0; i < BlockCount; ++i) {
+        QUIC_PARTITION_INIT_BLOCK* Block = &Blocks[i];
+        if (Block->ThreadCreated) {
+            CxPlatThreadWait(&Block->Thread);
+            CxPlatThreadDelete(&Block->Thread);
+        } else {
+            QuicLibraryInitializePartitionBlock(Block); // No thread, so do it inline.
+        }
+        if (QUIC_FAILED(Block->Status)) {
+            Status = Block->Status;
         }
     }
 
+    if (QUIC_FAILED(Status)) {
+        for (uint16_t i = 0; i < BlockCount; ++i) {
+            for (uint16_t j = 0; j < Blocks[i].Initialized; ++j) {
+                QuicPartitionUninitialize(&MsQuicLib.Partitions[Blocks[i].Start + j]);
+            }
+        }
+        CXPLAT_FREE(Blocks, QUIC_POOL_PERPROC);
+        goto Error;
+    }
+
+    CXPLAT_FREE(Blocks, QUIC_POOL_PERPROC);
     CxPlatSecureZeroMemory(ResetHashKey, sizeof(ResetHashKey));
 
     return QUIC_STATUS_SUCCESS;
@@ -247,10 +401,6 @@ Error:
 
     CxPlatSecureZeroMemory(ResetHashKey, sizeof(ResetHashKey));
 
-    for (uint16_t j = 0; j < i; ++j) {
-        QuicPartitionUninitialize(&MsQuicLib.Partitions[j]);
-    }
-
     CXPLAT_FREE(MsQuicLib.Partitions, QUIC_POOL_PERPROC);
     MsQuicLib.Partitions = NULL;
 
@@ -281,6 +431,29 @@ QuicLibrarySumPerfCounters(
         }
     }
 
+    //
+    // Memory usage is tracked library wide, not per partition.
+    //
+    if (CountersPerBuffer > QUIC_PERF_COUNTER_MEMORY_USAGE) {
+        Counters[QUIC_PERF_COUNTER_MEMORY_USAGE] = (int64_t)MsQuicLib.CurrentMemoryUsage;
+    }
+
+    //
+    // XDP poll mode time is tracked by the datapath, not per partition.
+    //
+    if (CountersPerBuffer > QUIC_PERF_COUNTER_XDP_BUSY_POLL_TIME) {
+        Counters[QUIC_PERF_COUNTER_XDP_BUSY_POLL_TIME] =
+            MsQuicLib.XdpPollStatistics.TimeUs[CXPLAT_XDP_POLL_MODE_BUSY_POLL];
+    }
+    if (CountersPerBuffer > QUIC_PERF_COUNTER_XDP_SLEEP_TIME) {
+        Counters[QUIC_PERF_COUNTER_XDP_SLEEP_TIME] =
+            MsQuicLib.XdpPollStatistics.TimeUs[CXPLAT_XDP_POLL_MODE_SLEEP];
+    }
+    if (CountersPerBuffer > QUIC_PERF_COUNTER_XDP_INTERRUPT_TIME) {
+        Counters[QUIC_PERF_COUNTER_XDP_INTERRUPT_TIME] =
+            MsQuicLib.XdpPollStatistics.TimeUs[CXPLAT_XDP_POLL_MODE_INTERRUPT];
+    }
+
     //
     // Zero any counters that are still negative after summation.
     //
@@ -428,6 +601,27 @@ QuicLibraryLoadRetryConfig(
     CxPlatSecureZeroMemory(&Secret, sizeof(Secret));
 }
 
+//
+// Derives the memory pressure thresholds from the configured budget, or the
+// default one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLibApplyMemoryBudget(
+    void
+    )
+{
+    const uint64_t Budget =
+        MsQuicLib.MemoryBudget != 0 ?
+            MsQuicLib.MemoryBudget :
+            CxPlatTotalMemory / QUIC_DEFAULT_MEMORY_BUDGET_DIVISOR;
+    MsQuicLib.MemoryPressureHighThreshold =
+        (Budget / 100) * QUIC_MEMORY_PRESSURE_HIGH_PERCENT;
+    MsQuicLib.MemoryPressureCriticalThreshold =
+        (Budget / 100) * QUIC_MEMORY_PRESSURE_CRITICAL_PERCENT;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 MsQuicLibraryOnSettingsChanged(
@@ -443,9 +637,14 @@ MsQuicLibraryOnSettingsChanged(
         QuicLibApplyLoadBalancingSetting();
     }
 
+    QuicLibraryResetSharedSettings();
+
     MsQuicLib.HandshakeMemoryLimit =
         (MsQuicLib.Settings.RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
     QuicLibraryEvaluateSendRetryState();
+    MsQuicLib.RecvWindowMemoryLimit =
+        CxPlatTotalMemory / QUIC_RECV_WINDOW_AUTOTUNE_MEMORY_DIVISOR;
+    QuicLibApplyMemoryBudget();
 
     if (UpdateRegistrations) {
         CxPlatLockAcquire(&MsQuicLib.Lock);
@@ -491,6 +690,7 @@ MsQuicLibraryInitialize(
 {
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     BOOLEAN PlatformInitialized = FALSE;
+    BOOLEAN BindingTableInitialized = FALSE;
 
     Status = CxPlatInitialize();
     if (QUIC_FAILED(Status)) {
@@ -508,6 +708,8 @@ MsQuicLibraryInitialize(
     CxPlatToeplitzHashInitialize(&MsQuicLib.ToeplitzHash);
 
     CxPlatDispatchRwLockInitialize(&MsQuicLib.StatelessRetry.Lock);
+    CxPlatDispatchRwLockInitialize(&MsQuicLib.QuicLb.Lock);
+    CxPlatDispatchRwLockInitialize(&MsQuicLib.RssPartitioning.Lock);
 
     CxPlatZeroMemory(&MsQuicLib.Settings, sizeof(MsQuicLib.Settings));
     CxPlatLockInitialize(&MsQuicLib.RegistrationCloseCleanupLock);
@@ -518,6 +720,17 @@ MsQuicLibraryInitialize(
 
     PlatformInitialized = TRUE;
 
+    if (!CxPlatHashtableInitializeEx(&MsQuicLib.BindingTable, CXPLAT_HASH_MIN_SIZE)) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "binding table",
+            0);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    BindingTableInitialized = TRUE;
+
     Status =
         CxPlatStorageOpen(
             NULL,
@@ -621,11 +834,16 @@ Error:
             CXPLAT_FREE(MsQuicLib.DefaultCompatibilityList, QUIC_POOL_DEFAULT_COMPAT_VER_LIST);
             MsQuicLib.DefaultCompatibilityList = NULL;
         }
+        if (BindingTableInitialized) {
+            CxPlatHashtableUninitialize(&MsQuicLib.BindingTable);
+        }
         if (PlatformInitialized) {
             CxPlatRundownUninitialize(&MsQuicLib.RegistrationCloseCleanupRundown);
             CxPlatEventUninitialize(MsQuicLib.RegistrationCloseCleanupEvent);
             CxPlatLockUninitialize(&MsQuicLib.RegistrationCloseCleanupLock);
             CxPlatDispatchRwLockUninitialize(&MsQuicLib.StatelessRetry.Lock);
+            CxPlatDispatchRwLockUninitialize(&MsQuicLib.QuicLb.Lock);
+            CxPlatDispatchRwLockUninitialize(&MsQuicLib.RssPartitioning.Lock);
             CxPlatUninitialize();
         }
     }
@@ -715,8 +933,12 @@ MsQuicLibraryLazyUninitialize(
     //
     CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&MsQuicLib.Bindings));
 
+    QuicQlogStop();
+
     MsQuicLibraryFreePartitions();
 
+    QuicLibraryStopHandshakeThreads();
+
     MsQuicLib.LazyInitComplete = FALSE;
 }
 
@@ -737,13 +959,28 @@ MsQuicLibraryUninitialize(
         MsQuicLib.Storage = NULL;
     }
 
+    QuicLibraryResetSharedSettings();
     QuicSettingsCleanup(&MsQuicLib.Settings);
 
     CXPLAT_FREE(MsQuicLib.DefaultCompatibilityList, QUIC_POOL_DEFAULT_COMPAT_VER_LIST);
     MsQuicLib.DefaultCompatibilityList = NULL;
 
+    CxPlatHashtableUninitialize(&MsQuicLib.BindingTable);
+
     CxPlatDispatchRwLockUninitialize(&MsQuicLib.StatelessRetry.Lock);
 
+    CxPlatHpKeyFree(MsQuicLib.QuicLb.Key);
+    MsQuicLib.QuicLb.Key = NULL;
+    CxPlatSecureZeroMemory(&MsQuicLib.QuicLb.Config, sizeof(MsQuicLib.QuicLb.Config));
+    CxPlatDispatchRwLockUninitialize(&MsQuicLib.QuicLb.Lock);
+
+    if (MsQuicLib.RssPartitioning.Config != NULL) {
+        CxPlatDataPathRssConfigFree(MsQuicLib.RssPartitioning.Config);
+        MsQuicLib.RssPartitioning.Config = NULL;
+    }
+    MsQuicLib.RssPartitioning.InterfaceIndex = 0;
+    CxPlatDispatchRwLockUninitialize(&MsQuicLib.RssPartitioning.Lock);
+
     CxPlatRundownReleaseAndWait(&MsQuicLib.RegistrationCloseCleanupRundown);
     MsQuicLib.RegistrationCloseCleanupShutdown = TRUE;
     CxPlatEventSet(MsQuicLib.RegistrationCloseCleanupEvent);
@@ -759,6 +996,11 @@ MsQuicLibraryUninitialize(
         MsQuicLib.ExecutionConfig = NULL;
     }
 
+    if (MsQuicLib.Qlog.FilePath != NULL) {
+        CXPLAT_FREE(MsQuicLib.Qlog.FilePath, QUIC_POOL_QLOG);
+        MsQuicLib.Qlog.FilePath = NULL;
+    }
+
 #ifndef _KERNEL_MODE
     CxPlatWorkerPoolDelete(MsQuicLib.WorkerPool, CXPLAT_WORKER_POOL_REF_LIBRARY);
     MsQuicLib.WorkerPool = NULL;
@@ -798,6 +1040,154 @@ CXPLAT_THREAD_CALLBACK(RegistrationCleanupWorker, Context)
     CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
 }
 
+CXPLAT_THREAD_CALLBACK(HandshakeWorker, Context)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    while (TRUE) {
+        CxPlatEventWaitForever(MsQuicLib.HandshakeEvent);
+
+        CxPlatLockAcquire(&MsQuicLib.HandshakeLock);
+        if (MsQuicLib.HandshakeShutdown) {
+            CxPlatLockRelease(&MsQuicLib.HandshakeLock);
+            break;
+        }
+        CXPLAT_LIST_ENTRY* Entry = NULL;
+        if (!CxPlatListIsEmpty(&MsQuicLib.HandshakeQueue)) {
+            Entry = CxPlatListRemoveHead(&MsQuicLib.HandshakeQueue);
+        }
+        if (!CxPlatListIsEmpty(&MsQuicLib.HandshakeQueue)) {
+            //
+            // The event auto-resets, so pass the wake on to another thread.
+            //
+            CxPlatEventSet(MsQuicLib.HandshakeEvent);
+        }
+        CxPlatLockRelease(&MsQuicLib.HandshakeLock);
+
+        if (Entry != NULL) {
+            QuicCryptoProcessHandshakeOffload(Entry);
+        }
+    }
+
+    //
+    // Wake the next thread so it sees the shutdown too.
+    //
+    CxPlatEventSet(MsQuicLib.HandshakeEvent);
+
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
+//
+// Creates the handshake threads, if configured. Failure isn't fatal; TLS
+// processing just stays on the connection workers.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryStartHandshakeThreads(
+    void
+    )
+{
+    CXPLAT_DBG_ASSERT(MsQuicLib.HandshakeThreadsStarted == 0);
+    if (MsQuicLib.HandshakeThreadCount == 0) {
+        return;
+    }
+
+    MsQuicLib.HandshakeThreads =
+        CXPLAT_ALLOC_NONPAGED(
+            MsQuicLib.HandshakeThreadCount * sizeof(CXPLAT_THREAD),
+            QUIC_POOL_HANDSHAKE_THREADS);
+    if (MsQuicLib.HandshakeThreads == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "handshake threads",
+            MsQuicLib.HandshakeThreadCount * sizeof(CXPLAT_THREAD));
+        return;
+    }
+
+    CxPlatLockInitialize(&MsQuicLib.HandshakeLock);
+    CxPlatEventInitialize(&MsQuicLib.HandshakeEvent, FALSE, FALSE);
+    CxPlatListInitializeHead(&MsQuicLib.HandshakeQueue);
+    MsQuicLib.HandshakeShutdown = FALSE;
+
+    CXPLAT_THREAD_CONFIG ThreadConfig = {
+        0,
+        0,
+        "HandshakeWorker",
+        HandshakeWorker,
+        NULL,
+    };
+
+    for (uint16_t i = 0; i < MsQuicLib.HandshakeThreadCount; ++i) {
+        QUIC_STATUS Status =
+            CxPlatThreadCreate(
+                &ThreadConfig,
+                &MsQuicLib.HandshakeThreads[MsQuicLib.HandshakeThreadsStarted]);
+        if (QUIC_FAILED(Status)) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "CxPlatThreadCreate (handshake)");
+            break;
+        }
+        MsQuicLib.HandshakeThreadsStarted++;
+    }
+
+    if (MsQuicLib.HandshakeThreadsStarted == 0) {
+        CxPlatEventUninitialize(MsQuicLib.HandshakeEvent);
+        CxPlatLockUninitialize(&MsQuicLib.HandshakeLock);
+        CXPLAT_FREE(MsQuicLib.HandshakeThreads, QUIC_POOL_HANDSHAKE_THREADS);
+        MsQuicLib.HandshakeThreads = NULL;
+    }
+}
+
+//
+// Stops the handshake threads. All connections must already be cleaned up, so
+// the queue is empty.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryStopHandshakeThreads(
+    void
+    )
+{
+    if (MsQuicLib.HandshakeThreadsStarted == 0) {
+        return;
+    }
+
+    CxPlatLockAcquire(&MsQuicLib.HandshakeLock);
+    CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&MsQuicLib.HandshakeQueue));
+    MsQuicLib.HandshakeShutdown = TRUE;
+    CxPlatEventSet(MsQuicLib.HandshakeEvent);
+    CxPlatLockRelease(&MsQuicLib.HandshakeLock);
+
+    for (uint16_t i = 0; i < MsQuicLib.HandshakeThreadsStarted; ++i) {
+        CxPlatThreadWait(&MsQuicLib.HandshakeThreads[i]);
+        CxPlatThreadDelete(&MsQuicLib.HandshakeThreads[i]);
+    }
+    MsQuicLib.HandshakeThreadsStarted = 0;
+
+    CxPlatEventUninitialize(MsQuicLib.HandshakeEvent);
+    CxPlatLockUninitialize(&MsQuicLib.HandshakeLock);
+    CXPLAT_FREE(MsQuicLib.HandshakeThreads, QUIC_POOL_HANDSHAKE_THREADS);
+    MsQuicLib.HandshakeThreads = NULL;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryQueueHandshakeOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    )
+{
+    CXPLAT_DBG_ASSERT(MsQuicLib.HandshakeThreadsStarted != 0);
+
+    CxPlatLockAcquire(&MsQuicLib.HandshakeLock);
+    CxPlatListInsertTail(&MsQuicLib.HandshakeQueue, Link);
+    CxPlatEventSet(MsQuicLib.HandshakeEvent);
+    CxPlatLockRelease(&MsQuicLib.HandshakeLock);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 MsQuicAddRef(
@@ -905,10 +1295,23 @@ QuicLibraryLazyInitialize(
         }
         CreatedWorkerPool = TRUE;
     }
+
+    const uint32_t PoolWorkerCount = CxPlatWorkerPoolGetCount(MsQuicLib.WorkerPool);
+    for (uint16_t i = 0; i < MsQuicLib.PartitionCount && i < PoolWorkerCount; ++i) {
+        QuicPartitionStartRecvStage(&MsQuicLib.Partitions[i]);
+    }
 #endif
 
     CXPLAT_DATAPATH_INIT_CONFIG InitConfig = {0};
     InitConfig.EnableDscpOnRecv = MsQuicLib.EnableDscpOnRecv;
+    InitConfig.EnableZeroCopySend = MsQuicLib.EnableZeroCopySend;
+    InitConfig.EnableTxTimePacing = MsQuicLib.EnableTxTimePacing;
+    InitConfig.EnableHugePages = MsQuicLib.EnableHugePages;
+    InitConfig.PoolReserveCount = MsQuicLib.PoolReserve.DatapathBuffers;
+    InitConfig.Loopback = MsQuicLib.EnableLoopback ? &MsQuicLib.LoopbackConfig : NULL;
+    InitConfig.XdpPollModeration =
+        MsQuicLib.CustomXdpPollModeration ? &MsQuicLib.XdpPollModeration : NULL;
+    InitConfig.XdpPollStatistics = &MsQuicLib.XdpPollStatistics;
 
     Status =
         CxPlatDataPathInitialize(
@@ -923,6 +1326,13 @@ QuicLibraryLazyInitialize(
             DataPathInitialized,
             "[data] Initialized, DatapathFeatures=%u",
             QuicLibraryGetDatapathFeatures());
+        //
+        // XDP sends bypass the qdisc layer, so departure times would be
+        // ignored and the connection left unpaced.
+        //
+        MsQuicLib.TxTimePacing =
+            !MsQuicLib.Settings.XdpEnabled &&
+            !!(QuicLibraryGetDatapathFeatures() & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME);
         if (MsQuicLib.ExecutionConfig &&
             MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs != 0) {
             CxPlatDataPathUpdatePollingIdleTimeout(
@@ -942,6 +1352,8 @@ QuicLibraryLazyInitialize(
 
     CXPLAT_DBG_ASSERT(MsQuicLib.Partitions != NULL);
     CXPLAT_DBG_ASSERT(MsQuicLib.Datapath != NULL);
+    QuicLibraryStartHandshakeThreads();
+    QuicQlogStart();
     MsQuicLib.LazyInitComplete = TRUE;
 
 Exit:
@@ -1034,6 +1446,12 @@ QuicLibApplyLoadBalancingSetting(
     case QUIC_LOAD_BALANCING_SERVER_ID_FIXED: // 1 + 4 for fixed value
         MsQuicLib.CidServerIdLength = 5;
         break;
+    case QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB: // First octet + server ID + nonce
+        MsQuicLib.CidServerIdLength =
+            MsQuicLib.QuicLb.Config.ServerIdLength == 0 ?
+                0 : // Not configured yet
+                QUIC_LB_ENCODED_LENGTH(&MsQuicLib.QuicLb.Config);
+        break;
     }
 
     MsQuicLib.CidTotalLength =
@@ -1051,6 +1469,67 @@ QuicLibApplyLoadBalancingSetting(
         MsQuicLib.CidTotalLength);
 }
 
+//
+// Aligns new server connections to the RSS processor of their 4-tuple on the
+// given interface, or stops doing so if InterfaceIndex is zero.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicLibrarySetRssPartitioningInterface(
+    _In_ uint32_t InterfaceIndex
+    )
+{
+    CXPLAT_RSS_CONFIG* RssConfig = NULL;
+    if (InterfaceIndex != 0) {
+        QUIC_STATUS Status = CxPlatDataPathRssConfigGet(InterfaceIndex, &RssConfig);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+
+        const uint32_t TableCount = RssConfig->RssIndirectionTableCount;
+        if (TableCount == 0 || (TableCount & (TableCount - 1)) != 0 ||
+            RssConfig->RssSecretKeyLength < CXPLAT_TOEPLITZ_KEY_SIZE_MIN ||
+            RssConfig->RssSecretKeyLength > CXPLAT_TOEPLITZ_KEY_SIZE_MAX) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                InterfaceIndex,
+                "Unsupported RSS configuration for partitioning");
+            CxPlatDataPathRssConfigFree(RssConfig);
+            return QUIC_STATUS_NOT_SUPPORTED;
+        }
+    }
+
+    CxPlatDispatchRwLockAcquireExclusive(&MsQuicLib.RssPartitioning.Lock, PrevIrql);
+    CXPLAT_RSS_CONFIG* OldRssConfig = MsQuicLib.RssPartitioning.Config;
+    MsQuicLib.RssPartitioning.Config = RssConfig;
+    MsQuicLib.RssPartitioning.InterfaceIndex = InterfaceIndex;
+    if (RssConfig != NULL) {
+        CxPlatZeroMemory(
+            MsQuicLib.RssPartitioning.ToeplitzHash.HashKey,
+            sizeof(MsQuicLib.RssPartitioning.ToeplitzHash.HashKey));
+        CxPlatCopyMemory(
+            MsQuicLib.RssPartitioning.ToeplitzHash.HashKey,
+            RssConfig->RssSecretKey,
+            RssConfig->RssSecretKeyLength);
+        MsQuicLib.RssPartitioning.ToeplitzHash.InputSize = CXPLAT_TOEPLITZ_INPUT_SIZE_IP;
+        CxPlatToeplitzHashInitialize(&MsQuicLib.RssPartitioning.ToeplitzHash);
+    }
+    CxPlatDispatchRwLockReleaseExclusive(&MsQuicLib.RssPartitioning.Lock, PrevIrql);
+
+    if (OldRssConfig != NULL) {
+        CxPlatDataPathRssConfigFree(OldRssConfig);
+    }
+
+    QuicTraceLogInfo(
+        LibraryRssPartitioningSet,
+        "[ lib] Updated RSS partitioning interface = %u",
+        InterfaceIndex);
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicLibrarySetGlobalParam(
@@ -1075,6 +1554,7 @@ QuicLibrarySetGlobalParam(
 
         MsQuicLib.Settings.RetryMemoryLimit = *(uint16_t*)Buffer;
         MsQuicLib.Settings.IsSet.RetryMemoryLimit = TRUE;
+        QuicLibraryResetSharedSettings();
 
         QuicTraceLogInfo(
             LibraryRetryMemoryLimitSet,
@@ -1095,7 +1575,8 @@ QuicLibrarySetGlobalParam(
             break;
         }
 
-        if (*(uint16_t*)Buffer > QUIC_LOAD_BALANCING_SERVER_ID_IP) {
+        if (*(uint16_t*)Buffer > QUIC_LOAD_BALANCING_SERVER_ID_IP &&
+            *(uint16_t*)Buffer != QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
@@ -1111,6 +1592,7 @@ QuicLibrarySetGlobalParam(
 
         MsQuicLib.Settings.LoadBalancingMode = *(uint16_t*)Buffer;
         MsQuicLib.Settings.IsSet.LoadBalancingMode = TRUE;
+        QuicLibraryResetSharedSettings();
 
         QuicLibApplyLoadBalancingSetting();
 
@@ -1382,26 +1864,251 @@ QuicLibrarySetGlobalParam(
         break;
     }
 
-    case QUIC_PARAM_GLOBAL_VERSION_NEGOTIATION_ENABLED:
+    case QUIC_PARAM_GLOBAL_DATAPATH_ZEROCOPY_SEND_ENABLED: {
 
-        if (Buffer == NULL ||
-            BufferLength < sizeof(BOOLEAN)) {
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
-        MsQuicLib.Settings.IsSet.VersionNegotiationExtEnabled = TRUE;
-        MsQuicLib.Settings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The datapath's send mode is fixed once it has been created.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
 
+        MsQuicLib.EnableZeroCopySend = *(BOOLEAN*)Buffer;
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_STATELESS_RESET_KEY:
-        if (!MsQuicLib.LazyInitComplete) {
+    case QUIC_PARAM_GLOBAL_DATAPATH_TXTIME_PACING_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The datapath's send mode is fixed once it has been created.
+            //
             Status = QUIC_STATUS_INVALID_STATE;
             break;
         }
-        if (BufferLength != QUIC_STATELESS_RESET_KEY_LENGTH * sizeof(uint8_t)) {
+
+        MsQuicLib.EnableTxTimePacing = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_HUGE_PAGES_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The datapath's buffer pools are created with it.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.EnableHugePages = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_LOOPBACK: {
+
+        if (BufferLength != sizeof(QUIC_DATAPATH_LOOPBACK_CONFIG) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The datapath is chosen when it's created.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const QUIC_DATAPATH_LOOPBACK_CONFIG* Config = (QUIC_DATAPATH_LOOPBACK_CONFIG*)Buffer;
+        if (Config->LossRate > 1000000) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.LoopbackConfig.DelayUs = Config->DelayUs;
+        MsQuicLib.LoopbackConfig.LossRate = Config->LossRate;
+        MsQuicLib.LoopbackConfig.Bandwidth = Config->Bandwidth;
+        MsQuicLib.EnableLoopback = TRUE;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_XDP_POLL_MODERATION: {
+
+        if (BufferLength != sizeof(QUIC_XDP_POLL_MODERATION_CONFIG) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The thresholds are read when the datapath is created.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const QUIC_XDP_POLL_MODERATION_CONFIG* Config = (QUIC_XDP_POLL_MODERATION_CONFIG*)Buffer;
+        if (Config->SleepRate != 0 && Config->SleepIntervalUs == 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.XdpPollModeration.BusyPollRate = Config->BusyPollRate;
+        MsQuicLib.XdpPollModeration.SleepRate = Config->SleepRate;
+        MsQuicLib.XdpPollModeration.SleepIntervalUs = Config->SleepIntervalUs;
+        MsQuicLib.CustomXdpPollModeration = TRUE;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_CID_STEERING_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.EnableCidSteering = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SOFTWARE_RSS_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.EnableSoftwareRss = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_HANDSHAKE_THREAD_COUNT: {
+
+        if (BufferLength != sizeof(uint16_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The handshake threads are created with the datapath.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.HandshakeThreadCount = *(uint16_t*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SERVER_TICKET_CACHE_SIZE: {
+
+        if (BufferLength != sizeof(uint32_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The caches are allocated with the partitions.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.TicketCacheSize = *(uint32_t*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_IDEAL_SEND_BUFFER_HEADROOM: {
+
+        if (BufferLength != sizeof(uint16_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.IdealSendBufferHeadroom = *(uint16_t*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SENT_PACKET_RING_SIZE: {
+
+        if (BufferLength != sizeof(uint32_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        uint32_t SlotCount = *(uint32_t*)Buffer;
+        if ((SlotCount & (SlotCount - 1)) != 0 ||
+            SlotCount > QUIC_MAX_SENT_PACKET_RING_SIZE) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.SentPacketRingSize = SlotCount;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SERVER_TICKET_CACHE_FLUSH:
+
+        if (MsQuicLib.LazyInitComplete) {
+            for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+                QuicTicketCacheFlush(&MsQuicLib.Partitions[i].TicketCache);
+            }
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_VERSION_NEGOTIATION_ENABLED:
+
+        if (Buffer == NULL ||
+            BufferLength < sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.Settings.IsSet.VersionNegotiationExtEnabled = TRUE;
+        MsQuicLib.Settings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
+        QuicLibraryResetSharedSettings();
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_STATELESS_RESET_KEY:
+        if (!MsQuicLib.LazyInitComplete) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+        if (BufferLength != QUIC_STATELESS_RESET_KEY_LENGTH * sizeof(uint8_t)) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
@@ -1430,6 +2137,69 @@ QuicLibrarySetGlobalParam(
         break;
     }
 
+    case QUIC_PARAM_GLOBAL_QUIC_LB_CONFIG:
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_LB_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+        Status = QuicLibrarySetQuicLbConfig((const QUIC_LB_CONFIG*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_RSS_PARTITIONING_INTERFACE:
+        if (Buffer == NULL || BufferLength != sizeof(uint32_t)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+        Status = QuicLibrarySetRssPartitioningInterface(*(uint32_t*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_MEMORY_BUDGET:
+        if (Buffer == NULL || BufferLength != sizeof(uint64_t)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+        MsQuicLib.MemoryBudget = *(uint64_t*)Buffer;
+        QuicLibApplyMemoryBudget();
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_QLOG_CONFIG:
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_QLOG_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        Status = QuicQlogSetConfig((QUIC_QLOG_CONFIG*)Buffer);
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        break;
+
+    case QUIC_PARAM_GLOBAL_RECV_CAPTURE:
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_RECV_CAPTURE_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+        Status = QuicRecvCaptureSetConfig((QUIC_RECV_CAPTURE_CONFIG*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_POOL_RESERVE:
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_POOL_RESERVE_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // The pools are reserved when they are created.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+        } else {
+            MsQuicLib.PoolReserve = *(QUIC_POOL_RESERVE_CONFIG*)Buffer;
+            Status = QUIC_STATUS_SUCCESS;
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        break;
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -1438,6 +2208,67 @@ QuicLibrarySetGlobalParam(
     return Status;
 }
 
+//
+// Calls Callback for the worker pool of each registration, including the
+// stateless one. Must be called with the library lock held.
+//
+typedef
+void
+(QUIC_LIBRARY_WORKER_POOL_CALLBACK)(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Inout_ void* Context
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLibraryForEachWorkerPool(
+    _In_ QUIC_LIBRARY_WORKER_POOL_CALLBACK* Callback,
+    _Inout_ void* Context
+    )
+{
+    if (MsQuicLib.StatelessRegistration != NULL) {
+        Callback(MsQuicLib.StatelessRegistration->WorkerPool, Context);
+    }
+    for (CXPLAT_LIST_ENTRY* Link = MsQuicLib.Registrations.Flink;
+        Link != &MsQuicLib.Registrations;
+        Link = Link->Flink) {
+        Callback(
+            CXPLAT_CONTAINING_RECORD(Link, QUIC_REGISTRATION, Link)->WorkerPool,
+            Context);
+    }
+}
+
+static
+void
+QuicLibraryCountWorkers(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Inout_ void* Context
+    )
+{
+    *(uint32_t*)Context += WorkerPool->WorkerCount;
+}
+
+typedef struct QUIC_FLIGHT_RECORDS_CONTEXT {
+    QUIC_FLIGHT_RECORD* Records;
+    uint32_t Count;
+} QUIC_FLIGHT_RECORDS_CONTEXT;
+
+static
+void
+QuicLibraryCopyFlightRecords(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Inout_ void* Context
+    )
+{
+    QUIC_FLIGHT_RECORDS_CONTEXT* Copy = (QUIC_FLIGHT_RECORDS_CONTEXT*)Context;
+    for (uint16_t i = 0; i < WorkerPool->WorkerCount; ++i) {
+        Copy->Count +=
+            QuicWorkerGetFlightRecords(
+                &WorkerPool->Workers[i], Copy->Records + Copy->Count);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicLibraryGetGlobalParam(
@@ -1452,11 +2283,163 @@ QuicLibraryGetGlobalParam(
 
     CXPLAT_DBG_ASSERT(MsQuicLib.Loaded);
 
-    switch (Param) {
-    case QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT:
+    switch (Param) {
+    case QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT:
+
+        if (*BufferLength < sizeof(MsQuicLib.Settings.RetryMemoryLimit)) {
+            *BufferLength = sizeof(MsQuicLib.Settings.RetryMemoryLimit);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(MsQuicLib.Settings.RetryMemoryLimit);
+        *(uint16_t*)Buffer = MsQuicLib.Settings.RetryMemoryLimit;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_SUPPORTED_VERSIONS:
+
+        if (*BufferLength < sizeof(QuicSupportedVersionList)) {
+            *BufferLength = sizeof(QuicSupportedVersionList);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QuicSupportedVersionList);
+        CxPlatCopyMemory(
+            Buffer,
+            QuicSupportedVersionList,
+            sizeof(QuicSupportedVersionList));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE:
+
+        if (*BufferLength < sizeof(uint16_t)) {
+            *BufferLength = sizeof(uint16_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint16_t);
+        *(uint16_t*)Buffer = MsQuicLib.Settings.LoadBalancingMode;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_PERF_COUNTERS: {
+
+        if (*BufferLength < sizeof(int64_t)) {
+            *BufferLength = sizeof(int64_t) * QUIC_PERF_COUNTER_MAX;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (*BufferLength < QUIC_PERF_COUNTER_MAX * sizeof(int64_t)) {
+            //
+            // Copy as many counters will fit completely in the buffer.
+            //
+            *BufferLength = (*BufferLength / sizeof(int64_t)) * sizeof(int64_t);
+        } else {
+            *BufferLength = QUIC_PERF_COUNTER_MAX * sizeof(int64_t);
+        }
+
+        QuicLibrarySumPerfCounters(Buffer, *BufferLength);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SETTINGS:
+
+        Status = QuicSettingsGetSettings(&MsQuicLib.Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_VERSION_SETTINGS:
+
+        Status = QuicSettingsGetVersionSettings(&MsQuicLib.Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_GLOBAL_SETTINGS:
+
+        Status = QuicSettingsGetGlobalSettings(&MsQuicLib.Settings, BufferLength, (QUIC_GLOBAL_SETTINGS*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_LIBRARY_VERSION:
+
+        if (*BufferLength < sizeof(MsQuicLib.Version)) {
+            *BufferLength = sizeof(MsQuicLib.Version);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(MsQuicLib.Version);
+        CxPlatCopyMemory(Buffer, MsQuicLib.Version, sizeof(MsQuicLib.Version));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_LIBRARY_GIT_HASH:
+
+        GitHashLength = (uint32_t)strlen(MsQuicLib.GitHash) + 1;
+
+        if (*BufferLength < GitHashLength) {
+            *BufferLength = GitHashLength;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = GitHashLength;
+        CxPlatCopyMemory(Buffer, MsQuicLib.GitHash, GitHashLength);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_EXECUTION_CONFIG: {
+        if (MsQuicLib.ExecutionConfig == NULL) {
+            *BufferLength = 0;
+            Status = QUIC_STATUS_SUCCESS;
+            break;
+        }
+
+        const uint32_t ConfigLength =
+            QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE +
+            sizeof(uint16_t) * MsQuicLib.ExecutionConfig->ProcessorCount;
 
-        if (*BufferLength < sizeof(MsQuicLib.Settings.RetryMemoryLimit)) {
-            *BufferLength = sizeof(MsQuicLib.Settings.RetryMemoryLimit);
+        if (*BufferLength < ConfigLength) {
+            *BufferLength = ConfigLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1466,16 +2449,16 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(MsQuicLib.Settings.RetryMemoryLimit);
-        *(uint16_t*)Buffer = MsQuicLib.Settings.RetryMemoryLimit;
-
+        *BufferLength = ConfigLength;
+        CxPlatCopyMemory(Buffer, MsQuicLib.ExecutionConfig, ConfigLength);
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_SUPPORTED_VERSIONS:
+    case QUIC_PARAM_GLOBAL_TLS_PROVIDER:
 
-        if (*BufferLength < sizeof(QuicSupportedVersionList)) {
-            *BufferLength = sizeof(QuicSupportedVersionList);
+        if (*BufferLength < sizeof(QUIC_TLS_PROVIDER)) {
+            *BufferLength = sizeof(QUIC_TLS_PROVIDER);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1485,19 +2468,16 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(QuicSupportedVersionList);
-        CxPlatCopyMemory(
-            Buffer,
-            QuicSupportedVersionList,
-            sizeof(QuicSupportedVersionList));
+        *BufferLength = sizeof(QUIC_TLS_PROVIDER);
+        *(QUIC_TLS_PROVIDER*)Buffer = CxPlatTlsGetProvider();
 
         Status = QUIC_STATUS_SUCCESS;
         break;
 
-    case QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE:
+    case QUIC_PARAM_GLOBAL_RSS_PARTITIONING_INTERFACE:
 
-        if (*BufferLength < sizeof(uint16_t)) {
-            *BufferLength = sizeof(uint16_t);
+        if (*BufferLength < sizeof(uint32_t)) {
+            *BufferLength = sizeof(uint32_t);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1507,16 +2487,16 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(uint16_t);
-        *(uint16_t*)Buffer = MsQuicLib.Settings.LoadBalancingMode;
+        *BufferLength = sizeof(uint32_t);
+        *(uint32_t*)Buffer = MsQuicLib.RssPartitioning.InterfaceIndex;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
 
-    case QUIC_PARAM_GLOBAL_PERF_COUNTERS: {
+    case QUIC_PARAM_GLOBAL_MEMORY_BUDGET:
 
-        if (*BufferLength < sizeof(int64_t)) {
-            *BufferLength = sizeof(int64_t) * QUIC_PERF_COUNTER_MAX;
+        if (*BufferLength < sizeof(uint64_t)) {
+            *BufferLength = sizeof(uint64_t);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1526,89 +2506,131 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        if (*BufferLength < QUIC_PERF_COUNTER_MAX * sizeof(int64_t)) {
-            //
-            // Copy as many counters will fit completely in the buffer.
-            //
-            *BufferLength = (*BufferLength / sizeof(int64_t)) * sizeof(int64_t);
-        } else {
-            *BufferLength = QUIC_PERF_COUNTER_MAX * sizeof(int64_t);
-        }
-
-        QuicLibrarySumPerfCounters(Buffer, *BufferLength);
+        *BufferLength = sizeof(uint64_t);
+        *(uint64_t*)Buffer =
+            MsQuicLib.MemoryBudget != 0 ?
+                MsQuicLib.MemoryBudget :
+                CxPlatTotalMemory / QUIC_DEFAULT_MEMORY_BUDGET_DIVISOR;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
-    }
 
-    case QUIC_PARAM_GLOBAL_SETTINGS:
-
-        Status = QuicSettingsGetSettings(&MsQuicLib.Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
-        break;
+    case QUIC_PARAM_GLOBAL_POOL_RESERVE:
 
-    case QUIC_PARAM_GLOBAL_VERSION_SETTINGS:
+        if (*BufferLength < sizeof(QUIC_POOL_RESERVE_CONFIG)) {
+            *BufferLength = sizeof(QUIC_POOL_RESERVE_CONFIG);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
 
-        Status = QuicSettingsGetVersionSettings(&MsQuicLib.Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
-        break;
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
 
-    case QUIC_PARAM_GLOBAL_GLOBAL_SETTINGS:
+        *BufferLength = sizeof(QUIC_POOL_RESERVE_CONFIG);
+        *(QUIC_POOL_RESERVE_CONFIG*)Buffer = MsQuicLib.PoolReserve;
 
-        Status = QuicSettingsGetGlobalSettings(&MsQuicLib.Settings, BufferLength, (QUIC_GLOBAL_SETTINGS*)Buffer);
+        Status = QUIC_STATUS_SUCCESS;
         break;
 
-    case QUIC_PARAM_GLOBAL_LIBRARY_VERSION:
+    case QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS: {
 
-        if (*BufferLength < sizeof(MsQuicLib.Version)) {
-            *BufferLength = sizeof(MsQuicLib.Version);
+        //
+        // Rows are copied as they are. A gauge like the connection count can
+        // go negative on one partition when its objects are released on
+        // another; only the sum over all partitions is meaningful for those.
+        //
+        const uint32_t PartitionCount =
+            MsQuicLib.Partitions != NULL ? MsQuicLib.PartitionCount : 0;
+        const uint32_t RowLength = sizeof(int64_t) * QUIC_PERF_COUNTER_MAX;
+        if (*BufferLength < PartitionCount * RowLength) {
+            *BufferLength = PartitionCount * RowLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
 
-        if (Buffer == NULL) {
+        if (Buffer == NULL && PartitionCount != 0) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
-        *BufferLength = sizeof(MsQuicLib.Version);
-        CxPlatCopyMemory(Buffer, MsQuicLib.Version, sizeof(MsQuicLib.Version));
+        for (uint32_t i = 0; i < PartitionCount; ++i) {
+            CxPlatCopyMemory(
+                (uint8_t*)Buffer + i * RowLength,
+                MsQuicLib.Partitions[i].PerfCounters,
+                RowLength);
+        }
 
+        *BufferLength = PartitionCount * RowLength;
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_LIBRARY_GIT_HASH:
+    case QUIC_PARAM_GLOBAL_FLIGHT_RECORDER: {
 
-        GitHashLength = (uint32_t)strlen(MsQuicLib.GitHash) + 1;
+        CxPlatLockAcquire(&MsQuicLib.Lock);
 
-        if (*BufferLength < GitHashLength) {
-            *BufferLength = GitHashLength;
+        //
+        // Room for full recorders is required, since workers keep adding
+        // records meanwhile.
+        //
+        uint32_t WorkerCount = 0;
+        QuicLibraryForEachWorkerPool(QuicLibraryCountWorkers, &WorkerCount);
+        const uint32_t MaxLength =
+            WorkerCount * QUIC_WORKER_FLIGHT_RECORDER_SIZE * sizeof(QUIC_FLIGHT_RECORD);
+        if (*BufferLength < MaxLength) {
+            CxPlatLockRelease(&MsQuicLib.Lock);
+            *BufferLength = MaxLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
 
-        if (Buffer == NULL) {
+        if (Buffer == NULL && WorkerCount != 0) {
+            CxPlatLockRelease(&MsQuicLib.Lock);
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
-        *BufferLength = GitHashLength;
-        CxPlatCopyMemory(Buffer, MsQuicLib.GitHash, GitHashLength);
+        QUIC_FLIGHT_RECORDS_CONTEXT Copy = { (QUIC_FLIGHT_RECORD*)Buffer, 0 };
+        QuicLibraryForEachWorkerPool(QuicLibraryCopyFlightRecords, &Copy);
+
+        CxPlatLockRelease(&MsQuicLib.Lock);
 
+        *BufferLength = Copy.Count * sizeof(QUIC_FLIGHT_RECORD);
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_EXECUTION_CONFIG: {
-        if (MsQuicLib.ExecutionConfig == NULL) {
-            *BufferLength = 0;
-            Status = QUIC_STATUS_SUCCESS;
+    case QUIC_PARAM_GLOBAL_PARTITION_LATENCY: {
+
+        const uint32_t PartitionCount =
+            MsQuicLib.Partitions != NULL ? MsQuicLib.PartitionCount : 0;
+        if (*BufferLength < PartitionCount * sizeof(QUIC_LATENCY_HISTOGRAMS)) {
+            *BufferLength = PartitionCount * sizeof(QUIC_LATENCY_HISTOGRAMS);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
 
-        const uint32_t ConfigLength =
-            QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE +
-            sizeof(uint16_t) * MsQuicLib.ExecutionConfig->ProcessorCount;
+        if (Buffer == NULL && PartitionCount != 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
 
-        if (*BufferLength < ConfigLength) {
-            *BufferLength = ConfigLength;
+        QUIC_LATENCY_HISTOGRAMS* Latency = (QUIC_LATENCY_HISTOGRAMS*)Buffer;
+        for (uint32_t i = 0; i < PartitionCount; ++i) {
+            Latency[i] = MsQuicLib.Partitions[i].Latency;
+        }
+
+        *BufferLength = PartitionCount * sizeof(QUIC_LATENCY_HISTOGRAMS);
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS: {
+
+        if (*BufferLength < sizeof(QUIC_LATENCY_HISTOGRAMS)) {
+            *BufferLength = sizeof(QUIC_LATENCY_HISTOGRAMS);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1618,16 +2640,33 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = ConfigLength;
-        CxPlatCopyMemory(Buffer, MsQuicLib.ExecutionConfig, ConfigLength);
+        //
+        // Merge and reset the partitions' histograms, one bucket at a time, so
+        // that samples recorded meanwhile land in either this snapshot or the
+        // next, never neither.
+        //
+        const uint32_t BucketCount =
+            sizeof(QUIC_LATENCY_HISTOGRAMS) / sizeof(uint64_t);
+        uint64_t* Merged = (uint64_t*)Buffer;
+        CxPlatZeroMemory(Merged, sizeof(QUIC_LATENCY_HISTOGRAMS));
+        if (MsQuicLib.Partitions != NULL) {
+            for (uint32_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+                int64_t* Buckets = (int64_t*)&MsQuicLib.Partitions[i].Latency;
+                for (uint32_t j = 0; j < BucketCount; ++j) {
+                    Merged[j] += (uint64_t)InterlockedExchange64(&Buckets[j], 0);
+                }
+            }
+        }
+
+        *BufferLength = sizeof(QUIC_LATENCY_HISTOGRAMS);
         Status = QUIC_STATUS_SUCCESS;
         break;
     }
 
-    case QUIC_PARAM_GLOBAL_TLS_PROVIDER:
+    case QUIC_PARAM_GLOBAL_MEMORY_USAGE: {
 
-        if (*BufferLength < sizeof(QUIC_TLS_PROVIDER)) {
-            *BufferLength = sizeof(QUIC_TLS_PROVIDER);
+        if (*BufferLength < sizeof(QUIC_MEMORY_USAGE)) {
+            *BufferLength = sizeof(QUIC_MEMORY_USAGE);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1637,11 +2676,26 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(QUIC_TLS_PROVIDER);
-        *(QUIC_TLS_PROVIDER*)Buffer = CxPlatTlsGetProvider();
+        //
+        // The fields of QUIC_MEMORY_USAGE are in QUIC_MEMORY_TYPE order.
+        //
+        int64_t Usage[QUIC_MEMORY_TYPE_COUNT] = {0};
+        if (MsQuicLib.Partitions != NULL) {
+            for (uint32_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+                for (uint32_t Type = 0; Type < QUIC_MEMORY_TYPE_COUNT; ++Type) {
+                    Usage[Type] += MsQuicLib.Partitions[i].MemoryUsage[Type];
+                }
+            }
+        }
+        uint64_t* Output = (uint64_t*)Buffer;
+        for (uint32_t Type = 0; Type < QUIC_MEMORY_TYPE_COUNT; ++Type) {
+            Output[Type] = Usage[Type] > 0 ? (uint64_t)Usage[Type] : 0;
+        }
 
+        *BufferLength = sizeof(QUIC_MEMORY_USAGE);
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
     case QUIC_PARAM_GLOBAL_DATAPATH_FEATURES: {
         if (*BufferLength < sizeof(uint32_t)) {
@@ -1728,7 +2782,10 @@ QuicLibraryGetGlobalParam(
             QUIC_STATISTICS_V2_SIZE_1,
             QUIC_STATISTICS_V2_SIZE_2,
             QUIC_STATISTICS_V2_SIZE_3,
-            QUIC_STATISTICS_V2_SIZE_4
+            QUIC_STATISTICS_V2_SIZE_4,
+            QUIC_STATISTICS_V2_SIZE_5,
+            QUIC_STATISTICS_V2_SIZE_6,
+            QUIC_STATISTICS_V2_SIZE_7
         };
         static const uint32_t NumStatSizes = ARRAYSIZE(StatSizes);
         uint32_t MaxSizes = *BufferLength / sizeof(uint32_t);
@@ -1902,6 +2959,8 @@ QuicLibrarySetParam(
     case QUIC_PARAM_PREFIX_TLS_SCHANNEL:
         if (Connection == NULL || Connection->Crypto.TLS == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
+        } else if (Connection->Crypto.HandshakeOffloadPending) {
+            Status = QUIC_STATUS_INVALID_STATE;
         } else {
             Status = CxPlatTlsParamSet(Connection->Crypto.TLS, Param, BufferLength, Buffer);
         }
@@ -2036,7 +3095,8 @@ QuicLibraryGetParam(
     case QUIC_PARAM_PREFIX_TLS_SCHANNEL:
         if (Connection == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
-        } else if (Connection->Crypto.TLS == NULL) {
+        } else if (Connection->Crypto.TLS == NULL ||
+                   Connection->Crypto.HandshakeOffloadPending) {
             Status = QUIC_STATUS_INVALID_STATE;
         } else {
             Status = CxPlatTlsParamGet(Connection->Crypto.TLS, Param, BufferLength, Buffer);
@@ -2152,12 +3212,19 @@ MsQuicOpenVersion(
     Api->ExecutionCreate = MsQuicExecutionCreate;
     Api->ExecutionDelete = MsQuicExecutionDelete;
     Api->ExecutionPoll = MsQuicExecutionPoll;
+    Api->ExecutionPollBatch = MsQuicExecutionPollBatch;
 #endif
 
     Api->RegistrationClose2 = MsQuicRegistrationClose2;
 
     Api->ConnectionPoolCreate = MsQuicConnectionPoolCreate;
 
+    Api->ConnectionSendBatch = MsQuicConnectionSendBatch;
+    Api->StreamOpenBatch = MsQuicStreamOpenBatch;
+#ifndef _KERNEL_MODE
+    Api->StreamSendFile = MsQuicStreamSendFile;
+#endif
+
     *QuicApi = Api;
 
 Exit:
@@ -2205,12 +3272,19 @@ QuicLibraryLookupBinding(
     _In_opt_ const QUIC_ADDR* RemoteAddress
     )
 {
-    for (CXPLAT_LIST_ENTRY* Link = MsQuicLib.Bindings.Flink;
-        Link != &MsQuicLib.Bindings;
-        Link = Link->Flink) {
+    //
+    // Every binding that can match has the same local port: connected bindings
+    // match on the whole local address and server bindings on the port alone.
+    //
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    for (CXPLAT_HASHTABLE_ENTRY* TableEntry =
+            CxPlatHashtableLookup(
+                &MsQuicLib.BindingTable, QuicAddrGetPort(LocalAddress), &Context);
+        TableEntry != NULL;
+        TableEntry = CxPlatHashtableLookupNext(&MsQuicLib.BindingTable, &Context)) {
 
         QUIC_BINDING* Binding =
-            CXPLAT_CONTAINING_RECORD(Link, QUIC_BINDING, Link);
+            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_BINDING, TableEntry);
 
 #ifdef QUIC_COMPARTMENT_ID
         if (CompartmentId != Binding->CompartmentId) {
@@ -2427,6 +3501,11 @@ NewBinding:
         }
         (*NewBinding)->RefCount++;
         CxPlatListInsertTail(&MsQuicLib.Bindings, &(*NewBinding)->Link);
+        CxPlatHashtableInsert(
+            &MsQuicLib.BindingTable,
+            &(*NewBinding)->TableEntry,
+            QuicAddrGetPort(&NewLocalAddress),
+            NULL);
     }
 
     CxPlatDispatchLockRelease(&MsQuicLib.DatapathLock);
@@ -2520,6 +3599,7 @@ QuicLibraryReleaseBinding(
     CXPLAT_DBG_ASSERT(Binding->RefCount > 0);
     if (--Binding->RefCount == 0) {
         CxPlatListEntryRemove(&Binding->Link);
+        CxPlatHashtableRemove(&MsQuicLib.BindingTable, &Binding->TableEntry, NULL);
         Uninitialize = TRUE;
 
         if (CxPlatListIsEmpty(&MsQuicLib.Bindings)) {
@@ -2587,7 +3667,60 @@ QuicLibraryGetWorker(
     CXPLAT_DBG_ASSERT(MsQuicLib.StatelessRegistration != NULL);
     return
         &MsQuicLib.StatelessRegistration->WorkerPool->Workers[
-            Packet->PartitionIndex % MsQuicLib.StatelessRegistration->WorkerPool->WorkerCount];
+            QuicLibraryGetPacketPartitionIndex(Packet) %
+                MsQuicLib.StatelessRegistration->WorkerPool->WorkerCount];
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint16_t
+QUIC_NO_SANITIZE("implicit-conversion")
+QuicLibraryGetPacketPartitionIndex(
+    _In_ const QUIC_RX_PACKET* Packet
+    )
+{
+    uint16_t PartitionIndex = Packet->PartitionIndex % MsQuicLib.PartitionCount;
+
+    if (MsQuicLib.RssPartitioning.Config != NULL) {
+        //
+        // Use the partition of the processor the NIC's RSS steers the client
+        // 4-tuple to, so the connection is processed where its packets arrive,
+        // regardless of which socket or queue delivered this one.
+        //
+        CxPlatDispatchRwLockAcquireShared(&MsQuicLib.RssPartitioning.Lock, PrevIrql);
+        const CXPLAT_RSS_CONFIG* RssConfig = MsQuicLib.RssPartitioning.Config;
+        if (RssConfig != NULL &&
+            QuicAddrGetFamily(&Packet->Route->RemoteAddress) ==
+                QuicAddrGetFamily(&Packet->Route->LocalAddress)) {
+            uint32_t RssHash = 0, Offset;
+            CxPlatToeplitzHashComputeRss(
+                &MsQuicLib.RssPartitioning.ToeplitzHash,
+                &Packet->Route->RemoteAddress,
+                &Packet->Route->LocalAddress,
+                &RssHash,
+                &Offset);
+            const uint32_t Processor =
+                RssConfig->RssIndirectionTable[
+                    RssHash & (RssConfig->RssIndirectionTableCount - 1)];
+            PartitionIndex = QuicLibraryGetPartitionFromProcessorIndex(Processor)->Index;
+        }
+        CxPlatDispatchRwLockReleaseShared(&MsQuicLib.RssPartitioning.Lock, PrevIrql);
+
+    } else if (MsQuicLib.EnableSoftwareRss && Packet->DestCidLen != 0) {
+        //
+        // The datapath may receive on fewer partitions than there are (such as
+        // XDP on a NIC with few queues), so spread the connections over all of
+        // them by the client chosen CID. Their later packets are still received
+        // on the queue's partition and handed across to the connection's.
+        //
+        PartitionIndex =
+            CxPlatToeplitzHashCompute(
+                &MsQuicLib.ToeplitzHash,
+                Packet->DestCid,
+                CXPLAT_MIN(Packet->DestCidLen, QUIC_MAX_CONNECTION_ID_LENGTH_V1),
+                0) % MsQuicLib.PartitionCount;
+    }
+
+    return PartitionIndex;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -2684,6 +3817,83 @@ QuicLibraryOnHandshakeConnectionRemoved(
     QuicLibraryEvaluateSendRetryState();
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryTryReserveRecvWindow(
+    _In_ uint32_t Increase
+    )
+{
+    if (QuicLibraryGetMemoryPressure() != QUIC_MEMORY_PRESSURE_NONE) {
+        return FALSE;
+    }
+
+    uint64_t NewUsage =
+        (uint64_t)InterlockedExchangeAdd64(
+            (int64_t*)&MsQuicLib.CurrentRecvWindowMemoryUsage,
+            (int64_t)Increase) + Increase;
+    if (NewUsage > MsQuicLib.RecvWindowMemoryLimit) {
+        InterlockedExchangeAdd64(
+            (int64_t*)&MsQuicLib.CurrentRecvWindowMemoryUsage,
+            -1 * (int64_t)Increase);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryReleaseRecvWindow(
+    _In_ uint64_t Amount
+    )
+{
+    InterlockedExchangeAdd64(
+        (int64_t*)&MsQuicLib.CurrentRecvWindowMemoryUsage,
+        -1 * (int64_t)Amount);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SHARED_SETTINGS*
+QuicLibraryGetSharedSettings(
+    void
+    )
+{
+    CxPlatDispatchLockAcquire(&MsQuicLib.SharedSettingsLock);
+    if (MsQuicLib.SharedSettings == NULL) {
+        MsQuicLib.SharedSettings = QuicSharedSettingsAlloc(&MsQuicLib.Settings);
+        if (MsQuicLib.SharedSettings != NULL) {
+            //
+            // Just grab the global values, not IsSet flags.
+            //
+            MsQuicLib.SharedSettings->Settings.IsSetFlags = 0;
+        }
+    }
+    QUIC_SHARED_SETTINGS* SharedSettings = MsQuicLib.SharedSettings;
+    if (SharedSettings != NULL) {
+        QuicSharedSettingsAddRef(SharedSettings);
+    }
+    CxPlatDispatchLockRelease(&MsQuicLib.SharedSettingsLock);
+    return SharedSettings;
+}
+
+//
+// Drops the snapshot of the global settings after they change. Connections
+// already using it keep their reference.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryResetSharedSettings(
+    void
+    )
+{
+    CxPlatDispatchLockAcquire(&MsQuicLib.SharedSettingsLock);
+    QUIC_SHARED_SETTINGS* SharedSettings = MsQuicLib.SharedSettings;
+    MsQuicLib.SharedSettings = NULL;
+    CxPlatDispatchLockRelease(&MsQuicLib.SharedSettingsLock);
+    if (SharedSettings != NULL) {
+        QuicSharedSettingsRelease(SharedSettings);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLibraryEvaluateSendRetryState(
@@ -2730,15 +3940,16 @@ QuicLibraryGenerateStatelessResetToken(
     )
 {
     uint8_t HashOutput[CXPLAT_HASH_SHA256_SIZE];
-    CxPlatLockAcquire(&Partition->ResetTokenLock);
+    uint32_t Index;
+    CXPLAT_HASH* Hash = QuicPartitionTakeResetTokenHash(Partition, &Index);
     QUIC_STATUS Status =
         CxPlatHashCompute(
-            Partition->ResetTokenHash,
+            Hash,
             CID,
             MsQuicLib.CidTotalLength,
             sizeof(HashOutput),
             HashOutput);
-    CxPlatLockRelease(&Partition->ResetTokenLock);
+    QuicPartitionReturnResetTokenHash(Partition, Index, Hash);
     if (QUIC_SUCCEEDED(Status)) {
         CxPlatCopyMemory(
             ResetToken,
@@ -2849,6 +4060,32 @@ MsQuicExecutionPoll(
     return Result;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+QUIC_API
+MsQuicExecutionPollBatch(
+    _In_ uint32_t Count,
+    _In_reads_(Count) QUIC_EXECUTION** Executions,
+    _In_ uint32_t TimeBudgetUs,
+    _In_ uint32_t RunBudget
+    )
+{
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_EXECUTION_POLL_BATCH,
+        NULL);
+
+    uint32_t Result =
+        CxPlatWorkerPoolWorkerPollBatch(Count, Executions, TimeBudgetUs, RunBudget);
+
+    QuicTraceEvent(
+        ApiExit,
+        "[ api] Exit");
+
+    return Result;
+}
+
 #endif
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -2905,6 +4142,91 @@ QuicLibrarySetRetryKeyConfig(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicLibrarySetQuicLbConfig(
+    _In_ const QUIC_LB_CONFIG* Config
+    )
+{
+    if (!QuicLbConfigIsValid(Config)) {
+        QuicTraceLogError(
+            LibrarySetQuicLbConfigInvalid,
+            "[ lib] Invalid QUIC-LB config: ID %hhu, server ID length %hhu, nonce length %hhu.",
+            Config->ConfigId,
+            Config->ServerIdLength,
+            Config->NonceLength);
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    CXPLAT_HP_KEY* NewKey = NULL;
+    if (Config->Encrypted) {
+        QUIC_STATUS Status =
+            CxPlatHpKeyCreate(CXPLAT_AEAD_AES_128_GCM, Config->Key, &NewKey);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    CXPLAT_HP_KEY* OldKey;
+    BOOLEAN ApplyLength = FALSE;
+    CxPlatLockAcquire(&MsQuicLib.Lock);
+    if (MsQuicLib.Settings.LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB &&
+        QUIC_LB_ENCODED_LENGTH(Config) != MsQuicLib.CidServerIdLength) {
+        if (MsQuicLib.InUse) {
+            //
+            // Keys may be rotated at any time, but the CID length is fixed
+            // once the library is in use.
+            //
+            CxPlatLockRelease(&MsQuicLib.Lock);
+            CxPlatHpKeyFree(NewKey);
+            QuicTraceLogError(
+                LibraryQuicLbLengthSetAfterInUse,
+                "[ lib] Tried to change QUIC-LB encoded length after library in use!");
+            return QUIC_STATUS_INVALID_STATE;
+        }
+        ApplyLength = TRUE;
+    }
+
+    CxPlatDispatchRwLockAcquireExclusive(&MsQuicLib.QuicLb.Lock, PrevIrql);
+    OldKey = MsQuicLib.QuicLb.Key;
+    MsQuicLib.QuicLb.Key = NewKey;
+    CxPlatCopyMemory(&MsQuicLib.QuicLb.Config, Config, sizeof(*Config));
+    CxPlatDispatchRwLockReleaseExclusive(&MsQuicLib.QuicLb.Lock, PrevIrql);
+
+    if (ApplyLength) {
+        QuicLibApplyLoadBalancingSetting();
+    }
+    CxPlatLockRelease(&MsQuicLib.Lock);
+
+    CxPlatHpKeyFree(OldKey);
+    QuicTraceLogInfo(
+        LibraryQuicLbConfigUpdated,
+        "[ lib] QUIC-LB config updated. ID: %hhu, Encrypted: %hhu",
+        Config->ConfigId,
+        Config->Encrypted);
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLibraryEncodeQuicLbServerId(
+    _Out_writes_(MsQuicLib.CidServerIdLength)
+        uint8_t* Data
+    )
+{
+    CxPlatDispatchRwLockAcquireShared(&MsQuicLib.QuicLb.Lock, PrevIrql);
+    CXPLAT_DBG_ASSERT(
+        QUIC_LB_ENCODED_LENGTH(&MsQuicLib.QuicLb.Config) == MsQuicLib.CidServerIdLength);
+    QUIC_STATUS Status =
+        QuicLbEncodeServerId(
+            &MsQuicLib.QuicLb.Config,
+            MsQuicLib.QuicLb.Key,
+            MsQuicLib.CidTotalLength,
+            Data);
+    CxPlatDispatchRwLockReleaseShared(&MsQuicLib.QuicLb.Lock, PrevIrql);
+    return Status;
+}
+
 #if DEBUG
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -91,6 +91,53 @@ typedef struct QUIC_LIBRARY {
     //
     BOOLEAN EnableDscpOnRecv : 1;
 
+    //
+    // Whether the datapath will be initialized with zero-copy send support.
+    //
+    BOOLEAN EnableZeroCopySend : 1;
+
+    //
+    // Whether the datapath will be initialized with departure time (SO_TXTIME)
+    // send support.
+    //
+    BOOLEAN EnableTxTimePacing : 1;
+
+    //
+    // Whether the datapath will be initialized with huge page backed buffer
+    // pools.
+    //
+    BOOLEAN EnableHugePages : 1;
+
+    //
+    // Whether the datapath delivers datagrams in memory to sockets in this
+    // process, over the path modeled by LoopbackConfig.
+    //
+    BOOLEAN EnableLoopback : 1;
+
+    //
+    // Whether the app overrode the XDP poll moderation thresholds with
+    // XdpPollModeration.
+    //
+    BOOLEAN CustomXdpPollModeration : 1;
+
+    //
+    // Whether connections pace by stamping send batches with a departure time
+    // instead of arming the pacing timer. Set once the datapath is created.
+    //
+    BOOLEAN TxTimePacing : 1;
+
+    //
+    // Whether listener bindings steer received packets by the partition ID in
+    // the destination CID.
+    //
+    BOOLEAN EnableCidSteering : 1;
+
+    //
+    // Whether new connections are spread over all partitions by a hash of the
+    // client's destination CID, instead of staying on the receiving partition.
+    //
+    BOOLEAN EnableSoftwareRss : 1;
+
 #ifdef CxPlatVerifierEnabled
     //
     // The app or driver verifier is globally enabled.
@@ -110,6 +157,22 @@ typedef struct QUIC_LIBRARY {
     //
     BOOLEAN SendRetryEnabled;
 
+    //
+    // The path modeled by the in-process loopback datapath, if enabled.
+    //
+    CXPLAT_LOOPBACK_CONFIG LoopbackConfig;
+
+    //
+    // The XDP poll moderation thresholds, if set by the app.
+    //
+    CXPLAT_XDP_POLL_MODERATION_CONFIG XdpPollModeration;
+
+    //
+    // Time XDP partitions have spent in each poll mode, reported through the
+    // QUIC_PERF_COUNTER_XDP_*_TIME counters.
+    //
+    CXPLAT_XDP_POLL_STATISTICS XdpPollStatistics;
+
     //
     // Current binary version.
     //
@@ -125,6 +188,13 @@ typedef struct QUIC_LIBRARY {
     //
     QUIC_SETTINGS_INTERNAL Settings;
 
+    //
+    // A snapshot of Settings (without IsSet flags) shared by new connections,
+    // created on first use after any change.
+    //
+    QUIC_SHARED_SETTINGS* SharedSettings;
+    CXPLAT_DISPATCH_LOCK SharedSettingsLock;
+
     //
     // Controls access to all non-datapath internal state of the library.
     //
@@ -193,6 +263,35 @@ typedef struct QUIC_LIBRARY {
     //
     uint64_t CurrentHandshakeMemoryUsage;
 
+    //
+    // The maximum total memory that connections may add to their flow control
+    // windows by receive window autotuning.
+    //
+    uint64_t RecvWindowMemoryLimit;
+
+    //
+    // The current total flow control window growth of all connections.
+    //
+    uint64_t CurrentRecvWindowMemoryUsage;
+
+    //
+    // The memory budget for buffered stream data and connection state, as
+    // configured by the app. Zero means the default, derived from the total
+    // system memory.
+    //
+    uint64_t MemoryBudget;
+
+    //
+    // The usage thresholds derived from the effective memory budget.
+    //
+    uint64_t MemoryPressureHighThreshold;
+    uint64_t MemoryPressureCriticalThreshold;
+
+    //
+    // The current memory usage counted against the budget.
+    //
+    uint64_t CurrentMemoryUsage;
+
     //
     // Handle to global persistent storage (registry).
     //
@@ -218,6 +317,12 @@ typedef struct QUIC_LIBRARY {
     //
     CXPLAT_LIST_ENTRY Bindings;
 
+    //
+    // Index of Bindings, keyed by local port, so that finding a binding
+    // doesn't scale with the number of (unshared, client) bindings.
+    //
+    CXPLAT_HASHTABLE BindingTable;
+
     //
     // Contains all (server) connections currently not in an app's registration.
     //
@@ -252,6 +357,74 @@ typedef struct QUIC_LIBRARY {
     //
     CXPLAT_RUNDOWN_REF RegistrationCloseCleanupRundown;
 
+    //
+    // Number of handshake threads to create when the library is first used.
+    //
+    uint16_t HandshakeThreadCount;
+
+    //
+    // Number of entries in each partition's server ticket cache.
+    //
+    uint32_t TicketCacheSize;
+
+    //
+    // Entries reserved in each partition's pools when they are created.
+    //
+    QUIC_POOL_RESERVE_CONFIG PoolReserve;
+
+    //
+    // Percentage added on top of the delivery rate based bandwidth-delay
+    // estimate for the ideal send buffer size. Zero disables the estimate.
+    //
+    uint16_t IdealSendBufferHeadroom;
+
+    //
+    // Number of slots in each connection's sent packet ring. Zero disables
+    // the ring.
+    //
+    uint32_t SentPacketRingSize;
+
+    //
+    // Number of handshake threads currently running. Zero means TLS processing
+    // is never offloaded.
+    //
+    uint16_t HandshakeThreadsStarted;
+
+    //
+    // Set to true to shut down the handshake threads.
+    //
+    BOOLEAN HandshakeShutdown;
+
+    //
+    // Protects the handshake job queue.
+    //
+    CXPLAT_LOCK HandshakeLock;
+
+    //
+    // Event set when a handshake thread needs to wake.
+    //
+    CXPLAT_EVENT HandshakeEvent;
+
+    //
+    // Queue of offloaded TLS process calls waiting for a handshake thread.
+    //
+    CXPLAT_LIST_ENTRY HandshakeQueue;
+
+    //
+    // The handshake threads. Count of `HandshakeThreadsStarted`.
+    //
+    CXPLAT_THREAD* HandshakeThreads;
+
+    //
+    // qlog capture configuration and writer thread.
+    //
+    QUIC_QLOG Qlog;
+
+    //
+    // Capture of received datagrams, for replay.
+    //
+    QUIC_RECV_CAPTURE RecvCapture;
+
     //
     // Per-partition storage. Count of `PartitionCount`.
     //
@@ -286,6 +459,49 @@ typedef struct QUIC_LIBRARY {
 
     } StatelessRetry;
 
+    struct {
+        //
+        // Lock protecting the QUIC-LB configuration.
+        //
+        CXPLAT_DISPATCH_RW_LOCK Lock;
+
+        //
+        // The configuration used to encode server IDs when the load balancing
+        // mode is QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB. Zero until set.
+        //
+        QUIC_LB_CONFIG Config;
+
+        //
+        // The AES-128-ECB key for encrypted configurations. NULL otherwise.
+        //
+        CXPLAT_HP_KEY* Key;
+
+    } QuicLb;
+
+    struct {
+        //
+        // Lock protecting the RSS partitioning state.
+        //
+        CXPLAT_DISPATCH_RW_LOCK Lock;
+
+        //
+        // The interface whose RSS configuration new server connections are
+        // aligned to. Zero if disabled.
+        //
+        uint32_t InterfaceIndex;
+
+        //
+        // The interface's RSS configuration. NULL if disabled.
+        //
+        CXPLAT_RSS_CONFIG* Config;
+
+        //
+        // The Toeplitz hash, keyed with the interface's RSS secret key.
+        //
+        CXPLAT_TOEPLITZ_HASH ToeplitzHash;
+
+    } RssPartitioning;
+
     //
     // The Toeplitz hash used for hashing received long header packets.
     //
@@ -449,6 +665,17 @@ QuicPerfCounterTrySnapShot(
     QuicPerfCounterSnapShot(TimeDiff);
 }
 
+//
+// Writes the QUIC-LB encoded server ID, with a fresh nonce, to the start of a
+// new CID.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLibraryEncodeQuicLbServerId(
+    _Out_writes_(MsQuicLib.CidServerIdLength)
+        uint8_t* Data
+    );
+
 //
 // Creates a random, new source connection ID, that will be used on the receive
 // path.
@@ -483,7 +710,14 @@ QuicCidNewRandomSource(
         Entry->CID.Length = MsQuicLib.CidTotalLength;
 
         uint8_t* Data = Entry->CID.Data;
-        if (ServerID != NULL) {
+        if (ServerID != NULL &&
+            MsQuicLib.Settings.LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB &&
+            MsQuicLib.CidServerIdLength != 0) {
+            if (QUIC_FAILED(QuicLibraryEncodeQuicLbServerId(Data))) {
+                CXPLAT_FREE(Entry, QUIC_POOL_CIDHASH);
+                return NULL;
+            }
+        } else if (ServerID != NULL) {
             CxPlatCopyMemory(Data, ServerID, MsQuicLib.CidServerIdLength);
         } else {
             CxPlatRandom(MsQuicLib.CidServerIdLength, Data);
@@ -520,6 +754,15 @@ MsQuicLibraryLazyUninitialize(
     void
     );
 
+//
+// Returns a reference to the settings new connections start with.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SHARED_SETTINGS*
+QuicLibraryGetSharedSettings(
+    void
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicLibrarySetGlobalParam(
@@ -608,6 +851,17 @@ QuicLibraryGetWorker(
     _In_ const QUIC_RX_PACKET* Packet
     );
 
+//
+// Returns the partition a packet should be processed on: the one of the
+// processor that received it, or with RSS partitioning enabled, the one of the
+// processor RSS steers its 4-tuple to.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint16_t
+QuicLibraryGetPacketPartitionIndex(
+    _In_ const QUIC_RX_PACKET* Packet
+    );
+
 //
 // Called when a new (server) connection is added in the handshake state.
 //
@@ -626,6 +880,91 @@ QuicLibraryOnHandshakeConnectionRemoved(
     void
     );
 
+//
+// Tries to charge a connection flow control window increase against the
+// global autotuning memory budget. Returns FALSE if the budget is exhausted,
+// or if memory is under pressure.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryTryReserveRecvWindow(
+    _In_ uint32_t Increase
+    );
+
+//
+// Returns flow control window growth previously charged with
+// QuicLibraryTryReserveRecvWindow.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryReleaseRecvWindow(
+    _In_ uint64_t Amount
+    );
+
+typedef enum QUIC_MEMORY_PRESSURE {
+    QUIC_MEMORY_PRESSURE_NONE,
+    QUIC_MEMORY_PRESSURE_HIGH,     // Windows stop growing and shrink by half.
+    QUIC_MEMORY_PRESSURE_CRITICAL  // Windows shrink to a quarter; no new stream credit.
+} QUIC_MEMORY_PRESSURE;
+
+//
+// Tracks allocated (positive) or freed (negative) memory by type, on the
+// current processor's partition so that processors don't share the counters.
+//
+QUIC_INLINE
+void
+QuicLibraryTrackMemory(
+    _In_ QUIC_MEMORY_TYPE Type,
+    _In_ int64_t Delta
+    )
+{
+    if (MsQuicLib.Partitions != NULL) {
+        InterlockedExchangeAdd64(
+            &QuicLibraryGetCurrentPartition()->MemoryUsage[Type], Delta);
+    }
+}
+
+//
+// Charges (positive) or credits (negative) memory against the global budget,
+// and tracks it by type.
+//
+QUIC_INLINE
+void
+QuicLibraryChargeMemory(
+    _In_ QUIC_MEMORY_TYPE Type,
+    _In_ int64_t Delta
+    )
+{
+    InterlockedExchangeAdd64((int64_t*)&MsQuicLib.CurrentMemoryUsage, Delta);
+    QuicLibraryTrackMemory(Type, Delta);
+}
+
+QUIC_INLINE
+QUIC_MEMORY_PRESSURE
+QuicLibraryGetMemoryPressure(
+    void
+    )
+{
+    const uint64_t Usage = MsQuicLib.CurrentMemoryUsage;
+    if (Usage >= MsQuicLib.MemoryPressureCriticalThreshold) {
+        return QUIC_MEMORY_PRESSURE_CRITICAL;
+    }
+    if (Usage >= MsQuicLib.MemoryPressureHighThreshold) {
+        return QUIC_MEMORY_PRESSURE_HIGH;
+    }
+    return QUIC_MEMORY_PRESSURE_NONE;
+}
+
+//
+// Queues an offloaded TLS process call to the handshake threads. Only valid
+// while `HandshakeThreadsStarted` is non-zero.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryQueueHandshakeOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    );
+
 //
 // Generates a stateless reset token for the given connection ID.
 //
@@ -645,6 +984,12 @@ QuicLibrarySetRetryKeyConfig(
     _In_ const QUIC_STATELESS_RETRY_CONFIG* Config
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicLibrarySetQuicLbConfig(
+    _In_ const QUIC_LB_CONFIG* Config
+    );
+
 #if DEBUG
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -137,6 +137,24 @@ Error:
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicListenerFreeSniConfigs(
+    _In_ QUIC_LISTENER* Listener
+    )
+{
+    for (uint32_t i = 0; i < Listener->SniConfigCount; ++i) {
+        QuicConfigurationRelease(
+            Listener->SniConfigs[i].Configuration, QUIC_CONF_REF_LISTENER_SNI);
+    }
+    if (Listener->SniConfigs != NULL) {
+        CXPLAT_FREE(Listener->SniConfigs, QUIC_POOL_SNI_CONFIG);
+        Listener->SniConfigs = NULL;
+    }
+    Listener->SniConfigCount = 0;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicListenerFree(
@@ -166,6 +184,7 @@ QuicListenerFree(
     CxPlatRefUninitialize(&Listener->StartRefCount);
     CxPlatEventUninitialize(Listener->StopEvent);
     CXPLAT_DBG_ASSERT(Listener->AlpnList == NULL);
+    QuicListenerFreeSniConfigs(Listener);
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_LISTENER, &Listener->DbgObjectLink);
 #endif
@@ -356,12 +375,21 @@ MsQuicListenerStart(
             UdpConfig.CibirIdLength);
     }
 
+    if (MsQuicLib.EnableCidSteering && !Listener->Partitioned) {
+        UdpConfig.CidPartitionCount = MsQuicLib.PartitionCount;
+        UdpConfig.CidPartitionMask = MsQuicLib.PartitionMask;
+        UdpConfig.CidPartitionIdOffset = MsQuicLib.CidServerIdLength;
+    }
+
     if (MsQuicLib.Settings.XdpEnabled) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
     }
     if (MsQuicLib.Settings.QTIPEnabled) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
     }
+    if (MsQuicLib.Settings.RioEnabled) {
+        UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_RIO;
+    }
 
     CXPLAT_TEL_ASSERT(Listener->Binding == NULL);
     Status =
@@ -723,6 +751,213 @@ QuicListenerMatchesAlpn(
     return FALSE;
 }
 
+static
+char
+QuicListenerSniToLower(
+    _In_ char Char
+    )
+{
+    return (Char >= 'A' && Char <= 'Z') ? (char)(Char - 'A' + 'a') : Char;
+}
+
+//
+// Orders server names byte-wise, with shorter names first on a common prefix.
+//
+static
+int
+QuicListenerSniCompare(
+    _In_ uint16_t NameLength1,
+    _In_reads_(NameLength1) const char* Name1,
+    _In_ uint16_t NameLength2,
+    _In_reads_(NameLength2) const char* Name2
+    )
+{
+    int Result = memcmp(Name1, Name2, CXPLAT_MIN(NameLength1, NameLength2));
+    if (Result == 0) {
+        Result = (int)NameLength1 - (int)NameLength2;
+    }
+    return Result;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+const QUIC_LISTENER_SNI_CONFIG*
+QuicListenerSniSearch(
+    _In_ const QUIC_LISTENER* Listener,
+    _In_ uint16_t NameLength,
+    _In_reads_(NameLength) const char* Name
+    )
+{
+    uint32_t Low = 0, High = Listener->SniConfigCount;
+    while (Low < High) {
+        const uint32_t Mid = Low + (High - Low) / 2;
+        const QUIC_LISTENER_SNI_CONFIG* Entry = &Listener->SniConfigs[Mid];
+        const int Result =
+            QuicListenerSniCompare(
+                NameLength, Name, Entry->ServerNameLength, Entry->ServerName);
+        if (Result == 0) {
+            return Entry;
+        }
+        if (Result < 0) {
+            High = Mid;
+        } else {
+            Low = Mid + 1;
+        }
+    }
+    return NULL;
+}
+
+//
+// Finds the configuration mapped to the server name, trying an exact match
+// before a wildcard one.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_CONFIGURATION*
+QuicListenerFindSniConfiguration(
+    _In_ const QUIC_LISTENER* Listener,
+    _In_ uint16_t ServerNameLength,
+    _In_reads_opt_(ServerNameLength) const char* ServerName
+    )
+{
+    if (Listener->SniConfigCount == 0 ||
+        ServerName == NULL ||
+        ServerNameLength == 0 ||
+        ServerNameLength > QUIC_LISTENER_MAX_SNI_NAME_LENGTH) {
+        return NULL;
+    }
+
+    char Name[QUIC_LISTENER_MAX_SNI_NAME_LENGTH];
+    uint16_t FirstDot = ServerNameLength;
+    for (uint16_t i = 0; i < ServerNameLength; ++i) {
+        Name[i] = QuicListenerSniToLower(ServerName[i]);
+        if (Name[i] == '.' && FirstDot == ServerNameLength) {
+            FirstDot = i;
+        }
+    }
+
+    const QUIC_LISTENER_SNI_CONFIG* Entry =
+        QuicListenerSniSearch(Listener, ServerNameLength, Name);
+    if (Entry == NULL && FirstDot != 0 && FirstDot < ServerNameLength - 1) {
+        //
+        // Replace the first label with '*' to look for a wildcard entry.
+        //
+        Name[FirstDot - 1] = '*';
+        Entry =
+            QuicListenerSniSearch(
+                Listener,
+                ServerNameLength - FirstDot + 1,
+                Name + FirstDot - 1);
+    }
+
+    return Entry == NULL ? NULL : Entry->Configuration;
+}
+
+//
+// Replaces the listener's server name to configuration map. The entries and
+// their lower cased names are kept in a single allocation.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicListenerSetSniConfigs(
+    _In_ QUIC_LISTENER* Listener,
+    _In_ uint32_t Count,
+    _In_reads_(Count) const QUIC_LISTENER_SNI_CONFIGURATION* Configs
+    )
+{
+    size_t AllocLength = (size_t)Count * sizeof(QUIC_LISTENER_SNI_CONFIG);
+    for (uint32_t i = 0; i < Count; ++i) {
+        const char* Name = Configs[i].ServerName;
+        const QUIC_CONFIGURATION* Configuration =
+            (const QUIC_CONFIGURATION*)Configs[i].Configuration;
+        if (Name == NULL ||
+            Configuration == NULL ||
+            Configuration->Type != QUIC_HANDLE_TYPE_CONFIGURATION ||
+            Configuration->Registration != Listener->Registration) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        const size_t NameLength = strnlen(Name, QUIC_LISTENER_MAX_SNI_NAME_LENGTH + 1);
+        if (NameLength == 0 || NameLength > QUIC_LISTENER_MAX_SNI_NAME_LENGTH) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        for (size_t j = 0; j < NameLength; ++j) {
+            //
+            // Only a leading "*." label, followed by a non-empty suffix, is
+            // allowed as a wildcard.
+            //
+            if (Name[j] == '*' && (j != 0 || NameLength < 3 || Name[1] != '.')) {
+                return QUIC_STATUS_INVALID_PARAMETER;
+            }
+        }
+        AllocLength += NameLength;
+    }
+
+    QUIC_LISTENER_SNI_CONFIG* SniConfigs = NULL;
+    if (Count != 0) {
+        SniConfigs = CXPLAT_ALLOC_PAGED(AllocLength, QUIC_POOL_SNI_CONFIG);
+        if (SniConfigs == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Listener SNI configurations",
+                AllocLength);
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    //
+    // Insertion sort the entries by name, rejecting duplicates.
+    //
+    char* NameBuffer = (char*)(SniConfigs + Count);
+    for (uint32_t i = 0; i < Count; ++i) {
+        const uint16_t NameLength =
+            (uint16_t)strnlen(Configs[i].ServerName, QUIC_LISTENER_MAX_SNI_NAME_LENGTH);
+        for (uint16_t j = 0; j < NameLength; ++j) {
+            NameBuffer[j] = QuicListenerSniToLower(Configs[i].ServerName[j]);
+        }
+
+        uint32_t Index = i;
+        while (Index > 0) {
+            const int Result =
+                QuicListenerSniCompare(
+                    NameLength,
+                    NameBuffer,
+                    SniConfigs[Index - 1].ServerNameLength,
+                    SniConfigs[Index - 1].ServerName);
+            if (Result == 0) {
+                CXPLAT_FREE(SniConfigs, QUIC_POOL_SNI_CONFIG);
+                return QUIC_STATUS_INVALID_PARAMETER;
+            }
+            if (Result > 0) {
+                break;
+            }
+            SniConfigs[Index] = SniConfigs[Index - 1];
+            Index--;
+        }
+        SniConfigs[Index].Configuration = (QUIC_CONFIGURATION*)Configs[i].Configuration;
+        SniConfigs[Index].ServerNameLength = NameLength;
+        SniConfigs[Index].ServerName = NameBuffer;
+        NameBuffer += NameLength;
+    }
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        QuicConfigurationAddRef(SniConfigs[i].Configuration, QUIC_CONF_REF_LISTENER_SNI);
+    }
+
+    QuicListenerFreeSniConfigs(Listener);
+    Listener->SniConfigs = SniConfigs;
+    Listener->SniConfigCount = Count;
+
+    QuicTraceLogVerbose(
+        ListenerSniConfigsSet,
+        "[list][%p] SNI configurations set (count %u)",
+        Listener,
+        Count);
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicListenerClaimConnection(
@@ -796,6 +1031,30 @@ QuicListenerClaimConnection(
         Connection->ClientCallbackHandler != NULL,
         "App MUST set callback handler or close connection!");
 
+    if (Connection->Configuration == NULL &&
+        !Connection->State.HandleClosed &&
+        !QuicConnIsClosed(Connection)) {
+        //
+        // The app didn't pick a configuration while accepting the connection,
+        // so use the one it mapped to the requested server name, if any. This
+        // lets the handshake continue right away.
+        //
+        QUIC_CONFIGURATION* Configuration =
+            QuicListenerFindSniConfiguration(
+                Listener, Info->ServerNameLength, Info->ServerName);
+        if (Configuration != NULL && Configuration->SecurityConfig != NULL) {
+            QuicTraceLogConnVerbose(
+                SniConfigurationSelected,
+                Connection,
+                "Configuration %p selected by server name",
+                Configuration);
+            Status = QuicConnSetConfiguration(Connection, Configuration);
+            if (QUIC_FAILED(Status)) {
+                QuicConnFatalError(Connection, Status, "Set SNI configuration");
+            }
+        }
+    }
+
     if (!Connection->State.ShutdownComplete) {
         Connection->State.UpdateWorker = TRUE;
     }
@@ -833,6 +1092,14 @@ QuicListenerAcceptConnection(
 
     memcpy(Connection->CibirId, Listener->CibirId, sizeof(Listener->CibirId));
 
+    if (QuicAddrGetFamily(&Listener->PreferredAddress) != QUIC_ADDRESS_FAMILY_UNSPEC) {
+        Connection->PreferredAddress =
+            QuicArenaAlloc(&Connection->HandshakeArena, sizeof(QUIC_ADDR));
+        if (Connection->PreferredAddress != NULL) {
+            *Connection->PreferredAddress = Listener->PreferredAddress;
+        }
+    }
+
     if (Connection->CibirId[0] != 0) {
         QuicTraceLogConnInfo(
             CibirIdSet,
@@ -904,6 +1171,36 @@ QuicListenerParamSet(
         }
     }
 
+    if (Param == QUIC_PARAM_LISTENER_PREFERRED_ADDRESS) {
+        if (BufferLength == 0) {
+            CxPlatZeroMemory(&Listener->PreferredAddress, sizeof(Listener->PreferredAddress));
+            return QUIC_STATUS_SUCCESS;
+        }
+        if (BufferLength != sizeof(QUIC_ADDR) ||
+            !QuicAddrIsValid((const QUIC_ADDR*)Buffer) ||
+            QuicAddrIsWildCard((const QUIC_ADDR*)Buffer) ||
+            QuicAddrGetPort((const QUIC_ADDR*)Buffer) == 0) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        Listener->PreferredAddress = *(const QUIC_ADDR*)Buffer;
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    if (Param == QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS) {
+        if (BufferLength % sizeof(QUIC_LISTENER_SNI_CONFIGURATION) != 0 ||
+            (BufferLength != 0 && Buffer == NULL)) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (!Listener->Stopped) {
+            return QUIC_STATUS_INVALID_STATE;
+        }
+        return
+            QuicListenerSetSniConfigs(
+                Listener,
+                BufferLength / sizeof(QUIC_LISTENER_SNI_CONFIGURATION),
+                (const QUIC_LISTENER_SNI_CONFIGURATION*)Buffer);
+    }
+
     if (Param == QUIC_PARAM_LISTENER_PARTITION_INDEX) {
         uint16_t PartitionIndex;
         if (BufferLength != sizeof(uint16_t)) {
@@ -1034,6 +1331,27 @@ QuicListenerParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_LISTENER_PREFERRED_ADDRESS:
+
+        if (QuicAddrGetFamily(&Listener->PreferredAddress) == QUIC_ADDRESS_FAMILY_UNSPEC) {
+            *BufferLength = 0;
+            return QUIC_STATUS_SUCCESS;
+        }
+
+        if (*BufferLength < sizeof(QUIC_ADDR)) {
+            *BufferLength = sizeof(QUIC_ADDR);
+            return QUIC_STATUS_BUFFER_TOO_SMALL;
+        }
+
+        if (Buffer == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+
+        *BufferLength = sizeof(QUIC_ADDR);
+        CxPlatCopyMemory(Buffer, &Listener->PreferredAddress, sizeof(QUIC_ADDR));
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     case QUIC_PARAM_LISTENER_PARTITION_INDEX:
 
         if (*BufferLength < sizeof(Listener->PartitionIndex)) {
@@ -5,6 +5,26 @@
 
 --*/
 
+//
+// A server name mapped to the configuration the listener gives connections
+// that ask for it.
+//
+typedef struct QUIC_LISTENER_SNI_CONFIG {
+
+    //
+    // The configuration, referenced by the listener.
+    //
+    QUIC_CONFIGURATION* Configuration;
+
+    //
+    // The lower case server name, starting with "*." for wildcard entries.
+    //
+    uint16_t ServerNameLength;
+    _Field_size_(ServerNameLength)
+    const char* ServerName;
+
+} QUIC_LISTENER_SNI_CONFIG;
+
 //
 // Represents the Listener specific state.
 //
@@ -166,6 +186,22 @@ typedef struct QUIC_LISTENER {
     // connections.
     //
     uint16_t PartitionIndex;
+
+    //
+    // An optional app-configured address advertised to the listener's new
+    // connections in the preferred_address transport parameter. Unspecified
+    // family when not set.
+    //
+    QUIC_ADDR PreferredAddress;
+
+    //
+    // Optional app-configured server name to configuration map, sorted by
+    // server name. Connections that match an entry are given its configuration
+    // if the app doesn't set one while accepting them.
+    //
+    uint32_t SniConfigCount;
+    _Field_size_(SniConfigCount)
+    QUIC_LISTENER_SNI_CONFIG* SniConfigs;
 } QUIC_LISTENER;
 
 #ifdef QUIC_SILO
@@ -0,0 +1,212 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement the server ID encoding of QUIC-LB
+    (draft-ietf-quic-load-balancers), so that a load balancer configured with
+    the same config ID, lengths and key can route packets statelessly.
+
+    The encoded part of the CID is laid out as:
+
+        [First Octet][Server ID | Nonce]
+
+    The first octet carries the config ID in its top 3 bits, which allows the
+    load balancer to find the right key while keys are being rotated. The
+    server ID and a random per-CID nonce follow, either in plaintext or
+    encrypted with the four-pass Feistel network. MsQuic's own partition ID
+    and payload come after the encoded part, and so don't change.
+
+    Since MsQuic always appends its 9 bytes of partition ID and payload, the
+    server ID and nonce can't be longer than 10 bytes, so the single-pass
+    (16 byte) encryption never applies.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "load_balancing.c.clog.h"
+#endif
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLbConfigIsValid(
+    _In_ const QUIC_LB_CONFIG* Config
+    )
+{
+    return
+        Config->ConfigId <= QUIC_LB_MAX_CONFIG_ID &&
+        Config->ServerIdLength != 0 &&
+        Config->ServerIdLength <= QUIC_LB_MAX_SERVER_ID_LENGTH &&
+        Config->NonceLength >= QUIC_LB_MIN_NONCE_LENGTH &&
+        Config->ServerIdLength + Config->NonceLength <= QUIC_LB_MAX_ENCODED_LENGTH;
+}
+
+//
+// A single pass of the Feistel network. Expands the source half to an AES
+// block, with the plaintext length and pass index in the last two bytes, and
+// XORs the leading bytes of the encrypted block into the target half. For odd
+// lengths, the halves share the middle byte; the left half owns its high
+// nibble and the right half its low nibble.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_STATUS
+QuicLbPass(
+    _In_ CXPLAT_HP_KEY* Key,
+    _In_ uint8_t Length,
+    _In_ uint8_t Pass,
+    _In_reads_((Length + 1) / 2)
+        const uint8_t* Source,
+    _Inout_updates_((Length + 1) / 2)
+        uint8_t* Target,
+    _In_ BOOLEAN TargetIsLeft
+    )
+{
+    const uint8_t HalfLength = (Length + 1) / 2;
+    uint8_t Input[CXPLAT_HP_SAMPLE_LENGTH] = {0};
+    uint8_t Output[CXPLAT_HP_SAMPLE_LENGTH];
+
+    CxPlatCopyMemory(Input, Source, HalfLength);
+    Input[CXPLAT_HP_SAMPLE_LENGTH - 2] = Length;
+    Input[CXPLAT_HP_SAMPLE_LENGTH - 1] = Pass;
+
+    QUIC_STATUS Status = CxPlatHpComputeMask(Key, 1, Input, Output);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    for (uint8_t i = 0; i < HalfLength; ++i) {
+        Target[i] ^= Output[i];
+    }
+    if (Length & 1) {
+        if (TargetIsLeft) {
+            Target[HalfLength - 1] &= 0xF0;
+        } else {
+            Target[0] &= 0x0F;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLbFourPass(
+    _In_ CXPLAT_HP_KEY* Key,
+    _In_ BOOLEAN Encrypt,
+    _In_range_(QUIC_LB_MIN_NONCE_LENGTH + 1, QUIC_LB_MAX_ENCODED_LENGTH)
+        uint8_t Length,
+    _Inout_updates_(Length)
+        uint8_t* Block
+    )
+{
+    if (Length < 2 || Length > QUIC_LB_MAX_ENCODED_LENGTH) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    const uint8_t HalfLength = (Length + 1) / 2;
+    uint8_t Left[(QUIC_LB_MAX_ENCODED_LENGTH + 1) / 2];
+    uint8_t Right[(QUIC_LB_MAX_ENCODED_LENGTH + 1) / 2];
+
+    CxPlatCopyMemory(Left, Block, HalfLength);
+    CxPlatCopyMemory(Right, Block + Length - HalfLength, HalfLength);
+    if (Length & 1) {
+        Left[HalfLength - 1] &= 0xF0;
+        Right[0] &= 0x0F;
+    }
+
+    //
+    // Odd passes modify the right half and even passes the left half.
+    // Decryption runs the same passes in reverse.
+    //
+    for (uint8_t i = 0; i < 4; ++i) {
+        const uint8_t Pass = Encrypt ? i + 1 : 4 - i;
+        QUIC_STATUS Status =
+            (Pass & 1) ?
+                QuicLbPass(Key, Length, Pass, Left, Right, FALSE) :
+                QuicLbPass(Key, Length, Pass, Right, Left, TRUE);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    CxPlatCopyMemory(Block, Left, HalfLength);
+    if (Length & 1) {
+        Block[HalfLength - 1] |= Right[0];
+        CxPlatCopyMemory(Block + HalfLength, Right + 1, HalfLength - 1);
+    } else {
+        CxPlatCopyMemory(Block + HalfLength, Right, HalfLength);
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLbEncodeServerId(
+    _In_ const QUIC_LB_CONFIG* Config,
+    _In_opt_ CXPLAT_HP_KEY* Key,
+    _In_ uint8_t CidLength,
+    _Out_writes_(QUIC_LB_ENCODED_LENGTH(Config))
+        uint8_t* Data
+    )
+{
+    CXPLAT_DBG_ASSERT(QuicLbConfigIsValid(Config));
+    CXPLAT_DBG_ASSERT(CidLength >= QUIC_LB_ENCODED_LENGTH(Config));
+
+    Data[0] =
+        (uint8_t)(Config->ConfigId << QUIC_LB_CONFIG_ID_SHIFT) |
+        ((CidLength - 1) & QUIC_LB_LENGTH_MASK);
+    CxPlatCopyMemory(Data + 1, Config->ServerId, Config->ServerIdLength);
+    CxPlatRandom(Config->NonceLength, Data + 1 + Config->ServerIdLength);
+
+    if (!Config->Encrypted) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    CXPLAT_DBG_ASSERT(Key != NULL);
+    return
+        QuicLbFourPass(
+            Key,
+            TRUE,
+            Config->ServerIdLength + Config->NonceLength,
+            Data + 1);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLbDecodeServerId(
+    _In_ const QUIC_LB_CONFIG* Config,
+    _In_opt_ CXPLAT_HP_KEY* Key,
+    _In_reads_(QUIC_LB_ENCODED_LENGTH(Config))
+        const uint8_t* Data,
+    _Out_writes_(Config->ServerIdLength)
+        uint8_t* ServerId
+    )
+{
+    if (!QuicLbConfigIsValid(Config)) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((Data[0] >> QUIC_LB_CONFIG_ID_SHIFT) != Config->ConfigId) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    uint8_t Block[QUIC_LB_MAX_ENCODED_LENGTH];
+    const uint8_t Length = Config->ServerIdLength + Config->NonceLength;
+    CxPlatCopyMemory(Block, Data + 1, Length);
+
+    if (Config->Encrypted) {
+        CXPLAT_DBG_ASSERT(Key != NULL);
+        QUIC_STATUS Status = QuicLbFourPass(Key, FALSE, Length, Block);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    CxPlatCopyMemory(ServerId, Block, Config->ServerIdLength);
+    return QUIC_STATUS_SUCCESS;
+}
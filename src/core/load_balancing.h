@@ -0,0 +1,87 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    QUIC-LB (draft-ietf-quic-load-balancers) server ID encoding.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The config ID occupies the top 3 bits of the first octet. The remaining 5
+// bits self-encode the CID length (minus one).
+//
+#define QUIC_LB_CONFIG_ID_SHIFT     5
+#define QUIC_LB_LENGTH_MASK         0x1F
+
+//
+// The number of bytes of the CID that QUIC-LB encoding of the config uses:
+// the first octet, the server ID and the nonce.
+//
+#define QUIC_LB_ENCODED_LENGTH(Config) \
+    (1 + (Config)->ServerIdLength + (Config)->NonceLength)
+
+//
+// Returns TRUE if the configuration is one MsQuic can encode.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLbConfigIsValid(
+    _In_ const QUIC_LB_CONFIG* Config
+    );
+
+//
+// Encrypts or decrypts, in place, the server ID and nonce with the four-pass
+// Feistel network, using the AES-128-ECB key.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLbFourPass(
+    _In_ CXPLAT_HP_KEY* Key,
+    _In_ BOOLEAN Encrypt,
+    _In_range_(QUIC_LB_MIN_NONCE_LENGTH + 1, QUIC_LB_MAX_ENCODED_LENGTH)
+        uint8_t Length,
+    _Inout_updates_(Length)
+        uint8_t* Block
+    );
+
+//
+// Writes the first octet, server ID and a fresh random nonce for a new CID of
+// length CidLength, encrypting the server ID and nonce if the config requires.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLbEncodeServerId(
+    _In_ const QUIC_LB_CONFIG* Config,
+    _In_opt_ CXPLAT_HP_KEY* Key,
+    _In_ uint8_t CidLength,
+    _Out_writes_(QUIC_LB_ENCODED_LENGTH(Config))
+        uint8_t* Data
+    );
+
+//
+// Extracts the server ID from a CID encoded with the config, as a load
+// balancer would.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicLbDecodeServerId(
+    _In_ const QUIC_LB_CONFIG* Config,
+    _In_opt_ CXPLAT_HP_KEY* Key,
+    _In_reads_(QUIC_LB_ENCODED_LENGTH(Config))
+        const uint8_t* Data,
+    _Out_writes_(Config->ServerIdLength)
+        uint8_t* ServerId
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -7,6 +7,16 @@ Abstract:
 
     Lookup tables for connections.
 
+    Local CIDs in the partitioned tables are stored in open-addressed arrays
+    that are read without taking any lock, since every received packet does
+    such a lookup. Writers are serialized by the lookup's RwLock, publish
+    changes with interlocked pointer writes and only free memory a reader may
+    still be looking at (the CID entries, their connection references and any
+    replaced arrays) after all readers that might have seen it have left. The
+    readers announce themselves on per-processor counters, split in two
+    phases, so that a writer only has to wait for the readers that started
+    before it switched phases.
+
 --*/
 
 #include "precomp.h"
@@ -14,21 +24,87 @@ Abstract:
 #include "lookup.c.clog.h"
 #endif
 
+//
+// Marks a removed entry, so that probe sequences through it stay intact.
+//
+#define QUIC_CID_SLOT_TOMBSTONE ((QUIC_CID_HASH_ENTRY*)(size_t)1)
+
+//
+// The initial (and minimum) number of slots of a partition's array.
+//
+#define QUIC_CID_SLOTS_MIN_COUNT 16
+
+//
+// An open-addressed (linear probing) array of local CIDs. It is never resized
+// in place; a new array is built and swapped in instead.
+//
+typedef struct QUIC_CID_SLOTS {
+
+    uint32_t Mask;
+    QUIC_CID_HASH_ENTRY* volatile Entries[0];
+
+} QUIC_CID_SLOTS;
+
 typedef struct QUIC_CACHEALIGN QUIC_PARTITIONED_HASHTABLE {
 
-    CXPLAT_DISPATCH_RW_LOCK RwLock;
-    CXPLAT_HASHTABLE Table;
+    QUIC_CID_SLOTS* volatile Slots;
+
+    //
+    // The number of live entries, and of live entries plus tombstones, in
+    // Slots. Only used by writers.
+    //
+    uint32_t EntryCount;
+    uint32_t UsedCount;
+
+    //
+    // The number of tables in the array this one belongs to. Lock-free readers
+    // use the copy in the first table so that they never pair an array with
+    // the partition count of another one.
+    //
+    uint16_t PartitionCount;
 
 } QUIC_PARTITIONED_HASHTABLE;
 
+typedef struct QUIC_CACHEALIGN QUIC_LOOKUP_READERS {
+
+    long volatile Enter[2];
+    long volatile Exit[2];
+
+} QUIC_LOOKUP_READERS;
+
+//
+// Allocates an empty slot array with room for SlotCount entries, which must be
+// a power of two.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
-BOOLEAN
-QuicLookupInsertLocalCid(
-    _In_ QUIC_LOOKUP* Lookup,
-    _In_ uint32_t Hash,
-    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
-    _In_ BOOLEAN UpdateRefCount
-    );
+QUIC_CID_SLOTS*
+QuicCidSlotsAlloc(
+    _In_ uint32_t SlotCount
+    )
+{
+    CXPLAT_DBG_ASSERT((SlotCount & (SlotCount - 1)) == 0);
+    const size_t Size =
+        sizeof(QUIC_CID_SLOTS) + SlotCount * sizeof(QUIC_CID_HASH_ENTRY*);
+    QUIC_CID_SLOTS* Slots = CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_LOOKUP_CID_SLOTS);
+    if (Slots != NULL) {
+        CxPlatZeroMemory(Slots, Size);
+        Slots->Mask = SlotCount - 1;
+        QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_LOOKUP, (int64_t)Size);
+    }
+    return Slots;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotsFree(
+    _In_ _Post_invalid_ QUIC_CID_SLOTS* Slots
+    )
+{
+    QuicLibraryTrackMemory(
+        QUIC_MEMORY_TYPE_LOOKUP,
+        -(int64_t)(sizeof(QUIC_CID_SLOTS) + (Slots->Mask + 1) * sizeof(QUIC_CID_HASH_ENTRY*)));
+    CXPLAT_FREE(Slots, QUIC_POOL_LOOKUP_CID_SLOTS);
+}
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
@@ -40,6 +116,22 @@ QuicLookupInitialize(
     CxPlatDispatchRwLockInitialize(&Lookup->RwLock);
 }
 
+//
+// Frees an array of partitioned tables.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFreeHashTables(
+    _In_ _Post_invalid_ QUIC_PARTITIONED_HASHTABLE* Tables,
+    _In_ uint16_t PartitionCount
+    )
+{
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        QuicCidSlotsFree(Tables[i].Slots);
+    }
+    CXPLAT_FREE(Tables, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLookupUninitialize(
@@ -53,15 +145,13 @@ QuicLookupUninitialize(
     } else {
         CXPLAT_DBG_ASSERT(Lookup->HASH.Tables != NULL);
         for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
-            QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[i];
-            CXPLAT_DBG_ASSERT(Table->Table.NumEntries == 0);
-#pragma warning(push)
-#pragma warning(disable:6001)
-            CxPlatHashtableUninitialize(&Table->Table);
-#pragma warning(pop)
-            CxPlatDispatchRwLockUninitialize(&Table->RwLock);
+            CXPLAT_DBG_ASSERT(Lookup->HASH.Tables[i].EntryCount == 0);
         }
-        CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
+        QuicLookupFreeHashTables(Lookup->HASH.Tables, Lookup->PartitionCount);
+    }
+
+    if (Lookup->Readers != NULL) {
+        CXPLAT_FREE(Lookup->Readers, QUIC_POOL_LOOKUP_READERS);
     }
 
     if (Lookup->MaximizePartitioning) {
@@ -73,47 +163,219 @@ QuicLookupUninitialize(
 }
 
 //
-// Allocates and initializes a new partitioned hash table.
+// Starts a lock-free read of the partitioned tables. Returns the index of the
+// counters and the phase to pass to QuicLookupReadEnd.
+//
+QUIC_INLINE
+uint32_t
+QuicLookupReadBegin(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_LOOKUP_READERS* Readers,
+    _Out_ long* Phase
+    )
+{
+    uint32_t Index = CxPlatProcCurrentNumber() % CxPlatProcCount();
+    while (TRUE) {
+        *Phase = Lookup->ReadPhase & 1;
+        InterlockedIncrement(&Readers[Index].Enter[*Phase]);
+
+        //
+        // A writer may have flipped the phase between the read above and the
+        // increment, and already summed the counters of the phase sampled
+        // here. The interlocked increment is a full barrier, so if the phase
+        // is still the same now, the writer is guaranteed to count this
+        // reader. Otherwise, cancel the enter with an exit and try again.
+        //
+        if ((Lookup->ReadPhase & 1) == *Phase) {
+            break;
+        }
+        InterlockedIncrement(&Readers[Index].Exit[*Phase]);
+    }
+    return Index;
+}
+
+QUIC_INLINE
+void
+QuicLookupReadEnd(
+    _In_ QUIC_LOOKUP_READERS* Readers,
+    _In_ long Phase,
+    _In_ uint32_t Index
+    )
+{
+    InterlockedIncrement(&Readers[Index].Exit[Phase]);
+}
+
+//
+// Waits for all the lock-free readers that may still reference something a
+// writer has just unlinked. Requires the RwLock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupWaitForReaders(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    QUIC_LOOKUP_READERS* Readers = Lookup->Readers;
+    if (Readers == NULL) {
+        return; // All readers take the RwLock.
+    }
+
+    //
+    // Move new readers to the other phase, so that the old one can drain. The
+    // interlocked operation also orders the writer's unlinks before the reads
+    // of the counters below. A reader that still increments the old phase
+    // after they are read sees the new phase when it checks it again in
+    // QuicLookupReadBegin, and moves to it.
+    //
+    long Phase = InterlockedIncrement(&Lookup->ReadPhase) - 1;
+    Phase &= 1;
+
+    const uint32_t ProcCount = CxPlatProcCount();
+    while (TRUE) {
+        //
+        // Exits are summed first, so that each one counted has its enter
+        // counted too. Equal sums then mean no reader is left in the phase.
+        //
+        uint32_t Exits = 0, Enters = 0;
+        for (uint32_t i = 0; i < ProcCount; i++) {
+            Exits += (uint32_t)Readers[i].Exit[Phase];
+        }
+        InterlockedOr(&Lookup->ReadPhase, 0); // Full barrier
+        for (uint32_t i = 0; i < ProcCount; i++) {
+            Enters += (uint32_t)Readers[i].Enter[Phase];
+        }
+        if (Enters == Exits) {
+            break;
+        }
+        CxPlatSchedulerYield();
+    }
+}
+
+//
+// Stores the entry in the first free slot of its probe sequence. The caller
+// makes sure one exists. Returns the slot's previous content.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CID_HASH_ENTRY*
+QuicCidSlotsInsert(
+    _In_ QUIC_CID_SLOTS* Slots,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid
+    )
+{
+    uint32_t i = SourceCid->Hash & Slots->Mask;
+    while (Slots->Entries[i] != NULL && Slots->Entries[i] != QUIC_CID_SLOT_TOMBSTONE) {
+        i = (i + 1) & Slots->Mask;
+    }
+    QUIC_CID_HASH_ENTRY* Previous = Slots->Entries[i];
+    InterlockedExchangePointer((void**)&Slots->Entries[i], SourceCid);
+    return Previous;
+}
+
+//
+// Inserts a CID entry into a partition, rebuilding its slot array first if it
+// is getting too full. Requires the RwLock to be held exclusively.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
-QuicLookupCreateHashTable(
+QuicLookupHashTableInsert(
     _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_PARTITIONED_HASHTABLE* Table,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid
+    )
+{
+    QUIC_CID_SLOTS* Slots = Table->Slots;
+    const uint32_t SlotCount = Slots->Mask + 1;
+
+    //
+    // Keep the load (tombstones included) at or below 3/4, so that probe
+    // sequences stay short and always end at an empty slot.
+    //
+    if ((Table->UsedCount + 1) * 4 > SlotCount * 3) {
+        uint32_t NewSlotCount = QUIC_CID_SLOTS_MIN_COUNT;
+        while ((Table->EntryCount + 1) * 2 > NewSlotCount) {
+            NewSlotCount <<= 1;
+        }
+        QUIC_CID_SLOTS* NewSlots = QuicCidSlotsAlloc(NewSlotCount);
+        if (NewSlots == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "CID slots",
+                sizeof(QUIC_CID_SLOTS) + NewSlotCount * sizeof(QUIC_CID_HASH_ENTRY*));
+            return FALSE;
+        }
+        for (uint32_t i = 0; i < SlotCount; i++) {
+            QUIC_CID_HASH_ENTRY* Entry = Slots->Entries[i];
+            if (Entry != NULL && Entry != QUIC_CID_SLOT_TOMBSTONE) {
+                (void)QuicCidSlotsInsert(NewSlots, Entry);
+            }
+        }
+        InterlockedExchangePointer((void**)&Table->Slots, NewSlots);
+        Table->UsedCount = Table->EntryCount;
+        QuicLookupWaitForReaders(Lookup);
+        QuicCidSlotsFree(Slots);
+        Slots = NewSlots;
+    }
+
+    if (QuicCidSlotsInsert(Slots, SourceCid) == NULL) {
+        Table->UsedCount++;
+    }
+    Table->EntryCount++;
+
+    return TRUE;
+}
+
+//
+// Replaces the CID entry with a tombstone. The entry must not be freed before
+// QuicLookupWaitForReaders is called.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupHashTableRemove(
+    _In_ QUIC_PARTITIONED_HASHTABLE* Table,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid
+    )
+{
+    QUIC_CID_SLOTS* Slots = Table->Slots;
+    uint32_t i = SourceCid->Hash & Slots->Mask;
+    while (Slots->Entries[i] != SourceCid) {
+        CXPLAT_DBG_ASSERT(Slots->Entries[i] != NULL);
+        i = (i + 1) & Slots->Mask;
+    }
+    InterlockedExchangePointer((void**)&Slots->Entries[i], QUIC_CID_SLOT_TOMBSTONE);
+    Table->EntryCount--;
+}
+
+//
+// Allocates and initializes a new array of partitioned hash tables.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_PARTITIONED_HASHTABLE*
+QuicLookupCreateHashTables(
     _In_range_(>, 0) uint16_t PartitionCount
     )
 {
-    CXPLAT_DBG_ASSERT(Lookup->LookupTable == NULL);
     CXPLAT_FRE_ASSERT(PartitionCount > 0);
 
-    Lookup->HASH.Tables =
+    QUIC_PARTITIONED_HASHTABLE* Tables =
         CXPLAT_ALLOC_NONPAGED(
             sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount,
             QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Tables == NULL) {
+        return NULL;
+    }
 
-    if (Lookup->HASH.Tables != NULL) {
-
-        uint16_t Cleanup = 0;
-        uint8_t Failed = FALSE;
-        for (uint16_t i = 0; i < PartitionCount; i++) {
-            if (!CxPlatHashtableInitializeEx(&Lookup->HASH.Tables[i].Table, CXPLAT_HASH_MIN_SIZE)) {
-                Cleanup = i;
-                Failed = TRUE;
-                break;
-            }
-            CxPlatDispatchRwLockInitialize(&Lookup->HASH.Tables[i].RwLock);
-        }
-        if (Failed) {
-            for (uint16_t i = 0; i < Cleanup; i++) {
-                CxPlatHashtableUninitialize(&Lookup->HASH.Tables[i].Table);
-            }
-            CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
-            Lookup->HASH.Tables = NULL;
-        } else {
-            Lookup->PartitionCount = PartitionCount;
+    CxPlatZeroMemory(Tables, sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount);
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        Tables[i].PartitionCount = PartitionCount;
+        Tables[i].Slots = QuicCidSlotsAlloc(QUIC_CID_SLOTS_MIN_COUNT);
+        if (Tables[i].Slots == NULL) {
+            QuicLookupFreeHashTables(Tables, i);
+            return NULL;
         }
     }
 
-    return Lookup->HASH.Tables != NULL;
+    return Tables;
 }
 
 //
@@ -152,31 +414,41 @@ QuicLookupRebalance(
 
     if (PartitionCount > Lookup->PartitionCount) {
 
-        uint16_t PreviousPartitionCount = Lookup->PartitionCount;
-        void* PreviousLookup = Lookup->LookupTable;
-        Lookup->LookupTable = NULL;
-
         CXPLAT_DBG_ASSERT(PartitionCount != 0);
 
-        if (!QuicLookupCreateHashTable(Lookup, PartitionCount)) {
-            Lookup->LookupTable = PreviousLookup;
-            return FALSE;
+        QUIC_LOOKUP_READERS* Readers = Lookup->Readers;
+        if (Readers == NULL) {
+            Readers =
+                CXPLAT_ALLOC_NONPAGED(
+                    sizeof(QUIC_LOOKUP_READERS) * CxPlatProcCount(),
+                    QUIC_POOL_LOOKUP_READERS);
+            if (Readers == NULL) {
+                return FALSE;
+            }
+            CxPlatZeroMemory(Readers, sizeof(QUIC_LOOKUP_READERS) * CxPlatProcCount());
+        }
+
+        QUIC_PARTITIONED_HASHTABLE* Tables =
+            QuicLookupCreateHashTables(PartitionCount);
+        if (Tables == NULL) {
+            goto Error;
         }
 
         //
-        // Move the CIDs to the new table.
+        // Copy the CIDs to the new tables. Nothing is published until they are
+        // all in, so readers keep using the previous lookup until then.
         //
 
-        if (PreviousPartitionCount == 0) {
+        if (Lookup->PartitionCount == 0) {
 
             //
             // Only a single connection before. Enumerate all CIDs on the
-            // connection and reinsert them into the new table(s).
+            // connection and insert them into the new table(s).
             //
 
-            if (PreviousLookup != NULL) {
+            if (Lookup->SINGLE.Connection != NULL) {
                 CXPLAT_SLIST_ENTRY* Entry =
-                    ((QUIC_CONNECTION*)PreviousLookup)->SourceCids.Next;
+                    Lookup->SINGLE.Connection->SourceCids.Next;
 
                 while (Entry != NULL) {
                     QUIC_CID_HASH_ENTRY *CID =
@@ -184,11 +456,17 @@ QuicLookupRebalance(
                             Entry,
                             QUIC_CID_HASH_ENTRY,
                             Link);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
+                    if (CID->CID.IsInLookupTable) {
+                        CID->Hash = CxPlatHashSimple(CID->CID.Length, CID->CID.Data);
+                        uint16_t PartitionIndex;
+                        CxPlatCopyMemory(&PartitionIndex, CID->CID.Data + MsQuicLib.CidServerIdLength, 2);
+                        PartitionIndex &= MsQuicLib.PartitionMask;
+                        PartitionIndex %= PartitionCount;
+                        if (!QuicLookupHashTableInsert(Lookup, &Tables[PartitionIndex], CID)) {
+                            QuicLookupFreeHashTables(Tables, PartitionCount);
+                            goto Error;
+                        }
+                    }
                     Entry = Entry->Next;
                 }
             }
@@ -196,44 +474,59 @@ QuicLookupRebalance(
         } else {
 
             //
-            // Changes the number of partitioned tables. Remove all the CIDs
-            // from the old tables and insert them into the new tables.
+            // Changes the number of partitioned tables. Copy all the CIDs from
+            // the old tables to the new tables.
             //
 
-            QUIC_PARTITIONED_HASHTABLE* PreviousTable = PreviousLookup;
-            for (uint16_t i = 0; i < PreviousPartitionCount; i++) {
-                CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableEnumerateBegin(&PreviousTable[i].Table, &Enumerator);
-#pragma warning(pop)
-                while (TRUE) {
-                    CXPLAT_HASHTABLE_ENTRY* Entry =
-                        CxPlatHashtableEnumerateNext(&PreviousTable[i].Table, &Enumerator);
-                    if (Entry == NULL) {
-                        CxPlatHashtableEnumerateEnd(&PreviousTable[i].Table, &Enumerator);
-                        break;
+            QUIC_PARTITIONED_HASHTABLE* PreviousTables = Lookup->HASH.Tables;
+            for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
+                QUIC_CID_SLOTS* Slots = PreviousTables[i].Slots;
+                for (uint32_t j = 0; j <= Slots->Mask; j++) {
+                    QUIC_CID_HASH_ENTRY* CID = Slots->Entries[j];
+                    if (CID == NULL || CID == QUIC_CID_SLOT_TOMBSTONE) {
+                        continue;
+                    }
+                    uint16_t PartitionIndex;
+                    CxPlatCopyMemory(&PartitionIndex, CID->CID.Data + MsQuicLib.CidServerIdLength, 2);
+                    PartitionIndex &= MsQuicLib.PartitionMask;
+                    PartitionIndex %= PartitionCount;
+                    if (!QuicLookupHashTableInsert(Lookup, &Tables[PartitionIndex], CID)) {
+                        QuicLookupFreeHashTables(Tables, PartitionCount);
+                        goto Error;
                     }
-                    CxPlatHashtableRemove(&PreviousTable[i].Table, Entry, NULL);
-
-                    QUIC_CID_HASH_ENTRY *CID =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_HASH_ENTRY,
-                            Entry);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
                 }
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableUninitialize(&PreviousTable[i].Table);
-#pragma warning(pop)
             }
-            CXPLAT_FREE(PreviousTable, QUIC_POOL_LOOKUP_HASHTABLE);
         }
+
+        //
+        // Publish the new tables, and then wait for any reader of the previous
+        // ones before freeing them.
+        //
+
+        QUIC_PARTITIONED_HASHTABLE* PreviousTables = Lookup->HASH.Tables;
+        uint16_t PreviousPartitionCount = Lookup->PartitionCount;
+        InterlockedExchangePointer((void**)&Lookup->HASH.Tables, Tables);
+        Lookup->PartitionCount = PartitionCount;
+        Lookup->SINGLE.Connection = NULL;
+
+        if (Lookup->Readers == NULL) {
+            //
+            // Up to now, all readers took the RwLock, which is held.
+            //
+            InterlockedExchangePointer((void**)&Lookup->Readers, Readers);
+        } else if (PreviousTables != NULL) {
+            QuicLookupWaitForReaders(Lookup);
+            QuicLookupFreeHashTables(PreviousTables, PreviousPartitionCount);
+        }
+
+        return TRUE;
+
+Error:
+
+        if (Readers != Lookup->Readers) {
+            CXPLAT_FREE(Readers, QUIC_POOL_LOOKUP_READERS);
+        }
+        return FALSE;
     }
 
     return TRUE;
@@ -301,31 +594,34 @@ QuicCidMatchConnection(
 //
 // Uses the hash and destination connection ID to look up the connection in the
 // hash table. Returns the pointer to the connection if found; NULL otherwise.
+// Safe to call without the RwLock, between QuicLookupReadBegin/End.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicHashLookupConnection(
-    _In_ CXPLAT_HASHTABLE* Table,
+    _In_ const QUIC_PARTITIONED_HASHTABLE* Table,
     _In_reads_(Length)
         const uint8_t* const DestCid,
     _In_ uint8_t Length,
     _In_ uint32_t Hash
     )
 {
-    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
-    CXPLAT_HASHTABLE_ENTRY* TableEntry =
-        CxPlatHashtableLookup(Table, Hash, &Context);
+    const QUIC_CID_SLOTS* Slots = QuicReadPtrNoFence((void**)&Table->Slots);
 
-    while (TableEntry != NULL) {
-        QUIC_CID_HASH_ENTRY* CIDEntry =
-            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_CID_HASH_ENTRY, Entry);
+    for (uint32_t i = Hash & Slots->Mask; ; i = (i + 1) & Slots->Mask) {
+        const QUIC_CID_HASH_ENTRY* CIDEntry =
+            QuicReadPtrNoFence((void**)&Slots->Entries[i]);
+
+        if (CIDEntry == NULL) {
+            break;
+        }
 
-        if (CIDEntry->CID.Length == Length &&
+        if (CIDEntry != QUIC_CID_SLOT_TOMBSTONE &&
+            CIDEntry->Hash == Hash &&
+            CIDEntry->CID.Length == Length &&
             memcmp(DestCid, CIDEntry->CID.Data, Length) == 0) {
             return CIDEntry->Connection;
         }
-
-        TableEntry = CxPlatHashtableLookupNext(Table, &Context);
     }
 
     return NULL;
@@ -342,8 +638,10 @@ QuicLookupFindConnectionByLocalCidInternal(
     )
 {
     QUIC_CONNECTION* Connection = NULL;
+    const QUIC_PARTITIONED_HASHTABLE* Tables =
+        QuicReadPtrNoFence((void**)&Lookup->HASH.Tables);
 
-    if (Lookup->PartitionCount == 0) {
+    if (Tables == NULL) {
         //
         // Only a single connection is on this binding. Validate that the
         // destination connection ID matches that connection.
@@ -366,17 +664,13 @@ QuicLookupFindConnectionByLocalCidInternal(
         uint16_t PartitionIndex;
         CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
         PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireShared(&Table->RwLock, PrevIrql);
+        PartitionIndex %= Tables[0].PartitionCount;
         Connection =
             QuicHashLookupConnection(
-                &Table->Table,
+                &Tables[PartitionIndex],
                 CID,
                 CIDLen,
                 Hash);
-        CxPlatDispatchRwLockReleaseShared(&Table->RwLock, PrevIrql);
     }
 
 #if QUIC_DEBUG_HASHTABLE_LOOKUP
@@ -399,6 +693,7 @@ QuicLookupFindConnectionByLocalCidInternal(
     return Connection;
 }
 
+
 //
 // Requires Lookup->RwLock to be held (shared).
 //
@@ -485,15 +780,11 @@ QuicLookupInsertLocalCid(
         CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
         PartitionIndex &= MsQuicLib.PartitionMask;
         PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock, PrevIrql);
-        CxPlatHashtableInsert(
-            &Table->Table,
-            &SourceCid->Entry,
-            Hash,
-            NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock, PrevIrql);
+        SourceCid->Hash = Hash;
+        if (!QuicLookupHashTableInsert(
+                Lookup, &Lookup->HASH.Tables[PartitionIndex], SourceCid)) {
+            return FALSE;
+        }
     }
 
     if (UpdateRefCount) {
@@ -575,7 +866,8 @@ QuicLookupInsertRemoteHash(
 
 //
 // Removes a source connection ID from the lookup table. Requires the
-// Lookup->RwLock to be exlusively held.
+// Lookup->RwLock to be exlusively held. Neither the entry nor its connection
+// reference may be released before QuicLookupWaitForReaders is called.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
@@ -616,10 +908,7 @@ QuicLookupRemoveLocalCidInt(
         CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
         PartitionIndex &= MsQuicLib.PartitionMask;
         PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock, PrevIrql);
-        CxPlatHashtableRemove(&Table->Table, &SourceCid->Entry, NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock, PrevIrql);
+        QuicLookupHashTableRemove(&Lookup->HASH.Tables[PartitionIndex], SourceCid);
     }
 }
 
@@ -629,25 +918,53 @@ QuicLookupFindConnectionByLocalCid(
     _In_ QUIC_LOOKUP* Lookup,
     _In_reads_(CIDLen)
         const uint8_t* const CID,
-    _In_ uint8_t CIDLen
+    _In_ uint8_t CIDLen,
+    _In_ uint32_t Hash
     )
 {
-    uint32_t Hash = CxPlatHashSimple(CIDLen, CID);
+    CXPLAT_DBG_ASSERT(Hash == CxPlatHashSimple(CIDLen, CID));
 
-    CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
+    QUIC_CONNECTION* ExistingConnection;
+    QUIC_LOOKUP_READERS* Readers = QuicReadPtrNoFence((void**)&Lookup->Readers);
 
-    QUIC_CONNECTION* ExistingConnection =
-        QuicLookupFindConnectionByLocalCidInternal(
-            Lookup,
-            CID,
-            CIDLen,
-            Hash);
+    if (Readers != NULL) {
+        //
+        // The partitioned tables exist, so the lookup is done lock-free. The
+        // connection's lookup table reference can't be released before the
+        // read ends, so it is safe to take a new one.
+        //
+        long Phase;
+        const uint32_t Index = QuicLookupReadBegin(Lookup, Readers, &Phase);
 
-    if (ExistingConnection != NULL) {
-        QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
-    }
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                CID,
+                CIDLen,
+                Hash);
 
-    CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+
+        QuicLookupReadEnd(Readers, Phase, Index);
+
+    } else {
+        CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
+
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                CID,
+                CIDLen,
+                Hash);
+
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+
+        CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+    }
 
     return ExistingConnection;
 }
@@ -830,6 +1147,7 @@ QuicLookupRemoveLocalCid(
     QuicLookupRemoveLocalCidInt(Lookup, SourceCid);
     SourceCid->CID.IsInLookupTable = FALSE;
     *Entry = (*Entry)->Next;
+    QuicLookupWaitForReaders(Lookup);
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
     QuicConnRelease(SourceCid->Connection, QUIC_CONN_REF_LOOKUP_TABLE);
 }
@@ -869,10 +1187,12 @@ QuicLookupRemoveLocalCids(
     uint8_t ReleaseRefCount = 0;
 
     CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
-    while (Connection->SourceCids.Next != NULL) {
+    for (CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
+        Entry != NULL;
+        Entry = Entry->Next) {
         QUIC_CID_HASH_ENTRY *CID =
             CXPLAT_CONTAINING_RECORD(
-                CxPlatListPopEntry(&Connection->SourceCids),
+                Entry,
                 QUIC_CID_HASH_ENTRY,
                 Link);
         if (CID->CID.IsInLookupTable) {
@@ -880,6 +1200,16 @@ QuicLookupRemoveLocalCids(
             CID->CID.IsInLookupTable = FALSE;
             ReleaseRefCount++;
         }
+    }
+    if (ReleaseRefCount != 0) {
+        QuicLookupWaitForReaders(Lookup);
+    }
+    while (Connection->SourceCids.Next != NULL) {
+        QUIC_CID_HASH_ENTRY *CID =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListPopEntry(&Connection->SourceCids),
+                QUIC_CID_HASH_ENTRY,
+                Link);
         CXPLAT_FREE(CID, QUIC_POOL_CIDHASH);
     }
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
@@ -913,6 +1243,11 @@ QuicLookupMoveLocalConnectionIDs(
         }
         Entry = Entry->Next;
     }
+    //
+    // The entries are reinserted below, so readers of the source lookup must
+    // be done with them first.
+    //
+    QuicLookupWaitForReaders(LookupSrc);
     CxPlatDispatchRwLockReleaseExclusive(&LookupSrc->RwLock, PrevIrql1);
 
     CxPlatDispatchRwLockAcquireExclusive(&LookupDest->RwLock, PrevIrql2);
@@ -938,3 +1273,43 @@ QuicLookupMoveLocalConnectionIDs(
     }
     CxPlatDispatchRwLockReleaseExclusive(&LookupDest->RwLock, PrevIrql2);
 }
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupAddStandbyConnection(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    BOOLEAN Result = FALSE;
+
+    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    if (!Lookup->MaximizePartitioning &&
+        Lookup->PartitionCount == 0 &&
+        Lookup->SINGLE.Connection == NULL) {
+        CXPLAT_DBG_ASSERT(Lookup->CidCount == 0);
+        Lookup->SINGLE.Connection = Connection;
+        QuicConnAddRef(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+        Result = TRUE;
+    }
+    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+
+    return Result;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupRemoveStandbyConnection(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    CXPLAT_DBG_ASSERT(Lookup->PartitionCount == 0);
+    CXPLAT_DBG_ASSERT(Lookup->CidCount == 0);
+    CXPLAT_DBG_ASSERT(Lookup->SINGLE.Connection == Connection);
+    Lookup->SINGLE.Connection = NULL;
+    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+
+    QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+}
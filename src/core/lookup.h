@@ -6,6 +6,7 @@
 --*/
 
 typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
+typedef struct QUIC_LOOKUP_READERS QUIC_LOOKUP_READERS;
 
 typedef struct QUIC_REMOTE_HASH_ENTRY {
 
@@ -34,10 +35,22 @@ typedef struct QUIC_LOOKUP {
     uint32_t CidCount;
 
     //
-    // Lock for accessing the lookup data.
+    // Lock for accessing the lookup data. Writers always hold it exclusively.
+    // Local CID lookups only take it (shared) until the partitioned tables
+    // exist; after that they run lock-free and use Readers instead.
     //
     CXPLAT_DISPATCH_RW_LOCK RwLock;
 
+    //
+    // Per-processor counters of the lock-free readers of the partitioned
+    // tables, indexed by ReadPhase. Writers wait for the readers of the
+    // previous phase to drain before freeing anything they have unlinked.
+    // NULL until the first partitioned table is created.
+    //
+    _Field_size_(CxPlatProcCount())
+    QUIC_LOOKUP_READERS* volatile Readers;
+    long volatile ReadPhase;
+
     //
     // The number of partitions used for lookup tables. Value of 0 (default)
     // indicates only a single connection (may be NULL) is bound.
@@ -45,24 +58,23 @@ typedef struct QUIC_LOOKUP {
     uint16_t PartitionCount;
 
     //
-    // Local CID lookup.
+    // Local CID lookup. Only one of these is used at a time, based on the
+    // partition count, but they are kept separate so that a lock-free reader
+    // never interprets one as the other.
     //
-    union {
-        void* LookupTable;
-        struct {
-            //
-            // Single client connection is bound.
-            //
-            QUIC_CONNECTION* Connection;
-        } SINGLE;
-        struct {
-            //
-            // Set of partitioned hash tables.
-            //
-            _Field_size_bytes_(PartitionCount * sizeof(QUIC_PARTITIONED_HASHTABLE))
-            QUIC_PARTITIONED_HASHTABLE* Tables;
-        } HASH;
-    };
+    struct {
+        //
+        // Single client connection is bound.
+        //
+        QUIC_CONNECTION* Connection;
+    } SINGLE;
+    struct {
+        //
+        // Set of partitioned hash tables.
+        //
+        _Field_size_bytes_(PartitionCount * sizeof(QUIC_PARTITIONED_HASHTABLE))
+        QUIC_PARTITIONED_HASHTABLE* volatile Tables;
+    } HASH;
 
     //
     // Remote Hash lookup.
@@ -99,7 +111,8 @@ QuicLookupMaximizePartitioning(
     );
 
 //
-// Returns the connection with the given local CID, or NULL.
+// Returns the connection with the given local CID, or NULL. Hash is the
+// CxPlatHashSimple hash of the CID, as precomputed on the receive path.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
@@ -107,7 +120,8 @@ QuicLookupFindConnectionByLocalCid(
     _In_ QUIC_LOOKUP* Lookup,
     _In_reads_(CIDLen)
         const uint8_t* const CID,
-    _In_ uint8_t CIDLen
+    _In_ uint8_t CIDLen,
+    _In_ uint32_t Hash
     );
 
 //
@@ -200,3 +214,25 @@ QuicLookupMoveLocalConnectionIDs(
     _In_ QUIC_LOOKUP* LookupDest,
     _In_ QUIC_CONNECTION* Connection
     );
+
+//
+// Binds a connection to a single connection lookup without inserting any of
+// its local CIDs, so that packets for any of them are delivered to it. Fails
+// if the lookup is already used.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupAddStandbyConnection(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Unbinds a connection previously bound with QuicLookupAddStandbyConnection.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupRemoveStandbyConnection(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_CONNECTION* Connection
+    );
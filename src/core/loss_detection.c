@@ -81,13 +81,25 @@ QuicLossDetectionInitializeInternalState(
     LossDetection->TotalBytesSent = 0;
     LossDetection->TotalBytesAcked = 0;
     LossDetection->TotalBytesSentAtLastAck = 0;
+    LossDetection->DeliveryRate = 0;
     LossDetection->TimeOfLastPacketAcked = 0;
     LossDetection->TimeOfLastAckedPacketSent = 0;
     LossDetection->AdjustedLastAckedTime = 0;
     LossDetection->ProbeCount = 0;
+    LossDetection->ReorderWindowMultiplier = 0;
+    LossDetection->ReorderWindowPersist = 0;
+    LossDetection->ReorderWindowPacketNumber = 0;
 }
 
 #if DEBUG
+#define QuicSentPacketIndexValidate(Index, Bits, Packet) \
+    CXPLAT_DBG_ASSERT( \
+        (Index)->Packets == NULL || \
+        ((Packet)->PacketNumber - (Index)->Base < (Index)->Capacity && \
+         (Index)->Packets[(Packet)->PacketNumber & ((Index)->Capacity - 1)] == (Packet) && \
+         ((Bits)[((Packet)->PacketNumber & ((Index)->Capacity - 1)) / 64] & \
+            (1ull << ((Packet)->PacketNumber % 64))) != 0))
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossValidate(
@@ -98,6 +110,8 @@ QuicLossValidate(
     QUIC_SENT_PACKET_METADATA** Tail = &LossDetection->SentPackets;
     while (*Tail) {
         CXPLAT_DBG_ASSERT(!(*Tail)->Flags.Freed);
+        QuicSentPacketIndexValidate(
+            &LossDetection->PacketIndex, LossDetection->PacketIndex.SentBits, *Tail);
         if ((*Tail)->Flags.IsAckEliciting) {
             AckElicitingPackets++;
         }
@@ -109,6 +123,8 @@ QuicLossValidate(
     Tail = &LossDetection->LostPackets;
     while (*Tail) {
         CXPLAT_DBG_ASSERT(!(*Tail)->Flags.Freed);
+        QuicSentPacketIndexValidate(
+            &LossDetection->PacketIndex, LossDetection->PacketIndex.LostBits, *Tail);
         Tail = &((*Tail)->Next);
     }
     CXPLAT_DBG_ASSERT(Tail == LossDetection->LostPacketsTail);
@@ -117,6 +133,277 @@ QuicLossValidate(
 #define QuicLossValidate(LossDetection)
 #endif
 
+//
+// Returns the index of the most significant set bit. Value must be non-zero.
+//
+static
+uint32_t
+QuicSentPacketIndexHighestBit(
+    _In_ uint64_t Value
+    )
+{
+    uint32_t Bit = 0;
+    for (uint32_t Shift = 32; Shift != 0; Shift /= 2) {
+        if (Value >> Shift) {
+            Value >>= Shift;
+            Bit += Shift;
+        }
+    }
+    return Bit;
+}
+
+//
+// The size of the allocation for an index of Capacity slots: the packet
+// pointers, followed by the sent and lost bits.
+//
+#define QUIC_SENT_PACKET_INDEX_ALLOC_SIZE(Capacity) \
+    ((size_t)(Capacity) * sizeof(QUIC_SENT_PACKET_METADATA*) + \
+     2 * ((Capacity) / 64) * sizeof(uint64_t))
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSentPacketIndexFree(
+    _Inout_ QUIC_SENT_PACKET_INDEX* Index
+    )
+{
+    if (Index->Packets != NULL) {
+        QuicLibraryTrackMemory(
+            QUIC_MEMORY_TYPE_SENT_PACKET_METADATA,
+            -(int64_t)QUIC_SENT_PACKET_INDEX_ALLOC_SIZE(Index->Capacity));
+        CXPLAT_FREE(Index->Packets, QUIC_POOL_SENT_PACKET_INDEX);
+        Index->Packets = NULL;
+        Index->SentBits = NULL;
+        Index->LostBits = NULL;
+        Index->Capacity = 0;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSentPacketIndexSet(
+    _Inout_ QUIC_SENT_PACKET_INDEX* Index,
+    _Inout_ uint64_t* Bits,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(Packet->PacketNumber - Index->Base < Index->Capacity);
+    const uint32_t Slot = (uint32_t)(Packet->PacketNumber & (Index->Capacity - 1));
+    Index->Packets[Slot] = Packet;
+    Bits[Slot / 64] |= 1ull << (Slot % 64);
+}
+
+//
+// Removes the packet number from the list tracked by Bits. No-op if the index
+// isn't active.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSentPacketIndexClear(
+    _Inout_ QUIC_SENT_PACKET_INDEX* Index,
+    _Inout_opt_ uint64_t* Bits,
+    _In_ uint64_t PacketNumber
+    )
+{
+    if (Index->Packets != NULL) {
+        const uint32_t Slot = (uint32_t)(PacketNumber & (Index->Capacity - 1));
+        Bits[Slot / 64] &= ~(1ull << (Slot % 64));
+    }
+}
+
+//
+// Returns the packet with the largest packet number less than PacketNumber in
+// the list tracked by Bits, or NULL if there is none. This scans 64 packet
+// numbers at a time, so it's cheap even across large gaps.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketIndexFindPrevious(
+    _In_ const QUIC_SENT_PACKET_INDEX* Index,
+    _In_ const uint64_t* Bits,
+    _In_ uint64_t PacketNumber
+    )
+{
+    if (PacketNumber <= Index->Base) {
+        return NULL;
+    }
+
+    uint64_t Count = CXPLAT_MIN(PacketNumber - Index->Base, Index->Capacity);
+    uint32_t Slot = (uint32_t)((Index->Base + Count - 1) & (Index->Capacity - 1));
+
+    while (TRUE) {
+        //
+        // Look at the bits for the packet numbers from Slot down to the start
+        // of its word, but no further than Count packet numbers.
+        //
+        const uint32_t Available = (Slot % 64) + 1;
+        uint64_t Mask = Bits[Slot / 64];
+        if (Available < 64) {
+            Mask &= (1ull << Available) - 1;
+        }
+        if (Count < Available) {
+            Mask &= ~((1ull << (Available - Count)) - 1);
+        }
+        if (Mask != 0) {
+            return
+                Index->Packets[
+                    (Slot & ~63u) + QuicSentPacketIndexHighestBit(Mask)];
+        }
+        if (Count <= Available) {
+            return NULL;
+        }
+        Count -= Available;
+        Slot = (Slot - Available) & (Index->Capacity - 1);
+    }
+}
+
+//
+// (Re)builds the index over the current SentPackets and LostPackets lists.
+// If the lists aren't in packet number order, they span too many packet
+// numbers or memory can't be allocated, the index is left inactive and ACK
+// processing walks the lists instead.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSentPacketIndexBuild(
+    _In_ QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    QUIC_SENT_PACKET_INDEX* Index = &LossDetection->PacketIndex;
+    QuicSentPacketIndexFree(Index);
+
+    if (LossDetection->SentPackets == NULL) {
+        return;
+    }
+
+    uint64_t Base = LossDetection->SentPackets->PacketNumber;
+    for (QUIC_SENT_PACKET_METADATA* Packet = LossDetection->LostPackets;
+            Packet != NULL; Packet = Packet->Next) {
+        if (Packet->Next != NULL && Packet->Next->PacketNumber < Packet->PacketNumber) {
+            return;
+        }
+        Base = CXPLAT_MIN(Base, Packet->PacketNumber);
+    }
+
+    //
+    // Leave room for the span to double before it has to grow again.
+    //
+    const uint64_t Span = LossDetection->LargestSentPacketNumber - Base + 1;
+    uint32_t Capacity = 4 * QUIC_SENT_PACKET_INDEX_THRESHOLD;
+    while (Capacity < 2 * Span && Capacity < QUIC_SENT_PACKET_INDEX_MAX_SPAN) {
+        Capacity *= 2;
+    }
+    if (Span > Capacity) {
+        return;
+    }
+
+    const size_t BitsSize = (Capacity / 64) * sizeof(uint64_t);
+    const size_t AllocSize = QUIC_SENT_PACKET_INDEX_ALLOC_SIZE(Capacity);
+    Index->Packets = CXPLAT_ALLOC_NONPAGED(AllocSize, QUIC_POOL_SENT_PACKET_INDEX);
+    if (Index->Packets == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "sent packet index",
+            AllocSize);
+        return;
+    }
+
+    Index->SentBits = (uint64_t*)(Index->Packets + Capacity);
+    Index->LostBits = (uint64_t*)((uint8_t*)Index->SentBits + BitsSize);
+    CxPlatZeroMemory(Index->SentBits, 2 * BitsSize);
+    Index->Base = Base;
+    Index->Capacity = Capacity;
+    QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_SENT_PACKET_METADATA, (int64_t)AllocSize);
+
+    for (QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
+            Packet != NULL; Packet = Packet->Next) {
+        QuicSentPacketIndexSet(Index, Index->SentBits, Packet);
+    }
+    for (QUIC_SENT_PACKET_METADATA* Packet = LossDetection->LostPackets;
+            Packet != NULL; Packet = Packet->Next) {
+        QuicSentPacketIndexSet(Index, Index->LostBits, Packet);
+    }
+}
+
+//
+// Adds a packet just appended to the SentPackets list to the index, activating
+// the index once enough packets are outstanding.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSentPacketIndexOnPacketSent(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    QUIC_SENT_PACKET_INDEX* Index = &LossDetection->PacketIndex;
+    if (Index->Packets == NULL) {
+        if (Packet->Flags.IsAckEliciting &&
+            LossDetection->PacketsInFlight == QUIC_SENT_PACKET_INDEX_THRESHOLD) {
+            QuicSentPacketIndexBuild(LossDetection);
+        }
+        return;
+    }
+
+    if (Packet->PacketNumber - Index->Base >= Index->Capacity) {
+        //
+        // Slots are indexed by packet number alone, so moving the base up to
+        // the oldest tracked packet doesn't move anything. If that isn't
+        // enough, rebuild with a larger capacity.
+        //
+        Index->Base = LossDetection->SentPackets->PacketNumber;
+        if (LossDetection->LostPackets != NULL &&
+            LossDetection->LostPackets->PacketNumber < Index->Base) {
+            Index->Base = LossDetection->LostPackets->PacketNumber;
+        }
+        if (Packet->PacketNumber - Index->Base >= Index->Capacity) {
+            QuicSentPacketIndexBuild(LossDetection);
+            return;
+        }
+    }
+
+    QuicSentPacketIndexSet(Index, Index->SentBits, Packet);
+}
+
+//
+// Moves a packet from the SentPackets list to the LostPackets list in the
+// index, before it is appended to the LostPackets list. The index is dropped
+// if that breaks the packet number order of the LostPackets list, which can
+// only happen during the handshake.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSentPacketIndexOnPacketLost(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    QUIC_SENT_PACKET_INDEX* Index = &LossDetection->PacketIndex;
+    if (Index->Packets == NULL) {
+        return;
+    }
+
+    if (LossDetection->LostPackets != NULL) {
+        const QUIC_SENT_PACKET_METADATA* LastLostPacket =
+            CXPLAT_CONTAINING_RECORD(
+                LossDetection->LostPacketsTail, QUIC_SENT_PACKET_METADATA, Next);
+        if (LastLostPacket->PacketNumber > Packet->PacketNumber) {
+            QuicSentPacketIndexFree(Index);
+            return;
+        }
+    }
+
+    QuicSentPacketIndexClear(Index, Index->SentBits, Packet->PacketNumber);
+    QuicSentPacketIndexSet(Index, Index->LostBits, Packet);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionInitialize(
@@ -127,6 +414,8 @@ QuicLossDetectionInitialize(
     LossDetection->SentPacketsTail = &LossDetection->SentPackets;
     LossDetection->LostPackets = NULL;
     LossDetection->LostPacketsTail = &LossDetection->LostPackets;
+    CxPlatZeroMemory(&LossDetection->PacketIndex, sizeof(LossDetection->PacketIndex));
+    CxPlatZeroMemory(&LossDetection->SentPacketRing, sizeof(LossDetection->SentPacketRing));
     QuicLossDetectionInitializeInternalState(LossDetection);
 }
 
@@ -165,6 +454,9 @@ QuicLossDetectionUninitialize(
 
         QuicLossDetectionOnPacketDiscarded(LossDetection, Packet, FALSE);
     }
+
+    QuicSentPacketIndexFree(&LossDetection->PacketIndex);
+    QuicSentPacketRingUninitialize(&LossDetection->SentPacketRing);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -199,10 +491,42 @@ QuicLossDetectionReset(
         QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
     }
     LossDetection->LostPacketsTail = &LossDetection->LostPackets;
+    QuicSentPacketIndexFree(&LossDetection->PacketIndex);
 
     QuicLossValidate(LossDetection);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicLossDetectionGetMemoryUsage(
+    _In_ const QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    const QUIC_SENT_PACKET_RING* Ring = &LossDetection->SentPacketRing;
+    uint64_t Usage = 0;
+    if (Ring->Slots != NULL) {
+        Usage += QUIC_SENT_PACKET_RING_ALLOC_SIZE(Ring->SlotCount);
+    }
+    if (LossDetection->PacketIndex.Packets != NULL) {
+        Usage += QUIC_SENT_PACKET_INDEX_ALLOC_SIZE(LossDetection->PacketIndex.Capacity);
+    }
+
+    const QUIC_SENT_PACKET_METADATA* Lists[] = {
+        LossDetection->SentPackets, LossDetection->LostPackets
+    };
+    for (uint32_t i = 0; i < ARRAYSIZE(Lists); ++i) {
+        for (const QUIC_SENT_PACKET_METADATA* Packet = Lists[i];
+             Packet != NULL;
+             Packet = Packet->Next) {
+            if (!QuicSentPacketRingContains(Ring, Packet)) {
+                Usage += SIZEOF_QUIC_SENT_PACKET_METADATA(Packet->FrameCount);
+            }
+        }
+    }
+
+    return Usage;
+}
+
 //
 // Returns the oldest outstanding retransmittable packet's sent tracking
 // data structure. Returns NULL if there are no oustanding retransmittable
@@ -250,6 +574,72 @@ typedef enum QUIC_LOSS_TIMER_TYPE {
     LOSS_TIMER_PROBE
 } QUIC_LOSS_TIMER_TYPE;
 
+//
+// Returns how long after a packet is sent it is considered lost, once a later
+// packet has been acknowledged. Normally this is QUIC_TIME_REORDER_THRESHOLD,
+// but after spurious losses the reordering window is widened (RACK-TLP).
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicLossDetectionComputeReorderThreshold(
+    _In_ const QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_PATH* Path
+    )
+{
+    const uint64_t Rtt = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
+    uint64_t Threshold = QUIC_TIME_REORDER_THRESHOLD(Rtt);
+    if (LossDetection->ReorderWindowMultiplier != 0 && Path->GotFirstRttSample) {
+        const uint64_t ReorderWindow =
+            CXPLAT_MIN(
+                LossDetection->ReorderWindowMultiplier * Path->MinRtt / 4,
+                Path->SmoothedRtt);
+        Threshold = CXPLAT_MAX(Threshold, Rtt + ReorderWindow);
+    }
+    return Threshold;
+}
+
+//
+// Called when packets previously declared lost are acknowledged. Widens the
+// reordering window, at most once per round trip.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionOnSpuriousLoss(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ uint64_t LargestSpuriousPacketNumber
+    )
+{
+    if (LossDetection->ReorderWindowMultiplier == 0 ||
+        LargestSpuriousPacketNumber > LossDetection->ReorderWindowPacketNumber) {
+        if (LossDetection->ReorderWindowMultiplier < QUIC_REORDER_WINDOW_MAX_MULTIPLIER) {
+            LossDetection->ReorderWindowMultiplier++;
+        }
+        LossDetection->ReorderWindowPacketNumber = LossDetection->LargestSentPacketNumber;
+    }
+    LossDetection->ReorderWindowPersist = QUIC_REORDER_WINDOW_PERSIST;
+}
+
+//
+// Called when packets are declared lost. Resets the reordering window after
+// QUIC_REORDER_WINDOW_PERSIST round trips with loss but without a spurious
+// loss.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionDecayReorderWindow(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ uint64_t LargestLostPacketNumber
+    )
+{
+    if (LossDetection->ReorderWindowMultiplier != 0 &&
+        LargestLostPacketNumber > LossDetection->ReorderWindowPacketNumber) {
+        LossDetection->ReorderWindowPacketNumber = LossDetection->LargestSentPacketNumber;
+        if (--LossDetection->ReorderWindowPersist == 0) {
+            LossDetection->ReorderWindowMultiplier = 0;
+        }
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionUpdateTimer(
@@ -310,8 +700,9 @@ QuicLossDetectionUpdateTimer(
         // If it expires, we'll consider the packet lost.
         //
         TimeoutType = LOSS_TIMER_RACK;
-        uint64_t RttUs = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
-        TimeFires = OldestPacket->SentTime + QUIC_TIME_REORDER_THRESHOLD(RttUs);
+        TimeFires =
+            OldestPacket->SentTime +
+            QuicLossDetectionComputeReorderThreshold(LossDetection, Path);
 
     } else if (!Path->GotFirstRttSample) {
 
@@ -347,7 +738,7 @@ QuicLossDetectionUpdateTimer(
             // is an outstanding packet.
             //
             const uint64_t DisconnectTime =
-                OldestPacket->SentTime + MS_TO_US(Connection->Settings.DisconnectTimeoutMs);
+                OldestPacket->SentTime + MS_TO_US(Connection->Settings->DisconnectTimeoutMs);
             if (CxPlatTimeAtOrBefore64(DisconnectTime, TimeNow)) {
                 Delay = 0;
             } else {
@@ -392,12 +783,29 @@ QuicLossDetectionOnPacketSent(
     CXPLAT_DBG_ASSERT(TempSentPacket->FrameCount != 0);
 
     //
-    // Allocate a copy of the packet metadata.
+    // Allocate a copy of the packet metadata. 1-RTT packets use the sent
+    // packet ring, if enabled and it has room, so that they are laid out in
+    // send order.
     //
-    QUIC_SENT_PACKET_METADATA* SentPacket =
-        QuicSentPacketPoolGetPacketMetadata(
-            &Connection->Partition->SentPacketPool,
-            TempSentPacket->FrameCount);
+    QUIC_SENT_PACKET_METADATA* SentPacket = NULL;
+    if (TempSentPacket->Flags.KeyType == QUIC_PACKET_KEY_1_RTT &&
+        MsQuicLib.SentPacketRingSize != 0) {
+        if (LossDetection->SentPacketRing.Slots == NULL) {
+            (void)QuicSentPacketRingInitialize(
+                &LossDetection->SentPacketRing,
+                MsQuicLib.SentPacketRingSize);
+        }
+        SentPacket =
+            QuicSentPacketRingGetPacketMetadata(
+                &LossDetection->SentPacketRing,
+                TempSentPacket->FrameCount);
+    }
+    if (SentPacket == NULL) {
+        SentPacket =
+            QuicSentPacketPoolGetPacketMetadata(
+                &Connection->Partition->SentPacketPool,
+                TempSentPacket->FrameCount);
+    }
     if (SentPacket == NULL) {
         //
         // We can't allocate the memory to permanently track this packet so just
@@ -434,6 +842,23 @@ QuicLossDetectionOnPacketSent(
 
     Connection->Stats.Send.TotalPackets++;
     Connection->Stats.Send.TotalBytes += TempSentPacket->PacketLength;
+    QuicTraceProbe(
+        packet_sent,
+        Connection,
+        SentPacket->PacketNumber,
+        SentPacket->PacketLength);
+    if (Connection->State.QlogEnabled) {
+        QuicQlogOnPacketSent(Connection, SentPacket);
+    }
+    if (!Path->IsPeerValidated) {
+        //
+        // Every byte sent counts against amplification protection, not just
+        // the ack-eliciting ones.
+        //
+        QuicPathDecrementAllowance(
+            Connection, Path, SentPacket->PacketLength);
+    }
+
     if (SentPacket->Flags.IsAckEliciting) {
 
         if (LossDetection->PacketsInFlight == 0) {
@@ -444,15 +869,16 @@ QuicLossDetectionOnPacketSent(
         LossDetection->PacketsInFlight++;
         LossDetection->TimeOfLastPacketSent = SentPacket->SentTime;
 
-        if (!Path->IsPeerValidated) {
-            QuicPathDecrementAllowance(
-                Connection, Path, SentPacket->PacketLength);
-        }
-
         QuicCongestionControlOnDataSent(
             &Connection->CongestionControl, SentPacket->PacketLength);
+        QuicSendRateLimitConsume(
+            &Connection->SendRateLimit,
+            SentPacket->SentTime,
+            SentPacket->PacketLength);
     }
 
+    QuicSentPacketIndexOnPacketSent(LossDetection, SentPacket);
+
     uint64_t SendPostedBytes = Connection->SendBuffer.PostedBytes;
 
     CXPLAT_LIST_ENTRY* Entry = Connection->Send.SendStreams.Flink;
@@ -461,10 +887,15 @@ QuicLossDetectionOnPacketSent(
           CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink) :
           NULL;
 
-    if (SendPostedBytes < Path->Mtu &&
-        QuicCongestionControlCanSend(&Connection->CongestionControl) &&
-        !QuicCryptoHasPendingCryptoFrame(&Connection->Crypto) &&
-        (Stream && QuicStreamAllowedByPeer(Stream)) && !QuicStreamCanSendNow(Stream, FALSE)) {
+    if (QuicCongestionControlCanSend(&Connection->CongestionControl) &&
+        (Connection->Send.RateLimited ||
+         (SendPostedBytes < Path->Mtu &&
+          !QuicCryptoHasPendingCryptoFrame(&Connection->Crypto) &&
+          (Stream && QuicStreamAllowedByPeer(Stream)) && !QuicStreamCanSendNow(Stream, FALSE)))) {
+        //
+        // Either the app isn't giving us enough data or its send rate limit
+        // is holding it back; either way the network isn't the bottleneck.
+        //
         QuicCongestionControlSetAppLimited(&Connection->CongestionControl);
     }
 
@@ -528,6 +959,13 @@ QuicLossDetectionOnPacketAcknowledged(
             Connection,
             "Key change confirmed by peer");
         PacketSpace->AwaitingKeyPhaseConfirmation = FALSE;
+
+        //
+        // Pre-derive the next key phase now, off the packet processing path,
+        // so the next key update is only a pointer swap. On failure, the keys
+        // are derived on demand instead.
+        //
+        (void)QuicCryptoGenerateNewKeys(Connection);
     }
 
     for (uint8_t i = 0; i < Packet->FrameCount; i++) {
@@ -829,12 +1267,12 @@ QuicLossDetectionRetransmitFrames(
         case QUIC_FRAME_PATH_CHALLENGE: {
             uint8_t PathIndex;
             QUIC_PATH* Path = QuicConnGetPathByID(Connection, Packet->PathId, &PathIndex);
-            if (Path != NULL && !Path->IsPeerValidated) {
+            if (Path != NULL && (!Path->IsPeerValidated || Path->StandbyProbePending)) {
                 uint64_t TimeNow = CxPlatTimeUs64();
                 CXPLAT_DBG_ASSERT(Connection->Configuration != NULL);
                 uint64_t ValidationTimeout =
                     CXPLAT_MAX(QuicLossDetectionComputeProbeTimeout(LossDetection, Path, 3),
-                        6 * MS_TO_US(Connection->Settings.InitialRttMs));
+                        6 * MS_TO_US(Connection->Settings->InitialRttMs));
                 if (CxPlatTimeDiff64(Path->PathValidationStartTime, TimeNow) > ValidationTimeout) {
                     QuicTraceLogConnInfo(
                         PathValidationTimeout,
@@ -950,6 +1388,10 @@ QuicLossDetectionDetectAndHandleLostPackets(
                 PtkConnPre(Connection),
                 Packet->PacketNumber);
             LossDetection->LostPackets = Packet->Next;
+            QuicSentPacketIndexClear(
+                &LossDetection->PacketIndex,
+                LossDetection->PacketIndex.LostBits,
+                Packet->PacketNumber);
             QuicLossDetectionOnPacketDiscarded(LossDetection, Packet, TRUE);
         }
         if (LossDetection->LostPackets == NULL) {
@@ -968,9 +1410,13 @@ QuicLossDetectionDetectAndHandleLostPackets(
         // This implementation excludes kGranularity from the calculation,
         // because it is not needed to keep timers from firing early.
         //
+        // Once reordering has caused spurious losses, only the (widened) time
+        // threshold is used, as the packet threshold can't adapt to it.
+        //
         const QUIC_PATH* Path = &Connection->Paths[0]; // TODO - Correct?
-        uint64_t Rtt = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
-        uint64_t TimeReorderThreshold = QUIC_TIME_REORDER_THRESHOLD(Rtt);
+        uint64_t TimeReorderThreshold =
+            QuicLossDetectionComputeReorderThreshold(LossDetection, Path);
+        const BOOLEAN UsePacketThreshold = LossDetection->ReorderWindowMultiplier == 0;
         uint64_t LargestLostPacketNumber = 0;
         QUIC_SENT_PACKET_METADATA* PrevPacket = NULL;
         Packet = LossDetection->SentPackets;
@@ -988,7 +1434,8 @@ QuicLossDetectionDetectAndHandleLostPackets(
                 continue;
             }
 
-            if (Packet->PacketNumber + QUIC_PACKET_REORDER_THRESHOLD < LossDetection->LargestAck) {
+            if (UsePacketThreshold &&
+                Packet->PacketNumber + QUIC_PACKET_REORDER_THRESHOLD < LossDetection->LargestAck) {
                 if (!NonretransmittableHandshakePacket) {
                     QuicTraceLogVerbose(
                         PacketTxLostFack,
@@ -1028,6 +1475,10 @@ QuicLossDetectionDetectAndHandleLostPackets(
             Connection->Stats.Send.SuspectedLostPackets++;
             QuicPerfCounterIncrement(
                 Connection->Partition, QUIC_PERF_COUNTER_PKTS_SUSPECTED_LOST);
+            QuicTraceProbe(packet_lost, Connection, Packet->PacketNumber);
+            if (Connection->State.QlogEnabled) {
+                QuicQlogOnPacketLost(Connection, Packet);
+            }
             if (Packet->Flags.IsAckEliciting) {
                 LossDetection->PacketsInFlight--;
                 LostRetransmittableBytes += Packet->PacketLength;
@@ -1035,6 +1486,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
             }
 
             LargestLostPacketNumber = Packet->PacketNumber;
+            QuicSentPacketIndexOnPacketLost(LossDetection, Packet);
             if (PrevPacket == NULL) {
                 LossDetection->SentPackets = Packet->Next;
                 if (Packet->Next == NULL) {
@@ -1056,6 +1508,8 @@ QuicLossDetectionDetectAndHandleLostPackets(
         QuicLossValidate(LossDetection);
 
         if (LostRetransmittableBytes > 0) {
+            QuicLossDetectionDecayReorderWindow(LossDetection, LargestLostPacketNumber);
+
             if (LossDetection->ProbeCount > QUIC_PERSISTENT_CONGESTION_THRESHOLD) {
                 //
                 // On persistent congestion, reset the peer's packet tolerance
@@ -1122,6 +1576,10 @@ QuicLossDetectionDiscardPackets(
                     LossDetection->LostPacketsTail = &LossDetection->LostPackets;
                 }
             }
+            QuicSentPacketIndexClear(
+                &LossDetection->PacketIndex,
+                LossDetection->PacketIndex.LostBits,
+                Packet->PacketNumber);
 
             QuicTraceLogVerbose(
                 PacketTxAckedImplicit,
@@ -1166,6 +1624,10 @@ QuicLossDetectionDiscardPackets(
                     LossDetection->SentPacketsTail = &LossDetection->SentPackets;
                 }
             }
+            QuicSentPacketIndexClear(
+                &LossDetection->PacketIndex,
+                LossDetection->PacketIndex.SentBits,
+                Packet->PacketNumber);
 
             QuicTraceLogVerbose(
                 PacketTxAckedImplicit,
@@ -1259,6 +1721,10 @@ QuicLossDetectionOnZeroRttRejected(
                     LossDetection->SentPacketsTail = &LossDetection->SentPackets;
                 }
             }
+            QuicSentPacketIndexClear(
+                &LossDetection->PacketIndex,
+                LossDetection->PacketIndex.SentBits,
+                Packet->PacketNumber);
 
             QuicTraceLogVerbose(
                 PacketTx0RttRejected,
@@ -1295,6 +1761,95 @@ QuicLossDetectionOnZeroRttRejected(
     }
 }
 
+//
+// Asks the peer (via ACK_FREQUENCY) to acknowledge about every quarter of the
+// congestion window instead of every other packet, which cuts the ACK
+// processing cost on both sides at high rates. The tolerance is only updated
+// when it changes by at least a factor of two, to avoid sending a new frame
+// for every small change in the window.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionUpdatePeerPacketTolerance(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_PATH* Path
+    )
+{
+    QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
+    if (!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY)) {
+        return;
+    }
+
+    uint32_t Target =
+        QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl) /
+        QuicPathGetDatagramPayloadSize(Path) /
+        QUIC_ACK_FREQUENCY_CWND_DIVISOR;
+    Target = CXPLAT_MAX(Target, QUIC_MIN_ACK_SEND_NUMBER);
+    Target = CXPLAT_MIN(Target, UINT8_MAX);
+
+    const uint32_t Current = Connection->PeerPacketTolerance;
+    if (Target >= 2 * Current || 2 * Target <= Current) {
+        QuicConnUpdatePeerPacketTolerance(Connection, (uint8_t)Target);
+    }
+}
+
+//
+// Takes the delivery rate sample for an ACK from the most recently sent packet
+// it acknowledges. Samples from app-limited packets only reflect how fast the
+// app was sending, so they only replace the estimate if they are higher.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionOnDeliveryRateSample(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet,
+    _Inout_ QUIC_ACK_EVENT* AckEvent
+    )
+{
+    const uint64_t DeliveryRate =
+        QuicCongestionControlSampleDeliveryRate(Packet, AckEvent);
+    if (DeliveryRate == UINT64_MAX) {
+        return;
+    }
+
+    AckEvent->DeliveryRate = DeliveryRate;
+    AckEvent->IsDeliveryRateAppLimited = Packet->Flags.IsAppLimited;
+
+    if (!Packet->Flags.IsAppLimited || DeliveryRate > LossDetection->DeliveryRate) {
+        LossDetection->DeliveryRate = DeliveryRate;
+    }
+}
+
+//
+// Returns the peer's receive time for the packet number from the receive
+// timestamps (in descending packet number order) of an ACK frame, or
+// UINT64_MAX if it wasn't reported.
+//
+static
+uint64_t
+QuicLossDetectionFindReceiveTimestamp(
+    _In_reads_(TimestampCount)
+        const QUIC_ACK_RECEIVE_TIMESTAMP* Timestamps,
+    _In_ uint32_t TimestampCount,
+    _In_ uint64_t PacketNumber
+    )
+{
+    uint32_t Low = 0;
+    uint32_t High = TimestampCount;
+    while (Low < High) {
+        const uint32_t Mid = Low + (High - Low) / 2;
+        if (Timestamps[Mid].PacketNumber == PacketNumber) {
+            return Timestamps[Mid].RecvTime;
+        }
+        if (Timestamps[Mid].PacketNumber > PacketNumber) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
+        }
+    }
+    return UINT64_MAX;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionProcessAckBlocks(
@@ -1305,7 +1860,10 @@ QuicLossDetectionProcessAckBlocks(
     _In_ uint64_t AckDelay,
     _In_ QUIC_RANGE* AckBlocks,
     _Out_ BOOLEAN* InvalidAckBlock,
-    _In_opt_ QUIC_ACK_ECN_EX* Ecn
+    _In_opt_ QUIC_ACK_ECN_EX* Ecn,
+    _In_reads_(TimestampCount)
+        const QUIC_ACK_RECEIVE_TIMESTAMP* Timestamps,
+    _In_ uint32_t TimestampCount
     )
 {
     QUIC_SENT_PACKET_METADATA* AckedPackets = NULL;
@@ -1319,6 +1877,17 @@ QuicLossDetectionProcessAckBlocks(
     BOOLEAN NewLargestAckRetransmittable = FALSE;
     BOOLEAN NewLargestAckDifferentPath = FALSE;
     uint64_t NewLargestAckTimestamp = 0;
+    uint64_t NewLargestAckPacketNumber = 0;
+
+    //
+    // Use the time the datapath received the ACK, if known, for RTT and
+    // delivery rate samples so time spent queued for the worker doesn't
+    // inflate them. It never moves back past the previous ACK's time.
+    //
+    uint64_t AckTime = TimeNow;
+    if (Packet->RecvTime != 0 && CxPlatTimeAtOrBefore64(Packet->RecvTime, TimeNow)) {
+        AckTime = CXPLAT_MAX(Packet->RecvTime, LossDetection->TimeOfLastPacketAcked);
+    }
 
     *InvalidAckBlock = FALSE;
 
@@ -1326,6 +1895,13 @@ QuicLossDetectionProcessAckBlocks(
     QUIC_SENT_PACKET_METADATA** SentPacketsStart = &LossDetection->SentPackets;
     QUIC_SENT_PACKET_METADATA* LargestAckedPacket = NULL;
 
+    //
+    // When many packets are outstanding, the packet number index finds where
+    // each ACK block starts in the lists, instead of walking up to it.
+    //
+    QUIC_SENT_PACKET_INDEX* Index = &LossDetection->PacketIndex;
+    uint64_t LargestSpuriousPacketNumber = UINT64_MAX;
+
     uint32_t i = 0;
     QUIC_SUBRANGE* AckBlock;
     while ((AckBlock = QuicRangeGetSafe(AckBlocks, i++)) != NULL) {
@@ -1358,6 +1934,12 @@ QuicLossDetectionProcessAckBlocks(
             if (LastLostPacket->PacketNumber < AckBlock->Low) {
                 goto CheckSentPackets;
             }
+            if (Index->Packets != NULL) {
+                QUIC_SENT_PACKET_METADATA* PrevPacket =
+                    QuicSentPacketIndexFindPrevious(Index, Index->LostBits, AckBlock->Low);
+                LostPacketsStart =
+                    PrevPacket == NULL ? &LossDetection->LostPackets : &PrevPacket->Next;
+            }
             while (*LostPacketsStart && (*LostPacketsStart)->PacketNumber < AckBlock->Low) {
                 LostPacketsStart = &((*LostPacketsStart)->Next);
             }
@@ -1370,8 +1952,10 @@ QuicLossDetectionProcessAckBlocks(
                     PtkConnPre(Connection),
                     (*End)->PacketNumber);
                 Connection->Stats.Send.SpuriousLostPackets++;
+                LargestSpuriousPacketNumber = (*End)->PacketNumber;
                 QuicPerfCounterDecrement(
                     Connection->Partition, QUIC_PERF_COUNTER_PKTS_SUSPECTED_LOST);
+                QuicSentPacketIndexClear(Index, Index->LostBits, (*End)->PacketNumber);
                 //
                 // NOTE: we don't increment AckedRetransmittableBytes here
                 // because we already told the congestion control module that
@@ -1412,6 +1996,12 @@ CheckSentPackets:
         // Now find all the acknowledged packets in the SentPackets list.
         //
         if (*SentPacketsStart != NULL) {
+            if (Index->Packets != NULL) {
+                QUIC_SENT_PACKET_METADATA* PrevPacket =
+                    QuicSentPacketIndexFindPrevious(Index, Index->SentBits, AckBlock->Low);
+                SentPacketsStart =
+                    PrevPacket == NULL ? &LossDetection->SentPackets : &PrevPacket->Next;
+            }
             while (*SentPacketsStart && (*SentPacketsStart)->PacketNumber < AckBlock->Low) {
                 SentPacketsStart = &((*SentPacketsStart)->Next);
             }
@@ -1423,6 +2013,7 @@ CheckSentPackets:
                     LossDetection->PacketsInFlight--;
                     AckedRetransmittableBytes += (*End)->PacketLength;
                 }
+                QuicSentPacketIndexClear(Index, Index->SentBits, (*End)->PacketNumber);
                 LargestAckedPacket = *End;
                 End = &((*End)->Next);
             }
@@ -1453,9 +2044,21 @@ CheckSentPackets:
             NewLargestAckRetransmittable = LargestAckedPacket->Flags.IsAckEliciting;
             NewLargestAckDifferentPath = Path->ID != LargestAckedPacket->PathId;
             NewLargestAckTimestamp = LargestAckedPacket->SentTime;
+            NewLargestAckPacketNumber = LargestAckedPacket->PacketNumber;
         }
     }
 
+    if (LargestSpuriousPacketNumber != UINT64_MAX) {
+        QuicLossDetectionOnSpuriousLoss(LossDetection, LargestSpuriousPacketNumber);
+    }
+
+    if (LossDetection->SentPackets == NULL && LossDetection->LostPackets == NULL) {
+        //
+        // Nothing is outstanding, so release the index until it's needed again.
+        //
+        QuicSentPacketIndexFree(Index);
+    }
+
     if (AckedPackets == NULL) {
         //
         // Nothing was acknowledged, so we can exit now.
@@ -1465,7 +2068,10 @@ CheckSentPackets:
 
     uint64_t LargestAckedPacketNum = 0;
     BOOLEAN IsLargestAckedPacketAppLimited = FALSE;
+    const QUIC_SENT_PACKET_METADATA* RateSamplePacket = NULL;
     int64_t EcnEctCounter = 0;
+    uint32_t NewEcnPackets = 0;
+    uint32_t NewEcnCePackets = 0;
     QUIC_SENT_PACKET_METADATA* AckedPacketsIterator = AckedPackets;
 
     while (AckedPacketsIterator != NULL) {
@@ -1486,7 +2092,10 @@ CheckSentPackets:
             return;
         }
 
-        uint64_t PacketRtt = CxPlatTimeDiff64(PacketMeta->SentTime, TimeNow);
+        uint64_t PacketRtt =
+            CxPlatTimeDiff64(
+                PacketMeta->SentTime,
+                CxPlatTimeAtOrBefore64(PacketMeta->SentTime, AckTime) ? AckTime : TimeNow);
         QuicTraceLogVerbose(
             PacketTxAcked,
             "[%c][TX][%llu] ACKed (%u.%03u ms)",
@@ -1508,8 +2117,14 @@ CheckSentPackets:
             IsLargestAckedPacketAppLimited = PacketMeta->Flags.IsAppLimited;
         }
 
+        if (PacketMeta->PacketLength != 0 &&
+            (RateSamplePacket == NULL ||
+             RateSamplePacket->PacketNumber < PacketMeta->PacketNumber)) {
+            RateSamplePacket = PacketMeta;
+        }
+
         EcnEctCounter += PacketMeta->Flags.EcnEctSet;
-        QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, PacketMeta, FALSE, TimeNow, AckDelay);
+        QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, PacketMeta, FALSE, AckTime, AckDelay);
     }
 
     QuicLossValidate(LossDetection);
@@ -1527,13 +2142,26 @@ CheckSentPackets:
             MinRtt -= AckDelay;
         }
 
+        //
+        // The one-way delay is sampled from the peer's receive time of the
+        // packet when the ACK frame reported it, which (unlike the time the
+        // peer sent the ACK) doesn't include how long the peer delayed it.
+        //
+        uint64_t PeerTimestamp =
+            QuicLossDetectionFindReceiveTimestamp(
+                Timestamps, TimestampCount, NewLargestAckPacketNumber);
+        if (PeerTimestamp == UINT64_MAX) {
+            PeerTimestamp = Packet->SendTimestamp;
+        }
+
         CXPLAT_DBG_ASSERT(NewLargestAckTimestamp != 0);
         QuicConnUpdateRtt(
             Connection,
             Path,
             MinRtt,
-            NewLargestAckTimestamp - Connection->Stats.Timing.Start,
-            Packet->SendTimestamp);
+            PeerTimestamp == UINT64_MAX ?
+                UINT64_MAX : NewLargestAckTimestamp - Connection->Stats.Timing.Start,
+            PeerTimestamp);
     }
 
     if (NewLargestAck) {
@@ -1546,8 +2174,17 @@ CheckSentPackets:
             BOOLEAN EcnValidated = TRUE;
             int64_t EctCeDeltaSum = 0;
             if (Ecn != NULL) {
+                //
+                // Packets are marked with the congestion control algorithm's
+                // ECT codepoint, except probes, which are always ECT(0), so
+                // each codepoint's count is checked against how many packets
+                // were sent with it.
+                //
+                const uint64_t EctCount = Ecn->ECT_0_Count + Ecn->ECT_1_Count;
+                const uint64_t SentWithEct0 =
+                    Connection->Send.NumPacketsSentWithEct - Connection->Send.NumPacketsSentWithEct1;
                 EctCeDeltaSum += Ecn->CE_Count - Packets->EcnCeCounter;
-                EctCeDeltaSum += Ecn->ECT_0_Count - Packets->EcnEctCounter;
+                EctCeDeltaSum += EctCount - Packets->EcnEctCounter;
                 //
                 // Conditions where ECN validation fails:
                 // 1. Reneging ECN counts from the peer.
@@ -1555,13 +2192,15 @@ CheckSentPackets:
                 //
                 if (EctCeDeltaSum < 0 ||
                     EctCeDeltaSum < EcnEctCounter ||
-                    Ecn->ECT_1_Count != 0 ||
-                    Connection->Send.NumPacketsSentWithEct < Ecn->ECT_0_Count) {
+                    Connection->Send.NumPacketsSentWithEct1 < Ecn->ECT_1_Count ||
+                    SentWithEct0 < Ecn->ECT_0_Count) {
                     EcnValidated = FALSE;
                 } else {
                     BOOLEAN NewCE = Ecn->CE_Count > Packets->EcnCeCounter;
+                    NewEcnPackets = (uint32_t)EctCeDeltaSum;
+                    NewEcnCePackets = (uint32_t)(Ecn->CE_Count - Packets->EcnCeCounter);
                     Packets->EcnCeCounter = Ecn->CE_Count;
-                    Packets->EcnEctCounter = Ecn->ECT_0_Count;
+                    Packets->EcnEctCounter = EctCount;
                     if (Path->EcnValidationState <= ECN_VALIDATION_UNKNOWN) {
                         Path->EcnValidationState = ECN_VALIDATION_CAPABLE;
                         QuicTraceEvent(
@@ -1616,7 +2255,7 @@ CheckSentPackets:
     if (NewLargestAck || AckedRetransmittableBytes > 0) {
         QUIC_ACK_EVENT AckEvent = {
             .IsImplicit = FALSE,
-            .TimeNow = TimeNow,
+            .TimeNow = AckTime,
             .LargestAck = LossDetection->LargestAck,
             .LargestSentPacketNumber = LossDetection->LargestSentPacketNumber,
             .NumRetransmittableBytes = AckedRetransmittableBytes,
@@ -1624,19 +2263,30 @@ CheckSentPackets:
             .MinRtt = MinRtt,
             .OneWayDelay = Path->OneWayDelay,
             .HasLoss = (LossDetection->LostPackets != NULL),
-            .AdjustedAckTime = TimeNow - AckDelay,
+            .AdjustedAckTime = AckTime - AckDelay,
             .AckedPackets = AckedPackets,
             .NumTotalAckedRetransmittableBytes = LossDetection->TotalBytesAcked,
+            .EcnPackets = NewEcnPackets,
+            .EcnCePackets = NewEcnCePackets,
             .IsLargestAckedPacketAppLimited = IsLargestAckedPacketAppLimited,
             .MinRttValid = TRUE,
         };
 
+        if (RateSamplePacket != NULL) {
+            QuicLossDetectionOnDeliveryRateSample(
+                LossDetection, RateSamplePacket, &AckEvent);
+        }
+
         if (QuicCongestionControlOnDataAcknowledged(&Connection->CongestionControl, &AckEvent)) {
             //
             // We were previously blocked and are now unblocked.
             //
             QuicSendQueueFlush(&Connection->Send, REASON_CONGESTION_CONTROL);
         }
+
+        if (EncryptLevel == QUIC_ENCRYPT_LEVEL_1_RTT) {
+            QuicLossDetectionUpdatePeerPacketTolerance(LossDetection, Path);
+        }
     }
 
     LossDetection->ProbeCount = 0;
@@ -1679,10 +2329,15 @@ QuicLossDetectionProcessAckFrame(
 
     uint64_t AckDelay; // microsec
     QUIC_ACK_ECN_EX Ecn;
+    QUIC_ACK_RECEIVE_TIMESTAMP Timestamps[QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+    uint32_t TimestampCount = 0;
 
+    //
+    // ACK_RECEIVE_TIMESTAMPS starts like an ACK frame without ECN counts.
+    //
     BOOLEAN Result =
         QuicAckFrameDecode(
-            FrameType,
+            FrameType == QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS ? QUIC_FRAME_ACK : FrameType,
             BufferLength,
             Buffer,
             Offset,
@@ -1691,6 +2346,21 @@ QuicLossDetectionProcessAckFrame(
             &Ecn,
             &AckDelay);
 
+    if (Result && FrameType == QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS) {
+        if (!QuicAckReceiveTimestampsDecode(
+                BufferLength,
+                Buffer,
+                Offset,
+                QuicRangeGetMax(&Connection->DecodedAckRanges),
+                (uint8_t)Connection->PeerTransportParams.ReceiveTimestampsExponent,
+                ARRAYSIZE(Timestamps),
+                Timestamps,
+                &TimestampCount)) {
+            *InvalidFrame = TRUE;
+            Result = FALSE;
+        }
+    }
+
     if (Result) {
 
         uint64_t Largest;
@@ -1716,7 +2386,12 @@ QuicLossDetectionProcessAckFrame(
                 AckDelay,
                 &Connection->DecodedAckRanges,
                 InvalidFrame,
-                FrameType == QUIC_FRAME_ACK_1 ? &Ecn : NULL);
+                FrameType == QUIC_FRAME_ACK_1 ? &Ecn : NULL,
+                Timestamps,
+                TimestampCount);
+            if (Connection->State.QlogEnabled) {
+                QuicQlogOnMetricsUpdated(Connection, Path);
+            }
         }
     }
 
@@ -1763,6 +2438,15 @@ QuicLossDetectionScheduleProbe(
     Connection->Send.TailLossProbeNeeded = TRUE;
 
     if (Connection->Crypto.TlsState.WriteKey == QUIC_PACKET_KEY_1_RTT) {
+        if (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) {
+            //
+            // The peer may be delaying ACKs for up to PeerPacketTolerance
+            // packets, so explicitly ask for the probe to be acknowledged
+            // right away.
+            //
+            QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK);
+        }
+
         //
         // Check to see if any streams have fresh data to send out.
         //
@@ -1852,7 +2536,7 @@ QuicLossDetectionProcessTimerOperation(
 
     if (OldestPacket != NULL &&
         CxPlatTimeDiff64(OldestPacket->SentTime, TimeNow) >=
-            MS_TO_US((uint64_t)Connection->Settings.DisconnectTimeoutMs)) {
+            MS_TO_US((uint64_t)Connection->Settings->DisconnectTimeoutMs)) {
         //
         // OldestPacket has been in the SentPackets list for at least
         // DisconnectTimeoutUs without an ACK for either OldestPacket or for any
@@ -1873,6 +2557,15 @@ QuicLossDetectionProcessTimerOperation(
         //
         if (!QuicLossDetectionDetectAndHandleLostPackets(LossDetection, TimeNow)) {
             QuicLossDetectionScheduleProbe(LossDetection);
+
+            if (LossDetection->ProbeCount >= QUIC_STANDBY_PATH_FAILOVER_PROBE_COUNT &&
+                QuicConnFailoverToStandbyPath(Connection)) {
+                //
+                // The active path looks dead. The probes just scheduled go
+                // out on the new path, so restart the backoff with its RTT.
+                //
+                LossDetection->ProbeCount = 0;
+            }
         }
 
         QuicLossDetectionUpdateTimer(LossDetection, FALSE);
@@ -5,6 +5,35 @@
 
 --*/
 
+//
+// Maps packet numbers to the packets in the SentPackets and LostPackets lists,
+// so that processing an ACK block can find where it starts in each list
+// without walking every packet in front of it.
+//
+typedef struct QUIC_SENT_PACKET_INDEX {
+
+    //
+    // Capacity slots, indexed by packet number modulo Capacity. NULL if the
+    // index isn't active.
+    //
+    QUIC_SENT_PACKET_METADATA** Packets;
+
+    //
+    // A bit per slot, set if the slot's packet is in the SentPackets or the
+    // LostPackets list respectively.
+    //
+    uint64_t* SentBits;
+    uint64_t* LostBits;
+
+    //
+    // All packets in both lists have packet numbers in the range
+    // [Base, Base + Capacity).
+    //
+    uint64_t Base;
+    uint32_t Capacity; // power of 2
+
+} QUIC_SENT_PACKET_INDEX;
+
 typedef struct QUIC_LOSS_DETECTION {
 
     //
@@ -57,6 +86,12 @@ typedef struct QUIC_LOSS_DETECTION {
     //
     uint64_t TotalBytesSentAtLastAck;
 
+    //
+    // Delivery rate estimate, in bits per second, from the most recently sent
+    // packet of each ACK. Zero until the first sample.
+    //
+    uint64_t DeliveryRate;
+
     //
     // N.B.: SentPackets and LostPackets are generally kept in ascending packet
     // number order, and packets in the LostPackets list generally have smaller
@@ -82,11 +117,37 @@ typedef struct QUIC_LOSS_DETECTION {
     QUIC_SENT_PACKET_METADATA* LostPackets;
     QUIC_SENT_PACKET_METADATA** LostPacketsTail;
 
+    //
+    // Packet number index over SentPackets and LostPackets. Only active while
+    // many packets are outstanding and both lists are in packet number order.
+    //
+    QUIC_SENT_PACKET_INDEX PacketIndex;
+
+    //
+    // Contiguous storage for the metadata of 1-RTT packets, if enabled via
+    // QUIC_PARAM_GLOBAL_SENT_PACKET_RING_SIZE. Allocated on first use.
+    //
+    QUIC_SENT_PACKET_RING SentPacketRing;
+
     //
     // Number of probes sent.
     //
     uint16_t ProbeCount;
 
+    //
+    // Adaptive reordering window, in quarters of the min RTT. Zero until a
+    // spurious loss is detected. ReorderWindowPersist counts down the round
+    // trips with loss, but no spurious loss, left before it resets.
+    //
+    uint8_t ReorderWindowMultiplier;
+    uint8_t ReorderWindowPersist;
+
+    //
+    // The largest packet sent when the reordering window was last updated.
+    // It is updated at most once per round trip.
+    //
+    uint64_t ReorderWindowPacketNumber;
+
 } QUIC_LOSS_DETECTION;
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -107,6 +168,15 @@ QuicLossDetectionReset(
     _In_ QUIC_LOSS_DETECTION* LossDetection
     );
 
+//
+// Returns the bytes allocated to track the outstanding and lost packets.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicLossDetectionGetMemoryUsage(
+    _In_ const QUIC_LOSS_DETECTION* LossDetection
+    );
+
 //
 // Called when a particular key type has been discarded. This removes
 // the tracking for all related outstanding packets.
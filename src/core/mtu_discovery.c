@@ -15,17 +15,21 @@ Abstract:
     reached.
 
     If a probe packet is not ACKed, the probe at the same size will be retried.
-    If this fails QUIC_DPLPMTUD_MAX_PROBES times, max MTU is considered found
-    and searching stops.
+    If this fails QUIC_DPLPMTUD_MAX_PROBES times, that size is considered too
+    big and bounds the search from above.
 
     Once searching has stopped, discovery will stay idle until
     QUIC_DPLPMTUD_RAISE_TIMER_TIMEOUT has passed. The next send will then
     trigger a new MTU discovery period, unless maximum allowed MTU is already
     reached.
 
-    The current algorithm is very simplistic, increasing by 80 bytes each
-    probe. A special case is added so 1500 is always a checked value, as 1500
-    is often the max allowed over the internet.
+    The first probe is for the maximum allowed MTU, which already accounts for
+    the MTU the datapath reports for the local interface, so paths that
+    support it (e.g. jumbo frames in a datacenter) reach it in a single round
+    trip. If that is lost, 1280 and 1500 are probed next, as those are the
+    most common limits, and then the search is a binary one between the
+    current MTU and the smallest lost probe size, until the two are within
+    QUIC_DPLPMTUD_INCREMENT bytes of each other.
 
 --*/
 
@@ -77,33 +81,33 @@ QuicGetNextProbeSize(
     QUIC_PATH* Path =
         CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
     //
-    // N.B. This algorithm must always be increasing. Other logic in the module
-    // depends on that behavior.
+    // N.B. This algorithm must always return a size larger than the current
+    // MTU, or the current MTU if there is nothing left worth probing. Other
+    // logic in the module depends on that behavior.
     //
 
     //
-    // Jump automatically to 1280 to return algorithm to ideal case. 1280 should
-    // be supported in most scenarios. With minimum being 1248, this will always
-    // be less then a full increment.
+    // Until a probe is lost, optimistically try the maximum allowed.
     //
-    if (Path->Mtu < 1280) {
-        return CXPLAT_MIN(1280, MtuDiscovery->MaxMtu);
-    }
-
-    uint16_t Mtu = Path->Mtu + QUIC_DPLPMTUD_INCREMENT;
-    if (Mtu > MtuDiscovery->MaxMtu) {
-        Mtu = MtuDiscovery->MaxMtu;
+    if (MtuDiscovery->SearchHigh == 0) {
+        return MtuDiscovery->MaxMtu;
     }
 
     //
-    // Our increasing algorithm might not hit 1500 by default. Ensure that
-    // happens.
+    // 1280 and 1500 are the most likely limits, so check them before
+    // bisecting.
     //
-    if (!MtuDiscovery->HasProbed1500 && Mtu >= 1500) {
-        MtuDiscovery->HasProbed1500 = TRUE;
-        Mtu = 1500;
+    if (Path->Mtu < 1280 && MtuDiscovery->SearchHigh > 1280) {
+        return 1280;
     }
-    return Mtu;
+    if (Path->Mtu < 1500 && MtuDiscovery->SearchHigh > 1500) {
+        return 1500;
+    }
+
+    if (MtuDiscovery->SearchHigh - Path->Mtu <= QUIC_DPLPMTUD_INCREMENT) {
+        return Path->Mtu;
+    }
+    return Path->Mtu + (MtuDiscovery->SearchHigh - Path->Mtu) / 2;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -115,6 +119,13 @@ QuicMtuDiscoveryMoveToSearching(
 {
     QUIC_PATH* Path =
         CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
+    if (MtuDiscovery->IsSearchComplete) {
+        //
+        // Searching again after the raise timer, so the path may now allow
+        // more than it did before.
+        //
+        MtuDiscovery->SearchHigh = 0;
+    }
     MtuDiscovery->IsSearchComplete = FALSE;
     MtuDiscovery->ProbeCount = 0;
     //
@@ -127,7 +138,7 @@ QuicMtuDiscoveryMoveToSearching(
 
     //
     // If we're attempting to probe the current MTU, and min MTU is validated
-    // then we've hit max allowed MTU. Enter search complete.
+    // then we've found the max MTU. Enter search complete.
     //
     if (MtuDiscovery->ProbeSize == Path->Mtu && Path->IsMinMtuValidated) {
         QuicMtuDiscoveryMoveToSearchComplete(MtuDiscovery, Connection);
@@ -161,7 +172,7 @@ QuicMtuDiscoveryPeerValidated(
     // default
     //
     MtuDiscovery->MaxMtu = QuicConnGetMaxMtuForPath(Connection, Path);
-    MtuDiscovery->HasProbed1500 = Path->Mtu >= 1500;
+    MtuDiscovery->SearchHigh = 0;
     CXPLAT_DBG_ASSERT(Path->Mtu <= MtuDiscovery->MaxMtu);
 
     QuicTraceLogConnInfo(
@@ -253,12 +264,18 @@ QuicMtuDiscoveryProbePacketDiscarded(
         MtuDiscovery->ProbeCount);
 
     //
-    // If we've done max probes, we've found our max, enter search complete
-    // waiting phase. Otherwise send out another probe of the same size.
+    // If we've done max probes, this size is too big. Continue the search
+    // below it, or enter search complete waiting phase if it was the minimum
+    // MTU that failed. Otherwise send out another probe of the same size.
     //
     if (MtuDiscovery->ProbeCount >=
-            (int16_t)Connection->Settings.MtuDiscoveryMissingProbeCount - 1) {
-        QuicMtuDiscoveryMoveToSearchComplete(MtuDiscovery, Connection);
+            (int16_t)Connection->Settings->MtuDiscoveryMissingProbeCount - 1) {
+        if (MtuDiscovery->ProbeSize == Path->Mtu) {
+            QuicMtuDiscoveryMoveToSearchComplete(MtuDiscovery, Connection);
+        } else {
+            MtuDiscovery->SearchHigh = MtuDiscovery->ProbeSize;
+            QuicMtuDiscoveryMoveToSearching(MtuDiscovery, Connection);
+        }
         return;
     }
     MtuDiscovery->ProbeCount++;
@@ -22,6 +22,12 @@ typedef struct QUIC_MTU_DISCOVERY {
     //
     uint16_t ProbeSize;
 
+    //
+    // The smallest probe size that has been lost, which bounds the search
+    // from above. Zero if no probe has been lost in the current search.
+    //
+    uint16_t SearchHigh;
+
     //
     // The amount of probes that have occured at the current size.
     //
@@ -32,11 +38,6 @@ typedef struct QUIC_MTU_DISCOVERY {
     //
     BOOLEAN IsSearchComplete    : 1;
 
-    //
-    // Check for has 1500 been probed to ensure its tested.
-    //
-    BOOLEAN HasProbed1500       : 1;
-
 } QUIC_MTU_DISCOVERY;
 
 //
@@ -20,6 +20,11 @@ Abstract:
     is the only thread that touches the connection itself, which simplifies
     synchronization.
 
+    Enqueuing is lock-free: producers push onto per-lane inbox stacks, which
+    the worker thread moves into its private list as it dequeues. Redundant
+    flush operations are coalesced before they get here, by the flags that
+    track whether one is already queued (e.g. Send.FlushOperationPending).
+
 --*/
 
 #include "precomp.h"
@@ -34,7 +39,9 @@ QuicOperationQueueInitialize(
     )
 {
     OperQ->ActivelyProcessing = FALSE;
-    CxPlatDispatchLockInitialize(&OperQ->Lock);
+    OperQ->FrontInbox = NULL;
+    OperQ->PriorityInbox = NULL;
+    OperQ->Inbox = NULL;
     CxPlatListInitializeHead(&OperQ->List);
     OperQ->PriorityTail = &OperQ->List.Flink;
 }
@@ -48,7 +55,9 @@ QuicOperationQueueUninitialize(
     UNREFERENCED_PARAMETER(OperQ);
     CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&OperQ->List));
     CXPLAT_DBG_ASSERT(OperQ->PriorityTail == &OperQ->List.Flink);
-    CxPlatDispatchLockUninitialize(&OperQ->Lock);
+    CXPLAT_DBG_ASSERT(OperQ->FrontInbox == NULL);
+    CXPLAT_DBG_ASSERT(OperQ->PriorityInbox == NULL);
+    CXPLAT_DBG_ASSERT(OperQ->Inbox == NULL);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -129,6 +138,20 @@ QuicOperationFree(
                     QUIC_POOL_RECVBUF);
             }
             QuicStreamRelease(ApiCtx->STRM_PROVIDE_RECV_BUFFERS.Stream, QUIC_STREAM_REF_OPERATION);
+        } else if (ApiCtx->Type == QUIC_API_TYPE_CONN_SEND_BATCH) {
+            for (uint32_t i = 0; i < ApiCtx->CONN_SEND_BATCH.StreamCount; ++i) {
+                QuicStreamRelease(ApiCtx->CONN_SEND_BATCH.Streams[i], QUIC_STREAM_REF_OPERATION);
+            }
+            if (ApiCtx->CONN_SEND_BATCH.Streams != NULL) {
+                CXPLAT_FREE(ApiCtx->CONN_SEND_BATCH.Streams, QUIC_POOL_SEND_BATCH);
+            }
+        } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_START_BATCH) {
+            for (uint32_t i = 0; i < ApiCtx->STRM_START_BATCH.StreamCount; ++i) {
+                QuicStreamRelease(ApiCtx->STRM_START_BATCH.Streams[i], QUIC_STREAM_REF_OPERATION);
+            }
+            if (ApiCtx->STRM_START_BATCH.Streams != NULL) {
+                CXPLAT_FREE(ApiCtx->STRM_START_BATCH.Streams, QUIC_POOL_SEND_BATCH);
+            }
         }
         CxPlatPoolFree(ApiCtx);
     } else if (Oper->Type == QUIC_OPER_TYPE_FLUSH_STREAM_RECV) {
@@ -141,27 +164,126 @@ QuicOperationFree(
     CxPlatPoolFree(Oper);
 }
 
+//
+// Pushes the operation onto one of the queue's inboxes. Returns TRUE if the
+// inbox was previously empty and the queue isn't being drained.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
+static
 BOOLEAN
-QuicOperationEnqueue(
+QuicOperationPush(
     _In_ QUIC_OPERATION_QUEUE* OperQ,
+    _Inout_ CXPLAT_LIST_ENTRY* volatile* Inbox,
     _In_ QUIC_PARTITION* Partition,
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
 #if DEBUG
     CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertTail(&OperQ->List, &Oper->Link);
-    CxPlatDispatchLockRelease(&OperQ->Lock);
+    CXPLAT_LIST_ENTRY* Head;
+    do {
+        Head = (CXPLAT_LIST_ENTRY*)QuicReadPtrNoFence((void**)Inbox);
+        Oper->Link.Flink = Head;
+    } while (InterlockedCompareExchangePointer(
+                (void* volatile*)Inbox, &Oper->Link, Head) != Head);
+
+    //
+    // The compare-exchange is a full barrier, so either this read sees the
+    // consumer has stopped draining, or the consumer's final check of the
+    // inboxes (after it stops) sees this operation.
+    //
+    const BOOLEAN StartProcessing =
+        Head == NULL && !*(volatile BOOLEAN*)&OperQ->ActivelyProcessing;
+
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
     return StartProcessing;
 }
 
+//
+// Takes everything in the inbox, oldest first, as a NULL terminated chain.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+CXPLAT_LIST_ENTRY*
+QuicOperationInboxTake(
+    _Inout_ CXPLAT_LIST_ENTRY* volatile* Inbox
+    )
+{
+    if (QuicReadPtrNoFence((void**)Inbox) == NULL) {
+        return NULL;
+    }
+
+    CXPLAT_LIST_ENTRY* Entry =
+        (CXPLAT_LIST_ENTRY*)InterlockedExchangePointer((void* volatile*)Inbox, NULL);
+    CXPLAT_LIST_ENTRY* Chain = NULL;
+    while (Entry != NULL) {
+        CXPLAT_LIST_ENTRY* Next = Entry->Flink;
+        Entry->Flink = Chain;
+        Chain = Entry;
+        Entry = Next;
+    }
+    return Chain;
+}
+
+//
+// Moves the operations in the inboxes into the consumer's list, in the same
+// order the lock protected queue would have had them. Returns TRUE if any were
+// moved.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+BOOLEAN
+QuicOperationQueueCollect(
+    _In_ QUIC_OPERATION_QUEUE* OperQ
+    )
+{
+    BOOLEAN Collected = FALSE;
+    CXPLAT_LIST_ENTRY* Entry;
+
+    Entry = QuicOperationInboxTake(&OperQ->FrontInbox);
+    while (Entry != NULL) {
+        CXPLAT_LIST_ENTRY* Next = Entry->Flink;
+        CxPlatListInsertHead(&OperQ->List, Entry);
+        if (OperQ->PriorityTail == &OperQ->List.Flink) {
+            OperQ->PriorityTail = &Entry->Flink;
+        }
+        Collected = TRUE;
+        Entry = Next;
+    }
+
+    Entry = QuicOperationInboxTake(&OperQ->PriorityInbox);
+    while (Entry != NULL) {
+        CXPLAT_LIST_ENTRY* Next = Entry->Flink;
+        CxPlatListInsertTail(*OperQ->PriorityTail, Entry);
+        OperQ->PriorityTail = &Entry->Flink;
+        Collected = TRUE;
+        Entry = Next;
+    }
+
+    Entry = QuicOperationInboxTake(&OperQ->Inbox);
+    while (Entry != NULL) {
+        CXPLAT_LIST_ENTRY* Next = Entry->Flink;
+        CxPlatListInsertTail(&OperQ->List, Entry);
+        Collected = TRUE;
+        Entry = Next;
+    }
+
+    return Collected;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicOperationEnqueue(
+    _In_ QUIC_OPERATION_QUEUE* OperQ,
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_OPERATION* Oper
+    )
+{
+    return QuicOperationPush(OperQ, &OperQ->Inbox, Partition, Oper);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicOperationEnqueuePriority(
@@ -170,18 +292,7 @@ QuicOperationEnqueuePriority(
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-#if DEBUG
-    CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
-#endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertTail(*OperQ->PriorityTail, &Oper->Link);
-    OperQ->PriorityTail = &Oper->Link.Flink;
-    CxPlatDispatchLockRelease(&OperQ->Lock);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
-    return StartProcessing;
+    return QuicOperationPush(OperQ, &OperQ->PriorityInbox, Partition, Oper);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -192,20 +303,7 @@ QuicOperationEnqueueFront(
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-#if DEBUG
-    CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
-#endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertHead(&OperQ->List, &Oper->Link);
-    if (OperQ->PriorityTail == &OperQ->List.Flink) {
-        OperQ->PriorityTail = &Oper->Link.Flink;
-    }
-    CxPlatDispatchLockRelease(&OperQ->Lock);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
-    return StartProcessing;
+    return QuicOperationPush(OperQ, &OperQ->FrontInbox, Partition, Oper);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -215,28 +313,35 @@ QuicOperationDequeue(
     _In_ QUIC_PARTITION* Partition
     )
 {
-    QUIC_OPERATION* Oper;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-    if (CxPlatListIsEmpty(&OperQ->List)) {
-        OperQ->ActivelyProcessing = FALSE;
-        Oper = NULL;
-    } else {
+    OperQ->ActivelyProcessing = TRUE;
+    (void)QuicOperationQueueCollect(OperQ);
+
+    while (CxPlatListIsEmpty(&OperQ->List)) {
+        //
+        // Stop draining, then check the inboxes once more for any operation
+        // pushed by a producer that still saw the queue being drained.
+        //
+        (void)InterlockedFetchAndClearBoolean(&OperQ->ActivelyProcessing);
+        if (QuicReadPtrNoFence((void**)&OperQ->FrontInbox) == NULL &&
+            QuicReadPtrNoFence((void**)&OperQ->PriorityInbox) == NULL &&
+            QuicReadPtrNoFence((void**)&OperQ->Inbox) == NULL) {
+            return NULL;
+        }
         OperQ->ActivelyProcessing = TRUE;
-        Oper =
-            CXPLAT_CONTAINING_RECORD(
-                CxPlatListRemoveHead(&OperQ->List), QUIC_OPERATION, Link);
+        (void)QuicOperationQueueCollect(OperQ);
+    }
+
+    QUIC_OPERATION* Oper =
+        CXPLAT_CONTAINING_RECORD(
+            CxPlatListRemoveHead(&OperQ->List), QUIC_OPERATION, Link);
 #if DEBUG
-        Oper->Link.Flink = NULL;
+    Oper->Link.Flink = NULL;
 #endif
-        if (OperQ->PriorityTail == &Oper->Link.Flink) {
-            OperQ->PriorityTail = &OperQ->List.Flink;
-        }
+    if (OperQ->PriorityTail == &Oper->Link.Flink) {
+        OperQ->PriorityTail = &OperQ->List.Flink;
     }
-    CxPlatDispatchLockRelease(&OperQ->Lock);
 
-    if (Oper != NULL) {
-        QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, -1);
-    }
+    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, -1);
     return Oper;
 }
 
@@ -250,11 +355,10 @@ QuicOperationQueueClear(
     CXPLAT_LIST_ENTRY OldList;
     CxPlatListInitializeHead(&OldList);
 
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
     OperQ->ActivelyProcessing = FALSE;
+    (void)QuicOperationQueueCollect(OperQ);
     CxPlatListMoveItems(&OperQ->List, &OldList);
     OperQ->PriorityTail = &OperQ->List.Flink;
-    CxPlatDispatchLockRelease(&OperQ->Lock);
 
     int64_t OperationsDequeued = 0;
 
@@ -284,6 +388,27 @@ QuicOperationQueueClear(
                         ApiCtx->STRM_START.Stream,
                         QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
                         0);
+                } else if (ApiCtx->Type == QUIC_API_TYPE_CONN_SEND_BATCH) {
+                    for (uint32_t i = 0; i < ApiCtx->CONN_SEND_BATCH.StreamCount; ++i) {
+                        QUIC_STREAM* Stream = ApiCtx->CONN_SEND_BATCH.Streams[i];
+                        if (!Stream->Flags.Started) {
+                            QuicStreamShutdown(
+                                Stream,
+                                QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
+                                0);
+                        }
+                    }
+                } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_START_BATCH) {
+                    for (uint32_t i = 0; i < ApiCtx->STRM_START_BATCH.StreamCount; ++i) {
+                        QUIC_STREAM* Stream = ApiCtx->STRM_START_BATCH.Streams[i];
+                        QuicStreamIndicateStartComplete(Stream, QUIC_STATUS_ABORTED);
+                        if (ApiCtx->STRM_START_BATCH.Flags & QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL) {
+                            QuicStreamShutdown(
+                                Stream,
+                                QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
+                                0);
+                        }
+                    }
                 }
             }
             QuicOperationFree(Oper);
@@ -31,6 +31,8 @@ typedef enum QUIC_OPERATION_TYPE {
     QUIC_OPER_TYPE_TIMER_EXPIRED,       // A timer expired.
     QUIC_OPER_TYPE_TRACE_RUNDOWN,       // A trace rundown was triggered.
     QUIC_OPER_TYPE_ROUTE_COMPLETION,    // Process route completion event.
+    QUIC_OPER_TYPE_HANDSHAKE_COMPLETION,// Process an offloaded TLS completion.
+    QUIC_OPER_TYPE_FLUSH_STREAMS_RECV,  // Indicate data for a batch of streams to the app.
 
     //
     // All stateless operations follow.
@@ -38,7 +40,7 @@ typedef enum QUIC_OPERATION_TYPE {
 
     QUIC_OPER_TYPE_VERSION_NEGOTIATION, // A version negotiation needs to be sent.
     QUIC_OPER_TYPE_STATELESS_RESET,     // A stateless reset needs to be sent.
-    QUIC_OPER_TYPE_RETRY,               // A retry needs to be sent.
+    QUIC_OPER_TYPE_RETRY,               // Unused. Retries are sent inline on receive.
 
 } QUIC_OPERATION_TYPE;
 
@@ -64,6 +66,8 @@ typedef enum QUIC_API_TYPE {
     QUIC_API_TYPE_CONN_COMPLETE_RESUMPTION_TICKET_VALIDATION,
     QUIC_API_TYPE_CONN_COMPLETE_CERTIFICATE_VALIDATION,
     QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS,
+    QUIC_API_TYPE_CONN_SEND_BATCH,
+    QUIC_API_TYPE_STRM_START_BATCH,
 
 } QUIC_API_TYPE;
 
@@ -159,6 +163,15 @@ typedef struct QUIC_API_CONTEXT {
             QUIC_STREAM* Stream;
             CXPLAT_LIST_ENTRY /* QUIC_RECV_CHUNK */ Chunks;
         } STRM_PROVIDE_RECV_BUFFERS;
+        struct {
+            QUIC_STREAM** Streams;
+            uint32_t StreamCount;
+        } CONN_SEND_BATCH;
+        struct {
+            QUIC_STREAM** Streams;
+            uint32_t StreamCount;
+            QUIC_STREAM_START_FLAGS Flags;
+        } STRM_START_BATCH;
 
         struct {
             HQUIC Handle;
@@ -183,6 +196,8 @@ typedef enum QUIC_CONN_TIMER_TYPE {
     QUIC_CONN_TIMER_LOSS_DETECTION,
     QUIC_CONN_TIMER_KEEP_ALIVE,
     QUIC_CONN_TIMER_IDLE,
+    QUIC_CONN_TIMER_HIBERNATE,
+    QUIC_CONN_TIMER_PATH_PROBE,
     QUIC_CONN_TIMER_SHUTDOWN,
 
     QUIC_CONN_TIMER_COUNT
@@ -289,6 +304,11 @@ QuicOperLog(
 //
 // A queue of operations to be executed for a connection.
 //
+// Producers never take a lock: each operation is pushed onto one of the inbox
+// stacks (linked through Link.Flink) with a compare-exchange. The consumer
+// moves the inboxes, in order, into its private List before dequeuing, so List
+// and PriorityTail are only ever touched by the thread draining the queue.
+//
 typedef struct QUIC_OPERATION_QUEUE {
 
     //
@@ -297,9 +317,16 @@ typedef struct QUIC_OPERATION_QUEUE {
     BOOLEAN ActivelyProcessing;
 
     //
-    // Queue of pending operations.
+    // Operations pushed by producers and not yet moved to List, newest first,
+    // for the front, priority and regular parts of the queue.
+    //
+    CXPLAT_LIST_ENTRY* volatile FrontInbox;
+    CXPLAT_LIST_ENTRY* volatile PriorityInbox;
+    CXPLAT_LIST_ENTRY* volatile Inbox;
+
+    //
+    // Queue of pending operations, owned by the consumer.
     //
-    CXPLAT_DISPATCH_LOCK Lock;
     CXPLAT_LIST_ENTRY List;
     CXPLAT_LIST_ENTRY** PriorityTail; // Tail of the priority queue.
 
@@ -343,7 +370,8 @@ QuicOperationFree(
     );
 
 //
-// Returns TRUE if the operation queue has priority operations queued.
+// Returns TRUE if the operation queue has priority operations queued. Only
+// called by the thread draining the queue.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
@@ -352,10 +380,10 @@ QuicOperationHasPriority(
     _In_ QUIC_OPERATION_QUEUE* OperQ
     )
 {
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-    BOOLEAN HasPriorityWork = (&OperQ->List.Flink != OperQ->PriorityTail);
-    CxPlatDispatchLockRelease(&OperQ->Lock);
-    return HasPriorityWork;
+    return
+        &OperQ->List.Flink != OperQ->PriorityTail ||
+        QuicReadPtrNoFence((void**)&OperQ->FrontInbox) != NULL ||
+        QuicReadPtrNoFence((void**)&OperQ->PriorityInbox) != NULL;
 }
 
 //
@@ -396,7 +424,8 @@ QuicOperationEnqueueFront(
     );
 
 //
-// Dequeues an operation. Returns NULL if the queue is empty.
+// Dequeues an operation. Returns NULL if the queue is empty. Only called by
+// the thread draining the queue.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_OPERATION*
@@ -0,0 +1,178 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement a per-worker calendar queue of paced
+    connections. When a connection's pacing chunk is used up it is placed in
+    the slot of the time when its next chunk may be sent, instead of setting
+    its (millisecond resolution) pacing timer. The worker then releases all
+    the connections that are due, once per iteration of its loop.
+
+    The calendar consists of QUIC_PACING_QUEUE_SLOT_COUNT slots, each
+    QUIC_PACING_QUEUE_SLOT_US wide, starting at the current slot time. Since
+    pacing delays never exceed QUIC_SEND_PACING_INTERVAL, the calendar only
+    needs to cover a little more than that, and the slots are reused as the
+    current slot time moves forward. Connections within a slot aren't sorted;
+    the slot width is the resolution of the queue.
+
+    Like the timer wheel, the queue is only accessed from the worker thread
+    that owns the connections in it, so no locking is needed.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "pacing_queue.c.clog.h"
+#endif
+
+//
+// Helpers to get the slot index and slot start time for a given time.
+//
+#define TIME_TO_SLOT_INDEX(TimeUs) \
+    (((TimeUs) / QUIC_PACING_QUEUE_SLOT_US) % QUIC_PACING_QUEUE_SLOT_COUNT)
+#define TIME_TO_SLOT_TIME(TimeUs) \
+    ((TimeUs) - ((TimeUs) % QUIC_PACING_QUEUE_SLOT_US))
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueInitialize(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue
+    )
+{
+    PacingQueue->NextReleaseTime = UINT64_MAX;
+    PacingQueue->CurrentSlotTime = 0;
+    PacingQueue->ConnectionCount = 0;
+    for (uint32_t i = 0; i < QUIC_PACING_QUEUE_SLOT_COUNT; ++i) {
+        CxPlatListInitializeHead(&PacingQueue->Slots[i]);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueUninitialize(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue
+    )
+{
+    UNREFERENCED_PARAMETER(PacingQueue);
+    for (uint32_t i = 0; i < QUIC_PACING_QUEUE_SLOT_COUNT; ++i) {
+        CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&PacingQueue->Slots[i]));
+    }
+    CXPLAT_TEL_ASSERT(PacingQueue->ConnectionCount == 0);
+    CXPLAT_TEL_ASSERT(PacingQueue->NextReleaseTime == UINT64_MAX);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueInsertConnection(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue,
+    _Inout_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow,
+    _In_ uint64_t Delay
+    )
+{
+    CXPLAT_DBG_ASSERT(!Connection->State.ShutdownComplete);
+
+    if (Connection->PacingLink.Flink != NULL) {
+        //
+        // Already scheduled, so just move it to the new slot.
+        //
+        CxPlatListEntryRemove(&Connection->PacingLink);
+    } else {
+        if (PacingQueue->ConnectionCount == 0) {
+            PacingQueue->CurrentSlotTime = TIME_TO_SLOT_TIME(TimeNow);
+        }
+        PacingQueue->ConnectionCount++;
+        QuicConnAddRef(Connection, QUIC_CONN_REF_PACING_QUEUE);
+    }
+
+    const uint64_t LastSlotTime =
+        PacingQueue->CurrentSlotTime +
+        (QUIC_PACING_QUEUE_SLOT_COUNT - 1) * QUIC_PACING_QUEUE_SLOT_US;
+    uint64_t ReleaseTime = TimeNow + Delay;
+    if (ReleaseTime < PacingQueue->CurrentSlotTime) {
+        ReleaseTime = PacingQueue->CurrentSlotTime;
+    } else if (ReleaseTime > LastSlotTime) {
+        ReleaseTime = LastSlotTime;
+    }
+
+    CxPlatListInsertTail(
+        &PacingQueue->Slots[TIME_TO_SLOT_INDEX(ReleaseTime)],
+        &Connection->PacingLink);
+
+    const uint64_t SlotTime = TIME_TO_SLOT_TIME(ReleaseTime);
+    if (SlotTime < PacingQueue->NextReleaseTime) {
+        PacingQueue->NextReleaseTime = SlotTime;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueRemoveConnection(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->PacingLink.Flink != NULL) {
+        CxPlatListEntryRemove(&Connection->PacingLink);
+        Connection->PacingLink.Flink = NULL;
+        if (--PacingQueue->ConnectionCount == 0) {
+            PacingQueue->NextReleaseTime = UINT64_MAX;
+        }
+
+        //
+        // The next release time may now be earlier than needed. That only
+        // costs an empty pass through the due slots.
+        //
+
+        QuicConnRelease(Connection, QUIC_CONN_REF_PACING_QUEUE);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueGetReleased(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
+    )
+{
+    if (PacingQueue->NextReleaseTime > TimeNow) {
+        return;
+    }
+
+    //
+    // Walk the due slots in order. Every connection is within one calendar
+    // length of the current slot, so this ends after at most one lap, even if
+    // the worker fell far behind.
+    //
+    while (PacingQueue->ConnectionCount != 0 &&
+           PacingQueue->CurrentSlotTime <= TimeNow) {
+        CXPLAT_LIST_ENTRY* ListHead =
+            &PacingQueue->Slots[TIME_TO_SLOT_INDEX(PacingQueue->CurrentSlotTime)];
+        while (!CxPlatListIsEmpty(ListHead)) {
+            QUIC_CONNECTION* Connection =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(ListHead), QUIC_CONNECTION, PacingLink);
+            CxPlatListInsertTail(OutputListHead, &Connection->PacingLink);
+            QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+            QuicConnRelease(Connection, QUIC_CONN_REF_PACING_QUEUE);
+            PacingQueue->ConnectionCount--;
+        }
+        PacingQueue->CurrentSlotTime += QUIC_PACING_QUEUE_SLOT_US;
+    }
+
+    PacingQueue->NextReleaseTime = UINT64_MAX;
+    if (PacingQueue->ConnectionCount != 0) {
+        uint64_t SlotTime = PacingQueue->CurrentSlotTime;
+        for (uint32_t i = 0; i < QUIC_PACING_QUEUE_SLOT_COUNT; ++i) {
+            if (!CxPlatListIsEmpty(&PacingQueue->Slots[TIME_TO_SLOT_INDEX(SlotTime)])) {
+                PacingQueue->NextReleaseTime = SlotTime;
+                break;
+            }
+            SlotTime += QUIC_PACING_QUEUE_SLOT_US;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+typedef struct QUIC_CONNECTION QUIC_CONNECTION;
+
+typedef struct QUIC_PACING_QUEUE {
+
+    //
+    // The earliest time (in us) at which a connection in the queue may be
+    // released, or UINT64_MAX if the queue is empty.
+    //
+    uint64_t NextReleaseTime;
+
+    //
+    // The start time of the slot at the head of the calendar. Connections are
+    // never placed in a slot earlier than this.
+    //
+    uint64_t CurrentSlotTime;
+
+    //
+    // Total number of connections in the queue.
+    //
+    uint32_t ConnectionCount;
+
+    //
+    // The calendar of slots, each QUIC_PACING_QUEUE_SLOT_US wide, holding an
+    // unsorted list of the connections to release in that slot.
+    //
+    CXPLAT_LIST_ENTRY Slots[QUIC_PACING_QUEUE_SLOT_COUNT];
+
+} QUIC_PACING_QUEUE;
+
+//
+// Initializes the pacing queue's internal structure.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueInitialize(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue
+    );
+
+//
+// Cleans up the pacing queue.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueUninitialize(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue
+    );
+
+//
+// Schedules the connection to be released after the given delay. The delay
+// is rounded to the slot width and capped at the length of the calendar.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueInsertConnection(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue,
+    _Inout_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow,
+    _In_ uint64_t Delay
+    );
+
+//
+// Removes the connection from the pacing queue, if it's in it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueRemoveConnection(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue,
+    _Inout_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Moves all the connections due for release onto the list. Each connection
+// returned holds a QUIC_CONN_REF_WORKER reference.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacingQueueGetReleased(
+    _Inout_ QUIC_PACING_QUEUE* PacingQueue,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* ListHead
+    );
@@ -33,6 +33,50 @@ QuicPacketBuilderSendBatch(
     _Inout_ QUIC_PACKET_BUILDER* Builder
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacketBuilderFinalizeCryptoBatch(
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    );
+
+//
+// The kinds of datagrams that are marked (ECN and DSCP) differently.
+//
+typedef enum QUIC_PACKET_TRAFFIC_CLASS {
+    QUIC_PACKET_TRAFFIC_CLASS_DATA,
+    QUIC_PACKET_TRAFFIC_CLASS_ACK_ONLY,
+    QUIC_PACKET_TRAFFIC_CLASS_PROBE,        // PMTUD and path challenges.
+} QUIC_PACKET_TRAFFIC_CLASS;
+
+//
+// Gets the ECN codepoint and DSCP value for a new datagram of the given class.
+// Probes aren't part of the congestion controlled flow, so they are always
+// marked ECT(0), even if the congestion control algorithm uses ECT(1) (L4S).
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicPacketBuilderGetMarks(
+    _In_ QUIC_PACKET_BUILDER* Builder,
+    _In_ QUIC_PACKET_TRAFFIC_CLASS TrafficClass,
+    _Out_ uint8_t* Ecn,
+    _Out_ uint8_t* Dscp
+    )
+{
+    QUIC_CONNECTION* Connection = Builder->Connection;
+    if (!Builder->EcnEctSet) {
+        *Ecn = CXPLAT_ECN_NON_ECT;
+    } else if (TrafficClass == QUIC_PACKET_TRAFFIC_CLASS_PROBE) {
+        *Ecn = CXPLAT_ECN_ECT_0;
+    } else {
+        *Ecn = (uint8_t)QuicCongestionControlGetEcnCodepoint(&Connection->CongestionControl);
+    }
+    *Dscp =
+        TrafficClass == QUIC_PACKET_TRAFFIC_CLASS_ACK_ONLY &&
+        Connection->State.AckOnlyDSCPSet ?
+            Connection->AckOnlyDSCP : Connection->DSCP;
+}
+
 #if DEBUG
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -105,6 +149,9 @@ QuicPacketBuilderInitialize(
     Builder->Metadata = &Builder->MetadataStorage.Metadata;
     Builder->EncryptionOverhead = CXPLAT_ENCRYPTION_OVERHEAD;
     Builder->TotalDatagramsLength = 0;
+    Builder->CryptSegments = NULL;
+    Builder->CryptSegmentCount = 0;
+    Builder->PacketCryptSegmentStart = 0;
 
     if (Connection->SourceCids.Next == NULL) {
         QuicTraceLogConnWarning(
@@ -128,14 +175,44 @@ QuicPacketBuilderInitialize(
     } else {
         TimeSinceLastSend = 0;
     }
-    Builder->SendAllowance =
-        QuicCongestionControlGetSendAllowance(
-            &Connection->CongestionControl,
-            TimeSinceLastSend,
-            Connection->Send.LastFlushTimeValid);
+    Builder->TxTimePacingRate =
+        MsQuicLib.TxTimePacing ?
+            QuicCongestionControlGetPacingRate(&Connection->CongestionControl) : 0;
+    if (Builder->TxTimePacingRate != 0) {
+        //
+        // The kernel holds each batch until its departure time, so the whole
+        // congestion window can be handed off now instead of a pacing chunk.
+        //
+        Builder->SendAllowance =
+            QuicCongestionControlGetSendAllowance(
+                &Connection->CongestionControl, 0, FALSE);
+        if (Connection->Send.NextTxTime < TimeNow) {
+            Connection->Send.NextTxTime = TimeNow;
+        }
+    } else {
+        Builder->SendAllowance =
+            QuicCongestionControlGetSendAllowance(
+                &Connection->CongestionControl,
+                TimeSinceLastSend,
+                Connection->Send.LastFlushTimeValid);
+    }
     if (Builder->SendAllowance > Path->Allowance) {
         Builder->SendAllowance = Path->Allowance;
     }
+
+    //
+    // The application's send rate limit further caps the allowance. Less than
+    // a full packet's worth isn't used, so the tokens can build up instead of
+    // being spent on small packets.
+    //
+    Connection->Send.RateLimited = FALSE;
+    const uint64_t RateLimitAvailable =
+        QuicSendRateLimitGetAvailable(&Connection->SendRateLimit, TimeNow);
+    if (RateLimitAvailable < Builder->SendAllowance) {
+        Builder->SendAllowance =
+            RateLimitAvailable < Path->Mtu ? 0 : (uint32_t)RateLimitAvailable;
+        Connection->Send.RateLimited = TRUE;
+    }
     Connection->Send.LastFlushTime = TimeNow;
     Connection->Send.LastFlushTimeValid = TRUE;
 
@@ -172,10 +249,27 @@ QuicPacketBuilderPrepare(
     _Inout_ QUIC_PACKET_BUILDER* Builder,
     _In_ QUIC_PACKET_KEY_TYPE NewPacketKeyType,
     _In_ BOOLEAN IsTailLossProbe,
-    _In_ BOOLEAN IsPathMtuDiscovery
+    _In_ BOOLEAN IsPathMtuDiscovery,
+    _In_ QUIC_PACKET_TRAFFIC_CLASS TrafficClass
     )
 {
     QUIC_CONNECTION* Connection = Builder->Connection;
+
+    if (NewPacketKeyType == QUIC_PACKET_KEY_1_RTT &&
+        !IsPathMtuDiscovery &&
+        Builder->Datagram != NULL &&
+        Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE &&
+        Builder->Key == Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT] &&
+        (Builder->Datagram->Length - Builder->DatagramLength) >= QUIC_MIN_PACKET_SPARE_SPACE) {
+        //
+        // Steady state fast path: the current 1-RTT packet is still open with
+        // the current key and has room, so keep writing to it.
+        //
+        CXPLAT_DBG_ASSERT(Builder->Key != NULL);
+        QuicPacketBuilderValidate(Builder, FALSE);
+        return TRUE;
+    }
+
     if (Connection->Crypto.TlsState.WriteKeys[NewPacketKeyType] == NULL) {
         //
         // A NULL key here usually means the connection had a fatal error in
@@ -249,6 +343,23 @@ QuicPacketBuilderPrepare(
 
     if (Builder->Datagram == NULL) {
 
+        uint8_t Ecn, Dscp;
+        QuicPacketBuilderGetMarks(Builder, TrafficClass, &Ecn, &Dscp);
+        if (Builder->SendData != NULL &&
+            (Builder->SendDataEcn != Ecn || Builder->SendDataDscp != Dscp)) {
+            //
+            // All the datagrams of a send batch (i.e. a GSO/USO send) get the
+            // same marks, so the batch is split where they change.
+            //
+            if (Builder->BatchCount != 0) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
+            QuicPacketBuilderSendBatch(Builder);
+            if (Builder->TotalCountDatagrams >= QUIC_MAX_DATAGRAMS_PER_SEND) {
+                goto Error;
+            }
+        }
+
         //
         // Allocate and initialize a new send buffer (UDP packet/payload).
         //
@@ -263,10 +374,11 @@ QuicPacketBuilderPrepare(
                     MaxUdpPayloadSizeForFamily(
                         QuicAddrGetFamily(&Builder->Path->Route.RemoteAddress),
                         DatagramSize),
-                Builder->EcnEctSet ? CXPLAT_ECN_ECT_0 : CXPLAT_ECN_NON_ECT,
+                Ecn,
                 Builder->Connection->Registration->ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT ?
                     CXPLAT_SEND_FLAGS_MAX_THROUGHPUT : CXPLAT_SEND_FLAGS_NONE,
-                Connection->DSCP
+                Dscp,
+                Builder->TxTimePacingRate != 0 ? Connection->Send.NextTxTime : 0
             };
             Builder->SendData =
                 CxPlatSendDataAlloc(Builder->Path->Binding->Socket, &SendConfig);
@@ -278,6 +390,8 @@ QuicPacketBuilderPrepare(
                     0);
                 goto Error;
             }
+            Builder->SendDataEcn = Ecn;
+            Builder->SendDataDscp = Dscp;
             SendDataAllocated = TRUE;
         }
 
@@ -412,6 +526,7 @@ QuicPacketBuilderPrepare(
 
         Builder->PacketStart = Builder->DatagramLength;
         Builder->HeaderLength = 0;
+        Builder->PacketCryptSegmentStart = Builder->CryptSegmentCount;
 
         uint8_t* Header =
             Builder->Datagram->Buffer + Builder->DatagramLength;
@@ -502,6 +617,19 @@ QuicPacketBuilderGetPacketTypeAndKeyForControlFrames(
     CXPLAT_DBG_ASSERT(SendFlags != 0);
     QuicSendValidate(&Builder->Connection->Send);
 
+    if (Connection->State.HandshakeConfirmed &&
+        Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT] != NULL) {
+        //
+        // Once the handshake is confirmed, the Initial and Handshake keys have
+        // been discarded, so every control frame (including CLOSE) goes out
+        // with the 1-RTT key.
+        //
+        CXPLAT_DBG_ASSERT(Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_INITIAL] == NULL);
+        CXPLAT_DBG_ASSERT(Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_HANDSHAKE] == NULL);
+        *PacketKeyType = QUIC_PACKET_KEY_1_RTT;
+        return TRUE;
+    }
+
     QUIC_PACKET_KEY_TYPE MaxKeyType = Connection->Crypto.TlsState.WriteKey;
 
     if (SendFlags & (QUIC_CONN_SEND_FLAG_CONNECTION_CLOSE | QUIC_CONN_SEND_FLAG_APPLICATION_CLOSE)) {
@@ -621,6 +749,16 @@ QuicPacketBuilderPrepareForControlFrames(
     )
 {
     CXPLAT_DBG_ASSERT(!(SendFlags & QUIC_CONN_SEND_FLAG_DPLPMTUD));
+    QUIC_PACKET_TRAFFIC_CLASS TrafficClass = QUIC_PACKET_TRAFFIC_CLASS_DATA;
+    if (SendFlags == QUIC_CONN_SEND_FLAG_PATH_CHALLENGE) {
+        TrafficClass = QUIC_PACKET_TRAFFIC_CLASS_PROBE;
+    } else if (
+        !IsTailLossProbe &&
+        SendFlags == QUIC_CONN_SEND_FLAG_ACK &&
+        CxPlatListIsEmpty(&Builder->Connection->Send.SendStreams)) {
+        TrafficClass = QUIC_PACKET_TRAFFIC_CLASS_ACK_ONLY;
+    }
+
     QUIC_PACKET_KEY_TYPE PacketKeyType;
     return
         QuicPacketBuilderGetPacketTypeAndKeyForControlFrames(
@@ -631,7 +769,8 @@ QuicPacketBuilderPrepareForControlFrames(
             Builder,
             PacketKeyType,
             IsTailLossProbe,
-            FALSE);
+            FALSE,
+            TrafficClass);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -646,7 +785,8 @@ QuicPacketBuilderPrepareForPathMtuDiscovery(
             Builder,
             QUIC_PACKET_KEY_1_RTT,
             FALSE,
-            TRUE);
+            TRUE,
+            QUIC_PACKET_TRAFFIC_CLASS_PROBE);
 }
 
 
@@ -673,18 +813,78 @@ QuicPacketBuilderPrepareForStreamFrames(
         PacketKeyType = QUIC_PACKET_KEY_1_RTT;
     }
 
-    return QuicPacketBuilderPrepare(Builder, PacketKeyType, IsTailLossProbe, FALSE);
+    return
+        QuicPacketBuilderPrepare(
+            Builder,
+            PacketKeyType,
+            IsTailLossProbe,
+            FALSE,
+            QUIC_PACKET_TRAFFIC_CLASS_DATA);
 }
 
+//
+// Encrypts all the batched short header packets with a single call into the
+// crypto layer and then applies header protection to them.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicPacketBuilderFinalizeHeaderProtection(
+QuicPacketBuilderFinalizeCryptoBatch(
     _Inout_ QUIC_PACKET_BUILDER* Builder
     )
 {
     CXPLAT_DBG_ASSERT(Builder->Key != NULL);
+    CXPLAT_DBG_ASSERT(Builder->BatchCount != 0);
+
+    uint8_t Iv[QUIC_MAX_CRYPTO_BATCH_COUNT][CXPLAT_MAX_IV_LENGTH];
+    CXPLAT_CRYPT_PACKET Packets[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
+    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+        uint8_t* Header = Builder->HeaderBatch[i];
+        QuicCryptoCombineIvAndPacketNumber(
+            Builder->Key->Iv, (uint8_t*)&Builder->PacketNumberBatch[i], Iv[i]);
+        Packets[i].Iv = Iv[i];
+        Packets[i].AuthData = Header;
+        Packets[i].AuthDataLength = Builder->HeaderLengthBatch[i];
+        Packets[i].Buffer = Header + Builder->HeaderLengthBatch[i];
+        Packets[i].BufferLength = Builder->PayloadLengthBatch[i];
+        if (Builder->CryptSegments != NULL) {
+            uint8_t SegmentEnd =
+                i + 1 < Builder->BatchCount ?
+                    Builder->CryptSegmentStartBatch[i + 1] : Builder->CryptSegmentCount;
+            Packets[i].Segments = Builder->CryptSegments + Builder->CryptSegmentStartBatch[i];
+            Packets[i].SegmentCount = SegmentEnd - Builder->CryptSegmentStartBatch[i];
+        } else {
+            Packets[i].Segments = NULL;
+            Packets[i].SegmentCount = 0;
+        }
+    }
+    Builder->CryptSegmentCount = 0;
 
     QUIC_STATUS Status;
+    if (QUIC_FAILED(
+        Status =
+        CxPlatEncryptBatch(
+            Builder->Key->PacketKey,
+            Builder->BatchCount,
+            Packets))) {
+        Builder->BatchCount = 0;
+        QuicConnFatalError(Builder->Connection, Status, "Encryption failure");
+        return;
+    }
+
+    if (!Builder->Connection->State.HeaderProtectionEnabled) {
+        Builder->BatchCount = 0;
+        return;
+    }
+
+    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+        uint8_t* PnStart = Packets[i].Buffer - Builder->PacketNumberLength;
+        CxPlatCopyMemory(
+            Builder->CipherBatch + i * CXPLAT_HP_SAMPLE_LENGTH,
+            PnStart + 4,
+            CXPLAT_HP_SAMPLE_LENGTH);
+    }
+
     if (QUIC_FAILED(
         Status =
         CxPlatHpComputeMask(
@@ -783,6 +983,19 @@ QuicPacketBuilderFinalize(
         }
     }
 
+    if (FinalQuicPacket && FlushBatchedDatagrams &&
+        QuicConnIsServer(Connection) &&
+        Builder->PacketStart == 0 &&
+        Builder->Metadata->Flags.KeyType == QUIC_PACKET_KEY_INITIAL &&
+        !Builder->Metadata->Flags.IsAckEliciting) {
+        //
+        // A server only has to pad datagrams with ack-eliciting Initial
+        // packets. Padding one holding just an ACK would spend amplification
+        // budget the rest of the server's flight needs.
+        //
+        Builder->MinimumDatagramLength = 0;
+    }
+
     uint16_t PaddingLength;
     if (FinalQuicPacket && ExpectedFinalDatagramLength < Builder->MinimumDatagramLength) {
         PaddingLength = Builder->MinimumDatagramLength - ExpectedFinalDatagramLength;
@@ -859,57 +1072,63 @@ QuicPacketBuilderFinalize(
 
         uint8_t* Payload = Header + Builder->HeaderLength;
 
-        uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
-        QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
-
         QUIC_STATUS Status;
-        if (QUIC_FAILED(
-            Status =
-            CxPlatEncrypt(
-                Builder->Key->PacketKey,
-                Iv,
-                Builder->HeaderLength,
-                Header,
-                PayloadLength,
-                Payload))) {
-            QuicConnFatalError(Connection, Status, "Encryption failure");
-            goto Exit;
-        }
-
-        QuicTraceEvent(
-            PacketFinalize,
-            "[pack][%llu] Finalizing",
-            Builder->Metadata->PacketId);
+        if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
+            CXPLAT_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
 
-        if (Connection->State.HeaderProtectionEnabled) {
+            //
+            // Batch the encryption and header protection for short header
+            // packets, as they all use the same keys.
+            //
 
-            uint8_t* PnStart = Payload - Builder->PacketNumberLength;
+            Builder->HeaderBatch[Builder->BatchCount] = Header;
+            Builder->PacketNumberBatch[Builder->BatchCount] = Builder->Metadata->PacketNumber;
+            Builder->PayloadLengthBatch[Builder->BatchCount] = PayloadLength;
+            Builder->HeaderLengthBatch[Builder->BatchCount] = (uint8_t)Builder->HeaderLength;
+            Builder->CryptSegmentStartBatch[Builder->BatchCount] = Builder->PacketCryptSegmentStart;
 
-            if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
-                CXPLAT_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
+            QuicTraceEvent(
+                PacketFinalize,
+                "[pack][%llu] Finalizing",
+                Builder->Metadata->PacketId);
 
-                //
-                // Batch the header protection for short header packets.
-                //
+            if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
 
-                CxPlatCopyMemory(
-                    Builder->CipherBatch + Builder->BatchCount * CXPLAT_HP_SAMPLE_LENGTH,
-                    PnStart + 4,
-                    CXPLAT_HP_SAMPLE_LENGTH);
-                Builder->HeaderBatch[Builder->BatchCount] = Header;
+        } else {
+            CXPLAT_DBG_ASSERT(Builder->BatchCount == 0);
+
+            uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+            QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
+
+            if (QUIC_FAILED(
+                Status =
+                CxPlatEncrypt(
+                    Builder->Key->PacketKey,
+                    Iv,
+                    Builder->HeaderLength,
+                    Header,
+                    PayloadLength,
+                    Payload))) {
+                QuicConnFatalError(Connection, Status, "Encryption failure");
+                goto Exit;
+            }
 
-                if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
-                    QuicPacketBuilderFinalizeHeaderProtection(Builder);
-                }
+            QuicTraceEvent(
+                PacketFinalize,
+                "[pack][%llu] Finalizing",
+                Builder->Metadata->PacketId);
 
-            } else {
-                CXPLAT_DBG_ASSERT(Builder->BatchCount == 0);
+            if (Connection->State.HeaderProtectionEnabled) {
 
                 //
                 // Individually do header protection for long header packets as
                 // they generally use different keys.
                 //
 
+                uint8_t* PnStart = Payload - Builder->PacketNumberLength;
+
                 if (QUIC_FAILED(
                     Status =
                     CxPlatHpComputeMask(
@@ -941,7 +1160,7 @@ QuicPacketBuilderFinalize(
         //
         if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE &&
             PacketSpace->CurrentKeyPhaseBytesSent + CXPLAT_MAX_MTU >=
-                Connection->Settings.MaxBytesPerKey &&
+                Connection->Settings->MaxBytesPerKey &&
             !PacketSpace->AwaitingKeyPhaseConfirmation &&
             Connection->State.HandshakeConfirmed) {
 
@@ -957,6 +1176,14 @@ QuicPacketBuilderFinalize(
                 goto Exit;
             }
 
+            //
+            // The batched packets were framed with the old key phase, so they
+            // must be encrypted before the key is swapped out.
+            //
+            if (Builder->BatchCount != 0) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
+
             QuicCryptoUpdateKeyPhase(Connection, TRUE);
 
             //
@@ -984,7 +1211,8 @@ QuicPacketBuilderFinalize(
     Builder->Metadata->SentTime = CxPlatTimeUs64();
     Builder->Metadata->PacketLength =
         Builder->HeaderLength + PayloadLength;
-    Builder->Metadata->Flags.EcnEctSet = Builder->EcnEctSet;
+    Builder->Metadata->Flags.EcnEctSet = Builder->SendDataEcn != CXPLAT_ECN_NON_ECT;
+    Builder->Metadata->Flags.EcnEct1 = Builder->SendDataEcn == CXPLAT_ECN_ECT_1;
     QuicTraceEvent(
         ConnPacketSent,
         "[conn][%p][TX][%llu] %hhu (%hu bytes)",
@@ -1022,6 +1250,7 @@ Exit:
         if (Builder->Datagram != NULL) {
             if (Builder->Metadata->Flags.EcnEctSet) {
                 ++Connection->Send.NumPacketsSentWithEct;
+                Connection->Send.NumPacketsSentWithEct1 += Builder->Metadata->Flags.EcnEct1;
             }
             Builder->Datagram->Length = Builder->DatagramLength;
             Builder->Datagram = NULL;
@@ -1032,7 +1261,7 @@ Exit:
 
         if (FlushBatchedDatagrams || CxPlatSendDataIsFull(Builder->SendData)) {
             if (Builder->BatchCount != 0) {
-                QuicPacketBuilderFinalizeHeaderProtection(Builder);
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
             }
             CXPLAT_DBG_ASSERT(Builder->TotalCountDatagrams > 0);
             QuicPacketBuilderSendBatch(Builder);
@@ -1084,13 +1313,34 @@ QuicPacketBuilderSendBatch(
         "Sending batch. %hu datagrams",
         (uint16_t)Builder->TotalCountDatagrams);
 
-    QuicBindingSend(
-        Builder->Path->Binding,
-        Builder->Connection->Partition,
-        &Builder->Path->Route,
-        Builder->SendData,
-        Builder->TotalDatagramsLength,
-        Builder->TotalCountDatagrams);
+    QUIC_CONNECTION* Connection = Builder->Connection;
+    if (Connection->Worker != NULL &&
+        Connection->Worker->BatchSends &&
+        Connection->WorkerThreadID == CxPlatCurThreadID()) {
+        //
+        // Let the worker submit this along with other connections' sends.
+        //
+        QuicWorkerSend(
+            Connection->Worker,
+            Builder->Path->Binding,
+            &Builder->Path->Route,
+            Builder->SendData,
+            Builder->TotalDatagramsLength,
+            Builder->TotalCountDatagrams);
+    } else {
+        QuicBindingSend(
+            Builder->Path->Binding,
+            Connection->Partition,
+            &Builder->Path->Route,
+            Builder->SendData,
+            Builder->TotalDatagramsLength,
+            Builder->TotalCountDatagrams);
+    }
+
+    if (Builder->TxTimePacingRate != 0) {
+        Builder->Connection->Send.NextTxTime +=
+            S_TO_US((uint64_t)Builder->TotalDatagramsLength) / Builder->TxTimePacingRate;
+    }
 
     Builder->PacketBatchSent = TRUE;
     Builder->SendData = NULL;
@@ -30,6 +30,13 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     CXPLAT_SEND_DATA* SendData;
 
+    //
+    // The ECN codepoint and DSCP value all the datagrams of SendData are
+    // marked with.
+    //
+    uint8_t SendDataEcn;
+    uint8_t SendDataDscp;
+
     //
     // Represents a single UDP payload. Can contain multiple coalesced QUIC
     // packets.
@@ -57,6 +64,24 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint8_t* HeaderBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
 
+    //
+    // Per-packet state needed to encrypt the batched short header packets.
+    //
+    uint64_t PacketNumberBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint16_t PayloadLengthBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t HeaderLengthBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
+    //
+    // Stream data that is encrypted straight from the send buffers instead of
+    // being copied into the packet first. NULL if not enabled for this flush.
+    // The storage is owned by the caller and indexed by
+    // CryptSegmentStartBatch for each batched packet.
+    //
+    CXPLAT_CRYPT_SEGMENT* CryptSegments;
+    uint8_t CryptSegmentCount;
+    uint8_t PacketCryptSegmentStart;
+    uint8_t CryptSegmentStartBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
     //
     // Indicates a batch of packets has been sent.
     //
@@ -69,7 +94,7 @@ typedef struct QUIC_PACKET_BUILDER {
     uint8_t PacketBatchRetransmittable : 1;
 
     //
-    // The number of batched packets to do header protection on.
+    // The number of batched packets to encrypt and do header protection on.
     //
     uint8_t BatchCount : 4;
 
@@ -146,6 +171,13 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint32_t SendAllowance;
 
+    //
+    // When the kernel paces sends (SO_TXTIME), the rate (in bytes per second)
+    // the departure times of consecutive batches are spread out at. Zero if
+    // batches are sent immediately.
+    //
+    uint64_t TxTimePacingRate;
+
     uint64_t BatchId;
 
     //
@@ -273,3 +305,38 @@ QuicPacketBuilderAddStreamFrame(
     QuicStreamSentMetadataIncrement(Stream);
     return QuicPacketBuilderAddFrame(Builder, FrameType, TRUE);
 }
+
+//
+// Tries to defer copying Length bytes of stream data from Source to
+// Destination (in the current packet's payload) until the packet is
+// encrypted, at which point the cipher text is written there straight from
+// Source. Returns FALSE if the caller must copy the data itself.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+BOOLEAN
+QuicPacketBuilderAddCryptSegment(
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
+    _In_ const uint8_t* Destination,
+    _In_reads_bytes_(Length) const uint8_t* Source,
+    _In_ uint16_t Length
+    )
+{
+    if (Builder->CryptSegments == NULL ||
+        Builder->CryptSegmentCount == QUIC_MAX_CRYPT_SEGMENTS ||
+        Builder->PacketType != SEND_PACKET_SHORT_HEADER_TYPE ||
+        Builder->EncryptionOverhead == 0 ||
+        Builder->Connection->Paths[0].EncryptionOffloading) {
+        return FALSE;
+    }
+
+    const uint8_t* Payload =
+        Builder->Datagram->Buffer + Builder->PacketStart + Builder->HeaderLength;
+    CXPLAT_DBG_ASSERT(Destination >= Payload);
+
+    CXPLAT_CRYPT_SEGMENT* Segment = &Builder->CryptSegments[Builder->CryptSegmentCount++];
+    Segment->Source = Source;
+    Segment->Offset = (uint16_t)(Destination - Payload);
+    Segment->Length = Length;
+    return TRUE;
+}
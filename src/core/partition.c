@@ -10,6 +10,211 @@
 #include "partition.c.clog.h"
 #endif
 
+#ifndef _KERNEL_MODE
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicRecvStageFlushEntry(
+    _Inout_ QUIC_RECV_STAGE_ENTRY* Entry
+    )
+{
+    QuicConnQueueRecvPackets(
+        Entry->Connection, Entry->Head, Entry->Length, Entry->Bytes);
+    QuicConnRelease(Entry->Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+    Entry->Connection = NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicRecvStageFlush(
+    _Inout_ QUIC_RECV_STAGE* Stage
+    )
+{
+    for (uint32_t i = 0; i < Stage->Count; ++i) {
+        QuicRecvStageFlushEntry(&Stage->Entries[i]);
+    }
+    Stage->Count = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(CXPLAT_EXECUTION_FN)
+static
+BOOLEAN
+QuicRecvStageRun(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    )
+{
+    QUIC_RECV_STAGE* Stage = (QUIC_RECV_STAGE*)Context;
+    UNREFERENCED_PARAMETER(State);
+
+    QuicRecvStageFlush(Stage);
+
+    if (!Stage->Enabled) {
+        CxPlatEventSet(Stage->Done);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPartitionStartRecvStage(
+    _Inout_ QUIC_PARTITION* Partition
+    )
+{
+    QUIC_RECV_STAGE* Stage = &Partition->RecvStage;
+    CXPLAT_DBG_ASSERT(MsQuicLib.WorkerPool != NULL);
+    CXPLAT_DBG_ASSERT(Stage->ExecutionContext.Context == NULL);
+
+    CxPlatEventInitialize(&Stage->Done, TRUE, FALSE);
+    Stage->Enabled = TRUE;
+    Stage->Count = 0;
+    Stage->ExecutionContext.Context = Stage;
+    Stage->ExecutionContext.Callback = QuicRecvStageRun;
+    Stage->ExecutionContext.NextTimeUs = UINT64_MAX;
+    Stage->ExecutionContext.Ready = FALSE;
+    CxPlatWorkerPoolAddExecutionContext(
+        MsQuicLib.WorkerPool,
+        &Stage->ExecutionContext,
+        Partition->Index);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicPartitionStopRecvStage(
+    _Inout_ QUIC_PARTITION* Partition
+    )
+{
+    QUIC_RECV_STAGE* Stage = &Partition->RecvStage;
+    if (Stage->ExecutionContext.Context == NULL) {
+        return;
+    }
+
+    Stage->Enabled = FALSE;
+    Stage->ExecutionContext.Ready = TRUE;
+    CxPlatWakeExecutionContext(&Stage->ExecutionContext);
+    CxPlatEventWaitForever(Stage->Done);
+    CxPlatEventUninitialize(Stage->Done);
+    CXPLAT_DBG_ASSERT(Stage->Count == 0);
+    Stage->ExecutionContext.Context = NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPartitionStageRecvPackets(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packets,
+    _In_ uint32_t PacketChainLength,
+    _In_ uint32_t PacketChainByteLength
+    )
+{
+    QUIC_RECV_STAGE* Stage = &Partition->RecvStage;
+    if (Stage->ExecutionContext.Context == NULL ||
+        !Stage->Enabled ||
+        !CxPlatWorkerIsThisThread(&Stage->ExecutionContext)) {
+        return FALSE;
+    }
+
+    QUIC_RECV_STAGE_ENTRY* Entry = NULL;
+    for (uint32_t i = 0; i < Stage->Count; ++i) {
+        if (Stage->Entries[i].Connection == Connection) {
+            Entry = &Stage->Entries[i];
+            break;
+        }
+    }
+
+    if (Entry == NULL) {
+        if (Stage->Count == QUIC_PARTITION_RECV_STAGE_SIZE) {
+            QuicRecvStageFlush(Stage);
+        }
+        if (Stage->Count == 0) {
+            Stage->ExecutionContext.Ready = TRUE;
+        }
+        Entry = &Stage->Entries[Stage->Count++];
+        Entry->Connection = Connection;
+        Entry->Head = NULL;
+        Entry->Tail = &Entry->Head;
+        Entry->Length = 0;
+        Entry->Bytes = 0;
+    } else {
+        //
+        // The first staged packets already hold a lookup reference.
+        //
+        QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+    }
+
+    *Entry->Tail = Packets;
+    QUIC_RX_PACKET* Last = Packets;
+    while (Last->Next != NULL) {
+        Last = (QUIC_RX_PACKET*)Last->Next;
+    }
+    Entry->Tail = (QUIC_RX_PACKET**)&Last->Next;
+    Entry->Length += PacketChainLength;
+    Entry->Bytes += PacketChainByteLength;
+
+    if (Entry->Length >= QUIC_MAX_RECEIVE_FLUSH_COUNT) {
+        //
+        // Don't hold back more than the connection processes in one flush.
+        // Swap the last entry into the freed slot.
+        //
+        QuicRecvStageFlushEntry(Entry);
+        *Entry = Stage->Entries[--Stage->Count];
+    }
+
+    return TRUE;
+}
+
+#endif // !_KERNEL_MODE
+
+//
+// Pre-allocates the configured number of entries in the partition's pools.
+// Best effort; the pools just grow on demand from wherever this stopped.
+//
+static
+void
+QuicPartitionReservePools(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_ const QUIC_POOL_RESERVE_CONFIG* PoolReserve
+    )
+{
+    struct {
+        CXPLAT_POOL* Pool;
+        uint32_t Count;
+    } Reservations[] = {
+        { &Partition->ConnectionPool, PoolReserve->Connections },
+        { &Partition->StreamPool, PoolReserve->Streams },
+        { &Partition->OperPool, PoolReserve->Operations },
+        { &Partition->SentPacketPool.Pools[0], PoolReserve->SentPackets },
+        { &Partition->SentPacketPool.Pools[1], PoolReserve->SentPackets },
+        { &Partition->RecvChunkPools[0], PoolReserve->RecvChunks },
+    };
+
+    for (uint32_t i = 0; i < ARRAYSIZE(Reservations); ++i) {
+        if (Reservations[i].Count == 0) {
+            continue;
+        }
+        QUIC_STATUS Status =
+            CxPlatPoolReserve(
+                Reservations[i].Pool,
+                Reservations[i].Count,
+                Partition->NumaNode);
+        if (QUIC_FAILED(Status)) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "CxPlatPoolReserve");
+            break;
+        }
+    }
+}
+
 QUIC_STATUS
 QuicPartitionInitialize(
     _Inout_ QUIC_PARTITION* Partition,
@@ -18,27 +223,47 @@ QuicPartitionInitialize(
     _In_ CXPLAT_HASH_TYPE HashType,
     _In_reads_(ResetHashKeyLength)
         const uint8_t* const ResetHashKey,
-    _In_ uint32_t ResetHashKeyLength
+    _In_ uint32_t ResetHashKeyLength,
+    _In_ uint32_t TicketCacheSize,
+    _In_ const QUIC_POOL_RESERVE_CONFIG* PoolReserve
     )
 {
-    QUIC_STATUS Status =
-        CxPlatHashCreate(
-            HashType,
-            ResetHashKey,
-            ResetHashKeyLength,
-            &Partition->ResetTokenHash);
+    QUIC_STATUS Status = QuicTicketCacheInitialize(&Partition->TicketCache, TicketCacheSize);
     if (QUIC_FAILED(Status)) {
         return Status;
     }
 
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        Status =
+            CxPlatHashCreate(
+                HashType,
+                ResetHashKey,
+                ResetHashKeyLength,
+                (CXPLAT_HASH**)&Partition->ResetTokenHashes[i]);
+        if (QUIC_FAILED(Status)) {
+            for (uint32_t j = 0; j < i; ++j) {
+                CxPlatHashFree(Partition->ResetTokenHashes[j]);
+                Partition->ResetTokenHashes[j] = NULL;
+            }
+            QuicTicketCacheUninitialize(&Partition->TicketCache);
+            return Status;
+        }
+    }
+
     Partition->Index = Index;
     Partition->Processor = Processor;
+    Partition->NumaNode = CxPlatProcNumaNode(Processor);
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_CONNECTION), QUIC_POOL_CONN, &Partition->ConnectionPool);
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_TRANSPORT_PARAMETERS), QUIC_POOL_TP, &Partition->TransportParamPool);
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_PACKET_SPACE), QUIC_POOL_TP, &Partition->PacketSpacePool);
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_STREAM), QUIC_POOL_STREAM, &Partition->StreamPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_RECV_CHUNK)+QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, QUIC_POOL_SBUF, &Partition->DefaultReceiveBufferPool);
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_CLASS_COUNT; ++i) {
+        CxPlatPoolInitialize(FALSE, sizeof(QUIC_RECV_CHUNK) + (QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE << i), QUIC_POOL_RECVBUF, &Partition->RecvChunkPools[i]);
+    }
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_SEND_REQUEST), QUIC_POOL_SEND_REQUEST, &Partition->SendRequestPool);
+    for (uint32_t i = 0; i < QUIC_SEND_BUFFER_POOL_CLASS_COUNT; ++i) {
+        CxPlatPoolInitialize(FALSE, QUIC_SEND_BUFFER_POOL_MIN_SIZE << i, QUIC_POOL_SENDBUF, &Partition->SendBufferPools[i]);
+    }
     QuicSentPacketPoolInitialize(&Partition->SentPacketPool);
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_API_CONTEXT), QUIC_POOL_API_CTX, &Partition->ApiContextPool);
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_STATELESS_CONTEXT), QUIC_POOL_STATELESS_CTX, &Partition->StatelessContextPool);
@@ -46,6 +271,9 @@ QuicPartitionInitialize(
     CxPlatPoolInitialize(FALSE, sizeof(QUIC_RECV_CHUNK), QUIC_POOL_APP_BUFFER_CHUNK, &Partition->AppBufferChunkPool);
     CxPlatLockInitialize(&Partition->ResetTokenLock);
     CxPlatDispatchLockInitialize(&Partition->StatelessRetryKeysLock);
+    CxPlatDispatchLockInitialize(&Partition->InitialKeysLock);
+    QuicQlogRingInitialize(&Partition->QlogRing);
+    QuicPartitionReservePools(Partition, PoolReserve);
 
     return QUIC_STATUS_SUCCESS;
 }
@@ -55,6 +283,9 @@ QuicPartitionUninitialize(
     _Inout_ QUIC_PARTITION* Partition
     )
 {
+#ifndef _KERNEL_MODE
+    QuicPartitionStopRecvStage(Partition);
+#endif
     for (size_t i = 0; i < ARRAYSIZE(Partition->StatelessRetryKeys); ++i) {
         CxPlatKeyFree(Partition->StatelessRetryKeys[i].Key);
     }
@@ -62,8 +293,13 @@ QuicPartitionUninitialize(
     CxPlatPoolUninitialize(&Partition->TransportParamPool);
     CxPlatPoolUninitialize(&Partition->PacketSpacePool);
     CxPlatPoolUninitialize(&Partition->StreamPool);
-    CxPlatPoolUninitialize(&Partition->DefaultReceiveBufferPool);
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_CLASS_COUNT; ++i) {
+        CxPlatPoolUninitialize(&Partition->RecvChunkPools[i]);
+    }
     CxPlatPoolUninitialize(&Partition->SendRequestPool);
+    for (uint32_t i = 0; i < QUIC_SEND_BUFFER_POOL_CLASS_COUNT; ++i) {
+        CxPlatPoolUninitialize(&Partition->SendBufferPools[i]);
+    }
     QuicSentPacketPoolUninitialize(&Partition->SentPacketPool);
     CxPlatPoolUninitialize(&Partition->ApiContextPool);
     CxPlatPoolUninitialize(&Partition->StatelessContextPool);
@@ -71,7 +307,257 @@ QuicPartitionUninitialize(
     CxPlatPoolUninitialize(&Partition->AppBufferChunkPool);
     CxPlatLockUninitialize(&Partition->ResetTokenLock);
     CxPlatDispatchLockUninitialize(&Partition->StatelessRetryKeysLock);
-    CxPlatHashFree(Partition->ResetTokenHash);
+    for (uint16_t i = 0; i < Partition->InitialKeyCount; ++i) {
+        QuicPacketKeyFree(Partition->InitialKeys[i]);
+    }
+    Partition->InitialKeyCount = 0;
+    CxPlatDispatchLockUninitialize(&Partition->InitialKeysLock);
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        CxPlatHashFree(Partition->ResetTokenHashes[i]);
+        Partition->ResetTokenHashes[i] = NULL;
+    }
+    QuicTicketCacheUninitialize(&Partition->TicketCache);
+    QuicQlogRingUninitialize(&Partition->QlogRing);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+QUIC_PACKET_KEY*
+QuicPartitionAcquireInitialKey(
+    _In_ QUIC_PARTITION* Partition
+    )
+{
+    QUIC_PACKET_KEY* Key = NULL;
+    CxPlatDispatchLockAcquire(&Partition->InitialKeysLock);
+    if (Partition->InitialKeyCount != 0) {
+        Key = Partition->InitialKeys[--Partition->InitialKeyCount];
+    }
+    CxPlatDispatchLockRelease(&Partition->InitialKeysLock);
+    return Key;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPartitionReleaseInitialKey(
+    _In_ QUIC_PARTITION* Partition,
+    _In_opt_ QUIC_PACKET_KEY* Key
+    )
+{
+    if (Key == NULL) {
+        return;
+    }
+
+    //
+    // Only keys that can be re-keyed as a whole are worth keeping.
+    //
+    if (Key->Type == QUIC_PACKET_KEY_INITIAL &&
+        Key->PacketKey != NULL && Key->HeaderKey != NULL) {
+        CxPlatDispatchLockAcquire(&Partition->InitialKeysLock);
+        if (Partition->InitialKeyCount < QUIC_PARTITION_INITIAL_KEY_CACHE_SIZE) {
+            Partition->InitialKeys[Partition->InitialKeyCount++] = Key;
+            Key = NULL;
+        }
+        CxPlatDispatchLockRelease(&Partition->InitialKeysLock);
+    }
+
+    QuicPacketKeyFree(Key);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicTicketCacheInitialize(
+    _Inout_ QUIC_TICKET_CACHE* Cache,
+    _In_ uint32_t EntryCount
+    )
+{
+    CxPlatZeroMemory(Cache, sizeof(*Cache));
+    if (EntryCount == 0) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    const size_t EntriesSize = (size_t)EntryCount * sizeof(QUIC_TICKET_CACHE_ENTRY);
+    Cache->Entries = CXPLAT_ALLOC_NONPAGED(EntriesSize, QUIC_POOL_TICKET_CACHE);
+    if (Cache->Entries == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "ticket cache",
+            EntriesSize);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    CxPlatZeroMemory(Cache->Entries, EntriesSize);
+    CxPlatDispatchLockInitialize(&Cache->Lock);
+    Cache->EntryCount = EntryCount;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTicketCacheUninitialize(
+    _Inout_ QUIC_TICKET_CACHE* Cache
+    )
+{
+    if (Cache->Entries != NULL) {
+        CxPlatDispatchLockUninitialize(&Cache->Lock);
+        CxPlatSecureZeroMemory(
+            Cache->Entries, (size_t)Cache->EntryCount * sizeof(QUIC_TICKET_CACHE_ENTRY));
+        CXPLAT_FREE(Cache->Entries, QUIC_POOL_TICKET_CACHE);
+        Cache->Entries = NULL;
+    }
+    Cache->EntryCount = 0;
+}
+
+//
+// Reads an entry's sequence number with a full fence, so the copy made
+// between two reads is ordered against the writer's updates.
+//
+#define QuicTicketCacheReadSequence(Entry) \
+    InterlockedCompareExchange(&(Entry)->Sequence, 0, 0)
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicTicketCacheInsert(
+    _Inout_ QUIC_TICKET_CACHE* Cache,
+    _In_ uint16_t PartitionIndex,
+    _In_ uint32_t TicketLength,
+    _In_reads_bytes_(TicketLength)
+        const uint8_t* Ticket,
+    _Out_writes_bytes_all_(QUIC_TICKET_CACHE_REF_LENGTH)
+        uint8_t* Ref
+    )
+{
+    if (Cache->EntryCount == 0 ||
+        TicketLength > QUIC_TICKET_CACHE_MAX_TICKET_LENGTH) {
+        return FALSE;
+    }
+
+    uint64_t TicketId;
+    do {
+        CxPlatRandom(sizeof(TicketId), &TicketId);
+    } while (TicketId == 0);
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+
+    //
+    // Advance the clock hand to the first empty or unreferenced entry. Every
+    // entry is visited at most twice.
+    //
+    QUIC_TICKET_CACHE_ENTRY* Entry;
+    uint32_t Slot;
+    while (TRUE) {
+        Slot = Cache->Hand;
+        Cache->Hand = (Cache->Hand + 1) % Cache->EntryCount;
+        Entry = &Cache->Entries[Slot];
+        if (Entry->TicketId == 0 || !Entry->Referenced) {
+            break;
+        }
+        Entry->Referenced = FALSE;
+    }
+
+    InterlockedIncrement(&Entry->Sequence);
+    Entry->Referenced = FALSE;
+    Entry->TicketId = TicketId;
+    Entry->TicketLength = (uint16_t)TicketLength;
+    CxPlatCopyMemory(Entry->Ticket, Ticket, TicketLength);
+    InterlockedIncrement(&Entry->Sequence);
+
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    Ref[0] = QUIC_TICKET_CACHE_REF_MARKER;
+    CxPlatCopyMemory(Ref + 1, &PartitionIndex, sizeof(PartitionIndex));
+    CxPlatCopyMemory(Ref + 3, &Slot, sizeof(Slot));
+    CxPlatCopyMemory(Ref + 7, &TicketId, sizeof(TicketId));
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicTicketCacheIsRef(
+    _In_ uint32_t TicketLength,
+    _In_reads_bytes_(TicketLength)
+        const uint8_t* Ticket,
+    _Out_ uint16_t* PartitionIndex
+    )
+{
+    if (TicketLength != QUIC_TICKET_CACHE_REF_LENGTH ||
+        Ticket[0] != QUIC_TICKET_CACHE_REF_MARKER) {
+        return FALSE;
+    }
+    CxPlatCopyMemory(PartitionIndex, Ticket + 1, sizeof(*PartitionIndex));
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicTicketCacheLookup(
+    _In_ QUIC_TICKET_CACHE* Cache,
+    _In_reads_bytes_(QUIC_TICKET_CACHE_REF_LENGTH)
+        const uint8_t* Ref,
+    _Out_writes_bytes_to_(QUIC_TICKET_CACHE_MAX_TICKET_LENGTH, *TicketLength)
+        uint8_t* Ticket,
+    _Out_ uint16_t* TicketLength
+    )
+{
+    uint32_t Slot;
+    uint64_t TicketId;
+    CxPlatCopyMemory(&Slot, Ref + 3, sizeof(Slot));
+    CxPlatCopyMemory(&TicketId, Ref + 7, sizeof(TicketId));
+
+    if (Slot >= Cache->EntryCount || TicketId == 0) {
+        return FALSE;
+    }
+
+    QUIC_TICKET_CACHE_ENTRY* Entry = &Cache->Entries[Slot];
+    for (uint32_t Attempt = 0; Attempt < 4; ++Attempt) {
+        long Sequence = QuicTicketCacheReadSequence(Entry);
+        if (Sequence & 1) {
+            continue; // A writer is updating the entry.
+        }
+        if (Entry->TicketId != TicketId) {
+            return FALSE; // Evicted or flushed.
+        }
+        uint16_t Length = Entry->TicketLength;
+        if (Length > QUIC_TICKET_CACHE_MAX_TICKET_LENGTH) {
+            continue; // Torn read.
+        }
+        CxPlatCopyMemory(Ticket, Entry->Ticket, Length);
+        if (QuicTicketCacheReadSequence(Entry) == Sequence) {
+            Entry->Referenced = TRUE;
+            *TicketLength = Length;
+            return TRUE;
+        }
+    }
+
+    return FALSE; // Too contended; treat as a miss.
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicTicketCacheFlush(
+    _Inout_ QUIC_TICKET_CACHE* Cache
+    )
+{
+    if (Cache->EntryCount == 0) {
+        return;
+    }
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    for (uint32_t i = 0; i < Cache->EntryCount; ++i) {
+        QUIC_TICKET_CACHE_ENTRY* Entry = &Cache->Entries[i];
+        if (Entry->TicketId != 0) {
+            InterlockedIncrement(&Entry->Sequence);
+            Entry->TicketId = 0;
+            Entry->TicketLength = 0;
+            Entry->Referenced = FALSE;
+            CxPlatSecureZeroMemory(Entry->Ticket, sizeof(Entry->Ticket));
+            InterlockedIncrement(&Entry->Sequence);
+        }
+    }
+    Cache->Hand = 0;
+    CxPlatDispatchLockRelease(&Cache->Lock);
 }
 
 //
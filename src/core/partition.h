@@ -48,6 +48,138 @@ typedef struct QUIC_RETRY_KEY {
     int64_t Index;
 } QUIC_RETRY_KEY;
 
+//
+// The number of retired Initial packet keys each partition keeps around to be
+// re-keyed in place by new connections.
+//
+#define QUIC_PARTITION_INITIAL_KEY_CACHE_SIZE 64
+
+//
+// The largest encoded server ticket the ticket cache stores. Larger tickets
+// are sent statelessly instead.
+//
+#define QUIC_TICKET_CACHE_MAX_TICKET_LENGTH 512
+
+//
+// The length of a reference to a cached ticket, which is sent in its place:
+//   Marker (1) | Partition Index (2) | Slot (4) | Ticket ID (8)
+//
+// The marker can't start a stateless ticket, whose first byte is a small
+// varint version number.
+//
+#define QUIC_TICKET_CACHE_REF_MARKER        0xFF
+#define QUIC_TICKET_CACHE_REF_LENGTH        15
+
+typedef struct QUIC_TICKET_CACHE_ENTRY {
+
+    //
+    // Odd while a writer is updating the entry. Readers copy the entry out and
+    // retry if it changed underneath them.
+    //
+    long volatile Sequence;
+
+    //
+    // Set on lookup and cleared by the eviction clock hand, so recently used
+    // tickets get a second chance before being evicted.
+    //
+    BOOLEAN Referenced;
+
+    uint16_t TicketLength;
+
+    //
+    // Random ID of the cached ticket. Zero means the entry is empty.
+    //
+    uint64_t TicketId;
+
+    uint8_t Ticket[QUIC_TICKET_CACHE_MAX_TICKET_LENGTH];
+
+} QUIC_TICKET_CACHE_ENTRY;
+
+//
+// A bounded, stateful cache of the server's resumption tickets. Lookups are
+// lock-free, since a resumed connection may land on any partition. Inserts and
+// flushes are serialized by the lock.
+//
+typedef struct QUIC_TICKET_CACHE {
+
+    CXPLAT_DISPATCH_LOCK Lock;
+
+    //
+    // Number of entries. Zero means the cache is disabled.
+    //
+    uint32_t EntryCount;
+
+    //
+    // The eviction clock hand.
+    //
+    uint32_t Hand;
+
+    QUIC_TICKET_CACHE_ENTRY* Entries;
+
+} QUIC_TICKET_CACHE;
+
+//
+// The number of stateless reset hashes a partition keeps, so that concurrent
+// token generation on the partition rarely has to wait.
+//
+#define QUIC_RESET_TOKEN_HASH_COUNT 4
+
+//
+// The number of connections whose received packets a partition stages at once.
+//
+#define QUIC_PARTITION_RECV_STAGE_SIZE 16
+
+typedef struct QUIC_RECV_STAGE_ENTRY {
+
+    //
+    // Holds the lookup reference taken when the first packets were staged.
+    //
+    QUIC_CONNECTION* Connection;
+
+    QUIC_RX_PACKET* Head;
+    QUIC_RX_PACKET** Tail;
+    uint32_t Length;
+    uint32_t Bytes;
+
+} QUIC_RECV_STAGE_ENTRY;
+
+//
+// Packets received on the partition's worker thread, chained per connection
+// across all the datapath indications of one round of event processing. The
+// stage's execution context then queues each connection's packets in one go,
+// so the connection gets a single receive operation and worker wake up
+// instead of one per indication. Only accessed on the worker thread.
+//
+typedef struct QUIC_RECV_STAGE {
+
+    CXPLAT_EXECUTION_CONTEXT ExecutionContext;
+    CXPLAT_EVENT Done;
+    BOOLEAN Enabled;
+
+    uint32_t Count;
+    QUIC_RECV_STAGE_ENTRY Entries[QUIC_PARTITION_RECV_STAGE_SIZE];
+
+} QUIC_RECV_STAGE;
+
+//
+// What tracked memory is used for. In the same order as the fields of
+// QUIC_MEMORY_USAGE.
+//
+typedef enum QUIC_MEMORY_TYPE {
+    QUIC_MEMORY_TYPE_CONNECTION,
+    QUIC_MEMORY_TYPE_STREAM,
+    QUIC_MEMORY_TYPE_RECV_BUFFER,
+    QUIC_MEMORY_TYPE_SEND_BUFFER,
+    QUIC_MEMORY_TYPE_SENT_PACKET_METADATA,
+    QUIC_MEMORY_TYPE_LOOKUP,
+    QUIC_MEMORY_TYPE_TIMER_WHEEL,
+    QUIC_MEMORY_TYPE_COUNT
+} QUIC_MEMORY_TYPE;
+
+CXPLAT_STATIC_ASSERT(
+    sizeof(QUIC_MEMORY_USAGE) == QUIC_MEMORY_TYPE_COUNT * sizeof(uint64_t),
+    "QUIC_MEMORY_USAGE must have a field per memory type");
+
 typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
 
     //
@@ -60,6 +192,11 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     //
     uint16_t Processor;
 
+    //
+    // The NUMA node of the processor.
+    //
+    uint16_t NumaNode;
+
     //
     // Log correlation ID for events.
     //
@@ -68,10 +205,12 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     uint64_t ReceivePacketId;
 
     //
-    // Used for generating stateless reset hashes.
+    // Used for generating stateless reset hashes, without a lock: a caller
+    // takes any of the (identically keyed) hashes for its exclusive use and
+    // puts it back in the same slot once done.
     //
-    CXPLAT_HASH* ResetTokenHash;
-    CXPLAT_LOCK ResetTokenLock;
+    CXPLAT_HASH* volatile ResetTokenHashes[QUIC_RESET_TOKEN_HASH_COUNT];
+    CXPLAT_LOCK ResetTokenLock; // Serializes key updates.
 
     //
     // Two most recent keys used for generating stateless retries.
@@ -79,6 +218,26 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     CXPLAT_DISPATCH_LOCK StatelessRetryKeysLock;
     QUIC_RETRY_KEY StatelessRetryKeys[2];
 
+    //
+    // Resumption tickets issued by server connections on this partition.
+    //
+    QUIC_TICKET_CACHE TicketCache;
+
+    //
+    // Retired Initial packet keys, re-keyed in place for new connections to
+    // avoid creating cipher contexts for every inbound Initial.
+    //
+    CXPLAT_DISPATCH_LOCK InitialKeysLock;
+    uint16_t InitialKeyCount;
+    QUIC_PACKET_KEY* InitialKeys[QUIC_PARTITION_INITIAL_KEY_CACHE_SIZE];
+
+#ifndef _KERNEL_MODE
+    //
+    // Received packets staged for delivery to their connections.
+    //
+    QUIC_RECV_STAGE RecvStage;
+#endif
+
     //
     // Pools for allocations.
     //
@@ -86,8 +245,9 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     CXPLAT_POOL TransportParamPool;         // QUIC_TRANSPORT_PARAMETER
     CXPLAT_POOL PacketSpacePool;            // QUIC_PACKET_SPACE
     CXPLAT_POOL StreamPool;                 // QUIC_STREAM
-    CXPLAT_POOL DefaultReceiveBufferPool;   // QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE
+    CXPLAT_POOL RecvChunkPools[QUIC_RECV_CHUNK_POOL_CLASS_COUNT]; // QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE << i
     CXPLAT_POOL SendRequestPool;            // QUIC_SEND_REQUEST
+    CXPLAT_POOL SendBufferPools[QUIC_SEND_BUFFER_POOL_CLASS_COUNT]; // QUIC_SEND_BUFFER_POOL_MIN_SIZE << i
     QUIC_SENT_PACKET_POOL SentPacketPool;   // QUIC_SENT_PACKET_METADATA
     CXPLAT_POOL ApiContextPool;             // QUIC_API_CONTEXT
     CXPLAT_POOL StatelessContextPool;       // QUIC_STATELESS_CONTEXT
@@ -99,6 +259,22 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     //
     int64_t PerfCounters[QUIC_PERF_COUNTER_MAX];
 
+    //
+    // Memory allocated and freed on the partition's processors, by type. A
+    // single partition's count can be negative, only the sum is meaningful.
+    //
+    int64_t MemoryUsage[QUIC_MEMORY_TYPE_COUNT];
+
+    //
+    // Latency histograms of the partition's workers and connections.
+    //
+    QUIC_LATENCY_HISTOGRAMS Latency;
+
+    //
+    // qlog events recorded by captured connections on this partition.
+    //
+    QUIC_QLOG_RING QlogRing;
+
 } QUIC_PARTITION;
 
 //
@@ -112,7 +288,9 @@ QuicPartitionInitialize(
     _In_ CXPLAT_HASH_TYPE HashType,
     _In_reads_(ResetHashKeyLength)
         const uint8_t* const ResetHashKey,
-    _In_ uint32_t ResetHashKeyLength
+    _In_ uint32_t ResetHashKeyLength,
+    _In_ uint32_t TicketCacheSize,
+    _In_ const QUIC_POOL_RESERVE_CONFIG* PoolReserve
     );
 
 void
@@ -120,6 +298,33 @@ QuicPartitionUninitialize(
     _Inout_ QUIC_PARTITION* Partition
     );
 
+#ifndef _KERNEL_MODE
+//
+// Starts the partition's receive staging on the library's worker pool.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPartitionStartRecvStage(
+    _Inout_ QUIC_PARTITION* Partition
+    );
+
+//
+// Stages the packets for a connection, to be queued to it after the current
+// round of event processing. Returns FALSE if the packets can't be staged on
+// this thread and must be queued directly. On success, takes ownership of the
+// packets and the connection's lookup reference.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPartitionStageRecvPackets(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packets,
+    _In_ uint32_t PacketChainLength,
+    _In_ uint32_t PacketChainByteLength
+    );
+#endif
+
 //
 // Returns the current stateless retry key.
 //
@@ -143,6 +348,48 @@ QuicPartitionGetStatelessRetryKeyForTimestamp(
     _In_ int64_t Timestamp
     );
 
+//
+// Takes a stateless reset hash for exclusive use, which must be returned with
+// QuicPartitionReturnResetTokenHash. Only waits if every hash is in use.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+CXPLAT_HASH*
+QuicPartitionTakeResetTokenHash(
+    _Inout_ QUIC_PARTITION* Partition,
+    _Out_ uint32_t* Index
+    )
+{
+    for (;;) {
+        for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+            CXPLAT_HASH* Hash =
+                (CXPLAT_HASH*)InterlockedFetchAndClearPointer(
+                    (void* volatile*)&Partition->ResetTokenHashes[i]);
+            if (Hash != NULL) {
+                *Index = i;
+                return Hash;
+            }
+        }
+        CxPlatSchedulerYield();
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicPartitionReturnResetTokenHash(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_ uint32_t Index,
+    _In_ CXPLAT_HASH* Hash
+    )
+{
+    void* Prev =
+        InterlockedExchangePointer(
+            (void* volatile*)&Partition->ResetTokenHashes[Index], Hash);
+    CXPLAT_DBG_ASSERT(Prev == NULL);
+    UNREFERENCED_PARAMETER(Prev);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_INLINE
 QUIC_STATUS
@@ -154,25 +401,64 @@ QuicPartitionUpdateStatelessResetKey(
     _In_ uint32_t ResetHashKeyLength
     )
 {
-    CXPLAT_HASH* NewResetTokenHash = NULL;
-    QUIC_STATUS Status =
-        CxPlatHashCreate(
-            HashType,
-            ResetHashKey,
-            ResetHashKeyLength,
-            &NewResetTokenHash);
-    if (QUIC_FAILED(Status)) {
-        return Status;
+    CXPLAT_HASH* NewResetTokenHashes[QUIC_RESET_TOKEN_HASH_COUNT] = {0};
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        Status =
+            CxPlatHashCreate(
+                HashType,
+                ResetHashKey,
+                ResetHashKeyLength,
+                &NewResetTokenHashes[i]);
+        if (QUIC_FAILED(Status)) {
+            for (uint32_t j = 0; j < i; ++j) {
+                CxPlatHashFree(NewResetTokenHashes[j]);
+            }
+            return Status;
+        }
     }
 
+    //
+    // Swap each hash once whoever is using it puts it back, so that no hash
+    // for the old key is put back after the swap.
+    //
     CxPlatLockAcquire(&Partition->ResetTokenLock);
-    CxPlatHashFree(Partition->ResetTokenHash);
-    Partition->ResetTokenHash = NewResetTokenHash;
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        CXPLAT_HASH* OldResetTokenHash;
+        while ((OldResetTokenHash =
+                (CXPLAT_HASH*)InterlockedFetchAndClearPointer(
+                    (void* volatile*)&Partition->ResetTokenHashes[i])) == NULL) {
+            CxPlatSchedulerYield();
+        }
+        QuicPartitionReturnResetTokenHash(Partition, i, NewResetTokenHashes[i]);
+        CxPlatHashFree(OldResetTokenHash);
+    }
     CxPlatLockRelease(&Partition->ResetTokenLock);
 
     return QUIC_STATUS_SUCCESS;
 }
 
+//
+// Takes a cached Initial packet key, if any, to be re-keyed in place.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+QUIC_PACKET_KEY*
+QuicPartitionAcquireInitialKey(
+    _In_ QUIC_PARTITION* Partition
+    );
+
+//
+// Returns an Initial packet key to the partition's cache, or frees it if the
+// cache is full.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPartitionReleaseInitialKey(
+    _In_ QUIC_PARTITION* Partition,
+    _In_opt_ QUIC_PACKET_KEY* Key
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
 void
@@ -186,6 +472,110 @@ QuicPerfCounterAdd(
     InterlockedExchangeAdd64(&Partition->PerfCounters[Type], Value);
 }
 
+//
+// Initializes the ticket cache with room for EntryCount tickets. Zero leaves
+// the cache disabled.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicTicketCacheInitialize(
+    _Inout_ QUIC_TICKET_CACHE* Cache,
+    _In_ uint32_t EntryCount
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTicketCacheUninitialize(
+    _Inout_ QUIC_TICKET_CACHE* Cache
+    );
+
+//
+// Stores the encoded ticket, evicting a least recently used one if the cache
+// is full, and writes out the reference to send in its place. Returns FALSE if
+// the ticket must be sent statelessly.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicTicketCacheInsert(
+    _Inout_ QUIC_TICKET_CACHE* Cache,
+    _In_ uint16_t PartitionIndex,
+    _In_ uint32_t TicketLength,
+    _In_reads_bytes_(TicketLength)
+        const uint8_t* Ticket,
+    _Out_writes_bytes_all_(QUIC_TICKET_CACHE_REF_LENGTH)
+        uint8_t* Ref
+    );
+
+//
+// Returns TRUE if the received ticket is a reference to a cached ticket, and
+// the partition index of the cache that holds it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicTicketCacheIsRef(
+    _In_ uint32_t TicketLength,
+    _In_reads_bytes_(TicketLength)
+        const uint8_t* Ticket,
+    _Out_ uint16_t* PartitionIndex
+    );
+
+//
+// Copies out the ticket a reference points to. Returns FALSE if it has been
+// evicted or flushed. Doesn't take any locks.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicTicketCacheLookup(
+    _In_ QUIC_TICKET_CACHE* Cache,
+    _In_reads_bytes_(QUIC_TICKET_CACHE_REF_LENGTH)
+        const uint8_t* Ref,
+    _Out_writes_bytes_to_(QUIC_TICKET_CACHE_MAX_TICKET_LENGTH, *TicketLength)
+        uint8_t* Ticket,
+    _Out_ uint16_t* TicketLength
+    );
+
+//
+// Removes every ticket, revoking resumption for all of them.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicTicketCacheFlush(
+    _Inout_ QUIC_TICKET_CACHE* Cache
+    );
+
+//
+// Returns the QUIC_LATENCY_HISTOGRAMS bucket for a sample. The top two bits
+// below the leading one pick the linear sub-bucket.
+//
+QUIC_INLINE
+uint32_t
+QuicLatencyBucket(
+    _In_ uint64_t TimeUs
+    )
+{
+    if (TimeUs < 4) {
+        return (uint32_t)TimeUs;
+    }
+    uint32_t Exponent = 2;
+    while (Exponent < 63 && (TimeUs >> (Exponent + 1)) != 0) {
+        Exponent++;
+    }
+    const uint32_t Bucket =
+        ((Exponent - 1) << 2) + (uint32_t)((TimeUs >> (Exponent - 2)) & 3);
+    return CXPLAT_MIN(Bucket, QUIC_LATENCY_BUCKET_COUNT - 1);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicLatencyRecord(
+    _Inout_updates_(QUIC_LATENCY_BUCKET_COUNT) uint64_t* Histogram,
+    _In_ uint64_t TimeUs
+    )
+{
+    InterlockedIncrement64((int64_t*)&Histogram[QuicLatencyBucket(TimeUs)]);
+}
+
 #define QuicPerfCounterIncrement(Partition, Type) QuicPerfCounterAdd(Partition, Type, 1)
 #define QuicPerfCounterDecrement(Partition, Type) QuicPerfCounterAdd(Partition, Type, -1)
 
@@ -29,16 +29,18 @@ QuicPathInitialize(
     Path->ID = Connection->NextPathId++; // TODO - Check for duplicates after wrap around?
     Path->InUse = TRUE;
     Path->MinRtt = UINT32_MAX;
-    Path->Mtu = Connection->Settings.MinimumMtu;
-    Path->SmoothedRtt = MS_TO_US(Connection->Settings.InitialRttMs);
+    Path->Mtu = Connection->Settings->MinimumMtu;
+    Path->SmoothedRtt = MS_TO_US(Connection->Settings->InitialRttMs);
     Path->RttVariance = Path->SmoothedRtt / 2;
     Path->EcnValidationState =
-        Connection->Settings.EcnEnabled ? ECN_VALIDATION_TESTING : ECN_VALIDATION_FAILED;
+        Connection->Settings->EcnEnabled ? ECN_VALIDATION_TESTING : ECN_VALIDATION_FAILED;
 
-    if (Connection->Settings.QTIPEnabled) {
+    if (Connection->Settings->QTIPEnabled) {
         CxPlatRandom(sizeof(Path->Route.TcpState.SequenceNumber), &Path->Route.TcpState.SequenceNumber);
     }
 
+    QuicPathInitSpinBit(Connection, Path);
+
     QuicTraceLogConnInfo(
         PathInitialized,
         Connection,
@@ -46,6 +48,26 @@ QuicPathInitialize(
         Path->ID);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPathInitSpinBit(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    )
+{
+    uint32_t Random;
+    CxPlatRandom(sizeof(Random), &Random);
+
+    //
+    // RFC 9000 section 17.4 - The spin bit must be disabled on a random
+    // selection of paths. Disabled paths send a random, but fixed, value
+    // rather than a constant, so they can't be told apart from an idle path.
+    //
+    Path->SpinBitDisabled =
+        (uint16_t)(Random % UINT16_MAX) < Connection->Settings->SpinBitDisableRate;
+    Path->SpinBit = Path->SpinBitDisabled ? (Random >> 31) : FALSE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicPathRemove(
@@ -69,11 +91,16 @@ QuicPathRemove(
         Path->ID);
 
 #if DEBUG
-    if (Path->DestCid) {
+    if (Path->DestCid && !Path->IsRacing) { // Racing paths share the active path's CID.
         QUIC_CID_CLEAR_PATH(Path->DestCid);
     }
 #endif
 
+    if (Path->IsStandby) {
+        QuicBindingRemoveStandbyConnection(Path->Binding, Connection);
+        QuicLibraryReleaseBinding(Path->Binding);
+    }
+
     if (Index + 1 < Connection->PathsCount) {
         CxPlatMoveMemory(
             Connection->Paths + Index,
@@ -197,7 +224,8 @@ QuicConnGetPathForPacket(
             !QuicAddrCompare(
                 &Packet->Route->RemoteAddress,
                 &Connection->Paths[i].Route.RemoteAddress)) {
-            if (!Connection->State.HandshakeConfirmed) {
+            if (!Connection->State.HandshakeConfirmed &&
+                !Connection->State.HappyEyeballsRacing) {
                 //
                 // Ignore packets on any other paths until connected/confirmed.
                 //
@@ -208,6 +236,10 @@ QuicConnGetPathForPacket(
         return &Connection->Paths[i];
     }
 
+    if (!Connection->State.HandshakeConfirmed) {
+        return NULL; // Not from any of the racing happy eyeballs paths.
+    }
+
     if (Connection->PathsCount == QUIC_MAX_PATH_COUNT) {
         //
         // See if any old paths share the same remote address, and is just a rebind.
@@ -272,11 +304,37 @@ QuicPathSetActive(
     } else {
         CXPLAT_DBG_ASSERT(Path->DestCid != NULL);
         UdpPortChangeOnly =
+            Path->Binding == Connection->Paths[0].Binding &&
             QuicAddrGetFamily(&Path->Route.RemoteAddress) == QuicAddrGetFamily(&Connection->Paths[0].Route.RemoteAddress) &&
             QuicAddrCompareIp(&Path->Route.RemoteAddress, &Connection->Paths[0].Route.RemoteAddress);
 
         QUIC_PATH PrevActivePath = Connection->Paths[0];
 
+        if (Path->IsStandby) {
+            //
+            // The standby path has its own (exclusive) binding. Move the
+            // source CIDs over to it, and keep the previous active path's
+            // binding around as a standby in its place. That path may be why
+            // we are switching, so it must answer a probe before it can be
+            // switched back to.
+            //
+            QuicBindingRemoveStandbyConnection(Path->Binding, Connection);
+            QuicBindingMoveSourceConnectionIDs(
+                PrevActivePath.Binding, Path->Binding, Connection);
+            BOOLEAN Result =
+                QuicBindingAddStandbyConnection(PrevActivePath.Binding, Connection);
+            CXPLAT_DBG_ASSERT(Result); // Standby paths require exclusive bindings.
+            UNREFERENCED_PARAMETER(Result);
+            Path->IsStandby = FALSE;
+            Path->StandbyProbePending = FALSE;
+            PrevActivePath.IsStandby = TRUE;
+            PrevActivePath.StandbyProbePending = TRUE;
+            PrevActivePath.SendChallenge = TRUE;
+            PrevActivePath.PathValidationStartTime = CxPlatTimeUs64();
+            CxPlatRandom(sizeof(PrevActivePath.Challenge), PrevActivePath.Challenge);
+            QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PATH_CHALLENGE);
+        }
+
         PrevActivePath.IsActive = FALSE;
         Path->IsActive = TRUE;
         if (UdpPortChangeOnly) {
@@ -288,6 +346,7 @@ QuicPathSetActive(
 
         Connection->Paths[0] = *Path;
         *Path = PrevActivePath;
+        Connection->SpinRtt.LastEdgeTime = 0;
     }
 
     QuicTraceLogConnInfo(
@@ -304,6 +363,30 @@ QuicPathSetActive(
     CXPLAT_DBG_ASSERT(!Path->DestCid->CID.Retired);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnFailoverToStandbyPath(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    for (uint8_t i = 1; i < Connection->PathsCount; ++i) {
+        QUIC_PATH* Path = &Connection->Paths[i];
+        if (!Path->IsStandby || Path->IsRacing || !Path->IsPeerValidated ||
+            Path->StandbyProbePending) {
+            continue; // Only fail over to a path that answered its last probe.
+        }
+
+        //
+        // The congestion controller is reset for the new path, but its RTT
+        // estimate comes from the standby's own path challenges instead of
+        // the initial RTT.
+        //
+        QuicPathSetActive(Connection, Path);
+        return TRUE;
+    }
+    return FALSE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicPathUpdateQeo(
@@ -116,6 +116,36 @@ typedef struct QUIC_PATH {
     //
     BOOLEAN EncryptionOffloading : 1;
 
+    //
+    // Indicates this is a pre-validated standby path, with its own binding,
+    // that the connection can fail over to.
+    //
+    BOOLEAN IsStandby : 1;
+
+    //
+    // Indicates a keep-alive path challenge is outstanding on this (already
+    // validated) standby path.
+    //
+    BOOLEAN StandbyProbePending : 1;
+
+    //
+    // Indicates this standby path is to the server's preferred address, and
+    // the client migrates to it as soon as it is validated.
+    //
+    BOOLEAN IsPreferredAddress : 1;
+
+    //
+    // Indicates this (client) path, with its own binding, is a happy eyeballs
+    // attempt to the server's other address family, racing the active path.
+    //
+    BOOLEAN IsRacing : 1;
+
+    //
+    // Indicates the latency spin bit is disabled on this path, so SpinBit is
+    // a fixed random value and the peer's spin bit is ignored.
+    //
+    BOOLEAN SpinBitDisabled : 1;
+
     //
     // The ending time of ECN validation testing state in microseconds.
     //
@@ -185,6 +215,12 @@ typedef struct QUIC_PATH {
     //
     uint64_t PathValidationStartTime;
 
+    //
+    // Time the last path challenge was sent. Used to measure the RTT of
+    // standby paths, which carry no other traffic.
+    //
+    uint64_t ChallengeSentTime;
+
 } QUIC_PATH;
 
 #if DEBUG
@@ -209,6 +245,17 @@ QuicPathInitialize(
     _In_ QUIC_PATH* Path
     );
 
+//
+// Randomly decides, per the SpinBitDisableRate setting, whether the path uses
+// the latency spin bit.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPathInitSpinBit(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicPathRemove(
@@ -286,6 +333,16 @@ QuicPathSetActive(
     _In_ QUIC_PATH* Path
     );
 
+//
+// Switches the active path to the first validated standby path, if there is
+// one. Returns TRUE if the active path changed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnFailoverToStandbyPath(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 _Ret_maybenull_
 _Success_(return != NULL)
@@ -0,0 +1,663 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A Prague style scalable congestion controller for L4S (RFC 9330,
+    draft-briscoe-iccrg-prague-congestion-control).
+
+    Packets are sent with ECT(1), so an L4S dual-queue AQM marks them early
+    and often instead of letting a queue build. The sender keeps Alpha, a per
+    round trip EWMA of the fraction of CE marked packets (from the QUIC ACK
+    frame's ECN counts), and on CE reduces the window by Alpha / 2, at most
+    once per round trip. A lightly marked path therefore only gives up a small
+    part of its window, which keeps the queue (and the sawtooth) very shallow.
+
+    Loss is still treated as a classic congestion signal and halves the
+    window, the same as Reno, so the controller stays safe on paths which
+    don't support L4S.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "prague.c.clog.h"
+#endif
+
+#include "prague.h"
+
+//
+// EWMA gain for Alpha, as a shift (g = 1/16).
+//
+#define PRAGUE_ALPHA_GAIN_SHIFT 4
+
+//
+// Minimum window after a CE triggered reduction, in packets.
+//
+#define PRAGUE_MIN_WINDOW_PACKETS 2
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+    return Prague->BytesInFlight < Prague->CongestionWindow || Prague->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Prague.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Prague->SlowStartThreshold = UINT32_MAX;
+    Prague->IsInRecovery = FALSE;
+    Prague->IsInPersistentCongestion = FALSE;
+    Prague->HasHadCongestionEvent = FALSE;
+    Prague->CongestionWindow = DatagramPayloadLength * Prague->InitialWindowPackets;
+    Prague->BytesInFlightMax = Prague->CongestionWindow / 2;
+    Prague->LastSendAllowance = 0;
+    Prague->AiAccumulator = 0;
+    Prague->Alpha = PRAGUE_ALPHA_ONE;
+    Prague->EcnPacketsInRound = 0;
+    Prague->CePacketsInRound = 0;
+    Prague->AlphaRoundEnd = Connection->Send.NextPacketNumber;
+    if (FullReset) {
+        Prague->BytesInFlight = 0;
+    }
+
+    QuicConnLogOutFlowStats(Connection);
+}
+
+//
+// Same as Cubic: pace at the predicted window of the next round trip, which
+// is double the window in slow start and slightly larger in congestion
+// avoidance. L4S queues are short, so smooth pacing matters even more here.
+//
+QUIC_INLINE
+uint64_t
+PragueCongestionControlGetEstimatedWindow(
+    _In_ const QUIC_CONGESTION_CONTROL_PRAGUE* Prague
+    )
+{
+    uint64_t EstimatedWnd;
+    if (Prague->CongestionWindow < Prague->SlowStartThreshold) {
+        EstimatedWnd = (uint64_t)Prague->CongestionWindow << 1;
+        if (EstimatedWnd > Prague->SlowStartThreshold) {
+            EstimatedWnd = Prague->SlowStartThreshold;
+        }
+    } else {
+        EstimatedWnd = Prague->CongestionWindow + (Prague->CongestionWindow >> 3); // CongestionWindow * 1.125
+    }
+    return EstimatedWnd;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+PragueCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    uint32_t SendAllowance;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    if (Prague->BytesInFlight >= Prague->CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        !TimeSinceLastSendValid ||
+        !Connection->Settings->PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+        //
+        // We're not in the necessary state to pace.
+        //
+        SendAllowance = Prague->CongestionWindow - Prague->BytesInFlight;
+
+    } else {
+        //
+        // We are pacing, so split the congestion window into chunks which are
+        // spread out over the RTT.
+        //
+        uint64_t EstimatedWnd = PragueCongestionControlGetEstimatedWindow(Prague);
+
+        SendAllowance =
+            Prague->LastSendAllowance +
+            (uint32_t)((EstimatedWnd * TimeSinceLastSend) / Connection->Paths[0].SmoothedRtt);
+        if (SendAllowance < Prague->LastSendAllowance || // Overflow case
+            SendAllowance > (Prague->CongestionWindow - Prague->BytesInFlight)) {
+            SendAllowance = Prague->CongestionWindow - Prague->BytesInFlight;
+        }
+
+        Prague->LastSendAllowance = SendAllowance;
+    }
+    return SendAllowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+PragueCongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    if (!Connection->Settings->PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+        return 0;
+    }
+
+    return
+        S_TO_US(PragueCongestionControlGetEstimatedWindow(Prague)) /
+        Connection->Paths[0].SmoothedRtt;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+    if (PreviousCanSendState != PragueCongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+PragueCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    Prague->BytesInFlight += NumRetransmittableBytes;
+    if (Prague->BytesInFlightMax < Prague->BytesInFlight) {
+        Prague->BytesInFlightMax = Prague->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (NumRetransmittableBytes > Prague->LastSendAllowance) {
+        Prague->LastSendAllowance = 0;
+    } else {
+        Prague->LastSendAllowance -= NumRetransmittableBytes;
+    }
+
+    if (Prague->Exemptions > 0) {
+        --Prague->Exemptions;
+    }
+
+    PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= NumRetransmittableBytes);
+    Prague->BytesInFlight -= NumRetransmittableBytes;
+
+    return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlGetNetworkStatistics(
+    _In_ const QUIC_CONNECTION* const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL* const Cc,
+    _Out_ QUIC_NETWORK_STATISTICS* NetworkStatistics
+    )
+{
+    const QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+    const QUIC_PATH* Path = &Connection->Paths[0];
+
+    NetworkStatistics->BytesInFlight = Prague->BytesInFlight;
+    NetworkStatistics->PostedBytes = Connection->SendBuffer.PostedBytes;
+    NetworkStatistics->IdealBytes = Connection->SendBuffer.IdealBytes;
+    NetworkStatistics->SmoothedRTT = Path->SmoothedRtt;
+    NetworkStatistics->CongestionWindow = Prague->CongestionWindow;
+    NetworkStatistics->Bandwidth = Prague->CongestionWindow / Path->SmoothedRtt;
+}
+
+//
+// Folds the ECN feedback of the round trip that just ended into Alpha.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlUpdateAlpha(
+    _In_ QUIC_CONGESTION_CONTROL_PRAGUE* Prague
+    )
+{
+    if (Prague->EcnPacketsInRound != 0) {
+        const uint32_t MarkedFraction =
+            (uint32_t)(((uint64_t)Prague->CePacketsInRound << PRAGUE_ALPHA_SHIFT) /
+                Prague->EcnPacketsInRound);
+        //
+        // Alpha = (1 - g) * Alpha + g * MarkedFraction
+        //
+        Prague->Alpha =
+            Prague->Alpha -
+            (Prague->Alpha >> PRAGUE_ALPHA_GAIN_SHIFT) +
+            (CXPLAT_MIN(MarkedFraction, PRAGUE_ALPHA_ONE) >> PRAGUE_ALPHA_GAIN_SHIFT);
+    }
+    Prague->EcnPacketsInRound = 0;
+    Prague->CePacketsInRound = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+    uint32_t BytesAcked = AckEvent->NumRetransmittableBytes;
+
+    CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= BytesAcked);
+    Prague->BytesInFlight -= BytesAcked;
+
+    Prague->EcnPacketsInRound += AckEvent->EcnPackets;
+    Prague->CePacketsInRound += AckEvent->EcnCePackets;
+    if (AckEvent->LargestAck >= Prague->AlphaRoundEnd) {
+        PragueCongestionControlUpdateAlpha(Prague);
+        Prague->AlphaRoundEnd = Connection->Send.NextPacketNumber;
+    }
+
+    if (Prague->IsInRecovery) {
+        if (AckEvent->LargestAck > Prague->RecoverySentPacketNumber) {
+            QuicTraceEvent(
+                ConnRecoveryExit,
+                "[conn][%p] Recovery complete",
+                Connection);
+            Prague->IsInRecovery = FALSE;
+            Prague->IsInPersistentCongestion = FALSE;
+        }
+        goto Exit;
+    } else if (BytesAcked == 0) {
+        goto Exit;
+    }
+
+    if (Prague->CongestionWindow < Prague->SlowStartThreshold) {
+
+        //
+        // Slow Start
+        //
+
+        Prague->CongestionWindow += BytesAcked;
+        BytesAcked = 0;
+        if (Prague->CongestionWindow >= Prague->SlowStartThreshold) {
+            BytesAcked = Prague->CongestionWindow - Prague->SlowStartThreshold;
+            Prague->CongestionWindow = Prague->SlowStartThreshold;
+        }
+    }
+
+    if (BytesAcked > 0) {
+
+        //
+        // Congestion Avoidance: one packet per window of acknowledged bytes.
+        // Unlike loss recovery, a CE reduction doesn't pause this growth, as
+        // L4S marks are expected every few round trips in steady state.
+        //
+
+        const uint16_t DatagramPayloadLength =
+            QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+        Prague->AiAccumulator += BytesAcked;
+        if (Prague->AiAccumulator > Prague->CongestionWindow) {
+            Prague->AiAccumulator -= Prague->CongestionWindow;
+            Prague->CongestionWindow += DatagramPayloadLength;
+        }
+    }
+
+    //
+    // Limit the growth of the window based on the number of bytes we
+    // actually manage to put on the wire.
+    //
+    if (Prague->CongestionWindow > 2 * Prague->BytesInFlightMax) {
+        Prague->CongestionWindow = 2 * Prague->BytesInFlightMax;
+    }
+
+Exit:
+
+    if (Connection->Settings->NetStatsEventEnabled) {
+        QUIC_CONNECTION_EVENT Event;
+        Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+        PragueCongestionControlGetNetworkStatistics(
+            Connection, Cc, &Event.NETWORK_STATISTICS);
+
+        QuicTraceLogConnVerbose(
+           IndicateDataAcked,
+           Connection,
+           "Indicating QUIC_CONNECTION_EVENT_NETWORK_STATISTICS [BytesInFlight=%u,PostedBytes=%llu,IdealBytes=%llu,SmoothedRTT=%llu,CongestionWindow=%u,Bandwidth=%llu]",
+           Event.NETWORK_STATISTICS.BytesInFlight,
+           Event.NETWORK_STATISTICS.PostedBytes,
+           Event.NETWORK_STATISTICS.IdealBytes,
+           Event.NETWORK_STATISTICS.SmoothedRTT,
+           Event.NETWORK_STATISTICS.CongestionWindow,
+           Event.NETWORK_STATISTICS.Bandwidth);
+       QuicConnIndicateEvent(Connection, &Event);
+    }
+
+    return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    //
+    // Loss is a classic congestion signal: halve the window, at most once
+    // per round trip.
+    //
+    if (!Prague->HasHadCongestionEvent ||
+        LossEvent->LargestPacketNumberLost > Prague->RecoverySentPacketNumber) {
+
+        const uint16_t DatagramPayloadLength =
+            QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+        QuicTraceEvent(
+            ConnCongestionV2,
+            "[conn][%p] Congestion event: IsEcn=%hu",
+            Connection,
+            FALSE);
+        QuicTraceProbe(congestion_event, Connection, FALSE);
+        Connection->Stats.Send.CongestionCount++;
+
+        Prague->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
+        Prague->HasHadCongestionEvent = TRUE;
+        Prague->IsInRecovery = TRUE;
+        Prague->PrevCongestionWindow = Prague->CongestionWindow;
+        Prague->PrevSlowStartThreshold = Prague->SlowStartThreshold;
+
+        Prague->SlowStartThreshold =
+            CXPLAT_MAX(
+                (uint32_t)DatagramPayloadLength * QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS,
+                Prague->CongestionWindow / 2);
+
+        if (LossEvent->PersistentCongestion && !Prague->IsInPersistentCongestion) {
+            QuicTraceEvent(
+                ConnPersistentCongestion,
+                "[conn][%p] Persistent congestion event",
+                Connection);
+            Connection->Stats.Send.PersistentCongestionCount++;
+            Connection->Paths[0].Route.State = RouteSuspected; // used only for RAW datapath
+
+            Prague->IsInPersistentCongestion = TRUE;
+            Prague->CongestionWindow =
+                DatagramPayloadLength * QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS;
+        } else {
+            Prague->CongestionWindow = Prague->SlowStartThreshold;
+        }
+        Prague->AiAccumulator = 0;
+    }
+
+    CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Prague->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    //
+    // Reduce the window in proportion to the marking level, at most once per
+    // round trip.
+    //
+    if (!Prague->HasHadCongestionEvent ||
+        EcnEvent->LargestPacketNumberAcked > Prague->RecoverySentPacketNumber) {
+
+        const uint16_t DatagramPayloadLength =
+            QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+        QuicTraceEvent(
+            ConnCongestionV2,
+            "[conn][%p] Congestion event: IsEcn=%hu",
+            Connection,
+            TRUE);
+        QuicTraceProbe(congestion_event, Connection, TRUE);
+        Connection->Stats.Send.CongestionCount++;
+        Connection->Stats.Send.EcnCongestionCount++;
+
+        Prague->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
+        Prague->HasHadCongestionEvent = TRUE;
+
+        const uint32_t Reduction =
+            (uint32_t)(((uint64_t)Prague->CongestionWindow * Prague->Alpha) >>
+                (PRAGUE_ALPHA_SHIFT + 1));
+        Prague->SlowStartThreshold =
+        Prague->CongestionWindow =
+            CXPLAT_MAX(
+                (uint32_t)DatagramPayloadLength * PRAGUE_MIN_WINDOW_PACKETS,
+                Prague->CongestionWindow - Reduction);
+    }
+
+    PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    if (!Prague->IsInRecovery) {
+        return FALSE;
+    }
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    QuicTraceEvent(
+        ConnSpuriousCongestion,
+        "[conn][%p] Spurious congestion event",
+        Connection);
+
+    Prague->SlowStartThreshold = Prague->PrevSlowStartThreshold;
+    Prague->CongestionWindow = Prague->PrevCongestionWindow;
+    Prague->IsInRecovery = FALSE;
+    Prague->HasHadCongestionEvent = FALSE;
+
+    return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+void
+PragueCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Prague->BytesInFlight,
+        Prague->CongestionWindow,
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+uint32_t
+PragueCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Prague.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+PragueCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Prague.Exemptions;
+}
+
+uint32_t
+PragueCongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Prague.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_ECN_TYPE
+PragueCongestionControlGetEcnCodepoint(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return CXPLAT_ECN_ECT_1;
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlPrague = {
+    .Name = "Prague",
+    .Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE,
+    .QuicCongestionControlCanSend = PragueCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = PragueCongestionControlSetExemption,
+    .QuicCongestionControlReset = PragueCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = PragueCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = PragueCongestionControlGetPacingRate,
+    .QuicCongestionControlGetDeliveryRate = NULL,
+    .QuicCongestionControlOnDataSent = PragueCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = PragueCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = PragueCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = PragueCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = PragueCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = PragueCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = PragueCongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = PragueCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = PragueCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = PragueCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = PragueCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow = PragueCongestionControlGetCongestionWindow,
+    .QuicCongestionControlGetNetworkStatistics = PragueCongestionControlGetNetworkStatistics,
+    .QuicCongestionControlGetEcnCodepoint = PragueCongestionControlGetEcnCodepoint
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    *Cc = QuicCongestionControlPrague;
+
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Prague->SlowStartThreshold = UINT32_MAX;
+    Prague->InitialWindowPackets = Settings->InitialWindowPackets;
+    Prague->CongestionWindow = DatagramPayloadLength * Prague->InitialWindowPackets;
+    Prague->BytesInFlightMax = Prague->CongestionWindow / 2;
+    Prague->Alpha = PRAGUE_ALPHA_ONE;
+    Prague->AlphaRoundEnd = Connection->Send.NextPacketNumber;
+
+    QuicConnLogOutFlowStats(Connection);
+}
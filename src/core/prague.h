@@ -0,0 +1,110 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Fixed point scale of Alpha (1.0 == PRAGUE_ALPHA_ONE).
+//
+#define PRAGUE_ALPHA_SHIFT 16
+#define PRAGUE_ALPHA_ONE (1u << PRAGUE_ALPHA_SHIFT)
+
+typedef struct QUIC_CONGESTION_CONTROL_PRAGUE {
+
+    //
+    // TRUE if we have had at least one congestion event.
+    // If TRUE, RecoverySentPacketNumber is valid.
+    //
+    BOOLEAN HasHadCongestionEvent : 1;
+
+    //
+    // This flag indicates a loss triggered congestion event occurred and CC
+    // is attempting to recover from it. CE triggered reductions don't pause
+    // window growth, so they don't set this.
+    //
+    BOOLEAN IsInRecovery : 1;
+
+    //
+    // This flag indicates a persistent congestion event occurred and CC is
+    // attempting to recover from it.
+    //
+    BOOLEAN IsInPersistentCongestion : 1;
+
+    //
+    // The size of the initial congestion window, in packets.
+    //
+    uint32_t InitialWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+    uint32_t PrevCongestionWindow; // bytes
+    uint32_t SlowStartThreshold; // bytes
+    uint32_t PrevSlowStartThreshold; // bytes
+
+    //
+    // Acknowledged bytes accumulated during congestion avoidance, used to
+    // grow the window by one packet per window of acknowledged bytes.
+    //
+    uint32_t AiAccumulator; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // The leftover send allowance from a previous send. Only used when pacing.
+    //
+    uint32_t LastSendAllowance; // bytes
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    // This is used to send probe packets for loss recovery.
+    //
+    uint8_t Exemptions;
+
+    //
+    // EWMA of the fraction of CE marked packets per round trip, scaled by
+    // PRAGUE_ALPHA_ONE. This drives how much the window is reduced on a CE
+    // mark, so that a lightly marked path only loses a small part of it.
+    //
+    uint32_t Alpha;
+
+    //
+    // ECN feedback accumulated over the current round trip, in packets.
+    //
+    uint32_t EcnPacketsInRound;
+    uint32_t CePacketsInRound;
+
+    //
+    // The packet number which ends the current round trip.
+    //
+    uint64_t AlphaRoundEnd;
+
+    //
+    // This variable tracks the largest packet that was outstanding at the time
+    // the last congestion event occurred. An ACK for any packet number greater
+    // than this indicates recovery is over.
+    //
+    uint64_t RecoverySentPacketNumber;
+
+} QUIC_CONGESTION_CONTROL_PRAGUE;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
+
+#if defined(__cplusplus)
+}
+#endif
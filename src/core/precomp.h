@@ -42,19 +42,26 @@
 // Internal Core Headers.
 //
 #include "quicdef.h"
+#include "arena.h"
 #include "cid.h"
+#include "load_balancing.h"
 #include "mtu_discovery.h"
 #include "path.h"
 #include "transport_params.h"
 #include "lookup.h"
 #include "timer_wheel.h"
+#include "pacing_queue.h"
 #include "settings.h"
 #include "sent_packet_metadata.h"
+#include "qlog.h"
+#include "recv_capture.h"
 #include "partition.h"
 #include "library.h"
 #include "operation.h"
 #include "binding.h"
 #include "api.h"
+#include "anti_replay.h"
+#include "client_ticket_cache.h"
 #include "registration.h"
 #include "configuration.h"
 #include "range.h"
@@ -74,8 +81,12 @@
 #include "datagram.h"
 #include "version_neg.h"
 #include "connection.h"
+#include "handoff.h"
 #include "packet_builder.h"
 #include "listener.h"
 #include "cubic.h"
 #include "bbr.h"
+#include "bbr3.h"
+#include "custom_cc.h"
+#include "prague.h"
 #include "sliding_window_extremum.h"
@@ -0,0 +1,464 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Captured connections record fixed size binary events into their
+    partition's ring, under a dispatch lock that is only ever taken for
+    captured connections. A single writer thread periodically moves the
+    events out of the rings in batches and writes them as JSON-SEQ (RFC 7464)
+    records, one trace for the whole library, with each connection's events
+    grouped by its correlation ID. Events that don't fit in a full ring are
+    dropped and reported as a warning, rather than ever blocking a worker.
+
+    File output is only supported in user mode.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "qlog.c.clog.h"
+#endif
+
+//
+// The number of events moved out of a ring at a time.
+//
+#define QUIC_QLOG_WRITE_BATCH_SIZE      64
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicQlogSetConfig(
+    _In_ const QUIC_QLOG_CONFIG* Config
+    )
+{
+#ifdef _KERNEL_MODE
+    UNREFERENCED_PARAMETER(Config);
+    return QUIC_STATUS_NOT_SUPPORTED;
+#else
+    if (MsQuicLib.LazyInitComplete) {
+        //
+        // The rings are allocated with the partitions.
+        //
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    char* FilePath = NULL;
+    if (Config->FilePath != NULL) {
+        if (Config->SampleRate == 0 || Config->SampleRate > 1000000) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        const size_t FilePathLength = strlen(Config->FilePath);
+        if (FilePathLength == 0) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        FilePath = CXPLAT_ALLOC_NONPAGED(FilePathLength + 1, QUIC_POOL_QLOG);
+        if (FilePath == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "qlog file path",
+                FilePathLength + 1);
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        CxPlatCopyMemory(FilePath, Config->FilePath, FilePathLength + 1);
+    }
+
+    if (MsQuicLib.Qlog.FilePath != NULL) {
+        CXPLAT_FREE(MsQuicLib.Qlog.FilePath, QUIC_POOL_QLOG);
+    }
+    MsQuicLib.Qlog.FilePath = FilePath;
+    MsQuicLib.Qlog.SampleRate = Config->SampleRate;
+    MsQuicLib.Qlog.RingSize =
+        Config->RingSize != 0 ? Config->RingSize : QUIC_QLOG_DEFAULT_RING_SIZE;
+
+    return QUIC_STATUS_SUCCESS;
+#endif
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogRingInitialize(
+    _Inout_ QUIC_QLOG_RING* Ring
+    )
+{
+    CxPlatDispatchLockInitialize(&Ring->Lock);
+    if (MsQuicLib.Qlog.FilePath == NULL) {
+        return;
+    }
+
+    Ring->Events =
+        CXPLAT_ALLOC_NONPAGED(
+            (size_t)MsQuicLib.Qlog.RingSize * sizeof(QUIC_QLOG_EVENT),
+            QUIC_POOL_QLOG);
+    if (Ring->Events == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "qlog ring",
+            (uint64_t)MsQuicLib.Qlog.RingSize * sizeof(QUIC_QLOG_EVENT));
+        return;
+    }
+    Ring->Size = MsQuicLib.Qlog.RingSize;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogRingUninitialize(
+    _Inout_ QUIC_QLOG_RING* Ring
+    )
+{
+    if (Ring->Events != NULL) {
+        CXPLAT_FREE(Ring->Events, QUIC_POOL_QLOG);
+        Ring->Events = NULL;
+    }
+    CxPlatDispatchLockUninitialize(&Ring->Lock);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicQlogRecord(
+    _In_ QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_QLOG_EVENT* Event
+    )
+{
+    QUIC_QLOG_RING* Ring = &Connection->Partition->QlogRing;
+    if (Ring->Events == NULL) {
+        return;
+    }
+
+    Event->TimeUs = CxPlatTimeUs64();
+    Event->CorrelationId = Connection->Stats.CorrelationId;
+
+    CxPlatDispatchLockAcquire(&Ring->Lock);
+    if (Ring->Count == Ring->Size) {
+        Ring->DroppedCount++;
+    } else {
+        Ring->Events[(Ring->Head + Ring->Count) % Ring->Size] = *Event;
+        Ring->Count++;
+    }
+    CxPlatDispatchLockRelease(&Ring->Lock);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicQlogOnConnectionCreated(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ BOOLEAN IsServer
+    )
+{
+    if (!MsQuicLib.Qlog.ThreadStarted ||
+        Connection->Partition->QlogRing.Events == NULL) {
+        return;
+    }
+
+    uint32_t Random;
+    CxPlatRandom(sizeof(Random), &Random);
+    if (Random % 1000000 >= MsQuicLib.Qlog.SampleRate) {
+        return;
+    }
+
+    Connection->State.QlogEnabled = TRUE;
+
+    QUIC_QLOG_EVENT Event;
+    Event.Type = QUIC_QLOG_EVENT_CONNECTION_STARTED;
+    Event.Started.IsServer = IsServer;
+    QuicQlogRecord(Connection, &Event);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnConnectionClosed(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_QLOG_EVENT Event;
+    Event.Type = QUIC_QLOG_EVENT_CONNECTION_CLOSED;
+    Event.Closed.Remote = Connection->State.ClosedRemotely;
+    Event.Closed.App = Connection->State.AppClosed;
+    Event.Closed.ErrorCode = Connection->CloseErrorCode;
+    QuicQlogRecord(Connection, &Event);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnPacketSent(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    QUIC_QLOG_EVENT Event;
+    Event.Type = QUIC_QLOG_EVENT_PACKET_SENT;
+    Event.Packet.KeyType = (uint8_t)Packet->Flags.KeyType;
+    Event.Packet.Length = Packet->PacketLength;
+    Event.Packet.PacketNumber = Packet->PacketNumber;
+    QuicQlogRecord(Connection, &Event);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnPacketReceived(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_RX_PACKET* Packet
+    )
+{
+    QUIC_QLOG_EVENT Event;
+    Event.Type = QUIC_QLOG_EVENT_PACKET_RECEIVED;
+    Event.Packet.KeyType = (uint8_t)Packet->KeyType;
+    Event.Packet.Length = Packet->HeaderLength + Packet->PayloadLength;
+    Event.Packet.PacketNumber = Packet->PacketNumber;
+    QuicQlogRecord(Connection, &Event);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnPacketLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    QUIC_QLOG_EVENT Event;
+    Event.Type = QUIC_QLOG_EVENT_PACKET_LOST;
+    Event.Packet.KeyType = (uint8_t)Packet->Flags.KeyType;
+    Event.Packet.Length = Packet->PacketLength;
+    Event.Packet.PacketNumber = Packet->PacketNumber;
+    QuicQlogRecord(Connection, &Event);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnMetricsUpdated(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_PATH* Path
+    )
+{
+    QUIC_QLOG_EVENT Event;
+    Event.Type = QUIC_QLOG_EVENT_METRICS_UPDATED;
+    Event.Metrics.SmoothedRtt = (uint32_t)CXPLAT_MIN(Path->SmoothedRtt, UINT32_MAX);
+    Event.Metrics.MinRtt = (uint32_t)CXPLAT_MIN(Path->MinRtt, UINT32_MAX);
+    Event.Metrics.LatestRtt = (uint32_t)CXPLAT_MIN(Path->LatestRttSample, UINT32_MAX);
+    Event.Metrics.CongestionWindow =
+        QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl);
+    Event.Metrics.PacketsInFlight = Connection->LossDetection.PacketsInFlight;
+    QuicQlogRecord(Connection, &Event);
+}
+
+#ifndef _KERNEL_MODE
+
+static
+const char*
+QuicQlogPacketType(
+    _In_ uint8_t KeyType
+    )
+{
+    switch (KeyType) {
+    case QUIC_PACKET_KEY_INITIAL:   return "initial";
+    case QUIC_PACKET_KEY_0_RTT:     return "0RTT";
+    case QUIC_PACKET_KEY_HANDSHAKE: return "handshake";
+    default:                        return "1RTT";
+    }
+}
+
+//
+// Writes one event as a JSON-SEQ record. Times are in milliseconds.
+//
+static
+void
+QuicQlogWriteEvent(
+    _In_ FILE* File,
+    _In_ const QUIC_QLOG_EVENT* Event
+    )
+{
+    fprintf(
+        File,
+        "\x1e{\"time\":%llu.%03llu,\"group_id\":\"%llu\",",
+        (unsigned long long)(Event->TimeUs / 1000),
+        (unsigned long long)(Event->TimeUs % 1000),
+        (unsigned long long)Event->CorrelationId);
+
+    switch (Event->Type) {
+    case QUIC_QLOG_EVENT_CONNECTION_STARTED:
+        fprintf(
+            File,
+            "\"name\":\"quic:connection_started\",\"data\":{\"vantage_point\":{\"type\":\"%s\"}}}\n",
+            Event->Started.IsServer ? "server" : "client");
+        break;
+    case QUIC_QLOG_EVENT_CONNECTION_CLOSED:
+        fprintf(
+            File,
+            "\"name\":\"quic:connection_closed\",\"data\":{\"owner\":\"%s\",\"%s\":%llu}}\n",
+            Event->Closed.Remote ? "remote" : "local",
+            Event->Closed.App ? "application_code" : "connection_code",
+            (unsigned long long)Event->Closed.ErrorCode);
+        break;
+    case QUIC_QLOG_EVENT_PACKET_SENT:
+    case QUIC_QLOG_EVENT_PACKET_RECEIVED:
+    case QUIC_QLOG_EVENT_PACKET_LOST:
+        fprintf(
+            File,
+            "\"name\":\"%s\",\"data\":{\"header\":{\"packet_type\":\"%s\",\"packet_number\":%llu},\"raw\":{\"length\":%u}}}\n",
+            Event->Type == QUIC_QLOG_EVENT_PACKET_SENT ? "quic:packet_sent" :
+                Event->Type == QUIC_QLOG_EVENT_PACKET_RECEIVED ? "quic:packet_received" :
+                "recovery:packet_lost",
+            QuicQlogPacketType(Event->Packet.KeyType),
+            (unsigned long long)Event->Packet.PacketNumber,
+            (uint32_t)Event->Packet.Length);
+        break;
+    case QUIC_QLOG_EVENT_METRICS_UPDATED:
+        fprintf(
+            File,
+            "\"name\":\"recovery:metrics_updated\",\"data\":{\"smoothed_rtt\":%u.%03u,\"min_rtt\":%u.%03u,\"latest_rtt\":%u.%03u,\"congestion_window\":%u,\"packets_in_flight\":%u}}\n",
+            Event->Metrics.SmoothedRtt / 1000, Event->Metrics.SmoothedRtt % 1000,
+            Event->Metrics.MinRtt / 1000, Event->Metrics.MinRtt % 1000,
+            Event->Metrics.LatestRtt / 1000, Event->Metrics.LatestRtt % 1000,
+            Event->Metrics.CongestionWindow,
+            Event->Metrics.PacketsInFlight);
+        break;
+    default:
+        CXPLAT_DBG_ASSERT(FALSE);
+        break;
+    }
+}
+
+//
+// Moves all events out of the rings and writes them.
+//
+static
+void
+QuicQlogDrain(
+    _In_ FILE* File
+    )
+{
+    QUIC_QLOG_EVENT Batch[QUIC_QLOG_WRITE_BATCH_SIZE];
+
+    for (uint32_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+        QUIC_QLOG_RING* Ring = &MsQuicLib.Partitions[i].QlogRing;
+        if (Ring->Events == NULL) {
+            continue;
+        }
+
+        uint32_t Count;
+        do {
+            CxPlatDispatchLockAcquire(&Ring->Lock);
+            Count = CXPLAT_MIN(Ring->Count, QUIC_QLOG_WRITE_BATCH_SIZE);
+            for (uint32_t j = 0; j < Count; ++j) {
+                Batch[j] = Ring->Events[Ring->Head];
+                Ring->Head = (Ring->Head + 1) % Ring->Size;
+            }
+            Ring->Count -= Count;
+            const uint64_t DroppedCount = Ring->DroppedCount;
+            Ring->DroppedCount = 0;
+            CxPlatDispatchLockRelease(&Ring->Lock);
+
+            if (DroppedCount != 0) {
+                const uint64_t TimeUs = CxPlatTimeUs64();
+                fprintf(
+                    File,
+                    "\x1e{\"time\":%llu.%03llu,\"name\":\"loglevel:warning\",\"data\":{\"message\":\"%llu events dropped on partition %u\"}}\n",
+                    (unsigned long long)(TimeUs / 1000),
+                    (unsigned long long)(TimeUs % 1000),
+                    (unsigned long long)DroppedCount,
+                    i);
+            }
+
+            for (uint32_t j = 0; j < Count; ++j) {
+                QuicQlogWriteEvent(File, &Batch[j]);
+            }
+        } while (Count == QUIC_QLOG_WRITE_BATCH_SIZE);
+    }
+
+    fflush(File);
+}
+
+CXPLAT_THREAD_CALLBACK(QuicQlogWriterThread, Context)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    BOOLEAN Shutdown;
+    do {
+        CxPlatEventWaitWithTimeout(MsQuicLib.Qlog.Event, QUIC_QLOG_FLUSH_INTERVAL_MS);
+        Shutdown = MsQuicLib.Qlog.Shutdown;
+        QuicQlogDrain((FILE*)MsQuicLib.Qlog.File);
+    } while (!Shutdown);
+
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
+#endif // !_KERNEL_MODE
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogStart(
+    void
+    )
+{
+#ifndef _KERNEL_MODE
+    CXPLAT_DBG_ASSERT(!MsQuicLib.Qlog.ThreadStarted);
+    if (MsQuicLib.Qlog.FilePath == NULL) {
+        return;
+    }
+
+    FILE* File = fopen(MsQuicLib.Qlog.FilePath, "w");
+    if (File == NULL) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "Failed to open qlog file");
+        return;
+    }
+    fprintf(
+        File,
+        "\x1e{\"qlog_version\":\"0.4\",\"qlog_format\":\"JSON-SEQ\",\"title\":\"msquic\","
+        "\"trace\":{\"common_fields\":{\"time_format\":\"absolute\"},\"vantage_point\":{\"type\":\"unknown\"}}}\n");
+
+    MsQuicLib.Qlog.File = File;
+    MsQuicLib.Qlog.Shutdown = FALSE;
+    CxPlatEventInitialize(&MsQuicLib.Qlog.Event, FALSE, FALSE);
+
+    CXPLAT_THREAD_CONFIG ThreadConfig = {
+        0,
+        0,
+        "QlogWriter",
+        QuicQlogWriterThread,
+        NULL,
+    };
+    QUIC_STATUS Status = CxPlatThreadCreate(&ThreadConfig, &MsQuicLib.Qlog.Thread);
+    if (QUIC_FAILED(Status)) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "CxPlatThreadCreate (qlog)");
+        CxPlatEventUninitialize(MsQuicLib.Qlog.Event);
+        fclose(File);
+        MsQuicLib.Qlog.File = NULL;
+        return;
+    }
+    MsQuicLib.Qlog.ThreadStarted = TRUE;
+#endif
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogStop(
+    void
+    )
+{
+#ifndef _KERNEL_MODE
+    if (!MsQuicLib.Qlog.ThreadStarted) {
+        return;
+    }
+
+    MsQuicLib.Qlog.Shutdown = TRUE;
+    CxPlatEventSet(MsQuicLib.Qlog.Event);
+    CxPlatThreadWait(&MsQuicLib.Qlog.Thread);
+    CxPlatThreadDelete(&MsQuicLib.Qlog.Thread);
+    MsQuicLib.Qlog.ThreadStarted = FALSE;
+
+    CxPlatEventUninitialize(MsQuicLib.Qlog.Event);
+    fclose((FILE*)MsQuicLib.Qlog.File);
+    MsQuicLib.Qlog.File = NULL;
+#endif
+}
@@ -0,0 +1,219 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Opt-in qlog (draft-ietf-quic-qlog) capture for a sample of connections.
+    Events are recorded in a compact binary form into a preallocated ring per
+    partition, and a background thread writes them out as JSON-SEQ.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_SENT_PACKET_METADATA QUIC_SENT_PACKET_METADATA;
+
+//
+// The number of events each partition's ring holds, if not configured.
+//
+#define QUIC_QLOG_DEFAULT_RING_SIZE     4096
+
+//
+// How often the writer thread drains the rings, in milliseconds.
+//
+#define QUIC_QLOG_FLUSH_INTERVAL_MS     100
+
+typedef enum QUIC_QLOG_EVENT_TYPE {
+    QUIC_QLOG_EVENT_CONNECTION_STARTED,
+    QUIC_QLOG_EVENT_CONNECTION_CLOSED,
+    QUIC_QLOG_EVENT_PACKET_SENT,
+    QUIC_QLOG_EVENT_PACKET_RECEIVED,
+    QUIC_QLOG_EVENT_PACKET_LOST,
+    QUIC_QLOG_EVENT_METRICS_UPDATED
+} QUIC_QLOG_EVENT_TYPE;
+
+typedef struct QUIC_QLOG_EVENT {
+
+    uint64_t TimeUs;
+    uint64_t CorrelationId;
+    uint8_t Type; // QUIC_QLOG_EVENT_TYPE
+
+    union {
+        struct {
+            BOOLEAN IsServer;
+        } Started;
+        struct {
+            BOOLEAN Remote;
+            BOOLEAN App;
+            uint64_t ErrorCode;
+        } Closed;
+        struct {
+            uint8_t KeyType; // QUIC_PACKET_KEY_TYPE
+            uint16_t Length;
+            uint64_t PacketNumber;
+        } Packet;
+        struct {
+            uint32_t SmoothedRtt; // us
+            uint32_t MinRtt; // us
+            uint32_t LatestRtt; // us
+            uint32_t CongestionWindow;
+            uint32_t PacketsInFlight;
+        } Metrics;
+    };
+
+} QUIC_QLOG_EVENT;
+
+//
+// Events recorded on a partition, waiting for the writer thread.
+//
+typedef struct QUIC_QLOG_RING {
+
+    CXPLAT_DISPATCH_LOCK Lock;
+
+    //
+    // NULL when qlog isn't enabled.
+    //
+    _Field_size_(Size)
+    QUIC_QLOG_EVENT* Events;
+    uint32_t Size;
+
+    //
+    // The oldest event, and the number of events after it.
+    //
+    uint32_t Head;
+    uint32_t Count;
+
+    //
+    // Events dropped because the ring was full, since the last drain.
+    //
+    uint64_t DroppedCount;
+
+} QUIC_QLOG_RING;
+
+//
+// Library wide qlog state.
+//
+typedef struct QUIC_QLOG {
+
+    //
+    // The file events are written to. NULL when qlog isn't enabled.
+    //
+    char* FilePath;
+
+    //
+    // Connections captured, per million.
+    //
+    uint32_t SampleRate;
+
+    //
+    // Events each partition's ring holds.
+    //
+    uint32_t RingSize;
+
+    BOOLEAN ThreadStarted;
+    BOOLEAN Shutdown;
+    CXPLAT_EVENT Event;
+    CXPLAT_THREAD Thread;
+    void* File;
+
+} QUIC_QLOG;
+
+//
+// Applies QUIC_PARAM_GLOBAL_QLOG_CONFIG. Must be called with the library lock
+// held, before the library is lazily initialized.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicQlogSetConfig(
+    _In_ const QUIC_QLOG_CONFIG* Config
+    );
+
+//
+// Opens the output file and starts the writer thread, after the partitions
+// are initialized. Failure isn't fatal; qlog just stays disabled.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogStart(
+    void
+    );
+
+//
+// Writes out any remaining events and stops the writer thread, before the
+// partitions are freed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogStop(
+    void
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogRingInitialize(
+    _Inout_ QUIC_QLOG_RING* Ring
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogRingUninitialize(
+    _Inout_ QUIC_QLOG_RING* Ring
+    );
+
+//
+// Decides whether a new connection is captured, and records its start if so.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicQlogOnConnectionCreated(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ BOOLEAN IsServer
+    );
+
+//
+// The following are only called for captured connections.
+//
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnConnectionClosed(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnPacketSent(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnPacketReceived(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_RX_PACKET* Packet
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnPacketLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogOnMetricsUpdated(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_PATH* Path
+    );
+
+#if defined(__cplusplus)
+}
+#endif
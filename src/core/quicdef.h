@@ -79,12 +79,29 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_TIME_REORDER_THRESHOLD(rtt)        ((rtt) + ((rtt) / 8))
 
+//
+// Adaptive reordering window (RACK-TLP). Each round trip with a spurious loss
+// widens the time threshold by a quarter of the min RTT (up to a smoothed RTT)
+// and stops packet threshold loss detection. It resets after this many round
+// trips with loss but without a spurious one.
+//
+#define QUIC_REORDER_WINDOW_MAX_MULTIPLIER      16
+#define QUIC_REORDER_WINDOW_PERSIST             16
+
 //
 // Number of consecutive PTOs after which the network is considered to be
 // experiencing persistent congestion.
 //
 #define QUIC_PERSISTENT_CONGESTION_THRESHOLD    2
 
+//
+// Number of outstanding retransmittable packets at which loss detection starts
+// indexing its sent and lost packet lists by packet number, and the maximum
+// packet number span (a power of two) the index covers.
+//
+#define QUIC_SENT_PACKET_INDEX_THRESHOLD        256
+#define QUIC_SENT_PACKET_INDEX_MAX_SPAN         (1u << 18)
+
 //
 // The number of probe timeouts' worth of time to wait in the closing period
 // before timing out.
@@ -103,6 +120,12 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MIN_ACK_SEND_NUMBER                2
 
+//
+// When the peer supports the ACK frequency extension, it is asked to send an
+// ACK for every 1/Nth of the congestion window worth of packets.
+//
+#define QUIC_ACK_FREQUENCY_CWND_DIVISOR         4
+
 //
 // The value for Reordering threshold when no ACK_FREQUENCY frame is received.
 // This means that the receiver will immediately acknowledge any out-of-order packets.
@@ -136,6 +159,12 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MAX_PARTITION_COUNT                512
 
+//
+// The number of partitions each thread initializes at library startup. Larger
+// partition counts are initialized in parallel, a block at a time.
+//
+#define QUIC_PARTITION_INIT_BLOCK_SIZE          16
+
 //
 // The number of partitions (cores) to offset from the receive (RSS) core when
 // using the QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT profile.
@@ -171,12 +200,111 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_STATELESS_OPERATION_EXPIRATION_MS  100
 
+//
+// The number of stateless responses (version negotiation, stateless reset and
+// retry) a binding sends to a single source address prefix (/24 for IPv4, /48
+// for IPv6) per QUIC_STATELESS_RATE_INTERVAL_MS. Estimated with a count-min
+// sketch of QUIC_STATELESS_RATE_SKETCH_DEPTH rows of
+// QUIC_STATELESS_RATE_SKETCH_WIDTH counters (a power of 2).
+//
+#define QUIC_STATELESS_RATE_PER_PREFIX          64
+#define QUIC_STATELESS_RATE_INTERVAL_MS         1000
+#define QUIC_STATELESS_RATE_SKETCH_DEPTH        4
+#define QUIC_STATELESS_RATE_SKETCH_WIDTH        512
+
 //
 // The maximum number of operations a connection will drain from its queue per
 // call to QuicConnDrainOperations.
 //
 #define QUIC_MAX_OPERATIONS_PER_DRAIN           16
 
+//
+// A worker lets connections drain up to this many times their
+// MaxOperationsPerDrain per call. The scale grows while no other connections
+// are waiting on the worker, and shrinks as its average queue delay rises
+// above QUIC_WORKER_DRAIN_SCALE_DELAY_US.
+//
+#define QUIC_WORKER_MAX_DRAIN_SCALE             8
+#define QUIC_WORKER_DRAIN_SCALE_DELAY_US        250
+
+//
+// The maximum number of connection sends a (batching) worker holds back to
+// submit to the datapath together, and the longest it holds any of them while
+// it keeps finding more work to do.
+//
+#define QUIC_WORKER_SEND_BATCH_MAX              16
+#define QUIC_WORKER_SEND_BATCH_MAX_DELAY_US     100
+
+//
+// The maximum number of path telemetry snapshots a worker collects before
+// delivering them, and the longest it holds any of them while it keeps finding
+// more work to do.
+//
+#define QUIC_WORKER_TELEMETRY_BATCH_MAX         32
+#define QUIC_WORKER_TELEMETRY_BATCH_MAX_DELAY_US 10000
+
+//
+// The number of entries in each worker's flight recorder. Must be a power of 2.
+//
+#define QUIC_WORKER_FLIGHT_RECORDER_SIZE        512
+
+//
+// The maximum number of received datagrams a worker collects from its
+// connections before returning them to the datapath, instead of waiting for
+// the end of the loop iteration.
+//
+#define QUIC_WORKER_RECV_RETURN_MAX             256
+
+//
+// Connection rebalancing between workers. A worker's load is the percentage
+// of each load interval it spends processing connections. After a worker has
+// been overloaded for QUIC_WORKER_REBALANCE_INTERVALS intervals in a row, it
+// moves one connection that uses at least QUIC_WORKER_REBALANCE_MIN_CONN_LOAD
+// percent of an interval to the least loaded worker, as long as the target
+// would still be QUIC_WORKER_REBALANCE_HYSTERESIS percent less loaded than
+// the source afterwards. A connection isn't moved again within
+// QUIC_CONN_REBALANCE_COOLDOWN_US.
+//
+#define QUIC_WORKER_LOAD_INTERVAL_US            1000000
+#define QUIC_WORKER_REBALANCE_INTERVALS         3
+#define QUIC_WORKER_REBALANCE_BUSY_PERCENT      90
+#define QUIC_WORKER_REBALANCE_MIN_CONN_LOAD     10
+#define QUIC_WORKER_REBALANCE_HYSTERESIS        20
+#define QUIC_CONN_REBALANCE_COOLDOWN_US         30000000
+
+//
+// Server connection admission. A worker admits at most
+// QUIC_WORKER_MAX_HANDSHAKE_QUEUE new connections it hasn't started processing
+// yet, and reserves half of them for resuming clients (those that sent 0-RTT
+// or a valid token). Fresh handshakes are also turned away once the worker's
+// queue delay passes half of MaxWorkerQueueDelayUs, or while it spends at
+// least QUIC_WORKER_HANDSHAKE_BUDGET_PERCENT of its time processing.
+//
+#define QUIC_WORKER_MAX_HANDSHAKE_QUEUE         256
+#define QUIC_WORKER_HANDSHAKE_BUDGET_PERCENT    50
+
+//
+// Work stealing. A worker that runs out of work asks a peer to hand over the
+// connection at the tail of its queue, if the peer's average queue delay is
+// at least QUIC_WORKER_STEAL_MIN_QUEUE_DELAY_US. It asks at most once every
+// QUIC_WORKER_STEAL_INTERVAL_US.
+//
+#define QUIC_WORKER_STEAL_MIN_QUEUE_DELAY_US    1000
+#define QUIC_WORKER_STEAL_INTERVAL_US           1000
+
+//
+// Registration shutdown hands each worker the connections it tears down at
+// most this many at a time, and the worker processes up to this many of them
+// back to back per loop iteration.
+//
+#define QUIC_WORKER_TEARDOWN_BATCH              64
+
+//
+// The longest server name a listener maps to a configuration. DNS host names
+// are at most 253 characters.
+//
+#define QUIC_LISTENER_MAX_SNI_NAME_LENGTH       255
+
 //
 // Used as a hint for the maximum number of UDP datagrams to send for each
 // FLUSH_SEND operation. The actual number will generally exceed this value up
@@ -190,6 +318,12 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_STREAM_SEND_BATCH_COUNT            8
 
+//
+// The number of bytes a stream may send per unit of weight each round, in the
+// weighted (deficit round robin) stream scheduling scheme.
+//
+#define QUIC_STREAM_WEIGHT_QUANTUM              256
+
 //
 // The maximum number of received packets to batch process at a time.
 //
@@ -200,12 +334,37 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MAX_CRYPTO_BATCH_COUNT             8
 
+//
+// The maximum number of send buffer ranges that may be encrypted in place of
+// being copied, across all the packets of a crypto batch.
+//
+#define QUIC_MAX_CRYPT_SEGMENTS                 32
+
+//
+// The maximum number of app-owned receive buffers the stream data of a single
+// received packet may be decrypted into, in place of being copied.
+//
+#define QUIC_MAX_RECV_PLACEMENT_SEGMENTS        4
+
+//
+// The minimum length of the stream data in a received packet for it to be
+// worth decrypting straight into an app-owned receive buffer.
+//
+#define QUIC_MIN_RECV_PLACEMENT_LENGTH          256
+
 //
 // The maximum number of received packets that may be processed in a single
 // flush operation.
 //
 #define QUIC_MAX_RECEIVE_FLUSH_COUNT            100
 
+//
+// The maximum number of destination CIDs a single receive indication is split
+// into at once. Datagrams for a CID already being gathered are appended to its
+// subchain, even if datagrams for other CIDs arrived in between.
+//
+#define QUIC_MAX_RECEIVE_SUBCHAIN_COUNT         8
+
 //
 // The maximum number of pending datagrams we will hold on to, per connection,
 // per packet number space. We base our max on the expected initial window size
@@ -233,11 +392,72 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE    0x1000  // 4096
 
+//
+// The number of power-of-two receive chunk sizes, starting at
+// QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, that are pooled per partition. Larger
+// chunks use the general allocator.
+//
+#define QUIC_RECV_CHUNK_POOL_CLASS_COUNT        4       // 4KB - 32KB
+
 //
 // The default connection flow control window value, in bytes.
 //
 #define QUIC_DEFAULT_CONN_FLOW_CONTROL_WINDOW   0x1000000  // 16MB
 
+//
+// The default maximum the connection flow control window may be grown to by
+// receive window autotuning, in bytes. Zero disables connection level
+// autotuning.
+//
+#define QUIC_DEFAULT_CONN_FLOW_CONTROL_WINDOW_MAX 0
+
+//
+// The default time, in milliseconds, a connected connection must be idle
+// before it releases its grown buffers and tracking state. Zero disables
+// hibernation.
+//
+#define QUIC_DEFAULT_HIBERNATE_TIMEOUT_MS           0
+
+//
+// The default maximum the number of simultaneous peer streams may be grown to
+// when the peer keeps running out of stream IDs. Zero disables growth.
+//
+#define QUIC_DEFAULT_PEER_STREAM_COUNT_MAX          0
+
+//
+// The fraction (N/65535) of paths on which the latency spin bit is disabled.
+// RFC 9000 requires disabling it on at least one in every 16 paths, so that is
+// both the default and the minimum.
+//
+#define QUIC_DEFAULT_SPIN_BIT_DISABLE_RATE          4096
+#define QUIC_MIN_SPIN_BIT_DISABLE_RATE              4096
+
+//
+// Credit for closed peer streams is given back in batches of 1 / divisor of the
+// peer's stream count, unless the peer is close to running out.
+//
+#define QUIC_STREAM_CREDIT_BATCH_DIVISOR            8
+
+//
+// The fraction (1 / divisor) of total system memory that all connections may
+// together add to their flow control windows by autotuning.
+//
+#define QUIC_RECV_WINDOW_AUTOTUNE_MEMORY_DIVISOR 16
+
+//
+// The default fraction (1 / divisor) of total system memory that buffered
+// stream data and connection state may use before peers are pushed back.
+//
+#define QUIC_DEFAULT_MEMORY_BUDGET_DIVISOR      4
+
+//
+// Memory usage, in percent of the budget, at which flow control windows stop
+// growing and shrink to half their size (high), and at which they shrink to a
+// quarter of their size and peers get no new stream credit (critical).
+//
+#define QUIC_MEMORY_PRESSURE_HIGH_PERCENT       75
+#define QUIC_MEMORY_PRESSURE_CRITICAL_PERCENT   90
+
 //
 // Maximum memory allocated (in bytes) for different range tracking structures
 //
@@ -251,6 +471,27 @@ CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_DUPLICATE_PACKETS), "Must be
 CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_ACK_PACKETS), "Must be power of two");
 CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_DECODE_ACKS), "Must be power of two");
 
+//
+// Maximum size (in bytes) of the encoded ACK blocks the ACK tracker keeps
+// between ACK frames. Larger sets of ACK ranges are encoded from scratch.
+//
+#define QUIC_MAX_ENCODED_ACK_BLOCKS_LENGTH      256
+
+//
+// The number of most recent packet numbers tracked in the ack tracker's
+// duplicate detection bitmap, before they move to the (slower) range.
+//
+#define QUIC_RECENT_PACKET_NUMBER_COUNT         256
+
+CXPLAT_STATIC_ASSERT(QUIC_RECENT_PACKET_NUMBER_COUNT % 64 == 0, "Must be whole uint64_t words");
+
+//
+// The maximum number of slots in a connection's sent packet ring.
+//
+#define QUIC_MAX_SENT_PACKET_RING_SIZE          0x10000     // 65536
+
+CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_SENT_PACKET_RING_SIZE), "Must be power of two");
+
 //
 // Minimum MTU allowed to be configured. Must be able to fit a
 // QUIC_MIN_INITIAL_PACKET_LENGTH in an IPv6 datagram.
@@ -356,6 +597,28 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_MAX_IDEAL_SEND_BUFFER_SIZE         0x8000000 // 134217728
 
+//
+// When the ideal send buffer size follows the delivery rate, the smoothed
+// estimate must grow by more than 1/N of the current size, or shrink by more
+// than 1/M of it, before a new size is indicated.
+//
+#define QUIC_IDEAL_SEND_BUFFER_GROW_HYSTERESIS  8
+#define QUIC_IDEAL_SEND_BUFFER_SHRINK_HYSTERESIS 4
+
+//
+// The weight (1/N) of each new sample in the smoothed delivery rate based
+// ideal send buffer estimate.
+//
+#define QUIC_IDEAL_SEND_BUFFER_SMOOTHING        8
+
+//
+// Buffered send requests are copied into power-of-two sized blocks, starting
+// at QUIC_SEND_BUFFER_POOL_MIN_SIZE, that are pooled per partition. Larger
+// requests use the general allocator.
+//
+#define QUIC_SEND_BUFFER_POOL_MIN_SIZE          128
+#define QUIC_SEND_BUFFER_POOL_CLASS_COUNT       6       // 128B - 4KB
+
 //
 // The minimum number of bytes of send allowance we must have before we will
 // send another packet.
@@ -373,6 +636,18 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_MAX_PATH_COUNT                     4
 
+//
+// The interval (in ms) at which validated standby paths are probed with a
+// path challenge to make sure they are still usable.
+//
+#define QUIC_STANDBY_PATH_PROBE_INTERVAL_MS     5000
+
+//
+// The number of consecutive probe timeouts on the active path after which the
+// connection fails over to a validated standby path.
+//
+#define QUIC_STANDBY_PATH_FAILOVER_PROBE_COUNT  2
+
 //
 // Maximum number of connection IDs accepted from the peer.
 //
@@ -401,6 +676,58 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_SEND_PACING_INTERVAL               1000
 
+//
+// The width, in microseconds, and number of the slots in a worker's pacing
+// queue. The slots must cover at least QUIC_SEND_PACING_INTERVAL.
+//
+#define QUIC_PACING_QUEUE_SLOT_US               16
+#define QUIC_PACING_QUEUE_SLOT_COUNT            128
+
+//
+// The resolution of a worker's timer wheel, as a power of two number of
+// microseconds (about 1ms), and the number of its levels. Each level has
+// QUIC_TIMER_WHEEL_SLOT_COUNT slots, each as wide as the whole level below,
+// so together they cover about 12 days. Timers further out than that wait in
+// the last slot of the top level.
+//
+#define QUIC_TIMER_WHEEL_TICK_SHIFT             10
+#define QUIC_TIMER_WHEEL_LEVEL_COUNT            5
+#define QUIC_TIMER_WHEEL_SLOT_COUNT             64 // One bit per slot in a uint64_t
+
+//
+// The number of full sized datagrams a connection paced by the worker's
+// pacing queue waits to accumulate before being released to send again.
+//
+#define QUIC_PACING_QUEUE_CHUNK_DATAGRAMS       10
+
+//
+// If the next paced connection is due sooner than this, in microseconds, the
+// worker polls for it instead of waiting, since the wait can't resolve delays
+// this short.
+//
+#define QUIC_PACING_QUEUE_POLL_THRESHOLD_US     2000
+
+//
+// The burst an application configured send rate limit allows, as the bytes
+// accumulated over this many microseconds, but never less than
+// QUIC_SEND_RATE_LIMIT_MIN_BURST bytes so a full chunk of datagrams can
+// always be sent at once.
+//
+#define QUIC_SEND_RATE_LIMIT_BURST_US           10000
+#define QUIC_SEND_RATE_LIMIT_MIN_BURST          (4 * QUIC_DPLPMTUD_DEFAULT_MAX_MTU)
+
+//
+// The longest idle time, in microseconds, a send rate limit accounts for when
+// refilling, which keeps the refill calculation from overflowing.
+//
+#define QUIC_SEND_RATE_LIMIT_MAX_REFILL_US      S_TO_US(60)
+
+//
+// The minimum connection attempt delay, in milliseconds, a client waits before
+// racing an attempt to the server's other address family (RFC 8305).
+//
+#define QUIC_HAPPY_EYEBALLS_MIN_DELAY_MS        10
+
 //
 // The maximum number of bytes to send in a given key phase
 // before performing a key phase update. Roughly, 274GB.
@@ -417,6 +744,18 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_ACK_DELAY_EXPONENT                 8
 
+//
+// The most receive timestamps (draft-smith-quic-receive-ts) tracked for the
+// next ACK frame and accepted from the peer in a single ACK frame.
+//
+#define QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK     32
+
+//
+// The scaling factor used locally for the timestamp deltas in the
+// ACK_RECEIVE_TIMESTAMPS frame.
+//
+#define QUIC_RECEIVE_TIMESTAMPS_EXPONENT        0
+
 //
 // The lifetime of a QUIC stateless retry token encryption key.
 // This is also the interval that generates new keys.
@@ -550,6 +889,11 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_DEFAULT_QTIP_ENABLED                    FALSE
 
+//
+// The default settings for using Registered I/O for UDP sockets.
+//
+#define QUIC_DEFAULT_RIO_ENABLED                     FALSE
+
 //
 // The default settings for allowing One-Way Delay support.
 //
@@ -565,6 +909,61 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_DEFAULT_STREAM_MULTI_RECEIVE_ENABLED    FALSE
 
+//
+// The default settings for letting flow control updates wait for a pending
+// delayed ACK (or the next packet) instead of being sent on their own.
+//
+#define QUIC_DEFAULT_CONTROL_FRAME_COALESCING_ENABLED FALSE
+
+//
+// The default settings for encrypting stream data straight from the send
+// buffers instead of first copying it into the packet.
+//
+#define QUIC_DEFAULT_ENCRYPT_FROM_SEND_BUFFERS_ENABLED FALSE
+
+//
+// The default settings for indicating stream receive data for multiple
+// streams in a single connection event.
+//
+#define QUIC_DEFAULT_STREAM_BATCH_RECEIVE_ENABLED FALSE
+
+//
+// The maximum number of streams indicated in a single
+// QUIC_CONNECTION_EVENT_STREAMS_RECEIVE event.
+//
+#define QUIC_STREAMS_RECEIVE_BATCH_MAX          16
+
+//
+// The maximum number of streams indicated in a single
+// QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED event.
+//
+#define QUIC_PEER_STREAMS_STARTED_BATCH_MAX     16
+
+//
+// The default settings for saving the path's congestion state in resumption
+// tickets and using it to jump-start resumed connections (Careful Resume).
+//
+#define QUIC_DEFAULT_CAREFUL_RESUME_ENABLED     FALSE
+
+//
+// How long (in seconds) the congestion state saved in a resumption ticket may
+// be used for Careful Resume.
+//
+#define QUIC_CAREFUL_RESUME_STATE_LIFETIME_S    3600
+
+//
+// The defaults for the registration's client ticket cache, when enabled.
+//
+#define QUIC_CLIENT_TICKET_CACHE_DEFAULT_MAX_BYTES (256 * 1024)
+#define QUIC_CLIENT_TICKET_CACHE_DEFAULT_LIFETIME_MS (24 * 60 * 60 * 1000)
+
+//
+// The default minimum time (in milliseconds) the registration's 0-RTT
+// anti-replay filter remembers a ClientHello. Matches the ticket age tolerance
+// the TLS libraries allow early data with.
+//
+#define QUIC_DEFAULT_ZERORTT_ANTI_REPLAY_WINDOW_MS 10000
+
 //
 // The number of rounds in Cubic Slow Start to sample RTT.
 //
@@ -622,6 +1021,9 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED                 0x01000000
 #define QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED                 0x02000000
 #define QUIC_TP_FLAG_TIMESTAMP_SHIFT                        24
+#define QUIC_TP_FLAG_INITIAL_MAX_PATH_ID                    0x04000000
+#define QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK         0x08000000
+#define QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT            0x10000000
 
 #define QUIC_TP_MAX_PACKET_SIZE_DEFAULT                     65527
 #define QUIC_TP_MAX_UDP_PAYLOAD_SIZE_MIN                    1200
@@ -634,9 +1036,21 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_TP_MAX_ACK_DELAY_MAX                           ((1 << 14) - 1)
 #define QUIC_TP_MIN_ACK_DELAY_MAX                           ((1 << 24) - 1)
 
+#define QUIC_TP_MAX_PATH_ID_MAX                             UINT32_MAX
+
+#define QUIC_TP_RECEIVE_TIMESTAMPS_EXPONENT_MAX             20
+
 #define QUIC_TP_ACTIVE_CONNECTION_ID_LIMIT_DEFAULT          2
 #define QUIC_TP_ACTIVE_CONNECTION_ID_LIMIT_MIN              2
 
+//
+// The preferred_address transport parameter: an IPv4 address and port, an
+// IPv6 address and port, a length-prefixed connection ID and a stateless
+// reset token.
+//
+#define QUIC_TP_PREFERRED_ADDRESS_LENGTH(CidLength) \
+    (4 + 2 + 16 + 2 + 1 + (CidLength) + QUIC_STATELESS_RESET_TOKEN_LENGTH)
+
 //
 // Max allowed value of a MAX_STREAMS frame or transport parameter.
 // Any larger value would allow a max stream ID that cannot be expressed
@@ -671,9 +1085,14 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_SETTING_RELIABLE_RESET_ENABLED         "ReliableResetEnabled"
 #define QUIC_SETTING_XDP_ENABLED                    "XdpEnabled"
 #define QUIC_SETTING_QTIP_ENABLED                   "QTIPEnabled"
+#define QUIC_SETTING_RIO_ENABLED                    "RioEnabled"
 #define QUIC_SETTING_ONE_WAY_DELAY_ENABLED          "OneWayDelayEnabled"
 #define QUIC_SETTING_NET_STATS_EVENT_ENABLED        "NetStatsEventEnabled"
 #define QUIC_SETTING_STREAM_MULTI_RECEIVE_ENABLED   "StreamMultiReceiveEnabled"
+#define QUIC_SETTING_CONTROL_FRAME_COALESCING_ENABLED "ControlFrameCoalescingEnabled"
+#define QUIC_SETTING_ENCRYPT_FROM_SEND_BUFFERS_ENABLED "EncryptFromSendBuffersEnabled"
+#define QUIC_SETTING_STREAM_BATCH_RECEIVE_ENABLED   "StreamBatchReceiveEnabled"
+#define QUIC_SETTING_CAREFUL_RESUME_ENABLED         "CarefulResumeEnabled"
 
 #define QUIC_SETTING_INITIAL_WINDOW_PACKETS         "InitialWindowPackets"
 #define QUIC_SETTING_SEND_IDLE_TIMEOUT_MS           "SendIdleTimeoutMs"
@@ -694,6 +1113,10 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_SETTING_STREAM_FC_UNIDI_WINDOW_SIZE    "StreamRecvWindowUnidiDefault"
 #define QUIC_SETTING_STREAM_RECV_BUFFER_SIZE        "StreamRecvBufferDefault"
 #define QUIC_SETTING_CONN_FLOW_CONTROL_WINDOW       "ConnFlowControlWindow"
+#define QUIC_SETTING_CONN_FLOW_CONTROL_WINDOW_MAX   "ConnFlowControlWindowMax"
+#define QUIC_SETTING_HIBERNATE_TIMEOUT              "HibernateTimeoutMs"
+#define QUIC_SETTING_PEER_STREAM_COUNT_MAX          "PeerStreamCountMax"
+#define QUIC_SETTING_SPIN_BIT_DISABLE_RATE          "SpinBitDisableRate"
 
 #define QUIC_SETTING_MAX_BYTES_PER_KEY_PHASE        "MaxBytesPerKey"
 
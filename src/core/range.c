@@ -49,6 +49,27 @@ QuicRangeReset(
     Range->UsedLength = 0;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeCompact(
+    _Inout_ QUIC_RANGE* Range
+    )
+{
+    if (Range->AllocLength == QUIC_RANGE_INITIAL_SUB_COUNT) {
+        return;
+    }
+
+    const uint32_t KeepLength = CXPLAT_MIN(Range->UsedLength, QUIC_RANGE_INITIAL_SUB_COUNT);
+    CxPlatCopyMemory(
+        Range->PreAllocSubRanges,
+        Range->SubRanges + Range->UsedLength - KeepLength,
+        KeepLength * sizeof(QUIC_SUBRANGE));
+    CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+    Range->SubRanges = Range->PreAllocSubRanges;
+    Range->AllocLength = QUIC_RANGE_INITIAL_SUB_COUNT;
+    Range->UsedLength = KeepLength;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != FALSE)
 BOOLEAN
@@ -375,6 +396,41 @@ QuicRangeAddRange(
     return Sub;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_SUBRANGE*
+QuicRangeAppendSubrange(
+    _Inout_ QUIC_RANGE* Range
+    )
+{
+    if (Range->UsedLength == Range->AllocLength) {
+        if (!QuicRangeGrow(Range, Range->UsedLength)) {
+            return NULL;
+        }
+    } else {
+        Range->UsedLength++;
+    }
+    return Range->SubRanges + Range->UsedLength - 1;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeReverse(
+    _Inout_ QUIC_RANGE* Range
+    )
+{
+    if (Range->UsedLength < 2) {
+        return;
+    }
+    QUIC_SUBRANGE* Low = Range->SubRanges;
+    QUIC_SUBRANGE* High = Range->SubRanges + Range->UsedLength - 1;
+    while (Low < High) {
+        QUIC_SUBRANGE Temp = *Low;
+        *Low++ = *High;
+        *High-- = Temp;
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != FALSE)
 BOOLEAN
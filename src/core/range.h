@@ -250,6 +250,17 @@ QuicRangeReset(
     _Inout_ QUIC_RANGE* Range
     );
 
+//
+// Frees the memory the range grew into, keeping only the highest subranges
+// that fit in the preallocated space. The lower values dropped are no longer
+// tracked, just like when the range reaches its maximum size.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeCompact(
+    _Inout_ QUIC_RANGE* Range
+    );
+
 //
 // O(n)      when QUIC_RANGE_USE_BINARY_SEARCH == 0
 // O(log(n)) when QUIC_RANGE_USE_BINARY_SEARCH == 1
@@ -298,6 +309,29 @@ QuicRangeAddRange(
     _Out_ BOOLEAN* RangeUpdated
     );
 
+//
+// O(1) Adds a new subrange after all the existing ones, without searching or
+// merging, and returns it for the caller to fill in. The caller must keep the
+// subranges disjoint and non-adjacent, and in ascending order (possibly by
+// calling QuicRangeReverse once it's done). Returns NULL if the range can't
+// grow.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_SUBRANGE*
+QuicRangeAppendSubrange(
+    _Inout_ QUIC_RANGE* Range
+    );
+
+//
+// O(n) Reverses the order of the subranges.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeReverse(
+    _Inout_ QUIC_RANGE* Range
+    );
+
 //
 // Removes a number of subranges from the range. Returns TRUE if the list was
 // shrunk (reallocated) because of the removal operation.
@@ -185,8 +185,14 @@ QuicRecvChunkFree(
     //
     // The data buffer of the chunk is allocated in the same allocation
     // as the chunk itself if and only if it is owned by the receive buffer:
-    // freeing the chunk will free the data buffer as needed.
+    // freeing the chunk will free the data buffer as needed. Only such chunks
+    // are charged against the global memory budget.
     //
+    if (Chunk->Buffer == (uint8_t*)(Chunk + 1)) {
+        QuicLibraryChargeMemory(
+            QUIC_MEMORY_TYPE_RECV_BUFFER,
+            -(int64_t)(sizeof(QUIC_RECV_CHUNK) + Chunk->AllocLength));
+    }
     if (Chunk->AllocatedFromPool) {
         CxPlatPoolFree(Chunk);
     } else {
@@ -194,6 +200,51 @@ QuicRecvChunkFree(
     }
 }
 
+//
+// Allocates a chunk and its buffer, of AllocLength bytes, in a single
+// allocation. Uses the matching size class of ChunkPools, if any.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_RECV_CHUNK*
+QuicRecvChunkAlloc(
+    _In_opt_ CXPLAT_POOL* ChunkPools,
+    _In_ uint32_t AllocLength
+    )
+{
+    QUIC_RECV_CHUNK* Chunk;
+    BOOLEAN AllocatedFromPool = FALSE;
+
+    uint32_t Class = 0;
+    uint32_t ClassLength = QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE;
+    while (Class < QUIC_RECV_CHUNK_POOL_CLASS_COUNT - 1 && ClassLength < AllocLength) {
+        ++Class;
+        ClassLength <<= 1;
+    }
+
+    if (ChunkPools != NULL && ClassLength == AllocLength) {
+        Chunk = CxPlatPoolAlloc(&ChunkPools[Class]);
+        AllocatedFromPool = TRUE;
+    } else {
+        Chunk = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + AllocLength, QUIC_POOL_RECVBUF);
+    }
+
+    if (Chunk == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "recv_buffer",
+            sizeof(QUIC_RECV_CHUNK) + AllocLength);
+        return NULL;
+    }
+
+    QuicRecvChunkInitialize(Chunk, AllocLength, (uint8_t*)(Chunk + 1), AllocatedFromPool);
+    QuicLibraryChargeMemory(
+        QUIC_MEMORY_TYPE_RECV_BUFFER,
+        (int64_t)(sizeof(QUIC_RECV_CHUNK) + AllocLength));
+    return Chunk;
+}
+
 #if DEBUG
 //
 // Validate the receive buffer invariants.
@@ -209,8 +260,8 @@ QuicRecvBufferValidate(
     // In Multiple and App-owned modes, there never is a retired buffer.
     //
     CXPLAT_DBG_ASSERT(
-        (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE &&
-        RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED) ||
+        (!QuicRecvBufferIsMultiple(RecvBuffer) &&
+        !QuicRecvBufferIsAppOwned(RecvBuffer)) ||
         RecvBuffer->RetiredChunk == NULL);
 
     //
@@ -226,11 +277,13 @@ QuicRecvBufferValidate(
     CXPLAT_DBG_ASSERT(RecvBuffer->RetiredChunk == NULL || RecvBuffer->ReadPendingLength != 0);
 
     //
-    // Except for App-owned mode, there is always at least one chunk in the list.
+    // Except for App-owned mode, there is always at least one chunk in the list
+    // once anything has been written.
     //
     CXPLAT_DBG_ASSERT(
-        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
-        !CxPlatListIsEmpty(&RecvBuffer->Chunks));
+        QuicRecvBufferIsAppOwned(RecvBuffer) ||
+        !CxPlatListIsEmpty(&RecvBuffer->Chunks) ||
+        QuicRangeSize(&RecvBuffer->WrittenRanges) == 0);
 
     if (CxPlatListIsEmpty(&RecvBuffer->Chunks)) {
         return;
@@ -254,7 +307,7 @@ QuicRecvBufferValidate(
     //
     CXPLAT_DBG_ASSERT(
         (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_SINGLE &&
-        RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED) ||
+        !QuicRecvBufferIsAppOwned(RecvBuffer)) ||
         RecvBuffer->ReadStart + RecvBuffer->ReadLength <= FirstChunk->AllocLength);
 }
 #else
@@ -268,12 +321,18 @@ QuicRecvBufferInitialize(
     _In_ uint32_t AllocBufferLength,
     _In_ uint32_t VirtualBufferLength,
     _In_ QUIC_RECV_BUF_MODE RecvMode,
-    _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk
+    _In_opt_ CXPLAT_POOL* ChunkPools,
+    _In_ BOOLEAN DeferAlloc
     )
 {
-    CXPLAT_DBG_ASSERT(AllocBufferLength != 0 || RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
-    CXPLAT_DBG_ASSERT(VirtualBufferLength != 0 || RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
-    CXPLAT_DBG_ASSERT(PreallocatedChunk == NULL || RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED);
+    CXPLAT_DBG_ASSERT(
+        AllocBufferLength != 0 ||
+        RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE);
+    CXPLAT_DBG_ASSERT(
+        VirtualBufferLength != 0 ||
+        RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE);
     CXPLAT_DBG_ASSERT((AllocBufferLength & (AllocBufferLength - 1)) == 0);     // Power of 2
     CXPLAT_DBG_ASSERT((VirtualBufferLength & (VirtualBufferLength - 1)) == 0); // Power of 2
     CXPLAT_DBG_ASSERT(AllocBufferLength <= VirtualBufferLength);
@@ -284,33 +343,25 @@ QuicRecvBufferInitialize(
     RecvBuffer->ReadLength = 0;
     RecvBuffer->RecvMode = RecvMode;
     RecvBuffer->RetiredChunk = NULL;
+    RecvBuffer->ChunkPools = ChunkPools;
     RecvBuffer->VirtualBufferLength = VirtualBufferLength;
     QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &RecvBuffer->WrittenRanges);
     CxPlatListInitializeHead(&RecvBuffer->Chunks);
 
-    if (RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED) {
+    if (QuicRecvBufferIsAppOwned(RecvBuffer)) {
+        RecvBuffer->Capacity = 0;
+    } else if (DeferAlloc) {
+        RecvBuffer->Capacity = AllocBufferLength;
+    } else {
         //
         // Setup an initial chunk.
         //
-        QUIC_RECV_CHUNK* Chunk = NULL;
-        if (PreallocatedChunk != NULL) {
-            Chunk = PreallocatedChunk;
-        } else {
-            Chunk = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + AllocBufferLength, QUIC_POOL_RECVBUF);
-            if (Chunk == NULL) {
-                QuicTraceEvent(
-                    AllocFailure,
-                    "Allocation of '%s' failed. (%llu bytes)",
-                    "recv_buffer",
-                    sizeof(QUIC_RECV_CHUNK) + AllocBufferLength);
-                return QUIC_STATUS_OUT_OF_MEMORY;
-            }
-            QuicRecvChunkInitialize(Chunk, AllocBufferLength, (uint8_t*)(Chunk + 1), FALSE);
+        QUIC_RECV_CHUNK* Chunk = QuicRecvChunkAlloc(ChunkPools, AllocBufferLength);
+        if (Chunk == NULL) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
         }
         CxPlatListInsertHead(&RecvBuffer->Chunks, &Chunk->Link);
         RecvBuffer->Capacity = AllocBufferLength;
-    } else {
-        RecvBuffer->Capacity = 0;
     }
 
     return QUIC_STATUS_SUCCESS;
@@ -337,6 +388,117 @@ QuicRecvBufferUninitialize(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_RECV_CHUNK*
+QuicRecvBufferDetachChunk(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t AllocBufferLength
+    )
+{
+    if (QuicRecvBufferIsAppOwned(RecvBuffer) ||
+        RecvBuffer->RetiredChunk != NULL ||
+        CxPlatListIsEmpty(&RecvBuffer->Chunks) ||
+        RecvBuffer->Chunks.Flink->Flink != &RecvBuffer->Chunks) {
+        return NULL;
+    }
+
+    QUIC_RECV_CHUNK* Chunk =
+        CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Flink, QUIC_RECV_CHUNK, Link);
+    if (Chunk->ExternalReference ||
+        !Chunk->AllocatedFromPool ||
+        Chunk->AllocLength != AllocBufferLength) {
+        return NULL;
+    }
+
+    CxPlatListEntryRemove(&Chunk->Link);
+    return Chunk;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvBufferAttachChunk(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ QUIC_RECV_CHUNK* Chunk
+    )
+{
+    if (QuicRecvBufferIsAppOwned(RecvBuffer) ||
+        !CxPlatListIsEmpty(&RecvBuffer->Chunks) ||
+        Chunk->AllocLength != RecvBuffer->Capacity) {
+        QuicRecvChunkFree(Chunk);
+        return;
+    }
+
+    //
+    // The same state as a buffer initialized without DeferAlloc.
+    //
+    CxPlatListInsertHead(&RecvBuffer->Chunks, &Chunk->Link);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvBufferShrink(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t AllocBufferLength
+    )
+{
+    CXPLAT_DBG_ASSERT((AllocBufferLength & (AllocBufferLength - 1)) == 0); // Power of 2
+
+    if (QuicRecvBufferIsAppOwned(RecvBuffer) ||
+        RecvBuffer->RetiredChunk != NULL ||
+        RecvBuffer->ReadPendingLength != 0 ||
+        QuicRecvBufferGetTotalLength(RecvBuffer) != RecvBuffer->BaseOffset ||
+        CxPlatListIsEmpty(&RecvBuffer->Chunks)) {
+        return;
+    }
+
+    QUIC_RECV_CHUNK* Chunk =
+        CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Flink, QUIC_RECV_CHUNK, Link);
+    if (Chunk->Link.Flink != &RecvBuffer->Chunks ||
+        Chunk->ExternalReference ||
+        Chunk->AllocLength <= AllocBufferLength) {
+        return;
+    }
+
+    QUIC_RECV_CHUNK* NewChunk = QuicRecvChunkAlloc(RecvBuffer->ChunkPools, AllocBufferLength);
+    if (NewChunk == NULL) {
+        return;
+    }
+
+    CxPlatListEntryRemove(&Chunk->Link);
+    QuicRecvChunkFree(Chunk);
+    CxPlatListInsertHead(&RecvBuffer->Chunks, &NewChunk->Link);
+    RecvBuffer->ReadStart = 0;
+    RecvBuffer->ReadLength = 0;
+    RecvBuffer->Capacity = AllocBufferLength;
+    QuicRangeCompact(&RecvBuffer->WrittenRanges);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicRecvBufferGetMemoryUsage(
+    _In_ const QUIC_RECV_BUFFER* RecvBuffer
+    )
+{
+    //
+    // Only count the chunks with a buffer of their own; app-owned buffers
+    // aren't MsQuic's memory.
+    //
+    uint64_t Usage = 0;
+    for (CXPLAT_LIST_ENTRY* Link = RecvBuffer->Chunks.Flink;
+         Link != &RecvBuffer->Chunks;
+         Link = Link->Flink) {
+        const QUIC_RECV_CHUNK* Chunk = CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link);
+        if (Chunk->Buffer == (uint8_t*)(Chunk + 1)) {
+            Usage += sizeof(QUIC_RECV_CHUNK) + Chunk->AllocLength;
+        }
+    }
+    const QUIC_RECV_CHUNK* Chunk = RecvBuffer->RetiredChunk;
+    if (Chunk != NULL && Chunk->Buffer == (uint8_t*)(Chunk + 1)) {
+        Usage += sizeof(QUIC_RECV_CHUNK) + Chunk->AllocLength;
+    }
+    return Usage;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 uint64_t
 QuicRecvBufferGetTotalLength(
@@ -423,7 +585,7 @@ QuicRecvBufferProvideChunks(
     _Inout_ CXPLAT_LIST_ENTRY* /* QUIC_RECV_CHUNKS */ Chunks
     )
 {
-    CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
+    CXPLAT_DBG_ASSERT(QuicRecvBufferIsAppOwned(RecvBuffer));
     CXPLAT_DBG_ASSERT(!CxPlatListIsEmpty(Chunks));
 
     uint64_t NewBufferLength = QuicRecvBufferGetTotalAllocLength(RecvBuffer);
@@ -475,12 +637,26 @@ QuicRecvBufferResize(
     )
 {
     CXPLAT_DBG_ASSERTMSG(
-        RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED,
+        !QuicRecvBufferIsAppOwned(RecvBuffer),
         "Should never resize in App-owned mode");
     CXPLAT_DBG_ASSERT(
         TargetBufferLength != 0 &&
         (TargetBufferLength & (TargetBufferLength - 1)) == 0); // Power of 2
-    CXPLAT_DBG_ASSERT(!CxPlatListIsEmpty(&RecvBuffer->Chunks)); // Should always have at least one chunk
+
+    if (CxPlatListIsEmpty(&RecvBuffer->Chunks)) {
+        //
+        // The deferred first chunk. There is no data to copy yet.
+        //
+        QUIC_RECV_CHUNK* FirstChunk =
+            QuicRecvChunkAlloc(RecvBuffer->ChunkPools, TargetBufferLength);
+        if (FirstChunk == NULL) {
+            return FALSE;
+        }
+        CxPlatListInsertHead(&RecvBuffer->Chunks, &FirstChunk->Link);
+        RecvBuffer->ReadStart = 0;
+        RecvBuffer->Capacity = TargetBufferLength;
+        return TRUE;
+    }
 
     QUIC_RECV_CHUNK* LastChunk =
         CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Blink, QUIC_RECV_CHUNK, Link);
@@ -488,17 +664,11 @@ QuicRecvBufferResize(
     BOOLEAN LastChunkIsFirst = LastChunk->Link.Blink == &RecvBuffer->Chunks;
 
     QUIC_RECV_CHUNK* NewChunk =
-        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + TargetBufferLength, QUIC_POOL_RECVBUF);
+        QuicRecvChunkAlloc(RecvBuffer->ChunkPools, TargetBufferLength);
     if (NewChunk == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)",
-            "recv_buffer",
-            sizeof(QUIC_RECV_CHUNK) + TargetBufferLength);
         return FALSE;
     }
 
-    QuicRecvChunkInitialize(NewChunk, TargetBufferLength, (uint8_t*)(NewChunk + 1), FALSE);
     CxPlatListInsertTail(&RecvBuffer->Chunks, &NewChunk->Link);
 
     if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE && LastChunk->ExternalReference) {
@@ -568,49 +738,100 @@ QuicRecvBufferResize(
     return TRUE;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferGetWriteBuffers(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint16_t WriteLength,
+    _Inout_ uint32_t* BufferCount,
+    _Out_writes_to_(*BufferCount, *BufferCount)
+        QUIC_BUFFER* Buffers
+    )
+{
+    CXPLAT_DBG_ASSERT(WriteLength != 0);
+
+    if (WriteOffset < RecvBuffer->BaseOffset ||
+        WriteOffset + WriteLength >
+            RecvBuffer->BaseOffset + QuicRecvBufferGetTotalAllocLength(RecvBuffer)) {
+        return FALSE;
+    }
+
+    QUIC_SUBRANGE* Sub;
+    for (uint32_t i = 0; (Sub = QuicRangeGetSafe(&RecvBuffer->WrittenRanges, i)) != NULL; ++i) {
+        if (Sub->Low < WriteOffset + WriteLength &&
+            WriteOffset < QuicRangeGetHigh(Sub) + 1) {
+            return FALSE;
+        }
+    }
+
+    QUIC_RECV_CHUNK_ITERATOR Iterator =
+        QuicRecvBufferGetChunkIterator(RecvBuffer, WriteOffset - RecvBuffer->BaseOffset);
+    uint32_t Count = 0;
+    while (WriteLength != 0) {
+        if (Count == *BufferCount ||
+            !QuicRecvChunkIteratorNext(&Iterator, FALSE, &Buffers[Count])) {
+            return FALSE;
+        }
+        if (Buffers[Count].Length > WriteLength) {
+            Buffers[Count].Length = WriteLength;
+        }
+        WriteLength -= (uint16_t)Buffers[Count].Length;
+        Count++;
+    }
+
+    *BufferCount = Count;
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRecvBufferCopyIntoChunks(
     _In_ QUIC_RECV_BUFFER* RecvBuffer,
     _In_ uint64_t WriteOffset,
     _In_ uint16_t WriteLength,
-    _In_reads_bytes_(WriteLength)
+    _In_reads_bytes_opt_(WriteLength)
         uint8_t const* WriteBuffer
     )
 {
     //
-    // Copy the data into the correct chunk(s).
-    // The caller is resonsible for ensuring there is enough space for the copy.
-    // In single/circular modes, data will always be copied to a single chunk.
-    // In multiple/app-owned mode this may result in copies to multiple chunks.
+    // No copy is needed if the data was already written in place.
     //
+    if (WriteBuffer != NULL) {
+        //
+        // Copy the data into the correct chunk(s).
+        // The caller is resonsible for ensuring there is enough space for the copy.
+        // In single/circular modes, data will always be copied to a single chunk.
+        // In multiple/app-owned mode this may result in copies to multiple chunks.
+        //
 
-    //
-    // Adjust the offset, length and buffer to ignore anything before the
-    // current base offset.
-    //
-    if (WriteOffset < RecvBuffer->BaseOffset) {
-        CXPLAT_DBG_ASSERT(RecvBuffer->BaseOffset - (uint64_t)WriteOffset < UINT16_MAX);
-        uint16_t Diff = (uint16_t)(RecvBuffer->BaseOffset - WriteOffset);
-        WriteOffset += Diff;
-        WriteLength -= Diff;
-        WriteBuffer += Diff;
-    }
+        //
+        // Adjust the offset, length and buffer to ignore anything before the
+        // current base offset.
+        //
+        if (WriteOffset < RecvBuffer->BaseOffset) {
+            CXPLAT_DBG_ASSERT(RecvBuffer->BaseOffset - (uint64_t)WriteOffset < UINT16_MAX);
+            uint16_t Diff = (uint16_t)(RecvBuffer->BaseOffset - WriteOffset);
+            WriteOffset += Diff;
+            WriteLength -= Diff;
+            WriteBuffer += Diff;
+        }
 
-    const uint64_t RelativeOffset = WriteOffset - RecvBuffer->BaseOffset;
+        const uint64_t RelativeOffset = WriteOffset - RecvBuffer->BaseOffset;
 
-    //
-    // Iterate over the list of chunk, copying the data.
-    //
-    QUIC_RECV_CHUNK_ITERATOR Iterator = QuicRecvBufferGetChunkIterator(RecvBuffer, RelativeOffset);
-    QUIC_BUFFER Buffer;
-    while (WriteLength != 0 && QuicRecvChunkIteratorNext(&Iterator, FALSE, &Buffer)) {
-        const uint32_t CopyLength = CXPLAT_MIN(Buffer.Length, WriteLength);
-        CxPlatCopyMemory(Buffer.Buffer, WriteBuffer, CopyLength);
-        WriteBuffer += CopyLength;
-        WriteLength -= (uint16_t)CopyLength;
+        //
+        // Iterate over the list of chunk, copying the data.
+        //
+        QUIC_RECV_CHUNK_ITERATOR Iterator = QuicRecvBufferGetChunkIterator(RecvBuffer, RelativeOffset);
+        QUIC_BUFFER Buffer;
+        while (WriteLength != 0 && QuicRecvChunkIteratorNext(&Iterator, FALSE, &Buffer)) {
+            const uint32_t CopyLength = CXPLAT_MIN(Buffer.Length, WriteLength);
+            CxPlatCopyMemory(Buffer.Buffer, WriteBuffer, CopyLength);
+            WriteBuffer += CopyLength;
+            WriteLength -= (uint16_t)CopyLength;
+        }
+        CXPLAT_DBG_ASSERT(WriteLength == 0); // Should always have enough room to copy everything
     }
-    CXPLAT_DBG_ASSERT(WriteLength == 0); // Should always have enough room to copy everything
 
     //
     // Update the amount of data readable in the first chunk.
@@ -630,7 +851,7 @@ QuicRecvBufferWrite(
     _In_ QUIC_RECV_BUFFER* RecvBuffer,
     _In_ uint64_t WriteOffset,
     _In_ uint16_t WriteLength,
-    _In_reads_bytes_(WriteLength) uint8_t const* WriteBuffer,
+    _In_reads_bytes_opt_(WriteLength) uint8_t const* WriteBuffer,
     _In_ uint64_t WriteQuota,
     _Out_ uint64_t* QuotaConsumed,
     _Out_ BOOLEAN* NewDataReady,
@@ -686,7 +907,7 @@ QuicRecvBufferWrite(
         //
         // There isn't enough space to write the data.
         //
-        if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        if (QuicRecvBufferIsAppOwned(RecvBuffer)) {
             //
             // We can't allocate more space in app-owned mode.
             // Let the caller notify the app to provide more buffer space.
@@ -697,11 +918,17 @@ QuicRecvBufferWrite(
 
         //
         // Add a new chunk (or replace the existing one), doubling the size of the largest chunk
-        // until there is enough space for the write.
+        // until there is enough space for the write. A deferred first chunk starts at the
+        // initial length instead.
         //
-        QUIC_RECV_CHUNK* LastChunk =
-            CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Blink, QUIC_RECV_CHUNK, Link);
-        uint32_t NewBufferLength = LastChunk->AllocLength << 1;
+        uint32_t NewBufferLength;
+        if (CxPlatListIsEmpty(&RecvBuffer->Chunks)) {
+            NewBufferLength = RecvBuffer->Capacity;
+        } else {
+            QUIC_RECV_CHUNK* LastChunk =
+                CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Blink, QUIC_RECV_CHUNK, Link);
+            NewBufferLength = LastChunk->AllocLength << 1;
+        }
         while (AbsoluteLength > RecvBuffer->BaseOffset + NewBufferLength) {
             NewBufferLength <<= 1;
         }
@@ -779,8 +1006,9 @@ QuicRecvBufferReadBufferNeededCount(
     }
 
     //
-    // RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED
-    // App-owned mode can need any number of buffer, we must count.
+    // RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED(_MULTIPLE)
+    // App-owned modes can need any number of buffer, we must count. Counting
+    // from the start of the buffer covers any read already pending too.
     //
 
     //
@@ -830,11 +1058,11 @@ QuicRecvBufferRead(
     CXPLAT_DBG_ASSERT(QuicRangeGetSafe(&RecvBuffer->WrittenRanges, 0) != NULL); // Only fail if you call read before write indicates read ready.
     CXPLAT_DBG_ASSERT(!CxPlatListIsEmpty(&RecvBuffer->Chunks)); // Should always have at least one chunk
     //
-    // Only multiple mode allows concurrent reads
+    // Only multiple modes allow concurrent reads
     //
     CXPLAT_DBG_ASSERT(
         RecvBuffer->ReadPendingLength == 0 ||
-        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE);
+        QuicRecvBufferIsMultiple(RecvBuffer));
 
     //
     // Find the length of the data written in the front, after the BaseOffset.
@@ -867,7 +1095,7 @@ QuicRecvBufferRead(
     // Check that the invariants on the number of receive buffer are respected.
     //
     CXPLAT_DBG_ASSERT(
-        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED || ReadableDataLeft == 0);
+        QuicRecvBufferIsAppOwned(RecvBuffer) || ReadableDataLeft == 0);
     CXPLAT_DBG_ASSERT(
         RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_SINGLE || *BufferCount <= 1);
     CXPLAT_DBG_ASSERT(
@@ -910,7 +1138,7 @@ QuicRecvBufferDrainFullChunks(
     }
 
     CXPLAT_DBG_ASSERT(RemainingDrainLength == 0 || NewFirstChunk != NULL);
-    if (NewFirstChunk == NULL && RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED) {
+    if (NewFirstChunk == NULL && !QuicRecvBufferIsAppOwned(RecvBuffer)) {
         //
         // All chunks have been fully drained. Recycle the last (and biggest) one.
         //
@@ -956,7 +1184,7 @@ QuicRecvBufferDrainFirstChunk(
 
     RecvBuffer->ReadStart = (RecvBuffer->ReadStart + DrainLength) % FirstChunk->AllocLength;
 
-    if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+    if (QuicRecvBufferIsAppOwned(RecvBuffer) ||
         FirstChunk->Link.Flink != &RecvBuffer->Chunks) {
         //
         // In App-owned mode or when more than one chunk is present, reduce the capacity to ensure the
@@ -994,9 +1222,9 @@ QuicRecvBufferDrain(
     CXPLAT_DBG_ASSERT(!CxPlatListIsEmpty(&RecvBuffer->Chunks));
     CXPLAT_DBG_ASSERT(DrainLength <= RecvBuffer->VirtualBufferLength);
 
-    if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE) {
+    if (QuicRecvBufferIsMultiple(RecvBuffer)) {
         //
-        // In Multiple mode, data not drained stays pending.
+        // In Multiple modes, data not drained stays pending.
         //
         RecvBuffer->ReadPendingLength -= DrainLength;
     } else {
@@ -1024,10 +1252,10 @@ QuicRecvBufferDrain(
 
     if (CxPlatListIsEmpty(&RecvBuffer->Chunks)) {
         //
-        // App-owned mode is the only mode where we can run out of chunks.
+        // App-owned modes are the only modes where we can run out of chunks.
         // In all other modes, if the last chunk was fully drained, we recycle it instead.
         //
-        CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
+        CXPLAT_DBG_ASSERT(QuicRecvBufferIsAppOwned(RecvBuffer));
         CXPLAT_DBG_ASSERT(DrainLength == 0);
         return TRUE;
     }
@@ -1040,9 +1268,9 @@ QuicRecvBufferDrain(
 
     //
     // Finally, dereference all chunks.
-    // For Multiple mode, chunks that still have read-pending data stay referenced.
+    // For Multiple modes, chunks that still have read-pending data stay referenced.
     //
-    if (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE) {
+    if (!QuicRecvBufferIsMultiple(RecvBuffer)) {
         for (CXPLAT_LIST_ENTRY* Link = RecvBuffer->Chunks.Flink;
              Link != &RecvBuffer->Chunks;
              Link = Link->Flink) {
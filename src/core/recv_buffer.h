@@ -13,8 +13,10 @@ typedef enum QUIC_RECV_BUF_MODE {
     QUIC_RECV_BUF_MODE_SINGLE,      // Only one receive with a single contiguous buffer at a time.
     QUIC_RECV_BUF_MODE_CIRCULAR,    // Only one receive that may indicate two contiguous buffers at a time.
     QUIC_RECV_BUF_MODE_MULTIPLE,    // Multiple independent receives that may indicate up to two contiguous buffers at a time.
-    QUIC_RECV_BUF_MODE_APP_OWNED    // Uses memory buffers provided by the app. Only one receive at a time,
+    QUIC_RECV_BUF_MODE_APP_OWNED,   // Uses memory buffers provided by the app. Only one receive at a time,
                                     //   that may indicate up to the number of provided buffers.
+    QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE // Uses memory buffers provided by the app. Multiple independent
+                                    //   receives that may indicate up to the number of provided buffers.
 } QUIC_RECV_BUF_MODE;
 
 //
@@ -39,6 +41,12 @@ QuicRecvChunkInitialize(
     _In_ BOOLEAN BufferAllocatedFromPool
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvChunkFree(
+    _In_ QUIC_RECV_CHUNK* Chunk
+    );
+
 typedef struct QUIC_RECV_BUFFER {
 
     //
@@ -51,6 +59,12 @@ typedef struct QUIC_RECV_BUFFER {
     //
     QUIC_RECV_CHUNK* RetiredChunk;
 
+    //
+    // Optional, QUIC_RECV_CHUNK_POOL_CLASS_COUNT pools of chunks, sized
+    // (QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE << i), to allocate chunks from.
+    //
+    CXPLAT_POOL* ChunkPools;
+
     //
     // Ranges of stream offsets that have been written to the buffer,
     // starting from 0 (not only what is currently in the buffer).
@@ -90,7 +104,8 @@ typedef struct QUIC_RECV_BUFFER {
 
     //
     // Basically same as Chunk->AllocLength of first chunk, but start shrinking
-    // by drain operation after next chunk is allocated.
+    // by drain operation after next chunk is allocated. Until a deferred first
+    // chunk is allocated, the length it will be allocated with.
     //
     uint32_t Capacity;
 
@@ -102,11 +117,42 @@ typedef struct QUIC_RECV_BUFFER {
 
 } QUIC_RECV_BUFFER;
 
+//
+// Returns TRUE if the buffer uses memory buffers provided by the app.
+//
+QUIC_INLINE
+BOOLEAN
+QuicRecvBufferIsAppOwned(
+    _In_ const QUIC_RECV_BUFFER* RecvBuffer
+    )
+{
+    return
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE;
+}
+
+//
+// Returns TRUE if the buffer allows multiple independent reads to be pending,
+// each one indicating data starting from the end of the previous one.
+//
+QUIC_INLINE
+BOOLEAN
+QuicRecvBufferIsMultiple(
+    _In_ const QUIC_RECV_BUFFER* RecvBuffer
+    )
+{
+    return
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE ||
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE;
+}
+
 //
 // Initialize a QUIC_RECV_BUFFER.
-// Can only fail if PreallocatedChunk == NULL && RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED.
-// PreallocatedChunk ownership is given to the receive buffer.
-// PreallocatedChunk must be null if RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED.
+// Can only fail if RecvMode isn't an app-owned mode and DeferAlloc is FALSE.
+// With DeferAlloc, the first chunk isn't allocated until the first write, so
+// that a buffer which never receives any data costs no memory.
+// ChunkPools, if provided, must outlive the receive buffer. Chunks of a pooled
+// size are allocated from them, others from the general allocator.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
@@ -115,7 +161,8 @@ QuicRecvBufferInitialize(
     _In_ uint32_t AllocBufferLength,
     _In_ uint32_t VirtualBufferLength,
     _In_ QUIC_RECV_BUF_MODE RecvMode,
-    _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk
+    _In_opt_ CXPLAT_POOL* ChunkPools,
+    _In_ BOOLEAN DeferAlloc
     );
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -124,6 +171,51 @@ QuicRecvBufferUninitialize(
     _In_ QUIC_RECV_BUFFER* RecvBuffer
     );
 
+//
+// Removes the buffer's only chunk, before uninitializing it, so that another
+// buffer can reuse it. Returns NULL unless that chunk is an unreferenced,
+// pooled chunk of AllocBufferLength bytes.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_RECV_CHUNK*
+QuicRecvBufferDetachChunk(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t AllocBufferLength
+    );
+
+//
+// Gives a buffer initialized with DeferAlloc a detached chunk as its first
+// chunk, in place of allocating one on the first write. The chunk is freed
+// instead if it doesn't fit the buffer.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvBufferAttachChunk(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ QUIC_RECV_CHUNK* Chunk
+    );
+
+//
+// Replaces a grown buffer with a chunk of AllocBufferLength bytes, if it holds
+// no data, to free memory while the receiver is idle. It grows again on the
+// next write that needs it. Does nothing in app-owned mode.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvBufferShrink(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t AllocBufferLength
+    );
+
+//
+// Returns the bytes allocated for the buffer's chunks.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicRecvBufferGetMemoryUsage(
+    _In_ const QUIC_RECV_BUFFER* RecvBuffer
+    );
+
 //
 // Get the buffer's total length from offset 0. This does not necessarily mean
 // all of this buffer is available to be read, as some of it may have already
@@ -156,7 +248,7 @@ QuicRecvBufferIncreaseVirtualBufferLength(
 
 //
 // Provide app-owned buffers. At least one chunk must be provided.
-// Only valid for QUIC_RECV_BUF_MODE_APP_OWNED mode.
+// Only valid for the app-owned modes.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
@@ -166,7 +258,28 @@ QuicRecvBufferProvideChunks(
     );
 
 //
-// Buffers a (possibly out-of-order or duplicate) range of bytes.
+// Gets the buffer space a range of bytes would be written to, so the caller
+// can write the data there itself before calling QuicRecvBufferWrite with a
+// NULL WriteBuffer. Returns FALSE if the range isn't completely allocated,
+// overlaps any data already written (so a failed write can't corrupt
+// anything) or would need more than BufferCount buffers. The space stays
+// valid until the buffer is next written to or drained.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferGetWriteBuffers(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint16_t WriteLength,
+    _Inout_ uint32_t* BufferCount,
+    _Out_writes_to_(*BufferCount, *BufferCount)
+        QUIC_BUFFER* Buffers
+    );
+
+//
+// Buffers a (possibly out-of-order or duplicate) range of bytes. A NULL
+// WriteBuffer indicates the bytes were already written to the buffers returned
+// by QuicRecvBufferGetWriteBuffers.
 //
 // NewDataReady indicates if new in-order bytes are ready to be delivered to the
 // client.
@@ -178,7 +291,7 @@ QuicRecvBufferWrite(
     _In_ QUIC_RECV_BUFFER* RecvBuffer,
     _In_ uint64_t WriteOffset,
     _In_ uint16_t WriteLength,
-    _In_reads_bytes_(WriteLength) uint8_t const* WriteBuffer,
+    _In_reads_bytes_opt_(WriteLength) uint8_t const* WriteBuffer,
     _In_ uint64_t WriteQuota,
     _Out_ uint64_t* QuotaConsumed,
     _Out_ BOOLEAN* NewDataReady,
@@ -216,8 +329,8 @@ QuicRecvBufferRead(
 // Marks a number of bytes at the beginning of the buffer as delivered (freeing
 // space in the buffer).
 //
-// When receive mode isn't MULTIPLE it invalidates the pointer returned by
-// QuicRecvBufferRead.
+// When receive mode isn't MULTIPLE or APP_OWNED_MULTIPLE it invalidates the
+// pointer returned by QuicRecvBufferRead.
 //
 // Returns TRUE if there is no more data available to be read.
 //
@@ -0,0 +1,189 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Receive capture writes datagrams synchronously, under a lock, as they are
+    indicated to the bindings. It relies on the file stream's buffering to
+    keep this cheap enough while enabled; it costs nothing but a pointer check
+    otherwise.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "recv_capture.c.clog.h"
+#endif
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicRecvCaptureInitialize(
+    void
+    )
+{
+    CxPlatDispatchLockInitialize(&MsQuicLib.RecvCapture.Lock);
+    MsQuicLib.RecvCapture.File = NULL;
+}
+
+#ifndef _KERNEL_MODE
+
+//
+// Must be called with the capture lock held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicRecvCaptureClose(
+    void
+    )
+{
+    if (MsQuicLib.RecvCapture.File != NULL) {
+        fclose((FILE*)MsQuicLib.RecvCapture.File);
+        MsQuicLib.RecvCapture.File = NULL;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicRecvCaptureCopyAddr(
+    _Out_ QUIC_RECV_CAPTURE_ADDR* Dest,
+    _In_ const QUIC_ADDR* Addr
+    )
+{
+    Dest->Port = QuicAddrGetPort(Addr);
+    if (QuicAddrGetFamily(Addr) == QUIC_ADDRESS_FAMILY_INET) {
+        Dest->Family = 4;
+        CxPlatCopyMemory(Dest->Ip, &Addr->Ipv4.sin_addr, 4);
+    } else {
+        Dest->Family = 6;
+        CxPlatCopyMemory(Dest->Ip, &Addr->Ipv6.sin6_addr, 16);
+    }
+}
+
+#endif // !_KERNEL_MODE
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicRecvCaptureUninitialize(
+    void
+    )
+{
+#ifndef _KERNEL_MODE
+    CxPlatDispatchLockAcquire(&MsQuicLib.RecvCapture.Lock);
+    QuicRecvCaptureClose();
+    CxPlatDispatchLockRelease(&MsQuicLib.RecvCapture.Lock);
+#endif
+    CxPlatDispatchLockUninitialize(&MsQuicLib.RecvCapture.Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicRecvCaptureSetConfig(
+    _In_ const QUIC_RECV_CAPTURE_CONFIG* Config
+    )
+{
+#ifdef _KERNEL_MODE
+    UNREFERENCED_PARAMETER(Config);
+    return QUIC_STATUS_NOT_SUPPORTED;
+#else
+    FILE* File = NULL;
+    if (Config->FilePath != NULL) {
+        if (Config->FilePath[0] == '\0') {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        File = fopen(Config->FilePath, "wb");
+        if (File == NULL) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "Failed to open receive capture file");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        const QUIC_RECV_CAPTURE_FILE_HEADER Header = {
+            QUIC_RECV_CAPTURE_MAGIC,
+            QUIC_RECV_CAPTURE_VERSION
+        };
+        if (fwrite(&Header, sizeof(Header), 1, File) != 1) {
+            fclose(File);
+            return QUIC_STATUS_INTERNAL_ERROR;
+        }
+    }
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.RecvCapture.Lock);
+    QuicRecvCaptureClose();
+    MsQuicLib.RecvCapture.StartTimeUs = CxPlatTimeUs64();
+    MsQuicLib.RecvCapture.MaxBytes = Config->MaxBytes;
+    MsQuicLib.RecvCapture.BytesWritten = sizeof(QUIC_RECV_CAPTURE_FILE_HEADER);
+    MsQuicLib.RecvCapture.File = File;
+    CxPlatDispatchLockRelease(&MsQuicLib.RecvCapture.Lock);
+
+    QuicTraceLogInfo(
+        LibraryRecvCaptureSet,
+        "[ lib] Receive capture %s",
+        File != NULL ? "started" : "stopped");
+
+    return QUIC_STATUS_SUCCESS;
+#endif
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvCaptureDatagrams(
+    _In_ const CXPLAT_RECV_DATA* DatagramChain
+    )
+{
+#ifdef _KERNEL_MODE
+    UNREFERENCED_PARAMETER(DatagramChain);
+#else
+    QUIC_RECV_CAPTURE* Capture = &MsQuicLib.RecvCapture;
+    CxPlatDispatchLockAcquire(&Capture->Lock);
+    FILE* File = (FILE*)Capture->File;
+    if (File == NULL) {
+        goto Exit; // Stopped since the caller checked.
+    }
+
+    const uint64_t TimeUs = CxPlatTimeDiff64(Capture->StartTimeUs, CxPlatTimeUs64());
+
+    for (const CXPLAT_RECV_DATA* Datagram = DatagramChain;
+        Datagram != NULL;
+        Datagram = Datagram->Next) {
+
+        const uint64_t RecordLength =
+            sizeof(QUIC_RECV_CAPTURE_RECORD) + Datagram->BufferLength;
+        if (Capture->MaxBytes != 0 &&
+            Capture->BytesWritten + RecordLength > Capture->MaxBytes) {
+            QuicTraceLogInfo(
+                LibraryRecvCaptureFull,
+                "[ lib] Receive capture stopped at its size limit");
+            QuicRecvCaptureClose();
+            break;
+        }
+
+        QUIC_RECV_CAPTURE_RECORD Record;
+        CxPlatZeroMemory(&Record, sizeof(Record));
+        Record.TimeUs = TimeUs;
+        QuicRecvCaptureCopyAddr(&Record.LocalAddress, &Datagram->Route->LocalAddress);
+        QuicRecvCaptureCopyAddr(&Record.RemoteAddress, &Datagram->Route->RemoteAddress);
+        Record.BufferLength = Datagram->BufferLength;
+        Record.TypeOfService = Datagram->TypeOfService;
+
+        if (fwrite(&Record, sizeof(Record), 1, File) != 1 ||
+            fwrite(Datagram->Buffer, 1, Datagram->BufferLength, File) != Datagram->BufferLength) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "Failed to write receive capture file");
+            QuicRecvCaptureClose();
+            break;
+        }
+        Capture->BytesWritten += RecordLength;
+    }
+
+Exit:
+
+    CxPlatDispatchLockRelease(&Capture->Lock);
+#endif
+}
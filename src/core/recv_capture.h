@@ -0,0 +1,125 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Opt-in capture of the datagrams received by the library's bindings, as
+    they are handed up by the datapath, so real traffic can later be replayed
+    against a server (see src/tools/recvreplay).
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The capture file starts with a QUIC_RECV_CAPTURE_FILE_HEADER. Each datagram
+// then follows as a QUIC_RECV_CAPTURE_RECORD and BufferLength bytes of payload.
+// All fields are in the capturing machine's byte order.
+//
+#define QUIC_RECV_CAPTURE_MAGIC         0x50414351 // "QCAP"
+#define QUIC_RECV_CAPTURE_VERSION       1
+
+typedef struct QUIC_RECV_CAPTURE_FILE_HEADER {
+
+    uint32_t Magic;
+    uint32_t Version;
+
+} QUIC_RECV_CAPTURE_FILE_HEADER;
+
+typedef struct QUIC_RECV_CAPTURE_ADDR {
+
+    uint16_t Family; // 4 or 6
+    uint16_t Port;
+    uint8_t Ip[16];  // Only the first 4 bytes are used for IPv4.
+
+} QUIC_RECV_CAPTURE_ADDR;
+
+typedef struct QUIC_RECV_CAPTURE_RECORD {
+
+    //
+    // When the datagram was received, relative to the start of the capture.
+    // All datagrams indicated together have the same time.
+    //
+    uint64_t TimeUs;
+
+    QUIC_RECV_CAPTURE_ADDR LocalAddress;
+    QUIC_RECV_CAPTURE_ADDR RemoteAddress;
+
+    uint16_t BufferLength;
+    uint8_t TypeOfService;
+    uint8_t Reserved[5];
+
+} QUIC_RECV_CAPTURE_RECORD;
+
+CXPLAT_STATIC_ASSERT(
+    sizeof(QUIC_RECV_CAPTURE_RECORD) == 56,
+    "The capture record layout is part of the file format");
+
+//
+// Library wide capture state.
+//
+typedef struct QUIC_RECV_CAPTURE {
+
+    //
+    // Serializes writes to the file, and starting and stopping the capture.
+    //
+    CXPLAT_DISPATCH_LOCK Lock;
+
+    //
+    // The file datagrams are written to. NULL when not capturing.
+    //
+    void* File;
+
+    uint64_t StartTimeUs;
+
+    //
+    // The size the file is limited to, or 0 for no limit, and its current size.
+    //
+    uint64_t MaxBytes;
+    uint64_t BytesWritten;
+
+} QUIC_RECV_CAPTURE;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicRecvCaptureInitialize(
+    void
+    );
+
+//
+// Stops any capture in progress.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicRecvCaptureUninitialize(
+    void
+    );
+
+//
+// Applies QUIC_PARAM_GLOBAL_RECV_CAPTURE, stopping any previous capture.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicRecvCaptureSetConfig(
+    _In_ const QUIC_RECV_CAPTURE_CONFIG* Config
+    );
+
+//
+// Records a chain of datagrams just received from the datapath. Only called
+// while a capture may be in progress.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRecvCaptureDatagrams(
+    _In_ const CXPLAT_RECV_DATA* DatagramChain
+    );
+
+#if defined(__cplusplus)
+}
+#endif
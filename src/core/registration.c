@@ -63,6 +63,8 @@ QuicRegistrationClose(
     }
 #endif
     CxPlatRundownUninitialize(&Registration->Rundown);
+    QuicClientTicketCacheUninitialize(&Registration->ClientTicketCache);
+    QuicAntiReplayUninitialize(&Registration->AntiReplay);
     CxPlatDispatchLockUninitialize(&Registration->ConnectionLock);
     CxPlatLockUninitialize(&Registration->ConfigLock);
     CxPlatEventUninitialize(Registration->CloseEvent);
@@ -184,6 +186,8 @@ MsQuicRegistrationOpen(
     CxPlatListInitializeHead(&Registration->Connections);
     CxPlatListInitializeHead(&Registration->Listeners);
     CxPlatRundownInitialize(&Registration->Rundown);
+    QuicClientTicketCacheInitialize(&Registration->ClientTicketCache);
+    QuicAntiReplayInitialize(&Registration->AntiReplay);
 #if DEBUG
     CxPlatRefInitializeMultiple(Registration->RefTypeBiasedCount, QUIC_REG_REF_COUNT);
     CxPlatRefIncrement(&Registration->RefTypeBiasedCount[QUIC_REG_REF_HANDLE_OWNER]);
@@ -261,6 +265,8 @@ Error:
         QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_REGISTRATION, &Registration->DbgObjectLink);
 #endif
         CxPlatRundownUninitialize(&Registration->Rundown);
+        QuicClientTicketCacheUninitialize(&Registration->ClientTicketCache);
+        QuicAntiReplayUninitialize(&Registration->AntiReplay);
         CxPlatDispatchLockUninitialize(&Registration->ConnectionLock);
         CxPlatLockUninitialize(&Registration->ConfigLock);
         CXPLAT_FREE(Registration, QUIC_POOL_REGISTRATION);
@@ -360,10 +366,33 @@ MsQuicRegistrationShutdown(
 #pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
         QUIC_REGISTRATION* Registration = (QUIC_REGISTRATION*)Handle;
 
+        //
+        // Connections are handed to their workers in per-worker batches, so
+        // each worker lock is taken once per batch instead of once per
+        // connection. Without the batch buffers, fall back to queuing them
+        // one at a time.
+        //
+        const uint16_t WorkerCount = Registration->WorkerPool->WorkerCount;
+        QUIC_CONNECTION** Batches =
+            CXPLAT_ALLOC_NONPAGED(
+                (size_t)WorkerCount * QUIC_WORKER_TEARDOWN_BATCH * sizeof(QUIC_CONNECTION*) +
+                WorkerCount * sizeof(uint32_t),
+                QUIC_POOL_TEARDOWN_BATCH);
+        uint32_t* BatchCounts =
+            Batches == NULL ?
+                NULL :
+                (uint32_t*)(Batches + (size_t)WorkerCount * QUIC_WORKER_TEARDOWN_BATCH);
+        if (BatchCounts != NULL) {
+            CxPlatZeroMemory(BatchCounts, WorkerCount * sizeof(uint32_t));
+        }
+
         CxPlatDispatchLockAcquire(&Registration->ConnectionLock);
 
         if (Registration->ShuttingDown) {
             CxPlatDispatchLockRelease(&Registration->ConnectionLock);
+            if (Batches != NULL) {
+                CXPLAT_FREE(Batches, QUIC_POOL_TEARDOWN_BATCH);
+            }
             goto Exit;
         }
 
@@ -389,14 +418,47 @@ MsQuicRegistrationShutdown(
                 Oper->API_CALL.Context->CONN_SHUTDOWN.ErrorCode = ErrorCode;
                 Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = TRUE;
                 Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = FALSE;
-                QuicConnQueueHighestPriorityOper(Connection, Oper);
+
+                QUIC_WORKER* Worker = Connection->Worker;
+                const size_t Index = (size_t)(Worker - Registration->WorkerPool->Workers);
+                if (BatchCounts == NULL || Index >= WorkerCount) {
+                    QuicConnQueueHighestPriorityOper(Connection, Oper);
+
+                } else if (QuicOperationEnqueueFront(
+                        &Connection->OperQ, Connection->Partition, Oper)) {
+                    //
+                    // The connection needs to be queued on its worker because
+                    // this was the first operation in its OperQ.
+                    //
+                    QUIC_CONNECTION** Batch = Batches + Index * QUIC_WORKER_TEARDOWN_BATCH;
+                    Batch[BatchCounts[Index]++] = Connection;
+                    if (BatchCounts[Index] == QUIC_WORKER_TEARDOWN_BATCH) {
+                        QuicWorkerQueueTeardownConnections(Worker, Batch, BatchCounts[Index]);
+                        BatchCounts[Index] = 0;
+                    }
+                }
             }
 
             Entry = Entry->Flink;
         }
 
+        if (BatchCounts != NULL) {
+            for (uint16_t i = 0; i < WorkerCount; ++i) {
+                if (BatchCounts[i] != 0) {
+                    QuicWorkerQueueTeardownConnections(
+                        &Registration->WorkerPool->Workers[i],
+                        Batches + (size_t)i * QUIC_WORKER_TEARDOWN_BATCH,
+                        BatchCounts[i]);
+                }
+            }
+        }
+
         CxPlatDispatchLockRelease(&Registration->ConnectionLock);
 
+        if (Batches != NULL) {
+            CXPLAT_FREE(Batches, QUIC_POOL_TEARDOWN_BATCH);
+        }
+
         Entry = Registration->Listeners.Flink;
         while (Entry != &Registration->Listeners) {
             QUIC_LISTENER* Listener =
@@ -513,11 +575,82 @@ QuicRegistrationParamSet(
         const void* Buffer
     )
 {
-    UNREFERENCED_PARAMETER(Registration);
-    UNREFERENCED_PARAMETER(Param);
-    UNREFERENCED_PARAMETER(BufferLength);
-    UNREFERENCED_PARAMETER(Buffer);
-    return QUIC_STATUS_INVALID_PARAMETER;
+    QUIC_STATUS Status;
+
+    switch (Param) {
+
+    case QUIC_PARAM_REGISTRATION_PATH_TELEMETRY: {
+
+        if (BufferLength != sizeof(QUIC_PATH_TELEMETRY_CONFIG) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_PATH_TELEMETRY_CONFIG* Config =
+            (const QUIC_PATH_TELEMETRY_CONFIG*)Buffer;
+        if (Config->Callback != NULL &&
+            Config->IntervalMs == 0 && Config->IntervalRtts == 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // The workers read the configuration without a lock, so it can't
+        // change while there are connections.
+        //
+        CxPlatDispatchLockAcquire(&Registration->ConnectionLock);
+        if (!CxPlatListIsEmpty(&Registration->Connections)) {
+            Status = QUIC_STATUS_INVALID_STATE;
+        } else {
+            Registration->Telemetry = *Config;
+            Status = QUIC_STATUS_SUCCESS;
+        }
+        CxPlatDispatchLockRelease(&Registration->ConnectionLock);
+        break;
+    }
+
+    case QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE:
+
+        if (BufferLength != sizeof(QUIC_CLIENT_TICKET_CACHE_CONFIG) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Status =
+            QuicClientTicketCacheSetConfig(
+                &Registration->ClientTicketCache,
+                (const QUIC_CLIENT_TICKET_CACHE_CONFIG*)Buffer);
+        break;
+
+    case QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY:
+
+        if (BufferLength != sizeof(QUIC_ZERORTT_ANTI_REPLAY_CONFIG) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // The filter is checked without a registration lock, so it can't be
+        // replaced while there are connections.
+        //
+        CxPlatDispatchLockAcquire(&Registration->ConnectionLock);
+        if (!CxPlatListIsEmpty(&Registration->Connections)) {
+            Status = QUIC_STATUS_INVALID_STATE;
+        } else {
+            Status =
+                QuicAntiReplaySetConfig(
+                    &Registration->AntiReplay,
+                    (const QUIC_ZERORTT_ANTI_REPLAY_CONFIG*)Buffer);
+        }
+        CxPlatDispatchLockRelease(&Registration->ConnectionLock);
+        break;
+
+    default:
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        break;
+    }
+
+    return Status;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -530,9 +663,92 @@ QuicRegistrationParamGet(
         void* Buffer
     )
 {
-    UNREFERENCED_PARAMETER(Registration);
-    UNREFERENCED_PARAMETER(Param);
-    UNREFERENCED_PARAMETER(BufferLength);
-    UNREFERENCED_PARAMETER(Buffer);
-    return QUIC_STATUS_INVALID_PARAMETER;
+    QUIC_STATUS Status;
+
+    switch (Param) {
+
+    case QUIC_PARAM_REGISTRATION_PATH_TELEMETRY:
+
+        if (*BufferLength < sizeof(QUIC_PATH_TELEMETRY_CONFIG)) {
+            *BufferLength = sizeof(QUIC_PATH_TELEMETRY_CONFIG);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_PATH_TELEMETRY_CONFIG);
+        CxPlatCopyMemory(Buffer, &Registration->Telemetry, sizeof(QUIC_PATH_TELEMETRY_CONFIG));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE:
+
+        if (*BufferLength < sizeof(QUIC_CLIENT_TICKET_CACHE_CONFIG)) {
+            *BufferLength = sizeof(QUIC_CLIENT_TICKET_CACHE_CONFIG);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_CLIENT_TICKET_CACHE_CONFIG);
+        QuicClientTicketCacheGetConfig(&Registration->ClientTicketCache, (QUIC_CLIENT_TICKET_CACHE_CONFIG*)Buffer);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE_STATS:
+
+        if (*BufferLength < sizeof(QUIC_CLIENT_TICKET_CACHE_STATISTICS)) {
+            *BufferLength = sizeof(QUIC_CLIENT_TICKET_CACHE_STATISTICS);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_CLIENT_TICKET_CACHE_STATISTICS);
+        QuicClientTicketCacheGetStatistics(
+            &Registration->ClientTicketCache, (QUIC_CLIENT_TICKET_CACHE_STATISTICS*)Buffer);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY:
+
+        if (*BufferLength < sizeof(QUIC_ZERORTT_ANTI_REPLAY_CONFIG)) {
+            *BufferLength = sizeof(QUIC_ZERORTT_ANTI_REPLAY_CONFIG);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_ZERORTT_ANTI_REPLAY_CONFIG);
+        CxPlatCopyMemory(
+            Buffer, &Registration->AntiReplay.Config, sizeof(QUIC_ZERORTT_ANTI_REPLAY_CONFIG));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    default:
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        break;
+    }
+
+    return Status;
 }
@@ -27,6 +27,7 @@ typedef enum QUIC_REGISTRATION_REF {
     QUIC_REG_REF_CONFIGURATION,
     QUIC_REG_REF_CONNECTION,
     QUIC_REG_REF_LISTENER,
+    QUIC_REG_REF_TELEMETRY,
 
     QUIC_REG_REF_COUNT
 
@@ -113,6 +114,24 @@ typedef struct QUIC_REGISTRATION {
     //
     CXPLAT_LIST_ENTRY Listeners;
 
+    //
+    // Periodic path telemetry for the registration's connections. Only set
+    // while there are no connections.
+    //
+    QUIC_PATH_TELEMETRY_CONFIG Telemetry;
+
+    //
+    // Resumption tickets received by the registration's client connections.
+    //
+    QUIC_CLIENT_TICKET_CACHE ClientTicketCache;
+
+    //
+    // Recently seen ClientHellos that presented a resumption ticket to the
+    // registration's listeners. Only configured while there are no
+    // connections.
+    //
+    QUIC_ANTI_REPLAY AntiReplay;
+
     //
     // Rundown for all child objects.
     //
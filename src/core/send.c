@@ -33,7 +33,12 @@ QuicSendInitialize(
     )
 {
     CxPlatListInitializeHead(&Send->SendStreams);
+    Send->PriorityLevels = Send->InlinePriorityLevels;
+    Send->PriorityLevelCount = 0;
+    Send->PriorityLevelCapacity = QUIC_SEND_PRIORITY_LEVELS_INLINE;
     Send->MaxData = Settings->ConnFlowControlWindow;
+    Send->MaxDataSent = Settings->ConnFlowControlWindow;
+    Send->RecvWindow = Settings->ConnFlowControlWindow;
     Send->SkippedPacketNumber = UINT64_MAX;
 
     //
@@ -61,10 +66,8 @@ QuicSendUninitialize(
     Send->DelayedAckTimerActive = FALSE;
     Send->SendFlags = 0;
 
-    if (Send->InitialToken != NULL) {
-        CXPLAT_FREE(Send->InitialToken, QUIC_POOL_INITIAL_TOKEN);
-        Send->InitialToken = NULL;
-    }
+    Send->InitialToken = NULL; // Freed with the connection's handshake arena.
+    Send->InitialTokenLength = 0;
 
     //
     // Release all the stream refs.
@@ -82,6 +85,19 @@ QuicSendUninitialize(
 
         QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
     }
+
+    if (Send->PriorityLevels != Send->InlinePriorityLevels) {
+        CXPLAT_FREE(Send->PriorityLevels, QUIC_POOL_SEND_PRIORITY);
+        Send->PriorityLevels = Send->InlinePriorityLevels;
+        Send->PriorityLevelCapacity = QUIC_SEND_PRIORITY_LEVELS_INLINE;
+    }
+    Send->PriorityLevelCount = 0;
+    Send->PriorityLevelsInvalid = FALSE;
+
+    if (Send->RecvWindowGrowth != 0) {
+        QuicLibraryReleaseRecvWindow(Send->RecvWindowGrowth);
+        Send->RecvWindowGrowth = 0;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -92,6 +108,12 @@ QuicSendApplyNewSettings(
     )
 {
     Send->MaxData = Settings->ConnFlowControlWindow;
+    Send->MaxDataSent = Settings->ConnFlowControlWindow;
+    Send->RecvWindow = Settings->ConnFlowControlWindow;
+    if (Send->RecvWindowGrowth != 0) {
+        QuicLibraryReleaseRecvWindow(Send->RecvWindowGrowth);
+        Send->RecvWindowGrowth = 0;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -102,6 +124,7 @@ QuicSendReset(
 {
     Send->SendFlags = 0;
     Send->LastFlushTime = 0;
+    Send->NextTxTime = 0;
     if (Send->DelayedAckTimerActive) {
         QuicConnTimerCancel(QuicSendGetConnection(Send), QUIC_CONN_TIMER_ACK_DELAY);
         Send->DelayedAckTimerActive = FALSE;
@@ -109,6 +132,9 @@ QuicSendReset(
     QuicConnTimerCancel(
         QuicSendGetConnection(Send),
         QUIC_CONN_TIMER_PACING);
+    QuicPacingQueueRemoveConnection(
+        &QuicSendGetConnection(Send)->Worker->PacingQueue,
+        QuicSendGetConnection(Send));
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -154,6 +180,212 @@ QuicSendQueueFlush(
     }
 }
 
+//
+// Looks up the level for Priority. Returns TRUE if it exists; otherwise Index
+// is where a new level for Priority would be inserted.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendFindPriorityLevel(
+    _In_ const QUIC_SEND* Send,
+    _In_ uint16_t Priority,
+    _Out_ uint32_t* Index
+    )
+{
+    uint32_t Low = 0;
+    uint32_t High = Send->PriorityLevelCount;
+    while (Low < High) {
+        uint32_t Mid = Low + (High - Low) / 2;
+        if (Send->PriorityLevels[Mid].Priority > Priority) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
+        }
+    }
+    *Index = Low;
+    return
+        Low < Send->PriorityLevelCount &&
+        Send->PriorityLevels[Low].Priority == Priority;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendGrowPriorityLevels(
+    _In_ QUIC_SEND* Send
+    )
+{
+    if (Send->PriorityLevelCount < Send->PriorityLevelCapacity) {
+        return TRUE;
+    }
+
+    uint32_t NewCapacity = Send->PriorityLevelCapacity * 2;
+    QUIC_SEND_PRIORITY_LEVEL* NewLevels =
+        CXPLAT_ALLOC_NONPAGED(
+            NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL),
+            QUIC_POOL_SEND_PRIORITY);
+    if (NewLevels == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Send priority levels",
+            NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+        return FALSE;
+    }
+
+    CxPlatCopyMemory(
+        NewLevels,
+        Send->PriorityLevels,
+        Send->PriorityLevelCount * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+    if (Send->PriorityLevels != Send->InlinePriorityLevels) {
+        CXPLAT_FREE(Send->PriorityLevels, QUIC_POOL_SEND_PRIORITY);
+    }
+    Send->PriorityLevels = NewLevels;
+    Send->PriorityLevelCapacity = NewCapacity;
+    return TRUE;
+}
+
+//
+// Inserts the stream into SendStreams after every stream of greater or equal
+// priority.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendInsertStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (!Send->PriorityLevelsInvalid) {
+        uint32_t Index;
+        if (QuicSendFindPriorityLevel(Send, Stream->SendPriority, &Index)) {
+            QUIC_SEND_PRIORITY_LEVEL* Level = &Send->PriorityLevels[Index];
+            CxPlatListInsertHead(Level->Last, &Stream->SendLink); // Insert after Last
+            Level->Last = &Stream->SendLink;
+            Level->StreamCount++;
+            return;
+        }
+
+        if (QuicSendGrowPriorityLevels(Send)) {
+            CXPLAT_LIST_ENTRY* Prev =
+                Index == 0 ?
+                    &Send->SendStreams : Send->PriorityLevels[Index - 1].Last;
+            CxPlatMoveMemory(
+                &Send->PriorityLevels[Index + 1],
+                &Send->PriorityLevels[Index],
+                (Send->PriorityLevelCount - Index) * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+            Send->PriorityLevelCount++;
+
+            QUIC_SEND_PRIORITY_LEVEL* Level = &Send->PriorityLevels[Index];
+            Level->Priority = Stream->SendPriority;
+            Level->StreamCount = 1;
+            Level->Last = &Stream->SendLink;
+            CxPlatListInsertHead(Prev, &Stream->SendLink); // Insert after Prev
+            return;
+        }
+
+        //
+        // Fall back to the linear search until the queue drains.
+        //
+        Send->PriorityLevelsInvalid = TRUE;
+    }
+
+    CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
+    while (Entry != &Send->SendStreams) {
+        //
+        // Search back to front for the right place (based on priority) to
+        // insert the stream.
+        //
+        if (Stream->SendPriority <=
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->SendPriority) {
+            break;
+        }
+        Entry = Entry->Blink;
+    }
+    CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+}
+
+//
+// Removes the stream, which was queued with Priority, from SendStreams.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRemoveStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint16_t Priority
+    )
+{
+    if (!Send->PriorityLevelsInvalid) {
+        uint32_t Index;
+        BOOLEAN Found = QuicSendFindPriorityLevel(Send, Priority, &Index);
+        CXPLAT_DBG_ASSERT(Found);
+        UNREFERENCED_PARAMETER(Found);
+
+        QUIC_SEND_PRIORITY_LEVEL* Level = &Send->PriorityLevels[Index];
+        if (Level->Last == &Stream->SendLink) {
+            Level->Last = Stream->SendLink.Blink;
+        }
+        if (--Level->StreamCount == 0) {
+            Send->PriorityLevelCount--;
+            CxPlatMoveMemory(
+                &Send->PriorityLevels[Index],
+                &Send->PriorityLevels[Index + 1],
+                (Send->PriorityLevelCount - Index) * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+        }
+    }
+
+    CxPlatListEntryRemove(&Stream->SendLink);
+
+    if (Send->PriorityLevelsInvalid && CxPlatListIsEmpty(&Send->SendStreams)) {
+        Send->PriorityLevelCount = 0;
+        Send->PriorityLevelsInvalid = FALSE;
+    }
+}
+
+//
+// Moves the stream after any other streams of the same priority.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendMoveStreamToPriorityTail(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (!Send->PriorityLevelsInvalid) {
+        uint32_t Index;
+        BOOLEAN Found = QuicSendFindPriorityLevel(Send, Stream->SendPriority, &Index);
+        CXPLAT_DBG_ASSERT(Found);
+        UNREFERENCED_PARAMETER(Found);
+
+        QUIC_SEND_PRIORITY_LEVEL* Level = &Send->PriorityLevels[Index];
+        if (Level->Last != &Stream->SendLink) {
+            CXPLAT_LIST_ENTRY* Last = Level->Last;
+            CxPlatListEntryRemove(&Stream->SendLink);
+            CxPlatListInsertHead(Last, &Stream->SendLink); // Insert after Last
+            Level->Last = &Stream->SendLink;
+        }
+        return;
+    }
+
+    //
+    // Start with the "next" entry in the list and keep going until the next
+    // entry's priority is less. Then move the stream before that entry.
+    //
+    CXPLAT_LIST_ENTRY* LastEntry = Stream->SendLink.Flink;
+    while (LastEntry != &Send->SendStreams) {
+        if (Stream->SendPriority >
+            CXPLAT_CONTAINING_RECORD(LastEntry, QUIC_STREAM, SendLink)->SendPriority) {
+            break;
+        }
+        LastEntry = LastEntry->Flink;
+    }
+    if (LastEntry->Blink != &Stream->SendLink) {
+        CxPlatListEntryRemove(&Stream->SendLink);
+        CxPlatListInsertTail(LastEntry, &Stream->SendLink);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendQueueFlushForStream(
@@ -166,19 +398,8 @@ QuicSendQueueFlushForStream(
         //
         // Not previously queued, so add the stream to the end of the queue.
         //
-        CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
-        while (Entry != &Send->SendStreams) {
-            //
-            // Search back to front for the right place (based on priority) to
-            // insert the stream.
-            //
-            if (Stream->SendPriority <=
-                CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->SendPriority) {
-                break;
-            }
-            Entry = Entry->Blink;
-        }
-        CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+        Stream->SendDeficit = 0;
+        QuicSendInsertStream(Send, Stream);
         QuicStreamAddRef(Stream, QUIC_STREAM_REF_SEND);
     }
 
@@ -204,25 +425,13 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendUpdateStreamPriority(
     _In_ QUIC_SEND* Send,
-    _In_ QUIC_STREAM* Stream
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint16_t OldPriority
     )
 {
     CXPLAT_DBG_ASSERT(Stream->SendLink.Flink != NULL);
-    CxPlatListEntryRemove(&Stream->SendLink);
-
-    CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
-    while (Entry != &Send->SendStreams) {
-        //
-        // Search back to front for the right place (based on priority) to
-        // insert the stream.
-        //
-        if (Stream->SendPriority <=
-            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->SendPriority) {
-            break;
-        }
-        Entry = Entry->Blink;
-    }
-    CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+    QuicSendRemoveStream(Send, Stream, OldPriority);
+    QuicSendInsertStream(Send, Stream);
 }
 
 #if DEBUG
@@ -288,6 +497,9 @@ QuicSendClear(
 
         QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
     }
+
+    Send->PriorityLevelCount = 0;
+    Send->PriorityLevelsInvalid = FALSE;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -332,6 +544,44 @@ QuicSendSetSendFlag(
     return CanSetFlag;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicSendSetSendFlagCoalesced(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t SendFlags
+    )
+{
+    QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+
+    CXPLAT_DBG_ASSERT(!(SendFlags & QUIC_CONN_SEND_FLAG_ACK));
+
+    if (!Connection->Settings->ControlFrameCoalescingEnabled ||
+        !Send->DelayedAckTimerActive ||
+        QuicConnIsClosed(Connection)) {
+        (void)QuicSendSetSendFlag(Send, SendFlags);
+        return FALSE;
+    }
+
+    //
+    // The delayed ACK timer is guaranteed to flush within MaxAckDelayMs, so
+    // just record the flag and let it ride along with the ACK.
+    //
+    if ((Send->SendFlags & SendFlags) != SendFlags) {
+        QuicTraceLogConnVerbose(
+            ScheduleSendFlags,
+            Connection,
+            "Adding send flags 0x%x (prev: 0x%x, new: 0x%x)",
+            SendFlags,
+            Send->SendFlags,
+            Send->SendFlags | SendFlags);
+        Send->SendFlags |= SendFlags;
+    }
+
+    QuicSendValidate(Send);
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicSendClearSendFlag(
@@ -375,6 +625,14 @@ QuicSendUpdateAckState(
         } else if (Send->DelayedAckTimerActive) {
             QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_ACK_DELAY);
             Send->DelayedAckTimerActive = FALSE;
+            if (Connection->Settings->ControlFrameCoalescingEnabled &&
+                (Send->SendFlags != 0 || !CxPlatListIsEmpty(&Send->SendStreams))) {
+                //
+                // Frames coalesced behind the delayed ACK no longer have a
+                // timer to carry them, so flush them now.
+                //
+                QuicSendQueueFlush(Send, REASON_CONNECTION_FLAGS);
+            }
         }
     }
 
@@ -472,7 +730,7 @@ QuicSendClearStreamSendFlag(
             //
             // Since there are no flags left, remove the stream from the queue.
             //
-            CxPlatListEntryRemove(&Stream->SendLink);
+            QuicSendRemoveStream(Send, Stream, Stream->SendPriority);
             Stream->SendLink.Flink = NULL;
             QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
         }
@@ -691,6 +949,7 @@ QuicSendWriteFrames(
                     Builder->Datagram->Buffer)) {
 
                 Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_MAX_DATA;
+                Send->MaxDataSent = Frame.MaximumData;
                 if (QuicPacketBuilderAddFrame(Builder, QUIC_FRAME_MAX_DATA, TRUE)) {
                     return TRUE;
                 }
@@ -714,6 +973,7 @@ QuicSendWriteFrames(
                     Builder->Datagram->Buffer)) {
 
                 Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_MAX_STREAMS_BIDI;
+                Connection->StreamCredit.MaxStreamsFramesSent++;
                 if (QuicPacketBuilderAddFrame(Builder, QUIC_FRAME_MAX_STREAMS, TRUE)) {
                     return TRUE;
                 }
@@ -783,6 +1043,7 @@ QuicSendWriteFrames(
                     Builder->Datagram->Buffer)) {
 
                 Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_MAX_STREAMS_UNI;
+                Connection->StreamCredit.MaxStreamsFramesSent++;
                 if (QuicPacketBuilderAddFrame(Builder, QUIC_FRAME_MAX_STREAMS_1, TRUE)) {
                     return TRUE;
                 }
@@ -934,6 +1195,19 @@ QuicSendWriteFrames(
             }
         }
 
+        if (Send->SendFlags & QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK) {
+
+            if (Builder->DatagramLength < AvailableBufferLength) {
+                Builder->Datagram->Buffer[Builder->DatagramLength++] = QUIC_FRAME_IMMEDIATE_ACK;
+                Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK;
+                if (QuicPacketBuilderAddFrame(Builder, QUIC_FRAME_IMMEDIATE_ACK, TRUE)) {
+                    return TRUE;
+                }
+            } else {
+                RanOutOfRoom = TRUE;
+            }
+        }
+
         if (Send->SendFlags & QUIC_CONN_SEND_FLAG_DATAGRAM) {
             RanOutOfRoom = QuicDatagramWriteFrame(&Connection->Datagram, Builder);
             if (Builder->Metadata->FrameCount == QUIC_MAX_FRAMES_PER_PACKET) {
@@ -1023,29 +1297,34 @@ QuicSendGetNextStream(
         //
         if (QuicSendCanSendStreamNow(Stream)) {
 
-            if (Connection->State.UseRoundRobinStreamScheduling) {
+            if (Connection->State.UseRoundRobinStreamScheduling ||
+                (Connection->State.UseExtensibleStreamScheduling &&
+                 Stream->Flags.SendIncremental)) {
                 //
-                // Move the stream after any streams of the same priority. Start
-                // with the "next" entry in the list and keep going until the
-                // next entry's priority is less. Then move the stream before
-                // that entry.
+                // Move the stream after any streams of the same priority. In
+                // the extensible scheme only incremental streams share; the
+                // non-incremental ones (queued ahead of them) are sent one at
+                // a time like FIFO.
                 //
-                CXPLAT_LIST_ENTRY* LastEntry = Stream->SendLink.Flink;
-                while (LastEntry != &Send->SendStreams) {
-                    if (Stream->SendPriority >
-                        CXPLAT_CONTAINING_RECORD(LastEntry, QUIC_STREAM, SendLink)->SendPriority) {
-                        break;
-                    }
-                    LastEntry = LastEntry->Flink;
-                }
-                if (LastEntry->Blink != &Stream->SendLink) {
-                    CxPlatListEntryRemove(&Stream->SendLink);
-                    CxPlatListInsertTail(LastEntry, &Stream->SendLink);
-                }
+                QuicSendMoveStreamToPriorityTail(Send, Stream);
 
                 *PacketCount = QUIC_STREAM_SEND_BATCH_COUNT;
 
-            } else { // FIFO prioritization scheme
+            } else if (Connection->State.UseWeightedStreamScheduling) {
+                //
+                // Deficit round robin: start a turn with the stream's quantum
+                // unless credit is left from a turn that ended early. The
+                // stream is sent until its credit is used up.
+                //
+                if (Stream->SendDeficit <= 0) {
+                    Stream->SendDeficit +=
+                        (int32_t)Stream->SendWeight * QUIC_STREAM_WEIGHT_QUANTUM;
+                }
+                QuicSendMoveStreamToPriorityTail(Send, Stream);
+
+                *PacketCount = UINT32_MAX;
+
+            } else { // FIFO prioritization scheme or non-incremental stream
                 *PacketCount = UINT32_MAX;
             }
 
@@ -1181,6 +1460,7 @@ QuicSendPathChallenges(
             UNREFERENCED_PARAMETER(Result);
 
             Path->SendChallenge = FALSE;
+            Path->ChallengeSentTime = CxPlatTimeUs64();
         }
 
         QuicPacketBuilderFinalize(&Builder, TRUE);
@@ -1189,6 +1469,75 @@ QuicSendPathChallenges(
 #pragma warning(pop)
 }
 
+//
+// Returns how long a paced connection should wait, in microseconds, for enough
+// send allowance to build up for its next chunk.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicSendGetPacingDelay(
+    _In_ QUIC_SEND* Send
+    )
+{
+    QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    const uint64_t PacingRate = // bytes per second
+        QuicCongestionControlGetPacingRate(&Connection->CongestionControl);
+    if (PacingRate == 0) {
+        return QUIC_SEND_PACING_INTERVAL;
+    }
+
+    uint64_t Delay =
+        S_TO_US((uint64_t)Connection->Paths[0].Mtu * QUIC_PACING_QUEUE_CHUNK_DATAGRAMS) /
+        PacingRate;
+    if (Delay < QUIC_PACING_QUEUE_SLOT_US) {
+        Delay = QUIC_PACING_QUEUE_SLOT_US;
+    } else if (Delay > QUIC_SEND_PACING_INTERVAL) {
+        Delay = QUIC_SEND_PACING_INTERVAL;
+    }
+    return Delay;
+}
+
+//
+// Schedules the connection to send again once the earliest stream send rate
+// limit holding back queued data allows it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendScheduleRateLimitedStreams(
+    _In_ QUIC_SEND* Send
+    )
+{
+    QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    const uint64_t TimeNow = CxPlatTimeUs64();
+
+    uint64_t Delay = UINT64_MAX;
+    for (CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Flink;
+            Entry != &Send->SendStreams;
+            Entry = Entry->Flink) {
+        QUIC_STREAM* Stream =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
+        const uint64_t StreamDelay =
+            QuicStreamSendGetRateLimitDelay(Stream, TimeNow);
+        if (StreamDelay != 0 && StreamDelay < Delay) {
+            Delay = StreamDelay;
+        }
+    }
+
+    if (Delay == UINT64_MAX) {
+        return;
+    }
+
+    //
+    // The streams' rate limits, not the network, are what keep the congestion
+    // window from being used.
+    //
+    Send->RateLimited = TRUE;
+    if (QuicCongestionControlCanSend(&Connection->CongestionControl)) {
+        QuicCongestionControlSetAppLimited(&Connection->CongestionControl);
+    }
+    QuicConnTimerSet(Connection, QUIC_CONN_TIMER_PACING, Delay);
+}
+
 typedef enum QUIC_SEND_RESULT {
 
     QUIC_SEND_COMPLETE,
@@ -1215,6 +1564,7 @@ QuicSendFlush(
     }
 
     QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_PACING);
+    QuicPacingQueueRemoveConnection(&Connection->Worker->PacingQueue, Connection);
     QuicConnRemoveOutFlowBlockedReason(
         Connection, QUIC_FLOW_BLOCKED_SCHEDULING | QUIC_FLOW_BLOCKED_PACING);
 
@@ -1232,16 +1582,32 @@ QuicSendFlush(
         Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_DPLPMTUD;
     }
 
+    if (Send->SendFlags & QUIC_CONN_SEND_FLAG_DATAGRAM) {
+        QuicDatagramExpire(&Connection->Datagram, TimeNow);
+    }
+
     if (Send->SendFlags == 0 && CxPlatListIsEmpty(&Send->SendStreams)) {
         return TRUE;
     }
 
+    if (Connection->Crypto.HandshakeOffloadPending &&
+        !(Send->SendFlags &
+            (QUIC_CONN_SEND_FLAG_CONNECTION_CLOSE | QUIC_CONN_SEND_FLAG_APPLICATION_CLOSE))) {
+        //
+        // The server's first flight is still being produced on a handshake
+        // thread. Hold the ACK of the client's Initial until then, so that it
+        // goes out coalesced with the whole flight in one batch instead of in
+        // its own datagram, which would also spend amplification budget.
+        //
+        return TRUE;
+    }
+
     //
     // Connection CID changes on idle state after an amount of time
     //
-    if (Connection->Settings.DestCidUpdateIdleTimeoutMs != 0 &&
+    if (Connection->Settings->DestCidUpdateIdleTimeoutMs != 0 &&
         Send->LastFlushTimeValid &&
-        CxPlatTimeDiff64(Send->LastFlushTime, TimeNow) >= MS_TO_US(Connection->Settings.DestCidUpdateIdleTimeoutMs)) {
+        CxPlatTimeDiff64(Send->LastFlushTime, TimeNow) >= MS_TO_US(Connection->Settings->DestCidUpdateIdleTimeoutMs)) {
         (void)QuicConnRetireCurrentDestCid(Connection, Path);
     }
 
@@ -1265,6 +1631,13 @@ QuicSendFlush(
     }
     _Analysis_assume_(Builder.Metadata != NULL);
 
+#ifndef QUIC_FUZZER // The fuzz hook needs the plaintext in the packet buffer.
+    CXPLAT_CRYPT_SEGMENT CryptSegments[QUIC_MAX_CRYPT_SEGMENTS];
+    if (Connection->Settings->EncryptFromSendBuffersEnabled) {
+        Builder.CryptSegments = CryptSegments;
+    }
+#endif
+
     if (Builder.Path->EcnValidationState == ECN_VALIDATION_CAPABLE) {
         Builder.EcnEctSet = TRUE;
     } else if (Builder.Path->EcnValidationState == ECN_VALIDATION_TESTING) {
@@ -1339,10 +1712,31 @@ QuicSendFlush(
                     //
                     QuicConnAddOutFlowBlockedReason(
                         Connection, QUIC_FLOW_BLOCKED_PACING);
-                    QuicConnTimerSet(
-                        Connection,
-                        QUIC_CONN_TIMER_PACING,
-                        QUIC_SEND_PACING_INTERVAL);
+                    const uint64_t RateLimitDelay =
+                        Send->RateLimited ?
+                            QuicSendRateLimitGetDelay(
+                                &Connection->SendRateLimit, TimeNow, Path->Mtu) : 0;
+                    if (RateLimitDelay > QUIC_SEND_PACING_INTERVAL) {
+                        //
+                        // The send rate limit holds off the next chunk for
+                        // longer than pacing ever would.
+                        //
+                        QuicConnTimerSet(
+                            Connection,
+                            QUIC_CONN_TIMER_PACING,
+                            RateLimitDelay);
+                    } else if (Connection->Worker->HighResPacing) {
+                        QuicPacingQueueInsertConnection(
+                            &Connection->Worker->PacingQueue,
+                            Connection,
+                            TimeNow,
+                            CXPLAT_MAX(QuicSendGetPacingDelay(Send), RateLimitDelay));
+                    } else {
+                        QuicConnTimerSet(
+                            Connection,
+                            QUIC_CONN_TIMER_PACING,
+                            QUIC_SEND_PACING_INTERVAL);
+                    }
                     Result = QUIC_SEND_DELAYED_PACING;
                 } else {
                     //
@@ -1367,6 +1761,17 @@ QuicSendFlush(
         BOOLEAN SendConnectionControlData =
             (SendFlags & ~(QUIC_CONN_SEND_FLAG_DPLPMTUD |
                             QUIC_CONN_SEND_FLAG_PATH_CHALLENGE)) != 0;
+        if (SendFlags == QUIC_CONN_SEND_FLAG_DATAGRAM &&
+            Builder.Metadata->FrameCount != 0 &&
+            (Stream != NULL ||
+             (Stream = QuicSendGetNextStream(Send, &StreamPacketCount)) != NULL)) {
+            //
+            // The datagrams already written to the current packet left the
+            // rest queued because they didn't fit, so fill the remaining
+            // space with stream data instead of sending the packet short.
+            //
+            SendConnectionControlData = FALSE;
+        }
         if (SendConnectionControlData) {
             CXPLAT_DBG_ASSERT(QuicSendCanSendFlagsNow(Send));
             if (!QuicPacketBuilderPrepareForControlFrames(
@@ -1424,12 +1829,13 @@ QuicSendFlush(
                 // If the stream no longer has anything to send, remove it from the
                 // list and release Send's reference on it.
                 //
-                CxPlatListEntryRemove(&Stream->SendLink);
+                QuicSendRemoveStream(Send, Stream, Stream->SendPriority);
                 Stream->SendLink.Flink = NULL;
                 QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
                 Stream = NULL;
 
             } else if ((WrotePacketFrames && --StreamPacketCount == 0) ||
+                (Connection->State.UseWeightedStreamScheduling && Stream->SendDeficit <= 0) ||
                 !QuicSendCanSendStreamNow(Stream)) {
                 //
                 // Try a new stream next loop iteration.
@@ -1489,6 +1895,10 @@ QuicSendFlush(
         "Flush complete flags=0x%x",
         Send->SendFlags);
 
+    if (Result == QUIC_SEND_COMPLETE && Send->StreamRateLimitsSet) {
+        QuicSendScheduleRateLimitedStreams(Send);
+    }
+
     if (Result == QUIC_SEND_INCOMPLETE) {
         //
         // The send is limited by the scheduling logic.
@@ -1500,25 +1910,6 @@ QuicSendFlush(
         // operation is queued to send the rest.
         //
         QuicSendQueueFlush(&Connection->Send, REASON_SCHEDULING);
-
-        if (Builder.TotalCountDatagrams + 1 > Connection->PeerPacketTolerance) {
-            //
-            // We're scheduling limited, so we should tell the peer to use our
-            // (max) batch size + 1 as the peer tolerance as a hint that they
-            // should expect more than a single batch before needing to send an
-            // acknowledgment back.
-            //
-            QuicConnUpdatePeerPacketTolerance(Connection, Builder.TotalCountDatagrams + 1);
-        }
-
-    } else if (Builder.TotalCountDatagrams > Connection->PeerPacketTolerance) {
-        //
-        // If we aren't scheduling limited, we should just use the current batch
-        // size as the packet tolerance for the peer to use for acknowledging
-        // packets.
-        //
-        // Temporarily disabled for now.
-        //QuicConnUpdatePeerPacketTolerance(Connection, Builder.TotalCountDatagrams);
     }
 
     //
@@ -1538,7 +1929,7 @@ QuicSendStartDelayedAckTimer(
 {
     QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
 
-    CXPLAT_DBG_ASSERT(Connection->Settings.MaxAckDelayMs != 0);
+    CXPLAT_DBG_ASSERT(Connection->MaxAckDelayMs != 0);
     if (!Send->DelayedAckTimerActive &&
         !(Send->SendFlags & QUIC_CONN_SEND_FLAG_ACK) &&
         !Connection->State.ClosedLocally &&
@@ -1548,11 +1939,11 @@ QuicSendStartDelayedAckTimer(
             StartAckDelayTimer,
             Connection,
             "Starting ACK_DELAY timer for %u ms",
-            Connection->Settings.MaxAckDelayMs);
+            Connection->MaxAckDelayMs);
         QuicConnTimerSet(
             Connection,
             QUIC_CONN_TIMER_ACK_DELAY,
-            MS_TO_US(Connection->Settings.MaxAckDelayMs)); // TODO - Use smaller timeout when handshake data is outstanding.
+            MS_TO_US(Connection->MaxAckDelayMs)); // TODO - Use smaller timeout when handshake data is outstanding.
         Send->DelayedAckTimerActive = TRUE;
     }
 }
@@ -121,6 +121,27 @@ QuicPacketTypeToEncryptLevelV2(
     }
 }
 
+//
+// Returns TRUE if the peer would use up the flow control credit it has left
+// within about one RTT, sending at the rate BytesDelivered were delivered over
+// the last ElapsedUs. A flow control update sent then reaches the peer before
+// it blocks.
+//
+QUIC_INLINE
+BOOLEAN
+QuicSendPeerCreditRunningOut(
+    _In_ uint64_t CreditLeft,
+    _In_ uint64_t BytesDelivered,
+    _In_ uint64_t ElapsedUs,
+    _In_ uint64_t SmoothedRtt
+    )
+{
+    if (ElapsedUs == 0) {
+        ElapsedUs = 1;
+    }
+    return CreditLeft <= BytesDelivered * SmoothedRtt / ElapsedUs;
+}
+
 //
 // Flags representing types of control messages that need to be sent out. Any
 // per-stream control messages are stored with the stream itself. The order
@@ -145,6 +166,7 @@ QuicPacketTypeToEncryptLevelV2(
 #define QUIC_CONN_SEND_FLAG_ACK_FREQUENCY           0x00008000U
 #define QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED    0x00010000U
 #define QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED     0x00020000U
+#define QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK           0x00040000U
 #define QUIC_CONN_SEND_FLAG_DPLPMTUD                0x80000000U
 
 //
@@ -174,6 +196,7 @@ QuicPacketTypeToEncryptLevelV2(
     QUIC_CONN_SEND_FLAG_PING | \
     QUIC_CONN_SEND_FLAG_DATAGRAM | \
     QUIC_CONN_SEND_FLAG_ACK_FREQUENCY | \
+    QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK | \
     QUIC_CONN_SEND_FLAG_DPLPMTUD | \
     QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED | \
     QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED \
@@ -234,6 +257,164 @@ QUIC_INLINE BOOLEAN HasStreamDataFrames(uint32_t Flags)
          QUIC_STREAM_SEND_FLAG_FIN);
 }
 
+//
+// One distinct priority level present in the send queue.
+//
+typedef struct QUIC_SEND_PRIORITY_LEVEL {
+
+    //
+    // The stream send priority shared by all streams in this level.
+    //
+    uint16_t Priority;
+
+    //
+    // The number of queued streams with this priority.
+    //
+    uint32_t StreamCount;
+
+    //
+    // The last queued stream (SendLink) with this priority.
+    //
+    CXPLAT_LIST_ENTRY* Last;
+
+} QUIC_SEND_PRIORITY_LEVEL;
+
+//
+// This structure is a token bucket limiting the rate data is sent at, for a
+// stream or connection.
+//
+typedef struct QUIC_SEND_RATE_LIMIT {
+
+    //
+    // The configured rate, in bytes per second. Zero means unlimited.
+    //
+    uint64_t Rate;
+
+    //
+    // The bytes that may be sent right now, as of LastRefillTime. Goes
+    // negative when more was sent than was available, which the refill pays
+    // back first.
+    //
+    int64_t Tokens;
+
+    //
+    // The time (in us) Tokens was last refilled.
+    //
+    uint64_t LastRefillTime;
+
+} QUIC_SEND_RATE_LIMIT;
+
+QUIC_INLINE
+int64_t
+QuicSendRateLimitGetBurst(
+    _In_ const QUIC_SEND_RATE_LIMIT* Limit
+    )
+{
+    const uint64_t Burst = Limit->Rate * QUIC_SEND_RATE_LIMIT_BURST_US / S_TO_US(1);
+    return (int64_t)CXPLAT_MAX(Burst, QUIC_SEND_RATE_LIMIT_MIN_BURST);
+}
+
+//
+// Returns the tokens the bucket holds at time Now, without updating it.
+//
+QUIC_INLINE
+int64_t
+QuicSendRateLimitGetTokens(
+    _In_ const QUIC_SEND_RATE_LIMIT* Limit,
+    _In_ uint64_t Now
+    )
+{
+    uint64_t Elapsed =
+        CxPlatTimeAtOrBefore64(Now, Limit->LastRefillTime) ?
+            0 : CxPlatTimeDiff64(Limit->LastRefillTime, Now);
+    if (Elapsed > QUIC_SEND_RATE_LIMIT_MAX_REFILL_US) {
+        Elapsed = QUIC_SEND_RATE_LIMIT_MAX_REFILL_US;
+    }
+    const int64_t Tokens =
+        Limit->Tokens + (int64_t)(Elapsed * Limit->Rate / S_TO_US(1));
+    const int64_t Burst = QuicSendRateLimitGetBurst(Limit);
+    return Tokens > Burst ? Burst : Tokens;
+}
+
+//
+// Returns the number of bytes that may be sent at time Now.
+//
+QUIC_INLINE
+uint64_t
+QuicSendRateLimitGetAvailable(
+    _In_ const QUIC_SEND_RATE_LIMIT* Limit,
+    _In_ uint64_t Now
+    )
+{
+    if (Limit->Rate == 0) {
+        return UINT64_MAX;
+    }
+    const int64_t Tokens = QuicSendRateLimitGetTokens(Limit, Now);
+    return Tokens > 0 ? (uint64_t)Tokens : 0;
+}
+
+//
+// Charges Bytes sent at time Now against the bucket.
+//
+QUIC_INLINE
+void
+QuicSendRateLimitConsume(
+    _Inout_ QUIC_SEND_RATE_LIMIT* Limit,
+    _In_ uint64_t Now,
+    _In_ uint64_t Bytes
+    )
+{
+    if (Limit->Rate != 0) {
+        Limit->Tokens = QuicSendRateLimitGetTokens(Limit, Now) - (int64_t)Bytes;
+        if (!CxPlatTimeAtOrBefore64(Now, Limit->LastRefillTime)) {
+            Limit->LastRefillTime = Now;
+        }
+    }
+}
+
+//
+// Returns how long, in microseconds, until Bytes may be sent.
+//
+QUIC_INLINE
+uint64_t
+QuicSendRateLimitGetDelay(
+    _In_ const QUIC_SEND_RATE_LIMIT* Limit,
+    _In_ uint64_t Now,
+    _In_ uint64_t Bytes
+    )
+{
+    if (Limit->Rate == 0) {
+        return 0;
+    }
+    const int64_t Tokens = QuicSendRateLimitGetTokens(Limit, Now);
+    if (Tokens >= (int64_t)Bytes) {
+        return 0;
+    }
+    const uint64_t Needed = (uint64_t)((int64_t)Bytes - Tokens);
+    return (S_TO_US(Needed) + Limit->Rate - 1) / Limit->Rate;
+}
+
+//
+// Changes the rate of the bucket, which starts out full.
+//
+QUIC_INLINE
+void
+QuicSendRateLimitSet(
+    _Inout_ QUIC_SEND_RATE_LIMIT* Limit,
+    _In_ uint64_t Rate,
+    _In_ uint64_t Now
+    )
+{
+    Limit->Rate = Rate;
+    Limit->Tokens = QuicSendRateLimitGetBurst(Limit);
+    Limit->LastRefillTime = Now;
+}
+
+//
+// The number of priority levels tracked without a separate allocation.
+//
+#define QUIC_SEND_PRIORITY_LEVELS_INLINE 4
+
 typedef struct QUIC_SEND {
 
     //
@@ -262,6 +443,24 @@ typedef struct QUIC_SEND {
     //
     BOOLEAN Uninitialized : 1;
 
+    //
+    // Indicates PriorityLevels failed to grow and no longer reflects
+    // SendStreams. Reset once SendStreams drains.
+    //
+    BOOLEAN PriorityLevelsInvalid : 1;
+
+    //
+    // Indicates the last flush stopped because of a send rate limit, rather
+    // than congestion control, so the connection is application limited.
+    //
+    BOOLEAN RateLimited : 1;
+
+    //
+    // Indicates a send rate limit has been set on at least one stream, so
+    // rate limited streams must be scheduled to be woken up.
+    //
+    BOOLEAN StreamRateLimitsSet : 1;
+
     //
     // The next packet number to use.
     //
@@ -283,17 +482,36 @@ typedef struct QUIC_SEND {
     //
     uint64_t LastFlushTime;
 
+    //
+    // The departure time given to the next batch sent, when the kernel paces
+    // sends (SO_TXTIME).
+    //
+    uint64_t NextTxTime;
+
     //
     // The total number of packets sent with each corresponding ECT codepoint in all encryption
     // level.
     //
     uint64_t NumPacketsSentWithEct;
 
+    //
+    // How many of them were sent with ECT(1). Other than ECN validation (and
+    // other) probes, all packets are marked with the codepoint chosen by the
+    // congestion control algorithm.
+    //
+    uint64_t NumPacketsSentWithEct1;
+
     //
     // The value we send in MAX_DATA frames.
     //
     uint64_t MaxData;
 
+    //
+    // The MaxData value last sent to the peer, i.e. the limit the peer is
+    // currently working against.
+    //
+    uint64_t MaxDataSent;
+
     //
     // The max value received in MAX_DATA frames.
     //
@@ -313,11 +531,29 @@ typedef struct QUIC_SEND {
 
     //
     // An accumulator for in-order delivered bytes across all streams. When this
-    // reaches ConnFlowControlWindow / QUIC_RECV_BUFFER_DRAIN_RATIO, the accumulator
-    // is reset and a MAX_DATA frame is sent.
+    // reaches RecvWindow / QUIC_RECV_BUFFER_DRAIN_RATIO, the accumulator is
+    // reset and a MAX_DATA frame is sent.
     //
     uint64_t OrderedStreamBytesDeliveredAccumulator;
 
+    //
+    // The time (in us) the accumulator was last reset.
+    //
+    uint64_t RecvWindowLastUpdate;
+
+    //
+    // The current connection flow control window. Starts at the
+    // ConnFlowControlWindow setting and may be grown by autotuning, up to
+    // ConnFlowControlWindowMax.
+    //
+    uint32_t RecvWindow;
+
+    //
+    // How much RecvWindow has been grown by autotuning. This is charged against
+    // the library wide autotuning memory budget.
+    //
+    uint32_t RecvWindowGrowth;
+
     //
     // Set of flags indicating what data is ready to be sent out.
     //
@@ -329,7 +565,18 @@ typedef struct QUIC_SEND {
     CXPLAT_LIST_ENTRY SendStreams;
 
     //
-    // The current token to send with an Initial packet.
+    // Index of the distinct priorities in SendStreams, sorted from highest to
+    // lowest, used to find a stream's insertion point without walking the
+    // list.
+    //
+    QUIC_SEND_PRIORITY_LEVEL* PriorityLevels;
+    uint32_t PriorityLevelCount;
+    uint32_t PriorityLevelCapacity;
+    QUIC_SEND_PRIORITY_LEVEL InlinePriorityLevels[QUIC_SEND_PRIORITY_LEVELS_INLINE];
+
+    //
+    // The current token to send with an Initial packet. Allocated from the
+    // connection's handshake arena.
     //
     const uint8_t* InitialToken;
 
@@ -348,6 +595,22 @@ typedef struct QUIC_FLOW_BLOCKED_TIMING_TRACKER {
     uint64_t LastStartTimeUs;
 } QUIC_FLOW_BLOCKED_TIMING_TRACKER;
 
+//
+// Returns the cumulative blocked time, including the current blocked period.
+//
+QUIC_INLINE
+uint64_t
+QuicFlowBlockedTimingGet(
+    _In_ const QUIC_FLOW_BLOCKED_TIMING_TRACKER* Tracker,
+    _In_ uint64_t Now
+    )
+{
+    return
+        Tracker->CumulativeTimeUs +
+        (Tracker->LastStartTimeUs != 0 ?
+            CxPlatTimeDiff64(Tracker->LastStartTimeUs, Now) : 0);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendInitialize(
@@ -429,7 +692,8 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendUpdateStreamPriority(
     _In_ QUIC_SEND* Send,
-    _In_ QUIC_STREAM* Stream
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint16_t OldPriority
     );
 
 //
@@ -480,6 +744,18 @@ QuicSendSetSendFlag(
     _In_ uint32_t SendFlag
     );
 
+//
+// Like QuicSendSetSendFlag, but if control frame coalescing is enabled and a
+// delayed ACK is pending, the flag is only recorded and goes out with the ACK
+// (or any earlier flush). Returns TRUE if the flush was deferred.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicSendSetSendFlagCoalesced(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t SendFlag
+    );
+
 //
 // Clears the given QUIC_CONN_SEND_FLAG_*.
 //
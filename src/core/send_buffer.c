@@ -15,7 +15,9 @@ Abstract:
     bytes it should keep posted.
 
     We copy requests into fixed-sized blocks when possible, and fall back on
-    CXPLAT_ALLOC for large send requests.
+    CXPLAT_ALLOC for large send requests. The blocks come from the partition's
+    SendBufferPools, one per power-of-two size class, so apps sending many
+    small messages don't pay for a general allocation per request.
 
     We buffer send requests until we've buffered AT LEAST the desired number
     of bytes, rather than using the ideal buffer size as a hard limit. This
@@ -66,6 +68,7 @@ QuicSendBufferInitialize(
     )
 {
     SendBuffer->IdealBytes = QUIC_DEFAULT_IDEAL_SEND_BUFFER_SIZE;
+    SendBuffer->EstimatedBytes = 0;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -77,18 +80,44 @@ QuicSendBufferUninitialize(
     UNREFERENCED_PARAMETER(SendBuffer);
 }
 
+//
+// Returns the index of the smallest pooled size class that fits Size, or
+// QUIC_SEND_BUFFER_POOL_CLASS_COUNT if Size is too large to be pooled.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint32_t
+QuicSendBufferPoolClass(
+    _In_ uint32_t Size
+    )
+{
+    uint32_t Class = 0;
+    uint32_t ClassSize = QUIC_SEND_BUFFER_POOL_MIN_SIZE;
+    while (Class < QUIC_SEND_BUFFER_POOL_CLASS_COUNT && ClassSize < Size) {
+        ++Class;
+        ClassSize <<= 1;
+    }
+    return Class;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != NULL)
 uint8_t*
 QuicSendBufferAlloc(
     _Inout_ QUIC_SEND_BUFFER* SendBuffer,
+    _In_ QUIC_PARTITION* Partition,
     _In_ uint32_t Size
     )
 {
-    uint8_t* Buf = (uint8_t*)CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_SENDBUF);
+    const uint32_t Class = QuicSendBufferPoolClass(Size);
+    uint8_t* Buf =
+        Class < QUIC_SEND_BUFFER_POOL_CLASS_COUNT ?
+            (uint8_t*)CxPlatPoolAlloc(&Partition->SendBufferPools[Class]) :
+            (uint8_t*)CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_SENDBUF);
 
     if (Buf != NULL) {
         SendBuffer->BufferedBytes += Size;
+        QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, Size);
     } else {
         QuicTraceEvent(
             AllocFailure,
@@ -108,8 +137,17 @@ QuicSendBufferFree(
     _In_ uint32_t Size
     )
 {
-    CXPLAT_FREE(Buf, QUIC_POOL_SENDBUF);
+    //
+    // Pooled blocks remember their pool, so this is safe even if the
+    // connection has moved to another partition since the allocation.
+    //
+    if (QuicSendBufferPoolClass(Size) < QUIC_SEND_BUFFER_POOL_CLASS_COUNT) {
+        CxPlatPoolFree(Buf);
+    } else {
+        CXPLAT_FREE(Buf, QUIC_POOL_SENDBUF);
+    }
     SendBuffer->BufferedBytes -= Size;
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, -(int64_t)Size);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -146,7 +184,17 @@ QuicSendBufferFill(
     QUIC_SEND_REQUEST* Req;
     CXPLAT_LIST_ENTRY* Entry;
 
-    CXPLAT_DBG_ASSERT(Connection->Settings.SendBufferingEnabled);
+    CXPLAT_DBG_ASSERT(Connection->Settings->SendBufferingEnabled);
+
+    if (Connection->State.InlineApiExecution) {
+        //
+        // Buffering a request completes it, and the app must not be reentered
+        // from its own API call, so wait for it to return.
+        //
+        Connection->SendBuffer.FillDeferred = TRUE;
+        return;
+    }
+    Connection->SendBuffer.FillDeferred = FALSE;
 
     Entry = Connection->Send.SendStreams.Flink;
     while (QuicSendBufferHasSpace(&Connection->SendBuffer) && Entry != &(Connection->Send.SendStreams)) {
@@ -178,6 +226,13 @@ QuicSendBufferFill(
         // Buffer as many requests as we can before moving to the next stream.
         //
         while (Req != NULL && QuicSendBufferHasSpace(&Connection->SendBuffer)) {
+            if (Req->Flags & QUIC_SEND_FLAG_FROM_FILE) {
+                //
+                // File backed requests are read as they are framed and never
+                // buffered, so the requests after one wait for it to complete.
+                //
+                break;
+            }
             if (QUIC_FAILED(QuicStreamSendBufferRequest(Stream, Req))) {
                 return;
             }
@@ -187,6 +242,18 @@ QuicSendBufferFill(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendBufferFillDeferred(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->SendBuffer.FillDeferred &&
+        Connection->Settings->SendBufferingEnabled) {
+        QuicSendBufferFill(Connection);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 uint32_t
 QuicGetNextIdealBytes(
@@ -246,26 +313,94 @@ QuicSendBufferStreamAdjust(
     }
 }
 
+//
+// Feeds the current delivery rate into the smoothed bandwidth-delay estimate
+// and returns the new IdealBytes if the estimate has moved far enough from the
+// current value, or zero if no delivery rate is available.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicSendBufferGetRateIdealBytes(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    uint64_t DeliveryRate =
+        QuicCongestionControlGetDeliveryRate(&Connection->CongestionControl);
+    if (DeliveryRate == 0) {
+        //
+        // The algorithm doesn't measure a delivery rate, so use the rate
+        // sampled by loss detection instead.
+        //
+        DeliveryRate = Connection->LossDetection.DeliveryRate / QUIC_DELIVERY_RATE_UNIT;
+    }
+    if (DeliveryRate == 0 || !Path->GotFirstRttSample) {
+        return 0;
+    }
+
+    QUIC_SEND_BUFFER* SendBuffer = &Connection->SendBuffer;
+    const uint64_t Bdp = DeliveryRate * Path->SmoothedRtt / S_TO_US(1);
+    const uint64_t Target = Bdp + Bdp * MsQuicLib.IdealSendBufferHeadroom / 100;
+
+    if (SendBuffer->EstimatedBytes == 0) {
+        SendBuffer->EstimatedBytes = Target;
+    } else {
+        SendBuffer->EstimatedBytes =
+            (SendBuffer->EstimatedBytes * (QUIC_IDEAL_SEND_BUFFER_SMOOTHING - 1) + Target) /
+            QUIC_IDEAL_SEND_BUFFER_SMOOTHING;
+    }
+
+    uint64_t Estimate = SendBuffer->EstimatedBytes;
+    if (Estimate < QUIC_DEFAULT_IDEAL_SEND_BUFFER_SIZE) {
+        Estimate = QUIC_DEFAULT_IDEAL_SEND_BUFFER_SIZE;
+    } else if (Estimate > QUIC_MAX_IDEAL_SEND_BUFFER_SIZE) {
+        Estimate = QUIC_MAX_IDEAL_SEND_BUFFER_SIZE;
+    }
+
+    //
+    // Only move IdealBytes once the estimate leaves a band around it, so
+    // normal delivery rate noise doesn't keep indicating new sizes to the app.
+    //
+    const uint64_t IdealBytes = SendBuffer->IdealBytes;
+    if (Estimate > IdealBytes + IdealBytes / QUIC_IDEAL_SEND_BUFFER_GROW_HYSTERESIS ||
+        Estimate < IdealBytes - IdealBytes / QUIC_IDEAL_SEND_BUFFER_SHRINK_HYSTERESIS) {
+        return Estimate;
+    }
+    return IdealBytes;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendBufferConnectionAdjust(
     _In_ QUIC_CONNECTION* Connection
     )
 {
-    if (Connection->SendBuffer.IdealBytes == QUIC_MAX_IDEAL_SEND_BUFFER_SIZE ||
-        Connection->Streams.StreamTable == NULL) {
+    if (Connection->Streams.StreamTable == NULL) {
         return; // Nothing to do.
     }
 
-    const uint64_t NewIdealBytes =
-        QuicGetNextIdealBytes(
-            QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl));
+    uint64_t NewIdealBytes = 0;
+    if (MsQuicLib.IdealSendBufferHeadroom != 0) {
+        NewIdealBytes = QuicSendBufferGetRateIdealBytes(Connection);
+    }
 
-    //
-    // TODO: Currently, IdealBytes only grows and never shrinks. Add appropriate
-    // shrinking logic.
-    //
-    if (NewIdealBytes > Connection->SendBuffer.IdealBytes) {
+    if (NewIdealBytes == 0) {
+        //
+        // No delivery rate, so step up from the largest bytes in flight seen.
+        // This only ever grows IdealBytes.
+        //
+        if (Connection->SendBuffer.IdealBytes == QUIC_MAX_IDEAL_SEND_BUFFER_SIZE) {
+            return;
+        }
+        NewIdealBytes =
+            QuicGetNextIdealBytes(
+                QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl));
+        if (NewIdealBytes < Connection->SendBuffer.IdealBytes) {
+            return;
+        }
+    }
+
+    if (NewIdealBytes != Connection->SendBuffer.IdealBytes) {
         Connection->SendBuffer.IdealBytes = NewIdealBytes;
 
         CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
@@ -279,7 +414,7 @@ QuicSendBufferConnectionAdjust(
         }
         CxPlatHashtableEnumerateEnd(Connection->Streams.StreamTable, &Enumerator);
 
-        if (Connection->Settings.SendBufferingEnabled) {
+        if (Connection->Settings->SendBufferingEnabled) {
             QuicSendBufferFill(Connection);
         }
     }
@@ -27,6 +27,20 @@ typedef struct QUIC_SEND_BUFFER {
     //
     uint64_t IdealBytes;
 
+    //
+    // The smoothed bandwidth-delay estimate (plus headroom) IdealBytes follows
+    // when the congestion controller measures a delivery rate. Zero until the
+    // first sample.
+    //
+    uint64_t EstimatedBytes;
+
+    //
+    // A fill was requested by an API call executing inline on the worker, and
+    // deferred until the call returns so the app isn't reentered with send
+    // completions.
+    //
+    BOOLEAN FillDeferred;
+
 } QUIC_SEND_BUFFER;
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -46,6 +60,7 @@ _Success_(return != NULL)
 uint8_t*
 QuicSendBufferAlloc(
     _Inout_ QUIC_SEND_BUFFER* SendBuffer,
+    _In_ QUIC_PARTITION* Partition,
     _In_ uint32_t Size
     );
 
@@ -70,6 +85,16 @@ QuicSendBufferFill(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Runs any fill deferred from an inline API call. Called by the worker once
+// it's no longer executing on behalf of the app.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendBufferFillDeferred(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Indicates an ISB update to the stream.
 //
@@ -80,7 +105,7 @@ QuicSendBufferStreamAdjust(
     );
 
 //
-// Updates IdealBytes upon change of BytesInFlightMax.
+// Updates IdealBytes upon change of BytesInFlightMax or the delivery rate.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -14,6 +14,11 @@ Abstract:
     contained in the packet. The allocator uses a different pool for each
     possible size.
 
+    Connections may also have a sent packet ring (see QuicSentPacketRing*),
+    which hands out fixed size slots from one contiguous allocation in send
+    order. Metadata that doesn't fit in, or can't get, a ring slot comes from
+    the pools. Returning metadata checks which of the two it came from.
+
 --*/
 
 #include "precomp.h"
@@ -108,11 +113,14 @@ QuicSentPacketPoolGetPacketMetadata(
 {
     QUIC_SENT_PACKET_METADATA* Metadata =
         CxPlatPoolAlloc(Pool->Pools + FrameCount - 1);
-#if DEBUG
     if (Metadata != NULL) {
+#if DEBUG
         Metadata->Flags.Freed = FALSE;
-    }
 #endif
+        QuicLibraryTrackMemory(
+            QUIC_MEMORY_TYPE_SENT_PACKET_METADATA,
+            SIZEOF_QUIC_SENT_PACKET_METADATA(FrameCount));
+    }
     return Metadata;
 }
 
@@ -132,5 +140,113 @@ QuicSentPacketPoolReturnPacketMetadata(
 #endif
 
     QuicSentPacketMetadataReleaseFrames(Metadata, Connection);
-    CxPlatPoolFree(Metadata);
+    if (!QuicSentPacketRingReturnPacketMetadata(
+            &Connection->LossDetection.SentPacketRing, Metadata)) {
+        QuicLibraryTrackMemory(
+            QUIC_MEMORY_TYPE_SENT_PACKET_METADATA,
+            -(int64_t)SIZEOF_QUIC_SENT_PACKET_METADATA(Metadata->FrameCount));
+        CxPlatPoolFree(Metadata);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicSentPacketRingInitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint32_t SlotCount
+    )
+{
+    CXPLAT_DBG_ASSERT(Ring->Slots == NULL);
+    CXPLAT_DBG_ASSERT(SlotCount != 0 && (SlotCount & (SlotCount - 1)) == 0);
+
+    const size_t AllocSize = QUIC_SENT_PACKET_RING_ALLOC_SIZE(SlotCount);
+    Ring->Slots = CXPLAT_ALLOC_NONPAGED(AllocSize, QUIC_POOL_META);
+    if (Ring->Slots == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "sent packet ring",
+            AllocSize);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    Ring->SlotInUse =
+        (BOOLEAN*)(Ring->Slots + (size_t)SlotCount * QUIC_SENT_PACKET_RING_SLOT_SIZE);
+    CxPlatZeroMemory(Ring->SlotInUse, SlotCount * sizeof(BOOLEAN));
+    Ring->SlotCount = SlotCount;
+    Ring->Head = 0;
+    Ring->Tail = 0;
+
+    QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_SENT_PACKET_METADATA, (int64_t)AllocSize);
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketRingUninitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    if (Ring->Slots != NULL) {
+        CXPLAT_TEL_ASSERT(Ring->Head == Ring->Tail);
+        QuicLibraryTrackMemory(
+            QUIC_MEMORY_TYPE_SENT_PACKET_METADATA,
+            -(int64_t)QUIC_SENT_PACKET_RING_ALLOC_SIZE(Ring->SlotCount));
+        CXPLAT_FREE(Ring->Slots, QUIC_POOL_META);
+        Ring->Slots = NULL;
+        Ring->SlotInUse = NULL;
+        Ring->SlotCount = 0;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingGetPacketMetadata(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint8_t FrameCount
+    )
+{
+    if (Ring->Slots == NULL ||
+        FrameCount > QUIC_SENT_PACKET_RING_SLOT_FRAMES ||
+        Ring->Tail - Ring->Head == Ring->SlotCount) {
+        return NULL;
+    }
+
+    const uint32_t Index = Ring->Tail++ & (Ring->SlotCount - 1);
+    Ring->SlotInUse[Index] = TRUE;
+
+    QUIC_SENT_PACKET_METADATA* Metadata =
+        (QUIC_SENT_PACKET_METADATA*)(Ring->Slots + (size_t)Index * QUIC_SENT_PACKET_RING_SLOT_SIZE);
+#if DEBUG
+    Metadata->Flags.Freed = FALSE;
+#endif
+    return Metadata;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicSentPacketRingReturnPacketMetadata(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Metadata
+    )
+{
+    if (!QuicSentPacketRingContains(Ring, Metadata)) {
+        return FALSE;
+    }
+
+    const uint8_t* Address = (const uint8_t*)Metadata;
+    const uint32_t Index =
+        (uint32_t)((size_t)(Address - Ring->Slots) / QUIC_SENT_PACKET_RING_SLOT_SIZE);
+    CXPLAT_DBG_ASSERT(Ring->SlotInUse[Index]);
+    Ring->SlotInUse[Index] = FALSE;
+
+    //
+    // Reclaim the run of returned slots at the head of the ring.
+    //
+    while (Ring->Head != Ring->Tail &&
+           !Ring->SlotInUse[Ring->Head & (Ring->SlotCount - 1)]) {
+        Ring->Head++;
+    }
+
+    return TRUE;
 }
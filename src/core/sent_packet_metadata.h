@@ -5,6 +5,10 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 //
 // The maximum number of frames we will write to a single packet.
 //
@@ -94,6 +98,7 @@ typedef struct QUIC_SEND_PACKET_FLAGS {
     BOOLEAN IsAppLimited            : 1;
     BOOLEAN HasLastAckedPacketInfo  : 1;
     BOOLEAN EcnEctSet               : 1;
+    BOOLEAN EcnEct1                 : 1;
 #if DEBUG
     BOOLEAN Freed                   : 1;
 #endif
@@ -243,3 +248,109 @@ QuicSentPacketPoolReturnPacketMetadata(
     _In_ QUIC_SENT_PACKET_METADATA* Metadata,
     _In_ QUIC_CONNECTION* Connection
     );
+
+//
+// The number of frames a slot in a sent packet ring can hold. Packets with
+// more frames than this are allocated from the pool instead.
+//
+#define QUIC_SENT_PACKET_RING_SLOT_FRAMES 4
+
+#define QUIC_SENT_PACKET_RING_SLOT_SIZE \
+    SIZEOF_QUIC_SENT_PACKET_METADATA(QUIC_SENT_PACKET_RING_SLOT_FRAMES)
+
+//
+// The size of the allocation for a ring of SlotCount slots.
+//
+#define QUIC_SENT_PACKET_RING_ALLOC_SIZE(SlotCount) \
+    ((size_t)(SlotCount) * (QUIC_SENT_PACKET_RING_SLOT_SIZE + sizeof(BOOLEAN)))
+
+//
+// A contiguous, per-connection ring of sent packet metadata. Slots are handed
+// out in the order packets are sent, so the loss detection lists mostly link
+// neighboring slots. Returned slots are only reclaimed once all older slots
+// have been returned too, which frees a whole run of slots at once when an
+// ACK covers them. If the oldest slot is still in use when the ring wraps, new
+// packets are allocated from the pool until it's returned.
+//
+typedef struct QUIC_SENT_PACKET_RING {
+
+    //
+    // SlotCount slots of QUIC_SENT_PACKET_RING_SLOT_SIZE bytes, followed by
+    // an in-use flag for each slot. NULL if the ring isn't allocated.
+    //
+    uint8_t* Slots;
+    BOOLEAN* SlotInUse;
+
+    //
+    // The number of slots; always a power of two.
+    //
+    uint32_t SlotCount;
+
+    //
+    // The (free running) indexes of the oldest slot still in use and of the
+    // next slot to hand out.
+    //
+    uint32_t Head;
+    uint32_t Tail;
+
+} QUIC_SENT_PACKET_RING;
+
+//
+// Returns TRUE if the metadata was allocated from the ring.
+//
+QUIC_INLINE
+BOOLEAN
+QuicSentPacketRingContains(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ const QUIC_SENT_PACKET_METADATA* Metadata
+    )
+{
+    const uint8_t* Address = (const uint8_t*)Metadata;
+    return
+        Ring->Slots != NULL &&
+        Address >= Ring->Slots &&
+        Address < (const uint8_t*)Ring->SlotInUse;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicSentPacketRingInitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint32_t SlotCount
+    );
+
+//
+// Frees the ring's memory. All slots must have been returned.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketRingUninitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    );
+
+//
+// Allocates a sent packet metadata item from the next slot of the ring.
+// Returns NULL if the ring isn't allocated, is full or the packet has too
+// many frames.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingGetPacketMetadata(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint8_t FrameCount
+    );
+
+//
+// Returns the metadata's slot to the ring. Returns FALSE if the metadata
+// wasn't allocated from the ring.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicSentPacketRingReturnPacketMetadata(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Metadata
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -111,6 +111,18 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.ConnFlowControlWindow) {
         Settings->ConnFlowControlWindow = QUIC_DEFAULT_CONN_FLOW_CONTROL_WINDOW;
     }
+    if (!Settings->IsSet.ConnFlowControlWindowMax) {
+        Settings->ConnFlowControlWindowMax = QUIC_DEFAULT_CONN_FLOW_CONTROL_WINDOW_MAX;
+    }
+    if (!Settings->IsSet.HibernateTimeoutMs) {
+        Settings->HibernateTimeoutMs = QUIC_DEFAULT_HIBERNATE_TIMEOUT_MS;
+    }
+    if (!Settings->IsSet.PeerStreamCountMax) {
+        Settings->PeerStreamCountMax = QUIC_DEFAULT_PEER_STREAM_COUNT_MAX;
+    }
+    if (!Settings->IsSet.SpinBitDisableRate) {
+        Settings->SpinBitDisableRate = QUIC_DEFAULT_SPIN_BIT_DISABLE_RATE;
+    }
     if (!Settings->IsSet.MaxBytesPerKey) {
         Settings->MaxBytesPerKey = QUIC_DEFAULT_MAX_BYTES_PER_KEY;
     }
@@ -165,6 +177,9 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.QTIPEnabled) {
         Settings->QTIPEnabled = QUIC_DEFAULT_QTIP_ENABLED;
     }
+    if (!Settings->IsSet.RioEnabled) {
+        Settings->RioEnabled = QUIC_DEFAULT_RIO_ENABLED;
+    }
     if (!Settings->IsSet.OneWayDelayEnabled) {
         Settings->OneWayDelayEnabled = QUIC_DEFAULT_ONE_WAY_DELAY_ENABLED;
     }
@@ -174,6 +189,127 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.StreamMultiReceiveEnabled) {
         Settings->StreamMultiReceiveEnabled = QUIC_DEFAULT_STREAM_MULTI_RECEIVE_ENABLED;
     }
+    if (!Settings->IsSet.ControlFrameCoalescingEnabled) {
+        Settings->ControlFrameCoalescingEnabled = QUIC_DEFAULT_CONTROL_FRAME_COALESCING_ENABLED;
+    }
+    if (!Settings->IsSet.EncryptFromSendBuffersEnabled) {
+        Settings->EncryptFromSendBuffersEnabled = QUIC_DEFAULT_ENCRYPT_FROM_SEND_BUFFERS_ENABLED;
+    }
+    if (!Settings->IsSet.CarefulResumeEnabled) {
+        Settings->CarefulResumeEnabled = QUIC_DEFAULT_CAREFUL_RESUME_ENABLED;
+    }
+    if (!Settings->IsSet.StreamBatchReceiveEnabled) {
+        Settings->StreamBatchReceiveEnabled = QUIC_DEFAULT_STREAM_BATCH_RECEIVE_ENABLED;
+    }
+}
+
+#define SETTING_FIELD(Field, Flags, Min, Max) \
+    { (uint16_t)offsetof(QUIC_SETTINGS_INTERNAL, Field), (uint8_t)CXPLAT_FIELD_SIZE(QUIC_SETTINGS_INTERNAL, Field), Flags, Min, Max }
+
+#define SETTING_FIELD_ANY(Field) SETTING_FIELD(Field, 0, 0, UINT64_MAX)
+
+const QUIC_SETTING_FIELD QuicSettingFields[QUIC_SETTINGS_COUNT] = {
+    SETTING_FIELD(MaxBytesPerKey, 0, 0, QUIC_DEFAULT_MAX_BYTES_PER_KEY),
+    SETTING_FIELD(HandshakeIdleTimeoutMs, 0, 0, QUIC_VAR_INT_MAX),
+    SETTING_FIELD(IdleTimeoutMs, 0, 0, QUIC_VAR_INT_MAX),
+    SETTING_FIELD_ANY(TlsClientMaxSendBuffer),
+    SETTING_FIELD_ANY(TlsServerMaxSendBuffer),
+    SETTING_FIELD(StreamRecvWindowDefault, QUIC_SETTING_FIELD_FLAG_POW2, 1, UINT32_MAX),
+    SETTING_FIELD(StreamRecvWindowBidiLocalDefault, QUIC_SETTING_FIELD_FLAG_POW2, 1, UINT32_MAX),
+    SETTING_FIELD(StreamRecvWindowBidiRemoteDefault, QUIC_SETTING_FIELD_FLAG_POW2, 1, UINT32_MAX),
+    SETTING_FIELD(StreamRecvWindowUnidiDefault, QUIC_SETTING_FIELD_FLAG_POW2, 1, UINT32_MAX),
+    SETTING_FIELD(StreamRecvBufferDefault, 0, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, UINT32_MAX),
+    SETTING_FIELD_ANY(ConnFlowControlWindow),
+    SETTING_FIELD_ANY(MaxWorkerQueueDelayUs),
+    SETTING_FIELD_ANY(MaxStatelessOperations),
+    SETTING_FIELD_ANY(InitialWindowPackets),
+    SETTING_FIELD_ANY(SendIdleTimeoutMs),
+    SETTING_FIELD(InitialRttMs, 0, 1, UINT32_MAX),
+    SETTING_FIELD(MaxAckDelayMs, 0, 0, QUIC_TP_MAX_ACK_DELAY_MAX),
+    SETTING_FIELD(DisconnectTimeoutMs, 0, 1, QUIC_MAX_DISCONNECT_TIMEOUT),
+    SETTING_FIELD_ANY(KeepAliveIntervalMs),
+    SETTING_FIELD_ANY(PeerBidiStreamCount),
+    SETTING_FIELD_ANY(PeerUnidiStreamCount),
+    SETTING_FIELD_ANY(RetryMemoryLimit),
+    SETTING_FIELD(LoadBalancingMode, 0, 0, QUIC_LOAD_BALANCING_COUNT - 1),
+    SETTING_FIELD_ANY(FixedServerID),
+    SETTING_FIELD(MaxOperationsPerDrain, 0, 1, UINT8_MAX),
+    SETTING_FIELD_ANY(SendBufferingEnabled),
+    SETTING_FIELD_ANY(PacingEnabled),
+    SETTING_FIELD_ANY(MigrationEnabled),
+    SETTING_FIELD_ANY(DatagramReceiveEnabled),
+    SETTING_FIELD(ServerResumptionLevel, 0, 0, QUIC_SERVER_RESUME_AND_ZERORTT),
+    SETTING_FIELD(VersionSettings, QUIC_SETTING_FIELD_FLAG_CUSTOM, 0, UINT64_MAX),
+    SETTING_FIELD_ANY(VersionNegotiationExtEnabled),
+    SETTING_FIELD(MinimumMtu, QUIC_SETTING_FIELD_FLAG_CUSTOM, 0, UINT64_MAX),
+    SETTING_FIELD(MaximumMtu, QUIC_SETTING_FIELD_FLAG_CUSTOM, 0, UINT64_MAX),
+    SETTING_FIELD_ANY(MtuDiscoverySearchCompleteTimeoutUs),
+    SETTING_FIELD_ANY(MtuDiscoveryMissingProbeCount),
+    SETTING_FIELD_ANY(MaxBindingStatelessOperations),
+    SETTING_FIELD_ANY(StatelessOperationExpirationMs),
+    SETTING_FIELD_ANY(CongestionControlAlgorithm),
+    SETTING_FIELD_ANY(DestCidUpdateIdleTimeoutMs),
+    SETTING_FIELD_ANY(GreaseQuicBitEnabled),
+    SETTING_FIELD_ANY(EcnEnabled),
+    SETTING_FIELD_ANY(HyStartEnabled),
+    SETTING_FIELD_ANY(EncryptionOffloadAllowed),
+    SETTING_FIELD_ANY(ReliableResetEnabled),
+    SETTING_FIELD_ANY(OneWayDelayEnabled),
+    SETTING_FIELD_ANY(NetStatsEventEnabled),
+    SETTING_FIELD_ANY(StreamMultiReceiveEnabled),
+    SETTING_FIELD_ANY(XdpEnabled),
+    SETTING_FIELD_ANY(QTIPEnabled),
+    SETTING_FIELD_ANY(RioEnabled),
+    SETTING_FIELD_ANY(ControlFrameCoalescingEnabled),
+    SETTING_FIELD_ANY(EncryptFromSendBuffersEnabled),
+    SETTING_FIELD_ANY(ConnFlowControlWindowMax),
+    SETTING_FIELD_ANY(StreamBatchReceiveEnabled),
+    SETTING_FIELD_ANY(CarefulResumeEnabled),
+    SETTING_FIELD_ANY(HibernateTimeoutMs),
+    SETTING_FIELD_ANY(PeerStreamCountMax),
+    SETTING_FIELD(SpinBitDisableRate, 0, QUIC_MIN_SPIN_BIT_DISABLE_RATE, UINT16_MAX),
+};
+
+QUIC_INLINE
+uint64_t
+QuicSettingFieldRead(
+    _In_ const QUIC_SETTING_FIELD* Field,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    const uint8_t* Value = (const uint8_t*)Settings + Field->Offset;
+    switch (Field->Size) {
+    case sizeof(uint8_t):  return *Value;
+    case sizeof(uint16_t): return *(const uint16_t*)Value;
+    case sizeof(uint32_t): return *(const uint32_t*)Value;
+    default:               return *(const uint64_t*)Value;
+    }
+}
+
+//
+// Copies the fields in Mask, other than the custom ones, from Source to
+// Destination, without changing any IsSet flags. Returns the fields copied.
+//
+static
+uint64_t
+QuicSettingsCopyFields(
+    _Inout_ QUIC_SETTINGS_INTERNAL* Destination,
+    _In_ const QUIC_SETTINGS_INTERNAL* Source,
+    _In_ uint64_t Mask
+    )
+{
+    uint64_t Copied = 0;
+    for (uint32_t i = 0; Mask != 0; ++i, Mask >>= 1) {
+        const QUIC_SETTING_FIELD* Field = &QuicSettingFields[i];
+        if ((Mask & 1) && !(Field->Flags & QUIC_SETTING_FIELD_FLAG_CUSTOM)) {
+            CxPlatCopyMemory(
+                (uint8_t*)Destination + Field->Offset,
+                (const uint8_t*)Source + Field->Offset,
+                Field->Size);
+            Copied |= 1ull << i;
+        }
+    }
+    return Copied;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -183,99 +319,23 @@ QuicSettingsCopy(
     _In_ const QUIC_SETTINGS_INTERNAL* Source
     )
 {
-    if (!Destination->IsSet.SendBufferingEnabled) {
-        Destination->SendBufferingEnabled = Source->SendBufferingEnabled;
-    }
-    if (!Destination->IsSet.PacingEnabled) {
-        Destination->PacingEnabled = Source->PacingEnabled;
-    }
-    if (!Destination->IsSet.MigrationEnabled) {
-        Destination->MigrationEnabled = Source->MigrationEnabled;
-    }
-    if (!Destination->IsSet.DatagramReceiveEnabled) {
-        Destination->DatagramReceiveEnabled = Source->DatagramReceiveEnabled;
-    }
-    if (!Destination->IsSet.MaxOperationsPerDrain) {
-        Destination->MaxOperationsPerDrain = Source->MaxOperationsPerDrain;
-    }
-    if (!Destination->IsSet.RetryMemoryLimit) {
-        Destination->RetryMemoryLimit = Source->RetryMemoryLimit;
-    }
-    if (!Destination->IsSet.LoadBalancingMode) {
-        Destination->LoadBalancingMode = Source->LoadBalancingMode;
-    }
-    if (!Destination->IsSet.FixedServerID) {
-        Destination->FixedServerID = Source->FixedServerID;
-    }
-    if (!Destination->IsSet.MaxWorkerQueueDelayUs) {
-        Destination->MaxWorkerQueueDelayUs = Source->MaxWorkerQueueDelayUs;
-    }
-    if (!Destination->IsSet.MaxStatelessOperations) {
-        Destination->MaxStatelessOperations = Source->MaxStatelessOperations;
-    }
-    if (!Destination->IsSet.InitialWindowPackets) {
-        Destination->InitialWindowPackets = Source->InitialWindowPackets;
-    }
-    if (!Destination->IsSet.SendIdleTimeoutMs) {
-        Destination->SendIdleTimeoutMs = Source->SendIdleTimeoutMs;
-    }
-    if (!Destination->IsSet.InitialRttMs) {
-        Destination->InitialRttMs = Source->InitialRttMs;
-    }
-    if (!Destination->IsSet.MaxAckDelayMs) {
-        Destination->MaxAckDelayMs = Source->MaxAckDelayMs;
-    }
-    if (!Destination->IsSet.DisconnectTimeoutMs) {
-        Destination->DisconnectTimeoutMs = Source->DisconnectTimeoutMs;
-    }
-    if (!Destination->IsSet.KeepAliveIntervalMs) {
-        Destination->KeepAliveIntervalMs = Source->KeepAliveIntervalMs;
-    }
-    if (!Destination->IsSet.IdleTimeoutMs) {
-        Destination->IdleTimeoutMs = Source->IdleTimeoutMs;
-    }
-    if (!Destination->IsSet.HandshakeIdleTimeoutMs) {
-        Destination->HandshakeIdleTimeoutMs = Source->HandshakeIdleTimeoutMs;
-    }
-    if (!Destination->IsSet.PeerBidiStreamCount) {
-        Destination->PeerBidiStreamCount = Source->PeerBidiStreamCount;
-    }
-    if (!Destination->IsSet.PeerUnidiStreamCount) {
-        Destination->PeerUnidiStreamCount = Source->PeerUnidiStreamCount;
-    }
-    if (!Destination->IsSet.TlsClientMaxSendBuffer) {
-        Destination->TlsClientMaxSendBuffer = Source->TlsClientMaxSendBuffer;
-    }
-    if (!Destination->IsSet.TlsClientMaxSendBuffer) {
-        Destination->TlsClientMaxSendBuffer = Source->TlsClientMaxSendBuffer;
-    }
-    if (!Destination->IsSet.StreamRecvWindowDefault) {
-        Destination->StreamRecvWindowDefault = Source->StreamRecvWindowDefault;
-    }
-    if (!Destination->IsSet.StreamRecvWindowBidiLocalDefault) {
-        Destination->StreamRecvWindowBidiLocalDefault = Source->StreamRecvWindowBidiLocalDefault;
-    }
-    if (!Destination->IsSet.StreamRecvWindowBidiRemoteDefault) {
-        Destination->StreamRecvWindowBidiRemoteDefault = Source->StreamRecvWindowBidiRemoteDefault;
-    }
-    if (!Destination->IsSet.StreamRecvWindowUnidiDefault) {
-        Destination->StreamRecvWindowUnidiDefault = Source->StreamRecvWindowUnidiDefault;
-    }
-    if (!Destination->IsSet.StreamRecvBufferDefault) {
-        Destination->StreamRecvBufferDefault = Source->StreamRecvBufferDefault;
-    }
-    if (!Destination->IsSet.ConnFlowControlWindow) {
-        Destination->ConnFlowControlWindow = Source->ConnFlowControlWindow;
-    }
-    if (!Destination->IsSet.MaxBytesPerKey) {
-        Destination->MaxBytesPerKey = Source->MaxBytesPerKey;
-    }
-    if (!Destination->IsSet.ServerResumptionLevel) {
-        Destination->ServerResumptionLevel = Source->ServerResumptionLevel;
-    }
-    if (!Destination->IsSet.VersionNegotiationExtEnabled) {
-        Destination->VersionNegotiationExtEnabled = Source->VersionNegotiationExtEnabled;
+    const uint64_t IsSetFlags = Destination->IsSetFlags;
+    if (IsSetFlags == 0) {
+        //
+        // Nothing set by the app, so everything but the version settings is
+        // a straight copy.
+        //
+        QUIC_VERSION_SETTINGS* VersionSettings = Destination->VersionSettings;
+        CxPlatCopyMemory(Destination, Source, sizeof(*Destination));
+        Destination->IsSetFlags = 0;
+        Destination->VersionSettings = VersionSettings;
+    } else {
+        (void)QuicSettingsCopyFields(
+            Destination,
+            Source,
+            ~IsSetFlags & ((1ull << QUIC_SETTINGS_COUNT) - 1));
     }
+
     if (!Destination->IsSet.VersionSettings) {
         if (Destination->VersionSettings) {
             CXPLAT_FREE(Destination->VersionSettings, QUIC_POOL_VERSION_SETTINGS);
@@ -287,6 +347,10 @@ QuicSettingsCopy(
         }
     }
 
+    if (IsSetFlags == 0) {
+        return; // MTUs were copied above.
+    }
+
     if (!Destination->IsSet.MinimumMtu && !Destination->IsSet.MaximumMtu) {
         Destination->MinimumMtu = Source->MinimumMtu;
         Destination->MaximumMtu = Source->MaximumMtu;
@@ -299,55 +363,6 @@ QuicSettingsCopy(
             Destination->MinimumMtu = Source->MinimumMtu;
         }
     }
-
-    if (!Destination->IsSet.MtuDiscoveryMissingProbeCount) {
-        Destination->MtuDiscoveryMissingProbeCount = Source->MtuDiscoveryMissingProbeCount;
-    }
-    if (!Destination->IsSet.MtuDiscoverySearchCompleteTimeoutUs) {
-        Destination->MtuDiscoverySearchCompleteTimeoutUs = Source->MtuDiscoverySearchCompleteTimeoutUs;
-    }
-    if (!Destination->IsSet.MaxBindingStatelessOperations) {
-        Destination->MaxBindingStatelessOperations = Source->MaxBindingStatelessOperations;
-    }
-    if (!Destination->IsSet.StatelessOperationExpirationMs) {
-        Destination->StatelessOperationExpirationMs = Source->StatelessOperationExpirationMs;
-    }
-    if (!Destination->IsSet.CongestionControlAlgorithm) {
-        Destination->CongestionControlAlgorithm = Source->CongestionControlAlgorithm;
-    }
-    if (!Destination->IsSet.DestCidUpdateIdleTimeoutMs) {
-        Destination->DestCidUpdateIdleTimeoutMs = Source->DestCidUpdateIdleTimeoutMs;
-    }
-    if (!Destination->IsSet.GreaseQuicBitEnabled) {
-        Destination->GreaseQuicBitEnabled = Source->GreaseQuicBitEnabled;
-    }
-    if (!Destination->IsSet.EcnEnabled) {
-        Destination->EcnEnabled = Source->EcnEnabled;
-    }
-    if (!Destination->IsSet.HyStartEnabled) {
-        Destination->HyStartEnabled = Source->HyStartEnabled;
-    }
-    if (!Destination->IsSet.EncryptionOffloadAllowed) {
-        Destination->EncryptionOffloadAllowed = Source->EncryptionOffloadAllowed;
-    }
-    if (!Destination->IsSet.ReliableResetEnabled) {
-        Destination->ReliableResetEnabled = Source->ReliableResetEnabled;
-    }
-    if (!Destination->IsSet.XdpEnabled) {
-        Destination->XdpEnabled = Source->XdpEnabled;
-    }
-    if (!Destination->IsSet.QTIPEnabled) {
-        Destination->QTIPEnabled = Source->QTIPEnabled;
-    }
-    if (!Destination->IsSet.OneWayDelayEnabled) {
-        Destination->OneWayDelayEnabled = Source->OneWayDelayEnabled;
-    }
-    if (!Destination->IsSet.NetStatsEventEnabled) {
-        Destination->NetStatsEventEnabled = Source->NetStatsEventEnabled;
-    }
-    if (!Destination->IsSet.StreamMultiReceiveEnabled) {
-        Destination->StreamMultiReceiveEnabled = Source->StreamMultiReceiveEnabled;
-    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -426,122 +441,83 @@ QuicSettingApply(
         const QUIC_SETTINGS_INTERNAL* Source
     )
 {
-    if (Source->IsSet.SendBufferingEnabled && (!Destination->IsSet.SendBufferingEnabled || OverWrite)) {
-        Destination->SendBufferingEnabled = Source->SendBufferingEnabled;
-        Destination->IsSet.SendBufferingEnabled = TRUE;
-    }
-    if (Source->IsSet.PacingEnabled && (!Destination->IsSet.PacingEnabled || OverWrite)) {
-        Destination->PacingEnabled = Source->PacingEnabled;
-        Destination->IsSet.PacingEnabled = TRUE;
-    }
-    if (Source->IsSet.MigrationEnabled && (!Destination->IsSet.MigrationEnabled || OverWrite)) {
-        Destination->MigrationEnabled = Source->MigrationEnabled;
-        Destination->IsSet.MigrationEnabled = TRUE;
+    if (!AllowMtuAndEcnChanges &&
+        (Source->IsSet.MinimumMtu || Source->IsSet.MaximumMtu || Source->IsSet.EcnEnabled)) {
+        return FALSE;
     }
-    if (Source->IsSet.DatagramReceiveEnabled && (!Destination->IsSet.DatagramReceiveEnabled || OverWrite)) {
-        Destination->DatagramReceiveEnabled = Source->DatagramReceiveEnabled;
-        Destination->IsSet.DatagramReceiveEnabled = TRUE;
+
+    uint64_t Mask = Source->IsSetFlags & ((1ull << QUIC_SETTINGS_COUNT) - 1);
+    if (!OverWrite) {
+        Mask &= ~Destination->IsSetFlags;
     }
-    if (Source->IsSet.MaxOperationsPerDrain && (!Destination->IsSet.MaxOperationsPerDrain || OverWrite)) {
-        if (Source->MaxOperationsPerDrain == 0) {
-            return FALSE;
+
+    //
+    // Validate everything before changing anything.
+    //
+    uint64_t Remaining = Mask;
+    for (uint32_t i = 0; Remaining != 0; ++i, Remaining >>= 1) {
+        const QUIC_SETTING_FIELD* Field = &QuicSettingFields[i];
+        if (!(Remaining & 1) || (Field->Flags & QUIC_SETTING_FIELD_FLAG_CUSTOM)) {
+            continue;
         }
-        Destination->MaxOperationsPerDrain = Source->MaxOperationsPerDrain;
-        Destination->IsSet.MaxOperationsPerDrain = TRUE;
-    }
-    if (Source->IsSet.RetryMemoryLimit && (!Destination->IsSet.RetryMemoryLimit || OverWrite)) {
-        Destination->RetryMemoryLimit = Source->RetryMemoryLimit;
-        Destination->IsSet.RetryMemoryLimit = TRUE;
-    }
-    if (Source->IsSet.LoadBalancingMode && (!Destination->IsSet.LoadBalancingMode || OverWrite)) {
-        if (Source->LoadBalancingMode >= QUIC_LOAD_BALANCING_COUNT) {
+        const uint64_t Value = QuicSettingFieldRead(Field, Source);
+        if (Value < Field->Min || Value > Field->Max) {
             return FALSE;
         }
-        Destination->LoadBalancingMode = Source->LoadBalancingMode;
-        Destination->IsSet.LoadBalancingMode = TRUE;
-    }
-    if (Source->IsSet.FixedServerID && (!Destination->IsSet.FixedServerID || OverWrite)) {
-        Destination->FixedServerID = Source->FixedServerID;
-        Destination->IsSet.FixedServerID = TRUE;
-    }
-    if (Source->IsSet.MaxWorkerQueueDelayUs && (!Destination->IsSet.MaxWorkerQueueDelayUs || OverWrite)) {
-        Destination->MaxWorkerQueueDelayUs = Source->MaxWorkerQueueDelayUs;
-        Destination->IsSet.MaxWorkerQueueDelayUs = TRUE;
-    }
-    if (Source->IsSet.MaxStatelessOperations && (!Destination->IsSet.MaxStatelessOperations || OverWrite)) {
-        Destination->MaxStatelessOperations = Source->MaxStatelessOperations;
-        Destination->IsSet.MaxStatelessOperations = TRUE;
-    }
-    if (Source->IsSet.InitialWindowPackets && (!Destination->IsSet.InitialWindowPackets || OverWrite)) {
-        Destination->InitialWindowPackets = Source->InitialWindowPackets;
-        Destination->IsSet.InitialWindowPackets = TRUE;
-    }
-    if (Source->IsSet.SendIdleTimeoutMs && (!Destination->IsSet.SendIdleTimeoutMs || OverWrite)) {
-        Destination->SendIdleTimeoutMs = Source->SendIdleTimeoutMs;
-        Destination->IsSet.SendIdleTimeoutMs = TRUE;
-    }
-    if (Source->IsSet.InitialRttMs && (!Destination->IsSet.InitialRttMs || OverWrite)) {
-        if (Source->InitialRttMs == 0) {
+        if ((Field->Flags & QUIC_SETTING_FIELD_FLAG_POW2) && (Value & (Value - 1)) != 0) {
             return FALSE;
         }
-        Destination->InitialRttMs = Source->InitialRttMs;
-        Destination->IsSet.InitialRttMs = TRUE;
     }
-    if (Source->IsSet.MaxAckDelayMs && (!Destination->IsSet.MaxAckDelayMs || OverWrite)) {
-        if (Source->MaxAckDelayMs > QUIC_TP_MAX_ACK_DELAY_MAX) {
-            return FALSE;
+
+    uint16_t MinimumMtu = 0, MaximumMtu = 0;
+    if (AllowMtuAndEcnChanges) {
+        MinimumMtu =
+            Destination->IsSet.MinimumMtu ? Destination->MinimumMtu : QUIC_DPLPMTUD_MIN_MTU;
+        MaximumMtu =
+            Destination->IsSet.MaximumMtu ? Destination->MaximumMtu : CXPLAT_MAX_MTU;
+        if (Source->IsSet.MinimumMtu && (!Destination->IsSet.MinimumMtu || OverWrite)) {
+            MinimumMtu = Source->MinimumMtu;
+            if (MinimumMtu < QUIC_DPLPMTUD_MIN_MTU) {
+                MinimumMtu = QUIC_DPLPMTUD_MIN_MTU;
+            } else if (MinimumMtu > CXPLAT_MAX_MTU) {
+                MinimumMtu = CXPLAT_MAX_MTU;
+            }
         }
-        Destination->MaxAckDelayMs = Source->MaxAckDelayMs;
-        Destination->IsSet.MaxAckDelayMs = TRUE;
-    }
-    if (Source->IsSet.DisconnectTimeoutMs && (!Destination->IsSet.DisconnectTimeoutMs || OverWrite)) {
-        if (Source->DisconnectTimeoutMs == 0 || Source->DisconnectTimeoutMs > QUIC_MAX_DISCONNECT_TIMEOUT) {
-            return FALSE;
+        if (Source->IsSet.MaximumMtu && (!Destination->IsSet.MaximumMtu || OverWrite)) {
+            MaximumMtu = Source->MaximumMtu;
+            if (MaximumMtu < QUIC_DPLPMTUD_MIN_MTU) {
+                MaximumMtu = QUIC_DPLPMTUD_MIN_MTU;
+            } else if (MaximumMtu > CXPLAT_MAX_JUMBO_MTU) {
+                //
+                // Paths are still limited by the local MTU the datapath
+                // reports, which only exceeds CXPLAT_MAX_MTU on jumbo capable
+                // interfaces.
+                //
+                MaximumMtu = CXPLAT_MAX_JUMBO_MTU;
+            }
         }
-        Destination->DisconnectTimeoutMs = Source->DisconnectTimeoutMs;
-        Destination->IsSet.DisconnectTimeoutMs = TRUE;
-    }
-    if (Source->IsSet.KeepAliveIntervalMs && (!Destination->IsSet.KeepAliveIntervalMs || OverWrite)) {
-        Destination->KeepAliveIntervalMs = Source->KeepAliveIntervalMs;
-        Destination->IsSet.KeepAliveIntervalMs = TRUE;
-    }
-    if (Source->IsSet.IdleTimeoutMs && (!Destination->IsSet.IdleTimeoutMs || OverWrite)) {
-        if (Source->IdleTimeoutMs > QUIC_VAR_INT_MAX) {
+        if (MinimumMtu > MaximumMtu) {
             return FALSE;
         }
-        Destination->IdleTimeoutMs = Source->IdleTimeoutMs;
-        Destination->IsSet.IdleTimeoutMs = TRUE;
     }
-    if (Source->IsSet.HandshakeIdleTimeoutMs && (!Destination->IsSet.HandshakeIdleTimeoutMs || OverWrite)) {
-        if (Source->HandshakeIdleTimeoutMs > QUIC_VAR_INT_MAX) {
+
+    //
+    // The version settings are copied up front too, as it is the only step
+    // that can fail for lack of memory.
+    //
+    QUIC_VERSION_SETTINGS* VersionSettings = NULL;
+    const BOOLEAN ApplyVersionSettings =
+        Source->IsSet.VersionSettings &&
+        (!Destination->IsSet.VersionSettings || OverWrite);
+    if (ApplyVersionSettings && Source->VersionSettings != NULL) {
+        VersionSettings = QuicSettingsCopyVersionSettings(Source->VersionSettings, FALSE);
+        if (VersionSettings == NULL) {
             return FALSE;
         }
-        Destination->HandshakeIdleTimeoutMs = Source->HandshakeIdleTimeoutMs;
-        Destination->IsSet.HandshakeIdleTimeoutMs = TRUE;
-    }
-    if (Source->IsSet.PeerBidiStreamCount && (!Destination->IsSet.PeerBidiStreamCount || OverWrite)) {
-        Destination->PeerBidiStreamCount = Source->PeerBidiStreamCount;
-        Destination->IsSet.PeerBidiStreamCount = TRUE;
-    }
-    if (Source->IsSet.PeerUnidiStreamCount && (!Destination->IsSet.PeerUnidiStreamCount || OverWrite)) {
-        Destination->PeerUnidiStreamCount = Source->PeerUnidiStreamCount;
-        Destination->IsSet.PeerUnidiStreamCount = TRUE;
     }
-    if (Source->IsSet.TlsClientMaxSendBuffer && (!Destination->IsSet.TlsClientMaxSendBuffer || OverWrite)) {
-        Destination->TlsClientMaxSendBuffer = Source->TlsClientMaxSendBuffer;
-        Destination->IsSet.TlsClientMaxSendBuffer = TRUE;
-    }
-    if (Source->IsSet.TlsClientMaxSendBuffer && (!Destination->IsSet.TlsClientMaxSendBuffer || OverWrite)) {
-        Destination->TlsClientMaxSendBuffer = Source->TlsClientMaxSendBuffer;
-        Destination->IsSet.TlsClientMaxSendBuffer = TRUE;
-    }
-    if (Source->IsSet.StreamRecvWindowDefault && (!Destination->IsSet.StreamRecvWindowDefault || OverWrite)) {
-        if (Source->StreamRecvWindowDefault == 0 || (Source->StreamRecvWindowDefault & (Source->StreamRecvWindowDefault - 1)) != 0) {
-            return FALSE; // Must be power of 2
-        }
-        Destination->StreamRecvWindowDefault = Source->StreamRecvWindowDefault;
-        Destination->IsSet.StreamRecvWindowDefault = TRUE;
 
+    if (Source->IsSet.StreamRecvWindowDefault &&
+        (!Destination->IsSet.StreamRecvWindowDefault || OverWrite)) {
         //
         // Also set window size for individual stream types, they will be overwritten by a more specific settings if set
         //
@@ -555,99 +531,18 @@ QuicSettingApply(
             Destination->StreamRecvWindowUnidiDefault = Source->StreamRecvWindowDefault;
         }
     }
-    if (Source->IsSet.StreamRecvWindowBidiLocalDefault && (!Destination->IsSet.StreamRecvWindowBidiLocalDefault || OverWrite)) {
-        if (Source->StreamRecvWindowBidiLocalDefault == 0 || (Source->StreamRecvWindowBidiLocalDefault & (Source->StreamRecvWindowBidiLocalDefault - 1)) != 0) {
-            return FALSE; // Must be power of 2
-        }
-        Destination->StreamRecvWindowBidiLocalDefault = Source->StreamRecvWindowBidiLocalDefault;
-        Destination->IsSet.StreamRecvWindowBidiLocalDefault = TRUE;
-    }
-    if (Source->IsSet.StreamRecvWindowBidiRemoteDefault && (!Destination->IsSet.StreamRecvWindowBidiRemoteDefault || OverWrite)) {
-        if (Source->StreamRecvWindowBidiRemoteDefault == 0 || (Source->StreamRecvWindowBidiRemoteDefault & (Source->StreamRecvWindowBidiRemoteDefault - 1)) != 0) {
-            return FALSE; // Must be power of 2
-        }
-        Destination->StreamRecvWindowBidiRemoteDefault = Source->StreamRecvWindowBidiRemoteDefault;
-        Destination->IsSet.StreamRecvWindowBidiRemoteDefault = TRUE;
-    }
-    if (Source->IsSet.StreamRecvWindowUnidiDefault && (!Destination->IsSet.StreamRecvWindowUnidiDefault || OverWrite)) {
-        if (Source->StreamRecvWindowUnidiDefault == 0 || (Source->StreamRecvWindowUnidiDefault & (Source->StreamRecvWindowUnidiDefault - 1)) != 0) {
-            return FALSE; // Must be power of 2
-        }
-        Destination->StreamRecvWindowUnidiDefault = Source->StreamRecvWindowUnidiDefault;
-        Destination->IsSet.StreamRecvWindowUnidiDefault = TRUE;
-    }
-    if (Source->IsSet.StreamRecvBufferDefault && (!Destination->IsSet.StreamRecvBufferDefault || OverWrite)) {
-        if (Source->StreamRecvBufferDefault < QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE) {
-            return FALSE;
-        }
-        Destination->StreamRecvBufferDefault = Source->StreamRecvBufferDefault;
-        Destination->IsSet.StreamRecvBufferDefault = TRUE;
-    }
-    if (Source->IsSet.ConnFlowControlWindow && (!Destination->IsSet.ConnFlowControlWindow || OverWrite)) {
-        Destination->ConnFlowControlWindow = Source->ConnFlowControlWindow;
-        Destination->IsSet.ConnFlowControlWindow = TRUE;
-    }
-    if (Source->IsSet.MaxBytesPerKey && (!Destination->IsSet.MaxBytesPerKey || OverWrite)) {
-        if (Source->MaxBytesPerKey > QUIC_DEFAULT_MAX_BYTES_PER_KEY) {
-            return FALSE;
-        }
-        Destination->MaxBytesPerKey = Source->MaxBytesPerKey;
-        Destination->IsSet.MaxBytesPerKey = TRUE;
-    }
-    if (Source->IsSet.ServerResumptionLevel && (!Destination->IsSet.ServerResumptionLevel || OverWrite)) {
-        if (Source->ServerResumptionLevel > QUIC_SERVER_RESUME_AND_ZERORTT) {
-            return FALSE;
-        }
-        Destination->ServerResumptionLevel = Source->ServerResumptionLevel;
-        Destination->IsSet.ServerResumptionLevel = TRUE;
-    }
-    if (Source->IsSet.VersionNegotiationExtEnabled && (!Destination->IsSet.VersionNegotiationExtEnabled || OverWrite)) {
-        Destination->VersionNegotiationExtEnabled = Source->VersionNegotiationExtEnabled;
-        Destination->IsSet.VersionNegotiationExtEnabled = TRUE;
-    }
 
-    if (Source->IsSet.VersionSettings) {
-        if ((Destination->IsSet.VersionSettings && OverWrite) ||
-            (!Destination->IsSet.VersionSettings && Destination->VersionSettings != NULL)) {
-            CXPLAT_FREE(Destination->VersionSettings, QUIC_POOL_VERSION_SETTINGS);
-            Destination->VersionSettings = NULL;
-            Destination->IsSet.VersionSettings = FALSE;
-        }
-        if (!Destination->IsSet.VersionSettings && Source->VersionSettings != NULL) {
-            Destination->VersionSettings =
-                QuicSettingsCopyVersionSettings(Source->VersionSettings, FALSE);
-            if (Destination->VersionSettings == NULL) {
-                return FALSE;
-            }
+    Destination->IsSetFlags |= QuicSettingsCopyFields(Destination, Source, Mask);
 
-            Destination->IsSet.VersionSettings = TRUE;
+    if (ApplyVersionSettings) {
+        if (Destination->VersionSettings != NULL) {
+            CXPLAT_FREE(Destination->VersionSettings, QUIC_POOL_VERSION_SETTINGS);
         }
+        Destination->VersionSettings = VersionSettings;
+        Destination->IsSet.VersionSettings = VersionSettings != NULL;
     }
 
     if (AllowMtuAndEcnChanges) {
-        uint16_t MinimumMtu =
-            Destination->IsSet.MinimumMtu ? Destination->MinimumMtu : QUIC_DPLPMTUD_MIN_MTU;
-        uint16_t MaximumMtu =
-            Destination->IsSet.MaximumMtu ? Destination->MaximumMtu : CXPLAT_MAX_MTU;
-        if (Source->IsSet.MinimumMtu && (!Destination->IsSet.MinimumMtu || OverWrite)) {
-            MinimumMtu = Source->MinimumMtu;
-            if (MinimumMtu < QUIC_DPLPMTUD_MIN_MTU) {
-                MinimumMtu = QUIC_DPLPMTUD_MIN_MTU;
-            } else if (MinimumMtu > CXPLAT_MAX_MTU) {
-                MinimumMtu = CXPLAT_MAX_MTU;
-            }
-        }
-        if (Source->IsSet.MaximumMtu && (!Destination->IsSet.MaximumMtu || OverWrite)) {
-            MaximumMtu = Source->MaximumMtu;
-            if (MaximumMtu < QUIC_DPLPMTUD_MIN_MTU) {
-                MaximumMtu = QUIC_DPLPMTUD_MIN_MTU;
-            } else if (MaximumMtu > CXPLAT_MAX_MTU) {
-                MaximumMtu = CXPLAT_MAX_MTU;
-            }
-        }
-        if (MinimumMtu > MaximumMtu) {
-            return FALSE;
-        }
         if (Source->IsSet.MinimumMtu) {
             Destination->IsSet.MinimumMtu = TRUE;
         }
@@ -656,87 +551,8 @@ QuicSettingApply(
         }
         Destination->MinimumMtu = MinimumMtu;
         Destination->MaximumMtu = MaximumMtu;
-    } else if (Source->IsSet.MinimumMtu || Source->IsSet.MaximumMtu) {
-        return FALSE;
-    }
-
-    if (Source->IsSet.MtuDiscoverySearchCompleteTimeoutUs && (!Destination->IsSet.MtuDiscoverySearchCompleteTimeoutUs || OverWrite)) {
-        Destination->MtuDiscoverySearchCompleteTimeoutUs = Source->MtuDiscoverySearchCompleteTimeoutUs;
-        Destination->IsSet.MtuDiscoverySearchCompleteTimeoutUs = TRUE;
-    }
-    if (Source->IsSet.MtuDiscoveryMissingProbeCount && (!Destination->IsSet.MtuDiscoveryMissingProbeCount || OverWrite)) {
-        Destination->MtuDiscoveryMissingProbeCount = Source->MtuDiscoveryMissingProbeCount;
-        Destination->IsSet.MtuDiscoveryMissingProbeCount = TRUE;
-    }
-
-    if (Source->IsSet.MaxBindingStatelessOperations && (!Destination->IsSet.MaxBindingStatelessOperations || OverWrite)) {
-        Destination->MaxBindingStatelessOperations = Source->MaxBindingStatelessOperations;
-        Destination->IsSet.MaxBindingStatelessOperations = TRUE;
-    }
-    if (Source->IsSet.StatelessOperationExpirationMs && (!Destination->IsSet.StatelessOperationExpirationMs || OverWrite)) {
-        Destination->StatelessOperationExpirationMs = Source->StatelessOperationExpirationMs;
-        Destination->IsSet.StatelessOperationExpirationMs = TRUE;
-    }
-
-    if (Source->IsSet.CongestionControlAlgorithm && (!Destination->IsSet.CongestionControlAlgorithm || OverWrite)) {
-        Destination->CongestionControlAlgorithm = Source->CongestionControlAlgorithm;
-        Destination->IsSet.CongestionControlAlgorithm = TRUE;
     }
 
-    if (Source->IsSet.DestCidUpdateIdleTimeoutMs && (!Destination->IsSet.DestCidUpdateIdleTimeoutMs || OverWrite)) {
-        Destination->DestCidUpdateIdleTimeoutMs = Source->DestCidUpdateIdleTimeoutMs;
-        Destination->IsSet.DestCidUpdateIdleTimeoutMs = TRUE;
-    }
-
-    if (Source->IsSet.GreaseQuicBitEnabled && (!Destination->IsSet.GreaseQuicBitEnabled || OverWrite)) {
-        Destination->GreaseQuicBitEnabled = Source->GreaseQuicBitEnabled;
-        Destination->IsSet.GreaseQuicBitEnabled = TRUE;
-    }
-
-    if (AllowMtuAndEcnChanges) {
-        if (Source->IsSet.EcnEnabled && (!Destination->IsSet.EcnEnabled || OverWrite)) {
-            Destination->EcnEnabled = Source->EcnEnabled;
-            Destination->IsSet.EcnEnabled = TRUE;
-        }
-    } else if (Source->IsSet.EcnEnabled) {
-        return FALSE;
-    }
-
-    if (Source->IsSet.EncryptionOffloadAllowed && (!Destination->IsSet.EncryptionOffloadAllowed || OverWrite)) {
-        Destination->EncryptionOffloadAllowed = Source->EncryptionOffloadAllowed;
-        Destination->IsSet.EncryptionOffloadAllowed = TRUE;
-    }
-
-    if (Source->IsSet.ReliableResetEnabled && (!Destination->IsSet.ReliableResetEnabled || OverWrite)) {
-        Destination->ReliableResetEnabled = Source->ReliableResetEnabled;
-        Destination->IsSet.ReliableResetEnabled = TRUE;
-    }
-
-    if (Source->IsSet.XdpEnabled && (!Destination->IsSet.XdpEnabled || OverWrite)) {
-        Destination->XdpEnabled = Source->XdpEnabled;
-        Destination->IsSet.XdpEnabled = TRUE;
-    }
-
-    if (Source->IsSet.QTIPEnabled && (!Destination->IsSet.QTIPEnabled || OverWrite)) {
-        Destination->QTIPEnabled = Source->QTIPEnabled;
-        Destination->IsSet.QTIPEnabled = TRUE;
-    }
-
-
-    if (Source->IsSet.OneWayDelayEnabled && (!Destination->IsSet.OneWayDelayEnabled || OverWrite)) {
-        Destination->OneWayDelayEnabled = Source->OneWayDelayEnabled;
-        Destination->IsSet.OneWayDelayEnabled = TRUE;
-    }
-
-    if (Source->IsSet.NetStatsEventEnabled && (!Destination->IsSet.NetStatsEventEnabled || OverWrite)) {
-        Destination->NetStatsEventEnabled = Source->NetStatsEventEnabled;
-        Destination->IsSet.NetStatsEventEnabled = TRUE;
-    }
-
-    if (Source->IsSet.StreamMultiReceiveEnabled && (!Destination->IsSet.StreamMultiReceiveEnabled || OverWrite)) {
-        Destination->StreamMultiReceiveEnabled = Source->StreamMultiReceiveEnabled;
-        Destination->IsSet.StreamMultiReceiveEnabled = TRUE;
-    }
     return TRUE;
 }
 
@@ -754,6 +570,49 @@ QuicSettingsCleanup(
 }
 
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SHARED_SETTINGS*
+QuicSharedSettingsAlloc(
+    _In_ const QUIC_SETTINGS_INTERNAL* Source
+    )
+{
+    QUIC_SHARED_SETTINGS* SharedSettings =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_SHARED_SETTINGS), QUIC_POOL_SHARED_SETTINGS);
+    if (SharedSettings == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "shared settings",
+            sizeof(QUIC_SHARED_SETTINGS));
+        return NULL;
+    }
+
+    CxPlatRefInitialize(&SharedSettings->RefCount);
+    CxPlatCopyMemory(&SharedSettings->Settings, Source, sizeof(*Source));
+    if (Source->VersionSettings != NULL) {
+        SharedSettings->Settings.VersionSettings =
+            QuicSettingsCopyVersionSettings(Source->VersionSettings, FALSE);
+        if (SharedSettings->Settings.VersionSettings == NULL) {
+            CXPLAT_FREE(SharedSettings, QUIC_POOL_SHARED_SETTINGS);
+            return NULL;
+        }
+    }
+
+    return SharedSettings;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSharedSettingsRelease(
+    _In_ QUIC_SHARED_SETTINGS* SharedSettings
+    )
+{
+    if (CxPlatRefDecrement(&SharedSettings->RefCount)) {
+        QuicSettingsCleanup(&SharedSettings->Settings);
+        CXPLAT_FREE(SharedSettings, QUIC_POOL_SHARED_SETTINGS);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSettingsLoad(
@@ -1059,6 +918,50 @@ QuicSettingsLoad(
             &ValueLen);
     }
 
+    if (!Settings->IsSet.ConnFlowControlWindowMax) {
+        ValueLen = sizeof(Settings->ConnFlowControlWindowMax);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_CONN_FLOW_CONTROL_WINDOW_MAX,
+            (uint8_t*)&Settings->ConnFlowControlWindowMax,
+            &ValueLen);
+    }
+
+    if (!Settings->IsSet.HibernateTimeoutMs) {
+        ValueLen = sizeof(Settings->HibernateTimeoutMs);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_HIBERNATE_TIMEOUT,
+            (uint8_t*)&Settings->HibernateTimeoutMs,
+            &ValueLen);
+    }
+
+    if (!Settings->IsSet.PeerStreamCountMax) {
+        Value = QUIC_DEFAULT_PEER_STREAM_COUNT_MAX;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_PEER_STREAM_COUNT_MAX,
+            (uint8_t*)&Value,
+            &ValueLen);
+        if (Value <= UINT16_MAX) {
+            Settings->PeerStreamCountMax = (uint16_t)Value;
+        }
+    }
+
+    if (!Settings->IsSet.SpinBitDisableRate) {
+        Value = QUIC_DEFAULT_SPIN_BIT_DISABLE_RATE;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_SPIN_BIT_DISABLE_RATE,
+            (uint8_t*)&Value,
+            &ValueLen);
+        if (Value >= QUIC_MIN_SPIN_BIT_DISABLE_RATE && Value <= UINT16_MAX) {
+            Settings->SpinBitDisableRate = (uint16_t)Value;
+        }
+    }
+
     if (!Settings->IsSet.MaxBytesPerKey) {
         ValueLen = sizeof(Settings->MaxBytesPerKey);
         CxPlatStorageReadValue(
@@ -1249,8 +1152,8 @@ VersionSettingsFail:
             (uint8_t*)&MaximumMtu,
             &ValueLen);
     }
-    if (MaximumMtu > CXPLAT_MAX_MTU) {
-        MaximumMtu = CXPLAT_MAX_MTU;
+    if (MaximumMtu > CXPLAT_MAX_JUMBO_MTU) {
+        MaximumMtu = CXPLAT_MAX_JUMBO_MTU;
     } else if (MaximumMtu < QUIC_DPLPMTUD_MIN_MTU) {
         MaximumMtu = QUIC_DPLPMTUD_MIN_MTU;
     }
@@ -1395,6 +1298,16 @@ VersionSettingsFail:
             &ValueLen);
         Settings->QTIPEnabled = !!Value;
     }
+    if (!Settings->IsSet.RioEnabled) {
+        Value = QUIC_DEFAULT_RIO_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_RIO_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->RioEnabled = !!Value;
+    }
     if (!Settings->IsSet.OneWayDelayEnabled) {
         Value = QUIC_DEFAULT_ONE_WAY_DELAY_ENABLED;
         ValueLen = sizeof(Value);
@@ -1425,6 +1338,46 @@ VersionSettingsFail:
             &ValueLen);
         Settings->StreamMultiReceiveEnabled = !!Value;
     }
+    if (!Settings->IsSet.ControlFrameCoalescingEnabled) {
+        Value = QUIC_DEFAULT_CONTROL_FRAME_COALESCING_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_CONTROL_FRAME_COALESCING_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->ControlFrameCoalescingEnabled = !!Value;
+    }
+    if (!Settings->IsSet.EncryptFromSendBuffersEnabled) {
+        Value = QUIC_DEFAULT_ENCRYPT_FROM_SEND_BUFFERS_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_ENCRYPT_FROM_SEND_BUFFERS_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->EncryptFromSendBuffersEnabled = !!Value;
+    }
+    if (!Settings->IsSet.StreamBatchReceiveEnabled) {
+        Value = QUIC_DEFAULT_STREAM_BATCH_RECEIVE_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_STREAM_BATCH_RECEIVE_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->StreamBatchReceiveEnabled = !!Value;
+    }
+    if (!Settings->IsSet.CarefulResumeEnabled) {
+        Value = QUIC_DEFAULT_CAREFUL_RESUME_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_CAREFUL_RESUME_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->CarefulResumeEnabled = !!Value;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1461,6 +1414,10 @@ QuicSettingsDump(
     QuicTraceLogVerbose(SettingDumpStreamRecvWindowBidiRemoteDefault, "[sett] StreamRecvWindowBidiRemoteDefault = %u", Settings->StreamRecvWindowBidiRemoteDefault);
     QuicTraceLogVerbose(SettingDumpStreamRecvWindowUnidiDefault,      "[sett] StreamRecvWindowUnidiDefault      = %u", Settings->StreamRecvWindowUnidiDefault);
     QuicTraceLogVerbose(SettingDumpConnFlowControlWindow,   "[sett] ConnFlowControlWindow  = %u", Settings->ConnFlowControlWindow);
+    QuicTraceLogVerbose(SettingDumpConnFlowControlWindowMax, "[sett] ConnFlowControlWindowMax = %u", Settings->ConnFlowControlWindowMax);
+    QuicTraceLogVerbose(SettingDumpHibernateTimeoutMs,      "[sett] HibernateTimeoutMs     = %u", Settings->HibernateTimeoutMs);
+    QuicTraceLogVerbose(SettingDumpPeerStreamCountMax,      "[sett] PeerStreamCountMax     = %hu", Settings->PeerStreamCountMax);
+    QuicTraceLogVerbose(SettingDumpSpinBitDisableRate,      "[sett] SpinBitDisableRate     = %hu", Settings->SpinBitDisableRate);
     QuicTraceLogVerbose(SettingDumpMaxBytesPerKey,          "[sett] MaxBytesPerKey         = %llu", Settings->MaxBytesPerKey);
     QuicTraceLogVerbose(SettingDumpServerResumptionLevel,   "[sett] ServerResumptionLevel  = %hhu", Settings->ServerResumptionLevel);
     QuicTraceLogVerbose(SettingDumpVersionNegoExtEnabled,   "[sett] Version Negotiation Ext Enabled = %hhu", Settings->VersionNegotiationExtEnabled);
@@ -1589,6 +1546,18 @@ QuicSettingsDumpNew(
     if (Settings->IsSet.ConnFlowControlWindow) {
         QuicTraceLogVerbose(SettingDumpConnFlowControlWindow,       "[sett] ConnFlowControlWindow  = %u", Settings->ConnFlowControlWindow);
     }
+    if (Settings->IsSet.ConnFlowControlWindowMax) {
+        QuicTraceLogVerbose(SettingDumpConnFlowControlWindowMax,    "[sett] ConnFlowControlWindowMax = %u", Settings->ConnFlowControlWindowMax);
+    }
+    if (Settings->IsSet.HibernateTimeoutMs) {
+        QuicTraceLogVerbose(SettingDumpHibernateTimeoutMs,          "[sett] HibernateTimeoutMs     = %u", Settings->HibernateTimeoutMs);
+    }
+    if (Settings->IsSet.PeerStreamCountMax) {
+        QuicTraceLogVerbose(SettingDumpPeerStreamCountMax,          "[sett] PeerStreamCountMax     = %hu", Settings->PeerStreamCountMax);
+    }
+    if (Settings->IsSet.SpinBitDisableRate) {
+        QuicTraceLogVerbose(SettingDumpSpinBitDisableRate,          "[sett] SpinBitDisableRate     = %hu", Settings->SpinBitDisableRate);
+    }
     if (Settings->IsSet.MaxBytesPerKey) {
         QuicTraceLogVerbose(SettingDumpMaxBytesPerKey,              "[sett] MaxBytesPerKey         = %llu", Settings->MaxBytesPerKey);
     }
@@ -1895,6 +1864,14 @@ QuicSettingsSettingsToInternal(
         SettingsSize,
         InternalSettings);
 
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        RioEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
     SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
         Flags,
         OneWayDelayEnabled,
@@ -1940,6 +1917,66 @@ QuicSettingsSettingsToInternal(
         SettingsSize,
         InternalSettings);
 
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        ControlFrameCoalescingEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        EncryptFromSendBuffersEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        StreamBatchReceiveEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        CarefulResumeEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        ConnFlowControlWindowMax,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        HibernateTimeoutMs,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        PeerStreamCountMax,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        SpinBitDisableRate,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
     return QUIC_STATUS_SUCCESS;
 }
 
@@ -2080,6 +2117,14 @@ QuicSettingsGetSettings(
         *SettingsLength,
         InternalSettings);
 
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        RioEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
     SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
         Flags,
         OneWayDelayEnabled,
@@ -2125,6 +2170,66 @@ QuicSettingsGetSettings(
         *SettingsLength,
         InternalSettings);
 
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        ControlFrameCoalescingEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        EncryptFromSendBuffersEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        StreamBatchReceiveEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        CarefulResumeEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        ConnFlowControlWindowMax,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        HibernateTimeoutMs,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        PeerStreamCountMax,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        SpinBitDisableRate,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
     *SettingsLength = CXPLAT_MIN(*SettingsLength, sizeof(QUIC_SETTINGS));
 
     return QUIC_STATUS_SUCCESS;
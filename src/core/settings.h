@@ -9,6 +9,11 @@
 extern "C" {
 #endif
 
+//
+// The number of settings tracked by the IsSet flags.
+//
+#define QUIC_SETTINGS_COUNT 59
+
 typedef struct QUIC_SETTINGS_INTERNAL {
 
     union {
@@ -64,7 +69,16 @@ typedef struct QUIC_SETTINGS_INTERNAL {
             uint64_t StreamMultiReceiveEnabled              : 1;
             uint64_t XdpEnabled                             : 1;
             uint64_t QTIPEnabled                            : 1;
-            uint64_t RESERVED                               : 14;
+            uint64_t RioEnabled                             : 1;
+            uint64_t ControlFrameCoalescingEnabled          : 1;
+            uint64_t EncryptFromSendBuffersEnabled          : 1;
+            uint64_t ConnFlowControlWindowMax               : 1;
+            uint64_t StreamBatchReceiveEnabled              : 1;
+            uint64_t CarefulResumeEnabled                   : 1;
+            uint64_t HibernateTimeoutMs                     : 1;
+            uint64_t PeerStreamCountMax                     : 1;
+            uint64_t SpinBitDisableRate                     : 1;
+            uint64_t RESERVED                               : 64 - QUIC_SETTINGS_COUNT;
         } IsSet;
     };
 
@@ -81,6 +95,8 @@ typedef struct QUIC_SETTINGS_INTERNAL {
     uint32_t StreamRecvWindowUnidiDefault;
     uint32_t StreamRecvBufferDefault;
     uint32_t ConnFlowControlWindow;
+    uint32_t ConnFlowControlWindowMax;
+    uint32_t HibernateTimeoutMs;
     uint32_t MaxWorkerQueueDelayUs;
     uint32_t MaxStatelessOperations;
     uint32_t InitialWindowPackets;
@@ -93,6 +109,8 @@ typedef struct QUIC_SETTINGS_INTERNAL {
     uint32_t FixedServerID;                 // Global only
     uint16_t PeerBidiStreamCount;
     uint16_t PeerUnidiStreamCount;
+    uint16_t PeerStreamCountMax;
+    uint16_t SpinBitDisableRate;
     uint16_t RetryMemoryLimit;              // Global only
     uint16_t LoadBalancingMode;             // Global only
     uint16_t MinimumMtu;
@@ -101,25 +119,62 @@ typedef struct QUIC_SETTINGS_INTERNAL {
     uint16_t StatelessOperationExpirationMs;
     uint16_t CongestionControlAlgorithm;
     uint8_t MaxOperationsPerDrain;
-    uint8_t SendBufferingEnabled            : 1;
-    uint8_t PacingEnabled                   : 1;
-    uint8_t MigrationEnabled                : 1;
-    uint8_t DatagramReceiveEnabled          : 1;
-    uint8_t ServerResumptionLevel           : 2;    // QUIC_SERVER_RESUMPTION_LEVEL
-    uint8_t VersionNegotiationExtEnabled    : 1;
-    uint8_t GreaseQuicBitEnabled            : 1;
-    uint8_t EcnEnabled                      : 1;
-    uint8_t HyStartEnabled                  : 1;
-    uint8_t EncryptionOffloadAllowed        : 1;
-    uint8_t ReliableResetEnabled            : 1;
-    uint8_t OneWayDelayEnabled              : 1;
-    uint8_t NetStatsEventEnabled            : 1;
-    uint8_t StreamMultiReceiveEnabled       : 1;
-    uint8_t XdpEnabled                      : 1;
-    uint8_t QTIPEnabled                     : 1;
+    uint8_t SendBufferingEnabled;
+    uint8_t PacingEnabled;
+    uint8_t MigrationEnabled;
+    uint8_t DatagramReceiveEnabled;
+    uint8_t ServerResumptionLevel;          // QUIC_SERVER_RESUMPTION_LEVEL
+    uint8_t VersionNegotiationExtEnabled;
+    uint8_t GreaseQuicBitEnabled;
+    uint8_t EcnEnabled;
+    uint8_t HyStartEnabled;
+    uint8_t EncryptionOffloadAllowed;
+    uint8_t ReliableResetEnabled;
+    uint8_t OneWayDelayEnabled;
+    uint8_t NetStatsEventEnabled;
+    uint8_t StreamMultiReceiveEnabled;
+    uint8_t XdpEnabled;
+    uint8_t QTIPEnabled;
+    uint8_t RioEnabled;
+    uint8_t ControlFrameCoalescingEnabled;
+    uint8_t EncryptFromSendBuffersEnabled;
+    uint8_t StreamBatchReceiveEnabled;
+    uint8_t CarefulResumeEnabled;
     uint8_t MtuDiscoveryMissingProbeCount;
 } QUIC_SETTINGS_INTERNAL;
 
+//
+// A ref counted copy of settings, shared read-only by all the connections that
+// use it. A connection that needs different settings makes its own copy.
+//
+typedef struct QUIC_SHARED_SETTINGS {
+
+    CXPLAT_REF_COUNT RefCount;
+
+    QUIC_SETTINGS_INTERNAL Settings;
+
+} QUIC_SHARED_SETTINGS;
+
+//
+// Describes where a setting is stored and the range of values it accepts, so
+// that merging settings is a loop over the IsSet flags instead of per field
+// code. QuicSettingFields has one entry per IsSet flag, in the same order.
+//
+typedef struct QUIC_SETTING_FIELD {
+
+    uint16_t Offset;
+    uint8_t Size;
+    uint8_t Flags;  // QUIC_SETTING_FIELD_FLAG_*
+    uint64_t Min;
+    uint64_t Max;
+
+} QUIC_SETTING_FIELD;
+
+#define QUIC_SETTING_FIELD_FLAG_POW2    0x01    // Value must be a power of 2
+#define QUIC_SETTING_FIELD_FLAG_CUSTOM  0x02    // Copied and applied by hand
+
+extern const QUIC_SETTING_FIELD QuicSettingFields[QUIC_SETTINGS_COUNT];
+
 //
 // Initializes all settings to default values, if not already set by the app.
 //
@@ -162,6 +217,31 @@ QuicSettingsCleanup(
     _In_ QUIC_SETTINGS_INTERNAL* Settings
     );
 
+//
+// Allocates shared settings with a deep copy of Source, including its IsSet
+// flags, and a single reference.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SHARED_SETTINGS*
+QuicSharedSettingsAlloc(
+    _In_ const QUIC_SETTINGS_INTERNAL* Source
+    );
+
+QUIC_INLINE
+void
+QuicSharedSettingsAddRef(
+    _In_ QUIC_SHARED_SETTINGS* SharedSettings
+    )
+{
+    CxPlatRefIncrement(&SharedSettings->RefCount);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSharedSettingsRelease(
+    _In_ QUIC_SHARED_SETTINGS* SharedSettings
+    );
+
 //
 // Loads the settings from storage, if not already set by the app.
 //
@@ -27,12 +27,20 @@ QuicStreamInitialize(
 {
     QUIC_STATUS Status;
     QUIC_STREAM* Stream;
-    QUIC_RECV_CHUNK* PreallocatedRecvChunk = NULL;
+    QUIC_RECV_CHUNK* RecycledChunk;
 
-    Stream = CxPlatPoolAlloc(&Connection->Partition->StreamPool);
+    //
+    // Prefer a stream recently freed by the connection; it is still charged
+    // against the memory budget and may come with a receive chunk.
+    //
+    Stream = QuicStreamSetTakeRecycledStream(&Connection->Streams, &RecycledChunk);
     if (Stream == NULL) {
-        Status = QUIC_STATUS_OUT_OF_MEMORY;
-        goto Exit;
+        Stream = CxPlatPoolAlloc(&Connection->Partition->StreamPool);
+        if (Stream == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+        QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_STREAM, sizeof(QUIC_STREAM));
     }
 
     QuicTraceEvent(
@@ -66,18 +74,13 @@ QuicStreamInitialize(
     Stream->Flags.SendEnabled = TRUE;
     Stream->Flags.ReceiveEnabled = TRUE;
     Stream->Flags.UseAppOwnedRecvBuffers = !!(Flags & QUIC_STREAM_OPEN_FLAG_APP_OWNED_BUFFERS);
-    //
-    // A stream doesn't support ReceiveMultiple and AppOwnedRecvBuffer simultaneously.
-    // AppOwnedRecvBuffer is stream specific and takes precedence of the
-    // connection-wide ReceiveMultiple setting.
-    //
-    Stream->Flags.ReceiveMultiple =
-        Connection->Settings.StreamMultiReceiveEnabled &&
-        !Stream->Flags.UseAppOwnedRecvBuffers;
+    Stream->Flags.ReceiveMultiple = Connection->Settings->StreamMultiReceiveEnabled;
     Stream->RecvMaxLength = UINT64_MAX;
     CxPlatRefInitialize(&Stream->RefCount);
     Stream->SendRequestsTail = &Stream->SendRequests;
     Stream->SendPriority = QUIC_STREAM_PRIORITY_DEFAULT;
+    Stream->SendUrgency = QUIC_STREAM_URGENCY_DEFAULT;
+    Stream->SendWeight = QUIC_STREAM_WEIGHT_DEFAULT;
     CxPlatDispatchLockInitialize(&Stream->ApiSendRequestLock);
     CxPlatRefInitialize(&Stream->RefCount);
     QuicRangeInitialize(
@@ -120,35 +123,22 @@ QuicStreamInitialize(
         }
     }
 
-    const uint32_t InitialRecvBufferLength = Connection->Settings.StreamRecvBufferDefault;
+    const uint32_t InitialRecvBufferLength = Connection->Settings->StreamRecvBufferDefault;
 
     QUIC_RECV_BUF_MODE RecvBufferMode = QUIC_RECV_BUF_MODE_CIRCULAR;
     if (Stream->Flags.UseAppOwnedRecvBuffers) {
-        RecvBufferMode = QUIC_RECV_BUF_MODE_APP_OWNED;
+        RecvBufferMode =
+            Stream->Flags.ReceiveMultiple ?
+                QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE : QUIC_RECV_BUF_MODE_APP_OWNED;
     } else if (Stream->Flags.ReceiveMultiple) {
         RecvBufferMode = QUIC_RECV_BUF_MODE_MULTIPLE;
     }
 
-    if (InitialRecvBufferLength == QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE &&
-        RecvBufferMode != QUIC_RECV_BUF_MODE_APP_OWNED) {
-        PreallocatedRecvChunk =
-            CxPlatPoolAlloc(&Connection->Partition->DefaultReceiveBufferPool);
-        if (PreallocatedRecvChunk == NULL) {
-            Status = QUIC_STATUS_OUT_OF_MEMORY;
-            goto Exit;
-        }
-        QuicRecvChunkInitialize(
-            PreallocatedRecvChunk,
-            InitialRecvBufferLength,
-            (uint8_t *)(PreallocatedRecvChunk + 1),
-            TRUE);
-    }
-
     const uint32_t FlowControlWindowSize = Stream->Flags.Unidirectional
-        ? Connection->Settings.StreamRecvWindowUnidiDefault
+        ? Connection->Settings->StreamRecvWindowUnidiDefault
         : OpenedRemotely
-            ? Connection->Settings.StreamRecvWindowBidiRemoteDefault
-            : Connection->Settings.StreamRecvWindowBidiLocalDefault;
+            ? Connection->Settings->StreamRecvWindowBidiRemoteDefault
+            : Connection->Settings->StreamRecvWindowBidiLocalDefault;
 
     Status =
         QuicRecvBufferInitialize(
@@ -156,11 +146,21 @@ QuicStreamInitialize(
             InitialRecvBufferLength,
             FlowControlWindowSize,
             RecvBufferMode,
-            PreallocatedRecvChunk);
+            Connection->Partition->RecvChunkPools,
+            TRUE);
     if (QUIC_FAILED(Status)) {
         goto Exit;
     }
 
+    if (RecycledChunk != NULL) {
+        if (Stream->Flags.ReceiveEnabled) {
+            QuicRecvBufferAttachChunk(&Stream->RecvBuffer, RecycledChunk);
+        } else {
+            QuicRecvChunkFree(RecycledChunk);
+        }
+        RecycledChunk = NULL;
+    }
+
     Stream->MaxAllowedRecvOffset = Stream->RecvBuffer.VirtualBufferLength;
     Stream->RecvWindowLastUpdate = CxPlatTimeUs64();
 
@@ -169,10 +169,13 @@ QuicStreamInitialize(
     Stream->Flags.Initialized = TRUE;
     *NewStream = Stream;
     Stream = NULL;
-    PreallocatedRecvChunk = NULL;
 
 Exit:
 
+    if (RecycledChunk != NULL) {
+        QuicRecvChunkFree(RecycledChunk);
+    }
+
     if (Stream) {
 #if DEBUG
         CXPLAT_DBG_ASSERT(!CxPlatRefDecrement(&Stream->RefTypeBiasedCount[QUIC_STREAM_REF_APP]));
@@ -182,13 +185,11 @@ Exit:
         CxPlatDispatchLockRelease(&Connection->Streams.AllStreamsLock);
 #endif
         QuicPerfCounterDecrement(Connection->Partition, QUIC_PERF_COUNTER_STRM_ACTIVE);
+        QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_STREAM, -(int64_t)sizeof(QUIC_STREAM));
         CxPlatDispatchLockUninitialize(&Stream->ApiSendRequestLock);
         Stream->Flags.Freed = TRUE;
         CxPlatPoolFree(Stream);
     }
-    if (PreallocatedRecvChunk) {
-        CxPlatPoolFree(PreallocatedRecvChunk);
-    }
 
     return Status;
 }
@@ -223,13 +224,28 @@ QuicStreamFree(
 #endif
     QuicPerfCounterDecrement(Connection->Partition, QUIC_PERF_COUNTER_STRM_ACTIVE);
 
+    //
+    // While the connection is still in use, keep the stream, with its receive
+    // chunk if it is still the initial size, for the connection's next stream.
+    //
+    const BOOLEAN Recycle = !QuicConnIsClosed(Connection);
+    QUIC_RECV_CHUNK* RecycledChunk =
+        Recycle ?
+            QuicRecvBufferDetachChunk(
+                &Stream->RecvBuffer, Connection->Settings->StreamRecvBufferDefault) :
+            NULL;
+
     QuicRecvBufferUninitialize(&Stream->RecvBuffer);
     QuicRangeUninitialize(&Stream->SparseAckRanges);
     CxPlatDispatchLockUninitialize(&Stream->ApiSendRequestLock);
     CxPlatRefUninitialize(&Stream->RefCount);
 
     Stream->Flags.Freed = TRUE;
-    CxPlatPoolFree(Stream);
+    if (!Recycle ||
+        !QuicStreamSetRecycleStream(&Connection->Streams, Stream, RecycledChunk)) {
+        QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_STREAM, -(int64_t)sizeof(QUIC_STREAM));
+        CxPlatPoolFree(Stream);
+    }
 
     if (WasStarted) {
 #pragma warning(push)
@@ -289,6 +305,9 @@ QuicStreamStart(
 
     Stream->Flags.Started = TRUE;
     Stream->Flags.IndicatePeerAccepted = !!(Flags & QUIC_STREAM_START_FLAG_INDICATE_PEER_ACCEPT);
+    if (Stream->Flags.UseAppOwnedRecvBuffers) {
+        Stream->Connection->State.AppOwnedRecvBuffers = TRUE;
+    }
 
     //
     // Cache flow blocked timings on connection so that the queried blocked timings only
@@ -382,6 +401,69 @@ Exit:
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamStartBatch(
+    _In_reads_(StreamCount) QUIC_STREAM** Streams,
+    _In_ uint32_t StreamCount,
+    _In_ QUIC_STREAM_START_FLAGS Flags
+    )
+{
+    CXPLAT_DBG_ASSERT(StreamCount != 0);
+    QUIC_CONNECTION* Connection = Streams[0]->Connection;
+
+    if ((Flags & QUIC_STREAM_START_FLAG_FAIL_BLOCKED) &&
+        !Connection->State.ClosedLocally &&
+        !Connection->State.ClosedRemotely) {
+        //
+        // Either the whole batch fits in the peer's stream limit or none of it
+        // is started, so a fan-out never goes out half started.
+        //
+        uint8_t Type =
+            QuicConnIsServer(Connection) ?
+                STREAM_ID_FLAG_IS_SERVER :
+                STREAM_ID_FLAG_IS_CLIENT;
+        if (Streams[0]->Flags.Unidirectional) {
+            Type |= STREAM_ID_FLAG_IS_UNI_DIR;
+        }
+
+        const uint16_t Available =
+            QuicStreamSetGetCountAvailable(&Connection->Streams, Type);
+        if (Available < UINT16_MAX && StreamCount > Available) {
+            if (Connection->State.PeerTransportParameterValid) {
+                QuicSendSetSendFlag(
+                    &Connection->Send,
+                    STREAM_ID_IS_UNI_DIR(Type) ?
+                        QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED : QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED);
+            }
+            for (uint32_t i = 0; i < StreamCount; ++i) {
+                QuicStreamIndicateStartComplete(Streams[i], QUIC_STATUS_STREAM_LIMIT_REACHED);
+                if (Flags & QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL) {
+                    QuicStreamShutdown(
+                        Streams[i],
+                        QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
+                        0);
+                }
+            }
+            goto Flush;
+        }
+    }
+
+    //
+    // Nothing else runs on the connection in between, so the streams get
+    // consecutive IDs.
+    //
+    for (uint32_t i = 0; i < StreamCount; ++i) {
+        (void)QuicStreamStart(Streams[i], Flags, FALSE);
+    }
+
+Flush:
+
+    for (uint32_t i = 0; i < StreamCount; ++i) {
+        QuicStreamSendFlush(Streams[i]);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamClose(
@@ -463,6 +545,13 @@ QuicStreamIndicateEvent(
 {
     CXPLAT_PASSIVE_CODE();
     QUIC_STATUS Status;
+
+    //
+    // The app may read or shut down streams from the callback, so any pending
+    // received stream data must be written first.
+    //
+    QuicStreamRecvRunFlush(&Stream->Connection->RecvRun);
+
     if (Stream->ClientCallbackHandler != NULL) {
         //
         // MsQuic shouldn't indicate reentrancy to the app when at all
@@ -674,6 +763,7 @@ QuicStreamParamSet(
         }
 
         if (Stream->SendPriority != *(uint16_t*)Buffer) {
+            uint16_t OldPriority = Stream->SendPriority;
             Stream->SendPriority = *(uint16_t*)Buffer;
 
             QuicTraceLogStreamInfo(
@@ -686,7 +776,7 @@ QuicStreamParamSet(
                 //
                 // Update the stream's place in the send queue if necessary.
                 //
-                QuicSendUpdateStreamPriority(&Stream->Connection->Send, Stream);
+                QuicSendUpdateStreamPriority(&Stream->Connection->Send, Stream, OldPriority);
             }
         }
 
@@ -694,6 +784,104 @@ QuicStreamParamSet(
         break;
     }
 
+    case QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY: {
+
+        if (BufferLength != sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_STREAM_EXTENSIBLE_PRIORITY* Priority =
+            (const QUIC_STREAM_EXTENSIBLE_PRIORITY*)Buffer;
+        if (Priority->Urgency > QUIC_STREAM_URGENCY_MAX) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        uint16_t OldPriority = Stream->SendPriority;
+        Stream->SendUrgency = Priority->Urgency;
+        Stream->Flags.SendIncremental = !!Priority->Incremental;
+        Stream->SendPriority =
+            QUIC_STREAM_URGENCY_TO_PRIORITY(
+                Stream->SendUrgency,
+                Stream->Flags.SendIncremental);
+
+        QuicTraceLogStreamInfo(
+            UpdatePriority,
+            Stream,
+            "New send priority = %hu",
+            Stream->SendPriority);
+
+        if (Stream->SendPriority != OldPriority &&
+            Stream->Flags.Started && Stream->SendFlags != 0) {
+            //
+            // Update the stream's place in the send queue if necessary.
+            //
+            QuicSendUpdateStreamPriority(&Stream->Connection->Send, Stream, OldPriority);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_STREAM_WEIGHT:
+
+        if (BufferLength != sizeof(Stream->SendWeight) || Buffer == NULL ||
+            *(uint16_t*)Buffer == 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Stream->SendWeight = *(uint16_t*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING:
+
+        if (BufferLength != sizeof(Stream->SendLatencySampleInterval) ||
+            Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Stream->SendLatencySampleInterval = *(uint32_t*)Buffer;
+        Stream->SendLatencySampleCount = 0;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_STREAM_SEND_TIMEOUT:
+
+        if (BufferLength != sizeof(Stream->SendTimeoutMs) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Stream->SendTimeoutMs = *(uint32_t*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_STREAM_SEND_RATE_LIMIT:
+
+        if (BufferLength != sizeof(uint64_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QuicSendRateLimitSet(
+            &Stream->SendRateLimit, *(uint64_t*)Buffer, CxPlatTimeUs64());
+        if (Stream->SendRateLimit.Rate != 0) {
+            Stream->Connection->Send.StreamRateLimitsSet = TRUE;
+        }
+        if (Stream->SendLink.Flink != NULL) {
+            QuicSendQueueFlush(&Stream->Connection->Send, REASON_STREAM_FLAGS);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
    case QUIC_PARAM_STREAM_RELIABLE_OFFSET:
 
         if (BufferLength != sizeof(uint64_t) || Buffer == NULL) {
@@ -854,6 +1042,105 @@ QuicStreamParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY: {
+
+        if (*BufferLength < sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY)) {
+            *BufferLength = sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QUIC_STREAM_EXTENSIBLE_PRIORITY* Priority =
+            (QUIC_STREAM_EXTENSIBLE_PRIORITY*)Buffer;
+        *BufferLength = sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY);
+        Priority->Urgency = Stream->SendUrgency;
+        Priority->Incremental = Stream->Flags.SendIncremental;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_STREAM_WEIGHT:
+
+        if (*BufferLength < sizeof(Stream->SendWeight)) {
+            *BufferLength = sizeof(Stream->SendWeight);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(Stream->SendWeight);
+        *(uint16_t*)Buffer = Stream->SendWeight;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING:
+
+        if (*BufferLength < sizeof(Stream->SendLatencySampleInterval)) {
+            *BufferLength = sizeof(Stream->SendLatencySampleInterval);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(Stream->SendLatencySampleInterval);
+        *(uint32_t*)Buffer = Stream->SendLatencySampleInterval;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_STREAM_SEND_TIMEOUT:
+
+        if (*BufferLength < sizeof(Stream->SendTimeoutMs)) {
+            *BufferLength = sizeof(Stream->SendTimeoutMs);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(Stream->SendTimeoutMs);
+        *(uint32_t*)Buffer = Stream->SendTimeoutMs;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_STREAM_SEND_RATE_LIMIT:
+
+        if (*BufferLength < sizeof(Stream->SendRateLimit.Rate)) {
+            *BufferLength = sizeof(Stream->SendRateLimit.Rate);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(Stream->SendRateLimit.Rate);
+        *(uint64_t*)Buffer = Stream->SendRateLimit.Rate;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     case QUIC_PARAM_STREAM_STATISTICS: {
 
         if (*BufferLength < sizeof(QUIC_STREAM_STATISTICS)) {
@@ -983,8 +1270,8 @@ QuicStreamSwitchToAppOwnedBuffers(
     //
     const uint32_t InitialControlFlow = Stream->RecvBuffer.VirtualBufferLength;
     CXPLAT_DBG_ASSERT(
-        InitialControlFlow == Stream->Connection->Settings.StreamRecvWindowBidiRemoteDefault ||
-        InitialControlFlow == Stream->Connection->Settings.StreamRecvWindowUnidiDefault);
+        InitialControlFlow == Stream->Connection->Settings->StreamRecvWindowBidiRemoteDefault ||
+        InitialControlFlow == Stream->Connection->Settings->StreamRecvWindowUnidiDefault);
 
     //
     // Reset the current receive buffer
@@ -998,9 +1285,12 @@ QuicStreamSwitchToAppOwnedBuffers(
         &Stream->RecvBuffer,
         0,
         InitialControlFlow,
-        QUIC_RECV_BUF_MODE_APP_OWNED,
-        NULL);
+        Stream->Flags.ReceiveMultiple ?
+            QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE : QUIC_RECV_BUF_MODE_APP_OWNED,
+        NULL,
+        FALSE);
     Stream->Flags.UseAppOwnedRecvBuffers = TRUE;
+    Stream->Connection->State.AppOwnedRecvBuffers = TRUE;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -1038,7 +1328,7 @@ QuicStreamNotifyReceiveBufferNeeded(
     _In_ uint64_t BufferLengthNeeded
     )
 {
-    CXPLAT_DBG_ASSERT(Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
+    CXPLAT_DBG_ASSERT(QuicRecvBufferIsAppOwned(&Stream->RecvBuffer));
 
     QUIC_STREAM_EVENT Event = {0};
     Event.Type = QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED;
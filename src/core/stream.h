@@ -45,14 +45,32 @@ typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 // Internal send flags. The public ones are defined in msquic.h.
 //
 #define QUIC_SEND_FLAG_BUFFERED     ((QUIC_SEND_FLAGS)0x80000000)
+#define QUIC_SEND_FLAG_FROM_FILE    ((QUIC_SEND_FLAGS)0x40000000) // Data is read from File when framed.
 
 #define QUIC_SEND_FLAGS_INTERNAL \
 ( \
-    QUIC_SEND_FLAG_BUFFERED \
+    QUIC_SEND_FLAG_BUFFERED | \
+    QUIC_SEND_FLAG_FROM_FILE \
 )
 
 #define QUIC_STREAM_PRIORITY_DEFAULT 0x7FFF // Medium priority by default
 
+#define QUIC_STREAM_WEIGHT_DEFAULT  16      // Used by the weighted scheduling scheme
+
+#define QUIC_STREAM_URGENCY_DEFAULT 3       // RFC 9218 default urgency
+#define QUIC_STREAM_URGENCY_MAX     7
+
+//
+// Maps an RFC 9218 urgency to a send priority, with the default urgency on the
+// default priority. Non-incremental streams sort just ahead of incremental
+// streams of the same urgency so that each priority level is uniformly one or
+// the other.
+//
+#define QUIC_STREAM_URGENCY_TO_PRIORITY(Urgency, Incremental) \
+    ((uint16_t)(QUIC_STREAM_PRIORITY_DEFAULT + \
+        ((int32_t)QUIC_STREAM_URGENCY_DEFAULT - (int32_t)(Urgency)) * 0x1000 - \
+        ((Incremental) ? 1 : 0)))
+
 //
 // Tracks the data queued up for sending by an application.
 //
@@ -90,15 +108,39 @@ typedef struct QUIC_SEND_REQUEST {
     uint64_t TotalLength;
 
     //
-    // Data descriptor for buffered requests.
+    // Data descriptor for buffered requests. File backed requests only use its
+    // length, as a single buffer without data.
     //
     QUIC_BUFFER InternalBuffer;
 
+#ifndef _KERNEL_MODE
+    //
+    // Where the data of a QUIC_SEND_FLAG_FROM_FILE request is read from.
+    //
+    QUIC_FILE_HANDLE File;
+    uint64_t FileOffset;
+#endif
+
     //
     // API Client completion context.
     //
     void* ClientContext;
 
+    //
+    // When the app queued the request, in microseconds.
+    //
+    uint64_t QueueTime;
+
+    //
+    // Lifecycle timestamps, in microseconds, only tracked for requests sampled
+    // by QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING.
+    //
+    BOOLEAN Sampled;
+    uint64_t EnqueueTime;
+    uint64_t FirstFramedTime;
+    uint64_t LastFramedTime;
+    uint64_t CompleteTime;
+
 } QUIC_SEND_REQUEST;
 
 //
@@ -158,7 +200,10 @@ typedef union QUIC_STREAM_FLAGS {
 
         BOOLEAN InStreamTable           : 1;    // The stream is currently in the connection's table.
         BOOLEAN InWaitingList           : 1;    // The stream is currently in the waiting list for stream id FC.
+        BOOLEAN InRecvFlushList         : 1;    // The stream is queued for a batched receive indication.
         BOOLEAN DelayIdFcUpdate         : 1;    // Delay stream ID FC updates to StreamClose.
+        BOOLEAN SendIncremental         : 1;    // Send data is interleaved with streams of the same urgency.
+        BOOLEAN SendFileFailed          : 1;    // A file backed send couldn't be read; sending is aborted.
     };
 } QUIC_STREAM_FLAGS;
 
@@ -260,6 +305,12 @@ typedef struct QUIC_STREAM {
     //
     CXPLAT_LIST_ENTRY SendLink;
 
+    //
+    // The list entry in the stream set's list of streams waiting for a batched
+    // receive indication.
+    //
+    CXPLAT_LIST_ENTRY RecvFlushLink;
+
 #if DEBUG
     //
     // The list entry in the stream set's list of all allocated streams.
@@ -398,6 +449,42 @@ typedef struct QUIC_STREAM {
     //
     uint16_t SendPriority;
 
+    //
+    // The RFC 9218 urgency last set by the application. SendPriority is
+    // derived from it when set.
+    //
+    uint8_t SendUrgency;
+
+    //
+    // The relative share of the connection's send bandwidth this stream gets
+    // among streams of the same priority, in the weighted scheduling scheme.
+    //
+    uint16_t SendWeight;
+
+    //
+    // The deficit round robin credit, in bytes, left for the stream's current
+    // turn. Negative when the last packet overshot it.
+    //
+    int32_t SendDeficit;
+
+    //
+    // One in this many send requests has its latency traced and indicated
+    // with QUIC_STREAM_EVENT_SEND_LATENCY. Zero disables tracing.
+    //
+    uint32_t SendLatencySampleInterval;
+    uint32_t SendLatencySampleCount;
+
+    //
+    // Lost data from send requests queued longer than this, in milliseconds,
+    // isn't retransmitted; the stream is reset instead. Zero disables it.
+    //
+    uint32_t SendTimeoutMs;
+
+    //
+    // The application configured limit on the rate new data is sent at.
+    //
+    QUIC_SEND_RATE_LIMIT SendRateLimit;
+
     //
     // Recv State
     //
@@ -543,6 +630,16 @@ QuicStreamRecvGetState(
     }
 }
 
+//
+// Returns how long, in microseconds, the stream's send rate limit holds off
+// its pending new data, or zero if it doesn't.
+//
+uint64_t
+QuicStreamSendGetRateLimitDelay(
+    _In_ const QUIC_STREAM* Stream,
+    _In_ uint64_t TimeNow
+    );
+
 //
 // Returns TRUE if the stream has anything to send.
 //
@@ -620,6 +717,18 @@ QuicStreamStart(
     _In_ BOOLEAN IsRemoteStream
     );
 
+//
+// Starts a batch of new local streams of the same type, assigning them
+// consecutive IDs, and then flushes any sends queued on them.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamStartBatch(
+    _In_reads_(StreamCount) QUIC_STREAM** Streams,
+    _In_ uint32_t StreamCount,
+    _In_ QUIC_STREAM_START_FLAGS Flags
+    );
+
 //
 // Releases the application's reference on the stream.
 //
@@ -1010,6 +1119,40 @@ QuicStreamReceiveCompletePending(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Tracks contiguous STREAM frames for a single stream whose data has already
+// been copied into the stream's receive buffer, but which haven't been
+// written (i.e. recorded, flow controlled and indicated) yet. This allows a
+// batch of received packets to apply all the frames with a single write.
+//
+typedef struct QUIC_STREAM_RECV_RUN {
+
+    //
+    // The stream the pending frames belong to. NULL if nothing is pending.
+    //
+    QUIC_STREAM* Stream;
+
+    //
+    // The stream offset of the first pending byte.
+    //
+    uint64_t Offset;
+
+    //
+    // The number of pending bytes.
+    //
+    uint16_t Length;
+
+} QUIC_STREAM_RECV_RUN;
+
+//
+// Writes any pending frames in the run to the stream's receive buffer.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamRecvRunFlush(
+    _Inout_ QUIC_STREAM_RECV_RUN* Run
+    );
+
 //
 // Processes a received frame for the given stream.
 //
@@ -1026,6 +1169,22 @@ QuicStreamRecv(
     _Inout_ BOOLEAN* UpdatedFlowControl
     );
 
+//
+// Checks whether the (not yet authenticated) data of a STREAM frame may be
+// decrypted straight into the stream's app-owned receive buffer, and if so,
+// gets the buffer space to decrypt it to.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamRecvGetPlacement(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t Offset,
+    _In_ uint16_t Length,
+    _Inout_ uint32_t* BufferCount,
+    _Out_writes_to_(*BufferCount, *BufferCount)
+        QUIC_BUFFER* Buffers
+    );
+
 //
 // Processes queued events and delivers them to the API client.
 //
@@ -1035,6 +1194,26 @@ QuicStreamRecvFlush(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Indicates receive data for a batch of the connection's queued streams in a
+// single QUIC_CONNECTION_EVENT_STREAMS_RECEIVE event. Returns TRUE if no
+// streams are left queued.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamRecvFlushBatch(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Releases all streams still queued for a batched receive indication.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamRecvFlushBatchCancel(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Enables or disables receive callbacks for the stream.
 //
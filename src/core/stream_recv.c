@@ -118,6 +118,64 @@ Exit:
     }
 }
 
+//
+// Streams using the default (circular) receive mode may have their data
+// indicated in a batched QUIC_CONNECTION_EVENT_STREAMS_RECEIVE event, if the
+// app opted in.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicStreamRecvCanBatchFlush(
+    _In_ const QUIC_STREAM* Stream
+    )
+{
+    const QUIC_CONNECTION* Connection = Stream->Connection;
+    return
+        Connection->Settings->StreamBatchReceiveEnabled &&
+        Connection->ClientCallbackHandler != NULL &&
+        !Connection->State.ShutdownComplete &&
+        Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_CIRCULAR &&
+        !Stream->Flags.HandleClosed;
+}
+
+//
+// Adds the stream to the connection's list of streams waiting for a batched
+// receive indication, queuing the flush operation if needed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicStreamRecvQueueBatchFlush(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    QUIC_STREAM_SET* StreamSet = &Stream->Connection->Streams;
+
+    if (!StreamSet->RecvFlushQueued) {
+        QUIC_OPERATION* Oper;
+        if ((Oper = QuicConnAllocOperation(Stream->Connection, QUIC_OPER_TYPE_FLUSH_STREAMS_RECV)) == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Flush Streams Recv operation",
+                0);
+            return;
+        }
+        QuicConnQueueOper(Stream->Connection, Oper);
+        StreamSet->RecvFlushQueued = TRUE;
+    }
+
+    QuicTraceLogStreamVerbose(
+        QueueRecvBatchFlush,
+        Stream,
+        "Queuing batched recv flush");
+
+    CxPlatListInsertTail(&StreamSet->RecvFlushStreams, &Stream->RecvFlushLink);
+    QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+    Stream->Flags.InRecvFlushList = TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamRecvQueueFlush(
@@ -134,6 +192,11 @@ QuicStreamRecvQueueFlush(
         if (AllowInlineFlush) {
             QuicStreamRecvFlush(Stream);
 
+        } else if (QuicStreamRecvCanBatchFlush(Stream)) {
+            if (!Stream->Flags.InRecvFlushList) {
+                QuicStreamRecvQueueBatchFlush(Stream);
+            }
+
         } else if (!Stream->Flags.ReceiveFlushQueued) {
             QuicTraceLogStreamVerbose(
                 QueueRecvFlush,
@@ -502,7 +565,7 @@ QuicStreamProcessStreamFrame(
                 &ReadyToDeliver,
                 &BufferSizeNeeded);
 
-        if (BufferSizeNeeded > 0 && Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        if (BufferSizeNeeded > 0 && QuicRecvBufferIsAppOwned(&Stream->RecvBuffer)) {
             CXPLAT_DBG_ASSERT(Status == QUIC_STATUS_BUFFER_TOO_SMALL);
 
             //
@@ -576,7 +639,7 @@ QuicStreamProcessStreamFrame(
     }
 
     if (ReadyToDeliver &&
-        (Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE ||
+        (QuicRecvBufferIsMultiple(&Stream->RecvBuffer) ||
          Stream->RecvBuffer.ReadPendingLength == 0)) {
         Stream->Flags.ReceiveDataPending = TRUE;
         QuicStreamRecvQueueFlush(
@@ -611,6 +674,131 @@ Error:
     return Status;
 }
 
+//
+// Tries to add a STREAM frame to the connection's pending receive run instead
+// of writing it to the receive buffer right away. Only frames that extend the
+// run with new, in-order data that is guaranteed to be written successfully
+// are added; their data is copied into the (unwritten) receive buffer space
+// immediately so the packet buffer doesn't need to be kept around.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamRecvRunAppend(
+    _Inout_ QUIC_STREAM_RECV_RUN* Run,
+    _In_ QUIC_STREAM* Stream,
+    _In_ BOOLEAN EncryptedWith0Rtt,
+    _In_ const QUIC_STREAM_EX* Frame
+    )
+{
+    if (EncryptedWith0Rtt ||
+        Frame->Fin ||
+        Frame->Length == 0 ||
+        Stream->Flags.RemoteNotAllowed ||
+        Stream->Flags.RemoteCloseFin ||
+        Stream->Flags.RemoteCloseReset ||
+        Stream->Flags.RemoteCloseResetReliable ||
+        Stream->Flags.SentStopSending) {
+        return FALSE;
+    }
+
+    if (Run->Stream != NULL &&
+        (Run->Stream != Stream ||
+         Run->Offset + Run->Length != Frame->Offset ||
+         (uint32_t)Run->Length + Frame->Length > UINT16_MAX)) {
+        return FALSE;
+    }
+
+    //
+    // The write at flush time must not fail, so make sure it fits in the
+    // stream and connection flow control windows.
+    //
+    QUIC_RECV_BUFFER* RecvBuffer = &Stream->RecvBuffer;
+    const uint64_t EndOffset = Frame->Offset + Frame->Length;
+    const uint64_t TotalLength = QuicRecvBufferGetTotalLength(RecvBuffer);
+    if (EndOffset > Stream->RecvMaxLength ||
+        EndOffset > RecvBuffer->BaseOffset + RecvBuffer->VirtualBufferLength ||
+        (EndOffset > TotalLength &&
+         EndOffset - TotalLength >
+            Stream->Connection->Send.MaxData -
+            Stream->Connection->Send.OrderedStreamBytesReceived)) {
+        return FALSE;
+    }
+
+    if (Frame->Data != NULL) {
+        //
+        // Copy the data to where the write would put it. This also makes sure
+        // the space is already allocated and hasn't been written to, so that
+        // the write doesn't need to resize (which could fail) or move the
+        // buffer.
+        //
+        QUIC_BUFFER Buffers[QUIC_MAX_RECV_PLACEMENT_SEGMENTS];
+        uint32_t BufferCount = ARRAYSIZE(Buffers);
+        if (!QuicRecvBufferGetWriteBuffers(
+                RecvBuffer,
+                Frame->Offset,
+                (uint16_t)Frame->Length,
+                &BufferCount,
+                Buffers)) {
+            return FALSE;
+        }
+
+        const uint8_t* Data = Frame->Data;
+        for (uint32_t i = 0; i < BufferCount; ++i) {
+            CxPlatCopyMemory(Buffers[i].Buffer, Data, Buffers[i].Length);
+            Data += Buffers[i].Length;
+        }
+    }
+
+    if (Run->Stream == NULL) {
+        QuicStreamAddRef(Stream, QUIC_STREAM_REF_LOOKUP);
+        Run->Stream = Stream;
+        Run->Offset = Frame->Offset;
+        Run->Length = 0;
+    }
+    Run->Length += (uint16_t)Frame->Length;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamRecvRunFlush(
+    _Inout_ QUIC_STREAM_RECV_RUN* Run
+    )
+{
+    QUIC_STREAM* Stream = Run->Stream;
+    if (Stream == NULL) {
+        return;
+    }
+
+    //
+    // Clear the run first, as the write may indicate events to the app.
+    //
+    Run->Stream = NULL;
+
+    QUIC_STREAM_EX Frame;
+    Frame.Fin = FALSE;
+    Frame.ExplicitLength = TRUE;
+    Frame.StreamID = Stream->ID;
+    Frame.Offset = Run->Offset;
+    Frame.Length = Run->Length;
+    Frame.Data = NULL; // Already copied to the receive buffer.
+
+    QUIC_STATUS Status = QuicStreamProcessStreamFrame(Stream, FALSE, &Frame);
+
+    //
+    // All frames in the run were validated when they were added, so the write
+    // is not expected to fail. Flow control errors are already reported by the
+    // write itself.
+    //
+    CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status));
+    if (Status == QUIC_STATUS_OUT_OF_MEMORY) {
+        QuicConnTransportError(Stream->Connection, QUIC_ERROR_INTERNAL_ERROR);
+    }
+
+    QuicStreamRelease(Stream, QUIC_STREAM_REF_LOOKUP);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicStreamRecv(
@@ -748,6 +936,28 @@ QuicStreamRecv(
             return QUIC_STATUS_INVALID_PARAMETER;
         }
 
+        if (Packet->PlacedStreamDataLength != 0 &&
+            Frame.Data == Buffer + Packet->PlacedStreamDataOffset) {
+            //
+            // The data was already decrypted straight into the receive buffer,
+            // so only the write itself needs to be recorded.
+            //
+            CXPLAT_DBG_ASSERT(Frame.Length == Packet->PlacedStreamDataLength);
+            Frame.Data = NULL;
+        }
+
+        QUIC_STREAM_RECV_RUN* Run = &Stream->Connection->RecvRun;
+        if (QuicStreamRecvRunAppend(
+                Run, Stream, Packet->EncryptedWith0Rtt, &Frame)) {
+            Status = QUIC_STATUS_SUCCESS;
+            break;
+        }
+
+        //
+        // Anything pending for this stream must be written first.
+        //
+        QuicStreamRecvRunFlush(Run);
+
         Status =
             QuicStreamProcessStreamFrame(
                 Stream, Packet->EncryptedWith0Rtt, &Frame);
@@ -764,6 +974,38 @@ QuicStreamRecv(
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamRecvGetPlacement(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t Offset,
+    _In_ uint16_t Length,
+    _Inout_ uint32_t* BufferCount,
+    _Out_writes_to_(*BufferCount, *BufferCount)
+        QUIC_BUFFER* Buffers
+    )
+{
+    //
+    // Only place data that the STREAM frame processing is going to write to
+    // the receive buffer anyway.
+    //
+    if (!Stream->Flags.UseAppOwnedRecvBuffers ||
+        Stream->Flags.RemoteNotAllowed ||
+        Stream->Flags.RemoteCloseFin ||
+        Stream->Flags.RemoteCloseReset ||
+        Stream->Flags.SentStopSending) {
+        return FALSE;
+    }
+
+    return
+        QuicRecvBufferGetWriteBuffers(
+            &Stream->RecvBuffer,
+            Offset,
+            Length,
+            BufferCount,
+            Buffers);
+}
+
 //
 // Criteria for sending MAX_DATA/MAX_STREAM_DATA frames:
 //
@@ -775,6 +1017,108 @@ QuicStreamRecv(
 // when many short streams are used, in which case we might never actually send a
 // MAX_STREAM_DATA update since each stream's entire payload fits in the initial window.
 //
+// The connection window is tuned the same way as the stream windows: if a quarter of it
+// is delivered within about one RTT, it is doubled, up to ConnFlowControlWindowMax and
+// as long as the library wide autotuning memory budget allows.
+//
+// Both frames are also sent early, when the credit the peer has left would run out
+// within about one RTT at the rate bytes have been delivered since the last update.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnOnOrderedBytesDelivered(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t BytesDelivered
+    )
+{
+    QUIC_SEND* Send = &Connection->Send;
+    const uint64_t RecvWindowDrainThreshold =
+        Send->RecvWindow / QUIC_RECV_BUFFER_DRAIN_RATIO;
+
+    Send->OrderedStreamBytesDeliveredAccumulator += BytesDelivered;
+    if (Send->OrderedStreamBytesDeliveredAccumulator < RecvWindowDrainThreshold) {
+        //
+        // Don't wait for the threshold if, at the rate data is being delivered,
+        // the peer would block on the MAX_DATA it has before a new one reaches
+        // it. This only advertises credit already allowed, so the window and
+        // its tuning are left alone.
+        //
+        if (Send->MaxData > Send->MaxDataSent &&
+            !(Send->SendFlags & QUIC_CONN_SEND_FLAG_MAX_DATA) &&
+            QuicSendPeerCreditRunningOut(
+                Send->MaxDataSent > Send->OrderedStreamBytesReceived ?
+                    Send->MaxDataSent - Send->OrderedStreamBytesReceived : 0,
+                Send->OrderedStreamBytesDeliveredAccumulator,
+                CxPlatTimeDiff64(Send->RecvWindowLastUpdate, CxPlatTimeUs64()),
+                Connection->Paths[0].SmoothedRtt)) {
+            (void)QuicSendSetSendFlagCoalesced(Send, QUIC_CONN_SEND_FLAG_MAX_DATA);
+        }
+        return;
+    }
+
+    uint64_t TimeNow = CxPlatTimeUs64();
+
+    if (Send->RecvWindow < Connection->Settings->ConnFlowControlWindowMax &&
+        !Send->Uninitialized) {
+
+        uint64_t TimeThreshold =
+            ((Send->OrderedStreamBytesDeliveredAccumulator * Connection->Paths[0].SmoothedRtt) / RecvWindowDrainThreshold);
+        if (CxPlatTimeDiff64(Send->RecvWindowLastUpdate, TimeNow) <= TimeThreshold) {
+
+            const uint32_t Increase =
+                CXPLAT_MIN(
+                    Send->RecvWindow,
+                    Connection->Settings->ConnFlowControlWindowMax - Send->RecvWindow);
+            if (QuicLibraryTryReserveRecvWindow(Increase)) {
+                Send->RecvWindow += Increase;
+                Send->RecvWindowGrowth += Increase;
+                Send->MaxData += Increase;
+
+                QuicTraceLogConnVerbose(
+                    IncreaseConnRecvWindow,
+                    Connection,
+                    "Increasing conn RX window to %u (SmoothedRtt=%llu; TimeNow=%llu; LastUpdate=%llu)",
+                    Send->RecvWindow,
+                    Connection->Paths[0].SmoothedRtt,
+                    TimeNow,
+                    Send->RecvWindowLastUpdate);
+            }
+        }
+    }
+
+    Send->RecvWindowLastUpdate = TimeNow;
+    Send->OrderedStreamBytesDeliveredAccumulator = 0;
+    (void)QuicSendSetSendFlagCoalesced(Send, QUIC_CONN_SEND_FLAG_MAX_DATA);
+}
+
+//
+// Returns TRUE if delivering data made room for more stream credit and, at the
+// rate data is being delivered, the peer would block on the MAX_STREAM_DATA it
+// has before a new one reaches it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicStreamRecvPeerCreditRunningOut(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (Stream->RecvBuffer.BaseOffset + Stream->RecvBuffer.VirtualBufferLength <=
+            Stream->MaxAllowedRecvOffset) {
+        return FALSE;
+    }
+
+    const uint64_t PeerOffset = QuicRecvBufferGetTotalLength(&Stream->RecvBuffer);
+    return
+        QuicSendPeerCreditRunningOut(
+            Stream->MaxAllowedRecvOffset > PeerOffset ?
+                Stream->MaxAllowedRecvOffset - PeerOffset : 0,
+            Stream->RecvWindowBytesDelivered,
+            CxPlatTimeDiff64(Stream->RecvWindowLastUpdate, CxPlatTimeUs64()),
+            Stream->Connection->Paths[0].SmoothedRtt);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamOnBytesDelivered(
@@ -787,27 +1131,21 @@ QuicStreamOnBytesDelivered(
 
     Stream->RecvWindowBytesDelivered += BytesDelivered;
     Stream->Connection->Send.MaxData += BytesDelivered;
-
-    Stream->Connection->Send.OrderedStreamBytesDeliveredAccumulator += BytesDelivered;
-    if (Stream->Connection->Send.OrderedStreamBytesDeliveredAccumulator >=
-        Stream->Connection->Settings.ConnFlowControlWindow / QUIC_RECV_BUFFER_DRAIN_RATIO) {
-        Stream->Connection->Send.OrderedStreamBytesDeliveredAccumulator = 0;
-        QuicSendSetSendFlag(
-            &Stream->Connection->Send,
-            QUIC_CONN_SEND_FLAG_MAX_DATA);
-    }
+    QuicConnOnOrderedBytesDelivered(Stream->Connection, BytesDelivered);
 
     if (Stream->RecvWindowBytesDelivered >= RecvBufferDrainThreshold) {
 
         uint64_t TimeNow = CxPlatTimeUs64();
 
         //
-        // Limit stream FC window growth by the connection FC window size.
+        // Limit stream FC window growth by the (current) connection FC window size.
         // When using app-owned buffers, skip this: the virtual buffer length is entirely based
-        // on the amount of buffer space provided by the app.
+        // on the amount of buffer space provided by the app. Don't grow at all while memory
+        // is under pressure.
         //
         if (Stream->RecvBuffer.VirtualBufferLength != 0 &&
-            Stream->RecvBuffer.VirtualBufferLength < Stream->Connection->Settings.ConnFlowControlWindow) {
+            Stream->RecvBuffer.VirtualBufferLength < Stream->Connection->Send.RecvWindow &&
+            QuicLibraryGetMemoryPressure() == QUIC_MEMORY_PRESSURE_NONE) {
 
             uint64_t TimeThreshold =
                 ((Stream->RecvWindowBytesDelivered * Stream->Connection->Paths[0].SmoothedRtt) / RecvBufferDrainThreshold);
@@ -850,11 +1188,12 @@ QuicStreamOnBytesDelivered(
         Stream->RecvWindowLastUpdate = TimeNow;
         Stream->RecvWindowBytesDelivered = 0;
 
-    } else if (!(Stream->Connection->Send.SendFlags & QUIC_CONN_SEND_FLAG_ACK)) {
+    } else if (!(Stream->Connection->Send.SendFlags & QUIC_CONN_SEND_FLAG_ACK) &&
+               !QuicStreamRecvPeerCreditRunningOut(Stream)) {
         //
         // We haven't hit the drain limit AND we don't have any ACKs to send
-        // immediately, so we don't need to immediately update the max stream data
-        // values.
+        // immediately AND the peer isn't about to block on the stream's credit,
+        // so we don't need to immediately update the max stream data values.
         //
         return;
     }
@@ -872,17 +1211,176 @@ QuicStreamOnBytesDelivered(
         Stream->RecvBuffer.BaseOffset + Stream->RecvBuffer.VirtualBufferLength >=
         Stream->MaxAllowedRecvOffset);
 
-    Stream->MaxAllowedRecvOffset =
-        Stream->RecvBuffer.BaseOffset + Stream->RecvBuffer.VirtualBufferLength;
+    //
+    // While memory is under pressure, only advertise part of the buffer so the
+    // peer slows down. Credit already given can't be taken back. Apps own the
+    // buffers in app-owned mode, so they are always advertised in full.
+    //
+    uint64_t WindowLength = Stream->RecvBuffer.VirtualBufferLength;
+    if (!QuicRecvBufferIsAppOwned(&Stream->RecvBuffer)) {
+        const QUIC_MEMORY_PRESSURE Pressure = QuicLibraryGetMemoryPressure();
+        if (Pressure == QUIC_MEMORY_PRESSURE_CRITICAL) {
+            WindowLength /= QUIC_RECV_BUFFER_DRAIN_RATIO;
+        } else if (Pressure == QUIC_MEMORY_PRESSURE_HIGH) {
+            WindowLength /= 2;
+        }
+    }
 
-    QuicSendSetSendFlag(
-        &Stream->Connection->Send,
-        QUIC_CONN_SEND_FLAG_MAX_DATA);
+    if (Stream->MaxAllowedRecvOffset < Stream->RecvBuffer.BaseOffset + WindowLength) {
+        Stream->MaxAllowedRecvOffset = Stream->RecvBuffer.BaseOffset + WindowLength;
+    }
+
+    //
+    // When coalescing, the MAX_DATA/MAX_STREAM_DATA frames wait for the pending
+    // delayed ACK instead of triggering a packet of their own.
+    //
+    const BOOLEAN Coalesced =
+        QuicSendSetSendFlagCoalesced(
+            &Stream->Connection->Send,
+            QUIC_CONN_SEND_FLAG_MAX_DATA);
     QuicSendSetStreamSendFlag(
         &Stream->Connection->Send,
         Stream,
         QUIC_STREAM_SEND_FLAG_MAX_DATA,
-        FALSE);
+        Coalesced);
+}
+
+//
+// Reads the next available data (or just the FIN) of the stream for a receive
+// indication to the app, and marks the receive call as active. The caller
+// provides enough buffers for all the unread data.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicStreamRecvIndicationBegin(
+    _In_ QUIC_STREAM* Stream,
+    _Out_ uint64_t* AbsoluteOffset,
+    _Out_ uint64_t* TotalBufferLength,
+    _Inout_ uint32_t* BufferCount,
+    _Out_writes_to_(*BufferCount, *BufferCount)
+        QUIC_BUFFER* Buffers,
+    _Out_ QUIC_RECEIVE_FLAGS* Flags
+    )
+{
+    CXPLAT_DBG_ASSERT(!Stream->Flags.SentStopSending);
+
+    //
+    // Set the top bit of RecvCompletionLength to indicate that there is an active receive.
+    //
+    uint64_t RecvCompletionLength =
+        InterlockedOr64(
+            (int64_t*)&Stream->RecvCompletionLength,
+            QUIC_STREAM_RECV_COMPLETION_LENGTH_RECEIVE_CALL_ACTIVE_FLAG);
+    CXPLAT_DBG_ASSERT(RecvCompletionLength == 0 ||
+        QuicRecvBufferIsMultiple(&Stream->RecvBuffer));
+    UNREFERENCED_PARAMETER(RecvCompletionLength);
+
+    *TotalBufferLength = 0;
+    *Flags = QUIC_RECEIVE_FLAG_NONE;
+
+    if (QuicRecvBufferHasUnreadData(&Stream->RecvBuffer)) {
+        QuicRecvBufferRead(
+            &Stream->RecvBuffer,
+            AbsoluteOffset,
+            BufferCount,
+            Buffers);
+        for (uint32_t i = 0; i < *BufferCount; ++i) {
+            *TotalBufferLength += Buffers[i].Length;
+        }
+        CXPLAT_DBG_ASSERT(*TotalBufferLength != 0);
+
+        if (*AbsoluteOffset < Stream->RecvMax0RttLength) {
+            //
+            // This data includes data encrypted with 0-RTT key.
+            //
+            *Flags |= QUIC_RECEIVE_FLAG_0_RTT;
+
+            //
+            // TODO - Split mixed 0-RTT and 1-RTT data?
+            //
+        }
+
+        if (*AbsoluteOffset + *TotalBufferLength == Stream->RecvMaxLength) {
+            //
+            // This data goes all the way to the FIN.
+            //
+            *Flags |= QUIC_RECEIVE_FLAG_FIN;
+        }
+
+    } else {
+        //
+        // FIN only case.
+        //
+        *AbsoluteOffset = Stream->RecvMaxLength;
+        *BufferCount = 0;
+        *Flags |= QUIC_RECEIVE_FLAG_FIN; // TODO - 0-RTT flag?
+    }
+
+    Stream->Flags.ReceiveEnabled = Stream->Flags.ReceiveMultiple;
+    Stream->RecvPendingLength += *TotalBufferLength;
+    CXPLAT_DBG_ASSERT(Stream->RecvPendingLength <= Stream->RecvBuffer.ReadPendingLength);
+}
+
+//
+// Processes the app's result for a receive indication. Returns TRUE if the
+// stream should immediately indicate more data.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicStreamRecvIndicationComplete(
+    _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_STATUS Status,
+    _In_ uint64_t TotalBufferLength
+    )
+{
+    //
+    // Clear the active receive flag and the actual length.
+    //
+    uint64_t RecvCompletionLength =
+        InterlockedExchange64(
+            (int64_t*)&Stream->RecvCompletionLength,
+            0) &
+        ~QUIC_STREAM_RECV_COMPLETION_LENGTH_RECEIVE_CALL_ACTIVE_FLAG;
+
+    BOOLEAN FlushRecv;
+    if (Status == QUIC_STATUS_CONTINUE) {
+        CXPLAT_DBG_ASSERT(!Stream->Flags.SentStopSending);
+        RecvCompletionLength += TotalBufferLength;
+        FlushRecv = TRUE;
+        //
+        // The app has explicitly indicated it wants to continue to
+        // receive callbacks, even if all the data wasn't drained.
+        //
+        Stream->Flags.ReceiveEnabled = TRUE;
+
+    } else if (Status == QUIC_STATUS_PENDING) {
+        //
+        // The app called the receive complete API
+        // (inline or concurrently) before the callback returned if RecvCompletionLength is non-zero.
+        //
+        FlushRecv = (RecvCompletionLength != 0);
+
+    } else {
+        //
+        // All failure status returns shouldn't be used by the app are
+        // ignored. We fire a telemetry event and treat as success.
+        //
+        CXPLAT_TEL_ASSERTMSG_ARGS(
+            QUIC_SUCCEEDED(Status),
+            "App failed recv callback",
+            Stream->Connection->Registration->AppName,
+            Status, 0);
+        RecvCompletionLength += TotalBufferLength;
+        FlushRecv = TRUE;
+    }
+
+    if (FlushRecv) {
+        FlushRecv = QuicStreamReceiveComplete(Stream, RecvCompletionLength);
+    }
+
+    return FlushRecv;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -917,28 +1415,7 @@ QuicStreamRecvFlush(
 
     BOOLEAN FlushRecv = TRUE;
     while (FlushRecv) {
-        CXPLAT_DBG_ASSERT(!Stream->Flags.SentStopSending);
-
-        //
-        // Set the top bit of RecvCompletionLength to indicate that there is an active receive.
-        //
-        uint64_t RecvCompletionLength =
-            InterlockedOr64(
-                (int64_t*)&Stream->RecvCompletionLength,
-                QUIC_STREAM_RECV_COMPLETION_LENGTH_RECEIVE_CALL_ACTIVE_FLAG);
-        CXPLAT_DBG_ASSERT(RecvCompletionLength == 0 ||
-            Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE);
-
-        QUIC_STREAM_EVENT Event = {0};
-        Event.Type = QUIC_STREAM_EVENT_RECEIVE;
-        Event.RECEIVE.BufferCount = ARRAYSIZE(StackRecvBuffers);
-        Event.RECEIVE.Buffers = StackRecvBuffers;
-
-        //
-        // Try to read the next available buffers.
-        //
-        BOOLEAN DataAvailable = QuicRecvBufferHasUnreadData(&Stream->RecvBuffer);
-        if (DataAvailable) {
+        if (QuicRecvBufferHasUnreadData(&Stream->RecvBuffer)) {
             uint32_t NumBuffersNeeded = QuicRecvBufferReadBufferNeededCount(&Stream->RecvBuffer);
             if (NumBuffersNeeded > RecvBufferCount) {
                 //
@@ -956,50 +1433,20 @@ QuicStreamRecvFlush(
                     RecvBufferCount = NumBuffersNeeded;
                 }
             }
-
-            Event.RECEIVE.Buffers = RecvBuffers;
-            Event.RECEIVE.BufferCount = RecvBufferCount;
-
-            QuicRecvBufferRead(
-                &Stream->RecvBuffer,
-                &Event.RECEIVE.AbsoluteOffset,
-                &Event.RECEIVE.BufferCount,
-                RecvBuffers);
-            for (uint32_t i = 0; i < Event.RECEIVE.BufferCount; ++i) {
-                Event.RECEIVE.TotalBufferLength += Event.RECEIVE.Buffers[i].Length;
-            }
-            CXPLAT_DBG_ASSERT(Event.RECEIVE.TotalBufferLength != 0);
-
-            if (Event.RECEIVE.AbsoluteOffset < Stream->RecvMax0RttLength) {
-                //
-                // This data includes data encrypted with 0-RTT key.
-                //
-                Event.RECEIVE.Flags |= QUIC_RECEIVE_FLAG_0_RTT;
-
-                //
-                // TODO - Split mixed 0-RTT and 1-RTT data?
-                //
-            }
-
-            if (Event.RECEIVE.AbsoluteOffset + Event.RECEIVE.TotalBufferLength == Stream->RecvMaxLength) {
-                //
-                // This data goes all the way to the FIN.
-                //
-                Event.RECEIVE.Flags |= QUIC_RECEIVE_FLAG_FIN;
-            }
-
-        } else {
-            //
-            // FIN only case.
-            //
-            Event.RECEIVE.AbsoluteOffset = Stream->RecvMaxLength;
-            Event.RECEIVE.BufferCount = 0;
-            Event.RECEIVE.Flags |= QUIC_RECEIVE_FLAG_FIN; // TODO - 0-RTT flag?
         }
 
-        Stream->Flags.ReceiveEnabled = Stream->Flags.ReceiveMultiple;
-        Stream->RecvPendingLength += Event.RECEIVE.TotalBufferLength;
-        CXPLAT_DBG_ASSERT(Stream->RecvPendingLength <= Stream->RecvBuffer.ReadPendingLength);
+        QUIC_STREAM_EVENT Event = {0};
+        Event.Type = QUIC_STREAM_EVENT_RECEIVE;
+        Event.RECEIVE.Buffers = RecvBuffers;
+        Event.RECEIVE.BufferCount = RecvBufferCount;
+
+        QuicStreamRecvIndicationBegin(
+            Stream,
+            &Event.RECEIVE.AbsoluteOffset,
+            &Event.RECEIVE.TotalBufferLength,
+            &Event.RECEIVE.BufferCount,
+            RecvBuffers,
+            &Event.RECEIVE.Flags);
 
         QuicTraceEvent(
             StreamAppReceive,
@@ -1011,57 +1458,152 @@ QuicStreamRecvFlush(
 
         QUIC_STATUS Status = QuicStreamIndicateEvent(Stream, &Event);
 
-        //
-        // Clear the active receive flag and the actual length.
-        //
-        RecvCompletionLength =
-            InterlockedExchange64(
-                (int64_t*)&Stream->RecvCompletionLength,
-                0) &
-            ~QUIC_STREAM_RECV_COMPLETION_LENGTH_RECEIVE_CALL_ACTIVE_FLAG;
+        FlushRecv =
+            QuicStreamRecvIndicationComplete(
+                Stream,
+                Status,
+                Event.RECEIVE.TotalBufferLength);
+    }
 
-        if (Status == QUIC_STATUS_CONTINUE) {
-            CXPLAT_DBG_ASSERT(!Stream->Flags.SentStopSending);
-            RecvCompletionLength += Event.RECEIVE.TotalBufferLength;
-            FlushRecv = TRUE;
-            //
-            // The app has explicitly indicated it wants to continue to
-            // receive callbacks, even if all the data wasn't drained.
-            //
-            Stream->Flags.ReceiveEnabled = TRUE;
+    //
+    // Cleanup receive buffers if needed
+    //
+    if (RecvBuffers != StackRecvBuffers) {
+        CXPLAT_FREE(RecvBuffers, QUIC_POOL_RECVBUF);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamRecvFlushBatch(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_STREAM_SET* StreamSet = &Connection->Streams;
+    QUIC_STREAM* Streams[QUIC_STREAMS_RECEIVE_BATCH_MAX];
+    QUIC_STREAM_RECEIVE_DATA Data[QUIC_STREAMS_RECEIVE_BATCH_MAX];
 
-        } else if (Status == QUIC_STATUS_PENDING) {
+    //
+    // Circular receive buffers never need more than two buffers to read all
+    // their unread data.
+    //
+    QUIC_BUFFER Buffers[QUIC_STREAMS_RECEIVE_BATCH_MAX * 2];
+    uint32_t StreamCount = 0;
+
+    //
+    // Write any STREAM frame data still pending from the current receive batch
+    // so it is included in this indication.
+    //
+    QuicStreamRecvRunFlush(&Connection->RecvRun);
+
+    while (StreamCount < QUIC_STREAMS_RECEIVE_BATCH_MAX &&
+           !CxPlatListIsEmpty(&StreamSet->RecvFlushStreams)) {
+        QUIC_STREAM* Stream =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&StreamSet->RecvFlushStreams),
+                QUIC_STREAM,
+                RecvFlushLink);
+        Stream->Flags.InRecvFlushList = FALSE;
+
+        if (!QuicStreamRecvCanBatchFlush(Stream)) {
             //
-            // The app called the receive complete API
-            // (inline or concurrently) before the callback returned if RecvCompletionLength is non-zero.
+            // Things changed since the stream was queued (for instance the
+            // handle was closed). Fall back to a normal stream indication.
             //
-            FlushRecv = (RecvCompletionLength != 0);
+            QuicStreamRecvFlush(Stream);
+            QuicStreamRelease(Stream, QUIC_STREAM_REF_OPERATION);
+            continue;
+        }
 
-        } else {
+        if (!Stream->Flags.ReceiveDataPending || !Stream->Flags.ReceiveEnabled) {
             //
-            // All failure status returns shouldn't be used by the app are
-            // ignored. We fire a telemetry event and treat as success.
+            // Either already flushed inline, or the app paused receives.
             //
-            CXPLAT_TEL_ASSERTMSG_ARGS(
-                QUIC_SUCCEEDED(Status),
-                "App failed recv callback",
-                Stream->Connection->Registration->AppName,
-                Status, 0);
-            RecvCompletionLength += Event.RECEIVE.TotalBufferLength;
-            FlushRecv = TRUE;
+            QuicStreamRelease(Stream, QUIC_STREAM_REF_OPERATION);
+            continue;
         }
 
-        if (FlushRecv) {
-            FlushRecv = QuicStreamReceiveComplete(Stream, RecvCompletionLength);
+        CXPLAT_DBG_ASSERT(QuicRecvBufferReadBufferNeededCount(&Stream->RecvBuffer) <= 2);
+        QUIC_STREAM_RECEIVE_DATA* Entry = &Data[StreamCount];
+        Entry->Stream = (HQUIC)Stream;
+        Entry->StreamContext = Stream->ClientContext;
+        Entry->Buffers = &Buffers[StreamCount * 2];
+        Entry->BufferCount = 2;
+        Entry->Status = QUIC_STATUS_SUCCESS;
+
+        QuicStreamRecvIndicationBegin(
+            Stream,
+            &Entry->AbsoluteOffset,
+            &Entry->TotalBufferLength,
+            &Entry->BufferCount,
+            &Buffers[StreamCount * 2],
+            &Entry->Flags);
+
+        QuicTraceEvent(
+            StreamAppReceive,
+            "[strm][%p] Indicating QUIC_STREAM_EVENT_RECEIVE [%llu bytes, %u buffers, 0x%x flags]",
+            Stream,
+            Entry->TotalBufferLength,
+            Entry->BufferCount,
+            Entry->Flags);
+
+        Streams[StreamCount++] = Stream;
+    }
+
+    if (StreamCount != 0) {
+        QUIC_CONNECTION_EVENT Event;
+        Event.Type = QUIC_CONNECTION_EVENT_STREAMS_RECEIVE;
+        Event.STREAMS_RECEIVE.Streams = Data;
+        Event.STREAMS_RECEIVE.StreamCount = StreamCount;
+
+        QuicTraceLogConnVerbose(
+            IndicateStreamsReceive,
+            Connection,
+            "Indicating QUIC_CONNECTION_EVENT_STREAMS_RECEIVE [%u streams]",
+            StreamCount);
+        (void)QuicConnIndicateEvent(Connection, &Event);
+
+        for (uint32_t i = 0; i < StreamCount; ++i) {
+            QUIC_STREAM* Stream = Streams[i];
+            if (QuicStreamRecvIndicationComplete(
+                    Stream,
+                    Data[i].Status,
+                    Data[i].TotalBufferLength)) {
+                //
+                // More data is ready to be delivered. Queue the stream up
+                // again behind the others instead of indicating it inline.
+                //
+                QuicStreamRecvQueueFlush(Stream, FALSE);
+            }
+            QuicStreamRelease(Stream, QUIC_STREAM_REF_OPERATION);
         }
     }
 
-    //
-    // Cleanup receive buffers if needed
-    //
-    if (RecvBuffers != StackRecvBuffers) {
-        CXPLAT_FREE(RecvBuffers, QUIC_POOL_RECVBUF);
+    if (CxPlatListIsEmpty(&StreamSet->RecvFlushStreams)) {
+        StreamSet->RecvFlushQueued = FALSE;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamRecvFlushBatchCancel(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_STREAM_SET* StreamSet = &Connection->Streams;
+    while (!CxPlatListIsEmpty(&StreamSet->RecvFlushStreams)) {
+        QUIC_STREAM* Stream =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&StreamSet->RecvFlushStreams),
+                QUIC_STREAM,
+                RecvFlushLink);
+        Stream->Flags.InRecvFlushList = FALSE;
+        QuicStreamRelease(Stream, QUIC_STREAM_REF_OPERATION);
     }
+    StreamSet->RecvFlushQueued = FALSE;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1240,7 +1782,7 @@ QuicStreamRecvSetEnabledState(
         Stream->Flags.ReceiveEnabled = NewRecvEnabled;
 
         if (Stream->Flags.Started && NewRecvEnabled &&
-            (Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE ||
+            (QuicRecvBufferIsMultiple(&Stream->RecvBuffer) ||
             Stream->RecvBuffer.ReadPendingLength == 0)) {
             //
             // The application just resumed receive callbacks. Queue a
@@ -261,7 +261,7 @@ QuicStreamSendShutdown(
             SendRequest->Next = NULL;
             QuicStreamEnqueueSendRequest(Stream, SendRequest);
 
-            if (Stream->Connection->Settings.SendBufferingEnabled) {
+            if (Stream->Connection->Settings->SendBufferingEnabled) {
                 QuicSendBufferFill(Stream->Connection);
             }
 
@@ -334,6 +334,44 @@ QuicStreamHasPending0RttData(
          (Stream->SendFlags & QUIC_STREAM_SEND_FLAG_FIN));
 }
 
+//
+// Returns the bytes of new data the stream's send rate limit must allow before
+// the stream is scheduled again, so it doesn't trickle out small frames as
+// the tokens refill.
+//
+uint64_t
+QuicStreamSendGetRateLimitThreshold(
+    _In_ const QUIC_STREAM* Stream
+    )
+{
+    const uint64_t Pending = Stream->QueuedSendOffset - Stream->NextSendOffset;
+    return CXPLAT_MIN(Pending, Stream->Connection->Paths[0].Mtu);
+}
+
+//
+// Returns how long, in microseconds, the stream's send rate limit holds off
+// its pending new data, or zero if it doesn't.
+//
+uint64_t
+QuicStreamSendGetRateLimitDelay(
+    _In_ const QUIC_STREAM* Stream,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (Stream->SendRateLimit.Rate == 0 ||
+        !HasStreamDataFrames(Stream->SendFlags) ||
+        RECOV_WINDOW_OPEN(Stream) ||
+        Stream->NextSendOffset == Stream->QueuedSendOffset) {
+        return 0;
+    }
+
+    return
+        QuicSendRateLimitGetDelay(
+            &Stream->SendRateLimit,
+            TimeNow,
+            QuicStreamSendGetRateLimitThreshold(Stream));
+}
+
 //
 // Returns TRUE if the stream can send a STREAM frame immediately. This
 // function does not include any congestion control state checks.
@@ -372,9 +410,18 @@ QuicStreamSendCanWriteDataFrames(
     // Some unsent data. Can send only if flow control will allow.
     //
     QUIC_SEND* Send = &Stream->Connection->Send;
+    if (Stream->NextSendOffset >= Stream->MaxAllowedSendOffset ||
+        Send->OrderedStreamBytesSent >= Send->PeerMaxData) {
+        return FALSE;
+    }
+
+    //
+    // And only if the stream's send rate limit will allow.
+    //
     return
-        Stream->NextSendOffset < Stream->MaxAllowedSendOffset &&
-        Send->OrderedStreamBytesSent < Send->PeerMaxData;
+        Stream->SendRateLimit.Rate == 0 ||
+        QuicSendRateLimitGetAvailable(&Stream->SendRateLimit, CxPlatTimeUs64()) >=
+            QuicStreamSendGetRateLimitThreshold(Stream);
 }
 
 BOOLEAN
@@ -408,6 +455,52 @@ QuicStreamCanSendNow(
     return FALSE;
 }
 
+//
+// Indicates the lifecycle breakdown of a sampled send request, once it has
+// been both acknowledged and completed to the app.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamIndicateSendLatency(
+    _In_ QUIC_STREAM* Stream,
+    _In_ const QUIC_SEND_REQUEST* SendRequest,
+    _In_ uint64_t AckTime
+    )
+{
+    //
+    // Requests that were never framed (i.e. zero length) report the framing
+    // phases as zero.
+    //
+    const uint64_t FirstFramedTime =
+        SendRequest->FirstFramedTime != 0 ?
+            SendRequest->FirstFramedTime : SendRequest->EnqueueTime;
+    const uint64_t LastFramedTime =
+        SendRequest->LastFramedTime != 0 ?
+            SendRequest->LastFramedTime : FirstFramedTime;
+
+    QUIC_STREAM_EVENT Event;
+    Event.Type = QUIC_STREAM_EVENT_SEND_LATENCY;
+    Event.SEND_LATENCY.ClientContext = SendRequest->ClientContext;
+    Event.SEND_LATENCY.StreamOffset = SendRequest->StreamOffset;
+    Event.SEND_LATENCY.Length = SendRequest->TotalLength;
+    Event.SEND_LATENCY.QueueDelayUs =
+        CxPlatTimeDiff64(SendRequest->QueueTime, SendRequest->EnqueueTime);
+    Event.SEND_LATENCY.ScheduleDelayUs =
+        CxPlatTimeDiff64(SendRequest->EnqueueTime, FirstFramedTime);
+    Event.SEND_LATENCY.SendDurationUs =
+        CxPlatTimeDiff64(FirstFramedTime, LastFramedTime);
+    Event.SEND_LATENCY.AckDelayUs =
+        CxPlatTimeDiff64(LastFramedTime, AckTime);
+    Event.SEND_LATENCY.CompleteDelayUs =
+        CxPlatTimeDiff64(SendRequest->QueueTime, SendRequest->CompleteTime);
+    QuicTraceLogStreamVerbose(
+        IndicateSendLatency,
+        Stream,
+        "Indicating QUIC_STREAM_EVENT_SEND_LATENCY [%p]",
+        SendRequest);
+    (void)QuicStreamIndicateEvent(Stream, &Event);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamCompleteSendRequest(
@@ -418,6 +511,7 @@ QuicStreamCompleteSendRequest(
     )
 {
     QUIC_CONNECTION* Connection = Stream->Connection;
+    const uint64_t AckTime = SendRequest->Sampled ? CxPlatTimeUs64() : 0;
 
     if (Stream->SendBookmark == SendRequest) {
         Stream->SendBookmark = SendRequest->Next;
@@ -451,9 +545,18 @@ QuicStreamCompleteSendRequest(
                 Stream,
                 "Indicating QUIC_STREAM_EVENT_SEND_COMPLETE [%p]",
                 SendRequest);
+            QuicLatencyRecord(
+                Connection->Partition->Latency.SendComplete,
+                CxPlatTimeDiff64(SendRequest->QueueTime, CxPlatTimeUs64()));
         }
+        QuicTraceProbe(
+            stream_send_complete,
+            Stream,
+            SendRequest->TotalLength,
+            Canceled);
 
         (void)QuicStreamIndicateEvent(Stream, &Event);
+        SendRequest->CompleteTime = AckTime;
     } else if (SendRequest->InternalBuffer.Length != 0) {
         QuicSendBufferFree(
             &Connection->SendBuffer,
@@ -461,11 +564,15 @@ QuicStreamCompleteSendRequest(
             SendRequest->InternalBuffer.Length);
     }
 
+    if (SendRequest->Sampled && !Canceled) {
+        QuicStreamIndicateSendLatency(Stream, SendRequest, AckTime);
+    }
+
     if (PreviouslyPosted) {
         CXPLAT_DBG_ASSERT(Connection->SendBuffer.PostedBytes >= SendRequest->TotalLength);
         Connection->SendBuffer.PostedBytes -= SendRequest->TotalLength;
 
-        if (Connection->Settings.SendBufferingEnabled) {
+        if (Connection->Settings->SendBufferingEnabled) {
             QuicSendBufferFill(Connection);
         }
     }
@@ -491,6 +598,7 @@ QuicStreamSendBufferRequest(
         uint8_t* Buf =
             QuicSendBufferAlloc(
                 &Connection->SendBuffer,
+                Connection->Partition,
                 (uint32_t)Req->TotalLength);
         if (Buf == NULL) {
             return QUIC_STATUS_OUT_OF_MEMORY;
@@ -527,9 +635,16 @@ QuicStreamSendBufferRequest(
         Stream,
         "Indicating QUIC_STREAM_EVENT_SEND_COMPLETE [%p]",
         Req);
+    QuicLatencyRecord(
+        Connection->Partition->Latency.SendComplete,
+        CxPlatTimeDiff64(Req->QueueTime, CxPlatTimeUs64()));
+    QuicTraceProbe(stream_send_complete, Stream, Req->TotalLength, FALSE);
     (void)QuicStreamIndicateEvent(Stream, &Event);
 
     Req->ClientContext = NULL;
+    if (Req->Sampled) {
+        Req->CompleteTime = CxPlatTimeUs64();
+    }
 
     return QUIC_STATUS_SUCCESS;
 }
@@ -552,6 +667,17 @@ QuicStreamEnqueueSendRequest(
     SendRequest->StreamOffset = Stream->QueuedSendOffset;
     Stream->QueuedSendOffset += SendRequest->TotalLength;
 
+    SendRequest->Sampled = FALSE;
+    if (Stream->SendLatencySampleInterval != 0 &&
+        ++Stream->SendLatencySampleCount >= Stream->SendLatencySampleInterval) {
+        Stream->SendLatencySampleCount = 0;
+        SendRequest->Sampled = TRUE;
+        SendRequest->EnqueueTime = CxPlatTimeUs64();
+        SendRequest->FirstFramedTime = 0;
+        SendRequest->LastFramedTime = 0;
+        SendRequest->CompleteTime = 0;
+    }
+
     if (SendRequest->Flags & QUIC_SEND_FLAG_ALLOW_0_RTT &&
         Stream->Queued0Rtt == SendRequest->StreamOffset) {
         Stream->Queued0Rtt = Stream->QueuedSendOffset;
@@ -658,7 +784,7 @@ QuicStreamSendFlush(
             QUIC_STREAM_SEND_FLAG_DATA,
             !!(SendRequest->Flags & QUIC_SEND_FLAG_DELAY_SEND));
 
-        if (Stream->Connection->Settings.SendBufferingEnabled) {
+        if (Stream->Connection->Settings->SendBufferingEnabled) {
             QuicSendBufferFill(Stream->Connection);
         }
 
@@ -681,17 +807,23 @@ QuicStreamSendFlush(
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
-void
+uint16_t
 QuicStreamCopyFromSendRequests(
     _In_ QUIC_STREAM* Stream,
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
     _In_ uint64_t Offset,
-    _Out_writes_bytes_(Len) uint8_t* Buf,
+    _Out_writes_bytes_to_(Len, return) uint8_t* Buf,
     _In_range_(>, 0) uint16_t Len
     )
 {
     //
     // Copies up to Len stream bytes starting at Offset from the noncontiguous
-    // send request queue into a contiguous frame buffer.
+    // send request queue into a contiguous frame buffer. Where the packet
+    // builder allows it, the copy is left to the encryption of the packet,
+    // which then reads straight from the send request buffers. File backed
+    // requests are read straight into the frame buffer instead. Returns the
+    // number of bytes copied, which is less than Len only if such a read
+    // failed.
     //
 
     CXPLAT_DBG_ASSERT(Len > 0);
@@ -723,6 +855,7 @@ QuicStreamCopyFromSendRequests(
     //
     uint32_t CurIndex = 0; // Index of the current buffer.
     uint64_t CurOffset = Offset - Req->StreamOffset; // Offset in the current buffer.
+    const uint8_t* BufStart = Buf;
     while (CurOffset >= (uint64_t)Req->Buffers[CurIndex].Length) {
         CurOffset -= Req->Buffers[CurIndex++].Length;
     }
@@ -743,10 +876,44 @@ QuicStreamCopyFromSendRequests(
         uint32_t BufferLeft = Req->Buffers[CurIndex].Length - (uint32_t)CurOffset;
         uint16_t CopyLength = Len < BufferLeft ? Len : (uint16_t)BufferLeft;
         CXPLAT_DBG_ASSERT(CopyLength > 0);
-        CxPlatCopyMemory(Buf, Req->Buffers[CurIndex].Buffer + CurOffset, CopyLength);
+#ifndef _KERNEL_MODE
+        if (Req->Flags & QUIC_SEND_FLAG_FROM_FILE) {
+            uint32_t BytesRead = 0;
+            QUIC_STATUS Status =
+                CxPlatFileRead(
+                    Req->File, Req->FileOffset + CurOffset, CopyLength, Buf, &BytesRead);
+            if (QUIC_FAILED(Status) || BytesRead < CopyLength) {
+                QuicTraceEvent(
+                    StreamError,
+                    "[strm][%p] ERROR, %s.",
+                    Stream,
+                    "Send file read failed");
+                return (uint16_t)((Buf - BufStart) + BytesRead);
+            }
+        } else
+#endif
+        if (!QuicPacketBuilderAddCryptSegment(
+                Builder, Buf, Req->Buffers[CurIndex].Buffer + CurOffset, CopyLength)) {
+            CxPlatCopyMemory(Buf, Req->Buffers[CurIndex].Buffer + CurOffset, CopyLength);
+        }
         Len -= CopyLength;
         Buf += CopyLength;
 
+        if (Req->Sampled) {
+            //
+            // Only the first transmission of the request's bytes is timed;
+            // retransmissions show up as a longer wait for the ACK.
+            //
+            const uint64_t EndOffset = Offset + (uint64_t)(Buf - BufStart);
+            if (Req->FirstFramedTime == 0) {
+                Req->FirstFramedTime = CxPlatTimeUs64();
+            }
+            if (Req->LastFramedTime == 0 &&
+                EndOffset >= Req->StreamOffset + Req->TotalLength) {
+                Req->LastFramedTime = CxPlatTimeUs64();
+            }
+        }
+
         if (Len == 0) {
             break; // All data has been copied!
         }
@@ -768,7 +935,58 @@ QuicStreamCopyFromSendRequests(
     // Save the bookmark for later.
     //
     Stream->SendBookmark = Req;
+
+    return (uint16_t)(Buf - BufStart);
+}
+
+#ifndef _KERNEL_MODE
+//
+// Called when a file backed send request couldn't be read while framing. The
+// stream stops framing data, and its send direction is aborted by a queued
+// operation, as the send state can't be torn down in the middle of framing.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicStreamOnSendFileFailure(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    QUIC_CONNECTION* Connection = Stream->Connection;
+
+    Stream->SendFlags &=
+        ~(QUIC_STREAM_SEND_FLAG_DATA |
+          QUIC_STREAM_SEND_FLAG_OPEN |
+          QUIC_STREAM_SEND_FLAG_FIN);
+
+    if (Stream->Flags.SendFileFailed) {
+        return; // Abort already queued.
+    }
+    Stream->Flags.SendFileFailed = TRUE;
+
+    QUIC_OPERATION* Oper =
+        QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
+    if (Oper != NULL) {
+        Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_SHUTDOWN;
+        Oper->API_CALL.Context->STRM_SHUTDOWN.Stream = Stream;
+        Oper->API_CALL.Context->STRM_SHUTDOWN.Flags = QUIC_STREAM_SHUTDOWN_FLAG_ABORT_SEND;
+        Oper->API_CALL.Context->STRM_SHUTDOWN.ErrorCode = 0;
+        QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+        QuicConnQueueOper(Connection, Oper);
+    } else if (InterlockedCompareExchange16((short*)&Connection->BackUpOperUsed, 1, 0) == 0) {
+        Oper = &Connection->BackUpOper;
+        Oper->FreeAfterProcess = FALSE;
+        Oper->Type = QUIC_OPER_TYPE_API_CALL;
+        Oper->API_CALL.Context = &Connection->BackupApiContext;
+        Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SHUTDOWN;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.ErrorCode = QUIC_ERROR_INTERNAL_ERROR;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = FALSE;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = TRUE;
+        QuicConnQueueHighestPriorityOper(Connection, Oper);
+    }
 }
+#endif
 
 //
 // Writes data at the requested stream offset to a stream frame.
@@ -782,9 +1000,10 @@ QuicStreamWriteOneFrame(
     _Inout_ uint16_t* FramePayloadBytes,
     _Inout_ uint16_t* FrameBytes,
     _Out_writes_bytes_(*FrameBytes) uint8_t* Buffer,
-    _Inout_ QUIC_SENT_PACKET_METADATA* PacketMetadata
+    _Inout_ QUIC_PACKET_BUILDER* Builder
     )
 {
+    QUIC_SENT_PACKET_METADATA* PacketMetadata = Builder->Metadata;
     QUIC_STREAM_EX Frame = { FALSE, ExplicitDataLength, Stream->ID, Offset, 0, NULL };
     uint16_t HeaderLength = 0;
 
@@ -819,8 +1038,21 @@ QuicStreamWriteOneFrame(
             CXPLAT_DBG_ASSERT(Frame.Length > 0);
         }
         Frame.Data = Buffer + HeaderLength;
-        QuicStreamCopyFromSendRequests(
-            Stream, Offset, (uint8_t*)Frame.Data, (uint16_t)Frame.Length);
+        const uint16_t CopiedLength =
+            QuicStreamCopyFromSendRequests(
+                Stream, Builder, Offset, (uint8_t*)Frame.Data, (uint16_t)Frame.Length);
+#ifndef _KERNEL_MODE
+        if (CopiedLength < Frame.Length) {
+            //
+            // Only send what could be read from the file.
+            //
+            Frame.Length = CopiedLength;
+            QuicStreamOnSendFileFailure(Stream);
+        }
+#else
+        CXPLAT_DBG_ASSERT(CopiedLength == Frame.Length);
+        UNREFERENCED_PARAMETER(CopiedLength);
+#endif
         Stream->Connection->Stats.Send.TotalStreamBytes += Frame.Length;
     }
 
@@ -892,13 +1124,16 @@ void
 QuicStreamWriteStreamFrames(
     _In_ QUIC_STREAM* Stream,
     _In_ BOOLEAN ExplicitDataLength,
-    _Inout_ QUIC_SENT_PACKET_METADATA* PacketMetadata,
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
     _Inout_ uint16_t* BufferLength,
     _Out_writes_bytes_(*BufferLength) uint8_t* Buffer
     )
 {
+    QUIC_SENT_PACKET_METADATA* PacketMetadata = Builder->Metadata;
     QUIC_SEND* Send = &Stream->Connection->Send;
     uint16_t BytesWritten = 0;
+    const uint64_t RateLimitTime =
+        Stream->SendRateLimit.Rate != 0 ? CxPlatTimeUs64() : 0;
 
     //
     // FUTURE: implicit data length when possible.
@@ -979,6 +1214,19 @@ QuicStreamWriteStreamFrames(
             Right = MaxConnFlowControlOffset;
         }
 
+        //
+        // Stream send rate limit, which only holds back new data.
+        //
+        uint64_t MaxRateLimitOffset = UINT64_MAX;
+        if (Stream->SendRateLimit.Rate != 0) {
+            MaxRateLimitOffset =
+                CXPLAT_MAX(Left, Stream->MaxSentLength) +
+                QuicSendRateLimitGetAvailable(&Stream->SendRateLimit, RateLimitTime);
+            if (Right > MaxRateLimitOffset) {
+                Right = MaxRateLimitOffset;
+            }
+        }
+
         //
         // It's OK for Right and Left to be equal because there are cases where
         // stream frames will be written with no payload (initial or FIN).
@@ -995,7 +1243,7 @@ QuicStreamWriteStreamFrames(
             &FramePayloadBytes,
             &FrameBytes,
             Buffer + BytesWritten,
-            PacketMetadata);
+            Builder);
 
         BOOLEAN ExitLoop = FALSE;
 
@@ -1005,6 +1253,9 @@ QuicStreamWriteStreamFrames(
         // FrameBytes is not).
         //
         BytesWritten += FrameBytes;
+        if (Stream->Connection->State.UseWeightedStreamScheduling) {
+            Stream->SendDeficit -= FramePayloadBytes;
+        }
         if (FramePayloadBytes == 0) {
             ExitLoop = TRUE;
         }
@@ -1044,6 +1295,10 @@ QuicStreamWriteStreamFrames(
             ExitLoop = TRUE;
         }
 
+        if (Right == MaxRateLimitOffset) {
+            ExitLoop = TRUE;
+        }
+
         //
         // Move the "next" offset (RecoveryNextOffset if we are sending recovery
         // bytes or NextSendOffset otherwise) forward by the number of bytes
@@ -1067,6 +1322,10 @@ QuicStreamWriteStreamFrames(
         }
 
         if (Stream->MaxSentLength < Right) {
+            QuicSendRateLimitConsume(
+                &Stream->SendRateLimit,
+                RateLimitTime,
+                Right - Stream->MaxSentLength);
             Send->OrderedStreamBytesSent += Right - Stream->MaxSentLength;
             CXPLAT_DBG_ASSERT(Send->OrderedStreamBytesSent <= Send->PeerMaxData);
             Stream->MaxSentLength = Right;
@@ -1194,7 +1453,7 @@ QuicStreamSendWrite(
         QuicStreamWriteStreamFrames(
             Stream,
             IsInitial,
-            Builder->Metadata,
+            Builder,
             &StreamFrameLength,
             Builder->Datagram->Buffer + Builder->DatagramLength);
 
@@ -1243,6 +1502,35 @@ QuicStreamSendWrite(
     return Builder->Metadata->FrameCount > PrevFrameCount;
 }
 
+//
+// Returns TRUE if the send request holding the data at Offset was queued more
+// than the stream's send timeout ago.
+//
+static
+BOOLEAN
+QuicStreamSendIsExpired(
+    _In_ const QUIC_STREAM* Stream,
+    _In_ uint64_t Offset
+    )
+{
+    if (Stream->SendTimeoutMs == 0) {
+        return FALSE;
+    }
+
+    for (const QUIC_SEND_REQUEST* SendRequest = Stream->SendRequests;
+            SendRequest != NULL;
+            SendRequest = SendRequest->Next) {
+        if (Offset < SendRequest->StreamOffset + SendRequest->TotalLength) {
+            return
+                Offset >= SendRequest->StreamOffset &&
+                CxPlatTimeDiff64(SendRequest->QueueTime, CxPlatTimeUs64()) >=
+                    MS_TO_US((uint64_t)Stream->SendTimeoutMs);
+        }
+    }
+
+    return FALSE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicStreamOnLoss(
@@ -1346,6 +1634,41 @@ QuicStreamOnLoss(
         }
     }
 
+    if (Stream->Flags.LocalCloseResetReliable) {
+        //
+        // The peer discards anything past the reliable offset, so there's no
+        // point retransmitting it.
+        //
+        if (End > Stream->ReliableOffsetSend) {
+            End = Stream->ReliableOffsetSend;
+        }
+        if (Start >= End) {
+            goto Done;
+        }
+
+    } else if (Stream->ReliableOffsetSend <= Start &&
+               QuicStreamSendIsExpired(Stream, Start)) {
+        //
+        // The lost data is too stale to be worth retransmitting. Reset the
+        // stream at the start of it; everything before it is still delivered
+        // if reliable reset was negotiated.
+        //
+        QUIC_STREAM_EVENT Event;
+        Event.Type = QUIC_STREAM_EVENT_CANCEL_ON_LOSS;
+        Event.CANCEL_ON_LOSS.ErrorCode = 0;
+        (void)QuicStreamIndicateEvent(Stream, &Event);
+
+        if (Stream->Connection->State.ReliableResetStreamNegotiated) {
+            Stream->ReliableOffsetSend = Start;
+        }
+        QuicStreamShutdown(
+            Stream,
+            QUIC_STREAM_SHUTDOWN_FLAG_ABORT_SEND,
+            Event.CANCEL_ON_LOSS.ErrorCode);
+
+        return FALSE; // Don't resend any data.
+    }
+
     BOOLEAN UpdatedRecoveryWindow = FALSE;
 
     //
@@ -74,21 +74,64 @@ QuicStreamSetInitialize(
 {
     CxPlatListInitializeHead(&StreamSet->ClosedStreams);
     CxPlatListInitializeHead(&StreamSet->WaitingStreams);
+    CxPlatListInitializeHead(&StreamSet->RecvFlushStreams);
+    CxPlatListInitializeHead(&StreamSet->RecycledStreams);
+    CxPlatDispatchLockInitialize(&StreamSet->RecycledStreamsLock);
 #if DEBUG
     CxPlatListInitializeHead(&StreamSet->AllStreams);
     CxPlatDispatchLockInitialize(&StreamSet->AllStreamsLock);
 #endif
 }
 
+//
+// Returns all the recycled streams, and their chunks, to their pools.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicStreamSetFreeRecycledStreams(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    )
+{
+    CXPLAT_LIST_ENTRY Streams;
+    CxPlatListInitializeHead(&Streams);
+
+    CxPlatDispatchLockAcquire(&StreamSet->RecycledStreamsLock);
+    CxPlatListMoveItems(&StreamSet->RecycledStreams, &Streams);
+    StreamSet->RecycledStreamCount = 0;
+    CxPlatDispatchLockRelease(&StreamSet->RecycledStreamsLock);
+
+    while (!CxPlatListIsEmpty(&Streams)) {
+        QUIC_STREAM* Stream =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Streams), QUIC_STREAM, ClosedLink);
+        if (!CxPlatListIsEmpty(&Stream->RecvBuffer.Chunks)) {
+            QuicRecvChunkFree(
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&Stream->RecvBuffer.Chunks), QUIC_RECV_CHUNK, Link));
+        }
+        QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_STREAM, -(int64_t)sizeof(QUIC_STREAM));
+        CxPlatPoolFree(Stream);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamSetUninitialize(
     _Inout_ QUIC_STREAM_SET* StreamSet
     )
 {
+    QuicStreamSetFreeRecycledStreams(StreamSet);
+    CxPlatDispatchLockUninitialize(&StreamSet->RecycledStreamsLock);
     if (StreamSet->StreamTable != NULL) {
         CxPlatHashtableUninitialize(StreamSet->StreamTable);
     }
+    for (uint32_t i = 0; i < NUMBER_OF_STREAM_TYPES; ++i) {
+        if (StreamSet->Types[i].Window != NULL) {
+            CXPLAT_FREE(StreamSet->Types[i].Window, QUIC_POOL_STREAM_WINDOW);
+            StreamSet->Types[i].Window = NULL;
+        }
+    }
 #if DEBUG
     CxPlatDispatchLockUninitialize(&StreamSet->AllStreamsLock);
 #endif
@@ -128,9 +171,14 @@ QuicStreamSetLazyInitStreamTable(
 {
     if (StreamSet->StreamTable == NULL) {
         //
-        // Lazily initialize the hash table.
+        // Lazily initialize the hash table. Stream lookups are on the receive
+        // path for every frame, so use the open addressing variant, which
+        // usually finds an ID with a single cache miss.
         //
-        if (!CxPlatHashtableInitialize(&StreamSet->StreamTable, CXPLAT_HASH_MIN_SIZE)) {
+        if (!CxPlatHashtableInitializeWithFlags(
+                &StreamSet->StreamTable,
+                CXPLAT_HASH_MIN_SIZE,
+                CXPLAT_HASH_OPEN_ADDRESSING)) {
             QuicTraceEvent(
                 AllocFailure,
                 "Allocation of '%s' failed. (%llu bytes)",
@@ -142,6 +190,61 @@ QuicStreamSetLazyInitStreamTable(
     return TRUE;
 }
 
+//
+// Adds the stream to its type's window, sliding the window forward if the
+// stream is newer than all the streams in it. Failure to allocate the window
+// only means lookups fall back to the stream table.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicStreamSetWindowInsert(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[Stream->ID & STREAM_ID_MASK];
+    const uint64_t Index = Stream->ID >> 2;
+
+    if (Info->Window == NULL) {
+        //
+        // Streams of a type are always inserted in ID order, so no stream
+        // newer than this one can be in the table yet.
+        //
+        Info->Window =
+            CXPLAT_ALLOC_NONPAGED(
+                QUIC_STREAM_WINDOW_SIZE * sizeof(QUIC_STREAM*),
+                QUIC_POOL_STREAM_WINDOW);
+        if (Info->Window == NULL) {
+            return;
+        }
+        CxPlatZeroMemory(Info->Window, QUIC_STREAM_WINDOW_SIZE * sizeof(QUIC_STREAM*));
+        Info->WindowBase = Index;
+    }
+
+    if (Index < Info->WindowBase) {
+        return; // Older than the window. Only in the stream table.
+    }
+
+    if (Index - Info->WindowBase >= QUIC_STREAM_WINDOW_SIZE) {
+        //
+        // Slide the window so the new stream is its last slot. The streams
+        // that fall out of it stay in the stream table.
+        //
+        const uint64_t NewBase = Index - QUIC_STREAM_WINDOW_SIZE + 1;
+        if (NewBase - Info->WindowBase >= QUIC_STREAM_WINDOW_SIZE) {
+            CxPlatZeroMemory(Info->Window, QUIC_STREAM_WINDOW_SIZE * sizeof(QUIC_STREAM*));
+        } else {
+            for (uint64_t i = Info->WindowBase; i < NewBase; ++i) {
+                Info->Window[i & (QUIC_STREAM_WINDOW_SIZE - 1)] = NULL;
+            }
+        }
+        Info->WindowBase = NewBase;
+    }
+
+    CXPLAT_DBG_ASSERT(Info->Window[Index & (QUIC_STREAM_WINDOW_SIZE - 1)] == NULL);
+    Info->Window[Index & (QUIC_STREAM_WINDOW_SIZE - 1)] = Stream;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != FALSE)
 BOOLEAN
@@ -159,6 +262,7 @@ QuicStreamSetInsertStream(
         &Stream->TableEntry,
         (uint32_t)Stream->ID,
         NULL);
+    QuicStreamSetWindowInsert(StreamSet, Stream);
     return TRUE;
 }
 
@@ -174,6 +278,17 @@ QuicStreamSetLookupStream(
         return NULL; // No streams have been created yet.
     }
 
+    const QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[ID & STREAM_ID_MASK];
+    const uint64_t Index = ID >> 2;
+    if (Info->Window != NULL && Index >= Info->WindowBase) {
+        if (Index - Info->WindowBase >= QUIC_STREAM_WINDOW_SIZE) {
+            return NULL; // Newer than any stream of this type.
+        }
+        QUIC_STREAM* Stream = Info->Window[Index & (QUIC_STREAM_WINDOW_SIZE - 1)];
+        CXPLAT_DBG_ASSERT(Stream == NULL || Stream->ID == ID);
+        return Stream;
+    }
+
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
     CXPLAT_HASHTABLE_ENTRY* Entry =
         CxPlatHashtableLookup(StreamSet->StreamTable, (uint32_t)ID, &Context);
@@ -228,6 +343,160 @@ QuicStreamSetShutdown(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetHibernate(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    )
+{
+    QuicStreamSetFreeRecycledStreams(StreamSet);
+
+    if (StreamSet->StreamTable == NULL) {
+        return;
+    }
+
+    const uint32_t AllocBufferLength =
+        QuicStreamSetGetConnection(StreamSet)->Settings->StreamRecvBufferDefault;
+    CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+    CXPLAT_HASHTABLE_ENTRY* Entry;
+    CxPlatHashtableEnumerateBegin(StreamSet->StreamTable, &Enumerator);
+    while ((Entry = CxPlatHashtableEnumerateNext(StreamSet->StreamTable, &Enumerator)) != NULL) {
+        QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, TableEntry);
+        QuicRecvBufferShrink(&Stream->RecvBuffer, AllocBufferLength);
+    }
+    CxPlatHashtableEnumerateEnd(StreamSet->StreamTable, &Enumerator);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicStreamSetRecycleStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream,
+    _In_opt_ QUIC_RECV_CHUNK* Chunk
+    )
+{
+    BOOLEAN Recycled = FALSE;
+
+    CxPlatListInitializeHead(&Stream->RecvBuffer.Chunks);
+    if (Chunk != NULL) {
+        CxPlatListInsertHead(&Stream->RecvBuffer.Chunks, &Chunk->Link);
+    }
+
+    CxPlatDispatchLockAcquire(&StreamSet->RecycledStreamsLock);
+    if (StreamSet->RecycledStreamCount < QUIC_STREAM_RECYCLE_MAX_COUNT) {
+        CxPlatListInsertHead(&StreamSet->RecycledStreams, &Stream->ClosedLink);
+        StreamSet->RecycledStreamCount++;
+        Recycled = TRUE;
+    }
+    CxPlatDispatchLockRelease(&StreamSet->RecycledStreamsLock);
+
+    if (!Recycled && Chunk != NULL) {
+        QuicRecvChunkFree(Chunk);
+    }
+
+    return Recycled;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_STREAM*
+QuicStreamSetTakeRecycledStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _Outptr_result_maybenull_ QUIC_RECV_CHUNK** Chunk
+    )
+{
+    QUIC_STREAM* Stream = NULL;
+    *Chunk = NULL;
+
+    CxPlatDispatchLockAcquire(&StreamSet->RecycledStreamsLock);
+    if (!CxPlatListIsEmpty(&StreamSet->RecycledStreams)) {
+        Stream =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&StreamSet->RecycledStreams), QUIC_STREAM, ClosedLink);
+        StreamSet->RecycledStreamCount--;
+    }
+    CxPlatDispatchLockRelease(&StreamSet->RecycledStreamsLock);
+
+    if (Stream != NULL && !CxPlatListIsEmpty(&Stream->RecvBuffer.Chunks)) {
+        *Chunk =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Stream->RecvBuffer.Chunks), QUIC_RECV_CHUNK, Link);
+    }
+
+    return Stream;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetGetMemoryUsage(
+    _In_ QUIC_STREAM_SET* StreamSet,
+    _Inout_ QUIC_MEMORY_USAGE* Usage
+    )
+{
+    CxPlatDispatchLockAcquire(&StreamSet->RecycledStreamsLock);
+    for (CXPLAT_LIST_ENTRY* Link = StreamSet->RecycledStreams.Flink;
+         Link != &StreamSet->RecycledStreams;
+         Link = Link->Flink) {
+        QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Link, QUIC_STREAM, ClosedLink);
+        Usage->Streams += sizeof(QUIC_STREAM);
+        if (!CxPlatListIsEmpty(&Stream->RecvBuffer.Chunks)) {
+            QUIC_RECV_CHUNK* Chunk =
+                CXPLAT_CONTAINING_RECORD(Stream->RecvBuffer.Chunks.Flink, QUIC_RECV_CHUNK, Link);
+            Usage->RecvBuffers += sizeof(QUIC_RECV_CHUNK) + Chunk->AllocLength;
+        }
+    }
+    CxPlatDispatchLockRelease(&StreamSet->RecycledStreamsLock);
+
+    if (StreamSet->StreamTable == NULL) {
+        return;
+    }
+
+    CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+    CXPLAT_HASHTABLE_ENTRY* Entry;
+    CxPlatHashtableEnumerateBegin(StreamSet->StreamTable, &Enumerator);
+    while ((Entry = CxPlatHashtableEnumerateNext(StreamSet->StreamTable, &Enumerator)) != NULL) {
+        QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, TableEntry);
+        Usage->Streams += sizeof(QUIC_STREAM);
+        Usage->RecvBuffers += QuicRecvBufferGetMemoryUsage(&Stream->RecvBuffer);
+    }
+    CxPlatHashtableEnumerateEnd(StreamSet->StreamTable, &Enumerator);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetGetBlockedTimings(
+    _In_ const QUIC_STREAM_SET* StreamSet,
+    _Out_ uint64_t* FlowControlUs,
+    _Out_ uint64_t* IdFlowControlUs
+    )
+{
+    const uint64_t Now = CxPlatTimeUs64();
+    *FlowControlUs = StreamSet->ReleasedBlockedByFlowControlUs;
+    *IdFlowControlUs = StreamSet->ReleasedBlockedByIdFlowControlUs;
+
+    if (StreamSet->StreamTable != NULL) {
+        CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+        CXPLAT_HASHTABLE_ENTRY* Entry;
+        CxPlatHashtableEnumerateBegin(StreamSet->StreamTable, &Enumerator);
+        while ((Entry = CxPlatHashtableEnumerateNext(StreamSet->StreamTable, &Enumerator)) != NULL) {
+            QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, TableEntry);
+            *FlowControlUs +=
+                QuicFlowBlockedTimingGet(&Stream->BlockedTimings.FlowControl, Now);
+            *IdFlowControlUs +=
+                QuicFlowBlockedTimingGet(&Stream->BlockedTimings.StreamIdFlowControl, Now);
+        }
+        CxPlatHashtableEnumerateEnd(StreamSet->StreamTable, &Enumerator);
+    }
+
+    for (CXPLAT_LIST_ENTRY* Link = StreamSet->WaitingStreams.Flink;
+         Link != &StreamSet->WaitingStreams;
+         Link = Link->Flink) {
+        QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Link, QUIC_STREAM, WaitingLink);
+        *IdFlowControlUs +=
+            QuicFlowBlockedTimingGet(&Stream->BlockedTimings.StreamIdFlowControl, Now);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamSetReleaseStream(
@@ -241,6 +510,11 @@ QuicStreamSetReleaseStream(
     if (Stream->Flags.InStreamTable) {
         CxPlatHashtableRemove(StreamSet->StreamTable, &Stream->TableEntry, NULL);
         Stream->Flags.InStreamTable = FALSE;
+        QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[Stream->ID & STREAM_ID_MASK];
+        if (Info->Window != NULL &&
+            Info->Window[(Stream->ID >> 2) & (QUIC_STREAM_WINDOW_SIZE - 1)] == Stream) {
+            Info->Window[(Stream->ID >> 2) & (QUIC_STREAM_WINDOW_SIZE - 1)] = NULL;
+        }
     } else if (Stream->Flags.InWaitingList) {
         CxPlatListEntryRemove(&Stream->WaitingLink);
         Stream->Flags.InWaitingList = FALSE;
@@ -253,6 +527,12 @@ QuicStreamSetReleaseStream(
 
     CxPlatListInsertTail(&StreamSet->ClosedStreams, &Stream->ClosedLink);
 
+    const uint64_t Now = CxPlatTimeUs64();
+    StreamSet->ReleasedBlockedByFlowControlUs +=
+        QuicFlowBlockedTimingGet(&Stream->BlockedTimings.FlowControl, Now);
+    StreamSet->ReleasedBlockedByIdFlowControlUs +=
+        QuicFlowBlockedTimingGet(&Stream->BlockedTimings.StreamIdFlowControl, Now);
+
     uint8_t Flags = (uint8_t)(Stream->ID & STREAM_ID_MASK);
     QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[Flags];
 
@@ -269,15 +549,124 @@ QuicStreamSetReleaseStream(
     if (Info->CurrentStreamCount < Info->MaxCurrentStreamCount) {
         //
         // Since a peer's stream was just closed we should allow the peer to
-        // create more streams.
+        // create more streams, unless memory is critically low. The credit is
+        // batched into fewer MAX_STREAMS frames, and given back once the
+        // pressure is gone.
+        //
+        Info->WithheldStreamCount++;
+        QuicStreamSetRestoreWithheldCount(StreamSet, Flags, FALSE);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetRestoreWithheldCount(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint8_t Type,
+    _In_ BOOLEAN Force
+    )
+{
+    QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[Type];
+    if (Info->WithheldStreamCount == 0 ||
+        QuicLibraryGetMemoryPressure() == QUIC_MEMORY_PRESSURE_CRITICAL) {
+        return;
+    }
+
+    if (!Force) {
         //
-        Info->MaxTotalStreamCount++;
-        QuicSendSetSendFlag(
-            &QuicStreamSetGetConnection(StreamSet)->Send,
-            (Flags & STREAM_ID_FLAG_IS_UNI_DIR) ?
-                QUIC_CONN_SEND_FLAG_MAX_STREAMS_UNI :
-                QUIC_CONN_SEND_FLAG_MAX_STREAMS_BIDI);
+        // Only send a MAX_STREAMS frame once a batch of credit is ready, as
+        // long as the peer has more than a batch left so that it doesn't
+        // block before the update arrives.
+        //
+        const uint16_t Batch =
+            CXPLAT_MAX(1, Info->MaxCurrentStreamCount / QUIC_STREAM_CREDIT_BATCH_DIVISOR);
+        if (Info->WithheldStreamCount < Batch &&
+            Info->MaxTotalStreamCount - Info->TotalStreamCount > Batch) {
+            return;
+        }
+    }
+
+    Info->MaxTotalStreamCount += Info->WithheldStreamCount;
+    Info->WithheldStreamCount = 0;
+    QuicSendSetSendFlag(
+        &QuicStreamSetGetConnection(StreamSet)->Send,
+        (Type & STREAM_ID_FLAG_IS_UNI_DIR) ?
+            QUIC_CONN_SEND_FLAG_MAX_STREAMS_UNI :
+            QUIC_CONN_SEND_FLAG_MAX_STREAMS_BIDI);
+}
+
+//
+// Doubles the peer's concurrent stream limit, up to the PeerStreamCountMax
+// setting, if the peer is using all of it and memory isn't under pressure.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicStreamSetGrowPeerStreamCount(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint8_t Type
+    )
+{
+    QUIC_CONNECTION* Connection = QuicStreamSetGetConnection(StreamSet);
+    const QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[Type];
+    const uint16_t MaxCount = Connection->Settings->PeerStreamCountMax;
+
+    if (Info->MaxCurrentStreamCount == 0 ||
+        Info->MaxCurrentStreamCount >= MaxCount ||
+        Info->CurrentStreamCount < Info->MaxCurrentStreamCount ||
+        QuicLibraryGetMemoryPressure() != QUIC_MEMORY_PRESSURE_NONE) {
+        return FALSE;
+    }
+
+    const uint16_t Count =
+        (uint16_t)CXPLAT_MIN((uint32_t)Info->MaxCurrentStreamCount * 2, MaxCount);
+    QuicStreamSetUpdateMaxCount(StreamSet, Type, Count);
+    Connection->StreamCredit.StreamCountGrowths++;
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamSetOnPeerStreamsBlocked(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint8_t Type,
+    _In_ uint64_t StreamLimit
+    )
+{
+    const QUIC_STREAM_TYPE_INFO* Info = &StreamSet->Types[Type];
+    QuicStreamSetGetConnection(StreamSet)->StreamCredit.StreamsBlockedFramesReceived++;
+
+    //
+    // The peer might be blocked on credit withheld for batching or under
+    // memory pressure.
+    //
+    QuicStreamSetRestoreWithheldCount(StreamSet, Type, TRUE);
+    if (Info->MaxTotalStreamCount > StreamLimit) {
+        return FALSE;
     }
+
+    return !QuicStreamSetGrowPeerStreamCount(StreamSet, Type);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetGetCreditStatistics(
+    _In_ QUIC_STREAM_SET* StreamSet,
+    _Inout_ QUIC_STREAM_CREDIT_STATISTICS* Stats
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicStreamSetGetConnection(StreamSet);
+    const uint8_t PeerType =
+        QuicConnIsServer(Connection) ? STREAM_ID_FLAG_IS_CLIENT : STREAM_ID_FLAG_IS_SERVER;
+    const QUIC_STREAM_TYPE_INFO* Bidi =
+        &StreamSet->Types[PeerType | STREAM_ID_FLAG_IS_BI_DIR];
+    const QUIC_STREAM_TYPE_INFO* Unidi =
+        &StreamSet->Types[PeerType | STREAM_ID_FLAG_IS_UNI_DIR];
+
+    Stats->PeerBidiMaxStreams = Bidi->MaxTotalStreamCount;
+    Stats->PeerUnidiMaxStreams = Unidi->MaxTotalStreamCount;
+    Stats->PeerBidiStreamCount = Bidi->MaxCurrentStreamCount;
+    Stats->PeerUnidiStreamCount = Unidi->MaxCurrentStreamCount;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -699,6 +1088,93 @@ Exit:
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetIndicatePeerStreamsStarted(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    )
+{
+    QUIC_CONNECTION* Connection = QuicStreamSetGetConnection(StreamSet);
+    const uint32_t Count = Connection->PeerStreamsStartedCount;
+    if (Count == 0) {
+        return;
+    }
+    Connection->PeerStreamsStartedCount = 0;
+
+    //
+    // Leave out the streams the app already closed from their own callbacks,
+    // but keep them referenced until after the event.
+    //
+    QUIC_STREAM* Streams[QUIC_PEER_STREAMS_STARTED_BATCH_MAX];
+    QUIC_PEER_STREAM_STARTED_DATA* Started = Connection->PeerStreamsStarted;
+    uint32_t StartedCount = 0;
+    for (uint32_t i = 0; i < Count; ++i) {
+        Streams[i] = (QUIC_STREAM*)Started[i].Stream;
+        if (!Streams[i]->Flags.HandleClosed) {
+            Started[StartedCount] = Started[i];
+            Started[StartedCount].StreamContext = Streams[i]->ClientContext;
+            StartedCount++;
+        }
+    }
+
+    if (StartedCount != 0) {
+        QUIC_CONNECTION_EVENT Event;
+        Event.Type = QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED;
+        Event.PEER_STREAMS_STARTED.Streams = Started;
+        Event.PEER_STREAMS_STARTED.StreamCount = StartedCount;
+
+        QuicTraceLogConnVerbose(
+            IndicatePeerStreamsStarted,
+            Connection,
+            "Indicating QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED [%u]",
+            StartedCount);
+        (void)QuicConnIndicateEvent(Connection, &Event);
+    }
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        QuicStreamRelease(Streams[i], QUIC_STREAM_REF_OPERATION);
+    }
+}
+
+//
+// Accepts a new peer stream on the app's behalf with the connection's peer
+// stream template, and adds it to the next PEER_STREAMS_STARTED event.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicStreamSetAcceptPeerStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_STREAM_OPEN_FLAGS Flags
+    )
+{
+    QUIC_CONNECTION* Connection = QuicStreamSetGetConnection(StreamSet);
+    const QUIC_PEER_STREAM_TEMPLATE* Template = &Connection->PeerStreamTemplate;
+
+    Stream->ClientCallbackHandler = Template->Handler;
+    Stream->ClientContext =
+        Template->ContextFactory != NULL ?
+            Template->ContextFactory((HQUIC)Connection, (HQUIC)Stream, Template->Context) :
+            Template->Context;
+
+    QuicTraceLogStreamVerbose(
+        AcceptedWithTemplate,
+        Stream,
+        "Accepted with the peer stream template");
+
+    if (Connection->PeerStreamsStartedCount == QUIC_PEER_STREAMS_STARTED_BATCH_MAX) {
+        QuicStreamSetIndicatePeerStreamsStarted(StreamSet);
+    }
+
+    QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+    QUIC_PEER_STREAM_STARTED_DATA* Started =
+        &Connection->PeerStreamsStarted[Connection->PeerStreamsStartedCount++];
+    Started->Stream = (HQUIC)Stream;
+    Started->StreamContext = Stream->ClientContext;
+    Started->Flags = Flags;
+}
+
 #pragma warning(push)
 #pragma warning(disable:6014) // SAL doesn't double ref count semantics
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -784,6 +1260,10 @@ QuicStreamSetGetStreamForPeer(
             if (FrameIn0Rtt) {
                 OpenFlags |= QUIC_STREAM_OPEN_FLAG_0_RTT;
             }
+            const BOOLEAN UseTemplate = Connection->PeerStreamTemplate.Handler != NULL;
+            if (UseTemplate) {
+                OpenFlags |= Connection->PeerStreamTemplate.Flags;
+            }
 
             QUIC_STATUS Status =
                 QuicStreamInitialize(Connection, TRUE, OpenFlags, &Stream);
@@ -815,6 +1295,12 @@ QuicStreamSetGetStreamForPeer(
 
             QuicStreamAddRef(Stream, QUIC_STREAM_REF_STREAM_SET);
 
+            if (UseTemplate) {
+                QuicStreamSetAcceptPeerStream(
+                    StreamSet, Stream, StreamFlags | Connection->PeerStreamTemplate.Flags);
+                continue;
+            }
+
             QUIC_CONNECTION_EVENT Event;
             Event.Type = QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED;
             Event.PEER_STREAM_STARTED.Stream = (HQUIC)Stream;
@@ -856,6 +1342,12 @@ QuicStreamSetGetStreamForPeer(
 
         } while (Info->TotalStreamCount != StreamCount);
 
+        //
+        // The peer used up more of its credit, so any batched credit may now
+        // be needed before it blocks.
+        //
+        QuicStreamSetRestoreWithheldCount(StreamSet, (uint8_t)StreamType, FALSE);
+
     } else {
 
         //
@@ -32,8 +32,32 @@ typedef struct QUIC_STREAM_TYPE_INFO {
     //
     uint16_t CurrentStreamCount;
 
+    //
+    // The number of peer streams whose credit hasn't been given back since
+    // they closed, either to batch MAX_STREAMS updates or because memory was
+    // under critical pressure.
+    //
+    uint16_t WithheldStreamCount;
+
+    //
+    // Direct index of the streams with the most recent IDs of this type, as
+    // a ring of QUIC_STREAM_WINDOW_SIZE slots indexed by (ID >> 2). All
+    // streams in the stream table with an index in [WindowBase, WindowBase +
+    // QUIC_STREAM_WINDOW_SIZE) are in the window; older, long-lived streams
+    // are only in the table. Lazily allocated; NULL if that failed.
+    //
+    QUIC_STREAM** Window;
+    uint64_t WindowBase;
+
 } QUIC_STREAM_TYPE_INFO;
 
+#define QUIC_STREAM_WINDOW_SIZE 64 // Must be a power of 2
+
+//
+// The maximum number of freed streams a connection keeps for reuse.
+//
+#define QUIC_STREAM_RECYCLE_MAX_COUNT 4
+
 typedef struct QUIC_STREAM_SET {
 
     //
@@ -56,6 +80,33 @@ typedef struct QUIC_STREAM_SET {
     //
     CXPLAT_LIST_ENTRY ClosedStreams;
 
+    //
+    // The list of streams with receive data waiting to be indicated in a
+    // batched QUIC_CONNECTION_EVENT_STREAMS_RECEIVE event.
+    //
+    CXPLAT_LIST_ENTRY RecvFlushStreams;
+
+    //
+    // Indicates a QUIC_OPER_TYPE_FLUSH_STREAMS_RECV operation is queued.
+    //
+    BOOLEAN RecvFlushQueued;
+
+    //
+    // The time streams already released spent blocked by stream and stream ID
+    // flow control, in microseconds.
+    //
+    uint64_t ReleasedBlockedByFlowControlUs;
+    uint64_t ReleasedBlockedByIdFlowControlUs;
+
+    //
+    // Freed streams, linked by their ClosedLink, kept to be reused by the
+    // connection's next streams. Each may keep its receive buffer's chunk
+    // in its (otherwise uninitialized) receive buffer.
+    //
+    CXPLAT_DISPATCH_LOCK RecycledStreamsLock;
+    CXPLAT_LIST_ENTRY RecycledStreams;
+    uint32_t RecycledStreamCount;
+
 #if DEBUG
     //
     // The list of allocated streams for leak tracking.
@@ -102,6 +153,62 @@ QuicStreamSetShutdown(
     _Inout_ QUIC_STREAM_SET* StreamSet
     );
 
+//
+// Shrinks the receive buffers of the open streams, and frees the recycled
+// ones, while the connection is idle.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetHibernate(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    );
+
+//
+// Keeps a freed stream, and optionally its receive chunk, for reuse. Returns
+// FALSE if the stream must be returned to its pool instead.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicStreamSetRecycleStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream,
+    _In_opt_ QUIC_RECV_CHUNK* Chunk
+    );
+
+//
+// Takes a recycled stream, if any, along with the receive chunk it kept.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_STREAM*
+QuicStreamSetTakeRecycledStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _Outptr_result_maybenull_ QUIC_RECV_CHUNK** Chunk
+    );
+
+//
+// Adds the memory of the open and recycled streams and their receive buffers
+// to Usage.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetGetMemoryUsage(
+    _In_ QUIC_STREAM_SET* StreamSet,
+    _Inout_ QUIC_MEMORY_USAGE* Usage
+    );
+
+//
+// Returns the time streams spent blocked by stream and stream ID flow control,
+// summed over all the streams.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetGetBlockedTimings(
+    _In_ const QUIC_STREAM_SET* StreamSet,
+    _Out_ uint64_t* FlowControlUs,
+    _Out_ uint64_t* IdFlowControlUs
+    );
+
 //
 // Called to inform the stream set that the stream is ready to be cleaned up.
 // The stream set queued the stream for later deletion.
@@ -156,6 +263,41 @@ QuicStreamSetUpdateMaxCount(
     _In_ uint16_t Count
     );
 
+//
+// Gives the peer back the withheld stream credit, unless memory is critically
+// low. Unless forced, the credit is held back until a whole batch is ready or
+// the peer is running low.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetRestoreWithheldCount(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint8_t Type,
+    _In_ BOOLEAN Force
+    );
+
+//
+// Handles the peer reporting it is blocked on stream ID credit. Returns TRUE
+// if the peer is still blocked after any withheld or grown credit is given.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamSetOnPeerStreamsBlocked(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint8_t Type,
+    _In_ uint64_t StreamLimit
+    );
+
+//
+// Returns the current stream ID credit given to the peer.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetGetCreditStatistics(
+    _In_ QUIC_STREAM_SET* StreamSet,
+    _Inout_ QUIC_STREAM_CREDIT_STATISTICS* Stats
+    );
+
 //
 // Returns the number of available streams still allowed.
 //
@@ -189,6 +331,28 @@ QuicStreamSetNewLocalStream(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Looks up an existing stream object by the stream ID, without validating the
+// ID or creating any streams.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+QUIC_STREAM*
+QuicStreamSetLookupStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint64_t ID
+    );
+
+//
+// Indicates the new peer streams accepted with the connection's peer stream
+// template that haven't been indicated to the app yet.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetIndicatePeerStreamsStarted(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    );
+
 //
 // Does a look up for a peer's stream object, by the stream ID. It may create
 // new streams up to StreamId if the CreateIfMissing flag is set.
@@ -21,28 +21,42 @@ Abstract:
         The timer wheel itself doesn't care about anything other than that value
         from the connection.
 
-        Slots - This is a very simple hash table of time slots. Each slot holds
-        all connections with a next expiration time modulo the total slot count.
+        Levels - The timer wheel is hierarchical. Time is counted in ticks of
+        about a millisecond, and each level has QUIC_TIMER_WHEEL_SLOT_COUNT
+        slots. A slot of the lowest level is a single tick wide, and a slot of
+        each higher level is as wide as the whole level below it. A connection
+        is placed in the lowest level that reaches its next expiration time.
 
-        Slot Entry - Each slot is made up of a sorted, doubly-linked list of
-        connections.
+        Slots - Each slot is an unsorted, doubly-linked list of connections,
+        along with a bit per level marking the slots that may be non-empty.
 
         Next Expiration - Along with all the connections in the timer wheel, the
         timer wheel also explicitly keeps track of the next expiration time and
         connection for quick next delay calculations.
 
-    With these parts, the timer wheel is able to support insertion, update and
-    removal of any number of timers (and their associated connection).
+    With these parts, insertion, update and removal of a connection are all
+    constant time, no matter how many connections are in the timer wheel.
 
     Insertion or update consists of getting the next expiration time from the
-    connection, calculating the correct slot and then doing an insert into the
-    slot's sorted list of connections. Additionally, the next expiration is
-    updated if the new timer is the soonest to expire.
+    connection, picking the level and slot for it and appending the connection
+    to the slot's list. Additionally, the next expiration is updated if the new
+    timer is the soonest to expire.
 
     Removal consists of removing the connection from the doubly-linked list and
     updating the timer wheel's next expiration if this connection was currently
     next to expire.
 
+    As time moves forward, the current tick passes into new slots of the higher
+    levels. The connections in those slots are then cascaded: placed again, in
+    lower levels, relative to the new current tick. Only lowest level slots ever
+    hand out expired connections. Empty stretches of time are skipped over
+    using the occupied slot bits.
+
+    The next expiration time is found exactly if the next connection is in the
+    lowest level, by checking the single tick's worth of connections in its
+    slot. Otherwise it is the time the higher level slot comes due, at which
+    point the slot is cascaded and the next expiration found again.
+
 --*/
 
 #include "precomp.h"
@@ -50,21 +64,20 @@ Abstract:
 #include "timer_wheel.c.clog.h"
 #endif
 
-//
-// The initial count of slots in the timer wheel.
-//
-#define QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT     32
-
-//
-// On average, the max number of connections per slot.
-//
-#define QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR    32
+#define QUIC_TIMER_WHEEL_SLOT_SHIFT 6
+CXPLAT_STATIC_ASSERT(
+    QUIC_TIMER_WHEEL_SLOT_COUNT == (1 << QUIC_TIMER_WHEEL_SLOT_SHIFT),
+    "Slot shift must match the slot count");
 
 //
-// Helper to get the slot index for a given time.
+// Helpers to convert between times and ticks, and to get the slot index of a
+// tick in a given level.
 //
-#define TIME_TO_SLOT_INDEX(TimerWheel, TimeUs) \
-    ((US_TO_MS(TimeUs) / 1000) % (TimerWheel)->SlotCount)
+#define TIME_TO_TICK(TimeUs) ((TimeUs) >> QUIC_TIMER_WHEEL_TICK_SHIFT)
+#define TICK_TO_TIME(Tick) ((Tick) << QUIC_TIMER_WHEEL_TICK_SHIFT)
+#define LEVEL_SHIFT(Level) ((Level) * QUIC_TIMER_WHEEL_SLOT_SHIFT)
+#define TICK_TO_SLOT_INDEX(Tick, Level) \
+    ((uint32_t)((Tick) >> LEVEL_SHIFT(Level)) & (QUIC_TIMER_WHEEL_SLOT_COUNT - 1))
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -75,21 +88,16 @@ QuicTimerWheelInitialize(
     TimerWheel->NextExpirationTime = UINT64_MAX;
     TimerWheel->ConnectionCount = 0;
     TimerWheel->NextConnection = NULL;
-    TimerWheel->SlotCount = QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT;
-    TimerWheel->Slots =
-        CXPLAT_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
-    if (TimerWheel->Slots == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots",
-            QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY));
-        return QUIC_STATUS_OUT_OF_MEMORY;
-    }
+    TimerWheel->CurrentTick = TIME_TO_TICK(CxPlatTimeUs64());
 
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        CxPlatListInitializeHead(&TimerWheel->Slots[i]);
+    for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+        TimerWheel->OccupiedSlots[i] = 0;
+        for (uint32_t j = 0; j < QUIC_TIMER_WHEEL_SLOT_COUNT; ++j) {
+            CxPlatListInitializeHead(&TimerWheel->Slots[i][j]);
+        }
     }
 
+    QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_TIMER_WHEEL, sizeof(QUIC_TIMER_WHEEL));
     return QUIC_STATUS_SUCCESS;
 }
 
@@ -99,9 +107,9 @@ QuicTimerWheelUninitialize(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel
     )
 {
-    if (TimerWheel->Slots != NULL) {
-        for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
+    for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+        for (uint32_t j = 0; j < QUIC_TIMER_WHEEL_SLOT_COUNT; ++j) {
+            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i][j];
             CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
             while (Entry != ListHead) {
                 QUIC_CONNECTION* Connection =
@@ -113,98 +121,119 @@ QuicTimerWheelUninitialize(
                 CXPLAT_DBG_ASSERT(!Connection);
                 Entry = Entry->Flink;
             }
-            CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&TimerWheel->Slots[i]));
+            CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(ListHead));
         }
-        CXPLAT_TEL_ASSERT(TimerWheel->ConnectionCount == 0);
-        CXPLAT_TEL_ASSERT(TimerWheel->NextConnection == NULL);
-        CXPLAT_TEL_ASSERT(TimerWheel->NextExpirationTime == UINT64_MAX);
-
-        CXPLAT_FREE(TimerWheel->Slots, QUIC_POOL_TIMERWHEEL);
     }
+    CXPLAT_TEL_ASSERT(TimerWheel->ConnectionCount == 0);
+    CXPLAT_TEL_ASSERT(TimerWheel->NextConnection == NULL);
+    CXPLAT_TEL_ASSERT(TimerWheel->NextExpirationTime == UINT64_MAX);
+
+    QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_TIMER_WHEEL, -(int64_t)sizeof(QUIC_TIMER_WHEEL));
 }
 
+//
+// Places the connection in the slot for its next expiration time, relative to
+// the current tick.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelResize(
-    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+QuicTimerWheelInsert(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
     )
 {
-    uint32_t NewSlotCount = TimerWheel->SlotCount * 2;
-    if (NewSlotCount <= TimerWheel->SlotCount) {
-        //
-        // Max size has been reached.
-        //
-        return;
-    }
-
-    CXPLAT_LIST_ENTRY* NewSlots =
-        CXPLAT_ALLOC_NONPAGED(NewSlotCount * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
-    if (NewSlots == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots (realloc)",
-            NewSlotCount * sizeof(CXPLAT_LIST_ENTRY));
-        return;
+    const uint64_t CurrentTick = TimerWheel->CurrentTick;
+    uint64_t Tick = TIME_TO_TICK(Connection->EarliestExpirationTime);
+    if (Tick < CurrentTick) {
+        Tick = CurrentTick; // Already due.
     }
 
-    QuicTraceLogVerbose(
-        TimerWheelResize,
-        "[time][%p] Resizing timer wheel (new slot count = %u).",
-        TimerWheel,
-        NewSlotCount);
-
-    for (uint32_t i = 0; i < NewSlotCount; ++i) {
-        CxPlatListInitializeHead(&NewSlots[i]);
+    //
+    // Find the lowest level in which the tick isn't a full lap or more ahead
+    // of the current one.
+    //
+    uint32_t Level = 0;
+    while (Level < QUIC_TIMER_WHEEL_LEVEL_COUNT - 1 &&
+           (Tick >> LEVEL_SHIFT(Level)) - (CurrentTick >> LEVEL_SHIFT(Level)) >=
+                QUIC_TIMER_WHEEL_SLOT_COUNT) {
+        Level++;
     }
 
-    uint32_t OldSlotCount = TimerWheel->SlotCount;
-    CXPLAT_LIST_ENTRY* OldSlots = TimerWheel->Slots;
-
-    TimerWheel->SlotCount = NewSlotCount;
-    TimerWheel->Slots = NewSlots;
-
-    for (uint32_t i = 0; i < OldSlotCount; ++i) {
+    uint32_t SlotIndex;
+    if ((Tick >> LEVEL_SHIFT(Level)) - (CurrentTick >> LEVEL_SHIFT(Level)) >=
+            QUIC_TIMER_WHEEL_SLOT_COUNT) {
         //
-        // Iterate through each old slot, remove all connections and add them
-        // to the new slots.
+        // Too far out for the top level. Wait in its last slot, and get placed
+        // again when that comes due.
         //
-        while (!CxPlatListIsEmpty(&OldSlots[i])) {
-            QUIC_CONNECTION* Connection =
-                CXPLAT_CONTAINING_RECORD(
-                    CxPlatListRemoveHead(&OldSlots[i]),
-                    QUIC_CONNECTION,
-                    TimerLink);
-            uint64_t ExpirationTime = Connection->EarliestExpirationTime;
-            CXPLAT_DBG_ASSERT(TimerWheel->SlotCount != 0);
-            uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-            //
-            // Insert the connection into the slot, in the correct order. We search
-            // the slot's list in reverse order, with the assumption that most new
-            // timers will on average be later than existing ones.
-            //
-            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-            CXPLAT_LIST_ENTRY* Entry = ListHead->Blink;
-
-            while (Entry != ListHead) {
-                QUIC_CONNECTION* ConnectionEntry =
-                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-                uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-
-                if (ExpirationTime > EntryExpirationTime) {
-                    break;
-                }
+        SlotIndex =
+            (TICK_TO_SLOT_INDEX(CurrentTick, Level) + QUIC_TIMER_WHEEL_SLOT_COUNT - 1) &
+            (QUIC_TIMER_WHEEL_SLOT_COUNT - 1);
+    } else {
+        SlotIndex = TICK_TO_SLOT_INDEX(Tick, Level);
+    }
 
-                Entry = Entry->Blink;
-            }
+    CxPlatListInsertTail(&TimerWheel->Slots[Level][SlotIndex], &Connection->TimerLink);
+    TimerWheel->OccupiedSlots[Level] |= 1ull << SlotIndex;
+}
 
+//
+// Returns the tick at which the first non-empty slot of the level after the
+// current one comes due, or UINT64_MAX if there are none.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicTimerWheelNextSlotTick(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint32_t Level
+    )
+{
+    const uint32_t CurrentIndex = TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, Level);
+    for (uint32_t Distance = 1;
+         Distance < QUIC_TIMER_WHEEL_SLOT_COUNT && TimerWheel->OccupiedSlots[Level] != 0;
+         ++Distance) {
+        const uint32_t SlotIndex =
+            (CurrentIndex + Distance) & (QUIC_TIMER_WHEEL_SLOT_COUNT - 1);
+        if (!(TimerWheel->OccupiedSlots[Level] & (1ull << SlotIndex))) {
+            continue;
+        }
+        if (CxPlatListIsEmpty(&TimerWheel->Slots[Level][SlotIndex])) {
             //
-            // Insert after the current entry.
+            // Removing connections doesn't clear the bits, so do it now.
             //
-            CxPlatListInsertHead(Entry, &Connection->TimerLink);
+            TimerWheel->OccupiedSlots[Level] &= ~(1ull << SlotIndex);
+            continue;
         }
+        return
+            ((TimerWheel->CurrentTick >> LEVEL_SHIFT(Level)) + Distance) << LEVEL_SHIFT(Level);
+    }
+    return UINT64_MAX;
+}
+
+//
+// Places the connections in the level's current slot again, in lower levels.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelCascade(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint32_t Level
+    )
+{
+    const uint32_t SlotIndex = TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, Level);
+    CXPLAT_LIST_ENTRY Connections;
+    CxPlatListInitializeHead(&Connections);
+    CxPlatListMoveItems(&TimerWheel->Slots[Level][SlotIndex], &Connections);
+    TimerWheel->OccupiedSlots[Level] &= ~(1ull << SlotIndex);
+
+    while (!CxPlatListIsEmpty(&Connections)) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Connections),
+                QUIC_CONNECTION,
+                TimerLink);
+        QuicTimerWheelInsert(TimerWheel, Connection);
     }
-    CXPLAT_FREE(OldSlots, QUIC_POOL_TIMERWHEEL);
 }
 
 //
@@ -221,25 +250,47 @@ QuicTimerWheelUpdate(
     TimerWheel->NextConnection = NULL;
 
     //
-    // Loop over the slots to find the connection with the earliest
-    // expiration time.
+    // Find the slot that comes due first. Ties go to the higher level, as its
+    // connections may expire earlier in the tick than the lower level's.
     //
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        if (!CxPlatListIsEmpty(&TimerWheel->Slots[i])) {
+    uint64_t NextTick = UINT64_MAX;
+    uint32_t NextLevel = 0;
+    if (!CxPlatListIsEmpty(
+            &TimerWheel->Slots[0][TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, 0)])) {
+        NextTick = TimerWheel->CurrentTick;
+    } else {
+        for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+            uint64_t Tick = QuicTimerWheelNextSlotTick(TimerWheel, i);
+            if (Tick <= NextTick && Tick != UINT64_MAX) {
+                NextTick = Tick;
+                NextLevel = i;
+            }
+        }
+    }
+
+    if (NextTick != UINT64_MAX && NextLevel == 0) {
+        //
+        // Loop over the slot's connections to find the one with the earliest
+        // expiration time.
+        //
+        CXPLAT_LIST_ENTRY* ListHead =
+            &TimerWheel->Slots[0][TICK_TO_SLOT_INDEX(NextTick, 0)];
+        for (CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
+             Entry != ListHead;
+             Entry = Entry->Flink) {
             QUIC_CONNECTION* ConnectionEntry =
-                CXPLAT_CONTAINING_RECORD(
-                    TimerWheel->Slots[i].Flink,
-                    QUIC_CONNECTION,
-                    TimerLink);
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
             uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
             if (EntryExpirationTime < TimerWheel->NextExpirationTime) {
                 TimerWheel->NextExpirationTime = EntryExpirationTime;
                 TimerWheel->NextConnection = ConnectionEntry;
             }
         }
+    } else if (NextTick != UINT64_MAX) {
+        TimerWheel->NextExpirationTime = TICK_TO_TIME(NextTick);
     }
 
-    if (TimerWheel->NextConnection == NULL) {
+    if (TimerWheel->NextExpirationTime == UINT64_MAX) {
         QuicTraceLogVerbose(
             TimerWheelNextExpirationNull,
             "[time][%p] Next Expiration = {NULL}.",
@@ -335,33 +386,7 @@ QuicTimerWheelUpdateConnection(
 
     CXPLAT_DBG_ASSERT(ExpirationTime != UINT64_MAX);
     CXPLAT_DBG_ASSERT(!Connection->State.ShutdownComplete);
-    CXPLAT_DBG_ASSERT(TimerWheel->SlotCount != 0);
-    uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-    //
-    // Insert the connection into the slot, in the correct order. We search
-    // the slot's list in reverse order, with the assumption that most new
-    // timers will on average be later than existing ones.
-    //
-    CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-    CXPLAT_LIST_ENTRY* Entry = ListHead->Blink;
-
-    while (Entry != ListHead) {
-        QUIC_CONNECTION* ConnectionEntry =
-            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-        uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-
-        if (ExpirationTime > EntryExpirationTime) {
-            break;
-        }
-
-        Entry = Entry->Blink;
-    }
-
-    //
-    // Insert after the current entry.
-    //
-    CxPlatListInsertHead(Entry, &Connection->TimerLink);
+    QuicTimerWheelInsert(TimerWheel, Connection);
 
     QuicTraceLogVerbose(
         TimerWheelUpdateConnection,
@@ -384,15 +409,6 @@ QuicTimerWheelUpdateConnection(
     } else if (Connection == TimerWheel->NextConnection) {
         QuicTimerWheelUpdate(TimerWheel);
     }
-
-    //
-    // Resize the timer wheel if we have too many connections for the
-    // current size.
-    //
-    if (TimerWheel->ConnectionCount >
-        TimerWheel->SlotCount * QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR) {
-        QuicTimerWheelResize(TimerWheel);
-    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -403,33 +419,57 @@ QuicTimerWheelGetExpired(
     _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
     )
 {
-    //
-    // Iterate through every slot to find all the connections that now have
-    // expired timers.
-    //
-    BOOLEAN NeedsUpdate = FALSE;
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
+    uint64_t NowTick = TIME_TO_TICK(TimeNow);
+    if (NowTick < TimerWheel->CurrentTick) {
+        NowTick = TimerWheel->CurrentTick;
+    }
+
+    for (;;) {
+        //
+        // Hand out the connections in the current tick's slot that have now
+        // expired. Only the current tick's connections may be left behind.
+        //
+        CXPLAT_LIST_ENTRY* ListHead =
+            &TimerWheel->Slots[0][TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, 0)];
         CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
         while (Entry != ListHead) {
             QUIC_CONNECTION* ConnectionEntry =
                 CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-            uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-            if (EntryExpirationTime > TimeNow) {
-                break;
-            }
             Entry = Entry->Flink;
+            if (ConnectionEntry->EarliestExpirationTime > TimeNow) {
+                continue;
+            }
             CxPlatListEntryRemove(&ConnectionEntry->TimerLink);
             CxPlatListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
-            if (ConnectionEntry == TimerWheel->NextConnection) {
-                NeedsUpdate = TRUE;
-            }
             QuicConnAddRef(ConnectionEntry, QUIC_CONN_REF_WORKER);
             QuicConnRelease(ConnectionEntry, QUIC_CONN_REF_TIMER_WHEEL);
             TimerWheel->ConnectionCount--;
         }
+
+        if (TimerWheel->CurrentTick == NowTick) {
+            break;
+        }
+
+        //
+        // Skip ahead to the next slot that comes due, but no further than now,
+        // and cascade the higher level slots that come due with it.
+        //
+        uint64_t NextTick = NowTick;
+        for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+            uint64_t Tick = QuicTimerWheelNextSlotTick(TimerWheel, i);
+            if (Tick < NextTick) {
+                NextTick = Tick;
+            }
+        }
+        TimerWheel->CurrentTick = NextTick;
+
+        for (uint32_t i = 1; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+            if ((NextTick & ((1ull << LEVEL_SHIFT(i)) - 1)) != 0) {
+                break; // Not the start of a slot in this level or any above.
+            }
+            QuicTimerWheelCascade(TimerWheel, i);
+        }
     }
-    if (NeedsUpdate) {
-        QuicTimerWheelUpdate(TimerWheel);
-    }
+
+    QuicTimerWheelUpdate(TimerWheel);
 }
@@ -5,12 +5,18 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
 typedef struct QUIC_TIMER_WHEEL {
 
     //
-    // The expiration time (in us) for the next timer in the timer wheel.
+    // The expiration time (in us) for the next timer in the timer wheel. When
+    // the next timer is only known to be in a slot of a higher level, this is
+    // the time that slot comes due instead.
     //
     uint64_t NextExpirationTime;
 
@@ -20,19 +26,27 @@ typedef struct QUIC_TIMER_WHEEL {
     uint64_t ConnectionCount;
 
     //
-    // The connection with the timer that expires next.
+    // The connection with the timer that expires next, or NULL if only a lower
+    // bound of the next expiration time is known.
     //
     QUIC_CONNECTION* NextConnection;
 
     //
-    // The number of slots in the Slots array.
+    // The tick (in units of 2^QUIC_TIMER_WHEEL_TICK_SHIFT us) the timer wheel
+    // has been advanced to. Connections due in earlier ticks have been handed
+    // out already.
     //
-    uint32_t SlotCount;
+    uint64_t CurrentTick;
 
     //
-    // An array of slots in the timer wheel.
+    // Per level, a bit for each slot that may hold connections.
     //
-    CXPLAT_LIST_ENTRY* Slots;
+    uint64_t OccupiedSlots[QUIC_TIMER_WHEEL_LEVEL_COUNT];
+
+    //
+    // The slots of each level, holding unsorted lists of connections.
+    //
+    CXPLAT_LIST_ENTRY Slots[QUIC_TIMER_WHEEL_LEVEL_COUNT][QUIC_TIMER_WHEEL_SLOT_COUNT];
 
 } QUIC_TIMER_WHEEL;
 
@@ -85,3 +99,7 @@ QuicTimerWheelGetExpired(
     _In_ uint64_t TimeNow,
     _Inout_ CXPLAT_LIST_ENTRY* ListHead
     );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -115,6 +115,28 @@ typedef struct QUIC_TRANSPORT_PARAMETERS {
     QUIC_VAR_INT CibirLength;
     QUIC_VAR_INT CibirOffset;
 
+    //
+    // The maximum path identifier the endpoint is willing to use initially
+    // (draft-ietf-quic-multipath). The presence of the parameter advertises
+    // support of the Multipath extension.
+    //
+    _Field_range_(0, QUIC_TP_MAX_PATH_ID_MAX)
+    QUIC_VAR_INT InitialMaxPathId;
+
+    //
+    // The maximum number of receive timestamps the endpoint would like in
+    // each ACK_RECEIVE_TIMESTAMPS frame (draft-smith-quic-receive-ts). The
+    // presence of the parameter advertises support of the extension.
+    //
+    QUIC_VAR_INT MaxReceiveTimestampsPerAck;
+
+    //
+    // Indicates the exponent used to decode the timestamp deltas in the
+    // ACK_RECEIVE_TIMESTAMPS frame. If not present, a default of 0 is assumed.
+    //
+    _Field_range_(0, QUIC_TP_RECEIVE_TIMESTAMPS_EXPONENT_MAX)
+    QUIC_VAR_INT ReceiveTimestampsExponent;
+
     //
     // Server specific.
     //
@@ -125,9 +147,16 @@ typedef struct QUIC_TRANSPORT_PARAMETERS {
     uint8_t StatelessResetToken[QUIC_STATELESS_RESET_TOKEN_LENGTH];
 
     //
-    // The server's preferred address.
+    // The server's preferred address, along with the connection ID and
+    // stateless reset token to use with it. Only one address family is kept;
+    // on decode, the one matching the current path is picked when both are
+    // present.
     //
     QUIC_ADDR PreferredAddress;
+    uint8_t PreferredAddressCid[QUIC_MAX_CONNECTION_ID_LENGTH_V1];
+    _Field_range_(0, QUIC_MAX_CONNECTION_ID_LENGTH_V1)
+    uint8_t PreferredAddressCidLength;
+    uint8_t PreferredAddressResetToken[QUIC_STATELESS_RESET_TOKEN_LENGTH];
 
     //
     // The value of the Destination Connection ID field from the first Initial
@@ -0,0 +1,87 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the 0-RTT anti-replay filter.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "AntiReplayTest.cpp.clog.h"
+#endif
+
+struct SmartAntiReplay {
+    QUIC_ANTI_REPLAY AntiReplay;
+    SmartAntiReplay() { QuicAntiReplayInitialize(&AntiReplay); }
+    ~SmartAntiReplay() { QuicAntiReplayUninitialize(&AntiReplay); }
+    QUIC_STATUS Configure(uint32_t FilterBytes, uint32_t WindowMs) {
+        QUIC_ZERORTT_ANTI_REPLAY_CONFIG Config = { FilterBytes, WindowMs };
+        return QuicAntiReplaySetConfig(&AntiReplay, &Config);
+    }
+    BOOLEAN Check(uint64_t Digest) { return QuicAntiReplayCheck(&AntiReplay, Digest); }
+};
+
+TEST(AntiReplayTest, Config)
+{
+    SmartAntiReplay Filter;
+    ASSERT_FALSE(QuicAntiReplayIsEnabled(&Filter.AntiReplay));
+
+    //
+    // Too small for a word per shard generation.
+    //
+    ASSERT_EQ(QUIC_STATUS_INVALID_PARAMETER, Filter.Configure(64, 0));
+    ASSERT_FALSE(QuicAntiReplayIsEnabled(&Filter.AntiReplay));
+
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Filter.Configure(64 * 1024, 0));
+    ASSERT_TRUE(QuicAntiReplayIsEnabled(&Filter.AntiReplay));
+    ASSERT_EQ((uint32_t)QUIC_DEFAULT_ZERORTT_ANTI_REPLAY_WINDOW_MS, Filter.AntiReplay.Config.WindowMs);
+
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Filter.Configure(0, 0));
+    ASSERT_FALSE(QuicAntiReplayIsEnabled(&Filter.AntiReplay));
+}
+
+TEST(AntiReplayTest, DetectsReplay)
+{
+    SmartAntiReplay Filter;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Filter.Configure(64 * 1024, 60000));
+
+    const uint32_t Count = 1000;
+    for (uint64_t i = 1; i <= Count; ++i) {
+        ASSERT_TRUE(Filter.Check(i * 0x9E3779B97F4A7C15ull));
+    }
+    for (uint64_t i = 1; i <= Count; ++i) {
+        ASSERT_FALSE(Filter.Check(i * 0x9E3779B97F4A7C15ull));
+    }
+
+    //
+    // With ~250 bits per entry, unseen digests are all new.
+    //
+    uint32_t FalsePositives = 0;
+    for (uint64_t i = Count + 1; i <= 2 * Count; ++i) {
+        if (!Filter.Check(i * 0x9E3779B97F4A7C15ull)) {
+            ++FalsePositives;
+        }
+    }
+    ASSERT_EQ(0u, FalsePositives);
+}
+
+TEST(AntiReplayTest, Expires)
+{
+    SmartAntiReplay Filter;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Filter.Configure(4 * 1024, 50));
+
+    ASSERT_TRUE(Filter.Check(1));
+    ASSERT_FALSE(Filter.Check(1));
+
+    //
+    // Remembered for at least one window, and forgotten after two.
+    //
+    CxPlatSleep(60);
+    ASSERT_FALSE(Filter.Check(1));
+    CxPlatSleep(120);
+    ASSERT_TRUE(Filter.Check(1));
+}
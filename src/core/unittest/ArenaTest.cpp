@@ -0,0 +1,68 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the QUIC_ARENA bump allocator.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "ArenaTest.cpp.clog.h"
+#endif
+
+struct SmartArena {
+    QUIC_ARENA arena;
+    SmartArena() { QuicArenaInitialize(&arena); }
+    ~SmartArena() { QuicArenaReset(&arena); }
+    uint8_t* Alloc(uint32_t Size, uint8_t Fill) {
+        uint8_t* Object = (uint8_t*)QuicArenaAlloc(&arena, Size);
+        if (Object != nullptr) {
+            for (uint32_t i = 0; i < Size; ++i) {
+                Object[i] = Fill;
+            }
+        }
+        return Object;
+    }
+};
+
+TEST(ArenaTest, AllocAligned)
+{
+    SmartArena Arena;
+    for (uint32_t Size = 1; Size < 100; ++Size) {
+        uint8_t* Object = Arena.Alloc(Size, (uint8_t)Size);
+        ASSERT_NE(nullptr, Object);
+        ASSERT_EQ(0u, (uintptr_t)Object % QUIC_ARENA_ALIGNMENT);
+    }
+}
+
+TEST(ArenaTest, ObjectsDontOverlap)
+{
+    SmartArena Arena;
+    const uint32_t Sizes[] = { 7, 300, 2 * QUIC_ARENA_CHUNK_SIZE, 16, 1, QUIC_ARENA_CHUNK_SIZE, 45 };
+    uint8_t* Objects[ARRAYSIZE(Sizes)];
+    for (uint32_t i = 0; i < ARRAYSIZE(Sizes); ++i) {
+        Objects[i] = Arena.Alloc(Sizes[i], (uint8_t)(i + 1));
+        ASSERT_NE(nullptr, Objects[i]);
+    }
+    for (uint32_t i = 0; i < ARRAYSIZE(Sizes); ++i) {
+        for (uint32_t j = 0; j < Sizes[i]; ++j) {
+            ASSERT_EQ((uint8_t)(i + 1), Objects[i][j]);
+        }
+    }
+}
+
+TEST(ArenaTest, Reset)
+{
+    SmartArena Arena;
+    for (uint32_t Round = 0; Round < 3; ++Round) {
+        for (uint32_t i = 0; i < 100; ++i) {
+            ASSERT_NE(nullptr, Arena.Alloc(40, 0xAB));
+        }
+        QuicArenaReset(&Arena.arena);
+        ASSERT_EQ(nullptr, Arena.arena.Chunks);
+    }
+}
@@ -0,0 +1,299 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit tests for BBRv3 congestion control.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "Bbr3Test.cpp.clog.h"
+#endif
+
+//
+// Helper to create a minimal valid connection for testing BBRv3. Uses a real
+// QUIC_CONNECTION structure so QuicCongestionControlGetConnection() works.
+//
+static QUIC_SETTINGS_INTERNAL MockConnectionSettings;
+
+static void InitializeMockConnection(
+    QUIC_CONNECTION& Connection,
+    uint16_t Mtu)
+{
+    CxPlatZeroMemory(&Connection, sizeof(Connection));
+
+    Connection.Paths[0].Mtu = Mtu;
+    Connection.Paths[0].IsActive = TRUE;
+    Connection.Send.NextPacketNumber = 0;
+    CxPlatZeroMemory(&MockConnectionSettings, sizeof(MockConnectionSettings));
+    Connection.Settings = &MockConnectionSettings;
+    MockConnectionSettings.PacingEnabled = FALSE;
+}
+
+static void InitializeBbr3(
+    QUIC_CONNECTION& Connection,
+    uint32_t InitialWindowPackets)
+{
+    QUIC_SETTINGS_INTERNAL Settings{};
+    Settings.InitialWindowPackets = InitialWindowPackets;
+
+    InitializeMockConnection(Connection, 1280);
+    Bbr3CongestionControlInitialize(&Connection.CongestionControl, &Settings);
+}
+
+static void AckBytes(
+    QUIC_CONNECTION& Connection,
+    uint64_t TimeNow,
+    uint64_t LargestAck,
+    uint32_t Bytes)
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+
+    QUIC_ACK_EVENT AckEvent;
+    CxPlatZeroMemory(&AckEvent, sizeof(AckEvent));
+    AckEvent.TimeNow = TimeNow;
+    AckEvent.LargestAck = LargestAck;
+    AckEvent.LargestSentPacketNumber = LargestAck + 10;
+    AckEvent.NumRetransmittableBytes = Bytes;
+    AckEvent.NumTotalAckedRetransmittableBytes = Bytes * LargestAck;
+    AckEvent.MinRtt = 50000;
+    AckEvent.MinRttValid = TRUE;
+    AckEvent.AdjustedAckTime = TimeNow;
+
+    Bbr3->BytesInFlight += Bytes;
+    Connection.CongestionControl.QuicCongestionControlOnDataAcknowledged(
+        &Connection.CongestionControl, &AckEvent);
+}
+
+//
+// Scenario: Initialization starts in STARTUP with no model bounds learned and
+// plugs in the ECN and delivery rate callbacks (unlike BBR, BBRv3 reacts to ECN).
+//
+TEST(Bbr3Test, Initialize)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 10);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+
+    ASSERT_STREQ(Connection.CongestionControl.Name, "BBR3");
+    ASSERT_NE(Connection.CongestionControl.QuicCongestionControlOnEcn, nullptr);
+    ASSERT_NE(Connection.CongestionControl.QuicCongestionControlGetDeliveryRate, nullptr);
+
+    ASSERT_EQ(Bbr3->State, (uint32_t)BBR3_STATE_STARTUP);
+    ASSERT_FALSE(Bbr3->FilledPipe);
+    ASSERT_FALSE(Bbr3->InRecovery);
+    ASSERT_EQ(Bbr3->InflightHi, UINT32_MAX);
+    ASSERT_EQ(Bbr3->InflightLo, UINT32_MAX);
+    ASSERT_EQ(Bbr3->BwLo, UINT64_MAX);
+    ASSERT_EQ(Bbr3->BytesInFlight, 0u);
+    ASSERT_EQ(Bbr3->CongestionWindow, Bbr3->InitialCongestionWindow);
+    ASSERT_GT(Bbr3->CongestionWindow, 0u);
+    ASSERT_TRUE(QuicCongestionControlCanSend(&Connection.CongestionControl));
+}
+
+//
+// Scenario: Acks in STARTUP grow the congestion window like slow start.
+//
+TEST(Bbr3Test, StartupGrowsWindow)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 10);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+    uint32_t InitialWindow = Bbr3->CongestionWindow;
+
+    uint64_t TimeNow = CxPlatTimeUs64();
+    AckBytes(Connection, TimeNow, 1, 1200);
+    AckBytes(Connection, TimeNow + 1000, 2, 1200);
+
+    ASSERT_EQ(Bbr3->State, (uint32_t)BBR3_STATE_STARTUP);
+    ASSERT_GT(Bbr3->CongestionWindow, InitialWindow);
+    ASSERT_EQ(Bbr3->MinRtt, 50000u);
+}
+
+//
+// Scenario: An isolated loss in STARTUP reduces the window but doesn't end
+// STARTUP; the loss rate must be high over enough loss events.
+//
+TEST(Bbr3Test, StartupIgnoresIsolatedLoss)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 20);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+    uint32_t InitialWindow = Bbr3->CongestionWindow;
+
+    Bbr3->BytesInFlight = 12000;
+
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.NumRetransmittableBytes = 1200;
+    LossEvent.LargestPacketNumberLost = 5;
+    LossEvent.LargestSentPacketNumber = 10;
+
+    Connection.CongestionControl.QuicCongestionControlOnDataLost(
+        &Connection.CongestionControl, &LossEvent);
+
+    ASSERT_EQ(Bbr3->State, (uint32_t)BBR3_STATE_STARTUP);
+    ASSERT_FALSE(Bbr3->FilledPipe);
+    ASSERT_TRUE(Bbr3->InRecovery);
+    ASSERT_EQ(Bbr3->PriorCongestionWindow, InitialWindow);
+    ASSERT_LT(Bbr3->CongestionWindow, InitialWindow);
+    ASSERT_EQ(Bbr3->BytesInFlight, 10800u);
+}
+
+//
+// Scenario: ECN marks in STARTUP mean the pipe is full; BBRv3 bounds
+// InflightHi and moves on to DRAIN.
+//
+TEST(Bbr3Test, EcnExitsStartup)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 10);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+    uint64_t EcnCount = Connection.Stats.Send.EcnCongestionCount;
+
+    QUIC_ECN_EVENT EcnEvent;
+    CxPlatZeroMemory(&EcnEvent, sizeof(EcnEvent));
+    EcnEvent.LargestPacketNumberAcked = 5;
+    EcnEvent.LargestSentPacketNumber = 10;
+
+    Connection.CongestionControl.QuicCongestionControlOnEcn(
+        &Connection.CongestionControl, &EcnEvent);
+
+    ASSERT_EQ(Bbr3->State, (uint32_t)BBR3_STATE_DRAIN);
+    ASSERT_TRUE(Bbr3->FilledPipe);
+    ASSERT_TRUE(Bbr3->EcnInRound);
+    ASSERT_NE(Bbr3->InflightHi, UINT32_MAX);
+    ASSERT_EQ(Connection.Stats.Send.EcnCongestionCount, EcnCount + 1);
+}
+
+//
+// Scenario: A loss rate above the 2% threshold while probing in ProbeBW_UP
+// lowers InflightHi to what the path carried and ends the probe (ProbeBW_DOWN).
+//
+TEST(Bbr3Test, HighLossWhileProbingBoundsInflightHi)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 10);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+
+    Bbr3->FilledPipe = TRUE;
+    Bbr3->State = BBR3_STATE_PROBE_BW_UP;
+    Bbr3->BwProbeSamples = TRUE;
+    Bbr3->BytesInFlight = 40000;
+    Bbr3->DeliveredInRound = 20000;
+
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.NumRetransmittableBytes = 2400; // ~11% loss in the round
+    LossEvent.LargestPacketNumberLost = 20;
+    LossEvent.LargestSentPacketNumber = 40;
+
+    Connection.CongestionControl.QuicCongestionControlOnDataLost(
+        &Connection.CongestionControl, &LossEvent);
+
+    ASSERT_EQ(Bbr3->State, (uint32_t)BBR3_STATE_PROBE_BW_DOWN);
+    ASSERT_FALSE(Bbr3->BwProbeSamples);
+    ASSERT_EQ(Bbr3->InflightHi, 40000u);
+}
+
+//
+// Scenario: A loss rate under the threshold while probing leaves InflightHi
+// unset and keeps probing.
+//
+TEST(Bbr3Test, LowLossWhileProbingKeepsProbing)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 10);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+
+    Bbr3->FilledPipe = TRUE;
+    Bbr3->State = BBR3_STATE_PROBE_BW_UP;
+    Bbr3->BwProbeSamples = TRUE;
+    Bbr3->BytesInFlight = 200000;
+    Bbr3->DeliveredInRound = 200000;
+
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.NumRetransmittableBytes = 1200; // ~0.6% loss in the round
+    LossEvent.LargestPacketNumberLost = 20;
+    LossEvent.LargestSentPacketNumber = 200;
+
+    Connection.CongestionControl.QuicCongestionControlOnDataLost(
+        &Connection.CongestionControl, &LossEvent);
+
+    ASSERT_EQ(Bbr3->State, (uint32_t)BBR3_STATE_PROBE_BW_UP);
+    ASSERT_TRUE(Bbr3->BwProbeSamples);
+    ASSERT_EQ(Bbr3->InflightHi, UINT32_MAX);
+}
+
+//
+// Scenario: At the end of a round with loss outside of probing, the short term
+// lower bounds back off and then cap the congestion window.
+//
+TEST(Bbr3Test, LossAdaptsLowerBoundsAtRoundEnd)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 10);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+
+    uint64_t TimeNow = CxPlatTimeUs64();
+    AckBytes(Connection, TimeNow, 1, 1200);
+
+    Bbr3->FilledPipe = TRUE;
+    Bbr3->State = BBR3_STATE_PROBE_BW_CRUISE;
+    Bbr3->CycleStart = TimeNow;
+    Bbr3->BwProbeWait = S_TO_US(10);
+    Bbr3->RoundsSinceBwProbe = 0;
+    Bbr3->CongestionWindow = 100000;
+    Bbr3->LossInRound = TRUE;
+
+    //
+    // Acking past EndOfRoundTrip starts a new round.
+    //
+    AckBytes(Connection, TimeNow + 1000, Bbr3->EndOfRoundTrip + 1, 1200);
+
+    ASSERT_NE(Bbr3->InflightLo, UINT32_MAX);
+    ASSERT_NE(Bbr3->BwLo, UINT64_MAX);
+    ASSERT_LE(Bbr3->CongestionWindow, Bbr3->InflightLo);
+    ASSERT_LE(Bbr3->InflightLo, 100000u * 7 / 10 + 1);
+    ASSERT_FALSE(Bbr3->LossInRound);
+}
+
+//
+// Scenario: A persistent congestion loss collapses the window to the minimum.
+//
+TEST(Bbr3Test, PersistentCongestion)
+{
+    QUIC_CONNECTION Connection;
+    InitializeBbr3(Connection, 20);
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr3 = &Connection.CongestionControl.Bbr3;
+
+    Bbr3->BytesInFlight = 12000;
+
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.NumRetransmittableBytes = 6000;
+    LossEvent.PersistentCongestion = TRUE;
+    LossEvent.LargestPacketNumberLost = 5;
+    LossEvent.LargestSentPacketNumber = 10;
+
+    Connection.CongestionControl.QuicCongestionControlOnDataLost(
+        &Connection.CongestionControl, &LossEvent);
+
+    ASSERT_EQ(
+        Bbr3->CongestionWindow,
+        4u * QuicPathGetDatagramPayloadSize(&Connection.Paths[0]));
+    ASSERT_EQ(Connection.Stats.Send.PersistentCongestionCount, 1u);
+}
@@ -0,0 +1,722 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Deterministic network simulation for the congestion control algorithms.
+
+    Each simulated flow drives a real QUIC_CONGESTION_CONTROL instance through
+    its vtable, in simulated time, over a shared bottleneck link modeled by its
+    bandwidth, propagation delay, drop-tail buffer, random loss, ECN marking
+    threshold and ACK jitter. The receiver acknowledges every packet, and the
+    sender does simplified loss detection (packet and time thresholds) and
+    pacing (1 ms timer), like the real send path.
+
+    Throughput, RTT and congestion window are sampled into a time series per
+    flow, which is recorded (with the summary values) as test properties, so
+    that runs with --gtest_output=xml|json can be used to compare algorithms.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "CongestionControlSimTest.cpp.clog.h"
+#endif
+
+#include <deque>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#define SIM_MTU                     1500
+#define SIM_TICK_US                 1000    // Pacing and loss timer granularity.
+#define SIM_SAMPLE_INTERVAL_US      100000  // Time series resolution.
+#define SIM_PACKET_THRESHOLD        3
+#define SIM_INITIAL_RTT_US          333000
+
+struct SimLink {
+    uint64_t BandwidthBps;          // bits per second
+    uint64_t OneWayDelayUs;
+    uint32_t BufferBytes;           // drop-tail queue size
+    uint32_t EcnThresholdBytes;     // CE mark above this queue size, 0 to disable
+    uint32_t LossPerMillion;        // random loss before the queue
+    uint64_t AckJitterUs;           // max extra delay on the ACK path
+};
+
+struct SimSample {
+    uint64_t TimeMs;
+    uint64_t ThroughputKbps;
+    uint64_t RttUs;
+    uint32_t CongestionWindow;
+};
+
+struct SimPacket {
+    QUIC_SENT_PACKET_METADATA* Metadata;
+    bool CeMarked;
+    bool Done;                      // Acknowledged or declared lost
+};
+
+struct SimFlow {
+    QUIC_CONNECTION* Connection;
+    QUIC_SETTINGS_INTERNAL* Settings;
+    uint64_t StartTime;
+
+    //
+    // Outstanding packets, in packet number order.
+    //
+    std::deque<SimPacket> Outstanding;
+    uint64_t NextPacketNumber;
+    uint64_t LastSendTime;
+    bool LastSendTimeValid;
+    uint64_t LastAckTime;           // ACKs are delivered in order
+
+    //
+    // Delivery rate sampling state, as kept by loss detection.
+    //
+    uint64_t TotalBytesSent;
+    uint64_t TotalBytesAcked;
+    uint64_t TotalBytesSentAtLastAck;
+    uint64_t TimeOfLastPacketAcked;
+    uint64_t TimeOfLastAckedPacketSent;
+    uint64_t LargestAck;
+    uint64_t DeliveryRate;          // bits per second
+
+    //
+    // Statistics.
+    //
+    uint64_t DeliveredBytes;
+    uint64_t DeliveredBytesAfterWarmup;
+    uint64_t LostPackets;
+    uint64_t IntervalBytes;
+    uint64_t IntervalRttSumUs;
+    uint64_t IntervalRttCount;
+    std::vector<SimSample> Series;
+};
+
+struct SimAck {
+    uint64_t Time;
+    size_t Flow;
+    uint64_t PacketNumber;
+    bool operator>(const SimAck& Other) const {
+        return Time != Other.Time ? Time > Other.Time : Flow > Other.Flow;
+    }
+};
+
+class CongestionControlSim {
+public:
+    CongestionControlSim(const SimLink& Link, uint32_t Seed = 1) :
+        Link(Link), Random(Seed) {
+        //
+        // Some algorithms read the real clock during initialization, so run
+        // the simulation from the current time.
+        //
+        Now = CxPlatTimeUs64();
+        Start = Now;
+        LinkFreeTime = Now;
+    }
+
+    ~CongestionControlSim() {
+        for (auto& Flow : Flows) {
+            for (auto& Packet : Flow.Outstanding) {
+                CXPLAT_FREE(Packet.Metadata, QUIC_POOL_TEST);
+            }
+            CXPLAT_FREE(Flow.Connection, QUIC_POOL_TEST);
+            CXPLAT_FREE(Flow.Settings, QUIC_POOL_TEST);
+        }
+    }
+
+    size_t AddFlow(
+        QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm,
+        uint64_t StartTimeUs = 0,
+        bool HyStartEnabled = true) {
+        SimFlow Flow{};
+        Flow.Connection =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Flow.Connection != NULL);
+        CxPlatZeroMemory(Flow.Connection, sizeof(QUIC_CONNECTION));
+        QUIC_CONNECTION* Connection = Flow.Connection;
+        Connection->Paths[0].Mtu = SIM_MTU;
+        Connection->Paths[0].IsActive = TRUE;
+        Connection->Paths[0].SmoothedRtt = SIM_INITIAL_RTT_US;
+        Flow.Settings =
+            (QUIC_SETTINGS_INTERNAL*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_SETTINGS_INTERNAL), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Flow.Settings != NULL);
+        CxPlatZeroMemory(Flow.Settings, sizeof(QUIC_SETTINGS_INTERNAL));
+        Flow.Settings->InitialWindowPackets = QUIC_INITIAL_WINDOW_PACKETS;
+        Flow.Settings->SendIdleTimeoutMs = QUIC_DEFAULT_SEND_IDLE_TIMEOUT_MS;
+        Flow.Settings->PacingEnabled = TRUE;
+        Flow.Settings->HyStartEnabled = HyStartEnabled;
+        Flow.Settings->CongestionControlAlgorithm = (uint16_t)Algorithm;
+        Connection->Settings = Flow.Settings;
+        QuicCongestionControlInitialize(&Connection->CongestionControl, Flow.Settings);
+        Flow.StartTime = Start + StartTimeUs;
+        Flows.push_back(Flow);
+        return Flows.size() - 1;
+    }
+
+    //
+    // Runs the simulation for the given duration. Statistics after WarmupUs
+    // are also accumulated separately, to measure the steady state.
+    //
+    void Run(uint64_t DurationUs, uint64_t WarmupUs) {
+        const uint64_t End = Start + DurationUs;
+        WarmupEnd = Start + WarmupUs;
+        uint64_t NextTick = Start;
+        uint64_t NextSample = Start + SIM_SAMPLE_INTERVAL_US;
+
+        while (Now < End) {
+            uint64_t NextEvent = CXPLAT_MIN(NextTick, NextSample);
+            if (!Acks.empty() && Acks.top().Time < NextEvent) {
+                NextEvent = Acks.top().Time;
+            }
+            Now = NextEvent;
+
+            bool AckProcessed = false;
+            while (!Acks.empty() && Acks.top().Time <= Now) {
+                SimAck Ack = Acks.top();
+                Acks.pop();
+                OnAck(Flows[Ack.Flow], Ack.PacketNumber);
+                AckProcessed = true;
+            }
+
+            const bool Tick = Now >= NextTick;
+            if (Tick) {
+                for (auto& Flow : Flows) {
+                    DetectTimeoutLosses(Flow);
+                }
+                NextTick = Now + SIM_TICK_US;
+            }
+
+            if (AckProcessed || Tick) {
+                for (size_t i = 0; i < Flows.size(); ++i) {
+                    Send(i);
+                }
+            }
+
+            if (Now >= NextSample) {
+                for (auto& Flow : Flows) {
+                    Sample(Flow);
+                }
+                NextSample += SIM_SAMPLE_INTERVAL_US;
+            }
+        }
+        RunDuration = DurationUs;
+        WarmupDuration = WarmupUs;
+    }
+
+    const SimFlow& GetFlow(size_t Index) const { return Flows[Index]; }
+
+    uint64_t BaseRttUs() const {
+        return 2 * Link.OneWayDelayUs + (uint64_t)SIM_MTU * 8 * 1000000 / Link.BandwidthBps;
+    }
+
+    //
+    // Throughput of the flow after the warmup, in kbps.
+    //
+    uint64_t SteadyThroughputKbps(size_t Index) const {
+        return Flows[Index].DeliveredBytesAfterWarmup * 8 * 1000 / (RunDuration - WarmupDuration);
+    }
+
+    //
+    // Fraction of the link used by all flows after the warmup, in percent.
+    //
+    uint64_t SteadyUtilizationPercent() const {
+        uint64_t Kbps = 0;
+        for (size_t i = 0; i < Flows.size(); ++i) {
+            Kbps += SteadyThroughputKbps(i);
+        }
+        return Kbps * 1000 * 100 / Link.BandwidthBps;
+    }
+
+    //
+    // Average queuing delay (RTT above the base RTT) seen by the flow after
+    // the warmup.
+    //
+    uint64_t SteadyQueuingDelayUs(size_t Index) const {
+        const SimFlow& Flow = Flows[Index];
+        uint64_t Sum = 0, Count = 0;
+        for (const auto& S : Flow.Series) {
+            if (S.TimeMs * 1000 > WarmupDuration && S.RttUs != 0) {
+                Sum += S.RttUs;
+                Count++;
+            }
+        }
+        if (Count == 0) {
+            return 0;
+        }
+        const uint64_t AvgRtt = Sum / Count;
+        return AvgRtt > BaseRttUs() ? AvgRtt - BaseRttUs() : 0;
+    }
+
+    //
+    // The latest delivery rate estimate, in bits per second.
+    //
+    uint64_t DeliveryRate(size_t Index) const {
+        return Flows[Index].DeliveryRate;
+    }
+
+    //
+    // Jain's fairness index of the steady state throughputs, in percent.
+    //
+    uint64_t JainFairnessPercent() const {
+        double Sum = 0, SumSq = 0;
+        for (size_t i = 0; i < Flows.size(); ++i) {
+            double X = (double)SteadyThroughputKbps(i);
+            Sum += X;
+            SumSq += X * X;
+        }
+        if (SumSq == 0) {
+            return 0;
+        }
+        return (uint64_t)(100 * Sum * Sum / (Flows.size() * SumSq));
+    }
+
+    //
+    // Records the flow's results as properties of the current test.
+    //
+    void Record(const char* Prefix, size_t Index) const {
+        const std::string P = Prefix;
+        const SimFlow& Flow = Flows[Index];
+        ::testing::Test::RecordProperty(P + ".ThroughputKbps", std::to_string(SteadyThroughputKbps(Index)));
+        ::testing::Test::RecordProperty(P + ".QueuingDelayUs", std::to_string(SteadyQueuingDelayUs(Index)));
+        ::testing::Test::RecordProperty(P + ".LostPackets", std::to_string(Flow.LostPackets));
+        std::string Series;
+        for (const auto& S : Flow.Series) {
+            Series += std::to_string(S.TimeMs) + ":" + std::to_string(S.ThroughputKbps) + ":" +
+                std::to_string(S.RttUs) + ":" + std::to_string(S.CongestionWindow) + ";";
+        }
+        ::testing::Test::RecordProperty(P + ".Series", Series);
+    }
+
+private:
+    const SimLink Link;
+    std::vector<SimFlow> Flows;
+    std::priority_queue<SimAck, std::vector<SimAck>, std::greater<SimAck>> Acks;
+    uint64_t Now;
+    uint64_t Start;
+    uint64_t WarmupEnd {0};
+    uint64_t RunDuration {0};
+    uint64_t WarmupDuration {0};
+    uint64_t LinkFreeTime;          // When the bottleneck queue drains
+    uint32_t Random;
+
+    uint32_t NextRandom() {
+        Random = Random * 1103515245 + 12345;
+        return (Random >> 8) & 0xFFFFFF;
+    }
+
+    uint32_t QueuedBytes() const {
+        if (LinkFreeTime <= Now) {
+            return 0;
+        }
+        return (uint32_t)((LinkFreeTime - Now) * Link.BandwidthBps / 8 / 1000000);
+    }
+
+    void Send(size_t Index) {
+        SimFlow& Flow = Flows[Index];
+        QUIC_CONNECTION* Connection = Flow.Connection;
+        QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+        if (Now < Flow.StartTime) {
+            return;
+        }
+
+        const uint16_t PacketLength = QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+        uint32_t Allowance =
+            QuicCongestionControlGetSendAllowance(
+                Cc,
+                Flow.LastSendTimeValid ? CxPlatTimeDiff64(Flow.LastSendTime, Now) : 0,
+                Flow.LastSendTimeValid);
+        bool Sent = false;
+        while (Allowance > 0 && QuicCongestionControlCanSend(Cc)) {
+            SendPacket(Index, PacketLength);
+            Allowance = Allowance > PacketLength ? Allowance - PacketLength : 0;
+            Sent = true;
+        }
+        if (Sent) {
+            Flow.LastSendTime = Now;
+            Flow.LastSendTimeValid = true;
+        }
+    }
+
+    void SendPacket(size_t Index, uint16_t PacketLength) {
+        SimFlow& Flow = Flows[Index];
+        QUIC_CONNECTION* Connection = Flow.Connection;
+        QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+
+        QUIC_SENT_PACKET_METADATA* Metadata =
+            (QUIC_SENT_PACKET_METADATA*)CXPLAT_ALLOC_NONPAGED(
+                sizeof(QUIC_SENT_PACKET_METADATA), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Metadata != NULL);
+        CxPlatZeroMemory(Metadata, sizeof(QUIC_SENT_PACKET_METADATA));
+        Metadata->PacketNumber = Flow.NextPacketNumber++;
+        Metadata->SentTime = Now;
+        Metadata->PacketLength = PacketLength;
+        Metadata->Flags.IsAckEliciting = TRUE;
+        Metadata->Flags.IsAppLimited = QuicCongestionControlIsAppLimited(Cc);
+        Flow.TotalBytesSent += PacketLength;
+        Metadata->TotalBytesSent = Flow.TotalBytesSent;
+        if (Flow.TimeOfLastPacketAcked) {
+            Metadata->Flags.HasLastAckedPacketInfo = TRUE;
+            Metadata->LastAckedPacketInfo.SentTime = Flow.TimeOfLastAckedPacketSent;
+            Metadata->LastAckedPacketInfo.AckTime = Flow.TimeOfLastPacketAcked;
+            Metadata->LastAckedPacketInfo.AdjustedAckTime = Flow.TimeOfLastPacketAcked;
+            Metadata->LastAckedPacketInfo.TotalBytesSent = Flow.TotalBytesSentAtLastAck;
+            Metadata->LastAckedPacketInfo.TotalBytesAcked = Flow.TotalBytesAcked;
+        }
+        Connection->Send.NextPacketNumber = Flow.NextPacketNumber;
+        Connection->LossDetection.LargestSentPacketNumber = Metadata->PacketNumber;
+
+        SimPacket Packet;
+        Packet.Metadata = Metadata;
+        Packet.Done = false;
+        Packet.CeMarked = false;
+
+        const uint32_t Queued = QueuedBytes();
+        const bool RandomLoss =
+            Link.LossPerMillion != 0 &&
+            (uint64_t)NextRandom() * 1000000 < (uint64_t)Link.LossPerMillion * 0x1000000;
+        if (!RandomLoss && Queued + PacketLength <= Link.BufferBytes) {
+            Packet.CeMarked = Link.EcnThresholdBytes != 0 && Queued > Link.EcnThresholdBytes;
+            LinkFreeTime =
+                CXPLAT_MAX(LinkFreeTime, Now) +
+                (uint64_t)PacketLength * 8 * 1000000 / Link.BandwidthBps;
+            uint64_t AckTime = LinkFreeTime + 2 * Link.OneWayDelayUs;
+            if (Link.AckJitterUs != 0) {
+                AckTime += NextRandom() % Link.AckJitterUs;
+            }
+            Flow.LastAckTime = CXPLAT_MAX(AckTime, Flow.LastAckTime);
+            Acks.push({Flow.LastAckTime, Index, Metadata->PacketNumber});
+        }
+        Flow.Outstanding.push_back(Packet);
+
+        QuicCongestionControlOnDataSent(Cc, PacketLength);
+    }
+
+    void UpdateRtt(QUIC_PATH* Path, uint64_t LatestRtt) {
+        if (!Path->GotFirstRttSample) {
+            Path->GotFirstRttSample = TRUE;
+            Path->MinRtt = Path->MaxRtt = Path->SmoothedRtt = LatestRtt;
+            Path->RttVariance = LatestRtt / 2;
+        } else {
+            Path->MinRtt = CXPLAT_MIN(Path->MinRtt, LatestRtt);
+            Path->MaxRtt = CXPLAT_MAX(Path->MaxRtt, LatestRtt);
+            const uint64_t Diff =
+                Path->SmoothedRtt > LatestRtt ?
+                    Path->SmoothedRtt - LatestRtt : LatestRtt - Path->SmoothedRtt;
+            Path->RttVariance = (3 * Path->RttVariance + Diff) / 4;
+            Path->SmoothedRtt = (7 * Path->SmoothedRtt + LatestRtt) / 8;
+        }
+        Path->LatestRttSample = LatestRtt;
+    }
+
+    //
+    // Declares the given outstanding packets lost, as one loss event.
+    //
+    void OnLost(SimFlow& Flow, const std::vector<size_t>& Lost) {
+        if (Lost.empty()) {
+            return;
+        }
+        QUIC_LOSS_EVENT LossEvent;
+        CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+        for (size_t i : Lost) {
+            LossEvent.NumRetransmittableBytes += Flow.Outstanding[i].Metadata->PacketLength;
+            LossEvent.LargestPacketNumberLost = Flow.Outstanding[i].Metadata->PacketNumber;
+            Flow.Outstanding[i].Done = true;
+            Flow.LostPackets++;
+        }
+        LossEvent.LargestSentPacketNumber = Flow.NextPacketNumber - 1;
+        QuicCongestionControlOnDataLost(&Flow.Connection->CongestionControl, &LossEvent);
+    }
+
+    void DetectTimeoutLosses(SimFlow& Flow) {
+        const QUIC_PATH* Path = &Flow.Connection->Paths[0];
+        const uint64_t Timeout =
+            Path->GotFirstRttSample ?
+                3 * Path->SmoothedRtt + 4 * Path->RttVariance : 3 * SIM_INITIAL_RTT_US;
+        std::vector<size_t> Lost;
+        for (size_t i = 0; i < Flow.Outstanding.size(); ++i) {
+            const SimPacket& Packet = Flow.Outstanding[i];
+            if (Packet.Done) {
+                continue;
+            }
+            if (Packet.Metadata->SentTime + Timeout > Now) {
+                break;
+            }
+            Lost.push_back(i);
+        }
+        OnLost(Flow, Lost);
+        Compact(Flow);
+    }
+
+    void OnAck(SimFlow& Flow, uint64_t PacketNumber) {
+        QUIC_CONNECTION* Connection = Flow.Connection;
+        QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+        QUIC_PATH* Path = &Connection->Paths[0];
+
+        //
+        // Find the packet. It's gone if it was already declared lost.
+        //
+        if (Flow.Outstanding.empty() ||
+            PacketNumber < Flow.Outstanding.front().Metadata->PacketNumber) {
+            return;
+        }
+        size_t Index = (size_t)(PacketNumber - Flow.Outstanding.front().Metadata->PacketNumber);
+        SimPacket& Packet = Flow.Outstanding[Index];
+        if (Packet.Done) {
+            return;
+        }
+        QUIC_SENT_PACKET_METADATA* Metadata = Packet.Metadata;
+
+        const uint64_t LatestRtt = Now - Metadata->SentTime;
+        UpdateRtt(Path, LatestRtt);
+        Flow.IntervalRttSumUs += LatestRtt;
+        Flow.IntervalRttCount++;
+
+        //
+        // Packet and time threshold loss detection, before acknowledging the
+        // data, like loss detection does.
+        //
+        const uint64_t TimeThreshold =
+            CXPLAT_MAX(Path->SmoothedRtt, LatestRtt) * 9 / 8;
+        std::vector<size_t> Lost;
+        for (size_t i = 0; i < Index; ++i) {
+            const SimPacket& Prev = Flow.Outstanding[i];
+            if (!Prev.Done &&
+                (Prev.Metadata->PacketNumber + SIM_PACKET_THRESHOLD <= PacketNumber ||
+                 Prev.Metadata->SentTime + TimeThreshold <= Now)) {
+                Lost.push_back(i);
+            }
+        }
+        OnLost(Flow, Lost);
+
+        if (Packet.CeMarked) {
+            QUIC_ECN_EVENT EcnEvent;
+            EcnEvent.LargestPacketNumberAcked = PacketNumber;
+            EcnEvent.LargestSentPacketNumber = Flow.NextPacketNumber - 1;
+            QuicCongestionControlOnEcn(Cc, &EcnEvent);
+        }
+
+        Packet.Done = true;
+        Flow.LargestAck = CXPLAT_MAX(Flow.LargestAck, PacketNumber);
+        Flow.TotalBytesAcked += Metadata->PacketLength;
+        Flow.TotalBytesSentAtLastAck = Metadata->TotalBytesSent;
+        Flow.TimeOfLastPacketAcked = Now;
+        Flow.TimeOfLastAckedPacketSent = Metadata->SentTime;
+        Flow.DeliveredBytes += Metadata->PacketLength;
+        Flow.IntervalBytes += Metadata->PacketLength;
+        if (Now > WarmupEnd) {
+            Flow.DeliveredBytesAfterWarmup += Metadata->PacketLength;
+        }
+
+        Metadata->Next = NULL;
+        QUIC_ACK_EVENT AckEvent;
+        CxPlatZeroMemory(&AckEvent, sizeof(AckEvent));
+        AckEvent.TimeNow = Now;
+        AckEvent.LargestAck = Flow.LargestAck;
+        AckEvent.LargestSentPacketNumber = Flow.NextPacketNumber - 1;
+        AckEvent.NumRetransmittableBytes = Metadata->PacketLength;
+        AckEvent.NumTotalAckedRetransmittableBytes = Flow.TotalBytesAcked;
+        AckEvent.SmoothedRtt = Path->SmoothedRtt;
+        AckEvent.MinRtt = LatestRtt;
+        AckEvent.MinRttValid = TRUE;
+        AckEvent.AdjustedAckTime = Now;
+        AckEvent.AckedPackets = Metadata;
+        AckEvent.EcnPackets = Link.EcnThresholdBytes != 0 ? 1 : 0;
+        AckEvent.EcnCePackets = Packet.CeMarked ? 1 : 0;
+        AckEvent.HasLoss = FALSE;
+        AckEvent.IsLargestAckedPacketAppLimited = Metadata->Flags.IsAppLimited;
+        const uint64_t DeliveryRate =
+            QuicCongestionControlSampleDeliveryRate(Metadata, &AckEvent);
+        if (DeliveryRate != UINT64_MAX) {
+            AckEvent.DeliveryRate = DeliveryRate;
+            AckEvent.IsDeliveryRateAppLimited = Metadata->Flags.IsAppLimited;
+            if (!Metadata->Flags.IsAppLimited || DeliveryRate > Flow.DeliveryRate) {
+                Flow.DeliveryRate = DeliveryRate;
+            }
+        }
+        QuicCongestionControlOnDataAcknowledged(Cc, &AckEvent);
+
+        Compact(Flow);
+    }
+
+    //
+    // Frees acknowledged and lost packets at the front of the list.
+    //
+    void Compact(SimFlow& Flow) {
+        while (!Flow.Outstanding.empty() && Flow.Outstanding.front().Done) {
+            CXPLAT_FREE(Flow.Outstanding.front().Metadata, QUIC_POOL_TEST);
+            Flow.Outstanding.pop_front();
+        }
+    }
+
+    void Sample(SimFlow& Flow) {
+        SimSample S;
+        S.TimeMs = (Now - Start) / 1000;
+        S.ThroughputKbps = Flow.IntervalBytes * 8 * 1000 / SIM_SAMPLE_INTERVAL_US;
+        S.RttUs = Flow.IntervalRttCount ? Flow.IntervalRttSumUs / Flow.IntervalRttCount : 0;
+        S.CongestionWindow =
+            QuicCongestionControlGetCongestionWindow(&Flow.Connection->CongestionControl);
+        Flow.Series.push_back(S);
+        Flow.IntervalBytes = 0;
+        Flow.IntervalRttSumUs = 0;
+        Flow.IntervalRttCount = 0;
+    }
+};
+
+//
+// 20 Mbps with 40 ms RTT, and one BDP of buffer.
+//
+static const SimLink DefaultLink = { 20000000, 20000, 100000, 0, 0, 0 };
+
+#define SIM_DURATION_US     20000000
+#define SIM_WARMUP_US       5000000
+
+//
+// Scenario: Each algorithm fills an uncontended link.
+//
+TEST(CongestionControlSimTest, SingleFlowUtilization)
+{
+    const struct {
+        QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm;
+        const char* Name;
+    } Algorithms[] = {
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, "Cubic" },
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, "Bbr" },
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3, "Bbr3" },
+    };
+    for (const auto& Alg : Algorithms) {
+        CongestionControlSim Sim(DefaultLink);
+        Sim.AddFlow(Alg.Algorithm);
+        Sim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+        Sim.Record(Alg.Name, 0);
+        ASSERT_GE(Sim.SteadyUtilizationPercent(), 80u) << Alg.Name;
+    }
+}
+
+//
+// Scenario: The shared delivery rate samples track the bottleneck rate for
+// Cubic, which doesn't measure one itself.
+//
+TEST(CongestionControlSimTest, DeliveryRateSample)
+{
+    CongestionControlSim Sim(DefaultLink);
+    Sim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+    Sim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+    Sim.Record("Cubic", 0);
+
+    const uint64_t DeliveryRate = Sim.DeliveryRate(0);
+    ::testing::Test::RecordProperty("Cubic.DeliveryRateKbps", std::to_string(DeliveryRate / 1000));
+    ASSERT_GE(DeliveryRate, DefaultLink.BandwidthBps / 2);
+    ASSERT_LE(DeliveryRate, DefaultLink.BandwidthBps + DefaultLink.BandwidthBps / 10);
+}
+
+//
+// Scenario: With a deep buffer, Cubic fills the queue while BBR keeps it
+// mostly empty.
+//
+TEST(CongestionControlSimTest, DeepBufferQueuingDelay)
+{
+    SimLink Link = DefaultLink;
+    Link.BufferBytes = 8 * 100000;
+
+    CongestionControlSim CubicSim(Link);
+    CubicSim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+    CubicSim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+    CubicSim.Record("Cubic", 0);
+
+    CongestionControlSim BbrSim(Link);
+    BbrSim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR);
+    BbrSim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+    BbrSim.Record("Bbr", 0);
+
+    ASSERT_GE(BbrSim.SteadyUtilizationPercent(), 80u);
+    ASSERT_LT(BbrSim.SteadyQueuingDelayUs(0), CubicSim.SteadyQueuingDelayUs(0));
+}
+
+//
+// Scenario: Random (non-congestive) loss limits Cubic's window, but not BBR's.
+//
+TEST(CongestionControlSimTest, RandomLoss)
+{
+    SimLink Link = DefaultLink;
+    Link.LossPerMillion = 10000; // 1%
+
+    CongestionControlSim CubicSim(Link);
+    CubicSim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+    CubicSim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+    CubicSim.Record("Cubic", 0);
+
+    CongestionControlSim BbrSim(Link);
+    BbrSim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_BBR);
+    BbrSim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+    BbrSim.Record("Bbr", 0);
+
+    ASSERT_GT(BbrSim.SteadyThroughputKbps(0), CubicSim.SteadyThroughputKbps(0));
+}
+
+//
+// Scenario: Two Cubic flows, the second starting later, converge to a fair
+// share of the link.
+//
+TEST(CongestionControlSimTest, CubicFairness)
+{
+    CongestionControlSim Sim(DefaultLink);
+    Sim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+    Sim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, 2000000);
+    Sim.Run(3 * SIM_DURATION_US, SIM_DURATION_US);
+    Sim.Record("Cubic0", 0);
+    Sim.Record("Cubic1", 1);
+
+    ASSERT_GE(Sim.SteadyUtilizationPercent(), 80u);
+    ASSERT_GE(Sim.JainFairnessPercent(), 90u);
+}
+
+//
+// Scenario: Prague keeps the queue short with ECN marking at a shallow
+// threshold, while still filling the link.
+//
+TEST(CongestionControlSimTest, PragueShallowEcnThreshold)
+{
+    SimLink Link = DefaultLink;
+    Link.EcnThresholdBytes = 10 * SIM_MTU;
+
+    CongestionControlSim Sim(Link);
+    Sim.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE);
+    Sim.Run(SIM_DURATION_US, SIM_WARMUP_US);
+    Sim.Record("Prague", 0);
+
+    ASSERT_GE(Sim.SteadyUtilizationPercent(), 80u);
+    ASSERT_EQ(Sim.GetFlow(0).LostPackets, 0u);
+}
+
+//
+// Scenario: The simulation is deterministic, with loss and jitter, so
+// results can be compared between runs.
+//
+TEST(CongestionControlSimTest, Deterministic)
+{
+    SimLink Link = DefaultLink;
+    Link.LossPerMillion = 5000;
+    Link.AckJitterUs = 2000;
+
+    CongestionControlSim Sim1(Link, 7);
+    Sim1.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+    Sim1.Run(SIM_DURATION_US / 4, 0);
+
+    CongestionControlSim Sim2(Link, 7);
+    Sim2.AddFlow(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+    Sim2.Run(SIM_DURATION_US / 4, 0);
+
+    const SimFlow& Flow1 = Sim1.GetFlow(0);
+    const SimFlow& Flow2 = Sim2.GetFlow(0);
+    ASSERT_EQ(Flow1.DeliveredBytes, Flow2.DeliveredBytes);
+    ASSERT_EQ(Flow1.LostPackets, Flow2.LostPackets);
+    ASSERT_EQ(Flow1.Series.size(), Flow2.Series.size());
+    for (size_t i = 0; i < Flow1.Series.size(); ++i) {
+        ASSERT_EQ(Flow1.Series[i].CongestionWindow, Flow2.Series[i].CongestionWindow);
+        ASSERT_EQ(Flow1.Series[i].RttUs, Flow2.Series[i].RttUs);
+    }
+}
@@ -19,6 +19,8 @@ Abstract:
 // Uses a real QUIC_CONNECTION structure to ensure proper memory layout when
 // QuicCongestionControlGetConnection() does CXPLAT_CONTAINING_RECORD pointer arithmetic.
 //
+static QUIC_SETTINGS_INTERNAL MockConnectionSettings;
+
 static void InitializeMockConnection(
     QUIC_CONNECTION& Connection,
     uint16_t Mtu)
@@ -32,8 +34,10 @@ static void InitializeMockConnection(
     Connection.Send.NextPacketNumber = 0;
 
     // Initialize Settings with defaults
-    Connection.Settings.PacingEnabled = FALSE;  // Disable pacing by default for simpler tests
-    Connection.Settings.HyStartEnabled = FALSE; // Disable HyStart by default
+    CxPlatZeroMemory(&MockConnectionSettings, sizeof(MockConnectionSettings));
+    Connection.Settings = &MockConnectionSettings;
+    MockConnectionSettings.PacingEnabled = FALSE;  // Disable pacing by default for simpler tests
+    MockConnectionSettings.HyStartEnabled = FALSE; // Disable HyStart by default
 
     // Initialize Path fields needed for some functions
     Connection.Paths[0].GotFirstRttSample = FALSE;
@@ -73,11 +77,12 @@ TEST(CubicTest, InitializeComprehensive)
     ASSERT_GT(Cubic->CongestionWindow, 0u);
     ASSERT_EQ(Cubic->BytesInFlightMax, Cubic->CongestionWindow / 2);
 
-    // Verify all 17 function pointers are set
+    // Verify all 18 function pointers are set
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlCanSend, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlSetExemption, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlReset, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlGetSendAllowance, nullptr);
+    ASSERT_NE(Connection.CongestionControl.QuicCongestionControlGetPacingRate, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlOnDataSent, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlOnDataInvalidated, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlOnDataAcknowledged, nullptr);
@@ -92,6 +97,10 @@ TEST(CubicTest, InitializeComprehensive)
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlGetCongestionWindow, nullptr);
     ASSERT_NE(Connection.CongestionControl.QuicCongestionControlGetNetworkStatistics, nullptr);
 
+    // Cubic doesn't measure a delivery rate
+    ASSERT_EQ(Connection.CongestionControl.QuicCongestionControlGetDeliveryRate, nullptr);
+    ASSERT_EQ(QuicCongestionControlGetDeliveryRate(&Connection.CongestionControl), 0ull);
+
     // Verify boolean state flags
     ASSERT_FALSE(Cubic->HasHadCongestionEvent);
     ASSERT_FALSE(Cubic->IsInRecovery);
@@ -272,7 +281,7 @@ TEST(CubicTest, GetSendAllowanceScenarios)
     ASSERT_EQ(Allowance, 0u);
 
     // Scenario 2: Available window without pacing - should return full window
-    Connection.Settings.PacingEnabled = FALSE;
+    MockConnectionSettings.PacingEnabled = FALSE;
     Cubic->BytesInFlight = Cubic->CongestionWindow / 2;
     uint32_t ExpectedAllowance = Cubic->CongestionWindow - Cubic->BytesInFlight;
     Allowance = Connection.CongestionControl.QuicCongestionControlGetSendAllowance(
@@ -280,7 +289,7 @@ TEST(CubicTest, GetSendAllowanceScenarios)
     ASSERT_EQ(Allowance, ExpectedAllowance);
 
     // Scenario 3: Invalid time - should skip pacing and return full window
-    Connection.Settings.PacingEnabled = TRUE;
+    MockConnectionSettings.PacingEnabled = TRUE;
     Connection.Paths[0].GotFirstRttSample = TRUE;
     Connection.Paths[0].SmoothedRtt = 50000;
     Allowance = Connection.CongestionControl.QuicCongestionControlGetSendAllowance(
@@ -308,7 +317,7 @@ TEST(CubicTest, GetSendAllowanceWithActivePacing)
     InitializeMockConnection(Connection, 1280);
 
     // Enable pacing and provide valid RTT sample
-    Connection.Settings.PacingEnabled = TRUE;
+    MockConnectionSettings.PacingEnabled = TRUE;
     Connection.Paths[0].GotFirstRttSample = TRUE;
     Connection.Paths[0].SmoothedRtt = 50000; // 50ms (well above QUIC_MIN_PACING_RTT)
 
@@ -769,3 +778,125 @@ TEST(CubicTest, HyStart_StateTransitions)
                 Cubic->HyStartState <= HYSTART_DONE);
     ASSERT_GE(Cubic->CWndSlowStartGrowthDivisor, 1u);
 }
+
+//
+// Test 18: GetPacingRate (via function pointer)
+// Scenario: Tests the rate used to space out departure times when the kernel paces sends.
+// Without pacing enabled or before an RTT sample the rate is zero (send immediately). With
+// pacing active it matches the GetSendAllowance pacing rate: the estimated next-round window
+// (twice the window in slow start) per smoothed RTT.
+//
+TEST(CubicTest, GetPacingRate)
+{
+    QUIC_CONNECTION Connection;
+    QUIC_SETTINGS_INTERNAL Settings{};
+
+    Settings.InitialWindowPackets = 10;
+    Settings.SendIdleTimeoutMs = 1000;
+
+    InitializeMockConnection(Connection, 1280);
+    CubicCongestionControlInitialize(&Connection.CongestionControl, &Settings);
+
+    QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Connection.CongestionControl.Cubic;
+
+    // Pacing disabled - no rate
+    MockConnectionSettings.PacingEnabled = FALSE;
+    Connection.Paths[0].GotFirstRttSample = TRUE;
+    Connection.Paths[0].SmoothedRtt = 50000;
+    ASSERT_EQ(
+        Connection.CongestionControl.QuicCongestionControlGetPacingRate(&Connection.CongestionControl),
+        0ull);
+
+    // No RTT sample yet - no rate
+    MockConnectionSettings.PacingEnabled = TRUE;
+    Connection.Paths[0].GotFirstRttSample = FALSE;
+    ASSERT_EQ(
+        Connection.CongestionControl.QuicCongestionControlGetPacingRate(&Connection.CongestionControl),
+        0ull);
+
+    // Pacing active in slow start - twice the window per RTT
+    Connection.Paths[0].GotFirstRttSample = TRUE;
+    ASSERT_LT(Cubic->CongestionWindow, Cubic->SlowStartThreshold);
+    uint64_t ExpectedRate = (uint64_t)Cubic->CongestionWindow * 2 * 1000000 / 50000;
+    ASSERT_EQ(
+        Connection.CongestionControl.QuicCongestionControlGetPacingRate(&Connection.CongestionControl),
+        ExpectedRate);
+}
+
+//
+// Test: Careful Resume
+// Scenario: Saved congestion state jumps the window to half the saved window
+// once the RTT is confirmed, and loss before the jump is validated retreats to
+// the bytes actually delivered instead of reducing from the jump window.
+//
+TEST(CubicTest, CarefulResume_JumpAndSafeRetreat)
+{
+    QUIC_CONNECTION Connection;
+    QUIC_SETTINGS_INTERNAL Settings{};
+    Settings.InitialWindowPackets = 10;
+    Settings.SendIdleTimeoutMs = 1000;
+
+    InitializeMockConnection(Connection, 1280);
+    CubicCongestionControlInitialize(&Connection.CongestionControl, &Settings);
+
+    QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Connection.CongestionControl.Cubic;
+    const uint32_t InitialWindow = Cubic->CongestionWindow;
+
+    QUIC_CONN_CAREFUL_RESUME_STATE State;
+    CxPlatZeroMemory(&State, sizeof(State));
+    State.SmoothedRtt = 50000;
+    State.MinRtt = 40000;
+    State.CongestionWindow = InitialWindow * 20;
+    QuicCongestionControlSetCarefulResumeState(&Connection.CongestionControl, &State);
+    ASSERT_EQ(Cubic->CarefulResumePhase, CAREFUL_RESUME_RECONNAISSANCE);
+    ASSERT_EQ(Cubic->CongestionWindow, InitialWindow);
+
+    //
+    // The first ACK with a matching RTT performs the jump.
+    //
+    Connection.CongestionControl.QuicCongestionControlOnDataSent(&Connection.CongestionControl, 5000);
+    QUIC_ACK_EVENT AckEvent;
+    CxPlatZeroMemory(&AckEvent, sizeof(AckEvent));
+    AckEvent.TimeNow = CxPlatTimeUs64();
+    AckEvent.LargestAck = 1;
+    AckEvent.LargestSentPacketNumber = 4;
+    AckEvent.NumRetransmittableBytes = 1000;
+    AckEvent.SmoothedRtt = 60000;
+    Connection.CongestionControl.QuicCongestionControlOnDataAcknowledged(
+        &Connection.CongestionControl, &AckEvent);
+    ASSERT_EQ(Cubic->CarefulResumePhase, CAREFUL_RESUME_UNVALIDATED);
+    ASSERT_EQ(Cubic->CongestionWindow, InitialWindow * 10);
+
+    //
+    // Loss before the jump is validated.
+    //
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.NumRetransmittableBytes = 1000;
+    LossEvent.LargestPacketNumberLost = 3;
+    LossEvent.LargestSentPacketNumber = 4;
+    Connection.CongestionControl.QuicCongestionControlOnDataLost(
+        &Connection.CongestionControl, &LossEvent);
+    ASSERT_EQ(Cubic->CarefulResumePhase, CAREFUL_RESUME_NONE);
+    ASSERT_LT(Cubic->CongestionWindow, InitialWindow);
+
+    //
+    // Saved state that doesn't increase the window is ignored.
+    //
+    CubicCongestionControlInitialize(&Connection.CongestionControl, &Settings);
+    State.CongestionWindow = InitialWindow;
+    QuicCongestionControlSetCarefulResumeState(&Connection.CongestionControl, &State);
+    ASSERT_EQ(Cubic->CarefulResumePhase, CAREFUL_RESUME_NONE);
+
+    //
+    // An RTT that doesn't match the saved one cancels the jump.
+    //
+    State.CongestionWindow = InitialWindow * 20;
+    QuicCongestionControlSetCarefulResumeState(&Connection.CongestionControl, &State);
+    Connection.CongestionControl.QuicCongestionControlOnDataSent(&Connection.CongestionControl, 5000);
+    AckEvent.SmoothedRtt = 1000000;
+    Connection.CongestionControl.QuicCongestionControlOnDataAcknowledged(
+        &Connection.CongestionControl, &AckEvent);
+    ASSERT_EQ(Cubic->CarefulResumePhase, CAREFUL_RESUME_NONE);
+    ASSERT_LT(Cubic->CongestionWindow, InitialWindow * 2);
+}
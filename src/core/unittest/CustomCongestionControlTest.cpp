@@ -0,0 +1,174 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit tests for application defined congestion control.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "CustomCongestionControlTest.cpp.clog.h"
+#endif
+
+struct TestCongestionControl {
+    uint32_t Window {12000};
+    uint32_t LastBytesInFlight {0};
+    uint32_t SentCount {0};
+    uint32_t AckedBytes {0};
+    uint32_t LostBytes {0};
+    uint32_t EcnCount {0};
+    uint32_t ResetCount {0};
+
+    static BOOLEAN QUIC_API CanSend(void* Context, uint32_t BytesInFlight) {
+        auto This = (TestCongestionControl*)Context;
+        This->LastBytesInFlight = BytesInFlight;
+        return BytesInFlight < This->Window;
+    }
+    static uint32_t QUIC_API GetSendAllowance(void* Context, uint32_t BytesInFlight, uint64_t, BOOLEAN) {
+        auto This = (TestCongestionControl*)Context;
+        return BytesInFlight < This->Window ? This->Window - BytesInFlight : 0;
+    }
+    static uint32_t QUIC_API GetCongestionWindow(void* Context) {
+        return ((TestCongestionControl*)Context)->Window;
+    }
+    static void QUIC_API OnDataSent(void* Context, uint32_t, uint32_t BytesInFlight) {
+        auto This = (TestCongestionControl*)Context;
+        This->SentCount++;
+        This->LastBytesInFlight = BytesInFlight;
+    }
+    static void QUIC_API OnDataAcknowledged(void* Context, const QUIC_CONGESTION_CONTROL_ACK_INFO* Info) {
+        auto This = (TestCongestionControl*)Context;
+        This->AckedBytes += Info->BytesAcked;
+        This->LastBytesInFlight = Info->BytesInFlight;
+    }
+    static void QUIC_API OnDataLost(void* Context, const QUIC_CONGESTION_CONTROL_LOSS_INFO* Info) {
+        auto This = (TestCongestionControl*)Context;
+        This->LostBytes += Info->BytesLost;
+        This->LastBytesInFlight = Info->BytesInFlight;
+        This->Window /= 2;
+    }
+    static void QUIC_API OnEcn(void* Context, const QUIC_CONGESTION_CONTROL_ECN_INFO*) {
+        ((TestCongestionControl*)Context)->EcnCount++;
+    }
+    static void QUIC_API Reset(void* Context, BOOLEAN) {
+        ((TestCongestionControl*)Context)->ResetCount++;
+    }
+};
+
+static const QUIC_CONGESTION_CONTROL_CALLBACKS TestCallbacks = {
+    TestCongestionControl::CanSend,
+    TestCongestionControl::GetSendAllowance,
+    TestCongestionControl::GetCongestionWindow,
+    TestCongestionControl::OnDataSent,
+    TestCongestionControl::OnDataAcknowledged,
+    TestCongestionControl::OnDataLost,
+    TestCongestionControl::OnEcn,
+    TestCongestionControl::Reset
+};
+
+static BOOLEAN InitializeMockConnection(
+    QUIC_CONNECTION& Connection,
+    QUIC_SETTINGS_INTERNAL& Settings,
+    TestCongestionControl* App)
+{
+    CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Paths[0].Mtu = 1280;
+    Connection.Paths[0].IsActive = TRUE;
+    Connection.Settings = &Settings;
+    if (App != nullptr) {
+        Connection.CustomCongestionControl.Callbacks = &TestCallbacks;
+        Connection.CustomCongestionControl.Context = App;
+    }
+
+    Settings.InitialWindowPackets = 10;
+    Settings.CongestionControlAlgorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM;
+    return CustomCongestionControlInitialize(&Connection.CongestionControl, &Settings);
+}
+
+//
+// Scenario: Initialization fails without application callbacks, so the caller
+// can fall back to the default algorithm.
+//
+TEST(CustomCongestionControlTest, InitializeWithoutCallbacks)
+{
+    QUIC_CONNECTION Connection;
+    QUIC_SETTINGS_INTERNAL Settings{};
+    ASSERT_FALSE(InitializeMockConnection(Connection, Settings, nullptr));
+}
+
+//
+// Scenario: Sent, acknowledged and lost bytes are tracked by MsQuic and the
+// application's callbacks drive the window and send decisions.
+//
+TEST(CustomCongestionControlTest, ForwardsEvents)
+{
+    QUIC_CONNECTION Connection;
+    QUIC_SETTINGS_INTERNAL Settings{};
+    TestCongestionControl App;
+    ASSERT_TRUE(InitializeMockConnection(Connection, Settings, &App));
+
+    QUIC_CONGESTION_CONTROL* Cc = &Connection.CongestionControl;
+    ASSERT_STREQ(Cc->Name, "Custom");
+    ASSERT_EQ(QuicCongestionControlGetCongestionWindow(Cc), 12000u);
+    ASSERT_TRUE(QuicCongestionControlCanSend(Cc));
+
+    QuicCongestionControlOnDataSent(Cc, 12000);
+    ASSERT_EQ(App.SentCount, 1u);
+    ASSERT_EQ(Cc->Custom.BytesInFlight, 12000u);
+    ASSERT_FALSE(QuicCongestionControlCanSend(Cc));
+
+    QUIC_ACK_EVENT AckEvent;
+    CxPlatZeroMemory(&AckEvent, sizeof(AckEvent));
+    AckEvent.TimeNow = CxPlatTimeUs64();
+    AckEvent.LargestAck = 5;
+    AckEvent.LargestSentPacketNumber = 10;
+    AckEvent.NumRetransmittableBytes = 6000;
+    AckEvent.NumTotalAckedRetransmittableBytes = 6000;
+    ASSERT_TRUE(QuicCongestionControlOnDataAcknowledged(Cc, &AckEvent));
+    ASSERT_EQ(App.AckedBytes, 6000u);
+    ASSERT_EQ(App.LastBytesInFlight, 6000u);
+
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.NumRetransmittableBytes = 1200;
+    LossEvent.LargestPacketNumberLost = 6;
+    LossEvent.LargestSentPacketNumber = 10;
+    QuicCongestionControlOnDataLost(Cc, &LossEvent);
+    ASSERT_EQ(App.LostBytes, 1200u);
+    ASSERT_EQ(Cc->Custom.BytesInFlight, 4800u);
+    ASSERT_EQ(QuicCongestionControlGetCongestionWindow(Cc), 6000u);
+    ASSERT_EQ(Connection.Stats.Send.CongestionCount, 1u);
+
+    QUIC_ECN_EVENT EcnEvent;
+    CxPlatZeroMemory(&EcnEvent, sizeof(EcnEvent));
+    QuicCongestionControlOnEcn(Cc, &EcnEvent);
+    ASSERT_EQ(App.EcnCount, 1u);
+
+    QuicCongestionControlReset(Cc, TRUE);
+    ASSERT_EQ(App.ResetCount, 1u);
+    ASSERT_EQ(Cc->Custom.BytesInFlight, 0u);
+}
+
+//
+// Scenario: Exemptions allow probe packets past the application's window.
+//
+TEST(CustomCongestionControlTest, Exemptions)
+{
+    QUIC_CONNECTION Connection;
+    QUIC_SETTINGS_INTERNAL Settings{};
+    TestCongestionControl App;
+    ASSERT_TRUE(InitializeMockConnection(Connection, Settings, &App));
+
+    QUIC_CONGESTION_CONTROL* Cc = &Connection.CongestionControl;
+    QuicCongestionControlOnDataSent(Cc, 12000);
+    ASSERT_FALSE(QuicCongestionControlCanSend(Cc));
+
+    QuicCongestionControlSetExemption(Cc, 1);
+    ASSERT_TRUE(QuicCongestionControlCanSend(Cc));
+    QuicCongestionControlOnDataSent(Cc, 1200);
+    ASSERT_FALSE(QuicCongestionControlCanSend(Cc));
+}
@@ -0,0 +1,131 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the decision to send flow control updates before the peer
+    runs out of credit.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "FlowControlTest.cpp.clog.h"
+#endif
+
+TEST(FlowControlTest, PeerCreditRunningOut)
+{
+    const uint64_t Rtt = 50000; // 50ms
+
+    //
+    // 64KB delivered over 10ms is 320KB per RTT.
+    //
+    ASSERT_TRUE(QuicSendPeerCreditRunningOut(100000, 65536, 10000, Rtt));
+    ASSERT_TRUE(QuicSendPeerCreditRunningOut(65536 * 5, 65536, 10000, Rtt));
+    ASSERT_FALSE(QuicSendPeerCreditRunningOut(65536 * 5 + 1, 65536, 10000, Rtt));
+    ASSERT_FALSE(QuicSendPeerCreditRunningOut(1000000, 65536, 10000, Rtt));
+
+    //
+    // The same bytes delivered over a longer time are a slower rate.
+    //
+    ASSERT_FALSE(QuicSendPeerCreditRunningOut(100000, 65536, 100000, Rtt));
+
+    //
+    // A longer RTT needs more credit left.
+    //
+    ASSERT_FALSE(QuicSendPeerCreditRunningOut(500000, 65536, 10000, Rtt));
+    ASSERT_TRUE(QuicSendPeerCreditRunningOut(500000, 65536, 10000, 2 * Rtt));
+
+    //
+    // Nothing delivered yet only matters once the peer is out of credit.
+    //
+    ASSERT_FALSE(QuicSendPeerCreditRunningOut(1, 0, 10000, Rtt));
+    ASSERT_TRUE(QuicSendPeerCreditRunningOut(0, 0, 10000, Rtt));
+
+    //
+    // Everything delivered at once.
+    //
+    ASSERT_TRUE(QuicSendPeerCreditRunningOut(1000000, 1500, 0, Rtt));
+}
+
+//
+// A peer sends at a steady rate to a receiver that delivers everything right
+// away. The receiver sends a flow control update after a quarter of the window
+// is delivered and, if EarlyUpdates, whenever the peer is running out. Each
+// update reaches the peer an RTT after the data it is in response to was sent.
+// Returns the number of times the peer was blocked.
+//
+static
+uint32_t
+SimulatePeerBlocked(
+    _In_ uint64_t Window,
+    _In_ uint64_t BytesPerMs,
+    _In_ uint64_t Rtt,
+    _In_ bool EarlyUpdates
+    )
+{
+    const uint64_t Threshold = Window / QUIC_RECV_BUFFER_DRAIN_RATIO;
+    uint64_t PeerOffset = 0;
+    uint64_t PeerLimit = Window;        // The limit the peer has
+    uint64_t MaxDataSent = Window;      // The limit last sent
+    uint64_t Accumulator = 0;
+    uint64_t LastUpdate = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> InFlight; // (arrival, limit)
+    uint32_t Blocked = 0;
+
+    for (uint64_t TimeNow = 1000; TimeNow <= 2000000; TimeNow += 1000) {
+        for (auto It = InFlight.begin(); It != InFlight.end();) {
+            if (It->first <= TimeNow) {
+                PeerLimit = CXPLAT_MAX(PeerLimit, It->second);
+                It = InFlight.erase(It);
+            } else {
+                ++It;
+            }
+        }
+
+        uint64_t Sent = CXPLAT_MIN(BytesPerMs, PeerLimit - PeerOffset);
+        if (Sent < BytesPerMs) {
+            ++Blocked;
+        }
+        PeerOffset += Sent;
+        Accumulator += Sent;
+
+        bool Update = false;
+        if (Accumulator >= Threshold) {
+            Accumulator = 0;
+            LastUpdate = TimeNow;
+            Update = true;
+        } else if (EarlyUpdates &&
+            QuicSendPeerCreditRunningOut(
+                MaxDataSent - PeerOffset, Accumulator, TimeNow - LastUpdate, Rtt)) {
+            Update = true;
+        }
+        if (Update) {
+            MaxDataSent = PeerOffset + Window;
+            InFlight.push_back({TimeNow + Rtt, MaxDataSent});
+        }
+    }
+    return Blocked;
+}
+
+TEST(FlowControlTest, EarlyUpdatesKeepPeerFromBlocking)
+{
+    //
+    // A window of 1.2 BDP: updating only after a quarter of it is delivered
+    // leaves the peer waiting on each update, but updating once the peer has
+    // about an RTT of credit left keeps it sending.
+    //
+    const uint64_t Rtt = 40000;
+    const uint64_t BytesPerMs = 20000;
+    const uint64_t Window = 960000;
+    ASSERT_NE(0u, SimulatePeerBlocked(Window, BytesPerMs, Rtt, false));
+    ASSERT_EQ(0u, SimulatePeerBlocked(Window, BytesPerMs, Rtt, true));
+
+    //
+    // Nothing changes with plenty of window.
+    //
+    ASSERT_EQ(0u, SimulatePeerBlocked(4 * Window, BytesPerMs, Rtt, false));
+    ASSERT_EQ(0u, SimulatePeerBlocked(4 * Window, BytesPerMs, Rtt, true));
+}
@@ -44,7 +44,7 @@ TEST_P(AckFrameTest, AckFrameEncodeDecode)
     ASSERT_TRUE(QuicRangeAddRange(&AckRange, MinPktNum, ContigPktCount, &Unused) != nullptr);
     ASSERT_TRUE(QuicRangeAddValue(&AckRange, MaxPktNum));
 
-    ASSERT_TRUE(QuicAckFrameEncode(&AckRange, AckDelay, (GetParam() == QUIC_FRAME_ACK ? nullptr : &Ecn), &Offset, BufferLength, Buffer));
+    ASSERT_TRUE(QuicAckFrameEncode(&AckRange, nullptr, AckDelay, (GetParam() == QUIC_FRAME_ACK ? nullptr : &Ecn), &Offset, BufferLength, Buffer));
     Offset = 1;
     ASSERT_EQ(Buffer[0], GetParam());
     ASSERT_TRUE(QuicAckFrameDecode(GetParam(), BufferLength, Buffer, &Offset, &InvalidFrame, &DecodedAckRange, &DecodedEcn, &DecodedAckDelay));
@@ -200,12 +200,244 @@ TEST_P(AckFrameTest, DecodeAckFrameFail) {
     QuicRangeUninitialize(&DecodedAckBlocks);
 }
 
+TEST_P(AckFrameTest, AckFrameEncodeDecodeManyRanges)
+{
+    const uint32_t RangeCount = 200;
+    QUIC_ACK_ECN_EX Ecn = {1, 2, 3};
+    QUIC_ACK_ECN_EX DecodedEcn = {0, 0, 0};
+    QUIC_RANGE AckRange;
+    QUIC_RANGE DecodedAckRange;
+    uint8_t Buffer[4096];
+    uint16_t Offset = 0;
+    uint64_t DecodedAckDelay = 0;
+    BOOLEAN InvalidFrame = FALSE;
+    BOOLEAN Unused;
+
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &AckRange);
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &DecodedAckRange);
+
+    //
+    // Ranges of varying lengths and gaps, with packet numbers large enough to
+    // need every var int length.
+    //
+    uint64_t Low = 0;
+    for (uint32_t i = 0; i < RangeCount; ++i) {
+        uint64_t Count = 1 + (i % 7) * (i % 3 == 0 ? 1000 : 1);
+        ASSERT_TRUE(QuicRangeAddRange(&AckRange, Low, Count, &Unused) != nullptr);
+        Low += Count + 1 + (i % 5) * (i % 11 == 0 ? 100000 : 1);
+    }
+    ASSERT_EQ(RangeCount, QuicRangeSize(&AckRange));
+
+    ASSERT_TRUE(QuicAckFrameEncode(&AckRange, nullptr, 0, (GetParam() == QUIC_FRAME_ACK ? nullptr : &Ecn), &Offset, (uint16_t)sizeof(Buffer), Buffer));
+    const uint16_t BufferLength = Offset;
+    Offset = 1;
+    ASSERT_TRUE(QuicAckFrameDecode(GetParam(), BufferLength, Buffer, &Offset, &InvalidFrame, &DecodedAckRange, &DecodedEcn, &DecodedAckDelay));
+    ASSERT_FALSE(InvalidFrame);
+    ASSERT_EQ(BufferLength, Offset);
+
+    ASSERT_EQ(QuicRangeSize(&AckRange), QuicRangeSize(&DecodedAckRange));
+    for (uint32_t i = 0; i < RangeCount; ++i) {
+        ASSERT_EQ(QuicRangeGet(&AckRange, i)->Low, QuicRangeGet(&DecodedAckRange, i)->Low);
+        ASSERT_EQ(QuicRangeGet(&AckRange, i)->Count, QuicRangeGet(&DecodedAckRange, i)->Count);
+    }
+
+    if (GetParam() == QUIC_FRAME_ACK_1) {
+        ASSERT_EQ(Ecn.CE_Count, DecodedEcn.CE_Count);
+        ASSERT_EQ(Ecn.ECT_0_Count, DecodedEcn.ECT_0_Count);
+        ASSERT_EQ(Ecn.ECT_1_Count, DecodedEcn.ECT_1_Count);
+    }
+
+    QuicRangeUninitialize(&AckRange);
+    QuicRangeUninitialize(&DecodedAckRange);
+}
+
+TEST_P(AckFrameTest, AckFrameEncodeWithEncodedBlocks)
+{
+    QUIC_ACK_ECN_EX Ecn = {1, 2, 3};
+    QUIC_RANGE AckRange;
+    uint8_t Blocks[QUIC_MAX_ENCODED_ACK_BLOCKS_LENGTH];
+    uint8_t Expected[512];
+    uint8_t Buffer[512];
+    BOOLEAN Unused;
+
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &AckRange);
+    ASSERT_TRUE(QuicRangeAddRange(&AckRange, 100, 5, &Unused) != nullptr);
+    ASSERT_TRUE(QuicRangeAddRange(&AckRange, 200, 1, &Unused) != nullptr);
+    ASSERT_TRUE(QuicRangeAddRange(&AckRange, 70000, 300, &Unused) != nullptr);
+
+    //
+    // Encoding the additional blocks ahead of time must give the same frame,
+    // as long as only the largest subrange changes in between.
+    //
+    uint16_t BlocksLength = 0;
+    ASSERT_TRUE(QuicAckBlocksEncode(&AckRange, &BlocksLength, (uint16_t)sizeof(Blocks), Blocks));
+    ASSERT_TRUE(QuicRangeAddValue(&AckRange, 70300));
+    const QUIC_ENCODED_ACK_BLOCKS EncodedBlocks = { Blocks, BlocksLength };
+
+    uint16_t ExpectedLength = 0;
+    ASSERT_TRUE(QuicAckFrameEncode(&AckRange, nullptr, 25, (GetParam() == QUIC_FRAME_ACK ? nullptr : &Ecn), &ExpectedLength, (uint16_t)sizeof(Expected), Expected));
+    uint16_t Length = 0;
+    ASSERT_TRUE(QuicAckFrameEncode(&AckRange, &EncodedBlocks, 25, (GetParam() == QUIC_FRAME_ACK ? nullptr : &Ecn), &Length, (uint16_t)sizeof(Buffer), Buffer));
+    ASSERT_EQ(ExpectedLength, Length);
+    ASSERT_EQ(0, memcmp(Expected, Buffer, Length));
+
+    QuicRangeUninitialize(&AckRange);
+}
+
+TEST_P(AckFrameTest, DecodeAckFrameBelowZero)
+{
+    QUIC_ACK_ECN_EX DecodedEcn;
+    uint8_t Buffer[] = {
+        (uint8_t)GetParam(),
+        10, // Largest acknowledged
+        0,  // ACK delay
+        1,  // Additional ACK ranges
+        2,  // First ACK range: 8 to 10
+        0,  // Gap: 6 unacknowledged
+        9,  // ACK range: 10 packets below 6
+        0, 0, 0
+    };
+    uint16_t Offset = 1;
+    BOOLEAN InvalidFrame = FALSE;
+    QUIC_RANGE DecodedAckBlocks;
+    QUIC_VAR_INT AckDelay = 0;
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &DecodedAckBlocks);
+
+    ASSERT_FALSE(QuicAckFrameDecode(GetParam(), sizeof(Buffer), Buffer, &Offset, &InvalidFrame, &DecodedAckBlocks, &DecodedEcn, &AckDelay));
+    ASSERT_TRUE(InvalidFrame);
+
+    QuicRangeUninitialize(&DecodedAckBlocks);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     FrameTest,
     AckFrameTest,
     ::testing::Values(QUIC_FRAME_ACK, QUIC_FRAME_ACK_1),
     ::testing::PrintToStringParamName());
 
+TEST(FrameTest, AckReceiveTimestampsFrameEncodeDecode)
+{
+    //
+    // Two timestamp ranges: 20 and 19, then (after a gap) 15.
+    //
+    const QUIC_ACK_RECEIVE_TIMESTAMP Timestamps[] = {
+        { 20, 100000 }, { 19, 99000 }, { 15, 40 }
+    };
+    QUIC_ACK_RECEIVE_TIMESTAMP DecodedTimestamps[QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+    uint32_t DecodedTimestampCount = 0;
+    QUIC_RANGE AckRange;
+    QUIC_RANGE DecodedAckRange;
+    uint8_t Buffer[64];
+    uint16_t Offset = 0;
+    uint64_t DecodedAckDelay = 0;
+    QUIC_VAR_INT FrameType = 0;
+    BOOLEAN InvalidFrame = FALSE;
+    BOOLEAN Unused;
+
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &AckRange);
+    QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &DecodedAckRange);
+    ASSERT_TRUE(QuicRangeAddRange(&AckRange, 10, 11, &Unused) != nullptr);
+    ASSERT_TRUE(QuicRangeAddValue(&AckRange, 22));
+
+    for (uint8_t Exponent : { (uint8_t)0, (uint8_t)3 }) {
+        Offset = 0;
+        ASSERT_TRUE(
+            QuicAckReceiveTimestampsFrameEncode(
+                &AckRange, nullptr, 7, Timestamps, ARRAYSIZE(Timestamps), Exponent,
+                &Offset, (uint16_t)sizeof(Buffer), Buffer));
+        const uint16_t EncodedLength = Offset;
+
+        Offset = 0;
+        ASSERT_TRUE(QuicVarIntDecode(EncodedLength, Buffer, &Offset, &FrameType));
+        ASSERT_EQ(FrameType, (QUIC_VAR_INT)QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS);
+        ASSERT_TRUE(QuicAckFrameDecode(QUIC_FRAME_ACK, EncodedLength, Buffer, &Offset, &InvalidFrame, &DecodedAckRange, nullptr, &DecodedAckDelay));
+        ASSERT_EQ(DecodedAckDelay, 7ull);
+        ASSERT_EQ(QuicRangeGetMax(&DecodedAckRange), 22ull);
+        ASSERT_TRUE(
+            QuicAckReceiveTimestampsDecode(
+                EncodedLength, Buffer, &Offset, 22, Exponent,
+                ARRAYSIZE(DecodedTimestamps), DecodedTimestamps, &DecodedTimestampCount));
+        ASSERT_EQ(Offset, EncodedLength);
+        ASSERT_EQ(DecodedTimestampCount, (uint32_t)ARRAYSIZE(Timestamps));
+        for (uint32_t i = 0; i < DecodedTimestampCount; ++i) {
+            ASSERT_EQ(DecodedTimestamps[i].PacketNumber, Timestamps[i].PacketNumber);
+            ASSERT_EQ(
+                DecodedTimestamps[i].RecvTime,
+                (Timestamps[i].RecvTime >> Exponent) << Exponent);
+        }
+
+        //
+        // Only as many timestamps as asked for are returned.
+        //
+        Offset = 0;
+        QuicRangeReset(&DecodedAckRange);
+        ASSERT_TRUE(QuicVarIntDecode(EncodedLength, Buffer, &Offset, &FrameType));
+        ASSERT_TRUE(QuicAckFrameDecode(QUIC_FRAME_ACK, EncodedLength, Buffer, &Offset, &InvalidFrame, &DecodedAckRange, nullptr, &DecodedAckDelay));
+        ASSERT_TRUE(
+            QuicAckReceiveTimestampsDecode(
+                EncodedLength, Buffer, &Offset, 22, Exponent,
+                1, DecodedTimestamps, &DecodedTimestampCount));
+        ASSERT_EQ(Offset, EncodedLength);
+        ASSERT_EQ(DecodedTimestampCount, 1u);
+        QuicRangeReset(&DecodedAckRange);
+    }
+
+    //
+    // Doesn't fit: nothing is written.
+    //
+    Offset = 0;
+    ASSERT_FALSE(
+        QuicAckReceiveTimestampsFrameEncode(
+            &AckRange, nullptr, 7, Timestamps, ARRAYSIZE(Timestamps), 0,
+            &Offset, 12, Buffer));
+    ASSERT_EQ(Offset, 0);
+
+    QuicRangeUninitialize(&AckRange);
+    QuicRangeUninitialize(&DecodedAckRange);
+}
+
+TEST(FrameTest, DecodeAckReceiveTimestampsFail)
+{
+    QUIC_ACK_RECEIVE_TIMESTAMP Timestamps[QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+    uint32_t TimestampCount;
+    uint16_t Offset;
+
+    //
+    // First range's gap goes past packet number zero.
+    //
+    const uint8_t GapTooLarge[] = { 1, 6, 1, 10 };
+    Offset = 0;
+    ASSERT_FALSE(QuicAckReceiveTimestampsDecode(sizeof(GapTooLarge), GapTooLarge, &Offset, 5, 0, ARRAYSIZE(Timestamps), Timestamps, &TimestampCount));
+
+    //
+    // More deltas than packet numbers left.
+    //
+    const uint8_t TooManyDeltas[] = { 1, 0, 3, 10, 1, 1 };
+    Offset = 0;
+    ASSERT_FALSE(QuicAckReceiveTimestampsDecode(sizeof(TooManyDeltas), TooManyDeltas, &Offset, 1, 0, ARRAYSIZE(Timestamps), Timestamps, &TimestampCount));
+
+    //
+    // A delta that goes back before the timestamp basis.
+    //
+    const uint8_t TimeUnderflow[] = { 1, 0, 2, 10, 11 };
+    Offset = 0;
+    ASSERT_FALSE(QuicAckReceiveTimestampsDecode(sizeof(TimeUnderflow), TimeUnderflow, &Offset, 5, 0, ARRAYSIZE(Timestamps), Timestamps, &TimestampCount));
+
+    //
+    // A range with no deltas.
+    //
+    const uint8_t EmptyRange[] = { 1, 0, 0 };
+    Offset = 0;
+    ASSERT_FALSE(QuicAckReceiveTimestampsDecode(sizeof(EmptyRange), EmptyRange, &Offset, 5, 0, ARRAYSIZE(Timestamps), Timestamps, &TimestampCount));
+
+    //
+    // Truncated.
+    //
+    const uint8_t Truncated[] = { 2, 0, 1, 10 };
+    Offset = 0;
+    ASSERT_FALSE(QuicAckReceiveTimestampsDecode(sizeof(Truncated), Truncated, &Offset, 5, 0, ARRAYSIZE(Timestamps), Timestamps, &TimestampCount));
+}
+
 TEST(FrameTest, ResetStreamFrameEncodeDecode)
 {
     QUIC_RESET_STREAM_EX Frame = {127, 4294967297, 65536};
@@ -301,6 +533,183 @@ TEST(FrameTest, TestQuicAckTrackerDidHitReorderingThreshold)
     ASSERT_TRUE(TestReorderingThreshold(5, 4, {{1, 2}, {4}, {10}}));
 }
 
+TEST(FrameTest, TestQuicAckTrackerAddPacketNumber)
+{
+    QUIC_ACK_TRACKER Tracker;
+    QuicAckTrackerInitialize(&Tracker);
+
+    //
+    // Receive everything but 100 and 900, so that the holes end up in both the
+    // bitmap and the older range.
+    //
+    for (uint64_t PacketNumber = 0; PacketNumber < 1000; ++PacketNumber) {
+        if (PacketNumber != 100 && PacketNumber != 900) {
+            ASSERT_FALSE(QuicAckTrackerAddPacketNumber(&Tracker, PacketNumber));
+        }
+    }
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 99));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 101));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 999));
+    ASSERT_FALSE(QuicAckTrackerAddPacketNumber(&Tracker, 100));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 100));
+    ASSERT_FALSE(QuicAckTrackerAddPacketNumber(&Tracker, 900));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 900));
+
+    //
+    // Jump far ahead, moving the whole bitmap to the range.
+    //
+    ASSERT_FALSE(QuicAckTrackerAddPacketNumber(&Tracker, 100000));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 100000));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 900));
+    ASSERT_TRUE(QuicAckTrackerAddPacketNumber(&Tracker, 999));
+    ASSERT_FALSE(QuicAckTrackerAddPacketNumber(&Tracker, 1000));
+    ASSERT_FALSE(QuicAckTrackerAddPacketNumber(&Tracker, 99999));
+
+    QuicAckTrackerUninitialize(&Tracker);
+}
+
+//
+// An ACK tracker in a packet space of a connection with only the state the
+// tracker uses initialized, and a packet builder to write its ACK frames to.
+//
+struct TestAckTracker {
+    QUIC_CONNECTION* Connection;
+    QUIC_PACKET_SPACE* Packets;
+    QUIC_SENT_PACKET_METADATA* Metadata;
+    uint8_t Datagram[1500];
+    QUIC_BUFFER DatagramBuffer { sizeof(Datagram), Datagram };
+    QUIC_PACKET_BUILDER Builder;
+
+    TestAckTracker() {
+        Connection =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        Packets =
+            (QUIC_PACKET_SPACE*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_PACKET_SPACE), QUIC_POOL_TEST);
+        Metadata =
+            (QUIC_SENT_PACKET_METADATA*)CXPLAT_ALLOC_NONPAGED(
+                SIZEOF_QUIC_SENT_PACKET_METADATA(QUIC_MAX_FRAMES_PER_PACKET), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connection != nullptr && Packets != nullptr && Metadata != nullptr);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        CxPlatZeroMemory(Packets, sizeof(QUIC_PACKET_SPACE));
+        Packets->Connection = Connection;
+        Packets->EncryptLevel = QUIC_ENCRYPT_LEVEL_1_RTT;
+        QuicAckTrackerInitialize(&Packets->AckTracker);
+
+        CxPlatZeroMemory(&Builder, sizeof(Builder));
+        Builder.Connection = Connection;
+        Builder.Datagram = &DatagramBuffer;
+        Builder.EncryptLevel = QUIC_ENCRYPT_LEVEL_1_RTT;
+        Builder.Metadata = Metadata;
+    }
+    ~TestAckTracker() {
+        QuicAckTrackerUninitialize(&Packets->AckTracker);
+        CXPLAT_FREE(Metadata, QUIC_POOL_TEST);
+        CXPLAT_FREE(Packets, QUIC_POOL_TEST);
+        CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+    }
+
+    void Ack(uint64_t PacketNumber) {
+        QuicAckTrackerAckPacket(
+            &Packets->AckTracker,
+            PacketNumber,
+            CxPlatTimeUs64(),
+            CXPLAT_ECN_NON_ECT,
+            QUIC_ACK_TYPE_NON_ACK_ELICITING);
+    }
+
+    //
+    // Writes the tracker's ACK frame and checks it against one encoded from
+    // scratch, with the same ACK delay, from the packet numbers to ACK.
+    //
+    void CheckAckFrame() {
+        Builder.DatagramLength = 0;
+        Metadata->FrameCount = 0;
+        ASSERT_TRUE(QuicAckTrackerAckFrameEncode(&Packets->AckTracker, &Builder));
+        ASSERT_EQ(QUIC_FRAME_ACK, Datagram[0]);
+
+        QUIC_RANGE Decoded;
+        QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &Decoded);
+        uint16_t Offset = 1;
+        BOOLEAN InvalidFrame = FALSE;
+        uint64_t AckDelay = 0;
+        ASSERT_TRUE(QuicAckFrameDecode(QUIC_FRAME_ACK, Builder.DatagramLength, Datagram, &Offset, &InvalidFrame, &Decoded, nullptr, &AckDelay));
+        ASSERT_EQ(Builder.DatagramLength, Offset);
+        QuicRangeUninitialize(&Decoded);
+
+        uint8_t Expected[sizeof(Datagram)];
+        uint16_t ExpectedLength = 0;
+        ASSERT_TRUE(QuicAckFrameEncode(&Packets->AckTracker.PacketNumbersToAck, nullptr, AckDelay, nullptr, &ExpectedLength, (uint16_t)sizeof(Expected), Expected));
+        ASSERT_EQ(ExpectedLength, Builder.DatagramLength);
+        ASSERT_EQ(0, memcmp(Expected, Datagram, ExpectedLength));
+    }
+};
+
+TEST(FrameTest, AckTrackerAckFrameEncodeMatchesFullEncode)
+{
+    TestAckTracker Test;
+    QUIC_ACK_TRACKER* Tracker = &Test.Packets->AckTracker;
+
+    //
+    // Each step checks both the kept encoding of the ACK blocks and writing
+    // the next frame again without any change in between.
+    //
+    auto AckAndCheck = [&](uint64_t PacketNumber) {
+        Test.Ack(PacketNumber);
+        Test.CheckAckFrame();
+        Test.CheckAckFrame();
+    };
+
+    //
+    // Extending the largest subrange.
+    //
+    for (uint64_t PacketNumber = 0; PacketNumber < 10; ++PacketNumber) {
+        ASSERT_NO_FATAL_FAILURE(AckAndCheck(PacketNumber));
+    }
+    ASSERT_TRUE(Tracker->EncodedAckBlocksValid);
+
+    //
+    // Starting new largest subranges, each one adding an ACK block.
+    //
+    for (uint64_t PacketNumber : {12, 13, 20, 30, 31, 1000, 70000, 70001}) {
+        ASSERT_NO_FATAL_FAILURE(AckAndCheck(PacketNumber));
+        ASSERT_TRUE(Tracker->EncodedAckBlocksValid);
+    }
+
+    //
+    // Packets below the largest subrange: a new hole, extending and merging
+    // older subranges, and filling holes entirely.
+    //
+    for (uint64_t PacketNumber : {25, 11, 10, 24, 14, 999, 69999, 15, 21}) {
+        ASSERT_NO_FATAL_FAILURE(AckAndCheck(PacketNumber));
+    }
+
+    //
+    // A new largest subrange right after the cache was invalidated and
+    // encoded again.
+    //
+    ASSERT_NO_FATAL_FAILURE(AckAndCheck(70010));
+    ASSERT_TRUE(Tracker->EncodedAckBlocksValid);
+
+    //
+    // More ACK blocks than fit in the kept encoding. The tracker also drops its
+    // oldest subranges on the way, once it holds as many as it can.
+    //
+    for (uint64_t PacketNumber = 80000; PacketNumber < 80000 + 100 * 200; PacketNumber += 100) {
+        ASSERT_NO_FATAL_FAILURE(AckAndCheck(PacketNumber));
+    }
+    ASSERT_FALSE(Tracker->EncodedAckBlocksValid);
+
+    //
+    // The peer acknowledging an ACK frame drops the older subranges.
+    //
+    QuicAckTrackerOnAckFrameAcked(Tracker, 80000 + 100 * 190);
+    ASSERT_NO_FATAL_FAILURE(Test.CheckAckFrame());
+    ASSERT_TRUE(Tracker->EncodedAckBlocksValid);
+    for (uint64_t PacketNumber : {100000, 100001, 100003, 80000 + 100 * 195 + 1}) {
+        ASSERT_NO_FATAL_FAILURE(AckAndCheck(PacketNumber));
+    }
+}
+
 struct ResetStreamFrameParams {
     uint8_t Buffer[4];
     uint16_t BufferLength = 4;
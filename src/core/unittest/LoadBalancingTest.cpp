@@ -0,0 +1,149 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the QUIC-LB server ID encoding.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "LoadBalancingTest.cpp.clog.h"
+#endif
+
+struct LoadBalancingTest : public ::testing::Test
+{
+    CXPLAT_HP_KEY* Key {nullptr};
+    QUIC_LB_CONFIG Config {};
+
+    void SetUp() override {
+        const uint8_t RawKey[QUIC_LB_KEY_LENGTH] = {
+            0x8f, 0x95, 0xf0, 0x92, 0x45, 0x76, 0x5f, 0x80,
+            0x25, 0x69, 0x34, 0xe5, 0x0c, 0x66, 0x20, 0x7f };
+        CxPlatCopyMemory(Config.Key, RawKey, sizeof(RawKey));
+        ASSERT_EQ(
+            QUIC_STATUS_SUCCESS,
+            CxPlatHpKeyCreate(CXPLAT_AEAD_AES_128_GCM, RawKey, &Key));
+    }
+    void TearDown() override {
+        CxPlatHpKeyFree(Key);
+    }
+};
+
+TEST_F(LoadBalancingTest, ConfigValidation)
+{
+    Config.ConfigId = 0;
+    Config.ServerIdLength = 1;
+    Config.NonceLength = QUIC_LB_MIN_NONCE_LENGTH;
+    ASSERT_TRUE(QuicLbConfigIsValid(&Config));
+
+    Config.ConfigId = QUIC_LB_MAX_CONFIG_ID + 1;
+    ASSERT_FALSE(QuicLbConfigIsValid(&Config));
+    Config.ConfigId = QUIC_LB_MAX_CONFIG_ID;
+
+    Config.ServerIdLength = 0;
+    ASSERT_FALSE(QuicLbConfigIsValid(&Config));
+    Config.ServerIdLength = QUIC_LB_MAX_SERVER_ID_LENGTH + 1;
+    ASSERT_FALSE(QuicLbConfigIsValid(&Config));
+    Config.ServerIdLength = QUIC_LB_MAX_SERVER_ID_LENGTH;
+    ASSERT_TRUE(QuicLbConfigIsValid(&Config));
+
+    Config.NonceLength = QUIC_LB_MAX_ENCODED_LENGTH - QUIC_LB_MAX_SERVER_ID_LENGTH + 1;
+    ASSERT_FALSE(QuicLbConfigIsValid(&Config));
+    Config.NonceLength = QUIC_LB_MIN_NONCE_LENGTH - 1;
+    ASSERT_FALSE(QuicLbConfigIsValid(&Config));
+}
+
+TEST_F(LoadBalancingTest, FourPassRoundTrip)
+{
+    for (uint8_t Length = QUIC_LB_MIN_NONCE_LENGTH + 1; Length <= QUIC_LB_MAX_ENCODED_LENGTH; ++Length) {
+        for (uint32_t i = 0; i < 100; ++i) {
+            uint8_t Plaintext[QUIC_LB_MAX_ENCODED_LENGTH];
+            uint8_t Block[QUIC_LB_MAX_ENCODED_LENGTH];
+            CxPlatRandom(Length, Plaintext);
+            CxPlatCopyMemory(Block, Plaintext, Length);
+
+            ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbFourPass(Key, TRUE, Length, Block));
+            ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbFourPass(Key, FALSE, Length, Block));
+            ASSERT_EQ(0, memcmp(Plaintext, Block, Length));
+        }
+    }
+}
+
+TEST_F(LoadBalancingTest, EncodeDecode)
+{
+    Config.Encrypted = TRUE;
+    for (uint8_t SidLength = 1; SidLength <= QUIC_LB_MAX_SERVER_ID_LENGTH; ++SidLength) {
+        for (uint8_t NonceLength = QUIC_LB_MIN_NONCE_LENGTH;
+             SidLength + NonceLength <= QUIC_LB_MAX_ENCODED_LENGTH;
+             ++NonceLength) {
+            Config.ConfigId = (SidLength + NonceLength) % (QUIC_LB_MAX_CONFIG_ID + 1);
+            Config.ServerIdLength = SidLength;
+            Config.NonceLength = NonceLength;
+            CxPlatRandom(SidLength, Config.ServerId);
+
+            uint8_t Cid[QUIC_CID_MAX_LENGTH];
+            uint8_t Cid2[QUIC_CID_MAX_LENGTH];
+            const uint8_t CidLength = QUIC_LB_ENCODED_LENGTH(&Config) + QUIC_CID_MIN_LENGTH;
+            ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbEncodeServerId(&Config, Key, CidLength, Cid));
+            ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbEncodeServerId(&Config, Key, CidLength, Cid2));
+            ASSERT_EQ(Config.ConfigId, Cid[0] >> QUIC_LB_CONFIG_ID_SHIFT);
+            ASSERT_EQ(CidLength - 1, Cid[0] & QUIC_LB_LENGTH_MASK);
+
+            //
+            // A fresh nonce makes every encoding different.
+            //
+            ASSERT_NE(0, memcmp(Cid, Cid2, QUIC_LB_ENCODED_LENGTH(&Config)));
+
+            uint8_t ServerId[QUIC_LB_MAX_SERVER_ID_LENGTH];
+            ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbDecodeServerId(&Config, Key, Cid, ServerId));
+            ASSERT_EQ(0, memcmp(Config.ServerId, ServerId, SidLength));
+            ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbDecodeServerId(&Config, Key, Cid2, ServerId));
+            ASSERT_EQ(0, memcmp(Config.ServerId, ServerId, SidLength));
+        }
+    }
+}
+
+TEST_F(LoadBalancingTest, KeyRotation)
+{
+    Config.Encrypted = TRUE;
+    Config.ConfigId = 1;
+    Config.ServerIdLength = 2;
+    Config.NonceLength = 6;
+    Config.ServerId[0] = 0x12;
+    Config.ServerId[1] = 0x34;
+
+    uint8_t Cid[QUIC_CID_MAX_LENGTH];
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbEncodeServerId(&Config, Key, 18, Cid));
+
+    //
+    // A config with the next ID doesn't claim CIDs of the old one.
+    //
+    QUIC_LB_CONFIG NewConfig = Config;
+    NewConfig.ConfigId = 2;
+    uint8_t ServerId[QUIC_LB_MAX_SERVER_ID_LENGTH];
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLbDecodeServerId(&NewConfig, Key, Cid, ServerId));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbDecodeServerId(&Config, Key, Cid, ServerId));
+    ASSERT_EQ(0, memcmp(Config.ServerId, ServerId, Config.ServerIdLength));
+}
+
+TEST_F(LoadBalancingTest, Plaintext)
+{
+    Config.ConfigId = 3;
+    Config.ServerIdLength = 4;
+    Config.NonceLength = 4;
+    CxPlatRandom(Config.ServerIdLength, Config.ServerId);
+
+    uint8_t Cid[QUIC_CID_MAX_LENGTH];
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbEncodeServerId(&Config, nullptr, 18, Cid));
+    ASSERT_EQ(0, memcmp(Config.ServerId, Cid + 1, Config.ServerIdLength));
+
+    uint8_t ServerId[QUIC_LB_MAX_SERVER_ID_LENGTH];
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicLbDecodeServerId(&Config, nullptr, Cid, ServerId));
+    ASSERT_EQ(0, memcmp(Config.ServerId, ServerId, Config.ServerIdLength));
+}
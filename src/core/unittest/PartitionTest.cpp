@@ -48,3 +48,57 @@ TEST(PartitionTest, RandomPartitionId)
 
     MsQuicLib.PartitionCount = OldPartitionCount;
 }
+
+TEST(PartitionTest, TicketCache)
+{
+    QUIC_TICKET_CACHE Cache;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicTicketCacheInitialize(&Cache, 2));
+
+    uint8_t TicketA[16], TicketB[32], TicketC[64];
+    CxPlatRandom(sizeof(TicketA), TicketA);
+    CxPlatRandom(sizeof(TicketB), TicketB);
+    CxPlatRandom(sizeof(TicketC), TicketC);
+
+    uint8_t RefA[QUIC_TICKET_CACHE_REF_LENGTH];
+    uint8_t RefB[QUIC_TICKET_CACHE_REF_LENGTH];
+    uint8_t RefC[QUIC_TICKET_CACHE_REF_LENGTH];
+    ASSERT_TRUE(QuicTicketCacheInsert(&Cache, 3, sizeof(TicketA), TicketA, RefA));
+    ASSERT_TRUE(QuicTicketCacheInsert(&Cache, 3, sizeof(TicketB), TicketB, RefB));
+
+    uint16_t PartitionIndex = 0;
+    ASSERT_TRUE(QuicTicketCacheIsRef(sizeof(RefA), RefA, &PartitionIndex));
+    ASSERT_EQ(3u, PartitionIndex);
+    ASSERT_FALSE(QuicTicketCacheIsRef(sizeof(TicketA), TicketA, &PartitionIndex));
+
+    uint8_t Ticket[QUIC_TICKET_CACHE_MAX_TICKET_LENGTH];
+    uint16_t TicketLength = 0;
+    ASSERT_TRUE(QuicTicketCacheLookup(&Cache, RefA, Ticket, &TicketLength));
+    ASSERT_EQ(sizeof(TicketA), TicketLength);
+    ASSERT_EQ(0, memcmp(Ticket, TicketA, sizeof(TicketA)));
+
+    //
+    // A was just used, so inserting C evicts B.
+    //
+    ASSERT_TRUE(QuicTicketCacheInsert(&Cache, 3, sizeof(TicketC), TicketC, RefC));
+    ASSERT_FALSE(QuicTicketCacheLookup(&Cache, RefB, Ticket, &TicketLength));
+    ASSERT_TRUE(QuicTicketCacheLookup(&Cache, RefA, Ticket, &TicketLength));
+    ASSERT_TRUE(QuicTicketCacheLookup(&Cache, RefC, Ticket, &TicketLength));
+    ASSERT_EQ(sizeof(TicketC), TicketLength);
+    ASSERT_EQ(0, memcmp(Ticket, TicketC, sizeof(TicketC)));
+
+    uint8_t LargeTicket[QUIC_TICKET_CACHE_MAX_TICKET_LENGTH + 1] = {0};
+    ASSERT_FALSE(QuicTicketCacheInsert(&Cache, 3, sizeof(LargeTicket), LargeTicket, RefB));
+
+    QuicTicketCacheFlush(&Cache);
+    ASSERT_FALSE(QuicTicketCacheLookup(&Cache, RefA, Ticket, &TicketLength));
+    ASSERT_FALSE(QuicTicketCacheLookup(&Cache, RefC, Ticket, &TicketLength));
+
+    QuicTicketCacheUninitialize(&Cache);
+
+    //
+    // A disabled cache stores nothing.
+    //
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicTicketCacheInitialize(&Cache, 0));
+    ASSERT_FALSE(QuicTicketCacheInsert(&Cache, 0, sizeof(TicketA), TicketA, RefA));
+    QuicTicketCacheUninitialize(&Cache);
+}
@@ -0,0 +1,179 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit tests for Prague (L4S) congestion control.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "PragueTest.cpp.clog.h"
+#endif
+
+static QUIC_SETTINGS_INTERNAL MockConnectionSettings;
+
+static void InitializeMockConnection(
+    QUIC_CONNECTION& Connection)
+{
+    CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Paths[0].Mtu = 1280;
+    Connection.Paths[0].IsActive = TRUE;
+
+    CxPlatZeroMemory(&MockConnectionSettings, sizeof(MockConnectionSettings));
+    MockConnectionSettings.InitialWindowPackets = 10;
+    Connection.Settings = &MockConnectionSettings;
+    PragueCongestionControlInitialize(&Connection.CongestionControl, &MockConnectionSettings);
+}
+
+static void AckPackets(
+    QUIC_CONNECTION& Connection,
+    uint64_t LargestAck,
+    uint32_t Bytes,
+    uint32_t EcnPackets,
+    uint32_t CePackets)
+{
+    QUIC_ACK_EVENT AckEvent;
+    CxPlatZeroMemory(&AckEvent, sizeof(AckEvent));
+    AckEvent.TimeNow = CxPlatTimeUs64();
+    AckEvent.LargestAck = LargestAck;
+    AckEvent.LargestSentPacketNumber = Connection.Send.NextPacketNumber - 1;
+    AckEvent.NumRetransmittableBytes = Bytes;
+    AckEvent.EcnPackets = EcnPackets;
+    AckEvent.EcnCePackets = CePackets;
+    QuicCongestionControlOnDataAcknowledged(&Connection.CongestionControl, &AckEvent);
+}
+
+static void SignalCe(
+    QUIC_CONNECTION& Connection,
+    uint64_t LargestAck)
+{
+    QUIC_ECN_EVENT EcnEvent;
+    EcnEvent.LargestPacketNumberAcked = LargestAck;
+    EcnEvent.LargestSentPacketNumber = Connection.Send.NextPacketNumber - 1;
+    QuicCongestionControlOnEcn(&Connection.CongestionControl, &EcnEvent);
+}
+
+//
+// Scenario: Prague marks packets with ECT(1) and starts with Alpha at 1.
+//
+TEST(PragueTest, Initialize)
+{
+    QUIC_CONNECTION Connection;
+    InitializeMockConnection(Connection);
+
+    QUIC_CONGESTION_CONTROL* Cc = &Connection.CongestionControl;
+    ASSERT_STREQ(Cc->Name, "Prague");
+    ASSERT_EQ(QuicCongestionControlGetEcnCodepoint(Cc), CXPLAT_ECN_ECT_1);
+    ASSERT_EQ(Cc->Prague.Alpha, PRAGUE_ALPHA_ONE);
+    ASSERT_EQ(Cc->Prague.SlowStartThreshold, UINT32_MAX);
+    ASSERT_EQ(Cc->Prague.CongestionWindow, 10u * QuicPathGetDatagramPayloadSize(&Connection.Paths[0]));
+}
+
+//
+// Scenario: Classic algorithms keep using ECT(0).
+//
+TEST(PragueTest, CubicUsesEct0)
+{
+    QUIC_CONNECTION Connection;
+    CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Paths[0].Mtu = 1280;
+    QUIC_SETTINGS_INTERNAL Settings{};
+    Settings.InitialWindowPackets = 10;
+    CubicCongestionControlInitialize(&Connection.CongestionControl, &Settings);
+
+    ASSERT_EQ(QuicCongestionControlGetEcnCodepoint(&Connection.CongestionControl), CXPLAT_ECN_ECT_0);
+}
+
+//
+// Scenario: The first CE mark (Alpha at 1) halves the window and exits slow
+// start. Further marks in the same round trip don't reduce it again.
+//
+TEST(PragueTest, CeReducesOncePerRound)
+{
+    QUIC_CONNECTION Connection;
+    InitializeMockConnection(Connection);
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Connection.CongestionControl.Prague;
+
+    const uint32_t Window = Prague->CongestionWindow;
+    Connection.Send.NextPacketNumber = 10;
+    QuicCongestionControlOnDataSent(&Connection.CongestionControl, 1000);
+
+    SignalCe(Connection, 2);
+    ASSERT_EQ(Prague->CongestionWindow, Window / 2);
+    ASSERT_EQ(Prague->SlowStartThreshold, Window / 2);
+    ASSERT_FALSE(Prague->IsInRecovery);
+    ASSERT_EQ(Connection.Stats.Send.EcnCongestionCount, 1u);
+
+    SignalCe(Connection, 5);
+    ASSERT_EQ(Prague->CongestionWindow, Window / 2);
+    ASSERT_EQ(Connection.Stats.Send.EcnCongestionCount, 1u);
+
+    Connection.Send.NextPacketNumber = 20;
+    SignalCe(Connection, 11);
+    ASSERT_EQ(Connection.Stats.Send.EcnCongestionCount, 2u);
+    ASSERT_LT(Prague->CongestionWindow, Window / 2);
+}
+
+//
+// Scenario: Alpha follows the fraction of CE marked packets per round trip,
+// and a light marking level only reduces the window slightly.
+//
+TEST(PragueTest, AlphaTracksMarkingFraction)
+{
+    QUIC_CONNECTION Connection;
+    InitializeMockConnection(Connection);
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Connection.CongestionControl.Prague;
+
+    //
+    // Many round trips with 1 in 10 packets marked.
+    //
+    for (uint64_t Round = 1; Round <= 100; ++Round) {
+        Connection.Send.NextPacketNumber = Round * 10;
+        QuicCongestionControlOnDataSent(&Connection.CongestionControl, 1000);
+        AckPackets(Connection, Round * 10 - 1, 1000, 10, 1);
+    }
+    const uint32_t TenPercent = PRAGUE_ALPHA_ONE / 10;
+    ASSERT_GT(Prague->Alpha, TenPercent - TenPercent / 10);
+    ASSERT_LT(Prague->Alpha, TenPercent + TenPercent / 10);
+
+    const uint32_t Window = Prague->CongestionWindow;
+    SignalCe(Connection, Connection.Send.NextPacketNumber - 1);
+    ASSERT_GT(Prague->CongestionWindow, Window - Window / 16);
+    ASSERT_LT(Prague->CongestionWindow, Window);
+}
+
+//
+// Scenario: Loss is a classic signal and halves the window, and window
+// growth pauses until recovery completes.
+//
+TEST(PragueTest, LossHalvesWindow)
+{
+    QUIC_CONNECTION Connection;
+    InitializeMockConnection(Connection);
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Connection.CongestionControl.Prague;
+
+    const uint32_t Window = Prague->CongestionWindow;
+    Connection.Send.NextPacketNumber = 10;
+    QuicCongestionControlOnDataSent(&Connection.CongestionControl, 4000);
+
+    QUIC_LOSS_EVENT LossEvent;
+    CxPlatZeroMemory(&LossEvent, sizeof(LossEvent));
+    LossEvent.LargestPacketNumberLost = 3;
+    LossEvent.LargestSentPacketNumber = 9;
+    LossEvent.NumRetransmittableBytes = 1000;
+    QuicCongestionControlOnDataLost(&Connection.CongestionControl, &LossEvent);
+    ASSERT_EQ(Prague->CongestionWindow, Window / 2);
+    ASSERT_TRUE(Prague->IsInRecovery);
+
+    AckPackets(Connection, 5, 1000, 0, 0);
+    ASSERT_EQ(Prague->CongestionWindow, Window / 2);
+
+    AckPackets(Connection, 10, 1000, 0, 0);
+    ASSERT_FALSE(Prague->IsInRecovery);
+
+    ASSERT_TRUE(QuicCongestionControlOnSpuriousCongestionEvent(&Connection.CongestionControl) == FALSE);
+}
@@ -787,3 +787,31 @@ TEST(RangeTest, SearchRangeThree)
     ASSERT_EQ(index, 2);
 #endif
 }
+
+TEST(RangeTest, Compact)
+{
+    SmartRange range;
+    const uint32_t Count = QUIC_RANGE_INITIAL_SUB_COUNT * 4;
+    for (uint32_t i = 0; i < Count; i++) {
+        range.Add(i * 2);
+    }
+    ASSERT_EQ(range.ValidCount(), Count);
+    ASSERT_NE(range.range.SubRanges, range.range.PreAllocSubRanges);
+
+    //
+    // Only the highest subranges are kept.
+    //
+    QuicRangeCompact(&range.range);
+    ASSERT_EQ(range.range.SubRanges, range.range.PreAllocSubRanges);
+    ASSERT_EQ(range.ValidCount(), (uint32_t)QUIC_RANGE_INITIAL_SUB_COUNT);
+    ASSERT_EQ(range.Max(), (uint64_t)(Count - 1) * 2);
+    ASSERT_EQ(range.Min(), (uint64_t)(Count - QUIC_RANGE_INITIAL_SUB_COUNT) * 2);
+
+    //
+    // The range still grows again on demand.
+    //
+    for (uint32_t i = Count; i < Count * 2; i++) {
+        range.Add(i * 2);
+    }
+    ASSERT_EQ(range.ValidCount(), Count + QUIC_RANGE_INITIAL_SUB_COUNT);
+}
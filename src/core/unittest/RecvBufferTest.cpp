@@ -23,6 +23,8 @@ Abstract:
 struct RecvBuffer {
     QUIC_RECV_BUFFER RecvBuf {0};
     CXPLAT_POOL AppBufferChunkPool {};
+    CXPLAT_POOL ChunkPools[QUIC_RECV_CHUNK_POOL_CLASS_COUNT] {};
+    bool ChunkPoolsInitialized {false};
     uint8_t* AppOwnedBuffer {nullptr};
 
     RecvBuffer() = default;
@@ -41,31 +43,41 @@ struct RecvBuffer {
             CXPLAT_FREE(AppOwnedBuffer, QUIC_POOL_TEST);
         }
         CxPlatPoolUninitialize(&AppBufferChunkPool);
+        if (ChunkPoolsInitialized) {
+            for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_CLASS_COUNT; ++i) {
+                CxPlatPoolUninitialize(&ChunkPools[i]);
+            }
+        }
     }
     QUIC_STATUS Initialize(
         _In_ QUIC_RECV_BUF_MODE RecvMode = QUIC_RECV_BUF_MODE_SINGLE,
-        _In_ bool PreallocatedChunk = false,
+        _In_ bool UseChunkPools = false,
         _In_ uint32_t AllocBufferLength = DEF_TEST_BUFFER_LENGTH,
-        _In_ uint32_t VirtualBufferLength = DEF_TEST_BUFFER_LENGTH
+        _In_ uint32_t VirtualBufferLength = DEF_TEST_BUFFER_LENGTH,
+        _In_ bool DeferAlloc = false
         ) {
         CxPlatPoolInitialize(FALSE, sizeof(QUIC_RECV_CHUNK), QUIC_POOL_TEST, &AppBufferChunkPool);
 
-        QUIC_RECV_CHUNK* PreallocChunk{nullptr};
-        if (PreallocatedChunk) {
-                PreallocChunk = (QUIC_RECV_CHUNK*)CXPLAT_ALLOC_NONPAGED(
-                    sizeof(QUIC_RECV_CHUNK) + AllocBufferLength,
-                    QUIC_POOL_RECVBUF); // Use the recv buffer pool tag as this memory is moved to the recv buffer.
-            QuicRecvChunkInitialize(PreallocChunk, AllocBufferLength, (uint8_t*)(PreallocChunk + 1), FALSE);
+        if (UseChunkPools) {
+            for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_CLASS_COUNT; ++i) {
+                CxPlatPoolInitialize(
+                    FALSE,
+                    sizeof(QUIC_RECV_CHUNK) + (QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE << i),
+                    QUIC_POOL_RECVBUF,
+                    &ChunkPools[i]);
+            }
+            ChunkPoolsInitialized = true;
         }
         printf("Initializing: [mode=%u,vlen=%u,alen=%u]\n", RecvMode, VirtualBufferLength, AllocBufferLength);
 
         auto Result = QuicRecvBufferInitialize(
-            &RecvBuf, AllocBufferLength, VirtualBufferLength, RecvMode, PreallocChunk);
+            &RecvBuf, AllocBufferLength, VirtualBufferLength, RecvMode, UseChunkPools ? ChunkPools : nullptr, DeferAlloc);
         if (Result != QUIC_STATUS_SUCCESS) {
             return Result;
         }
 
-        if (RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED && AllocBufferLength > 0) {
+        if ((RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+             RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE) && AllocBufferLength > 0) {
             //
             // In app-owned mode, provide app-owned buffers.
             // Provide up to two chunks, so that:
@@ -327,15 +339,124 @@ TEST_P(WithMode, Alloc)
     ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(GetParam()));
 }
 
-TEST_P(WithMode, AllocWithChunk)
+TEST_P(WithMode, AllocFromPool)
+{
+    const auto Mode = GetParam();
+    if (Mode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        // App-owned mode doesn't allocate chunks
+        return;
+    }
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(GetParam(), true, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE));
+    auto* Chunk = CXPLAT_CONTAINING_RECORD(RecvBuf.RecvBuf.Chunks.Flink, QUIC_RECV_CHUNK, Link);
+    ASSERT_TRUE(Chunk->AllocatedFromPool);
+}
+
+TEST_P(WithMode, DeferredAlloc)
+{
+    const auto Mode = GetParam();
+    if (Mode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        // App-owned mode doesn't allocate chunks
+        return;
+    }
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(Mode, false, DEF_TEST_BUFFER_LENGTH, LARGE_TEST_BUFFER_LENGTH, true));
+    ASSERT_TRUE(CxPlatListIsEmpty(&RecvBuf.RecvBuf.Chunks));
+    ASSERT_FALSE(RecvBuf.HasUnreadData());
+
+    uint64_t InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Write(0, 4, &InOutWriteLength, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+    ASSERT_FALSE(CxPlatListIsEmpty(&RecvBuf.RecvBuf.Chunks));
+    auto* Chunk = CXPLAT_CONTAINING_RECORD(RecvBuf.RecvBuf.Chunks.Flink, QUIC_RECV_CHUNK, Link);
+    ASSERT_EQ((uint32_t)DEF_TEST_BUFFER_LENGTH, Chunk->AllocLength);
+
+    uint64_t ReadOffset;
+    QUIC_BUFFER ReadBuffers[3];
+    uint32_t BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(1ul, BufferCount);
+    ASSERT_EQ(4ul, ReadBuffers[0].Length);
+    ASSERT_TRUE(RecvBuf.Drain(4));
+}
+
+TEST_P(WithMode, DeferredAllocLargeFirstWrite)
+{
+    const auto Mode = GetParam();
+    if (Mode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        // App-owned mode doesn't allocate chunks
+        return;
+    }
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(Mode, false, DEF_TEST_BUFFER_LENGTH, LARGE_TEST_BUFFER_LENGTH, true));
+
+    //
+    // The first chunk grows to fit a first write beyond the initial length.
+    //
+    uint64_t InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Write(DEF_TEST_BUFFER_LENGTH + 2, 4, &InOutWriteLength, &NewDataReady));
+    ASSERT_FALSE(NewDataReady);
+    auto* Chunk = CXPLAT_CONTAINING_RECORD(RecvBuf.RecvBuf.Chunks.Flink, QUIC_RECV_CHUNK, Link);
+    ASSERT_EQ((uint32_t)DEF_TEST_BUFFER_LENGTH * 2, Chunk->AllocLength);
+    ASSERT_EQ(Chunk->Link.Flink, &RecvBuf.RecvBuf.Chunks);
+}
+
+TEST_P(WithMode, DetachAndAttachChunk)
 {
     const auto Mode = GetParam();
     if (Mode == QUIC_RECV_BUF_MODE_APP_OWNED) {
-        // App-owned mode doesn't support preallocated chunks
+        // App-owned mode doesn't allocate chunks
         return;
     }
     RecvBuffer RecvBuf;
-    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(GetParam(), true));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(Mode, true, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE));
+
+    uint64_t InOutWriteLength = QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE;
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Write(0, 4, &InOutWriteLength, &NewDataReady));
+    uint64_t ReadOffset;
+    QUIC_BUFFER ReadBuffers[3];
+    uint32_t BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+
+    //
+    // Not while the app holds the chunk, nor for another length.
+    //
+    ASSERT_EQ(nullptr, QuicRecvBufferDetachChunk(&RecvBuf.RecvBuf, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE));
+    ASSERT_TRUE(RecvBuf.Drain(4));
+    ASSERT_EQ(nullptr, QuicRecvBufferDetachChunk(&RecvBuf.RecvBuf, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE * 2));
+
+    auto* Chunk = QuicRecvBufferDetachChunk(&RecvBuf.RecvBuf, QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE);
+    ASSERT_NE(nullptr, Chunk);
+    ASSERT_TRUE(CxPlatListIsEmpty(&RecvBuf.RecvBuf.Chunks));
+
+    //
+    // A fresh buffer starts with the detached chunk and works as usual.
+    //
+    QuicRecvBufferUninitialize(&RecvBuf.RecvBuf);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicRecvBufferInitialize(
+            &RecvBuf.RecvBuf,
+            QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE,
+            QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE,
+            Mode,
+            RecvBuf.ChunkPools,
+            TRUE));
+    QuicRecvBufferAttachChunk(&RecvBuf.RecvBuf, Chunk);
+    ASSERT_EQ(&Chunk->Link, RecvBuf.RecvBuf.Chunks.Flink);
+
+    InOutWriteLength = QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Write(0, 8, &InOutWriteLength, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+    BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(0ull, ReadOffset);
+    ASSERT_EQ(8ul, ReadBuffers[0].Length);
+    ASSERT_EQ(Chunk->Buffer, ReadBuffers[0].Buffer);
+    ASSERT_TRUE(RecvBuf.Drain(8));
 }
 
 void TestSingleWriteRead(QUIC_RECV_BUF_MODE Mode, uint16_t WriteLength, uint64_t WriteOffset, uint64_t DrainLength)
@@ -426,6 +547,62 @@ TEST_P(WithMode, WriteFillGap)
     ASSERT_EQ(30u, ReadBuffers[0].Length);
 }
 
+TEST_P(WithMode, WriteInPlace)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(GetParam()));
+    uint64_t InOutWriteLength = DEF_TEST_BUFFER_LENGTH; // FC limit same as recv buffer size
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.Write(
+            0,
+            10,
+            &InOutWriteLength,
+            &NewDataReady));
+
+    //
+    // Fill in the next 20 bytes directly and then record the write.
+    //
+    QUIC_BUFFER WriteBuffers[3];
+    uint32_t BufferCount = ARRAYSIZE(WriteBuffers);
+    ASSERT_FALSE(QuicRecvBufferGetWriteBuffers(&RecvBuf.RecvBuf, 5, 20, &BufferCount, WriteBuffers));
+    BufferCount = ARRAYSIZE(WriteBuffers);
+    ASSERT_TRUE(QuicRecvBufferGetWriteBuffers(&RecvBuf.RecvBuf, 10, 20, &BufferCount, WriteBuffers));
+    uint8_t Value = 10;
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        for (uint32_t j = 0; j < WriteBuffers[i].Length; ++j) {
+            WriteBuffers[i].Buffer[j] = Value++;
+        }
+    }
+    ASSERT_EQ(30, Value);
+
+    uint64_t QuotaConsumed = 0;
+    uint64_t BufferSizeNeeded = 0;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicRecvBufferWrite(
+            &RecvBuf.RecvBuf,
+            10,
+            20,
+            NULL,
+            DEF_TEST_BUFFER_LENGTH,
+            &QuotaConsumed,
+            &NewDataReady,
+            &BufferSizeNeeded));
+    ASSERT_TRUE(NewDataReady);
+    ASSERT_EQ(20ull, QuotaConsumed);
+    ASSERT_EQ(30ull, RecvBuf.GetTotalLength());
+
+    uint64_t ReadOffset;
+    QUIC_BUFFER ReadBuffers[3];
+    BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers); // Validates the data
+    ASSERT_EQ(0ull, ReadOffset);
+    ASSERT_EQ(1ul, BufferCount);
+    ASSERT_EQ(30u, ReadBuffers[0].Length);
+}
+
 TEST_P(WithMode, Overwrite)
 {
     RecvBuffer RecvBuf;
@@ -1180,6 +1357,60 @@ TEST_P(WithMode, IncreaseVirtualLength)
     }
 }
 
+//
+// Checks the memory held by idle stream receive buffers, such as those of
+// the many streams of a connection that are open but haven't received data.
+// With the first chunk deferred, they hold no chunk at all.
+//
+TEST_P(WithMode, IdleFootprint)
+{
+    const auto Mode = GetParam();
+    if (Mode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        // App-owned mode doesn't allocate chunks
+        return;
+    }
+
+    const uint32_t BufferCount = 1000;
+    QUIC_RECV_BUFFER* RecvBufs =
+        (QUIC_RECV_BUFFER*)CXPLAT_ALLOC_NONPAGED(BufferCount * sizeof(QUIC_RECV_BUFFER), QUIC_POOL_TEST);
+    ASSERT_NE(nullptr, RecvBufs);
+
+    uint64_t Footprints[2];
+    for (uint32_t DeferAlloc = 0; DeferAlloc < 2; ++DeferAlloc) {
+        uint64_t Footprint = 0;
+        for (uint32_t i = 0; i < BufferCount; ++i) {
+            ASSERT_EQ(
+                QUIC_STATUS_SUCCESS,
+                QuicRecvBufferInitialize(
+                    &RecvBufs[i],
+                    QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE,
+                    QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE,
+                    Mode,
+                    NULL,
+                    (BOOLEAN)DeferAlloc));
+            Footprint += sizeof(QUIC_RECV_BUFFER);
+            for (CXPLAT_LIST_ENTRY* Link = RecvBufs[i].Chunks.Flink;
+                 Link != &RecvBufs[i].Chunks;
+                 Link = Link->Flink) {
+                QUIC_RECV_CHUNK* Chunk = CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link);
+                Footprint += sizeof(QUIC_RECV_CHUNK) + Chunk->AllocLength;
+            }
+        }
+        for (uint32_t i = 0; i < BufferCount; ++i) {
+            QuicRecvBufferUninitialize(&RecvBufs[i]);
+        }
+
+        Footprints[DeferAlloc] = Footprint / BufferCount;
+    }
+
+    CXPLAT_FREE(RecvBufs, QUIC_POOL_TEST);
+
+    ASSERT_EQ(sizeof(QUIC_RECV_BUFFER), Footprints[1]);
+    ASSERT_GE(
+        Footprints[0],
+        sizeof(QUIC_RECV_BUFFER) + sizeof(QUIC_RECV_CHUNK) + QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE);
+}
+
 // Validate the gap can span the edge of a chunk
 // |0, 1, 2, 3, x, x, x, x| ReadStart:0, ReadLength:4, Ext:0
 // |R, R, R, R, x, x, x, x| ReadStart:0, ReadLength:4, Ext:1
@@ -2152,6 +2383,134 @@ TEST(AppOwnedBuffersTest, FreeBufferBeforeDrain)
     RecvBuf.Drain(8);
 }
 
+TEST(AppOwnedBuffersTest, WriteInPlace)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_APP_OWNED, false, 0, 0));
+
+    std::array<uint8_t, 24> Buffer{};
+    std::vector ChunkSizes{8u, 8u, 8u};
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(ChunkSizes, Buffer.size(), Buffer.data()));
+
+    uint64_t InOutWriteLength = DEF_TEST_BUFFER_LENGTH;
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Write(0, 4, &InOutWriteLength, &NewDataReady));
+
+    //
+    // Ranges overlapping written data, past the provided memory or needing
+    // too many buffers are rejected.
+    //
+    QUIC_BUFFER Buffers[3];
+    uint32_t BufferCount = ARRAYSIZE(Buffers);
+    ASSERT_FALSE(QuicRecvBufferGetWriteBuffers(&RecvBuf.RecvBuf, 2, 8, &BufferCount, Buffers));
+    BufferCount = ARRAYSIZE(Buffers);
+    ASSERT_FALSE(QuicRecvBufferGetWriteBuffers(&RecvBuf.RecvBuf, 20, 8, &BufferCount, Buffers));
+    BufferCount = 1;
+    ASSERT_FALSE(QuicRecvBufferGetWriteBuffers(&RecvBuf.RecvBuf, 4, 12, &BufferCount, Buffers));
+
+    //
+    // A range spanning chunks is split across the app-owned buffers, and
+    // becomes readable once written in place.
+    //
+    BufferCount = ARRAYSIZE(Buffers);
+    ASSERT_TRUE(QuicRecvBufferGetWriteBuffers(&RecvBuf.RecvBuf, 4, 12, &BufferCount, Buffers));
+    ASSERT_EQ(2u, BufferCount);
+    ASSERT_EQ(Buffer.data() + 4, Buffers[0].Buffer);
+    ASSERT_EQ(4u, Buffers[0].Length);
+    ASSERT_EQ(Buffer.data() + 8, Buffers[1].Buffer);
+    ASSERT_EQ(8u, Buffers[1].Length);
+
+    uint64_t Offset = 4;
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        for (uint32_t j = 0; j < Buffers[i].Length; ++j) {
+            Buffers[i].Buffer[j] = (uint8_t)Offset++;
+        }
+    }
+
+    uint64_t QuotaConsumed = 0;
+    uint64_t SizeNeeded = 0;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicRecvBufferWrite(
+            &RecvBuf.RecvBuf, 4, 12, NULL, DEF_TEST_BUFFER_LENGTH,
+            &QuotaConsumed, &NewDataReady, &SizeNeeded));
+    ASSERT_EQ(12u, QuotaConsumed);
+    ASSERT_TRUE(NewDataReady);
+
+    uint32_t LengthList[] = {8, 8};
+    BOOLEAN ExternalReferences[] = {TRUE, TRUE, FALSE};
+    RecvBuf.ReadAndCheck(2, LengthList, 0, 8, 3, ExternalReferences);
+    RecvBuf.Drain(16);
+}
+
+TEST(AppOwnedBuffersTest, MultiplePendingReads)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE, false, 0, 0));
+
+    const uint32_t NbChunks = 3;
+    std::array<uint8_t, NbChunks * 8> Buffer{};
+    std::vector ChunkSizes(NbChunks, 8u);
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(ChunkSizes, Buffer.size(), Buffer.data()));
+
+    std::vector<BOOLEAN> ExternalReferences(NbChunks, FALSE);
+    RecvBuf.WriteAndCheck(0, 12, 0, 8, NbChunks, ExternalReferences.data());
+    uint32_t LengthList[] = {8, 4};
+    ExternalReferences[0] = TRUE;
+    ExternalReferences[1] = TRUE;
+    RecvBuf.ReadAndCheck(2, LengthList, 0, 8, NbChunks, ExternalReferences.data());
+
+    //
+    // A second read, while the first is pending, only indicates the new data.
+    //
+    RecvBuf.WriteAndCheck(12, 8, 0, 8, NbChunks, ExternalReferences.data());
+    LengthList[0] = 4;
+    LengthList[1] = 4;
+    ExternalReferences[2] = TRUE;
+    RecvBuf.ReadAndCheck(2, LengthList, 0, 8, NbChunks, ExternalReferences.data());
+
+    //
+    // Draining the first buffer gives it back while the rest stays pending.
+    //
+    ASSERT_FALSE(RecvBuf.Drain(8));
+    ASSERT_EQ(12u, RecvBuf.RecvBuf.ReadPendingLength);
+    RecvBuf.Check(0, 8, NbChunks - 1, ExternalReferences.data() + 1);
+
+    ASSERT_TRUE(RecvBuf.Drain(12));
+    ExternalReferences[2] = FALSE;
+    RecvBuf.Check(4, 0, 1, ExternalReferences.data() + 2);
+}
+
+TEST(AppOwnedBuffersTest, MultipleProvideWhileReadPending)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE, false, 0, 0));
+
+    std::array<uint8_t, 16> Buffer{};
+    std::vector ChunkSizes{8u};
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(ChunkSizes, 8, Buffer.data()));
+
+    BOOLEAN ExternalReferences[] = {FALSE, FALSE};
+    RecvBuf.WriteAndCheck(0, 8, 0, 8, 1, ExternalReferences);
+    uint32_t LengthList[] = {8};
+    ExternalReferences[0] = TRUE;
+    RecvBuf.ReadAndCheck(1, LengthList, 0, 8, 1, ExternalReferences);
+
+    //
+    // More buffers can be provided while the read is pending.
+    //
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(ChunkSizes, 8, Buffer.data() + 8));
+    ASSERT_EQ(16u, RecvBuf.RecvBuf.VirtualBufferLength);
+    RecvBuf.WriteAndCheck(8, 4, 0, 8, 2, ExternalReferences);
+    LengthList[0] = 4;
+    ExternalReferences[1] = TRUE;
+    RecvBuf.ReadAndCheck(1, LengthList, 0, 8, 2, ExternalReferences);
+
+    ASSERT_TRUE(RecvBuf.Drain(12));
+    ExternalReferences[0] = FALSE;
+    RecvBuf.Check(4, 0, 1, ExternalReferences);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     RecvBufferTest,
     WithMode,
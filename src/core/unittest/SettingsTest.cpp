@@ -129,9 +129,15 @@ TEST(SettingsTest, TestAllSettingsFieldsSet)
     SETTINGS_FEATURE_SET_TEST(OneWayDelayEnabled, QuicSettingsSettingsToInternal);
     SETTINGS_FEATURE_SET_TEST(NetStatsEventEnabled, QuicSettingsSettingsToInternal);
     SETTINGS_FEATURE_SET_TEST(StreamMultiReceiveEnabled, QuicSettingsSettingsToInternal);
-
-    // Bias field count on behalf of erstwhile ReservedRioEnabled
-    FieldCount++;
+    SETTINGS_FEATURE_SET_TEST(ControlFrameCoalescingEnabled, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(EncryptFromSendBuffersEnabled, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(ConnFlowControlWindowMax, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(HibernateTimeoutMs, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(PeerStreamCountMax, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(SpinBitDisableRate, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(StreamBatchReceiveEnabled, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(CarefulResumeEnabled, QuicSettingsSettingsToInternal);
+    SETTINGS_FEATURE_SET_TEST(RioEnabled, QuicSettingsSettingsToInternal);
 
     Settings.IsSetFlags = 0;
     Settings.IsSet.RESERVED = ~Settings.IsSet.RESERVED;
@@ -220,9 +226,15 @@ TEST(SettingsTest, TestAllSettingsFieldsGet)
     SETTINGS_FEATURE_GET_TEST(OneWayDelayEnabled, QuicSettingsGetSettings);
     SETTINGS_FEATURE_GET_TEST(NetStatsEventEnabled, QuicSettingsGetSettings);
     SETTINGS_FEATURE_GET_TEST(StreamMultiReceiveEnabled, QuicSettingsGetSettings);
-
-    // Bias field count on behalf of erstwhile ReservedRioEnabled
-    FieldCount++;
+    SETTINGS_FEATURE_GET_TEST(ControlFrameCoalescingEnabled, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(EncryptFromSendBuffersEnabled, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(ConnFlowControlWindowMax, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(HibernateTimeoutMs, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(PeerStreamCountMax, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(SpinBitDisableRate, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(StreamBatchReceiveEnabled, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(CarefulResumeEnabled, QuicSettingsGetSettings);
+    SETTINGS_FEATURE_GET_TEST(RioEnabled, QuicSettingsGetSettings);
 
     Settings.IsSetFlags = 0;
     Settings.IsSet.RESERVED = ~Settings.IsSet.RESERVED;
@@ -245,6 +257,191 @@ TEST(SettingsTest, TestAllGlobalSettingsFieldsGet)
     ASSERT_EQ(FieldCount, (sizeof(Settings.IsSetFlags) * 8) - PopCount(Settings.IsSetFlags));
 }
 
+#define SETTINGS_FIELD_TABLE_TEST(Field)                                                    \
+    FieldCount++;                                                                           \
+    Settings.IsSetFlags = 0;                                                                \
+    Settings.IsSet.Field = 1;                                                               \
+    ASSERT_EQ(1u, PopCount(Settings.IsSetFlags));                                           \
+    Index = 0;                                                                              \
+    while (!(Settings.IsSetFlags & (1ull << Index))) { Index++; }                           \
+    ASSERT_EQ(offsetof(QUIC_SETTINGS_INTERNAL, Field), (size_t)QuicSettingFields[Index].Offset); \
+    ASSERT_EQ(sizeof(Settings.Field), (size_t)QuicSettingFields[Index].Size);
+
+TEST(SettingsTest, FieldTableMatchesIsSetFlags)
+{
+    QUIC_SETTINGS_INTERNAL Settings;
+    uint32_t FieldCount = 0;
+    uint32_t Index;
+    CxPlatZeroMemory(&Settings, sizeof(Settings));
+
+    SETTINGS_FIELD_TABLE_TEST(MaxBytesPerKey);
+    SETTINGS_FIELD_TABLE_TEST(HandshakeIdleTimeoutMs);
+    SETTINGS_FIELD_TABLE_TEST(IdleTimeoutMs);
+    SETTINGS_FIELD_TABLE_TEST(TlsClientMaxSendBuffer);
+    SETTINGS_FIELD_TABLE_TEST(TlsServerMaxSendBuffer);
+    SETTINGS_FIELD_TABLE_TEST(StreamRecvWindowDefault);
+    SETTINGS_FIELD_TABLE_TEST(StreamRecvWindowBidiLocalDefault);
+    SETTINGS_FIELD_TABLE_TEST(StreamRecvWindowBidiRemoteDefault);
+    SETTINGS_FIELD_TABLE_TEST(StreamRecvWindowUnidiDefault);
+    SETTINGS_FIELD_TABLE_TEST(StreamRecvBufferDefault);
+    SETTINGS_FIELD_TABLE_TEST(ConnFlowControlWindow);
+    SETTINGS_FIELD_TABLE_TEST(MaxWorkerQueueDelayUs);
+    SETTINGS_FIELD_TABLE_TEST(MaxStatelessOperations);
+    SETTINGS_FIELD_TABLE_TEST(InitialWindowPackets);
+    SETTINGS_FIELD_TABLE_TEST(SendIdleTimeoutMs);
+    SETTINGS_FIELD_TABLE_TEST(InitialRttMs);
+    SETTINGS_FIELD_TABLE_TEST(MaxAckDelayMs);
+    SETTINGS_FIELD_TABLE_TEST(DisconnectTimeoutMs);
+    SETTINGS_FIELD_TABLE_TEST(KeepAliveIntervalMs);
+    SETTINGS_FIELD_TABLE_TEST(PeerBidiStreamCount);
+    SETTINGS_FIELD_TABLE_TEST(PeerUnidiStreamCount);
+    SETTINGS_FIELD_TABLE_TEST(RetryMemoryLimit);
+    SETTINGS_FIELD_TABLE_TEST(LoadBalancingMode);
+    SETTINGS_FIELD_TABLE_TEST(FixedServerID);
+    SETTINGS_FIELD_TABLE_TEST(MaxOperationsPerDrain);
+    SETTINGS_FIELD_TABLE_TEST(SendBufferingEnabled);
+    SETTINGS_FIELD_TABLE_TEST(PacingEnabled);
+    SETTINGS_FIELD_TABLE_TEST(MigrationEnabled);
+    SETTINGS_FIELD_TABLE_TEST(DatagramReceiveEnabled);
+    SETTINGS_FIELD_TABLE_TEST(ServerResumptionLevel);
+    SETTINGS_FIELD_TABLE_TEST(VersionSettings);
+    SETTINGS_FIELD_TABLE_TEST(VersionNegotiationExtEnabled);
+    SETTINGS_FIELD_TABLE_TEST(MinimumMtu);
+    SETTINGS_FIELD_TABLE_TEST(MaximumMtu);
+    SETTINGS_FIELD_TABLE_TEST(MtuDiscoverySearchCompleteTimeoutUs);
+    SETTINGS_FIELD_TABLE_TEST(MtuDiscoveryMissingProbeCount);
+    SETTINGS_FIELD_TABLE_TEST(MaxBindingStatelessOperations);
+    SETTINGS_FIELD_TABLE_TEST(StatelessOperationExpirationMs);
+    SETTINGS_FIELD_TABLE_TEST(CongestionControlAlgorithm);
+    SETTINGS_FIELD_TABLE_TEST(DestCidUpdateIdleTimeoutMs);
+    SETTINGS_FIELD_TABLE_TEST(GreaseQuicBitEnabled);
+    SETTINGS_FIELD_TABLE_TEST(EcnEnabled);
+    SETTINGS_FIELD_TABLE_TEST(HyStartEnabled);
+    SETTINGS_FIELD_TABLE_TEST(EncryptionOffloadAllowed);
+    SETTINGS_FIELD_TABLE_TEST(ReliableResetEnabled);
+    SETTINGS_FIELD_TABLE_TEST(OneWayDelayEnabled);
+    SETTINGS_FIELD_TABLE_TEST(NetStatsEventEnabled);
+    SETTINGS_FIELD_TABLE_TEST(StreamMultiReceiveEnabled);
+    SETTINGS_FIELD_TABLE_TEST(XdpEnabled);
+    SETTINGS_FIELD_TABLE_TEST(QTIPEnabled);
+    SETTINGS_FIELD_TABLE_TEST(RioEnabled);
+    SETTINGS_FIELD_TABLE_TEST(ControlFrameCoalescingEnabled);
+    SETTINGS_FIELD_TABLE_TEST(EncryptFromSendBuffersEnabled);
+    SETTINGS_FIELD_TABLE_TEST(ConnFlowControlWindowMax);
+    SETTINGS_FIELD_TABLE_TEST(StreamBatchReceiveEnabled);
+    SETTINGS_FIELD_TABLE_TEST(CarefulResumeEnabled);
+    SETTINGS_FIELD_TABLE_TEST(HibernateTimeoutMs);
+    SETTINGS_FIELD_TABLE_TEST(PeerStreamCountMax);
+    SETTINGS_FIELD_TABLE_TEST(SpinBitDisableRate);
+
+    ASSERT_EQ((uint32_t)QUIC_SETTINGS_COUNT, FieldCount);
+}
+
+TEST(SettingsTest, ApplyValidatesBeforeChanging)
+{
+    QUIC_SETTINGS_INTERNAL Source;
+    QUIC_SETTINGS_INTERNAL Destination;
+    CxPlatZeroMemory(&Source, sizeof(Source));
+    CxPlatZeroMemory(&Destination, sizeof(Destination));
+
+    Source.IsSet.IdleTimeoutMs = 1;
+    Source.IdleTimeoutMs = 1000;
+    Source.IsSet.HyStartEnabled = 1;
+    Source.HyStartEnabled = TRUE;
+    Source.IsSet.DisconnectTimeoutMs = 1;
+    Source.DisconnectTimeoutMs = 0;
+
+    ASSERT_FALSE(QuicSettingApply(&Destination, TRUE, TRUE, &Source));
+    ASSERT_EQ(0ull, Destination.IsSetFlags);
+    ASSERT_EQ(0ull, Destination.IdleTimeoutMs);
+
+    Source.DisconnectTimeoutMs = 1000;
+    ASSERT_TRUE(QuicSettingApply(&Destination, TRUE, TRUE, &Source));
+    ASSERT_TRUE(Destination.IsSet.IdleTimeoutMs);
+    ASSERT_EQ(1000ull, Destination.IdleTimeoutMs);
+    ASSERT_TRUE(Destination.IsSet.HyStartEnabled);
+    ASSERT_TRUE(Destination.HyStartEnabled);
+    ASSERT_EQ(1000u, Destination.DisconnectTimeoutMs);
+
+    //
+    // Without OverWrite, values already set are kept.
+    //
+    Source.IdleTimeoutMs = 2000;
+    ASSERT_TRUE(QuicSettingApply(&Destination, FALSE, TRUE, &Source));
+    ASSERT_EQ(1000ull, Destination.IdleTimeoutMs);
+
+    //
+    // An invalid MTU pair fails before any other field or the stream windows
+    // are written.
+    //
+    Source.IdleTimeoutMs = 3000;
+    Source.IsSet.StreamRecvWindowDefault = 1;
+    Source.StreamRecvWindowDefault = 0x10000;
+    Source.IsSet.MinimumMtu = 1;
+    Source.MinimumMtu = 1400;
+    Source.IsSet.MaximumMtu = 1;
+    Source.MaximumMtu = 1300;
+    ASSERT_FALSE(QuicSettingApply(&Destination, TRUE, TRUE, &Source));
+    ASSERT_EQ(1000ull, Destination.IdleTimeoutMs);
+    ASSERT_FALSE(Destination.IsSet.StreamRecvWindowDefault);
+    ASSERT_EQ(0u, Destination.StreamRecvWindowBidiLocalDefault);
+    ASSERT_FALSE(Destination.IsSet.MinimumMtu);
+    ASSERT_FALSE(Destination.IsSet.MaximumMtu);
+
+    QuicSettingsCleanup(&Destination);
+}
+
+TEST(SettingsTest, SpinBitDisableRateMinimum)
+{
+    QUIC_SETTINGS_INTERNAL Source;
+    QUIC_SETTINGS_INTERNAL Destination;
+    CxPlatZeroMemory(&Source, sizeof(Source));
+    CxPlatZeroMemory(&Destination, sizeof(Destination));
+    QuicSettingsSetDefault(&Destination);
+    ASSERT_EQ(QUIC_DEFAULT_SPIN_BIT_DISABLE_RATE, Destination.SpinBitDisableRate);
+
+    //
+    // RFC 9000 requires disabling the spin bit on at least 1 in 16 paths.
+    //
+    Source.IsSet.SpinBitDisableRate = 1;
+    Source.SpinBitDisableRate = QUIC_MIN_SPIN_BIT_DISABLE_RATE - 1;
+    ASSERT_FALSE(QuicSettingApply(&Destination, TRUE, TRUE, &Source));
+    ASSERT_EQ(QUIC_DEFAULT_SPIN_BIT_DISABLE_RATE, Destination.SpinBitDisableRate);
+
+    Source.SpinBitDisableRate = UINT16_MAX;
+    ASSERT_TRUE(QuicSettingApply(&Destination, TRUE, TRUE, &Source));
+    ASSERT_EQ(UINT16_MAX, Destination.SpinBitDisableRate);
+
+    QuicSettingsCleanup(&Destination);
+}
+
+TEST(SettingsTest, CopyOnlyFillsUnsetFields)
+{
+    QUIC_SETTINGS_INTERNAL Source;
+    QUIC_SETTINGS_INTERNAL Destination;
+    CxPlatZeroMemory(&Source, sizeof(Source));
+    CxPlatZeroMemory(&Destination, sizeof(Destination));
+    QuicSettingsSetDefault(&Source);
+
+    QuicSettingsCopy(&Destination, &Source);
+    ASSERT_EQ(0ull, Destination.IsSetFlags);
+    ASSERT_EQ(Source.IdleTimeoutMs, Destination.IdleTimeoutMs);
+    ASSERT_EQ(Source.PacingEnabled, Destination.PacingEnabled);
+    ASSERT_EQ(Source.MaximumMtu, Destination.MaximumMtu);
+
+    CxPlatZeroMemory(&Destination, sizeof(Destination));
+    Destination.IsSet.IdleTimeoutMs = 1;
+    Destination.IdleTimeoutMs = Source.IdleTimeoutMs + 1;
+    QuicSettingsCopy(&Destination, &Source);
+    ASSERT_EQ(Source.IdleTimeoutMs + 1, Destination.IdleTimeoutMs);
+    ASSERT_EQ(Source.HandshakeIdleTimeoutMs, Destination.HandshakeIdleTimeoutMs);
+    ASSERT_EQ(Source.PacingEnabled, Destination.PacingEnabled);
+    ASSERT_EQ(Source.MaximumMtu, Destination.MaximumMtu);
+
+    QuicSettingsCleanup(&Source);
+    QuicSettingsCleanup(&Destination);
+}
+
 TEST(SettingsTest, StreamRecvWindowDefaultSetsIndividualLimits)
 {
     QUIC_SETTINGS_INTERNAL Source;
@@ -361,6 +558,46 @@ TEST(SettingsTest, QuicSettingsSetDefault_DoesNotOverwriteSetFields)
     ASSERT_EQ(Settings.MigrationEnabled, QUIC_DEFAULT_MIGRATION_ENABLED);
 }
 
+TEST(SettingsTest, SharedSettingsOwnVersionSettings)
+{
+    uint32_t Versions[] = { QUIC_VERSION_2, QUIC_VERSION_1 };
+    QUIC_VERSION_SETTINGS VersionSettings = {
+        Versions, Versions, Versions,
+        ARRAYSIZE(Versions), ARRAYSIZE(Versions), ARRAYSIZE(Versions)
+    };
+
+    QUIC_SETTINGS_INTERNAL Settings;
+    CxPlatZeroMemory(&Settings, sizeof(Settings));
+    Settings.IdleTimeoutMs = 1234;
+    Settings.IsSet.IdleTimeoutMs = 1;
+    Settings.VersionSettings = &VersionSettings;
+    Settings.IsSet.VersionSettings = 1;
+
+    QUIC_SHARED_SETTINGS* SharedSettings = QuicSharedSettingsAlloc(&Settings);
+    ASSERT_NE(nullptr, SharedSettings);
+    ASSERT_EQ(1234ull, SharedSettings->Settings.IdleTimeoutMs);
+    ASSERT_EQ(1u, SharedSettings->Settings.IsSet.IdleTimeoutMs);
+
+    //
+    // The version settings are copied, not referenced.
+    //
+    ASSERT_NE(&VersionSettings, SharedSettings->Settings.VersionSettings);
+    ASSERT_EQ(
+        (uint32_t)ARRAYSIZE(Versions),
+        SharedSettings->Settings.VersionSettings->FullyDeployedVersionsLength);
+    Versions[0] = QUIC_VERSION_1;
+    ASSERT_EQ(
+        (uint32_t)QUIC_VERSION_2,
+        SharedSettings->Settings.VersionSettings->FullyDeployedVersions[0]);
+
+    QuicSharedSettingsAddRef(SharedSettings);
+    QuicSharedSettingsRelease(SharedSettings);
+    ASSERT_EQ(
+        (uint32_t)QUIC_VERSION_2,
+        SharedSettings->Settings.VersionSettings->FullyDeployedVersions[0]);
+    QuicSharedSettingsRelease(SharedSettings);
+}
+
 class QuicStorageSettingScopeGuard {
 public:
     static
@@ -807,6 +1044,397 @@ TEST(SettingsTest, GlobalLoadBalancingServerIDSet)
             &OldMode));
 }
 
+TEST(SettingsTest, GlobalLoadBalancingQuicLbSet)
+{
+    uint16_t Mode = QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB;
+    uint16_t OldMode = MsQuicLib.Settings.LoadBalancingMode;
+    QUIC_LB_CONFIG Config = {0};
+    Config.ConfigId = 2;
+    Config.ServerIdLength = 3;
+    Config.NonceLength = 5;
+    Config.ServerId[0] = 0xA1;
+    Config.ServerId[1] = 0xB2;
+    Config.ServerId[2] = 0xC3;
+
+    Config.NonceLength = QUIC_LB_MIN_NONCE_LENGTH - 1;
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QUIC_LB_CONFIG,
+            sizeof(Config),
+            &Config));
+    Config.NonceLength = 5;
+
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QUIC_LB_CONFIG,
+            sizeof(Config),
+            &Config));
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE,
+            sizeof(Mode),
+            &Mode));
+
+    ASSERT_EQ(Mode, MsQuicLib.Settings.LoadBalancingMode);
+    ASSERT_EQ(9, MsQuicLib.CidServerIdLength);
+    ASSERT_EQ(QUIC_CID_PID_LENGTH + QUIC_CID_PAYLOAD_LENGTH + 9, MsQuicLib.CidTotalLength);
+
+    uint8_t ServerID[QUIC_MAX_CID_SID_LENGTH] = {0};
+    QUIC_CID_HASH_ENTRY* Entry =
+        QuicCidNewRandomSource(NULL, ServerID, 0x1234, 0, NULL);
+    ASSERT_NE(nullptr, Entry);
+    ASSERT_EQ(MsQuicLib.CidTotalLength, Entry->CID.Length);
+    ASSERT_EQ((2 << 5) | (MsQuicLib.CidTotalLength - 1), Entry->CID.Data[0]);
+    ASSERT_EQ(0, memcmp(Config.ServerId, Entry->CID.Data + 1, 3));
+    ASSERT_EQ(0x1234, *(uint16_t*)(Entry->CID.Data + 9));
+    CXPLAT_FREE(Entry, QUIC_POOL_CIDHASH);
+
+    // Revert
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE,
+            sizeof(OldMode),
+            &OldMode));
+}
+
+TEST(SettingsTest, GlobalRssPartitioningDisable)
+{
+    uint32_t InterfaceIndex = 0;
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_RSS_PARTITIONING_INTERFACE,
+            sizeof(uint16_t),
+            &InterfaceIndex));
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_RSS_PARTITIONING_INTERFACE,
+            sizeof(InterfaceIndex),
+            &InterfaceIndex));
+
+    InterfaceIndex = UINT32_MAX;
+    uint32_t BufferLength = sizeof(InterfaceIndex);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_RSS_PARTITIONING_INTERFACE,
+            &BufferLength,
+            &InterfaceIndex));
+    ASSERT_EQ(0u, InterfaceIndex);
+    ASSERT_EQ(nullptr, MsQuicLib.RssPartitioning.Config);
+}
+
+TEST(SettingsTest, GlobalMemoryBudget)
+{
+    uint64_t Budget = 1000;
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_BUDGET,
+            sizeof(uint32_t),
+            &Budget));
+
+    //
+    // Start from a known usage.
+    //
+    const int64_t OldUsage = (int64_t)MsQuicLib.CurrentMemoryUsage;
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, -OldUsage);
+
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_BUDGET,
+            sizeof(Budget),
+            &Budget));
+    ASSERT_EQ(QUIC_MEMORY_PRESSURE_NONE, QuicLibraryGetMemoryPressure());
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, 800);
+    ASSERT_EQ(QUIC_MEMORY_PRESSURE_HIGH, QuicLibraryGetMemoryPressure());
+    ASSERT_FALSE(QuicLibraryTryReserveRecvWindow(1));
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, 100);
+    ASSERT_EQ(QUIC_MEMORY_PRESSURE_CRITICAL, QuicLibraryGetMemoryPressure());
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, -900);
+    ASSERT_EQ(QUIC_MEMORY_PRESSURE_NONE, QuicLibraryGetMemoryPressure());
+
+    Budget = 0;
+    uint32_t BufferLength = sizeof(Budget);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_BUDGET,
+            &BufferLength,
+            &Budget));
+    ASSERT_EQ(1000ull, Budget);
+
+    //
+    // Zero restores the default.
+    //
+    Budget = 0;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_BUDGET,
+            sizeof(Budget),
+            &Budget));
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_BUDGET,
+            &BufferLength,
+            &Budget));
+    ASSERT_EQ(CxPlatTotalMemory / QUIC_DEFAULT_MEMORY_BUDGET_DIVISOR, Budget);
+
+    QuicLibraryChargeMemory(QUIC_MEMORY_TYPE_SEND_BUFFER, OldUsage);
+}
+
+TEST(SettingsTest, GlobalMemoryUsage)
+{
+    QUIC_MEMORY_USAGE Usage;
+    uint32_t BufferLength = sizeof(Usage) - 1;
+    ASSERT_EQ(
+        QUIC_STATUS_BUFFER_TOO_SMALL,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_USAGE,
+            &BufferLength,
+            &Usage));
+    ASSERT_EQ((uint32_t)sizeof(Usage), BufferLength);
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_USAGE,
+            sizeof(Usage),
+            &Usage));
+
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_USAGE,
+            &BufferLength,
+            &Usage));
+    const uint64_t OldTimerWheels = Usage.TimerWheels;
+
+    QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_TIMER_WHEEL, 1000);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_MEMORY_USAGE,
+            &BufferLength,
+            &Usage));
+    QuicLibraryTrackMemory(QUIC_MEMORY_TYPE_TIMER_WHEEL, -1000);
+    if (MsQuicLib.Partitions != nullptr) {
+        ASSERT_EQ(OldTimerWheels + 1000, Usage.TimerWheels);
+    } else {
+        ASSERT_EQ(0ull, Usage.TimerWheels);
+    }
+}
+
+TEST(SettingsTest, GlobalPartitionPerfCounters)
+{
+    const uint32_t PartitionCount =
+        MsQuicLib.Partitions != nullptr ? MsQuicLib.PartitionCount : 0;
+    uint32_t BufferLength = 0;
+    QUIC_STATUS Status =
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS,
+            &BufferLength,
+            nullptr);
+    ASSERT_EQ(PartitionCount * sizeof(int64_t) * QUIC_PERF_COUNTER_MAX, BufferLength);
+    if (PartitionCount == 0) {
+        ASSERT_EQ(QUIC_STATUS_SUCCESS, Status);
+        return;
+    }
+    ASSERT_EQ(QUIC_STATUS_BUFFER_TOO_SMALL, Status);
+
+    std::vector<int64_t> Counters(PartitionCount * QUIC_PERF_COUNTER_MAX);
+    QuicPerfCounterAdd(&MsQuicLib.Partitions[PartitionCount - 1], QUIC_PERF_COUNTER_APP_RECV_BYTES, 1234);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS,
+            &BufferLength,
+            Counters.data()));
+    QuicPerfCounterAdd(&MsQuicLib.Partitions[PartitionCount - 1], QUIC_PERF_COUNTER_APP_RECV_BYTES, -1234);
+    ASSERT_LE(
+        1234,
+        Counters[(PartitionCount - 1) * QUIC_PERF_COUNTER_MAX + QUIC_PERF_COUNTER_APP_RECV_BYTES]);
+}
+
+TEST(SettingsTest, LatencyBuckets)
+{
+    //
+    // Every bucket's lower bound maps back to it, and the value just below it
+    // to the previous bucket.
+    //
+    for (uint32_t i = 0; i < QUIC_LATENCY_BUCKET_COUNT; ++i) {
+        ASSERT_EQ(i, QuicLatencyBucket(QUIC_LATENCY_BUCKET_MIN_US(i)));
+        if (i != 0) {
+            ASSERT_EQ(i - 1, QuicLatencyBucket(QUIC_LATENCY_BUCKET_MIN_US(i) - 1));
+        }
+    }
+    ASSERT_EQ(QUIC_LATENCY_BUCKET_COUNT - 1u, QuicLatencyBucket(UINT64_MAX));
+
+    uint64_t Histogram[QUIC_LATENCY_BUCKET_COUNT] = {0};
+    QuicLatencyRecord(Histogram, 100);
+    QuicLatencyRecord(Histogram, 111);
+    QuicLatencyRecord(Histogram, 112);
+    ASSERT_EQ(2ull, Histogram[QuicLatencyBucket(96)]);
+    ASSERT_EQ(1ull, Histogram[QuicLatencyBucket(112)]);
+    ASSERT_NE(QuicLatencyBucket(96), QuicLatencyBucket(112));
+}
+
+TEST(SettingsTest, GlobalQlogConfig)
+{
+    QUIC_QLOG_CONFIG Config = { "qlog.sqlog", 0, 0 };
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QLOG_CONFIG,
+            sizeof(Config) - 1,
+            &Config));
+    if (MsQuicLib.LazyInitComplete) {
+        ASSERT_EQ(
+            QUIC_STATUS_INVALID_STATE,
+            QuicLibrarySetGlobalParam(
+                QUIC_PARAM_GLOBAL_QLOG_CONFIG,
+                sizeof(Config),
+                &Config));
+        return;
+    }
+
+    //
+    // A file needs a sample rate of at most a million.
+    //
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QLOG_CONFIG,
+            sizeof(Config),
+            &Config));
+    Config.SampleRate = 1000001;
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QLOG_CONFIG,
+            sizeof(Config),
+            &Config));
+
+    Config.SampleRate = 1000;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QLOG_CONFIG,
+            sizeof(Config),
+            &Config));
+    ASSERT_STREQ("qlog.sqlog", MsQuicLib.Qlog.FilePath);
+    ASSERT_EQ((uint32_t)QUIC_QLOG_DEFAULT_RING_SIZE, MsQuicLib.Qlog.RingSize);
+
+    //
+    // No file disables it again.
+    //
+    Config.FilePath = nullptr;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_QLOG_CONFIG,
+            sizeof(Config),
+            &Config));
+    ASSERT_EQ(nullptr, MsQuicLib.Qlog.FilePath);
+}
+
+TEST(SettingsTest, GlobalPoolReserve)
+{
+    QUIC_POOL_RESERVE_CONFIG Config = { 16, 32, 64, 128, 8, 256 };
+    ASSERT_EQ(
+        QUIC_STATUS_INVALID_PARAMETER,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_POOL_RESERVE,
+            sizeof(Config) - 1,
+            &Config));
+    if (MsQuicLib.LazyInitComplete) {
+        ASSERT_EQ(
+            QUIC_STATUS_INVALID_STATE,
+            QuicLibrarySetGlobalParam(
+                QUIC_PARAM_GLOBAL_POOL_RESERVE,
+                sizeof(Config),
+                &Config));
+        return;
+    }
+
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_POOL_RESERVE,
+            sizeof(Config),
+            &Config));
+
+    QUIC_POOL_RESERVE_CONFIG Got;
+    uint32_t BufferLength = 0;
+    ASSERT_EQ(
+        QUIC_STATUS_BUFFER_TOO_SMALL,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_POOL_RESERVE,
+            &BufferLength,
+            nullptr));
+    ASSERT_EQ((uint32_t)sizeof(Got), BufferLength);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_POOL_RESERVE,
+            &BufferLength,
+            &Got));
+    ASSERT_EQ(0, memcmp(&Config, &Got, sizeof(Config)));
+
+    //
+    // All zero turns it off again.
+    //
+    CxPlatZeroMemory(&Config, sizeof(Config));
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibrarySetGlobalParam(
+            QUIC_PARAM_GLOBAL_POOL_RESERVE,
+            sizeof(Config),
+            &Config));
+}
+
+TEST(SettingsTest, GlobalLatencyHistograms)
+{
+    QUIC_LATENCY_HISTOGRAMS Histograms;
+    uint32_t BufferLength = 0;
+    ASSERT_EQ(
+        QUIC_STATUS_BUFFER_TOO_SMALL,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS,
+            &BufferLength,
+            nullptr));
+    ASSERT_EQ((uint32_t)sizeof(Histograms), BufferLength);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS,
+            &BufferLength,
+            &Histograms));
+    if (MsQuicLib.Partitions == nullptr) {
+        return;
+    }
+
+    //
+    // A sample is returned by the next query only.
+    //
+    QuicLatencyRecord(MsQuicLib.Partitions[0].Latency.Handshake, 5000);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        QuicLibraryGetGlobalParam(
+            QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS,
+            &BufferLength,
+            &Histograms));
+    ASSERT_LE(1ull, Histograms.Handshake[QuicLatencyBucket(5000)]);
+    ASSERT_EQ(0ull, MsQuicLib.Partitions[0].Latency.Handshake[QuicLatencyBucket(5000)]);
+}
+
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 TEST(SettingsTest, GlobalExecutionConfigSetAndGet)
 {
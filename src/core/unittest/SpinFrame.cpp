@@ -43,6 +43,8 @@ TEST(SpinFrame, SpinFrame1000000)
     QUIC_ACK_ECN_EX Ecn;
     QUIC_RANGE AckBlocks;
     uint64_t AckDelay;
+    QUIC_ACK_RECEIVE_TIMESTAMP Timestamps[QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK];
+    uint32_t TimestampCount;
     uint32_t SuccessfulDecodes = 0;
     uint32_t FailedDecodes = 0;
     uint16_t Offset;
@@ -93,6 +95,15 @@ TEST(SpinFrame, SpinFrame1000000)
                 }
                 QuicRangeReset(&AckBlocks);
                 break;
+            case QUIC_FRAME_ACK_RECEIVE_TIMESTAMPS:
+                if (QuicAckFrameDecode(QUIC_FRAME_ACK, BufferLength, Buffer, &Offset, &InvalidFrame, &AckBlocks, &Ecn, &AckDelay) &&
+                    QuicAckReceiveTimestampsDecode(BufferLength, Buffer, &Offset, QuicRangeGetMax(&AckBlocks), 0, ARRAYSIZE(Timestamps), Timestamps, &TimestampCount)) {
+                    SuccessfulDecodes++;
+                } else {
+                    FailedDecodes++;
+                }
+                QuicRangeReset(&AckBlocks);
+                break;
             case QUIC_FRAME_RESET_STREAM:
                 if (QuicResetStreamFrameDecode(BufferLength, Buffer, &Offset, &DecodedFrame.ResetStreamFrame)) {
                     SuccessfulDecodes++;
@@ -468,8 +468,10 @@ TEST(ResumptionTicketTest, ServerEncDec)
     const uint8_t* DecodedAppData = nullptr;
     uint32_t DecodedAppDataLength = 0;
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -531,8 +533,10 @@ TEST(ResumptionTicketTest, ServerEncDecNoAppDataNoCR)
     const uint8_t* DecodedAppData = nullptr;
     uint32_t DecodedAppDataLength = 0;
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -595,8 +599,10 @@ TEST(ResumptionTicketTest, ServerEncDecNoAppDataWithIpV4CR)
     QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState = {};
     QUIC_CONN_CAREFUL_RESUME_STATE DecodedCarefulResumeState = {};
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -623,6 +629,8 @@ TEST(ResumptionTicketTest, ServerEncDecNoAppDataWithIpV4CR)
         { QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, "CUBIC" },
 #if defined(QUIC_API_ENABLE_PREVIEW_FEATURES)
         { QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, "BBR" },
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3, "BBR3" },
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE, "PRAGUE" },
 #endif
     };
 
@@ -701,8 +709,10 @@ TEST(ResumptionTicketTest, ServerEncDecAppData250WithIpV4ClassBCR)
     QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState = {};
     QUIC_CONN_CAREFUL_RESUME_STATE DecodedCarefulResumeState = {};
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -801,8 +811,10 @@ TEST(ResumptionTicketTest, ServerEncDecNoAppDataWithIpV6CR)
     QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState = {};
     QUIC_CONN_CAREFUL_RESUME_STATE DecodedCarefulResumeState = {};
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -829,6 +841,8 @@ TEST(ResumptionTicketTest, ServerEncDecNoAppDataWithIpV6CR)
         { QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, "CUBIC" },
 #if defined(QUIC_API_ENABLE_PREVIEW_FEATURES)
         { QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, "BBR" },
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3, "BBR3" },
+        { QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE, "PRAGUE" },
 #endif
     };
 
@@ -907,8 +921,10 @@ TEST(ResumptionTicketTest, ServerEncDecAppData250WithIpV6CR)
     QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState = {};
     QUIC_CONN_CAREFUL_RESUME_STATE DecodedCarefulResumeState = {};
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -1014,8 +1030,10 @@ TEST(ResumptionTicketTest, ServerTicketDecodeFailureCases)
         ARRAYSIZE(Versions), ARRAYSIZE(Versions),ARRAYSIZE(Versions)
     };
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     uint8_t InputTicketBuffer[TicketBufferFixedV2HeaderLength + TransportParametersLength +
@@ -1354,8 +1372,8 @@ TEST(ResumptionTicketTest, ServerTicketDecodeFailureCases)
             &DecodedAppDataLength));
 
     // Unsupported QUIC version on connection
-    Connection.Settings.VersionSettings = &VersionSettings;
-    Connection.Settings.IsSet.VersionSettings = true;
+    ConnectionSettings.VersionSettings = &VersionSettings;
+    ConnectionSettings.IsSet.VersionSettings = true;
     ASSERT_EQ(
         QUIC_STATUS_INVALID_PARAMETER,
         QuicCryptoDecodeServerTicket(
@@ -1372,8 +1390,8 @@ TEST(ResumptionTicketTest, ServerTicketDecodeFailureCases)
     InputTicketBuffer[2] = 0;
     InputTicketBuffer[3] = 0;
     InputTicketBuffer[4] = 1;
-    Connection.Settings.VersionSettings = nullptr;
-    Connection.Settings.IsSet.VersionSettings = false;
+    ConnectionSettings.VersionSettings = nullptr;
+    ConnectionSettings.IsSet.VersionSettings = false;
 
     // Negotiated ALPN length shorter than actual
     for (uint8_t s = 0; s < (uint8_t)sizeof(Alpn); ++s) {
@@ -1585,8 +1603,10 @@ TEST(ResumptionTicketTest, ServerTicketDecodeFailureCasesWithCR)
     CarefulResumeState.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
     CarefulResumeState.CongestionWindow = 65536;
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     uint8_t* EncodedServerTicket = nullptr;
@@ -1745,8 +1765,10 @@ TEST(ResumptionTicketTest, ClientServerEndToEnd)
     uint32_t EncodedServerTicketLength = 0, EncodedClientTicketLength = 0, DecodedServerTicketLength = 0, DecodedAppDataLength = 0, DecodedQuicVersion = 0;
     const uint8_t* EncodedClientTicket = nullptr, *DecodedAppData = nullptr;
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings{};
     QUIC_CONNECTION Connection;
     CxPlatZeroMemory(&Connection, sizeof(Connection));
+    Connection.Settings = &ConnectionSettings;
     Connection.Stats.QuicVersion = QUIC_VERSION_1;
 
     CxPlatZeroMemory(&ServerTP, sizeof(ServerTP));
@@ -0,0 +1,350 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the hierarchical QUIC_TIMER_WHEEL.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "TimerWheelTest.cpp.clog.h"
+#endif
+
+#define TICK_US (1ull << QUIC_TIMER_WHEEL_TICK_SHIFT)
+
+//
+// A timer wheel along with connections that have only the state the timer
+// wheel uses initialized. The test holds a reference on each connection, so
+// the wheel never frees them.
+//
+struct TestTimerWheel {
+    QUIC_TIMER_WHEEL TimerWheel;
+    std::vector<QUIC_CONNECTION*> Connections;
+    uint64_t Now;
+
+    TestTimerWheel() {
+        EXPECT_EQ(QUIC_STATUS_SUCCESS, QuicTimerWheelInitialize(&TimerWheel));
+        Now = TimerWheel.CurrentTick << QUIC_TIMER_WHEEL_TICK_SHIFT;
+    }
+    ~TestTimerWheel() {
+        for (auto Connection : Connections) {
+            QuicTimerWheelRemoveConnection(&TimerWheel, Connection);
+            CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+        }
+        QuicTimerWheelUninitialize(&TimerWheel);
+    }
+
+    QUIC_CONNECTION* NewConnection() {
+        auto Connection =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connection != nullptr);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        Connection->RefCount = 1;
+#if DEBUG
+        for (uint32_t i = 0; i < QUIC_CONN_REF_COUNT; i++) {
+            CxPlatRefInitialize(&Connection->RefTypeBiasedCount[i]);
+        }
+#endif
+        Connections.push_back(Connection);
+        return Connection;
+    }
+
+    QUIC_CONNECTION* Arm(uint64_t ExpirationTime) {
+        QUIC_CONNECTION* Connection = NewConnection();
+        Set(Connection, ExpirationTime);
+        return Connection;
+    }
+
+    void Set(QUIC_CONNECTION* Connection, uint64_t ExpirationTime) {
+        Connection->EarliestExpirationTime = ExpirationTime;
+        QuicTimerWheelUpdateConnection(&TimerWheel, Connection);
+    }
+
+    //
+    // Gets the expired connections the way the worker does and drops the
+    // references handed out with them.
+    //
+    std::vector<QUIC_CONNECTION*> Expire(uint64_t TimeNow) {
+        std::vector<QUIC_CONNECTION*> Expired;
+        CXPLAT_LIST_ENTRY List;
+        CxPlatListInitializeHead(&List);
+        QuicTimerWheelGetExpired(&TimerWheel, TimeNow, &List);
+        while (!CxPlatListIsEmpty(&List)) {
+            QUIC_CONNECTION* Connection =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&List), QUIC_CONNECTION, TimerLink);
+            Connection->TimerLink.Flink = nullptr;
+#if DEBUG
+            CxPlatRefDecrement(&Connection->RefTypeBiasedCount[QUIC_CONN_REF_WORKER]);
+#endif
+            InterlockedDecrement(&Connection->RefCount);
+            Expired.push_back(Connection);
+        }
+        return Expired;
+    }
+
+    //
+    // The next expiration time must never be later than the earliest timer in
+    // the wheel, or the worker would sleep through it.
+    //
+    void CheckNextExpiration() {
+        uint64_t Earliest = UINT64_MAX;
+        uint64_t Count = 0;
+        for (auto Connection : Connections) {
+            if (Connection->TimerLink.Flink != nullptr) {
+                ++Count;
+                if (Connection->EarliestExpirationTime < Earliest) {
+                    Earliest = Connection->EarliestExpirationTime;
+                }
+            }
+        }
+        ASSERT_EQ(Count, TimerWheel.ConnectionCount);
+        ASSERT_LE(TimerWheel.NextExpirationTime, Earliest);
+        if (TimerWheel.NextConnection != nullptr) {
+            ASSERT_EQ(Earliest, TimerWheel.NextExpirationTime);
+            ASSERT_EQ(Earliest, TimerWheel.NextConnection->EarliestExpirationTime);
+        }
+        if (Count == 0) {
+            ASSERT_EQ(UINT64_MAX, TimerWheel.NextExpirationTime);
+        }
+    }
+};
+
+TEST(TimerWheelTest, InsertUpdateRemove)
+{
+    TestTimerWheel Wheel;
+    ASSERT_EQ(0ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(UINT64_MAX, Wheel.TimerWheel.NextExpirationTime);
+    ASSERT_EQ(nullptr, Wheel.TimerWheel.NextConnection);
+
+    QUIC_CONNECTION* A = Wheel.Arm(Wheel.Now + 10000);
+    ASSERT_EQ(1ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(2, (int)A->RefCount);
+    ASSERT_EQ(A, Wheel.TimerWheel.NextConnection);
+    ASSERT_EQ(Wheel.Now + 10000, Wheel.TimerWheel.NextExpirationTime);
+
+    QUIC_CONNECTION* B = Wheel.Arm(Wheel.Now + 5000);
+    QUIC_CONNECTION* C = Wheel.Arm(Wheel.Now + 20000);
+    ASSERT_EQ(3ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(B, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    //
+    // Moving the next connection later makes the wheel look again.
+    //
+    Wheel.Set(B, Wheel.Now + 30000);
+    ASSERT_EQ(3ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(A, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    //
+    // Moving another connection earlier makes it the next one.
+    //
+    Wheel.Set(C, Wheel.Now + 1000);
+    ASSERT_EQ(C, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    QuicTimerWheelRemoveConnection(&Wheel.TimerWheel, C);
+    ASSERT_EQ(nullptr, C->TimerLink.Flink);
+    ASSERT_EQ(1, (int)C->RefCount);
+    ASSERT_EQ(2ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(A, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    //
+    // Clearing all of a connection's timers removes it.
+    //
+    Wheel.Set(A, UINT64_MAX);
+    ASSERT_EQ(nullptr, A->TimerLink.Flink);
+    ASSERT_EQ(1, (int)A->RefCount);
+    ASSERT_EQ(1ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(B, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    //
+    // A connection not in the wheel without timers is ignored.
+    //
+    Wheel.Set(A, UINT64_MAX);
+    ASSERT_EQ(1ull, Wheel.TimerWheel.ConnectionCount);
+
+    QuicTimerWheelRemoveConnection(&Wheel.TimerWheel, B);
+    ASSERT_EQ(0ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(UINT64_MAX, Wheel.TimerWheel.NextExpirationTime);
+    ASSERT_EQ(nullptr, Wheel.TimerWheel.NextConnection);
+}
+
+TEST(TimerWheelTest, ExpiredAlready)
+{
+    TestTimerWheel Wheel;
+    QUIC_CONNECTION* A = Wheel.Arm(Wheel.Now - 5 * TICK_US);
+    QUIC_CONNECTION* B = Wheel.Arm(Wheel.Now + 1);
+    ASSERT_EQ(A, Wheel.TimerWheel.NextConnection);
+
+    auto Expired = Wheel.Expire(Wheel.Now);
+    ASSERT_EQ(1u, Expired.size());
+    ASSERT_EQ(A, Expired[0]);
+    ASSERT_EQ(1, (int)A->RefCount);
+    ASSERT_EQ(B, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    Expired = Wheel.Expire(Wheel.Now + 1);
+    ASSERT_EQ(1u, Expired.size());
+    ASSERT_EQ(B, Expired[0]);
+    Wheel.CheckNextExpiration();
+}
+
+TEST(TimerWheelTest, ExpiryOrderAcrossCascades)
+{
+    TestTimerWheel Wheel;
+
+    //
+    // Timers spread over the lower four levels, inserted out of order and
+    // with a couple sharing a tick.
+    //
+    const uint64_t Offsets[] = {
+        400000000,  // Level 3
+        3000,       // Level 0
+        5000000,    // Level 2
+        100000,     // Level 1
+        3001,       // Same tick as the level 0 one
+        100000000,  // Level 3
+        64 * TICK_US, // First tick of level 1
+        4000,       // Level 0
+    };
+    std::vector<std::pair<uint64_t, QUIC_CONNECTION*>> Timers;
+    for (auto Offset : Offsets) {
+        Timers.push_back({Wheel.Now + Offset, Wheel.Arm(Wheel.Now + Offset)});
+        Wheel.CheckNextExpiration();
+    }
+    std::sort(Timers.begin(), Timers.end());
+
+    for (auto& Timer : Timers) {
+        //
+        // Nothing may come out before its time, no matter how many cascades
+        // the wheel did getting there.
+        //
+        auto Expired = Wheel.Expire(Timer.first - 1);
+        ASSERT_EQ(0u, Expired.size());
+        Wheel.CheckNextExpiration();
+
+        Expired = Wheel.Expire(Timer.first);
+        ASSERT_EQ(1u, Expired.size());
+        ASSERT_EQ(Timer.second, Expired[0]);
+        Wheel.CheckNextExpiration();
+    }
+    ASSERT_EQ(0ull, Wheel.TimerWheel.ConnectionCount);
+}
+
+TEST(TimerWheelTest, ExpireManyAtOnce)
+{
+    TestTimerWheel Wheel;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        Wheel.Arm(Wheel.Now + i * 7919);
+    }
+    Wheel.CheckNextExpiration();
+
+    //
+    // A single late call hands out everything due across all the levels.
+    //
+    auto Expired = Wheel.Expire(Wheel.Now + 500 * 7919);
+    ASSERT_EQ(500u, Expired.size());
+    for (auto Connection : Expired) {
+        ASSERT_LE(Connection->EarliestExpirationTime, Wheel.Now + 500 * 7919);
+    }
+    ASSERT_EQ(500ull, Wheel.TimerWheel.ConnectionCount);
+    Wheel.CheckNextExpiration();
+
+    Expired = Wheel.Expire(Wheel.Now + 1000 * 7919);
+    ASSERT_EQ(500u, Expired.size());
+    Wheel.CheckNextExpiration();
+}
+
+TEST(TimerWheelTest, FarFutureAndOverflow)
+{
+    TestTimerWheel Wheel;
+
+    //
+    // Further out than the whole top level reaches, so the connection waits in
+    // the top level's last slot and is placed again when that comes due.
+    //
+    const uint64_t TopLevelSpan =
+        TICK_US << (QUIC_TIMER_WHEEL_LEVEL_COUNT * 6);
+    QUIC_CONNECTION* Far = Wheel.Arm(Wheel.Now + 4 * TopLevelSpan + 12345);
+    ASSERT_NE(0ull, Wheel.TimerWheel.OccupiedSlots[QUIC_TIMER_WHEEL_LEVEL_COUNT - 1]);
+    ASSERT_EQ(Far, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    //
+    // And one that would overflow any time arithmetic.
+    //
+    QUIC_CONNECTION* Max = Wheel.Arm(UINT64_MAX - 1);
+    Wheel.CheckNextExpiration();
+
+    QUIC_CONNECTION* Near = Wheel.Arm(Wheel.Now + 2000);
+    ASSERT_EQ(Near, Wheel.TimerWheel.NextConnection);
+
+    auto Expired = Wheel.Expire(Wheel.Now + 2000);
+    ASSERT_EQ(1u, Expired.size());
+    ASSERT_EQ(Near, Expired[0]);
+    Wheel.CheckNextExpiration();
+
+    Expired = Wheel.Expire(Far->EarliestExpirationTime - 1);
+    ASSERT_EQ(0u, Expired.size());
+    ASSERT_EQ(2ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_EQ(Far, Wheel.TimerWheel.NextConnection);
+    Wheel.CheckNextExpiration();
+
+    Expired = Wheel.Expire(Far->EarliestExpirationTime);
+    ASSERT_EQ(1u, Expired.size());
+    ASSERT_EQ(Far, Expired[0]);
+    Wheel.CheckNextExpiration();
+
+    ASSERT_NE(nullptr, Max->TimerLink.Flink);
+    ASSERT_EQ(1ull, Wheel.TimerWheel.ConnectionCount);
+    ASSERT_NE(UINT64_MAX, Wheel.TimerWheel.NextExpirationTime);
+}
+
+TEST(TimerWheelTest, NextExpirationAfterCascades)
+{
+    TestTimerWheel Wheel;
+    const uint64_t Offsets[] = { 100000, 5000000, 400000000 };
+    for (auto Offset : Offsets) {
+        QUIC_CONNECTION* First = Wheel.Arm(Wheel.Now + 1000);
+        QUIC_CONNECTION* Connection = Wheel.Arm(Wheel.Now + Offset);
+        const uint64_t ExpirationTime = Connection->EarliestExpirationTime;
+        ASSERT_EQ(First, Wheel.TimerWheel.NextConnection);
+
+        auto Expired = Wheel.Expire(First->EarliestExpirationTime);
+        ASSERT_EQ(1u, Expired.size());
+        ASSERT_EQ(First, Expired[0]);
+
+        //
+        // With the connection waiting in a higher level, the wheel now only
+        // knows when its slot comes due. Waking up then, as the worker does,
+        // must cascade it down a level, until the exact time is known.
+        //
+        uint32_t Wakeups = 0;
+        uint64_t LastExpirationTime = First->EarliestExpirationTime;
+        while (Wheel.TimerWheel.NextConnection == nullptr) {
+            ASSERT_LT(Wakeups, (uint32_t)QUIC_TIMER_WHEEL_LEVEL_COUNT);
+            ASSERT_GT(Wheel.TimerWheel.NextExpirationTime, LastExpirationTime);
+            ASSERT_LE(Wheel.TimerWheel.NextExpirationTime, ExpirationTime);
+            LastExpirationTime = Wheel.TimerWheel.NextExpirationTime;
+            ASSERT_EQ(0u, Wheel.Expire(LastExpirationTime).size());
+            ++Wakeups;
+        }
+        ASSERT_NE(0u, Wakeups);
+        ASSERT_EQ(Connection, Wheel.TimerWheel.NextConnection);
+        ASSERT_EQ(ExpirationTime, Wheel.TimerWheel.NextExpirationTime);
+
+        Expired = Wheel.Expire(ExpirationTime);
+        ASSERT_EQ(1u, Expired.size());
+        ASSERT_EQ(Connection, Expired[0]);
+        ASSERT_EQ(UINT64_MAX, Wheel.TimerWheel.NextExpirationTime);
+        Wheel.Now = ExpirationTime;
+    }
+}
@@ -36,12 +36,25 @@ void CompareTransportParams(
     COMPARE_TP_FIELD(ACTIVE_CONNECTION_ID_LIMIT, ActiveConnectionIdLimit);
     COMPARE_TP_FIELD(CIBIR_ENCODING, CibirLength);
     COMPARE_TP_FIELD(CIBIR_ENCODING, CibirOffset);
+    COMPARE_TP_FIELD(INITIAL_MAX_PATH_ID, InitialMaxPathId);
+    COMPARE_TP_FIELD(MAX_RECEIVE_TIMESTAMPS_PER_ACK, MaxReceiveTimestampsPerAck);
+    COMPARE_TP_FIELD(RECEIVE_TIMESTAMPS_EXPONENT, ReceiveTimestampsExponent);
     if (A->Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION) {
         ASSERT_EQ(A->VersionInfoLength, B->VersionInfoLength);
         ASSERT_EQ(
             memcmp(A->VersionInfo, B->VersionInfo, (size_t)A->VersionInfoLength),
             0);
     }
+    if (A->Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
+        ASSERT_TRUE(QuicAddrCompare(&A->PreferredAddress, &B->PreferredAddress));
+        ASSERT_EQ(A->PreferredAddressCidLength, B->PreferredAddressCidLength);
+        ASSERT_EQ(
+            memcmp(A->PreferredAddressCid, B->PreferredAddressCid, A->PreferredAddressCidLength),
+            0);
+        ASSERT_EQ(
+            memcmp(A->PreferredAddressResetToken, B->PreferredAddressResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH),
+            0);
+    }
     //COMPARE_TP_FIELD(InitialSourceConnectionID);
     //COMPARE_TP_FIELD(InitialSourceConnectionIDLength);
     if (IsServer) { // TODO
@@ -270,3 +283,78 @@ TEST(TransportParamTest, ReliableResetEnabled)
     EncodeDecodeAndCompare(&OriginalTP);
     EncodeDecodeAndCompare(&OriginalTP, true);
 }
+
+TEST(TransportParamTest, InitialMaxPathId)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags = QUIC_TP_FLAG_INITIAL_MAX_PATH_ID;
+    OriginalTP.InitialMaxPathId = 0;
+    EncodeDecodeAndCompare(&OriginalTP);
+    OriginalTP.InitialMaxPathId = QUIC_TP_MAX_PATH_ID_MAX;
+    EncodeDecodeAndCompare(&OriginalTP, true);
+}
+
+TEST(TransportParamTest, ReceiveTimestamps)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags =
+        QUIC_TP_FLAG_MAX_RECEIVE_TIMESTAMPS_PER_ACK |
+        QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT;
+    OriginalTP.MaxReceiveTimestampsPerAck = QUIC_MAX_RECEIVE_TIMESTAMPS_PER_ACK;
+    OriginalTP.ReceiveTimestampsExponent = QUIC_TP_RECEIVE_TIMESTAMPS_EXPONENT_MAX;
+    EncodeDecodeAndCompare(&OriginalTP);
+    EncodeDecodeAndCompare(&OriginalTP, true);
+}
+
+TEST(TransportParamTest, ReceiveTimestampsExponentOverMax)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags = QUIC_TP_FLAG_RECEIVE_TIMESTAMPS_EXPONENT;
+    OriginalTP.ReceiveTimestampsExponent = QUIC_TP_RECEIVE_TIMESTAMPS_EXPONENT_MAX + 1;
+    EncodeDecodeAndCompare(&OriginalTP, false, false);
+}
+
+TEST(TransportParamTest, InitialMaxPathIdOverMax)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags = QUIC_TP_FLAG_INITIAL_MAX_PATH_ID;
+    OriginalTP.InitialMaxPathId = (uint64_t)QUIC_TP_MAX_PATH_ID_MAX + 1;
+    EncodeDecodeAndCompare(&OriginalTP, false, false);
+}
+
+TEST(TransportParamTest, PreferredAddressIpv4)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags = QUIC_TP_FLAG_PREFERRED_ADDRESS;
+    ASSERT_TRUE(QuicAddrFromString("192.0.2.1", 4433, &OriginalTP.PreferredAddress));
+    OriginalTP.PreferredAddressCidLength = 8;
+    CxPlatRandom(OriginalTP.PreferredAddressCidLength, OriginalTP.PreferredAddressCid);
+    CxPlatRandom(QUIC_STATELESS_RESET_TOKEN_LENGTH, OriginalTP.PreferredAddressResetToken);
+    EncodeDecodeAndCompare(&OriginalTP, true);
+}
+
+TEST(TransportParamTest, PreferredAddressIpv6)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags = QUIC_TP_FLAG_PREFERRED_ADDRESS;
+    ASSERT_TRUE(QuicAddrFromString("2001:db8::1", 4433, &OriginalTP.PreferredAddress));
+    OriginalTP.PreferredAddressCidLength = QUIC_MAX_CONNECTION_ID_LENGTH_V1;
+    CxPlatRandom(OriginalTP.PreferredAddressCidLength, OriginalTP.PreferredAddressCid);
+    CxPlatRandom(QUIC_STATELESS_RESET_TOKEN_LENGTH, OriginalTP.PreferredAddressResetToken);
+    EncodeDecodeAndCompare(&OriginalTP, true);
+}
+
+TEST(TransportParamTest, PreferredAddressZeroLengthCid)
+{
+    QUIC_TRANSPORT_PARAMETERS OriginalTP;
+    CxPlatZeroMemory(&OriginalTP, sizeof(OriginalTP));
+    OriginalTP.Flags = QUIC_TP_FLAG_PREFERRED_ADDRESS;
+    ASSERT_TRUE(QuicAddrFromString("192.0.2.1", 4433, &OriginalTP.PreferredAddress));
+    EncodeDecodeAndCompare(&OriginalTP, true, false);
+}
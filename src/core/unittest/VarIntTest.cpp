@@ -73,3 +73,45 @@ TEST(VarIntTest, RandomEncodeDecode)
         ASSERT_EQ(Value, Decoded);
     }
 }
+
+TEST(VarIntTest, DecodeSequence)
+{
+    //
+    // Pack values of every encoded length back to back, so that values are
+    // decoded both with at least 8 bytes left in the buffer and with fewer.
+    //
+    const uint64_t Values[] = {
+        0, 0x3F, 0x40, 0x3FFF, 0x4000, 0x3FFFFFFF, 0x40000000,
+        0x3FFFFFFFFFFFFFFFULL, 0x25, 0x1234, 0x12345678, 0x7
+    };
+    uint8_t Buffer[sizeof(Values) * sizeof(uint64_t)];
+    uint8_t* Head = Buffer;
+    for (uint32_t i = 0; i < ARRAYSIZE(Values); ++i) {
+        Head = QuicVarIntEncode(Values[i], Head);
+    }
+    const uint16_t BufferLength = (uint16_t)(Head - Buffer);
+
+    uint16_t Offset = 0;
+    for (uint32_t i = 0; i < ARRAYSIZE(Values); ++i) {
+        QUIC_VAR_INT Decoded;
+        uint16_t PrevOffset = Offset;
+        ASSERT_TRUE(QuicVarIntDecode(BufferLength, Buffer, &Offset, &Decoded));
+        ASSERT_EQ(Values[i], Decoded);
+        ASSERT_EQ(QuicVarIntSize(Values[i]), Offset - PrevOffset);
+    }
+    ASSERT_EQ(BufferLength, Offset);
+
+    //
+    // Truncated values must fail to decode, whatever the path.
+    //
+    QUIC_VAR_INT Decoded;
+    Offset = 0;
+    uint8_t Truncated[8] = { 0xC0, 0, 0, 0, 0, 0, 0, 0 };
+    ASSERT_FALSE(QuicVarIntDecode(7, Truncated, &Offset, &Decoded));
+    ASSERT_EQ(0, Offset);
+    Truncated[0] = 0x80;
+    ASSERT_FALSE(QuicVarIntDecode(3, Truncated, &Offset, &Decoded));
+    ASSERT_TRUE(QuicVarIntDecode(8, Truncated, &Offset, &Decoded));
+    ASSERT_EQ(4, Offset);
+    ASSERT_EQ(0ull, Decoded);
+}
@@ -40,7 +40,9 @@ TEST_P(WithType, ParseVersionInfoFail)
     };
 
     QUIC_VERSION_INFORMATION_V1 ParsedVI = {0};
+    QUIC_SETTINGS_INTERNAL ConnectionSettings {};
     QUIC_CONNECTION Connection {};
+    Connection.Settings = &ConnectionSettings;
     Connection._.Type = GetParam();
 
     //
@@ -113,13 +115,15 @@ TEST_P(WithType, EncodeDecodeVersionInfo)
         ARRAYSIZE(TestVersions), ARRAYSIZE(TestVersions), ARRAYSIZE(TestVersions)
     };
 
+    QUIC_SETTINGS_INTERNAL ConnectionSettings {};
     QUIC_CONNECTION Connection {};
+    Connection.Settings = &ConnectionSettings;
     if (Type == QUIC_HANDLE_TYPE_CONNECTION_SERVER) {
         MsQuicLib.Settings.VersionSettings = &VerSettings;
         MsQuicLib.Settings.IsSet.VersionSettings = TRUE;
     } else {
-        Connection.Settings.VersionSettings = &VerSettings;
-        Connection.Settings.IsSet.VersionSettings = TRUE;
+        ConnectionSettings.VersionSettings = &VerSettings;
+        ConnectionSettings.IsSet.VersionSettings = TRUE;
     }
 
     Connection._.Type = Type;
@@ -61,12 +61,12 @@ QuicVersionNegotiationExtIsVersionClientSupported(
     _In_ uint32_t Version
     )
 {
-    if (Connection->Settings.IsSet.VersionSettings) {
+    if (Connection->Settings->IsSet.VersionSettings) {
         if (QuicIsVersionReserved(Version)) {
             return FALSE;
         }
-        for (uint32_t i = 0; i < Connection->Settings.VersionSettings->FullyDeployedVersionsLength; ++i) {
-            if (Connection->Settings.VersionSettings->FullyDeployedVersions[i] == Version) {
+        for (uint32_t i = 0; i < Connection->Settings->VersionSettings->FullyDeployedVersionsLength; ++i) {
+            if (Connection->Settings->VersionSettings->FullyDeployedVersions[i] == Version) {
                 return TRUE;
             }
         }
@@ -105,9 +105,9 @@ QuicVersionNegotiationExtIsVersionCompatible(
     _In_ uint32_t NegotiatedVersion
     )
 {
-    if (Connection->Settings.IsSet.VersionSettings) {
-        const uint32_t* CompatibleVersions = Connection->Settings.VersionSettings->FullyDeployedVersions;
-        uint32_t CompatibleVersionsLength = Connection->Settings.VersionSettings->FullyDeployedVersionsLength;
+    if (Connection->Settings->IsSet.VersionSettings) {
+        const uint32_t* CompatibleVersions = Connection->Settings->VersionSettings->FullyDeployedVersions;
+        uint32_t CompatibleVersionsLength = Connection->Settings->VersionSettings->FullyDeployedVersionsLength;
 
         for (uint32_t i = 0; i < CompatibleVersionsLength; ++i) {
             if (QuicVersionNegotiationExtAreVersionsCompatible(CompatibleVersions[i], NegotiatedVersion)) {
@@ -315,11 +315,11 @@ QuicVersionNegotiationExtEncodeVersionInfo(
         //
         uint32_t CompatibilityListByteLength = 0;
         VILen = sizeof(Connection->Stats.QuicVersion);
-        if (Connection->Settings.IsSet.VersionSettings) {
+        if (Connection->Settings->IsSet.VersionSettings) {
             QuicVersionNegotiationExtGenerateCompatibleVersionsList(
                 Connection->Stats.QuicVersion,
-                Connection->Settings.VersionSettings->FullyDeployedVersions,
-                Connection->Settings.VersionSettings->FullyDeployedVersionsLength,
+                Connection->Settings->VersionSettings->FullyDeployedVersions,
+                Connection->Settings->VersionSettings->FullyDeployedVersionsLength,
                 NULL, &CompatibilityListByteLength);
             VILen += CompatibilityListByteLength;
         } else {
@@ -342,13 +342,13 @@ QuicVersionNegotiationExtEncodeVersionInfo(
         CXPLAT_DBG_ASSERT(VILen >= sizeof(uint32_t));
         CxPlatCopyMemory(VIBuf, &Connection->Stats.QuicVersion, sizeof(Connection->Stats.QuicVersion));
         VIBuf += sizeof(Connection->Stats.QuicVersion);
-        if (Connection->Settings.IsSet.VersionSettings) {
+        if (Connection->Settings->IsSet.VersionSettings) {
             uint32_t RemainingBuffer = VILen - (uint32_t)(VIBuf - VersionInfo);
             CXPLAT_DBG_ASSERT(RemainingBuffer == CompatibilityListByteLength);
             QuicVersionNegotiationExtGenerateCompatibleVersionsList(
                 Connection->Stats.QuicVersion,
-                Connection->Settings.VersionSettings->FullyDeployedVersions,
-                Connection->Settings.VersionSettings->FullyDeployedVersionsLength,
+                Connection->Settings->VersionSettings->FullyDeployedVersions,
+                Connection->Settings->VersionSettings->FullyDeployedVersionsLength,
                 VIBuf,
                 &RemainingBuffer);
             CXPLAT_DBG_ASSERT(VILen == (uint32_t)(VIBuf - VersionInfo) + RemainingBuffer);
@@ -78,11 +78,23 @@ QuicWorkerInitialize(
 
     Worker->Enabled = TRUE;
     Worker->Partition = Partition;
+    Worker->BatchSends =
+        ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT ||
+        ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_SCAVENGER;
+    Worker->HighResPacing =
+        ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT;
+    Worker->RebalanceConnections =
+        ExecProfile == QUIC_EXECUTION_PROFILE_LOW_LATENCY ||
+        ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT;
+    Worker->LoadIntervalStart = CxPlatTimeUs64();
+    Worker->DrainScale = 1;
+    QuicPacingQueueInitialize(&Worker->PacingQueue);
     CxPlatDispatchLockInitialize(&Worker->Lock);
     CxPlatEventInitialize(&Worker->Done, TRUE, FALSE);
     CxPlatEventInitialize(&Worker->Ready, FALSE, FALSE);
     CxPlatListInitializeHead(&Worker->Connections);
     Worker->PriorityConnectionsTail = &Worker->Connections.Flink;
+    Worker->RecvReturnTail = &Worker->RecvReturnChain;
     CxPlatListInitializeHead(&Worker->Listeners);
     CxPlatListInitializeHead(&Worker->Operations);
 
@@ -199,6 +211,7 @@ QuicWorkerUninitialize(
 
     CxPlatDispatchLockUninitialize(&Worker->Lock);
     QuicTimerWheelUninitialize(&Worker->TimerWheel);
+    QuicPacingQueueUninitialize(&Worker->PacingQueue);
 
     QuicTraceEvent(
         WorkerDestroyed,
@@ -288,22 +301,24 @@ QuicWorkerQueueConnection(
     }
 }
 
+//
+// Moves the connection to the tail of the worker's priority connections.
+// Returns TRUE if the connection wasn't already queued. Called with the
+// worker lock held.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
-void
-QuicWorkerQueuePriorityConnection(
+static
+BOOLEAN
+QuicWorkerInsertPriorityConnection(
     _In_ QUIC_WORKER* Worker,
     _In_ QUIC_CONNECTION* Connection
     )
 {
     CXPLAT_DBG_ASSERT(Connection->Worker != NULL);
     BOOLEAN ConnectionQueued = FALSE;
-    BOOLEAN WakeWorkerThread = FALSE;
-
-    CxPlatDispatchLockAcquire(&Worker->Lock);
 
     if (!Connection->WorkerProcessing && !Connection->HasPriorityWork) {
         if (!Connection->HasQueuedWork) { // Not already queued for normal priority work
-            WakeWorkerThread = QuicWorkerIsIdle(Worker);
             Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
             QuicTraceEvent(
                 ConnScheduleState,
@@ -322,6 +337,119 @@ QuicWorkerQueuePriorityConnection(
 
     Connection->HasQueuedWork = TRUE;
 
+    return ConnectionQueued;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueuePriorityConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    const BOOLEAN WakeWorkerThread = QuicWorkerIsIdle(Worker);
+    const BOOLEAN ConnectionQueued =
+        QuicWorkerInsertPriorityConnection(Worker, Connection);
+    CxPlatDispatchLockRelease(&Worker->Lock);
+
+    if (ConnectionQueued) {
+        if (WakeWorkerThread) {
+            QuicWorkerThreadWake(Worker);
+        }
+        QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueueTeardownConnections(
+    _In_ QUIC_WORKER* Worker,
+    _In_reads_(Count) QUIC_CONNECTION** Connections,
+    _In_ uint32_t Count
+    )
+{
+    uint32_t QueuedCount = 0;
+
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    const BOOLEAN WakeWorkerThread = QuicWorkerIsIdle(Worker);
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (QuicWorkerInsertPriorityConnection(Worker, Connections[i])) {
+            QueuedCount++;
+        }
+    }
+    CxPlatDispatchLockRelease(&Worker->Lock);
+
+    InterlockedExchangeAdd(&Worker->TeardownCount, (long)Count);
+
+    if (QueuedCount != 0) {
+        if (WakeWorkerThread) {
+            QuicWorkerThreadWake(Worker);
+        }
+        QuicPerfCounterAdd(
+            Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH, (int64_t)QueuedCount);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerTryClaimConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    BOOLEAN Claimed = FALSE;
+
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    if (!Connection->WorkerProcessing && !Connection->HasQueuedWork) {
+        Connection->WorkerProcessing = TRUE;
+        Claimed = TRUE;
+    }
+    CxPlatDispatchLockRelease(&Worker->Lock);
+
+    return Claimed;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerReleaseClaimedConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    BOOLEAN ConnectionQueued = FALSE;
+    BOOLEAN WakeWorkerThread = FALSE;
+
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    CXPLAT_DBG_ASSERT(Connection->WorkerProcessing);
+    Connection->WorkerProcessing = FALSE;
+    if (Connection->HasQueuedWork) {
+        //
+        // Work was queued while the connection was claimed. It wasn't put on
+        // the worker's queue then, so do it now.
+        //
+        WakeWorkerThread = QuicWorkerIsIdle(Worker);
+        Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+        QuicTraceEvent(
+            ConnScheduleState,
+            "[conn][%p] Scheduling: %u",
+            Connection,
+            QUIC_SCHEDULE_QUEUED);
+        QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+        if (Connection->HasPriorityWork) {
+            CxPlatListInsertTail(*Worker->PriorityConnectionsTail, &Connection->WorkerLink);
+            Worker->PriorityConnectionsTail = &Connection->WorkerLink.Flink;
+        } else {
+            CxPlatListInsertTail(&Worker->Connections, &Connection->WorkerLink);
+        }
+        ConnectionQueued = TRUE;
+    } else {
+        QuicTraceEvent(
+            ConnScheduleState,
+            "[conn][%p] Scheduling: %u",
+            Connection,
+            QUIC_SCHEDULE_IDLE);
+    }
     CxPlatDispatchLockRelease(&Worker->Lock);
 
     if (ConnectionQueued) {
@@ -448,7 +576,19 @@ QuicWorkerUpdateQueueDelay(
     _In_ uint32_t TimeInQueueUs
     )
 {
+    QuicLatencyRecord(Worker->Partition->Latency.QueueDelay, TimeInQueueUs);
+
+    const uint32_t PrevQueueDelay = Worker->AverageQueueDelay;
     Worker->AverageQueueDelay = (7 * Worker->AverageQueueDelay + TimeInQueueUs) / 8;
+
+    if (Worker->AverageQueueDelay > PrevQueueDelay &&
+        Worker->AverageQueueDelay > QUIC_WORKER_DRAIN_SCALE_DELAY_US &&
+        Worker->DrainScale > 1) {
+        //
+        // Connections are waiting longer, so give them turns sooner.
+        //
+        Worker->DrainScale /= 2;
+    }
     QuicTraceEvent(
         WorkerQueueDelayUpdated,
         "[wrkr][%p] QueueDelay = %u",
@@ -586,6 +726,323 @@ QuicWorkerProcessTimers(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerProcessPacing(
+    _In_ QUIC_WORKER* Worker,
+    _In_ CXPLAT_THREAD_ID ThreadID,
+    _In_ uint64_t TimeNow
+    )
+{
+    //
+    // Get the list of all paced connections due to send again.
+    //
+    CXPLAT_LIST_ENTRY Released;
+    CxPlatListInitializeHead(&Released);
+    QuicPacingQueueGetReleased(&Worker->PacingQueue, TimeNow, &Released);
+
+    while (!CxPlatListIsEmpty(&Released)) {
+        CXPLAT_LIST_ENTRY* Entry = CxPlatListRemoveHead(&Released);
+        Entry->Flink = NULL;
+
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, PacingLink);
+
+        Connection->WorkerThreadID = ThreadID;
+        QuicConfigurationAttachSilo(Connection->Configuration);
+        (void)QuicSendFlush(&Connection->Send);
+        QuicConfigurationDetachSilo();
+        Connection->WorkerThreadID = 0;
+        QuicConnRelease(Connection, QUIC_CONN_REF_WORKER);
+    }
+}
+
+//
+// Closes the current load interval, if it has run its length, and tracks how
+// long the worker has been overloaded for.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerUpdateLoad(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint64_t TimeNow
+    )
+{
+    const uint64_t Elapsed = CxPlatTimeDiff64(Worker->LoadIntervalStart, TimeNow);
+    if (Elapsed < QUIC_WORKER_LOAD_INTERVAL_US) {
+        return;
+    }
+
+    Worker->Load =
+        (uint8_t)CXPLAT_MIN(100, Worker->LoadIntervalBusyTime * 100 / Elapsed);
+    QuicTraceLogVerbose(
+        WorkerLoadUpdated,
+        "[wrkr][%p] Load = %hhu%%",
+        Worker,
+        Worker->Load);
+    if (Worker->Load >= QUIC_WORKER_REBALANCE_BUSY_PERCENT ||
+        QuicWorkerIsOverloaded(Worker)) {
+        if (Worker->OverloadedIntervals < UINT8_MAX) {
+            Worker->OverloadedIntervals++;
+        }
+    } else {
+        Worker->OverloadedIntervals = 0;
+    }
+
+    Worker->LoadIntervalStart = TimeNow;
+    Worker->LoadIntervalBusyTime = 0;
+}
+
+//
+// Returns TRUE if the connection may be moved from the worker to another one
+// in the worker's pool to balance load.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerCanMoveConnection(
+    _In_ const QUIC_WORKER* Worker,
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow
+    )
+{
+    const QUIC_REGISTRATION* Registration = Connection->Registration;
+    return
+        Worker->WorkerPool->WorkerCount > 1 &&
+        Registration != NULL && !Registration->NoPartitioning &&
+        Registration->WorkerPool == Worker->WorkerPool &&
+        Connection->State.Connected && !Connection->State.ShutdownComplete &&
+        !Connection->State.UpdateWorker && !Connection->State.Partitioned &&
+        Connection->Paths[0].Binding != NULL && !Connection->Paths[0].Binding->Partitioned &&
+        (Connection->LastRebalanceTime == 0 ||
+         CxPlatTimeDiff64(Connection->LastRebalanceTime, TimeNow) >= QUIC_CONN_REBALANCE_COOLDOWN_US);
+}
+
+//
+// Points the connection at the target worker's partition, the same way as when
+// its packets start arriving on another partition. New source CIDs route its
+// packets to the target's partition, and marking the path keeps receives from
+// moving it back. The caller still has to hand it over to the target.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerRetargetConnection(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_WORKER* Target,
+    _In_ uint64_t TimeNow
+    )
+{
+    Connection->LastRebalanceTime = TimeNow;
+    Connection->Paths[0].PartitionUpdated = TRUE;
+    Connection->PartitionID = QuicPartitionIdCreate(Target->Partition->Index);
+    QuicConnGenerateNewSourceCids(Connection, TRUE);
+}
+
+//
+// Accounts for the time just spent processing the connection in its share of
+// the worker's load, and moves it to a less loaded worker if this worker has
+// stayed overloaded and the connection is a large enough part of its load.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerRebalanceConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t ProcessingTime,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (Connection->RebalanceIntervalStart != Worker->LoadIntervalStart) {
+        Connection->RebalanceIntervalStart = Worker->LoadIntervalStart;
+        Connection->RebalanceIntervalTime = 0;
+    }
+    Connection->RebalanceIntervalTime += ProcessingTime;
+
+    if (Worker->OverloadedIntervals < QUIC_WORKER_REBALANCE_INTERVALS) {
+        return;
+    }
+
+    //
+    // The connection's share of the interval so far is a lower bound on its
+    // share of the whole interval. Moving it must leave some load behind, or
+    // the work would just move with it.
+    //
+    const uint64_t ConnLoad =
+        Connection->RebalanceIntervalTime * 100 / QUIC_WORKER_LOAD_INTERVAL_US;
+    if (ConnLoad < QUIC_WORKER_REBALANCE_MIN_CONN_LOAD ||
+        ConnLoad + QUIC_WORKER_REBALANCE_MIN_CONN_LOAD > Worker->Load) {
+        return;
+    }
+
+    if (!QuicWorkerCanMoveConnection(Worker, Connection, TimeNow)) {
+        return;
+    }
+
+    //
+    // Find the least loaded worker, and the least loaded one on the same NUMA
+    // node. The connection's memory stays where it is, so the latter is
+    // preferred if moving there helps enough.
+    //
+    QUIC_WORKER_POOL* WorkerPool = Worker->WorkerPool;
+    QUIC_WORKER* Target = NULL;
+    QUIC_WORKER* LocalTarget = NULL;
+    for (uint16_t i = 0; i < WorkerPool->WorkerCount; ++i) {
+        QUIC_WORKER* Candidate = &WorkerPool->Workers[i];
+        if (Candidate == Worker || !Candidate->Enabled ||
+            QuicWorkerIsOverloaded(Candidate)) {
+            continue;
+        }
+        if (Target == NULL || Candidate->Load < Target->Load) {
+            Target = Candidate;
+        }
+        if (Candidate->Partition->NumaNode == Worker->Partition->NumaNode &&
+            (LocalTarget == NULL || Candidate->Load < LocalTarget->Load)) {
+            LocalTarget = Candidate;
+        }
+    }
+
+    if (LocalTarget != NULL &&
+        LocalTarget->Load + ConnLoad + QUIC_WORKER_REBALANCE_HYSTERESIS <= Worker->Load - ConnLoad) {
+        Target = LocalTarget;
+    } else if (Target == NULL ||
+        Target->Load + ConnLoad + QUIC_WORKER_REBALANCE_HYSTERESIS > Worker->Load - ConnLoad) {
+        return;
+    }
+
+    QuicTraceLogConnInfo(
+        RebalanceWorker,
+        Connection,
+        "Moving to partition %hu (load %hhu%%, source load %hhu%%, conn load %llu%%)",
+        Target->Partition->Index,
+        Target->Load,
+        Worker->Load,
+        ConnLoad);
+
+    QuicWorkerRetargetConnection(Connection, Target, TimeNow);
+    Connection->State.UpdateWorker = TRUE;
+
+    //
+    // Only shed one connection per period of sustained overload.
+    //
+    Worker->OverloadedIntervals = 0;
+}
+
+//
+// Called when the worker runs out of work. Asks a peer on the same NUMA node
+// with a backed up queue to hand over a connection, so the connection's memory
+// stays local. Peers on nearby partitions are checked first.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerTrySteal(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (CxPlatTimeDiff64(Worker->LastStealTime, TimeNow) < QUIC_WORKER_STEAL_INTERVAL_US) {
+        return;
+    }
+    Worker->LastStealTime = TimeNow;
+
+    QUIC_WORKER_POOL* WorkerPool = Worker->WorkerPool;
+    const uint32_t Count = WorkerPool->WorkerCount;
+    const uint32_t Index = (uint32_t)(Worker - WorkerPool->Workers);
+    for (uint32_t Distance = 1; Distance <= Count / 2; ++Distance) {
+        const uint32_t PeerIndexes[2] = {
+            (Index + Distance) % Count,
+            (Index + Count - Distance) % Count
+        };
+        for (uint32_t i = 0; i < ARRAYSIZE(PeerIndexes); ++i) {
+            QUIC_WORKER* Peer = &WorkerPool->Workers[PeerIndexes[i]];
+            //
+            // The queue is only peeked at here. The peer checks it again under
+            // its lock when it handles the request.
+            //
+            if (Peer->Partition->NumaNode == Worker->Partition->NumaNode &&
+                Peer->Enabled && Peer->StealRequest == NULL &&
+                Peer->AverageQueueDelay >= QUIC_WORKER_STEAL_MIN_QUEUE_DELAY_US &&
+                Peer->Connections.Flink != Peer->Connections.Blink) {
+                InterlockedExchangePointer((void**)&Peer->StealRequest, Worker);
+                return;
+            }
+        }
+    }
+}
+
+//
+// Hands the connection at the tail of the queue over to the idle worker that
+// asked for it. The tail connection has waited the least, so none of the
+// others wait any longer for it. The connection isn't being processed, and the
+// hand over happens on this worker's thread, which owns its timers.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerProcessStealRequest(
+    _In_ QUIC_WORKER* Worker,
+    _In_ CXPLAT_THREAD_ID ThreadID,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_WORKER* Thief =
+        (QUIC_WORKER*)InterlockedFetchAndClearPointer((void**)&Worker->StealRequest);
+    if (Thief == NULL || !Thief->Enabled) {
+        return;
+    }
+
+    QUIC_CONNECTION* Connection = NULL;
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    if (Worker->Connections.Flink != Worker->Connections.Blink) {
+        //
+        // At least two connections are queued. Take the last one, unless it
+        // has priority work.
+        //
+        CXPLAT_LIST_ENTRY* Tail = Worker->Connections.Blink;
+        QUIC_CONNECTION* Candidate =
+            CXPLAT_CONTAINING_RECORD(Tail, QUIC_CONNECTION, WorkerLink);
+        if (Worker->PriorityConnectionsTail != &Tail->Flink &&
+            QuicWorkerCanMoveConnection(Worker, Candidate, TimeNow)) {
+            CXPLAT_DBG_ASSERT(!Candidate->WorkerProcessing);
+            CXPLAT_DBG_ASSERT(Candidate->HasQueuedWork);
+            CxPlatListEntryRemove(Tail);
+            Candidate->WorkerProcessing = TRUE;
+            Connection = Candidate;
+        }
+    }
+    CxPlatDispatchLockRelease(&Worker->Lock);
+
+    if (Connection == NULL) {
+        return;
+    }
+
+    QuicTraceLogConnInfo(
+        StealWorker,
+        Connection,
+        "Handing over to idle partition %hu",
+        Thief->Partition->Index);
+
+    Connection->WorkerThreadID = ThreadID;
+    QuicConfigurationAttachSilo(Connection->Configuration);
+    QuicWorkerRetargetConnection(Connection, Thief, TimeNow);
+    QuicConfigurationDetachSilo();
+    Connection->WorkerThreadID = 0;
+    Connection->State.UpdateWorker = TRUE;
+
+    //
+    // The connection still has queued work, so nothing queues it again on
+    // this worker once it's released. Move it like any connection whose
+    // worker changed.
+    //
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    Connection->WorkerProcessing = FALSE;
+    CxPlatDispatchLockRelease(&Worker->Lock);
+
+    QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
+    QuicPacingQueueRemoveConnection(&Worker->PacingQueue, Connection);
+    QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
+    CXPLAT_DBG_ASSERT(Connection->Worker == Thief);
+    QuicWorkerMoveConnection(Connection->Worker, Connection, FALSE);
+    QuicConnRelease(Connection, QUIC_CONN_REF_WORKER);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicWorkerProcessConnection(
@@ -602,8 +1059,9 @@ QuicWorkerProcessConnection(
         QUIC_SCHEDULE_PROCESSING);
     QuicConfigurationAttachSilo(Connection->Configuration);
 
+    uint32_t Delay = 0;
     if (Connection->Stats.Schedule.LastQueueTime != 0) {
-        uint32_t Delay =
+        Delay =
             CxPlatTimeDiff32(
                 Connection->Stats.Schedule.LastQueueTime,
                 (uint32_t)*TimeNow);
@@ -625,6 +1083,11 @@ QuicWorkerProcessConnection(
     Connection->WorkerThreadID = ThreadID;
     Connection->Stats.Schedule.DrainCount++;
 
+    if (Connection->State.HandshakeQueued) {
+        Connection->State.HandshakeQueued = FALSE;
+        InterlockedDecrement(&Worker->HandshakeQueueCount);
+    }
+
     if (Connection->State.UpdateWorker) {
         //
         // The connection was recently placed into this worker and needs any
@@ -651,11 +1114,35 @@ QuicWorkerProcessConnection(
     }
 
     //
-    // Process some operations.
+    // Process some operations, accounting for the time it takes to both the
+    // connection and the worker.
     //
+    const uint64_t ProcessStart = CxPlatTimeUs64();
     BOOLEAN StillHasPriorityWork = FALSE;
     BOOLEAN StillHasWorkToDo =
-        QuicConnDrainOperations(Connection, &StillHasPriorityWork) | Connection->State.UpdateWorker;
+        QuicConnDrainOperations(
+            Connection,
+            (uint32_t)Connection->Settings->MaxOperationsPerDrain * Worker->DrainScale,
+            &StillHasPriorityWork);
+    *TimeNow = CxPlatTimeUs64();
+    const uint64_t ProcessingTime = CxPlatTimeDiff64(ProcessStart, *TimeNow);
+    Connection->Stats.Schedule.ProcessingTime += ProcessingTime;
+    Worker->LoadIntervalBusyTime += ProcessingTime;
+    QuicPerfCounterAdd(Worker->Partition, QUIC_PERF_COUNTER_WORK_BUSY_TIME, (int64_t)ProcessingTime);
+    QuicLatencyRecord(Worker->Partition->Latency.DrainTime, ProcessingTime);
+    QUIC_FLIGHT_RECORD* Record =
+        QuicWorkerFlightRecord(
+            Worker, QUIC_FLIGHT_RECORD_CONNECTION, ProcessStart, ProcessingTime);
+    Record->CONNECTION.CorrelationId = Connection->Stats.CorrelationId;
+    Record->CONNECTION.QueueDelayUs = Delay;
+    Record->CONNECTION.StillHasWork = StillHasWorkToDo;
+    if (QuicConnTelemetryDue(Connection, *TimeNow)) {
+        QuicWorkerQueueTelemetry(Worker, Connection, *TimeNow);
+    }
+    if (Worker->RebalanceConnections) {
+        QuicWorkerRebalanceConnection(Worker, Connection, ProcessingTime, *TimeNow);
+    }
+    StillHasWorkToDo |= Connection->State.UpdateWorker;
     Connection->WorkerThreadID = 0;
 
     //
@@ -665,6 +1152,15 @@ QuicWorkerProcessConnection(
     Connection->WorkerProcessing = FALSE;
     Connection->HasQueuedWork |= StillHasWorkToDo;
 
+    if (StillHasWorkToDo && CxPlatListIsEmpty(&Worker->Connections) &&
+        Worker->DrainScale < QUIC_WORKER_MAX_DRAIN_SCALE) {
+        //
+        // The connection used up its turn with nobody else waiting, so let
+        // the next turns be longer.
+        //
+        Worker->DrainScale *= 2;
+    }
+
     BOOLEAN DoneWithConnection = TRUE;
     if (!Connection->State.UpdateWorker) {
         if (Connection->HasQueuedWork) {
@@ -703,6 +1199,7 @@ QuicWorkerProcessConnection(
             // processed on the other worker.
             //
             QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
+            QuicPacingQueueRemoveConnection(&Worker->PacingQueue, Connection);
             CXPLAT_FRE_ASSERT(Connection->Registration != NULL);
             QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
             CXPLAT_DBG_ASSERT(Worker != Connection->Worker);
@@ -775,6 +1272,25 @@ QuicWorkerLoopCleanup(
     _In_ QUIC_WORKER* Worker
     )
 {
+    QuicWorkerFlushSends(Worker);
+    QuicWorkerFlushRecvData(Worker);
+    QuicWorkerFlushTelemetry(Worker);
+
+    //
+    // Release the paced connections still waiting. They're either cleaned up
+    // below, or already shutting down.
+    //
+    CXPLAT_LIST_ENTRY Released;
+    CxPlatListInitializeHead(&Released);
+    QuicPacingQueueGetReleased(&Worker->PacingQueue, UINT64_MAX, &Released);
+    while (!CxPlatListIsEmpty(&Released)) {
+        CXPLAT_LIST_ENTRY* Entry = CxPlatListRemoveHead(&Released);
+        Entry->Flink = NULL;
+        QuicConnRelease(
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, PacingLink),
+            QUIC_CONN_REF_WORKER);
+    }
+
     //
     // Because the registration layer only waits for the rundown to complete,
     // and because the connection releases the rundown on handle close,
@@ -840,6 +1356,8 @@ QuicWorkerLoop(
     )
 {
     QUIC_WORKER* Worker = (QUIC_WORKER*)Context;
+    Worker->ThreadID = State->ThreadID;
+    const uint64_t LoopStart = State->TimeNow;
 
     if (!Worker->Enabled) {
         QuicWorkerLoopCleanup(Worker);
@@ -863,6 +1381,8 @@ QuicWorkerLoop(
     //
     QuicPerfCounterTrySnapShot(State->TimeNow);
 
+    QuicWorkerUpdateLoad(Worker, State->TimeNow);
+
     //
     // For every loop of the worker thread, in an attempt to balance things,
     // first the timer wheel is checked and any expired timers are processed.
@@ -876,11 +1396,37 @@ QuicWorkerLoop(
         State->NoWorkCount = 0;
     }
 
+    if (Worker->PacingQueue.NextReleaseTime <= State->TimeNow) {
+        QuicWorkerProcessPacing(Worker, State->ThreadID, State->TimeNow);
+        State->NoWorkCount = 0;
+    }
+
+    if (Worker->StealRequest != NULL) {
+        QuicWorkerProcessStealRequest(Worker, State->ThreadID, State->TimeNow);
+    }
+
     QUIC_CONNECTION* Connection = QuicWorkerGetNextConnection(Worker);
     if (Connection != NULL) {
         QuicWorkerProcessConnection(Worker, Connection, State->ThreadID, &State->TimeNow);
         Worker->ExecutionContext.Ready = TRUE;
         State->NoWorkCount = 0;
+
+        if (Worker->TeardownCount != 0) {
+            //
+            // A registration shutdown queued its connections at the front of
+            // the queue. Tear down a batch of them in one pass, instead of
+            // going around the whole loop for each.
+            //
+            uint32_t Processed = 1;
+            while (Processed < QUIC_WORKER_TEARDOWN_BATCH &&
+                   (Connection = QuicWorkerGetNextConnection(Worker)) != NULL) {
+                QuicWorkerProcessConnection(Worker, Connection, State->ThreadID, &State->TimeNow);
+                Processed++;
+            }
+            if (InterlockedExchangeAdd(&Worker->TeardownCount, -(long)Processed) <= (long)Processed) {
+                Worker->TeardownCount = 0;
+            }
+        }
     }
 
     QUIC_LISTENER* Listener = QuicWorkerGetNextListener(Worker);
@@ -902,12 +1448,41 @@ QuicWorkerLoop(
     }
 
     if (Worker->ExecutionContext.Ready) {
+        QuicWorkerFlightRecordQueues(
+            Worker,
+            QUIC_FLIGHT_RECORD_LOOP,
+            LoopStart,
+            CxPlatTimeDiff64(LoopStart, CxPlatTimeUs64()));
+
         //
-        // There is more work to be done.
+        // There is more work to be done. Keep holding back batched sends
+        // unless they've already waited long enough.
         //
+        if (Worker->SendBatch.Count != 0 &&
+            CxPlatTimeDiff64(Worker->SendBatch.StartTimeUs, State->TimeNow) >=
+                QUIC_WORKER_SEND_BATCH_MAX_DELAY_US) {
+            QuicWorkerFlushSends(Worker);
+        }
+        if (Worker->TelemetryBatch.Count != 0 &&
+            CxPlatTimeDiff64(Worker->TelemetryBatch.StartTimeUs, State->TimeNow) >=
+                QUIC_WORKER_TELEMETRY_BATCH_MAX_DELAY_US) {
+            QuicWorkerFlushTelemetry(Worker);
+        }
+        QuicWorkerFlushRecvData(Worker);
         return TRUE;
     }
 
+    //
+    // Out of immediate work, so submit everything that was batched up.
+    //
+    QuicWorkerFlushSends(Worker);
+    QuicWorkerFlushRecvData(Worker);
+    QuicWorkerFlushTelemetry(Worker);
+
+    if (Worker->RebalanceConnections) {
+        QuicWorkerTrySteal(Worker, State->TimeNow);
+    }
+
     if (MsQuicLib.ExecutionConfig &&
         (uint64_t)MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs >
             CxPlatTimeDiff64(State->LastWorkTime, State->TimeNow)) {
@@ -919,12 +1494,28 @@ QuicWorkerLoop(
         return TRUE;
     }
 
+    if (Worker->PacingQueue.NextReleaseTime != UINT64_MAX &&
+        Worker->PacingQueue.NextReleaseTime <
+            State->TimeNow + QUIC_PACING_QUEUE_POLL_THRESHOLD_US) {
+        //
+        // A paced connection is due sooner than waiting can resolve, so poll
+        // for it instead.
+        //
+        Worker->ExecutionContext.Ready = TRUE;
+        return TRUE;
+    }
+
     //
     // We have no other work to process at the moment. Wait for work to come in
     // or any timer to expire.
     //
     Worker->IsActive = FALSE;
-    Worker->ExecutionContext.NextTimeUs = Worker->TimerWheel.NextExpirationTime;
+    QuicWorkerFlightRecordQueues(
+        Worker, QUIC_FLIGHT_RECORD_IDLE, State->TimeNow, 0);
+    Worker->ExecutionContext.NextTimeUs =
+        CXPLAT_MIN(
+            Worker->TimerWheel.NextExpirationTime,
+            Worker->PacingQueue.NextReleaseTime);
     QuicTraceEvent(
         WorkerActivityStateUpdated,
         "[wrkr][%p] IsActive = %hhu, Arg = %u",
@@ -960,14 +1551,18 @@ CXPLAT_THREAD_CALLBACK(QuicWorkerThread, Context)
         BOOLEAN Ready = InterlockedFetchAndClearBoolean(&EC->Ready);
         if (!Ready) {
             if (EC->NextTimeUs == UINT64_MAX) {
+                QuicTraceProbe(worker_sleep, Worker, UINT32_MAX);
                 CxPlatEventWaitForever(Worker->Ready);
+                QuicTraceProbe(worker_wake, Worker);
 
             } else if (EC->NextTimeUs > State.TimeNow) {
                 uint64_t Delay = US_TO_MS(EC->NextTimeUs - State.TimeNow) + 1;
                 if (Delay >= (uint64_t)UINT32_MAX) {
                     Delay = UINT32_MAX - 1; // Max has special meaning for most platforms.
                 }
+                QuicTraceProbe(worker_sleep, Worker, (uint32_t)Delay);
                 CxPlatEventWaitWithTimeout(Worker->Ready, (uint32_t)Delay);
+                QuicTraceProbe(worker_wake, Worker);
             }
         }
         if (State.NoWorkCount == 0) {
@@ -1015,6 +1610,7 @@ QuicWorkerPoolInitialize(
 
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     for (uint16_t i = 0; i < WorkerCount; i++) {
+        WorkerPool->Workers[i].WorkerPool = WorkerPool;
         Status =
             QuicWorkerInitialize(
                 Registration,
@@ -1097,6 +1693,198 @@ QuicWorkerPoolGetLeastLoadedWorker(
     return MinQueueDelayWorker;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerSend(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_BINDING* Binding,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ uint32_t BytesToSend,
+    _In_ uint32_t DatagramsToSend
+    )
+{
+    QUIC_WORKER_SEND_BATCH* Batch = &Worker->SendBatch;
+
+    if (Batch->Binding != Binding) {
+        QuicWorkerFlushSends(Worker);
+        if (!QuicLibraryTryAddRefBinding(Binding)) {
+            QuicBindingSend(
+                Binding,
+                Worker->Partition,
+                Route,
+                SendData,
+                BytesToSend,
+                DatagramsToSend);
+            return;
+        }
+        Batch->Binding = Binding;
+    }
+
+    if (Batch->Count == 0) {
+        Batch->StartTimeUs = CxPlatTimeUs64();
+    }
+
+    Batch->Routes[Batch->Count] = *Route;
+    Batch->SendData[Batch->Count] = SendData;
+    Batch->TotalBytes += BytesToSend;
+    Batch->TotalDatagrams += DatagramsToSend;
+
+    if (++Batch->Count == QUIC_WORKER_SEND_BATCH_MAX) {
+        QuicWorkerFlushSends(Worker);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerFlushSends(
+    _In_ QUIC_WORKER* Worker
+    )
+{
+    QUIC_WORKER_SEND_BATCH* Batch = &Worker->SendBatch;
+
+    if (Batch->Binding == NULL) {
+        return;
+    }
+
+    if (Batch->Count != 0) {
+        QuicBindingSendBatch(
+            Batch->Binding,
+            Worker->Partition,
+            Batch->Routes,
+            Batch->SendData,
+            Batch->Count,
+            Batch->TotalBytes,
+            Batch->TotalDatagrams);
+    }
+
+    QuicLibraryReleaseBinding(Batch->Binding);
+    Batch->Binding = NULL;
+    Batch->Count = 0;
+    Batch->TotalBytes = 0;
+    Batch->TotalDatagrams = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicWorkerGetFlightRecords(
+    _In_ const QUIC_WORKER* Worker,
+    _Out_writes_to_(QUIC_WORKER_FLIGHT_RECORDER_SIZE, return)
+        QUIC_FLIGHT_RECORD* Records
+    )
+{
+    const uint32_t Next = *(volatile const uint32_t*)&Worker->FlightRecorder.Next;
+    const uint32_t Count = CXPLAT_MIN(Next, QUIC_WORKER_FLIGHT_RECORDER_SIZE);
+    for (uint32_t i = 0; i < Count; ++i) {
+        Records[i] =
+            Worker->FlightRecorder.Records[
+                (Next - Count + i) & (QUIC_WORKER_FLIGHT_RECORDER_SIZE - 1)];
+    }
+    return Count;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerQueueTelemetry(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_WORKER_TELEMETRY_BATCH* Batch = &Worker->TelemetryBatch;
+
+    if (Batch->Registration != Connection->Registration) {
+        QuicWorkerFlushTelemetry(Worker);
+        if (!QuicRegistrationRundownAcquire(
+                Connection->Registration, QUIC_REG_REF_TELEMETRY)) {
+            return;
+        }
+        Batch->Registration = Connection->Registration;
+    }
+
+    if (Batch->Count == 0) {
+        Batch->StartTimeUs = TimeNow;
+    }
+
+    QuicConnGetPathTelemetry(Connection, TimeNow, &Batch->Snapshots[Batch->Count]);
+
+    if (++Batch->Count == QUIC_WORKER_TELEMETRY_BATCH_MAX) {
+        QuicWorkerFlushTelemetry(Worker);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerFlushTelemetry(
+    _In_ QUIC_WORKER* Worker
+    )
+{
+    QUIC_WORKER_TELEMETRY_BATCH* Batch = &Worker->TelemetryBatch;
+
+    if (Batch->Registration == NULL) {
+        return;
+    }
+
+    if (Batch->Count != 0) {
+        const QUIC_PATH_TELEMETRY_CONFIG* Config = &Batch->Registration->Telemetry;
+        QuicTraceLogVerbose(
+            IndicatePathTelemetry,
+            "[wrkr][%p] Indicating %u path telemetry snapshots",
+            Worker,
+            Batch->Count);
+        Config->Callback(Config->Context, Batch->Count, Batch->Snapshots);
+    }
+
+    QuicRegistrationRundownRelease(Batch->Registration, QUIC_REG_REF_TELEMETRY);
+    Batch->Registration = NULL;
+    Batch->Count = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerReturnRecvData(
+    _In_opt_ QUIC_WORKER* Worker,
+    _In_ CXPLAT_RECV_DATA* Chain,
+    _In_ CXPLAT_RECV_DATA** Tail,
+    _In_ uint32_t Count
+    )
+{
+    //
+    // Only the worker's own thread may touch the chain. Connections are also
+    // processed elsewhere (e.g. while the worker is being changed), and those
+    // return their datagrams right away.
+    //
+    if (Worker == NULL || Worker->ThreadID != CxPlatCurThreadID()) {
+        CxPlatRecvDataReturn(Chain);
+        return;
+    }
+
+    *Worker->RecvReturnTail = Chain;
+    Worker->RecvReturnTail = Tail;
+    Worker->RecvReturnCount += Count;
+
+    if (Worker->RecvReturnCount >= QUIC_WORKER_RECV_RETURN_MAX) {
+        QuicWorkerFlushRecvData(Worker);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerFlushRecvData(
+    _In_ QUIC_WORKER* Worker
+    )
+{
+    if (Worker->RecvReturnChain == NULL) {
+        return;
+    }
+
+    *Worker->RecvReturnTail = NULL;
+    CxPlatRecvDataReturn(Worker->RecvReturnChain);
+    Worker->RecvReturnChain = NULL;
+    Worker->RecvReturnTail = &Worker->RecvReturnChain;
+    Worker->RecvReturnCount = 0;
+}
+
 BOOLEAN
 QuicWorkerPoolIsInPartition(
     _In_ QUIC_WORKER_POOL* WorkerPool,
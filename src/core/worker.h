@@ -5,6 +5,71 @@
 
 --*/
 
+//
+// Sends collected from the worker's connections for the same binding, so that
+// they may be handed to the datapath together.
+//
+typedef struct QUIC_WORKER_SEND_BATCH {
+
+    //
+    // The binding all the sends are for. Holds a reference while set.
+    //
+    QUIC_BINDING* Binding;
+
+    //
+    // When the first send was held back.
+    //
+    uint64_t StartTimeUs;
+
+    uint32_t Count;
+    uint32_t TotalBytes;
+    uint32_t TotalDatagrams;
+
+    CXPLAT_ROUTE Routes[QUIC_WORKER_SEND_BATCH_MAX];
+    CXPLAT_SEND_DATA* SendData[QUIC_WORKER_SEND_BATCH_MAX];
+
+} QUIC_WORKER_SEND_BATCH;
+
+//
+// Path telemetry snapshots taken of the worker's connections, to be delivered
+// to the registration together.
+//
+typedef struct QUIC_WORKER_TELEMETRY_BATCH {
+
+    //
+    // The registration the snapshots are for. Holds a rundown reference while
+    // set.
+    //
+    QUIC_REGISTRATION* Registration;
+
+    //
+    // When the first snapshot was taken.
+    //
+    uint64_t StartTimeUs;
+
+    uint32_t Count;
+    QUIC_PATH_TELEMETRY Snapshots[QUIC_WORKER_TELEMETRY_BATCH_MAX];
+
+} QUIC_WORKER_TELEMETRY_BATCH;
+
+//
+// The most recent events of a worker, kept so that stalls can be diagnosed
+// after the fact. Only written by the worker's thread, and read without
+// synchronization, so a dump taken while the worker runs may have a torn
+// entry or two.
+//
+typedef struct QUIC_WORKER_FLIGHT_RECORDER {
+
+    //
+    // The number of entries ever recorded. The next one is written at this
+    // index, modulo the size.
+    //
+    uint32_t Next;
+
+    QUIC_FLIGHT_RECORD Records[QUIC_WORKER_FLIGHT_RECORDER_SIZE];
+
+} QUIC_WORKER_FLIGHT_RECORDER;
+
 //
 // A worker thread for draining queued operations on a connection.
 //
@@ -20,6 +85,11 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     //
     QUIC_PARTITION* Partition;
 
+    //
+    // The pool the worker belongs to.
+    //
+    QUIC_WORKER_POOL* WorkerPool;
+
     //
     // Event to signal when the execution context (i.e. worker thread) is
     // complete.
@@ -41,16 +111,92 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     //
     BOOLEAN IsActive;
 
+    //
+    // TRUE if connection sends are batched across connections until the
+    // worker runs out of immediate work.
+    //
+    BOOLEAN BatchSends;
+
+    //
+    // TRUE if paced connections are scheduled on the worker's pacing queue
+    // instead of their own pacing timers.
+    //
+    BOOLEAN HighResPacing;
+
+    //
+    // TRUE if connections may be moved between workers to balance load: heavy
+    // connections off a worker that stays overloaded, and queued connections
+    // to an idle worker that steals them.
+    //
+    BOOLEAN RebalanceConnections;
+
+    //
+    // Percentage of the last load interval spent processing connections, and
+    // the number of consecutive intervals the worker has been overloaded.
+    //
+    uint8_t Load;
+    uint8_t OverloadedIntervals;
+
+    //
+    // How many times their MaxOperationsPerDrain connections may drain per
+    // call, between 1 and QUIC_WORKER_MAX_DRAIN_SCALE.
+    //
+    uint8_t DrainScale;
+
     //
     // The average queue delay connections experience, in microseconds.
     //
     uint32_t AverageQueueDelay;
 
+    //
+    // The number of new server connections admitted to the worker that it
+    // hasn't processed yet.
+    //
+    long volatile HandshakeQueueCount;
+
+    //
+    // Roughly the number of connections queued by registration shutdowns that
+    // the worker hasn't processed yet. Only used to decide when to process
+    // connections in batches.
+    //
+    long volatile TeardownCount;
+
+    //
+    // Start of the current load interval, and the time spent processing
+    // connections in it so far, in microseconds.
+    //
+    uint64_t LoadIntervalStart;
+    uint64_t LoadIntervalBusyTime;
+
+    //
+    // An idle worker that asked to take over one of the connections queued on
+    // this worker, or NULL. Only this worker's thread hands the connection
+    // over, so it's never processed by two threads at once.
+    //
+    struct QUIC_WORKER* StealRequest;
+
+    //
+    // When this worker last asked a peer for a connection.
+    //
+    uint64_t LastStealTime;
+
+    //
+    // The thread that last ran the worker's execution context. When the worker
+    // shares its thread with the datapath, receives indicated on this thread
+    // can be processed inline.
+    //
+    CXPLAT_THREAD_ID ThreadID;
+
     //
     // Timers for the worker's connections.
     //
     QUIC_TIMER_WHEEL TimerWheel;
 
+    //
+    // Paced connections waiting for their next chunk to be released.
+    //
+    QUIC_PACING_QUEUE PacingQueue;
+
     //
     // An event to kick the thread.
     //
@@ -84,6 +230,30 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     uint32_t OperationCount;
     uint64_t DroppedOperationCount;
 
+    //
+    // Connection sends waiting to be submitted to the datapath.
+    //
+    QUIC_WORKER_SEND_BATCH SendBatch;
+
+    //
+    // Path telemetry snapshots waiting to be delivered.
+    //
+    QUIC_WORKER_TELEMETRY_BATCH TelemetryBatch;
+
+    //
+    // Received datagrams the worker's connections are done with, returned to
+    // the datapath together at the end of the loop iteration.
+    //
+    CXPLAT_RECV_DATA* RecvReturnChain;
+    CXPLAT_RECV_DATA** RecvReturnTail;
+    uint32_t RecvReturnCount;
+
+    //
+    // Always-on record of the worker's recent loop iterations and connection
+    // processing.
+    //
+    QUIC_WORKER_FLIGHT_RECORDER FlightRecorder;
+
 } QUIC_WORKER;
 
 //
@@ -109,6 +279,61 @@ typedef struct QUIC_WORKER_POOL {
 
 } QUIC_WORKER_POOL;
 
+//
+// Claims the next flight recorder entry, overwriting the oldest, and fills in
+// its common fields. The caller fills in the type specific ones.
+//
+QUIC_INLINE
+QUIC_FLIGHT_RECORD*
+QuicWorkerFlightRecord(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_FLIGHT_RECORD_TYPE Type,
+    _In_ uint64_t TimeUs,
+    _In_ uint64_t DurationUs
+    )
+{
+    QUIC_FLIGHT_RECORD* Record =
+        &Worker->FlightRecorder.Records[
+            Worker->FlightRecorder.Next++ & (QUIC_WORKER_FLIGHT_RECORDER_SIZE - 1)];
+    Record->TimeUs = TimeUs;
+    Record->DurationUs = (uint32_t)CXPLAT_MIN(DurationUs, UINT32_MAX);
+    Record->Type = (uint16_t)Type;
+    Record->PartitionIndex = Worker->Partition->Index;
+    return Record;
+}
+
+//
+// Records the worker's queues, for loop and idle entries.
+//
+QUIC_INLINE
+void
+QuicWorkerFlightRecordQueues(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_FLIGHT_RECORD_TYPE Type,
+    _In_ uint64_t TimeUs,
+    _In_ uint64_t DurationUs
+    )
+{
+    QUIC_FLIGHT_RECORD* Record =
+        QuicWorkerFlightRecord(Worker, Type, TimeUs, DurationUs);
+    Record->LOOP.QueuedOperations = Worker->OperationCount;
+    Record->LOOP.QueuedHandshakes = (uint32_t)Worker->HandshakeQueueCount;
+    Record->LOOP.TimerConnections = (uint32_t)Worker->TimerWheel.ConnectionCount;
+    Record->LOOP.Load = Worker->Load;
+}
+
+//
+// Copies the worker's flight recorder entries, oldest first, to Records, which
+// has room for QUIC_WORKER_FLIGHT_RECORDER_SIZE. Returns the number copied.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicWorkerGetFlightRecords(
+    _In_ const QUIC_WORKER* Worker,
+    _Out_writes_to_(QUIC_WORKER_FLIGHT_RECORDER_SIZE, return)
+        QUIC_FLIGHT_RECORD* Records
+    );
+
 //
 // Returns TRUE if the worker is currently overloaded and shouldn't take on more
 // work, if at all possible.
@@ -123,6 +348,39 @@ QuicWorkerIsOverloaded(
     return Worker->AverageQueueDelay > MsQuicLib.Settings.MaxWorkerQueueDelayUs;
 }
 
+//
+// Returns TRUE if the worker can admit a new server connection. Fresh
+// handshakes are turned away well before resuming clients are, so that the
+// worker's established connections don't suffer during connection storms.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+BOOLEAN
+QuicWorkerCanAdmitConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ BOOLEAN IsResumption
+    )
+{
+    const long QueueCount = Worker->HandshakeQueueCount;
+    if (QuicWorkerIsOverloaded(Worker) ||
+        QueueCount >= QUIC_WORKER_MAX_HANDSHAKE_QUEUE) {
+        return FALSE;
+    }
+
+    if (IsResumption) {
+        return TRUE;
+    }
+
+    //
+    // The load is only current while the worker is active. An idle worker
+    // has capacity to spare.
+    //
+    return
+        QueueCount < QUIC_WORKER_MAX_HANDSHAKE_QUEUE / 2 &&
+        Worker->AverageQueueDelay <= MsQuicLib.Settings.MaxWorkerQueueDelayUs / 2 &&
+        (!Worker->IsActive || Worker->Load < QUIC_WORKER_HANDSHAKE_BUDGET_PERCENT);
+}
+
 //
 // Initializes the worker pool.
 //
@@ -193,6 +451,42 @@ QuicWorkerQueuePriorityConnection(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Queues a batch of connections being torn down by a registration shutdown
+// onto the worker as priority connections, taking the worker lock once. The
+// worker then processes them back to back instead of one per loop iteration.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueueTeardownConnections(
+    _In_ QUIC_WORKER* Worker,
+    _In_reads_(Count) QUIC_CONNECTION** Connections,
+    _In_ uint32_t Count
+    );
+
+//
+// Tries to take ownership of an idle connection for processing inline on the
+// worker's own thread, as if the worker had dequeued it. Fails if the
+// connection has queued work or is already being processed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerTryClaimConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Releases a connection claimed by QuicWorkerTryClaimConnection, queuing it if
+// any work was queued in the meantime.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerReleaseClaimedConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerAssignListener(
@@ -218,6 +512,74 @@ QuicWorkerQueueOperation(
     _In_ QUIC_OPERATION* Operation
     );
 
+//
+// Sends the data for a connection being processed by the worker, possibly
+// holding it back to be submitted with other connections' sends.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerSend(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_BINDING* Binding,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ uint32_t BytesToSend,
+    _In_ uint32_t DatagramsToSend
+    );
+
+//
+// Submits any sends held back by the worker.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerFlushSends(
+    _In_ QUIC_WORKER* Worker
+    );
+
+//
+// Takes a path telemetry snapshot of the connection, to be delivered to its
+// registration with the worker's next batch.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerQueueTelemetry(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeNow
+    );
+
+//
+// Delivers any path telemetry snapshots held back by the worker.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerFlushTelemetry(
+    _In_ QUIC_WORKER* Worker
+    );
+
+//
+// Returns a chain of received datagrams to the datapath. If called on the
+// worker's thread, the chain is held back to be returned with the others
+// collected in the same loop iteration.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerReturnRecvData(
+    _In_opt_ QUIC_WORKER* Worker,
+    _In_ CXPLAT_RECV_DATA* Chain,
+    _In_ CXPLAT_RECV_DATA** Tail,
+    _In_ uint32_t Count
+    );
+
+//
+// Returns the received datagrams held back by the worker.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerFlushRecvData(
+    _In_ QUIC_WORKER* Worker
+    );
+
 BOOLEAN
 QuicWorkerPoolIsInPartition(
     _In_ QUIC_WORKER_POOL* WorkerPool,
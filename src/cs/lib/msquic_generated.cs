@@ -41,6 +41,7 @@ namespace Microsoft.Quic
         DISABLED,
         SERVER_ID_IP,
         SERVER_ID_FIXED,
+        SERVER_ID_QUIC_LB,
         COUNT,
     }
 
@@ -143,6 +144,8 @@ namespace Microsoft.Quic
     {
         FIFO = 0x0000,
         ROUND_ROBIN = 0x0001,
+        EXTENSIBLE = 0x0002,
+        WEIGHTED = 0x0003,
         COUNT,
     }
 
@@ -199,6 +202,7 @@ namespace Microsoft.Quic
         CANCEL_ON_LOSS = 0x0020,
         PRIORITY_WORK = 0x0040,
         CANCEL_ON_BLOCKED = 0x0080,
+        DGRAM_LOW_PRIORITY = 0x0100,
     }
 
     internal enum QUIC_DATAGRAM_SEND_STATE
@@ -924,6 +928,42 @@ namespace Microsoft.Quic
 
         [NativeTypeName("uint32_t")]
         internal uint RttVariance;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendDeliveryRate;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong ProcessingTime;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedBySchedulingUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedByPacingUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedByAmplificationProtUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedByCongestionControlUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedByConnFlowControlUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedByStreamFlowControlUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendBlockedByStreamIdFlowControlUs;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SpinRttSampleCount;
+
+        [NativeTypeName("uint32_t")]
+        internal uint SpinRttLatestUs;
+
+        [NativeTypeName("uint32_t")]
+        internal uint SpinRttMinUs;
     }
 
     internal partial struct QUIC_NETWORK_STATISTICS
@@ -994,6 +1034,13 @@ namespace Microsoft.Quic
         SEND_STATELESS_RETRY,
         CONN_LOAD_REJECT,
         LISTEN_QUEUE_DEPTH,
+        WORK_BUSY_TIME,
+        MEMORY_USAGE,
+        CONN_HIBERNATING,
+        ZERORTT_REPLAY_REJECT,
+        XDP_BUSY_POLL_TIME,
+        XDP_SLEEP_TIME,
+        XDP_INTERRUPT_TIME,
         MAX,
     }
 
@@ -1448,16 +1495,16 @@ namespace Microsoft.Quic
             }
         }
 
-        internal ulong ReservedRioEnabled
+        internal ulong RioEnabled
         {
             get
             {
-                return Anonymous2.Anonymous.ReservedRioEnabled;
+                return Anonymous2.Anonymous.RioEnabled;
             }
 
             set
             {
-                Anonymous2.Anonymous.ReservedRioEnabled = value;
+                Anonymous2.Anonymous.RioEnabled = value;
             }
         }
 
@@ -2120,7 +2167,7 @@ namespace Microsoft.Quic
                 }
 
                 [NativeTypeName("uint64_t : 1")]
-                internal ulong ReservedRioEnabled
+                internal ulong RioEnabled
                 {
                     get
                     {
@@ -2277,7 +2324,7 @@ namespace Microsoft.Quic
                 }
 
                 [NativeTypeName("uint64_t : 1")]
-                internal ulong ReservedRioEnabled
+                internal ulong RioEnabled
                 {
                     get
                     {
@@ -2450,6 +2497,15 @@ namespace Microsoft.Quic
         internal ulong StreamBlockedByAppUs;
     }
 
+    internal partial struct QUIC_STREAM_EXTENSIBLE_PRIORITY
+    {
+        [NativeTypeName("uint8_t")]
+        internal byte Urgency;
+
+        [NativeTypeName("BOOLEAN")]
+        internal byte Incremental;
+    }
+
     internal enum QUIC_AEAD_ALGORITHM_TYPE
     {
         QUIC_AEAD_ALGORITHM_AES_128_GCM = 0,
@@ -3444,6 +3500,46 @@ namespace Microsoft.Quic
         internal QUIC_CONNECTION_POOL_FLAGS Flags;
     }
 
+    internal unsafe partial struct QUIC_SEND_BATCH_ENTRY
+    {
+        [NativeTypeName("HQUIC")]
+        internal QUIC_HANDLE* Stream;
+
+        [NativeTypeName("const QUIC_BUFFER *")]
+        internal QUIC_BUFFER* Buffers;
+
+        [NativeTypeName("uint32_t")]
+        internal uint BufferCount;
+
+        internal QUIC_SEND_FLAGS Flags;
+
+        internal void* ClientSendContext;
+
+        [NativeTypeName("HRESULT")]
+        internal int Status;
+    }
+
+    internal unsafe partial struct QUIC_STREAM_OPEN_BATCH_ENTRY
+    {
+        internal void* Context;
+
+        [NativeTypeName("const QUIC_BUFFER *")]
+        internal QUIC_BUFFER* Buffers;
+
+        [NativeTypeName("uint32_t")]
+        internal uint BufferCount;
+
+        internal QUIC_SEND_FLAGS Flags;
+
+        internal void* ClientSendContext;
+
+        [NativeTypeName("HQUIC")]
+        internal QUIC_HANDLE* Stream;
+
+        [NativeTypeName("HRESULT")]
+        internal int Status;
+    }
+
     internal unsafe partial struct QUIC_API_TABLE
     {
         [NativeTypeName("QUIC_SET_CONTEXT_FN")]
@@ -3559,6 +3655,18 @@ namespace Microsoft.Quic
 
         [NativeTypeName("QUIC_REGISTRATION_CLOSE2_FN")]
         internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, delegate* unmanaged[Cdecl]<void*, void>, void*, void> RegistrationClose2;
+
+        [NativeTypeName("QUIC_EXECUTION_POLL_BATCH_FN")]
+        internal delegate* unmanaged[Cdecl]<uint, QUIC_EXECUTION**, uint, uint, uint> ExecutionPollBatch;
+
+        [NativeTypeName("QUIC_CONNECTION_SEND_BATCH_FN")]
+        internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, uint, QUIC_SEND_BATCH_ENTRY*, int> ConnectionSendBatch;
+
+        [NativeTypeName("QUIC_STREAM_OPEN_BATCH_FN")]
+        internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, QUIC_STREAM_OPEN_FLAGS, QUIC_STREAM_START_FLAGS, delegate* unmanaged[Cdecl]<QUIC_HANDLE*, void*, QUIC_STREAM_EVENT*, int>, uint, QUIC_STREAM_OPEN_BATCH_ENTRY*, int> StreamOpenBatch;
+
+        [NativeTypeName("QUIC_STREAM_SEND_FILE_FN")]
+        internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, nint, ulong, ulong, QUIC_SEND_FLAGS, void*, int> StreamSendFile;
     }
 
     internal static unsafe partial class MsQuic
@@ -3804,6 +3912,12 @@ namespace Microsoft.Quic
         [NativeTypeName("#define QUIC_PARAM_STREAM_RELIABLE_OFFSET 0x08000005")]
         internal const uint QUIC_PARAM_STREAM_RELIABLE_OFFSET = 0x08000005;
 
+        [NativeTypeName("#define QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY 0x08000006")]
+        internal const uint QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY = 0x08000006;
+
+        [NativeTypeName("#define QUIC_PARAM_STREAM_WEIGHT 0x08000007")]
+        internal const uint QUIC_PARAM_STREAM_WEIGHT = 0x08000007;
+
         [NativeTypeName("#define QUIC_API_VERSION_2 2")]
         internal const uint QUIC_API_VERSION_2 = 2;
     }
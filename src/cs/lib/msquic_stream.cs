@@ -0,0 +1,264 @@
+#pragma warning disable IDE0073
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+#pragma warning restore IDE0073
+
+#if NET6_0_OR_GREATER
+
+using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace Microsoft.Quic
+{
+    /// <summary>
+    /// A pool of fixed size native send buffers. Each block starts with the
+    /// QUIC_BUFFER describing its data, so the block can be passed straight
+    /// to StreamSend as both the buffer and the client context, and returned
+    /// to the pool on SEND_COMPLETE. Nothing is pinned and nothing is
+    /// allocated on the managed heap once the pool is warm.
+    /// </summary>
+    internal sealed unsafe class MsQuicSendBufferPool : IDisposable
+    {
+        internal struct Block
+        {
+            public QUIC_BUFFER Buffer;
+            public Block* Next;
+        }
+
+        private readonly object _lock = new();
+        private readonly int _maxCached;
+        private Block* _free;
+        private int _freeCount;
+        private bool _disposed;
+
+        public int BlockSize { get; }
+
+        public MsQuicSendBufferPool(int blockSize = 16 * 1024, int maxCached = 256)
+        {
+            if (blockSize <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(blockSize));
+            }
+            BlockSize = blockSize;
+            _maxCached = maxCached;
+        }
+
+        public Block* Rent()
+        {
+            lock (_lock)
+            {
+                if (_free != null)
+                {
+                    Block* block = _free;
+                    _free = block->Next;
+                    _freeCount--;
+                    return block;
+                }
+            }
+
+            Block* newBlock = (Block*)NativeMemory.Alloc((nuint)(sizeof(Block) + BlockSize));
+            newBlock->Buffer.Buffer = (byte*)(newBlock + 1);
+            newBlock->Buffer.Length = 0;
+            newBlock->Next = null;
+            return newBlock;
+        }
+
+        public void Return(Block* block)
+        {
+            lock (_lock)
+            {
+                // Sends still in flight when the pool is disposed are freed
+                // as they complete.
+                if (!_disposed && _freeCount < _maxCached)
+                {
+                    block->Next = _free;
+                    _free = block;
+                    _freeCount++;
+                    return;
+                }
+            }
+            NativeMemory.Free(block);
+        }
+
+        public void Dispose()
+        {
+            Block* free;
+            lock (_lock)
+            {
+                _disposed = true;
+                free = _free;
+                _free = null;
+                _freeCount = 0;
+            }
+            while (free != null)
+            {
+                Block* next = free->Next;
+                NativeMemory.Free(free);
+                free = next;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Base class for a stream with an allocation free data path. Sends copy
+    /// the caller's span into pooled native buffers, and received data is
+    /// passed to <see cref="OnReceive"/> as spans over MsQuic's own buffers.
+    /// Events are dispatched through a function pointer callback to virtual
+    /// methods, using a single GCHandle for the life of the stream.
+    /// </summary>
+    /// <remarks>
+    /// The GCHandle keeps the object alive until <see cref="Dispose"/>, which
+    /// must be called to close the stream.
+    /// </remarks>
+    internal abstract unsafe class MsQuicStream : IDisposable
+    {
+        private readonly QUIC_API_TABLE* _api;
+        private readonly MsQuicSendBufferPool _pool;
+        private QUIC_HANDLE* _handle;
+        private GCHandle _self;
+
+        public QUIC_HANDLE* Handle => _handle;
+
+        /// <summary>Opens a new local stream on the connection.</summary>
+        protected MsQuicStream(QUIC_API_TABLE* api, QUIC_HANDLE* connection, QUIC_STREAM_OPEN_FLAGS flags, MsQuicSendBufferPool pool)
+        {
+            _api = api;
+            _pool = pool;
+            _self = GCHandle.Alloc(this);
+            QUIC_HANDLE* handle = null;
+            int status = api->StreamOpen(connection, flags, &NativeCallback, (void*)GCHandle.ToIntPtr(_self), &handle);
+            if (MsQuic.StatusFailed(status))
+            {
+                _self.Free();
+                MsQuic.ThrowIfFailure(status, "StreamOpen failed");
+            }
+            _handle = handle;
+        }
+
+        /// <summary>
+        /// Takes over a stream started by the peer. Must be called from the
+        /// PEER_STREAM_STARTED connection event.
+        /// </summary>
+        protected MsQuicStream(QUIC_API_TABLE* api, QUIC_HANDLE* stream, MsQuicSendBufferPool pool)
+        {
+            _api = api;
+            _pool = pool;
+            _self = GCHandle.Alloc(this);
+            _handle = stream;
+            api->SetStreamCallback(stream, &NativeCallback, (void*)GCHandle.ToIntPtr(_self));
+        }
+
+        public void Start(QUIC_STREAM_START_FLAGS flags = QUIC_STREAM_START_FLAGS.NONE)
+        {
+            MsQuic.ThrowIfFailure(_api->StreamStart(_handle, flags), "StreamStart failed");
+        }
+
+        /// <summary>
+        /// Queues a copy of <paramref name="data"/> for sending. Data larger
+        /// than the pool's block size is split over several sends, with FIN
+        /// (if requested) only on the last one.
+        /// </summary>
+        public void Send(ReadOnlySpan<byte> data, QUIC_SEND_FLAGS flags = QUIC_SEND_FLAGS.NONE)
+        {
+            do
+            {
+                int length = Math.Min(data.Length, _pool.BlockSize);
+                MsQuicSendBufferPool.Block* block = _pool.Rent();
+                data.Slice(0, length).CopyTo(new Span<byte>(block->Buffer.Buffer, length));
+                block->Buffer.Length = (uint)length;
+                data = data.Slice(length);
+
+                QUIC_SEND_FLAGS sendFlags = data.IsEmpty ? flags : flags & ~QUIC_SEND_FLAGS.FIN;
+                int status = _api->StreamSend(_handle, &block->Buffer, 1, sendFlags, block);
+                if (MsQuic.StatusFailed(status))
+                {
+                    _pool.Return(block);
+                    MsQuic.ThrowIfFailure(status, "StreamSend failed");
+                }
+            } while (!data.IsEmpty);
+        }
+
+        public void Shutdown(QUIC_STREAM_SHUTDOWN_FLAGS flags, ulong errorCode = 0)
+        {
+            MsQuic.ThrowIfFailure(_api->StreamShutdown(_handle, flags, errorCode), "StreamShutdown failed");
+        }
+
+        /// <summary>
+        /// Called for each received buffer. The span is only valid for the
+        /// duration of the call.
+        /// </summary>
+        protected abstract void OnReceive(ReadOnlySpan<byte> data);
+
+        protected virtual void OnStartComplete(int status) { }
+
+        protected virtual void OnSendComplete(bool canceled) { }
+
+        protected virtual void OnPeerSendShutdown() { }
+
+        protected virtual void OnPeerSendAborted(ulong errorCode) { }
+
+        protected virtual void OnShutdownComplete(bool connectionShutdown) { }
+
+        public void Dispose()
+        {
+            if (_handle != null)
+            {
+                // Aborts the stream if it is still open. Outstanding sends
+                // complete, returning their blocks, before this returns.
+                _api->StreamClose(_handle);
+                _handle = null;
+                _self.Free();
+            }
+        }
+
+        private int HandleEvent(QUIC_STREAM_EVENT* evnt)
+        {
+            switch (evnt->Type)
+            {
+                case QUIC_STREAM_EVENT_TYPE.START_COMPLETE:
+                    OnStartComplete(evnt->START_COMPLETE.Status);
+                    break;
+                case QUIC_STREAM_EVENT_TYPE.RECEIVE:
+                    for (uint i = 0; i < evnt->RECEIVE.BufferCount; i++)
+                    {
+                        OnReceive(evnt->RECEIVE.Buffers[i].Span);
+                    }
+                    break;
+                case QUIC_STREAM_EVENT_TYPE.SEND_COMPLETE:
+                    _pool.Return((MsQuicSendBufferPool.Block*)evnt->SEND_COMPLETE.ClientContext);
+                    OnSendComplete(evnt->SEND_COMPLETE.Canceled != 0);
+                    break;
+                case QUIC_STREAM_EVENT_TYPE.PEER_SEND_SHUTDOWN:
+                    OnPeerSendShutdown();
+                    break;
+                case QUIC_STREAM_EVENT_TYPE.PEER_SEND_ABORTED:
+                    OnPeerSendAborted(evnt->PEER_SEND_ABORTED.ErrorCode);
+                    break;
+                case QUIC_STREAM_EVENT_TYPE.SHUTDOWN_COMPLETE:
+                    OnShutdownComplete(evnt->SHUTDOWN_COMPLETE.ConnectionShutdown != 0);
+                    break;
+            }
+            return MsQuic.QUIC_STATUS_SUCCESS;
+        }
+
+        [UnmanagedCallersOnly(CallConvs = new Type[] { typeof(CallConvCdecl) })]
+        private static int NativeCallback(QUIC_HANDLE* handle, void* context, QUIC_STREAM_EVENT* evnt)
+        {
+            var stream = (MsQuicStream)GCHandle.FromIntPtr((IntPtr)context).Target!;
+            try
+            {
+                return stream.HandleEvent(evnt);
+            }
+            catch (Exception)
+            {
+                // Exceptions must not cross back into native code.
+                return MsQuic.QUIC_STATUS_INTERNAL_ERROR;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,23 @@
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "anti-replay filter",
+                BitsLength);
+// arg2 = arg2 = "anti-replay filter" = arg2
+// arg3 = arg3 = BitsLength = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_ANTI_REPLAY_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
@@ -112,19 +112,23 @@ tracepoint(CLOG_API_C, AllocFailure , arg2, arg3);\
 
 
 /*----------------------------------------------------------
-// Decoder Ring for StreamError
-// [strm][%p] ERROR, %s.
+// Decoder Ring for StreamAppSend
+// [strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]
 // QuicTraceEvent(
-            StreamError,
-            "[strm][%p] ERROR, %s.",
-            Stream,
-            "Send request total length exceeds max");
+        StreamAppSend,
+        "[strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]",
+        Stream,
+        SendRequest->TotalLength,
+        SendRequest->BufferCount,
+        SendRequest->Flags);
 // arg2 = arg2 = Stream = arg2
-// arg3 = arg3 = "Send request total length exceeds max" = arg3
+// arg3 = arg3 = SendRequest->TotalLength = arg3
+// arg4 = arg4 = SendRequest->BufferCount = arg4
+// arg5 = arg5 = SendRequest->Flags = arg5
 ----------------------------------------------------------*/
-#ifndef _clog_4_ARGS_TRACE_StreamError
-#define _clog_4_ARGS_TRACE_StreamError(uniqueId, encoded_arg_string, arg2, arg3)\
-tracepoint(CLOG_API_C, StreamError , arg2, arg3);\
+#ifndef _clog_6_ARGS_TRACE_StreamAppSend
+#define _clog_6_ARGS_TRACE_StreamAppSend(uniqueId, encoded_arg_string, arg2, arg3, arg4, arg5)\
+tracepoint(CLOG_API_C, StreamAppSend , arg2, arg3, arg4, arg5);\
 
 #endif
 
@@ -132,23 +136,19 @@ tracepoint(CLOG_API_C, StreamError , arg2, arg3);\
 
 
 /*----------------------------------------------------------
-// Decoder Ring for StreamAppSend
-// [strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]
+// Decoder Ring for StreamError
+// [strm][%p] ERROR, %s.
 // QuicTraceEvent(
-        StreamAppSend,
-        "[strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]",
-        Stream,
-        TotalLength,
-        BufferCount,
-        Flags);
+            StreamError,
+            "[strm][%p] ERROR, %s.",
+            Stream,
+            "Send request total length exceeds max");
 // arg2 = arg2 = Stream = arg2
-// arg3 = arg3 = TotalLength = arg3
-// arg4 = arg4 = BufferCount = arg4
-// arg5 = arg5 = Flags = arg5
+// arg3 = arg3 = "Send request total length exceeds max" = arg3
 ----------------------------------------------------------*/
-#ifndef _clog_6_ARGS_TRACE_StreamAppSend
-#define _clog_6_ARGS_TRACE_StreamAppSend(uniqueId, encoded_arg_string, arg2, arg3, arg4, arg5)\
-tracepoint(CLOG_API_C, StreamAppSend , arg2, arg3, arg4, arg5);\
+#ifndef _clog_4_ARGS_TRACE_StreamError
+#define _clog_4_ARGS_TRACE_StreamError(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_API_C, StreamError , arg2, arg3);\
 
 #endif
 
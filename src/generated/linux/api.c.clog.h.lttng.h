@@ -99,54 +99,54 @@ TRACEPOINT_EVENT(CLOG_API_C, AllocFailure,
 
 
 /*----------------------------------------------------------
-// Decoder Ring for StreamError
-// [strm][%p] ERROR, %s.
+// Decoder Ring for StreamAppSend
+// [strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]
 // QuicTraceEvent(
-            StreamError,
-            "[strm][%p] ERROR, %s.",
-            Stream,
-            "Send request total length exceeds max");
+        StreamAppSend,
+        "[strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]",
+        Stream,
+        SendRequest->TotalLength,
+        SendRequest->BufferCount,
+        SendRequest->Flags);
 // arg2 = arg2 = Stream = arg2
-// arg3 = arg3 = "Send request total length exceeds max" = arg3
+// arg3 = arg3 = SendRequest->TotalLength = arg3
+// arg4 = arg4 = SendRequest->BufferCount = arg4
+// arg5 = arg5 = SendRequest->Flags = arg5
 ----------------------------------------------------------*/
-TRACEPOINT_EVENT(CLOG_API_C, StreamError,
+TRACEPOINT_EVENT(CLOG_API_C, StreamAppSend,
     TP_ARGS(
         const void *, arg2,
-        const char *, arg3), 
+        unsigned long long, arg3,
+        unsigned int, arg4,
+        unsigned int, arg5), 
     TP_FIELDS(
         ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
-        ctf_string(arg3, arg3)
+        ctf_integer(uint64_t, arg3, arg3)
+        ctf_integer(unsigned int, arg4, arg4)
+        ctf_integer(unsigned int, arg5, arg5)
     )
 )
 
 
 
 /*----------------------------------------------------------
-// Decoder Ring for StreamAppSend
-// [strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]
+// Decoder Ring for StreamError
+// [strm][%p] ERROR, %s.
 // QuicTraceEvent(
-        StreamAppSend,
-        "[strm][%p] App queuing send [%llu bytes, %u buffers, 0x%x flags]",
-        Stream,
-        TotalLength,
-        BufferCount,
-        Flags);
+            StreamError,
+            "[strm][%p] ERROR, %s.",
+            Stream,
+            "Send request total length exceeds max");
 // arg2 = arg2 = Stream = arg2
-// arg3 = arg3 = TotalLength = arg3
-// arg4 = arg4 = BufferCount = arg4
-// arg5 = arg5 = Flags = arg5
+// arg3 = arg3 = "Send request total length exceeds max" = arg3
 ----------------------------------------------------------*/
-TRACEPOINT_EVENT(CLOG_API_C, StreamAppSend,
+TRACEPOINT_EVENT(CLOG_API_C, StreamError,
     TP_ARGS(
         const void *, arg2,
-        unsigned long long, arg3,
-        unsigned int, arg4,
-        unsigned int, arg5), 
+        const char *, arg3), 
     TP_FIELDS(
         ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
-        ctf_integer(uint64_t, arg3, arg3)
-        ctf_integer(unsigned int, arg4, arg4)
-        ctf_integer(unsigned int, arg5, arg5)
+        ctf_string(arg3, arg3)
     )
 )
 
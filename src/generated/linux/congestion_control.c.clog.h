@@ -41,6 +41,24 @@ tracepoint(CLOG_CONGESTION_CONTROL_C, InvalidCongestionControlAlgorithm , arg1,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for CustomCongestionControlMissing
+// [conn][%p] No custom congestion control provided, fallback to Cubic
+// QuicTraceLogConnWarning(
+                CustomCongestionControlMissing,
+                QuicCongestionControlGetConnection(Cc),
+                "No custom congestion control provided, fallback to Cubic");
+// arg1 = arg1 = QuicCongestionControlGetConnection(Cc) = arg1
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_CustomCongestionControlMissing
+#define _clog_3_ARGS_TRACE_CustomCongestionControlMissing(uniqueId, arg1, encoded_arg_string)\
+tracepoint(CLOG_CONGESTION_CONTROL_C, CustomCongestionControlMissing , arg1);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,9 +81,9 @@ tracepoint(CLOG_CONNECTION_C, PacketRxVersionNegVer , arg2, arg3);\
 // Decoder Ring for PacketRxStatelessReset
 // [S][RX][-] SR %s
 // QuicTraceLogVerbose(
-                            PacketRxStatelessReset,
-                            "[S][RX][-] SR %s",
-                            QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
+                    PacketRxStatelessReset,
+                    "[S][RX][-] SR %s",
+                    QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
 // arg2 = arg2 = QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer = arg2
 ----------------------------------------------------------*/
 #ifndef _clog_3_ARGS_TRACE_PacketRxStatelessReset
@@ -526,6 +526,28 @@ tracepoint(CLOG_CONNECTION_C, Restart , arg1, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for PathActive
+// [conn][%p] Path[%hhu] Set active (rebind=%hhu)
+// QuicTraceLogConnInfo(
+        PathActive,
+        Connection,
+        "Path[%hhu] Set active (rebind=%hhu)",
+        Connection->Paths[0].ID,
+        FALSE);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Connection->Paths[0].ID = arg3
+// arg4 = arg4 = FALSE = arg4
+----------------------------------------------------------*/
+#ifndef _clog_5_ARGS_TRACE_PathActive
+#define _clog_5_ARGS_TRACE_PathActive(uniqueId, arg1, encoded_arg_string, arg3, arg4)\
+tracepoint(CLOG_CONNECTION_C, PathActive , arg1, arg3, arg4);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for CryptoStateDiscard
 // [conn][%p] TLS state no longer needed
@@ -582,26 +604,6 @@ tracepoint(CLOG_CONNECTION_C, PeerTPSet , arg1);\
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for PeerPreferredAddress
-// [conn][%p] Peer configured preferred address %!ADDR!
-// QuicTraceLogConnInfo(
-                PeerPreferredAddress,
-                Connection,
-                "Peer configured preferred address %!ADDR!",
-                CASTED_CLOG_BYTEARRAY(sizeof(Connection->PeerTransportParams.PreferredAddress), &Connection->PeerTransportParams.PreferredAddress));
-// arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = CASTED_CLOG_BYTEARRAY(sizeof(Connection->PeerTransportParams.PreferredAddress), &Connection->PeerTransportParams.PreferredAddress) = arg3
-----------------------------------------------------------*/
-#ifndef _clog_5_ARGS_TRACE_PeerPreferredAddress
-#define _clog_5_ARGS_TRACE_PeerPreferredAddress(uniqueId, arg1, encoded_arg_string, arg3, arg3_len)\
-tracepoint(CLOG_CONNECTION_C, PeerPreferredAddress , arg1, arg3_len, arg3);\
-
-#endif
-
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for NegotiatedDisable1RttEncryption
 // [conn][%p] Negotiated Disable 1-RTT Encryption
@@ -642,9 +644,9 @@ tracepoint(CLOG_CONNECTION_C, CustomCertValidationPending , arg1);\
 // Decoder Ring for RecvStatelessReset
 // [conn][%p] Received stateless reset
 // QuicTraceLogConnInfo(
-                            RecvStatelessReset,
-                            Connection,
-                            "Received stateless reset");
+                    RecvStatelessReset,
+                    Connection,
+                    "Received stateless reset");
 // arg1 = arg1 = Connection = arg1
 ----------------------------------------------------------*/
 #ifndef _clog_3_ARGS_TRACE_RecvStatelessReset
@@ -894,6 +896,26 @@ tracepoint(CLOG_CONNECTION_C, ConnDscpSet , arg1, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for ConnAckOnlyDscpSet
+// [conn][%p] Connection ACK-only DSCP set to %hhu
+// QuicTraceLogConnInfo(
+            ConnAckOnlyDscpSet,
+            Connection,
+            "Connection ACK-only DSCP set to %hhu",
+            Connection->AckOnlyDSCP);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Connection->AckOnlyDSCP = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_ConnAckOnlyDscpSet
+#define _clog_4_ARGS_TRACE_ConnAckOnlyDscpSet(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CONNECTION_C, ConnAckOnlyDscpSet , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ApplySettings
 // [conn][%p] Applying new settings
@@ -1215,6 +1237,26 @@ tracepoint(CLOG_CONNECTION_C, IndicatePeerCertificateReceived , arg1, arg3, arg4
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for RecvDatagramsInline
+// [conn][%p] Processing %u UDP datagrams inline
+// QuicTraceLogConnVerbose(
+        RecvDatagramsInline,
+        Connection,
+        "Processing %u UDP datagrams inline",
+        PacketChainLength);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = PacketChainLength = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_RecvDatagramsInline
+#define _clog_4_ARGS_TRACE_RecvDatagramsInline(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CONNECTION_C, RecvDatagramsInline , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for QueueDatagrams
 // [conn][%p] Queuing %u UDP datagrams
@@ -1441,9 +1483,9 @@ tracepoint(CLOG_CONNECTION_C, UdpRecvDeferred , arg1, arg3);\
             DatagramReceiveEnableUpdated,
             Connection,
             "Updated datagram receive enabled to %hhu",
-            Connection->Settings.DatagramReceiveEnabled);
+            Connection->Settings->DatagramReceiveEnabled);
 // arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = Connection->Settings.DatagramReceiveEnabled = arg3
+// arg3 = arg3 = Connection->Settings->DatagramReceiveEnabled = arg3
 ----------------------------------------------------------*/
 #ifndef _clog_4_ARGS_TRACE_DatagramReceiveEnableUpdated
 #define _clog_4_ARGS_TRACE_DatagramReceiveEnableUpdated(uniqueId, arg1, encoded_arg_string, arg3)\
@@ -1494,6 +1536,66 @@ tracepoint(CLOG_CONNECTION_C, CloseAsyncUpdated , arg1, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for CustomCongestionControlSet
+// [conn][%p] Custom congestion control %s
+// QuicTraceLogConnVerbose(
+            CustomCongestionControlSet,
+            Connection,
+            "Custom congestion control %s",
+            Custom->Callbacks != NULL ? "set" : "cleared");
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Custom->Callbacks != NULL ? "set" : "cleared" = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_CustomCongestionControlSet
+#define _clog_4_ARGS_TRACE_CustomCongestionControlSet(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CONNECTION_C, CustomCongestionControlSet , arg1, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SendRateLimitSet
+// [conn][%p] Send rate limit set to %llu bytes/s
+// QuicTraceLogConnVerbose(
+            SendRateLimitSet,
+            Connection,
+            "Send rate limit set to %llu bytes/s",
+            Connection->SendRateLimit.Rate);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Connection->SendRateLimit.Rate = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_SendRateLimitSet
+#define _clog_4_ARGS_TRACE_SendRateLimitSet(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CONNECTION_C, SendRateLimitSet , arg1, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for PeerStreamTemplateSet
+// [conn][%p] Peer stream template %s
+// QuicTraceLogConnVerbose(
+            PeerStreamTemplateSet,
+            Connection,
+            "Peer stream template %s",
+            Template->Handler != NULL ? "set" : "cleared");
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Template->Handler != NULL ? "set" : "cleared" = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_PeerStreamTemplateSet
+#define _clog_4_ARGS_TRACE_PeerStreamTemplateSet(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CONNECTION_C, PeerStreamTemplateSet , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ForceKeyUpdate
 // [conn][%p] Forcing key update
@@ -2099,24 +2201,6 @@ tracepoint(CLOG_CONNECTION_C, ConnHandshakeStart , arg2);\
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for PacketDecrypt
-// [pack][%llu] Decrypting
-// QuicTraceEvent(
-            PacketDecrypt,
-            "[pack][%llu] Decrypting",
-            Packet->PacketId);
-// arg2 = arg2 = Packet->PacketId = arg2
-----------------------------------------------------------*/
-#ifndef _clog_3_ARGS_TRACE_PacketDecrypt
-#define _clog_3_ARGS_TRACE_PacketDecrypt(uniqueId, encoded_arg_string, arg2)\
-tracepoint(CLOG_CONNECTION_C, PacketDecrypt , arg2);\
-
-#endif
-
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for ConnPacketRecv
 // [conn][%p][RX][%llu] %c (%hu bytes)
@@ -2141,6 +2225,24 @@ tracepoint(CLOG_CONNECTION_C, ConnPacketRecv , arg2, arg3, arg4, arg5);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for PacketDecrypt
+// [pack][%llu] Decrypting
+// QuicTraceEvent(
+            PacketDecrypt,
+            "[pack][%llu] Decrypting",
+            Packet->PacketId);
+// arg2 = arg2 = Packet->PacketId = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_PacketDecrypt
+#define _clog_3_ARGS_TRACE_PacketDecrypt(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_CONNECTION_C, PacketDecrypt , arg2);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConnDelayCloseApplicationError
 // [conn][%p] Received APPLICATION_ERROR error, delaying close in expectation of a 1-RTT CONNECTION_CLOSE frame.
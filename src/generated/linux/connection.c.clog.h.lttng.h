@@ -44,9 +44,9 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, PacketRxVersionNegVer,
 // Decoder Ring for PacketRxStatelessReset
 // [S][RX][-] SR %s
 // QuicTraceLogVerbose(
-                            PacketRxStatelessReset,
-                            "[S][RX][-] SR %s",
-                            QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
+                    PacketRxStatelessReset,
+                    "[S][RX][-] SR %s",
+                    QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
 // arg2 = arg2 = QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer = arg2
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_CONNECTION_C, PacketRxStatelessReset,
@@ -546,6 +546,33 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, Restart,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for PathActive
+// [conn][%p] Path[%hhu] Set active (rebind=%hhu)
+// QuicTraceLogConnInfo(
+        PathActive,
+        Connection,
+        "Path[%hhu] Set active (rebind=%hhu)",
+        Connection->Paths[0].ID,
+        FALSE);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Connection->Paths[0].ID = arg3
+// arg4 = arg4 = FALSE = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, PathActive,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned char, arg3,
+        unsigned char, arg4), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned char, arg3, arg3)
+        ctf_integer(unsigned char, arg4, arg4)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for CryptoStateDiscard
 // [conn][%p] TLS state no longer needed
@@ -607,31 +634,6 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, PeerTPSet,
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for PeerPreferredAddress
-// [conn][%p] Peer configured preferred address %!ADDR!
-// QuicTraceLogConnInfo(
-                PeerPreferredAddress,
-                Connection,
-                "Peer configured preferred address %!ADDR!",
-                CASTED_CLOG_BYTEARRAY(sizeof(Connection->PeerTransportParams.PreferredAddress), &Connection->PeerTransportParams.PreferredAddress));
-// arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = CASTED_CLOG_BYTEARRAY(sizeof(Connection->PeerTransportParams.PreferredAddress), &Connection->PeerTransportParams.PreferredAddress) = arg3
-----------------------------------------------------------*/
-TRACEPOINT_EVENT(CLOG_CONNECTION_C, PeerPreferredAddress,
-    TP_ARGS(
-        const void *, arg1,
-        unsigned int, arg3_len,
-        const void *, arg3), 
-    TP_FIELDS(
-        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
-        ctf_integer(unsigned int, arg3_len, arg3_len)
-        ctf_sequence(char, arg3, arg3, unsigned int, arg3_len)
-    )
-)
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for NegotiatedDisable1RttEncryption
 // [conn][%p] Negotiated Disable 1-RTT Encryption
@@ -674,9 +676,9 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, CustomCertValidationPending,
 // Decoder Ring for RecvStatelessReset
 // [conn][%p] Received stateless reset
 // QuicTraceLogConnInfo(
-                            RecvStatelessReset,
-                            Connection,
-                            "Received stateless reset");
+                    RecvStatelessReset,
+                    Connection,
+                    "Received stateless reset");
 // arg1 = arg1 = Connection = arg1
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_CONNECTION_C, RecvStatelessReset,
@@ -961,6 +963,29 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, ConnDscpSet,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for ConnAckOnlyDscpSet
+// [conn][%p] Connection ACK-only DSCP set to %hhu
+// QuicTraceLogConnInfo(
+            ConnAckOnlyDscpSet,
+            Connection,
+            "Connection ACK-only DSCP set to %hhu",
+            Connection->AckOnlyDSCP);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Connection->AckOnlyDSCP = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, ConnAckOnlyDscpSet,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned char, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned char, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ApplySettings
 // [conn][%p] Applying new settings
@@ -1334,6 +1359,29 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, IndicatePeerCertificateReceived,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for RecvDatagramsInline
+// [conn][%p] Processing %u UDP datagrams inline
+// QuicTraceLogConnVerbose(
+        RecvDatagramsInline,
+        Connection,
+        "Processing %u UDP datagrams inline",
+        PacketChainLength);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = PacketChainLength = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, RecvDatagramsInline,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned int, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned int, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for QueueDatagrams
 // [conn][%p] Queuing %u UDP datagrams
@@ -1591,9 +1639,9 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, UdpRecvDeferred,
             DatagramReceiveEnableUpdated,
             Connection,
             "Updated datagram receive enabled to %hhu",
-            Connection->Settings.DatagramReceiveEnabled);
+            Connection->Settings->DatagramReceiveEnabled);
 // arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = Connection->Settings.DatagramReceiveEnabled = arg3
+// arg3 = arg3 = Connection->Settings->DatagramReceiveEnabled = arg3
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_CONNECTION_C, DatagramReceiveEnableUpdated,
     TP_ARGS(
@@ -1653,6 +1701,75 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, CloseAsyncUpdated,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for CustomCongestionControlSet
+// [conn][%p] Custom congestion control %s
+// QuicTraceLogConnVerbose(
+            CustomCongestionControlSet,
+            Connection,
+            "Custom congestion control %s",
+            Custom->Callbacks != NULL ? "set" : "cleared");
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Custom->Callbacks != NULL ? "set" : "cleared" = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, CustomCongestionControlSet,
+    TP_ARGS(
+        const void *, arg1,
+        const char *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_string(arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SendRateLimitSet
+// [conn][%p] Send rate limit set to %llu bytes/s
+// QuicTraceLogConnVerbose(
+            SendRateLimitSet,
+            Connection,
+            "Send rate limit set to %llu bytes/s",
+            Connection->SendRateLimit.Rate);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Connection->SendRateLimit.Rate = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, SendRateLimitSet,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for PeerStreamTemplateSet
+// [conn][%p] Peer stream template %s
+// QuicTraceLogConnVerbose(
+            PeerStreamTemplateSet,
+            Connection,
+            "Peer stream template %s",
+            Template->Handler != NULL ? "set" : "cleared");
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Template->Handler != NULL ? "set" : "cleared" = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, PeerStreamTemplateSet,
+    TP_ARGS(
+        const void *, arg1,
+        const char *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_string(arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ForceKeyUpdate
 // [conn][%p] Forcing key update
@@ -2364,25 +2481,6 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, ConnHandshakeStart,
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for PacketDecrypt
-// [pack][%llu] Decrypting
-// QuicTraceEvent(
-            PacketDecrypt,
-            "[pack][%llu] Decrypting",
-            Packet->PacketId);
-// arg2 = arg2 = Packet->PacketId = arg2
-----------------------------------------------------------*/
-TRACEPOINT_EVENT(CLOG_CONNECTION_C, PacketDecrypt,
-    TP_ARGS(
-        unsigned long long, arg2), 
-    TP_FIELDS(
-        ctf_integer(uint64_t, arg2, arg2)
-    )
-)
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for ConnPacketRecv
 // [conn][%p][RX][%llu] %c (%hu bytes)
@@ -2414,6 +2512,25 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, ConnPacketRecv,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for PacketDecrypt
+// [pack][%llu] Decrypting
+// QuicTraceEvent(
+            PacketDecrypt,
+            "[pack][%llu] Decrypting",
+            Packet->PacketId);
+// arg2 = arg2 = Packet->PacketId = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_C, PacketDecrypt,
+    TP_ARGS(
+        unsigned long long, arg2), 
+    TP_FIELDS(
+        ctf_integer(uint64_t, arg2, arg2)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConnDelayCloseApplicationError
 // [conn][%p] Received APPLICATION_ERROR error, delaying close in expectation of a 1-RTT CONNECTION_CLOSE frame.
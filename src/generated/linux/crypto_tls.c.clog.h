@@ -619,6 +619,66 @@ tracepoint(CLOG_CRYPTO_TLS_C, EncodeTPTimestamp , arg1, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for EncodeTPInitialMaxPathId
+// [conn][%p] TP: Initial Max Path ID (%llu)
+// QuicTraceLogConnVerbose(
+            EncodeTPInitialMaxPathId,
+            Connection,
+            "TP: Initial Max Path ID (%llu)",
+            TransportParams->InitialMaxPathId);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->InitialMaxPathId = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_EncodeTPInitialMaxPathId
+#define _clog_4_ARGS_TRACE_EncodeTPInitialMaxPathId(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CRYPTO_TLS_C, EncodeTPInitialMaxPathId , arg1, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for EncodeTPMaxReceiveTimestampsPerAck
+// [conn][%p] TP: Max Receive Timestamps Per ACK (%llu)
+// QuicTraceLogConnVerbose(
+            EncodeTPMaxReceiveTimestampsPerAck,
+            Connection,
+            "TP: Max Receive Timestamps Per ACK (%llu)",
+            TransportParams->MaxReceiveTimestampsPerAck);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->MaxReceiveTimestampsPerAck = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_EncodeTPMaxReceiveTimestampsPerAck
+#define _clog_4_ARGS_TRACE_EncodeTPMaxReceiveTimestampsPerAck(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CRYPTO_TLS_C, EncodeTPMaxReceiveTimestampsPerAck , arg1, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for EncodeTPReceiveTimestampsExponent
+// [conn][%p] TP: Receive Timestamps Exponent (%llu)
+// QuicTraceLogConnVerbose(
+            EncodeTPReceiveTimestampsExponent,
+            Connection,
+            "TP: Receive Timestamps Exponent (%llu)",
+            TransportParams->ReceiveTimestampsExponent);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->ReceiveTimestampsExponent = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_EncodeTPReceiveTimestampsExponent
+#define _clog_4_ARGS_TRACE_EncodeTPReceiveTimestampsExponent(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CRYPTO_TLS_C, EncodeTPReceiveTimestampsExponent , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for EncodeTPTest
 // [conn][%p] TP: TEST TP (Type %hu, Length %hu)
@@ -1171,6 +1231,66 @@ tracepoint(CLOG_CRYPTO_TLS_C, DecodeTPReliableReset , arg1);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for DecodeTPInitialMaxPathId
+// [conn][%p] TP: Initial Max Path ID (%llu)
+// QuicTraceLogConnVerbose(
+                DecodeTPInitialMaxPathId,
+                Connection,
+                "TP: Initial Max Path ID (%llu)",
+                TransportParams->InitialMaxPathId);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->InitialMaxPathId = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_DecodeTPInitialMaxPathId
+#define _clog_4_ARGS_TRACE_DecodeTPInitialMaxPathId(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CRYPTO_TLS_C, DecodeTPInitialMaxPathId , arg1, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for DecodeTPMaxReceiveTimestampsPerAck
+// [conn][%p] TP: Max Receive Timestamps Per ACK (%llu)
+// QuicTraceLogConnVerbose(
+                DecodeTPMaxReceiveTimestampsPerAck,
+                Connection,
+                "TP: Max Receive Timestamps Per ACK (%llu)",
+                TransportParams->MaxReceiveTimestampsPerAck);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->MaxReceiveTimestampsPerAck = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_DecodeTPMaxReceiveTimestampsPerAck
+#define _clog_4_ARGS_TRACE_DecodeTPMaxReceiveTimestampsPerAck(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CRYPTO_TLS_C, DecodeTPMaxReceiveTimestampsPerAck , arg1, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for DecodeTPReceiveTimestampsExponent
+// [conn][%p] TP: Receive Timestamps Exponent (%llu)
+// QuicTraceLogConnVerbose(
+                DecodeTPReceiveTimestampsExponent,
+                Connection,
+                "TP: Receive Timestamps Exponent (%llu)",
+                TransportParams->ReceiveTimestampsExponent);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->ReceiveTimestampsExponent = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_DecodeTPReceiveTimestampsExponent
+#define _clog_4_ARGS_TRACE_DecodeTPReceiveTimestampsExponent(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_CRYPTO_TLS_C, DecodeTPReceiveTimestampsExponent , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConnError
 // [conn][%p] ERROR, %s.
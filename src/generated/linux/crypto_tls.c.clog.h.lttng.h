@@ -672,6 +672,75 @@ TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, EncodeTPTimestamp,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for EncodeTPInitialMaxPathId
+// [conn][%p] TP: Initial Max Path ID (%llu)
+// QuicTraceLogConnVerbose(
+            EncodeTPInitialMaxPathId,
+            Connection,
+            "TP: Initial Max Path ID (%llu)",
+            TransportParams->InitialMaxPathId);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->InitialMaxPathId = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, EncodeTPInitialMaxPathId,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for EncodeTPMaxReceiveTimestampsPerAck
+// [conn][%p] TP: Max Receive Timestamps Per ACK (%llu)
+// QuicTraceLogConnVerbose(
+            EncodeTPMaxReceiveTimestampsPerAck,
+            Connection,
+            "TP: Max Receive Timestamps Per ACK (%llu)",
+            TransportParams->MaxReceiveTimestampsPerAck);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->MaxReceiveTimestampsPerAck = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, EncodeTPMaxReceiveTimestampsPerAck,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for EncodeTPReceiveTimestampsExponent
+// [conn][%p] TP: Receive Timestamps Exponent (%llu)
+// QuicTraceLogConnVerbose(
+            EncodeTPReceiveTimestampsExponent,
+            Connection,
+            "TP: Receive Timestamps Exponent (%llu)",
+            TransportParams->ReceiveTimestampsExponent);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->ReceiveTimestampsExponent = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, EncodeTPReceiveTimestampsExponent,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for EncodeTPTest
 // [conn][%p] TP: TEST TP (Type %hu, Length %hu)
@@ -1301,6 +1370,75 @@ TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, DecodeTPReliableReset,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for DecodeTPInitialMaxPathId
+// [conn][%p] TP: Initial Max Path ID (%llu)
+// QuicTraceLogConnVerbose(
+                DecodeTPInitialMaxPathId,
+                Connection,
+                "TP: Initial Max Path ID (%llu)",
+                TransportParams->InitialMaxPathId);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->InitialMaxPathId = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, DecodeTPInitialMaxPathId,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for DecodeTPMaxReceiveTimestampsPerAck
+// [conn][%p] TP: Max Receive Timestamps Per ACK (%llu)
+// QuicTraceLogConnVerbose(
+                DecodeTPMaxReceiveTimestampsPerAck,
+                Connection,
+                "TP: Max Receive Timestamps Per ACK (%llu)",
+                TransportParams->MaxReceiveTimestampsPerAck);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->MaxReceiveTimestampsPerAck = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, DecodeTPMaxReceiveTimestampsPerAck,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for DecodeTPReceiveTimestampsExponent
+// [conn][%p] TP: Receive Timestamps Exponent (%llu)
+// QuicTraceLogConnVerbose(
+                DecodeTPReceiveTimestampsExponent,
+                Connection,
+                "TP: Receive Timestamps Exponent (%llu)",
+                TransportParams->ReceiveTimestampsExponent);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = TransportParams->ReceiveTimestampsExponent = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CRYPTO_TLS_C, DecodeTPReceiveTimestampsExponent,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConnError
 // [conn][%p] ERROR, %s.
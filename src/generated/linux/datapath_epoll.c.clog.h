@@ -119,6 +119,24 @@ tracepoint(CLOG_DATAPATH_EPOLL_C, EpollProcessorContextQueuedForDestruction , ar
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryError
+// [ lib] ERROR, %s.
+// QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "CxPlatPoolReserve failed");
+// arg2 = arg2 = "CxPlatPoolReserve failed" = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_LibraryError
+#define _clog_3_ARGS_TRACE_LibraryError(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_DATAPATH_EPOLL_C, LibraryError , arg2);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for AllocFailure
 // Allocation of '%s' failed. (%llu bytes)
@@ -143,14 +161,14 @@ tracepoint(CLOG_DATAPATH_EPOLL_C, AllocFailure , arg2, arg3);\
 // Decoder Ring for DatapathErrorStatus
 // [data][%p] ERROR, %u, %s.
 // QuicTraceEvent(
-            DatapathErrorStatus,
-            "[data][%p] ERROR, %u, %s.",
-            Binding,
-            Status,
-            "CxPlatSqeInitialize failed");
-// arg2 = arg2 = Binding = arg2
-// arg3 = arg3 = Status = arg3
-// arg4 = arg4 = "CxPlatSqeInitialize failed" = arg4
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                Datapath,
+                errno,
+                "ioctl(EPIOCSPARAMS) failed");
+// arg2 = arg2 = Datapath = arg2
+// arg3 = arg3 = errno = arg3
+// arg4 = arg4 = "ioctl(EPIOCSPARAMS) failed" = arg4
 ----------------------------------------------------------*/
 #ifndef _clog_5_ARGS_TRACE_DatapathErrorStatus
 #define _clog_5_ARGS_TRACE_DatapathErrorStatus(uniqueId, encoded_arg_string, arg2, arg3, arg4)\
@@ -255,24 +273,6 @@ tracepoint(CLOG_DATAPATH_EPOLL_C, DatapathSend , arg2, arg3, arg4, arg5, arg6_le
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for LibraryError
-// [ lib] ERROR, %s.
-// QuicTraceEvent(
-                    LibraryError,
-                    "[ lib] ERROR, %s.",
-                    "Disabling segmentation support globally");
-// arg2 = arg2 = "Disabling segmentation support globally" = arg2
-----------------------------------------------------------*/
-#ifndef _clog_3_ARGS_TRACE_LibraryError
-#define _clog_3_ARGS_TRACE_LibraryError(uniqueId, encoded_arg_string, arg2)\
-tracepoint(CLOG_DATAPATH_EPOLL_C, LibraryError , arg2);\
-
-#endif
-
-
-
-
 #ifdef __cplusplus
 }
 #endif
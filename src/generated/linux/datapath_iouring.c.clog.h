@@ -85,6 +85,24 @@ tracepoint(CLOG_DATAPATH_IOURING_C, DatapathErrorStatus , arg2, arg3, arg4);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryError
+// [ lib] ERROR, %s.
+// QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "CxPlatPoolReserve failed");
+// arg2 = arg2 = "CxPlatPoolReserve failed" = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_LibraryError
+#define _clog_3_ARGS_TRACE_LibraryError(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_DATAPATH_IOURING_C, LibraryError , arg2);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for DatapathCreated
 // [data][%p] Created, local=%!ADDR!, remote=%!ADDR!
@@ -179,24 +197,6 @@ tracepoint(CLOG_DATAPATH_IOURING_C, DatapathSend , arg2, arg3, arg4, arg5, arg6_
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for LibraryError
-// [ lib] ERROR, %s.
-// QuicTraceEvent(
-                    LibraryError,
-                    "[ lib] ERROR, %s.",
-                    "Disabling segmentation support globally");
-// arg2 = arg2 = "Disabling segmentation support globally" = arg2
-----------------------------------------------------------*/
-#ifndef _clog_3_ARGS_TRACE_LibraryError
-#define _clog_3_ARGS_TRACE_LibraryError(uniqueId, encoded_arg_string, arg2)\
-tracepoint(CLOG_DATAPATH_IOURING_C, LibraryError , arg2);\
-
-#endif
-
-
-
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,77 @@
+#ifndef CLOG_DO_NOT_INCLUDE_HEADER
+#include <clog.h>
+#endif
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER CLOG_DATAPATH_LOOPBACK_C
+#undef TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#define  TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "datapath_loopback.c.clog.h.lttng.h"
+#if !defined(DEF_CLOG_DATAPATH_LOOPBACK_C) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define DEF_CLOG_DATAPATH_LOOPBACK_C
+#include <lttng/tracepoint.h>
+#define __int64 __int64_t
+#include "datapath_loopback.c.clog.h.lttng.h"
+#endif
+#include <lttng/tracepoint-event.h>
+#ifndef _clog_MACRO_QuicTraceLogInfo
+#define _clog_MACRO_QuicTraceLogInfo  1
+#define QuicTraceLogInfo(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifndef _clog_MACRO_QuicTraceEvent
+#define _clog_MACRO_QuicTraceEvent  1
+#define QuicTraceEvent(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*----------------------------------------------------------
+// Decoder Ring for LoopbackDatapathInit
+// [loop][%p] Loopback datapath initialized, delay:%u us, loss:%u ppm, rate:%llu bps
+// QuicTraceLogInfo(
+        LoopbackDatapathInit,
+        "[loop][%p] Loopback datapath initialized, delay:%u us, loss:%u ppm, rate:%llu bps",
+        Loopback,
+        Config->DelayUs,
+        Config->LossRate,
+        Config->Bandwidth);
+// arg2 = arg2 = Loopback = arg2
+// arg3 = arg3 = Config->DelayUs = arg3
+// arg4 = arg4 = Config->LossRate = arg4
+// arg5 = arg5 = Config->Bandwidth = arg5
+----------------------------------------------------------*/
+#ifndef _clog_6_ARGS_TRACE_LoopbackDatapathInit
+#define _clog_6_ARGS_TRACE_LoopbackDatapathInit(uniqueId, encoded_arg_string, arg2, arg3, arg4, arg5)\
+tracepoint(CLOG_DATAPATH_LOOPBACK_C, LoopbackDatapathInit , arg2, arg3, arg4, arg5);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_DATAPATH_LOOPBACK",
+            DatapathSize);
+// arg2 = arg2 = "CXPLAT_DATAPATH_LOOPBACK" = arg2
+// arg3 = arg3 = DatapathSize = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_DATAPATH_LOOPBACK_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+#ifdef CLOG_INLINE_IMPLEMENTATION
+#include "quic.clog_datapath_loopback.c.clog.h.c"
+#endif
@@ -0,0 +1,54 @@
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LoopbackDatapathInit
+// [loop][%p] Loopback datapath initialized, delay:%u us, loss:%u ppm, rate:%llu bps
+// QuicTraceLogInfo(
+        LoopbackDatapathInit,
+        "[loop][%p] Loopback datapath initialized, delay:%u us, loss:%u ppm, rate:%llu bps",
+        Loopback,
+        Config->DelayUs,
+        Config->LossRate,
+        Config->Bandwidth);
+// arg2 = arg2 = Loopback = arg2
+// arg3 = arg3 = Config->DelayUs = arg3
+// arg4 = arg4 = Config->LossRate = arg4
+// arg5 = arg5 = Config->Bandwidth = arg5
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_DATAPATH_LOOPBACK_C, LoopbackDatapathInit,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned int, arg3,
+        unsigned int, arg4,
+        unsigned long long, arg5), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned int, arg3, arg3)
+        ctf_integer(unsigned int, arg4, arg4)
+        ctf_integer(uint64_t, arg5, arg5)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_DATAPATH_LOOPBACK",
+            DatapathSize);
+// arg2 = arg2 = "CXPLAT_DATAPATH_LOOPBACK" = arg2
+// arg3 = arg3 = DatapathSize = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_DATAPATH_LOOPBACK_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
@@ -137,8 +137,8 @@ tracepoint(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpAllocUmem );\
 // Decoder Ring for XdpUmemAllocFails
 // [ xdp][umem] Out of UMEM frame, OOM
 // QuicTraceLogVerbose(
-            XdpUmemAllocFails,
-            "[ xdp][umem] Out of UMEM frame, OOM");
+                XdpUmemAllocFails,
+                "[ xdp][umem] Out of UMEM frame, OOM");
 ----------------------------------------------------------*/
 #ifndef _clog_2_ARGS_TRACE_XdpUmemAllocFails
 #define _clog_2_ARGS_TRACE_XdpUmemAllocFails(uniqueId, encoded_arg_string)\
@@ -149,6 +149,24 @@ tracepoint(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpUmemAllocFails );\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for FailXskSocketCreate
+// [ xdp] Failed to create XDP socket for %s. error:%s
+// QuicTraceLogVerbose(
+            FailXskSocketCreate,
+            "[ xdp] Failed to create XDP socket for %s. error:%s", Interface->IfName, strerror(-Ret));
+// arg2 = arg2 = Interface->IfName = arg2
+// arg3 = arg3 = strerror(-Ret) = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_FailXskSocketCreate
+#define _clog_4_ARGS_TRACE_FailXskSocketCreate(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_DATAPATH_RAW_XDP_LINUX_C, FailXskSocketCreate , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for XdpAttachFails
 // [ xdp] Failed to attach XDP program to %s. error:%s
@@ -245,8 +263,8 @@ tracepoint(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpNoXsksMap );\
 // Decoder Ring for XdpConfigureUmem
 // [ xdp] Failed to configure Umem
 // QuicTraceLogVerbose(
-                XdpConfigureUmem,
-                "[ xdp] Failed to configure Umem");
+                    XdpConfigureUmem,
+                    "[ xdp] Failed to configure Umem");
 ----------------------------------------------------------*/
 #ifndef _clog_2_ARGS_TRACE_XdpConfigureUmem
 #define _clog_2_ARGS_TRACE_XdpConfigureUmem(uniqueId, encoded_arg_string)\
@@ -257,24 +275,6 @@ tracepoint(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpConfigureUmem );\
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for FailXskSocketCreate
-// [ xdp] Failed to create XDP socket for %s. error:%s
-// QuicTraceLogVerbose(
-                FailXskSocketCreate,
-                "[ xdp] Failed to create XDP socket for %s. error:%s", Interface->IfName, strerror(-Ret));
-// arg2 = arg2 = Interface->IfName = arg2
-// arg3 = arg3 = strerror(-Ret) = arg3
-----------------------------------------------------------*/
-#ifndef _clog_4_ARGS_TRACE_FailXskSocketCreate
-#define _clog_4_ARGS_TRACE_FailXskSocketCreate(uniqueId, encoded_arg_string, arg2, arg3)\
-tracepoint(CLOG_DATAPATH_RAW_XDP_LINUX_C, FailXskSocketCreate , arg2, arg3);\
-
-#endif
-
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for FailRxAlloc
 // [ xdp][rx  ] OOM for Rx
@@ -121,8 +121,8 @@ TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpAllocUmem,
 // Decoder Ring for XdpUmemAllocFails
 // [ xdp][umem] Out of UMEM frame, OOM
 // QuicTraceLogVerbose(
-            XdpUmemAllocFails,
-            "[ xdp][umem] Out of UMEM frame, OOM");
+                XdpUmemAllocFails,
+                "[ xdp][umem] Out of UMEM frame, OOM");
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpUmemAllocFails,
     TP_ARGS(
@@ -133,6 +133,27 @@ TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpUmemAllocFails,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for FailXskSocketCreate
+// [ xdp] Failed to create XDP socket for %s. error:%s
+// QuicTraceLogVerbose(
+            FailXskSocketCreate,
+            "[ xdp] Failed to create XDP socket for %s. error:%s", Interface->IfName, strerror(-Ret));
+// arg2 = arg2 = Interface->IfName = arg2
+// arg3 = arg3 = strerror(-Ret) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, FailXskSocketCreate,
+    TP_ARGS(
+        const char *, arg2,
+        const char *, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_string(arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for XdpAttachFails
 // [ xdp] Failed to attach XDP program to %s. error:%s
@@ -241,8 +262,8 @@ TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpNoXsksMap,
 // Decoder Ring for XdpConfigureUmem
 // [ xdp] Failed to configure Umem
 // QuicTraceLogVerbose(
-                XdpConfigureUmem,
-                "[ xdp] Failed to configure Umem");
+                    XdpConfigureUmem,
+                    "[ xdp] Failed to configure Umem");
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpConfigureUmem,
     TP_ARGS(
@@ -253,27 +274,6 @@ TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, XdpConfigureUmem,
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for FailXskSocketCreate
-// [ xdp] Failed to create XDP socket for %s. error:%s
-// QuicTraceLogVerbose(
-                FailXskSocketCreate,
-                "[ xdp] Failed to create XDP socket for %s. error:%s", Interface->IfName, strerror(-Ret));
-// arg2 = arg2 = Interface->IfName = arg2
-// arg3 = arg3 = strerror(-Ret) = arg3
-----------------------------------------------------------*/
-TRACEPOINT_EVENT(CLOG_DATAPATH_RAW_XDP_LINUX_C, FailXskSocketCreate,
-    TP_ARGS(
-        const char *, arg2,
-        const char *, arg3), 
-    TP_FIELDS(
-        ctf_string(arg2, arg2)
-        ctf_string(arg3, arg3)
-    )
-)
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for FailRxAlloc
 // [ xdp][rx  ] OOM for Rx
@@ -38,6 +38,23 @@ tracepoint(CLOG_DATAPATH_XPLAT_C, DatapathInitFail , arg2);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LoopbackDatapathInitFail
+// [  dp] Failed to initialize loopback datapath, status:%d
+// QuicTraceLogVerbose(
+                LoopbackDatapathInitFail,
+                "[  dp] Failed to initialize loopback datapath, status:%d", Status);
+// arg2 = arg2 = Status = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_LoopbackDatapathInitFail
+#define _clog_3_ARGS_TRACE_LoopbackDatapathInitFail(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_DATAPATH_XPLAT_C, LoopbackDatapathInitFail , arg2);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for SockCreateFail
 // [sock] Failed to create socket, status:%d
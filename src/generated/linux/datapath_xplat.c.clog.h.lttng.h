@@ -19,6 +19,24 @@ TRACEPOINT_EVENT(CLOG_DATAPATH_XPLAT_C, DatapathInitFail,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LoopbackDatapathInitFail
+// [  dp] Failed to initialize loopback datapath, status:%d
+// QuicTraceLogVerbose(
+                LoopbackDatapathInitFail,
+                "[  dp] Failed to initialize loopback datapath, status:%d", Status);
+// arg2 = arg2 = Status = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_DATAPATH_XPLAT_C, LoopbackDatapathInitFail,
+    TP_ARGS(
+        int, arg2), 
+    TP_FIELDS(
+        ctf_integer(int, arg2, arg2)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for SockCreateFail
 // [sock] Failed to create socket, status:%d
@@ -265,6 +265,50 @@ tracepoint(CLOG_FRAME_C, FrameLogAckEcn , arg2, arg3, arg4, arg5, arg6, arg7);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for FrameLogAckReceiveTimestampsInvalid
+// [%c][%cX][%llu]     Timestamps [Invalid]
+// QuicTraceLogVerbose(
+                    FrameLogAckReceiveTimestampsInvalid,
+                    "[%c][%cX][%llu]     Timestamps [Invalid]",
+                    PtkConnPre(Connection),
+                    PktRxPre(Rx),
+                    PacketNumber);
+// arg2 = arg2 = PtkConnPre(Connection) = arg2
+// arg3 = arg3 = PktRxPre(Rx) = arg3
+// arg4 = arg4 = PacketNumber = arg4
+----------------------------------------------------------*/
+#ifndef _clog_5_ARGS_TRACE_FrameLogAckReceiveTimestampsInvalid
+#define _clog_5_ARGS_TRACE_FrameLogAckReceiveTimestampsInvalid(uniqueId, encoded_arg_string, arg2, arg3, arg4)\
+tracepoint(CLOG_FRAME_C, FrameLogAckReceiveTimestampsInvalid , arg2, arg3, arg4);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for FrameLogAckReceiveTimestamps
+// [%c][%cX][%llu]     Timestamps
+// QuicTraceLogVerbose(
+                FrameLogAckReceiveTimestamps,
+                "[%c][%cX][%llu]     Timestamps",
+                PtkConnPre(Connection),
+                PktRxPre(Rx),
+                PacketNumber);
+// arg2 = arg2 = PtkConnPre(Connection) = arg2
+// arg3 = arg3 = PktRxPre(Rx) = arg3
+// arg4 = arg4 = PacketNumber = arg4
+----------------------------------------------------------*/
+#ifndef _clog_5_ARGS_TRACE_FrameLogAckReceiveTimestamps
+#define _clog_5_ARGS_TRACE_FrameLogAckReceiveTimestamps(uniqueId, encoded_arg_string, arg2, arg3, arg4)\
+tracepoint(CLOG_FRAME_C, FrameLogAckReceiveTimestamps , arg2, arg3, arg4);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for FrameLogResetStreamInvalid
 // [%c][%cX][%llu]   RESET_STREAM [Invalid]
@@ -311,6 +311,60 @@ TRACEPOINT_EVENT(CLOG_FRAME_C, FrameLogAckEcn,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for FrameLogAckReceiveTimestampsInvalid
+// [%c][%cX][%llu]     Timestamps [Invalid]
+// QuicTraceLogVerbose(
+                    FrameLogAckReceiveTimestampsInvalid,
+                    "[%c][%cX][%llu]     Timestamps [Invalid]",
+                    PtkConnPre(Connection),
+                    PktRxPre(Rx),
+                    PacketNumber);
+// arg2 = arg2 = PtkConnPre(Connection) = arg2
+// arg3 = arg3 = PktRxPre(Rx) = arg3
+// arg4 = arg4 = PacketNumber = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_FRAME_C, FrameLogAckReceiveTimestampsInvalid,
+    TP_ARGS(
+        unsigned char, arg2,
+        unsigned char, arg3,
+        unsigned long long, arg4), 
+    TP_FIELDS(
+        ctf_integer(unsigned char, arg2, arg2)
+        ctf_integer(unsigned char, arg3, arg3)
+        ctf_integer(uint64_t, arg4, arg4)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for FrameLogAckReceiveTimestamps
+// [%c][%cX][%llu]     Timestamps
+// QuicTraceLogVerbose(
+                FrameLogAckReceiveTimestamps,
+                "[%c][%cX][%llu]     Timestamps",
+                PtkConnPre(Connection),
+                PktRxPre(Rx),
+                PacketNumber);
+// arg2 = arg2 = PtkConnPre(Connection) = arg2
+// arg3 = arg3 = PktRxPre(Rx) = arg3
+// arg4 = arg4 = PacketNumber = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_FRAME_C, FrameLogAckReceiveTimestamps,
+    TP_ARGS(
+        unsigned char, arg2,
+        unsigned char, arg3,
+        unsigned long long, arg4), 
+    TP_FIELDS(
+        ctf_integer(unsigned char, arg2, arg2)
+        ctf_integer(unsigned char, arg3, arg3)
+        ctf_integer(uint64_t, arg4, arg4)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for FrameLogResetStreamInvalid
 // [%c][%cX][%llu]   RESET_STREAM [Invalid]
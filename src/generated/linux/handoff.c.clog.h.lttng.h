@@ -0,0 +1,204 @@
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for IndicateConnected
+// [conn][%p] Indicating QUIC_CONNECTION_EVENT_CONNECTED (Resume=%hhu)
+// QuicTraceLogConnVerbose(
+        IndicateConnected,
+        Connection,
+        "Indicating QUIC_CONNECTION_EVENT_CONNECTED (Resume=%hhu)",
+        Event.CONNECTED.SessionResumed);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Event.CONNECTED.SessionResumed = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, IndicateConnected,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned char, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned char, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "handoff state",
+            sizeof(QUIC_CONN_HANDOFF_STATE));
+// arg2 = arg2 = "handoff state" = arg2
+// arg3 = arg3 = sizeof(QUIC_CONN_HANDOFF_STATE) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnError
+// [conn][%p] ERROR, %s.
+// QuicTraceEvent(
+        ConnError,
+        "[conn][%p] ERROR, %s.",
+        Connection,
+        "Invalid handoff state");
+// arg2 = arg2 = Connection = arg2
+// arg3 = arg3 = "Invalid handoff state" = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, ConnError,
+    TP_ARGS(
+        const void *, arg2,
+        const char *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_string(arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnErrorStatus
+// [conn][%p] ERROR, %u, %s.
+// QuicTraceEvent(
+            ConnErrorStatus,
+            "[conn][%p] ERROR, %u, %s.",
+            Connection,
+            Status,
+            "Get binding");
+// arg2 = arg2 = Connection = arg2
+// arg3 = arg3 = Status = arg3
+// arg4 = arg4 = "Get binding" = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, ConnErrorStatus,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned int, arg3,
+        const char *, arg4), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned int, arg3, arg3)
+        ctf_string(arg4, arg4)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnSourceCidAdded
+// [conn][%p] (SeqNum=%llu) New Source CID: %!CID!
+// QuicTraceEvent(
+            ConnSourceCidAdded,
+            "[conn][%p] (SeqNum=%llu) New Source CID: %!CID!",
+            Connection,
+            SourceCid->CID.SequenceNumber,
+            CASTED_CLOG_BYTEARRAY(SourceCid->CID.Length, SourceCid->CID.Data));
+// arg2 = arg2 = Connection = arg2
+// arg3 = arg3 = SourceCid->CID.SequenceNumber = arg3
+// arg4 = arg4 = CASTED_CLOG_BYTEARRAY(SourceCid->CID.Length, SourceCid->CID.Data) = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, ConnSourceCidAdded,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned long long, arg3,
+        unsigned int, arg4_len,
+        const void *, arg4), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+        ctf_integer(unsigned int, arg4_len, arg4_len)
+        ctf_sequence(char, arg4, arg4, unsigned int, arg4_len)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnDestCidAdded
+// [conn][%p] (SeqNum=%llu) New Destination CID: %!CID!
+// QuicTraceEvent(
+            ConnDestCidAdded,
+            "[conn][%p] (SeqNum=%llu) New Destination CID: %!CID!",
+            Connection,
+            DestCid->CID.SequenceNumber,
+            CASTED_CLOG_BYTEARRAY(DestCid->CID.Length, DestCid->CID.Data));
+// arg2 = arg2 = Connection = arg2
+// arg3 = arg3 = DestCid->CID.SequenceNumber = arg3
+// arg4 = arg4 = CASTED_CLOG_BYTEARRAY(DestCid->CID.Length, DestCid->CID.Data) = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, ConnDestCidAdded,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned long long, arg3,
+        unsigned int, arg4_len,
+        const void *, arg4), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+        ctf_integer(unsigned int, arg4_len, arg4_len)
+        ctf_sequence(char, arg4, arg4, unsigned int, arg4_len)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnLocalAddrAdded
+// [conn][%p] New Local IP: %!ADDR!
+// QuicTraceEvent(
+        ConnLocalAddrAdded,
+        "[conn][%p] New Local IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.LocalAddress), &Path->Route.LocalAddress));
+// arg2 = arg2 = Connection = arg2
+// arg3 = arg3 = CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.LocalAddress), &Path->Route.LocalAddress) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, ConnLocalAddrAdded,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned int, arg3_len,
+        const void *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned int, arg3_len, arg3_len)
+        ctf_sequence(char, arg3, arg3, unsigned int, arg3_len)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnRemoteAddrAdded
+// [conn][%p] New Remote IP: %!ADDR!
+// QuicTraceEvent(
+        ConnRemoteAddrAdded,
+        "[conn][%p] New Remote IP: %!ADDR!",
+        Connection,
+        CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.RemoteAddress), &Path->Route.RemoteAddress));
+// arg2 = arg2 = Connection = arg2
+// arg3 = arg3 = CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.RemoteAddress), &Path->Route.RemoteAddress) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_HANDOFF_C, ConnRemoteAddrAdded,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned int, arg3_len,
+        const void *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned int, arg3_len, arg3_len)
+        ctf_sequence(char, arg3, arg3, unsigned int, arg3_len)
+    )
+)
@@ -139,6 +139,24 @@ tracepoint(CLOG_LIBRARY_C, LibraryCidLengthSet , arg2);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryRssPartitioningSet
+// [ lib] Updated RSS partitioning interface = %u
+// QuicTraceLogInfo(
+        LibraryRssPartitioningSet,
+        "[ lib] Updated RSS partitioning interface = %u",
+        InterfaceIndex);
+// arg2 = arg2 = InterfaceIndex = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_LibraryRssPartitioningSet
+#define _clog_3_ARGS_TRACE_LibraryRssPartitioningSet(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_LIBRARY_C, LibraryRssPartitioningSet , arg2);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryRetryMemoryLimitSet
 // [ lib] Updated retry memory limit = %hu
@@ -276,6 +294,26 @@ tracepoint(CLOG_LIBRARY_C, LibraryRetryKeyUpdated , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryQuicLbConfigUpdated
+// [ lib] QUIC-LB config updated. ID: %hhu, Encrypted: %hhu
+// QuicTraceLogInfo(
+        LibraryQuicLbConfigUpdated,
+        "[ lib] QUIC-LB config updated. ID: %hhu, Encrypted: %hhu",
+        Config->ConfigId,
+        Config->Encrypted);
+// arg2 = arg2 = Config->ConfigId = arg2
+// arg3 = arg3 = Config->Encrypted = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_LibraryQuicLbConfigUpdated
+#define _clog_4_ARGS_TRACE_LibraryQuicLbConfigUpdated(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_LIBRARY_C, LibraryQuicLbConfigUpdated , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryMsQuicOpenVersionNull
 // [ api] MsQuicOpenVersion, NULL
@@ -430,6 +468,44 @@ tracepoint(CLOG_LIBRARY_C, LibrarySetRetryKeySecretLengthInvalid , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibrarySetQuicLbConfigInvalid
+// [ lib] Invalid QUIC-LB config: ID %hhu, server ID length %hhu, nonce length %hhu.
+// QuicTraceLogError(
+            LibrarySetQuicLbConfigInvalid,
+            "[ lib] Invalid QUIC-LB config: ID %hhu, server ID length %hhu, nonce length %hhu.",
+            Config->ConfigId,
+            Config->ServerIdLength,
+            Config->NonceLength);
+// arg2 = arg2 = Config->ConfigId = arg2
+// arg3 = arg3 = Config->ServerIdLength = arg3
+// arg4 = arg4 = Config->NonceLength = arg4
+----------------------------------------------------------*/
+#ifndef _clog_5_ARGS_TRACE_LibrarySetQuicLbConfigInvalid
+#define _clog_5_ARGS_TRACE_LibrarySetQuicLbConfigInvalid(uniqueId, encoded_arg_string, arg2, arg3, arg4)\
+tracepoint(CLOG_LIBRARY_C, LibrarySetQuicLbConfigInvalid , arg2, arg3, arg4);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryQuicLbLengthSetAfterInUse
+// [ lib] Tried to change QUIC-LB encoded length after library in use!
+// QuicTraceLogError(
+                LibraryQuicLbLengthSetAfterInUse,
+                "[ lib] Tried to change QUIC-LB encoded length after library in use!");
+----------------------------------------------------------*/
+#ifndef _clog_2_ARGS_TRACE_LibraryQuicLbLengthSetAfterInUse
+#define _clog_2_ARGS_TRACE_LibraryQuicLbLengthSetAfterInUse(uniqueId, encoded_arg_string)\
+tracepoint(CLOG_LIBRARY_C, LibraryQuicLbLengthSetAfterInUse );\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for AllocFailure
 // Allocation of '%s' failed. (%llu bytes)
@@ -524,6 +600,26 @@ tracepoint(CLOG_LIBRARY_C, LibraryUninitialized );\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryErrorStatus
+// [ lib] ERROR, %u, %s.
+// QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "CxPlatThreadCreate (handshake)");
+// arg2 = arg2 = Status = arg2
+// arg3 = arg3 = "CxPlatThreadCreate (handshake)" = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_LibraryErrorStatus
+#define _clog_4_ARGS_TRACE_LibraryErrorStatus(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_LIBRARY_C, LibraryErrorStatus , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryAddRef
 // [ lib] AddRef
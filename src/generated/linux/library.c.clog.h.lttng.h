@@ -106,6 +106,25 @@ TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryCidLengthSet,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryRssPartitioningSet
+// [ lib] Updated RSS partitioning interface = %u
+// QuicTraceLogInfo(
+        LibraryRssPartitioningSet,
+        "[ lib] Updated RSS partitioning interface = %u",
+        InterfaceIndex);
+// arg2 = arg2 = InterfaceIndex = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryRssPartitioningSet,
+    TP_ARGS(
+        unsigned int, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryRetryMemoryLimitSet
 // [ lib] Updated retry memory limit = %hu
@@ -249,6 +268,29 @@ TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryRetryKeyUpdated,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryQuicLbConfigUpdated
+// [ lib] QUIC-LB config updated. ID: %hhu, Encrypted: %hhu
+// QuicTraceLogInfo(
+        LibraryQuicLbConfigUpdated,
+        "[ lib] QUIC-LB config updated. ID: %hhu, Encrypted: %hhu",
+        Config->ConfigId,
+        Config->Encrypted);
+// arg2 = arg2 = Config->ConfigId = arg2
+// arg3 = arg3 = Config->Encrypted = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryQuicLbConfigUpdated,
+    TP_ARGS(
+        unsigned char, arg2,
+        unsigned char, arg3), 
+    TP_FIELDS(
+        ctf_integer(unsigned char, arg2, arg2)
+        ctf_integer(unsigned char, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryMsQuicOpenVersionNull
 // [ api] MsQuicOpenVersion, NULL
@@ -409,6 +451,49 @@ TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibrarySetRetryKeySecretLengthInvalid,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibrarySetQuicLbConfigInvalid
+// [ lib] Invalid QUIC-LB config: ID %hhu, server ID length %hhu, nonce length %hhu.
+// QuicTraceLogError(
+            LibrarySetQuicLbConfigInvalid,
+            "[ lib] Invalid QUIC-LB config: ID %hhu, server ID length %hhu, nonce length %hhu.",
+            Config->ConfigId,
+            Config->ServerIdLength,
+            Config->NonceLength);
+// arg2 = arg2 = Config->ConfigId = arg2
+// arg3 = arg3 = Config->ServerIdLength = arg3
+// arg4 = arg4 = Config->NonceLength = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibrarySetQuicLbConfigInvalid,
+    TP_ARGS(
+        unsigned char, arg2,
+        unsigned char, arg3,
+        unsigned char, arg4), 
+    TP_FIELDS(
+        ctf_integer(unsigned char, arg2, arg2)
+        ctf_integer(unsigned char, arg3, arg3)
+        ctf_integer(unsigned char, arg4, arg4)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryQuicLbLengthSetAfterInUse
+// [ lib] Tried to change QUIC-LB encoded length after library in use!
+// QuicTraceLogError(
+                LibraryQuicLbLengthSetAfterInUse,
+                "[ lib] Tried to change QUIC-LB encoded length after library in use!");
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryQuicLbLengthSetAfterInUse,
+    TP_ARGS(
+), 
+    TP_FIELDS(
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for AllocFailure
 // Allocation of '%s' failed. (%llu bytes)
@@ -516,6 +601,29 @@ TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryUninitialized,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for LibraryErrorStatus
+// [ lib] ERROR, %u, %s.
+// QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "CxPlatThreadCreate (handshake)");
+// arg2 = arg2 = Status = arg2
+// arg3 = arg3 = "CxPlatThreadCreate (handshake)" = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LIBRARY_C, LibraryErrorStatus,
+    TP_ARGS(
+        unsigned int, arg2,
+        const char *, arg3), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+        ctf_string(arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryAddRef
 // [ lib] AddRef
@@ -22,6 +22,10 @@
 #define _clog_MACRO_QuicTraceLogConnInfo  1
 #define QuicTraceLogConnInfo(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
 #endif
+#ifndef _clog_MACRO_QuicTraceLogConnVerbose
+#define _clog_MACRO_QuicTraceLogConnVerbose  1
+#define QuicTraceLogConnVerbose(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
 #ifndef _clog_MACRO_QuicTraceEvent
 #define _clog_MACRO_QuicTraceEvent  1
 #define QuicTraceEvent(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
@@ -47,6 +51,26 @@ tracepoint(CLOG_LISTENER_C, ListenerIndicateStopComplete , arg2);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for ListenerSniConfigsSet
+// [list][%p] SNI configurations set (count %u)
+// QuicTraceLogVerbose(
+        ListenerSniConfigsSet,
+        "[list][%p] SNI configurations set (count %u)",
+        Listener,
+        Count);
+// arg2 = arg2 = Listener = arg2
+// arg3 = arg3 = Count = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_ListenerSniConfigsSet
+#define _clog_4_ARGS_TRACE_ListenerSniConfigsSet(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_LISTENER_C, ListenerSniConfigsSet , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ListenerIndicateNewConnection
 // [list][%p] Indicating NEW_CONNECTION %p
@@ -131,6 +155,26 @@ tracepoint(CLOG_LISTENER_C, CibirIdSet , arg1, arg3, arg4);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for SniConfigurationSelected
+// [conn][%p] Configuration %p selected by server name
+// QuicTraceLogConnVerbose(
+                SniConfigurationSelected,
+                Connection,
+                "Configuration %p selected by server name",
+                Configuration);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Configuration = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_SniConfigurationSelected
+#define _clog_4_ARGS_TRACE_SniConfigurationSelected(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_LISTENER_C, SniConfigurationSelected , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ApiEnter
 // [ api] Enter %u (%p).
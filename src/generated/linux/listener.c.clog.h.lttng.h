@@ -20,6 +20,29 @@ TRACEPOINT_EVENT(CLOG_LISTENER_C, ListenerIndicateStopComplete,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for ListenerSniConfigsSet
+// [list][%p] SNI configurations set (count %u)
+// QuicTraceLogVerbose(
+        ListenerSniConfigsSet,
+        "[list][%p] SNI configurations set (count %u)",
+        Listener,
+        Count);
+// arg2 = arg2 = Listener = arg2
+// arg3 = arg3 = Count = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LISTENER_C, ListenerSniConfigsSet,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned int, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned int, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ListenerIndicateNewConnection
 // [list][%p] Indicating NEW_CONNECTION %p
@@ -120,6 +143,29 @@ TRACEPOINT_EVENT(CLOG_LISTENER_C, CibirIdSet,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for SniConfigurationSelected
+// [conn][%p] Configuration %p selected by server name
+// QuicTraceLogConnVerbose(
+                SniConfigurationSelected,
+                Connection,
+                "Configuration %p selected by server name",
+                Configuration);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Configuration = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LISTENER_C, SniConfigurationSelected,
+    TP_ARGS(
+        const void *, arg1,
+        const void *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer_hex(uint64_t, arg3, (uint64_t)arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ApiEnter
 // [ api] Enter %u (%p).
@@ -175,3 +175,26 @@ TRACEPOINT_EVENT(CLOG_LOOKUP_C, LookupCidRemoved,
         ctf_integer_hex(uint64_t, arg3, (uint64_t)arg3)
     )
 )
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "CID slots",
+                sizeof(QUIC_CID_SLOTS) + NewSlotCount * sizeof(QUIC_CID_HASH_ENTRY*));
+// arg2 = arg2 = "CID slots" = arg2
+// arg3 = arg3 = sizeof(QUIC_CID_SLOTS) + NewSlotCount * sizeof(QUIC_CID_HASH_ENTRY*) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_LOOKUP_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
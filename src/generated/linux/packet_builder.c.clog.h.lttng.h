@@ -181,9 +181,9 @@ TRACEPOINT_EVENT(CLOG_PACKET_BUILDER_C, PacketEncrypt,
 // Decoder Ring for PacketFinalize
 // [pack][%llu] Finalizing
 // QuicTraceEvent(
-            PacketFinalize,
-            "[pack][%llu] Finalizing",
-            Builder->Metadata->PacketId);
+                PacketFinalize,
+                "[pack][%llu] Finalizing",
+                Builder->Metadata->PacketId);
 // arg2 = arg2 = Builder->Metadata->PacketId = arg2
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_PACKET_BUILDER_C, PacketFinalize,
@@ -5,12 +5,12 @@
 // Decoder Ring for LibraryErrorStatus
 // [ lib] ERROR, %u, %s.
 // QuicTraceEvent(
-            LibraryErrorStatus,
-            "[ lib] ERROR, %u, %s.",
-            Status,
-            "Create stateless retry key");
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                Status,
+                "CxPlatPoolReserve");
 // arg2 = arg2 = Status = arg2
-// arg3 = arg3 = "Create stateless retry key" = arg3
+// arg3 = arg3 = "CxPlatPoolReserve" = arg3
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_PARTITION_C, LibraryErrorStatus,
     TP_ARGS(
@@ -21,3 +21,26 @@ TRACEPOINT_EVENT(CLOG_PARTITION_C, LibraryErrorStatus,
         ctf_string(arg3, arg3)
     )
 )
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "ticket cache",
+            EntriesSize);
+// arg2 = arg2 = "ticket cache" = arg2
+// arg3 = arg3 = EntriesSize = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_PARTITION_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
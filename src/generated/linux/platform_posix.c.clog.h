@@ -111,6 +111,26 @@ tracepoint(CLOG_PLATFORM_POSIX_C, PosixUninitialized );\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CxPlatProcessorDefaultList",
+            Count * sizeof(uint16_t));
+// arg2 = arg2 = "CxPlatProcessorDefaultList" = arg2
+// arg3 = arg3 = Count * sizeof(uint16_t) = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_PLATFORM_POSIX_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryErrorStatus
 // [ lib] ERROR, %u, %s.
@@ -149,26 +169,6 @@ tracepoint(CLOG_PLATFORM_POSIX_C, LibraryError , arg2);\
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for AllocFailure
-// Allocation of '%s' failed. (%llu bytes)
-// QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)",
-            "Custom thread context",
-            sizeof(CXPLAT_THREAD_CUSTOM_CONTEXT));
-// arg2 = arg2 = "Custom thread context" = arg2
-// arg3 = arg3 = sizeof(CXPLAT_THREAD_CUSTOM_CONTEXT) = arg3
-----------------------------------------------------------*/
-#ifndef _clog_4_ARGS_TRACE_AllocFailure
-#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
-tracepoint(CLOG_PLATFORM_POSIX_C, AllocFailure , arg2, arg3);\
-
-#endif
-
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for LibraryAssert
 // [ lib] ASSERT, %u:%s - %s.
@@ -84,6 +84,29 @@ TRACEPOINT_EVENT(CLOG_PLATFORM_POSIX_C, PosixUninitialized,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CxPlatProcessorDefaultList",
+            Count * sizeof(uint16_t));
+// arg2 = arg2 = "CxPlatProcessorDefaultList" = arg2
+// arg3 = arg3 = Count * sizeof(uint16_t) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_PLATFORM_POSIX_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for LibraryErrorStatus
 // [ lib] ERROR, %u, %s.
@@ -126,29 +149,6 @@ TRACEPOINT_EVENT(CLOG_PLATFORM_POSIX_C, LibraryError,
 
 
 
-/*----------------------------------------------------------
-// Decoder Ring for AllocFailure
-// Allocation of '%s' failed. (%llu bytes)
-// QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)",
-            "Custom thread context",
-            sizeof(CXPLAT_THREAD_CUSTOM_CONTEXT));
-// arg2 = arg2 = "Custom thread context" = arg2
-// arg3 = arg3 = sizeof(CXPLAT_THREAD_CUSTOM_CONTEXT) = arg3
-----------------------------------------------------------*/
-TRACEPOINT_EVENT(CLOG_PLATFORM_POSIX_C, AllocFailure,
-    TP_ARGS(
-        const char *, arg2,
-        unsigned long long, arg3), 
-    TP_FIELDS(
-        ctf_string(arg2, arg2)
-        ctf_integer(uint64_t, arg3, arg3)
-    )
-)
-
-
-
 /*----------------------------------------------------------
 // Decoder Ring for LibraryAssert
 // [ lib] ASSERT, %u:%s - %s.
@@ -0,0 +1,85 @@
+#ifndef CLOG_DO_NOT_INCLUDE_HEADER
+#include <clog.h>
+#endif
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER CLOG_RECV_CAPTURE_C
+#undef TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#define  TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "recv_capture.c.clog.h.lttng.h"
+#if !defined(DEF_CLOG_RECV_CAPTURE_C) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define DEF_CLOG_RECV_CAPTURE_C
+#include <lttng/tracepoint.h>
+#define __int64 __int64_t
+#include "recv_capture.c.clog.h.lttng.h"
+#endif
+#include <lttng/tracepoint-event.h>
+#ifndef _clog_MACRO_QuicTraceLogInfo
+#define _clog_MACRO_QuicTraceLogInfo  1
+#define QuicTraceLogInfo(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifndef _clog_MACRO_QuicTraceEvent
+#define _clog_MACRO_QuicTraceEvent  1
+#define QuicTraceEvent(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*----------------------------------------------------------
+// Decoder Ring for LibraryRecvCaptureSet
+// [ lib] Receive capture %s
+// QuicTraceLogInfo(
+        LibraryRecvCaptureSet,
+        "[ lib] Receive capture %s",
+        File != NULL ? "started" : "stopped");
+// arg2 = arg2 = File != NULL ? "started" : "stopped" = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_LibraryRecvCaptureSet
+#define _clog_3_ARGS_TRACE_LibraryRecvCaptureSet(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_RECV_CAPTURE_C, LibraryRecvCaptureSet , arg2);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryRecvCaptureFull
+// [ lib] Receive capture stopped at its size limit
+// QuicTraceLogInfo(
+                LibraryRecvCaptureFull,
+                "[ lib] Receive capture stopped at its size limit");
+----------------------------------------------------------*/
+#ifndef _clog_2_ARGS_TRACE_LibraryRecvCaptureFull
+#define _clog_2_ARGS_TRACE_LibraryRecvCaptureFull(uniqueId, encoded_arg_string)\
+tracepoint(CLOG_RECV_CAPTURE_C, LibraryRecvCaptureFull );\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryError
+// [ lib] ERROR, %s.
+// QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "Failed to open receive capture file");
+// arg2 = arg2 = "Failed to open receive capture file" = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_LibraryError
+#define _clog_3_ARGS_TRACE_LibraryError(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_RECV_CAPTURE_C, LibraryError , arg2);\
+
+#endif
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+#ifdef CLOG_INLINE_IMPLEMENTATION
+#include "quic.clog_recv_capture.c.clog.h.c"
+#endif
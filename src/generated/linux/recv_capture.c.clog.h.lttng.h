@@ -0,0 +1,54 @@
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryRecvCaptureSet
+// [ lib] Receive capture %s
+// QuicTraceLogInfo(
+        LibraryRecvCaptureSet,
+        "[ lib] Receive capture %s",
+        File != NULL ? "started" : "stopped");
+// arg2 = arg2 = File != NULL ? "started" : "stopped" = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_RECV_CAPTURE_C, LibraryRecvCaptureSet,
+    TP_ARGS(
+        const char *, arg2), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryRecvCaptureFull
+// [ lib] Receive capture stopped at its size limit
+// QuicTraceLogInfo(
+                LibraryRecvCaptureFull,
+                "[ lib] Receive capture stopped at its size limit");
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_RECV_CAPTURE_C, LibraryRecvCaptureFull,
+    TP_ARGS(
+), 
+    TP_FIELDS(
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for LibraryError
+// [ lib] ERROR, %s.
+// QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "Failed to open receive capture file");
+// arg2 = arg2 = "Failed to open receive capture file" = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_RECV_CAPTURE_C, LibraryError,
+    TP_ARGS(
+        const char *, arg2), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+    )
+)
@@ -182,9 +182,9 @@ tracepoint(CLOG_SEND_C, SendFlushComplete , arg1, arg3);\
             StartAckDelayTimer,
             Connection,
             "Starting ACK_DELAY timer for %u ms",
-            Connection->Settings.MaxAckDelayMs);
+            Connection->MaxAckDelayMs);
 // arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = Connection->Settings.MaxAckDelayMs = arg3
+// arg3 = arg3 = Connection->MaxAckDelayMs = arg3
 ----------------------------------------------------------*/
 #ifndef _clog_4_ARGS_TRACE_StartAckDelayTimer
 #define _clog_4_ARGS_TRACE_StartAckDelayTimer(uniqueId, arg1, encoded_arg_string, arg3)\
@@ -215,6 +215,26 @@ tracepoint(CLOG_SEND_C, ConnQueueSendFlush , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Send priority levels",
+            NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+// arg2 = arg2 = "Send priority levels" = arg2
+// arg3 = arg3 = NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL) = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_SEND_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConnFlushSend
 // [conn][%p] Flushing Send. Allowance=%u bytes
@@ -173,9 +173,9 @@ TRACEPOINT_EVENT(CLOG_SEND_C, SendFlushComplete,
             StartAckDelayTimer,
             Connection,
             "Starting ACK_DELAY timer for %u ms",
-            Connection->Settings.MaxAckDelayMs);
+            Connection->MaxAckDelayMs);
 // arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = Connection->Settings.MaxAckDelayMs = arg3
+// arg3 = arg3 = Connection->MaxAckDelayMs = arg3
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_SEND_C, StartAckDelayTimer,
     TP_ARGS(
@@ -212,6 +212,29 @@ TRACEPOINT_EVENT(CLOG_SEND_C, ConnQueueSendFlush,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Send priority levels",
+            NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+// arg2 = arg2 = "Send priority levels" = arg2
+// arg3 = arg3 = NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SEND_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConnFlushSend
 // [conn][%p] Flushing Send. Allowance=%u bytes
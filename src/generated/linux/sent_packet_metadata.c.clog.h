@@ -1,9 +1,46 @@
 #ifndef CLOG_DO_NOT_INCLUDE_HEADER
 #include <clog.h>
 #endif
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER CLOG_SENT_PACKET_METADATA_C
+#undef TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#define  TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "sent_packet_metadata.c.clog.h.lttng.h"
+#if !defined(DEF_CLOG_SENT_PACKET_METADATA_C) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define DEF_CLOG_SENT_PACKET_METADATA_C
+#include <lttng/tracepoint.h>
+#define __int64 __int64_t
+#include "sent_packet_metadata.c.clog.h.lttng.h"
+#endif
+#include <lttng/tracepoint-event.h>
+#ifndef _clog_MACRO_QuicTraceEvent
+#define _clog_MACRO_QuicTraceEvent  1
+#define QuicTraceEvent(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
 #ifdef __cplusplus
 extern "C" {
 #endif
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "sent packet ring",
+            AllocSize);
+// arg2 = arg2 = "sent packet ring" = arg2
+// arg3 = arg3 = AllocSize = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_SENT_PACKET_METADATA_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,23 @@
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "sent packet ring",
+            AllocSize);
+// arg2 = arg2 = "sent packet ring" = arg2
+// arg3 = arg3 = AllocSize = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SENT_PACKET_METADATA_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
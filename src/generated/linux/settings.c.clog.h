@@ -434,6 +434,66 @@ tracepoint(CLOG_SETTINGS_C, SettingDumpConnFlowControlWindow , arg2);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpConnFlowControlWindowMax
+// [sett] ConnFlowControlWindowMax = %u
+// QuicTraceLogVerbose(SettingDumpConnFlowControlWindowMax, "[sett] ConnFlowControlWindowMax = %u", Settings->ConnFlowControlWindowMax);
+// arg2 = arg2 = Settings->ConnFlowControlWindowMax = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_SettingDumpConnFlowControlWindowMax
+#define _clog_3_ARGS_TRACE_SettingDumpConnFlowControlWindowMax(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_SETTINGS_C, SettingDumpConnFlowControlWindowMax , arg2);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpHibernateTimeoutMs
+// [sett] HibernateTimeoutMs     = %u
+// QuicTraceLogVerbose(SettingDumpHibernateTimeoutMs,      "[sett] HibernateTimeoutMs     = %u", Settings->HibernateTimeoutMs);
+// arg2 = arg2 = Settings->HibernateTimeoutMs = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_SettingDumpHibernateTimeoutMs
+#define _clog_3_ARGS_TRACE_SettingDumpHibernateTimeoutMs(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_SETTINGS_C, SettingDumpHibernateTimeoutMs , arg2);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpPeerStreamCountMax
+// [sett] PeerStreamCountMax     = %hu
+// QuicTraceLogVerbose(SettingDumpPeerStreamCountMax,      "[sett] PeerStreamCountMax     = %hu", Settings->PeerStreamCountMax);
+// arg2 = arg2 = Settings->PeerStreamCountMax = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_SettingDumpPeerStreamCountMax
+#define _clog_3_ARGS_TRACE_SettingDumpPeerStreamCountMax(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_SETTINGS_C, SettingDumpPeerStreamCountMax , arg2);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpSpinBitDisableRate
+// [sett] SpinBitDisableRate     = %hu
+// QuicTraceLogVerbose(SettingDumpSpinBitDisableRate,      "[sett] SpinBitDisableRate     = %hu", Settings->SpinBitDisableRate);
+// arg2 = arg2 = Settings->SpinBitDisableRate = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_SettingDumpSpinBitDisableRate
+#define _clog_3_ARGS_TRACE_SettingDumpSpinBitDisableRate(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_SETTINGS_C, SettingDumpSpinBitDisableRate , arg2);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for SettingDumpMaxBytesPerKey
 // [sett] MaxBytesPerKey         = %llu
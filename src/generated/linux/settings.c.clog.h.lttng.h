@@ -433,6 +433,70 @@ TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingDumpConnFlowControlWindow,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpConnFlowControlWindowMax
+// [sett] ConnFlowControlWindowMax = %u
+// QuicTraceLogVerbose(SettingDumpConnFlowControlWindowMax, "[sett] ConnFlowControlWindowMax = %u", Settings->ConnFlowControlWindowMax);
+// arg2 = arg2 = Settings->ConnFlowControlWindowMax = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingDumpConnFlowControlWindowMax,
+    TP_ARGS(
+        unsigned int, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpHibernateTimeoutMs
+// [sett] HibernateTimeoutMs     = %u
+// QuicTraceLogVerbose(SettingDumpHibernateTimeoutMs,      "[sett] HibernateTimeoutMs     = %u", Settings->HibernateTimeoutMs);
+// arg2 = arg2 = Settings->HibernateTimeoutMs = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingDumpHibernateTimeoutMs,
+    TP_ARGS(
+        unsigned int, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpPeerStreamCountMax
+// [sett] PeerStreamCountMax     = %hu
+// QuicTraceLogVerbose(SettingDumpPeerStreamCountMax,      "[sett] PeerStreamCountMax     = %hu", Settings->PeerStreamCountMax);
+// arg2 = arg2 = Settings->PeerStreamCountMax = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingDumpPeerStreamCountMax,
+    TP_ARGS(
+        unsigned short, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned short, arg2, arg2)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingDumpSpinBitDisableRate
+// [sett] SpinBitDisableRate     = %hu
+// QuicTraceLogVerbose(SettingDumpSpinBitDisableRate,      "[sett] SpinBitDisableRate     = %hu", Settings->SpinBitDisableRate);
+// arg2 = arg2 = Settings->SpinBitDisableRate = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingDumpSpinBitDisableRate,
+    TP_ARGS(
+        unsigned short, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned short, arg2, arg2)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for SettingDumpMaxBytesPerKey
 // [sett] MaxBytesPerKey         = %llu
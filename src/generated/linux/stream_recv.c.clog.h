@@ -26,6 +26,10 @@
 #define _clog_MACRO_QuicTraceLogStreamVerbose  1
 #define QuicTraceLogStreamVerbose(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
 #endif
+#ifndef _clog_MACRO_QuicTraceLogConnVerbose
+#define _clog_MACRO_QuicTraceLogConnVerbose  1
+#define QuicTraceLogConnVerbose(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
 #ifndef _clog_MACRO_QuicTraceEvent
 #define _clog_MACRO_QuicTraceEvent  1
 #define QuicTraceEvent(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
@@ -197,6 +201,24 @@ tracepoint(CLOG_STREAM_RECV_C, TreatFinAsReset , arg1);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for QueueRecvBatchFlush
+// [strm][%p] Queuing batched recv flush
+// QuicTraceLogStreamVerbose(
+        QueueRecvBatchFlush,
+        Stream,
+        "Queuing batched recv flush");
+// arg1 = arg1 = Stream = arg1
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_QueueRecvBatchFlush
+#define _clog_3_ARGS_TRACE_QueueRecvBatchFlush(uniqueId, arg1, encoded_arg_string)\
+tracepoint(CLOG_STREAM_RECV_C, QueueRecvBatchFlush , arg1);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for QueueRecvFlush
 // [strm][%p] Queuing recv flush
@@ -433,6 +455,52 @@ tracepoint(CLOG_STREAM_RECV_C, IndicatePeerSendShutdown , arg1);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IncreaseConnRecvWindow
+// [conn][%p] Increasing conn RX window to %u (SmoothedRtt=%llu; TimeNow=%llu; LastUpdate=%llu)
+// QuicTraceLogConnVerbose(
+                    IncreaseConnRecvWindow,
+                    Connection,
+                    "Increasing conn RX window to %u (SmoothedRtt=%llu; TimeNow=%llu; LastUpdate=%llu)",
+                    Send->RecvWindow,
+                    Connection->Paths[0].SmoothedRtt,
+                    TimeNow,
+                    Send->RecvWindowLastUpdate);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Send->RecvWindow = arg3
+// arg4 = arg4 = Connection->Paths[0].SmoothedRtt = arg4
+// arg5 = arg5 = TimeNow = arg5
+// arg6 = arg6 = Send->RecvWindowLastUpdate = arg6
+----------------------------------------------------------*/
+#ifndef _clog_7_ARGS_TRACE_IncreaseConnRecvWindow
+#define _clog_7_ARGS_TRACE_IncreaseConnRecvWindow(uniqueId, arg1, encoded_arg_string, arg3, arg4, arg5, arg6)\
+tracepoint(CLOG_STREAM_RECV_C, IncreaseConnRecvWindow , arg1, arg3, arg4, arg5, arg6);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for IndicateStreamsReceive
+// [conn][%p] Indicating QUIC_CONNECTION_EVENT_STREAMS_RECEIVE [%u streams]
+// QuicTraceLogConnVerbose(
+            IndicateStreamsReceive,
+            Connection,
+            "Indicating QUIC_CONNECTION_EVENT_STREAMS_RECEIVE [%u streams]",
+            StreamCount);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = StreamCount = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_IndicateStreamsReceive
+#define _clog_4_ARGS_TRACE_IndicateStreamsReceive(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_STREAM_RECV_C, IndicateStreamsReceive , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for StreamRecvState
 // [strm][%p] Recv State: %hhu
@@ -457,11 +525,11 @@ tracepoint(CLOG_STREAM_RECV_C, StreamRecvState , arg2, arg3);\
 // Decoder Ring for AllocFailure
 // Allocation of '%s' failed. (%llu bytes)
 // QuicTraceEvent(
-                    AllocFailure,
-                    "Allocation of '%s' failed. (%llu bytes)",
-                    "Flush Stream Recv operation",
-                    0);
-// arg2 = arg2 = "Flush Stream Recv operation" = arg2
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Flush Streams Recv operation",
+                0);
+// arg2 = arg2 = "Flush Streams Recv operation" = arg2
 // arg3 = arg3 = 0 = arg3
 ----------------------------------------------------------*/
 #ifndef _clog_4_ARGS_TRACE_AllocFailure
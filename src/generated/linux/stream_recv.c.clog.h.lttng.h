@@ -176,6 +176,25 @@ TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, TreatFinAsReset,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for QueueRecvBatchFlush
+// [strm][%p] Queuing batched recv flush
+// QuicTraceLogStreamVerbose(
+        QueueRecvBatchFlush,
+        Stream,
+        "Queuing batched recv flush");
+// arg1 = arg1 = Stream = arg1
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, QueueRecvBatchFlush,
+    TP_ARGS(
+        const void *, arg1), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for QueueRecvFlush
 // [strm][%p] Queuing recv flush
@@ -444,6 +463,64 @@ TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, IndicatePeerSendShutdown,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IncreaseConnRecvWindow
+// [conn][%p] Increasing conn RX window to %u (SmoothedRtt=%llu; TimeNow=%llu; LastUpdate=%llu)
+// QuicTraceLogConnVerbose(
+                    IncreaseConnRecvWindow,
+                    Connection,
+                    "Increasing conn RX window to %u (SmoothedRtt=%llu; TimeNow=%llu; LastUpdate=%llu)",
+                    Send->RecvWindow,
+                    Connection->Paths[0].SmoothedRtt,
+                    TimeNow,
+                    Send->RecvWindowLastUpdate);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Send->RecvWindow = arg3
+// arg4 = arg4 = Connection->Paths[0].SmoothedRtt = arg4
+// arg5 = arg5 = TimeNow = arg5
+// arg6 = arg6 = Send->RecvWindowLastUpdate = arg6
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, IncreaseConnRecvWindow,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned int, arg3,
+        unsigned long long, arg4,
+        unsigned long long, arg5,
+        unsigned long long, arg6), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned int, arg3, arg3)
+        ctf_integer(uint64_t, arg4, arg4)
+        ctf_integer(uint64_t, arg5, arg5)
+        ctf_integer(uint64_t, arg6, arg6)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for IndicateStreamsReceive
+// [conn][%p] Indicating QUIC_CONNECTION_EVENT_STREAMS_RECEIVE [%u streams]
+// QuicTraceLogConnVerbose(
+            IndicateStreamsReceive,
+            Connection,
+            "Indicating QUIC_CONNECTION_EVENT_STREAMS_RECEIVE [%u streams]",
+            StreamCount);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = StreamCount = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, IndicateStreamsReceive,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned int, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned int, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for StreamRecvState
 // [strm][%p] Recv State: %hhu
@@ -471,11 +548,11 @@ TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, StreamRecvState,
 // Decoder Ring for AllocFailure
 // Allocation of '%s' failed. (%llu bytes)
 // QuicTraceEvent(
-                    AllocFailure,
-                    "Allocation of '%s' failed. (%llu bytes)",
-                    "Flush Stream Recv operation",
-                    0);
-// arg2 = arg2 = "Flush Stream Recv operation" = arg2
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Flush Streams Recv operation",
+                0);
+// arg2 = arg2 = "Flush Streams Recv operation" = arg2
 // arg3 = arg3 = 0 = arg3
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_STREAM_RECV_C, AllocFailure,
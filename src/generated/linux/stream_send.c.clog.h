@@ -43,6 +43,26 @@ tracepoint(CLOG_STREAM_SEND_C, IndicateSendShutdownComplete , arg1);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IndicateSendLatency
+// [strm][%p] Indicating QUIC_STREAM_EVENT_SEND_LATENCY [%p]
+// QuicTraceLogStreamVerbose(
+        IndicateSendLatency,
+        Stream,
+        "Indicating QUIC_STREAM_EVENT_SEND_LATENCY [%p]",
+        SendRequest);
+// arg1 = arg1 = Stream = arg1
+// arg3 = arg3 = SendRequest = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_IndicateSendLatency
+#define _clog_4_ARGS_TRACE_IndicateSendLatency(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_STREAM_SEND_C, IndicateSendLatency , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for IndicateSendCanceled
 // [strm][%p] Indicating QUIC_STREAM_EVENT_SEND_COMPLETE [%p] (Canceled)
@@ -367,6 +387,26 @@ tracepoint(CLOG_STREAM_SEND_C, StreamSendState , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for StreamError
+// [strm][%p] ERROR, %s.
+// QuicTraceEvent(
+                    StreamError,
+                    "[strm][%p] ERROR, %s.",
+                    Stream,
+                    "Send file read failed");
+// arg2 = arg2 = Stream = arg2
+// arg3 = arg3 = "Send file read failed" = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_StreamError
+#define _clog_4_ARGS_TRACE_StreamError(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_STREAM_SEND_C, StreamError , arg2, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for StreamWriteFrames
 // [strm][%p] Writing frames to packet %llu
@@ -20,6 +20,29 @@ TRACEPOINT_EVENT(CLOG_STREAM_SEND_C, IndicateSendShutdownComplete,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IndicateSendLatency
+// [strm][%p] Indicating QUIC_STREAM_EVENT_SEND_LATENCY [%p]
+// QuicTraceLogStreamVerbose(
+        IndicateSendLatency,
+        Stream,
+        "Indicating QUIC_STREAM_EVENT_SEND_LATENCY [%p]",
+        SendRequest);
+// arg1 = arg1 = Stream = arg1
+// arg3 = arg3 = SendRequest = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_SEND_C, IndicateSendLatency,
+    TP_ARGS(
+        const void *, arg1,
+        const void *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer_hex(uint64_t, arg3, (uint64_t)arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for IndicateSendCanceled
 // [strm][%p] Indicating QUIC_STREAM_EVENT_SEND_COMPLETE [%p] (Canceled)
@@ -413,6 +436,29 @@ TRACEPOINT_EVENT(CLOG_STREAM_SEND_C, StreamSendState,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for StreamError
+// [strm][%p] ERROR, %s.
+// QuicTraceEvent(
+                    StreamError,
+                    "[strm][%p] ERROR, %s.",
+                    Stream,
+                    "Send file read failed");
+// arg2 = arg2 = Stream = arg2
+// arg3 = arg3 = "Send file read failed" = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_SEND_C, StreamError,
+    TP_ARGS(
+        const void *, arg2,
+        const char *, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_string(arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for StreamWriteFrames
 // [strm][%p] Writing frames to packet %llu
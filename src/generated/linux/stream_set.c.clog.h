@@ -75,6 +75,24 @@ tracepoint(CLOG_STREAM_SET_C, IndicatePeerAccepted , arg1);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AcceptedWithTemplate
+// [strm][%p] Accepted with the peer stream template
+// QuicTraceLogStreamVerbose(
+        AcceptedWithTemplate,
+        Stream,
+        "Accepted with the peer stream template");
+// arg1 = arg1 = Stream = arg1
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_AcceptedWithTemplate
+#define _clog_3_ARGS_TRACE_AcceptedWithTemplate(uniqueId, arg1, encoded_arg_string)\
+tracepoint(CLOG_STREAM_SET_C, AcceptedWithTemplate , arg1);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConfiguredForDelayedIDFC
 // [strm][%p] Configured for delayed ID FC updates
@@ -159,6 +177,26 @@ tracepoint(CLOG_STREAM_SET_C, PeerStreamCountsUpdated , arg1, arg3, arg4);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IndicatePeerStreamsStarted
+// [conn][%p] Indicating QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED [%u]
+// QuicTraceLogConnVerbose(
+            IndicatePeerStreamsStarted,
+            Connection,
+            "Indicating QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED [%u]",
+            StartedCount);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = StartedCount = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_IndicatePeerStreamsStarted
+#define _clog_4_ARGS_TRACE_IndicatePeerStreamsStarted(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_STREAM_SET_C, IndicatePeerStreamsStarted , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for IndicatePeerStreamStarted
 // [conn][%p] Indicating QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED [%p, 0x%x]
@@ -43,6 +43,25 @@ TRACEPOINT_EVENT(CLOG_STREAM_SET_C, IndicatePeerAccepted,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AcceptedWithTemplate
+// [strm][%p] Accepted with the peer stream template
+// QuicTraceLogStreamVerbose(
+        AcceptedWithTemplate,
+        Stream,
+        "Accepted with the peer stream template");
+// arg1 = arg1 = Stream = arg1
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_SET_C, AcceptedWithTemplate,
+    TP_ARGS(
+        const void *, arg1), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for ConfiguredForDelayedIDFC
 // [strm][%p] Configured for delayed ID FC updates
@@ -143,6 +162,29 @@ TRACEPOINT_EVENT(CLOG_STREAM_SET_C, PeerStreamCountsUpdated,
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IndicatePeerStreamsStarted
+// [conn][%p] Indicating QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED [%u]
+// QuicTraceLogConnVerbose(
+            IndicatePeerStreamsStarted,
+            Connection,
+            "Indicating QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED [%u]",
+            StartedCount);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = StartedCount = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_SET_C, IndicatePeerStreamsStarted,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned int, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned int, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for IndicatePeerStreamStarted
 // [conn][%p] Indicating QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED [%p, 0x%x]
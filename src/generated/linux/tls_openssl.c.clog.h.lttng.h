@@ -522,12 +522,12 @@ TRACEPOINT_EVENT(CLOG_TLS_OPENSSL_C, TlsErrorStatus,
 // Decoder Ring for LibraryErrorStatus
 // [ lib] ERROR, %u, %s.
 // QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                CredConfig->AllowedCipherSuites,
-                "No valid cipher suites presented");
-// arg2 = arg2 = CredConfig->AllowedCipherSuites = arg2
-// arg3 = arg3 = "No valid cipher suites presented" = arg3
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "BIO_new_file failed");
+// arg2 = arg2 = ERR_get_error() = arg2
+// arg3 = arg3 = "BIO_new_file failed" = arg3
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_TLS_OPENSSL_C, LibraryErrorStatus,
     TP_ARGS(
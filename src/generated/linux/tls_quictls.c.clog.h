@@ -549,12 +549,12 @@ tracepoint(CLOG_TLS_QUICTLS_C, TlsErrorStatus , arg2, arg3, arg4);\
 // Decoder Ring for LibraryErrorStatus
 // [ lib] ERROR, %u, %s.
 // QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                CredConfig->AllowedCipherSuites,
-                "No valid cipher suites presented");
-// arg2 = arg2 = CredConfig->AllowedCipherSuites = arg2
-// arg3 = arg3 = "No valid cipher suites presented" = arg3
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "BIO_new_file failed");
+// arg2 = arg2 = ERR_get_error() = arg2
+// arg3 = arg3 = "BIO_new_file failed" = arg3
 ----------------------------------------------------------*/
 #ifndef _clog_4_ARGS_TRACE_LibraryErrorStatus
 #define _clog_4_ARGS_TRACE_LibraryErrorStatus(uniqueId, encoded_arg_string, arg2, arg3)\
@@ -14,6 +14,14 @@
 #include "worker.c.clog.h.lttng.h"
 #endif
 #include <lttng/tracepoint-event.h>
+#ifndef _clog_MACRO_QuicTraceLogVerbose
+#define _clog_MACRO_QuicTraceLogVerbose  1
+#define QuicTraceLogVerbose(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifndef _clog_MACRO_QuicTraceLogConnInfo
+#define _clog_MACRO_QuicTraceLogConnInfo  1
+#define QuicTraceLogConnInfo(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
 #ifndef _clog_MACRO_QuicTraceLogConnVerbose
 #define _clog_MACRO_QuicTraceLogConnVerbose  1
 #define QuicTraceLogConnVerbose(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
@@ -25,6 +33,92 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+/*----------------------------------------------------------
+// Decoder Ring for WorkerLoadUpdated
+// [wrkr][%p] Load = %hhu%%
+// QuicTraceLogVerbose(
+        WorkerLoadUpdated,
+        "[wrkr][%p] Load = %hhu%%",
+        Worker,
+        Worker->Load);
+// arg2 = arg2 = Worker = arg2
+// arg3 = arg3 = Worker->Load = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_WorkerLoadUpdated
+#define _clog_4_ARGS_TRACE_WorkerLoadUpdated(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_WORKER_C, WorkerLoadUpdated , arg2, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for IndicatePathTelemetry
+// [wrkr][%p] Indicating %u path telemetry snapshots
+// QuicTraceLogVerbose(
+            IndicatePathTelemetry,
+            "[wrkr][%p] Indicating %u path telemetry snapshots",
+            Worker,
+            Batch->Count);
+// arg2 = arg2 = Worker = arg2
+// arg3 = arg3 = Batch->Count = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_IndicatePathTelemetry
+#define _clog_4_ARGS_TRACE_IndicatePathTelemetry(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_WORKER_C, IndicatePathTelemetry , arg2, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for RebalanceWorker
+// [conn][%p] Moving to partition %hu (load %hhu%%, source load %hhu%%, conn load %llu%%)
+// QuicTraceLogConnInfo(
+        RebalanceWorker,
+        Connection,
+        "Moving to partition %hu (load %hhu%%, source load %hhu%%, conn load %llu%%)",
+        Target->Partition->Index,
+        Target->Load,
+        Worker->Load,
+        ConnLoad);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Target->Partition->Index = arg3
+// arg4 = arg4 = Target->Load = arg4
+// arg5 = arg5 = Worker->Load = arg5
+// arg6 = arg6 = ConnLoad = arg6
+----------------------------------------------------------*/
+#ifndef _clog_7_ARGS_TRACE_RebalanceWorker
+#define _clog_7_ARGS_TRACE_RebalanceWorker(uniqueId, arg1, encoded_arg_string, arg3, arg4, arg5, arg6)\
+tracepoint(CLOG_WORKER_C, RebalanceWorker , arg1, arg3, arg4, arg5, arg6);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for StealWorker
+// [conn][%p] Handing over to idle partition %hu
+// QuicTraceLogConnInfo(
+        StealWorker,
+        Connection,
+        "Handing over to idle partition %hu",
+        Thief->Partition->Index);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Thief->Partition->Index = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_StealWorker
+#define _clog_4_ARGS_TRACE_StealWorker(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_WORKER_C, StealWorker , arg1, arg3);\
+
+#endif
+
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for IndicateIdealProcChanged
 // [conn][%p] Indicating QUIC_CONNECTION_EVENT_IDEAL_PROCESSOR_CHANGED (Proc=%hu,Indx=%hu)
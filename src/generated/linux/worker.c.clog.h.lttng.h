@@ -1,6 +1,110 @@
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for WorkerLoadUpdated
+// [wrkr][%p] Load = %hhu%%
+// QuicTraceLogVerbose(
+        WorkerLoadUpdated,
+        "[wrkr][%p] Load = %hhu%%",
+        Worker,
+        Worker->Load);
+// arg2 = arg2 = Worker = arg2
+// arg3 = arg3 = Worker->Load = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_WORKER_C, WorkerLoadUpdated,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned char, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned char, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for IndicatePathTelemetry
+// [wrkr][%p] Indicating %u path telemetry snapshots
+// QuicTraceLogVerbose(
+            IndicatePathTelemetry,
+            "[wrkr][%p] Indicating %u path telemetry snapshots",
+            Worker,
+            Batch->Count);
+// arg2 = arg2 = Worker = arg2
+// arg3 = arg3 = Batch->Count = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_WORKER_C, IndicatePathTelemetry,
+    TP_ARGS(
+        const void *, arg2,
+        unsigned int, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+        ctf_integer(unsigned int, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for RebalanceWorker
+// [conn][%p] Moving to partition %hu (load %hhu%%, source load %hhu%%, conn load %llu%%)
+// QuicTraceLogConnInfo(
+        RebalanceWorker,
+        Connection,
+        "Moving to partition %hu (load %hhu%%, source load %hhu%%, conn load %llu%%)",
+        Target->Partition->Index,
+        Target->Load,
+        Worker->Load,
+        ConnLoad);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Target->Partition->Index = arg3
+// arg4 = arg4 = Target->Load = arg4
+// arg5 = arg5 = Worker->Load = arg5
+// arg6 = arg6 = ConnLoad = arg6
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_WORKER_C, RebalanceWorker,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned short, arg3,
+        unsigned char, arg4,
+        unsigned char, arg5,
+        unsigned long long, arg6), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned short, arg3, arg3)
+        ctf_integer(unsigned char, arg4, arg4)
+        ctf_integer(unsigned char, arg5, arg5)
+        ctf_integer(uint64_t, arg6, arg6)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for StealWorker
+// [conn][%p] Handing over to idle partition %hu
+// QuicTraceLogConnInfo(
+        StealWorker,
+        Connection,
+        "Handing over to idle partition %hu",
+        Thief->Partition->Index);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = Thief->Partition->Index = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_WORKER_C, StealWorker,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned short, arg3), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned short, arg3, arg3)
+    )
+)
+
+
+
 /*----------------------------------------------------------
 // Decoder Ring for IndicateIdealProcChanged
 // [conn][%p] Indicating QUIC_CONNECTION_EVENT_IDEAL_PROCESSOR_CHANGED (Proc=%hu,Indx=%hu)
@@ -91,6 +91,7 @@ typedef enum QUIC_LOAD_BALANCING_MODE {
     QUIC_LOAD_BALANCING_DISABLED,               // Default
     QUIC_LOAD_BALANCING_SERVER_ID_IP,           // Encodes IP address in Server ID
     QUIC_LOAD_BALANCING_SERVER_ID_FIXED,        // Encodes a fixed 4-byte value in Server ID
+    QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB,      // Encodes Server ID per QUIC-LB (see QUIC_PARAM_GLOBAL_QUIC_LB_CONFIG)
     QUIC_LOAD_BALANCING_COUNT,                  // The number of supported load balancing modes
                                                 // MUST BE LAST
 } QUIC_LOAD_BALANCING_MODE;
@@ -190,6 +191,8 @@ DEFINE_ENUM_FLAG_OPERATORS(QUIC_SEND_RESUMPTION_FLAGS)
 typedef enum QUIC_STREAM_SCHEDULING_SCHEME {
     QUIC_STREAM_SCHEDULING_SCHEME_FIFO          = 0x0000,   // Sends stream data first come, first served. (Default)
     QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN   = 0x0001,   // Sends stream data evenly multiplexed.
+    QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE    = 0x0002,   // Sends stream data by RFC 9218 urgency and incremental.
+    QUIC_STREAM_SCHEDULING_SCHEME_WEIGHTED      = 0x0003,   // Sends stream data in proportion to stream weights.
     QUIC_STREAM_SCHEDULING_SCHEME_COUNT,                    // The number of stream scheduling schemes.
 } QUIC_STREAM_SCHEDULING_SCHEME;
 
@@ -249,6 +252,7 @@ typedef enum QUIC_SEND_FLAGS {
     QUIC_SEND_FLAG_CANCEL_ON_LOSS           = 0x0020,   // Indicates that a stream is to be cancelled when packet loss is detected.
     QUIC_SEND_FLAG_PRIORITY_WORK            = 0x0040,   // Higher priority than other connection work.
     QUIC_SEND_FLAG_CANCEL_ON_BLOCKED        = 0x0080,   // Indicates that a frame should be dropped when it can't be sent immediately.
+    QUIC_SEND_FLAG_DGRAM_LOW_PRIORITY       = 0x0100,   // Indicates the datagram is lower priority than others.
 } QUIC_SEND_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_SEND_FLAGS)
@@ -349,6 +353,24 @@ uint32_t
     _In_ QUIC_EXECUTION* Execution
     );
 
+//
+// This is called to allow MsQuic to process polling work for several execution
+// contexts in one call, within a budget. The execution contexts are polled in
+// turn until none has immediate work left, TimeBudgetUs microseconds have
+// passed, or work has been run RunBudget times. A zero budget means no limit.
+// It returns the number of microseconds until one of them needs to be polled
+// again: 0 if work is still pending, or UINT32_MAX if nothing is scheduled.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+(QUIC_API * QUIC_EXECUTION_POLL_BATCH_FN)(
+    _In_ uint32_t Count,
+    _In_reads_(Count) QUIC_EXECUTION** Executions,
+    _In_ uint32_t TimeBudgetUs,
+    _In_ uint32_t RunBudget
+    );
+
 #endif // _KERNEL_MODE
 
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
@@ -511,10 +533,100 @@ typedef enum QUIC_CONGESTION_CONTROL_ALGORITHM {
     QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC,
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
     QUIC_CONGESTION_CONTROL_ALGORITHM_BBR,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE,
 #endif
     QUIC_CONGESTION_CONTROL_ALGORITHM_MAX,
 } QUIC_CONGESTION_CONTROL_ALGORITHM;
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// Application defined congestion control. Selected with
+// QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM and provided per connection with
+// QUIC_PARAM_CONN_CUSTOM_CONGESTION_CONTROL. All callbacks are invoked inline
+// on the connection's worker thread. MsQuic tracks bytes in flight and passes
+// the current value to the callbacks.
+//
+typedef struct QUIC_CONGESTION_CONTROL_ACK_INFO {
+    uint64_t TimeNow;                   // Microseconds
+    uint64_t LargestAck;
+    uint64_t LargestSentPacketNumber;
+    uint64_t TotalBytesAcked;           // For the connection's lifetime
+    uint64_t SmoothedRtt;               // Microseconds
+    uint64_t MinRtt;                    // Microseconds. Only valid if MinRttValid
+    uint64_t OneWayDelay;               // Microseconds
+    uint32_t BytesAcked;
+    uint32_t BytesInFlight;             // After removing BytesAcked
+    BOOLEAN IsImplicit;
+    BOOLEAN HasLoss;
+    BOOLEAN MinRttValid;
+    BOOLEAN IsLargestAckedPacketAppLimited;
+} QUIC_CONGESTION_CONTROL_ACK_INFO;
+
+typedef struct QUIC_CONGESTION_CONTROL_LOSS_INFO {
+    uint64_t LargestPacketNumberLost;
+    uint64_t LargestSentPacketNumber;
+    uint32_t BytesLost;
+    uint32_t BytesInFlight;             // After removing BytesLost
+    BOOLEAN PersistentCongestion;
+} QUIC_CONGESTION_CONTROL_LOSS_INFO;
+
+typedef struct QUIC_CONGESTION_CONTROL_ECN_INFO {
+    uint64_t LargestPacketNumberAcked;
+    uint64_t LargestSentPacketNumber;
+    uint32_t BytesInFlight;
+} QUIC_CONGESTION_CONTROL_ECN_INFO;
+
+typedef struct QUIC_CONGESTION_CONTROL_CALLBACKS {
+    //
+    // Required callbacks.
+    //
+    BOOLEAN (QUIC_API * CanSend)(
+        _In_opt_ void* Context,
+        _In_ uint32_t BytesInFlight
+        );
+    uint32_t (QUIC_API * GetSendAllowance)(
+        _In_opt_ void* Context,
+        _In_ uint32_t BytesInFlight,
+        _In_ uint64_t TimeSinceLastSend, // Microseconds
+        _In_ BOOLEAN TimeSinceLastSendValid
+        );
+    uint32_t (QUIC_API * GetCongestionWindow)(
+        _In_opt_ void* Context
+        );
+    void (QUIC_API * OnDataSent)(
+        _In_opt_ void* Context,
+        _In_ uint32_t BytesSent,
+        _In_ uint32_t BytesInFlight
+        );
+    void (QUIC_API * OnDataAcknowledged)(
+        _In_opt_ void* Context,
+        _In_ const QUIC_CONGESTION_CONTROL_ACK_INFO* Info
+        );
+    void (QUIC_API * OnDataLost)(
+        _In_opt_ void* Context,
+        _In_ const QUIC_CONGESTION_CONTROL_LOSS_INFO* Info
+        );
+    //
+    // Optional callbacks.
+    //
+    void (QUIC_API * OnEcn)(
+        _In_opt_ void* Context,
+        _In_ const QUIC_CONGESTION_CONTROL_ECN_INFO* Info
+        );
+    void (QUIC_API * Reset)(
+        _In_opt_ void* Context,
+        _In_ BOOLEAN FullReset
+        );
+} QUIC_CONGESTION_CONTROL_CALLBACKS;
+
+typedef struct QUIC_CUSTOM_CONGESTION_CONTROL {
+    const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks; // Must outlive the connection
+    void* Context;
+} QUIC_CUSTOM_CONGESTION_CONTROL;
+#endif
+
 //
 // All the available information describing a handshake.
 //
@@ -637,6 +749,31 @@ typedef struct QUIC_STATISTICS_V2 {
 
     uint32_t RttVariance;                   // In microseconds
 
+    uint64_t SendDeliveryRate;              // Bytes per second; most recent delivery rate estimate
+
+    uint64_t ProcessingTime;                // In microseconds; time the worker spent processing the connection
+
+    //
+    // Cumulative time, in microseconds, that sending was blocked for each
+    // reason. The stream reasons are summed over all the connection's streams.
+    //
+    uint64_t SendBlockedBySchedulingUs;         // Waiting for the worker to send
+    uint64_t SendBlockedByPacingUs;
+    uint64_t SendBlockedByAmplificationProtUs;  // Anti-amplification limit, before address validation
+    uint64_t SendBlockedByCongestionControlUs;
+    uint64_t SendBlockedByConnFlowControlUs;    // Peer's MAX_DATA
+    uint64_t SendBlockedByStreamFlowControlUs;  // Peer's MAX_STREAM_DATA
+    uint64_t SendBlockedByStreamIdFlowControlUs;// Peer's MAX_STREAMS
+
+    //
+    // RTT observed passively from the peer's latency spin bit, in
+    // microseconds. No samples are taken while either endpoint has the spin
+    // bit disabled on the active path.
+    //
+    uint64_t SpinRttSampleCount;
+    uint32_t SpinRttLatestUs;
+    uint32_t SpinRttMinUs;
+
     // N.B. New fields must be appended to end
 
 } QUIC_STATISTICS_V2;
@@ -659,6 +796,9 @@ typedef struct QUIC_NETWORK_STATISTICS
 #define QUIC_STATISTICS_V2_SIZE_2   QUIC_STRUCT_SIZE_THRU_FIELD(QUIC_STATISTICS_V2, DestCidUpdateCount)     // MsQuic v2.1 final size
 #define QUIC_STATISTICS_V2_SIZE_3   QUIC_STRUCT_SIZE_THRU_FIELD(QUIC_STATISTICS_V2, SendEcnCongestionCount) // MsQuic v2.2 final size
 #define QUIC_STATISTICS_V2_SIZE_4   QUIC_STRUCT_SIZE_THRU_FIELD(QUIC_STATISTICS_V2, RttVariance)            // MsQuic v2.5 final size
+#define QUIC_STATISTICS_V2_SIZE_5   QUIC_STRUCT_SIZE_THRU_FIELD(QUIC_STATISTICS_V2, ProcessingTime)
+#define QUIC_STATISTICS_V2_SIZE_6   QUIC_STRUCT_SIZE_THRU_FIELD(QUIC_STATISTICS_V2, SendBlockedByStreamIdFlowControlUs)
+#define QUIC_STATISTICS_V2_SIZE_7   QUIC_STRUCT_SIZE_THRU_FIELD(QUIC_STATISTICS_V2, SpinRttMinUs)
 
 typedef struct QUIC_LISTENER_STATISTICS {
 
@@ -703,6 +843,13 @@ typedef enum QUIC_PERFORMANCE_COUNTERS {
     QUIC_PERF_COUNTER_SEND_STATELESS_RETRY, // Total stateless retry packets sent ever.
     QUIC_PERF_COUNTER_CONN_LOAD_REJECT,     // Total connections rejected due to worker load.
     QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH,   // Current listeners queued for processing.
+    QUIC_PERF_COUNTER_WORK_BUSY_TIME,       // Total time workers spent processing connections ever (in microseconds).
+    QUIC_PERF_COUNTER_MEMORY_USAGE,         // Current memory used by buffered stream data and connection state (in bytes).
+    QUIC_PERF_COUNTER_CONN_HIBERNATING,     // Current connections hibernating to save memory.
+    QUIC_PERF_COUNTER_ZERORTT_REPLAY_REJECT, // Total resumptions refused as ClientHello replays.
+    QUIC_PERF_COUNTER_XDP_BUSY_POLL_TIME,   // Total time XDP partitions spent busy polling (in microseconds).
+    QUIC_PERF_COUNTER_XDP_SLEEP_TIME,       // Total time XDP partitions spent sleeping between polls (in microseconds).
+    QUIC_PERF_COUNTER_XDP_INTERRUPT_TIME,   // Total time XDP partitions spent waiting for packet notifications (in microseconds).
     QUIC_PERF_COUNTER_MAX,
 } QUIC_PERFORMANCE_COUNTERS;
 
@@ -785,8 +932,16 @@ typedef struct QUIC_SETTINGS {
             uint64_t StreamMultiReceiveEnabled              : 1;
             uint64_t XdpEnabled                             : 1;
             uint64_t QTIPEnabled                            : 1;
-            uint64_t ReservedRioEnabled                     : 1;
-            uint64_t RESERVED                               : 18;
+            uint64_t RioEnabled                             : 1;
+            uint64_t ControlFrameCoalescingEnabled          : 1;
+            uint64_t EncryptFromSendBuffersEnabled          : 1;
+            uint64_t ConnFlowControlWindowMax               : 1;
+            uint64_t StreamBatchReceiveEnabled              : 1;
+            uint64_t CarefulResumeEnabled                   : 1;
+            uint64_t HibernateTimeoutMs                     : 1;
+            uint64_t PeerStreamCountMax                     : 1;
+            uint64_t SpinBitDisableRate                     : 1;
+            uint64_t RESERVED                               : 10;
 #else
             uint64_t RESERVED                               : 26;
 #endif
@@ -839,8 +994,12 @@ typedef struct QUIC_SETTINGS {
             uint64_t StreamMultiReceiveEnabled : 1;
             uint64_t XdpEnabled                : 1;
             uint64_t QTIPEnabled               : 1;
-            uint64_t ReservedRioEnabled        : 1;
-            uint64_t ReservedFlags             : 55;
+            uint64_t RioEnabled                : 1;
+            uint64_t ControlFrameCoalescingEnabled : 1;
+            uint64_t EncryptFromSendBuffersEnabled : 1;
+            uint64_t StreamBatchReceiveEnabled : 1;
+            uint64_t CarefulResumeEnabled      : 1;
+            uint64_t ReservedFlags             : 51;
 #else
             uint64_t ReservedFlags             : 63;
 #endif
@@ -849,6 +1008,12 @@ typedef struct QUIC_SETTINGS {
     uint32_t StreamRecvWindowBidiLocalDefault;
     uint32_t StreamRecvWindowBidiRemoteDefault;
     uint32_t StreamRecvWindowUnidiDefault;
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    uint32_t ConnFlowControlWindowMax;
+    uint32_t HibernateTimeoutMs;
+    uint16_t PeerStreamCountMax;
+    uint16_t SpinBitDisableRate;
+#endif
 
 } QUIC_SETTINGS;
 
@@ -887,6 +1052,13 @@ typedef struct QUIC_STREAM_STATISTICS {
     uint64_t StreamBlockedByAppUs;
 } QUIC_STREAM_STATISTICS;
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+typedef struct QUIC_STREAM_EXTENSIBLE_PRIORITY {
+    uint8_t Urgency;                    // 0 (high) to 7 (low) - 3 (default)
+    BOOLEAN Incremental;                // Data may be interleaved with other streams of the same urgency.
+} QUIC_STREAM_EXTENSIBLE_PRIORITY;
+#endif
+
 typedef enum QUIC_AEAD_ALGORITHM_TYPE {
     QUIC_AEAD_ALGORITHM_AES_128_GCM = 0,
     QUIC_AEAD_ALGORITHM_AES_256_GCM = 1,
@@ -900,6 +1072,209 @@ typedef struct QUIC_STATELESS_RETRY_CONFIG {
         const uint8_t* Secret;          // Secret to generate the key.
 } QUIC_STATELESS_RETRY_CONFIG;
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+#define QUIC_LB_MAX_SERVER_ID_LENGTH    6
+#define QUIC_LB_MIN_NONCE_LENGTH        4
+#define QUIC_LB_MAX_ENCODED_LENGTH      10  // ServerIdLength + NonceLength
+#define QUIC_LB_KEY_LENGTH              16
+#define QUIC_LB_MAX_CONFIG_ID           6   // 7 is reserved for unroutable CIDs
+
+typedef struct QUIC_LB_CONFIG {
+    uint8_t ConfigId;                   // Config rotation codepoint, in the top 3 bits of the CID.
+    uint8_t ServerIdLength;             // Length of ServerId, in bytes.
+    uint8_t NonceLength;                // Length of the per-CID random nonce, in bytes.
+    BOOLEAN Encrypted;                  // Encrypt the server ID and nonce with Key (four-pass).
+    uint8_t ServerId[QUIC_LB_MAX_SERVER_ID_LENGTH];
+    uint8_t Key[QUIC_LB_KEY_LENGTH];    // AES-128 key. Ignored if not Encrypted.
+} QUIC_LB_CONFIG;
+
+//
+// Bytes of memory in use, by what it's used for. Allocations made by the TLS
+// library and the datapath aren't included.
+//
+typedef struct QUIC_MEMORY_USAGE {
+    uint64_t Connections;               // Connection objects.
+    uint64_t Streams;                   // Stream objects.
+    uint64_t RecvBuffers;               // Buffered received stream and crypto data.
+    uint64_t SendBuffers;               // Buffered send data.
+    uint64_t SentPacketMetadata;        // Tracking of sent packets until they're acknowledged or lost.
+    uint64_t LookupTables;              // Connection ID lookup tables. Global only.
+    uint64_t TimerWheels;               // Worker timer wheels. Global only.
+} QUIC_MEMORY_USAGE;
+
+//
+// How stream ID credit has been managed for the streams the peer opens.
+//
+typedef struct QUIC_STREAM_CREDIT_STATISTICS {
+    uint64_t PeerBidiMaxStreams;        // Current MAX_STREAMS limit for bidirectional streams.
+    uint64_t PeerUnidiMaxStreams;       // Current MAX_STREAMS limit for unidirectional streams.
+    uint16_t PeerBidiStreamCount;       // Simultaneous bidirectional streams allowed, including growth.
+    uint16_t PeerUnidiStreamCount;      // Simultaneous unidirectional streams allowed, including growth.
+    uint32_t MaxStreamsFramesSent;
+    uint32_t StreamsBlockedFramesReceived;
+    uint32_t StreamCountGrowths;        // Times a stream count was grown, see PeerStreamCountMax.
+} QUIC_STREAM_CREDIT_STATISTICS;
+
+//
+// Log-linear latency histograms, in microseconds. Buckets 0 to 3 count samples
+// of exactly that many microseconds. After that, every power of two is split
+// into 4 equal buckets, so a sample is never off by more than 25%. The last
+// bucket counts everything from about 59 seconds up.
+//
+#define QUIC_LATENCY_BUCKET_COUNT       100
+
+//
+// The smallest sample, in microseconds, counted by a bucket.
+//
+#define QUIC_LATENCY_BUCKET_MIN_US(Index) \
+    ((Index) < 4 ? (uint64_t)(Index) : (uint64_t)(4 + ((Index) & 3)) << (((Index) >> 2) - 1))
+
+typedef struct QUIC_LATENCY_HISTOGRAMS {
+    uint64_t QueueDelay[QUIC_LATENCY_BUCKET_COUNT];     // Time connections waited in a worker's queue.
+    uint64_t DrainTime[QUIC_LATENCY_BUCKET_COUNT];      // Time spent draining a connection's operations.
+    uint64_t Handshake[QUIC_LATENCY_BUCKET_COUNT];      // Time from connection start to handshake confirmation.
+    uint64_t SmoothedRtt[QUIC_LATENCY_BUCKET_COUNT];    // Smoothed RTT of connections when they shut down.
+    uint64_t SendComplete[QUIC_LATENCY_BUCKET_COUNT];   // Time from StreamSend to its successful SEND_COMPLETE.
+} QUIC_LATENCY_HISTOGRAMS;
+
+//
+// Captures a sample of connections in qlog (draft-ietf-quic-qlog) format.
+// Only supported in user mode.
+//
+typedef struct QUIC_QLOG_CONFIG {
+    const char* FilePath;               // JSON-SEQ output file. NULL disables qlog.
+    uint32_t SampleRate;                // Connections captured, per million.
+    uint32_t RingSize;                  // Events buffered per partition. 0 uses the default.
+} QUIC_QLOG_CONFIG;
+
+//
+// A periodic snapshot of a connection's current path. The counts are since the
+// connection's previous snapshot.
+//
+typedef struct QUIC_PATH_TELEMETRY {
+    uint64_t CorrelationId;             // Matches QUIC_STATISTICS_V2.CorrelationId.
+    void* ConnectionContext;            // The connection's app context.
+    uint64_t DeliveryRate;              // Bytes per second.
+    uint32_t CongestionWindow;          // Bytes.
+    uint32_t BytesInFlight;
+    uint32_t SmoothedRtt;               // Microseconds.
+    uint32_t RttVariance;               // Microseconds.
+    uint32_t SentPackets;
+    uint32_t LostPackets;               // Suspected lost.
+    uint32_t EcnCongestionEvents;
+} QUIC_PATH_TELEMETRY;
+
+//
+// Delivers a batch of snapshots, taken on the same worker thread.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_PATH_TELEMETRY_CALLBACK)
+void
+(QUIC_API QUIC_PATH_TELEMETRY_CALLBACK)(
+    _In_opt_ void* Context,
+    _In_ uint32_t SnapshotCount,
+    _In_reads_(SnapshotCount) const QUIC_PATH_TELEMETRY* Snapshots
+    );
+
+typedef QUIC_PATH_TELEMETRY_CALLBACK *QUIC_PATH_TELEMETRY_CALLBACK_HANDLER;
+
+typedef struct QUIC_PATH_TELEMETRY_CONFIG {
+    QUIC_PATH_TELEMETRY_CALLBACK_HANDLER Callback; // NULL disables telemetry.
+    void* Context;
+    uint32_t IntervalMs;                // Minimum time between a connection's snapshots.
+    uint32_t IntervalRtts;              // Or, if larger, this many smoothed RTTs.
+} QUIC_PATH_TELEMETRY_CONFIG;
+
+//
+// Client resumption ticket cache. When enabled, resumption tickets received by
+// the registration's client connections are saved, keyed by server name, port
+// and ALPN list, and used by later connections to the same server that don't
+// have a ticket set by the app. Each ticket is only used once.
+//
+typedef struct QUIC_CLIENT_TICKET_CACHE_CONFIG {
+    uint32_t MaxEntries;                // 0 disables the cache and drops all tickets.
+    uint32_t MaxBytes;                  // Memory for all entries. 0 uses the default.
+    uint32_t LifetimeMs;                // How long a ticket is kept. 0 uses the default.
+} QUIC_CLIENT_TICKET_CACHE_CONFIG;
+
+typedef struct QUIC_CLIENT_TICKET_CACHE_STATISTICS {
+    uint64_t Hits;                      // Connections started with a cached ticket.
+    uint64_t Misses;                    // Connections started without one.
+    uint64_t Stored;
+    uint64_t Evicted;                   // Dropped to stay within the limits.
+    uint64_t Expired;
+    uint32_t Entries;                   // Currently cached.
+    uint32_t Bytes;
+    uint64_t VersionHits;               // Connections started with a saved negotiated version.
+    uint32_t VersionEntries;            // Servers with a saved negotiated version.
+} QUIC_CLIENT_TICKET_CACHE_STATISTICS;
+
+//
+// Server 0-RTT anti-replay. When enabled, each ClientHello that presents a
+// resumption ticket to one of the registration's listeners is recorded, and
+// the ticket of one already seen within the window is refused, so a replayed
+// ClientHello can't have its 0-RTT data accepted again.
+//
+typedef struct QUIC_ZERORTT_ANTI_REPLAY_CONFIG {
+    uint32_t FilterBytes;               // Memory for the filter. 0 disables it.
+    uint32_t WindowMs;                  // Minimum time a ClientHello is remembered. 0 uses the default.
+} QUIC_ZERORTT_ANTI_REPLAY_CONFIG;
+
+//
+// Records every datagram received by the library's bindings, with its
+// addresses and arrival time, for offline replay. Only supported in user mode.
+//
+typedef struct QUIC_RECV_CAPTURE_CONFIG {
+    const char* FilePath;               // Capture file. NULL stops the capture.
+    uint64_t MaxBytes;                  // Stops once the file reaches this size. 0 is unlimited.
+} QUIC_RECV_CAPTURE_CONFIG;
+
+typedef enum QUIC_FLIGHT_RECORD_TYPE {
+    QUIC_FLIGHT_RECORD_NONE,
+    QUIC_FLIGHT_RECORD_LOOP,            // A worker loop iteration that found work.
+    QUIC_FLIGHT_RECORD_CONNECTION,      // A worker processing a connection's operations.
+    QUIC_FLIGHT_RECORD_IDLE,            // A worker running out of work.
+} QUIC_FLIGHT_RECORD_TYPE;
+
+//
+// An entry of a worker's always-on flight recorder.
+//
+typedef struct QUIC_FLIGHT_RECORD {
+    uint64_t TimeUs;                    // When the event started.
+    uint32_t DurationUs;
+    uint16_t Type;                      // QUIC_FLIGHT_RECORD_TYPE
+    uint16_t PartitionIndex;            // The worker's partition.
+    union {
+        struct {
+            uint32_t QueuedOperations;  // Stateless operations waiting.
+            uint32_t QueuedHandshakes;  // New connections not processed yet.
+            uint32_t TimerConnections;  // Connections with timers set.
+            uint32_t Load;              // Percent busy in the last load interval.
+        } LOOP, IDLE;
+        struct {
+            uint64_t CorrelationId;
+            uint32_t QueueDelayUs;      // Time it waited for the worker.
+            uint32_t StillHasWork;      // TRUE if its turn ended before its operations did.
+        } CONNECTION;
+    };
+} QUIC_FLIGHT_RECORD;
+
+//
+// Entries pre-allocated in each partition's pools when the library is first
+// used, so the first burst of traffic doesn't pay for growing them. Their
+// memory is faulted in up front, on the partition's NUMA node where possible.
+//
+typedef struct QUIC_POOL_RESERVE_CONFIG {
+    uint32_t Connections;               // Per partition.
+    uint32_t Streams;                   // Per partition.
+    uint32_t Operations;                // Per partition.
+    uint32_t SentPackets;               // Sent packet metadata, per partition and size up to 2 frames.
+    uint32_t RecvChunks;                // Default sized stream receive buffers, per partition.
+    uint32_t DatapathBuffers;           // Send and receive buffers, per datapath partition.
+} QUIC_POOL_RESERVE_CONFIG;
+#endif
+
 //
 // Functions for associating application contexts with QUIC handles. MsQuic
 // provides no explicit synchronization between parallel calls to these
@@ -973,10 +1348,29 @@ void
 #define QUIC_PARAM_GLOBAL_STATELESS_RESET_KEY           0x0100000B  // uint8_t[] - Array size is QUIC_STATELESS_RESET_KEY_LENGTH
 #define QUIC_PARAM_GLOBAL_STATISTICS_V2_SIZES           0x0100000C  // uint32_t[] - Array of sizes for each QUIC_STATISTICS_V2 version. Get-only. Pass a buffer of uint32_t, output count is variable. See documentation for details.
 #define QUIC_PARAM_GLOBAL_STATELESS_RETRY_CONFIG        0x0100000D  // QUIC_STATELESS_RETRY_CONFIG
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+#define QUIC_PARAM_GLOBAL_QUIC_LB_CONFIG                0x0100000E  // QUIC_LB_CONFIG
+#define QUIC_PARAM_GLOBAL_RSS_PARTITIONING_INTERFACE    0x0100000F  // uint32_t - Interface index, 0 disables
+#define QUIC_PARAM_GLOBAL_MEMORY_BUDGET                 0x01000010  // uint64_t - Bytes, 0 restores the default
+#define QUIC_PARAM_GLOBAL_MEMORY_USAGE                  0x01000011  // QUIC_MEMORY_USAGE
+#define QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS       0x01000012  // int64_t[][QUIC_PERF_COUNTER_MAX] - One row per partition
+#define QUIC_PARAM_GLOBAL_PARTITION_LATENCY             0x01000013  // QUIC_LATENCY_HISTOGRAMS[] - One per partition
+#define QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS            0x01000014  // QUIC_LATENCY_HISTOGRAMS - Get-only, resets them
+#define QUIC_PARAM_GLOBAL_QLOG_CONFIG                   0x01000015  // QUIC_QLOG_CONFIG - Set-only, before first use
+#define QUIC_PARAM_GLOBAL_RECV_CAPTURE                  0x01000016  // QUIC_RECV_CAPTURE_CONFIG - Set-only
+#define QUIC_PARAM_GLOBAL_FLIGHT_RECORDER               0x01000017  // QUIC_FLIGHT_RECORD[] - Get-only
+#define QUIC_PARAM_GLOBAL_POOL_RESERVE                  0x01000018  // QUIC_POOL_RESERVE_CONFIG - Set before first use
+#endif
 
 //
 // Parameters for Registration.
 //
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+#define QUIC_PARAM_REGISTRATION_PATH_TELEMETRY          0x02000000  // QUIC_PATH_TELEMETRY_CONFIG - Set before opening connections
+#define QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE     0x02000001  // QUIC_CLIENT_TICKET_CACHE_CONFIG
+#define QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE_STATS 0x02000002  // QUIC_CLIENT_TICKET_CACHE_STATISTICS - Get-only
+#define QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY     0x02000003  // QUIC_ZERORTT_ANTI_REPLAY_CONFIG - Set before opening connections
+#endif
 
 //
 // Parameters for Configuration.
@@ -997,11 +1391,19 @@ typedef struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W {
 //
 // Parameters for Listener.
 //
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+typedef struct QUIC_LISTENER_SNI_CONFIGURATION {
+    const char* ServerName;         // Host name, or "*." and a suffix to match any single label.
+    HQUIC Configuration;
+} QUIC_LISTENER_SNI_CONFIGURATION;
+#endif
 #define QUIC_PARAM_LISTENER_LOCAL_ADDRESS               0x04000000  // QUIC_ADDR
 #define QUIC_PARAM_LISTENER_STATS                       0x04000001  // QUIC_LISTENER_STATISTICS
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_LISTENER_CIBIR_ID                    0x04000002  // uint8_t[] {offset, id[]}
 #define QUIC_PARAM_LISTENER_PARTITION_INDEX             0x04000005  // uint16_t
+#define QUIC_PARAM_LISTENER_PREFERRED_ADDRESS           0x04000006  // QUIC_ADDR
+#define QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS          0x04000007  // QUIC_LISTENER_SNI_CONFIGURATION[]
 #endif
 #define QUIC_PARAM_DOS_MODE_EVENTS                      0x04000004  // BOOLEAN
 
@@ -1041,6 +1443,17 @@ typedef struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W {
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_CONN_NETWORK_STATISTICS              0x05000020  // struct QUIC_NETWORK_STATISTICS
 #define QUIC_PARAM_CONN_CLOSE_ASYNC                     0x0500001A  // uint8_t
+#define QUIC_PARAM_CONN_CUSTOM_CONGESTION_CONTROL       0x0500001B  // QUIC_CUSTOM_CONGESTION_CONTROL
+#define QUIC_PARAM_CONN_MEMORY_USAGE                    0x0500001C  // QUIC_MEMORY_USAGE
+#define QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT           0x0500001D  // uint32_t - milliseconds
+#define QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS           0x0500001E  // QUIC_ADDR
+#define QUIC_PARAM_CONN_HANDOFF_STATE                   0x0500001F  // uint8_t[]
+#define QUIC_PARAM_CONN_STREAM_CREDIT_STATISTICS        0x05000021  // QUIC_STREAM_CREDIT_STATISTICS
+#define QUIC_PARAM_CONN_PARTITION_INDEX                 0x05000022  // uint16_t
+#define QUIC_PARAM_CONN_SEND_RATE_LIMIT                 0x05000023  // uint64_t - bytes per second - 0 (default, unlimited)
+#define QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY            0x05000024  // uint32_t - milliseconds - 0 (default, disabled)
+#define QUIC_PARAM_CONN_ACK_ONLY_DSCP                   0x05000025  // uint8_t
+#define QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE            0x05000026  // QUIC_PEER_STREAM_TEMPLATE
 #endif
 
 //
@@ -1074,6 +1487,11 @@ typedef struct QUIC_SCHANNEL_CONTEXT_ATTRIBUTE_EX_W {
 #define QUIC_PARAM_STREAM_STATISTICS                    0X08000004  // QUIC_STREAM_STATISTICS
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_STREAM_RELIABLE_OFFSET               0x08000005  // uint64_t
+#define QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY           0x08000006  // QUIC_STREAM_EXTENSIBLE_PRIORITY
+#define QUIC_PARAM_STREAM_WEIGHT                        0x08000007  // uint16_t - 1 (low) to 0xFFFF (high) - 16 (default)
+#define QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING         0x08000008  // uint32_t - 1 in N send requests traced - 0 (default, disabled)
+#define QUIC_PARAM_STREAM_SEND_TIMEOUT                  0x08000009  // uint32_t - ms - 0 (default, disabled)
+#define QUIC_PARAM_STREAM_SEND_RATE_LIMIT               0x0800000A  // uint64_t - bytes per second - 0 (default, unlimited)
 #endif
 
 typedef
@@ -1316,6 +1734,35 @@ void
 // Connections
 //
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// Receive data for a single stream, as indicated in a batched
+// QUIC_CONNECTION_EVENT_STREAMS_RECEIVE event.
+//
+typedef struct QUIC_STREAM_RECEIVE_DATA {
+    /* in */    HQUIC Stream;
+    /* in */    void* StreamContext;
+    /* in */    uint64_t AbsoluteOffset;
+    /* inout */ uint64_t TotalBufferLength;
+    _Field_size_(BufferCount)
+    /* in */    const QUIC_BUFFER* Buffers;
+    _Field_range_(0, UINT32_MAX)
+    /* in */    uint32_t BufferCount;
+    /* in */    QUIC_RECEIVE_FLAGS Flags;
+    /* out */   QUIC_STATUS Status;         // Per-stream result, as if returned from QUIC_STREAM_EVENT_RECEIVE.
+} QUIC_STREAM_RECEIVE_DATA;
+
+//
+// A new peer stream, as indicated in a batched
+// QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED event.
+//
+typedef struct QUIC_PEER_STREAM_STARTED_DATA {
+    HQUIC Stream;
+    void* StreamContext;
+    QUIC_STREAM_OPEN_FLAGS Flags;
+} QUIC_PEER_STREAM_STARTED_DATA;
+#endif
+
 typedef enum QUIC_CONNECTION_EVENT_TYPE {
     QUIC_CONNECTION_EVENT_CONNECTED                         = 0,
     QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT   = 1,    // The transport started the shutdown process.
@@ -1337,6 +1784,8 @@ typedef enum QUIC_CONNECTION_EVENT_TYPE {
     QUIC_CONNECTION_EVENT_RELIABLE_RESET_NEGOTIATED         = 16,   // Only indicated if QUIC_SETTINGS.ReliableResetEnabled is TRUE.
     QUIC_CONNECTION_EVENT_ONE_WAY_DELAY_NEGOTIATED          = 17,   // Only indicated if QUIC_SETTINGS.OneWayDelayEnabled is TRUE.
     QUIC_CONNECTION_EVENT_NETWORK_STATISTICS                = 18,   // Only indicated if QUIC_SETTINGS.EnableNetStatsEvent is TRUE.
+    QUIC_CONNECTION_EVENT_STREAMS_RECEIVE                   = 19,   // Only indicated if QUIC_SETTINGS.StreamBatchReceiveEnabled is TRUE.
+    QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED              = 20,   // Only indicated if QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE is set.
 #endif
 } QUIC_CONNECTION_EVENT_TYPE;
 
@@ -1420,6 +1869,16 @@ typedef struct QUIC_CONNECTION_EVENT {
             BOOLEAN ReceiveNegotiated;          // TRUE if receiving one-way delay timestamps is negotiated.
         } ONE_WAY_DELAY_NEGOTIATED;
         QUIC_NETWORK_STATISTICS NETWORK_STATISTICS;
+        struct {
+            _Field_size_(StreamCount)
+            /* inout */ QUIC_STREAM_RECEIVE_DATA* Streams;
+            /* in */    uint32_t StreamCount;
+        } STREAMS_RECEIVE;
+        struct {
+            _Field_size_(StreamCount)
+            const QUIC_PEER_STREAM_STARTED_DATA* Streams;
+            uint32_t StreamCount;
+        } PEER_STREAMS_STARTED;
 #endif
     };
 } QUIC_CONNECTION_EVENT;
@@ -1576,6 +2035,7 @@ typedef enum QUIC_STREAM_EVENT_TYPE {
     QUIC_STREAM_EVENT_CANCEL_ON_LOSS            = 10,
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
     QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED = 11,
+    QUIC_STREAM_EVENT_SEND_LATENCY          = 12,
 #endif
 } QUIC_STREAM_EVENT_TYPE;
 
@@ -1629,6 +2089,16 @@ typedef struct QUIC_STREAM_EVENT {
         struct {
             /* in */  uint64_t BufferLengthNeeded;
         } RECEIVE_BUFFER_NEEDED;
+        struct {
+            /* in */  void* ClientContext;      // NULL for buffered sends
+            /* in */  uint64_t StreamOffset;
+            /* in */  uint64_t Length;
+            /* in */  uint64_t QueueDelayUs;    // StreamSend to queued on the stream
+            /* in */  uint64_t ScheduleDelayUs; // Queued to first byte framed
+            /* in */  uint64_t SendDurationUs;  // First to last byte framed
+            /* in */  uint64_t AckDelayUs;      // Last byte framed to fully acknowledged
+            /* in */  uint64_t CompleteDelayUs; // StreamSend to SEND_COMPLETE indicated
+        } SEND_LATENCY;
 #endif
     };
 } QUIC_STREAM_EVENT;
@@ -1645,6 +2115,35 @@ QUIC_STATUS
 
 typedef QUIC_STREAM_CALLBACK *QUIC_STREAM_CALLBACK_HANDLER;
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// Returns the context for a new peer stream accepted with a
+// QUIC_PEER_STREAM_TEMPLATE.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_PEER_STREAM_CONTEXT_FACTORY)
+void*
+(QUIC_API QUIC_PEER_STREAM_CONTEXT_FACTORY)(
+    _In_ HQUIC Connection,
+    _In_ HQUIC Stream,
+    _In_opt_ void* Context
+    );
+
+//
+// Applied to every new peer stream when set with
+// QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE. The streams are then indicated in
+// batched QUIC_CONNECTION_EVENT_PEER_STREAMS_STARTED events instead of
+// QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED.
+//
+typedef struct QUIC_PEER_STREAM_TEMPLATE {
+    QUIC_STREAM_CALLBACK_HANDLER Handler;   // NULL to go back to per-stream events.
+    void* Context;                          // The streams' context, or the factory's.
+    QUIC_PEER_STREAM_CONTEXT_FACTORY* ContextFactory; // Optional.
+    QUIC_STREAM_OPEN_FLAGS Flags;           // QUIC_STREAM_OPEN_FLAG_APP_OWNED_BUFFERS and/or DELAY_ID_FC_UPDATES.
+} QUIC_PEER_STREAM_TEMPLATE;
+#endif
+
 //
 // Opens a stream on the given connection.
 //
@@ -1710,6 +2209,96 @@ QUIC_STATUS
     _In_opt_ void* ClientSendContext
     );
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// A single stream send, submitted with others on the same connection via
+// ConnectionSendBatch.
+//
+typedef struct QUIC_SEND_BATCH_ENTRY {
+    HQUIC Stream;
+    const QUIC_BUFFER* Buffers;
+    uint32_t BufferCount;
+    QUIC_SEND_FLAGS Flags;
+    void* ClientSendContext;
+    QUIC_STATUS Status;         // Output: QUIC_STATUS_PENDING if the send was queued.
+} QUIC_SEND_BATCH_ENTRY;
+
+//
+// Sends data on several streams of the connection at once, processing them all
+// with a single connection operation. Each entry behaves as a call to
+// StreamSend; in particular, QUIC_SEND_FLAG_START and QUIC_SEND_FLAG_FIN allow
+// streams fresh from StreamOpen to be started, sent on and finished. Returns
+// QUIC_STATUS_PENDING if all sends were queued, or else the status of the first
+// entry that failed.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONNECTION_SEND_BATCH_FN)(
+    _In_ _Pre_defensive_ HQUIC Connection,
+    _In_ uint32_t EntryCount,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_SEND_BATCH_ENTRY* Entries
+    );
+
+//
+// A single new stream, opened with others on the same connection via
+// StreamOpenBatch, and the optional send queued on it once started.
+//
+typedef struct QUIC_STREAM_OPEN_BATCH_ENTRY {
+    void* Context;              // The stream's callback context.
+    const QUIC_BUFFER* Buffers;
+    uint32_t BufferCount;
+    QUIC_SEND_FLAGS Flags;      // No send is queued if zero and there are no buffers.
+    void* ClientSendContext;
+    HQUIC Stream;               // Output: the new stream, or NULL if it wasn't opened.
+    QUIC_STATUS Status;         // Output: QUIC_STATUS_PENDING if the stream's start was queued.
+} QUIC_STREAM_OPEN_BATCH_ENTRY;
+
+//
+// Opens several streams on the connection and starts them all with a single
+// connection operation, assigning them consecutive IDs. Each entry may also
+// queue a send, for instance with QUIC_SEND_FLAG_FIN, which is flushed right
+// after the streams start. Returns QUIC_STATUS_PENDING if every stream was
+// opened and its start queued, or else the status of the first entry that
+// failed. Every non-NULL Stream returned must be closed with StreamClose.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_STREAM_OPEN_BATCH_FN)(
+    _In_ _Pre_defensive_ HQUIC Connection,
+    _In_ QUIC_STREAM_OPEN_FLAGS OpenFlags,
+    _In_ QUIC_STREAM_START_FLAGS StartFlags,
+    _In_ _Pre_defensive_ QUIC_STREAM_CALLBACK_HANDLER Handler,
+    _In_ uint32_t EntryCount,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_STREAM_OPEN_BATCH_ENTRY* Entries
+    );
+
+#ifndef _KERNEL_MODE
+//
+// Sends Length bytes of an open file, starting at FileOffset, on the stream.
+// Behaves as StreamSend, except the data is read from the file straight into
+// each outgoing packet, including on retransmission, rather than being copied
+// or buffered. The file must stay open, and the range unmodified, until the
+// send completes. If the range can't be read, the stream's send direction is
+// aborted.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_STREAM_SEND_FILE_FN)(
+    _In_ _Pre_defensive_ HQUIC Stream,
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t FileOffset,
+    _In_ uint64_t Length,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    );
+#endif // _KERNEL_MODE
+#endif
+
 //
 // Completes a previously pended receive callback.
 //
@@ -1882,6 +2471,14 @@ typedef struct QUIC_API_TABLE {
     QUIC_EXECUTION_POLL_FN              ExecutionPoll;      // Available from v2.5
 #endif // _KERNEL_MODE
     QUIC_REGISTRATION_CLOSE2_FN         RegistrationClose2; // Available from v2.6
+#ifndef _KERNEL_MODE
+    QUIC_EXECUTION_POLL_BATCH_FN        ExecutionPollBatch; // Available from v2.6
+#endif // _KERNEL_MODE
+    QUIC_CONNECTION_SEND_BATCH_FN       ConnectionSendBatch; // Available from v2.6
+    QUIC_STREAM_OPEN_BATCH_FN           StreamOpenBatch;     // Available from v2.6
+#ifndef _KERNEL_MODE
+    QUIC_STREAM_SEND_FILE_FN            StreamSendFile;      // Available from v2.6
+#endif // _KERNEL_MODE
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
 
 } QUIC_API_TABLE;
@@ -735,6 +735,7 @@ public:
     MsQuicSettings& SetReliableResetEnabled(bool value) { ReliableResetEnabled = value; IsSet.ReliableResetEnabled = TRUE; return *this; }
     MsQuicSettings& SetXdpEnabled(bool value) { XdpEnabled = value; IsSet.XdpEnabled = TRUE; return *this; }
     MsQuicSettings& SetQtipEnabled(bool value) { QTIPEnabled = value; IsSet.QTIPEnabled = TRUE; return *this; }
+    MsQuicSettings& SetRioEnabled(bool value) { RioEnabled = value; IsSet.RioEnabled = TRUE; return *this; }
     MsQuicSettings& SetOneWayDelayEnabled(bool value) { OneWayDelayEnabled = value; IsSet.OneWayDelayEnabled = TRUE; return *this; }
     MsQuicSettings& SetNetStatsEventEnabled(bool value) { NetStatsEventEnabled = value; IsSet.NetStatsEventEnabled = TRUE; return *this; }
     MsQuicSettings& SetStreamMultiReceiveEnabled(bool value) { StreamMultiReceiveEnabled = value; IsSet.StreamMultiReceiveEnabled = TRUE; return *this; }
@@ -1872,6 +1873,592 @@ private:
     }
 };
 
+#if defined(CX_PLATFORM_TYPE) && defined(QUIC_API_ENABLE_PREVIEW_FEATURES)
+
+struct MsQuicConnectionPool;
+
+//
+// A connection owned by an MsQuicConnectionPool. Handed out by Acquire and
+// must be given back with Release; the handle stays valid until then, even if
+// the pool has replaced the connection in the meantime.
+//
+struct MsQuicPooledConnection {
+    enum PooledState : uint8_t {
+        Starting,   // Not started yet; not handed out.
+        Connecting,
+        Connected,
+        Draining    // Shutting down; replaced and not handed out.
+    };
+
+    MsQuicConnectionPool* Pool;
+    uint16_t Index;
+    PooledState State {Starting};
+    bool Alive {true};              // Until SHUTDOWN_COMPLETE.
+    HQUIC Handle {nullptr};
+    uint32_t Outstanding {0};       // Number of leases from Acquire.
+    uint32_t Rtt {0};               // Smoothed RTT, in microseconds.
+    uint64_t RttTime {0};
+
+    MsQuicPooledConnection(MsQuicConnectionPool* Pool, uint16_t Index) noexcept
+        : Pool(Pool), Index(Index) { }
+    operator HQUIC () const noexcept { return Handle; }
+};
+
+typedef QUIC_STATUS QUIC_API MsQuicConnectionPoolCallback(
+    _In_ MsQuicPooledConnection* Connection,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    );
+
+//
+// Keeps NumberOfConnections client connections to a server healthy.
+//
+// The connections are initially spread across RSS CPUs with
+// ConnectionPoolCreate, falling back to plain connections where that isn't
+// supported. Acquire hands out the connected connection with the fewest
+// outstanding leases, weighted by RTT. A connection that fails, or that the
+// peer starts shutting down, stops being handed out and is replaced on a
+// later Acquire: right away if it had connected, with exponential backoff if
+// it never did. Replacements reuse the old local address, to keep their RSS
+// CPU, and optionally the last resumption ticket.
+//
+// Acquire and Release may be called from any thread, but not from the pool's
+// callbacks, and must not race with the pool's destruction.
+//
+struct MsQuicConnectionPool {
+    static const uint32_t RttRefreshIntervalUs = 100 * 1000;
+    static const uint32_t MinReconnectDelayMs = 100;
+    static const uint32_t MaxReconnectDelayMs = 5000;
+
+    struct PoolSlot {
+        MsQuicPooledConnection* Current {nullptr};
+        uint64_t NextAttemptTime {0};
+        uint32_t ReconnectDelayMs {0};
+        bool Reconnecting {false};
+        bool HasLocalAddr {false};
+        QuicAddr LocalAddr;
+    };
+
+    const MsQuicRegistration& Registration;
+    const MsQuicConfiguration& Configuration;
+    char* ServerName {nullptr};
+    uint16_t ServerPort;
+    QUIC_ADDRESS_FAMILY Family;
+    uint16_t NumberOfConnections;
+    bool UseResumption;
+    MsQuicConnectionPoolCallback* Callback;
+    void* Context;
+    PoolSlot* Slots {nullptr};
+    uint8_t* ResumptionTicket {nullptr};
+    uint32_t ResumptionTicketLength {0};
+    uint32_t LiveConnections {0};
+    bool Closing {false};
+    CxPlatLock Lock;
+    CxPlatEvent AllClosedEvent {true};
+    QUIC_STATUS InitStatus;
+
+    MsQuicConnectionPool(
+        _In_ const MsQuicRegistration& Registration,
+        _In_ const MsQuicConfiguration& Configuration,
+        _In_z_ const char* ServerName,
+        _In_ uint16_t ServerPort, // Host byte order
+        _In_ uint16_t NumberOfConnections,
+        _In_ QUIC_ADDRESS_FAMILY Family = QUIC_ADDRESS_FAMILY_UNSPEC,
+        _In_ bool UseResumption = true,
+        _In_opt_ MsQuicConnectionPoolCallback* Callback = nullptr,
+        _In_opt_ void* Context = nullptr
+        ) noexcept :
+        Registration(Registration), Configuration(Configuration),
+        ServerPort(ServerPort), Family(Family),
+        NumberOfConnections(NumberOfConnections), UseResumption(UseResumption),
+        Callback(Callback), Context(Context) {
+        if (!Registration.IsValid()) {
+            InitStatus = Registration.GetInitStatus();
+            return;
+        }
+        if (!Configuration.IsValid()) {
+            InitStatus = Configuration.GetInitStatus();
+            return;
+        }
+        if (ServerName == nullptr || NumberOfConnections == 0) {
+            InitStatus = QUIC_STATUS_INVALID_PARAMETER;
+            return;
+        }
+        const size_t ServerNameLength = strlen(ServerName);
+        this->ServerName = new(std::nothrow) char[ServerNameLength + 1];
+        Slots = new(std::nothrow) PoolSlot[NumberOfConnections];
+        if (this->ServerName == nullptr || Slots == nullptr) {
+            InitStatus = QUIC_STATUS_OUT_OF_MEMORY;
+            return;
+        }
+        memcpy(this->ServerName, ServerName, ServerNameLength + 1);
+
+        InitStatus = CreateRssSpread();
+        if (QUIC_FAILED(InitStatus)) {
+            //
+            // RSS spreading isn't available (it requires XDP), so just start
+            // the connections normally. Failures are retried by Acquire.
+            //
+            for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+                InitStatus = Reconnect(i);
+                if (QUIC_FAILED(InitStatus)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    ~MsQuicConnectionPool() noexcept {
+        if (Slots != nullptr) {
+            //
+            // Connections already replaced are shutting down on their own.
+            //
+            for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+                Lock.Acquire();
+                CXPLAT_DBG_ASSERT(!Slots[i].Reconnecting);
+                MsQuicPooledConnection* Connection = Slots[i].Current;
+                if (Connection != nullptr) {
+                    Connection->Outstanding++; // Keep it around for shutdown.
+                }
+                Lock.Release();
+                if (Connection != nullptr) {
+                    MsQuic->ConnectionShutdown(
+                        Connection->Handle, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+                    Put(Connection);
+                }
+            }
+            Lock.Acquire();
+            Closing = true;
+            const bool Wait = LiveConnections != 0;
+            Lock.Release();
+            if (Wait) {
+                AllClosedEvent.WaitForever();
+            }
+            delete[] Slots;
+        }
+        delete[] ServerName;
+        delete[] ResumptionTicket;
+    }
+
+    //
+    // Returns the best connection to use, replacing any that need it first.
+    // The connection must be given back with Release once the caller is done
+    // with it (e.g. once its streams are closed).
+    //
+    QUIC_STATUS
+    Acquire(
+        _Outptr_ MsQuicPooledConnection** Connection
+        ) noexcept {
+        *Connection = nullptr;
+        for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+            (void)Reconnect(i);
+        }
+
+        MsQuicPooledConnection* Best = nullptr;
+        uint64_t BestCost = 0;
+        Lock.Acquire();
+        for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+            MsQuicPooledConnection* Candidate = Slots[i].Current;
+            if (Candidate == nullptr ||
+                Candidate->State == MsQuicPooledConnection::Starting ||
+                Candidate->State == MsQuicPooledConnection::Draining) {
+                continue;
+            }
+            //
+            // Streams opened on a connecting connection just wait for the
+            // handshake, so those are only used if none are connected.
+            //
+            const uint64_t Rtt =
+                Candidate->State == MsQuicPooledConnection::Connected ?
+                    (Candidate->Rtt != 0 ? Candidate->Rtt : 1) : UINT32_MAX;
+            const uint64_t Cost = (Candidate->Outstanding + 1) * Rtt;
+            if (Best == nullptr || Cost < BestCost) {
+                Best = Candidate;
+                BestCost = Cost;
+            }
+        }
+        if (Best != nullptr) {
+            Best->Outstanding++;
+        }
+        Lock.Release();
+
+        if (Best == nullptr) {
+            return QUIC_STATUS_INVALID_STATE; // All waiting to be replaced.
+        }
+        *Connection = Best;
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    //
+    // Gives back a connection from Acquire, refreshing its RTT if stale.
+    //
+    void
+    Release(
+        _In_ MsQuicPooledConnection* Connection
+        ) noexcept {
+        const uint64_t Now = CxPlatTimeUs64();
+        Lock.Acquire();
+        const bool Refresh =
+            Connection->State == MsQuicPooledConnection::Connected &&
+            CxPlatTimeDiff64(Connection->RttTime, Now) >= RttRefreshIntervalUs;
+        if (Refresh) {
+            Connection->RttTime = Now;
+        }
+        Lock.Release();
+
+        if (Refresh) {
+            //
+            // Queried here rather than in Acquire, as it blocks on the
+            // connection's worker and the lease keeps the handle valid.
+            //
+            QUIC_STATISTICS_V2 Stats;
+            uint32_t Size = sizeof(Stats);
+            if (QUIC_SUCCEEDED(
+                    MsQuic->GetParam(
+                        Connection->Handle,
+                        QUIC_PARAM_CONN_STATISTICS_V2,
+                        &Size,
+                        &Stats))) {
+                Lock.Acquire();
+                Connection->Rtt = Stats.Rtt;
+                Lock.Release();
+            }
+        }
+        Put(Connection);
+    }
+
+    QUIC_STATUS GetInitStatus() const noexcept { return InitStatus; }
+    bool IsValid() const { return QUIC_SUCCEEDED(InitStatus); }
+    MsQuicConnectionPool(const MsQuicConnectionPool& Other) = delete;
+    MsQuicConnectionPool& operator=(const MsQuicConnectionPool& Other) = delete;
+    MsQuicConnectionPool(MsQuicConnectionPool&& Other) = delete;
+    MsQuicConnectionPool& operator=(MsQuicConnectionPool&& Other) = delete;
+
+private:
+
+    QUIC_STATUS
+    CreateRssSpread() noexcept {
+        UniquePtrArray<MsQuicPooledConnection*> Connections(
+            new(std::nothrow) MsQuicPooledConnection*[NumberOfConnections]);
+        UniquePtrArray<HQUIC> Handles(new(std::nothrow) HQUIC[NumberOfConnections]);
+        if (Connections.get() == nullptr || Handles.get() == nullptr) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+        for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+            Connections[i] = new(std::nothrow) MsQuicPooledConnection(this, i);
+            if (Connections[i] == nullptr) {
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+            }
+        }
+
+        if (QUIC_SUCCEEDED(Status)) {
+            QUIC_CONNECTION_POOL_CONFIG PoolConfig{};
+            PoolConfig.Registration = Registration;
+            PoolConfig.Configuration = Configuration;
+            PoolConfig.Handler = (QUIC_CONNECTION_CALLBACK_HANDLER)MsQuicCallback;
+            PoolConfig.Context = (void**)Connections.get();
+            PoolConfig.ServerName = ServerName;
+            PoolConfig.Family = Family;
+            PoolConfig.ServerPort = ServerPort;
+            PoolConfig.NumberOfConnections = NumberOfConnections;
+            PoolConfig.Flags = QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE;
+
+            Lock.Acquire();
+            LiveConnections += NumberOfConnections;
+            for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+                Slots[i].Current = Connections[i];
+            }
+            Lock.Release();
+
+            Status = MsQuic->ConnectionPoolCreate(&PoolConfig, Handles.get());
+
+            Lock.Acquire();
+            if (QUIC_SUCCEEDED(Status)) {
+                for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+                    Connections[i]->Handle = Handles[i];
+                    if (Connections[i]->State == MsQuicPooledConnection::Starting) {
+                        Connections[i]->State = MsQuicPooledConnection::Connecting;
+                    }
+                    if (Connections[i]->Alive) {
+                        Connections[i] = nullptr; // Owned by the slot now.
+                    }
+                    //
+                    // Otherwise it already completed shutdown, before its
+                    // handle was known, so it's closed below.
+                    //
+                }
+            } else {
+                //
+                // The connections were closed without indicating any events.
+                //
+                LiveConnections -= NumberOfConnections;
+                for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+                    Slots[i].Current = nullptr;
+                }
+            }
+            Lock.Release();
+        }
+
+        for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+            if (Connections[i] != nullptr && Connections[i]->Handle != nullptr) {
+                MsQuic->ConnectionClose(Connections[i]->Handle);
+            }
+            delete Connections[i];
+        }
+        return Status;
+    }
+
+    //
+    // Replaces the slot's connection if it failed or is draining, and its
+    // reconnect delay has passed.
+    //
+    QUIC_STATUS
+    Reconnect(
+        _In_ uint16_t Index
+        ) noexcept {
+        PoolSlot& Slot = Slots[Index];
+        const uint64_t Now = CxPlatTimeUs64();
+        Lock.Acquire();
+        const bool NeedsReplacement =
+            !Slot.Reconnecting &&
+            (Slot.Current == nullptr ||
+             Slot.Current->State == MsQuicPooledConnection::Draining) &&
+            (int64_t)(Now - Slot.NextAttemptTime) >= 0;
+        if (!NeedsReplacement) {
+            Lock.Release();
+            return QUIC_STATUS_SUCCESS;
+        }
+        Slot.Reconnecting = true;
+        const bool HasLocalAddr = Slot.HasLocalAddr;
+        const QuicAddr LocalAddr = Slot.LocalAddr;
+        uint8_t* Ticket = nullptr;
+        uint32_t TicketLength = 0;
+        if (ResumptionTicket != nullptr) {
+            Ticket = new(std::nothrow) uint8_t[ResumptionTicketLength];
+            if (Ticket != nullptr) {
+                memcpy(Ticket, ResumptionTicket, ResumptionTicketLength);
+                TicketLength = ResumptionTicketLength;
+            }
+        }
+        Lock.Release();
+
+        //
+        // The MsQuic calls below may block on the connection's worker, which
+        // may be waiting on the lock in a callback, so they are made without
+        // holding it.
+        //
+        QUIC_STATUS Status;
+        HQUIC Handle = nullptr;
+        auto Connection = new(std::nothrow) MsQuicPooledConnection(this, Index);
+        if (Connection == nullptr) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+        Status =
+            MsQuic->ConnectionOpen(
+                Registration,
+                (QUIC_CONNECTION_CALLBACK_HANDLER)MsQuicCallback,
+                Connection,
+                &Handle);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+        Connection->Handle = Handle;
+        if (HasLocalAddr) {
+            //
+            // The same local address (and port) hashes to the same RSS CPU
+            // as the connection being replaced. Best effort.
+            //
+            (void)MsQuic->SetParam(
+                Handle, QUIC_PARAM_CONN_LOCAL_ADDRESS, sizeof(LocalAddr.SockAddr), &LocalAddr.SockAddr);
+        }
+        if (Ticket != nullptr) {
+            (void)MsQuic->SetParam(
+                Handle, QUIC_PARAM_CONN_RESUMPTION_TICKET, TicketLength, Ticket);
+        }
+
+        Lock.Acquire();
+        Slot.Current = Connection; // A draining connection finishes on its own.
+        LiveConnections++;
+        Lock.Release();
+
+        Status = MsQuic->ConnectionStart(Handle, Configuration, Family, ServerName, ServerPort);
+
+        Lock.Acquire();
+        if (QUIC_SUCCEEDED(Status)) {
+            if (Connection->State == MsQuicPooledConnection::Starting) {
+                Connection->State = MsQuicPooledConnection::Connecting;
+            }
+            Connection = nullptr;
+            Handle = nullptr;
+        } else {
+            Slot.Current = nullptr;
+            LiveConnections--;
+        }
+        Lock.Release();
+
+    Exit:
+        Lock.Acquire();
+        Slot.Reconnecting = false;
+        if (QUIC_FAILED(Status)) {
+            BackOff(Slot);
+        }
+        Lock.Release();
+        if (Handle != nullptr) {
+            MsQuic->ConnectionClose(Handle);
+        }
+        delete Connection;
+        delete[] Ticket;
+        return Status;
+    }
+
+    void
+    BackOff(
+        _In_ PoolSlot& Slot
+        ) noexcept {
+        Slot.ReconnectDelayMs =
+            Slot.ReconnectDelayMs == 0 ?
+                MinReconnectDelayMs :
+                CXPLAT_MIN(Slot.ReconnectDelayMs * 2, MaxReconnectDelayMs);
+        Slot.NextAttemptTime =
+            CxPlatTimeUs64() + (uint64_t)Slot.ReconnectDelayMs * CXPLAT_MICROSEC_PER_MS;
+        Slot.HasLocalAddr = false; // In case the old address is the problem.
+    }
+
+    void
+    Put(
+        _In_ MsQuicPooledConnection* Connection
+        ) noexcept {
+        Lock.Acquire();
+        CXPLAT_DBG_ASSERT(Connection->Outstanding != 0);
+        const bool Free = --Connection->Outstanding == 0 && !Connection->Alive;
+        Lock.Release();
+        if (Free) {
+            MsQuic->ConnectionClose(Connection->Handle);
+            delete Connection;
+        }
+    }
+
+    _IRQL_requires_max_(PASSIVE_LEVEL)
+    _Function_class_(QUIC_CONNECTION_CALLBACK)
+    static
+    QUIC_STATUS
+    QUIC_API
+    MsQuicCallback(
+        _In_ HQUIC Handle,
+        _In_opt_ MsQuicPooledConnection* Connection,
+        _Inout_ QUIC_CONNECTION_EVENT* Event
+        ) noexcept {
+        CXPLAT_DBG_ASSERT(Connection);
+        MsQuicConnectionPool* pThis = Connection->Pool;
+        PoolSlot& Slot = pThis->Slots[Connection->Index];
+        //
+        // The pool may be destroyed as soon as the last connection has
+        // completed shutdown, so don't touch it after that.
+        //
+        MsQuicConnectionPoolCallback* Callback = pThis->Callback;
+        void* Context = pThis->Context;
+        bool Free = false;
+        bool LastClosed = false;
+
+        switch (Event->Type) {
+        case QUIC_CONNECTION_EVENT_CONNECTED: {
+            QuicAddr LocalAddr;
+            uint32_t Size = sizeof(LocalAddr.SockAddr);
+            const bool HasLocalAddr =
+                QUIC_SUCCEEDED(
+                    MsQuic->GetParam(
+                        Handle, QUIC_PARAM_CONN_LOCAL_ADDRESS, &Size, &LocalAddr.SockAddr));
+            QUIC_STATISTICS_V2 Stats;
+            Size = sizeof(Stats);
+            const bool HasStats =
+                QUIC_SUCCEEDED(
+                    MsQuic->GetParam(
+                        Handle, QUIC_PARAM_CONN_STATISTICS_V2, &Size, &Stats));
+            pThis->Lock.Acquire();
+            if (Connection->State != MsQuicPooledConnection::Draining) {
+                Connection->State = MsQuicPooledConnection::Connected;
+            }
+            if (HasStats) {
+                Connection->Rtt = Stats.Rtt;
+                Connection->RttTime = CxPlatTimeUs64();
+            }
+            if (Slot.Current == Connection) {
+                Slot.ReconnectDelayMs = 0;
+                Slot.HasLocalAddr = HasLocalAddr;
+                Slot.LocalAddr = LocalAddr;
+            }
+            pThis->Lock.Release();
+            break;
+        }
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT:
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_PEER:
+            pThis->Lock.Acquire();
+            if (Slot.Current == Connection) {
+                if (Connection->State == MsQuicPooledConnection::Connected) {
+                    Slot.NextAttemptTime = CxPlatTimeUs64(); // Replace right away.
+                } else {
+                    pThis->BackOff(Slot);
+                }
+            }
+            Connection->State = MsQuicPooledConnection::Draining;
+            pThis->Lock.Release();
+            break;
+        case QUIC_CONNECTION_EVENT_RESUMPTION_TICKET_RECEIVED:
+            if (pThis->UseResumption) {
+                const uint32_t Length = Event->RESUMPTION_TICKET_RECEIVED.ResumptionTicketLength;
+                uint8_t* Ticket = new(std::nothrow) uint8_t[Length];
+                if (Ticket != nullptr) {
+                    memcpy(Ticket, Event->RESUMPTION_TICKET_RECEIVED.ResumptionTicket, Length);
+                    pThis->Lock.Acquire();
+                    uint8_t* OldTicket = pThis->ResumptionTicket;
+                    pThis->ResumptionTicket = Ticket;
+                    pThis->ResumptionTicketLength = Length;
+                    pThis->Lock.Release();
+                    delete[] OldTicket;
+                }
+            }
+            break;
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+            pThis->Lock.Acquire();
+            Connection->State = MsQuicPooledConnection::Draining;
+            Connection->Alive = false;
+            if (Slot.Current == Connection) {
+                Slot.Current = nullptr;
+            }
+            //
+            // The handle is only closed here if no leases are outstanding,
+            // and during pool creation it isn't known yet.
+            //
+            Free = Connection->Outstanding == 0 && Connection->Handle != nullptr;
+            LastClosed = --pThis->LiveConnections == 0 && pThis->Closing;
+            pThis->Lock.Release();
+            break;
+        default:
+            break;
+        }
+
+        QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+        if (Callback != nullptr) {
+            Status = Callback(Connection, Context, Event);
+        } else if (Event->Type == QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED) {
+            MsQuic->StreamClose(Event->PEER_STREAM_STARTED.Stream);
+        }
+
+        if (Free) {
+            MsQuic->ConnectionClose(Handle);
+            delete Connection;
+        }
+        if (LastClosed) {
+            pThis->AllClosedEvent.Set();
+        }
+        return Status;
+    }
+};
+
+#endif // CX_PLATFORM_TYPE && QUIC_API_ENABLE_PREVIEW_FEATURES
+
 struct ConnectionScope {
     HQUIC Handle;
     ConnectionScope() noexcept : Handle(nullptr) { }
@@ -0,0 +1,1318 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    C++20 coroutine wrappers over the MsQuic API, for apps that would rather
+    write request handling as straight line code than as per-request state
+    machines driven by callback events:
+
+        MsQuicCoTask HandleConnection(MsQuicCoPtr<MsQuicCoConnection> Connection) {
+            while (auto Stream = co_await Connection->AcceptStream()) {
+                auto Result = co_await Stream->Receive();
+                ...
+                QUIC_BUFFER Buffer { Length, Data };
+                co_await Stream->Send(&Buffer, 1, QUIC_SEND_FLAG_FIN);
+            }
+        }
+
+        while (auto Connection = co_await Listener.Accept()) {
+            HandleConnection(std::move(Connection)).Start();
+        }
+
+    Awaiting coroutines are resumed inline from the MsQuic callback that
+    completes the operation, i.e. on the connection's worker thread, so they
+    must not block, just like any other callback code.
+
+    A coroutine frame is allocated from the frame pool of the connection
+    passed as the coroutine's first parameter (directly, via one of its
+    streams or via an MsQuicCoPtr to either), so steady state request
+    handling doesn't touch the heap. Frames of other coroutines come from
+    the heap.
+
+    NOTE! Like msquic.hpp, this header file is not guaranteed to remain
+    binary compatible between releases.
+
+Supported Platforms:
+
+    Windows User mode
+    Linux User mode
+
+--*/
+
+#ifdef _WIN32
+#pragma once
+#endif
+
+#ifndef _MSQUIC_CORO_HPP_
+#define _MSQUIC_CORO_HPP_
+
+#include "msquic.hpp"
+
+#if defined(_KERNEL_MODE) || !defined(__cpp_impl_coroutine)
+#error "msquic_coro.hpp requires C++20 coroutine support in user mode"
+#endif
+
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+
+//
+// Caches coroutine frames for reuse. Blocks are bucketed by power of two
+// size and each carries a header pointing back at its pool, so a frame can
+// be freed without knowing where it was allocated. Outstanding frames hold a
+// reference on the pool, so it outlives its owner if it has to.
+//
+class MsQuicCoFramePool {
+public:
+    static constexpr uint32_t MinBlockShift = 8;        // 256 bytes
+    static constexpr uint32_t ClassCount = 5;           // Up to 4KB
+    static constexpr uint32_t MaxCachedPerClass = 64;
+
+    static
+    MsQuicCoFramePool*
+    Create() noexcept {
+        return new(std::nothrow) MsQuicCoFramePool;
+    }
+
+    void AddRef() noexcept { RefCount.fetch_add(1, std::memory_order_relaxed); }
+
+    void
+    Release() noexcept {
+        if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    //
+    // Allocates a frame from the pool, or from the heap if there isn't a pool
+    // or the frame is too big to cache. Returns nullptr on failure.
+    //
+    static
+    void*
+    Alloc(
+        _In_opt_ MsQuicCoFramePool* Pool,
+        _In_ size_t Size
+        ) noexcept {
+        const uint32_t Class = Pool ? GetClass(Size) : ClassCount;
+        Header* Block = nullptr;
+        if (Class < ClassCount) {
+            Block = Pool->Pop(Class);
+            if (!Block) {
+                Block = (Header*)::operator new(BlockSize(Class), std::nothrow);
+            }
+        } else {
+            Block = (Header*)::operator new(sizeof(Header) + Size, std::nothrow);
+        }
+        if (!Block) {
+            return nullptr;
+        }
+        Block->Class = Class;
+        if (Class < ClassCount) {
+            Block->Pool = Pool;
+            Pool->AddRef();
+        } else {
+            Block->Pool = nullptr;
+        }
+        return Block + 1;
+    }
+
+    static
+    void
+    Free(
+        _In_ void* Frame
+        ) noexcept {
+        Header* Block = (Header*)Frame - 1;
+        MsQuicCoFramePool* Pool = Block->Pool;
+        if (!Pool) {
+            ::operator delete(Block);
+            return;
+        }
+        if (!Pool->Push(Block)) {
+            ::operator delete(Block);
+        }
+        Pool->Release();
+    }
+
+    MsQuicCoFramePool(const MsQuicCoFramePool& Other) = delete;
+    MsQuicCoFramePool& operator=(const MsQuicCoFramePool& Other) = delete;
+
+private:
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header {
+        union {
+            MsQuicCoFramePool* Pool;    // While allocated.
+            Header* Next;               // While cached.
+        };
+        uint32_t Class;
+    };
+
+    std::atomic<uint32_t> RefCount {1};
+    std::mutex Lock;
+    Header* FreeLists[ClassCount] {};
+    uint32_t FreeCounts[ClassCount] {};
+
+    MsQuicCoFramePool() noexcept = default;
+
+    ~MsQuicCoFramePool() noexcept {
+        for (uint32_t i = 0; i < ClassCount; ++i) {
+            while (FreeLists[i]) {
+                Header* Block = FreeLists[i];
+                FreeLists[i] = Block->Next;
+                ::operator delete(Block);
+            }
+        }
+    }
+
+    static constexpr size_t BlockSize(uint32_t Class) { return (size_t)1 << (MinBlockShift + Class); }
+
+    static
+    uint32_t
+    GetClass(
+        _In_ size_t Size
+        ) noexcept {
+        for (uint32_t i = 0; i < ClassCount; ++i) {
+            if (sizeof(Header) + Size <= BlockSize(i)) {
+                return i;
+            }
+        }
+        return ClassCount;
+    }
+
+    Header*
+    Pop(
+        _In_ uint32_t Class
+        ) noexcept {
+        std::lock_guard<std::mutex> Guard(Lock);
+        Header* Block = FreeLists[Class];
+        if (Block) {
+            FreeLists[Class] = Block->Next;
+            FreeCounts[Class]--;
+        }
+        return Block;
+    }
+
+    bool
+    Push(
+        _In_ Header* Block
+        ) noexcept {
+        std::lock_guard<std::mutex> Guard(Lock);
+        if (FreeCounts[Block->Class] == MaxCachedPerClass) {
+            return false;
+        }
+        Block->Next = FreeLists[Block->Class];
+        FreeLists[Block->Class] = Block;
+        FreeCounts[Block->Class]++;
+        return true;
+    }
+};
+
+//
+// Anything that can supply a frame pool to a coroutine taking it as the first
+// parameter.
+//
+template<typename T>
+concept MsQuicCoFramePoolOwner =
+    requires(T& Object) {
+        { Object.GetFramePool() } -> std::same_as<MsQuicCoFramePool*>;
+    };
+
+//
+// A lazily started coroutine. It either runs detached, via Start, and frees
+// itself on completion, or is awaited by another coroutine, which resumes
+// when it completes.
+//
+class MsQuicCoTask {
+public:
+    struct promise_type;
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<>
+        await_suspend(Handle Coroutine) noexcept {
+            std::coroutine_handle<> Continuation = Coroutine.promise().Continuation;
+            if (Coroutine.promise().Detached) {
+                Coroutine.destroy();
+            }
+            return Continuation ? Continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept { }
+    };
+
+    struct promise_type {
+        std::coroutine_handle<> Continuation;
+        bool Detached {false};
+
+        MsQuicCoTask get_return_object() noexcept { return MsQuicCoTask(Handle::from_promise(*this)); }
+        static MsQuicCoTask get_return_object_on_allocation_failure() noexcept { return MsQuicCoTask(nullptr); }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept { }
+        void unhandled_exception() const noexcept { std::terminate(); }
+
+        static void* operator new(size_t Size) noexcept {
+            return MsQuicCoFramePool::Alloc(nullptr, Size);
+        }
+        template<MsQuicCoFramePoolOwner Owner, typename... Args>
+        static void* operator new(size_t Size, Owner& Object, Args&...) noexcept {
+            return MsQuicCoFramePool::Alloc(Object.GetFramePool(), Size);
+        }
+        static void operator delete(void* Frame) noexcept {
+            MsQuicCoFramePool::Free(Frame);
+        }
+    };
+
+    MsQuicCoTask(MsQuicCoTask&& Other) noexcept : Coroutine(Other.Coroutine) { Other.Coroutine = nullptr; }
+    MsQuicCoTask(const MsQuicCoTask& Other) = delete;
+    MsQuicCoTask& operator=(const MsQuicCoTask& Other) = delete;
+    MsQuicCoTask& operator=(MsQuicCoTask&& Other) = delete;
+
+    ~MsQuicCoTask() noexcept {
+        if (Coroutine) {
+            Coroutine.destroy();
+        }
+    }
+
+    //
+    // False if the frame couldn't be allocated, in which case the coroutine
+    // can't be started or awaited.
+    //
+    bool IsValid() const noexcept { return Coroutine != nullptr; }
+
+    //
+    // Runs the coroutine detached, until its first suspension point. The frame
+    // is freed when it completes.
+    //
+    bool
+    Start() noexcept {
+        if (!Coroutine) {
+            return false;
+        }
+        Handle Detached = Coroutine;
+        Coroutine = nullptr;
+        Detached.promise().Detached = true;
+        Detached.resume();
+        return true;
+    }
+
+    auto
+    operator co_await() const noexcept {
+        struct Awaiter {
+            Handle Coroutine;
+            bool await_ready() const noexcept { return !Coroutine; }
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+                Coroutine.promise().Continuation = Awaiting;
+                return Coroutine;
+            }
+            void await_resume() const noexcept { }
+        };
+        return Awaiter{Coroutine};
+    }
+
+private:
+    Handle Coroutine;
+
+    explicit MsQuicCoTask(Handle Coroutine) noexcept : Coroutine(Coroutine) { }
+};
+
+//
+// The app's reference to a coroutine connection or stream. Dropping it shuts
+// the object down (gracefully, if it hasn't already been), and the object is
+// freed once MsQuic has finished with it too.
+//
+template<class T>
+class MsQuicCoPtr {
+    T* Ptr {nullptr};
+public:
+    MsQuicCoPtr() noexcept = default;
+    explicit MsQuicCoPtr(_In_opt_ T* _Ptr) noexcept : Ptr(_Ptr) { }
+    MsQuicCoPtr(MsQuicCoPtr&& Other) noexcept : Ptr(Other.Ptr) { Other.Ptr = nullptr; }
+    MsQuicCoPtr(const MsQuicCoPtr& Other) = delete;
+    MsQuicCoPtr& operator=(const MsQuicCoPtr& Other) = delete;
+    MsQuicCoPtr&
+    operator=(MsQuicCoPtr&& Other) noexcept {
+        if (this != &Other) {
+            Reset();
+            Ptr = Other.Ptr;
+            Other.Ptr = nullptr;
+        }
+        return *this;
+    }
+    ~MsQuicCoPtr() noexcept { Reset(); }
+
+    void
+    Reset() noexcept {
+        if (Ptr) {
+            Ptr->Release();
+            Ptr = nullptr;
+        }
+    }
+
+    T* Get() const noexcept { return Ptr; }
+    T* operator->() const noexcept { return Ptr; }
+    T& operator*() const noexcept { return *Ptr; }
+    explicit operator bool() const noexcept { return Ptr != nullptr; }
+    MsQuicCoFramePool* GetFramePool() const noexcept { return Ptr ? Ptr->GetFramePool() : nullptr; }
+};
+
+class MsQuicCoConnection;
+
+struct MsQuicCoReceiveResult {
+    QUIC_STATUS Status;         // QUIC_STATUS_ABORTED if the peer aborted or the stream shut down.
+    const QUIC_BUFFER* Buffers; // Valid until the next Receive or the stream shuts down.
+    uint32_t BufferCount;
+    uint64_t TotalLength;
+    bool Fin;                   // No more data will be received.
+};
+
+class MsQuicCoStream {
+    friend class MsQuicCoConnection;
+public:
+    HQUIC Handle {nullptr};
+    QUIC_STATUS InitStatus {QUIC_STATUS_SUCCESS};
+
+    //
+    // Completes with the next chunk of received data, or with Fin set once
+    // the peer has finished sending. Data returned by the previous call is
+    // consumed first.
+    //
+    struct ReceiveAwaiter {
+        MsQuicCoStream* Stream;
+        MsQuicCoReceiveResult Result {};
+
+        bool
+        await_ready() noexcept {
+            Stream->CompletePendingReceive();
+            std::lock_guard<std::mutex> Guard(Stream->Lock);
+            return Stream->TryTakeReceive(Result);
+        }
+        bool
+        await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            std::lock_guard<std::mutex> Guard(Stream->Lock);
+            if (Stream->TryTakeReceive(Result)) {
+                return false;
+            }
+            Stream->ReceiveWaiter = Awaiting;
+            Stream->ReceiveWaiterResult = &Result;
+            return true;
+        }
+        MsQuicCoReceiveResult await_resume() const noexcept { return Result; }
+    };
+
+    //
+    // Completes once MsQuic no longer needs the buffers, which must stay valid
+    // until then.
+    //
+    struct SendAwaiter {
+        MsQuicCoStream* Stream;
+        const QUIC_BUFFER* Buffers;
+        uint32_t BufferCount;
+        QUIC_SEND_FLAGS Flags;
+        std::coroutine_handle<> Waiter;
+        QUIC_STATUS Status {QUIC_STATUS_SUCCESS};
+
+        bool await_ready() const noexcept { return false; }
+        bool
+        await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            Waiter = Awaiting;
+            //
+            // The completion may resume the coroutine on the worker thread
+            // before StreamSend even returns, so nothing in the frame can be
+            // touched after the call unless it failed.
+            //
+            QUIC_STATUS SendStatus =
+                MsQuic->StreamSend(Stream->Handle, Buffers, BufferCount, Flags, this);
+            if (QUIC_FAILED(SendStatus)) {
+                Status = SendStatus;
+                return false;
+            }
+            return true;
+        }
+        QUIC_STATUS await_resume() const noexcept { return Status; }
+    };
+
+    ReceiveAwaiter Receive() noexcept { return ReceiveAwaiter{this}; }
+
+    SendAwaiter
+    Send(
+        _In_reads_(BufferCount) const QUIC_BUFFER* Buffers,
+        _In_ uint32_t BufferCount = 1,
+        _In_ QUIC_SEND_FLAGS Flags = QUIC_SEND_FLAG_NONE
+        ) noexcept {
+        return SendAwaiter{this, Buffers, BufferCount, Flags, {}};
+    }
+
+    QUIC_STATUS
+    Shutdown(
+        _In_ _Pre_defensive_ QUIC_UINT62 ErrorCode, // Application defined error code
+        _In_ QUIC_STREAM_SHUTDOWN_FLAGS Flags = QUIC_STREAM_SHUTDOWN_FLAG_ABORT
+        ) noexcept {
+        return MsQuic->StreamShutdown(Handle, Flags, ErrorCode);
+    }
+
+    QUIC_UINT62
+    ID() const noexcept {
+        QUIC_UINT62 ID = 0;
+        uint32_t Size = sizeof(ID);
+        MsQuic->GetParam(Handle, QUIC_PARAM_STREAM_ID, &Size, &ID);
+        return ID;
+    }
+
+    MsQuicCoConnection* GetConnection() const noexcept { return Connection; }
+    MsQuicCoFramePool* GetFramePool() const noexcept;
+
+    //
+    // Drops the app's reference. Unless the stream has already shut down,
+    // this finishes sending gracefully and aborts receiving.
+    //
+    void
+    Release() noexcept {
+        if (Started && !ShutdownComplete.load(std::memory_order_acquire)) {
+            MsQuic->StreamShutdown(Handle, QUIC_STREAM_SHUTDOWN_FLAG_GRACEFUL, 0);
+            MsQuic->StreamShutdown(Handle, QUIC_STREAM_SHUTDOWN_FLAG_ABORT_RECEIVE, 0);
+        }
+        Dereference();
+    }
+
+    bool IsValid() const noexcept { return QUIC_SUCCEEDED(InitStatus); }
+    MsQuicCoStream(const MsQuicCoStream& Other) = delete;
+    MsQuicCoStream& operator=(const MsQuicCoStream& Other) = delete;
+    operator HQUIC () const noexcept { return Handle; }
+
+private:
+    MsQuicCoConnection* Connection;
+    std::atomic<uint32_t> RefCount {1};
+    std::atomic<bool> ShutdownComplete {false};
+    bool Started {false};
+    MsQuicCoStream* NextAccepted {nullptr};
+
+    //
+    // Start state, only used while OpenStream is pending.
+    //
+    std::coroutine_handle<> StartWaiter;
+    QUIC_STATUS* StartWaiterStatus {nullptr};
+
+    //
+    // Receive state, protected by Lock. At most one indication is held at a
+    // time, since MsQuic doesn't indicate more data until the app completes
+    // the pending receive.
+    //
+    // MsQuic's QUIC_BUFFER array only lives as long as the RECEIVE callback
+    // (the data it describes lives until the receive is completed), so it is
+    // copied into IndicatedBuffers.
+    //
+    std::mutex Lock;
+    std::coroutine_handle<> ReceiveWaiter;
+    MsQuicCoReceiveResult* ReceiveWaiterResult {nullptr};
+    MsQuicCoReceiveResult Indicated {};
+    bool IndicatedReady {false};
+    bool PeerSendDone {false};
+    QUIC_STATUS PeerSendStatus {QUIC_STATUS_SUCCESS};
+    uint64_t ReceiveOutstanding {0}; // Only touched by the receiving coroutine.
+    bool ReceivePartial {false};
+    QUIC_BUFFER InlineBuffers[3];
+    QUIC_BUFFER* IndicatedBuffers {InlineBuffers};
+    uint32_t IndicatedCapacity {3};
+
+    //
+    // Opens a local stream.
+    //
+    MsQuicCoStream(
+        _In_ MsQuicCoConnection* _Connection,
+        _In_ QUIC_STREAM_OPEN_FLAGS Flags
+        ) noexcept;
+
+    //
+    // Wraps a peer stream.
+    //
+    MsQuicCoStream(
+        _In_ MsQuicCoConnection* _Connection,
+        _In_ HQUIC StreamHandle
+        ) noexcept;
+
+    ~MsQuicCoStream() noexcept;
+
+    void AddRef() noexcept { RefCount.fetch_add(1, std::memory_order_relaxed); }
+
+    void
+    Dereference() noexcept {
+        if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    void
+    CompletePendingReceive() noexcept {
+        if (ReceiveOutstanding != 0) {
+            uint64_t Length = ReceiveOutstanding;
+            ReceiveOutstanding = 0;
+            MsQuic->StreamReceiveComplete(Handle, Length);
+            if (ReceivePartial) {
+                //
+                // Partially completing a receive disables further ones.
+                //
+                ReceivePartial = false;
+                MsQuic->StreamReceiveSetEnabled(Handle, TRUE);
+            }
+        }
+    }
+
+    //
+    // Requires Lock to be held. If a bigger array can't be allocated, only
+    // the data that fits is returned and the rest is indicated again once
+    // that is completed.
+    //
+    void
+    CopyIndicated(
+        _Inout_ MsQuicCoReceiveResult& Result
+        ) noexcept {
+        if (Result.BufferCount > IndicatedCapacity) {
+            auto Buffers = new(std::nothrow) QUIC_BUFFER[Result.BufferCount];
+            if (Buffers) {
+                if (IndicatedBuffers != InlineBuffers) {
+                    delete[] IndicatedBuffers;
+                }
+                IndicatedBuffers = Buffers;
+                IndicatedCapacity = Result.BufferCount;
+            } else {
+                Result.BufferCount = IndicatedCapacity;
+                Result.TotalLength = 0;
+                for (uint32_t i = 0; i < Result.BufferCount; ++i) {
+                    Result.TotalLength += Result.Buffers[i].Length;
+                }
+                Result.Fin = false;
+                ReceivePartial = true;
+            }
+        }
+        memcpy(IndicatedBuffers, Result.Buffers, Result.BufferCount * sizeof(QUIC_BUFFER));
+        Result.Buffers = IndicatedBuffers;
+    }
+
+    //
+    // Requires Lock to be held.
+    //
+    bool
+    TryTakeReceive(
+        _Out_ MsQuicCoReceiveResult& Result
+        ) noexcept {
+        if (IndicatedReady) {
+            IndicatedReady = false;
+            Result = Indicated;
+            ReceiveOutstanding = Indicated.TotalLength;
+            return true;
+        }
+        if (PeerSendDone) {
+            Result = {PeerSendStatus, nullptr, 0, 0, QUIC_SUCCEEDED(PeerSendStatus)};
+            return true;
+        }
+        return false;
+    }
+
+    //
+    // Marks the receive direction done and hands the waiter, if any, back to
+    // be resumed.
+    //
+    std::coroutine_handle<>
+    FinishReceive(
+        _In_ QUIC_STATUS Status
+        ) noexcept {
+        std::lock_guard<std::mutex> Guard(Lock);
+        std::coroutine_handle<> Waiter;
+        if (!PeerSendDone) {
+            PeerSendDone = true;
+            PeerSendStatus = Status;
+        }
+        if (ShutdownComplete.load(std::memory_order_relaxed)) {
+            IndicatedReady = false; // The buffers are no longer valid.
+        }
+        if (ReceiveWaiter && TryTakeReceive(*ReceiveWaiterResult)) {
+            Waiter = ReceiveWaiter;
+            ReceiveWaiter = nullptr;
+        }
+        return Waiter;
+    }
+
+    _IRQL_requires_max_(PASSIVE_LEVEL)
+    _Function_class_(QUIC_STREAM_CALLBACK)
+    static
+    QUIC_STATUS
+    QUIC_API
+    MsQuicCallback(
+        _In_ HQUIC /* Stream */,
+        _In_opt_ MsQuicCoStream* pThis,
+        _Inout_ QUIC_STREAM_EVENT* Event
+        ) noexcept {
+        CXPLAT_DBG_ASSERT(pThis);
+        //
+        // The stream holds a reference for MsQuic until SHUTDOWN_COMPLETE, so
+        // it is still valid after resuming a coroutine that drops the app's.
+        //
+        switch (Event->Type) {
+        case QUIC_STREAM_EVENT_START_COMPLETE: {
+            std::coroutine_handle<> Waiter = pThis->StartWaiter;
+            pThis->StartWaiter = nullptr;
+            if (Waiter) {
+                *pThis->StartWaiterStatus = Event->START_COMPLETE.Status;
+                Waiter.resume();
+            }
+            break;
+        }
+        case QUIC_STREAM_EVENT_RECEIVE: {
+            if (Event->RECEIVE.TotalBufferLength == 0) {
+                break; // FIN only, handled by PEER_SEND_SHUTDOWN.
+            }
+            std::coroutine_handle<> Waiter;
+            MsQuicCoReceiveResult Result {
+                QUIC_STATUS_SUCCESS,
+                Event->RECEIVE.Buffers,
+                Event->RECEIVE.BufferCount,
+                Event->RECEIVE.TotalBufferLength,
+                (Event->RECEIVE.Flags & QUIC_RECEIVE_FLAG_FIN) != 0 };
+            {
+                std::lock_guard<std::mutex> Guard(pThis->Lock);
+                pThis->CopyIndicated(Result);
+                if (pThis->ReceiveWaiter) {
+                    *pThis->ReceiveWaiterResult = Result;
+                    pThis->ReceiveOutstanding = Result.TotalLength;
+                    Waiter = pThis->ReceiveWaiter;
+                    pThis->ReceiveWaiter = nullptr;
+                } else {
+                    pThis->Indicated = Result;
+                    pThis->IndicatedReady = true;
+                }
+            }
+            if (Waiter) {
+                Waiter.resume();
+            }
+            return QUIC_STATUS_PENDING;
+        }
+        case QUIC_STREAM_EVENT_SEND_COMPLETE: {
+            auto Send = (SendAwaiter*)Event->SEND_COMPLETE.ClientContext;
+            if (Send) {
+                Send->Status =
+                    Event->SEND_COMPLETE.Canceled ? QUIC_STATUS_ABORTED : QUIC_STATUS_SUCCESS;
+                Send->Waiter.resume();
+            }
+            break;
+        }
+        case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
+            if (auto Waiter = pThis->FinishReceive(QUIC_STATUS_SUCCESS)) {
+                Waiter.resume();
+            }
+            break;
+        case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
+            if (auto Waiter = pThis->FinishReceive(QUIC_STATUS_ABORTED)) {
+                Waiter.resume();
+            }
+            break;
+        case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+            pThis->ShutdownComplete.store(true, std::memory_order_release);
+            pThis->ReceiveOutstanding = 0;
+            if (auto Waiter = pThis->FinishReceive(QUIC_STATUS_ABORTED)) {
+                Waiter.resume();
+            }
+            pThis->Dereference();
+            break;
+        default:
+            break;
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+class MsQuicCoConnection {
+    friend class MsQuicCoStream;
+    friend class MsQuicCoListener;
+public:
+    HQUIC Handle {nullptr};
+    QUIC_STATUS InitStatus {QUIC_STATUS_SUCCESS};
+
+    //
+    // Opens a client connection. Returns an empty pointer on failure.
+    //
+    static
+    MsQuicCoPtr<MsQuicCoConnection>
+    Open(
+        _In_ const MsQuicRegistration& Registration
+        ) noexcept {
+        MsQuicCoPtr<MsQuicCoConnection> Connection(new(std::nothrow) MsQuicCoConnection);
+        if (Connection && QUIC_SUCCEEDED(Connection->InitStatus)) {
+            Connection->InitStatus =
+                MsQuic->ConnectionOpen(
+                    Registration,
+                    (QUIC_CONNECTION_CALLBACK_HANDLER)MsQuicCallback,
+                    Connection.Get(),
+                    &Connection->Handle);
+        }
+        if (Connection && QUIC_FAILED(Connection->InitStatus)) {
+            Connection.Reset();
+        }
+        return Connection;
+    }
+
+    QUIC_STATUS
+    Start(
+        _In_ const MsQuicConfiguration& Config,
+        _In_reads_or_z_opt_(QUIC_MAX_SNI_LENGTH)
+            const char* ServerName,
+        _In_ uint16_t ServerPort // Host byte order
+        ) noexcept {
+        Started = true;
+        AddRef(); // Released on SHUTDOWN_COMPLETE.
+        QUIC_STATUS Status =
+            MsQuic->ConnectionStart(
+                Handle, Config, QUIC_ADDRESS_FAMILY_UNSPEC, ServerName, ServerPort);
+        if (QUIC_FAILED(Status)) {
+            Started = false;
+            Dereference();
+        }
+        return Status;
+    }
+
+    void
+    Shutdown(
+        _In_ _Pre_defensive_ QUIC_UINT62 ErrorCode, // Application defined error code
+        _In_ QUIC_CONNECTION_SHUTDOWN_FLAGS Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_NONE
+        ) noexcept {
+        MsQuic->ConnectionShutdown(Handle, Flags, ErrorCode);
+    }
+
+    //
+    // Completes with QUIC_STATUS_SUCCESS once the handshake completes, or with
+    // the reason the connection shut down before it could.
+    //
+    struct ConnectedAwaiter {
+        MsQuicCoConnection* Connection;
+        QUIC_STATUS Status {QUIC_STATUS_PENDING};
+
+        bool await_ready() const noexcept { return false; }
+        bool
+        await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            std::lock_guard<std::mutex> Guard(Connection->Lock);
+            if (Connection->HandshakeStatus != QUIC_STATUS_PENDING) {
+                Status = Connection->HandshakeStatus;
+                return false;
+            }
+            Connection->ConnectedWaiter = Awaiting;
+            Connection->ConnectedWaiterStatus = &Status;
+            return true;
+        }
+        QUIC_STATUS await_resume() const noexcept { return Status; }
+    };
+
+    //
+    // Opens and starts a local stream. Completes with an empty pointer if the
+    // stream couldn't be started, with the reason in Status.
+    //
+    struct OpenStreamAwaiter {
+        MsQuicCoConnection* Connection;
+        QUIC_STREAM_OPEN_FLAGS OpenFlags;
+        QUIC_STREAM_START_FLAGS StartFlags;
+        MsQuicCoStream* Stream {nullptr};
+        QUIC_STATUS Status {QUIC_STATUS_SUCCESS};
+
+        bool
+        await_ready() noexcept {
+            Stream = new(std::nothrow) MsQuicCoStream(Connection, OpenFlags);
+            if (!Stream) {
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+                return true;
+            }
+            if (QUIC_FAILED(Stream->InitStatus)) {
+                Status = Stream->InitStatus;
+                return true;
+            }
+            return false;
+        }
+        bool
+        await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            MsQuicCoStream* Local = Stream;
+            Local->StartWaiter = Awaiting;
+            Local->StartWaiterStatus = &Status;
+            Local->Started = true;
+            Local->AddRef(); // Released on SHUTDOWN_COMPLETE.
+            //
+            // With SHUTDOWN_ON_FAIL, a failed start is followed by
+            // SHUTDOWN_COMPLETE, which drops MsQuic's reference. As with sends,
+            // the frame can't be touched after the call unless it failed.
+            //
+            QUIC_STATUS StartStatus =
+                MsQuic->StreamStart(
+                    Local->Handle, StartFlags | QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL);
+            if (QUIC_FAILED(StartStatus)) {
+                Local->StartWaiter = nullptr;
+                Local->Started = false;
+                Local->Dereference();
+                Status = StartStatus;
+                return false;
+            }
+            return true;
+        }
+        MsQuicCoPtr<MsQuicCoStream>
+        await_resume() noexcept {
+            MsQuicCoPtr<MsQuicCoStream> Result(Stream);
+            if (QUIC_FAILED(Status)) {
+                Result.Reset();
+            }
+            return Result;
+        }
+    };
+
+    //
+    // Completes with the next stream started by the peer, or with an empty
+    // pointer once the connection has shut down.
+    //
+    struct AcceptStreamAwaiter {
+        MsQuicCoConnection* Connection;
+        MsQuicCoStream* Stream {nullptr};
+
+        bool await_ready() const noexcept { return false; }
+        bool
+        await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            std::lock_guard<std::mutex> Guard(Connection->Lock);
+            if (Connection->TryTakeStream(Stream) ||
+                Connection->ShutdownComplete.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            Connection->StreamWaiter = Awaiting;
+            Connection->StreamWaiterResult = &Stream;
+            return true;
+        }
+        MsQuicCoPtr<MsQuicCoStream> await_resume() const noexcept { return MsQuicCoPtr<MsQuicCoStream>(Stream); }
+    };
+
+    ConnectedAwaiter Connected() noexcept { return ConnectedAwaiter{this}; }
+
+    OpenStreamAwaiter
+    OpenStream(
+        _In_ QUIC_STREAM_OPEN_FLAGS OpenFlags = QUIC_STREAM_OPEN_FLAG_NONE,
+        _In_ QUIC_STREAM_START_FLAGS StartFlags = QUIC_STREAM_START_FLAG_NONE
+        ) noexcept {
+        return OpenStreamAwaiter{this, OpenFlags, StartFlags};
+    }
+
+    AcceptStreamAwaiter AcceptStream() noexcept { return AcceptStreamAwaiter{this}; }
+
+    MsQuicCoFramePool* GetFramePool() const noexcept { return FramePool; }
+
+    //
+    // Drops the app's reference, shutting the connection down if it hasn't
+    // already.
+    //
+    void
+    Release() noexcept {
+        if (Started && !ShutdownComplete.load(std::memory_order_acquire)) {
+            Shutdown(0);
+        }
+        Dereference();
+    }
+
+    bool IsValid() const noexcept { return QUIC_SUCCEEDED(InitStatus); }
+    MsQuicCoConnection(const MsQuicCoConnection& Other) = delete;
+    MsQuicCoConnection& operator=(const MsQuicCoConnection& Other) = delete;
+    operator HQUIC () const noexcept { return Handle; }
+
+private:
+    MsQuicCoFramePool* FramePool;
+    std::atomic<uint32_t> RefCount {1};
+    std::atomic<bool> ShutdownComplete {false};
+    bool Started {false};
+    MsQuicCoConnection* NextAccepted {nullptr};
+
+    //
+    // Protected by Lock.
+    //
+    std::mutex Lock;
+    QUIC_STATUS HandshakeStatus {QUIC_STATUS_PENDING};
+    std::coroutine_handle<> ConnectedWaiter;
+    QUIC_STATUS* ConnectedWaiterStatus {nullptr};
+    std::coroutine_handle<> StreamWaiter;
+    MsQuicCoStream** StreamWaiterResult {nullptr};
+    MsQuicCoStream* PeerStreamsHead {nullptr};
+    MsQuicCoStream** PeerStreamsTail {&PeerStreamsHead};
+
+    MsQuicCoConnection() noexcept : FramePool(MsQuicCoFramePool::Create()) {
+        if (!FramePool) {
+            InitStatus = QUIC_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    //
+    // Wraps a connection accepted by a listener.
+    //
+    MsQuicCoConnection(
+        _In_ HQUIC ConnectionHandle
+        ) noexcept : MsQuicCoConnection() {
+        if (QUIC_FAILED(InitStatus)) {
+            return;
+        }
+        Handle = ConnectionHandle;
+        Started = true;
+        AddRef(); // Released on SHUTDOWN_COMPLETE.
+        MsQuic->SetCallbackHandler(Handle, (void*)MsQuicCallback, this);
+    }
+
+    ~MsQuicCoConnection() noexcept {
+        if (Handle) {
+            MsQuic->ConnectionClose(Handle);
+        }
+        if (FramePool) {
+            FramePool->Release();
+        }
+    }
+
+    void AddRef() noexcept { RefCount.fetch_add(1, std::memory_order_relaxed); }
+
+    void
+    Dereference() noexcept {
+        if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    //
+    // Requires Lock to be held.
+    //
+    bool
+    TryTakeStream(
+        _Out_ MsQuicCoStream*& Stream
+        ) noexcept {
+        Stream = PeerStreamsHead;
+        if (!Stream) {
+            return false;
+        }
+        PeerStreamsHead = Stream->NextAccepted;
+        if (!PeerStreamsHead) {
+            PeerStreamsTail = &PeerStreamsHead;
+        }
+        Stream->NextAccepted = nullptr;
+        return true;
+    }
+
+    //
+    // Records the handshake result, if not already known, and hands the
+    // waiter, if any, back to be resumed.
+    //
+    std::coroutine_handle<>
+    SetHandshakeStatus(
+        _In_ QUIC_STATUS Status
+        ) noexcept {
+        std::lock_guard<std::mutex> Guard(Lock);
+        std::coroutine_handle<> Waiter;
+        if (HandshakeStatus == QUIC_STATUS_PENDING) {
+            HandshakeStatus = Status;
+        }
+        if (ConnectedWaiter) {
+            *ConnectedWaiterStatus = HandshakeStatus;
+            Waiter = ConnectedWaiter;
+            ConnectedWaiter = nullptr;
+        }
+        return Waiter;
+    }
+
+    _IRQL_requires_max_(PASSIVE_LEVEL)
+    _Function_class_(QUIC_CONNECTION_CALLBACK)
+    static
+    QUIC_STATUS
+    QUIC_API
+    MsQuicCallback(
+        _In_ HQUIC /* Connection */,
+        _In_opt_ MsQuicCoConnection* pThis,
+        _Inout_ QUIC_CONNECTION_EVENT* Event
+        ) noexcept {
+        CXPLAT_DBG_ASSERT(pThis);
+        switch (Event->Type) {
+        case QUIC_CONNECTION_EVENT_CONNECTED:
+            if (auto Waiter = pThis->SetHandshakeStatus(QUIC_STATUS_SUCCESS)) {
+                Waiter.resume();
+            }
+            break;
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT:
+            if (auto Waiter = pThis->SetHandshakeStatus(Event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status)) {
+                Waiter.resume();
+            }
+            break;
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_PEER:
+            if (auto Waiter = pThis->SetHandshakeStatus(QUIC_STATUS_ABORTED)) {
+                Waiter.resume();
+            }
+            break;
+        case QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED: {
+            auto Stream =
+                new(std::nothrow) MsQuicCoStream(pThis, Event->PEER_STREAM_STARTED.Stream);
+            if (!Stream) {
+                MsQuic->StreamClose(Event->PEER_STREAM_STARTED.Stream);
+                break;
+            }
+            std::coroutine_handle<> Waiter;
+            {
+                std::lock_guard<std::mutex> Guard(pThis->Lock);
+                if (pThis->StreamWaiter) {
+                    *pThis->StreamWaiterResult = Stream;
+                    Waiter = pThis->StreamWaiter;
+                    pThis->StreamWaiter = nullptr;
+                } else {
+                    *pThis->PeerStreamsTail = Stream;
+                    pThis->PeerStreamsTail = &Stream->NextAccepted;
+                }
+            }
+            if (Waiter) {
+                Waiter.resume();
+            }
+            break;
+        }
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE: {
+            pThis->ShutdownComplete.store(true, std::memory_order_release);
+            if (auto Waiter = pThis->SetHandshakeStatus(QUIC_STATUS_ABORTED)) {
+                Waiter.resume();
+            }
+            std::coroutine_handle<> Waiter;
+            MsQuicCoStream* Unaccepted;
+            {
+                std::lock_guard<std::mutex> Guard(pThis->Lock);
+                Waiter = pThis->StreamWaiter;
+                pThis->StreamWaiter = nullptr;
+                Unaccepted = pThis->PeerStreamsHead;
+                pThis->PeerStreamsHead = nullptr;
+                pThis->PeerStreamsTail = &pThis->PeerStreamsHead;
+            }
+            if (Waiter) {
+                Waiter.resume(); // With an empty pointer.
+            }
+            while (Unaccepted) {
+                MsQuicCoStream* Next = Unaccepted->NextAccepted;
+                Unaccepted->Release();
+                Unaccepted = Next;
+            }
+            pThis->Dereference();
+            break;
+        }
+        default:
+            break;
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+inline
+MsQuicCoStream::MsQuicCoStream(
+    _In_ MsQuicCoConnection* _Connection,
+    _In_ QUIC_STREAM_OPEN_FLAGS Flags
+    ) noexcept : Connection(_Connection) {
+    Connection->AddRef();
+    if (QUIC_FAILED(
+        InitStatus =
+            MsQuic->StreamOpen(
+                *Connection,
+                Flags,
+                (QUIC_STREAM_CALLBACK_HANDLER)MsQuicCallback,
+                this,
+                &Handle))) {
+        Handle = nullptr;
+    }
+}
+
+inline
+MsQuicCoStream::MsQuicCoStream(
+    _In_ MsQuicCoConnection* _Connection,
+    _In_ HQUIC StreamHandle
+    ) noexcept : Handle(StreamHandle), Connection(_Connection) {
+    Connection->AddRef();
+    Started = true;
+    AddRef(); // Released on SHUTDOWN_COMPLETE.
+    MsQuic->SetCallbackHandler(Handle, (void*)MsQuicCallback, this);
+}
+
+inline
+MsQuicCoStream::~MsQuicCoStream() noexcept {
+    if (Handle) {
+        MsQuic->StreamClose(Handle);
+    }
+    if (IndicatedBuffers != InlineBuffers) {
+        delete[] IndicatedBuffers;
+    }
+    Connection->Dereference();
+}
+
+inline
+MsQuicCoFramePool*
+MsQuicCoStream::GetFramePool() const noexcept {
+    return Connection->GetFramePool();
+}
+
+class MsQuicCoListener {
+public:
+    HQUIC Handle {nullptr};
+    QUIC_STATUS InitStatus;
+
+    //
+    // Completes with the next accepted connection, or with an empty pointer
+    // once the listener has stopped. Connections are accepted with the
+    // listener's configuration, and are delivered while the handshake is
+    // still in progress; await Connected to wait for it.
+    //
+    struct AcceptAwaiter {
+        MsQuicCoListener* Listener;
+        MsQuicCoConnection* Connection {nullptr};
+
+        bool await_ready() const noexcept { return false; }
+        bool
+        await_suspend(std::coroutine_handle<> Awaiting) noexcept {
+            std::lock_guard<std::mutex> Guard(Listener->Lock);
+            if (Listener->TryTakeConnection(Connection) || Listener->Stopped) {
+                return false;
+            }
+            Listener->AcceptWaiter = Awaiting;
+            Listener->AcceptWaiterResult = &Connection;
+            return true;
+        }
+        MsQuicCoPtr<MsQuicCoConnection> await_resume() const noexcept { return MsQuicCoPtr<MsQuicCoConnection>(Connection); }
+    };
+
+    MsQuicCoListener(
+        _In_ const MsQuicRegistration& Registration,
+        _In_ const MsQuicConfiguration& _Configuration
+        ) noexcept : Configuration(_Configuration) {
+        if (!Registration.IsValid()) {
+            InitStatus = Registration.GetInitStatus();
+            return;
+        }
+        if (QUIC_FAILED(
+            InitStatus =
+                MsQuic->ListenerOpen(
+                    Registration,
+                    (QUIC_LISTENER_CALLBACK_HANDLER)MsQuicCallback,
+                    this,
+                    &Handle))) {
+            Handle = nullptr;
+        }
+    }
+
+    ~MsQuicCoListener() noexcept {
+        if (Handle) {
+            MsQuic->ListenerClose(Handle);
+        }
+        MsQuicCoConnection* Connection;
+        while (TryTakeConnection(Connection)) {
+            Connection->Release();
+        }
+    }
+
+    QUIC_STATUS
+    Start(
+        _In_ const MsQuicAlpn& Alpns,
+        _In_opt_ const QUIC_ADDR* Address = nullptr
+        ) noexcept {
+        {
+            std::lock_guard<std::mutex> Guard(Lock);
+            Stopped = false;
+        }
+        return MsQuic->ListenerStart(Handle, Alpns, Alpns.Length(), Address);
+    }
+
+    void
+    Stop() noexcept {
+        MsQuic->ListenerStop(Handle);
+    }
+
+    AcceptAwaiter Accept() noexcept { return AcceptAwaiter{this}; }
+
+    QUIC_STATUS GetInitStatus() const noexcept { return InitStatus; }
+    bool IsValid() const noexcept { return QUIC_SUCCEEDED(InitStatus); }
+    MsQuicCoListener(const MsQuicCoListener& Other) = delete;
+    MsQuicCoListener& operator=(const MsQuicCoListener& Other) = delete;
+    operator HQUIC () const noexcept { return Handle; }
+
+private:
+    const MsQuicConfiguration& Configuration;
+
+    //
+    // Protected by Lock.
+    //
+    std::mutex Lock;
+    bool Stopped {true};
+    std::coroutine_handle<> AcceptWaiter;
+    MsQuicCoConnection** AcceptWaiterResult {nullptr};
+    MsQuicCoConnection* BacklogHead {nullptr};
+    MsQuicCoConnection** BacklogTail {&BacklogHead};
+
+    //
+    // Requires Lock to be held, except once the listener is closed.
+    //
+    bool
+    TryTakeConnection(
+        _Out_ MsQuicCoConnection*& Connection
+        ) noexcept {
+        Connection = BacklogHead;
+        if (!Connection) {
+            return false;
+        }
+        BacklogHead = Connection->NextAccepted;
+        if (!BacklogHead) {
+            BacklogTail = &BacklogHead;
+        }
+        Connection->NextAccepted = nullptr;
+        return true;
+    }
+
+    _IRQL_requires_max_(PASSIVE_LEVEL)
+    _Function_class_(QUIC_LISTENER_CALLBACK)
+    static
+    QUIC_STATUS
+    QUIC_API
+    MsQuicCallback(
+        _In_ HQUIC /* Listener */,
+        _In_opt_ MsQuicCoListener* pThis,
+        _Inout_ QUIC_LISTENER_EVENT* Event
+        ) noexcept {
+        CXPLAT_DBG_ASSERT(pThis);
+        std::coroutine_handle<> Waiter;
+        if (Event->Type == QUIC_LISTENER_EVENT_NEW_CONNECTION) {
+            //
+            // Failing the event rejects the connection, so only take it over
+            // once nothing else can fail.
+            //
+            QUIC_STATUS Status =
+                MsQuic->ConnectionSetConfiguration(
+                    Event->NEW_CONNECTION.Connection, pThis->Configuration);
+            if (QUIC_FAILED(Status)) {
+                return Status;
+            }
+            auto Connection =
+                new(std::nothrow) MsQuicCoConnection(Event->NEW_CONNECTION.Connection);
+            if (!Connection) {
+                return QUIC_STATUS_OUT_OF_MEMORY;
+            }
+            if (QUIC_FAILED(Connection->InitStatus)) {
+                Status = Connection->InitStatus;
+                delete Connection;
+                return Status;
+            }
+            std::lock_guard<std::mutex> Guard(pThis->Lock);
+            if (pThis->AcceptWaiter) {
+                *pThis->AcceptWaiterResult = Connection;
+                Waiter = pThis->AcceptWaiter;
+                pThis->AcceptWaiter = nullptr;
+            } else {
+                *pThis->BacklogTail = Connection;
+                pThis->BacklogTail = &Connection->NextAccepted;
+            }
+        } else if (Event->Type == QUIC_LISTENER_EVENT_STOP_COMPLETE) {
+            std::lock_guard<std::mutex> Guard(pThis->Lock);
+            pThis->Stopped = true;
+            Waiter = pThis->AcceptWaiter; // Resumed with an empty pointer.
+            pThis->AcceptWaiter = nullptr;
+        }
+        if (Waiter) {
+            Waiter.resume();
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+#endif // _MSQUIC_CORO_HPP_
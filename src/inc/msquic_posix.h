@@ -529,6 +529,13 @@ QuicAddrToString(
     return TRUE;
 }
 
+//
+// File Abstraction
+//
+
+typedef int QUIC_FILE_HANDLE;
+#define QUIC_FILE_HANDLE_INVALID -1
+
 //
 // Event Queue Abstraction
 //
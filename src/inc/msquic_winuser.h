@@ -378,6 +378,13 @@ QuicAddrToString(
 
 #endif // WINAPI_FAMILY != WINAPI_FAMILY_GAMES
 
+//
+// File Abstraction
+//
+
+typedef HANDLE QUIC_FILE_HANDLE;
+#define QUIC_FILE_HANDLE_INVALID INVALID_HANDLE_VALUE
+
 //
 // Event Queue Abstraction
 //
@@ -199,6 +199,13 @@ DumpMsQuicPerfCounters(
     printf("  SEND_STATELESS_RESET:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_STATELESS_RESET]);
     printf("  SEND_STATELESS_RETRY:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_STATELESS_RETRY]);
     printf("  CONN_LOAD_REJECT:      %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_CONN_LOAD_REJECT]);
+    printf("  WORK_BUSY_TIME:        %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_WORK_BUSY_TIME]);
+    printf("  MEMORY_USAGE:          %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_MEMORY_USAGE]);
+    printf("  CONN_HIBERNATING:      %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_CONN_HIBERNATING]);
+    printf("  ZERORTT_REPLAY_REJECT: %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_ZERORTT_REPLAY_REJECT]);
+    printf("  XDP_BUSY_POLL_TIME:    %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_XDP_BUSY_POLL_TIME]);
+    printf("  XDP_SLEEP_TIME:        %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_XDP_SLEEP_TIME]);
+    printf("  XDP_INTERRUPT_TIME:    %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_XDP_INTERRUPT_TIME]);
 }
 
 //
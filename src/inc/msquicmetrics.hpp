@@ -0,0 +1,278 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Formats MsQuic's perf counters and latency histograms as OpenMetrics text
+    (the Prometheus exposition format), so apps don't each need their own
+    glue to export them.
+
+    The app calls MsQuicMetrics::Write whenever it's scraped, and serves the
+    output from its own HTTP endpoint. Nothing is allocated per scrape.
+
+    NOTE! This header file not guaranteed to remain binary compatible between
+    releases. It is included here for convenience only.
+
+Supported Platforms:
+
+    Windows User mode
+    Linux User mode
+
+--*/
+
+#ifdef _WIN32
+#pragma once
+#endif
+
+#ifndef _MSQUICMETRICS_HPP_
+#define _MSQUICMETRICS_HPP_
+
+#include "msquic.hpp"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+struct MsQuicPerfCounterInfo {
+    const char* Name;
+    const char* Help;
+    bool IsCounter; // Otherwise a gauge.
+};
+
+//
+// Must be kept in the order of QUIC_PERFORMANCE_COUNTERS.
+//
+static const MsQuicPerfCounterInfo MsQuicPerfCounterInfos[] = {
+    { "msquic_conn_created", "Connections ever allocated.", true },
+    { "msquic_conn_handshake_fail", "Connections that failed during handshake.", true },
+    { "msquic_conn_app_reject", "Connections rejected by the application.", true },
+    { "msquic_conn_resumed", "Connections resumed.", true },
+    { "msquic_conn_active", "Connections currently allocated.", false },
+    { "msquic_conn_connected", "Connections currently in the connected state.", false },
+    { "msquic_conn_protocol_errors", "Connections shutdown with a protocol error.", true },
+    { "msquic_conn_no_alpn", "Connection attempts with no matching ALPN.", true },
+    { "msquic_strm_active", "Streams currently allocated.", false },
+    { "msquic_pkts_suspected_lost", "Packets suspected lost.", true },
+    { "msquic_pkts_dropped", "Packets dropped for any reason.", true },
+    { "msquic_pkts_decryption_fail", "Packets with decryption failures.", true },
+    { "msquic_udp_recv", "UDP datagrams received.", true },
+    { "msquic_udp_send", "UDP datagrams sent.", true },
+    { "msquic_udp_recv_bytes", "UDP payload bytes received.", true },
+    { "msquic_udp_send_bytes", "UDP payload bytes sent.", true },
+    { "msquic_udp_recv_events", "UDP receive events.", true },
+    { "msquic_udp_send_calls", "UDP send API calls.", true },
+    { "msquic_app_send_bytes", "Bytes sent by applications.", true },
+    { "msquic_app_recv_bytes", "Bytes received by applications.", true },
+    { "msquic_conn_queue_depth", "Connections currently queued for processing.", false },
+    { "msquic_conn_oper_queue_depth", "Connection operations currently queued.", false },
+    { "msquic_conn_oper_queued", "Connection operations queued.", true },
+    { "msquic_conn_oper_completed", "Connection operations processed.", true },
+    { "msquic_work_oper_queue_depth", "Worker operations currently queued.", false },
+    { "msquic_work_oper_queued", "Worker operations queued.", true },
+    { "msquic_work_oper_completed", "Worker operations processed.", true },
+    { "msquic_path_validated", "Path challenges that succeeded.", true },
+    { "msquic_path_failure", "Path challenges that failed.", true },
+    { "msquic_send_stateless_reset", "Stateless reset packets sent.", true },
+    { "msquic_send_stateless_retry", "Stateless retry packets sent.", true },
+    { "msquic_conn_load_reject", "Connections rejected due to worker load.", true },
+    { "msquic_listen_queue_depth", "Listeners currently queued for processing.", false },
+    { "msquic_work_busy_time_us", "Time workers spent processing connections, in microseconds.", true },
+    { "msquic_memory_usage_bytes", "Memory currently used by buffered stream data and connection state.", false },
+    { "msquic_conn_hibernating", "Connections currently hibernating.", false },
+};
+
+static_assert(
+    sizeof(MsQuicPerfCounterInfos) / sizeof(MsQuicPerfCounterInfos[0]) == QUIC_PERF_COUNTER_MAX,
+    "MsQuicPerfCounterInfos must have an entry for each perf counter");
+
+#define MSQUIC_METRICS_MAX_PARTITIONS 256
+
+class MsQuicMetrics {
+
+    //
+    // Formats into the caller's buffer, counting what doesn't fit so the
+    // required length can be returned.
+    //
+    struct Writer {
+        char* Buffer;
+        size_t Length;
+        size_t Offset {0};
+        Writer(char* Buffer, size_t Length) noexcept : Buffer(Buffer), Length(Length) { }
+#ifdef __GNUC__
+        __attribute__((format(printf, 2, 3)))
+#endif
+        void Print(const char* Format, ...) noexcept {
+            va_list Args;
+            va_start(Args, Format);
+            const size_t Avail = Offset < Length ? Length - Offset : 0;
+            const int Written =
+                vsnprintf(Avail != 0 ? Buffer + Offset : nullptr, Avail, Format, Args);
+            va_end(Args);
+            if (Written > 0) {
+                Offset += (size_t)Written;
+            }
+        }
+    };
+
+    bool PerPartition;
+    uint32_t PartitionCount {0};
+    int64_t PartitionCounters[MSQUIC_METRICS_MAX_PARTITIONS][QUIC_PERF_COUNTER_MAX];
+
+#ifdef QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS
+    //
+    // Reading the library's histograms resets them, so they are accumulated
+    // here to give the cumulative counts OpenMetrics expects.
+    //
+    QUIC_LATENCY_HISTOGRAMS Histograms {};
+    QUIC_LATENCY_HISTOGRAMS Delta {};
+#endif
+
+    void WriteCounter(
+        Writer& Out,
+        const MsQuicPerfCounterInfo& Info,
+        const char* Labels,
+        int64_t Value
+        ) noexcept {
+        Out.Print(
+            "%s%s%s %lld\n",
+            Info.Name,
+            Info.IsCounter ? "_total" : "",
+            Labels,
+            (long long)Value);
+    }
+
+    void WriteCounters(Writer& Out, const int64_t* Counters) noexcept {
+        for (uint32_t i = 0; i < QUIC_PERF_COUNTER_MAX; ++i) {
+            const MsQuicPerfCounterInfo& Info = MsQuicPerfCounterInfos[i];
+            Out.Print(
+                "# TYPE %s %s\n# HELP %s %s\n",
+                Info.Name,
+                Info.IsCounter ? "counter" : "gauge",
+                Info.Name,
+                Info.Help);
+            if (Counters != nullptr) {
+                WriteCounter(Out, Info, "", Counters[i]);
+            } else {
+                for (uint32_t j = 0; j < PartitionCount; ++j) {
+                    char Labels[32];
+                    snprintf(Labels, sizeof(Labels), "{partition=\"%u\"}", j);
+                    WriteCounter(Out, Info, Labels, PartitionCounters[j][i]);
+                }
+            }
+        }
+    }
+
+#ifdef QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS
+    void WriteHistogram(
+        Writer& Out,
+        const char* Name,
+        const char* Help,
+        const uint64_t* Buckets
+        ) noexcept {
+        Out.Print(
+            "# TYPE %s histogram\n# HELP %s %s\n# UNIT %s seconds\n",
+            Name, Name, Help, Name);
+        uint64_t Count = 0;
+        for (uint32_t i = 0; i < QUIC_LATENCY_BUCKET_COUNT - 1; ++i) {
+            Count += Buckets[i];
+            //
+            // Samples are whole microseconds, so a bucket's inclusive upper
+            // bound is one less than the next bucket's lower bound.
+            //
+            const uint64_t UpperUs = QUIC_LATENCY_BUCKET_MIN_US(i + 1) - 1;
+            Out.Print(
+                "%s_bucket{le=\"%llu.%06llu\"} %llu\n",
+                Name,
+                (unsigned long long)(UpperUs / 1000000),
+                (unsigned long long)(UpperUs % 1000000),
+                (unsigned long long)Count);
+        }
+        Count += Buckets[QUIC_LATENCY_BUCKET_COUNT - 1];
+        Out.Print("%s_bucket{le=\"+Inf\"} %llu\n", Name, (unsigned long long)Count);
+        Out.Print("%s_count %llu\n", Name, (unsigned long long)Count);
+    }
+#endif
+
+public:
+
+    //
+    // PerPartition labels each perf counter by partition, instead of only
+    // reporting library wide totals.
+    //
+    MsQuicMetrics(bool PerPartition = false) noexcept : PerPartition(PerPartition) { }
+
+    MsQuicMetrics(const MsQuicMetrics&) = delete;
+    MsQuicMetrics& operator=(const MsQuicMetrics&) = delete;
+
+    //
+    // Samples the library's current metrics and formats them into Buffer.
+    // Returns the length of the output, which is larger than Length if it
+    // didn't fit, in which case the caller should retry with a larger buffer.
+    // Only one instance should be used per process, since the library's
+    // histograms are reset by each sample.
+    //
+    size_t Write(_Out_writes_bytes_(Length) char* Buffer, size_t Length) noexcept {
+        Writer Out(Buffer, Length);
+
+        if (PerPartition) {
+            uint32_t BufferLength = sizeof(PartitionCounters);
+            if (QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    nullptr,
+                    QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS,
+                    &BufferLength,
+                    PartitionCounters))) {
+                PartitionCount = BufferLength / sizeof(PartitionCounters[0]);
+            } else {
+                PartitionCount = 0;
+            }
+            WriteCounters(Out, nullptr);
+        } else {
+            int64_t Counters[QUIC_PERF_COUNTER_MAX] = {0};
+            uint32_t BufferLength = sizeof(Counters);
+            (void)MsQuic->GetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_PERF_COUNTERS,
+                &BufferLength,
+                Counters);
+            WriteCounters(Out, Counters);
+        }
+
+#ifdef QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS
+        uint32_t BufferLength = sizeof(Delta);
+        if (QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_LATENCY_HISTOGRAMS,
+                &BufferLength,
+                &Delta))) {
+            uint64_t* Total = (uint64_t*)&Histograms;
+            const uint64_t* Sampled = (const uint64_t*)&Delta;
+            for (uint32_t i = 0; i < sizeof(Histograms) / sizeof(uint64_t); ++i) {
+                Total[i] += Sampled[i];
+            }
+        }
+        WriteHistogram(
+            Out, "msquic_queue_delay_seconds",
+            "Time connections waited in a worker's queue.", Histograms.QueueDelay);
+        WriteHistogram(
+            Out, "msquic_drain_time_seconds",
+            "Time spent draining a connection's operations.", Histograms.DrainTime);
+        WriteHistogram(
+            Out, "msquic_handshake_seconds",
+            "Time from connection start to handshake confirmation.", Histograms.Handshake);
+        WriteHistogram(
+            Out, "msquic_smoothed_rtt_seconds",
+            "Smoothed RTT of connections when they shut down.", Histograms.SmoothedRtt);
+        WriteHistogram(
+            Out, "msquic_send_complete_seconds",
+            "Time from StreamSend to its successful completion.", Histograms.SendComplete);
+#endif
+
+        Out.Print("# EOF\n");
+        return Out.Offset;
+    }
+};
+
+#endif // _MSQUICMETRICS_HPP_
@@ -126,6 +126,115 @@ typedef struct QUIC_PRIVATE_TRANSPORT_PARAMETER {
 //
 #define QUIC_PARAM_GLOBAL_DATAPATH_DSCP_RECV_ENABLED    0x81000007 // BOOLEAN
 
+//
+// Sets whether the datapath will be initialized with zero-copy transmit for
+// large segmented sends (MSG_ZEROCOPY on Linux). Must be set before the
+// library is first used.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_ZEROCOPY_SEND_ENABLED 0x81000008 // BOOLEAN
+
+//
+// Sets whether paced sends are handed to the kernel with an earliest departure
+// time (SO_TXTIME on Linux) instead of being released by the pacing timer. The
+// fq qdisc must be installed on the egress interface for this to pace. Must be
+// set before the library is first used.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_TXTIME_PACING_ENABLED 0x81000009 // BOOLEAN
+
+//
+// Sets whether listener sockets steer received packets to the partition
+// encoded in the destination CID (a SO_REUSEPORT BPF program on Linux) instead
+// of by the receiving CPU. Only applies to bindings created afterwards.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_CID_STEERING_ENABLED 0x8100000A // BOOLEAN
+
+//
+// Sets the number of dedicated threads that run the TLS processing of a
+// server's first handshake flight, off the connection's worker. Zero (the
+// default) processes it inline. Must be set before the library is first used.
+//
+#define QUIC_PARAM_GLOBAL_HANDSHAKE_THREAD_COUNT        0x8100000B // uint16_t
+
+//
+// Sets the number of resumption tickets each partition keeps in a stateful
+// server ticket cache. Clients are then sent a short reference instead of the
+// full ticket, and only cached tickets are accepted. Zero (the default) sends
+// stateless tickets. Must be set before the library is first used.
+//
+#define QUIC_PARAM_GLOBAL_SERVER_TICKET_CACHE_SIZE      0x8100000C // uint32_t
+
+//
+// Removes all tickets from the server ticket cache, revoking resumption for
+// every ticket issued so far without rotating the ticket keys.
+//
+#define QUIC_PARAM_GLOBAL_SERVER_TICKET_CACHE_FLUSH     0x8100000D // No buffer
+
+//
+// Sets the headroom, as a percentage on top of the estimated bandwidth-delay
+// product, that connections indicate as their ideal send buffer size when the
+// congestion controller measures a delivery rate (BBR). Zero (the default)
+// keeps sizing it in coarse steps from the largest bytes in flight.
+//
+#define QUIC_PARAM_GLOBAL_IDEAL_SEND_BUFFER_HEADROOM    0x8100000E // uint16_t
+
+//
+// Sets the number of slots in the per-connection ring used to store the
+// metadata of sent 1-RTT packets, instead of the shared pools. Must be a power
+// of two, no larger than 65536. Zero (the default) disables the ring. Only
+// affects connections that haven't sent any 1-RTT packets yet.
+//
+#define QUIC_PARAM_GLOBAL_SENT_PACKET_RING_SIZE         0x8100000F // uint32_t
+
+//
+// Sets whether the datapath backs its per-partition receive and send buffer
+// pools with 2MB huge pages, to cut TLB misses at high packet rates. Reserved
+// huge pages are used if available, and transparent huge pages otherwise.
+// Only the Linux socket datapaths honor it. Must be set before the library is
+// first used.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_HUGE_PAGES_ENABLED   0x81000010 // BOOLEAN
+
+//
+// Replaces the network with an in-process loopback: UDP datagrams are handed
+// directly to the socket in this process bound to the destination port, over
+// the modeled path, and datagrams to other ports are dropped. For CPU bound
+// end-to-end benchmarks with client and server in the same process. Only the
+// Windows user mode and Linux datapaths honor it. Must be set before the
+// library is first used.
+//
+typedef struct QUIC_DATAPATH_LOOPBACK_CONFIG {
+    uint32_t DelayUs;   // One way delay
+    uint32_t LossRate;  // Datagrams lost per million
+    uint64_t Bandwidth; // In bits per second; zero for unlimited
+} QUIC_DATAPATH_LOOPBACK_CONFIG;
+
+#define QUIC_PARAM_GLOBAL_DATAPATH_LOOPBACK             0x81000011 // QUIC_DATAPATH_LOOPBACK_CONFIG
+
+//
+// Sets whether new server connections are assigned a partition by a hash of
+// the client's initial destination CID, instead of the partition that received
+// the packet. For datapaths that receive on fewer partitions than there are,
+// such as XDP on a NIC with only a few queues. Connections then also stay on
+// that partition rather than following the partition their packets arrive on.
+//
+#define QUIC_PARAM_GLOBAL_SOFTWARE_RSS_ENABLED          0x81000012 // BOOLEAN
+
+//
+// Sets how the Windows XDP datapath waits for packets. Each partition tracks
+// the packet arrival rate of its queues and, by the highest one, busy polls,
+// takes short sleeps between polls, or waits for the NIC to signal new packets.
+// A rate of zero disables that mode. Must be set before the library is first
+// used. The time spent in each mode is reported by the
+// QUIC_PERF_COUNTER_XDP_*_TIME counters.
+//
+typedef struct QUIC_XDP_POLL_MODERATION_CONFIG {
+    uint32_t BusyPollRate;      // Packets per second at or above which to busy poll
+    uint32_t SleepRate;         // Packets per second at or above which to sleep between polls
+    uint32_t SleepIntervalUs;   // Length of a sleep between polls
+} QUIC_XDP_POLL_MODERATION_CONFIG;
+
+#define QUIC_PARAM_GLOBAL_XDP_POLL_MODERATION           0x81000013 // QUIC_XDP_POLL_MODERATION_CONFIG
+
 //
 // The different private parameters for Configuration.
 //
@@ -196,6 +196,24 @@ QuicPacketKeyCreateInitial(
     _Out_opt_ QUIC_PACKET_KEY** WriteKey
     );
 
+//
+// Re-derives Initial packet keys from the static version specific salt into
+// previously created Initial packet keys, re-keying them in place.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicPacketKeyRekeyInitial(
+    _In_ BOOLEAN IsServer,
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_reads_(CXPLAT_VERSION_SALT_LENGTH)
+        const uint8_t* const Salt,  // Version Specific
+    _In_ uint8_t CIDLength,
+    _In_reads_(CIDLength)
+        const uint8_t* const CID,
+    _Inout_ QUIC_PACKET_KEY* ReadKey,
+    _Inout_ QUIC_PACKET_KEY* WriteKey
+    );
+
 //
 // Frees the packet key.
 //
@@ -217,6 +235,18 @@ QuicPacketKeyUpdate(
     _Out_ QUIC_PACKET_KEY** NewKey
     );
 
+//
+// Calculates the updated packet key from the current packet key into a retired
+// 1-RTT packet key, re-keying it in place rather than allocating a new one.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicPacketKeyUpdateInPlace(
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_ QUIC_PACKET_KEY* OldKey,
+    _Inout_ QUIC_PACKET_KEY* NewKey
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatKeyCreate(
@@ -228,6 +258,21 @@ CxPlatKeyCreate(
     _Out_ CXPLAT_KEY** Key
     );
 
+//
+// Replaces the raw key material of an existing key, reusing its cipher state
+// where the crypto library allows it, instead of freeing and recreating it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatKeyRekey(
+    _In_ CXPLAT_AEAD_TYPE AeadType,
+    _When_(AeadType == CXPLAT_AEAD_AES_128_GCM, _In_reads_(16))
+    _When_(AeadType == CXPLAT_AEAD_AES_256_GCM, _In_reads_(32))
+    _When_(AeadType == CXPLAT_AEAD_CHACHA20_POLY1305, _In_reads_(32))
+        const uint8_t* const RawKey,
+    _Inout_ CXPLAT_KEY** Key
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicPacketKeyDerive(
@@ -329,6 +374,88 @@ CxPlatDecrypt(
         uint8_t* Buffer
     );
 
+//
+// A range of a packet's plaintext that isn't in the packet buffer. On encrypt,
+// the plaintext is read from 'Source' and the cipher text is written to
+// Buffer + Offset, saving the copy into the packet buffer. On decrypt, the
+// plaintext of Buffer + Offset is written to 'Destination' instead, and the
+// packet buffer range is left undefined. The destination may be written even
+// if the packet fails authentication.
+//
+typedef struct CXPLAT_CRYPT_SEGMENT {
+    union {
+        const uint8_t* Source;
+        uint8_t* Destination;
+    };
+    uint16_t Offset;
+    uint16_t Length;
+} CXPLAT_CRYPT_SEGMENT;
+
+//
+// A single packet's worth of input to the batched AEAD functions below. The
+// buffer parameters follow the same rules as CxPlatEncrypt/CxPlatDecrypt.
+// 'Segments' must be sorted by offset and not overlap.
+//
+typedef struct CXPLAT_CRYPT_PACKET {
+    const uint8_t* Iv;
+    const uint8_t* AuthData;
+    uint8_t* Buffer;
+    const CXPLAT_CRYPT_SEGMENT* Segments;
+    uint16_t AuthDataLength;
+    uint16_t BufferLength;
+    uint8_t SegmentCount;
+} CXPLAT_CRYPT_PACKET;
+
+//
+// Encrypts a batch of packets with the same key. Semantically equivalent to
+// calling CxPlatEncrypt on each packet in order, but allows the crypto
+// implementation to keep per-key state warm (and pipeline) across packets.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_PACKET* Packets
+    );
+
+//
+// Decrypts a batch of packets with the same key. Each packet is authenticated
+// independently; the per-packet result is written to 'Results'. Returns
+// success only if all the packets were successfully decrypted.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_PACKET* Packets,
+    _Out_writes_(BatchSize)
+        QUIC_STATUS* Results
+    );
+
+//
+// Decrypts only the first 'PrefixLength' bytes of the cipher text into
+// 'Prefix', leaving the buffer untouched. Nothing is authenticated, so the
+// result may only be used as a hint (e.g. where to decrypt the rest of the
+// payload to) until the whole packet is decrypted. Returns
+// QUIC_STATUS_NOT_SUPPORTED if the crypto library can't do this.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptPrefix(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint16_t PrefixLength,
+    _In_reads_bytes_(PrefixLength)
+        const uint8_t* const Buffer,
+    _Out_writes_bytes_(PrefixLength)
+        uint8_t* Prefix
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
@@ -346,6 +473,21 @@ CxPlatHpKeyFree(
     _In_opt_ CXPLAT_HP_KEY* Key
     );
 
+//
+// Replaces the raw key material of an existing header protection key, reusing
+// its allocation where the crypto library allows it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatHpKeyRekey(
+    _In_ CXPLAT_AEAD_TYPE AeadType,
+    _When_(AeadType == CXPLAT_AEAD_AES_128_GCM, _In_reads_(16))
+    _When_(AeadType == CXPLAT_AEAD_AES_256_GCM, _In_reads_(32))
+    _When_(AeadType == CXPLAT_AEAD_CHACHA20_POLY1305, _In_reads_(32))
+        const uint8_t* const RawKey,
+    _Inout_ CXPLAT_HP_KEY** Key
+    );
+
 //
 // Calculates the header protection mask, to be XOR'ed with the QUIC packet
 // header.
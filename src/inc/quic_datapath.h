@@ -96,6 +96,12 @@ typedef enum CXPLAT_DSCP_TYPE {
 //
 #define CXPLAT_MAX_MTU 1500
 
+//
+// The maximum IP MTU a datapath may report for a path over an interface with
+// jumbo frames (e.g. XDP with multi-buffer descriptors).
+//
+#define CXPLAT_MAX_JUMBO_MTU 9000
+
 //
 // The buffer size that must be allocated to fit the maximum UDP payload we
 // support.
@@ -159,6 +165,7 @@ PacketSizeFromUdpPayloadSize(
 //
 typedef struct CXPLAT_DATAPATH CXPLAT_DATAPATH;
 typedef struct CXPLAT_DATAPATH_RAW CXPLAT_DATAPATH_RAW;
+typedef struct CXPLAT_DATAPATH_LOOPBACK CXPLAT_DATAPATH_LOOPBACK;
 
 //
 // Represents a UDP or TCP abstraction.
@@ -273,6 +280,13 @@ typedef struct CXPLAT_RECV_DATA {
     uint16_t Reserved : 4;           // PACKET_TYPE (at least 3 bits)
     uint16_t ReservedEx : 8;         // Header length
 
+    //
+    // The time (in CxPlatTimeUs64 units) the packet was received by the kernel
+    // or NIC, if the datapath reports CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS.
+    // Zero if unknown.
+    //
+    uint64_t RecvTime;
+
     //
     // Variable length data (of size `ClientRecvContextLength` passed into
     // CxPlatDataPathInitialize) directly follows.
@@ -436,6 +450,9 @@ typedef enum CXPLAT_DATAPATH_FEATURES {
     CXPLAT_DATAPATH_FEATURE_TTL                = 0x00000080,
     CXPLAT_DATAPATH_FEATURE_SEND_DSCP          = 0x00000100,
     CXPLAT_DATAPATH_FEATURE_RECV_DSCP          = 0x00000200,
+    CXPLAT_DATAPATH_FEATURE_SEND_ZEROCOPY      = 0x00000400,
+    CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS    = 0x00000800,
+    CXPLAT_DATAPATH_FEATURE_SEND_TXTIME        = 0x00001000,
 } CXPLAT_DATAPATH_FEATURES;
 
 DEFINE_ENUM_FLAG_OPERATORS(CXPLAT_DATAPATH_FEATURES)
@@ -448,6 +465,7 @@ typedef enum CXPLAT_SOCKET_FLAGS {
     CXPLAT_SOCKET_FLAG_XDP          = 0x00000008, // Socket will use XDP
     CXPLAT_SOCKET_FLAG_QTIP         = 0x00000010, // Socket will use QTIP
     CXPLAT_SOCKET_FLAG_PARTITIONED  = 0x00000020, // Socket is partitioned
+    CXPLAT_SOCKET_FLAG_RIO          = 0x00000040, // Socket will use Registered I/O, if supported
 } CXPLAT_SOCKET_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(CXPLAT_SOCKET_FLAGS)
@@ -469,6 +487,40 @@ void
 typedef CXPLAT_DATAPATH_SEND_COMPLETE *CXPLAT_DATAPATH_SEND_COMPLETE_HANDLER;
 
 
+//
+// The modeled path for the in-process loopback datapath.
+//
+typedef struct CXPLAT_LOOPBACK_CONFIG {
+    uint32_t DelayUs;   // One way delay
+    uint32_t LossRate;  // Datagrams lost per million
+    uint64_t Bandwidth; // In bits per second; zero for unlimited
+} CXPLAT_LOOPBACK_CONFIG;
+
+//
+// The packet arrival rates at which an XDP partition switches how it waits
+// for packets. A rate of zero disables that mode.
+//
+typedef struct CXPLAT_XDP_POLL_MODERATION_CONFIG {
+    uint32_t BusyPollRate;      // Packets per second at or above which to busy poll
+    uint32_t SleepRate;         // Packets per second at or above which to sleep between polls
+    uint32_t SleepIntervalUs;   // Length of a sleep between polls
+} CXPLAT_XDP_POLL_MODERATION_CONFIG;
+
+typedef enum CXPLAT_XDP_POLL_MODE {
+    CXPLAT_XDP_POLL_MODE_INTERRUPT, // Wait for the NIC to signal new packets
+    CXPLAT_XDP_POLL_MODE_SLEEP,     // Poll, sleeping SleepIntervalUs between polls
+    CXPLAT_XDP_POLL_MODE_BUSY_POLL, // Poll continuously
+    CXPLAT_XDP_POLL_MODE_COUNT
+} CXPLAT_XDP_POLL_MODE;
+
+//
+// Total time, in microseconds, XDP partitions have spent in each poll mode.
+// Updated by the datapath with interlocked adds.
+//
+typedef struct CXPLAT_XDP_POLL_STATISTICS {
+    int64_t TimeUs[CXPLAT_XDP_POLL_MODE_COUNT];
+} CXPLAT_XDP_POLL_STATISTICS;
+
 typedef struct CXPLAT_DATAPATH_INIT_CONFIG {
     //
     // Whether the datapath will be initialized with support for DSCP on receive.
@@ -476,6 +528,54 @@ typedef struct CXPLAT_DATAPATH_INIT_CONFIG {
     // the Windows fast path causing a large performance regression.
     //
     BOOLEAN EnableDscpOnRecv;
+
+    //
+    // Whether the datapath should transmit large (segmented) sends without
+    // copying the payload into the kernel. The send buffer is then held until
+    // the kernel indicates it's done with it. Only honored on platforms that
+    // report CXPLAT_DATAPATH_FEATURE_SEND_ZEROCOPY.
+    //
+    BOOLEAN EnableZeroCopySend;
+
+    //
+    // Whether the datapath should honor CXPLAT_SEND_CONFIG.TxTime and let the
+    // kernel hold sends until their departure time. Only honored on platforms
+    // that report CXPLAT_DATAPATH_FEATURE_SEND_TXTIME.
+    //
+    BOOLEAN EnableTxTimePacing;
+
+    //
+    // Whether the datapath should back its per partition buffer pools with
+    // huge pages, to save TLB misses at high packet rates. Only honored by the
+    // Linux socket datapaths.
+    //
+    BOOLEAN EnableHugePages;
+
+    //
+    // Number of send and receive buffers to reserve in each partition's pools
+    // up front, faulting in their memory on the partition's NUMA node where
+    // possible. Only honored by the Linux socket datapaths.
+    //
+    uint32_t PoolReserveCount;
+
+    //
+    // If set, UDP datagrams are delivered in memory to sockets in the same
+    // process, over the modeled path, instead of being sent on the network.
+    // Only honored by the Windows user mode and Linux datapaths.
+    //
+    const CXPLAT_LOOPBACK_CONFIG* Loopback;
+
+    //
+    // If set, overrides the default poll moderation thresholds of the XDP
+    // datapath. Only honored by the Windows XDP datapath.
+    //
+    const CXPLAT_XDP_POLL_MODERATION_CONFIG* XdpPollModeration;
+
+    //
+    // If set, the XDP datapath adds the time its partitions spend in each
+    // poll mode here. Must outlive the datapath.
+    //
+    CXPLAT_XDP_POLL_STATISTICS* XdpPollStatistics;
 } CXPLAT_DATAPATH_INIT_CONFIG;
 
 //
@@ -622,6 +722,11 @@ typedef struct CXPLAT_UDP_CONFIG {
     uint8_t CibirIdOffsetSrc;           // CIBIR ID offset in source CID
     uint8_t CibirIdOffsetDst;           // CIBIR ID offset in destination CID
     uint8_t CibirId[6];                 // CIBIR ID data
+
+    // used for steering server receives by CID (Linux SO_REUSEPORT sockets)
+    uint16_t CidPartitionCount;         // Value of 0 indicates CID steering isn't used
+    uint16_t CidPartitionMask;          // Mask for the partition index in the partition ID
+    uint8_t CidPartitionIdOffset;       // Partition ID offset in destination CID
 } CXPLAT_UDP_CONFIG;
 
 //
@@ -749,6 +854,13 @@ typedef struct CXPLAT_SEND_CONFIG {
     uint8_t ECN; // CXPLAT_ECN_TYPE
     uint8_t Flags; // CXPLAT_SEND_FLAGS
     uint8_t DSCP; // CXPLAT_DSCP_TYPE
+
+    //
+    // The earliest time (in CxPlatTimeUs64 units) the datagrams should leave
+    // the host, if the datapath reports CXPLAT_DATAPATH_FEATURE_SEND_TXTIME.
+    // Zero to send immediately.
+    //
+    uint64_t TxTime;
 } CXPLAT_SEND_CONFIG;
 
 //
@@ -813,6 +925,20 @@ CxPlatSocketSend(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+//
+// Sends several send data objects (possibly for different routes) over the
+// socket, in order. Where supported, they are submitted together to amortize
+// the system call cost.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    );
+
 typedef struct CXPLAT_TCP_STATISTICS { // Mostly copied from TCP_INFO_v1 for now
     uint32_t Mss;
     uint64_t ConnectionTimeMs;
@@ -86,6 +86,14 @@ extern "C" {
 
 #define CXPLAT_HASH_ALLOCATED_HEADER 0x00000001
 
+//
+// Creates the table with open addressing: entries are kept in a flat array
+// probed a group at a time using per-slot tag bytes, instead of in chains of
+// buckets. Lookups touch fewer cache lines, but the table is rebuilt (not
+// grown incrementally) as it fills up.
+//
+#define CXPLAT_HASH_OPEN_ADDRESSING  0x00000002
+
 #define CXPLAT_HASH_MIN_SIZE 128
 
 typedef struct CXPLAT_HASHTABLE_ENTRY {
@@ -111,8 +119,21 @@ typedef struct CXPLAT_HASHTABLE_LOOKUP_CONTEXT {
     // 3. Signature is used primarily as a safety check in insertion. This field
     //    must match the Signature of the entry being inserted.
     //
-    CXPLAT_LIST_ENTRY* ChainHead;
-    CXPLAT_LIST_ENTRY* PrevLinkage;
+    // For CXPLAT_HASH_OPEN_ADDRESSING tables, the position of the last entry
+    // returned is kept instead: its slot and probe number, or the overflow
+    // list entry.
+    //
+    union {
+        struct {
+            CXPLAT_LIST_ENTRY* ChainHead;
+            CXPLAT_LIST_ENTRY* PrevLinkage;
+        };
+        struct {
+            uint32_t Slot;
+            uint32_t Probe;
+            CXPLAT_LIST_ENTRY* OverflowLinkage;
+        };
+    };
     uint64_t Signature;
 } CXPLAT_HASHTABLE_LOOKUP_CONTEXT;
 
@@ -130,9 +151,14 @@ typedef struct CXPLAT_HASHTABLE {
     // Entries initialized at creation
     uint32_t Flags;
 
-    // Entries used in bucket computation.
+    // Entries used in bucket computation. With CXPLAT_HASH_OPEN_ADDRESSING,
+    // TableSize is the number of slots and DivisorMask the number of slot
+    // groups minus one.
     uint32_t TableSize;
-    uint32_t Pivot;
+    union {
+        uint32_t Pivot;
+        uint32_t NumDeleted; // Slots holding a tombstone (open addressing)
+    };
     uint32_t DivisorMask;
 
     // Counters
@@ -145,8 +171,15 @@ typedef struct CXPLAT_HASHTABLE {
         void* Directory;
         CXPLAT_LIST_ENTRY* SecondLevelDir; // When TableSize <= HT_SECOND_LEVEL_DIR_MIN_SIZE
         CXPLAT_LIST_ENTRY** FirstLevelDir; // When TableSize > HT_SECOND_LEVEL_DIR_MIN_SIZE
+        CXPLAT_HASHTABLE_ENTRY** Slots; // With CXPLAT_HASH_OPEN_ADDRESSING, followed by the tag bytes
     };
 
+    //
+    // Open addressing only. Entries that didn't fit in the slots because the
+    // table couldn't be rebuilt (allocation failure or active enumerators).
+    //
+    CXPLAT_LIST_ENTRY Overflow;
+
 } CXPLAT_HASHTABLE;
 
 _Must_inspect_result_
@@ -158,6 +191,20 @@ CxPlatHashtableInitialize(
     _In_ uint32_t InitialSize
     );
 
+//
+// Same as CxPlatHashtableInitialize, with CXPLAT_HASH_* creation flags (i.e.
+// CXPLAT_HASH_OPEN_ADDRESSING).
+//
+_Must_inspect_result_
+_Success_(return != FALSE)
+BOOLEAN
+CxPlatHashtableInitializeWithFlags(
+    _Inout_ _When_(NULL == *HashTable, _At_(*HashTable, __drv_allocatesMem(Mem) _Post_notnull_))
+        CXPLAT_HASHTABLE** HashTable,
+    _In_ uint32_t InitialSize,
+    _In_ uint32_t Flags
+    );
+
 QUIC_INLINE
 _Must_inspect_result_
 _Success_(return != FALSE)
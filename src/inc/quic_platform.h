@@ -161,6 +161,29 @@ typedef struct CXPLAT_SLIST_ENTRY {
 #define QUIC_POOL_DATAPATH_RSS_CONFIG       'F4cQ' // Qc4F - QUIC Datapath RSS configuration
 #define QUIC_POOL_TLS_AUX_DATA              '05cQ' // Qc50 - QUIC TLS Backing Aux data
 #define QUIC_POOL_TLS_RECORD_ENTRY          '15cQ' // Qc51 - QUIC TLS Backing Record storage
+#define QUIC_POOL_HANDSHAKE_OFFLOAD         '25cQ' // Qc52 - QUIC Handshake offload job
+#define QUIC_POOL_HANDSHAKE_THREADS         '35cQ' // Qc53 - QUIC Handshake offload threads
+#define QUIC_POOL_TICKET_CACHE              '45cQ' // Qc54 - QUIC Server ticket cache
+#define QUIC_POOL_TLS_CREDENTIAL            '55cQ' // Qc55 - QUIC TLS Shared credential cache entry
+#define QUIC_POOL_SEND_PRIORITY             '65cQ' // Qc56 - QUIC Send priority levels
+#define QUIC_POOL_SENT_PACKET_INDEX         '75cQ' // Qc57 - QUIC Sent packet number index
+#define QUIC_POOL_SEND_BATCH                '85cQ' // Qc58 - QUIC Batched stream sends
+#define QUIC_POOL_LOOKUP_CID_SLOTS          '95cQ' // Qc59 - QUIC Lookup CID slot array
+#define QUIC_POOL_LOOKUP_READERS            'A5cQ' // Qc5A - QUIC Lookup reader counters
+#define QUIC_POOL_STREAM_WINDOW             'B5cQ' // Qc5B - QUIC Stream ID window
+#define QUIC_POOL_LISTENER_INDEX            'C5cQ' // Qc5C - QUIC Binding listener index
+#define QUIC_POOL_STATELESS_RATE            'D5cQ' // Qc5D - QUIC Binding stateless response rate sketch
+#define QUIC_POOL_ARENA                     'E5cQ' // Qc5E - QUIC Arena chunk
+#define QUIC_POOL_QLOG                      'F5cQ' // Qc5F - QUIC qlog ring and file path
+#define QUIC_POOL_DATAPATH_LOOPBACK         'G5cQ' // Qc5G - QUIC Platform in-process loopback datapath
+#define QUIC_POOL_CLIENT_TICKET_CACHE       'H5cQ' // Qc5H - QUIC Registration client ticket cache entry
+#define QUIC_POOL_ANTI_REPLAY               'I5cQ' // Qc5I - QUIC Registration 0-RTT anti-replay filter
+#define QUIC_POOL_SHARED_SETTINGS           'J5cQ' // Qc5J - QUIC shared connection settings
+#define QUIC_POOL_CONN_HANDOFF              'K5cQ' // Qc5K - QUIC connection handoff state
+#define QUIC_POOL_RECEIVE_TIMESTAMPS        'L5cQ' // Qc5L - QUIC ACK tracker receive timestamps
+#define QUIC_POOL_TEARDOWN_BATCH            'M5cQ' // Qc5M - QUIC registration shutdown batches
+#define QUIC_POOL_SNI_CONFIG                'N5cQ' // Qc5N - QUIC listener SNI configurations
+#define QUIC_POOL_PEER_STREAMS_STARTED      'O5cQ' // Qc5O - QUIC connection peer streams started batch
 
 typedef enum CXPLAT_THREAD_FLAGS {
     CXPLAT_THREAD_FLAG_NONE               = 0x0000,
@@ -556,6 +579,14 @@ CxPlatWorkerPoolWorkerPoll(
     _In_ QUIC_EXECUTION* Execution
     );
 
+uint32_t
+CxPlatWorkerPoolWorkerPollBatch(
+    _In_ uint32_t Count,
+    _In_reads_(Count) QUIC_EXECUTION** Executions,
+    _In_ uint32_t TimeBudgetUs,
+    _In_ uint32_t RunBudget
+    );
+
 //
 // Supports more dynamic operations, but must be submitted to the platform worker
 // to manage.
@@ -578,6 +609,25 @@ CxPlatRemoveDynamicPoolAllocator(
     _Inout_ CXPLAT_POOL_EX* Pool
     );
 
+//
+// File Abstraction
+//
+
+//
+// Synchronously reads up to Length bytes at Offset from the file, without
+// moving the file's current position. BytesRead is less than Length only if
+// the end of the file was reached.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatFileRead(
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _Out_writes_bytes_to_(Length, *BytesRead) uint8_t* Buffer,
+    _Out_ uint32_t* BytesRead
+    );
+
 #endif // !_KERNEL_MODE
 
 //
@@ -125,6 +125,16 @@ InterlockedDecrement(
     return __sync_sub_and_fetch(Addend, (long)1);
 }
 
+QUIC_INLINE
+long
+InterlockedExchangeAdd(
+    _Inout_ _Interlocked_operand_ long volatile *Addend,
+    _In_ long Value
+    )
+{
+    return __sync_fetch_and_add(Addend, Value);
+}
+
 QUIC_INLINE
 long
 InterlockedAnd(
@@ -246,6 +256,17 @@ InterlockedExchangePointer(
     return __sync_lock_test_and_set(Target, Value);
 }
 
+QUIC_INLINE
+void*
+InterlockedCompareExchangePointer(
+    _Inout_ _Interlocked_operand_ void* volatile *Destination,
+    _In_opt_ void* ExChange,
+    _In_opt_ void* Comperand
+    )
+{
+    return __sync_val_compare_and_swap(Destination, Comperand, ExChange);
+}
+
 QUIC_INLINE
 void*
 InterlockedFetchAndClearPointer(
@@ -486,6 +507,12 @@ CXPLAT_SLIST_ENTRY*
 CxPlatListPopEntry(
     _Inout_ CXPLAT_SLIST_ENTRY* ListHead
     );
+
+FORCEINLINE
+void
+CxPlatListInitializeHead(
+    _Out_ CXPLAT_LIST_ENTRY* ListHead
+    );
 typedef struct CXPLAT_POOL {
 
     //
@@ -501,8 +528,9 @@ typedef struct CXPLAT_POOL {
     uint16_t ListDepth;
 
     //
-    // Lock to synchronize access to the List.
-    // LINUX_TODO: Check how to make this lock free?
+    // Lock to synchronize access to the List. Most allocations and frees are
+    // served by the calling thread's magazine instead, and only take the lock
+    // to exchange a batch of entries with the list.
     //
 
     CXPLAT_LOCK Lock;
@@ -519,6 +547,41 @@ typedef struct CXPLAT_POOL {
 
     uint32_t Tag;
 
+    //
+    // Unique (never zero) for every initialization of a pool, so that a thread
+    // never mistakes its magazine of a freed pool for one of a new pool at the
+    // same address.
+    //
+
+    uint64_t Generation;
+
+    //
+    // Slabs that entries are carved from, the ones with free entries first.
+    // Empty if the entries are too large to be carved from slabs, in which
+    // case each is allocated individually.
+    //
+
+    CXPLAT_LIST_ENTRY Slabs;
+
+    //
+    // Size of the slabs the pool maps.
+    //
+
+    uint32_t SlabSize;
+
+    //
+    // Number of entries carved from each slab, or zero if the pool doesn't use
+    // slabs.
+    //
+
+    uint32_t SlabEntryCount;
+
+    //
+    // Number of free entries in the slabs, including not yet carved ones.
+    //
+
+    uint32_t SlabFreeCount;
+
 } CXPLAT_POOL;
 
 #define CXPLAT_MEMORY_ALIGNMENT 16
@@ -528,6 +591,7 @@ typedef struct __attribute__((aligned(CXPLAT_MEMORY_ALIGNMENT))) CXPLAT_POOL_HEA
     CXPLAT_POOL* Owner;
     CXPLAT_SLIST_ENTRY Entry;
     };
+    struct CXPLAT_POOL_SLAB* Slab; // NULL if allocated individually
 #if DEBUG
     uint64_t SpecialFlag;
 #endif
@@ -542,12 +606,136 @@ typedef struct __attribute__((aligned(CXPLAT_MEMORY_ALIGNMENT))) CXPLAT_POOL_HEA
 #define CXPLAT_POOL_MAXIMUM_DEPTH   0   // TODO - Optimize this scenario better
 #endif
 
+//
+// Each thread caches free entries of the pools it uses in magazines, in the
+// style of the slab allocator's magazine layer. A magazine belongs to one pool
+// at a time and is only touched by its thread, so allocations and frees it can
+// serve take no lock and use no atomics. An empty magazine is refilled, and a
+// full one half emptied, with a single acquisition of the pool's lock.
+//
+// A thread only ever returns entries to the pool it is being called with. The
+// entries in a magazine of another pool (which may be gone by now) are freed
+// when the magazine is taken over, or when the thread exits.
+//
+// Below the magazines, pools of small enough entries carve them from large,
+// page aligned slabs (see CXPLAT_POOL_SLAB in platform_posix.c) instead of
+// allocating each one, and return memory to the system in whole slabs.
+//
+// With CXPLAT_POOL_HUGE_PAGES, all slabs are huge page backed. Otherwise, only
+// those of pools initialized with CxPlatPoolInitializeHugePages are.
+//
+#define CXPLAT_HUGE_PAGE_SIZE       (2 * 1024 * 1024)
+#define CXPLAT_HUGE_PAGE_ROUND_UP(Length) \
+    (((Length) + CXPLAT_HUGE_PAGE_SIZE - 1) & ~(size_t)(CXPLAT_HUGE_PAGE_SIZE - 1))
+#ifdef CXPLAT_POOL_HUGE_PAGES
+#define CXPLAT_POOL_SLAB_SIZE       CXPLAT_HUGE_PAGE_SIZE
+#else
+#define CXPLAT_POOL_SLAB_SIZE       (256 * 1024)
+#endif
+#define CXPLAT_POOL_MAGAZINE_SIZE   16
+#define CXPLAT_POOL_MAGAZINE_COUNT  16 // Per thread
+
+typedef struct CXPLAT_POOL_MAGAZINE {
+
+    CXPLAT_POOL* Pool;
+    uint64_t Generation;
+    uint32_t Count;
+    CXPLAT_POOL_HEADER* Entries[CXPLAT_POOL_MAGAZINE_SIZE];
+
+} CXPLAT_POOL_MAGAZINE;
+
+extern __thread CXPLAT_POOL_MAGAZINE CxPlatPoolMagazines[CXPLAT_POOL_MAGAZINE_COUNT];
+
+uint64_t
+CxPlatPoolNextGeneration(
+    void
+    );
+
+//
+// Returns the number of entries of the given size (including the header) to
+// carve from each slab, or zero if they are too large for slabs.
+//
+uint32_t
+CxPlatPoolSlabEntryCount(
+    _In_ uint32_t Size,
+    _In_ uint32_t SlabSize
+    );
+
+//
+// Frees the magazine's entries, without returning them to its pool.
+//
+void
+CxPlatPoolEmptyMagazine(
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    );
+
+//
+// Frees the uninitialized pool's slabs, or leaves the last ones out to free
+// them when their entries are.
+//
+void
+CxPlatPoolFreeSlabs(
+    _Inout_ CXPLAT_POOL* Pool
+    );
+
+//
+// Returns one slab without any entries in use to the system.
+//
+BOOLEAN
+CxPlatPoolPruneSlab(
+    _Inout_ CXPLAT_POOL* Pool
+    );
+
+//
+// Frees the entries of whichever pool the magazine held, and assigns it to
+// the pool.
+//
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolClaimMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    );
+
+//
+// Moves up to half a magazine of entries from the pool's list, or its slabs,
+// into the empty magazine.
+//
+void
+CxPlatPoolRefillMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    );
+
+//
+// Moves half of the full magazine's entries back to their slabs, or to the
+// pool's list, freeing any that don't fit under CXPLAT_POOL_MAXIMUM_DEPTH.
+//
+void
+CxPlatPoolFlushMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    );
+
 #if DEBUG
 int32_t
 CxPlatGetAllocFailDenominator(
     );
 #endif
 
+QUIC_INLINE
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolGetMagazine(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CXPLAT_POOL_MAGAZINE* Magazine =
+        &CxPlatPoolMagazines[Pool->Generation % CXPLAT_POOL_MAGAZINE_COUNT];
+    if (Magazine->Pool == Pool && Magazine->Generation == Pool->Generation) {
+        return Magazine;
+    }
+    return CxPlatPoolClaimMagazine(Pool, Magazine);
+}
+
 QUIC_INLINE
 void
 CxPlatPoolInitialize(
@@ -559,23 +747,57 @@ CxPlatPoolInitialize(
 {
     Pool->Size = Size + sizeof(CXPLAT_POOL_HEADER); // Add space for the pool header
     Pool->Tag = Tag;
+    Pool->Generation = CxPlatPoolNextGeneration();
     CxPlatLockInitialize(&Pool->Lock);
     Pool->ListDepth = 0;
     CxPlatZeroMemory(&Pool->ListHead, sizeof(Pool->ListHead));
+    CxPlatListInitializeHead(&Pool->Slabs);
+    Pool->SlabSize = CXPLAT_POOL_SLAB_SIZE;
+    Pool->SlabEntryCount = CxPlatPoolSlabEntryCount(Pool->Size, Pool->SlabSize);
+    Pool->SlabFreeCount = 0;
     UNREFERENCED_PARAMETER(IsPaged);
 }
 
+//
+// Initializes a pool whose entries are carved from huge page backed slabs,
+// for pools so heavily used that TLB misses on their entries matter. Each slab
+// is committed as a whole, so this only pays off for pools with many entries.
+//
+QUIC_INLINE
+void
+CxPlatPoolInitializeHugePages(
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CxPlatPoolInitialize(FALSE, Size, Tag, Pool);
+    Pool->SlabSize = CXPLAT_HUGE_PAGE_SIZE;
+    Pool->SlabEntryCount = CxPlatPoolSlabEntryCount(Pool->Size, Pool->SlabSize);
+}
+
 QUIC_INLINE
 void
 CxPlatPoolUninitialize(
     _Inout_ CXPLAT_POOL* Pool
     )
 {
+    //
+    // Only this thread's magazine can be drained here. Other threads free the
+    // entries of theirs later.
+    //
+    CXPLAT_POOL_MAGAZINE* Magazine =
+        &CxPlatPoolMagazines[Pool->Generation % CXPLAT_POOL_MAGAZINE_COUNT];
+    if (Magazine->Pool == Pool && Magazine->Generation == Pool->Generation) {
+        CxPlatPoolEmptyMagazine(Magazine);
+    }
+
     CXPLAT_POOL_HEADER* Entry;
     while ((Entry = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead)) != NULL) {
         CXPLAT_DBG_ASSERT(Entry->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
         CxPlatFree(Entry, Pool->Tag);
     }
+    CxPlatPoolFreeSlabs(Pool);
     CxPlatLockUninitialize(&Pool->Lock);
 }
 
@@ -585,23 +807,26 @@ CxPlatPoolAlloc(
     _Inout_ CXPLAT_POOL* Pool
     )
 {
-    CxPlatLockAcquire(&Pool->Lock);
-    CXPLAT_POOL_HEADER* Header =
-    #if DEBUG
-        CxPlatGetAllocFailDenominator() ? NULL : // No pool when using simulated alloc failures
-    #endif
-        (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead);
-    if (Header != NULL) {
-        CXPLAT_DBG_ASSERT(Pool->ListDepth > 0);
-        CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
-        Pool->ListDepth--;
+    CXPLAT_POOL_HEADER* Header = NULL;
+#if DEBUG
+    if (!CxPlatGetAllocFailDenominator()) // No pool when using simulated alloc failures
+#endif
+    {
+        CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolGetMagazine(Pool);
+        if (Magazine->Count == 0) {
+            CxPlatPoolRefillMagazine(Pool, Magazine);
+        }
+        if (Magazine->Count > 0) {
+            Header = Magazine->Entries[--Magazine->Count];
+            CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
+        }
     }
-    CxPlatLockRelease(&Pool->Lock);
     if (Header == NULL) {
         Header = (CXPLAT_POOL_HEADER*)CxPlatAlloc(Pool->Size, Pool->Tag);
         if (Header == NULL) {
             return NULL;
         }
+        Header->Slab = NULL;
     }
 #if DEBUG
     Header->SpecialFlag = CXPLAT_POOL_ALLOC_FLAG;
@@ -620,20 +845,21 @@ CxPlatPoolFree(
     CXPLAT_POOL* Pool = Header->Owner;
 #if DEBUG
     CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_ALLOC_FLAG);
-    if (CxPlatGetAllocFailDenominator()) {
+    if (CxPlatGetAllocFailDenominator() && Header->Slab == NULL) {
         CxPlatFree(Header, Pool->Tag);
         return;
     }
     Header->SpecialFlag = CXPLAT_POOL_FREE_FLAG;
 #endif
-    if (Pool->ListDepth >= CXPLAT_POOL_MAXIMUM_DEPTH) {
-        CxPlatFree(Header, Pool->Tag);
-    } else {
-        CxPlatLockAcquire(&Pool->Lock);
-        CxPlatListPushEntry(&Pool->ListHead, &Header->Entry);
-        Pool->ListDepth++;
-        CxPlatLockRelease(&Pool->Lock);
+#if CXPLAT_POOL_MAXIMUM_DEPTH == 0
+    CxPlatFree(Header, Pool->Tag);
+#else
+    CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolGetMagazine(Pool);
+    if (Magazine->Count == CXPLAT_POOL_MAGAZINE_SIZE) {
+        CxPlatPoolFlushMagazine(Pool, Magazine);
     }
+    Magazine->Entries[Magazine->Count++] = Header;
+#endif
 }
 
 QUIC_INLINE
@@ -650,12 +876,25 @@ CxPlatPoolPrune(
     }
     CxPlatLockRelease(&Pool->Lock);
     if (Entry == NULL) {
-        return FALSE;
+        return CxPlatPoolPruneSlab(Pool);
     }
     CxPlatFree(Entry, Pool->Tag);
     return TRUE;
 }
 
+//
+// Pre-allocates entries for the next Count allocations from the pool and
+// faults in their pages, preferring NumaNode's memory where supported and
+// otherwise first touching them on the calling thread. Entries too large for
+// slabs are only reserved up to CXPLAT_POOL_MAXIMUM_DEPTH.
+//
+QUIC_STATUS
+CxPlatPoolReserve(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ uint32_t Count,
+    _In_ uint16_t NumaNode
+    );
+
 //
 // Reference Count Interface
 //
@@ -1636,11 +1875,29 @@ CxPlatCurThreadID(
 extern uint32_t CxPlatProcessorCount;
 #define CxPlatProcCount() CxPlatProcessorCount
 
+//
+// The processors used by default when the app doesn't configure its own,
+// narrowed by the process' cgroup cpuset and CPU quota. The list is NULL when
+// all processors are used.
+//
+extern uint16_t* CxPlatProcessorDefaultList;
+extern uint32_t CxPlatProcessorDefaultCount;
+#define CxPlatProcDefaultList() ((const uint16_t*)CxPlatProcessorDefaultList)
+#define CxPlatProcDefaultCount() CxPlatProcessorDefaultCount
+
 uint32_t
 CxPlatProcCurrentNumber(
     void
     );
 
+//
+// Returns the NUMA node of the processor, or 0 if unknown.
+//
+uint16_t
+CxPlatProcNumaNode(
+    _In_ uint32_t Index
+    );
+
 //
 // Rundown Protection Interfaces.
 //
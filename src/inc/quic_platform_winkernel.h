@@ -311,6 +311,24 @@ CxPlatPoolFree(
     CXPLAT_POOL* Pool = Header->Owner;
     ExFreeToLookasideListEx(Pool, Header);
 }
+
+//
+// Lookaside lists size their depth to the allocation rate themselves, so
+// entries can't be reserved ahead of use.
+//
+QUIC_INLINE
+QUIC_STATUS
+CxPlatPoolReserve(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ uint32_t Count,
+    _In_ uint16_t NumaNode
+    )
+{
+    UNREFERENCED_PARAMETER(Pool);
+    UNREFERENCED_PARAMETER(Count);
+    UNREFERENCED_PARAMETER(NumaNode);
+    return QUIC_STATUS_SUCCESS;
+}
 #define CxPlatZeroMemory RtlZeroMemory
 #define CxPlatCopyMemory RtlCopyMemory
 #define CxPlatMoveMemory RtlMoveMemory
@@ -932,8 +950,34 @@ typedef ULONG_PTR CXPLAT_THREAD_ID;
 
 extern uint32_t CxPlatProcessorCount;
 #define CxPlatProcCount() CxPlatProcessorCount
+#define CxPlatProcDefaultList() ((const uint16_t*)NULL)
+#define CxPlatProcDefaultCount() CxPlatProcessorCount
 #define CxPlatProcCurrentNumber() (KeGetCurrentProcessorIndex() % CxPlatProcessorCount)
 
+//
+// Returns the NUMA node of the processor, or 0 if unknown.
+//
+QUIC_INLINE
+uint16_t
+CxPlatProcNumaNode(
+    _In_ uint32_t Index
+    )
+{
+    PROCESSOR_NUMBER Processor;
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX Info;
+    ULONG InfoLength = sizeof(Info);
+    if (!NT_SUCCESS(KeGetProcessorNumberFromIndex(Index, &Processor)) ||
+        !NT_SUCCESS(
+            KeQueryLogicalProcessorRelationship(
+                &Processor,
+                RelationNumaNode,
+                &Info,
+                &InfoLength))) {
+        return 0;
+    }
+    return (uint16_t)Info.NumaNode.NodeNumber;
+}
+
 //
 // Rundown Protection Interfaces
 //
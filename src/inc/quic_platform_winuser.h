@@ -492,6 +492,34 @@ CxPlatPoolPrune(
     return TRUE;
 }
 
+//
+// Pre-allocates entries for the next Count allocations from the pool, up to
+// its maximum depth, and faults in their pages on the calling thread's node.
+//
+QUIC_INLINE
+QUIC_STATUS
+CxPlatPoolReserve(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ uint32_t Count,
+    _In_ uint16_t NumaNode
+    )
+{
+    UNREFERENCED_PARAMETER(NumaNode);
+    Count = CXPLAT_MIN(Count, Pool->MaxDepth);
+    while (QueryDepthSList(&Pool->ListHead) < Count) {
+        CXPLAT_POOL_HEADER* Header = Pool->Allocate(Pool->Size, Pool->Tag, Pool);
+        if (Header == NULL) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        CxPlatZeroMemory(Header, Pool->Size);
+#if DEBUG
+        Header->SpecialFlag = CXPLAT_POOL_FREE_FLAG;
+#endif
+        InterlockedPushEntrySList(&Pool->ListHead, (PSLIST_ENTRY)Header);
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
 #define CxPlatZeroMemory RtlZeroMemory
 #define CxPlatCopyMemory RtlCopyMemory
 #define CxPlatMoveMemory RtlMoveMemory
@@ -1073,6 +1101,8 @@ extern CXPLAT_PROCESSOR_GROUP_INFO* CxPlatProcessorGroupInfo;
 
 extern uint32_t CxPlatProcessorCount;
 #define CxPlatProcCount() CxPlatProcessorCount
+#define CxPlatProcDefaultList() ((const uint16_t*)NULL)
+#define CxPlatProcDefaultCount() CxPlatProcessorCount
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
@@ -1096,6 +1126,23 @@ CxPlatProcCurrentNumber(
     return CxPlatProcNumberToIndex(&ProcNumber);
 }
 
+//
+// Returns the NUMA node of the processor, or 0 if unknown.
+//
+QUIC_INLINE
+uint16_t
+CxPlatProcNumaNode(
+    _In_ uint32_t Index
+    )
+{
+    USHORT NodeNumber;
+    if (!GetNumaProcessorNodeEx((PPROCESSOR_NUMBER)&CxPlatProcessorInfo[Index], &NodeNumber) ||
+        NodeNumber == MAXUSHORT) {
+        return 0;
+    }
+    return (uint16_t)NodeNumber;
+}
+
 
 //
 // Create Thread Interfaces
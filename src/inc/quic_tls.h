@@ -57,6 +57,7 @@ typedef enum CXPLAT_TLS_CREDENTIAL_FLAGS {
 
     CXPLAT_TLS_CREDENTIAL_FLAG_NONE                 = 0x0000,
     CXPLAT_TLS_CREDENTIAL_FLAG_DISABLE_RESUMPTION   = 0x0001,   // Server only
+    CXPLAT_TLS_CREDENTIAL_FLAG_ASYNC_CRYPTO         = 0x0002,   // Server only
 
 } CXPLAT_TLS_CREDENTIAL_FLAGS;
 
@@ -64,10 +64,24 @@ typedef struct CXPLAT_TOEPLITZ_LOOKUP_TABLE {
     uint32_t Table[CXPLAT_TOEPLITZ_LOOKUP_TABLE_SIZE];
 } CXPLAT_TOEPLITZ_LOOKUP_TABLE;
 
+//
+// Padding after the reversed key so a 16 byte load at any input offset stays
+// within it.
+//
+#define CXPLAT_TOEPLITZ_REVERSED_KEY_PADDING    16
+
 typedef struct CXPLAT_TOEPLITZ_HASH {
     CXPLAT_TOEPLITZ_LOOKUP_TABLE LookupTableArray[CXPLAT_TOEPLITZ_LOOKUP_TABLE_COUNT_MAX];
     uint8_t HashKey[CXPLAT_TOEPLITZ_KEY_SIZE_MAX];
     CXPLAT_TOEPLITZ_INPUT_SIZE InputSize;
+
+    //
+    // Set by CxPlatToeplitzHashInitialize if the CPU supports carry-less
+    // multiplication, in which case ReversedKey (HashKey with the bits of each
+    // byte reversed, zero padded) is used instead of the lookup tables.
+    //
+    BOOLEAN UseClmul;
+    uint8_t ReversedKey[CXPLAT_TOEPLITZ_KEY_SIZE_MAX + CXPLAT_TOEPLITZ_REVERSED_KEY_PADDING];
 } CXPLAT_TOEPLITZ_HASH;
 
 //
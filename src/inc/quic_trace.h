@@ -29,6 +29,10 @@ Abstract:
 
     QUIC_CLOG                   Bypasses these mechanisms and uses CLOG to generate logging
 
+    Independently, QUIC_USDT_ENABLED compiles in a few USDT (SystemTap SDT)
+    probes on hot paths, under the "msquic" provider, so that bpftrace or perf
+    can attach to them on Linux without rebuilding.
+
  --*/
 
 #pragma once
@@ -109,6 +113,10 @@ typedef enum QUIC_TRACE_API_TYPE {
     QUIC_TRACE_API_EXECUTION_DELETE,
     QUIC_TRACE_API_EXECUTION_POLL,
     QUIC_TRACE_API_REGISTRATION_CLOSE2,
+    QUIC_TRACE_API_EXECUTION_POLL_BATCH,
+    QUIC_TRACE_API_CONNECTION_SEND_BATCH,
+    QUIC_TRACE_API_STREAM_OPEN_BATCH,
+    QUIC_TRACE_API_STREAM_SEND_FILE,
     QUIC_TRACE_API_COUNT // Must be last
 } QUIC_TRACE_API_TYPE;
 
@@ -129,6 +137,18 @@ void
 
 extern QUIC_TRACE_RUNDOWN_CALLBACK* QuicTraceRundownCallback;
 
+//
+// USDT probes. Each one is only a nop instruction until a tracer attaches to
+// it, so they may be used on the hottest paths. Arguments should be integers
+// or pointers.
+//
+#ifdef QUIC_USDT_ENABLED
+#include <sys/sdt.h>
+#define QuicTraceProbe(Name, ...) STAP_PROBEV(msquic, Name, ##__VA_ARGS__)
+#else
+#define QuicTraceProbe(Name, ...)
+#endif
+
 #ifdef QUIC_CLOG
 
 #if DEBUG
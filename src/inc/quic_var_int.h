@@ -115,6 +115,20 @@ QuicVarIntDecode(
     _Out_ QUIC_VAR_INT* Value
     )
 {
+    if (BufferLength >= sizeof(uint64_t) + *Offset) {
+        //
+        // Fast path when a full 8 bytes can be read: load them all at once
+        // and extract the value with shifts instead of branching on the
+        // length.
+        //
+        uint64_t v;
+        memcpy(&v, Buffer + *Offset, sizeof(uint64_t));
+        v = CxPlatByteSwapUint64(v);
+        const uint8_t Length = (uint8_t)(1 << (v >> 62));
+        *Value = (v << 2) >> (66 - 8 * Length);
+        *Offset += Length;
+        return TRUE;
+    }
     if (BufferLength < sizeof(uint8_t) + *Offset) {
         return FALSE;
     }
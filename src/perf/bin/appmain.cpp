@@ -12,6 +12,7 @@ Abstract:
 #include "SecNetPerf.h"
 #include "LatencyHelpers.h"
 #include "histogram/hdr_histogram.h"
+#include "coordinator.h"
 
 #ifdef _WIN32
 #include <winioctl.h>
@@ -23,11 +24,12 @@ typedef struct {
 #include "quic_driver_helpers.h"
 #endif // _WIN32
 
-void
+bool
 QuicHandleExtraData(
     _In_reads_(Length) uint8_t* ExtraData,
     _In_ uint32_t Length,
-    _In_opt_z_ const char* FileName
+    _In_opt_z_ const char* FileName,
+    _Out_opt_ PERF_LATENCY_RESULT* Result
     )
 {
     uint64_t RunTime;
@@ -45,7 +47,37 @@ QuicHandleExtraData(
     uint32_t RPS = (uint32_t)((CachedCompletedRequests * 1000ull * 1000ull) / RunTime);
     if (RPS == 0) {
         printf("Error: No requests were completed\n");
-        return;
+        return false;
+    }
+
+    //
+    // When response sizes were drawn from a distribution, each latency's size
+    // bucket follows all the latencies. These must be recorded before the
+    // latencies are sorted below.
+    //
+    struct hdr_histogram* BucketHistograms[PERF_SIZE_BUCKET_COUNT] = {0};
+    const bool HasSizeBuckets =
+        Length - sizeof(RunTime) - sizeof(CachedCompletedRequests) >=
+            MaxCount * (sizeof(uint32_t) + sizeof(uint8_t));
+    if (HasSizeBuckets) {
+        const uint32_t* Latencies = (uint32_t*)ExtraData;
+        const uint8_t* Buckets = ExtraData + MaxCount * sizeof(uint32_t);
+        uint32_t MaxLatency = 1;
+        for (uint32_t i = 0; i < MaxCount; i++) {
+            MaxLatency = CXPLAT_MAX(MaxLatency, Latencies[i]);
+        }
+        for (uint32_t i = 0; i < MaxCount; i++) {
+            const uint8_t Bucket = Buckets[i];
+            if (Bucket >= PERF_SIZE_BUCKET_COUNT) {
+                continue;
+            }
+            if (BucketHistograms[Bucket] == nullptr &&
+                hdr_init(1, MaxLatency + 1, 3, &BucketHistograms[Bucket])) {
+                printf("Failed to create histogram\n");
+                break;
+            }
+            hdr_record_value(BucketHistograms[Bucket], Latencies[i]);
+        }
     }
 
     Statistics LatencyStats;
@@ -63,6 +95,33 @@ QuicHandleExtraData(
         PercentileStats.P99p999,
         PercentileStats.P99p9999,
         LatencyStats.Max);
+    if (Result != nullptr) {
+        Result->RPS = RPS;
+        Result->Min = LatencyStats.Min;
+        Result->P50 = PercentileStats.P50;
+        Result->P90 = PercentileStats.P90;
+        Result->P99 = PercentileStats.P99;
+        Result->P99p9 = PercentileStats.P99p9;
+        Result->P99p99 = PercentileStats.P99p99;
+        Result->Max = LatencyStats.Max;
+    }
+
+    for (uint32_t i = 0; i < PERF_SIZE_BUCKET_COUNT; i++) {
+        struct hdr_histogram* Histogram = BucketHistograms[i];
+        if (Histogram == nullptr) {
+            continue;
+        }
+        WriteOutput(
+            "Result: Response %s: %lld requests, Latency,us 50th: %lld, 90th: %lld, 99th: %lld, 99.9th: %lld, Max: %lld\n",
+            PerfSizeBucketNames[i],
+            (long long)Histogram->total_count,
+            (long long)hdr_value_at_percentile(Histogram, 50.0),
+            (long long)hdr_value_at_percentile(Histogram, 90.0),
+            (long long)hdr_value_at_percentile(Histogram, 99.0),
+            (long long)hdr_value_at_percentile(Histogram, 99.9),
+            (long long)hdr_max(Histogram));
+        hdr_close(Histogram);
+    }
 
     if (FileName != nullptr) {
 #ifdef _WIN32
@@ -74,7 +133,7 @@ QuicHandleExtraData(
 #endif
         if (FileErr) {
             printf("Failed to open file '%s' for write, error: %d\n", FileName, FileErr);
-            return;
+            return true;
         }
         struct hdr_histogram* histogram = nullptr;
         if (hdr_init(1, LatencyStats.Max, 3, &histogram)) {
@@ -88,6 +147,108 @@ QuicHandleExtraData(
         }
         fclose(FilePtr);
     }
+    return true;
+}
+
+static
+void
+WriteJsonEscaped(
+    _In_ FILE* File,
+    _In_z_ const char* Value
+    )
+{
+    for (; *Value != '\0'; ++Value) {
+        const unsigned char c = (unsigned char)*Value;
+        if (c == '"' || c == '\\') {
+            fprintf(File, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(File, "\\u%04x", c);
+        } else {
+            fputc(c, File);
+        }
+    }
+}
+
+void
+QuicWriteJsonResult(
+    _In_z_ const char* JsonFileName,
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_ const PERF_CLIENT_SUMMARY* Summary,
+    _In_opt_ const PERF_LATENCY_RESULT* Latency
+    )
+{
+#ifdef _WIN32
+    FILE* File = nullptr;
+    errno_t FileErr = fopen_s(&File, JsonFileName, "w");
+#else
+    FILE* File = fopen(JsonFileName, "w");
+    int FileErr = (File == nullptr) ? 1 : 0;
+#endif
+    if (FileErr) {
+        printf("Failed to open file '%s' for write, error: %d\n", JsonFileName, FileErr);
+        return;
+    }
+
+    //
+    // HPS and RPS are only meaningful for repeat (timed) scenarios.
+    //
+    uint64_t HPS = 0, RPS = 0;
+    if (Summary->RunTime != 0) {
+        HPS = Summary->ConnectionsConnected * 1000 * 1000 / Summary->RunTime;
+        RPS = Summary->StreamsCompleted * 1000 * 1000 / Summary->RunTime;
+    }
+    if (Latency != nullptr) {
+        RPS = Latency->RPS;
+    }
+
+    fprintf(File, "{\n  \"version\": 1,\n  \"args\": \"");
+    for (int i = 1; i < argc; ++i) {
+        if (i != 1) {
+            fputc(' ', File);
+        }
+        WriteJsonEscaped(File, argv[i]);
+    }
+    fprintf(
+        File,
+        "\",\n"
+        "  \"runTimeUs\": %llu,\n"
+        "  \"connections\": %llu,\n"
+        "  \"streams\": %llu,\n"
+        "  \"uploadKbps\": %llu,\n"
+        "  \"downloadKbps\": %llu,\n"
+        "  \"hps\": %llu,\n"
+        "  \"rps\": %llu",
+        (unsigned long long)Summary->RunTime,
+        (unsigned long long)Summary->ConnectionsConnected,
+        (unsigned long long)Summary->StreamsCompleted,
+        (unsigned long long)Summary->UploadRate,
+        (unsigned long long)Summary->DownloadRate,
+        (unsigned long long)HPS,
+        (unsigned long long)RPS);
+    if (Latency != nullptr) {
+        fprintf(
+            File,
+            ",\n"
+            "  \"latencyUs\": {\n"
+            "    \"p0\": %u,\n"
+            "    \"p50\": %.0f,\n"
+            "    \"p90\": %.0f,\n"
+            "    \"p99\": %.0f,\n"
+            "    \"p99.9\": %.0f,\n"
+            "    \"p99.99\": %.0f,\n"
+            "    \"max\": %u\n"
+            "  }",
+            Latency->Min,
+            Latency->P50,
+            Latency->P90,
+            Latency->P99,
+            Latency->P99p9,
+            Latency->P99p99,
+            Latency->Max);
+    }
+    fprintf(File, "\n}\n");
+    fclose(File);
 }
 
 QUIC_STATUS
@@ -98,6 +259,8 @@ QuicUserMain(
     _In_opt_z_ const char* FileName
     ) {
     CxPlatEvent StopEvent {true};
+    const char* JsonFileName = nullptr;
+    TryGetValue(argc, argv, "json", &JsonFileName);
     auto SimpleOutput = GetFlag(argc, argv, "trimout");
     auto AbortOnFailure = GetFlag(argc, argv, "abortOnFailure");
     QUIC_STATUS Status = QuicMainStart(argc, argv, &StopEvent.Handle, SelfSignedCredConfig);
@@ -114,11 +277,21 @@ QuicUserMain(
         goto Exit;
     }
 
-    if (const uint32_t DataLength = QuicMainGetExtraDataLength(); DataLength) {
-        auto Buffer = UniquePtr<uint8_t[]>(new (std::nothrow) uint8_t[DataLength]);
-        CXPLAT_FRE_ASSERT(Buffer.get() != nullptr);
-        QuicMainGetExtraData(Buffer.get(), DataLength);
-        QuicHandleExtraData(Buffer.get(), DataLength, FileName);
+    {
+        PERF_LATENCY_RESULT Latency;
+        bool HasLatency = false;
+        if (const uint32_t DataLength = QuicMainGetExtraDataLength(); DataLength) {
+            auto Buffer = UniquePtr<uint8_t[]>(new (std::nothrow) uint8_t[DataLength]);
+            CXPLAT_FRE_ASSERT(Buffer.get() != nullptr);
+            QuicMainGetExtraData(Buffer.get(), DataLength);
+            HasLatency = QuicHandleExtraData(Buffer.get(), DataLength, FileName, &Latency);
+        }
+
+        PERF_CLIENT_SUMMARY Summary;
+        if (JsonFileName != nullptr && QuicMainGetClientSummary(&Summary)) {
+            QuicWriteJsonResult(
+                JsonFileName, argc, argv, &Summary, HasLatency ? &Latency : nullptr);
+        }
     }
 
 Exit:
@@ -267,7 +440,7 @@ QuicKernelMain(
                     &DataLength,
                     10000);
             if (RunSuccess) {
-                QuicHandleExtraData(Buffer.get(), DataLength, FileName);
+                QuicHandleExtraData(Buffer.get(), DataLength, FileName, nullptr);
             }
         }
     } else {
@@ -315,7 +488,14 @@ main(
     const char* FileName = nullptr;
     TryGetValue(argc, argv, "extraOutputFile", &FileName);
 
-    if (!TryGetTarget(argc, argv)) { // Only create certificate on server
+    const bool IsAgent = GetFlag(argc, argv, "agent");
+    const char* AgentList = nullptr;
+    TryGetValue(argc, argv, "agents", &AgentList);
+
+    const char* IoMode = nullptr;
+    const bool InProcessServer =
+        TryGetValue(argc, argv, "io", &IoMode) && IsValue(IoMode, "loopback");
+    if ((!TryGetTarget(argc, argv) || InProcessServer) && !IsAgent) { // Only create certificate on server
         SelfSignedCredConfig =
             CxPlatGetSelfSignedCert(CXPLAT_SELF_SIGN_CERT_USER, FALSE, NULL);
         if (!SelfSignedCredConfig) {
@@ -330,7 +510,11 @@ main(
         }
     }
 
-    if (DriverName != nullptr) {
+    if (IsAgent) {
+        Status = QuicAgentMain(argc, argv);
+    } else if (AgentList != nullptr) {
+        Status = QuicCoordinatorMain(argc, argv, FileName);
+    } else if (DriverName != nullptr) {
 #if defined(_WIN32) && !defined(QUIC_RESTRICTED_BUILD)
         printf("Entering kernel mode main\n");
         Status = QuicKernelMain(argc, argv, SelfSignedCredConfig, PrivateTestLibrary, DriverName, FileName);
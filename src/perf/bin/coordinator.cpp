@@ -0,0 +1,642 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Coordinated runs of secnetperf clients on several agents.
+
+    An agent (-agent) listens on a TCP control port. A coordinator (-agents:)
+    connects to every agent, sends each the client's arguments, waits until
+    all of them are ready, then tells all of them to start together. Each
+    agent runs the client and sends back its totals and latency samples, which
+    the coordinator merges into one report.
+
+    The control channel is plain TCP, rather than QUIC, so that it doesn't
+    share (or have to configure) the library instance being measured.
+
+--*/
+
+#include "SecNetPerf.h"
+#include "coordinator.h"
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+typedef SOCKET PERF_SOCKET;
+#define PERF_INVALID_SOCKET INVALID_SOCKET
+#define PerfCloseSocket closesocket
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+typedef int PERF_SOCKET;
+#define PERF_INVALID_SOCKET (-1)
+#define PerfCloseSocket close
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define PERF_SEND_FLAGS MSG_NOSIGNAL // A dead peer shouldn't kill the process.
+#else
+#define PERF_SEND_FLAGS 0
+#endif
+
+#define PERF_MAX_AGENTS                     64
+#define PERF_CONTROL_MAX_ARGS               128
+#define PERF_CONTROL_MAX_LENGTH             (512 * 1024 * 1024)
+
+//
+// Every control message is a PERF_CONTROL_HEADER followed by Length bytes of
+// payload. Values are in host byte order, so the agents and the coordinator
+// must share one.
+//
+enum PERF_CONTROL_TYPE : uint32_t {
+    PERF_CONTROL_ARGS = 1,  // Coordinator: the client's arguments, each NUL terminated.
+    PERF_CONTROL_READY,     // Agent: ready to start.
+    PERF_CONTROL_GO,        // Coordinator: start now.
+    PERF_CONTROL_RESULT,    // Agent: PERF_CONTROL_RESULT_HEADER, then the extra data.
+};
+
+struct PERF_CONTROL_HEADER {
+    uint32_t Type;
+    uint32_t Length;
+};
+
+struct PERF_CONTROL_RESULT_HEADER {
+    uint32_t Status;
+    uint32_t Reserved;
+    PERF_CLIENT_SUMMARY Summary;
+};
+
+struct PerfSocketLibrary {
+#ifdef _WIN32
+    bool Initialized;
+    PerfSocketLibrary() {
+        WSADATA WsaData;
+        Initialized = WSAStartup(MAKEWORD(2, 2), &WsaData) == 0;
+    }
+    ~PerfSocketLibrary() { if (Initialized) { WSACleanup(); } }
+#else
+    bool Initialized {true};
+#endif
+};
+
+static
+bool
+PerfSendAll(
+    _In_ PERF_SOCKET Socket,
+    _In_reads_bytes_(Length) const void* Buffer,
+    _In_ size_t Length
+    )
+{
+    const char* Cur = (const char*)Buffer;
+    while (Length != 0) {
+        const int Sent =
+            send(Socket, Cur, (int)CXPLAT_MIN(Length, (size_t)0x10000000), PERF_SEND_FLAGS);
+        if (Sent <= 0) {
+            return false;
+        }
+        Cur += Sent;
+        Length -= (size_t)Sent;
+    }
+    return true;
+}
+
+static
+bool
+PerfRecvAll(
+    _In_ PERF_SOCKET Socket,
+    _Out_writes_bytes_(Length) void* Buffer,
+    _In_ size_t Length
+    )
+{
+    char* Cur = (char*)Buffer;
+    while (Length != 0) {
+        const int Received =
+            recv(Socket, Cur, (int)CXPLAT_MIN(Length, (size_t)0x10000000), 0);
+        if (Received <= 0) {
+            return false;
+        }
+        Cur += Received;
+        Length -= (size_t)Received;
+    }
+    return true;
+}
+
+static
+bool
+PerfSendMessage(
+    _In_ PERF_SOCKET Socket,
+    _In_ PERF_CONTROL_TYPE Type,
+    _In_reads_bytes_opt_(Length) const void* Payload = nullptr,
+    _In_ uint32_t Length = 0,
+    _In_reads_bytes_opt_(Length2) const void* Payload2 = nullptr,
+    _In_ uint32_t Length2 = 0
+    )
+{
+    PERF_CONTROL_HEADER Header = { Type, Length + Length2 };
+    return
+        PerfSendAll(Socket, &Header, sizeof(Header)) &&
+        (Length == 0 || PerfSendAll(Socket, Payload, Length)) &&
+        (Length2 == 0 || PerfSendAll(Socket, Payload2, Length2));
+}
+
+//
+// Receives a message of the expected type. The payload is NUL terminated, one
+// byte past Length.
+//
+static
+bool
+PerfRecvMessage(
+    _In_ PERF_SOCKET Socket,
+    _In_ PERF_CONTROL_TYPE Type,
+    _Out_ UniquePtr<uint8_t[]>& Payload,
+    _Out_ uint32_t* Length
+    )
+{
+    PERF_CONTROL_HEADER Header;
+    if (!PerfRecvAll(Socket, &Header, sizeof(Header))) {
+        return false;
+    }
+    if (Header.Type != (uint32_t)Type || Header.Length > PERF_CONTROL_MAX_LENGTH) {
+        printf("Unexpected control message (type %u, length %u)!\n", Header.Type, Header.Length);
+        return false;
+    }
+    Payload.reset(new(std::nothrow) uint8_t[Header.Length + 1]);
+    if (Payload == nullptr || !PerfRecvAll(Socket, Payload.get(), Header.Length)) {
+        return false;
+    }
+    Payload[Header.Length] = 0;
+    *Length = Header.Length;
+    return true;
+}
+
+static
+void
+PerfSetNoDelay(
+    _In_ PERF_SOCKET Socket
+    )
+{
+    int Opt = 1;
+    (void)setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&Opt, sizeof(Opt));
+}
+
+//
+// Returns true if Arg is "-<Name>" or "-<Name>:<value>".
+//
+static
+bool
+PerfIsArg(
+    _In_z_ const char* Arg,
+    _In_z_ const char* Name
+    )
+{
+    const size_t NameLen = strlen(Name);
+    return
+        Arg[0] == '-' &&
+        _strnicmp(Arg + 1, Name, NameLen) == 0 &&
+        (Arg[NameLen + 1] == '\0' || Arg[NameLen + 1] == ':');
+}
+
+static
+void
+QuicAgentServe(
+    _In_ PERF_SOCKET Control
+    )
+{
+    UniquePtr<uint8_t[]> Args;
+    uint32_t ArgsLength;
+    if (!PerfRecvMessage(Control, PERF_CONTROL_ARGS, Args, &ArgsLength)) {
+        return;
+    }
+
+    //
+    // The arguments start with the app name, like the process's own.
+    //
+    char* Argv[PERF_CONTROL_MAX_ARGS];
+    int Argc = 0;
+    char* Cur = (char*)Args.get();
+    char* End = Cur + ArgsLength;
+    while (Cur < End && Argc < PERF_CONTROL_MAX_ARGS) {
+        Argv[Argc++] = Cur;
+        Cur += strlen(Cur) + 1;
+    }
+
+    if (!PerfSendMessage(Control, PERF_CONTROL_READY)) {
+        return;
+    }
+    UniquePtr<uint8_t[]> Go;
+    uint32_t GoLength;
+    if (!PerfRecvMessage(Control, PERF_CONTROL_GO, Go, &GoLength)) {
+        return;
+    }
+
+    PERF_CONTROL_RESULT_HEADER Result = {};
+    UniquePtr<uint8_t[]> ExtraData;
+    uint32_t ExtraLength = 0;
+    QUIC_STATUS Status;
+    if (Argc < 2 || !TryGetTarget(Argc - 1, Argv + 1)) {
+        printf("Coordinator didn't specify a target!\n");
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+    } else {
+        printf("Starting run for coordinator\n");
+        fflush(stdout);
+        CxPlatEvent StopEvent {true};
+        Status = QuicMainStart(Argc, Argv, &StopEvent.Handle, nullptr);
+        if (QUIC_SUCCEEDED(Status)) {
+            Status = QuicMainWaitForCompletion();
+        }
+        if (QUIC_SUCCEEDED(Status)) {
+            QuicMainGetClientSummary(&Result.Summary);
+            ExtraLength = QuicMainGetExtraDataLength();
+            if (ExtraLength != 0) {
+                ExtraData.reset(new(std::nothrow) uint8_t[ExtraLength]);
+                if (ExtraData == nullptr) {
+                    ExtraLength = 0;
+                } else {
+                    QuicMainGetExtraData(ExtraData.get(), ExtraLength);
+                }
+            }
+        }
+        QuicMainFree();
+        printf("Run complete, status 0x%x\n", (uint32_t)Status);
+    }
+
+    Result.Status = (uint32_t)Status;
+    (void)PerfSendMessage(
+        Control, PERF_CONTROL_RESULT,
+        &Result, sizeof(Result), ExtraData.get(), ExtraLength);
+}
+
+QUIC_STATUS
+QuicAgentMain(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    uint16_t Port = PERF_DEFAULT_AGENT_PORT;
+    TryGetValue(argc, argv, "agentport", &Port);
+
+    PerfSocketLibrary SocketLibrary;
+    if (!SocketLibrary.Initialized) {
+        printf("Failed to initialize sockets!\n");
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
+    PERF_SOCKET Listener = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+    if (Listener == PERF_INVALID_SOCKET) {
+        printf("Failed to create agent socket!\n");
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+    int Opt = 0;
+    (void)setsockopt(Listener, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&Opt, sizeof(Opt));
+#ifndef _WIN32
+    Opt = 1;
+    (void)setsockopt(Listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&Opt, sizeof(Opt));
+#endif
+
+    sockaddr_in6 Address = {};
+    Address.sin6_family = AF_INET6;
+    Address.sin6_port = htons(Port);
+    Address.sin6_addr = in6addr_any;
+    if (bind(Listener, (const sockaddr*)&Address, sizeof(Address)) != 0 ||
+        listen(Listener, PERF_MAX_AGENTS) != 0) {
+        printf("Failed to listen on agent port %hu!\n", Port);
+        PerfCloseSocket(Listener);
+        return QUIC_STATUS_ADDRESS_IN_USE;
+    }
+
+    printf("Agent listening on port %hu\n", Port);
+    fflush(stdout);
+
+    //
+    // Coordinators are served one at a time, so runs never overlap.
+    //
+    for (;;) {
+        PERF_SOCKET Control = accept(Listener, nullptr, nullptr);
+        if (Control == PERF_INVALID_SOCKET) {
+            break;
+        }
+        PerfSetNoDelay(Control);
+        QuicAgentServe(Control);
+        PerfCloseSocket(Control);
+        fflush(stdout);
+    }
+
+    PerfCloseSocket(Listener);
+    return QUIC_STATUS_INTERNAL_ERROR;
+}
+
+struct PerfAgent {
+    char Name[256] {};
+    PERF_SOCKET Socket {PERF_INVALID_SOCKET};
+    PERF_CONTROL_RESULT_HEADER Result {};
+    UniquePtr<uint8_t[]> ExtraData;
+    uint32_t ExtraLength {0};
+    ~PerfAgent() {
+        if (Socket != PERF_INVALID_SOCKET) {
+            PerfCloseSocket(Socket);
+        }
+    }
+};
+
+//
+// Connects to an agent given as "host", "host:port" or "[v6 address]:port".
+//
+static
+bool
+PerfAgentConnect(
+    _Inout_ PerfAgent* Agent,
+    _In_z_ const char* Entry
+    )
+{
+    if (strlen(Entry) >= sizeof(Agent->Name)) {
+        printf("Invalid agent '%s'!\n", Entry);
+        return false;
+    }
+    CxPlatCopyMemory(Agent->Name, Entry, strlen(Entry) + 1);
+    char HostBuffer[sizeof(Agent->Name)];
+    CxPlatCopyMemory(HostBuffer, Entry, strlen(Entry) + 1);
+    char* Host = HostBuffer;
+    char DefaultPort[8];
+    snprintf(DefaultPort, sizeof(DefaultPort), "%u", PERF_DEFAULT_AGENT_PORT);
+    const char* Port = DefaultPort;
+    if (Host[0] == '[') {
+        char* Close = strchr(Host, ']');
+        if (Close == nullptr) {
+            printf("Invalid agent '%s'!\n", Entry);
+            return false;
+        }
+        *Close = '\0';
+        ++Host;
+        if (Close[1] == ':') {
+            Port = Close + 2;
+        }
+    } else {
+        char* Colon = strchr(Host, ':');
+        if (Colon != nullptr && strchr(Colon + 1, ':') == nullptr) {
+            *Colon = '\0';
+            Port = Colon + 1;
+        }
+    }
+
+    addrinfo Hints = {};
+    Hints.ai_family = AF_UNSPEC;
+    Hints.ai_socktype = SOCK_STREAM;
+    Hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* Addresses = nullptr;
+    if (getaddrinfo(Host, Port, &Hints, &Addresses) != 0) {
+        printf("Failed to resolve agent '%s'!\n", Host);
+        return false;
+    }
+    for (addrinfo* Cur = Addresses; Cur != nullptr; Cur = Cur->ai_next) {
+        Agent->Socket = socket(Cur->ai_family, Cur->ai_socktype, Cur->ai_protocol);
+        if (Agent->Socket == PERF_INVALID_SOCKET) {
+            continue;
+        }
+        if (connect(Agent->Socket, Cur->ai_addr, (int)Cur->ai_addrlen) == 0) {
+            break;
+        }
+        PerfCloseSocket(Agent->Socket);
+        Agent->Socket = PERF_INVALID_SOCKET;
+    }
+    freeaddrinfo(Addresses);
+    if (Agent->Socket == PERF_INVALID_SOCKET) {
+        printf("Failed to connect to agent '%s' port %s!\n", Host, Port);
+        return false;
+    }
+    PerfSetNoDelay(Agent->Socket);
+    return true;
+}
+
+QUIC_STATUS
+QuicCoordinatorMain(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_opt_z_ const char* FileName
+    )
+{
+    const char* AgentList = nullptr;
+    if (!TryGetValue(argc, argv, "agents", &AgentList) || *AgentList == '\0') {
+        printf("Must specify at least one agent!\n");
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+    if (!TryGetTarget(argc, argv)) {
+        printf("Must specify a 'target' for the agents' clients!\n");
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    //
+    // Forward everything but the coordinator's own arguments.
+    //
+    size_t ArgsLength = 0;
+    for (int i = 0; i < argc; ++i) {
+        ArgsLength += strlen(argv[i]) + 1;
+    }
+    UniquePtr<char[]> Args(new(std::nothrow) char[ArgsLength]);
+    if (Args == nullptr) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    ArgsLength = 0;
+    for (int i = 0; i < argc; ++i) {
+        if (i != 0 &&
+            (PerfIsArg(argv[i], "agents") ||
+             PerfIsArg(argv[i], "extraOutputFile") ||
+             PerfIsArg(argv[i], "json"))) {
+            continue;
+        }
+        const size_t Length = strlen(argv[i]) + 1;
+        CxPlatCopyMemory(Args.get() + ArgsLength, argv[i], Length);
+        ArgsLength += Length;
+    }
+
+    PerfSocketLibrary SocketLibrary;
+    if (!SocketLibrary.Initialized) {
+        printf("Failed to initialize sockets!\n");
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
+    const size_t AgentListLength = strlen(AgentList) + 1;
+    UniquePtr<char[]> AgentNames(new(std::nothrow) char[AgentListLength]);
+    UniquePtr<PerfAgent[]> Agents(new(std::nothrow) PerfAgent[PERF_MAX_AGENTS]);
+    if (AgentNames == nullptr || Agents == nullptr) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    CxPlatCopyMemory(AgentNames.get(), AgentList, AgentListLength);
+
+    uint32_t AgentCount = 0;
+    for (char* Entry = AgentNames.get(); Entry != nullptr; ) {
+        char* Next = strchr(Entry, ',');
+        if (Next != nullptr) {
+            *Next++ = '\0';
+        }
+        if (*Entry != '\0') {
+            if (AgentCount == PERF_MAX_AGENTS) {
+                printf("At most %u agents are supported!\n", PERF_MAX_AGENTS);
+                return QUIC_STATUS_INVALID_PARAMETER;
+            }
+            if (!PerfAgentConnect(&Agents[AgentCount], Entry)) {
+                return QUIC_STATUS_UNREACHABLE;
+            }
+            ++AgentCount;
+        }
+        Entry = Next;
+    }
+
+    //
+    // Everything slow (connecting, parsing) happens before GO, so the agents
+    // start within a control channel latency of each other.
+    //
+    for (uint32_t i = 0; i < AgentCount; ++i) {
+        if (!PerfSendMessage(Agents[i].Socket, PERF_CONTROL_ARGS, Args.get(), (uint32_t)ArgsLength)) {
+            printf("Failed to send arguments to agent '%s'!\n", Agents[i].Name);
+            return QUIC_STATUS_CONNECTION_REFUSED;
+        }
+    }
+    for (uint32_t i = 0; i < AgentCount; ++i) {
+        UniquePtr<uint8_t[]> Ready;
+        uint32_t ReadyLength;
+        if (!PerfRecvMessage(Agents[i].Socket, PERF_CONTROL_READY, Ready, &ReadyLength)) {
+            printf("Agent '%s' isn't ready!\n", Agents[i].Name);
+            return QUIC_STATUS_CONNECTION_REFUSED;
+        }
+    }
+    for (uint32_t i = 0; i < AgentCount; ++i) {
+        if (!PerfSendMessage(Agents[i].Socket, PERF_CONTROL_GO)) {
+            printf("Failed to start agent '%s'!\n", Agents[i].Name);
+            return QUIC_STATUS_CONNECTION_REFUSED;
+        }
+    }
+    printf("Started %u agents!\n\n", AgentCount);
+    fflush(stdout);
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    PERF_CLIENT_SUMMARY Total = {};
+    uint64_t LatencyCount = 0;
+    bool AllSizeBuckets = true;
+    for (uint32_t i = 0; i < AgentCount; ++i) {
+        PerfAgent& Agent = Agents[i];
+        UniquePtr<uint8_t[]> Payload;
+        uint32_t Length;
+        if (!PerfRecvMessage(Agent.Socket, PERF_CONTROL_RESULT, Payload, &Length) ||
+            Length < sizeof(Agent.Result)) {
+            printf("Agent '%s' didn't return results!\n", Agent.Name);
+            Status = QUIC_STATUS_ABORTED;
+            continue;
+        }
+        CxPlatCopyMemory(&Agent.Result, Payload.get(), sizeof(Agent.Result));
+        if (QUIC_FAILED((QUIC_STATUS)Agent.Result.Status)) {
+            printf("Agent '%s' failed, 0x%x\n", Agent.Name, Agent.Result.Status);
+            Status = (QUIC_STATUS)Agent.Result.Status;
+            continue;
+        }
+
+        const PERF_CLIENT_SUMMARY& Summary = Agent.Result.Summary;
+        printf(
+            "Agent '%s': %llu connections, %llu streams, upload %llu kbps, download %llu kbps\n",
+            Agent.Name,
+            (unsigned long long)Summary.ConnectionsConnected,
+            (unsigned long long)Summary.StreamsCompleted,
+            (unsigned long long)Summary.UploadRate,
+            (unsigned long long)Summary.DownloadRate);
+        Total.ConnectionsConnected += Summary.ConnectionsConnected;
+        Total.StreamsCompleted += Summary.StreamsCompleted;
+        Total.UploadRate += Summary.UploadRate;
+        Total.DownloadRate += Summary.DownloadRate;
+        if (Summary.RunTime > Total.RunTime) {
+            Total.RunTime = Summary.RunTime;
+        }
+
+        //
+        // Extra data is the run time and sample count, the latencies, then
+        // optionally a size bucket per sample.
+        //
+        Agent.ExtraLength = Length - sizeof(Agent.Result);
+        if (Agent.ExtraLength >= sizeof(uint64_t) * 2) {
+            Agent.ExtraData.reset(new(std::nothrow) uint8_t[Agent.ExtraLength]);
+            if (Agent.ExtraData != nullptr) {
+                CxPlatCopyMemory(
+                    Agent.ExtraData.get(), Payload.get() + sizeof(Agent.Result), Agent.ExtraLength);
+                uint64_t Count;
+                CxPlatCopyMemory(&Count, Agent.ExtraData.get() + sizeof(uint64_t), sizeof(Count));
+                const uint64_t MaxCount = (Agent.ExtraLength - sizeof(uint64_t) * 2) / sizeof(uint32_t);
+                if (Count > MaxCount) {
+                    Count = MaxCount;
+                }
+                CxPlatCopyMemory(Agent.ExtraData.get() + sizeof(uint64_t), &Count, sizeof(Count));
+                if (Agent.ExtraLength - sizeof(uint64_t) * 2 < Count * 5) {
+                    AllSizeBuckets = false;
+                }
+                LatencyCount += Count;
+                continue;
+            }
+        }
+        Agent.ExtraLength = 0;
+    }
+
+    printf(
+        "\nResult: %u agents, %llu connections, %llu streams\n",
+        AgentCount,
+        (unsigned long long)Total.ConnectionsConnected,
+        (unsigned long long)Total.StreamsCompleted);
+    if (Total.RunTime != 0 && Total.ConnectionsConnected != 0) {
+        printf(
+            "Result: %llu HPS\n",
+            (unsigned long long)(Total.ConnectionsConnected * 1000 * 1000 / Total.RunTime));
+    }
+    if (Total.UploadRate != 0) {
+        printf("Result: Upload %llu kbps.\n", (unsigned long long)Total.UploadRate);
+    }
+    if (Total.DownloadRate != 0) {
+        printf("Result: Download %llu kbps.\n", (unsigned long long)Total.DownloadRate);
+    }
+
+    //
+    // Merge every agent's samples into one set, and report it like a single
+    // client's.
+    //
+    PERF_LATENCY_RESULT Latency;
+    bool HasLatency = false;
+    const uint64_t MergedLength =
+        sizeof(uint64_t) * 2 + LatencyCount * (sizeof(uint32_t) + (AllSizeBuckets ? 1 : 0));
+    if (LatencyCount != 0 && Total.RunTime != 0 && MergedLength <= UINT32_MAX) {
+        UniquePtr<uint8_t[]> Merged(new(std::nothrow) uint8_t[MergedLength]);
+        if (Merged != nullptr) {
+            CxPlatCopyMemory(Merged.get(), &Total.RunTime, sizeof(uint64_t));
+            CxPlatCopyMemory(Merged.get() + sizeof(uint64_t), &LatencyCount, sizeof(uint64_t));
+            uint8_t* Latencies = Merged.get() + sizeof(uint64_t) * 2;
+            uint8_t* Buckets = Latencies + LatencyCount * sizeof(uint32_t);
+            for (uint32_t i = 0; i < AgentCount; ++i) {
+                if (Agents[i].ExtraLength == 0) {
+                    continue;
+                }
+                uint64_t Count;
+                CxPlatCopyMemory(&Count, Agents[i].ExtraData.get() + sizeof(uint64_t), sizeof(Count));
+                const uint8_t* Source = Agents[i].ExtraData.get() + sizeof(uint64_t) * 2;
+                CxPlatCopyMemory(Latencies, Source, (size_t)Count * sizeof(uint32_t));
+                Latencies += Count * sizeof(uint32_t);
+                if (AllSizeBuckets) {
+                    CxPlatCopyMemory(Buckets, Source + Count * sizeof(uint32_t), (size_t)Count);
+                    Buckets += Count;
+                }
+            }
+            HasLatency =
+                QuicHandleExtraData(
+                    Merged.get(), (uint32_t)MergedLength, FileName, &Latency);
+        }
+    } else if (Total.RunTime != 0 && Total.StreamsCompleted != 0) {
+        printf(
+            "Result: %llu RPS\n",
+            (unsigned long long)(Total.StreamsCompleted * 1000 * 1000 / Total.RunTime));
+    }
+
+    const char* JsonFileName = nullptr;
+    if (TryGetValue(argc, argv, "json", &JsonFileName)) {
+        QuicWriteJsonResult(
+            JsonFileName, argc, argv, &Total, HasLatency ? &Latency : nullptr);
+    }
+
+    return Status;
+}
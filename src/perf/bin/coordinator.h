@@ -0,0 +1,73 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Coordinated runs of secnetperf clients on several agents (processes or
+    machines), with their results aggregated into one report.
+
+--*/
+
+#pragma once
+
+//
+// The latency results of a client run, as printed.
+//
+typedef struct PERF_LATENCY_RESULT {
+    uint32_t RPS;
+    uint32_t Min;                   // us
+    double P50;
+    double P90;
+    double P99;
+    double P99p9;
+    double P99p99;
+    uint32_t Max;
+} PERF_LATENCY_RESULT;
+
+//
+// Prints the latency results (extra data) of a client run, and optionally
+// returns them. Defined in appmain.cpp.
+//
+bool
+QuicHandleExtraData(
+    _In_reads_(Length) uint8_t* ExtraData,
+    _In_ uint32_t Length,
+    _In_opt_z_ const char* FileName,
+    _Out_opt_ PERF_LATENCY_RESULT* Result
+    );
+
+//
+// Writes the results of a client run to JsonFileName, for scripts comparing
+// runs (see scripts/perf-regression.ps1). Defined in appmain.cpp.
+//
+void
+QuicWriteJsonResult(
+    _In_z_ const char* JsonFileName,
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_ const PERF_CLIENT_SUMMARY* Summary,
+    _In_opt_ const PERF_LATENCY_RESULT* Latency
+    );
+
+//
+// Serves coordinators on the control port, running a client for each of
+// them, one at a time, until the process is stopped.
+//
+QUIC_STATUS
+QuicAgentMain(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    );
+
+//
+// Runs the client described by the rest of the command line on each of the
+// agents together, and prints the aggregated results.
+//
+QUIC_STATUS
+QuicCoordinatorMain(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_opt_z_ const char* FileName
+    );
@@ -67,6 +67,21 @@ PerfClient::Init(
             RunTime = S_TO_US(20); // 20 seconds
             RepeatStreams = TRUE;
             PrintLatency = TRUE;
+        } else if (IsValue(ScenarioStr, "datagram")) {
+            DatagramSize = 1000;
+            RunTime = S_TO_US(12); // 12 seconds
+            PrintThroughput = TRUE;
+        } else if (IsValue(ScenarioStr, "datagram-latency")) {
+            DatagramSize = 200;
+            RequestRate = 1000; // 1000 datagrams a second, like a media stream
+            RunTime = S_TO_US(20); // 20 seconds
+        } else if (IsValue(ScenarioStr, "h3")) {
+            RequestSizes.Initialize("lognormal:400:0.5:16000");
+            ResponseSizes.Initialize("pareto:1000:1.2:10000000");
+            StreamCount = 10;
+            RunTime = S_TO_US(20); // 20 seconds
+            RepeatStreams = TRUE;
+            PrintLatency = TRUE;
         } else {
             WriteOutput("Failed to parse scenario profile[%s]!\n", ScenarioStr);
             return QUIC_STATUS_INVALID_PARAMETER;
@@ -181,6 +196,25 @@ PerfClient::Init(
     if (TryGetVariableUnitValue(argc, argv, DownloadVarNames, &Download, &IsTimeUnit)) {
         Timed = IsTimeUnit ? 1 : 0;
     }
+    const char* DistStr;
+    if (TryGetValue(argc, argv, "reqsize", &DistStr) && !RequestSizes.Initialize(DistStr)) {
+        WriteOutput("Failed to parse 'reqsize' distribution[%s]!\n", DistStr);
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+    if (TryGetValue(argc, argv, "respsize", &DistStr) && !ResponseSizes.Initialize(DistStr)) {
+        WriteOutput("Failed to parse 'respsize' distribution[%s]!\n", DistStr);
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+    if (TryGetValue(argc, argv, "think", &DistStr) && !ThinkTimes.Initialize(DistStr)) {
+        WriteOutput("Failed to parse 'think' distribution[%s]!\n", DistStr);
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+    TryGetValue(argc, argv, "prio", &UsePriority);
+    TryGetVariableUnitValue(argc, argv, "rate", &RequestRate);
+    TryGetValue(argc, argv, "datagram", &DatagramSize);
+    TryGetValue(argc, argv, "dgwindow", &DatagramWindow);
+    TryGetValue(argc, argv, "dgoneway", &DatagramOneWay);
+
     const char* RunVarNames[] = {"runtime", "time", "run", nullptr};
     TryGetVariableUnitValue(argc, argv, RunVarNames, &RunTime, &IsTimeUnit);
     //TryGetValue(argc, argv, "inline", &SendInline);
@@ -195,17 +229,78 @@ PerfClient::Init(
     }
 
     if (UseTCP) {
-        if (!UseEncryption) {
-            WriteOutput("TCP mode doesn't support disabling encryption!\n");
-            return QUIC_STATUS_INVALID_PARAMETER;
-        }
+        TcpConfig.EncryptStreams = UseEncryption != FALSE;
         if (CibirBytes) {
             WriteOutput("TCP mode doesn't support CIBIR!\n");
             return QUIC_STATUS_INVALID_PARAMETER;
         }
+        if (ThinkTimes.IsEnabled() || UsePriority) {
+            WriteOutput("TCP mode doesn't support think times or priorities!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    if ((RequestSizes.IsEnabled() || ResponseSizes.IsEnabled()) && Timed) {
+        WriteOutput("Size distributions can't be used with timed transfers!\n");
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (ThinkTimes.IsEnabled() && !RepeatStreams) {
+        WriteOutput("Must use 'rstream' if using 'think'!\n");
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (DatagramSize) {
+        if (DatagramSize < sizeof(PERF_DATAGRAM_ECHO) ||
+            DatagramSize > sizeof(PERF_DATAGRAM_HEADER) + IoSize) {
+            WriteOutput("'datagram' must be from %u to %u bytes!\n",
+                (uint32_t)sizeof(PERF_DATAGRAM_ECHO),
+                (uint32_t)sizeof(PERF_DATAGRAM_HEADER) + IoSize);
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (UseTCP) {
+            WriteOutput("TCP mode doesn't support 'datagram'!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (!RunTime) {
+            WriteOutput("Must specify a 'runtime' if using 'datagram'!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (StreamCount || Upload || Download || RequestSizes.IsEnabled() ||
+            ResponseSizes.IsEnabled() || ThinkTimes.IsEnabled() ||
+            RepeatConnections || RepeatStreams) {
+            WriteOutput("'datagram' can't be used with streams or 'rconn'!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (!DatagramWindow) {
+            WriteOutput("'dgwindow' must be at least 1!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (RequestRate) {
+            PrintLatency = TRUE; // Of the echoes
+        }
+    }
+
+    if (RequestRate) {
+        if (!RunTime) {
+            WriteOutput("Must specify a 'runtime' if using 'rate'!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (RepeatConnections || RepeatStreams || ThinkTimes.IsEnabled()) {
+            WriteOutput("'rate' can't be used with 'rconn', 'rstream' or 'think'!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (UseTCP) {
+            WriteOutput("TCP mode doesn't support 'rate'!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        if (!StreamCount && !DatagramSize) {
+            StreamCount = 1; // Only checked to imply streams are used
+        }
     }
 
-    if ((Upload || Download) && !StreamCount) {
+    if ((Upload || Download || RequestSizes.IsEnabled() || ResponseSizes.IsEnabled()) &&
+        !StreamCount) {
         StreamCount = 1; // Just up/down args imply they want a stream
     }
 
@@ -231,6 +326,9 @@ PerfClient::Init(
         MsQuicSettings Settings;
         Settings.SetSendBufferingEnabled(UseSendBuffering != 0);
         Settings.SetPacingEnabled(UsePacing != 0);
+        if (DatagramSize) {
+            Settings.SetDatagramReceiveEnabled(true); // For the echoes
+        }
         const char* IoMode = GetValue(argc, argv, "io");
         if (IoMode && IsValue(IoMode, "xdp")) {
             Settings.SetXdpEnabled(true);
@@ -239,6 +337,9 @@ PerfClient::Init(
             Settings.SetXdpEnabled(true);
             Settings.SetQtipEnabled(true);
         }
+        if (IoMode && IsValue(IoMode, "rio")) {
+            Settings.SetRioEnabled(true);
+        }
 #ifndef CXPLAT_USE_IO_URING
         if (IoMode && IsValue(IoMode, "iouring")) {
             WriteOutput("iouring is not supported on this build\n");
@@ -276,6 +377,13 @@ PerfClient::Init(
             return QUIC_STATUS_OUT_OF_MEMORY;
         }
         CxPlatZeroMemory(LatencyValues.get(), (size_t)(sizeof(uint32_t) * MaxLatencyIndex));
+
+        if (ResponseSizes.IsEnabled()) {
+            LatencySizeBuckets = UniquePtr<uint8_t[]>(new(std::nothrow) uint8_t[(size_t)MaxLatencyIndex]);
+            if (LatencySizeBuckets == nullptr) {
+                return QUIC_STATUS_OUT_OF_MEMORY;
+            }
+        }
     }
 
     return QUIC_STATUS_SUCCESS;
@@ -312,6 +420,7 @@ PerfClient::Start(
         nullptr
     };
     const size_t TargetLen = strlen(Target.get());
+    uint64_t ConnectionsAssigned = 0;
     for (uint32_t i = 0; i < WorkerCount; ++i) {
         auto Worker = &Workers[i];
         Worker->Processor = (uint16_t)i;
@@ -324,6 +433,12 @@ PerfClient::Start(
             Worker->ConnectionsQueued++;
         }
 
+        // Split the open loop request rate in proportion to the connections.
+        Worker->RequestRate =
+            (RequestRate * (ConnectionsAssigned + Worker->ConnectionsQueued)) / ConnectionCount -
+            (RequestRate * ConnectionsAssigned) / ConnectionCount;
+        ConnectionsAssigned += Worker->ConnectionsQueued;
+
         // Build up target hostname.
         Worker->Target.reset(new(std::nothrow) char[TargetLen + 10]);
         CxPlatCopyMemory(Worker->Target.get(), Target.get(), TargetLen);
@@ -376,6 +491,51 @@ PerfClient::Wait(
     unsigned long long CompletedConnections = GetConnectedConnections();
     unsigned long long CompletedStreams = GetStreamsCompleted();
 
+    if (RequestRate) {
+        //
+        // Requests still outstanding at the end have no latency sample, so
+        // a large number here means the tail is understated.
+        //
+        WriteOutput(
+            "Result: Offered %llu RPS, %llu requests incomplete\n",
+            (unsigned long long)RequestRate,
+            (unsigned long long)(GetStreamsStarted() - CompletedStreams));
+    }
+
+    if (DatagramSize) {
+        //
+        // Only datagrams whose fate was known before the end are counted as
+        // acknowledged or lost; those still in flight are neither.
+        //
+        const uint64_t Sent = GetDatagramTotal(&PerfClientWorker::DatagramsSent);
+        const uint64_t Acked = GetDatagramTotal(&PerfClientWorker::DatagramsAcked);
+        const uint64_t Lost = GetDatagramTotal(&PerfClientWorker::DatagramsLost);
+        const uint64_t Settled = CXPLAT_MAX(Acked + Lost, 1);
+        WriteOutput(
+            "Result: Datagrams sent %llu, acknowledged %llu, lost %llu (%llu.%02llu%%), canceled %llu.\n",
+            (unsigned long long)Sent,
+            (unsigned long long)Acked,
+            (unsigned long long)Lost,
+            (unsigned long long)(Lost * 100 / Settled),
+            (unsigned long long)(Lost * 10000 / Settled % 100),
+            (unsigned long long)GetDatagramTotal(&PerfClientWorker::DatagramsCanceled));
+        if (RequestRate) {
+            const uint64_t Echoed = GetDatagramTotal(&PerfClientWorker::DatagramsEchoed);
+            WriteOutput(
+                "Result: Offered %llu datagrams/s, %llu echoed.\n",
+                (unsigned long long)RequestRate,
+                (unsigned long long)Echoed);
+        }
+        if (Sent) {
+            const uint64_t Changes = GetDatagramTotal(&PerfClientWorker::DatagramStateChanges);
+            WriteOutput(
+                "Result: %llu send state changes, %llu.%02llu per datagram.\n",
+                (unsigned long long)Changes,
+                (unsigned long long)(Changes / Sent),
+                (unsigned long long)(Changes * 100 / Sent % 100));
+        }
+    }
+
     if (PrintIoRate) {
         if (CompletedConnections) {
             unsigned long long HPS = CompletedConnections * 1000 * 1000 / RunTime;
@@ -423,7 +583,7 @@ PerfClient::GetExtraDataLength(
         (uint32_t)(
         sizeof(RunTime) +
         sizeof(CurLatencyIndex) +
-        (LatencyCount * sizeof(uint32_t)));
+        (LatencyCount * GetLatencySampleLength()));
 }
 
 void
@@ -436,10 +596,17 @@ PerfClient::GetExtraData(
     CXPLAT_FRE_ASSERT(Length >= sizeof(RunTime) + sizeof(CurLatencyIndex));
     CxPlatCopyMemory(Data, &RunTime, sizeof(RunTime));
     Data += sizeof(RunTime);
-    uint64_t Count = (Length - sizeof(RunTime) - sizeof(Count)) / sizeof(uint32_t);
+    uint64_t Count = (Length - sizeof(RunTime) - sizeof(Count)) / GetLatencySampleLength();
     CxPlatCopyMemory(Data, &Count, sizeof(Count));
     Data += sizeof(CurLatencyIndex);
     CxPlatCopyMemory(Data, LatencyValues.get(), (size_t)(Count * sizeof(uint32_t)));
+    if (LatencySizeBuckets) {
+        //
+        // Each latency's response size bucket follows all the latencies.
+        //
+        Data += Count * sizeof(uint32_t);
+        CxPlatCopyMemory(Data, LatencySizeBuckets.get(), (size_t)Count);
+    }
 }
 
 void
@@ -458,7 +625,13 @@ PerfClientWorker::WorkerThread() {
         while (Client->Running && ConnectionsCreated < ConnectionsQueued) {
             StartNewConnection();
         }
-        WakeEvent.WaitForever();
+        const uint32_t TimeoutMs =
+            CXPLAT_MIN(StartThinkingStreams(), StartScheduledStreams());
+        if (TimeoutMs == UINT32_MAX) {
+            WakeEvent.WaitForever();
+        } else {
+            WakeEvent.WaitTimeout(TimeoutMs);
+        }
     }
 }
 
@@ -469,6 +642,134 @@ PerfClientWorker::StartNewConnection() {
     ConnectionPool.Alloc(*Client, *this)->Initialize();
 }
 
+void
+PerfClientWorker::QueueThinkingStream(
+    _In_ PerfClientConnection* Connection,
+    _In_ uint64_t ThinkTime
+    ) {
+    auto Think = ThinkPool.Alloc();
+    if (!Think) {
+        return;
+    }
+    Think->Connection = Connection;
+    Think->StartTime = CxPlatTimeUs64() + ThinkTime;
+    Lock.Acquire();
+    CXPLAT_LIST_ENTRY* Prev = ThinkList.Blink;
+    while (Prev != &ThinkList &&
+           CXPLAT_CONTAINING_RECORD(Prev, PerfClientThink, Link)->StartTime > Think->StartTime) {
+        Prev = Prev->Blink;
+    }
+    const bool IsFirst = Prev == &ThinkList;
+    CxPlatListInsertHead(Prev, &Think->Link);
+    Lock.Release();
+    if (IsFirst) {
+        WakeEvent.Set(); // The thread may be waiting on a later one
+    }
+}
+
+void
+PerfClientWorker::CancelThinkingStreams(
+    _In_ PerfClientConnection* Connection
+    ) {
+    Lock.Acquire();
+    CXPLAT_LIST_ENTRY* Entry = ThinkList.Flink;
+    while (Entry != &ThinkList) {
+        auto Think = CXPLAT_CONTAINING_RECORD(Entry, PerfClientThink, Link);
+        Entry = Entry->Flink;
+        if (Think->Connection == Connection) {
+            CxPlatListEntryRemove(&Think->Link);
+            ThinkPool.Free(Think);
+        }
+    }
+    Lock.Release();
+}
+
+uint32_t
+PerfClientWorker::StartThinkingStreams() {
+    uint32_t TimeoutMs = UINT32_MAX;
+    Lock.Acquire();
+    while (Client->Running && !CxPlatListIsEmpty(&ThinkList)) {
+        auto Think = CXPLAT_CONTAINING_RECORD(ThinkList.Flink, PerfClientThink, Link);
+        const uint64_t Now = CxPlatTimeUs64();
+        if (Think->StartTime > Now) {
+            TimeoutMs = (uint32_t)CXPLAT_MIN(US_TO_MS(Think->StartTime - Now) + 1, UINT32_MAX - 1);
+            break;
+        }
+        CxPlatListEntryRemove(&Think->Link);
+        //
+        // Holding the lock keeps the connection from being freed while the
+        // stream is started. Its first send happens on the connection's own
+        // thread, once the start completes.
+        //
+        Think->Connection->StartStream(true);
+        ThinkPool.Free(Think);
+    }
+    Lock.Release();
+    return TimeoutMs;
+}
+
+void
+PerfClientWorker::AddReadyConnection(
+    _In_ PerfClientConnection* Connection
+    ) {
+    Lock.Acquire();
+    if (ScheduleStartTime == 0) {
+        ScheduleStartTime = CxPlatTimeUs64(); // Starts with the first connection
+    }
+    Connection->IsReady = true;
+    Connection->ReadyEntry.Connection = Connection;
+    CxPlatListInsertTail(&ReadyConnections, &Connection->ReadyEntry.Link);
+    Lock.Release();
+    WakeEvent.Set();
+}
+
+void
+PerfClientWorker::RemoveReadyConnection(
+    _In_ PerfClientConnection* Connection
+    ) {
+    Lock.Acquire();
+    if (Connection->IsReady) {
+        CxPlatListEntryRemove(&Connection->ReadyEntry.Link);
+        Connection->IsReady = false;
+    }
+    Lock.Release();
+}
+
+uint32_t
+PerfClientWorker::StartScheduledStreams() {
+    uint32_t TimeoutMs = UINT32_MAX;
+    if (RequestRate == 0) {
+        return TimeoutMs;
+    }
+    Lock.Acquire();
+    while (Client->Running && !CxPlatListIsEmpty(&ReadyConnections)) {
+        //
+        // Requests are due on a fixed timeline, whether or not earlier ones
+        // have completed, and their latency is measured from when they were
+        // due. Late requests are all started at once, to catch up.
+        //
+        const uint64_t DueTime =
+            ScheduleStartTime + (RequestsScheduled * 1000 * 1000) / RequestRate;
+        const uint64_t Now = CxPlatTimeUs64();
+        if (DueTime > Now) {
+            // Spins if less than a millisecond away, to keep to the timeline.
+            TimeoutMs = (uint32_t)CXPLAT_MIN(US_TO_MS(DueTime - Now), UINT32_MAX - 1);
+            break;
+        }
+        CXPLAT_LIST_ENTRY* Entry = CxPlatListRemoveHead(&ReadyConnections);
+        CxPlatListInsertTail(&ReadyConnections, Entry); // Round robin
+        auto Ready = CXPLAT_CONTAINING_RECORD(Entry, PerfClientReadyEntry, Link);
+        if (Client->DatagramSize) {
+            Ready->Connection->SendDatagram(DueTime);
+        } else {
+            Ready->Connection->StartStream(true, DueTime);
+        }
+        RequestsScheduled++;
+    }
+    Lock.Release();
+    return TimeoutMs;
+}
+
 void
 PerfClientWorker::OnConnectionComplete() {
     InterlockedIncrement64((int64_t*)&ConnectionsCompleted);
@@ -639,7 +940,21 @@ PerfClientConnection::Initialize() {
 void
 PerfClientConnection::OnHandshakeComplete() {
     InterlockedIncrement64((int64_t*)&Worker.ConnectionsConnected);
-    if (!Client.StreamCount) {
+    if (Client.DatagramSize) {
+        if (DatagramMaxLength < Client.DatagramSize) {
+            WriteOutput(
+                "Datagrams of %hu bytes don't fit (the max is %hu)!\n",
+                Client.DatagramSize,
+                DatagramMaxLength);
+            Shutdown();
+        } else if (Client.RequestRate) {
+            Worker.AddReadyConnection(this);
+        } else {
+            while (DatagramsQueued < Client.DatagramWindow && SendDatagram()) { }
+        }
+    } else if (Client.RequestRate) {
+        Worker.AddReadyConnection(this);
+    } else if (!Client.StreamCount) {
         WorkerConnComplete = true;
         Worker.OnConnectionComplete();
         Shutdown();
@@ -667,6 +982,14 @@ PerfClientConnection::OnShutdownComplete() {
         StreamTable.EnumEnd(&Enum);
     }
 
+    if (Client.ThinkTimes.IsEnabled()) {
+        Worker.CancelThinkingStreams(this);
+    }
+
+    if (Client.RequestRate) {
+        Worker.RemoveReadyConnection(this);
+    }
+
     if (!WorkerConnComplete) {
         Worker.OnConnectionComplete();
     }
@@ -677,7 +1000,15 @@ void
 PerfClientConnection::StartNewStream() {
     StreamsCreated++;
     StreamsActive++;
+    StartStream();
+}
+
+void
+PerfClientConnection::StartStream(bool Deferred, uint64_t StartTime) {
     auto Stream = Worker.StreamPool.Alloc(*this);
+    if (StartTime) {
+        Stream->StartTime = StartTime;
+    }
     if (Client.UseTCP) {
         Stream->Entry.Signature = (uint32_t)Worker.StreamsStarted;
         StreamTable.Insert(&Stream->Entry);
@@ -692,17 +1023,51 @@ PerfClientConnection::StartNewStream() {
             Worker.StreamPool.Free(Stream);
             return;
         }
+        if (Client.UsePriority) {
+            //
+            // Like HTTP/3 urgency, smaller responses are more urgent.
+            //
+            uint16_t Priority =
+                (uint16_t)(0x7FFF + PERF_SIZE_BUCKET_COUNT / 2 - PerfSizeBucket(Stream->ResponseSize));
+            MsQuic->SetParam(
+                Stream->Handle,
+                QUIC_PARAM_STREAM_PRIORITY,
+                sizeof(Priority),
+                &Priority);
+        }
     }
 
     InterlockedIncrement64((int64_t*)&Worker.StreamsStarted);
-    Stream->Send();
+    if (Deferred) {
+        Stream->StartDeferred = true;
+        if (QUIC_FAILED(MsQuic->StreamStart(Stream->Handle, QUIC_STREAM_START_FLAG_NONE))) {
+            Worker.StreamPool.Free(Stream);
+        }
+    } else {
+        Stream->Send();
+    }
 }
 
 PerfClientStream::PerfClientStream(_In_ PerfClientConnection& Connection)
     : Connection{Connection} {
-    if (Connection.Client.UseSendBuffering) {
+    auto& Client = Connection.Client;
+    if (Client.UseSendBuffering) {
         IdealSendBuffer = 1; // Hack to only keep 1 outstanding send at a time
     }
+    RequestSize = Client.Upload;
+    ResponseSize = Client.Download;
+    if (Client.RequestSizes.IsEnabled()) {
+        RequestSize = CXPLAT_MAX(Client.RequestSizes.Sample(), sizeof(uint64_t));
+    }
+    if (Client.ResponseSizes.IsEnabled()) {
+        //
+        // The request starts with the response size the server should send.
+        //
+        ResponseSize = Client.ResponseSizes.Sample();
+        RequestHeader = CxPlatByteSwapUint64(ResponseSize);
+        HeaderBuffer.Buffer = (uint8_t*)&RequestHeader;
+        HeaderBuffer.Length = sizeof(RequestHeader);
+    }
 }
 
 PerfClientStream*
@@ -712,11 +1077,19 @@ PerfClientConnection::GetTcpStream(uint32_t ID) {
 
 void
 PerfClientConnection::OnStreamShutdown() {
+    if (Client.RequestRate) {
+        return; // Streams are started by the worker, on a schedule
+    }
     StreamsActive--;
     if (!Client.Running) {
         if (!StreamsActive) {
             Shutdown();
         }
+    } else if (Client.ThinkTimes.IsEnabled()) {
+        while (StreamsActive < Client.StreamCount) {
+            StreamsActive++; // Still counted while thinking
+            Worker.QueueThinkingStream(this, Client.ThinkTimes.Sample());
+        }
     } else if (Client.RepeatStreams) {
         while (StreamsActive < Client.StreamCount) {
             StartNewStream();
@@ -728,6 +1101,114 @@ PerfClientConnection::OnStreamShutdown() {
     }
 }
 
+bool
+PerfClientConnection::SendDatagram(uint64_t DueTime) {
+    auto Datagram = Worker.DatagramPool.Alloc();
+    if (!Datagram) {
+        return false;
+    }
+    uint64_t Sequence = DatagramSequence++;
+    if (Client.RequestRate) {
+        Sequence |= PERF_DATAGRAM_ECHO_FLAG; // Open loop datagrams measure latency
+    }
+    Datagram->Header.Sequence = CxPlatByteSwapUint64(Sequence);
+    Datagram->Header.SendTime = CxPlatByteSwapUint64(DueTime ? DueTime : CxPlatTimeUs64());
+    Datagram->Buffers[0].Buffer = (uint8_t*)&Datagram->Header;
+    Datagram->Buffers[0].Length = sizeof(Datagram->Header);
+    Datagram->Buffers[1].Buffer = Client.RequestBuffer.Buffer->Buffer;
+    Datagram->Buffers[1].Length = Client.DatagramSize - sizeof(Datagram->Header);
+    Datagram->Sent = false;
+
+    //
+    // The window is only used without a rate, where datagrams are all sent
+    // on the connection's thread.
+    //
+    if (!Client.RequestRate) {
+        DatagramsQueued++;
+    }
+    if (QUIC_FAILED(
+        MsQuic->DatagramSend(
+            Handle,
+            Datagram->Buffers,
+            ARRAYSIZE(Datagram->Buffers),
+            QUIC_SEND_FLAG_NONE,
+            Datagram))) {
+        if (!Client.RequestRate) {
+            DatagramsQueued--;
+        }
+        Worker.DatagramPool.Free(Datagram);
+        return false;
+    }
+    InterlockedIncrement64((int64_t*)&Worker.DatagramsSent);
+    return true;
+}
+
+void
+PerfClientConnection::OnDatagramSendStateChanged(
+    _In_ PerfClientDatagram* Datagram,
+    _In_ QUIC_DATAGRAM_SEND_STATE State
+    ) {
+    InterlockedIncrement64((int64_t*)&Worker.DatagramStateChanges);
+    if (!Datagram->Sent &&
+        (State == QUIC_DATAGRAM_SEND_SENT || QUIC_DATAGRAM_SEND_STATE_IS_FINAL(State))) {
+        Datagram->Sent = true;
+        if (!Client.RequestRate) {
+            DatagramsQueued--;
+            while (Client.Running && DatagramsQueued < Client.DatagramWindow && SendDatagram()) { }
+        }
+    }
+
+    if (!QUIC_DATAGRAM_SEND_STATE_IS_FINAL(State)) {
+        return;
+    }
+    if (Client.Running) {
+        switch (State) {
+        case QUIC_DATAGRAM_SEND_ACKNOWLEDGED:
+        case QUIC_DATAGRAM_SEND_ACKNOWLEDGED_SPURIOUS:
+            InterlockedIncrement64((int64_t*)&Worker.DatagramsAcked);
+            InterlockedExchangeAdd64((int64_t*)&Worker.DatagramBytesAcked, Client.DatagramSize);
+            break;
+        case QUIC_DATAGRAM_SEND_LOST_DISCARDED:
+            InterlockedIncrement64((int64_t*)&Worker.DatagramsLost);
+            break;
+        default:
+            InterlockedIncrement64((int64_t*)&Worker.DatagramsCanceled);
+            break;
+        }
+    }
+    Worker.DatagramPool.Free(Datagram);
+}
+
+void
+PerfClientConnection::OnDatagramReceived(
+    _In_ const QUIC_BUFFER* Buffer
+    ) {
+    if (Buffer->Length < sizeof(PERF_DATAGRAM_ECHO)) {
+        return;
+    }
+    const uint64_t Now = CxPlatTimeUs64();
+    PERF_DATAGRAM_ECHO Echo;
+    CxPlatCopyMemory(&Echo, Buffer->Buffer, sizeof(Echo));
+    InterlockedIncrement64((int64_t*)&Worker.DatagramsEchoed);
+    if (!Client.Running) {
+        return;
+    }
+
+    const auto Index = (uint64_t)InterlockedIncrement64((int64_t*)&Client.CurLatencyIndex) - 1;
+    if (Index < Client.MaxLatencyIndex) {
+        //
+        // One way latency compares the two clocks, so is only meaningful
+        // when both sides are on the same machine.
+        //
+        const uint64_t SendTime = CxPlatByteSwapUint64(Echo.Header.SendTime);
+        const uint64_t ReceiveTime =
+            Client.DatagramOneWay ? CxPlatByteSwapUint64(Echo.ReceiveTime) : Now;
+        const uint64_t Latency = ReceiveTime > SendTime ? ReceiveTime - SendTime : 0;
+        Client.LatencyValues[(size_t)Index] = Latency > UINT32_MAX ? UINT32_MAX : (uint32_t)Latency;
+        InterlockedIncrement64((int64_t*)&Client.LatencyCount);
+    }
+}
+
 void
 PerfClientConnection::Shutdown() {
     if (Client.UseTCP) {
@@ -756,6 +1237,19 @@ PerfClientConnection::ConnectionCallback(
         }
         OnShutdownComplete();
         break;
+    case QUIC_CONNECTION_EVENT_DATAGRAM_STATE_CHANGED:
+        DatagramMaxLength =
+            Event->DATAGRAM_STATE_CHANGED.SendEnabled ?
+                Event->DATAGRAM_STATE_CHANGED.MaxSendLength : 0;
+        break;
+    case QUIC_CONNECTION_EVENT_DATAGRAM_SEND_STATE_CHANGED:
+        OnDatagramSendStateChanged(
+            (PerfClientDatagram*)Event->DATAGRAM_SEND_STATE_CHANGED.ClientContext,
+            Event->DATAGRAM_SEND_STATE_CHANGED.State);
+        break;
+    case QUIC_CONNECTION_EVENT_DATAGRAM_RECEIVED:
+        OnDatagramReceived(Event->DATAGRAM_RECEIVED.Buffer);
+        break;
     default:
         break;
     }
@@ -821,6 +1315,11 @@ PerfClientStream::QuicStreamCallback(
     _Inout_ QUIC_STREAM_EVENT* Event
     ) {
     switch (Event->Type) {
+    case QUIC_STREAM_EVENT_START_COMPLETE:
+        if (StartDeferred && QUIC_SUCCEEDED(Event->START_COMPLETE.Status)) {
+            Send();
+        }
+        break;
     case QUIC_STREAM_EVENT_RECEIVE:
         OnReceive(Event->RECEIVE.TotalBufferLength, Event->RECEIVE.Flags & QUIC_RECEIVE_FLAG_FIN);
         break;
@@ -844,7 +1343,7 @@ PerfClientStream::QuicStreamCallback(
         OnReceiveShutdown();
         break;
     case QUIC_STREAM_EVENT_IDEAL_SEND_BUFFER_SIZE:
-        if (Connection.Client.Upload && !Connection.Client.UseSendBuffering &&
+        if (RequestSize && !Connection.Client.UseSendBuffering &&
             IdealSendBuffer != Event->IDEAL_SEND_BUFFER_SIZE.ByteCount) {
             IdealSendBuffer = Event->IDEAL_SEND_BUFFER_SIZE.ByteCount;
             Send();
@@ -863,11 +1362,16 @@ PerfClientStream::Send() {
         const uint64_t BytesLeftToSend =
             Client.Timed ?
                 UINT64_MAX : // Timed sends forever
-                (Client.Upload ? (Client.Upload - BytesSent) : sizeof(uint64_t));
+                (RequestSize ? (RequestSize - BytesSent) : sizeof(uint64_t));
         uint32_t DataLength = Client.IoSize;
         QUIC_BUFFER* Buffer = Client.RequestBuffer;
         QUIC_SEND_FLAGS Flags = QUIC_SEND_FLAG_START;
 
+        if (BytesSent == 0 && Client.ResponseSizes.IsEnabled()) {
+            DataLength = sizeof(RequestHeader);
+            Buffer = &HeaderBuffer;
+        }
+
         if ((uint64_t)DataLength >= BytesLeftToSend) {
             DataLength = (uint32_t)BytesLeftToSend;
             LastBuffer.Buffer = Buffer->Buffer;
@@ -974,9 +1478,9 @@ void
 PerfClientStream::OnShutdown() {
     auto& Client = Connection.Client;
     auto SendSuccess = SendEndTime != 0;
-    if (Client.Upload) {
+    if (RequestSize) {
         const auto TotalBytes = BytesAcked;
-        if (TotalBytes < sizeof(uint64_t) || (!Client.Timed && TotalBytes < Client.Upload)) {
+        if (TotalBytes < sizeof(uint64_t) || (!Client.Timed && TotalBytes < RequestSize)) {
             SendSuccess = false;
         }
 
@@ -998,9 +1502,9 @@ PerfClientStream::OnShutdown() {
     }
 
     auto RecvSuccess = RecvStartTime != 0 && RecvEndTime != 0;
-    if (Client.Download) {
+    if (ResponseSize) {
         const auto TotalBytes = BytesReceived;
-        if (TotalBytes == 0 || (!Client.Timed && TotalBytes < Client.Download)) {
+        if (TotalBytes == 0 || (!Client.Timed && TotalBytes < ResponseSize)) {
             RecvSuccess = false;
         }
 
@@ -1028,6 +1532,9 @@ PerfClientStream::OnShutdown() {
             if (Index < Client.MaxLatencyIndex) {
                 const auto Latency = CxPlatTimeDiff64(StartTime, RecvEndTime);
                 Client.LatencyValues[(size_t)Index] = Latency > UINT32_MAX ? UINT32_MAX : (uint32_t)Latency;
+                if (Client.LatencySizeBuckets) {
+                    Client.LatencySizeBuckets[(size_t)Index] = PerfSizeBucket(ResponseSize);
+                }
                 InterlockedIncrement64((int64_t*)&Connection.Client.LatencyCount);
             }
         }
@@ -13,6 +13,25 @@ Abstract:
 
 #include "SecNetPerf.h"
 #include "Tcp.h"
+#include "PerfDistribution.h"
+
+//
+// Links a connected connection into its worker's ReadyConnections, for open
+// loop scheduling.
+//
+struct PerfClientReadyEntry {
+    CXPLAT_LIST_ENTRY Link;
+    struct PerfClientConnection* Connection;
+};
+
+//
+// A datagram queued to send, until its send state is final.
+//
+struct PerfClientDatagram {
+    PERF_DATAGRAM_HEADER Header;
+    QUIC_BUFFER Buffers[2]; // {Header, Payload}
+    bool Sent {false};
+};
 
 struct PerfClientConnection {
     struct PerfClient& Client;
@@ -25,14 +44,23 @@ struct PerfClientConnection {
     uint64_t StreamsCreated {0};
     uint64_t StreamsActive {0};
     bool WorkerConnComplete {false}; // Indicated completion to worker
+    bool IsReady {false}; // In the worker's ReadyConnections
+    PerfClientReadyEntry ReadyEntry;
+    uint16_t DatagramMaxLength {0}; // 0 if the peer doesn't accept datagrams
+    uint32_t DatagramsQueued {0}; // Not yet sent, for the max throughput window
+    uint64_t DatagramSequence {0};
     PerfClientConnection(_In_ PerfClient& Client, _In_ PerfClientWorker& Worker) : Client(Client), Worker(Worker) { }
     ~PerfClientConnection();
     void Initialize();
     void StartNewStream();
+    void StartStream(bool Deferred = false, uint64_t StartTime = 0);
     void OnHandshakeComplete();
     void OnShutdownComplete();
     void OnStreamShutdown();
     void Shutdown();
+    bool SendDatagram(uint64_t DueTime = 0);
+    void OnDatagramSendStateChanged(_In_ PerfClientDatagram* Datagram, _In_ QUIC_DATAGRAM_SEND_STATE State);
+    void OnDatagramReceived(_In_ const QUIC_BUFFER* Buffer);
     QUIC_STATUS ConnectionCallback(_Inout_ QUIC_CONNECTION_EVENT* Event);
     static QUIC_STATUS QUIC_API s_ConnectionCallback(HQUIC, void* Context, _Inout_ QUIC_CONNECTION_EVENT* Event) {
         return ((PerfClientConnection*)Context)->ConnectionCallback(Event);
@@ -70,7 +98,12 @@ struct PerfClientStream {
     uint64_t BytesOutstanding {0};
     uint64_t BytesAcked {0};
     uint64_t BytesReceived {0};
+    uint64_t RequestSize;
+    uint64_t ResponseSize;
+    uint64_t RequestHeader; // Response size, when drawn per stream
     bool SendComplete {false};
+    bool StartDeferred {false}; // Started off the connection's thread
+    QUIC_BUFFER HeaderBuffer;
     QUIC_BUFFER LastBuffer;
     QUIC_STATUS QuicStreamCallback(_Inout_ QUIC_STREAM_EVENT* Event);
     void Send();
@@ -81,6 +114,15 @@ struct PerfClientStream {
     void OnShutdown();
 };
 
+//
+// A stream waiting out its think time before being started.
+//
+struct PerfClientThink {
+    CXPLAT_LIST_ENTRY Link;
+    PerfClientConnection* Connection;
+    uint64_t StartTime;
+};
+
 struct QUIC_CACHEALIGN PerfClientWorker {
     PerfClient* Client {nullptr};
     CxPlatLock Lock;
@@ -97,6 +139,14 @@ struct QUIC_CACHEALIGN PerfClientWorker {
     uint64_t StreamsCompleted {0};
     uint64_t UploadRate {0};
     uint64_t DownloadRate {0};
+    // Datagram mode
+    uint64_t DatagramsSent {0};
+    uint64_t DatagramsAcked {0};
+    uint64_t DatagramsLost {0};
+    uint64_t DatagramsCanceled {0};
+    uint64_t DatagramsEchoed {0};
+    uint64_t DatagramBytesAcked {0};
+    uint64_t DatagramStateChanges {0};
     UniquePtr<char[]> Target;
     QuicAddr LocalAddr;
     QuicAddr RemoteAddr;
@@ -104,7 +154,18 @@ struct QUIC_CACHEALIGN PerfClientWorker {
     CxPlatPoolT<PerfClientStream> StreamPool;
     CxPlatPoolT<TcpConnection> TcpConnectionPool;
     CxPlatPoolT<TcpSendData> TcpSendDataPool;
-    PerfClientWorker() { }
+    CxPlatPoolT<PerfClientThink> ThinkPool;
+    CxPlatPoolT<PerfClientDatagram> DatagramPool;
+    CXPLAT_LIST_ENTRY ThinkList; // Sorted by StartTime, protected by Lock
+    // Open loop scheduling, protected by Lock
+    uint64_t RequestRate {0};
+    uint64_t RequestsScheduled {0};
+    uint64_t ScheduleStartTime {0};
+    CXPLAT_LIST_ENTRY ReadyConnections;
+    PerfClientWorker() {
+        CxPlatListInitializeHead(&ThinkList);
+        CxPlatListInitializeHead(&ReadyConnections);
+    }
     ~PerfClientWorker() { WaitForThread(); }
     void Uninitialize() { WaitForThread(); }
     void QueueNewConnection() {
@@ -112,6 +173,10 @@ struct QUIC_CACHEALIGN PerfClientWorker {
         WakeEvent.Set();
     }
     void OnConnectionComplete();
+    void QueueThinkingStream(_In_ PerfClientConnection* Connection, _In_ uint64_t ThinkTime);
+    void CancelThinkingStreams(_In_ PerfClientConnection* Connection);
+    void AddReadyConnection(_In_ PerfClientConnection* Connection);
+    void RemoveReadyConnection(_In_ PerfClientConnection* Connection);
     static CXPLAT_THREAD_CALLBACK(s_WorkerThread, Context) {
         ((PerfClientWorker*)Context)->WorkerThread();
         CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
@@ -126,6 +191,8 @@ private:
         }
     }
     void StartNewConnection();
+    uint32_t StartThinkingStreams();
+    uint32_t StartScheduledStreams();
     void WorkerThread();
 };
 
@@ -144,6 +211,9 @@ struct PerfClient {
     QUIC_STATUS Wait(_In_ int Timeout);
     uint32_t GetExtraDataLength();
     void GetExtraData(_Out_writes_bytes_(Length) uint8_t* Data, _In_ uint32_t Length);
+    uint32_t GetLatencySampleLength() const {
+        return sizeof(uint32_t) + (LatencySizeBuckets ? sizeof(uint8_t) : 0);
+    }
 
     bool Running {true};
     CXPLAT_EVENT* CompletionEvent {nullptr};
@@ -151,6 +221,7 @@ struct PerfClient {
     uint64_t CurLatencyIndex {0};
     uint64_t LatencyCount {0};
     UniquePtr<uint32_t[]> LatencyValues {nullptr}; // TODO - Move to Worker
+    UniquePtr<uint8_t[]> LatencySizeBuckets {nullptr}; // Only with ResponseSizes
     PerfClientWorker Workers[PERF_MAX_THREAD_COUNT];
 
     UniquePtr<TcpEngine> Engine;
@@ -209,6 +280,14 @@ struct PerfClient {
     uint8_t RepeatConnections {FALSE};
     uint8_t RepeatStreams {FALSE};
     uint64_t RunTime {0};
+    PerfDistribution RequestSizes;
+    PerfDistribution ResponseSizes;
+    PerfDistribution ThinkTimes;
+    uint8_t UsePriority {FALSE};
+    uint64_t RequestRate {0}; // Open loop, in requests per second
+    uint16_t DatagramSize {0}; // Sends datagrams of this size, instead of using streams
+    uint32_t DatagramWindow {PERF_DEFAULT_DATAGRAM_WINDOW};
+    uint8_t DatagramOneWay {FALSE}; // Latency from the server's receive time
 
     struct PerfIoBuffer {
         QUIC_BUFFER* Buffer {nullptr};
@@ -261,6 +340,9 @@ struct PerfClient {
         return StreamsCompleted;
     }
     uint64_t GetUploadRate() const {
+        if (DatagramSize) {
+            return GetDatagramTotal(&PerfClientWorker::DatagramBytesAcked) * 8 * 1000 / RunTime;
+        }
         uint64_t UploadRate = 0;
         for (uint32_t i = 0; i < WorkerCount; ++i) {
             UploadRate += Workers[i].UploadRate;
@@ -274,6 +356,16 @@ struct PerfClient {
         }
         return DownloadRate;
     }
+    uint64_t GetDatagramTotal(uint64_t PerfClientWorker::* Counter) const {
+        uint64_t Total = 0;
+        for (uint32_t i = 0; i < WorkerCount; ++i) {
+            Total += Workers[i].*Counter;
+        }
+        return Total;
+    }
+    uint64_t GetDatagramsSent() const {
+        return DatagramSize ? GetDatagramTotal(&PerfClientWorker::DatagramsSent) : 0;
+    }
 
     void OnConnectionsComplete() { // Called when a worker has completed its set of connections
         if (GetConnectionsCompleted() == ConnectionCount) {
@@ -0,0 +1,183 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Samples the CPU cost of a run, to report it per byte, per request and per
+    handshake, along with how busy each MsQuic worker was.
+
+    Process cycles come from QueryProcessCycleTime on Windows. Elsewhere, on
+    x86, they are the process CPU time (from getrusage) converted at the TSC
+    rate measured over the run; both count reference cycles, not core clock
+    cycles. On other platforms, only CPU time is reported.
+
+--*/
+
+#pragma once
+
+#ifndef _KERNEL_MODE
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PERF_CPU_HAS_TSC 1
+#endif
+#endif
+
+class PerfCpuMonitor {
+
+    struct Snapshot {
+        uint64_t TimeUs {0};
+        uint64_t CpuUs {0};
+        uint64_t Cycles {0};    // 0 if not known.
+        int64_t Counters[QUIC_PERF_COUNTER_MAX] {0};
+        UniquePtr<int64_t[]> Partitions;
+        uint32_t PartitionCount {0};
+    };
+
+    Snapshot Begin;
+    Snapshot End;
+
+    static void Sample(_Out_ Snapshot& Snap) {
+        Snap.TimeUs = CxPlatTimeUs64();
+#ifdef _WIN32
+        FILETIME Creation, Exit, Kernel, User;
+        if (GetProcessTimes(GetCurrentProcess(), &Creation, &Exit, &Kernel, &User)) {
+            Snap.CpuUs =
+                ((((uint64_t)Kernel.dwHighDateTime << 32) | Kernel.dwLowDateTime) +
+                 (((uint64_t)User.dwHighDateTime << 32) | User.dwLowDateTime)) / 10;
+        }
+        ULONG64 Cycles;
+        if (QueryProcessCycleTime(GetCurrentProcess(), &Cycles)) {
+            Snap.Cycles = Cycles;
+        }
+#else
+        struct rusage Usage;
+        if (getrusage(RUSAGE_SELF, &Usage) == 0) {
+            Snap.CpuUs =
+                (uint64_t)Usage.ru_utime.tv_sec * 1000000 + (uint64_t)Usage.ru_utime.tv_usec +
+                (uint64_t)Usage.ru_stime.tv_sec * 1000000 + (uint64_t)Usage.ru_stime.tv_usec;
+        }
+#ifdef PERF_CPU_HAS_TSC
+        Snap.Cycles = __rdtsc(); // Only the TSC, until converted in Stop.
+#endif
+#endif
+
+        uint32_t BufferLength = sizeof(Snap.Counters);
+        (void)MsQuic->GetParam(
+            nullptr, QUIC_PARAM_GLOBAL_PERF_COUNTERS, &BufferLength, Snap.Counters);
+
+        BufferLength = 0;
+        Snap.PartitionCount = 0;
+        if (MsQuic->GetParam(
+                nullptr, QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS,
+                &BufferLength, nullptr) == QUIC_STATUS_BUFFER_TOO_SMALL) {
+            const uint32_t Count = BufferLength / (sizeof(int64_t) * QUIC_PERF_COUNTER_MAX);
+            Snap.Partitions.reset(new(std::nothrow) int64_t[Count * QUIC_PERF_COUNTER_MAX]);
+            if (Snap.Partitions != nullptr &&
+                QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    nullptr, QUIC_PARAM_GLOBAL_PARTITION_PERF_COUNTERS,
+                    &BufferLength, Snap.Partitions.get()))) {
+                Snap.PartitionCount = Count;
+            }
+        }
+    }
+
+    int64_t CounterDelta(QUIC_PERFORMANCE_COUNTERS Counter) const {
+        return End.Counters[Counter] - Begin.Counters[Counter];
+    }
+
+    void PrintCost(const char* Name, uint64_t Cycles, uint64_t Count) const {
+        if (Count == 0) {
+            return;
+        }
+        if (Cycles != 0) {
+            WriteOutput(
+                "Result: CPU %llu cycles/%s (%llu %ss).\n",
+                (unsigned long long)(Cycles / Count),
+                Name,
+                (unsigned long long)Count,
+                Name);
+        } else {
+            WriteOutput(
+                "Result: CPU %llu ns/%s (%llu %ss).\n",
+                (unsigned long long)((End.CpuUs - Begin.CpuUs) * 1000 / Count),
+                Name,
+                (unsigned long long)Count,
+                Name);
+        }
+    }
+
+public:
+
+    void Start() { Sample(Begin); }
+
+    void Stop() {
+        Sample(End);
+#if !defined(_WIN32) && defined(PERF_CPU_HAS_TSC)
+        //
+        // Convert CPU time to cycles at the TSC rate measured over the run.
+        //
+        const uint64_t ElapsedUs = End.TimeUs - Begin.TimeUs;
+        if (ElapsedUs != 0) {
+            const double TscPerUs = (double)(End.Cycles - Begin.Cycles) / ElapsedUs;
+            Begin.Cycles = 0;
+            End.Cycles = (uint64_t)((End.CpuUs - Begin.CpuUs) * TscPerUs);
+        } else {
+            Begin.Cycles = End.Cycles = 0;
+        }
+#endif
+    }
+
+    //
+    // Requests (and datagrams) are the number completed by the app, since
+    // MsQuic doesn't count them. Bytes and handshakes come from MsQuic's
+    // counters, so aren't known for TCP.
+    //
+    void Print(uint64_t Requests, uint64_t Datagrams) const {
+        const uint64_t ElapsedUs = End.TimeUs - Begin.TimeUs;
+        if (ElapsedUs == 0) {
+            return;
+        }
+        const uint64_t CpuUs = End.CpuUs - Begin.CpuUs;
+        const uint64_t Cycles = End.Cycles - Begin.Cycles;
+        const uint32_t ProcCount = CxPlatProcCount();
+        WriteOutput(
+            "Result: CPU %llu.%02llu cores busy (%llu%% of %u), %llu ms.\n",
+            (unsigned long long)(CpuUs / ElapsedUs),
+            (unsigned long long)(CpuUs * 100 / ElapsedUs % 100),
+            (unsigned long long)(CpuUs * 100 / ElapsedUs / ProcCount),
+            ProcCount,
+            (unsigned long long)(CpuUs / 1000));
+
+        const int64_t Bytes =
+            CounterDelta(QUIC_PERF_COUNTER_APP_SEND_BYTES) +
+            CounterDelta(QUIC_PERF_COUNTER_APP_RECV_BYTES);
+        const int64_t Handshakes =
+            CounterDelta(QUIC_PERF_COUNTER_CONN_CREATED) -
+            CounterDelta(QUIC_PERF_COUNTER_CONN_HANDSHAKE_FAIL);
+        PrintCost("byte", Cycles, Bytes > 0 ? (uint64_t)Bytes : 0);
+        PrintCost("request", Cycles, Requests);
+        PrintCost("datagram", Cycles, Datagrams);
+        PrintCost("handshake", Cycles, Handshakes > 0 ? (uint64_t)Handshakes : 0);
+
+        if (Begin.PartitionCount == End.PartitionCount) {
+            for (uint32_t i = 0; i < End.PartitionCount; ++i) {
+                const uint32_t Index = i * QUIC_PERF_COUNTER_MAX + QUIC_PERF_COUNTER_WORK_BUSY_TIME;
+                const int64_t BusyUs = End.Partitions[Index] - Begin.Partitions[Index];
+                if (BusyUs > 0) {
+                    WriteOutput(
+                        "  Worker %u: %llu%% busy\n",
+                        i,
+                        (unsigned long long)((uint64_t)BusyUs * 100 / ElapsedUs));
+                }
+            }
+        }
+    }
+};
+
+#endif // _KERNEL_MODE
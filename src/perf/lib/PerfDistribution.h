@@ -0,0 +1,191 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Random distributions that request sizes, response sizes and think times
+    can be drawn from, to shape load more like real HTTP/3 traffic than fixed
+    values do.
+
+    A distribution is configured from a string of the form:
+
+        <value>                             - Always the same value.
+        lognormal:<median>:<sigma>[:<max>]  - Lognormal around a median.
+        pareto:<min>:<alpha>[:<max>]        - Pareto, with a heavy tail.
+        file:<path>                         - Uniformly drawn from the values
+                                              in a file, one per line.
+
+--*/
+
+#pragma once
+
+//
+// Forward declaration because of include issues with math.h
+//
+extern "C" {
+    double sqrt(double value);
+    double log(double value);
+    double exp(double value);
+}
+
+struct PerfDistribution {
+
+    enum Type : uint8_t {
+        None,
+        Fixed,
+        Lognormal,
+        Pareto,
+        Empirical
+    };
+
+    Type DistType {None};
+    double Scale {0};   // Fixed value, lognormal median or pareto minimum.
+    double Shape {0};   // Lognormal sigma or pareto alpha.
+    uint64_t Max {UINT64_MAX};
+    UniquePtr<uint64_t[]> Samples;
+    uint32_t SampleCount {0};
+
+    bool IsEnabled() const { return DistType != None; }
+
+    //
+    // Parses the configuration string. Returns false if it's invalid.
+    //
+    bool Initialize(_In_z_ const char* Config) {
+        DistType = None;
+        Max = UINT64_MAX;
+        SampleCount = 0;
+        if (!strncmp(Config, "file:", 5)) {
+            return LoadFile(Config + 5);
+        }
+        if (!strncmp(Config, "lognormal:", 10)) {
+            DistType = Lognormal;
+            Config += 10;
+        } else if (!strncmp(Config, "pareto:", 7)) {
+            DistType = Pareto;
+            Config += 7;
+        } else {
+            DistType = Fixed;
+        }
+        if (!ParseNumber(&Config, &Scale)) {
+            return false;
+        }
+        if (DistType == Fixed) {
+            return *Config == '\0';
+        }
+        if (*Config++ != ':' || !ParseNumber(&Config, &Shape) || Shape <= 0) {
+            return false;
+        }
+        if (*Config == ':') {
+            ++Config;
+            double Value;
+            if (!ParseNumber(&Config, &Value) || Value < Scale) {
+                return false;
+            }
+            Max = (uint64_t)Value;
+        }
+        return *Config == '\0';
+    }
+
+    uint64_t Sample() const {
+        double Value;
+        switch (DistType) {
+        case Fixed:
+            return (uint64_t)Scale;
+        case Lognormal:
+            Value = Scale * exp(Shape * Normal());
+            break;
+        case Pareto:
+            Value = Scale * exp(-log(Uniform()) / Shape);
+            break;
+        case Empirical:
+            return Samples[(uint32_t)(Uniform() * SampleCount) % SampleCount];
+        default:
+            return 0;
+        }
+        return Value >= (double)Max ? Max : (uint64_t)Value;
+    }
+
+private:
+
+    //
+    // Uniform in (0, 1].
+    //
+    static double Uniform() {
+        uint64_t Random;
+        CxPlatRandom(sizeof(Random), &Random);
+        return (double)((Random >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    //
+    // Standard normal, by the Marsaglia polar method.
+    //
+    static double Normal() {
+        double U, V, S;
+        do {
+            U = 2 * Uniform() - 1;
+            V = 2 * Uniform() - 1;
+            S = U * U + V * V;
+        } while (S >= 1 || S == 0);
+        return U * sqrt(-2 * log(S) / S);
+    }
+
+    //
+    // Parses a non-negative decimal number, advancing past it.
+    //
+    static bool ParseNumber(_Inout_ const char** Str, _Out_ double* Value) {
+        const char* Cur = *Str;
+        double Result = 0;
+        bool Digits = false;
+        for (; *Cur >= '0' && *Cur <= '9'; ++Cur, Digits = true) {
+            Result = Result * 10 + (*Cur - '0');
+        }
+        if (*Cur == '.') {
+            double Place = 0.1;
+            for (++Cur; *Cur >= '0' && *Cur <= '9'; ++Cur, Digits = true) {
+                Result += (*Cur - '0') * Place;
+                Place /= 10;
+            }
+        }
+        *Value = Result;
+        *Str = Cur;
+        return Digits;
+    }
+
+    bool LoadFile(_In_z_ const char* Path) {
+#ifdef _KERNEL_MODE
+        UNREFERENCED_PARAMETER(Path);
+        WriteOutput("Distribution files aren't supported in kernel mode!\n");
+        return false;
+#else
+        FILE* File = fopen(Path, "r");
+        if (File == nullptr) {
+            WriteOutput("Failed to open distribution file '%s'!\n", Path);
+            return false;
+        }
+        unsigned long long Value;
+        uint32_t Count = 0;
+        while (fscanf(File, "%llu", &Value) == 1) {
+            ++Count;
+        }
+        if (Count == 0 || !feof(File)) {
+            WriteOutput("Distribution file '%s' must contain one number per line!\n", Path);
+            fclose(File);
+            return false;
+        }
+        Samples.reset(new(std::nothrow) uint64_t[Count]);
+        if (Samples == nullptr) {
+            fclose(File);
+            return false;
+        }
+        rewind(File);
+        while (SampleCount < Count && fscanf(File, "%llu", &Value) == 1) {
+            Samples[SampleCount++] = Value;
+        }
+        fclose(File);
+        DistType = Empirical;
+        return SampleCount != 0;
+#endif
+    }
+};
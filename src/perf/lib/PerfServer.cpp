@@ -235,12 +235,51 @@ PerfServer::ConnectionCallback(
         MsQuic->SetCallbackHandler(Event->PEER_STREAM_STARTED.Stream, (void*)Handler, Context);
         break;
     }
+    case QUIC_CONNECTION_EVENT_DATAGRAM_RECEIVED:
+        OnDatagramReceived(ConnectionHandle, Event->DATAGRAM_RECEIVED.Buffer);
+        break;
+    case QUIC_CONNECTION_EVENT_DATAGRAM_SEND_STATE_CHANGED:
+        if (QUIC_DATAGRAM_SEND_STATE_IS_FINAL(Event->DATAGRAM_SEND_STATE_CHANGED.State)) {
+            DatagramEchoAllocator.Free(
+                (DatagramEcho*)Event->DATAGRAM_SEND_STATE_CHANGED.ClientContext);
+        }
+        break;
     default:
         break;
     }
     return QUIC_STATUS_SUCCESS;
 }
 
+void
+PerfServer::OnDatagramReceived(
+    _In_ HQUIC ConnectionHandle,
+    _In_ const QUIC_BUFFER* Buffer
+    ) {
+    InterlockedIncrement64((int64_t*)&DatagramsReceived);
+    if (Buffer->Length < sizeof(PERF_DATAGRAM_HEADER)) {
+        return;
+    }
+    PERF_DATAGRAM_HEADER Header;
+    CxPlatCopyMemory(&Header, Buffer->Buffer, sizeof(Header));
+    if (!(CxPlatByteSwapUint64(Header.Sequence) & PERF_DATAGRAM_ECHO_FLAG)) {
+        return;
+    }
+
+    auto Echo = DatagramEchoAllocator.Alloc();
+    if (!Echo) {
+        return;
+    }
+    Echo->Echo.Header = Header;
+    Echo->Echo.ReceiveTime = CxPlatByteSwapUint64(CxPlatTimeUs64());
+    Echo->Buffer.Buffer = (uint8_t*)&Echo->Echo;
+    Echo->Buffer.Length = sizeof(Echo->Echo);
+    if (QUIC_FAILED(
+        MsQuic->DatagramSend(
+            ConnectionHandle, &Echo->Buffer, 1, QUIC_SEND_FLAG_NONE, Echo))) {
+        DatagramEchoAllocator.Free(Echo);
+    }
+}
+
 void
 PerfServer::IntroduceFixedDelay(uint32_t DelayUs)
 {
@@ -400,6 +439,7 @@ PerfServer::SendResponse(
             Context->LastBuffer.Length = IoSize;
             Buffer = &Context->LastBuffer;
             Flags = QUIC_SEND_FLAG_FIN;
+            InterlockedIncrement64((int64_t*)&ResponsesCompleted);
         }
 
         Context->BytesSent += IoSize;
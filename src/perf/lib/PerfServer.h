@@ -91,6 +91,8 @@ public:
         );
     QUIC_STATUS Start(_In_ CXPLAT_EVENT* StopEvent);
     QUIC_STATUS Wait(int Timeout);
+    uint64_t GetResponsesCompleted() const { return ResponsesCompleted; }
+    uint64_t GetDatagramsReceived() const { return DatagramsReceived; }
     void SimulateDelay();
     void
     SendResponse(
@@ -134,6 +136,22 @@ private:
 
     CxPlatPoolT<TcpSendData> TcpSendDataAllocator;
 
+    //
+    // An echo of a datagram's header, until its send state is final.
+    //
+    struct DatagramEcho {
+        PERF_DATAGRAM_ECHO Echo;
+        QUIC_BUFFER Buffer;
+    };
+
+    CxPlatPoolT<DatagramEcho> DatagramEchoAllocator;
+
+    void
+    OnDatagramReceived(
+        _In_ HQUIC ConnectionHandle,
+        _In_ const QUIC_BUFFER* Buffer
+        );
+
     QUIC_STATUS
     ListenerCallback(
         _Inout_ QUIC_LISTENER_EVENT* Event
@@ -183,11 +201,14 @@ private:
             .SetCongestionControlAlgorithm(PerfDefaultCongestionControl)
             .SetEcnEnabled(PerfDefaultEcnEnabled)
             .SetEncryptionOffloadAllowed(PerfDefaultQeoAllowed)
-            .SetOneWayDelayEnabled(true)};
+            .SetOneWayDelayEnabled(true)
+            .SetDatagramReceiveEnabled(true)};
     MsQuicListener Listener {Registration, CleanUpManual, ListenerCallbackStatic, this};
     QUIC_ADDR LocalAddr;
     CXPLAT_EVENT* StopEvent {nullptr};
     uint8_t PrintStats {FALSE};
+    uint64_t ResponsesCompleted {0}; // Responses fully queued to send.
+    uint64_t DatagramsReceived {0};
 
     TcpEngine Engine;
     TcpConfiguration TcpConfig;
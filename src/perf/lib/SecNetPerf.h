@@ -32,6 +32,7 @@ Abstract:
 
 #define PERF_ALPN                           "perf"
 #define PERF_DEFAULT_PORT                   4433
+#define PERF_DEFAULT_AGENT_PORT             4434
 #define PERF_DEFAULT_DISCONNECT_TIMEOUT     (10 * 1000)
 #define PERF_DEFAULT_IDLE_TIMEOUT           (30 * 1000)
 #define PERF_DEFAULT_CONN_FLOW_CONTROL      0x8000000
@@ -42,6 +43,51 @@ Abstract:
 #define PERF_MAX_THREAD_COUNT               128
 #define PERF_MAX_REQUESTS_PER_SECOND        2000000 // best guess - must increase if we can do better
 
+//
+// When response sizes are drawn from a distribution, latency is also reported
+// separately for the responses in each of these size ranges.
+//
+#define PERF_SIZE_BUCKET_COUNT              5
+
+static const char* const PerfSizeBucketNames[PERF_SIZE_BUCKET_COUNT] = {
+    "<1kb", "1kb-16kb", "16kb-128kb", "128kb-1mb", ">=1mb"
+};
+
+QUIC_INLINE
+uint8_t
+PerfSizeBucket(
+    _In_ uint64_t Size
+    )
+{
+    const uint64_t Limits[PERF_SIZE_BUCKET_COUNT - 1] = {
+        1000, 16 * 1000, 128 * 1000, 1000 * 1000
+    };
+    uint8_t Bucket = 0;
+    while (Bucket < PERF_SIZE_BUCKET_COUNT - 1 && Size >= Limits[Bucket]) {
+        ++Bucket;
+    }
+    return Bucket;
+}
+
+//
+// Every datagram sent in datagram mode starts with this header, in network
+// byte order. The server echoes the header of datagrams with
+// PERF_DATAGRAM_ECHO set in their sequence number, followed by the time (on
+// its clock) it received them.
+//
+typedef struct PERF_DATAGRAM_HEADER {
+    uint64_t Sequence;
+    uint64_t SendTime;              // us, on the client's clock
+} PERF_DATAGRAM_HEADER;
+
+typedef struct PERF_DATAGRAM_ECHO {
+    PERF_DATAGRAM_HEADER Header;
+    uint64_t ReceiveTime;           // us, on the server's clock
+} PERF_DATAGRAM_ECHO;
+
+#define PERF_DATAGRAM_ECHO_FLAG             0x8000000000000000ull
+#define PERF_DEFAULT_DATAGRAM_WINDOW        64
+
 typedef enum TCP_EXECUTION_PROFILE {
     TCP_EXECUTION_PROFILE_LOW_LATENCY,
     TCP_EXECUTION_PROFILE_MAX_THROUGHPUT,
@@ -89,6 +135,24 @@ QuicMainGetExtraData(
     _In_ uint32_t Length
     );
 
+//
+// Totals from a completed client run, so runs on several agents can be
+// aggregated.
+//
+typedef struct PERF_CLIENT_SUMMARY {
+    uint64_t RunTime;               // us, or 0 if not a repeat scenario
+    uint64_t ConnectionsConnected;
+    uint64_t StreamsCompleted;
+    uint64_t UploadRate;            // kbps
+    uint64_t DownloadRate;          // kbps
+} PERF_CLIENT_SUMMARY;
+
+extern
+bool
+QuicMainGetClientSummary(
+    _Out_ PERF_CLIENT_SUMMARY* Summary
+    );
+
 QUIC_INLINE
 const char*
 TryGetTarget(
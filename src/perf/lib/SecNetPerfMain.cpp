@@ -13,6 +13,7 @@ Abstract:
 #include "PerfServer.h"
 #include "PerfClient.h"
 #include "Tcp.h"
+#include "PerfCpu.h"
 
 const MsQuicApi* MsQuic;
 CXPLAT_WORKER_POOL* WorkerPool;
@@ -20,6 +21,10 @@ CXPLAT_DATAPATH* Datapath;
 CxPlatWatchdog* Watchdog;
 PerfServer* Server;
 PerfClient* Client;
+bool InProcessServer;
+#ifndef _KERNEL_MODE
+PerfCpuMonitor* CpuMonitor;
+#endif
 
 uint32_t MaxRuntime = 0;
 QUIC_EXECUTION_PROFILE PerfDefaultExecutionProfile = QUIC_EXECUTION_PROFILE_LOW_LATENCY;
@@ -111,15 +116,27 @@ PrintHelp(
         "  -pconn:<0/1>             Print connection statistics. (def:0)\n"
         "  -pstream:<0/1>           Print stream statistics. (def:0)\n"
         "  -platency<0/1>           Print latency statistics. (def:0)\n"
+#ifndef _KERNEL_MODE
+        "  -json:<file>             Writes the results to a JSON file, for comparing runs.\n"
+#endif // _KERNEL_MODE
         "\n"
         "  Scenario options:\n"
         "  -scenario:<profile>      Scenario profile to use.\n"
-        "                            - {upload, download, hps, rps, rps-multi, latency}.\n"
+        "                            - {upload, download, hps, rps, rps-multi, latency, h3, datagram, datagram-latency}.\n"
         "  -conns:<####>            The number of connections to use. (def:1)\n"
         "  -streams:<####>          The number of streams to send on at a time. (def:0)\n"
         "  -upload:<####>[unit]     The length of bytes to send on each stream, with an optional (time or length) unit. (def:0)\n"
         "  -download:<####>[unit]   The length of bytes to receive on each stream, with an optional (time or length) unit. (def:0)\n"
         "  -iosize:<####>           The size of each send request queued.\n"
+        "  -reqsize:<dist>          Draws each stream's upload length from a distribution.\n"
+        "  -respsize:<dist>         Draws each stream's download length from a distribution.\n"
+        "                            - {<####>, lognormal:<median>:<sigma>[:<max>], pareto:<min>:<alpha>[:<max>], file:<path>}\n"
+        "  -think:<dist>            Draws the time (us) to wait before repeating each stream from a distribution.\n"
+        "  -prio:<0/1>              Prioritizes streams with smaller response sizes. (def:0)\n"
+        "  -rate:<####>             Starts streams open loop, at this many per second, and measures latency from when each was due.\n"
+        "  -datagram:<####>         Sends datagrams of this many bytes instead of using streams (open loop and echoed with 'rate').\n"
+        "  -dgwindow:<####>         The datagrams queued per connection, without 'rate'. (def:%u)\n"
+        "  -dgoneway:<0/1>          Measures one way datagram latency, from the server's clock (same machine only). (def:0)\n"
         //"  -inline:<0/1>            Create new streams on callbacks. (def:0)\n"
         "  -rconn:<0/1>             Repeat the scenario at the connection level. (def:0)\n"
         "  -rstream:<0/1>           Repeat the scenario at the stream level. (def:0)\n"
@@ -129,13 +146,16 @@ PrintHelp(
         "  -exec:<profile>          Execution profile to use.\n"
         "                            - {lowlat, maxtput, scavenger, realtime}.\n"
         "  -cc:<algo>               Congestion control algorithm to use.\n"
-        "                            - {cubic, bbr}.\n"
+        "                            - {cubic, bbr, bbr3, prague}.\n"
         "  -pollidle:<time_us>      Amount of time to poll while idle before sleeping (default: 0).\n"
         "  -ecn:<0/1>               Enables/disables sender-side ECN support. (def:0)\n"
         "  -qeo:<0/1>               Allows/disallowes QUIC encryption offload. (def:0)\n"
 #ifndef _KERNEL_MODE
         "  -io:<mode>               Configures a requested network IO model to be used.\n"
-        "                            - {iocp, xdp, qtip, epoll, iouring, kqueue}\n"
+        "                            - {iocp, rio, xdp, qtip, epoll, iouring, kqueue, loopback}\n"
+        "  -loopdelay:<time_us>     One way delay of the in-process loopback (-io:loopback). (def:0)\n"
+        "  -looploss:<####>         Datagrams lost per million by the in-process loopback. (def:0)\n"
+        "  -looprate:<####>         Link rate (Mbps) of the in-process loopback. (def:0, unlimited)\n"
 #else
         "  -io:<mode>               Configures a requested network IO model to be used.\n"
         "                            - {wsk}\n"
@@ -144,12 +164,39 @@ PrintHelp(
         "  -cipher:<value>          Decimal value of 1 or more QUIC_ALLOWED_CIPHER_SUITE_FLAGS.\n"
         "  -highpri:<0/1>           Configures MsQuic to run threads at high priority. (def:0)\n"
         "  -dscp:<0-63>             Specify DSCP value to mark sent packets with. (def:0)\n"
-        "\n",
+        "  -pcpu:<0/1>              Print CPU utilization and cost per byte/request/handshake. (def:0)\n"
+        "\n"
+#ifndef _KERNEL_MODE
+        "Agent: secnetperf -agent [-agentport:<####>]\n"
+        "\n"
+        "  Runs clients on behalf of a coordinator, on a TCP control port. (def:%u)\n"
+        "\n"
+        "Coordinator: secnetperf -agents:<host[:port]>[,...] -target:<hostname/ip> [client options]\n"
+        "\n"
+        "  Runs the client on each of the agents at once, and aggregates their results.\n"
+        "\n"
+#endif // _KERNEL_MODE
+        ,
+        PERF_DEFAULT_PORT,
         PERF_DEFAULT_PORT,
-        PERF_DEFAULT_PORT
+        PERF_DEFAULT_DATAGRAM_WINDOW
+#ifndef _KERNEL_MODE
+        , PERF_DEFAULT_AGENT_PORT
+#endif // _KERNEL_MODE
         );
 }
 
+static
+void
+StartCpuMonitor(
+    ) {
+#ifndef _KERNEL_MODE
+    if (CpuMonitor) {
+        CpuMonitor->Start();
+    }
+#endif
+}
+
 QUIC_STATUS
 QuicMainStart(
     _In_ int argc,
@@ -159,6 +206,20 @@ QuicMainStart(
     ) {
     argc--; argv++; // Skip app name
 
+    //
+    // Reset anything a previous run in this process may have changed.
+    //
+    MaxRuntime = 0;
+    InProcessServer = false;
+    PerfDefaultExecutionProfile = QUIC_EXECUTION_PROFILE_LOW_LATENCY;
+    TcpDefaultExecutionProfile = TCP_EXECUTION_PROFILE_LOW_LATENCY;
+    PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
+    PerfDefaultEcnEnabled = false;
+    PerfDefaultQeoAllowed = false;
+    PerfDefaultHighPriority = false;
+    PerfDefaultAffinitizeThreads = false;
+    PerfDefaultDscpValue = 0;
+
     if (GetFlag(argc, argv, "?") || GetFlag(argc, argv, "help")) {
         PrintHelp();
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -185,13 +246,49 @@ QuicMainStart(
     bool SetConfig = false;
 
     const char* IoMode = GetValue(argc, argv, "io");
-    if (IoMode) {
+    if (IoMode && IsValue(IoMode, "loopback")) {
+#ifndef _KERNEL_MODE
+        //
+        // Client and server run in this process, and the datapath hands
+        // datagrams between them in memory.
+        //
+        uint8_t UseTcp = false;
+        TryGetValue(argc, argv, "tcp", &UseTcp);
+        if (UseTcp) {
+            WriteOutput("TCP isn't supported with the in-process loopback!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        QUIC_DATAPATH_LOOPBACK_CONFIG Loopback = {0};
+        TryGetValue(argc, argv, "loopdelay", &Loopback.DelayUs);
+        TryGetValue(argc, argv, "looploss", &Loopback.LossRate);
+        uint32_t LoopRateMbps = 0;
+        if (TryGetValue(argc, argv, "looprate", &LoopRateMbps)) {
+            Loopback.Bandwidth = (uint64_t)LoopRateMbps * 1000 * 1000;
+        }
+        if (QUIC_FAILED(
+            Status =
+            MsQuic->SetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_DATAPATH_LOOPBACK,
+                sizeof(Loopback),
+                &Loopback))) {
+            WriteOutput("Failed to enable the in-process loopback 0x%x\n", Status);
+            return Status;
+        }
+        InProcessServer = Target != nullptr;
+#else
+        WriteOutput("The in-process loopback isn't supported in kernel mode!\n");
+        return QUIC_STATUS_NOT_SUPPORTED;
+#endif
+    } else if (IoMode) {
         MsQuicSettings Settings;
         if (IsValue(IoMode, "xdp")) {
             Settings.SetXdpEnabled(true);
         } else if (IsValue(IoMode, "qtip")) {
             Settings.SetXdpEnabled(true);
             Settings.SetQtipEnabled(true);
+        } else if (IsValue(IoMode, "rio")) {
+            Settings.SetRioEnabled(true);
         }
         Settings.SetGlobal();
     }
@@ -244,13 +341,16 @@ QuicMainStart(
     if (ScenarioStr != nullptr) {
         if (IsValue(ScenarioStr, "upload") ||
             IsValue(ScenarioStr, "download") ||
-            IsValue(ScenarioStr, "hps")) {
+            IsValue(ScenarioStr, "hps") ||
+            IsValue(ScenarioStr, "datagram")) {
             PerfDefaultExecutionProfile = QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT;
             TcpDefaultExecutionProfile = TCP_EXECUTION_PROFILE_MAX_THROUGHPUT;
         } else if (
             IsValue(ScenarioStr, "rps") ||
             IsValue(ScenarioStr, "rps-multi") ||
-            IsValue(ScenarioStr, "latency")) {
+            IsValue(ScenarioStr, "latency") ||
+            IsValue(ScenarioStr, "datagram-latency") ||
+            IsValue(ScenarioStr, "h3")) {
             PerfDefaultExecutionProfile = QUIC_EXECUTION_PROFILE_LOW_LATENCY;
             TcpDefaultExecutionProfile = TCP_EXECUTION_PROFILE_LOW_LATENCY;
         } else {
@@ -281,6 +381,10 @@ QuicMainStart(
     if (CcName != nullptr) {
         if (IsValue(CcName, "cubic")) {
             PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
+        } else if (IsValue(CcName, "prague")) {
+            PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE;
+        } else if (IsValue(CcName, "bbr3")) {
+            PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3;
         } else if (IsValue(CcName, "bbr")) {
             PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR;
         } else {
@@ -319,18 +423,44 @@ QuicMainStart(
         return Status;
     }
 
+    uint8_t PrintCpu = false;
+    TryGetValue(argc, argv, "pcpu", &PrintCpu);
+#ifndef _KERNEL_MODE
+    if (PrintCpu) {
+        CpuMonitor = new(std::nothrow) PerfCpuMonitor;
+    }
+#else
+    if (PrintCpu) {
+        WriteOutput("CPU statistics aren't supported in kernel mode!\n");
+    }
+#endif
+
+    if (InProcessServer) {
+        CXPLAT_FRE_ASSERT(SelfSignedCredConfig);
+        Server = new(std::nothrow) PerfServer(SelfSignedCredConfig);
+        if (QUIC_FAILED(Status = Server->Init(argc, argv)) ||
+            QUIC_FAILED(Status = Server->Start(nullptr))) {
+            WriteOutput("In-process server failed to start 0x%x\n", Status);
+            return Status; // QuicMainFree is called on failure
+        }
+    }
+
     if (Target) {
         Client = new(std::nothrow) PerfClient;
-        if ((QUIC_SUCCEEDED(Status = Client->Init(argc, argv, Target)) &&
-             QUIC_SUCCEEDED(Status = Client->Start(StopEvent)))) {
-            return QUIC_STATUS_SUCCESS;
+        if (QUIC_SUCCEEDED(Status = Client->Init(argc, argv, Target))) {
+            StartCpuMonitor();
+            if (QUIC_SUCCEEDED(Status = Client->Start(StopEvent))) {
+                return QUIC_STATUS_SUCCESS;
+            }
         }
     } else {
         CXPLAT_FRE_ASSERT(SelfSignedCredConfig);
         Server = new(std::nothrow) PerfServer(SelfSignedCredConfig);
-        if ((QUIC_SUCCEEDED(Status = Server->Init(argc, argv)) &&
-             QUIC_SUCCEEDED(Status = Server->Start(StopEvent)))) {
-            return QUIC_STATUS_SUCCESS;
+        if (QUIC_SUCCEEDED(Status = Server->Init(argc, argv))) {
+            StartCpuMonitor();
+            if (QUIC_SUCCEEDED(Status = Server->Start(StopEvent))) {
+                return QUIC_STATUS_SUCCESS;
+            }
         }
     }
 
@@ -342,7 +472,17 @@ QuicMainStart(
 QUIC_STATUS
 QuicMainWaitForCompletion(
     ) {
-    return Client ? Client->Wait((int)MaxRuntime) : Server->Wait((int)MaxRuntime);
+    QUIC_STATUS Status =
+        Client ? Client->Wait((int)MaxRuntime) : Server->Wait((int)MaxRuntime);
+#ifndef _KERNEL_MODE
+    if (CpuMonitor && QUIC_SUCCEEDED(Status)) {
+        CpuMonitor->Stop();
+        CpuMonitor->Print(
+            Client ? Client->GetStreamsCompleted() : Server->GetResponsesCompleted(),
+            Client ? Client->GetDatagramsSent() : Server->GetDatagramsReceived());
+    }
+#endif
+    return Status;
 }
 
 void
@@ -366,6 +506,11 @@ QuicMainFree(
 
     delete Watchdog;
     Watchdog = nullptr;
+
+#ifndef _KERNEL_MODE
+    delete CpuMonitor;
+    CpuMonitor = nullptr;
+#endif
 }
 
 uint32_t QuicMainGetExtraDataLength() {
@@ -382,6 +527,22 @@ QuicMainGetExtraData(
     Client->GetExtraData(Data, Length);
 }
 
+bool
+QuicMainGetClientSummary(
+    _Out_ PERF_CLIENT_SUMMARY* Summary
+    )
+{
+    if (!Client) {
+        return false;
+    }
+    Summary->RunTime = Client->RunTime;
+    Summary->ConnectionsConnected = Client->GetConnectedConnections();
+    Summary->StreamsCompleted = Client->GetStreamsCompleted();
+    Summary->UploadRate = Client->GetUploadRate();
+    Summary->DownloadRate = Client->GetDownloadRate();
+    return true;
+}
+
 const char* TimeUnits[] = { "m", "ms", "us", "s" };
 const uint64_t TimeMult[] = { 60 * 1000 * 1000, 1000, 1, 1000 * 1000 };
 const char* SizeUnits[] = { "gb", "mb", "kb", "b" };
@@ -477,6 +638,17 @@ TryGetVariableUnitValue<uint32_t>(
     _Out_opt_ bool* isTimed
     );
 
+_Success_(return != false)
+template
+bool
+TryGetVariableUnitValue<uint64_t>(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_z_ const char* name,
+    _Out_ uint64_t * pValue,
+    _Out_opt_ bool* isTimed
+    );
+
 _Success_(return != false)
 template
 bool
@@ -380,7 +380,8 @@ TcpConnection::TcpConnection(
     TcpEngine* Engine,
     const TcpConfiguration* Config,
     void* Context) :
-    IsServer(false), Engine(Engine), SecConfig(Config->SecConfig), Context(Context)
+    IsServer(false), EncryptStreams(Config->EncryptStreams), Engine(Engine),
+    SecConfig(Config->SecConfig), Context(Context)
 {
     CxPlatRefInitialize(&Ref);
     CxPlatEventInitialize(&CloseComplete, TRUE, FALSE);
@@ -929,6 +930,17 @@ bool TcpConnection::ProcessReceiveFrame(TcpFrame* Frame)
         }
         break;
     case FRAME_TYPE_STREAM: {
+        if (Frame->KeyType == QUIC_PACKET_KEY_INITIAL) {
+            //
+            // Unencrypted stream data is only allowed after the handshake, and
+            // only if this side isn't configured to require encryption.
+            //
+            if (TlsState.ReadKey < QUIC_PACKET_KEY_1_RTT || (!IsServer && EncryptStreams)) {
+                WriteOutput("Unexpected unencrypted stream data\n");
+                return false;
+            }
+            EncryptStreams = false;
+        }
         auto StreamFrame = (TcpStreamFrame*)Frame->Data;
         QuicTraceLogVerbose(
             PerfTcpAppReceive,
@@ -990,7 +1002,7 @@ bool TcpConnection::ProcessSend()
             auto Frame = (TcpFrame*)SendBuffer->Buffer;
             Frame->FrameType = FRAME_TYPE_STREAM;
             Frame->Length = (uint16_t)(sizeof(TcpStreamFrame) + StreamLength);
-            Frame->KeyType = QUIC_PACKET_KEY_1_RTT;
+            Frame->KeyType = EncryptStreams ? QUIC_PACKET_KEY_1_RTT : QUIC_PACKET_KEY_INITIAL;
 
             auto StreamFrame = (TcpStreamFrame*)Frame->Data;
             StreamFrame->Id = NextSendData->StreamId;
@@ -158,6 +158,12 @@ class TcpConfiguration {
         );
 public:
     CXPLAT_SEC_CONFIG* SecConfig{nullptr};
+    //
+    // When false, the handshake still runs but stream data is sent without
+    // the AEAD applied, modelling TLS offloaded to the NIC (e.g. kTLS with
+    // hardware offload). Servers mirror what each client sends.
+    //
+    bool EncryptStreams{true};
     TcpConfiguration(const QUIC_CREDENTIAL_CONFIG* CredConfig) noexcept;
     ~TcpConfiguration() noexcept;
     TcpConfiguration(const TcpConfiguration&) = delete;
@@ -207,6 +213,7 @@ class TcpConnection {
     bool Closed{false};
     bool QueuedOnWorker{false};
     bool StartTls{false};
+    bool EncryptStreams{true};
     bool ConnStartQueued{false};
     bool IndicateAccept{false};
     bool IndicateConnect{false};
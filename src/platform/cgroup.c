@@ -7,7 +7,7 @@
 
 Abstract:
 
-    Read the memory limit for the current process
+    Read the memory and CPU limits for the current process
 
 Environment:
 
@@ -33,6 +33,9 @@ Environment:
 #include <sys/vfs.h>
 #endif
 #include <errno.h>
+#if defined(CX_PLATFORM_LINUX)
+#include <sched.h>
+#endif
 
 #ifndef SIZE_T_MAX
 #define SIZE_T_MAX (~(size_t)0)
@@ -45,6 +48,11 @@ Environment:
 #define PROC_CGROUP_FILENAME "/proc/self/cgroup"
 #define CGROUP1_MEMORY_LIMIT_FILENAME "/memory.limit_in_bytes"
 #define CGROUP2_MEMORY_LIMIT_FILENAME "/memory.max"
+#define CGROUP1_CFS_QUOTA_FILENAME "/cpu.cfs_quota_us"
+#define CGROUP1_CFS_PERIOD_FILENAME "/cpu.cfs_period_us"
+#define CGROUP2_CPU_MAX_FILENAME "/cpu.max"
+#define CGROUP1_CPUSET_FILENAME "/cpuset.effective_cpus"
+#define CGROUP2_CPUSET_FILENAME "/cpuset.cpus.effective"
 
 static int CGroupVersion = 0;
 static char* CGroupMemoryPath = NULL;
@@ -128,6 +136,28 @@ IsCGroup1MemorySubsystem(
     return strcmp("memory", strTok) == 0;
 }
 
+static
+_Success_(return != FALSE)
+BOOLEAN
+IsCGroup1CpuSubsystem(
+    _In_z_ const char *strTok
+    )
+{
+    return strcmp("cpu", strTok) == 0;
+}
+
+#if defined(CX_PLATFORM_LINUX)
+static
+_Success_(return != FALSE)
+BOOLEAN
+IsCGroup1CpuSetSubsystem(
+    _In_z_ const char *strTok
+    )
+{
+    return strcmp("cpuset", strTok) == 0;
+}
+#endif
+
 static
 _Success_(return == 1 || return == 2)
 int
@@ -571,3 +601,229 @@ Done:
 
     return PhysicalMemoryLimit;
 }
+
+//
+// Reads a cgroup CPU bandwidth file, which is either a single value (v1) or a
+// "quota period" pair (v2). A quota of -1 (v1) or "max" (v2) means unlimited.
+//
+static
+_Success_(return != FALSE)
+BOOLEAN
+ReadCpuQuotaFromFile(
+    _In_z_ const char* Filename,
+    _Out_ int64_t* Quota,
+    _Out_opt_ int64_t* Period
+    )
+{
+    BOOLEAN Result = FALSE;
+    char* Line = NULL;
+    size_t LineLen = 0;
+    char* EndPtr = NULL;
+
+    FILE* File = fopen(Filename, "r");
+    if (File == NULL) {
+        goto Done;
+    }
+
+    if (getline(&Line, &LineLen, File) == -1) {
+        goto Done;
+    }
+
+    if (strncmp(Line, "max", 3) == 0) {
+        *Quota = -1;
+        EndPtr = Line + 3;
+    } else {
+        errno = 0;
+        *Quota = strtoll(Line, &EndPtr, 10);
+        if (errno != 0 || EndPtr == Line) {
+            goto Done;
+        }
+    }
+
+    if (Period != NULL) {
+        char* PeriodStr = EndPtr;
+        errno = 0;
+        *Period = strtoll(PeriodStr, &EndPtr, 10);
+        if (errno != 0 || EndPtr == PeriodStr) {
+            goto Done;
+        }
+    }
+
+    Result = TRUE;
+
+Done:
+
+    if (File) {
+        fclose(File);
+    }
+    free(Line);
+    return Result;
+}
+
+static
+_Success_(return != FALSE)
+BOOLEAN
+GetCGroupCpuQuota(
+    _In_z_ const char* CGroupCpuPath,
+    _Out_ int64_t* Quota,
+    _Out_ int64_t* Period
+    )
+{
+    BOOLEAN Result = FALSE;
+    char* Filename = NULL;
+
+    if (CGroupVersion == 1) {
+        if (asprintf(&Filename, "%s%s", CGroupCpuPath, CGROUP1_CFS_QUOTA_FILENAME) < 0) {
+            return FALSE;
+        }
+        Result = ReadCpuQuotaFromFile(Filename, Quota, NULL);
+        free(Filename);
+        if (!Result) {
+            return FALSE;
+        }
+        if (asprintf(&Filename, "%s%s", CGroupCpuPath, CGROUP1_CFS_PERIOD_FILENAME) < 0) {
+            return FALSE;
+        }
+        Result = ReadCpuQuotaFromFile(Filename, Period, NULL);
+
+    } else if (CGroupVersion == 2) {
+        if (asprintf(&Filename, "%s%s", CGroupCpuPath, CGROUP2_CPU_MAX_FILENAME) < 0) {
+            return FALSE;
+        }
+        Result = ReadCpuQuotaFromFile(Filename, Quota, Period);
+    }
+
+    free(Filename);
+    return Result;
+}
+
+//
+// Returns the number of processors the process' cgroup CPU bandwidth quota
+// allows, rounded up, or 0 if there is no quota.
+//
+uint32_t
+CGroupGetCpuLimit()
+{
+    uint32_t CpuLimit = 0;
+    int64_t Quota = -1, Period = 0;
+
+    CGroupVersion = FindCGroupVersion();
+    char* CGroupCpuPath =
+        FindCGroupPath(CGroupVersion == 1 ? &IsCGroup1CpuSubsystem : NULL);
+    if (CGroupCpuPath == NULL) {
+        goto Done;
+    }
+
+    if (!GetCGroupCpuQuota(CGroupCpuPath, &Quota, &Period) ||
+        Quota <= 0 || Period <= 0) {
+        goto Done;
+    }
+
+    const int64_t Cpus = (Quota + Period - 1) / Period;
+    CpuLimit = Cpus > UINT32_MAX ? UINT32_MAX : (uint32_t)Cpus;
+
+Done:
+
+    free(CGroupCpuPath);
+    return CpuLimit;
+}
+
+#if defined(CX_PLATFORM_LINUX)
+//
+// Parses a cgroup cpuset list, such as "0-3,8,10-11".
+//
+static
+_Success_(return != FALSE)
+BOOLEAN
+ReadCpuSetFromFile(
+    _In_z_ const char* Filename,
+    _Out_ cpu_set_t* CpuSet
+    )
+{
+    BOOLEAN Result = FALSE;
+    char* Line = NULL;
+    size_t LineLen = 0;
+
+    CPU_ZERO(CpuSet);
+
+    FILE* File = fopen(Filename, "r");
+    if (File == NULL) {
+        goto Done;
+    }
+
+    if (getline(&Line, &LineLen, File) == -1) {
+        goto Done;
+    }
+
+    char* Context = NULL;
+    char* StrTok = strtok_r(Line, ",\n", &Context);
+    while (StrTok != NULL) {
+        char* EndPtr = NULL;
+        errno = 0;
+        unsigned long First = strtoul(StrTok, &EndPtr, 10);
+        unsigned long Last = First;
+        if (errno != 0 || EndPtr == StrTok) {
+            goto Done;
+        }
+        if (*EndPtr == '-') {
+            char* LastStr = EndPtr + 1;
+            Last = strtoul(LastStr, &EndPtr, 10);
+            if (errno != 0 || EndPtr == LastStr || Last < First) {
+                goto Done;
+            }
+        }
+        for (unsigned long Cpu = First; Cpu <= Last && Cpu < CPU_SETSIZE; ++Cpu) {
+            CPU_SET(Cpu, CpuSet);
+        }
+        StrTok = strtok_r(NULL, ",\n", &Context);
+    }
+
+    Result = CPU_COUNT(CpuSet) > 0;
+
+Done:
+
+    if (File) {
+        fclose(File);
+    }
+    free(Line);
+    return Result;
+}
+
+//
+// Gets the processors the process' cgroup cpuset allows.
+//
+_Success_(return != FALSE)
+BOOLEAN
+CGroupGetCpuSet(
+    _Out_ cpu_set_t* CpuSet
+    )
+{
+    BOOLEAN Result = FALSE;
+    char* Filename = NULL;
+
+    CGroupVersion = FindCGroupVersion();
+    char* CGroupCpuSetPath =
+        FindCGroupPath(CGroupVersion == 1 ? &IsCGroup1CpuSetSubsystem : NULL);
+    if (CGroupCpuSetPath == NULL) {
+        CPU_ZERO(CpuSet);
+        goto Done;
+    }
+
+    if (asprintf(
+            &Filename,
+            "%s%s",
+            CGroupCpuSetPath,
+            CGroupVersion == 1 ? CGROUP1_CPUSET_FILENAME : CGROUP2_CPUSET_FILENAME) < 0) {
+        CPU_ZERO(CpuSet);
+        goto Done;
+    }
+
+    Result = ReadCpuSetFromFile(Filename, CpuSet);
+
+Done:
+
+    free(Filename);
+    free(CGroupCpuSetPath);
+    return Result;
+}
+#endif
@@ -480,21 +480,18 @@ QuicPacketKeyFree(
     }
 }
 
-_IRQL_requires_max_(DISPATCH_LEVEL)
-_At_(*NewKey, __drv_allocatesMem(Mem))
+//
+// Derives the next traffic secret (RFC 9001, Section 6.1) from the current one.
+//
+static
 QUIC_STATUS
-QuicPacketKeyUpdate(
+QuicPacketKeyNextTrafficSecret(
     _In_ const QUIC_HKDF_LABELS* HkdfLabels,
-    _In_ QUIC_PACKET_KEY* OldKey,
-    _Out_ QUIC_PACKET_KEY** NewKey
+    _In_ const QUIC_PACKET_KEY* OldKey,
+    _Out_ CXPLAT_SECRET* NewTrafficSecret
     )
 {
-    if (OldKey == NULL || OldKey->Type != QUIC_PACKET_KEY_1_RTT) {
-        return QUIC_STATUS_INVALID_STATE;
-    }
-
     CXPLAT_HASH* Hash = NULL;
-    CXPLAT_SECRET NewTrafficSecret;
     const uint16_t SecretLength = CxPlatHashLength(OldKey->TrafficSecret->Hash);
 
     QUIC_STATUS Status =
@@ -513,13 +510,44 @@ QuicPacketKeyUpdate(
             HkdfLabels->KuLabel,
             SecretLength,
             SecretLength,
-            NewTrafficSecret.Secret);
+            NewTrafficSecret->Secret);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
 
-    NewTrafficSecret.Hash = OldKey->TrafficSecret->Hash;
-    NewTrafficSecret.Aead = OldKey->TrafficSecret->Aead;
+    NewTrafficSecret->Hash = OldKey->TrafficSecret->Hash;
+    NewTrafficSecret->Aead = OldKey->TrafficSecret->Aead;
+
+Error:
+
+    CxPlatHashFree(Hash);
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_At_(*NewKey, __drv_allocatesMem(Mem))
+QUIC_STATUS
+QuicPacketKeyUpdate(
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_ QUIC_PACKET_KEY* OldKey,
+    _Out_ QUIC_PACKET_KEY** NewKey
+    )
+{
+    if (OldKey == NULL || OldKey->Type != QUIC_PACKET_KEY_1_RTT) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    CXPLAT_SECRET NewTrafficSecret;
+
+    QUIC_STATUS Status =
+        QuicPacketKeyNextTrafficSecret(
+            HkdfLabels,
+            OldKey,
+            &NewTrafficSecret);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
 
     Status =
         QuicPacketKeyDerive(
@@ -530,12 +558,315 @@ QuicPacketKeyUpdate(
             FALSE,
             NewKey);
 
-    CxPlatSecureZeroMemory(&NewTrafficSecret, sizeof(CXPLAT_SECRET));
     CxPlatSecureZeroMemory(OldKey->TrafficSecret, sizeof(CXPLAT_SECRET));
 
+Error:
+
+    CxPlatSecureZeroMemory(&NewTrafficSecret, sizeof(CXPLAT_SECRET));
+
+    return Status;
+}
+
+//
+// Derives the IV, packet key and (if present) header protection key for an
+// existing packet key from the given secret, re-keying them in place.
+//
+static
+QUIC_STATUS
+QuicPacketKeyRederive(
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_ const CXPLAT_SECRET* const Secret,
+    _In_z_ const char* const SecretName,
+    _Inout_ QUIC_PACKET_KEY* Key
+    )
+{
+    const uint16_t SecretLength = CxPlatHashLength(Secret->Hash);
+    const uint16_t KeyLength = CxPlatKeyLength(Secret->Aead);
+
+    CXPLAT_DBG_ASSERT(SecretLength >= KeyLength);
+    CXPLAT_DBG_ASSERT(SecretLength >= CXPLAT_IV_LENGTH);
+    CXPLAT_DBG_ASSERT(SecretLength <= CXPLAT_HASH_MAX_SIZE);
+    CXPLAT_DBG_ASSERT(Key->PacketKey != NULL);
+
+    CxPlatTlsLogSecret(SecretName, Secret->Secret, SecretLength);
+
+    CXPLAT_HASH* Hash = NULL;
+    uint8_t Temp[CXPLAT_HASH_MAX_SIZE];
+
+    QUIC_STATUS Status =
+        CxPlatHashCreate(
+            Secret->Hash,
+            Secret->Secret,
+            SecretLength,
+            &Hash);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Status =
+        CxPlatHkdfExpandLabel(
+            Hash,
+            HkdfLabels->IvLabel,
+            CXPLAT_IV_LENGTH,
+            SecretLength,
+            Temp);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    memcpy(Key->Iv, Temp, CXPLAT_IV_LENGTH);
+    CxPlatTlsLogSecret("static iv", Key->Iv, CXPLAT_IV_LENGTH);
+
+    Status =
+        CxPlatHkdfExpandLabel(
+            Hash,
+            HkdfLabels->KeyLabel,
+            KeyLength,
+            SecretLength,
+            Temp);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    CxPlatTlsLogSecret("key", Temp, KeyLength);
+
+    Status =
+        CxPlatKeyRekey(
+            Secret->Aead,
+            Temp,
+            &Key->PacketKey);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    if (Key->HeaderKey != NULL) {
+        Status =
+            CxPlatHkdfExpandLabel(
+                Hash,
+                HkdfLabels->HpLabel,
+                KeyLength,
+                SecretLength,
+                Temp);
+        if (QUIC_FAILED(Status)) {
+            goto Error;
+        }
+
+        CxPlatTlsLogSecret("hp", Temp, KeyLength);
+
+        Status =
+            CxPlatHpKeyRekey(
+                Secret->Aead,
+                Temp,
+                &Key->HeaderKey);
+        if (QUIC_FAILED(Status)) {
+            goto Error;
+        }
+    }
+
 Error:
 
     CxPlatHashFree(Hash);
 
+    CxPlatSecureZeroMemory(Temp, sizeof(Temp));
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicPacketKeyUpdateInPlace(
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_ QUIC_PACKET_KEY* OldKey,
+    _Inout_ QUIC_PACKET_KEY* NewKey
+    )
+{
+    if (OldKey == NULL || OldKey->Type != QUIC_PACKET_KEY_1_RTT ||
+        NewKey->Type != QUIC_PACKET_KEY_1_RTT || NewKey->PacketKey == NULL) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    CXPLAT_DBG_ASSERT(NewKey->HeaderKey == NULL);
+
+    QUIC_STATUS Status =
+        QuicPacketKeyNextTrafficSecret(
+            HkdfLabels,
+            OldKey,
+            NewKey->TrafficSecret);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Status =
+        QuicPacketKeyRederive(
+            HkdfLabels,
+            NewKey->TrafficSecret,
+            "update traffic secret",
+            NewKey);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    CxPlatSecureZeroMemory(OldKey->TrafficSecret, sizeof(CXPLAT_SECRET));
+
+Error:
+
+    if (QUIC_FAILED(Status)) {
+        CxPlatSecureZeroMemory(NewKey->TrafficSecret, sizeof(CXPLAT_SECRET));
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicPacketKeyRekeyInitial(
+    _In_ BOOLEAN IsServer,
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_reads_(CXPLAT_VERSION_SALT_LENGTH)
+        const uint8_t* const Salt,  // Version Specific
+    _In_ uint8_t CIDLength,
+    _In_reads_(CIDLength)
+        const uint8_t* const CID,
+    _Inout_ QUIC_PACKET_KEY* ReadKey,
+    _Inout_ QUIC_PACKET_KEY* WriteKey
+    )
+{
+    QUIC_STATUS Status;
+    CXPLAT_SECRET ClientInitial, ServerInitial;
+
+    if (ReadKey->Type != QUIC_PACKET_KEY_INITIAL || ReadKey->HeaderKey == NULL ||
+        WriteKey->Type != QUIC_PACKET_KEY_INITIAL || WriteKey->HeaderKey == NULL) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    Status =
+        CxPlatTlsDeriveInitialSecrets(
+            Salt,
+            CID,
+            CIDLength,
+            &ClientInitial,
+            &ServerInitial);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Status =
+        QuicPacketKeyRederive(
+            HkdfLabels,
+            IsServer ? &ServerInitial : &ClientInitial,
+            IsServer ? "srv secret" : "cli secret",
+            WriteKey);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Status =
+        QuicPacketKeyRederive(
+            HkdfLabels,
+            IsServer ? &ClientInitial : &ServerInitial,
+            IsServer ? "cli secret" : "srv secret",
+            ReadKey);
+
+Error:
+
+    CxPlatSecureZeroMemory(ClientInitial.Secret, sizeof(ClientInitial.Secret));
+    CxPlatSecureZeroMemory(ServerInitial.Secret, sizeof(ServerInitial.Secret));
+
     return Status;
 }
+
+#define CXPLAT_CHACHA20_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CXPLAT_CHACHA20_LOAD32(p) \
+    ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24))
+
+//
+// One ChaCha20 quarter round applied across all the lanes.
+//
+QUIC_INLINE
+void
+CxPlatChaCha20QuarterRound(
+    _Inout_updates_(16) uint32_t (*X)[CXPLAT_CHACHA20_HP_LANES],
+    _In_ uint8_t a,
+    _In_ uint8_t b,
+    _In_ uint8_t c,
+    _In_ uint8_t d
+    )
+{
+    for (uint8_t l = 0; l < CXPLAT_CHACHA20_HP_LANES; ++l) {
+        X[a][l] += X[b][l]; X[d][l] ^= X[a][l]; X[d][l] = CXPLAT_CHACHA20_ROTL(X[d][l], 16);
+        X[c][l] += X[d][l]; X[b][l] ^= X[c][l]; X[b][l] = CXPLAT_CHACHA20_ROTL(X[b][l], 12);
+        X[a][l] += X[b][l]; X[d][l] ^= X[a][l]; X[d][l] = CXPLAT_CHACHA20_ROTL(X[d][l], 8);
+        X[c][l] += X[d][l]; X[b][l] ^= X[c][l]; X[b][l] = CXPLAT_CHACHA20_ROTL(X[b][l], 7);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatChaCha20HpComputeMask(
+    _In_reads_(8) const uint32_t* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_bytes_(CXPLAT_HP_SAMPLE_LENGTH * BatchSize)
+        const uint8_t* const Cipher,
+    _Out_writes_bytes_(CXPLAT_HP_SAMPLE_LENGTH * BatchSize)
+        uint8_t* Mask
+    )
+{
+    static const uint32_t Sigma[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+
+    for (uint32_t Base = 0; Base < BatchSize; Base += CXPLAT_CHACHA20_HP_LANES) {
+        const uint32_t Count = CXPLAT_MIN(BatchSize - Base, CXPLAT_CHACHA20_HP_LANES);
+        uint32_t State[16][CXPLAT_CHACHA20_HP_LANES];
+        uint32_t X[16][CXPLAT_CHACHA20_HP_LANES];
+
+        //
+        // The first 4 bytes of the sample are the block counter and the
+        // remaining 12 bytes are the nonce. Unused lanes are zeroed and their
+        // output is discarded.
+        //
+        for (uint8_t l = 0; l < CXPLAT_CHACHA20_HP_LANES; ++l) {
+            for (uint8_t i = 0; i < 4; ++i) {
+                State[i][l] = Sigma[i];
+            }
+            for (uint8_t i = 0; i < 8; ++i) {
+                State[4 + i][l] = Key[i];
+            }
+            for (uint8_t i = 0; i < 4; ++i) {
+                State[12 + i][l] =
+                    l < Count ?
+                        CXPLAT_CHACHA20_LOAD32(Cipher + (Base + l) * CXPLAT_HP_SAMPLE_LENGTH + i * 4) :
+                        0;
+            }
+        }
+
+        CxPlatCopyMemory(X, State, sizeof(X));
+        for (uint8_t i = 0; i < 10; ++i) {
+            CxPlatChaCha20QuarterRound(X, 0, 4,  8, 12);
+            CxPlatChaCha20QuarterRound(X, 1, 5,  9, 13);
+            CxPlatChaCha20QuarterRound(X, 2, 6, 10, 14);
+            CxPlatChaCha20QuarterRound(X, 3, 7, 11, 15);
+            CxPlatChaCha20QuarterRound(X, 0, 5, 10, 15);
+            CxPlatChaCha20QuarterRound(X, 1, 6, 11, 12);
+            CxPlatChaCha20QuarterRound(X, 2, 7,  8, 13);
+            CxPlatChaCha20QuarterRound(X, 3, 4,  9, 14);
+        }
+
+        //
+        // Only the first 5 bytes of the key stream are used as the mask, but
+        // the whole first 16 bytes are written for each sample.
+        //
+        for (uint32_t l = 0; l < Count; ++l) {
+            uint8_t* Out = Mask + (Base + l) * CXPLAT_HP_SAMPLE_LENGTH;
+            for (uint8_t i = 0; i < 4; ++i) {
+                const uint32_t Word = X[i][l] + State[i][l];
+                Out[i * 4]     = (uint8_t)Word;
+                Out[i * 4 + 1] = (uint8_t)(Word >> 8);
+                Out[i * 4 + 2] = (uint8_t)(Word >> 16);
+                Out[i * 4 + 3] = (uint8_t)(Word >> 24);
+            }
+        }
+
+        CxPlatSecureZeroMemory(State, sizeof(State));
+        CxPlatSecureZeroMemory(X, sizeof(X));
+    }
+}
@@ -409,6 +409,25 @@ CxPlatKeyFree(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatKeyRekey(
+    _In_ CXPLAT_AEAD_TYPE AeadType,
+    _When_(AeadType == CXPLAT_AEAD_AES_128_GCM, _In_reads_(16))
+    _When_(AeadType == CXPLAT_AEAD_AES_256_GCM, _In_reads_(32))
+    _When_(AeadType == CXPLAT_AEAD_CHACHA20_POLY1305, _In_reads_(32))
+        const uint8_t* const RawKey,
+    _Inout_ CXPLAT_KEY** Key
+    )
+{
+    //
+    // BCrypt key objects are immutable, so the key is regenerated.
+    //
+    CxPlatKeyFree(*Key);
+    *Key = NULL;
+    return CxPlatKeyCreate(AeadType, RawKey, Key);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatEncrypt(
@@ -515,6 +534,109 @@ CxPlatDecrypt(
     return NtStatusToQuicStatus(Status);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_PACKET* Packets
+    )
+{
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        //
+        // BCryptEncrypt is only ever called once per packet here, so pull
+        // any external plaintext into the buffer first.
+        //
+        for (uint8_t j = 0; j < Packets[i].SegmentCount; ++j) {
+            const CXPLAT_CRYPT_SEGMENT* Segment = &Packets[i].Segments[j];
+            CxPlatCopyMemory(
+                Packets[i].Buffer + Segment->Offset,
+                Segment->Source,
+                Segment->Length);
+        }
+        QUIC_STATUS Status =
+            CxPlatEncrypt(
+                Key,
+                Packets[i].Iv,
+                Packets[i].AuthDataLength,
+                Packets[i].AuthData,
+                Packets[i].BufferLength,
+                Packets[i].Buffer);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_PACKET* Packets,
+    _Out_writes_(BatchSize)
+        QUIC_STATUS* Results
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        Results[i] =
+            CxPlatDecrypt(
+                Key,
+                Packets[i].Iv,
+                Packets[i].AuthDataLength,
+                Packets[i].AuthData,
+                Packets[i].BufferLength,
+                Packets[i].Buffer);
+        if (QUIC_FAILED(Results[i])) {
+            Status = Results[i];
+            continue;
+        }
+        //
+        // BCryptDecrypt is only ever called once per packet here, so push any
+        // external plaintext out of the buffer afterwards.
+        //
+        for (uint8_t j = 0; j < Packets[i].SegmentCount; ++j) {
+            const CXPLAT_CRYPT_SEGMENT* Segment = &Packets[i].Segments[j];
+            CxPlatCopyMemory(
+                Segment->Destination,
+                Packets[i].Buffer + Segment->Offset,
+                Segment->Length);
+        }
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptPrefix(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint16_t PrefixLength,
+    _In_reads_bytes_(PrefixLength)
+        const uint8_t* const Buffer,
+    _Out_writes_bytes_(PrefixLength)
+        uint8_t* Prefix
+    )
+{
+    //
+    // BCrypt can't decrypt part of an authenticated cipher text without
+    // chaining the whole operation.
+    //
+    UNREFERENCED_PARAMETER(Key);
+    UNREFERENCED_PARAMETER(Iv);
+    UNREFERENCED_PARAMETER(PrefixLength);
+    UNREFERENCED_PARAMETER(Buffer);
+    UNREFERENCED_PARAMETER(Prefix);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
@@ -622,6 +744,74 @@ CxPlatHpKeyFree(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatHpKeyRekey(
+    _In_ CXPLAT_AEAD_TYPE AeadType,
+    _When_(AeadType == CXPLAT_AEAD_AES_128_GCM, _In_reads_(16))
+    _When_(AeadType == CXPLAT_AEAD_AES_256_GCM, _In_reads_(32))
+    _When_(AeadType == CXPLAT_AEAD_CHACHA20_POLY1305, _In_reads_(32))
+        const uint8_t* const RawKey,
+    _Inout_ CXPLAT_HP_KEY** Key
+    )
+{
+    CXPLAT_HP_KEY* HpKey = *Key;
+    BCRYPT_ALG_HANDLE AlgHandle;
+    uint8_t KeyLength;
+
+    switch (AeadType) {
+    case CXPLAT_AEAD_AES_128_GCM:
+        KeyLength = 16;
+        AlgHandle = CXPLAT_AES_ECB_ALG_HANDLE;
+        break;
+    case CXPLAT_AEAD_AES_256_GCM:
+        KeyLength = 32;
+        AlgHandle = CXPLAT_AES_ECB_ALG_HANDLE;
+        break;
+    default:
+        //
+        // The ChaCha20 key carries extra mode info; just recreate it.
+        //
+        CxPlatHpKeyFree(HpKey);
+        *Key = NULL;
+        return CxPlatHpKeyCreate(AeadType, RawKey, Key);
+    }
+
+    if (HpKey->Aead != AeadType) {
+        CxPlatHpKeyFree(HpKey);
+        *Key = NULL;
+        return CxPlatHpKeyCreate(AeadType, RawKey, Key);
+    }
+
+    //
+    // BCrypt key objects are immutable, so only the key handle is regenerated;
+    // the CXPLAT_HP_KEY allocation is kept.
+    //
+    BCryptDestroyKey(HpKey->Key);
+    HpKey->Key = NULL;
+
+    NTSTATUS Status =
+        BCryptGenerateSymmetricKey(
+            AlgHandle,
+            &HpKey->Key,
+            NULL, // Let BCrypt manage the memory for this key.
+            0,
+            (uint8_t*)RawKey,
+            KeyLength,
+            0);
+    if (!NT_SUCCESS(Status)) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "BCryptGenerateSymmetricKey (ECB)");
+        CXPLAT_FREE(HpKey, QUIC_POOL_TLS_HP_KEY);
+        *Key = NULL;
+    }
+
+    return NtStatusToQuicStatus(Status);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpComputeMask(
@@ -124,6 +124,11 @@ CxPlatLoadHMACCTX(
 typedef struct CXPLAT_HP_KEY {
     EVP_CIPHER_CTX* CipherCtx;
     CXPLAT_AEAD_TYPE Aead;
+    //
+    // ChaCha20 masks are computed by the portable batch kernel rather than
+    // reinitializing the cipher context for every sample.
+    //
+    uint32_t ChaChaKey[8];
 } CXPLAT_HP_KEY;
 
 QUIC_STATUS
@@ -310,6 +315,34 @@ CxPlatKeyFree(
     EVP_CIPHER_CTX_free((EVP_CIPHER_CTX*)Key);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatKeyRekey(
+    _In_ CXPLAT_AEAD_TYPE AeadType,
+    _When_(AeadType == CXPLAT_AEAD_AES_128_GCM, _In_reads_(16))
+    _When_(AeadType == CXPLAT_AEAD_AES_256_GCM, _In_reads_(32))
+    _When_(AeadType == CXPLAT_AEAD_CHACHA20_POLY1305, _In_reads_(32))
+        const uint8_t* const RawKey,
+    _Inout_ CXPLAT_KEY** Key
+    )
+{
+    UNREFERENCED_PARAMETER(AeadType);
+
+    //
+    // Keep the cipher, IV length and direction; only the key schedule is
+    // recomputed, without reallocating the context.
+    //
+    if (EVP_CipherInit_ex2((EVP_CIPHER_CTX*)*Key, NULL, RawKey, NULL, -1, NULL) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_CipherInit_ex2 failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatEncrypt(
@@ -455,6 +488,314 @@ CxPlatDecrypt(
     return QUIC_STATUS_SUCCESS;
 }
 
+//
+// Encrypts a packet whose plaintext is partially held in external segments.
+// The AEAD is streamed over the payload in order, reading each range either
+// from the packet buffer (in place) or from the segment's source.
+//
+static
+QUIC_STATUS
+CxPlatEncryptSegments(
+    _In_ CXPLAT_KEY* Key,
+    _In_ const CXPLAT_CRYPT_PACKET* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(CXPLAT_ENCRYPTION_OVERHEAD <= Packet->BufferLength);
+
+    const uint16_t PlainTextLength = Packet->BufferLength - CXPLAT_ENCRYPTION_OVERHEAD;
+    uint8_t* Buffer = Packet->Buffer;
+    uint8_t *Tag = Buffer + PlainTextLength;
+    int OutLen;
+
+    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+    OSSL_PARAM AlgParam[2];
+
+    if (EVP_EncryptInit_ex(CipherCtx, NULL, NULL, NULL, Packet->Iv) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_EncryptInit_ex failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (Packet->AuthData != NULL &&
+        EVP_EncryptUpdate(
+            CipherCtx, NULL, &OutLen, Packet->AuthData, (int)Packet->AuthDataLength) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_EncryptUpdate (AD) failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    uint16_t Offset = 0;
+    for (uint8_t i = 0; i <= Packet->SegmentCount; ++i) {
+        const uint16_t End =
+            i < Packet->SegmentCount ? Packet->Segments[i].Offset : PlainTextLength;
+        CXPLAT_DBG_ASSERT(Offset <= End);
+        if (End > Offset &&
+            EVP_EncryptUpdate(
+                CipherCtx, Buffer + Offset, &OutLen, Buffer + Offset, (int)(End - Offset)) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_EncryptUpdate (Cipher) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+        if (i == Packet->SegmentCount) {
+            break;
+        }
+
+        const CXPLAT_CRYPT_SEGMENT* Segment = &Packet->Segments[i];
+        CXPLAT_DBG_ASSERT(Segment->Offset + Segment->Length <= PlainTextLength);
+        if (EVP_EncryptUpdate(
+                CipherCtx,
+                Buffer + Segment->Offset,
+                &OutLen,
+                Segment->Source,
+                (int)Segment->Length) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_EncryptUpdate (Cipher) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+        Offset = Segment->Offset + Segment->Length;
+    }
+
+    if (EVP_EncryptFinal_ex(CipherCtx, Tag, &OutLen) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_EncryptFinal_ex failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    AlgParam[0] = OSSL_PARAM_construct_octet_string("tag", Tag, CXPLAT_ENCRYPTION_OVERHEAD);
+    AlgParam[1] = OSSL_PARAM_construct_end();
+
+    if (EVP_CIPHER_CTX_get_params(CipherCtx, AlgParam) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_CIPHER_CTX_get_params (GET_TAG) failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Decrypts a packet whose plaintext is partially written to external segments.
+// The AEAD is streamed over the payload in order, writing each range either
+// to the packet buffer (in place) or to the segment's destination.
+//
+static
+QUIC_STATUS
+CxPlatDecryptSegments(
+    _In_ CXPLAT_KEY* Key,
+    _In_ const CXPLAT_CRYPT_PACKET* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(CXPLAT_ENCRYPTION_OVERHEAD <= Packet->BufferLength);
+
+    const uint16_t CipherTextLength = Packet->BufferLength - CXPLAT_ENCRYPTION_OVERHEAD;
+    uint8_t* Buffer = Packet->Buffer;
+    uint8_t *Tag = Buffer + CipherTextLength;
+    int OutLen;
+
+    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+    OSSL_PARAM AlgParam[2];
+
+    if (EVP_DecryptInit_ex(CipherCtx, NULL, NULL, NULL, Packet->Iv) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_DecryptInit_ex failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (Packet->AuthData != NULL &&
+        EVP_DecryptUpdate(
+            CipherCtx, NULL, &OutLen, Packet->AuthData, (int)Packet->AuthDataLength) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_DecryptUpdate (AD) failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    uint16_t Offset = 0;
+    for (uint8_t i = 0; i <= Packet->SegmentCount; ++i) {
+        const uint16_t End =
+            i < Packet->SegmentCount ? Packet->Segments[i].Offset : CipherTextLength;
+        CXPLAT_DBG_ASSERT(Offset <= End);
+        if (End > Offset &&
+            EVP_DecryptUpdate(
+                CipherCtx, Buffer + Offset, &OutLen, Buffer + Offset, (int)(End - Offset)) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_DecryptUpdate (Cipher) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+        if (i == Packet->SegmentCount) {
+            break;
+        }
+
+        const CXPLAT_CRYPT_SEGMENT* Segment = &Packet->Segments[i];
+        CXPLAT_DBG_ASSERT(Segment->Offset + Segment->Length <= CipherTextLength);
+        if (EVP_DecryptUpdate(
+                CipherCtx,
+                Segment->Destination,
+                &OutLen,
+                Buffer + Segment->Offset,
+                (int)Segment->Length) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_DecryptUpdate (Cipher) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+        Offset = Segment->Offset + Segment->Length;
+    }
+
+    AlgParam[0] = OSSL_PARAM_construct_octet_string("tag", Tag, CXPLAT_ENCRYPTION_OVERHEAD);
+    AlgParam[1] = OSSL_PARAM_construct_end();
+
+    if (EVP_CIPHER_CTX_set_params(CipherCtx, AlgParam) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_CIPHER_CTX_set_params (SET_TAG) failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (EVP_DecryptFinal_ex(CipherCtx, Tag, &OutLen) != 1) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "EVP_DecryptFinal_ex failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_PACKET* Packets
+    )
+{
+    //
+    // The cipher context already holds the expanded key schedule, so each
+    // packet only needs to reset the IV on it.
+    //
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        if (Packets[i].SegmentCount != 0) {
+            QUIC_STATUS Status = CxPlatEncryptSegments(Key, &Packets[i]);
+            if (QUIC_FAILED(Status)) {
+                return Status;
+            }
+            continue;
+        }
+        QUIC_STATUS Status =
+            CxPlatEncrypt(
+                Key,
+                Packets[i].Iv,
+                Packets[i].AuthDataLength,
+                Packets[i].AuthData,
+                Packets[i].BufferLength,
+                Packets[i].Buffer);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_PACKET* Packets,
+    _Out_writes_(BatchSize)
+        QUIC_STATUS* Results
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        if (Packets[i].SegmentCount != 0) {
+            Results[i] = CxPlatDecryptSegments(Key, &Packets[i]);
+            if (QUIC_FAILED(Results[i])) {
+                Status = Results[i];
+            }
+            continue;
+        }
+        Results[i] =
+            CxPlatDecrypt(
+                Key,
+                Packets[i].Iv,
+                Packets[i].AuthDataLength,
+                Packets[i].AuthData,
+                Packets[i].BufferLength,
+                Packets[i].Buffer);
+        if (QUIC_FAILED(Results[i])) {
+            Status = Results[i];
+        }
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptPrefix(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint16_t PrefixLength,
+    _In_reads_bytes_(PrefixLength)
+        const uint8_t* const Buffer,
+    _Out_writes_bytes_(PrefixLength)
+        uint8_t* Prefix
+    )
+{
+    int OutLen;
+    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+
+    //
+    // The AEAD's key stream doesn't depend on the authenticated data, so the
+    // start of the cipher text can be decrypted without it. The context is
+    // reinitialized by the next operation anyway.
+    //
+    if (EVP_DecryptInit_ex(CipherCtx, NULL, NULL, NULL, Iv) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_DecryptInit_ex failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (EVP_DecryptUpdate(CipherCtx, Prefix, &OutLen, Buffer, (int)PrefixLength) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_DecryptUpdate (Cipher) failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
@@ -504,6 +845,13 @@ CxPlatHpKeyCreate(
             goto Exit;
         }
         Aead = CXPLAT_CHACHA20_ALG_HANDLE;
+        for (uint8_t i = 0; i < ARRAYSIZE(Key->ChaChaKey); ++i) {
+            Key->ChaChaKey[i] =
+                (uint32_t)RawKey[i * 4] |
+                ((uint32_t)RawKey[i * 4 + 1] << 8) |
+                ((uint32_t)RawKey[i * 4 + 2] << 16) |
+                ((uint32_t)RawKey[i * 4 + 3] << 24);
+        }
         break;
     default:
         Status = QUIC_STATUS_NOT_SUPPORTED;
@@ -537,10 +885,51 @@ CxPlatHpKeyFree(
 {
     if (Key != NULL) {
         EVP_CIPHER_CTX_free(Key->CipherCtx);
+        CxPlatSecureZeroMemory(Key->ChaChaKey, sizeof(Key->ChaChaKey));
         CXPLAT_FREE(Key, QUIC_POOL_TLS_HP_KEY);
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatHpKeyRekey(
+    _In_ CXPLAT_AEAD_TYPE AeadType,
+    _When_(AeadType == CXPLAT_AEAD_AES_128_GCM, _In_reads_(16))
+    _When_(AeadType == CXPLAT_AEAD_AES_256_GCM, _In_reads_(32))
+    _When_(AeadType == CXPLAT_AEAD_CHACHA20_POLY1305, _In_reads_(32))
+        const uint8_t* const RawKey,
+    _Inout_ CXPLAT_HP_KEY** Key
+    )
+{
+    CXPLAT_HP_KEY* HpKey = *Key;
+
+    if (HpKey->Aead != AeadType) {
+        CxPlatHpKeyFree(HpKey);
+        *Key = NULL;
+        return CxPlatHpKeyCreate(AeadType, RawKey, Key);
+    }
+
+    if (AeadType == CXPLAT_AEAD_CHACHA20_POLY1305) {
+        for (uint8_t i = 0; i < ARRAYSIZE(HpKey->ChaChaKey); ++i) {
+            HpKey->ChaChaKey[i] =
+                (uint32_t)RawKey[i * 4] |
+                ((uint32_t)RawKey[i * 4 + 1] << 8) |
+                ((uint32_t)RawKey[i * 4 + 2] << 16) |
+                ((uint32_t)RawKey[i * 4 + 3] << 24);
+        }
+    }
+
+    if (EVP_EncryptInit_ex(HpKey->CipherCtx, NULL, NULL, RawKey, NULL) != 1) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_EncryptInit_ex failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpComputeMask(
@@ -554,24 +943,12 @@ CxPlatHpComputeMask(
 {
     int OutLen = 0;
     if (Key->Aead == CXPLAT_AEAD_CHACHA20_POLY1305) {
-        static const uint8_t Zero[] = { 0, 0, 0, 0, 0 };
-        for (uint32_t i = 0, Offset = 0; i < BatchSize; ++i, Offset += CXPLAT_HP_SAMPLE_LENGTH) {
-            if (EVP_EncryptInit_ex(Key->CipherCtx, NULL, NULL, NULL, Cipher + Offset) != 1) {
-                QuicTraceEvent(
-                    LibraryError,
-                    "[ lib] ERROR, %s.",
-                    "EVP_EncryptInit_ex (hp) failed");
-                return QUIC_STATUS_TLS_ERROR;
-            }
-            if (EVP_EncryptUpdate(Key->CipherCtx, Mask + Offset, &OutLen, Zero, sizeof(Zero)) != 1) {
-                QuicTraceEvent(
-                    LibraryError,
-                    "[ lib] ERROR, %s.",
-                    "EVP_EncryptUpdate (hp) failed");
-                return QUIC_STATUS_TLS_ERROR;
-            }
-        }
+        CxPlatChaCha20HpComputeMask(Key->ChaChaKey, BatchSize, Cipher, Mask);
     } else {
+        //
+        // A single ECB call over all the samples lets the AES-NI/VAES or
+        // ARMv8 crypto code in OpenSSL pipeline the blocks.
+        //
         if (EVP_EncryptUpdate(Key->CipherCtx, Mask, &OutLen, Cipher, CXPLAT_HP_SAMPLE_LENGTH * BatchSize) != 1) {
             QuicTraceEvent(
                 LibraryError,
@@ -591,9 +968,7 @@ CxPlatHpComputeMask(
 // OpenSSL 3.0 Hash implementation
 //
 typedef struct CXPLAT_HASH {
-    EVP_MAC_CTX* Ctx;
-    uint32_t SaltLength;
-    uint8_t Salt[0];
+    EVP_MAC_CTX* Ctx; // Keyed once, at creation.
 } CXPLAT_HASH;
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -610,20 +985,17 @@ CxPlatHashCreate(
     CXPLAT_HASH* Hash;
     EVP_MAC_CTX *hctx = NULL;
 
-    Hash = CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_HASH) + SaltLength, QUIC_POOL_TLS_HASH);
+    Hash = CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_HASH), QUIC_POOL_TLS_HASH);
     if (Hash == NULL) {
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
             "Crypt Hash Context",
-            sizeof(CXPLAT_HASH) + SaltLength);
+            sizeof(CXPLAT_HASH));
         Status = QUIC_STATUS_OUT_OF_MEMORY;
         goto Exit;
     }
-    CxPlatZeroMemory(Hash, sizeof(CXPLAT_HASH) + SaltLength);
-
-    Hash->SaltLength = SaltLength;
-    CxPlatCopyMemory(Hash->Salt, Salt, SaltLength);
+    CxPlatZeroMemory(Hash, sizeof(CXPLAT_HASH));
 
     switch (HashType) {
     case CXPLAT_HASH_SHA256:
@@ -651,6 +1023,20 @@ CxPlatHashCreate(
         goto Exit;
     }
 
+    //
+    // Key the context once, so that each compute only has to reset it to the
+    // precomputed inner and outer pads. A non-NULL key is required even when
+    // empty, since a NULL key means reuse the current one.
+    //
+    if (!EVP_MAC_init(Hash->Ctx, Salt != NULL ? Salt : (const uint8_t*)"", SaltLength, NULL)) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "EVP_MAC_init failed");
+        Status = QUIC_STATUS_INTERNAL_ERROR;
+        goto Exit;
+    }
+
     *NewHash = Hash;
     Hash = NULL;
 
@@ -685,7 +1071,7 @@ CxPlatHashCompute(
         uint8_t* const Output
     )
 {
-    if (!EVP_MAC_init(Hash->Ctx, Hash->Salt, Hash->SaltLength, NULL)) {
+    if (!EVP_MAC_init(Hash->Ctx, NULL, 0, NULL)) {
         QuicTraceEvent(
             LibraryError,
             "[ lib] ERROR, %s.",
@@ -80,6 +80,16 @@ typedef struct CXPLAT_SEND_DATA {
     //
     CXPLAT_LIST_ENTRY TxEntry;
 
+    //
+    // Entry in the socket's list of sends waiting on a zero-copy completion.
+    //
+    CXPLAT_LIST_ENTRY ZeroCopyEntry;
+
+    //
+    // The kernel's notification ID for this send, if sent zero-copy.
+    //
+    uint32_t ZeroCopyId;
+
     //
     // The local address to bind to.
     //
@@ -95,6 +105,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_BUFFER ClientBuffer;
 
+    //
+    // The earliest departure time (CLOCK_MONOTONIC, in microseconds) passed to
+    // the kernel with SCM_TXTIME. Zero to send immediately.
+    //
+    uint64_t TxTime;
+
     //
     // Total number of packet buffers allocated (and iovecs used if !GSO).
     //
@@ -127,6 +143,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     uint8_t SegmentationSupported : 1;
 
+    //
+    // Indicates the payload should be (or was) passed to the kernel without
+    // copying it.
+    //
+    uint8_t ZeroCopy : 1;
+
     //
     // Space for ancillary control data.
     //
@@ -136,6 +158,9 @@ typedef struct CXPLAT_SEND_DATA {
         CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
     #ifdef UDP_SEGMENT
         + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+    #ifdef SO_TXTIME
+        + CMSG_SPACE(sizeof(uint64_t))          // SCM_TXTIME
     #endif
         ];
     CXPLAT_STATIC_ASSERT(
@@ -163,7 +188,8 @@ typedef struct CXPLAT_SEND_DATA {
 
 typedef struct CXPLAT_RECV_MSG_CONTROL_BUFFER {
     char Data[CMSG_SPACE(sizeof(struct in6_pktinfo)) + // IP_PKTINFO
-              3 * CMSG_SPACE(sizeof(int))]; // TOS + IP_TTL
+              3 * CMSG_SPACE(sizeof(int)) + // TOS + IP_TTL
+              CMSG_SPACE(sizeof(struct scm_timestamping))]; // SO_TIMESTAMPING
 
 } CXPLAT_RECV_MSG_CONTROL_BUFFER;
 
@@ -183,8 +209,37 @@ CxPlatProcessorContextInitialize(
     DatapathPartition->PartitionIndex = PartitionIndex;
     DatapathPartition->EventQ = CxPlatWorkerPoolGetEventQ(Datapath->WorkerPool, PartitionIndex);
     CxPlatRefInitialize(&DatapathPartition->RefCount);
-    CxPlatPoolInitialize(TRUE, Datapath->RecvBlockSize, QUIC_POOL_DATA, &DatapathPartition->RecvBlockPool);
-    CxPlatPoolInitialize(TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    if (Datapath->HugePages) {
+        CxPlatPoolInitializeHugePages(Datapath->RecvBlockSize, QUIC_POOL_DATA, &DatapathPartition->RecvBlockPool);
+        CxPlatPoolInitializeHugePages(Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    } else {
+        CxPlatPoolInitialize(TRUE, Datapath->RecvBlockSize, QUIC_POOL_DATA, &DatapathPartition->RecvBlockPool);
+        CxPlatPoolInitialize(TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    }
+}
+
+//
+// Best effort; the pools just grow on demand from wherever this stopped.
+//
+static
+void
+CxPlatProcessorContextReservePools(
+    _Inout_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _In_ uint32_t Count
+    )
+{
+    const uint16_t NumaNode =
+        CxPlatProcNumaNode(
+            CxPlatWorkerPoolGetIdealProcessor(
+                DatapathPartition->Datapath->WorkerPool,
+                DatapathPartition->PartitionIndex));
+    if (QUIC_FAILED(CxPlatPoolReserve(&DatapathPartition->RecvBlockPool, Count, NumaNode)) ||
+        QUIC_FAILED(CxPlatPoolReserve(&DatapathPartition->SendBlockPool, Count, NumaNode))) {
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "CxPlatPoolReserve failed");
+    }
 }
 
 QUIC_STATUS
@@ -198,7 +253,6 @@ DataPathInitialize(
     )
 {
     UNREFERENCED_PARAMETER(TcpCallbacks);
-    UNREFERENCED_PARAMETER(InitConfig);
 
     if (NewDatapath == NULL) {
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -249,6 +303,25 @@ DataPathInitialize(
     CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
     CxPlatDataPathCalculateFeatureSupport(Datapath);
 
+#ifdef SO_ZEROCOPY
+    //
+    // Zero-copy only pays off for large GSO batches, so it's only offered
+    // alongside send segmentation.
+    //
+    if (InitConfig->EnableZeroCopySend &&
+        Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_ZEROCOPY;
+    }
+#endif
+
+#ifdef SO_TXTIME
+    if (InitConfig->EnableTxTimePacing) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+    }
+#endif
+
+    Datapath->HugePages = InitConfig->EnableHugePages;
+
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
         Datapath->SendDataSize = sizeof(CXPLAT_SEND_DATA);
         Datapath->SendIoVecCount = 1;
@@ -264,7 +337,7 @@ DataPathInitialize(
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
         Datapath->RecvBlockBufferOffset =
             ALIGN_UP_BY(
-                sizeof(DATAPATH_RX_IO_BLOCK) + CXPLAT_MAX_IO_BATCH_SIZE * Datapath->RecvBlockStride,
+                sizeof(DATAPATH_RX_IO_BLOCK) + CXPLAT_MAX_RECV_PACKET_COUNT * Datapath->RecvBlockStride,
                 CXPLAT_MEMORY_ALIGNMENT);
         Datapath->RecvBlockSize =
             ALIGN_UP_BY(
@@ -287,6 +360,10 @@ DataPathInitialize(
     for (uint32_t i = 0; i < Datapath->PartitionCount; i++) {
         CxPlatProcessorContextInitialize(
             Datapath, i, &Datapath->Partitions[i]);
+        if (InitConfig->PoolReserveCount != 0) {
+            CxPlatProcessorContextReservePools(
+                &Datapath->Partitions[i], InitConfig->PoolReserveCount);
+        }
     }
 
     CXPLAT_FRE_ASSERT(CxPlatWorkerPoolAddRef(WorkerPool, CXPLAT_WORKER_POOL_REF_EPOLL));
@@ -355,6 +432,46 @@ DataPathUninitialize(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+DataPathUpdatePollingIdleTimeout(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ uint32_t PollingIdleTimeoutUs
+    )
+{
+    //
+    // Sockets pick up the busy-poll settings when they are created. The event
+    // queues are updated immediately so that epoll_wait on each worker spins
+    // on the device queues of its sockets instead of sleeping until the next
+    // interrupt.
+    //
+    Datapath->BusyPollUs = PollingIdleTimeoutUs;
+
+#ifdef EPIOCSPARAMS
+    struct epoll_params Params = {0};
+    Params.busy_poll_usecs = PollingIdleTimeoutUs;
+    Params.busy_poll_budget = PollingIdleTimeoutUs != 0 ? CXPLAT_BUSY_POLL_BUDGET : 0;
+    Params.prefer_busy_poll = PollingIdleTimeoutUs != 0;
+
+    const uint16_t PartitionCount = Datapath->PartitionCount;
+    for (uint32_t i = 0; i < PartitionCount; i++) {
+        if (ioctl(*Datapath->Partitions[i].EventQ, EPIOCSPARAMS, &Params) == SOCKET_ERROR) {
+            //
+            // Older kernels don't support per-epoll busy polling; the socket
+            // options below still apply.
+            //
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                Datapath,
+                errno,
+                "ioctl(EPIOCSPARAMS) failed");
+            break;
+        }
+    }
+#endif // EPIOCSPARAMS
+}
+
 QUIC_STATUS
 CxPlatSocketContextSqeInitialize(
     _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext
@@ -695,6 +812,87 @@ CxPlatSocketContextInitialize(
         }
     #endif
 
+    #ifdef SO_ZEROCOPY
+        if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_ZEROCOPY) {
+            //
+            // Failure here isn't fatal; sends on this socket are just copied.
+            //
+            Option = TRUE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_ZEROCOPY,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_ZEROCOPY) failed");
+            } else {
+                SocketContext->ZeroCopyEnabled = TRUE;
+            }
+        }
+    #endif
+
+    #ifdef SO_TIMESTAMPING
+        if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS) {
+            //
+            // Failure here isn't fatal; packets are just timestamped when the
+            // worker processes them. Hardware timestamps are only reported if
+            // the NIC has been configured for them (SIOCSHWTSTAMP).
+            //
+            Option =
+                SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TIMESTAMPING,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_TIMESTAMPING) failed");
+            }
+        }
+    #endif
+
+    #ifdef SO_TXTIME
+        if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME) {
+            //
+            // Failure here isn't fatal; departure times are just dropped and
+            // sends on this socket go out immediately.
+            //
+            struct sock_txtime TxTimeConfig = { CLOCK_MONOTONIC, 0 };
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TXTIME,
+                    (const void*)&TxTimeConfig,
+                    sizeof(TxTimeConfig));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_TXTIME) failed");
+            } else {
+                SocketContext->TxTimeEnabled = TRUE;
+            }
+        }
+    #endif
+
         //
         // The socket is shared by multiple QUIC endpoints, so increase the receive
         // buffer size.
@@ -718,6 +916,65 @@ CxPlatSocketContextInitialize(
             goto Exit;
         }
 
+    #ifdef SO_PREFER_BUSY_POLL
+        if (Datapath->BusyPollUs != 0) {
+            //
+            // Failure here isn't fatal; raising the busy-poll time or budget
+            // above the system default requires CAP_NET_ADMIN, in which case
+            // the socket falls back to interrupt driven receives.
+            //
+            Option = (int)Datapath->BusyPollUs;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_BUSY_POLL,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_BUSY_POLL) failed");
+            } else {
+                Option = TRUE;
+                Result =
+                    setsockopt(
+                        SocketContext->SocketFd,
+                        SOL_SOCKET,
+                        SO_PREFER_BUSY_POLL,
+                        (const void*)&Option,
+                        sizeof(Option));
+                if (Result == SOCKET_ERROR) {
+                    QuicTraceEvent(
+                        DatapathErrorStatus,
+                        "[data][%p] ERROR, %u, %s.",
+                        Binding,
+                        errno,
+                        "setsockopt(SO_PREFER_BUSY_POLL) failed");
+                }
+                Option = CXPLAT_BUSY_POLL_BUDGET;
+                Result =
+                    setsockopt(
+                        SocketContext->SocketFd,
+                        SOL_SOCKET,
+                        SO_BUSY_POLL_BUDGET,
+                        (const void*)&Option,
+                        sizeof(Option));
+                if (Result == SOCKET_ERROR) {
+                    QuicTraceEvent(
+                        DatapathErrorStatus,
+                        "[data][%p] ERROR, %u, %s.",
+                        Binding,
+                        errno,
+                        "setsockopt(SO_BUSY_POLL_BUDGET) failed");
+                }
+            }
+        }
+    #endif
+
         //
         // Only set SO_REUSEPORT on a server socket, otherwise the client could be
         // assigned a server port (unless it's forcing sharing).
@@ -945,6 +1202,13 @@ CxPlatSocketRelease(
     }
 }
 
+#ifdef SO_ZEROCOPY
+void
+CxPlatSocketWaitForZeroCopyCompletions(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    );
+#endif
+
 void
 CxPlatSocketContextUninitializeComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
@@ -955,6 +1219,19 @@ CxPlatSocketContextUninitializeComplete(
     SocketContext->Freed = TRUE;
 #endif
 
+#ifdef SO_ZEROCOPY
+    //
+    // The kernel keeps reading the payload of a MSG_ZEROCOPY send from our
+    // buffer until it posts the send's completion on the socket's error queue.
+    // Those completions are lost once the socket is closed, so collect them
+    // first; a send is only freed after its completion has been seen.
+    //
+    if (SocketContext->SocketFd != INVALID_SOCKET &&
+        !CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+        CxPlatSocketWaitForZeroCopyCompletions(SocketContext);
+    }
+#endif
+
     while (!CxPlatListIsEmpty(&SocketContext->TxQueue)) {
         CxPlatSendDataFree(
             CXPLAT_CONTAINING_RECORD(
@@ -963,6 +1240,19 @@ CxPlatSocketContextUninitializeComplete(
                 TxEntry));
     }
 
+    //
+    // Anything left timed out waiting for its completion. The kernel still
+    // holds references on the pages, so freeing can only change the bytes of
+    // a packet stuck in a device queue, not corrupt memory.
+    //
+    while (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+        CxPlatSendDataFree(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&SocketContext->ZeroCopyQueue),
+                CXPLAT_SEND_DATA,
+                ZeroCopyEntry));
+    }
+
     CXPLAT_DBG_ASSERT(SocketContext->AcceptSocket == NULL);
 
     if (SocketContext->SocketFd != INVALID_SOCKET) {
@@ -1134,6 +1424,7 @@ SocketCreateUdp(
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
+        CxPlatListInitializeHead(&Binding->SocketContexts[i].ZeroCopyQueue);
         CxPlatLockInitialize(&Binding->SocketContexts[i].TxQueueLock);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
@@ -1152,12 +1443,18 @@ SocketCreateUdp(
 
     if (!IsPartitioned) {
         //
-        // The return value is being ignored here, as if a system does not support
+        // Prefer steering by the partition encoded in the CID, so packets land
+        // on the socket of the partition owning the connection. Otherwise, the
+        // return value is being ignored here, as if a system does not support
         // bpf we still want the server to work. If this happens, the sockets will
         // round robin, but each flow will be sent to the same socket, just not
         // based on RSS.
         //
-        (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        if (QUIC_FAILED(
+                CxPlatSocketConfigureCidSteering(
+                    &Binding->SocketContexts[0], SocketCount, Config))) {
+            (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        }
     }
 
     CxPlatConvertFromMappedV6(&Binding->LocalAddress, &Binding->LocalAddress);
@@ -1264,6 +1561,7 @@ CxPlatSocketCreateTcpInternal(
     SocketContext->Binding = Binding;
     SocketContext->SocketFd = INVALID_SOCKET;
     CxPlatListInitializeHead(&SocketContext->TxQueue);
+    CxPlatListInitializeHead(&SocketContext->ZeroCopyQueue);
     CxPlatLockInitialize(&SocketContext->TxQueueLock);
     CxPlatRundownInitialize(&SocketContext->UpcallRundown);
 
@@ -1430,6 +1728,7 @@ SocketCreateTcpListener(
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
+        CxPlatListInitializeHead(&Binding->SocketContexts[i].ZeroCopyQueue);
         CxPlatLockInitialize(&Binding->SocketContexts[i].TxQueueLock);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
@@ -1585,6 +1884,127 @@ CxPlatSocketHandleErrors(
     }
 }
 
+#ifdef SO_ZEROCOPY
+//
+// Drains the socket error queue of MSG_ZEROCOPY completion notifications and
+// frees the sends the kernel no longer references.
+//
+void
+CxPlatSocketProcessZeroCopyCompletions(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    char Control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    CXPLAT_LIST_ENTRY Completed;
+    CxPlatListInitializeHead(&Completed);
+
+    while (TRUE) {
+        struct msghdr Msg = {0};
+        Msg.msg_control = Control;
+        Msg.msg_controllen = sizeof(Control);
+        if (recvmsg(SocketContext->SocketFd, &Msg, MSG_ERRQUEUE) < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    SocketContext->Binding,
+                    errno,
+                    "recvmsg(MSG_ERRQUEUE) failed");
+            }
+            break;
+        }
+
+        for (struct cmsghdr* CMsg = CMSG_FIRSTHDR(&Msg); CMsg != NULL; CMsg = CMSG_NXTHDR(&Msg, CMsg)) {
+            if (!((CMsg->cmsg_level == SOL_IP && CMsg->cmsg_type == IP_RECVERR) ||
+                  (CMsg->cmsg_level == SOL_IPV6 && CMsg->cmsg_type == IPV6_RECVERR))) {
+                continue;
+            }
+            CXPLAT_DBG_ASSERT_CMSG(CMsg, struct sock_extended_err);
+            const struct sock_extended_err* Err = (struct sock_extended_err*)CMSG_DATA(CMsg);
+            if (Err->ee_errno != 0 || Err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            if (Err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                //
+                // The kernel had to fall back to copying (e.g. the route's
+                // device can't do scatter/gather), so there's nothing to gain
+                // from pinning pages on this socket.
+                //
+                SocketContext->ZeroCopyEnabled = FALSE;
+            }
+
+            //
+            // The notification covers the inclusive ID range [ee_info, ee_data].
+            //
+            const uint32_t First = Err->ee_info;
+            const uint32_t Count = Err->ee_data - First;
+            CxPlatLockAcquire(&SocketContext->TxQueueLock);
+            CXPLAT_LIST_ENTRY* Entry = SocketContext->ZeroCopyQueue.Flink;
+            while (Entry != &SocketContext->ZeroCopyQueue) {
+                CXPLAT_SEND_DATA* SendData =
+                    CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_SEND_DATA, ZeroCopyEntry);
+                Entry = Entry->Flink;
+                if (SendData->ZeroCopyId - First <= Count) {
+                    CxPlatListEntryRemove(&SendData->ZeroCopyEntry);
+                    CxPlatListInsertTail(&Completed, &SendData->ZeroCopyEntry);
+                }
+            }
+            CxPlatLockRelease(&SocketContext->TxQueueLock);
+        }
+    }
+
+    while (!CxPlatListIsEmpty(&Completed)) {
+        CxPlatSendDataFree(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Completed),
+                CXPLAT_SEND_DATA,
+                ZeroCopyEntry));
+    }
+}
+
+//
+// Called as the socket is closed, after all upcalls have completed, to wait for
+// the completions of the zero-copy sends still outstanding.
+//
+void
+CxPlatSocketWaitForZeroCopyCompletions(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    const uint64_t StartTime = CxPlatTimeMs64();
+    CxPlatSocketProcessZeroCopyCompletions(SocketContext);
+    while (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+        const uint64_t Elapsed = CxPlatTimeDiff64(StartTime, CxPlatTimeMs64());
+        if (Elapsed >= CXPLAT_ZEROCOPY_CLOSE_TIMEOUT_MS) {
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                SocketContext->Binding,
+                ETIMEDOUT,
+                "zero-copy send completions");
+            break;
+        }
+
+        //
+        // Pending error queue entries are reported as POLLERR.
+        //
+        struct pollfd PollFd = { SocketContext->SocketFd, 0, 0 };
+        if (poll(&PollFd, 1, (int)(CXPLAT_ZEROCOPY_CLOSE_TIMEOUT_MS - Elapsed)) < 0 &&
+            errno != EINTR) {
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                SocketContext->Binding,
+                errno,
+                "poll");
+            break;
+        }
+        CxPlatSocketProcessZeroCopyCompletions(SocketContext);
+    }
+}
+#endif // SO_ZEROCOPY
+
 void
 CxPlatSocketContextRecvComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -1606,6 +2026,7 @@ CxPlatSocketContextRecvComplete(
         uint8_t TOS = 0;
         int HopLimitTTL = 0;
         uint16_t SegmentLength = 0;
+        uint64_t RecvTime = 0;
         BOOLEAN FoundLocalAddr = FALSE, FoundTOS = FALSE, FoundTTL = FALSE;
         QUIC_ADDR* LocalAddr = &IoBlock->Route.LocalAddress;
         QUIC_ADDR* RemoteAddr = &IoBlock->Route.RemoteAddress;
@@ -1614,7 +2035,8 @@ CxPlatSocketContextRecvComplete(
 
         //
         // Process the ancillary control messages to get the local address,
-        // type of service and possibly the GRO segmentation length.
+        // type of service, receive timestamp and possibly the GRO segmentation
+        // length.
         //
         struct msghdr* Msg = &RecvMsgHdr[CurrentMessage].msg_hdr;
         for (struct cmsghdr *CMsg = CMSG_FIRSTHDR(Msg); CMsg != NULL; CMsg = CMSG_NXTHDR(Msg, CMsg)) {
@@ -1659,6 +2081,11 @@ CxPlatSocketContextRecvComplete(
                     SegmentLength = *(uint16_t*)CMSG_DATA(CMsg);
                 }
 #endif
+            } else if (CMsg->cmsg_level == SOL_SOCKET) {
+                if (CMsg->cmsg_type == SCM_TIMESTAMPING) {
+                    CXPLAT_DBG_ASSERT_CMSG(CMsg, struct scm_timestamping);
+                    RecvTime = CxPlatSocketGetRecvTimestamp(CMsg);
+                }
             } else {
                 CXPLAT_DBG_ASSERT(FALSE);
             }
@@ -1691,7 +2118,7 @@ CxPlatSocketContextRecvComplete(
         //
         uint32_t Offset = 0;
         while (Offset < RecvMsgHdr[CurrentMessage].msg_len &&
-               IoBlock->RefCount < CXPLAT_MAX_IO_BATCH_SIZE) {
+               IoBlock->RefCount < CXPLAT_MAX_RECV_PACKET_COUNT) {
             IoBlock->RefCount++;
             Datagram->IoBlock = IoBlock;
 
@@ -1707,6 +2134,7 @@ CxPlatSocketContextRecvComplete(
             RecvData->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
             RecvData->TypeOfService = TOS;
             RecvData->HopLimitTTL = (uint8_t)HopLimitTTL;
+            RecvData->RecvTime = RecvTime;
             RecvData->Allocated = TRUE;
             RecvData->Route->DatapathType = RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             RecvData->QueuedOnConnection = FALSE;
@@ -1955,6 +2383,7 @@ CxPlatSocketReceiveTcpData(
             Data->Route = &IoBlock->Route;
             Data->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
             Data->TypeOfService = 0;
+            Data->RecvTime = 0;
             Data->Allocated = TRUE;
             Data->Route->DatapathType = Data->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             Data->QueuedOnConnection = FALSE;
@@ -1997,11 +2426,22 @@ RecvDataReturn(
 {
     CXPLAT_RECV_DATA* Datagram;
     while ((Datagram = RecvDataChain) != NULL) {
-        RecvDataChain = RecvDataChain->Next;
-        DATAPATH_RX_PACKET* Packet =
-            CXPLAT_CONTAINING_RECORD(Datagram, DATAPATH_RX_PACKET, Data);
-        if (InterlockedDecrement(&Packet->IoBlock->RefCount) == 0) {
-            CxPlatPoolFree(Packet->IoBlock);
+        DATAPATH_RX_IO_BLOCK* IoBlock =
+            CXPLAT_CONTAINING_RECORD(Datagram, DATAPATH_RX_PACKET, Data)->IoBlock;
+
+        //
+        // Datagrams from the same block are usually returned next to each
+        // other, so drop all of their references with a single atomic.
+        //
+        long Count = 0;
+        do {
+            RecvDataChain = RecvDataChain->Next;
+            ++Count;
+        } while (RecvDataChain != NULL &&
+                 CXPLAT_CONTAINING_RECORD(RecvDataChain, DATAPATH_RX_PACKET, Data)->IoBlock == IoBlock);
+
+        if (InterlockedExchangeAdd(&IoBlock->RefCount, -Count) == Count) {
+            CxPlatPoolFree(IoBlock);
         }
     }
 }
@@ -2043,10 +2483,12 @@ SendDataAlloc(
         SendData->ControlBufferLength = 0;
         SendData->ECN = Config->ECN;
         SendData->DSCP = Config->DSCP;
+        SendData->TxTime = SocketContext->TxTimeEnabled ? Config->TxTime : 0;
         SendData->Flags = Config->Flags;
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
             !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->ZeroCopy = FALSE;
         SendData->Iovs[0].iov_len = 0;
         SendData->Iovs[0].iov_base = SendData->Buffer;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
@@ -2154,11 +2596,12 @@ SendDataIsFull(
 
 QUIC_STATUS
 CxPlatSendDataSend(
-    _In_ CXPLAT_SEND_DATA* SendData
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _Out_ BOOLEAN* ZeroCopyPending
     );
 
 void
-SocketSend(
+CxPlatSendDataPrepare(
     _In_ CXPLAT_SOCKET* Socket,
     _In_ const CXPLAT_ROUTE* Route,
     _In_ CXPLAT_SEND_DATA* SendData
@@ -2186,11 +2629,25 @@ SocketSend(
     CxPlatConvertToMappedV6(&Route->RemoteAddress, &SendData->RemoteAddress);
     SendData->LocalAddress = Route->LocalAddress;
 
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    SendData->ZeroCopy =
+        SocketContext->ZeroCopyEnabled &&
+        SendData->SegmentationSupported &&
+        SendData->TotalSize >= CXPLAT_ZEROCOPY_SEND_THRESHOLD;
+}
+
+void
+CxPlatSocketSendPrepared(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+
     //
     // Check to see if we need to pend because there's already queue.
     //
     BOOLEAN SendPending = FALSE, FlushTxQueue = FALSE;
-    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
     CxPlatLockAcquire(&SocketContext->TxQueueLock);
     if (/*SendData->Flags & CXPLAT_SEND_FLAGS_MAX_THROUGHPUT ||*/
         !CxPlatListIsEmpty(&SocketContext->TxQueue)) {
@@ -2212,7 +2669,8 @@ SocketSend(
     //
     // Go ahead and try to send on the socket.
     //
-    QUIC_STATUS Status = CxPlatSendDataSend(SendData);
+    BOOLEAN ZeroCopyPending;
+    QUIC_STATUS Status = CxPlatSendDataSend(SendData, &ZeroCopyPending);
     if (Status == QUIC_STATUS_PENDING) {
         //
         // Couldn't send right now, so queue up the send and wait for send
@@ -2230,10 +2688,23 @@ SocketSend(
                 Status,
                 SendData->TotalSize);
         }
-        CxPlatSendDataFree(SendData);
+        if (!ZeroCopyPending) {
+            CxPlatSendDataFree(SendData);
+        }
     }
 }
 
+void
+SocketSend(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CxPlatSendDataPrepare(Socket, Route, SendData);
+    CxPlatSocketSendPrepared(Socket, SendData);
+}
+
 //
 // This is defined and used instead of CMSG_NXTHDR because (1) we've already
 // done the work to ensure the necessary space is available and (2) CMSG_NXTHDR
@@ -2293,15 +2764,28 @@ CxPlatSendDataPopulateAncillaryData(
     }
 #endif
 
+#ifdef SO_TXTIME
+    if (SendData->TxTime != 0) {
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *((uint64_t*)CMSG_DATA(CMsg)) = US_TO_NS(SendData->TxTime);
+    }
+#endif
+
     CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
 
 BOOLEAN
 CxPlatSendDataSendSegmented(
-    _In_ CXPLAT_SEND_DATA* SendData
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _Out_ BOOLEAN* ZeroCopyPending
     )
 {
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
     struct msghdr msghdr;
     msghdr.msg_name = (void*)&SendData->RemoteAddress;
     msghdr.msg_namelen = sizeof(SendData->RemoteAddress);
@@ -2316,7 +2800,39 @@ CxPlatSendDataSendSegmented(
         msghdr.msg_controllen = SendData->ControlBufferLength;
     }
 
-    if (sendmsg(SendData->SocketContext->SocketFd, &msghdr, 0) < 0) {
+    *ZeroCopyPending = FALSE;
+
+#ifdef SO_ZEROCOPY
+    if (SendData->ZeroCopy) {
+        //
+        // The kernel numbers zero-copy sends sequentially per socket, so the
+        // send and the ID assignment must happen atomically. Ownership of the
+        // send data passes to the zero-copy queue until the completion
+        // notification arrives on the error queue.
+        //
+        BOOLEAN Success = TRUE;
+        CxPlatLockAcquire(&SocketContext->TxQueueLock);
+        if (sendmsg(SocketContext->SocketFd, &msghdr, MSG_ZEROCOPY) >= 0) {
+            SendData->ZeroCopyId = SocketContext->ZeroCopyNextId++;
+            CxPlatListInsertTail(&SocketContext->ZeroCopyQueue, &SendData->ZeroCopyEntry);
+            *ZeroCopyPending = TRUE;
+        } else if (errno != ENOBUFS) {
+            Success = FALSE;
+        }
+        CxPlatLockRelease(&SocketContext->TxQueueLock);
+        if (*ZeroCopyPending || !Success) {
+            return Success;
+        }
+
+        //
+        // ENOBUFS means the socket's pinned page budget (optmem) is exhausted;
+        // fall back to a copying send.
+        //
+        SendData->ZeroCopy = FALSE;
+    }
+#endif
+
+    if (sendmsg(SocketContext->SocketFd, &msghdr, 0) < 0) {
         return FALSE;
     }
 
@@ -2391,6 +2907,109 @@ CxPlatSendDataSendMessages(
     return TRUE;
 }
 
+//
+// Returns TRUE if the (prepared) send data goes out as a single message, so
+// that it can share a sendmmsg call with other send data.
+//
+static
+BOOLEAN
+CxPlatSendDataIsSingleMessage(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ const CXPLAT_SEND_DATA* SendData
+    )
+{
+    return
+        Socket->Type == CXPLAT_SOCKET_UDP &&
+        !SendData->ZeroCopy &&
+        SendData->AlreadySentCount == 0 &&
+#ifdef UDP_SEGMENT
+        (SendData->SegmentationSupported || SendData->BufferCount == 1);
+#else
+        SendData->BufferCount == 1;
+#endif
+}
+
+void
+SocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    struct mmsghdr Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        CxPlatSendDataPrepare(Socket, &Routes[i], SendData[i]);
+    }
+
+    uint32_t Index = 0;
+    while (Index < Count) {
+        CXPLAT_SOCKET_CONTEXT* SocketContext = SendData[Index]->SocketContext;
+
+        //
+        // Collect a run of single message sends on the same socket context.
+        // Anything queued behind an already pending send keeps that order.
+        //
+        CxPlatLockAcquire(&SocketContext->TxQueueLock);
+        BOOLEAN TxQueueEmpty = CxPlatListIsEmpty(&SocketContext->TxQueue);
+        CxPlatLockRelease(&SocketContext->TxQueueLock);
+
+        uint32_t RunCount = 0;
+        while (TxQueueEmpty &&
+               Index + RunCount < Count &&
+               RunCount < CXPLAT_MAX_IO_BATCH_SIZE &&
+               SendData[Index + RunCount]->SocketContext == SocketContext &&
+               CxPlatSendDataIsSingleMessage(Socket, SendData[Index + RunCount])) {
+            CXPLAT_SEND_DATA* Send = SendData[Index + RunCount];
+            struct msghdr* Mhdr = &Mhdrs[RunCount].msg_hdr;
+            Mhdrs[RunCount].msg_len = 0;
+            Mhdr->msg_name = (void*)&Send->RemoteAddress;
+            Mhdr->msg_namelen = sizeof(Send->RemoteAddress);
+            Mhdr->msg_iov = Send->Iovs;
+            Mhdr->msg_iovlen = 1;
+            Mhdr->msg_flags = 0;
+            Mhdr->msg_control = Send->ControlBuffer;
+            Mhdr->msg_controllen = Send->ControlBufferLength;
+            if (Send->ControlBufferLength == 0) {
+                CxPlatSendDataPopulateAncillaryData(Send, Mhdr);
+            }
+            RunCount++;
+        }
+
+        if (RunCount < 2) {
+            //
+            // Nothing to amortize; take the regular (queueing, zero-copy,
+            // multi-message) path.
+            //
+            CxPlatSocketSendPrepared(Socket, SendData[Index]);
+            Index++;
+            continue;
+        }
+
+        int SentCount =
+            cxplat_sendmmsg(SocketContext->SocketFd, Mhdrs, RunCount, 0);
+        if (SentCount < 0) {
+            SentCount = 0;
+        }
+
+        for (int i = 0; i < SentCount; ++i) {
+            CxPlatSendDataFree(SendData[Index + i]);
+        }
+        Index += (uint32_t)SentCount;
+
+        if ((uint32_t)SentCount < RunCount) {
+            //
+            // The socket stopped accepting messages part way through. Let the
+            // regular path retry the next send so it can report the error or
+            // queue it (and everything after it) for EPOLLOUT.
+            //
+            CxPlatSocketSendPrepared(Socket, SendData[Index]);
+            Index++;
+        }
+    }
+}
+
 BOOLEAN
 CxPlatSendDataSendTcp(
     _In_ CXPLAT_SEND_DATA* SendData
@@ -2414,7 +3033,8 @@ CxPlatSendDataSendTcp(
 
 QUIC_STATUS
 CxPlatSendDataSend(
-    _In_ CXPLAT_SEND_DATA* SendData
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _Out_ BOOLEAN* ZeroCopyPending
     )
 {
     CXPLAT_DBG_ASSERT(SendData != NULL);
@@ -2425,11 +3045,13 @@ CxPlatSendDataSend(
     CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
     BOOLEAN Success;
 
+    *ZeroCopyPending = FALSE;
     if (SocketType == CXPLAT_SOCKET_UDP) {
         Success =
 #ifdef UDP_SEGMENT
             SendData->SegmentationSupported ?
-                CxPlatSendDataSendSegmented(SendData) : CxPlatSendDataSendMessages(SendData);
+                CxPlatSendDataSendSegmented(SendData, ZeroCopyPending) :
+                CxPlatSendDataSendMessages(SendData);
 #else
             CxPlatSendDataSendMessages(SendData);
 #endif
@@ -2524,7 +3146,8 @@ CxPlatSocketContextFlushTxQueue(
     CxPlatLockRelease(&SocketContext->TxQueueLock);
 
     while (SendData != NULL) {
-        QUIC_STATUS Status = CxPlatSendDataSend(SendData);
+        BOOLEAN ZeroCopyPending;
+        QUIC_STATUS Status = CxPlatSendDataSend(SendData, &ZeroCopyPending);
         if (Status == QUIC_STATUS_PENDING) {
             if (!SendAlreadyPending) {
                 //
@@ -2544,7 +3167,9 @@ CxPlatSocketContextFlushTxQueue(
                 Status,
                 SendData->TotalSize);
         }
-        CxPlatSendDataFree(SendData);
+        if (!ZeroCopyPending) {
+            CxPlatSendDataFree(SendData);
+        }
         if (!CxPlatListIsEmpty(&SocketContext->TxQueue)) {
             SendData =
                 CXPLAT_CONTAINING_RECORD(
@@ -2597,6 +3222,11 @@ CxPlatSocketContextIoEventComplete(
 
     if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
         if (EPOLLERR & Cqe->events) {
+#ifdef SO_ZEROCOPY
+            if (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+                CxPlatSocketProcessZeroCopyCompletions(SocketContext);
+            }
+#endif
             CxPlatSocketHandleErrors(SocketContext);
         }
         if (EPOLLIN & Cqe->events) {
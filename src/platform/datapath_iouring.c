@@ -128,6 +128,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_BUFFER ClientBuffer;
 
+    //
+    // The earliest departure time (CLOCK_MONOTONIC, in microseconds) passed to
+    // the kernel with SCM_TXTIME. Zero to send immediately.
+    //
+    uint64_t TxTime;
+
     //
     // Total number of packet buffers allocated (and iovecs used if !GSO).
     //
@@ -160,6 +166,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     uint8_t SegmentationSupported : 1;
 
+    //
+    // Indicates the payload is passed to the kernel without copying it. The
+    // send data is only freed once the kernel's notification CQE arrives.
+    //
+    uint8_t ZeroCopy : 1;
+
     //
     // The message header for the send.
     //
@@ -174,6 +186,9 @@ typedef struct CXPLAT_SEND_DATA {
         CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
     #ifdef UDP_SEGMENT
         + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+    #ifdef SO_TXTIME
+        + CMSG_SPACE(sizeof(uint64_t))          // SCM_TXTIME
     #endif
         ];
     CXPLAT_STATIC_ASSERT(
@@ -205,7 +220,8 @@ typedef struct CXPLAT_SEND_DATA {
 
 typedef struct CXPLAT_RECV_MSG_CONTROL_BUFFER {
     char Data[CMSG_SPACE(sizeof(struct in6_pktinfo)) + // IP_PKTINFO
-              3 * CMSG_SPACE(sizeof(int))]; // TOS + IP_TTL
+              3 * CMSG_SPACE(sizeof(int)) + // TOS + IP_TTL
+              CMSG_SPACE(sizeof(struct scm_timestamping))]; // SO_TIMESTAMPING
 
 } CXPLAT_RECV_MSG_CONTROL_BUFFER;
 
@@ -218,6 +234,12 @@ const struct msghdr CxPlatRecvMsgHdr = {
 };
 const uint32_t RecvBufCount = 1024;
 
+//
+// The number of sockets per partition that can be registered with the ring so
+// their sends skip the per-SQE file lookup. Sockets beyond this use their fd.
+//
+#define CXPLAT_IOURING_FIXED_FILE_COUNT 4096
+
 void
 CxPlatSocketIoStart(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -273,7 +295,11 @@ CxPlatFreeBufferPool(
         Pool->Buffers = NULL;
     }
     if (Pool->Ring != NULL) {
-        free(Pool->Ring);
+        if (Pool->HugePages) {
+            CxPlatHugePageFree(Pool->Ring, Pool->TotalSize);
+        } else {
+            free(Pool->Ring);
+        }
         Pool->Ring = NULL;
     }
 }
@@ -296,7 +322,13 @@ CxPlatCreateBufferPool(
     CxPlatLockInitialize(&Pool->Lock);
 
     Pool->TotalSize = BufferCount * (sizeof(struct io_uring_buf) + BufferSize);
-    if (posix_memalign(&Pool->Ring, getpagesize(), Pool->TotalSize)) {
+    if (DatapathPartition->Datapath->HugePages) {
+        Pool->HugePages = TRUE;
+        Pool->Ring = CxPlatHugePageAlloc(Pool->TotalSize);
+    } else if (posix_memalign(&Pool->Ring, getpagesize(), Pool->TotalSize)) {
+        Pool->Ring = NULL;
+    }
+    if (Pool->Ring == NULL) {
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
@@ -343,6 +375,66 @@ Exit:
     return Status;
 }
 
+void
+CxPlatFreeFixedFileTable(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    if (DatapathPartition->FixedFileFreeSlots != NULL) {
+        io_uring_unregister_files(&DatapathPartition->EventQ->Ring);
+        CXPLAT_FREE(DatapathPartition->FixedFileFreeSlots, QUIC_POOL_DATAPATH);
+        DatapathPartition->FixedFileFreeSlots = NULL;
+        DatapathPartition->FixedFileFreeCount = 0;
+    }
+    CxPlatLockUninitialize(&DatapathPartition->FixedFileLock);
+}
+
+void
+CxPlatCreateFixedFileTable(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    const size_t SlotsLength = CXPLAT_IOURING_FIXED_FILE_COUNT * sizeof(uint32_t);
+
+    CxPlatLockInitialize(&DatapathPartition->FixedFileLock);
+    DatapathPartition->FixedFileFreeSlots = NULL;
+    DatapathPartition->FixedFileFreeCount = 0;
+
+    uint32_t* FreeSlots = CXPLAT_ALLOC_NONPAGED(SlotsLength, QUIC_POOL_DATAPATH);
+    if (FreeSlots == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "FixedFileFreeSlots",
+            SlotsLength);
+        return;
+    }
+
+    //
+    // Failure here isn't fatal (e.g. an externally provided ring may already
+    // have a file table); sockets on this partition just use their fd.
+    //
+    int Result =
+        io_uring_register_files_sparse(
+            &DatapathPartition->EventQ->Ring, CXPLAT_IOURING_FIXED_FILE_COUNT);
+    if (Result < 0) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            DatapathPartition,
+            -Result,
+            "io_uring_register_files_sparse failed");
+        CXPLAT_FREE(FreeSlots, QUIC_POOL_DATAPATH);
+        return;
+    }
+
+    for (uint32_t i = 0; i < CXPLAT_IOURING_FIXED_FILE_COUNT; i++) {
+        FreeSlots[i] = CXPLAT_IOURING_FIXED_FILE_COUNT - 1 - i;
+    }
+    DatapathPartition->FixedFileFreeSlots = FreeSlots;
+    DatapathPartition->FixedFileFreeCount = CXPLAT_IOURING_FIXED_FILE_COUNT;
+}
+
 QUIC_STATUS
 CxPlatProcessorContextInitialize(
     _In_ CXPLAT_DATAPATH* Datapath,
@@ -358,8 +450,15 @@ CxPlatProcessorContextInitialize(
     DatapathPartition->EventQ = CxPlatWorkerPoolGetEventQ(Datapath->WorkerPool, PartitionIndex);
     CxPlatRefInitialize(&DatapathPartition->RefCount);
 
-    CxPlatPoolInitialize(
-        TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    if (Datapath->HugePages) {
+        CxPlatPoolInitializeHugePages(
+            Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    } else {
+        CxPlatPoolInitialize(
+            TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    }
+
+    CxPlatCreateFixedFileTable(DatapathPartition);
 
     Status =
         CxPlatCreateBufferPool(
@@ -400,7 +499,6 @@ DataPathInitialize(
     )
 {
     UNREFERENCED_PARAMETER(TcpCallbacks);
-    UNREFERENCED_PARAMETER(InitConfig);
 
     if (NewDatapath == NULL) {
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -451,6 +549,30 @@ DataPathInitialize(
     CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
     CxPlatDataPathCalculateFeatureSupport(Datapath);
 
+    //
+    // Zero-copy only pays off for large GSO batches, so it's only offered
+    // alongside send segmentation and when the kernel has IORING_OP_SENDMSG_ZC.
+    //
+    if (InitConfig->EnableZeroCopySend &&
+        Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        struct io_uring_probe* Probe =
+            io_uring_get_probe_ring(&CxPlatWorkerPoolGetEventQ(WorkerPool, 0)->Ring);
+        if (Probe != NULL) {
+            if (io_uring_opcode_supported(Probe, IORING_OP_SENDMSG_ZC)) {
+                Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_ZEROCOPY;
+            }
+            io_uring_free_probe(Probe);
+        }
+    }
+
+#ifdef SO_TXTIME
+    if (InitConfig->EnableTxTimePacing) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+    }
+#endif
+
+    Datapath->HugePages = InitConfig->EnableHugePages;
+
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
         Datapath->SendDataSize = sizeof(CXPLAT_SEND_DATA);
         Datapath->SendIoVecCount = 1;
@@ -466,7 +588,7 @@ DataPathInitialize(
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
         Datapath->RecvBlockBufferOffset =
             sizeof(DATAPATH_RX_IO_BLOCK) +
-            CXPLAT_MAX_IO_BATCH_SIZE * Datapath->RecvBlockStride;
+            CXPLAT_MAX_RECV_PACKET_COUNT * Datapath->RecvBlockStride;
         Datapath->RecvBlockSize =
             ALIGN_UP_BY(
                 Datapath->RecvBlockBufferOffset + CXPLAT_LARGE_IO_BUFFER_SIZE,
@@ -489,6 +611,22 @@ DataPathInitialize(
         if (QUIC_FAILED(Status)) {
             return Status;
         }
+
+        //
+        // Receive buffers are registered with the ring up front already. The
+        // reservation is best effort; the pool just grows on demand.
+        //
+        if (InitConfig->PoolReserveCount != 0 &&
+            QUIC_FAILED(
+                CxPlatPoolReserve(
+                    &Datapath->Partitions[i].SendBlockPool,
+                    InitConfig->PoolReserveCount,
+                    CxPlatProcNumaNode(CxPlatWorkerPoolGetIdealProcessor(WorkerPool, i))))) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "CxPlatPoolReserve failed");
+        }
     }
 
     CXPLAT_FRE_ASSERT(CxPlatWorkerPoolAddRef(WorkerPool, CXPLAT_WORKER_POOL_REF_IOURING));
@@ -528,6 +666,7 @@ CxPlatProcessorContextRelease(
         CxPlatFreeBufferPool(
             DatapathPartition, CxPlatIoRingBufGroupRecv,
             &DatapathPartition->RecvRegisteredBufferPool);
+        CxPlatFreeFixedFileTable(DatapathPartition);
         CxPlatPoolUninitialize(&DatapathPartition->SendBlockPool);
         CxPlatDataPathRelease(DatapathPartition->Datapath);
     }
@@ -550,6 +689,17 @@ DataPathUninitialize(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+DataPathUpdatePollingIdleTimeout(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ uint32_t PollingIdleTimeoutUs
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(PollingIdleTimeoutUs);
+}
+
 QUIC_STATUS
 CxPlatSocketContextSqeInitialize(
     _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext
@@ -606,6 +756,66 @@ Exit:
 // Socket context interface. It abstracts a (generally per-processor) UDP socket
 // and the corresponding logic/functionality like send and receive processing.
 //
+void
+CxPlatSocketContextRegisterFile(
+    _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    uint32_t Slot;
+
+    CxPlatLockAcquire(&DatapathPartition->FixedFileLock);
+    if (DatapathPartition->FixedFileFreeCount == 0) {
+        CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+        return;
+    }
+    Slot = DatapathPartition->FixedFileFreeSlots[--DatapathPartition->FixedFileFreeCount];
+    CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+
+    int Result =
+        io_uring_register_files_update(
+            &DatapathPartition->EventQ->Ring, Slot, &SocketContext->SocketFd, 1);
+    if (Result < 0) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            -Result,
+            "io_uring_register_files_update failed");
+        CxPlatLockAcquire(&DatapathPartition->FixedFileLock);
+        DatapathPartition->FixedFileFreeSlots[DatapathPartition->FixedFileFreeCount++] = Slot;
+        CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+        return;
+    }
+
+    SocketContext->FixedFileIndex = (int)Slot;
+}
+
+void
+CxPlatSocketContextUnregisterFile(
+    _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+
+    if (SocketContext->FixedFileIndex == -1) {
+        return;
+    }
+
+    //
+    // The registered table holds its own reference on the socket, so the slot
+    // must be cleared for the close of SocketFd to take effect.
+    //
+    const int EmptyFd = -1;
+    const uint32_t Slot = (uint32_t)SocketContext->FixedFileIndex;
+    (void)io_uring_register_files_update(&DatapathPartition->EventQ->Ring, Slot, &EmptyFd, 1);
+    SocketContext->FixedFileIndex = -1;
+
+    CxPlatLockAcquire(&DatapathPartition->FixedFileLock);
+    DatapathPartition->FixedFileFreeSlots[DatapathPartition->FixedFileFreeCount++] = Slot;
+    CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+}
+
 QUIC_STATUS
 CxPlatSocketContextInitialize(
     _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -873,6 +1083,61 @@ CxPlatSocketContextInitialize(
         }
     #endif
 
+    #ifdef SO_TIMESTAMPING
+        if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS) {
+            //
+            // Failure here isn't fatal; packets are just timestamped when the
+            // worker processes them. Hardware timestamps are only reported if
+            // the NIC has been configured for them (SIOCSHWTSTAMP).
+            //
+            Option =
+                SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TIMESTAMPING,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_TIMESTAMPING) failed");
+            }
+        }
+    #endif
+
+    #ifdef SO_TXTIME
+        if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME) {
+            //
+            // Failure here isn't fatal; departure times are just dropped and
+            // sends on this socket go out immediately.
+            //
+            struct sock_txtime TxTimeConfig = { CLOCK_MONOTONIC, 0 };
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TXTIME,
+                    (const void*)&TxTimeConfig,
+                    sizeof(TxTimeConfig));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_TXTIME) failed");
+            } else {
+                SocketContext->TxTimeEnabled = TRUE;
+            }
+        }
+    #endif
+
         //
         // The socket is shared by multiple QUIC endpoints, so increase the receive
         // buffer size.
@@ -1057,6 +1322,8 @@ CxPlatSocketContextInitialize(
         }
     }
 
+    CxPlatSocketContextRegisterFile(SocketContext);
+
 Exit:
 
     if (QUIC_FAILED(Status)) {
@@ -1103,6 +1370,8 @@ CxPlatSocketContextUninitializeComplete(
 
     CXPLAT_DBG_ASSERT(SocketContext->AcceptSocket == NULL);
 
+    CxPlatSocketContextUnregisterFile(SocketContext);
+
     if (SocketContext->SocketFd != INVALID_SOCKET) {
         close(SocketContext->SocketFd);
     }
@@ -1306,6 +1575,7 @@ SocketCreateUdp(
     for (uint32_t i = 0; i < SocketCount; i++) {
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
+        Binding->SocketContexts[i].FixedFileIndex = -1;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
@@ -1324,12 +1594,18 @@ SocketCreateUdp(
 
     if (IsServerSocket) {
         //
-        // The return value is being ignored here, as if a system does not support
+        // Prefer steering by the partition encoded in the CID, so packets land
+        // on the socket of the partition owning the connection. Otherwise, the
+        // return value is being ignored here, as if a system does not support
         // bpf we still want the server to work. If this happens, the sockets will
         // round robin, but each flow will be sent to the same socket, just not
         // based on RSS.
         //
-        (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        if (QUIC_FAILED(
+                CxPlatSocketConfigureCidSteering(
+                    &Binding->SocketContexts[0], SocketCount, Config))) {
+            (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        }
     }
 
     CxPlatConvertFromMappedV6(&Binding->LocalAddress, &Binding->LocalAddress);
@@ -1494,7 +1770,8 @@ void
 CxPlatSocketContextRecvComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
     _Inout_ DATAPATH_RX_IO_BLOCK** IoBlocks,
-    _In_ struct msghdr* RecvMsgHdr
+    _In_ struct msghdr* RecvMsgHdrs,
+    _In_ uint32_t MessagesReceived
     )
 {
     CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath == SocketContext->DatapathPartition->Datapath);
@@ -1502,15 +1779,17 @@ CxPlatSocketContextRecvComplete(
     uint32_t BytesTransferred = 0;
     CXPLAT_RECV_DATA* DatagramHead = NULL;
     CXPLAT_RECV_DATA** DatagramTail = &DatagramHead;
-    for (int CurrentMessage = 0; CurrentMessage < 1; CurrentMessage++) {
+    for (uint32_t CurrentMessage = 0; CurrentMessage < MessagesReceived; CurrentMessage++) {
         DATAPATH_RX_IO_BLOCK* IoBlock = IoBlocks[CurrentMessage];
         IoBlocks[CurrentMessage] = NULL;
+        struct msghdr* RecvMsgHdr = &RecvMsgHdrs[CurrentMessage];
         uint32_t MsgLen = (uint32_t)RecvMsgHdr->msg_iov->iov_len;
         BytesTransferred += MsgLen;
 
         uint8_t TOS = 0;
         int HopLimitTTL = 0;
         uint16_t SegmentLength = 0;
+        uint64_t RecvTime = 0;
         BOOLEAN FoundLocalAddr = FALSE, FoundTOS = FALSE, FoundTTL = FALSE;
         QUIC_ADDR* LocalAddr = &IoBlock->Route.LocalAddress;
         QUIC_ADDR* RemoteAddr = RecvMsgHdr->msg_name;
@@ -1519,7 +1798,8 @@ CxPlatSocketContextRecvComplete(
 
         //
         // Process the ancillary control messages to get the local address,
-        // type of service and possibly the GRO segmentation length.
+        // type of service, receive timestamp and possibly the GRO segmentation
+        // length.
         //
         struct msghdr* Msg = RecvMsgHdr;
         for (struct cmsghdr*CMsg = CMSG_FIRSTHDR(Msg); CMsg != NULL; CMsg = CMSG_NXTHDR(Msg, CMsg)) {
@@ -1564,6 +1844,11 @@ CxPlatSocketContextRecvComplete(
                     SegmentLength = *(uint16_t*)CMSG_DATA(CMsg);
                 }
 #endif
+            } else if (CMsg->cmsg_level == SOL_SOCKET) {
+                if (CMsg->cmsg_type == SCM_TIMESTAMPING) {
+                    CXPLAT_DBG_ASSERT_CMSG(CMsg, struct scm_timestamping);
+                    RecvTime = CxPlatSocketGetRecvTimestamp(CMsg);
+                }
             } else {
                 CXPLAT_DBG_ASSERT(FALSE);
             }
@@ -1595,7 +1880,7 @@ CxPlatSocketContextRecvComplete(
         //
         uint32_t Offset = 0;
         while (Offset < MsgLen &&
-               IoBlock->RefCount < CXPLAT_MAX_IO_BATCH_SIZE) {
+               IoBlock->RefCount < CXPLAT_MAX_RECV_PACKET_COUNT) {
             IoBlock->RefCount++;
             Datagram->IoBlock = IoBlock;
 
@@ -1611,6 +1896,7 @@ CxPlatSocketContextRecvComplete(
             RecvData->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
             RecvData->TypeOfService = TOS;
             RecvData->HopLimitTTL = (uint8_t)HopLimitTTL;
+            RecvData->RecvTime = RecvTime;
             RecvData->Allocated = TRUE;
             RecvData->Route->DatapathType = RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             RecvData->QueuedOnConnection = FALSE;
@@ -1651,70 +1937,93 @@ CxPlatSocketContextRecvComplete(
     }
 }
 
+//
+// The maximum number of multishot receive completions on a single socket that
+// are coalesced into one receive indication.
+//
+#define CXPLAT_IOURING_RECV_BATCH_SIZE 32
+
 void
 CxPlatSocketReceiveComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
-    _In_ CXPLAT_CQE Cqe
+    _In_reads_(CqeCount) CXPLAT_CQE* Cqes,
+    _In_ uint32_t CqeCount
     )
 {
     CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
-    DATAPATH_RX_IO_BLOCK* IoBlock;
-    uint8_t* IoPayload;
-    struct msghdr RecvMsgHdrs[1];
-    struct iovec RecvIov;
-    uint32_t BufferIndex;
-    struct io_uring_recvmsg_out* RecvMsgOut;
+    DATAPATH_RX_IO_BLOCK* IoBlocks[CXPLAT_IOURING_RECV_BATCH_SIZE];
+    struct msghdr RecvMsgHdrs[CXPLAT_IOURING_RECV_BATCH_SIZE];
+    struct iovec RecvIovs[CXPLAT_IOURING_RECV_BATCH_SIZE];
+    uint32_t MessageCount = 0;
+    BOOLEAN MultiRecvTerminated = FALSE;
 
-    if (Cqe->res == -ENOBUFS) {
-        //
-        // Ignore packet loss indications for now.
-        //
-        goto Exit;
-    }
+    CXPLAT_DBG_ASSERT(CqeCount <= CXPLAT_IOURING_RECV_BATCH_SIZE);
 
-    if (Cqe->res < 0) {
-        if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
-            CxPlatSocketHandleError(SocketContext, -Cqe->res);
-            CxPlatRundownRelease(&SocketContext->UpcallRundown);
-        }
-        goto Exit;
-    }
-
-    CXPLAT_DBG_ASSERT(Cqe->flags & IORING_CQE_F_BUFFER);
+    for (uint32_t i = 0; i < CqeCount; i++) {
+        CXPLAT_CQE Cqe = Cqes[i];
 
-    BufferIndex = Cqe->flags >> 16;
-    IoBlock =
-        (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(
-            &DatapathPartition->RecvRegisteredBufferPool, BufferIndex);
-    IoPayload = (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset;
-    RecvMsgOut = io_uring_recvmsg_validate(IoPayload, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
-    CXPLAT_FRE_ASSERT(RecvMsgOut != NULL); // Review: can this legally fail?
-
-    CXPLAT_DBG_ASSERT((uintptr_t)IoBlock % CXPLAT_MEMORY_ALIGNMENT == 0);
-
-    IoBlock->Route.State = RouteResolved;
+        if (!(Cqe->flags & IORING_CQE_F_MORE)) {
+            //
+            // The kernel only stops a multishot receive on error or when the
+            // provided buffer ring runs dry, so this is the last completion
+            // for the armed SQE.
+            //
+            CXPLAT_DBG_ASSERT(i == CqeCount - 1);
+            MultiRecvTerminated = TRUE;
+        }
 
-    //
-    // Review: these can be batched by propagating the CQE array here.
-    //
-    struct msghdr* MsgHdr = &RecvMsgHdrs[0];
-    MsgHdr->msg_name = io_uring_recvmsg_name(RecvMsgOut);
-    MsgHdr->msg_namelen = RecvMsgOut->namelen;
-    MsgHdr->msg_iov = &RecvIov;
-    MsgHdr->msg_iovlen = 1;
-    MsgHdr->msg_control =
-        io_uring_recvmsg_cmsg_firsthdr(RecvMsgOut, (struct msghdr*)&CxPlatRecvMsgHdr);
-    MsgHdr->msg_controllen = RecvMsgOut->controllen;
-    MsgHdr->msg_flags = 0;
-    RecvIov.iov_base = io_uring_recvmsg_payload(RecvMsgOut, (struct msghdr*)&CxPlatRecvMsgHdr);
-    RecvIov.iov_len =
-        io_uring_recvmsg_payload_length(RecvMsgOut, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
+        if (Cqe->res == -ENOBUFS) {
+            //
+            // Ignore packet loss indications for now.
+            //
+            continue;
+        }
 
-    CxPlatSocketContextRecvComplete(SocketContext, &IoBlock, RecvMsgHdrs);
+        if (Cqe->res < 0) {
+            if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
+                CxPlatSocketHandleError(SocketContext, -Cqe->res);
+                CxPlatRundownRelease(&SocketContext->UpcallRundown);
+            }
+            continue;
+        }
 
-Exit:
+        CXPLAT_DBG_ASSERT(Cqe->flags & IORING_CQE_F_BUFFER);
 
-    if (!(Cqe->flags & IORING_CQE_F_MORE)) {
+        uint32_t BufferIndex = Cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        DATAPATH_RX_IO_BLOCK* IoBlock =
+            (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(
+                &DatapathPartition->RecvRegisteredBufferPool, BufferIndex);
+        uint8_t* IoPayload = (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset;
+        struct io_uring_recvmsg_out* RecvMsgOut =
+            io_uring_recvmsg_validate(IoPayload, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
+        CXPLAT_FRE_ASSERT(RecvMsgOut != NULL); // Review: can this legally fail?
+
+        CXPLAT_DBG_ASSERT((uintptr_t)IoBlock % CXPLAT_MEMORY_ALIGNMENT == 0);
+
+        IoBlock->Route.State = RouteResolved;
+        IoBlocks[MessageCount] = IoBlock;
+
+        struct msghdr* MsgHdr = &RecvMsgHdrs[MessageCount];
+        MsgHdr->msg_name = io_uring_recvmsg_name(RecvMsgOut);
+        MsgHdr->msg_namelen = RecvMsgOut->namelen;
+        MsgHdr->msg_iov = &RecvIovs[MessageCount];
+        MsgHdr->msg_iovlen = 1;
+        MsgHdr->msg_control =
+            io_uring_recvmsg_cmsg_firsthdr(RecvMsgOut, (struct msghdr*)&CxPlatRecvMsgHdr);
+        MsgHdr->msg_controllen = RecvMsgOut->controllen;
+        MsgHdr->msg_flags = 0;
+        RecvIovs[MessageCount].iov_base =
+            io_uring_recvmsg_payload(RecvMsgOut, (struct msghdr*)&CxPlatRecvMsgHdr);
+        RecvIovs[MessageCount].iov_len =
+            io_uring_recvmsg_payload_length(RecvMsgOut, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
+        MessageCount++;
+    }
+
+    if (MessageCount != 0) {
+        CxPlatSocketContextRecvComplete(SocketContext, IoBlocks, RecvMsgHdrs, MessageCount);
+    }
+
+    if (MultiRecvTerminated) {
         CXPLAT_DBG_ASSERT(SocketContext->LockedFlags.MultiRecvStarted);
         CXPLAT_DBG_ONLY(SocketContext->LockedFlags.MultiRecvStarted = FALSE);
 
@@ -1726,33 +2035,65 @@ Exit:
     }
 }
 
+void
+CxPlatRecvBufferRingFlush(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _In_ uint32_t Count
+    )
+{
+    io_uring_buf_ring_advance(DatapathPartition->RecvRegisteredBufferPool.Ring, Count);
+    CxPlatLockRelease(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+}
+
 void
 RecvDataReturn(
     _In_ CXPLAT_RECV_DATA* RecvDataChain
     )
 {
     CXPLAT_RECV_DATA* Datagram;
+    CXPLAT_DATAPATH_PARTITION* LockedPartition = NULL;
+    uint32_t PendingCount = 0;
+
+    //
+    // Released buffers are handed back to the provided buffer ring in runs:
+    // the ring lock is held while consecutive blocks from the same partition
+    // are added and the tail is only published once per run. Likewise, the
+    // references of consecutive datagrams from the same block are dropped
+    // with a single atomic.
+    //
     while ((Datagram = RecvDataChain) != NULL) {
-        RecvDataChain = RecvDataChain->Next;
         DATAPATH_RX_IO_BLOCK* IoBlock =
             CXPLAT_CONTAINING_RECORD(Datagram, DATAPATH_RX_PACKET, Data)->IoBlock;
-        if (InterlockedDecrement(&IoBlock->RefCount) == 0) {
+        long Count = 0;
+        do {
+            RecvDataChain = RecvDataChain->Next;
+            ++Count;
+        } while (RecvDataChain != NULL &&
+                 CXPLAT_CONTAINING_RECORD(RecvDataChain, DATAPATH_RX_PACKET, Data)->IoBlock == IoBlock);
+
+        if (InterlockedExchangeAdd(&IoBlock->RefCount, -Count) == Count) {
             CXPLAT_DATAPATH_PARTITION* DatapathPartition = IoBlock->DatapathPartition;
-            //
-            // Review: this is amenable to batching, but the added complexity
-            // may not be worth it.
-            //
-            CxPlatLockAcquire(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+            if (DatapathPartition != LockedPartition) {
+                if (LockedPartition != NULL) {
+                    CxPlatRecvBufferRingFlush(LockedPartition, PendingCount);
+                }
+                CxPlatLockAcquire(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+                LockedPartition = DatapathPartition;
+                PendingCount = 0;
+            }
             io_uring_buf_ring_add(
                 DatapathPartition->RecvRegisteredBufferPool.Ring,
                 (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset,
                 CxPlatGetBufferPoolBufferSize(&DatapathPartition->RecvRegisteredBufferPool) -
                     DatapathPartition->Datapath->RecvBlockBufferOffset,
-                IoBlock->BufferIndex, io_uring_buf_ring_mask(RecvBufCount), 0);
-            io_uring_buf_ring_advance(DatapathPartition->RecvRegisteredBufferPool.Ring, 1);
-            CxPlatLockRelease(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+                IoBlock->BufferIndex, io_uring_buf_ring_mask(RecvBufCount), PendingCount);
+            PendingCount++;
         }
     }
+
+    if (LockedPartition != NULL) {
+        CxPlatRecvBufferRingFlush(LockedPartition, PendingCount);
+    }
 }
 
 //
@@ -1805,10 +2146,12 @@ SendDataAlloc(
         SendData->ControlBufferLength = 0;
         SendData->ECN = Config->ECN;
         SendData->DSCP = Config->DSCP;
+        SendData->TxTime = SocketContext->TxTimeEnabled ? Config->TxTime : 0;
         SendData->Flags = Config->Flags;
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
             !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->ZeroCopy = FALSE;
         SendData->Iovs[0].iov_len = 0;
         SendData->Iovs[0].iov_base = SendData->Buffer;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
@@ -1954,12 +2297,36 @@ SocketSend(
     CxPlatConvertToMappedV6(&Route->RemoteAddress, &SendData->RemoteAddress);
     SendData->LocalAddress = Route->LocalAddress;
 
+    SendData->ZeroCopy =
+        (Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_ZEROCOPY) &&
+        Socket->Type == CXPLAT_SOCKET_UDP &&
+        SendData->SegmentationSupported &&
+        SendData->TotalSize >= CXPLAT_ZEROCOPY_SEND_THRESHOLD;
+
     //
     // Go ahead and try to send on the socket.
     //
     CxPlatSendDataSend(SendData, FALSE, FALSE);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    //
+    // When called on the partition's thread, the ring submit is already
+    // deferred, so back to back sends share a single io_uring_submit.
+    //
+    for (uint32_t i = 0; i < Count; ++i) {
+        SocketSend(Socket, &Routes[i], SendData[i]);
+    }
+}
+
 //
 // This is defined and used instead of CMSG_NXTHDR because (1) we've already
 // done the work to ensure the necessary space is available and (2) CMSG_NXTHDR
@@ -2019,6 +2386,17 @@ CxPlatSendDataPopulateAncillaryData(
     }
 #endif
 
+#ifdef SO_TXTIME
+    if (SendData->TxTime != 0) {
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *((uint64_t*)CMSG_DATA(CMsg)) = US_TO_NS(SendData->TxTime);
+    }
+#endif
+
     CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
@@ -2073,7 +2451,17 @@ CxPlatSendDataSendSegmented(
         SendData->MsgHdr.msg_controllen = SendData->ControlBufferLength;
     }
 
-    io_uring_prep_sendmsg(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+    const int Fd =
+        SocketContext->FixedFileIndex != -1 ?
+            SocketContext->FixedFileIndex : SocketContext->SocketFd;
+    if (SendData->ZeroCopy) {
+        io_uring_prep_sendmsg_zc(Sqe, Fd, &SendData->MsgHdr, 0);
+    } else {
+        io_uring_prep_sendmsg(Sqe, Fd, &SendData->MsgHdr, 0);
+    }
+    if (SocketContext->FixedFileIndex != -1) {
+        io_uring_sqe_set_flags(Sqe, IOSQE_FIXED_FILE);
+    }
     io_uring_sqe_set_data(Sqe, (void*)&SendData->Sqe);
     CxPlatBatchSqeInitialize(
         DatapathPartition->EventQ, CxPlatSocketContextIoEventComplete, &SendData->Sqe.Sqe);
@@ -2187,8 +2575,28 @@ CxPlatSocketContextSendComplete(
     CXPLAT_SQE* Sqe = CxPlatCqeGetSqe(&Cqe);
     CXPLAT_SEND_DATA* SendData = CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SEND_DATA, Sqe);
 
+    if (Cqe->flags & IORING_CQE_F_NOTIF) {
+        //
+        // The kernel released its references to a zero-copy send's buffer.
+        // The send itself already completed (and drained the queue) on the
+        // earlier CQE.
+        //
+        CXPLAT_DBG_ASSERT(SendData->ZeroCopy);
+        CxPlatSendDataFree(SendData);
+        CxPlatSocketIoComplete(SocketContext, IoTagSend);
+        return;
+    }
+
+    //
+    // A zero-copy send that actually went out produces a second, notification
+    // CQE; until then the send data (and the send IO) stay outstanding.
+    //
+    const BOOLEAN NotificationPending = !!(Cqe->flags & IORING_CQE_F_MORE);
+
     CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateSendComplete) == SendStateSending);
-    CxPlatSendDataFree(SendData);
+    if (!NotificationPending) {
+        CxPlatSendDataFree(SendData);
+    }
     SendData = NULL;
 
     if (SocketContext->LockedFlags.Shutdown) {
@@ -2227,7 +2635,9 @@ CxPlatSocketContextSendComplete(
 
 Exit:
 
-    CxPlatSocketIoComplete(SocketContext, IoTagSend);
+    if (!NotificationPending) {
+        CxPlatSocketIoComplete(SocketContext, IoTagSend);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -2285,13 +2695,21 @@ CxPlatSocketContextIoEventComplete(
     while (TRUE) {
         CXPLAT_SOCKET_SQE* SocketSqe = CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SOCKET_SQE, Sqe);
 
-        //
-        // Review: these functions could be unrolled to batch within an IO
-        // type on a socket.
-        //
+        uint32_t Consumed = 1;
+
         switch ((DATAPATH_CONTEXT_TYPE)(uintptr_t)SocketSqe->Context) {
         case DatapathContextRecv:
-            CxPlatSocketReceiveComplete(SocketContext, *Cqes[0]);
+            //
+            // Multishot receive produces a run of CQEs against the same SQE.
+            // Coalesce the run so the upper layer gets a single indication.
+            //
+            while (Consumed < *CqeCount &&
+                   Consumed < CXPLAT_IOURING_RECV_BATCH_SIZE &&
+                   ((*Cqes)[Consumed - 1]->flags & IORING_CQE_F_MORE) &&
+                   CxPlatCqeGetSqe(&(*Cqes)[Consumed]) == Sqe) {
+                Consumed++;
+            }
+            CxPlatSocketReceiveComplete(SocketContext, *Cqes, Consumed);
             break;
         case DatapathContextSend:
             CxPlatSocketContextSendComplete(SocketContext, *Cqes[0]);
@@ -2300,8 +2718,8 @@ CxPlatSocketContextIoEventComplete(
             CXPLAT_DBG_ASSERT(FALSE);
         }
 
-        (*Cqes)++;
-        (*CqeCount)--;
+        (*Cqes) += Consumed;
+        (*CqeCount) -= Consumed;
 
         if (*CqeCount == 0 ||
             CxPlatCqeGetSqe(*Cqes)->Completion != CxPlatSocketContextIoEventComplete) {
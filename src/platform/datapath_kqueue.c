@@ -26,6 +26,9 @@ struct in_pktinfo {
 // See netinet6/in6.h:46 for an explanation
 #include "platform_internal.h"
 #include <sys/sysctl.h>
+#if defined(__APPLE__)
+#include <dlfcn.h>
+#endif
 
 #ifdef QUIC_CLOG
 #include "datapath_kqueue.c.clog.h"
@@ -43,10 +46,22 @@ CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Length) <= sizeof(size_t
 CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Buffer) == sizeof(void*)), "(sizeof(QUIC_BUFFER.Buffer) == sizeof(void*) must be TRUE.");
 
 //
-// TODO: Support batching.
+// Each send data has a single backing buffer. Multiple datagrams are carried
+// in it as equal sized segments, which are split back out at send time.
 //
 #define CXPLAT_MAX_BATCH_SEND 1
 
+//
+// The maximum number of datagrams passed to a single batched send or receive
+// syscall.
+//
+#define CXPLAT_MAX_IO_BATCH_SIZE 32
+
+//
+// The number of receive batches read before moving on to another event.
+//
+#define CXPLAT_MAX_RECV_BATCHES 4
+
 //
 // The maximum single buffer size for sending coalesced payloads.
 //
@@ -116,9 +131,10 @@ typedef struct CXPLAT_SEND_DATA {
     uint32_t BufferCount;
 
     //
-    // The current index of the Buffers to be sent.
+    // The number of datagrams already sent, if the send was pended part way
+    // through.
     //
-    uint32_t CurrentIndex;
+    uint32_t AlreadySentCount;
 
     //
     // The QUIC_BUFFER returned to the client for segmented sends.
@@ -130,13 +146,41 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_BUFFER Buffers[CXPLAT_MAX_BATCH_SEND];
 
-    //
-    // IO vectors used for sends on the socket.
-    //
-    struct iovec Iovs[CXPLAT_MAX_BATCH_SEND];
-
 } CXPLAT_SEND_DATA;
 
+typedef struct CXPLAT_RECV_MSG_CONTROL_BUFFER {
+    char Data[CMSG_SPACE(sizeof(struct in6_pktinfo)) +
+              CMSG_SPACE(sizeof(struct in_pktinfo)) +
+              2 * CMSG_SPACE(sizeof(int))];
+
+} CXPLAT_RECV_MSG_CONTROL_BUFFER;
+
+#if defined(__APPLE__)
+//
+// Darwin's batched send and receive syscalls. They are exported by libSystem
+// but not declared in the public headers, so they are looked up at runtime.
+//
+struct msghdr_x {
+    void* msg_name;
+    socklen_t msg_namelen;
+    struct iovec* msg_iov;
+    int msg_iovlen;
+    void* msg_control;
+    socklen_t msg_controllen;
+    int msg_flags;
+    size_t msg_datalen;
+};
+
+typedef
+ssize_t
+(CXPLAT_MSG_X_FN)(
+    int s,
+    const struct msghdr_x* msgp,
+    u_int cnt,
+    int flags
+    );
+#endif
+
 typedef struct CXPLAT_DATAPATH_PARTITION CXPLAT_DATAPATH_PARTITION;
 
 //
@@ -170,26 +214,9 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     CXPLAT_SQE IoSqe;
 
     //
-    // The I/O vector for receive datagrams.
+    // The length of the buffer posted for each received datagram.
     //
-    struct iovec RecvIov;
-
-    //
-    // The control buffer used in RecvMsgHdr.
-    //
-    char RecvMsgControl[CMSG_SPACE(sizeof(struct in6_pktinfo)) +
-                        CMSG_SPACE(sizeof(struct in_pktinfo)) +
-                        2 * CMSG_SPACE(sizeof(int))];
-
-    //
-    // The buffer used to receive msg headers on socket.
-    //
-    struct msghdr RecvMsgHdr;
-
-    //
-    // The receive block currently being used for receives on this socket.
-    //
-    DATAPATH_RX_IO_BLOCK* CurrentRecvBlock;
+    uint32_t RecvBufferLength;
 
     //
     // The head of list containg all pending sends on this socket.
@@ -365,6 +392,14 @@ typedef struct CXPLAT_DATAPATH {
     //
     uint32_t PartitionCount;
 
+#if defined(__APPLE__)
+    //
+    // The batched syscalls, if available on this system.
+    //
+    CXPLAT_MSG_X_FN* SendMsgX;
+    CXPLAT_MSG_X_FN* RecvMsgX;
+#endif
+
 #if DEBUG
     uint8_t Uninitialized : 1;
     uint8_t Freed : 1;
@@ -472,6 +507,15 @@ CxPlatDataPathInitialize(
         Datapath->UdpHandlers = *UdpCallbacks;
     }
     Datapath->WorkerPool = WorkerPool;
+    //
+    // Segmentation is done in software: the segments of a send are split back
+    // into datagrams and handed to the socket in a single batched syscall.
+    //
+    Datapath->Features = CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION;
+#if defined(__APPLE__)
+    Datapath->SendMsgX = (CXPLAT_MSG_X_FN*)dlsym(RTLD_DEFAULT, "sendmsg_x");
+    Datapath->RecvMsgX = (CXPLAT_MSG_X_FN*)dlsym(RTLD_DEFAULT, "recvmsg_x");
+#endif
     Datapath->PartitionCount = 1; //CxPlatWorkerPoolGetCount(WorkerPool); // Darwin only supports a single receiver
     CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
 
@@ -588,7 +632,11 @@ CxPlatDataPathAllocRxIoBlock(
             "DATAPATH_RX_IO_BLOCK",
             0);
     } else {
-        CxPlatZeroMemory(IoBlock, sizeof(*IoBlock));
+        //
+        // The payload buffer is left as is; it's overwritten by the receive.
+        //
+        CxPlatZeroMemory(&IoBlock->Route, sizeof(IoBlock->Route));
+        CxPlatZeroMemory(&IoBlock->RecvPacket, sizeof(IoBlock->RecvPacket));
         IoBlock->Route.State = RouteResolved;
         IoBlock->OwningPool = &DatapathPartition->RecvBlockPool;
         IoBlock->RecvPacket.Buffer = IoBlock->Buffer;
@@ -949,10 +997,6 @@ CxPlatSocketContextUninitializeComplete(
     SocketContext->Freed = TRUE;
 #endif
 
-    if (SocketContext->CurrentRecvBlock != NULL) {
-        CxPlatRecvDataReturn(&SocketContext->CurrentRecvBlock->RecvPacket);
-    }
-
     while (!CxPlatListIsEmpty(&SocketContext->PendingSendDataHead)) {
         CxPlatSendDataFree(
             CXPLAT_CONTAINING_RECORD(
@@ -1018,41 +1062,120 @@ CxPlatSocketContextUninitialize(
     }
 }
 
-QUIC_STATUS
-CxPlatSocketContextPrepareReceive(
-    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+//
+// Sends the messages in as few syscalls as the system allows. Returns the
+// number of messages sent, or -1 (with errno set) if the first one failed.
+//
+int
+CxPlatSocketSendMessages(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ int SocketFd,
+    _In_reads_(Count) struct msghdr* Messages,
+    _In_ uint32_t Count
     )
 {
-    if (SocketContext->CurrentRecvBlock == NULL) {
-        SocketContext->CurrentRecvBlock =
-            CxPlatDataPathAllocRxIoBlock(SocketContext->DatapathPartition);
-        if (SocketContext->CurrentRecvBlock == NULL) {
-            QuicTraceEvent(
-                AllocFailure,
-                "Allocation of '%s' failed. (%llu bytes)",
-                "DATAPATH_RX_IO_BLOCK",
-                0);
-            return QUIC_STATUS_OUT_OF_MEMORY;
+    CXPLAT_DBG_ASSERT(Count > 0 && Count <= CXPLAT_MAX_IO_BATCH_SIZE);
+    UNREFERENCED_PARAMETER(Datapath);
+
+#if defined(__FreeBSD__)
+    struct mmsghdr Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+    for (uint32_t i = 0; i < Count; ++i) {
+        Mhdrs[i].msg_hdr = Messages[i];
+        Mhdrs[i].msg_len = 0;
+    }
+    return (int)sendmmsg(SocketFd, Mhdrs, Count, 0);
+#else
+#if defined(__APPLE__)
+    if (Datapath->SendMsgX != NULL) {
+        struct msghdr_x Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+        for (uint32_t i = 0; i < Count; ++i) {
+            Mhdrs[i].msg_name = Messages[i].msg_name;
+            Mhdrs[i].msg_namelen = Messages[i].msg_namelen;
+            Mhdrs[i].msg_iov = Messages[i].msg_iov;
+            Mhdrs[i].msg_iovlen = Messages[i].msg_iovlen;
+            Mhdrs[i].msg_control = Messages[i].msg_control;
+            Mhdrs[i].msg_controllen = Messages[i].msg_controllen;
+            Mhdrs[i].msg_flags = 0;
+            Mhdrs[i].msg_datalen = 0;
         }
+        return (int)Datapath->SendMsgX(SocketFd, Mhdrs, Count, 0);
     }
+#endif
+    uint32_t SentCount = 0;
+    while (SentCount < Count) {
+        if (sendmsg(SocketFd, &Messages[SentCount], 0) < 0) {
+            return SentCount == 0 ? -1 : (int)SentCount;
+        }
+        SentCount++;
+    }
+    return (int)SentCount;
+#endif
+}
 
-    SocketContext->RecvIov.iov_base = SocketContext->CurrentRecvBlock->RecvPacket.Buffer;
-    SocketContext->CurrentRecvBlock->RecvPacket.Next = NULL;
-    SocketContext->CurrentRecvBlock->RecvPacket.BufferLength = SocketContext->RecvIov.iov_len;
-    SocketContext->CurrentRecvBlock->RecvPacket.Route = &SocketContext->CurrentRecvBlock->Route;
-
-    CxPlatZeroMemory(&SocketContext->RecvMsgHdr, sizeof(SocketContext->RecvMsgHdr));
-    CxPlatZeroMemory(&SocketContext->RecvMsgControl, sizeof(SocketContext->RecvMsgControl));
-
-    SocketContext->RecvMsgHdr.msg_name = &SocketContext->CurrentRecvBlock->RecvPacket.Route->RemoteAddress;
-    SocketContext->RecvMsgHdr.msg_namelen = sizeof(SocketContext->CurrentRecvBlock->RecvPacket.Route->RemoteAddress);
-    SocketContext->RecvMsgHdr.msg_iov = &SocketContext->RecvIov;
-    SocketContext->RecvMsgHdr.msg_iovlen = 1;
-    SocketContext->RecvMsgHdr.msg_control = SocketContext->RecvMsgControl;
-    SocketContext->RecvMsgHdr.msg_controllen = sizeof(SocketContext->RecvMsgControl);
-    SocketContext->RecvMsgHdr.msg_flags = 0;
+//
+// Receives up to Count messages in as few syscalls as the system allows.
+// Returns the number of messages received, with their lengths in
+// MessageLengths, or -1 (with errno set) if nothing could be received.
+//
+int
+CxPlatSocketRecvMessages(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ int SocketFd,
+    _Inout_updates_(Count) struct msghdr* Messages,
+    _Out_writes_(Count) size_t* MessageLengths,
+    _In_ uint32_t Count
+    )
+{
+    CXPLAT_DBG_ASSERT(Count > 0 && Count <= CXPLAT_MAX_IO_BATCH_SIZE);
+    UNREFERENCED_PARAMETER(Datapath);
 
-    return QUIC_STATUS_SUCCESS;
+#if defined(__FreeBSD__)
+    struct mmsghdr Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+    for (uint32_t i = 0; i < Count; ++i) {
+        Mhdrs[i].msg_hdr = Messages[i];
+        Mhdrs[i].msg_len = 0;
+    }
+    int Ret = (int)recvmmsg(SocketFd, Mhdrs, Count, MSG_DONTWAIT, NULL);
+    for (int i = 0; i < Ret; ++i) {
+        Messages[i] = Mhdrs[i].msg_hdr;
+        MessageLengths[i] = (size_t)Mhdrs[i].msg_len;
+    }
+    return Ret;
+#else
+#if defined(__APPLE__)
+    if (Datapath->RecvMsgX != NULL) {
+        struct msghdr_x Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+        for (uint32_t i = 0; i < Count; ++i) {
+            Mhdrs[i].msg_name = Messages[i].msg_name;
+            Mhdrs[i].msg_namelen = Messages[i].msg_namelen;
+            Mhdrs[i].msg_iov = Messages[i].msg_iov;
+            Mhdrs[i].msg_iovlen = Messages[i].msg_iovlen;
+            Mhdrs[i].msg_control = Messages[i].msg_control;
+            Mhdrs[i].msg_controllen = Messages[i].msg_controllen;
+            Mhdrs[i].msg_flags = 0;
+            Mhdrs[i].msg_datalen = 0;
+        }
+        int Ret = (int)Datapath->RecvMsgX(SocketFd, Mhdrs, Count, 0);
+        for (int i = 0; i < Ret; ++i) {
+            Messages[i].msg_namelen = Mhdrs[i].msg_namelen;
+            Messages[i].msg_controllen = Mhdrs[i].msg_controllen;
+            Messages[i].msg_flags = Mhdrs[i].msg_flags;
+            MessageLengths[i] = Mhdrs[i].msg_datalen;
+        }
+        return Ret;
+    }
+#endif
+    uint32_t RecvCount = 0;
+    while (RecvCount < Count) {
+        ssize_t Ret = recvmsg(SocketFd, &Messages[RecvCount], 0);
+        if (Ret < 0) {
+            return RecvCount == 0 ? -1 : (int)RecvCount;
+        }
+        MessageLengths[RecvCount] = (size_t)Ret;
+        RecvCount++;
+    }
+    return (int)RecvCount;
+#endif
 }
 
 QUIC_STATUS
@@ -1060,10 +1183,7 @@ CxPlatSocketContextStartReceive(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
     )
 {
-    QUIC_STATUS Status = CxPlatSocketContextPrepareReceive(SocketContext);
-    if (QUIC_FAILED(Status)) {
-        goto Error;
-    }
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
 
     if (!CxPlatEventQEnqueueEx(
             SocketContext->DatapathPartition->EventQ,
@@ -1077,25 +1197,24 @@ CxPlatSocketContextStartReceive(
             SocketContext->Binding,
             Status,
             "CxPlatEventQEnqueueEx failed");
-        goto Error;
     }
 
-Error:
-
     return Status;
 }
 
-void
+//
+// Parses the received message and returns the datagram to indicate.
+//
+CXPLAT_RECV_DATA*
 CxPlatSocketContextRecvComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
-    _In_ ssize_t BytesTransferred
+    _In_ DATAPATH_RX_IO_BLOCK* IoBlock,
+    _In_ struct msghdr* RecvMsgHdr,
+    _In_ size_t BytesTransferred
     )
 {
-    QUIC_STATUS Status = QUIC_STATUS_SUCCESS; // cppcheck-suppress unreadVariable
-
-    CXPLAT_DBG_ASSERT(SocketContext->CurrentRecvBlock != NULL);
-    CXPLAT_RECV_DATA* RecvPacket = &SocketContext->CurrentRecvBlock->RecvPacket;
-    SocketContext->CurrentRecvBlock = NULL;
+    CXPLAT_RECV_DATA* RecvPacket = &IoBlock->RecvPacket;
+    RecvPacket->Route = &IoBlock->Route;
 
     BOOLEAN FoundLocalAddr = FALSE; // cppcheck-suppress unreadVariable
     BOOLEAN FoundTOS = FALSE; // cppcheck-suppress unreadVariable
@@ -1113,12 +1232,12 @@ CxPlatSocketContextRecvComplete(
     RecvPacket->Route->Queue = (CXPLAT_QUEUE*)SocketContext;
     RecvPacket->TypeOfService = 0;
     RecvPacket->HopLimitTTL = 0; // TODO: We are not supporting this on MacOS (yet) unless there's a business need.
+    RecvPacket->RecvTime = 0;
 
     struct cmsghdr *CMsg;
-    for (CMsg = CMSG_FIRSTHDR(&SocketContext->RecvMsgHdr);
+    for (CMsg = CMSG_FIRSTHDR(RecvMsgHdr);
          CMsg != NULL;
-         CMsg = CMSG_NXTHDR(&SocketContext->RecvMsgHdr, CMsg)) {
-
+         CMsg = CMSG_NXTHDR(RecvMsgHdr, CMsg)) {
         if (CMsg->cmsg_level == IPPROTO_IPV6) {
             if (CMsg->cmsg_type == IPV6_PKTINFO) {
                 struct in6_pktinfo* PktInfo6 = (struct in6_pktinfo*) CMSG_DATA(CMsg);
@@ -1188,32 +1307,139 @@ CxPlatSocketContextRecvComplete(
 
     RecvPacket->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
 
+    return RecvPacket;
+}
+
+void
+CxPlatSocketContextIndicateReceive(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ CXPLAT_RECV_DATA* RecvDataChain
+    )
+{
     if (!SocketContext->Binding->PcpBinding) {
         CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath->UdpHandlers.Receive);
         SocketContext->Binding->Datapath->UdpHandlers.Receive(
             SocketContext->Binding,
             SocketContext->Binding->ClientContext,
-            RecvPacket);
+            RecvDataChain);
     } else {
         CxPlatPcpRecvCallback(
             SocketContext->Binding,
             SocketContext->Binding->ClientContext,
-            RecvPacket);
+            RecvDataChain);
     }
+}
 
-    int32_t RetryCount = 0;
-    do {
-        Status = CxPlatSocketContextPrepareReceive(SocketContext);
-    } while (!QUIC_SUCCEEDED(Status) && ++RetryCount < 10);
+void
+CxPlatSocketContextReceiveMessages(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    DATAPATH_RX_IO_BLOCK* IoBlocks[CXPLAT_MAX_IO_BATCH_SIZE];
+    struct msghdr RecvMsgHdr[CXPLAT_MAX_IO_BATCH_SIZE];
+    CXPLAT_RECV_MSG_CONTROL_BUFFER RecvMsgControl[CXPLAT_MAX_IO_BATCH_SIZE];
+    struct iovec RecvIov[CXPLAT_MAX_IO_BATCH_SIZE];
+    size_t RecvLength[CXPLAT_MAX_IO_BATCH_SIZE];
+    CxPlatZeroMemory(IoBlocks, sizeof(IoBlocks));
+
+    for (uint32_t Batch = 0; Batch < CXPLAT_MAX_RECV_BATCHES; ++Batch) {
+        uint32_t Count = 0;
+        while (Count < CXPLAT_MAX_IO_BATCH_SIZE) {
+            if (IoBlocks[Count] == NULL) {
+                IoBlocks[Count] =
+                    CxPlatDataPathAllocRxIoBlock(SocketContext->DatapathPartition);
+                if (IoBlocks[Count] == NULL) {
+                    break;
+                }
+            }
 
-    if (!QUIC_SUCCEEDED(Status)) {
-        CXPLAT_DBG_ASSERT(Status == QUIC_STATUS_OUT_OF_MEMORY);
-        QuicTraceEvent(
-            DatapathErrorStatus,
-            "[data][%p] ERROR, %u, %s.",
-            SocketContext->Binding,
-            Status,
-            "CxPlatSocketContextPrepareReceive failed multiple times. Receive will no longer work.");
+            DATAPATH_RX_IO_BLOCK* IoBlock = IoBlocks[Count];
+            IoBlock->RecvPacket.BufferLength = SocketContext->RecvBufferLength;
+            RecvIov[Count].iov_base = IoBlock->RecvPacket.Buffer;
+            RecvIov[Count].iov_len = SocketContext->RecvBufferLength;
+
+            struct msghdr* MsgHdr = &RecvMsgHdr[Count];
+            MsgHdr->msg_name = &IoBlock->Route.RemoteAddress;
+            MsgHdr->msg_namelen = sizeof(IoBlock->Route.RemoteAddress);
+            MsgHdr->msg_iov = &RecvIov[Count];
+            MsgHdr->msg_iovlen = 1;
+            MsgHdr->msg_control = RecvMsgControl[Count].Data;
+            MsgHdr->msg_controllen = sizeof(RecvMsgControl[Count].Data);
+            MsgHdr->msg_flags = 0;
+            Count++;
+        }
+
+        if (Count == 0) {
+            break;
+        }
+
+        int Ret =
+            CxPlatSocketRecvMessages(
+                SocketContext->DatapathPartition->Datapath,
+                SocketContext->SocketFd,
+                RecvMsgHdr,
+                RecvLength,
+                Count);
+        if (Ret < 0) {
+            int ErrNum = errno;
+            if (ErrNum != EAGAIN && ErrNum != EWOULDBLOCK) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    SocketContext->Binding,
+                    ErrNum,
+                    "recvmsg failed");
+
+                //
+                // The read can also return unreachable events. There is no
+                // flag to detect this state other then to call recvmsg.
+                // Send unreachable notification to MsQuic if any related
+                // errors were received.
+                //
+                if (ErrNum == ECONNREFUSED ||
+                    ErrNum == EHOSTUNREACH ||
+                    ErrNum == ENETUNREACH) {
+                    if (!SocketContext->Binding->PcpBinding) {
+                        SocketContext->Binding->Datapath->UdpHandlers.Unreachable(
+                            SocketContext->Binding,
+                            SocketContext->Binding->ClientContext,
+                            &SocketContext->Binding->RemoteAddress);
+                    }
+                }
+            }
+            break;
+        }
+
+        CXPLAT_DBG_ASSERT((uint32_t)Ret <= Count);
+
+        //
+        // Indicate the whole batch as a single chain.
+        //
+        CXPLAT_RECV_DATA* RecvDataChain = NULL;
+        CXPLAT_RECV_DATA** RecvDataTail = &RecvDataChain;
+        for (int i = 0; i < Ret; ++i) {
+            *RecvDataTail =
+                CxPlatSocketContextRecvComplete(
+                    SocketContext,
+                    IoBlocks[i],
+                    &RecvMsgHdr[i],
+                    RecvLength[i]);
+            RecvDataTail = &(*RecvDataTail)->Next;
+            IoBlocks[i] = NULL;
+        }
+        if (RecvDataChain != NULL) {
+            CxPlatSocketContextIndicateReceive(SocketContext, RecvDataChain);
+        }
+
+        if ((uint32_t)Ret < Count) {
+            break; // The socket has been drained.
+        }
+    }
+
+    for (uint32_t i = 0; i < CXPLAT_MAX_IO_BATCH_SIZE; ++i) {
+        if (IoBlocks[i] != NULL) {
+            CxPlatPoolFree(IoBlocks[i]);
+        }
     }
 }
 
@@ -1316,48 +1542,7 @@ CxPlatSocketContextIoEventComplete(
     CXPLAT_DBG_ASSERT(Cqe->filter & (EVFILT_READ | EVFILT_WRITE | EVFILT_USER));
 
     if (Cqe->filter == EVFILT_READ) {
-        //
-        // Read up to 4 receives before moving to another event.
-        //
-        for (int i = 0; i < 4; i++) {
-            CXPLAT_DBG_ASSERT(SocketContext->CurrentRecvBlock != NULL);
-
-            ssize_t Ret =
-                recvmsg(
-                    SocketContext->SocketFd,
-                    &SocketContext->RecvMsgHdr,
-                    0);
-            if (Ret < 0) {
-                int ErrNum = errno;
-                if (ErrNum != EAGAIN && ErrNum != EWOULDBLOCK) {
-                    QuicTraceEvent(
-                        DatapathErrorStatus,
-                        "[data][%p] ERROR, %u, %s.",
-                        SocketContext->Binding,
-                        errno,
-                        "recvmsg failed");
-
-                    //
-                    // The read can also return unreachable events. There is no
-                    // flag to detect this state other then to call recvmsg.
-                    // Send unreachable notification to MsQuic if any related
-                    // errors were received.
-                    //
-                    if (ErrNum == ECONNREFUSED ||
-                        ErrNum == EHOSTUNREACH ||
-                        ErrNum == ENETUNREACH) {
-                        if (!SocketContext->Binding->PcpBinding) {
-                            SocketContext->Binding->Datapath->UdpHandlers.Unreachable(
-                                SocketContext->Binding,
-                                SocketContext->Binding->ClientContext,
-                                &SocketContext->Binding->RemoteAddress);
-                        }
-                    }
-                }
-                break;
-            }
-            CxPlatSocketContextRecvComplete(SocketContext, Ret);
-        }
+        CxPlatSocketContextReceiveMessages(SocketContext);
     }
 
     if (Cqe->filter == EVFILT_WRITE) {
@@ -1422,7 +1607,7 @@ CxPlatSocketCreateUdp(
     for (uint32_t i = 0; i < SocketCount; i++) {
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
-        Binding->SocketContexts[i].RecvIov.iov_len =
+        Binding->SocketContexts[i].RecvBufferLength =
             Binding->Mtu - CXPLAT_MIN_IPV4_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE;
         Binding->SocketContexts[i].DatapathPartition =
             IsServerSocket ?
@@ -1898,7 +2083,7 @@ CxPlatSocketSendInternal(
     )
 {
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
-    ssize_t SentByteCount = 0;
+    int SentCount = 0;
     QUIC_ADDR MappedRemoteAddress = {0};
     struct cmsghdr *CMsg = NULL;
     struct in_pktinfo *PktInfo = NULL;
@@ -1915,10 +2100,6 @@ CxPlatSocketSendInternal(
 
     if (!IsPendedSend) {
         CxPlatSendDataFinalizeSendBuffer(SendData);
-        for (size_t i = 0; i < SendData->BufferCount; ++i) {
-            SendData->Iovs[i].iov_base = SendData->Buffers[i].Buffer;
-            SendData->Iovs[i].iov_len = SendData->Buffers[i].Length;
-        }
         QuicTraceEvent(
             DatapathSend,
             "[data][%p] Send %u bytes in %hhu buffers (segment=%hu) Dst=%!ADDR!, Src=%!ADDR!",
@@ -1959,8 +2140,8 @@ CxPlatSocketSendInternal(
     struct msghdr Mhdr = {
         .msg_name = NULL,
         .msg_namelen = 0,
-        .msg_iov = SendData->Iovs,
-        .msg_iovlen = SendData->BufferCount,
+        .msg_iov = NULL,
+        .msg_iovlen = 1,
         .msg_control = ControlBuffer,
         .msg_controllen = CMSG_SPACE(sizeof(int)),
         .msg_flags = 0
@@ -2005,9 +2186,43 @@ CxPlatSocketSendInternal(
         }
     }
 
-    SentByteCount = sendmsg(SocketContext->SocketFd, &Mhdr, 0);
+    //
+    // Split the send back into its datagrams; every datagram but the last is
+    // a full segment. They all share the same addresses and ancillary data.
+    //
+    CXPLAT_DBG_ASSERT(SendData->BufferCount <= CXPLAT_MAX_BATCH_SEND);
+    const uint32_t SegmentSize =
+        SendData->SegmentSize != 0 ? SendData->SegmentSize : SendData->TotalSize;
+    const uint32_t MessageCount =
+        SegmentSize == 0 ? 0 : (SendData->TotalSize + SegmentSize - 1) / SegmentSize;
+
+    while (SendData->AlreadySentCount < MessageCount) {
+        struct msghdr Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+        struct iovec Iovs[CXPLAT_MAX_IO_BATCH_SIZE];
+        uint32_t Count = 0;
+        while (Count < CXPLAT_MAX_IO_BATCH_SIZE &&
+               SendData->AlreadySentCount + Count < MessageCount) {
+            const uint32_t Offset = (SendData->AlreadySentCount + Count) * SegmentSize;
+            Iovs[Count].iov_base = SendData->Buffers[0].Buffer + Offset;
+            Iovs[Count].iov_len = CXPLAT_MIN(SegmentSize, SendData->TotalSize - Offset);
+            Mhdrs[Count] = Mhdr;
+            Mhdrs[Count].msg_iov = &Iovs[Count];
+            Count++;
+        }
 
-    if (SentByteCount < 0) {
+        SentCount =
+            CxPlatSocketSendMessages(
+                SocketContext->Binding->Datapath,
+                SocketContext->SocketFd,
+                Mhdrs,
+                Count);
+        if (SentCount < 0) {
+            break;
+        }
+        SendData->AlreadySentCount += (uint32_t)SentCount;
+    }
+
+    if (SentCount < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             if (!IsPendedSend) {
                 CxPlatLockAcquire(&SocketContext->PendingSendDataLock);
@@ -2092,6 +2307,23 @@ CxPlatSocketSend(
         FALSE);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    //
+    // Each send data already goes out in a single batched syscall.
+    //
+    for (uint32_t i = 0; i < Count; ++i) {
+        CxPlatSocketSend(Socket, &Routes[i], SendData[i]);
+    }
+}
+
 uint16_t
 CxPlatSocketGetLocalMtu(
     _In_ CXPLAT_SOCKET* Socket,
@@ -24,9 +24,13 @@ CxPlatSocketUpdateQeo(
     _In_ uint32_t OffloadCount
     )
 {
-    UNREFERENCED_PARAMETER(Socket);
-    UNREFERENCED_PARAMETER(Offloads);
-    UNREFERENCED_PARAMETER(OffloadCount);
+    //
+    // Only the raw (XDP) datapath owns the NIC queues the offload would be
+    // programmed into. Anything else stays in software.
+    //
+    if (Socket->RawSocketAvailable && !IS_LOOPBACK(Offloads[0].Address)) {
+        return RawSocketUpdateQeo(CxPlatSocketToRaw(Socket), Offloads, OffloadCount);
+    }
     return QUIC_STATUS_NOT_SUPPORTED;
 }
 
@@ -72,17 +76,6 @@ DataPathIsPaddingPreferred(
     return !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
 }
 
-_IRQL_requires_max_(PASSIVE_LEVEL)
-void
-DataPathUpdatePollingIdleTimeout(
-    _In_ CXPLAT_DATAPATH* Datapath,
-    _In_ uint32_t PollingIdleTimeoutUs
-    )
-{
-    UNREFERENCED_PARAMETER(Datapath);
-    UNREFERENCED_PARAMETER(PollingIdleTimeoutUs);
-}
-
 void
 CxPlatDataPathCalculateFeatureSupport(
     _Inout_ CXPLAT_DATAPATH* Datapath
@@ -189,6 +182,9 @@ Error:
     Datapath->Features |= CXPLAT_DATAPATH_FEATURE_TTL;
     Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_DSCP;
     Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_DSCP;
+#ifdef SO_TIMESTAMPING
+    Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS;
+#endif
 }
 
 QUIC_STATUS
@@ -236,6 +232,124 @@ CxPlatSocketConfigureRss(
 #endif
 }
 
+QUIC_STATUS
+CxPlatSocketConfigureCidSteering(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t SocketCount,
+    _In_ const CXPLAT_UDP_CONFIG* Config
+    )
+{
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    //
+    // Socket i is owned by partition (i % PartitionCount), so returning the
+    // partition index selects a socket of that partition.
+    //
+    CXPLAT_DATAPATH* Datapath = SocketContext->Binding->Datapath;
+    if (Config->CidPartitionCount == 0 ||
+        Config->CidPartitionCount != Datapath->PartitionCount ||
+        SocketCount < Config->CidPartitionCount ||
+        SocketCount == 1) {
+        return QUIC_STATUS_NOT_SUPPORTED;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    int Result = 0;
+
+    //
+    // The program runs with the UDP header already pulled, so offset 0 is the
+    // first byte of the QUIC packet. The destination CID of a long header
+    // packet starts after the first byte, version and CID length (offset 6);
+    // for a short header it follows the first byte (offset 1). The partition
+    // ID is written into the CID in host byte order.
+    //
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const uint32_t HighByte = Config->CidPartitionIdOffset + 1;
+    const uint32_t LowByte = Config->CidPartitionIdOffset;
+#else
+    const uint32_t HighByte = Config->CidPartitionIdOffset;
+    const uint32_t LowByte = Config->CidPartitionIdOffset + 1;
+#endif
+
+    struct sock_filter BpfCode[] = {
+        {BPF_LD | BPF_B | BPF_ABS, 0, 0, 0}, // Load first byte
+        {BPF_JMP | BPF_JSET | BPF_K, 0, 2, 0x80}, // Long header?
+        {BPF_LDX | BPF_W | BPF_IMM, 0, 0, 6}, // X = long header CID offset
+        {BPF_JMP | BPF_JA, 0, 0, 1},
+        {BPF_LDX | BPF_W | BPF_IMM, 0, 0, 1}, // X = short header CID offset
+        {BPF_LD | BPF_B | BPF_IND, 0, 0, HighByte}, // Load partition ID high byte
+        {BPF_ALU | BPF_LSH | BPF_K, 0, 0, 8},
+        {BPF_ST, 0, 0, 0}, // M[0] = A
+        {BPF_LD | BPF_B | BPF_IND, 0, 0, LowByte}, // Load partition ID low byte
+        {BPF_LDX | BPF_W | BPF_MEM, 0, 0, 0}, // X = M[0]
+        {BPF_ALU | BPF_OR | BPF_X, 0, 0, 0},
+        {BPF_ALU | BPF_AND | BPF_K, 0, 0, Config->CidPartitionMask}, // AND by PartitionMask
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, Config->CidPartitionCount}, // MOD by PartitionCount
+        {BPF_RET | BPF_A, 0, 0, 0} // Return
+    };
+
+    struct sock_fprog BpfConfig = {0};
+    BpfConfig.len = ARRAYSIZE(BpfCode);
+    BpfConfig.filter = BpfCode;
+
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_ATTACH_REUSEPORT_CBPF,
+            (const void*)&BpfConfig,
+            sizeof(BpfConfig));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            Status,
+            "setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed");
+    }
+
+    return Status;
+#else
+    UNREFERENCED_PARAMETER(SocketContext);
+    UNREFERENCED_PARAMETER(SocketCount);
+    UNREFERENCED_PARAMETER(Config);
+    return QUIC_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+uint64_t
+CxPlatSocketGetRecvTimestamp(
+    _In_ const struct cmsghdr* CMsg
+    )
+{
+    //
+    // The kernel reports timestamps against CLOCK_REALTIME (or the NIC clock
+    // for hardware timestamps), so convert them to the monotonic clock used by
+    // CxPlatTimeUs64 via their age. The hardware timestamp is preferred as it
+    // excludes the kernel's own receive processing.
+    //
+    const struct scm_timestamping* Timestamps = (const struct scm_timestamping*)CMSG_DATA(CMsg);
+    struct timespec Now;
+    if (clock_gettime(CLOCK_REALTIME, &Now) != 0) {
+        return 0;
+    }
+    const int64_t NowUs = (int64_t)Now.tv_sec * 1000000 + Now.tv_nsec / 1000;
+
+    static const uint8_t Order[] = { 2, 0 }; // Raw hardware, then software.
+    for (uint32_t i = 0; i < ARRAYSIZE(Order); ++i) {
+        const struct timespec* Ts = &Timestamps->ts[Order[i]];
+        if (Ts->tv_sec == 0 && Ts->tv_nsec == 0) {
+            continue;
+        }
+        const int64_t AgeUs = NowUs - ((int64_t)Ts->tv_sec * 1000000 + Ts->tv_nsec / 1000);
+        if (AgeUs >= 0 && AgeUs <= CXPLAT_RECV_TIMESTAMP_MAX_AGE_US) {
+            return CxPlatTimeUs64() - (uint64_t)AgeUs;
+        }
+    }
+
+    return 0;
+}
+
 void
 CxPlatSocketHandleError(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
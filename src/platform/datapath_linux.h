@@ -9,9 +9,13 @@
 
 #include <fcntl.h>
 #include <linux/filter.h>
+#include <linux/errqueue.h>
 #include <linux/in6.h>
+#include <linux/net_tstamp.h>
 #include <linux/stddef.h>
 #include <netinet/udp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
 
 //
 // The maximum single buffer size for single packet/datagram IO payloads.
@@ -31,6 +35,47 @@
 //
 #define CXPLAT_MAX_IO_BATCH_SIZE ((uint16_t)(CXPLAT_LARGE_IO_BUFFER_SIZE / (1280 - CXPLAT_MIN_IPV6_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE)))
 
+//
+// The maximum number of segments the kernel coalesces into a single UDP GRO
+// receive (UDP_GRO_CNT_MAX). GRO also merges runs of datagrams smaller than
+// the minimum MTU (e.g. ACK-only packets), so this can exceed the number of
+// full size packets that fit in the large buffer.
+//
+#define CXPLAT_MAX_GRO_SEGMENT_COUNT        64
+
+//
+// The number of receive packets reserved in each coalesced receive block.
+//
+#define CXPLAT_MAX_RECV_PACKET_COUNT \
+    CXPLAT_MAX(CXPLAT_MAX_IO_BATCH_SIZE, CXPLAT_MAX_GRO_SEGMENT_COUNT)
+
+//
+// Sends smaller than this are always copied into the kernel. Below roughly
+// this size the page pinning and completion notification of a zero-copy send
+// cost more than the copy they avoid.
+//
+#define CXPLAT_ZEROCOPY_SEND_THRESHOLD      16384
+
+//
+// How long closing a socket waits for the kernel to release the buffers of
+// its outstanding zero-copy sends. Completions normally arrive as soon as the
+// device has transmitted the packets; this only bounds a stuck device queue.
+//
+#define CXPLAT_ZEROCOPY_CLOSE_TIMEOUT_MS    1000
+
+//
+// The maximum number of packets the kernel processes per busy-poll of a
+// device queue. Matches the default NAPI weight.
+//
+#define CXPLAT_BUSY_POLL_BUDGET             64
+
+//
+// Kernel receive timestamps older than this (or in the future) are ignored.
+// This filters out hardware timestamps from a NIC clock that isn't
+// synchronized to the system clock, and system clock steps.
+//
+#define CXPLAT_RECV_TIMESTAMP_MAX_AGE_US    1000000
+
 #define CXPLAT_DBG_ASSERT_CMSG(CMsg, type) \
     CXPLAT_DBG_ASSERT((CMsg)->cmsg_len >= CMSG_LEN(sizeof(type)))
 
@@ -45,6 +90,18 @@ CxPlatSocketConfigureRss(
     _In_ uint32_t SocketCount
     );
 
+//
+// Steers each received datagram to the socket owned by the partition encoded
+// in its destination CID. Returns QUIC_STATUS_NOT_SUPPORTED if the config
+// doesn't request CID steering or its partitions don't map onto the sockets.
+//
+QUIC_STATUS
+CxPlatSocketConfigureCidSteering(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t SocketCount,
+    _In_ const CXPLAT_UDP_CONFIG* Config
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 DataPathUpdatePollingIdleTimeout(
@@ -52,6 +109,11 @@ DataPathUpdatePollingIdleTimeout(
     _In_ uint32_t PollingIdleTimeoutUs
     );
 
+uint64_t
+CxPlatSocketGetRecvTimestamp(
+    _In_ const struct cmsghdr* CMsg
+    );
+
 void
 CxPlatSocketHandleError(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -0,0 +1,748 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    QUIC In-Process Loopback Datapath
+
+    Hands datagrams sent on a UDP socket directly to the receive path of the
+    socket in the same process bound to the destination port, without any
+    system calls, optionally after a modeled one way delay, random loss and
+    link rate. This leaves only the QUIC and TLS processing for CPU bound
+    end-to-end benchmarks.
+
+    The sockets themselves are still created by the normal datapath, so the
+    OS allocates (and reserves) their ports, but nothing is ever sent or
+    received on them. Datagrams to a port without a socket in this process
+    are dropped.
+
+    Delivery happens on a per worker execution context, so it runs on the
+    same threads as the normal datapath's receives would. Delayed datagrams
+    are delivered no earlier than their due time, but the worker's wait only
+    has millisecond resolution, unless it's polling.
+
+--*/
+
+#include "platform_internal.h"
+
+#ifdef QUIC_CLOG
+#include "datapath_loopback.c.clog.h"
+#endif
+
+//
+// The most datagrams a single send data can batch.
+//
+#define CXPLAT_LOOPBACK_MAX_BATCH 16
+
+//
+// A socket in this process that datagrams can be delivered to.
+//
+typedef struct CXPLAT_LOOPBACK_BINDING {
+
+    //
+    // Entry in the datapath's table, keyed by local port.
+    //
+    CXPLAT_HASHTABLE_ENTRY Entry;
+
+    CXPLAT_SOCKET* Socket;
+
+    //
+    // One for the table and one for each queued datagram.
+    //
+    CXPLAT_REF_COUNT RefCount;
+
+    //
+    // Held while indicating datagrams to the socket's client, so deleting the
+    // socket can wait for any in progress indications.
+    //
+    CXPLAT_RUNDOWN_REF Rundown;
+
+    uint16_t PartitionIndex;
+
+    BOOLEAN HasFixedRemoteAddress;
+
+    //
+    // When the modeled link into this socket is next idle. Protected by the
+    // datapath's lock.
+    //
+    uint64_t LinkIdleTime;
+
+} CXPLAT_LOOPBACK_BINDING;
+
+//
+// A single datagram. Allocated once by the sender, and the receive data (with
+// the client's receive context and the payload after it) is indicated as is.
+//
+typedef struct CXPLAT_LOOPBACK_PACKET {
+
+    CXPLAT_LIST_ENTRY Link;
+
+    CXPLAT_DATAPATH_LOOPBACK* Loopback;
+
+    CXPLAT_LOOPBACK_BINDING* Binding;
+
+    uint64_t DueTime;
+
+    //
+    // The buffer handed to the sender to fill in.
+    //
+    QUIC_BUFFER Buffer;
+
+    CXPLAT_ROUTE Route;
+
+    //
+    // Followed by the client's receive context and then the payload.
+    //
+    CXPLAT_RECV_DATA RecvData;
+
+} CXPLAT_LOOPBACK_PACKET;
+
+typedef struct CXPLAT_LOOPBACK_SEND_DATA {
+
+    CXPLAT_SEND_DATA_COMMON;
+
+    CXPLAT_DATAPATH_LOOPBACK* Loopback;
+
+    uint8_t PacketCount;
+
+    CXPLAT_LOOPBACK_PACKET* Packets[CXPLAT_LOOPBACK_MAX_BATCH];
+
+} CXPLAT_LOOPBACK_SEND_DATA;
+
+//
+// The datagrams due for delivery on one worker.
+//
+typedef struct CXPLAT_LOOPBACK_PARTITION {
+
+    CXPLAT_DATAPATH_LOOPBACK* Loopback;
+
+    CXPLAT_EXECUTION_CONTEXT Ec;
+
+    CXPLAT_LOCK Lock;
+
+    //
+    // Queued datagrams, sorted by due time.
+    //
+    CXPLAT_LIST_ENTRY Queue;
+
+} CXPLAT_LOOPBACK_PARTITION;
+
+typedef struct CXPLAT_DATAPATH_LOOPBACK {
+
+    CXPLAT_DATAPATH* Datapath;
+
+    CXPLAT_LOOPBACK_CONFIG Config;
+
+    uint32_t ClientRecvContextLength;
+
+    BOOLEAN Running;
+
+    //
+    // Protects the bindings table, the loss model's state and the bindings'
+    // modeled link state.
+    //
+    CXPLAT_LOCK Lock;
+
+    CXPLAT_HASHTABLE Bindings;
+
+    //
+    // Loss is drawn from a fixed seed, so runs are repeatable.
+    //
+    uint64_t RandomState;
+
+    CXPLAT_POOL PacketPool;
+
+    CXPLAT_POOL SendDataPool;
+
+    //
+    // Held by each partition's execution context until it's cleaned up.
+    //
+    CXPLAT_RUNDOWN_REF Rundown;
+
+    uint16_t PartitionCount;
+
+    CXPLAT_LOOPBACK_PARTITION Partitions[0];
+
+} CXPLAT_DATAPATH_LOOPBACK;
+
+static
+CXPLAT_LOOPBACK_PACKET*
+CxPlatLoopbackRecvToPacket(
+    _In_ CXPLAT_RECV_DATA* RecvData
+    )
+{
+    return CXPLAT_CONTAINING_RECORD(RecvData, CXPLAT_LOOPBACK_PACKET, RecvData);
+}
+
+static
+uint8_t*
+CxPlatLoopbackPacketPayload(
+    _In_ const CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _In_ CXPLAT_LOOPBACK_PACKET* Packet
+    )
+{
+    return (uint8_t*)(&Packet->RecvData + 1) + Loopback->ClientRecvContextLength;
+}
+
+static
+void
+CxPlatLoopbackBindingRelease(
+    _In_ CXPLAT_LOOPBACK_BINDING* Binding,
+    _In_ uint32_t Count
+    )
+{
+    while (Count-- > 0) {
+        if (CxPlatRefDecrement(&Binding->RefCount)) {
+            CxPlatRundownUninitialize(&Binding->Rundown);
+            CXPLAT_FREE(Binding, QUIC_POOL_DATAPATH_LOOPBACK);
+            CXPLAT_DBG_ASSERT(Count == 0);
+            break;
+        }
+    }
+}
+
+//
+// Finds the binding for the local port. Must be called with the lock held.
+//
+static
+CXPLAT_LOOPBACK_BINDING*
+CxPlatLoopbackLookupBinding(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _In_ uint16_t Port,
+    _In_opt_ const CXPLAT_SOCKET* Socket
+    )
+{
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    CXPLAT_HASHTABLE_ENTRY* Entry =
+        CxPlatHashtableLookup(&Loopback->Bindings, Port, &Context);
+    while (Entry != NULL) {
+        CXPLAT_LOOPBACK_BINDING* Binding =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_LOOPBACK_BINDING, Entry);
+        if (Socket == NULL || Binding->Socket == Socket) {
+            return Binding;
+        }
+        Entry = CxPlatHashtableLookupNext(&Loopback->Bindings, &Context);
+    }
+    return NULL;
+}
+
+static
+void
+CxPlatLoopbackFreePackets(
+    _In_ CXPLAT_LIST_ENTRY* List
+    )
+{
+    while (!CxPlatListIsEmpty(List)) {
+        CXPLAT_LOOPBACK_PACKET* Packet =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(List), CXPLAT_LOOPBACK_PACKET, Link);
+        CxPlatLoopbackBindingRelease(Packet->Binding, 1);
+        CxPlatPoolFree(Packet);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+CxPlatLoopbackExecute(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    )
+{
+    CXPLAT_LOOPBACK_PARTITION* Partition = (CXPLAT_LOOPBACK_PARTITION*)Context;
+    CXPLAT_DATAPATH_LOOPBACK* Loopback = Partition->Loopback;
+
+    CXPLAT_LIST_ENTRY Due;
+    CxPlatListInitializeHead(&Due);
+
+    if (!Loopback->Running) {
+        CxPlatLockAcquire(&Partition->Lock);
+        CxPlatListMoveItems(&Partition->Queue, &Due);
+        CxPlatLockRelease(&Partition->Lock);
+        CxPlatLoopbackFreePackets(&Due);
+        CxPlatRundownRelease(&Loopback->Rundown);
+        return FALSE;
+    }
+
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    CxPlatLockAcquire(&Partition->Lock);
+    while (!CxPlatListIsEmpty(&Partition->Queue)) {
+        CXPLAT_LOOPBACK_PACKET* Packet =
+            CXPLAT_CONTAINING_RECORD(
+                Partition->Queue.Flink, CXPLAT_LOOPBACK_PACKET, Link);
+        if (Packet->DueTime > TimeNow) {
+            break;
+        }
+        CxPlatListInsertTail(&Due, CxPlatListRemoveHead(&Partition->Queue));
+    }
+    Partition->Ec.NextTimeUs =
+        CxPlatListIsEmpty(&Partition->Queue) ?
+            UINT64_MAX :
+            CXPLAT_CONTAINING_RECORD(
+                Partition->Queue.Flink, CXPLAT_LOOPBACK_PACKET, Link)->DueTime;
+    CxPlatLockRelease(&Partition->Lock);
+
+    //
+    // Indicate runs of datagrams to the same socket as a single chain.
+    //
+    while (!CxPlatListIsEmpty(&Due)) {
+        CXPLAT_LOOPBACK_PACKET* Packet =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Due), CXPLAT_LOOPBACK_PACKET, Link);
+        CXPLAT_LOOPBACK_BINDING* Binding = Packet->Binding;
+        CXPLAT_RECV_DATA* Chain = &Packet->RecvData;
+        CXPLAT_RECV_DATA** Tail = &Packet->RecvData.Next;
+        uint32_t Count = 1;
+        Packet->RecvData.RecvTime = TimeNow;
+        while (!CxPlatListIsEmpty(&Due)) {
+            Packet =
+                CXPLAT_CONTAINING_RECORD(Due.Flink, CXPLAT_LOOPBACK_PACKET, Link);
+            if (Packet->Binding != Binding) {
+                break;
+            }
+            CxPlatListRemoveHead(&Due);
+            Packet->RecvData.RecvTime = TimeNow;
+            *Tail = &Packet->RecvData;
+            Tail = &Packet->RecvData.Next;
+            Count++;
+        }
+
+        if (CxPlatRundownAcquire(&Binding->Rundown)) {
+            Loopback->Datapath->UdpHandlers.Receive(
+                Binding->Socket, Binding->Socket->ClientContext, Chain);
+            CxPlatRundownRelease(&Binding->Rundown);
+        } else {
+            LoopbackRecvDataReturn(Chain); // The socket is being deleted.
+        }
+        CxPlatLoopbackBindingRelease(Binding, Count);
+    }
+
+    State->NoWorkCount = 0;
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+LoopbackDataPathInitialize(
+    _In_ uint32_t ClientRecvContextLength,
+    _In_ CXPLAT_DATAPATH* ParentDataPath,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_LOOPBACK_CONFIG* Config,
+    _Out_ CXPLAT_DATAPATH_LOOPBACK** NewDataPath
+    )
+{
+    const uint16_t PartitionCount = (uint16_t)CxPlatWorkerPoolGetCount(WorkerPool);
+    const size_t DatapathSize =
+        sizeof(CXPLAT_DATAPATH_LOOPBACK) +
+        PartitionCount * sizeof(CXPLAT_LOOPBACK_PARTITION);
+
+    CXPLAT_DATAPATH_LOOPBACK* Loopback =
+        CXPLAT_ALLOC_NONPAGED(DatapathSize, QUIC_POOL_DATAPATH_LOOPBACK);
+    if (Loopback == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_DATAPATH_LOOPBACK",
+            DatapathSize);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    CxPlatZeroMemory(Loopback, DatapathSize);
+    if (!CxPlatHashtableInitializeEx(&Loopback->Bindings, CXPLAT_HASH_MIN_SIZE)) {
+        CXPLAT_FREE(Loopback, QUIC_POOL_DATAPATH_LOOPBACK);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    Loopback->Datapath = ParentDataPath;
+    Loopback->Config = *Config;
+    Loopback->ClientRecvContextLength = ClientRecvContextLength;
+    Loopback->Running = TRUE;
+    Loopback->RandomState = 0x9E3779B97F4A7C15ull;
+    Loopback->PartitionCount = PartitionCount;
+    CxPlatLockInitialize(&Loopback->Lock);
+    CxPlatPoolInitialize(
+        FALSE,
+        sizeof(CXPLAT_LOOPBACK_PACKET) + ClientRecvContextLength + MAX_UDP_PAYLOAD_LENGTH,
+        QUIC_POOL_DATAPATH_LOOPBACK,
+        &Loopback->PacketPool);
+    CxPlatPoolInitialize(
+        FALSE,
+        sizeof(CXPLAT_LOOPBACK_SEND_DATA),
+        QUIC_POOL_DATAPATH_LOOPBACK,
+        &Loopback->SendDataPool);
+    CxPlatRundownInitialize(&Loopback->Rundown);
+
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        CXPLAT_LOOPBACK_PARTITION* Partition = &Loopback->Partitions[i];
+        Partition->Loopback = Loopback;
+        CxPlatLockInitialize(&Partition->Lock);
+        CxPlatListInitializeHead(&Partition->Queue);
+        Partition->Ec.Ready = FALSE;
+        Partition->Ec.NextTimeUs = UINT64_MAX;
+        Partition->Ec.Callback = CxPlatLoopbackExecute;
+        Partition->Ec.Context = Partition;
+        CXPLAT_FRE_ASSERT(CxPlatRundownAcquire(&Loopback->Rundown));
+        CxPlatWorkerPoolAddExecutionContext(WorkerPool, &Partition->Ec, i);
+    }
+
+    QuicTraceLogInfo(
+        LoopbackDatapathInit,
+        "[loop][%p] Loopback datapath initialized, delay:%u us, loss:%u ppm, rate:%llu bps",
+        Loopback,
+        Config->DelayUs,
+        Config->LossRate,
+        Config->Bandwidth);
+
+    *NewDataPath = Loopback;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+LoopbackDataPathUninitialize(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback
+    )
+{
+    //
+    // Each partition frees anything still queued and releases its reference
+    // the next time it runs.
+    //
+    Loopback->Running = FALSE;
+    for (uint16_t i = 0; i < Loopback->PartitionCount; i++) {
+        Loopback->Partitions[i].Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Loopback->Partitions[i].Ec);
+    }
+    CxPlatRundownReleaseAndWait(&Loopback->Rundown);
+
+    for (uint16_t i = 0; i < Loopback->PartitionCount; i++) {
+        CxPlatLockUninitialize(&Loopback->Partitions[i].Lock);
+    }
+    CxPlatRundownUninitialize(&Loopback->Rundown);
+    CxPlatPoolUninitialize(&Loopback->SendDataPool);
+    CxPlatPoolUninitialize(&Loopback->PacketPool);
+    CxPlatHashtableUninitialize(&Loopback->Bindings);
+    CxPlatLockUninitialize(&Loopback->Lock);
+    CXPLAT_FREE(Loopback, QUIC_POOL_DATAPATH_LOOPBACK);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_DATAPATH_FEATURES
+LoopbackDataPathGetSupportedFeatures(
+    _In_ CXPLAT_DATAPATH_FEATURES SocketFeatures
+    )
+{
+    //
+    // Keep what the sockets themselves provide, but nothing about how
+    // datagrams are sent or received.
+    //
+    return
+        (SocketFeatures &
+            (CXPLAT_DATAPATH_FEATURE_LOCAL_PORT_SHARING |
+             CXPLAT_DATAPATH_FEATURE_PORT_RESERVATIONS |
+             CXPLAT_DATAPATH_FEATURE_TCP)) |
+        CXPLAT_DATAPATH_FEATURE_SEND_DSCP |
+        CXPLAT_DATAPATH_FEATURE_RECV_DSCP |
+        CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+LoopbackSocketCreateUdp(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _In_ const CXPLAT_UDP_CONFIG* Config,
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    CXPLAT_LOOPBACK_BINDING* Binding =
+        CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_LOOPBACK_BINDING), QUIC_POOL_DATAPATH_LOOPBACK);
+    if (Binding == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_LOOPBACK_BINDING",
+            sizeof(CXPLAT_LOOPBACK_BINDING));
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    CxPlatZeroMemory(Binding, sizeof(*Binding));
+    Binding->Socket = Socket;
+    CxPlatRefInitialize(&Binding->RefCount);
+    CxPlatRundownInitialize(&Binding->Rundown);
+    Binding->PartitionIndex = Config->PartitionIndex % Loopback->PartitionCount;
+    Binding->HasFixedRemoteAddress = Config->RemoteAddress != NULL;
+
+    CxPlatLockAcquire(&Loopback->Lock);
+    CxPlatHashtableInsert(
+        &Loopback->Bindings,
+        &Binding->Entry,
+        QuicAddrGetPort(&Socket->LocalAddress),
+        NULL);
+    CxPlatLockRelease(&Loopback->Lock);
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+LoopbackSocketDelete(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    CxPlatLockAcquire(&Loopback->Lock);
+    CXPLAT_LOOPBACK_BINDING* Binding =
+        CxPlatLoopbackLookupBinding(
+            Loopback, QuicAddrGetPort(&Socket->LocalAddress), Socket);
+    if (Binding != NULL) {
+        CxPlatHashtableRemove(&Loopback->Bindings, &Binding->Entry, NULL);
+    }
+    CxPlatLockRelease(&Loopback->Lock);
+
+    if (Binding != NULL) {
+        //
+        // Wait for in progress indications. Anything still queued is dropped
+        // on delivery.
+        //
+        CxPlatRundownReleaseAndWait(&Binding->Rundown);
+        CxPlatLoopbackBindingRelease(Binding, 1);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackRecvDataReturn(
+    _In_opt_ CXPLAT_RECV_DATA* RecvDataChain
+    )
+{
+    while (RecvDataChain != NULL) {
+        CXPLAT_LOOPBACK_PACKET* Packet = CxPlatLoopbackRecvToPacket(RecvDataChain);
+        RecvDataChain = RecvDataChain->Next;
+        CXPLAT_DBG_ASSERT(Packet->RecvData.Allocated);
+        Packet->RecvData.Allocated = FALSE;
+        CxPlatPoolFree(Packet);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+CXPLAT_SEND_DATA*
+LoopbackSendDataAlloc(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _Inout_ CXPLAT_SEND_CONFIG* Config
+    )
+{
+    CXPLAT_LOOPBACK_SEND_DATA* SendData = CxPlatPoolAlloc(&Loopback->SendDataPool);
+    if (SendData != NULL) {
+        SendData->DatapathType = CXPLAT_DATAPATH_TYPE_LOOPBACK;
+        SendData->ECN = Config->ECN;
+        SendData->DSCP = Config->DSCP;
+        SendData->TotalSize = 0;
+        SendData->SegmentSize = 0;
+        SendData->Loopback = Loopback;
+        SendData->PacketCount = 0;
+    }
+    return (CXPLAT_SEND_DATA*)SendData;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackSendDataFree(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CXPLAT_LOOPBACK_SEND_DATA* LoopbackSendData = (CXPLAT_LOOPBACK_SEND_DATA*)SendData;
+    for (uint8_t i = 0; i < LoopbackSendData->PacketCount; i++) {
+        if (LoopbackSendData->Packets[i] != NULL) {
+            CxPlatPoolFree(LoopbackSendData->Packets[i]);
+        }
+    }
+    CxPlatPoolFree(LoopbackSendData);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_BUFFER*
+LoopbackSendDataAllocBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ uint16_t MaxBufferLength
+    )
+{
+    CXPLAT_LOOPBACK_SEND_DATA* LoopbackSendData = (CXPLAT_LOOPBACK_SEND_DATA*)SendData;
+    CXPLAT_DBG_ASSERT(MaxBufferLength <= MAX_UDP_PAYLOAD_LENGTH);
+    if (LoopbackSendData->PacketCount == CXPLAT_LOOPBACK_MAX_BATCH) {
+        return NULL;
+    }
+    CXPLAT_LOOPBACK_PACKET* Packet =
+        CxPlatPoolAlloc(&LoopbackSendData->Loopback->PacketPool);
+    if (Packet == NULL) {
+        return NULL;
+    }
+    Packet->Loopback = LoopbackSendData->Loopback;
+    Packet->Buffer.Buffer = CxPlatLoopbackPacketPayload(Packet->Loopback, Packet);
+    Packet->Buffer.Length = MaxBufferLength;
+    LoopbackSendData->Packets[LoopbackSendData->PacketCount++] = Packet;
+    LoopbackSendData->TotalSize += MaxBufferLength;
+    return &Packet->Buffer;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackSendDataFreeBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ QUIC_BUFFER* Buffer
+    )
+{
+    CXPLAT_LOOPBACK_SEND_DATA* LoopbackSendData = (CXPLAT_LOOPBACK_SEND_DATA*)SendData;
+    CXPLAT_DBG_ASSERT(LoopbackSendData->PacketCount > 0);
+    CXPLAT_LOOPBACK_PACKET* Packet =
+        LoopbackSendData->Packets[LoopbackSendData->PacketCount - 1];
+    CXPLAT_DBG_ASSERT(Buffer == &Packet->Buffer);
+    UNREFERENCED_PARAMETER(Buffer);
+    LoopbackSendData->TotalSize -= Packet->Buffer.Length;
+    LoopbackSendData->PacketCount--;
+    CxPlatPoolFree(Packet);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LoopbackSendDataIsFull(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    return
+        ((CXPLAT_LOOPBACK_SEND_DATA*)SendData)->PacketCount == CXPLAT_LOOPBACK_MAX_BATCH;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackSocketSend(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CXPLAT_LOOPBACK_SEND_DATA* LoopbackSendData = (CXPLAT_LOOPBACK_SEND_DATA*)SendData;
+    CXPLAT_DATAPATH_LOOPBACK* Loopback = LoopbackSendData->Loopback;
+    const CXPLAT_LOOPBACK_CONFIG* Config = &Loopback->Config;
+    const uint64_t TimeNow = CxPlatTimeUs64();
+
+    //
+    // The receiver sees the datagrams as coming from the sender's local
+    // address, which is made specific if the sender is bound to a wildcard.
+    //
+    QUIC_ADDR SourceAddress = Route->LocalAddress;
+    if (QuicAddrGetPort(&SourceAddress) == 0) {
+        SourceAddress = Socket->LocalAddress;
+    }
+    if (QuicAddrIsWildCard(&SourceAddress)) {
+        const uint16_t Port = QuicAddrGetPort(&SourceAddress);
+        QuicAddrSetFamily(&SourceAddress, QuicAddrGetFamily(&Route->RemoteAddress));
+        QuicAddrSetToLoopback(&SourceAddress);
+        QuicAddrSetPort(&SourceAddress, Port);
+    }
+
+    CXPLAT_LIST_ENTRY Queued;
+    CxPlatListInitializeHead(&Queued);
+    uint16_t PartitionIndex = 0;
+
+    CxPlatLockAcquire(&Loopback->Lock);
+    CXPLAT_LOOPBACK_BINDING* Binding =
+        CxPlatLoopbackLookupBinding(
+            Loopback, QuicAddrGetPort(&Route->RemoteAddress), NULL);
+    if (Binding != NULL) {
+        //
+        // Datagrams for a connected socket are handled on its partition.
+        // Otherwise, they stay on the sender's, as if RSS hashed them there.
+        //
+        PartitionIndex = Binding->PartitionIndex;
+        if (!Binding->HasFixedRemoteAddress) {
+            CXPLAT_LOOPBACK_BINDING* Source =
+                CxPlatLoopbackLookupBinding(
+                    Loopback, QuicAddrGetPort(&Socket->LocalAddress), Socket);
+            if (Source != NULL) {
+                PartitionIndex = Source->PartitionIndex;
+            }
+        }
+
+        for (uint8_t i = 0; i < LoopbackSendData->PacketCount; i++) {
+            CXPLAT_LOOPBACK_PACKET* Packet = LoopbackSendData->Packets[i];
+            if (Config->LossRate != 0) {
+                uint64_t x = Loopback->RandomState;
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                Loopback->RandomState = x;
+                if (x % 1000000 < Config->LossRate) {
+                    continue;
+                }
+            }
+
+            uint64_t DepartureTime = TimeNow;
+            if (Config->Bandwidth != 0) {
+                if (Binding->LinkIdleTime > DepartureTime) {
+                    DepartureTime = Binding->LinkIdleTime;
+                }
+                DepartureTime +=
+                    (uint64_t)Packet->Buffer.Length * 8 * 1000000 / Config->Bandwidth;
+                Binding->LinkIdleTime = DepartureTime;
+            }
+            Packet->DueTime = DepartureTime + Config->DelayUs;
+
+            CxPlatRefIncrement(&Binding->RefCount);
+            Packet->Binding = Binding;
+            LoopbackSendData->Packets[i] = NULL;
+            CxPlatListInsertTail(&Queued, &Packet->Link);
+        }
+    }
+    CxPlatLockRelease(&Loopback->Lock);
+
+    if (!CxPlatListIsEmpty(&Queued)) {
+        CXPLAT_LOOPBACK_PARTITION* Partition = &Loopback->Partitions[PartitionIndex];
+        CxPlatLockAcquire(&Partition->Lock);
+        while (!CxPlatListIsEmpty(&Queued)) {
+            CXPLAT_LOOPBACK_PACKET* Packet =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&Queued), CXPLAT_LOOPBACK_PACKET, Link);
+
+            CxPlatZeroMemory(&Packet->Route, sizeof(Packet->Route));
+            Packet->Route.RemoteAddress = SourceAddress;
+            Packet->Route.LocalAddress = Route->RemoteAddress;
+            Packet->Route.DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
+            Packet->Route.State = RouteResolved;
+
+            CXPLAT_RECV_DATA* RecvData = &Packet->RecvData;
+            RecvData->Next = NULL;
+            RecvData->Route = &Packet->Route;
+            RecvData->Buffer = Packet->Buffer.Buffer;
+            RecvData->BufferLength = (uint16_t)Packet->Buffer.Length;
+            RecvData->PartitionIndex = PartitionIndex;
+            RecvData->TypeOfService =
+                (uint8_t)(LoopbackSendData->ECN | (LoopbackSendData->DSCP << 2));
+            RecvData->HopLimitTTL = 0;
+            RecvData->Allocated = TRUE;
+            RecvData->QueuedOnConnection = FALSE;
+            RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_LOOPBACK;
+            RecvData->Reserved = 0;
+            RecvData->ReservedEx = 0;
+
+            //
+            // Keep the queue sorted by due time. With a fixed delay, new
+            // datagrams are almost always due last.
+            //
+            CXPLAT_LIST_ENTRY* Prev = Partition->Queue.Blink;
+            while (Prev != &Partition->Queue &&
+                   CXPLAT_CONTAINING_RECORD(Prev, CXPLAT_LOOPBACK_PACKET, Link)->DueTime >
+                        Packet->DueTime) {
+                Prev = Prev->Blink;
+            }
+            CxPlatListInsertHead(Prev, &Packet->Link);
+        }
+        CxPlatLockRelease(&Partition->Lock);
+
+        Partition->Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Partition->Ec);
+    }
+
+    LoopbackSendDataFree(SendData); // Frees any datagrams that were dropped.
+}
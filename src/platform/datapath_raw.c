@@ -24,6 +24,7 @@ RawDataPathInitialize(
     _In_ uint32_t ClientRecvContextLength,
     _In_opt_ const CXPLAT_DATAPATH* ParentDataPath,
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig,
     _Outptr_result_maybenull_ CXPLAT_DATAPATH_RAW** NewDataPath
     )
 {
@@ -53,7 +54,7 @@ RawDataPathInitialize(
     }
     SockPoolInitialized = TRUE;
 
-    Status = CxPlatDpRawInitialize(DataPath, ClientRecvContextLength, WorkerPool);
+    Status = CxPlatDpRawInitialize(DataPath, ClientRecvContextLength, WorkerPool, InitConfig);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
@@ -192,8 +193,15 @@ RawSocketGetLocalMtu(
     _In_ CXPLAT_ROUTE* Route
     )
 {
+    uint16_t Mtu = CXPLAT_MAX_MTU;
+    if (Route->Queue != NULL) {
+        const CXPLAT_INTERFACE* Interface = CxPlatDpRawGetInterfaceFromQueue(Route->Queue);
+        if (Interface->Mtu > Mtu) {
+            Mtu = Interface->Mtu;
+        }
+    }
     // Reserve space for TCP header.
-    return Route->UseQTIP ? 1488 : 1500;
+    return Route->UseQTIP ? Mtu - 12 : Mtu;
 
 }
 
@@ -327,9 +335,14 @@ RawSendDataIsFull(
 
 #define TH_ACK 0x10
 
+//
+// Writes the headers for the send. Returns FALSE if the send was instead held
+// back until the QTIP handshake completes.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_STATUS
-RawSocketSend(
+static
+BOOLEAN
+RawSocketFrameSend(
     _In_ CXPLAT_SOCKET_RAW* Socket,
     _In_ const CXPLAT_ROUTE* Route,
     _In_ CXPLAT_SEND_DATA* SendData
@@ -341,7 +354,7 @@ RawSocketSend(
         Route->TcpState.Syncd == FALSE) {
         Socket->PausedTcpSend = SendData;
         CxPlatDpRawSocketSyn(Socket, Route);
-        return QUIC_STATUS_SUCCESS;
+        return FALSE;
     }
 
     QuicTraceEvent(
@@ -363,6 +376,46 @@ RawSocketSend(
         Route->TcpState.SequenceNumber,
         Route->TcpState.AckNumber,
         TH_ACK);
-    CxPlatDpRawTxEnqueue(SendData);
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+RawSocketSend(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    if (RawSocketFrameSend(Socket, Route, SendData)) {
+        CxPlatDpRawTxEnqueue(SendData);
+    }
     return QUIC_STATUS_SUCCESS;
 }
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+RawSocketSendBatch(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    //
+    // Frame each run of packets, then hand the run to the device at once. A
+    // send held back for the QTIP handshake ends the run.
+    //
+    uint32_t RunStart = 0;
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (!RawSocketFrameSend(Socket, &Routes[i], SendData[i])) {
+            if (i > RunStart) {
+                CxPlatDpRawTxEnqueueBatch(SendData + RunStart, i - RunStart);
+            }
+            RunStart = i + 1;
+        }
+    }
+    if (Count > RunStart) {
+        CxPlatDpRawTxEnqueueBatch(SendData + RunStart, Count - RunStart);
+    }
+}
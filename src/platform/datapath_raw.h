@@ -73,6 +73,7 @@ typedef struct CXPLAT_INTERFACE {
     uint32_t IfIndex;
     uint32_t ActualIfIndex;
     uint8_t PhysicalAddress[ETH_MAC_ADDR_LEN];
+    uint16_t Mtu; // Zero if only the default CXPLAT_MAX_MTU is supported.
     struct {
         struct {
             BOOLEAN NetworkLayerXsum : 1;
@@ -112,7 +113,8 @@ QUIC_STATUS
 CxPlatDpRawInitialize(
     _Inout_ CXPLAT_DATAPATH_RAW* Datapath,
     _In_ uint32_t ClientRecvContextLength,
-    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig
     );
 
 //
@@ -270,6 +272,17 @@ CxPlatDpRawTxEnqueue(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+//
+// Enqueues a batch of TX send objects to be sent out on the raw datapath
+// device, amortizing the queue lock and device notification across them.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxEnqueueBatch(
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    );
+
 //
 // Sets the TX send object to have the specified L3 checksum offload settings.
 //
@@ -56,12 +56,14 @@ RawDataPathInitialize(
     _In_ uint32_t ClientRecvContextLength,
     _In_opt_ const CXPLAT_DATAPATH* ParentDataPath,
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig,
     _Outptr_result_maybenull_ CXPLAT_DATAPATH_RAW** DataPath
     )
 {
     UNREFERENCED_PARAMETER(ClientRecvContextLength);
     UNREFERENCED_PARAMETER(ParentDataPath);
     UNREFERENCED_PARAMETER(WorkerPool);
+    UNREFERENCED_PARAMETER(InitConfig);
     *DataPath = NULL;
 }
 
@@ -207,6 +209,21 @@ RawSocketSend(
     return QUIC_STATUS_NOT_SUPPORTED;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+RawSocketSendBatch(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(Routes);
+    UNREFERENCED_PARAMETER(SendData);
+    UNREFERENCED_PARAMETER(Count);
+}
+
 void
 RawResolveRouteComplete(
     _In_ void* Context,
@@ -49,6 +49,11 @@ typedef struct QUIC_CACHEALIGN XDP_PARTITION {
     CXPLAT_QUEUE* Queues; // A linked list of queues, accessed by Next.
     uint16_t PartitionIndex;
     uint16_t Processor;
+    //
+    // Poll moderation state. Only used by the Windows XDP datapath.
+    //
+    uint8_t PollMode;           // CXPLAT_XDP_POLL_MODE
+    uint64_t RxRateTimeUs;      // Start of the current rate sampling interval
 } XDP_PARTITION;
 
 void XdpWorkerAddQueue(_In_ XDP_PARTITION* Partition, _In_ CXPLAT_QUEUE* Queue) {
@@ -32,25 +32,41 @@ Abstract:
 #define PROD_NUM_DESCS     NUM_FRAMES / 2
 #define FRAME_SIZE         XSK_UMEM__DEFAULT_FRAME_SIZE // TODO: 2K mode
 #define INVALID_UMEM_FRAME UINT64_MAX
+#define UMEM_FREE_LIST_END UINT32_MAX
+
+//
+// The largest Ethernet frame supported with multi-buffer (XDP_USE_SG)
+// descriptors, and the most UMEM frames such a frame can span.
+//
+#define MAX_JUMBO_ETH_FRAME_SIZE (CXPLAT_MAX_JUMBO_MTU + (MAX_ETH_FRAME_SIZE - CXPLAT_MAX_MTU))
+#define MAX_FRAME_FRAGMENTS      8
 
 struct XskSocketInfo {
     struct xsk_ring_cons Rx;
     struct xsk_ring_prod Tx;
+    struct xsk_ring_prod Fq;
+    struct xsk_ring_cons Cq;
     struct XskUmemInfo *UmemInfo;
     struct xsk_socket *Xsk;
-
-    CXPLAT_LOCK UmemLock;
-    uint64_t UmemFrameAddr[NUM_FRAMES];
-    uint32_t UmemFrameFree;
+    uint32_t FillLimit; // Max frames posted to the fill ring.
 };
 
 struct XskUmemInfo {
-    struct xsk_ring_prod Fq;
-    struct xsk_ring_cons Cq;
     struct xsk_umem *Umem;
     void *Buffer;
     uint32_t RxHeadRoom;
     uint32_t TxHeadRoom;
+    uint32_t NumFrames;
+    uint32_t RefCount; // Number of queues using this UMEM.
+
+    //
+    // Lock-free stack of free frame indexes, shared by every queue using the
+    // UMEM. The head holds an ABA tag in the upper 32 bits and the index of the
+    // top frame in the lower 32 bits.
+    //
+    int64_t FreeHead;
+    int64_t FreeCount;
+    uint32_t NextFree[0];
 };
 
 // TODO: remove this exception when finalizing members
@@ -67,6 +83,7 @@ typedef struct XDP_DATAPATH { // NOLINT(clang-analyzer-optin.performance.Padding
     uint32_t PollingIdleTimeoutUs;
     BOOLEAN TxAlwaysPoke;
     BOOLEAN SkipXsum;
+    BOOLEAN ShareUmem;      // One UMEM for all queues of an interface.
     BOOLEAN Running;        // Signal to stop workers.
 
     CXPLAT_RUNDOWN_REF Rundown;
@@ -106,6 +123,9 @@ typedef struct CXPLAT_QUEUE {
     CXPLAT_LOCK FqLock;
     CXPLAT_LOCK CqLock;
 
+    // Contiguous staging buffers for frames spanning multiple UMEM frames.
+    CXPLAT_POOL JumboPool;
+
     struct XskSocketInfo* XskInfo;
 } CXPLAT_QUEUE;
 
@@ -113,6 +133,7 @@ typedef struct __attribute__((aligned(64))) XDP_RX_PACKET {
     CXPLAT_QUEUE* Queue;
     CXPLAT_ROUTE RouteStorage;
     uint64_t Addr;
+    uint8_t* JumboBuffer; // Reassembled multi-buffer frame, if any.
     CXPLAT_RECV_DATA RecvData;
     // Followed by:
     // uint8_t ClientContext[...];
@@ -124,7 +145,9 @@ typedef struct __attribute__((aligned(64))) XDP_TX_PACKET {
     uint64_t UmemRelativeAddr;
     CXPLAT_QUEUE* Queue;
     CXPLAT_LIST_ENTRY Link;
-    uint8_t FrameBuffer[MAX_ETH_FRAME_SIZE];
+    uint8_t* JumboBuffer; // Staging buffer if the frame exceeds FrameBuffer.
+    // Aligned to match the TX headroom the descriptors are offset by.
+    uint8_t FrameBuffer[MAX_ETH_FRAME_SIZE] __attribute__((aligned(32)));
 } XDP_TX_PACKET;
 
 CXPLAT_EVENT_COMPLETION CxPlatPartitionShutdownEventComplete;
@@ -195,6 +218,31 @@ CxPlatGetInterfaceRssQueueCount(
     return QUIC_STATUS_SUCCESS;
 }
 
+QUIC_STATUS
+CxPlatGetInterfaceMtu(
+    _In_ const char* IfName,
+    _Out_ uint16_t* Mtu
+    )
+{
+    char Path[256];
+    snprintf(Path, sizeof(Path), "/sys/class/net/%s/mtu", IfName);
+
+    FILE* File = fopen(Path, "r");
+    if (File == NULL) {
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
+    unsigned int Value = 0;
+    int Ret = fscanf(File, "%u", &Value);
+    fclose(File);
+    if (Ret != 1 || Value == 0) {
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
+    *Mtu = (uint16_t)CXPLAT_MIN(Value, CXPLAT_MAX_JUMBO_MTU);
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 CxPlatXdpReadConfig(
@@ -209,6 +257,9 @@ CxPlatXdpReadConfig(
 
 void UninitializeUmem(struct XskUmemInfo* UmemInfo)
 {
+    if (--UmemInfo->RefCount > 0) {
+        return;
+    }
     if (xsk_umem__delete(UmemInfo->Umem) != 0) {
         QuicTraceLogVerbose(
             XdpUmemDeleteFails,
@@ -268,7 +319,6 @@ CxPlatDpRawInterfaceUninitialize(
             if (Queue->XskInfo->UmemInfo) {
                 UninitializeUmem(Queue->XskInfo->UmemInfo);
             }
-            CxPlatLockUninitialize(&Queue->XskInfo->UmemLock);
             free(Queue->XskInfo);
         }
 
@@ -276,6 +326,7 @@ CxPlatDpRawInterfaceUninitialize(
         CxPlatLockUninitialize(&Queue->RxLock);
         CxPlatLockUninitialize(&Queue->CqLock);
         CxPlatLockUninitialize(&Queue->FqLock);
+        CxPlatPoolUninitialize(&Queue->JumboPool);
     }
 
     if (Interface->Queues != NULL) {
@@ -293,13 +344,19 @@ CxPlatDpRawInterfaceUninitialize(
     }
 }
 
-static QUIC_STATUS InitializeUmem(uint32_t FrameSize, uint32_t NumFrames, uint32_t RxHeadRoom, uint32_t TxHeadRoom, struct XskUmemInfo* UmemInfo)
+static QUIC_STATUS InitializeUmem(uint32_t FrameSize, uint32_t NumFrames, uint32_t RxHeadRoom, uint32_t TxHeadRoom, struct XskSocketInfo* XskInfo)
 {
+    struct XskUmemInfo *UmemInfo = calloc(1, sizeof(struct XskUmemInfo) + NumFrames * sizeof(uint32_t));
+    if (!UmemInfo) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
     void *Buffer = NULL;
     if (posix_memalign(&Buffer, getpagesize(), (size_t)(FrameSize) * NumFrames)) {
         QuicTraceLogVerbose(
             XdpAllocUmem,
             "[ xdp] Failed to allocate umem");
+        free(UmemInfo);
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
@@ -311,42 +368,129 @@ static QUIC_STATUS InitializeUmem(uint32_t FrameSize, uint32_t NumFrames, uint32
         .flags = 0
     };
 
-    int Ret = xsk_umem__create(&UmemInfo->Umem, Buffer, (uint64_t)(FrameSize) * NumFrames, &UmemInfo->Fq, &UmemInfo->Cq, &UmemConfig);
+    //
+    // The fill and completion rings passed here belong to the first socket
+    // bound to the UMEM; sockets sharing it later bring their own.
+    //
+    int Ret = xsk_umem__create(&UmemInfo->Umem, Buffer, (uint64_t)(FrameSize) * NumFrames, &XskInfo->Fq, &XskInfo->Cq, &UmemConfig);
     if (Ret) {
         errno = -Ret;
         free(Buffer);
+        free(UmemInfo);
         return QUIC_STATUS_INTERNAL_ERROR;
     }
 
     UmemInfo->Buffer = Buffer;
     UmemInfo->RxHeadRoom = RxHeadRoom;
     UmemInfo->TxHeadRoom = TxHeadRoom;
+    UmemInfo->NumFrames = NumFrames;
+    UmemInfo->RefCount = 1;
+    for (uint32_t i = 0; i < NumFrames; i++) {
+        UmemInfo->NextFree[i] = i + 1 < NumFrames ? i + 1 : UMEM_FREE_LIST_END;
+    }
+    UmemInfo->FreeHead = 0;
+    UmemInfo->FreeCount = NumFrames;
+    XskInfo->UmemInfo = UmemInfo;
     return QUIC_STATUS_SUCCESS;
 }
 
+static int64_t XskUmemFreeHead(int64_t Head, uint32_t Index)
+{
+    //
+    // Bump the tag on every update so a stale head can't be swapped back in
+    // after the same index was popped and pushed again (ABA).
+    //
+    return (int64_t)(((((uint64_t)Head >> 32) + 1) << 32) | Index);
+}
+
 static uint64_t XskUmemFreeFrames(struct XskSocketInfo *Xsk)
 {
-    return Xsk->UmemFrameFree;
+    const int64_t FreeCount = Xsk->UmemInfo->FreeCount;
+    return FreeCount > 0 ? (uint64_t)FreeCount : 0;
 }
 
 static uint64_t XskUmemFrameAlloc(struct XskSocketInfo *Xsk)
 {
-    uint64_t Frame;
-    if (Xsk->UmemFrameFree == 0) {
-        QuicTraceLogVerbose(
-            XdpUmemAllocFails,
-            "[ xdp][umem] Out of UMEM frame, OOM");
-        return INVALID_UMEM_FRAME;
+    struct XskUmemInfo* UmemInfo = Xsk->UmemInfo;
+    int64_t Head = UmemInfo->FreeHead;
+    for (;;) {
+        const uint32_t Index = (uint32_t)Head;
+        if (Index == UMEM_FREE_LIST_END) {
+            QuicTraceLogVerbose(
+                XdpUmemAllocFails,
+                "[ xdp][umem] Out of UMEM frame, OOM");
+            return INVALID_UMEM_FRAME;
+        }
+        const int64_t NewHead = XskUmemFreeHead(Head, UmemInfo->NextFree[Index]);
+        const int64_t OldHead = InterlockedCompareExchange64(&UmemInfo->FreeHead, NewHead, Head);
+        if (OldHead == Head) {
+            InterlockedDecrement64(&UmemInfo->FreeCount);
+            return (uint64_t)Index * FRAME_SIZE;
+        }
+        Head = OldHead;
     }
-    Frame = Xsk->UmemFrameAddr[--Xsk->UmemFrameFree];
-    Xsk->UmemFrameAddr[Xsk->UmemFrameFree] = INVALID_UMEM_FRAME;
-    return Frame;
 }
 
 static void XskUmemFrameFree(struct XskSocketInfo *Xsk, uint64_t Frame)
 {
-    assert(Xsk->UmemFrameFree < NUM_FRAMES);
-    Xsk->UmemFrameAddr[Xsk->UmemFrameFree++] = Frame;
+    struct XskUmemInfo* UmemInfo = Xsk->UmemInfo;
+    const uint32_t Index = (uint32_t)(Frame / FRAME_SIZE);
+    assert(Index < UmemInfo->NumFrames);
+    int64_t Head = UmemInfo->FreeHead;
+    for (;;) {
+        UmemInfo->NextFree[Index] = (uint32_t)Head;
+        const int64_t OldHead =
+            InterlockedCompareExchange64(&UmemInfo->FreeHead, XskUmemFreeHead(Head, Index), Head);
+        if (OldHead == Head) {
+            break;
+        }
+        Head = OldHead;
+    }
+    InterlockedIncrement64(&UmemInfo->FreeCount);
+}
+
+static int
+XskSocketCreate(
+    _In_ XDP_INTERFACE* Interface,
+    _In_ uint32_t QueueId,
+    _Inout_ struct XskSocketInfo* XskInfo,
+    _Inout_ struct xsk_socket_config* XskCfg
+    )
+{
+    int Ret;
+    for (;;) {
+        int RetryCount = 10;
+        do {
+            Ret = xsk_socket__create_shared(&XskInfo->Xsk, Interface->IfName,
+                        QueueId, XskInfo->UmemInfo->Umem, &XskInfo->Rx,
+                        &XskInfo->Tx, &XskInfo->Fq, &XskInfo->Cq, XskCfg);
+            if (Ret == -EBUSY) {
+                CxPlatSleep(100);
+            }
+        } while (Ret == -EBUSY && RetryCount-- > 0);
+        if (Ret >= 0) {
+            break;
+        }
+
+        //
+        // Drop optional features one at a time until the driver accepts the
+        // bind. The config is shared, so later queues skip the failed modes.
+        //
+        QuicTraceLogVerbose(
+            FailXskSocketCreate,
+            "[ xdp] Failed to create XDP socket for %s. error:%s", Interface->IfName, strerror(-Ret));
+        if (XskCfg->bind_flags & XDP_ZEROCOPY) {
+            XskCfg->bind_flags &= ~XDP_ZEROCOPY;
+            XskCfg->bind_flags |= XDP_COPY;
+#ifdef XDP_USE_SG
+        } else if (XskCfg->bind_flags & XDP_USE_SG) {
+            XskCfg->bind_flags &= ~XDP_USE_SG;
+#endif
+        } else {
+            break;
+        }
+    }
+    return Ret;
 }
 
 QUIC_STATUS
@@ -363,7 +507,7 @@ AttachXdpProgram(struct xdp_program *Prog, XDP_INTERFACE *Interface, struct xsk_
         unsigned int xdp_flag;
     } AttachTypePairs[]  = {
         // { XDP_MODE_HW, XDP_FLAGS_HW_MODE },
-        // { XDP_MODE_NATIVE, XDP_FLAGS_DRV_MODE },
+        { XDP_MODE_NATIVE, XDP_FLAGS_DRV_MODE },
         { XDP_MODE_SKB, XDP_FLAGS_SKB_MODE },
     };
     for (uint32_t i = 0; i < ARRAYSIZE(AttachTypePairs); i++) {
@@ -419,6 +563,15 @@ OpenXdpProgram(struct xdp_program **Prog)
                 do {
                     *Prog = xdp_program__open_file(FilePath, "xdp_prog", NULL);
                     err = libxdp_get_error(*Prog);
+#ifdef XDP_USE_SG
+                    if (!err) {
+                        //
+                        // The program only parses headers, which are always
+                        // in the first buffer of a multi-buffer frame.
+                        //
+                        xdp_program__set_xdp_frags_support(*Prog, true);
+                    }
+#endif
                     if (err) {
                         // TODO: Need investigation.
                         //       Sometimes fail to load same object
@@ -476,11 +629,14 @@ CxPlatDpRawInterfaceInitialize(
     XskCfg->rx_size = CONS_NUM_DESCS;
     XskCfg->tx_size = PROD_NUM_DESCS;
     XskCfg->libbpf_flags = XSK_LIBBPF_FLAGS__INHIBIT_PROG_LOAD;
-    // TODO: check ZEROCOPY feature, change Tx/Rx behavior based on feature
-    //       refer xdp-tools/xdp-loader/xdp-loader features <ifname>
-    XskCfg->bind_flags &= ~XDP_ZEROCOPY;
-    XskCfg->bind_flags |= XDP_COPY;
     XskCfg->bind_flags |= XDP_USE_NEED_WAKEUP;
+#ifdef XDP_USE_SG
+    //
+    // Allow frames to span multiple UMEM frames so jumbo MTUs can be used.
+    // This is dropped below if the kernel or driver doesn't support it.
+    //
+    XskCfg->bind_flags |= XDP_USE_SG;
+#endif
     Interface->XskCfg = XskCfg;
 
     DetachXdpProgram(Interface, true);
@@ -495,6 +651,16 @@ CxPlatDpRawInterfaceInitialize(
         goto Error;
     }
 
+    //
+    // Zero-copy needs the program attached in driver mode. Sockets fall back
+    // to copy mode if the driver doesn't support it.
+    //
+    if (Interface->AttachMode == XDP_MODE_NATIVE) {
+        XskCfg->bind_flags |= XDP_ZEROCOPY;
+    } else {
+        XskCfg->bind_flags |= XDP_COPY;
+    }
+
     int XskBypassMapFd = bpf_map__fd(bpf_object__find_map_by_name(xdp_program__bpf_obj(Interface->XdpProg), "xsks_map"));
     if (XskBypassMapFd < 0) {
         QuicTraceLogVerbose(
@@ -538,22 +704,7 @@ CxPlatDpRawInterfaceInitialize(
         CxPlatLockInitialize(&Queue->RxLock);
         CxPlatLockInitialize(&Queue->FqLock);
         CxPlatLockInitialize(&Queue->CqLock);
-
-        // Initialize shared packet_buffer for umem usage
-        struct XskUmemInfo *UmemInfo = calloc(1, sizeof(struct XskUmemInfo));
-        if (!UmemInfo) {
-            Status = QUIC_STATUS_OUT_OF_MEMORY;
-            goto Error;
-        }
-
-        Status = InitializeUmem(FRAME_SIZE, NUM_FRAMES, RxHeadroom, TxHeadroom, UmemInfo);
-        if (QUIC_FAILED(Status)) {
-            QuicTraceLogVerbose(
-                XdpConfigureUmem,
-                "[ xdp] Failed to configure Umem");
-            free(UmemInfo);
-            goto Error;
-        }
+        CxPlatPoolInitialize(FALSE, MAX_JUMBO_ETH_FRAME_SIZE, RX_BUFFER_TAG, &Queue->JumboPool);
 
         //
         // Create AF_XDP socket.
@@ -561,24 +712,33 @@ CxPlatDpRawInterfaceInitialize(
         struct XskSocketInfo *XskInfo = calloc(1, sizeof(*XskInfo));
         if (!XskInfo) {
             Status = QUIC_STATUS_OUT_OF_MEMORY;
-            free(UmemInfo->Buffer);
-            free(UmemInfo);
             goto Error;
         }
-        CxPlatLockInitialize(&XskInfo->UmemLock);
         Queue->XskInfo = XskInfo;
-        XskInfo->UmemInfo = UmemInfo;
 
-        int RetryCount = 10;
-        int Ret = 0;
-        do {
-            Ret = xsk_socket__create(&XskInfo->Xsk, Interface->IfName,
-                        i, UmemInfo->Umem, &XskInfo->Rx,
-                        &XskInfo->Tx, XskCfg);
-            if (Ret == -EBUSY) {
-                CxPlatSleep(100);
+        if (Xdp->ShareUmem && i > 0) {
+            XskInfo->UmemInfo = Interface->Queues[0].XskInfo->UmemInfo;
+            XskInfo->UmemInfo->RefCount++;
+        } else {
+            Status = InitializeUmem(FrameSize, NUM_FRAMES, RxHeadroom, TxHeadroom, XskInfo);
+            if (QUIC_FAILED(Status)) {
+                QuicTraceLogVerbose(
+                    XdpConfigureUmem,
+                    "[ xdp] Failed to configure Umem");
+                goto Error;
             }
-        } while (Ret == -EBUSY && RetryCount-- > 0);
+        }
+
+        //
+        // Split the receive half of a shared UMEM between the queues so one
+        // busy queue can't starve the others of frames.
+        //
+        XskInfo->FillLimit =
+            Xdp->ShareUmem ?
+                CXPLAT_MAX(PROD_NUM_DESCS / Interface->QueueCount, 1) :
+                PROD_NUM_DESCS;
+
+        int Ret = XskSocketCreate(Interface, i, XskInfo, XskCfg);
         if (Ret < 0) {
             QuicTraceLogVerbose(
                 FailXskSocketCreate,
@@ -594,18 +754,14 @@ CxPlatDpRawInterfaceInitialize(
             goto Error;
         }
 
-        for (int i = 0; i < NUM_FRAMES; i++) {
-            XskInfo->UmemFrameAddr[i] = i * FrameSize;
-        }
-        XskInfo->UmemFrameFree = NUM_FRAMES;
-
         // Setup fill queue for Rx
         uint32_t FqIdx = 0;
-        Ret = xsk_ring_prod__reserve(&XskInfo->UmemInfo->Fq, PROD_NUM_DESCS, &FqIdx);
-        if (Ret != PROD_NUM_DESCS) {
-            return QUIC_STATUS_OUT_OF_MEMORY;
+        uint32_t FillCount = (uint32_t)CXPLAT_MIN(XskInfo->FillLimit, XskUmemFreeFrames(XskInfo));
+        if (xsk_ring_prod__reserve(&XskInfo->Fq, FillCount, &FqIdx) != FillCount) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Error;
         }
-        for (uint32_t i = 0; i < PROD_NUM_DESCS; i ++) {
+        for (uint32_t i = 0; i < FillCount; i ++) {
             uint64_t Addr = XskUmemFrameAlloc(XskInfo);
             if (Addr == INVALID_UMEM_FRAME) {
                 QuicTraceLogVerbose(
@@ -613,12 +769,22 @@ CxPlatDpRawInterfaceInitialize(
                     "[ xdp][rx  ] OOM for Rx");
                 break;
             }
-            *xsk_ring_prod__fill_addr(&XskInfo->UmemInfo->Fq, FqIdx++) = Addr;
+            *xsk_ring_prod__fill_addr(&XskInfo->Fq, FqIdx++) = Addr;
         }
 
-        xsk_ring_prod__submit(&XskInfo->UmemInfo->Fq, PROD_NUM_DESCS);
+        xsk_ring_prod__submit(&XskInfo->Fq, FillCount);
     }
 
+#ifdef XDP_USE_SG
+    if (XskCfg->bind_flags & XDP_USE_SG) {
+        uint16_t Mtu = 0;
+        if (QUIC_SUCCEEDED(CxPlatGetInterfaceMtu(Interface->IfName, &Mtu)) &&
+            Mtu > CXPLAT_MAX_MTU) {
+            Interface->Mtu = Mtu;
+        }
+    }
+#endif
+
     //
     // Add each queue to a worker (round robin).
     //
@@ -674,13 +840,17 @@ QUIC_STATUS
 CxPlatDpRawInitialize(
     _Inout_ CXPLAT_DATAPATH_RAW* Datapath,
     _In_ uint32_t ClientRecvContextLength,
-    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig
     )
 {
     XDP_DATAPATH* Xdp = (XDP_DATAPATH*)Datapath;
+    UNREFERENCED_PARAMETER(InitConfig);
 
     CxPlatListInitializeHead(&Xdp->Interfaces);
     Xdp->PollingIdleTimeoutUs = 0;
+    const char* ShareUmem = getenv("MSQUIC_XDP_SHARED_UMEM");
+    Xdp->ShareUmem = ShareUmem != NULL && strcmp(ShareUmem, "1") == 0;
     Xdp->PartitionCount = CxPlatWorkerPoolGetCount(WorkerPool);
     for (uint32_t i = 0; i < Xdp->PartitionCount; i++) {
         Xdp->Partitions[i].Processor = (uint16_t)
@@ -909,21 +1079,75 @@ CxPlatDpRawUpdatePollingIdleTimeout(
     Xdp->PollingIdleTimeoutUs = PollingIdleTimeoutUs;
 }
 
+//
+// Programs the QUIC connection keys into the NIC behind the interface. Linux
+// doesn't have a generic uAPI for inline QUIC crypto offload yet, so this is
+// where a driver specific mechanism plugs in. Until then, every interface
+// reports the offload as unsupported and the connection stays in software.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
+static
 QUIC_STATUS
-RawSocketUpdateQeo(
-    _In_ CXPLAT_SOCKET_RAW* Socket,
+CxPlatXdpQeoSet(
+    _In_ const XDP_INTERFACE* Interface,
     _In_reads_(OffloadCount)
         const CXPLAT_QEO_CONNECTION* Offloads,
     _In_ uint32_t OffloadCount
     )
 {
-    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(Interface);
     UNREFERENCED_PARAMETER(Offloads);
     UNREFERENCED_PARAMETER(OffloadCount);
     return QUIC_STATUS_NOT_SUPPORTED;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+RawSocketUpdateQeo(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(OffloadCount)
+        const CXPLAT_QEO_CONNECTION* Offloads,
+    _In_ uint32_t OffloadCount
+    )
+{
+    XDP_DATAPATH* Xdp = (XDP_DATAPATH*)Socket->RawDatapath;
+
+    for (uint32_t i = 0; i < OffloadCount; i++) {
+        if ((QuicAddrGetFamily(&Offloads[i].Address) != QUIC_ADDRESS_FAMILY_INET &&
+             QuicAddrGetFamily(&Offloads[i].Address) != QUIC_ADDRESS_FAMILY_INET6) ||
+            Offloads[i].ConnectionIdLength > sizeof(Offloads[i].ConnectionId)) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    //
+    // Same as Windows: try all interfaces and consider it a success if any of
+    // them accepted the offload.
+    //
+
+    BOOLEAN AtLeastOneSucceeded = FALSE;
+    for (CXPLAT_LIST_ENTRY* Entry = Xdp->Interfaces.Flink; Entry != &Xdp->Interfaces; Entry = Entry->Flink) {
+        QUIC_STATUS Status =
+            CxPlatXdpQeoSet(
+                CXPLAT_CONTAINING_RECORD(Entry, XDP_INTERFACE, Link),
+                Offloads,
+                OffloadCount);
+        if (QUIC_FAILED(Status)) {
+            if (Status != QUIC_STATUS_NOT_SUPPORTED) {
+                QuicTraceEvent(
+                    LibraryErrorStatus,
+                    "[ lib] ERROR, %u, %s.",
+                    Status,
+                    "CxPlatXdpQeoSet");
+            }
+        } else {
+            AtLeastOneSucceeded = TRUE;
+        }
+    }
+
+    return AtLeastOneSucceeded ? QUIC_STATUS_SUCCESS : QUIC_STATUS_NOT_SUPPORTED;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 CxPlatDpRawPlumbRulesOnSocket(
@@ -1025,25 +1249,14 @@ CxPlatDpRawRxFree(
     _In_opt_ const CXPLAT_RECV_DATA* PacketChain
     )
 {
-    uint32_t Count = 0;
-    struct XskSocketInfo *XskInfo = NULL;
-    if (PacketChain) {
+    while (PacketChain) {
         const XDP_RX_PACKET* Packet =
             CXPLAT_CONTAINING_RECORD(PacketChain, XDP_RX_PACKET, RecvData);
-        XskInfo = Packet->Queue->XskInfo;
-
-        CxPlatLockAcquire(&XskInfo->UmemLock);
-        while (PacketChain) {
-            Packet =
-                CXPLAT_CONTAINING_RECORD(PacketChain, XDP_RX_PACKET, RecvData);
-            PacketChain = PacketChain->Next;
-            XskUmemFrameFree(Packet->Queue->XskInfo, Packet->Addr);
-            Count++;
+        PacketChain = PacketChain->Next;
+        if (Packet->JumboBuffer != NULL) {
+            CxPlatPoolFree(Packet->JumboBuffer);
         }
-    }
-
-    if (Count > 0) {
-        CxPlatLockRelease(&XskInfo->UmemLock);
+        XskUmemFrameFree(Packet->Queue->XskInfo, Packet->Addr);
     }
 }
 
@@ -1053,13 +1266,10 @@ CxPlatDpRawTxAlloc(
     _Inout_ CXPLAT_SEND_CONFIG* Config
     )
 {
-    CXPLAT_DBG_ASSERT(Config->MaxPacketSize <= MAX_UDP_PAYLOAD_LENGTH);
     XDP_TX_PACKET* Packet = NULL;
     CXPLAT_QUEUE* Queue = Config->Route->Queue;
     struct XskSocketInfo* XskInfo = Queue->XskInfo;
-    CxPlatLockAcquire(&XskInfo->UmemLock);
     uint64_t BaseAddr = XskUmemFrameAlloc(XskInfo);
-    CxPlatLockRelease(&XskInfo->UmemLock);
     if (BaseAddr == INVALID_UMEM_FRAME) {
         QuicTraceLogVerbose(
             FailTxAlloc,
@@ -1070,10 +1280,28 @@ CxPlatDpRawTxAlloc(
     Packet = (XDP_TX_PACKET*)xsk_umem__get_data(XskInfo->UmemInfo->Buffer, BaseAddr);
     if (Packet) {
         HEADER_BACKFILL HeaderBackfill = CxPlatDpRawCalculateHeaderBackFill(Config->Route); // TODO - Cache in Route?
-        CXPLAT_DBG_ASSERT(Config->MaxPacketSize <= sizeof(Packet->FrameBuffer) - HeaderBackfill.AllLayer);
         Packet->Queue = Queue;
+        Packet->JumboBuffer = NULL;
+        if (Config->MaxPacketSize + HeaderBackfill.AllLayer > sizeof(Packet->FrameBuffer)) {
+            //
+            // The frame doesn't fit in a single UMEM frame, so it's built in a
+            // contiguous staging buffer and split across frames on enqueue.
+            //
+            CXPLAT_DBG_ASSERT(Config->MaxPacketSize + HeaderBackfill.AllLayer <= MAX_JUMBO_ETH_FRAME_SIZE);
+            Packet->JumboBuffer = CxPlatPoolAlloc(&Queue->JumboPool);
+            if (Packet->JumboBuffer == NULL) {
+                QuicTraceLogVerbose(
+                    FailTxAlloc,
+                    "[ xdp][tx  ] OOM for Tx");
+                XskUmemFrameFree(XskInfo, BaseAddr);
+                Packet = NULL;
+                goto Error;
+            }
+            Packet->Buffer.Buffer = &Packet->JumboBuffer[HeaderBackfill.AllLayer];
+        } else {
+            Packet->Buffer.Buffer = &Packet->FrameBuffer[HeaderBackfill.AllLayer];
+        }
         Packet->Buffer.Length = Config->MaxPacketSize;
-        Packet->Buffer.Buffer = &Packet->FrameBuffer[HeaderBackfill.AllLayer];
         Packet->ECN = Config->ECN;
         Packet->DSCP = Config->DSCP;
         Packet->UmemRelativeAddr = BaseAddr;
@@ -1090,7 +1318,11 @@ CxPlatDpRawTxFree(
     _In_ CXPLAT_SEND_DATA* SendData
     )
 {
-    UNREFERENCED_PARAMETER(SendData);
+    XDP_TX_PACKET* Packet = (XDP_TX_PACKET*)SendData;
+    if (Packet->JumboBuffer != NULL) {
+        CxPlatPoolFree(Packet->JumboBuffer);
+        Packet->JumboBuffer = NULL;
+    }
 }
 
 void
@@ -1100,7 +1332,12 @@ KickTx(
     )
 {
     struct XskSocketInfo* XskInfo = Queue->XskInfo;
-    if (sendto(xsk_socket__fd(XskInfo->Xsk), NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) {
+    //
+    // With XDP_USE_NEED_WAKEUP the kernel only needs a kick when it has stopped
+    // processing the TX ring.
+    //
+    if (xsk_ring_prod__needs_wakeup(&XskInfo->Tx) &&
+        sendto(xsk_socket__fd(XskInfo->Xsk), NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             if (!SendAlreadyPending) {
                 XdpSocketContextSetEvents(Queue, EPOLL_CTL_MOD, EPOLLIN | EPOLLOUT);
@@ -1119,16 +1356,14 @@ KickTx(
     uint32_t Completed;
     uint32_t CqIdx;
     CxPlatLockAcquire(&Queue->CqLock);
-    Completed = xsk_ring_cons__peek(&XskInfo->UmemInfo->Cq, CONS_NUM_DESCS, &CqIdx);
+    Completed = xsk_ring_cons__peek(&XskInfo->Cq, CONS_NUM_DESCS, &CqIdx);
     if (Completed > 0) {
-        CxPlatLockAcquire(&XskInfo->UmemLock);
         for (uint32_t i = 0; i < Completed; i++) {
-            uint64_t addr = *xsk_ring_cons__comp_addr(&XskInfo->UmemInfo->Cq, CqIdx++) - XskInfo->UmemInfo->TxHeadRoom;
+            uint64_t addr = *xsk_ring_cons__comp_addr(&XskInfo->Cq, CqIdx++) - XskInfo->UmemInfo->TxHeadRoom;
             XskUmemFrameFree(XskInfo, addr);
         }
-        CxPlatLockRelease(&XskInfo->UmemLock);
 
-        xsk_ring_cons__release(&XskInfo->UmemInfo->Cq, Completed);
+        xsk_ring_cons__release(&XskInfo->Cq, Completed);
         QuicTraceLogVerbose(
             ReleaseCons,
             "[ xdp][cq  ] Release %d from completion queue", Completed);
@@ -1136,40 +1371,165 @@ KickTx(
     CxPlatLockRelease(&Queue->CqLock);
 }
 
-_IRQL_requires_max_(DISPATCH_LEVEL)
-void
-CxPlatDpRawTxEnqueue(
-    _In_ CXPLAT_SEND_DATA* SendData
+//
+// Gets the UMEM frames holding the packet, copying a staged jumbo packet into
+// as many frames as it needs. Returns zero if frames couldn't be allocated.
+//
+static
+uint32_t
+XdpTxPacketGetFrames(
+    _In_ XDP_TX_PACKET* Packet,
+    _Out_writes_(MAX_FRAME_FRAGMENTS) uint64_t* Frames
     )
 {
-    XDP_TX_PACKET* Packet = (XDP_TX_PACKET*)SendData;
-    CXPLAT_QUEUE* Queue = Packet->Queue;
-    XDP_PARTITION* Partition = Queue->Partition;
-    struct XskSocketInfo* XskInfo = Queue->XskInfo;
+    struct XskSocketInfo* XskInfo = Packet->Queue->XskInfo;
+    uint32_t FrameCount = 1;
+    Frames[0] = Packet->UmemRelativeAddr;
+
+#ifdef XDP_USE_SG
+    if (Packet->JumboBuffer != NULL) {
+        //
+        // Copy the staged frame into as many UMEM frames as it needs. Every
+        // fragment keeps the TX headroom so completions are handled uniformly.
+        //
+        const uint32_t FrameCapacity = FRAME_SIZE - XskInfo->UmemInfo->TxHeadRoom;
+        FrameCount = (Packet->Buffer.Length + FrameCapacity - 1) / FrameCapacity;
+        CXPLAT_DBG_ASSERT(FrameCount <= MAX_FRAME_FRAGMENTS);
+        for (uint32_t i = 1; i < FrameCount; i++) {
+            Frames[i] = XskUmemFrameAlloc(XskInfo);
+            if (Frames[i] == INVALID_UMEM_FRAME) {
+                while (i-- > 0) {
+                    XskUmemFrameFree(XskInfo, Frames[i]);
+                }
+                FrameCount = 0;
+                break;
+            }
+        }
+
+        if (FrameCount != 0) {
+            const uint8_t* Source = Packet->Buffer.Buffer;
+            uint32_t Remaining = Packet->Buffer.Length;
+            for (uint32_t i = 0; i < FrameCount; i++) {
+                const uint32_t Length = CXPLAT_MIN(Remaining, FrameCapacity);
+                CxPlatCopyMemory(
+                    xsk_umem__get_data(
+                        XskInfo->UmemInfo->Buffer, Frames[i] + XskInfo->UmemInfo->TxHeadRoom),
+                    Source,
+                    Length);
+                Source += Length;
+                Remaining -= Length;
+            }
+        }
+
+        CxPlatPoolFree(Packet->JumboBuffer);
+        Packet->JumboBuffer = NULL;
+
+        if (FrameCount == 0) {
+            QuicTraceLogVerbose(
+                FailTxAlloc,
+                "[ xdp][tx  ] OOM for Tx");
+        }
+    }
+#else
+    UNREFERENCED_PARAMETER(XskInfo);
+#endif
+
+    return FrameCount;
+}
+
+//
+// Writes the packet's frames to the TX ring. Returns the number of
+// descriptors reserved, or zero if the ring is full.
+//
+// N.B. Requires Queue->TxLock to be held.
+//
+static
+uint32_t
+XdpTxPacketWriteRing(
+    _In_ XDP_TX_PACKET* Packet,
+    _In_reads_(FrameCount) const uint64_t* Frames,
+    _In_ uint32_t FrameCount
+    )
+{
+    struct XskSocketInfo* XskInfo = Packet->Queue->XskInfo;
+    const uint32_t FrameCapacity = FRAME_SIZE - XskInfo->UmemInfo->TxHeadRoom;
 
     uint32_t TxIdx = 0;
-    CxPlatLockAcquire(&Queue->TxLock);
-    if (xsk_ring_prod__reserve(&XskInfo->Tx, 1, &TxIdx) != 1) {
-        CxPlatLockAcquire(&XskInfo->UmemLock);
-        XskUmemFrameFree(XskInfo, Packet->UmemRelativeAddr);
-        CxPlatLockRelease(&XskInfo->UmemLock);
+    if (xsk_ring_prod__reserve(&XskInfo->Tx, FrameCount, &TxIdx) != FrameCount) {
+        for (uint32_t i = 0; i < FrameCount; i++) {
+            XskUmemFrameFree(XskInfo, Frames[i]);
+        }
         QuicTraceLogVerbose(
             FailTxReserve,
             "[ xdp][tx  ] Failed to reserve");
-        return;
+        return 0;
+    }
+
+    uint32_t Remaining = Packet->Buffer.Length;
+    for (uint32_t i = 0; i < FrameCount; i++) {
+        struct xdp_desc *tx_desc = xsk_ring_prod__tx_desc(&XskInfo->Tx, TxIdx++);
+        CXPLAT_FRE_ASSERT(tx_desc != NULL);
+        tx_desc->addr = Frames[i] + XskInfo->UmemInfo->TxHeadRoom;
+        tx_desc->len = CXPLAT_MIN(Remaining, FrameCapacity);
+        tx_desc->options = 0;
+#ifdef XDP_USE_SG
+        if (i + 1 < FrameCount) {
+            tx_desc->options = XDP_PKT_CONTD;
+        }
+#endif
+        Remaining -= tx_desc->len;
     }
 
-    struct xdp_desc *tx_desc = xsk_ring_prod__tx_desc(&XskInfo->Tx, TxIdx);
-    CXPLAT_FRE_ASSERT(tx_desc != NULL);
-    tx_desc->addr = Packet->UmemRelativeAddr + XskInfo->UmemInfo->TxHeadRoom;
-    tx_desc->len = SendData->Buffer.Length;
-    xsk_ring_prod__submit(&XskInfo->Tx, 1);
-    CxPlatLockRelease(&Queue->TxLock);
+    return FrameCount;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxEnqueue(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CxPlatDpRawTxEnqueueBatch(&SendData, 1);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxEnqueueBatch(
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    uint32_t Index = 0;
+    while (Index < Count) {
+        //
+        // Submit each run of packets on the same queue with a single ring
+        // update and kick.
+        //
+        CXPLAT_QUEUE* Queue = ((XDP_TX_PACKET*)SendData[Index])->Queue;
+        XDP_PARTITION* Partition = Queue->Partition;
+        uint32_t SubmitCount = 0;
+
+        CxPlatLockAcquire(&Queue->TxLock);
+        while (Index < Count && ((XDP_TX_PACKET*)SendData[Index])->Queue == Queue) {
+            XDP_TX_PACKET* Packet = (XDP_TX_PACKET*)SendData[Index++];
+            uint64_t Frames[MAX_FRAME_FRAGMENTS];
+            const uint32_t FrameCount = XdpTxPacketGetFrames(Packet, Frames);
+            if (FrameCount != 0) {
+                SubmitCount += XdpTxPacketWriteRing(Packet, Frames, FrameCount);
+            }
+        }
+        if (SubmitCount != 0) {
+            xsk_ring_prod__submit(&Queue->XskInfo->Tx, SubmitCount);
+        }
+        CxPlatLockRelease(&Queue->TxLock);
 
-    KickTx(Packet->Queue, FALSE);
+        if (SubmitCount != 0) {
+            KickTx(Queue, FALSE);
+        }
 
-    Partition->Ec.Ready = TRUE;
-    CxPlatWakeExecutionContext(&Partition->Ec);
+        Partition->Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Partition->Ec);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -1278,16 +1638,75 @@ CxPlatXdpRx(
     CxPlatLockAcquire(&Queue->RxLock);
     Rcvd = xsk_ring_cons__peek(&XskInfo->Rx, RX_BATCH_SIZE, &RxIdx);
 
+#ifdef XDP_USE_SG
+    //
+    // A multi-buffer frame is only processed once all of its descriptors are
+    // on the ring. A partial frame at the end of the batch is left for the
+    // next poll.
+    //
+    uint32_t Complete = Rcvd;
+    while (Complete > 0 &&
+           (xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx + Complete - 1)->options & XDP_PKT_CONTD)) {
+        Complete--;
+    }
+    if (Complete < Rcvd) {
+        xsk_ring_cons__cancel(&XskInfo->Rx, Rcvd - Complete);
+        Rcvd = Complete;
+    }
+#endif
+
     // Process received packets
     CXPLAT_RECV_DATA* Buffers[RX_BATCH_SIZE] = {};
     uint32_t PacketCount = 0;
     for (i = 0; i < Rcvd; i++) {
-        uint64_t Addr = xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx)->addr;
-        uint32_t Len = xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx++)->len;
+        const struct xdp_desc* Desc = xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx++);
+        uint64_t Addr = Desc->addr;
+        uint32_t Len = Desc->len;
         uint8_t *FrameBuffer = xsk_umem__get_data(XskInfo->UmemInfo->Buffer, Addr);
         XDP_RX_PACKET* Packet = (XDP_RX_PACKET*)(FrameBuffer - XskInfo->UmemInfo->RxHeadRoom);
         CxPlatZeroMemory(Packet, XskInfo->UmemInfo->RxHeadRoom);
 
+#ifdef XDP_USE_SG
+        if (Desc->options & XDP_PKT_CONTD) {
+            //
+            // Reassemble the fragments into a contiguous buffer for parsing and
+            // return the continuation frames to the UMEM right away.
+            //
+            uint8_t* JumboBuffer = CxPlatPoolAlloc(&Queue->JumboPool);
+            uint32_t JumboLength = 0;
+            if (JumboBuffer != NULL) {
+                CxPlatCopyMemory(JumboBuffer, FrameBuffer, Len);
+                JumboLength = Len;
+            }
+            do {
+                Desc = xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx++);
+                i++;
+                if (JumboBuffer != NULL) {
+                    if (JumboLength + Desc->len <= MAX_JUMBO_ETH_FRAME_SIZE) {
+                        CxPlatCopyMemory(
+                            JumboBuffer + JumboLength,
+                            xsk_umem__get_data(XskInfo->UmemInfo->Buffer, Desc->addr),
+                            Desc->len);
+                        JumboLength += Desc->len;
+                    } else {
+                        CxPlatPoolFree(JumboBuffer);
+                        JumboBuffer = NULL;
+                    }
+                }
+                XskUmemFrameFree(XskInfo, Desc->addr - (Desc->addr % FRAME_SIZE));
+            } while (Desc->options & XDP_PKT_CONTD);
+
+            if (JumboBuffer == NULL) {
+                XskUmemFrameFree(XskInfo, Addr - (XDP_PACKET_HEADROOM + XskInfo->UmemInfo->RxHeadRoom));
+                continue;
+            }
+
+            Packet->JumboBuffer = JumboBuffer;
+            FrameBuffer = JumboBuffer;
+            Len = JumboLength;
+        }
+#endif
+
         Packet->Queue = Queue;
         Packet->RouteStorage.Queue = Queue;
         Packet->RecvData.Route = &Packet->RouteStorage;
@@ -1318,6 +1737,9 @@ CxPlatXdpRx(
             Packet->RecvData.Allocated = TRUE;
             Buffers[PacketCount++] = &Packet->RecvData;
         } else {
+            if (Packet->JumboBuffer != NULL) {
+                CxPlatPoolFree(Packet->JumboBuffer);
+            }
             XskUmemFrameFree(XskInfo, Addr - (XDP_PACKET_HEADROOM + XskInfo->UmemInfo->RxHeadRoom));
         }
     }
@@ -1327,16 +1749,17 @@ CxPlatXdpRx(
     }
     CxPlatLockRelease(&Queue->RxLock);
 
-    CxPlatLockAcquire(&XskInfo->UmemLock);
     CxPlatLockAcquire(&Queue->FqLock);
-    // Stuff the ring with as much frames as possible
-    Available = xsk_prod_nb_free(&XskInfo->UmemInfo->Fq, XskUmemFreeFrames(XskInfo));
+    // Stuff the ring with as much frames as possible, up to the queue's limit
+    const uint32_t Posted = PROD_NUM_DESCS - xsk_prod_nb_free(&XskInfo->Fq, PROD_NUM_DESCS);
+    Available = Posted < XskInfo->FillLimit ? XskInfo->FillLimit - Posted : 0;
+    Available = (uint32_t)CXPLAT_MIN(Available, XskUmemFreeFrames(XskInfo));
     if (Available > 0) {
-        ret = xsk_ring_prod__reserve(&XskInfo->UmemInfo->Fq, Available, &FqIdx);
+        ret = xsk_ring_prod__reserve(&XskInfo->Fq, Available, &FqIdx);
 
         // This should not happen, but just in case
         while (ret != Available) {
-            ret = xsk_ring_prod__reserve(&XskInfo->UmemInfo->Fq, Rcvd, &FqIdx);
+            ret = xsk_ring_prod__reserve(&XskInfo->Fq, Rcvd, &FqIdx);
         }
         for (i = 0; i < Available; i++) {
             uint64_t addr = XskUmemFrameAlloc(XskInfo);
@@ -1346,14 +1769,20 @@ CxPlatXdpRx(
                     "[ xdp][rx  ] OOM for Rx");
                 break;
             }
-            *xsk_ring_prod__fill_addr(&XskInfo->UmemInfo->Fq, FqIdx++) = addr;
+            *xsk_ring_prod__fill_addr(&XskInfo->Fq, FqIdx++) = addr;
         }
         if (i > 0) {
-            xsk_ring_prod__submit(&XskInfo->UmemInfo->Fq, i);
+            xsk_ring_prod__submit(&XskInfo->Fq, i);
+            if (xsk_ring_prod__needs_wakeup(&XskInfo->Fq)) {
+                //
+                // The driver ran dry and is waiting to be told about the new
+                // fill entries.
+                //
+                recvfrom(xsk_socket__fd(XskInfo->Xsk), NULL, 0, MSG_DONTWAIT, NULL, NULL);
+            }
         }
     }
     CxPlatLockRelease(&Queue->FqLock);
-    CxPlatLockRelease(&XskInfo->UmemLock);
 
     if (PacketCount) {
         CxPlatDpRawRxEthernet(
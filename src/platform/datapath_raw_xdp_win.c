@@ -29,6 +29,16 @@ Abstract:
 
 #define XDP_MAX_SYNC_WAIT_TIMEOUT_MS 1000 // Used for querying XDP RSS capabilities.
 
+//
+// How often each partition samples the packet arrival rates of its queues to
+// pick its poll mode, and the default rates at which it switches modes. Sleeps
+// are rounded up to the worker's wait granularity of a millisecond.
+//
+#define XDP_POLL_RATE_INTERVAL_US       10000
+#define XDP_DEFAULT_BUSY_POLL_RATE      100000  // Packets per second
+#define XDP_DEFAULT_SLEEP_RATE          10000   // Packets per second
+#define XDP_DEFAULT_SLEEP_INTERVAL_US   1000
+
 typedef struct XDP_DATAPATH {
     CXPLAT_DATAPATH_RAW;
     DECLSPEC_CACHEALIGN
@@ -45,6 +55,8 @@ typedef struct XDP_DATAPATH {
     uint32_t PollingIdleTimeoutUs;
     BOOLEAN TxAlwaysPoke;
     BOOLEAN Running;        // Signal to stop partitions.
+    CXPLAT_XDP_POLL_MODERATION_CONFIG PollModeration;
+    CXPLAT_XDP_POLL_STATISTICS* PollStatistics;
 
     XDP_PARTITION Partitions[0];
 } XDP_DATAPATH;
@@ -66,6 +78,8 @@ typedef struct CXPLAT_QUEUE {
     XSK_RING RxFillRing;
     XSK_RING RxRing;
     HANDLE RxProgram;
+    uint32_t RxPacketCount; // Received in the current rate sampling interval
+    uint32_t RxPacketRate;  // Smoothed, in packets per second
     uint8_t* TxBuffers;
     HANDLE TxXsk;
     CXPLAT_SQE TxIoSqe;
@@ -1038,7 +1052,8 @@ QUIC_STATUS
 CxPlatDpRawInitialize(
     _Inout_ CXPLAT_DATAPATH_RAW* Datapath,
     _In_ uint32_t ClientRecvContextLength,
-    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig
     )
 {
     XDP_DATAPATH* Xdp = (XDP_DATAPATH*)Datapath;
@@ -1058,6 +1073,15 @@ CxPlatDpRawInitialize(
     Xdp->TxAlwaysPoke = FALSE;
     //CxPlatXdpReadConfig(Xdp); // TODO - Make this more secure
 
+    if (InitConfig->XdpPollModeration != NULL) {
+        Xdp->PollModeration = *InitConfig->XdpPollModeration;
+    } else {
+        Xdp->PollModeration.BusyPollRate = XDP_DEFAULT_BUSY_POLL_RATE;
+        Xdp->PollModeration.SleepRate = XDP_DEFAULT_SLEEP_RATE;
+        Xdp->PollModeration.SleepIntervalUs = XDP_DEFAULT_SLEEP_INTERVAL_US;
+    }
+    Xdp->PollStatistics = InitConfig->XdpPollStatistics;
+
     PMIB_IF_TABLE2 pIfTable = NULL;
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     if (GetIfTable2(&pIfTable) != NO_ERROR) {
@@ -1209,6 +1233,8 @@ CxPlatDpRawInitialize(
         Partition->Ec.Ready = TRUE;
         Partition->Ec.NextTimeUs = UINT64_MAX;
         Partition->Ec.Callback = CxPlatXdpExecute;
+        Partition->PollMode = CXPLAT_XDP_POLL_MODE_INTERRUPT;
+        Partition->RxRateTimeUs = CxPlatTimeUs64();
         Partition->Ec.Context = &Xdp->Partitions[i];
         CxPlatSqeInitializeEx(CxPlatIoXdpShutdownEventComplete, &Partition->ShutdownSqe);
         CxPlatRefIncrement(&Xdp->RefCount);
@@ -1623,6 +1649,7 @@ CxPlatXdpRx(
     uint32_t ProdCount = 0;
     uint32_t PacketCount = 0;
     const uint32_t BuffersCount = XskRingConsumerReserve(&Queue->RxRing, RX_BATCH_SIZE, &RxIndex);
+    Queue->RxPacketCount += BuffersCount;
 
     for (uint32_t i = 0; i < BuffersCount; i++) {
         XSK_BUFFER_DESCRIPTOR* Buffer = XskRingGetElement(&Queue->RxRing, RxIndex++);
@@ -1796,6 +1823,34 @@ CxPlatDpRawTxEnqueue(
     CxPlatWakeExecutionContext(&Partition->Ec);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxEnqueueBatch(
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    uint32_t Index = 0;
+    while (Index < Count) {
+        //
+        // Queue each run of packets on the same queue under a single lock
+        // acquisition and wake.
+        //
+        CXPLAT_QUEUE* Queue = ((XDP_TX_PACKET*)SendData[Index])->Queue;
+        XDP_PARTITION* Partition = Queue->Partition;
+
+        CxPlatLockAcquire(&Queue->TxLock);
+        while (Index < Count && ((XDP_TX_PACKET*)SendData[Index])->Queue == Queue) {
+            XDP_TX_PACKET* Packet = (XDP_TX_PACKET*)SendData[Index++];
+            CxPlatListInsertTail(&Queue->TxQueue, &Packet->Link);
+        }
+        CxPlatLockRelease(&Queue->TxLock);
+
+        Partition->Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Partition->Ec);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 CxPlatDpRawTxSetL3ChecksumOffload(
@@ -1927,6 +1982,71 @@ CxPlatXdpTx(
     return ProdCount > 0 || CompCount > 0;
 }
 
+//
+// Once in a mode, the rate must fall to half the mode's threshold to leave it,
+// so partitions don't flap between modes around a threshold.
+//
+static
+BOOLEAN
+CxPlatXdpPollRateReached(
+    _In_ uint32_t Rate,
+    _In_ uint32_t Threshold,
+    _In_ BOOLEAN InMode
+    )
+{
+    return Threshold != 0 && Rate >= (InMode ? Threshold / 2 : Threshold);
+}
+
+//
+// Samples the packet arrival rate of the partition's queues, accounts the time
+// spent in the current poll mode and picks the next one by the busiest queue.
+//
+static
+void
+CxPlatXdpUpdatePollMode(
+    _In_ const XDP_DATAPATH* Xdp,
+    _Inout_ XDP_PARTITION* Partition,
+    _In_ uint64_t TimeNow
+    )
+{
+    const uint64_t ElapsedUs = CxPlatTimeDiff64(Partition->RxRateTimeUs, TimeNow);
+    if (ElapsedUs < XDP_POLL_RATE_INTERVAL_US) {
+        return;
+    }
+
+    uint32_t MaxRate = 0;
+    CXPLAT_QUEUE* Queue = Partition->Queues;
+    while (Queue) {
+        const uint64_t Sample =
+            CXPLAT_MIN((uint64_t)Queue->RxPacketCount * 1000000 / ElapsedUs, UINT32_MAX);
+        Queue->RxPacketRate = (uint32_t)(((uint64_t)Queue->RxPacketRate + Sample) / 2);
+        Queue->RxPacketCount = 0;
+        if (Queue->RxPacketRate > MaxRate) {
+            MaxRate = Queue->RxPacketRate;
+        }
+        Queue = Queue->Next;
+    }
+
+    if (Xdp->PollStatistics != NULL) {
+        InterlockedExchangeAdd64(
+            &Xdp->PollStatistics->TimeUs[Partition->PollMode], (int64_t)ElapsedUs);
+    }
+    Partition->RxRateTimeUs = TimeNow;
+
+    const CXPLAT_XDP_POLL_MODERATION_CONFIG* Config = &Xdp->PollModeration;
+    if (CxPlatXdpPollRateReached(
+            MaxRate, Config->BusyPollRate,
+            Partition->PollMode == CXPLAT_XDP_POLL_MODE_BUSY_POLL)) {
+        Partition->PollMode = CXPLAT_XDP_POLL_MODE_BUSY_POLL;
+    } else if (CxPlatXdpPollRateReached(
+            MaxRate, Config->SleepRate,
+            Partition->PollMode != CXPLAT_XDP_POLL_MODE_INTERRUPT)) {
+        Partition->PollMode = CXPLAT_XDP_POLL_MODE_SLEEP;
+    } else {
+        Partition->PollMode = CXPLAT_XDP_POLL_MODE_INTERRUPT;
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 CxPlatXdpExecute(
@@ -1967,11 +2087,21 @@ CxPlatXdpExecute(
         Queue = Queue->Next;
     }
 
+    CxPlatXdpUpdatePollMode(Xdp, Partition, State->TimeNow);
+    Partition->Ec.NextTimeUs = UINT64_MAX;
+
     if (DidWork) {
         Partition->Ec.Ready = TRUE;
         State->NoWorkCount = 0;
-    } else if (!PollingExpired) {
+    } else if (!PollingExpired ||
+               Partition->PollMode == CXPLAT_XDP_POLL_MODE_BUSY_POLL) {
         Partition->Ec.Ready = TRUE;
+    } else if (Partition->PollMode == CXPLAT_XDP_POLL_MODE_SLEEP) {
+        //
+        // Poll again after a short sleep instead of asking XDP to signal new
+        // packets, which costs more than it saves at this rate.
+        //
+        Partition->Ec.NextTimeUs = State->TimeNow + Xdp->PollModeration.SleepIntervalUs;
     } else {
         Queue = Partition->Queues;
         while (Queue) {
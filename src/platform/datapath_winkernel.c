@@ -228,6 +228,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_BUFFER ClientBuffer;
 
+    //
+    // Further send data whose buffers were chained onto this one's, to go
+    // out (and complete) in this send's WskSendMessages call.
+    //
+    struct CXPLAT_SEND_DATA* Next;
+
 } CXPLAT_SEND_DATA;
 
 //
@@ -2306,6 +2312,7 @@ CxPlatDataPathSocketReceive(
             Datagram->Data.PartitionIndex = (uint16_t)(CurProcNumber % Binding->Datapath->ProcCount);
             Datagram->Data.TypeOfService = (uint8_t)TypeOfService;
             Datagram->Data.HopLimitTTL = (uint8_t)HopLimitTTL;
+            Datagram->Data.RecvTime = 0;
             Datagram->Data.Allocated = TRUE;
             Datagram->Data.QueuedOnConnection = FALSE;
 
@@ -2446,6 +2453,7 @@ SendDataAlloc(
                 ? Config->MaxPacketSize : 0;
         SendData->ClientBuffer.Length = 0;
         SendData->ClientBuffer.Buffer = NULL;
+        SendData->Next = NULL;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
     }
 
@@ -2803,7 +2811,17 @@ CxPlatDataPathSendComplete(
     }
 
     IoCleanupIrp(&SendData->Irp);
-    SendDataFree(SendData);
+    do {
+        CXPLAT_SEND_DATA* Next = SendData->Next;
+        if (Next != NULL) {
+            //
+            // Split the buffer lists back apart before freeing.
+            //
+            SendData->TailBuf->Link.Next = NULL;
+        }
+        SendDataFree(SendData);
+        SendData = Next;
+    } while (SendData != NULL);
 
     return STATUS_MORE_PROCESSING_REQUIRED;
 }
@@ -2832,7 +2850,7 @@ CxPlatSocketPrepareSendData(
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
-SocketSend(
+CxPlatSocketSendPrepared(
     _In_ CXPLAT_SOCKET* Binding,
     _In_ const CXPLAT_ROUTE* Route,
     _In_ CXPLAT_SEND_DATA* SendData
@@ -2841,14 +2859,6 @@ SocketSend(
     QUIC_STATUS Status;
     PDWORD SegmentSize;
 
-    CXPLAT_DBG_ASSERT(
-        Binding != NULL && Route != NULL && SendData != NULL);
-
-    //
-    // Initialize IRP and MDLs for sending.
-    //
-    CxPlatSocketPrepareSendData(SendData);
-
     SendData->Binding = Binding;
 
     QuicTraceEvent(
@@ -2968,6 +2978,91 @@ SocketSend(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SocketSend(
+    _In_ CXPLAT_SOCKET* Binding,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CXPLAT_DBG_ASSERT(
+        Binding != NULL && Route != NULL && SendData != NULL);
+
+    //
+    // Initialize IRP and MDLs for sending.
+    //
+    CxPlatSocketPrepareSendData(SendData);
+    CxPlatSocketSendPrepared(Binding, Route, SendData);
+}
+
+//
+// Returns TRUE if the (prepared) send data can go out in the same
+// WskSendMessages call as another. The call takes a single set of addresses
+// and control messages for all its buffers.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+BOOLEAN
+CxPlatSendDataCanShareSend(
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ const CXPLAT_SEND_DATA* SendData,
+    _In_ const CXPLAT_ROUTE* OtherRoute,
+    _In_ const CXPLAT_SEND_DATA* OtherSendData
+    )
+{
+    return
+        OtherSendData->WskBufs != NULL &&
+        SendData->ECN == OtherSendData->ECN &&
+        SendData->DSCP == OtherSendData->DSCP &&
+        SendData->SegmentSize == OtherSendData->SegmentSize &&
+        QuicAddrCompare(&Route->RemoteAddress, &OtherRoute->RemoteAddress) &&
+        QuicAddrCompare(&Route->LocalAddress, &OtherRoute->LocalAddress) &&
+        Route->LocalAddress.Ipv6.sin6_scope_id == OtherRoute->LocalAddress.Ipv6.sin6_scope_id;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    for (uint32_t i = 0; i < Count; ++i) {
+        CxPlatSocketPrepareSendData(SendData[i]);
+    }
+
+    uint32_t Index = 0;
+    while (Index < Count) {
+        //
+        // Chain the buffers of a run of sends to the same destination, so
+        // they all go out with the first one's IRP in a single call.
+        //
+        CXPLAT_SEND_DATA* Head = SendData[Index];
+        CXPLAT_SEND_DATA* Tail = Head;
+        uint32_t RunCount = 1;
+        while (Tail->WskBufs != NULL &&
+               Index + RunCount < Count &&
+               CxPlatSendDataCanShareSend(
+                    &Routes[Index],
+                    Head,
+                    &Routes[Index + RunCount],
+                    SendData[Index + RunCount])) {
+            CXPLAT_SEND_DATA* Next = SendData[Index + RunCount];
+            Tail->TailBuf->Link.Next = Next->WskBufs;
+            Tail->Next = Next;
+            Tail = Next;
+            Head->TotalSize += Next->TotalSize;
+            RunCount++;
+        }
+
+        CxPlatSocketSendPrepared(Socket, &Routes[Index], Head);
+        Index += RunCount;
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatSocketGetTcpStatistics(
@@ -63,6 +63,25 @@ Abstract:
 //
 #define URO_MAX_DATAGRAMS_PER_INDICATION    64
 
+//
+// The depths of a RIO socket's receive and send request queues.
+//
+#define CXPLAT_RIO_RECV_QUEUE_DEPTH           256
+#define CXPLAT_RIO_SEND_QUEUE_DEPTH           256
+
+//
+// The maximum number of RIO completions dequeued at once, and the number of
+// times to dequeue per notification before rearming it.
+//
+#define CXPLAT_RIO_MAX_COMPLETIONS            64
+#define CXPLAT_RIO_MAX_DEQUEUES               4
+
+//
+// RIO request contexts are either receive IO blocks or send data. Sends are
+// marked with the low bit.
+//
+#define CXPLAT_RIO_SEND_REQUEST               ((ULONG_PTR)1)
+
 CXPLAT_STATIC_ASSERT(
     sizeof(QUIC_BUFFER) == sizeof(WSABUF),
     "WSABUF is assumed to be interchangeable for QUIC_BUFFER");
@@ -116,9 +135,11 @@ typedef struct DATAPATH_RX_IO_BLOCK {
     WSABUF WsaControlBuf;
 
     //
-    // Contains the control data resulting from the receive.
+    // Contains the control data resulting from the receive. RIO receives
+    // prefix it with a RIO_CMSG_BUFFER header.
     //
     char ControlBuf[
+        RIO_CMSG_BASE_SIZE +                    // RIO_CMSG_BUFFER
         WSA_CMSG_SPACE(sizeof(IN6_PKTINFO)) +   // IP_PKTINFO
         WSA_CMSG_SPACE(sizeof(DWORD)) +         // UDP_COALESCED_INFO
         WSA_CMSG_SPACE(sizeof(INT)) +           // IP_TOS, or IP_ECN if RECV_DSCP isn't supported
@@ -186,9 +207,11 @@ typedef struct CXPLAT_SEND_DATA {
     WSABUF ClientBuffer;
 
     //
-    // The buffer for send control data.
+    // The buffer for send control data. RIO sends prefix it with a
+    // RIO_CMSG_BUFFER header.
     //
     char CtrlBuf[
+        RIO_CMSG_BASE_SIZE +                    // RIO_CMSG_BUFFER
         WSA_CMSG_SPACE(sizeof(IN6_PKTINFO)) +   // IP_PKTINFO
         WSA_CMSG_SPACE(sizeof(INT)) +           // IP_ECN or IP_TOS
         WSA_CMSG_SPACE(sizeof(DWORD))           // UDP_SEND_MSG_SIZE
@@ -203,8 +226,27 @@ typedef struct CXPLAT_SEND_DATA {
     // The V6-mapped remote address to send to.
     //
     QUIC_ADDR MappedRemoteAddress;
+
+    //
+    // Links the send into its socket's RIO backlog while the request queue is
+    // full.
+    //
+    CXPLAT_LIST_ENTRY RioLink;
+
+    //
+    // Lets RIO defer the send until a later send on the same socket commits
+    // it.
+    //
+    BOOLEAN RioDefer;
 } CXPLAT_SEND_DATA;
 
+//
+// Prefixes every allocation from a RIO pool, ahead of the pool header.
+//
+typedef struct DECLSPEC_ALIGN(MEMORY_ALLOCATION_ALIGNMENT) CXPLAT_RIO_POOL_PREFIX {
+    RIO_BUFFERID BufferId;
+} CXPLAT_RIO_POOL_PREFIX;
+
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -218,6 +260,7 @@ CXPLAT_EVENT_COMPLETION CxPlatIoSendEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatIoQueueSendEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatIoAcceptExEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatIoConnectExEventComplete;
+CXPLAT_EVENT_COMPLETION CxPlatIoRioNotifyEventComplete;
 
 #ifdef DEBUG
 #ifndef AllocOffset
@@ -306,6 +349,16 @@ CxPlatDataPathStartReceiveAsync(
     _In_ CXPLAT_SOCKET_PROC* SocketProc
     );
 
+QUIC_STATUS
+CxPlatSocketRioInitialize(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    );
+
+void
+CxPlatSocketRioStartReceive(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    );
+
 QUIC_STATUS
 CxPlatSocketStartAccept(
     _In_ CXPLAT_SOCKET_PROC* SocketProc
@@ -399,6 +452,7 @@ CxPlatDataPathQuerySockoptSupport(
     GUID ConnectExGuid = WSAID_CONNECTEX;
     GUID WSASendMsgGuid = WSAID_WSASENDMSG;
     GUID WSARecvMsgGuid = WSAID_WSARECVMSG;
+    GUID RioGuid = WSAID_MULTIPLE_RIO;
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
 
     SOCKET UdpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
@@ -499,6 +553,31 @@ CxPlatDataPathQuerySockoptSupport(
         goto Error;
     }
 
+    //
+    // RIO is optional. Sockets fall back to overlapped IO without it.
+    //
+    Result =
+        WSAIoctl(
+            UdpSocket,
+            SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER,
+            &RioGuid,
+            sizeof(RioGuid),
+            &Datapath->RioDispatch,
+            sizeof(Datapath->RioDispatch),
+            &BytesReturned,
+            NULL,
+            NULL);
+    if (Result != NO_ERROR) {
+        int WsaError = WSAGetLastError();
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            WsaError,
+            "SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER (RIO)");
+    } else {
+        Datapath->RioSupported = TRUE;
+    }
+
 {
     DWORD SegmentSize;
     OptionLength = sizeof(SegmentSize);
@@ -597,6 +676,89 @@ Error:
     return Status;
 }
 
+CXPLAT_POOL_HEADER*
+CxPlatRioPoolAlloc(
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    //
+    // The pool is the first member of its CXPLAT_RIO_POOL.
+    //
+    const CXPLAT_RIO_POOL* RioPool = (CXPLAT_RIO_POOL*)Pool;
+    const uint32_t AllocSize = sizeof(CXPLAT_RIO_POOL_PREFIX) + Size;
+    CXPLAT_RIO_POOL_PREFIX* Prefix = CxPlatAlloc(AllocSize, Tag);
+    if (Prefix == NULL) {
+        return NULL;
+    }
+
+    Prefix->BufferId =
+        RioPool->Datapath->RioDispatch.RIORegisterBuffer((PCHAR)Prefix, AllocSize);
+    if (Prefix->BufferId == RIO_INVALID_BUFFERID) {
+        int WsaError = WSAGetLastError();
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            WsaError,
+            "RIORegisterBuffer");
+        CxPlatFree(Prefix, Tag);
+        return NULL;
+    }
+
+    return (CXPLAT_POOL_HEADER*)(Prefix + 1);
+}
+
+void
+CxPlatRioPoolFree(
+    _In_ CXPLAT_POOL_HEADER* Entry,
+    _In_ uint32_t Tag,
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    const CXPLAT_RIO_POOL* RioPool = (CXPLAT_RIO_POOL*)Pool;
+    CXPLAT_RIO_POOL_PREFIX* Prefix = (CXPLAT_RIO_POOL_PREFIX*)Entry - 1;
+    RioPool->Datapath->RioDispatch.RIODeregisterBuffer(Prefix->BufferId);
+    CxPlatFree(Prefix, Tag);
+}
+
+void
+CxPlatRioPoolInitialize(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _Out_ CXPLAT_RIO_POOL* Pool
+    )
+{
+    Pool->Datapath = Datapath;
+    CxPlatPoolInitializeEx(
+        FALSE,
+        Size,
+        Tag,
+        0,
+        CxPlatRioPoolAlloc,
+        CxPlatRioPoolFree,
+        &Pool->Base.Base);
+}
+
+//
+// Describes part of an element allocated from a RIO pool as a RIO_BUF.
+//
+void
+CxPlatRioBufInitialize(
+    _In_ const void* Element,
+    _In_ const void* Buffer,
+    _In_ ULONG Length,
+    _Out_ RIO_BUF* RioBuf
+    )
+{
+    const CXPLAT_RIO_POOL_PREFIX* Prefix =
+        (const CXPLAT_RIO_POOL_PREFIX*)((const CXPLAT_POOL_HEADER*)Element - 1) - 1;
+    RioBuf->BufferId = Prefix->BufferId;
+    RioBuf->Offset = (ULONG)((const UCHAR*)Buffer - (const UCHAR*)Prefix);
+    RioBuf->Length = Length;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 DataPathInitialize(
@@ -753,6 +915,33 @@ DataPathInitialize(
             Datapath->WorkerPool,
             &Datapath->Partitions[i].RecvDatagramPool,
             i);
+
+        if (Datapath->RioSupported) {
+            CxPlatRioPoolInitialize(
+                Datapath,
+                sizeof(CXPLAT_SEND_DATA),
+                QUIC_POOL_PLATFORM_SENDCTX,
+                &Datapath->Partitions[i].RioSendDataPool);
+            CxPlatRioPoolInitialize(
+                Datapath,
+                MAX_UDP_PAYLOAD_LENGTH,
+                QUIC_POOL_DATA,
+                &Datapath->Partitions[i].RioSendBufferPool);
+            CxPlatRioPoolInitialize(
+                Datapath,
+                CXPLAT_LARGE_SEND_BUFFER_SIZE,
+                QUIC_POOL_DATA,
+                &Datapath->Partitions[i].RioLargeSendBufferPool);
+            CxPlatRioPoolInitialize(
+                Datapath,
+                RecvDatagramLength,
+                QUIC_POOL_DATA,
+                &Datapath->Partitions[i].RioRecvDatagramPool);
+            CxPlatAddDynamicPoolAllocator(
+                Datapath->WorkerPool,
+                &Datapath->Partitions[i].RioRecvDatagramPool.Base,
+                i);
+        }
     }
 
     CXPLAT_FRE_ASSERT(CxPlatWorkerPoolAddRef(WorkerPool, CXPLAT_WORKER_POOL_REF_WINSOCK));
@@ -809,6 +998,13 @@ CxPlatProcessorContextRelease(
         CxPlatPoolUninitialize(&DatapathProc->LargeSendBufferPool);
         CxPlatRemoveDynamicPoolAllocator(&DatapathProc->RecvDatagramPool);
         CxPlatPoolUninitialize(&DatapathProc->RecvDatagramPool.Base);
+        if (DatapathProc->Datapath->RioSupported) {
+            CxPlatPoolUninitialize(&DatapathProc->RioSendDataPool.Base.Base);
+            CxPlatPoolUninitialize(&DatapathProc->RioSendBufferPool.Base.Base);
+            CxPlatPoolUninitialize(&DatapathProc->RioLargeSendBufferPool.Base.Base);
+            CxPlatRemoveDynamicPoolAllocator(&DatapathProc->RioRecvDatagramPool.Base);
+            CxPlatPoolUninitialize(&DatapathProc->RioRecvDatagramPool.Base.Base);
+        }
         CxPlatDataPathRelease(DatapathProc->Datapath);
     }
 }
@@ -1283,11 +1479,24 @@ SocketCreateUdp(
             MAX_URO_PAYLOAD_LENGTH :
             Socket->Mtu - CXPLAT_MIN_IPV4_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE;
 
+    //
+    // RIO is used if requested and available; otherwise the socket silently
+    // falls back to overlapped IO.
+    //
+    Socket->UseRio =
+        (Config->Flags & CXPLAT_SOCKET_FLAG_RIO) && Datapath->RioSupported;
+
     for (uint16_t i = 0; i < SocketCount; i++) {
         CxPlatRefInitialize(&Socket->PerProcSockets[i].RefCount);
         Socket->PerProcSockets[i].Parent = Socket;
         Socket->PerProcSockets[i].Socket = INVALID_SOCKET;
         CxPlatRundownInitialize(&Socket->PerProcSockets[i].RundownRef);
+        if (Socket->UseRio) {
+            Socket->PerProcSockets[i].RioCq = RIO_INVALID_CQ;
+            Socket->PerProcSockets[i].RioRq = RIO_INVALID_RQ;
+            CxPlatLockInitialize(&Socket->PerProcSockets[i].RioLock);
+            CxPlatListInitializeHead(&Socket->PerProcSockets[i].RioSendBacklog);
+        }
     }
 
     for (uint16_t i = 0; i < SocketCount; i++) {
@@ -1300,6 +1509,10 @@ SocketCreateUdp(
         DWORD SocketFlags = WSA_FLAG_OVERLAPPED;
         DWORD BytesReturned;
 
+        if (Socket->UseRio) {
+            SocketFlags |= WSA_FLAG_REGISTERED_IO;
+        }
+
         SocketProc->Socket =
             WSASocketW(
                 AF_INET6,
@@ -1653,6 +1866,13 @@ SocketCreateUdp(
             goto Error;
         }
 
+        if (Socket->UseRio) {
+            Status = CxPlatSocketRioInitialize(SocketProc);
+            if (QUIC_FAILED(Status)) {
+                goto Error;
+            }
+        }
+
         if (Config->InterfaceIndex != 0) {
             Option = (int)Config->InterfaceIndex;
             Result =
@@ -1845,7 +2065,11 @@ Skip:
 
     if (!Socket->ReserveAuxTcpSock) {
         for (uint16_t i = 0; i < SocketCount; i++) {
-            CxPlatDataPathStartReceiveAsync(&Socket->PerProcSockets[i]);
+            if (Socket->UseRio) {
+                CxPlatSocketRioStartReceive(&Socket->PerProcSockets[i]);
+            } else {
+                CxPlatDataPathStartReceiveAsync(&Socket->PerProcSockets[i]);
+            }
             Socket->PerProcSockets[i].IoStarted = TRUE;
         }
     }
@@ -2425,6 +2649,17 @@ CxPlatSocketContextRelease(
             }
         }
 
+        if (SocketProc->Parent->UseRio) {
+            CXPLAT_DBG_ASSERT(SocketProc->RioRecvCount == 0);
+            CXPLAT_DBG_ASSERT(SocketProc->RioSendCount == 0);
+            CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&SocketProc->RioSendBacklog));
+            if (SocketProc->RioCq != RIO_INVALID_CQ) {
+                SocketProc->Parent->Datapath->RioDispatch.RIOCloseCompletionQueue(
+                    SocketProc->RioCq);
+            }
+            CxPlatLockUninitialize(&SocketProc->RioLock);
+        }
+
         CxPlatRundownUninitialize(&SocketProc->RundownRef);
 
         QuicTraceLogVerbose(
@@ -2528,7 +2763,11 @@ CxPlatSocketAllocRxIoBlock(
     )
 {
     CXPLAT_DATAPATH_PARTITION* DatapathProc = SocketProc->DatapathProc;
-    DATAPATH_RX_IO_BLOCK* IoBlock = CxPlatPoolAlloc(&DatapathProc->RecvDatagramPool.Base);
+    DATAPATH_RX_IO_BLOCK* IoBlock =
+        CxPlatPoolAlloc(
+            SocketProc->Parent->UseRio ?
+                &DatapathProc->RioRecvDatagramPool.Base.Base :
+                &DatapathProc->RecvDatagramPool.Base);
 
     if (IoBlock != NULL) {
         CxPlatZeroMemory(&IoBlock->Route, sizeof(CXPLAT_ROUTE));
@@ -3157,6 +3396,7 @@ CxPlatDataPathUdpRecvComplete(
                 SocketProc->DatapathProc->PartitionIndex % SocketProc->DatapathProc->Datapath->PartitionCount;
             Datagram->TypeOfService = (uint8_t)TypeOfService;
             Datagram->HopLimitTTL = (uint8_t) HopLimitTTL;
+            Datagram->RecvTime = 0;
             Datagram->Allocated = TRUE;
             Datagram->Route->DatapathType = Datagram->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             Datagram->QueuedOnConnection = FALSE;
@@ -3331,6 +3571,7 @@ CxPlatDataPathTcpRecvComplete(
         Data->Route = &IoBlock->Route;
         Data->PartitionIndex = SocketProc->DatapathProc->PartitionIndex;
         Data->TypeOfService = 0;
+        Data->RecvTime = 0;
         Data->Allocated = TRUE;
         Data->Route->DatapathType = Data->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
         Data->QueuedOnConnection = FALSE;
@@ -3500,7 +3741,11 @@ SendDataAlloc(
     CXPLAT_SOCKET_PROC* SocketProc = (CXPLAT_SOCKET_PROC*)Config->Route->Queue;
     CXPLAT_DATAPATH_PARTITION* DatapathProc = SocketProc->DatapathProc;
 
-    CXPLAT_SEND_DATA* SendData = CxPlatPoolAlloc(&DatapathProc->SendDataPool);
+    CXPLAT_SEND_DATA* SendData =
+        CxPlatPoolAlloc(
+            Socket->UseRio ?
+                &DatapathProc->RioSendDataPool.Base.Base :
+                &DatapathProc->SendDataPool);
 
     if (SendData != NULL) {
         SendData->Owner = DatapathProc;
@@ -3516,11 +3761,19 @@ SendDataAlloc(
         SendData->ClientBuffer.len = 0;
         SendData->ClientBuffer.buf = NULL;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
+        SendData->RioDefer = FALSE;
 
-        SendData->BufferPool =
-            SendData->SegmentSize > 0 ?
-                &DatapathProc->LargeSendBufferPool :
-                &DatapathProc->SendBufferPool;
+        if (Socket->UseRio) {
+            SendData->BufferPool =
+                SendData->SegmentSize > 0 ?
+                    &DatapathProc->RioLargeSendBufferPool.Base.Base :
+                    &DatapathProc->RioSendBufferPool.Base.Base;
+        } else {
+            SendData->BufferPool =
+                SendData->SegmentSize > 0 ?
+                    &DatapathProc->LargeSendBufferPool :
+                    &DatapathProc->SendBufferPool;
+        }
     }
 
     return SendData;
@@ -3779,6 +4032,424 @@ CxPlatSendDataComplete(
     SendDataFree(SendData);
 }
 
+QUIC_STATUS
+CxPlatSocketRioInitialize(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    )
+{
+    const RIO_EXTENSION_FUNCTION_TABLE* Rio = &SocketProc->Parent->Datapath->RioDispatch;
+
+    //
+    // Completions are signaled by queuing the socket context's IoSqe on the
+    // partition's event queue, whenever the notification is armed.
+    //
+    RIO_NOTIFICATION_COMPLETION Notification;
+    Notification.Type = RIO_IOCP_COMPLETION;
+    Notification.Iocp.IocpHandle = *SocketProc->DatapathProc->EventQ;
+    Notification.Iocp.CompletionKey = NULL;
+    Notification.Iocp.Overlapped = &SocketProc->IoSqe.Overlapped;
+
+    SocketProc->RioCq =
+        Rio->RIOCreateCompletionQueue(
+            CXPLAT_RIO_RECV_QUEUE_DEPTH + CXPLAT_RIO_SEND_QUEUE_DEPTH,
+            &Notification);
+    if (SocketProc->RioCq == RIO_INVALID_CQ) {
+        int WsaError = WSAGetLastError();
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketProc->Parent,
+            WsaError,
+            "RIOCreateCompletionQueue");
+        return HRESULT_FROM_WIN32(WsaError);
+    }
+
+    SocketProc->RioRq =
+        Rio->RIOCreateRequestQueue(
+            SocketProc->Socket,
+            CXPLAT_RIO_RECV_QUEUE_DEPTH,
+            1,
+            CXPLAT_RIO_SEND_QUEUE_DEPTH,
+            1,
+            SocketProc->RioCq,
+            SocketProc->RioCq,
+            SocketProc);
+    if (SocketProc->RioRq == RIO_INVALID_RQ) {
+        int WsaError = WSAGetLastError();
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketProc->Parent,
+            WsaError,
+            "RIOCreateRequestQueue");
+        return HRESULT_FROM_WIN32(WsaError);
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Arms the completion queue's notification if it isn't armed and requests are
+// outstanding. Called with the RIO lock held.
+//
+void
+CxPlatSocketRioArmNotify(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    )
+{
+    if (SocketProc->RioNotifyArmed ||
+        SocketProc->RioRecvCount + SocketProc->RioSendCount == 0) {
+        return;
+    }
+
+    CxPlatStartDatapathIo(
+        SocketProc,
+        &SocketProc->IoSqe,
+        CxPlatIoRioNotifyEventComplete);
+    INT Result =
+        SocketProc->Parent->Datapath->RioDispatch.RIONotify(SocketProc->RioCq);
+    if (Result != ERROR_SUCCESS) {
+        //
+        // Only fails if the notification is already armed, which the flag
+        // prevents.
+        //
+        CXPLAT_DBG_ASSERT(FALSE);
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketProc->Parent,
+            Result,
+            "RIONotify");
+        CxPlatCancelDatapathIo(SocketProc);
+        return;
+    }
+    SocketProc->RioNotifyArmed = TRUE;
+}
+
+//
+// Posts receives until the request queue is full, and commits them together.
+// Called with the RIO lock held.
+//
+void
+CxPlatSocketRioPostReceives(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    )
+{
+    const CXPLAT_DATAPATH* Datapath = SocketProc->Parent->Datapath;
+    BOOLEAN Posted = FALSE;
+
+    while (SocketProc->RioRecvCount < CXPLAT_RIO_RECV_QUEUE_DEPTH) {
+        DATAPATH_RX_IO_BLOCK* IoBlock = CxPlatSocketAllocRxIoBlock(SocketProc);
+        if (IoBlock == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Socket Receive Buffer",
+                Datapath->RecvPayloadOffset + SocketProc->Parent->RecvBufLen);
+            break;
+        }
+
+        RIO_BUF Data, RemoteAddress, Control;
+        CxPlatRioBufInitialize(
+            IoBlock,
+            ((PUCHAR)IoBlock) + Datapath->RecvPayloadOffset,
+            SocketProc->Parent->RecvBufLen,
+            &Data);
+        CxPlatRioBufInitialize(
+            IoBlock,
+            &IoBlock->Route.RemoteAddress,
+            sizeof(IoBlock->Route.RemoteAddress),
+            &RemoteAddress);
+        CxPlatRioBufInitialize(
+            IoBlock,
+            IoBlock->ControlBuf,
+            sizeof(IoBlock->ControlBuf),
+            &Control);
+
+        //
+        // The receive holds a reference on the context until it completes.
+        //
+        CxPlatRefIncrement(&SocketProc->RefCount);
+        if (!Datapath->RioDispatch.RIOReceiveEx(
+                SocketProc->RioRq,
+                &Data,
+                1,
+                NULL,
+                &RemoteAddress,
+                &Control,
+                NULL,
+                RIO_MSG_DEFER,
+                IoBlock)) {
+            int WsaError = WSAGetLastError();
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                SocketProc->Parent,
+                WsaError,
+                "RIOReceiveEx");
+            CxPlatSocketContextRelease(SocketProc);
+            CxPlatSocketFreeRxIoBlock(IoBlock);
+            break;
+        }
+
+        SocketProc->RioRecvCount++;
+        Posted = TRUE;
+    }
+
+    if (Posted) {
+        Datapath->RioDispatch.RIOReceiveEx(
+            SocketProc->RioRq, NULL, 0, NULL, NULL, NULL, NULL, RIO_MSG_COMMIT_ONLY, NULL);
+    }
+
+    if (SocketProc->RioRecvCount == 0) {
+        SocketProc->RecvFailure = TRUE;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketProc->Parent,
+            QUIC_STATUS_OUT_OF_MEMORY,
+            "No RIO receives could be posted. Receive will stall.");
+    } else {
+        SocketProc->RecvFailure = FALSE;
+    }
+}
+
+void
+CxPlatSocketRioStartReceive(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    )
+{
+    CxPlatLockAcquire(&SocketProc->RioLock);
+    CxPlatSocketRioPostReceives(SocketProc);
+    CxPlatSocketRioArmNotify(SocketProc);
+    CxPlatLockRelease(&SocketProc->RioLock);
+}
+
+//
+// Posts a send on the request queue. Called with the RIO lock held.
+//
+ULONG
+CxPlatSocketRioPostSend(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc,
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ DWORD Flags
+    )
+{
+    const RIO_EXTENSION_FUNCTION_TABLE* Rio = &SocketProc->Parent->Datapath->RioDispatch;
+    const RIO_CMSG_BUFFER* RioCmsg = (const RIO_CMSG_BUFFER*)SendData->CtrlBuf;
+
+    CXPLAT_DBG_ASSERT(SendData->WsaBufferCount == 1);
+    CXPLAT_DBG_ASSERT(SocketProc->RioSendCount < CXPLAT_RIO_SEND_QUEUE_DEPTH);
+
+    RIO_BUF Data, RemoteAddress, Control;
+    CxPlatRioBufInitialize(
+        SendData->WsaBuffers[0].buf,
+        SendData->WsaBuffers[0].buf,
+        SendData->WsaBuffers[0].len,
+        &Data);
+    CxPlatRioBufInitialize(
+        SendData,
+        &SendData->MappedRemoteAddress,
+        sizeof(SendData->MappedRemoteAddress),
+        &RemoteAddress);
+    CxPlatRioBufInitialize(
+        SendData,
+        SendData->CtrlBuf,
+        RioCmsg->TotalLength,
+        &Control);
+
+    if (!Rio->RIOSendEx(
+            SocketProc->RioRq,
+            &Data,
+            1,
+            NULL,
+            SocketProc->Parent->HasFixedRemoteAddress ? NULL : &RemoteAddress,
+            RioCmsg->TotalLength > RIO_CMSG_BASE_SIZE ? &Control : NULL,
+            NULL,
+            Flags,
+            (PVOID)((ULONG_PTR)SendData | CXPLAT_RIO_SEND_REQUEST))) {
+        int WsaError = WSAGetLastError();
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketProc->Parent,
+            WsaError,
+            "RIOSendEx");
+        //
+        // Don't strand any sends deferred ahead of this one.
+        //
+        Rio->RIOSendEx(
+            SocketProc->RioRq, NULL, 0, NULL, NULL, NULL, NULL, RIO_MSG_COMMIT_ONLY, NULL);
+        return WsaError;
+    }
+
+    SocketProc->RioSendCount++;
+    return NO_ERROR;
+}
+
+//
+// Posts the send, or holds it in the backlog while the request queue is full.
+//
+void
+CxPlatSocketRioSend(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ ULONG ControlLength
+    )
+{
+    CXPLAT_SOCKET_PROC* SocketProc = SendData->SocketProc;
+    ((RIO_CMSG_BUFFER*)SendData->CtrlBuf)->TotalLength = RIO_CMSG_BASE_SIZE + ControlLength;
+
+    //
+    // The send holds a reference on the context until it completes.
+    //
+    CxPlatRefIncrement(&SocketProc->RefCount);
+
+    CxPlatLockAcquire(&SocketProc->RioLock);
+    if (SocketProc->RioSendCount == CXPLAT_RIO_SEND_QUEUE_DEPTH ||
+        !CxPlatListIsEmpty(&SocketProc->RioSendBacklog)) {
+        CxPlatListInsertTail(&SocketProc->RioSendBacklog, &SendData->RioLink);
+        CxPlatLockRelease(&SocketProc->RioLock);
+        return;
+    }
+
+    ULONG Error =
+        CxPlatSocketRioPostSend(
+            SocketProc, SendData, SendData->RioDefer ? RIO_MSG_DEFER : 0);
+    if (Error == NO_ERROR) {
+        CxPlatSocketRioArmNotify(SocketProc);
+    }
+    CxPlatLockRelease(&SocketProc->RioLock);
+
+    if (Error != NO_ERROR) {
+        CxPlatSendDataComplete(SendData, Error);
+        CxPlatSocketContextRelease(SocketProc);
+    }
+}
+
+void
+CxPlatDataPathSocketProcessRioCompletions(
+    _In_ CXPLAT_SOCKET_PROC* SocketProc
+    )
+{
+    const RIO_EXTENSION_FUNCTION_TABLE* Rio = &SocketProc->Parent->Datapath->RioDispatch;
+    RIORESULT Results[CXPLAT_RIO_MAX_COMPLETIONS];
+    CXPLAT_LIST_ENTRY FailedSends;
+    ULONG ResultCount;
+
+    CXPLAT_DBG_ASSERT(!SocketProc->Freed);
+    CxPlatListInitializeHead(&FailedSends);
+
+    //
+    // Without the rundown, the socket is cleaning up: completions are only
+    // released, and nothing is reposted.
+    //
+    const BOOLEAN Active = CxPlatRundownAcquire(&SocketProc->RundownRef);
+
+    for (uint32_t Dequeues = 0; Dequeues < CXPLAT_RIO_MAX_DEQUEUES; ++Dequeues) {
+
+        CxPlatLockAcquire(&SocketProc->RioLock);
+        ResultCount =
+            Rio->RIODequeueCompletion(
+                SocketProc->RioCq, Results, CXPLAT_RIO_MAX_COMPLETIONS);
+        CxPlatLockRelease(&SocketProc->RioLock);
+
+        if (ResultCount == RIO_CORRUPT_CQ) {
+            CXPLAT_DBG_ASSERT(FALSE);
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                SocketProc->Parent,
+                ResultCount,
+                "RIODequeueCompletion");
+            break;
+        }
+
+        ULONG RecvCompleted = 0, SendCompleted = 0;
+        for (ULONG i = 0; i < ResultCount; ++i) {
+            const RIORESULT* Result = &Results[i];
+            const ULONG_PTR RequestContext = (ULONG_PTR)Result->RequestContext;
+
+            if (RequestContext & CXPLAT_RIO_SEND_REQUEST) {
+                CxPlatSendDataComplete(
+                    (CXPLAT_SEND_DATA*)(RequestContext & ~CXPLAT_RIO_SEND_REQUEST),
+                    (ULONG)Result->Status);
+                ++SendCompleted;
+
+            } else {
+                DATAPATH_RX_IO_BLOCK* IoBlock = (DATAPATH_RX_IO_BLOCK*)RequestContext;
+                if (Active) {
+                    //
+                    // Point the message header at the control messages that
+                    // follow the RIO_CMSG_BUFFER header, so the completion is
+                    // processed exactly like a WSARecvMsg one.
+                    //
+                    const RIO_CMSG_BUFFER* RioCmsg = (const RIO_CMSG_BUFFER*)IoBlock->ControlBuf;
+                    IoBlock->WsaMsgHdr.Control.buf = IoBlock->ControlBuf + RIO_CMSG_BASE_SIZE;
+                    IoBlock->WsaMsgHdr.Control.len =
+                        RioCmsg->TotalLength > RIO_CMSG_BASE_SIZE ?
+                            RioCmsg->TotalLength - RIO_CMSG_BASE_SIZE : 0;
+                    CXPLAT_DBG_ASSERT(Result->BytesTransferred <= UINT16_MAX);
+                    (void)CxPlatDataPathUdpRecvComplete(
+                        SocketProc,
+                        IoBlock,
+                        Result->Status == WSAEMSGSIZE ? ERROR_MORE_DATA : (ULONG)Result->Status,
+                        (UINT16)Result->BytesTransferred);
+                } else {
+                    CxPlatSocketFreeRxIoBlock(IoBlock);
+                }
+                ++RecvCompleted;
+            }
+
+            CxPlatSocketContextRelease(SocketProc);
+        }
+
+        CxPlatLockAcquire(&SocketProc->RioLock);
+        SocketProc->RioRecvCount -= RecvCompleted;
+        SocketProc->RioSendCount -= SendCompleted;
+        if (Active) {
+            CxPlatSocketRioPostReceives(SocketProc);
+        }
+        while (SocketProc->RioSendCount < CXPLAT_RIO_SEND_QUEUE_DEPTH &&
+               !CxPlatListIsEmpty(&SocketProc->RioSendBacklog)) {
+            CXPLAT_SEND_DATA* SendData =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&SocketProc->RioSendBacklog),
+                    CXPLAT_SEND_DATA,
+                    RioLink);
+            if (!Active ||
+                CxPlatSocketRioPostSend(SocketProc, SendData, 0) != NO_ERROR) {
+                CxPlatListInsertTail(&FailedSends, &SendData->RioLink);
+            }
+        }
+        CxPlatLockRelease(&SocketProc->RioLock);
+
+        while (!CxPlatListIsEmpty(&FailedSends)) {
+            CXPLAT_SEND_DATA* SendData =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&FailedSends), CXPLAT_SEND_DATA, RioLink);
+            CxPlatSendDataComplete(SendData, WSAESHUTDOWN);
+            CxPlatSocketContextRelease(SocketProc);
+        }
+
+        if (ResultCount < CXPLAT_RIO_MAX_COMPLETIONS) {
+            break;
+        }
+    }
+
+    //
+    // Rearm the notification. If completions are already queued, it fires
+    // right away, and they are processed after any other queued work.
+    //
+    CxPlatLockAcquire(&SocketProc->RioLock);
+    SocketProc->RioNotifyArmed = FALSE;
+    CxPlatSocketRioArmNotify(SocketProc);
+    CxPlatLockRelease(&SocketProc->RioLock);
+
+    if (Active) {
+        CxPlatRundownRelease(&SocketProc->RundownRef);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 CxPlatSocketSendInline(
@@ -3813,7 +4484,8 @@ CxPlatSocketSendInline(
     }
     WSAMhdr.lpBuffers = SendData->WsaBuffers;
     WSAMhdr.dwBufferCount = SendData->WsaBufferCount;
-    WSAMhdr.Control.buf = SendData->CtrlBuf;
+    WSAMhdr.Control.buf =
+        Socket->UseRio ? SendData->CtrlBuf + RIO_CMSG_BASE_SIZE : SendData->CtrlBuf;
     WSAMhdr.Control.len = 0;
 
     PWSACMSGHDR CMsg = NULL;
@@ -3898,6 +4570,11 @@ CxPlatSocketSendInline(
         *(PDWORD)WSA_CMSG_DATA(CMsg) = SendData->SegmentSize;
     }
 
+    if (Socket->UseRio) {
+        CxPlatSocketRioSend(SendData, WSAMhdr.Control.len);
+        return;
+    }
+
     //
     // Windows' networking stack doesn't like a non-NULL Control.buf when len is 0.
     //
@@ -4003,6 +4680,27 @@ SocketSend(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    //
+    // Overlapped sends are each a single WSASendMsg; nothing to merge. RIO
+    // sends to the same socket context are deferred and committed together by
+    // the last of them, with a single kernel transition.
+    //
+    for (uint32_t i = 0; i < Count; ++i) {
+        SendData[i]->RioDefer =
+            Socket->UseRio && i + 1 < Count && Routes[i].Queue == Routes[i + 1].Queue;
+        SocketSend(Socket, &Routes[i], SendData[i]);
+    }
+}
+
 void
 CxPlatDataPathSocketProcessQueuedSend(
     _In_ CXPLAT_SEND_DATA* SendData
@@ -4175,3 +4873,15 @@ CxPlatIoConnectExEventComplete(
     CxPlatDataPathSocketProcessConnectCompletion(SocketProc, IoResult);
     CxPlatSocketContextRelease(SocketProc);
 }
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatIoRioNotifyEventComplete(
+    _In_ CXPLAT_CQE* Cqe
+    )
+{
+    CXPLAT_SQE* Sqe = CxPlatCqeGetSqe(Cqe);
+    CXPLAT_SOCKET_PROC* SocketProc = CONTAINING_RECORD(Sqe, CXPLAT_SOCKET_PROC, IoSqe);
+    CxPlatDataPathSocketProcessRioCompletions(SocketProc);
+    CxPlatSocketContextRelease(SocketProc);
+}
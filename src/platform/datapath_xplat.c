@@ -47,6 +47,24 @@ CxPlatDataPathInitialize(
         goto Error;
     }
 
+    if (InitConfig->Loopback != NULL) {
+        Status =
+            LoopbackDataPathInitialize(
+                ClientRecvContextLength,
+                *NewDataPath,
+                WorkerPool,
+                InitConfig->Loopback,
+                &((*NewDataPath)->Loopback));
+        if (QUIC_FAILED(Status)) {
+            QuicTraceLogVerbose(
+                LoopbackDatapathInitFail,
+                "[  dp] Failed to initialize loopback datapath, status:%d", Status);
+            DataPathUninitialize(*NewDataPath);
+            *NewDataPath = NULL;
+            goto Error;
+        }
+    }
+
     //
     // Best effort try to initialize the raw datapath.
     //
@@ -54,6 +72,7 @@ CxPlatDataPathInitialize(
         ClientRecvContextLength,
         *NewDataPath,
         WorkerPool,
+        InitConfig,
         &((*NewDataPath)->RawDataPath));
 
 Error:
@@ -70,6 +89,9 @@ CxPlatDataPathUninitialize(
     if (Datapath->RawDataPath) {
         RawDataPathUninitialize(Datapath->RawDataPath);
     }
+    if (Datapath->Loopback) {
+        LoopbackDataPathUninitialize(Datapath->Loopback);
+    }
     DataPathUninitialize(Datapath);
 }
 
@@ -94,6 +116,9 @@ CxPlatDataPathGetSupportedFeatures(
     _In_ CXPLAT_SOCKET_FLAGS SocketFlags
     )
 {
+    if (Datapath->Loopback) {
+        return LoopbackDataPathGetSupportedFeatures(DataPathGetSupportedFeatures(Datapath));
+    }
     if (Datapath->RawDataPath && (SocketFlags & CXPLAT_SOCKET_FLAG_XDP)) {
         return DataPathGetSupportedFeatures(Datapath) |
                RawDataPathGetSupportedFeatures(Datapath->RawDataPath);
@@ -108,6 +133,9 @@ CxPlatDataPathIsPaddingPreferred(
     _In_ CXPLAT_SEND_DATA* SendData
     )
 {
+    if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        return FALSE;
+    }
     CXPLAT_DBG_ASSERT(
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_NORMAL ||
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_RAW);
@@ -175,6 +203,13 @@ CxPlatSocketCreateUdp(
         break;
     }
 
+    if (QUIC_SUCCEEDED(Status) && Datapath->Loopback) {
+        Status = LoopbackSocketCreateUdp(Datapath->Loopback, Config, *NewSocket);
+        if (QUIC_FAILED(Status)) {
+            CxPlatSocketDelete(*NewSocket);
+        }
+    }
+
 Error:
     return Status;
 }
@@ -219,6 +254,9 @@ CxPlatSocketDelete(
     _In_ CXPLAT_SOCKET* Socket
     )
 {
+    if (Socket->Datapath->Loopback) {
+        LoopbackSocketDelete(Socket->Datapath->Loopback, Socket);
+    }
     if (Socket->RawSocketAvailable) {
         RawSocketDelete(CxPlatSocketToRaw(Socket));
     }
@@ -280,6 +318,10 @@ CxPlatRecvDataReturn(
     if (RecvDataChain == NULL) {
         return;
     }
+    if (RecvDataChain->DatapathType == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        LoopbackRecvDataReturn(RecvDataChain);
+        return;
+    }
     CXPLAT_DBG_ASSERT(
         RecvDataChain->DatapathType == CXPLAT_DATAPATH_TYPE_NORMAL ||
         RecvDataChain->DatapathType == CXPLAT_DATAPATH_TYPE_RAW);
@@ -297,7 +339,9 @@ CxPlatSendDataAlloc(
 {
     CXPLAT_SEND_DATA* SendData = NULL;
     // TODO: fallback?
-    if (Config->Route->DatapathType == CXPLAT_DATAPATH_TYPE_RAW ||
+    if (Socket->Datapath->Loopback) {
+        SendData = LoopbackSendDataAlloc(Socket->Datapath->Loopback, Config);
+    } else if (Config->Route->DatapathType == CXPLAT_DATAPATH_TYPE_RAW ||
         (Config->Route->DatapathType == CXPLAT_DATAPATH_TYPE_UNKNOWN &&
         Socket->RawSocketAvailable && !IS_LOOPBACK(Config->Route->RemoteAddress))) {
         SendData = RawSendDataAlloc(Config);
@@ -313,6 +357,10 @@ CxPlatSendDataFree(
     _In_ CXPLAT_SEND_DATA* SendData
     )
 {
+    if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        LoopbackSendDataFree(SendData);
+        return;
+    }
     CXPLAT_DBG_ASSERT(
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_NORMAL ||
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_RAW);
@@ -328,6 +376,9 @@ CxPlatSendDataAllocBuffer(
     _In_ uint16_t MaxBufferLength
     )
 {
+    if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        return LoopbackSendDataAllocBuffer(SendData, MaxBufferLength);
+    }
     CXPLAT_DBG_ASSERT(
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_NORMAL ||
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_RAW);
@@ -343,6 +394,10 @@ CxPlatSendDataFreeBuffer(
     _In_ QUIC_BUFFER* Buffer
     )
 {
+    if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        LoopbackSendDataFreeBuffer(SendData, Buffer);
+        return;
+    }
     CXPLAT_DBG_ASSERT(
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_NORMAL ||
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_RAW);
@@ -356,6 +411,9 @@ CxPlatSendDataIsFull(
     _In_ CXPLAT_SEND_DATA* SendData
     )
 {
+    if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        return LoopbackSendDataIsFull(SendData);
+    }
     CXPLAT_DBG_ASSERT(
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_NORMAL ||
         DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_RAW);
@@ -373,12 +431,49 @@ CxPlatSocketSend(
 {
     if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_NORMAL) {
         SocketSend(Socket, Route, SendData);
+     } else if (DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_LOOPBACK) {
+        LoopbackSocketSend(Socket, Route, SendData);
      } else {
         CXPLAT_DBG_ASSERT(DatapathType(SendData) == CXPLAT_DATAPATH_TYPE_RAW);
         RawSocketSend(CxPlatSocketToRaw(Socket), Route, SendData);
      }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    )
+{
+    uint32_t RawCount = 0;
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (DatapathType(SendData[i]) == CXPLAT_DATAPATH_TYPE_RAW) {
+            RawCount++;
+        }
+    }
+    if (RawCount == Count) {
+        RawSocketSendBatch(CxPlatSocketToRaw(Socket), Routes, SendData, Count);
+        return;
+    }
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (DatapathType(SendData[i]) != CXPLAT_DATAPATH_TYPE_NORMAL) {
+            //
+            // Mixed into the raw or loopback datapath; no batching.
+            //
+            for (uint32_t j = 0; j < Count; ++j) {
+                CxPlatSocketSend(Socket, &Routes[j], SendData[j]);
+            }
+            return;
+        }
+    }
+
+    SocketSendBatch(Socket, Routes, SendData, Count);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicCopyRouteInfo(
@@ -464,6 +464,408 @@ Return Value:
     Context->Signature = Signature;
 }
 
+//
+// Open addressing (CXPLAT_HASH_OPEN_ADDRESSING) tables.
+//
+// Entry pointers are stored in a flat array of slots, followed by a parallel
+// array with one tag byte per slot: 7 bits of the mixed signature for a used
+// slot, or one of the special values below. Slots are probed a group of 8 at
+// a time, testing all the tag bytes of the group with a few 64-bit operations,
+// and groups are visited in triangular order from the one the signature maps
+// to. A lookup usually reads a single tag word and only the entries whose tag
+// matches; a probe ends at the first group with an empty slot.
+//
+// Removed entries leave a tombstone, unless their group has an empty slot
+// (no probe goes past such a group). The table is rebuilt when used and
+// tombstone slots exceed 7/8 of its size. If that isn't possible, because an
+// allocation failed or the table is being enumerated, entries that don't find
+// a free slot go to an overflow list, so that insertion never fails.
+//
+
+#define HT_OPEN_GROUP_WIDTH     8
+#define HT_OPEN_TAG_EMPTY       ((uint8_t)0x80)
+#define HT_OPEN_TAG_DELETED     ((uint8_t)0xFE)
+#define HT_OPEN_LSBS            0x0101010101010101ull
+#define HT_OPEN_MSBS            0x8080808080808080ull
+#define HT_OPEN_START_SLOT      UINT32_MAX
+
+QUIC_INLINE
+uint64_t
+CxPlatOpenMixSignature(
+    _In_ uint64_t Signature
+    )
+{
+    //
+    // Callers' signatures are often sequential (stream IDs) or weak, so spread
+    // them over all bits (Fibonacci hashing). The group index comes from bits
+    // 32 and up, the tag from the top 7 bits.
+    //
+    return Signature * 0x9E3779B97F4A7C15ull;
+}
+
+QUIC_INLINE
+uint8_t*
+CxPlatOpenTags(
+    _In_ const CXPLAT_HASHTABLE* HashTable
+    )
+{
+    return (uint8_t*)(HashTable->Slots + HashTable->TableSize);
+}
+
+//
+// Loads the 8 tag bytes of a group, with the first slot's in the lowest byte.
+//
+QUIC_INLINE
+uint64_t
+CxPlatOpenLoadGroup(
+    _In_ const uint8_t* Tags,
+    _In_ uint32_t Group
+    )
+{
+    uint64_t Word;
+    CxPlatCopyMemory(&Word, Tags + (size_t)Group * HT_OPEN_GROUP_WIDTH, sizeof(Word));
+    return Word;
+}
+
+//
+// The Match functions return a mask with the high bit of every matching byte
+// set. MatchTag may also flag the byte just after a real match; callers always
+// check the entry's signature anyway.
+//
+QUIC_INLINE
+uint64_t
+CxPlatOpenMatchTag(
+    _In_ uint64_t Word,
+    _In_ uint8_t Tag
+    )
+{
+    const uint64_t X = Word ^ (HT_OPEN_LSBS * Tag);
+    return (X - HT_OPEN_LSBS) & ~X & HT_OPEN_MSBS;
+}
+
+QUIC_INLINE
+uint64_t
+CxPlatOpenMatchEmpty(
+    _In_ uint64_t Word
+    )
+{
+    return Word & ~(Word << 6) & HT_OPEN_MSBS; // 0x80 but not 0xFE
+}
+
+QUIC_INLINE
+uint64_t
+CxPlatOpenMatchFree(
+    _In_ uint64_t Word
+    )
+{
+    return Word & HT_OPEN_MSBS; // Empty or deleted
+}
+
+//
+// Returns the index, in its group, of the lowest byte flagged in the mask.
+//
+QUIC_INLINE
+uint32_t
+CxPlatOpenLowestByte(
+    _In_ uint64_t Mask
+    )
+{
+    CXPLAT_DBG_ASSERT(Mask != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(Mask) / 8;
+#elif defined(_M_X64) || defined(_M_ARM64)
+    unsigned long Index;
+    _BitScanForward64(&Index, Mask);
+    return (uint32_t)Index / 8;
+#else
+    uint32_t Index = 0;
+    while ((Mask & 0x80) == 0) {
+        Mask >>= 8;
+        Index++;
+    }
+    return Index;
+#endif
+}
+
+//
+// Allocates the slots and tags of an empty table of the given size.
+//
+static
+_Success_(return != FALSE)
+BOOLEAN
+CxPlatOpenAllocate(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ uint32_t TableSize
+    )
+{
+    CXPLAT_DBG_ASSERT(IS_POWER_OF_TWO(TableSize) && TableSize >= HT_OPEN_GROUP_WIDTH);
+    const size_t Size = (size_t)TableSize * (sizeof(CXPLAT_HASHTABLE_ENTRY*) + 1);
+    CXPLAT_HASHTABLE_ENTRY** Slots = CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_HASHTABLE_MEMBER);
+    if (Slots == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "hash table slots",
+            Size);
+        return FALSE;
+    }
+
+    HashTable->Slots = Slots;
+    HashTable->TableSize = TableSize;
+    HashTable->DivisorMask = TableSize / HT_OPEN_GROUP_WIDTH - 1;
+    HashTable->NumDeleted = 0;
+    CxPlatZeroMemory(Slots, (size_t)TableSize * sizeof(CXPLAT_HASHTABLE_ENTRY*));
+    memset(CxPlatOpenTags(HashTable), HT_OPEN_TAG_EMPTY, TableSize);
+    return TRUE;
+}
+
+//
+// Stores the entry in the first free slot of its probe sequence. Returns FALSE
+// if there is none.
+//
+static
+BOOLEAN
+CxPlatOpenPlace(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ CXPLAT_HASHTABLE_ENTRY* Entry
+    )
+{
+    const uint64_t Hash = CxPlatOpenMixSignature(Entry->Signature);
+    uint8_t* Tags = CxPlatOpenTags(HashTable);
+    uint32_t Group = (uint32_t)(Hash >> 32) & HashTable->DivisorMask;
+
+    for (uint32_t Probe = 0; Probe <= HashTable->DivisorMask; Probe++) {
+        const uint64_t Free = CxPlatOpenMatchFree(CxPlatOpenLoadGroup(Tags, Group));
+        if (Free != 0) {
+            const uint32_t Slot =
+                Group * HT_OPEN_GROUP_WIDTH + CxPlatOpenLowestByte(Free);
+            if (Tags[Slot] == HT_OPEN_TAG_DELETED) {
+                HashTable->NumDeleted--;
+            }
+            Tags[Slot] = (uint8_t)(Hash >> 57);
+            HashTable->Slots[Slot] = Entry;
+            Entry->Linkage.Flink = NULL; // Not in the overflow list.
+            return TRUE;
+        }
+        Group = (Group + Probe + 1) & HashTable->DivisorMask;
+    }
+
+    return FALSE;
+}
+
+//
+// Rebuilds the table, with room for twice the current number of entries, and
+// moves any overflow entries back into the slots.
+//
+static
+BOOLEAN
+CxPlatOpenRebuild(
+    _Inout_ CXPLAT_HASHTABLE* HashTable
+    )
+{
+    uint32_t NewSize = BASE_HASH_TABLE_SIZE;
+    while (NewSize < 2 * HashTable->NumEntries) {
+        NewSize <<= 1;
+    }
+
+    CXPLAT_HASHTABLE Old = *HashTable;
+    if (!CxPlatOpenAllocate(HashTable, NewSize)) {
+        return FALSE;
+    }
+
+    const uint8_t* OldTags = CxPlatOpenTags(&Old);
+    for (uint32_t i = 0; i < Old.TableSize; i++) {
+        if ((OldTags[i] & 0x80) == 0) {
+            BOOLEAN Placed = CxPlatOpenPlace(HashTable, Old.Slots[i]);
+            CXPLAT_DBG_ASSERT(Placed);
+            UNREFERENCED_PARAMETER(Placed);
+        }
+    }
+    while (!CxPlatListIsEmpty(&HashTable->Overflow)) {
+        CXPLAT_LIST_ENTRY* Linkage = CxPlatListRemoveHead(&HashTable->Overflow);
+        BOOLEAN Placed =
+            CxPlatOpenPlace(
+                HashTable,
+                CXPLAT_CONTAINING_RECORD(Linkage, CXPLAT_HASHTABLE_ENTRY, Linkage));
+        CXPLAT_DBG_ASSERT(Placed);
+        UNREFERENCED_PARAMETER(Placed);
+    }
+
+    CXPLAT_FREE(Old.Slots, QUIC_POOL_HASHTABLE_MEMBER);
+    return TRUE;
+}
+
+static
+void
+CxPlatOpenInsert(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ CXPLAT_HASHTABLE_ENTRY* Entry
+    )
+{
+    HashTable->NumEntries++;
+
+    if ((HashTable->NumEntries + HashTable->NumDeleted) * 8 > HashTable->TableSize * 7 &&
+        HashTable->NumEnumerators == 0) {
+        (void)CxPlatOpenRebuild(HashTable); // Overflows on failure.
+    }
+
+    if (!CxPlatOpenPlace(HashTable, Entry)) {
+        CxPlatListInsertTail(&HashTable->Overflow, &Entry->Linkage);
+    }
+}
+
+static
+void
+CxPlatOpenRemove(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ CXPLAT_HASHTABLE_ENTRY* Entry
+    )
+{
+    CXPLAT_DBG_ASSERT(HashTable->NumEntries > 0);
+    HashTable->NumEntries--;
+
+    if (Entry->Linkage.Flink != NULL) {
+        CxPlatListEntryRemove(&Entry->Linkage);
+        return;
+    }
+
+    const uint64_t Hash = CxPlatOpenMixSignature(Entry->Signature);
+    const uint8_t Tag = (uint8_t)(Hash >> 57);
+    uint8_t* Tags = CxPlatOpenTags(HashTable);
+    uint32_t Group = (uint32_t)(Hash >> 32) & HashTable->DivisorMask;
+
+    for (uint32_t Probe = 0; Probe <= HashTable->DivisorMask; Probe++) {
+        const uint64_t Word = CxPlatOpenLoadGroup(Tags, Group);
+        uint64_t Match = CxPlatOpenMatchTag(Word, Tag);
+        while (Match != 0) {
+            const uint32_t Slot =
+                Group * HT_OPEN_GROUP_WIDTH + CxPlatOpenLowestByte(Match);
+            if (HashTable->Slots[Slot] == Entry) {
+                HashTable->Slots[Slot] = NULL;
+                if (CxPlatOpenMatchEmpty(Word) != 0) {
+                    Tags[Slot] = HT_OPEN_TAG_EMPTY;
+                } else {
+                    Tags[Slot] = HT_OPEN_TAG_DELETED;
+                    HashTable->NumDeleted++;
+                }
+                return;
+            }
+            Match &= Match - 1;
+        }
+        Group = (Group + Probe + 1) & HashTable->DivisorMask;
+    }
+
+    CXPLAT_DBG_ASSERT(FALSE); // Not in the table.
+}
+
+//
+// Returns the next entry matching the context's signature after the position
+// recorded in the context, and records the new position.
+//
+static
+CXPLAT_HASHTABLE_ENTRY*
+CxPlatOpenFind(
+    _In_ const CXPLAT_HASHTABLE* HashTable,
+    _Inout_ CXPLAT_HASHTABLE_LOOKUP_CONTEXT* Context
+    )
+{
+    if (Context->OverflowLinkage == NULL) {
+        const uint64_t Hash = CxPlatOpenMixSignature(Context->Signature);
+        const uint8_t Tag = (uint8_t)(Hash >> 57);
+        const uint8_t* Tags = CxPlatOpenTags(HashTable);
+        uint32_t Probe = Context->Probe;
+        uint32_t Group =
+            ((uint32_t)(Hash >> 32) + Probe * (Probe + 1) / 2) & HashTable->DivisorMask;
+
+        //
+        // When resuming, skip the slots up to the one last returned.
+        //
+        uint64_t Skip = 0;
+        if (Context->Slot != HT_OPEN_START_SLOT) {
+            const uint32_t Index = Context->Slot % HT_OPEN_GROUP_WIDTH;
+            Skip = Index == HT_OPEN_GROUP_WIDTH - 1 ?
+                UINT64_MAX : (1ull << (8 * (Index + 1))) - 1;
+        }
+
+        for (; Probe <= HashTable->DivisorMask; Probe++) {
+            const uint64_t Word = CxPlatOpenLoadGroup(Tags, Group);
+            uint64_t Match = CxPlatOpenMatchTag(Word, Tag) & ~Skip;
+            Skip = 0;
+            while (Match != 0) {
+                const uint32_t Slot =
+                    Group * HT_OPEN_GROUP_WIDTH + CxPlatOpenLowestByte(Match);
+                CXPLAT_HASHTABLE_ENTRY* Entry = HashTable->Slots[Slot];
+                if (Entry->Signature == Context->Signature) {
+                    Context->Slot = Slot;
+                    Context->Probe = Probe;
+                    return Entry;
+                }
+                Match &= Match - 1;
+            }
+            if (CxPlatOpenMatchEmpty(Word) != 0) {
+                break;
+            }
+            Group = (Group + Probe + 1) & HashTable->DivisorMask;
+        }
+
+        Context->OverflowLinkage = (CXPLAT_LIST_ENTRY*)&HashTable->Overflow;
+    }
+
+    for (CXPLAT_LIST_ENTRY* Linkage = Context->OverflowLinkage->Flink;
+         Linkage != &HashTable->Overflow;
+         Linkage = Linkage->Flink) {
+        CXPLAT_HASHTABLE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Linkage, CXPLAT_HASHTABLE_ENTRY, Linkage);
+        if (Entry->Signature == Context->Signature) { // Never matches an enumerator.
+            Context->OverflowLinkage = Linkage;
+            return Entry;
+        }
+    }
+
+    return NULL;
+}
+
+static
+CXPLAT_HASHTABLE_ENTRY*
+CxPlatOpenEnumerateNext(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _Inout_ CXPLAT_HASHTABLE_ENUMERATOR* Enumerator
+    )
+{
+    const uint8_t* Tags = CxPlatOpenTags(HashTable);
+    for (uint32_t i = Enumerator->BucketIndex; i < HashTable->TableSize; i++) {
+        if ((Tags[i] & 0x80) == 0) {
+            Enumerator->BucketIndex = i + 1;
+            return HashTable->Slots[i];
+        }
+    }
+    Enumerator->BucketIndex = HashTable->TableSize;
+
+    //
+    // Then walk the overflow list, keeping the enumerator itself in the list
+    // (like in a bucket chain) so that entries can be removed meanwhile.
+    //
+    if (Enumerator->ChainHead == NULL) {
+        Enumerator->ChainHead = &HashTable->Overflow;
+        CxPlatListInsertHead(&HashTable->Overflow, &Enumerator->HashEntry.Linkage);
+    }
+
+    CXPLAT_LIST_ENTRY* CurEntry = &Enumerator->HashEntry.Linkage;
+    while (CurEntry->Flink != &HashTable->Overflow) {
+        CXPLAT_LIST_ENTRY* NextEntry = CurEntry->Flink;
+        CXPLAT_HASHTABLE_ENTRY* NextHashEntry =
+            CXPLAT_CONTAINING_RECORD(NextEntry, CXPLAT_HASHTABLE_ENTRY, Linkage);
+        if (NextHashEntry->Signature != CXPLAT_HASH_RESERVED_SIGNATURE) {
+            CxPlatListEntryRemove(&Enumerator->HashEntry.Linkage);
+            CxPlatListInsertHead(NextEntry, &Enumerator->HashEntry.Linkage);
+            return NextHashEntry;
+        }
+        CurEntry = NextEntry;
+    }
+
+    return NULL;
+}
+
 _Must_inspect_result_
 _Success_(return != FALSE)
 BOOLEAN
@@ -472,6 +874,19 @@ CxPlatHashtableInitialize(
         CXPLAT_HASHTABLE* *HashTable,
     _In_ uint32_t InitialSize
     )
+{
+    return CxPlatHashtableInitializeWithFlags(HashTable, InitialSize, 0);
+}
+
+_Must_inspect_result_
+_Success_(return != FALSE)
+BOOLEAN
+CxPlatHashtableInitializeWithFlags(
+    _Inout_ _When_(NULL == *HashTable, _At_(*HashTable, __drv_allocatesMem(Mem) _Post_notnull_))
+        CXPLAT_HASHTABLE* *HashTable,
+    _In_ uint32_t InitialSize,
+    _In_ uint32_t Flags
+    )
 /*++
 
 Routine Description:
@@ -491,7 +906,10 @@ Arguments:
         which case a CXPLAT_HASHTABLE will be allocated, or can contain a
         pre-allocated CXPLAT_HASHTABLE.
 
-    InitialSize - The initial size of the hash table in number of buckets.
+    InitialSize - The initial size of the hash table in number of buckets (or
+        slots, for open addressing).
+
+    Flags - CXPLAT_HASH_OPEN_ADDRESSING or 0.
 
 Return Value:
 
@@ -532,6 +950,18 @@ Return Value:
 
     CxPlatZeroMemory(Table, sizeof(CXPLAT_HASHTABLE));
     Table->Flags = LocalFlags;
+
+    if (Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        Table->Flags |= CXPLAT_HASH_OPEN_ADDRESSING;
+        CxPlatListInitializeHead(&Table->Overflow);
+        if (!CxPlatOpenAllocate(Table, InitialSize)) {
+            CxPlatHashtableUninitialize(Table);
+            return FALSE;
+        }
+        *HashTable = Table;
+        return TRUE;
+    }
+
     Table->TableSize = InitialSize;
     Table->DivisorMask = Table->TableSize - 1;
     Table->Pivot = 0;
@@ -645,7 +1075,15 @@ Arguments:
     CXPLAT_DBG_ASSERT(HashTable->NumEnumerators == 0);
     CXPLAT_DBG_ASSERT(HashTable->NumEntries == 0);
 
-    if (HashTable->TableSize <= HT_SECOND_LEVEL_DIR_MIN_SIZE) {
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+
+        CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&HashTable->Overflow));
+        if (HashTable->Slots != NULL) {
+            CXPLAT_FREE(HashTable->Slots, QUIC_POOL_HASHTABLE_MEMBER);
+            HashTable->Slots = NULL;
+        }
+
+    } else if (HashTable->TableSize <= HT_SECOND_LEVEL_DIR_MIN_SIZE) {
 
         if (HashTable->SecondLevelDir != NULL) {
             CXPLAT_FREE(HashTable->SecondLevelDir, QUIC_POOL_HASHTABLE_MEMBER);
@@ -749,6 +1187,12 @@ Arguments:
 
     Entry->Signature = Signature;
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        UNREFERENCED_PARAMETER(Context); // Positions aren't reused.
+        CxPlatOpenInsert(HashTable, Entry);
+        return;
+    }
+
     HashTable->NumEntries++;
 
     if (Context == NULL) {
@@ -828,6 +1272,17 @@ Arguments:
 {
     uint64_t Signature = Entry->Signature;
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        CxPlatOpenRemove(HashTable, Entry);
+        if (Context != NULL) {
+            Context->Slot = HT_OPEN_START_SLOT;
+            Context->Probe = 0;
+            Context->OverflowLinkage = NULL;
+            Context->Signature = Signature;
+        }
+        return;
+    }
+
     CXPLAT_DBG_ASSERT(HashTable->NumEntries > 0);
     HashTable->NumEntries--;
 
@@ -918,6 +1373,14 @@ Return Value:
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT* ContextPtr =
         (Context != NULL) ? Context : &LocalContext; // cppcheck-suppress uninitvar
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        ContextPtr->Slot = HT_OPEN_START_SLOT;
+        ContextPtr->Probe = 0;
+        ContextPtr->OverflowLinkage = NULL;
+        ContextPtr->Signature = Signature;
+        return CxPlatOpenFind(HashTable, ContextPtr);
+    }
+
     CxPlatPopulateContext(HashTable, ContextPtr, Signature);
 
     CXPLAT_LIST_ENTRY* CurEntry = ContextPtr->PrevLinkage->Flink;
@@ -974,6 +1437,11 @@ Return Value:
 --*/
 {
     CXPLAT_DBG_ASSERT(NULL != Context);
+
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        return CxPlatOpenFind(HashTable, Context);
+    }
+
     CXPLAT_DBG_ASSERT(NULL != Context->ChainHead);
     CXPLAT_DBG_ASSERT(Context->PrevLinkage->Flink != Context->ChainHead);
 
@@ -1062,6 +1530,14 @@ Arguments:
 {
     CXPLAT_DBG_ASSERT(Enumerator != NULL);
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        HashTable->NumEnumerators++;
+        Enumerator->BucketIndex = 0;
+        Enumerator->ChainHead = NULL; // Set once in the overflow list.
+        Enumerator->HashEntry.Signature = CXPLAT_HASH_RESERVED_SIGNATURE;
+        return;
+    }
+
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT LocalContext;
     CxPlatPopulateContext(HashTable, &LocalContext, 0);
     HashTable->NumEnumerators++;
@@ -1116,9 +1592,14 @@ Return Value:
 --*/
 {
     CXPLAT_DBG_ASSERT(Enumerator != NULL);
-    CXPLAT_DBG_ASSERT(Enumerator->ChainHead != NULL);
     CXPLAT_DBG_ASSERT(CXPLAT_HASH_RESERVED_SIGNATURE == Enumerator->HashEntry.Signature);
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        return CxPlatOpenEnumerateNext(HashTable, Enumerator);
+    }
+
+    CXPLAT_DBG_ASSERT(Enumerator->ChainHead != NULL);
+
     //
     // We are trying to find the next valid entry. We need
     // to skip over other enumerators AND empty buckets.
@@ -1202,6 +1683,14 @@ Arguments:
     CXPLAT_DBG_ASSERT(HashTable->NumEnumerators > 0);
     HashTable->NumEnumerators--;
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        if (Enumerator->ChainHead != NULL) {
+            CxPlatListEntryRemove(&Enumerator->HashEntry.Linkage);
+            Enumerator->ChainHead = NULL;
+        }
+        return;
+    }
+
     if (!CxPlatListIsEmpty(&(Enumerator->HashEntry.Linkage))) {
         CXPLAT_DBG_ASSERT(Enumerator->ChainHead != NULL);
 
@@ -61,6 +61,11 @@ typedef struct CXPLAT_DATAPATH_COMMON {
     CXPLAT_DATAPATH_FEATURES Features;
 
     CXPLAT_DATAPATH_RAW* RawDataPath;
+
+    //
+    // The in-process loopback datapath, if enabled.
+    //
+    CXPLAT_DATAPATH_LOOPBACK* Loopback;
 } CXPLAT_DATAPATH_COMMON;
 
 typedef struct CXPLAT_SOCKET_COMMON {
@@ -118,6 +123,7 @@ typedef enum CXPLAT_DATAPATH_TYPE {
     CXPLAT_DATAPATH_TYPE_UNKNOWN = 0,
     CXPLAT_DATAPATH_TYPE_NORMAL,
     CXPLAT_DATAPATH_TYPE_RAW, // currently raw == xdp
+    CXPLAT_DATAPATH_TYPE_LOOPBACK,
 } CXPLAT_DATAPATH_TYPE;
 
 typedef enum CXPLAT_SOCKET_TYPE {
@@ -340,6 +346,24 @@ typedef struct CX_PLATFORM {
 
 } CX_PLATFORM;
 
+//
+// A pool of buffers registered with Registered I/O (RIO). Each allocation is
+// registered as its own RIO buffer.
+//
+typedef struct CXPLAT_RIO_POOL {
+
+    //
+    // The underlying pool. Must be first.
+    //
+    CXPLAT_POOL_EX Base;
+
+    //
+    // The datapath, for its RIO function table.
+    //
+    CXPLAT_DATAPATH* Datapath;
+
+} CXPLAT_RIO_POOL;
+
 //
 // Represents a single IO completion port and thread for processing work that is
 // completed on a single processor.
@@ -393,6 +417,15 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PROC {
     //
     CXPLAT_POOL_EX RecvDatagramPool;
 
+    //
+    // RIO registered versions of the pools above, for sockets using RIO. Only
+    // initialized if the datapath supports RIO.
+    //
+    CXPLAT_RIO_POOL RioSendDataPool;
+    CXPLAT_RIO_POOL RioSendBufferPool;
+    CXPLAT_RIO_POOL RioLargeSendBufferPool;
+    CXPLAT_RIO_POOL RioRecvDatagramPool;
+
 } CXPLAT_DATAPATH_PARTITION;
 
 //
@@ -461,6 +494,38 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_PROC {
         sizeof(SOCKADDR_INET) + 16
         ];
     };
+    //
+    // UDP socket RIO data. IoSqe is used for the completion queue's
+    // notification.
+    //
+    struct {
+    //
+    // Completion queue for all the socket's requests.
+    //
+    RIO_CQ RioCq;
+    //
+    // Request queue for the socket's receives and sends.
+    //
+    RIO_RQ RioRq;
+    //
+    // Serializes use of the request and completion queues.
+    //
+    CXPLAT_LOCK RioLock;
+    //
+    // Outstanding receive and send requests.
+    //
+    ULONG RioRecvCount;
+    ULONG RioSendCount;
+    //
+    // Sends waiting for room in the request queue.
+    //
+    CXPLAT_LIST_ENTRY RioSendBacklog;
+    //
+    // Indicates the completion queue's notification is armed. The armed
+    // notification holds a reference on the socket context.
+    //
+    BOOLEAN RioNotifyArmed;
+    };
     };
 } CXPLAT_SOCKET_PROC;
 
@@ -490,6 +555,11 @@ typedef struct CXPLAT_DATAPATH {
     //
     LPFN_WSARECVMSG WSARecvMsg;
 
+    //
+    // Registered I/O function table. Only valid if RioSupported is set.
+    //
+    RIO_EXTENSION_FUNCTION_TABLE RioDispatch;
+
     //
     // Used to synchronize clean up.
     //
@@ -525,6 +595,11 @@ typedef struct CXPLAT_DATAPATH {
 
     uint8_t ReserveAuxTcpSock : 1;
 
+    //
+    // Indicates Registered I/O is available for UDP sockets.
+    //
+    uint8_t RioSupported : 1;
+
     //
     // Per-processor completion contexts.
     //
@@ -579,6 +654,11 @@ typedef struct CXPLAT_SOCKET {
     //
     uint8_t PcpBinding : 1;
 
+    //
+    // Flag indicates the socket uses Registered I/O.
+    //
+    uint8_t UseRio : 1;
+
     //
     // Debug flags.
     //
@@ -628,6 +708,22 @@ typedef struct CX_PLATFORM {
                               (Address.Ip.sa_family == QUIC_ADDRESS_FAMILY_INET6 &&       \
                                IN6_IS_ADDR_LOOPBACK(&Address.Ipv6.sin6_addr)))
 
+//
+// Maps memory backed by huge pages, rounded up to a multiple of
+// CXPLAT_HUGE_PAGE_SIZE. Explicitly reserved huge pages are used if available,
+// and transparent huge pages are requested otherwise.
+//
+void*
+CxPlatHugePageAlloc(
+    _In_ size_t Length
+    );
+
+void
+CxPlatHugePageFree(
+    _In_ void* Memory,
+    _In_ size_t Length
+    );
+
 #else
 
 #error "Unsupported Platform"
@@ -718,6 +814,29 @@ CxPlatCryptUninitialize(
     void
     );
 
+//
+// Number of header protection samples processed in lock step by the portable
+// ChaCha20 mask kernel.
+//
+#define CXPLAT_CHACHA20_HP_LANES 8
+
+//
+// Computes the ChaCha20 header protection masks (RFC 9001, Section 5.4.4) for
+// a batch of samples. Independent samples are processed in lanes so the
+// compiler can map each ChaCha20 round onto vector instructions, instead of
+// reinitializing a cipher context per sample.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatChaCha20HpComputeMask(
+    _In_reads_(8) const uint32_t* Key,
+    _In_ uint8_t BatchSize,
+    _In_reads_bytes_(CXPLAT_HP_SAMPLE_LENGTH * BatchSize)
+        const uint8_t* const Cipher,
+    _Out_writes_bytes_(CXPLAT_HP_SAMPLE_LENGTH * BatchSize)
+        uint8_t* Mask
+    );
+
 //
 // Queries the raw datapath stack for the total size needed to allocate the
 // datapath structure.
@@ -795,6 +914,20 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     CXPLAT_LOCK TxQueueLock;
 
+#ifndef CXPLAT_USE_IO_URING
+    //
+    // Sends passed to the kernel with MSG_ZEROCOPY that are still waiting for
+    // their completion notification. Protected by TxQueueLock.
+    //
+    CXPLAT_LIST_ENTRY ZeroCopyQueue;
+
+    //
+    // The notification ID the kernel will assign to the next zero-copy send.
+    // Protected by TxQueueLock.
+    //
+    uint32_t ZeroCopyNextId;
+#endif // CXPLAT_USE_IO_URING
+
     //
     // Rundown for synchronizing clean up with upcalls.
     //
@@ -809,6 +942,14 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     int64_t IoCountTags[IoTagMax];
 #endif // defined(CXPLAT_USE_IO_URING) && defined(DEBUG)
 
+#ifdef CXPLAT_USE_IO_URING
+    //
+    // The socket's slot in the partition's registered file table, or -1 if the
+    // socket isn't registered and IO uses SocketFd directly.
+    //
+    int FixedFileIndex;
+#endif // CXPLAT_USE_IO_URING
+
     //
     // Inidicates the SQEs have been initialized.
     //
@@ -819,6 +960,16 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     BOOLEAN IoStarted : 1;
 
+    //
+    // Indicates large segmented sends on this socket are sent zero-copy.
+    //
+    BOOLEAN ZeroCopyEnabled : 1;
+
+    //
+    // Indicates sends on this socket may carry a departure time (SO_TXTIME).
+    //
+    BOOLEAN TxTimeEnabled : 1;
+
 #ifdef CXPLAT_USE_IO_URING
     struct {
         //
@@ -912,6 +1063,7 @@ typedef struct CXPLAT_REGISTERED_BUFFER_POOL {
     uint8_t* Buffers;
     uint32_t BufferSize;
     uint32_t TotalSize;
+    BOOLEAN HugePages;
     CXPLAT_LOCK Lock;
 } CXPLAT_REGISTERED_BUFFER_POOL;
 
@@ -970,6 +1122,16 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
     CXPLAT_REGISTERED_BUFFER_POOL SendRegisteredBufferPool;
 #endif
 
+#ifdef CXPLAT_USE_IO_URING
+    //
+    // Stack of unused slots in the registered file table of the partition's
+    // ring. NULL if the ring has no registered file table.
+    //
+    uint32_t* FixedFileFreeSlots;
+    uint32_t FixedFileFreeCount;
+    CXPLAT_LOCK FixedFileLock;
+#endif
+
     //
     // TODO: big hack for batching experiment.
     //
@@ -1025,6 +1187,13 @@ typedef struct CXPLAT_DATAPATH {
     //
     uint32_t RecvBlockSize;
 
+    //
+    // The kernel busy-poll duration applied to new sockets and the partition
+    // event queues. Derived from the execution config's polling idle timeout;
+    // zero disables busy polling.
+    //
+    uint32_t BusyPollUs;
+
 #if DEBUG
     uint8_t Uninitialized : 1;
     uint8_t Freed : 1;
@@ -1032,6 +1201,11 @@ typedef struct CXPLAT_DATAPATH {
 
     uint8_t ReserveAuxTcpSock : 1;
 
+    //
+    // Whether the per partition buffer pools are backed by huge pages.
+    //
+    uint8_t HugePages : 1;
+
     //
     // The per proc datapath contexts.
     //
@@ -1163,6 +1337,15 @@ SocketSend(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SocketSendBatch(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    );
+
 CXPLAT_SOCKET*
 CxPlatRawToSocket(
     _In_ CXPLAT_SOCKET_RAW* Socket
@@ -1196,6 +1379,7 @@ RawDataPathInitialize(
     _In_ uint32_t ClientRecvContextLength,
     _In_opt_ const CXPLAT_DATAPATH* ParentDataPath,
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig,
     _Outptr_result_maybenull_ CXPLAT_DATAPATH_RAW** DataPath
     );
 
@@ -1287,6 +1471,15 @@ RawSocketSend(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+RawSocketSendBatch(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(Count) const CXPLAT_ROUTE* Routes,
+    _In_reads_(Count) CXPLAT_SEND_DATA** SendData,
+    _In_ uint32_t Count
+    );
+
 void
 RawResolveRouteComplete(
     _In_ void* Context,
@@ -1312,4 +1505,94 @@ RawUpdateRoute(
     _In_ CXPLAT_ROUTE* SrcRoute
     );
 
+//
+// In-process loopback datapath (datapath_loopback.c)
+//
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+LoopbackDataPathInitialize(
+    _In_ uint32_t ClientRecvContextLength,
+    _In_ CXPLAT_DATAPATH* ParentDataPath,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_LOOPBACK_CONFIG* Config,
+    _Out_ CXPLAT_DATAPATH_LOOPBACK** NewDataPath
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+LoopbackDataPathUninitialize(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_DATAPATH_FEATURES
+LoopbackDataPathGetSupportedFeatures(
+    _In_ CXPLAT_DATAPATH_FEATURES SocketFeatures
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+LoopbackSocketCreateUdp(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _In_ const CXPLAT_UDP_CONFIG* Config,
+    _In_ CXPLAT_SOCKET* Socket
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+LoopbackSocketDelete(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _In_ CXPLAT_SOCKET* Socket
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackRecvDataReturn(
+    _In_opt_ CXPLAT_RECV_DATA* RecvDataChain
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+CXPLAT_SEND_DATA*
+LoopbackSendDataAlloc(
+    _In_ CXPLAT_DATAPATH_LOOPBACK* Loopback,
+    _Inout_ CXPLAT_SEND_CONFIG* Config
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackSendDataFree(
+    _In_ CXPLAT_SEND_DATA* SendData
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_BUFFER*
+LoopbackSendDataAllocBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ uint16_t MaxBufferLength
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackSendDataFreeBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ QUIC_BUFFER* Buffer
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LoopbackSendDataIsFull(
+    _In_ CXPLAT_SEND_DATA* SendData
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LoopbackSocketSend(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    );
+
 #endif // CX_PLATFORM_LINUX || _WIN32
@@ -25,6 +25,7 @@ Environment:
 #include <fcntl.h>
 #include <limits.h>
 #include <sched.h>
+#include <sys/mman.h>
 #include <syslog.h>
 #define QUIC_VERSION_ONLY 1
 #include "msquic.ver"
@@ -34,6 +35,7 @@ Environment:
 
 #ifdef CXPLAT_NUMA_AWARE
 #include <numa.h>               // If missing: `apt-get install -y libnuma-dev`
+#include <numaif.h>
 uint32_t CxPlatNumaNodeCount;
 cpu_set_t* CxPlatNumaNodeMasks;
 #endif // CXPLAT_NUMA_AWARE
@@ -52,6 +54,14 @@ QUIC_TRACE_RUNDOWN_CALLBACK* QuicTraceRundownCallback;
 static const char TpLibName[] = "libmsquic.lttng.so." LIBRARY_VERSION;
 
 uint32_t CxPlatProcessorCount;
+uint16_t* CxPlatProcessorDefaultList;
+uint32_t CxPlatProcessorDefaultCount;
+
+static
+void
+CxPlatPoolMagazinesUnload(
+    void
+    );
 
 uint64_t CxPlatTotalMemory;
 
@@ -107,6 +117,7 @@ CxPlatSystemLoad(
 #else
     CxPlatProcessorCount = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
 #endif
+    CxPlatProcessorDefaultCount = CxPlatProcessorCount;
 
 #ifdef CXPLAT_NUMA_AWARE
     if (numa_available() >= 0) {
@@ -213,12 +224,75 @@ CxPlatSystemUnload(
 #ifdef CXPLAT_NUMA_AWARE
     CXPLAT_FREE(CxPlatNumaNodeMasks, QUIC_POOL_PLATFORM_PROC);
 #endif
+    CxPlatPoolMagazinesUnload();
     QuicTraceLogInfo(
         PosixUnloaded,
         "[ dso] Unloaded");
 }
 
 uint64_t CGroupGetMemoryLimit();
+uint32_t CGroupGetCpuLimit();
+#if defined(CX_PLATFORM_LINUX)
+BOOLEAN CGroupGetCpuSet(cpu_set_t* CpuSet);
+#endif
+
+//
+// Narrows the processors the worker pool and partitions default to down to the
+// ones in the process' cgroup cpuset, and then to as many as its cgroup CPU
+// quota can keep busy. Otherwise a container with a small quota on a large host
+// gets a worker per host processor, all contending for (and being throttled
+// by) the same quota.
+//
+static
+void
+CxPlatProcessorDefaultInitialize(
+    void
+    )
+{
+    CxPlatProcessorDefaultList = NULL;
+    CxPlatProcessorDefaultCount = CxPlatProcessorCount;
+
+#if defined(CX_PLATFORM_LINUX)
+    cpu_set_t CpuSet;
+    const BOOLEAN HasCpuSet = CGroupGetCpuSet(&CpuSet);
+
+    uint32_t AllowedCount = 0;
+    for (uint32_t i = 0; i < CxPlatProcessorCount; ++i) {
+        if (!HasCpuSet || (i < CPU_SETSIZE && CPU_ISSET(i, &CpuSet))) {
+            AllowedCount++;
+        }
+    }
+
+    uint32_t Count = AllowedCount;
+    const uint32_t CpuLimit = CGroupGetCpuLimit();
+    if (CpuLimit != 0 && CpuLimit < Count) {
+        Count = CpuLimit;
+    }
+
+    if (Count == 0 || Count >= CxPlatProcessorCount) {
+        return; // Not restricted.
+    }
+
+    CxPlatProcessorDefaultList =
+        CXPLAT_ALLOC_NONPAGED(Count * sizeof(uint16_t), QUIC_POOL_PLATFORM_PROC);
+    if (CxPlatProcessorDefaultList == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CxPlatProcessorDefaultList",
+            Count * sizeof(uint16_t));
+        return; // Fall back to using all processors.
+    }
+
+    uint32_t Index = 0;
+    for (uint32_t i = 0; i < CxPlatProcessorCount && Index < Count; ++i) {
+        if (!HasCpuSet || (i < CPU_SETSIZE && CPU_ISSET(i, &CpuSet))) {
+            CxPlatProcessorDefaultList[Index++] = (uint16_t)i;
+        }
+    }
+    CxPlatProcessorDefaultCount = Count;
+#endif
+}
 
 QUIC_STATUS
 CxPlatInitialize(
@@ -246,6 +320,7 @@ CxPlatInitialize(
     }
 
     CxPlatTotalMemory = CGroupGetMemoryLimit();
+    CxPlatProcessorDefaultInitialize();
 
     QuicTraceLogInfo(
         PosixInitialized,
@@ -260,6 +335,10 @@ CxPlatUninitialize(
     void
     )
 {
+    if (CxPlatProcessorDefaultList != NULL) {
+        CXPLAT_FREE(CxPlatProcessorDefaultList, QUIC_POOL_PLATFORM_PROC);
+        CxPlatProcessorDefaultList = NULL;
+    }
     CxPlatCryptUninitialize();
     close(RandomFd);
     QuicTraceLogInfo(
@@ -295,6 +374,583 @@ CxPlatFree(
     free(Mem);
 }
 
+void*
+CxPlatHugePageAlloc(
+    _In_ size_t Length
+    )
+{
+    Length = CXPLAT_HUGE_PAGE_ROUND_UP(Length);
+
+#ifdef MAP_HUGETLB
+    //
+    // Explicitly reserved huge pages are preferred, as they are guaranteed.
+    // Such mappings are always aligned to the huge page size.
+    //
+    void* Memory =
+        mmap(
+            NULL,
+            Length,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0);
+    if (Memory != MAP_FAILED) {
+        return Memory;
+    }
+#endif
+
+    //
+    // Otherwise, fall back to transparent huge pages. They need the memory to
+    // be aligned to their size, which mmap doesn't guarantee, so map an extra
+    // huge page and trim the excess.
+    //
+    uint8_t* Region =
+        mmap(
+            NULL,
+            Length + CXPLAT_HUGE_PAGE_SIZE,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+    if (Region == MAP_FAILED) {
+        return NULL;
+    }
+    uint8_t* Aligned =
+        (uint8_t*)(((uintptr_t)Region + CXPLAT_HUGE_PAGE_SIZE - 1) &
+            ~(uintptr_t)(CXPLAT_HUGE_PAGE_SIZE - 1));
+    if (Aligned != Region) {
+        munmap(Region, (size_t)(Aligned - Region));
+    }
+    munmap(
+        Aligned + Length,
+        (size_t)(Region + CXPLAT_HUGE_PAGE_SIZE - Aligned));
+#ifdef MADV_HUGEPAGE
+    (void)madvise(Aligned, Length, MADV_HUGEPAGE);
+#endif
+    return Aligned;
+}
+
+void
+CxPlatHugePageFree(
+    _In_ void* Memory,
+    _In_ size_t Length
+    )
+{
+    munmap(Memory, CXPLAT_HUGE_PAGE_ROUND_UP(Length));
+}
+
+//
+// Pool entries are carved from slabs: page aligned mappings of the pool's
+// slab size, starting with the slab's header. Entries are carved lazily, so
+// that pages of a slab are only touched once the pool actually needs them,
+// and freed entries go back to their own slab. A slab none of whose entries
+// are in use can be returned to the system as a whole.
+//
+// Slabs of CXPLAT_HUGE_PAGE_SIZE are backed by huge pages (see
+// CxPlatPoolInitializeHugePages), which saves TLB misses for heavily used
+// pools at the cost of committing the whole slab at once.
+//
+#define CXPLAT_POOL_SLAB_MIN_ENTRIES    16 // Larger entries are allocated individually
+#define CXPLAT_POOL_SLAB_HEADER_SIZE    64 // Keeps entries cache line aligned
+#define CXPLAT_POOL_SLAB_STRIDE(Size) \
+    (((Size) + CXPLAT_MEMORY_ALIGNMENT - 1) & ~(uint32_t)(CXPLAT_MEMORY_ALIGNMENT - 1))
+
+typedef struct CXPLAT_POOL_SLAB {
+
+    //
+    // Link in the pool's list of slabs.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // Entries returned to the slab.
+    //
+    CXPLAT_SLIST_ENTRY FreeList;
+    uint32_t FreeCount;
+
+    //
+    // Number of entries carved so far.
+    //
+    uint32_t CarvedCount;
+
+    //
+    // One reference for the pool, until it lets go of the slab, and one for
+    // each carved entry not on the free list. Entries in use, or in magazines,
+    // may outlive the pool and release their reference when they are freed.
+    //
+    long volatile RefCount;
+
+    //
+    // The size of the slab's mapping, copied from the pool for when the slab
+    // outlives it.
+    //
+    uint32_t Size;
+
+} CXPLAT_POOL_SLAB;
+
+CXPLAT_STATIC_ASSERT(
+    sizeof(CXPLAT_POOL_SLAB) <= CXPLAT_POOL_SLAB_HEADER_SIZE,
+    "Slab header must fit before the first entry");
+
+#define CXPLAT_POOL_SLAB_AVAILABLE(Pool, Slab) \
+    ((Slab)->FreeCount + (Pool)->SlabEntryCount - (Slab)->CarvedCount)
+
+uint32_t
+CxPlatPoolSlabEntryCount(
+    _In_ uint32_t Size,
+    _In_ uint32_t SlabSize
+    )
+{
+#if CXPLAT_POOL_MAXIMUM_DEPTH == 0
+    UNREFERENCED_PARAMETER(Size);
+    UNREFERENCED_PARAMETER(SlabSize);
+    return 0;
+#else
+    const uint32_t Count =
+        (SlabSize - CXPLAT_POOL_SLAB_HEADER_SIZE) / CXPLAT_POOL_SLAB_STRIDE(Size);
+    return Count >= CXPLAT_POOL_SLAB_MIN_ENTRIES ? Count : 0;
+#endif
+}
+
+static
+CXPLAT_POOL_SLAB*
+CxPlatPoolSlabCreate(
+    _In_ uint32_t SlabSize
+    )
+{
+    void* Memory;
+    if (SlabSize == CXPLAT_HUGE_PAGE_SIZE) {
+        Memory = CxPlatHugePageAlloc(SlabSize);
+        if (Memory == NULL) {
+            return NULL;
+        }
+    } else {
+        Memory =
+            mmap(
+                NULL,
+                SlabSize,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0);
+        if (Memory == MAP_FAILED) {
+            return NULL;
+        }
+    }
+
+    CXPLAT_POOL_SLAB* Slab = (CXPLAT_POOL_SLAB*)Memory;
+    Slab->FreeList.Next = NULL;
+    Slab->FreeCount = 0;
+    Slab->CarvedCount = 0;
+    Slab->RefCount = 1;
+    Slab->Size = SlabSize;
+    return Slab;
+}
+
+static
+void
+CxPlatPoolSlabRelease(
+    _In_ CXPLAT_POOL_SLAB* Slab
+    )
+{
+    if (InterlockedDecrement(&Slab->RefCount) == 0) {
+        munmap(Slab, Slab->Size);
+    }
+}
+
+//
+// Takes a free entry from the first slab. Called with the pool's lock held.
+//
+static
+CXPLAT_POOL_HEADER*
+CxPlatPoolSlabAlloc(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    if (CxPlatListIsEmpty(&Pool->Slabs)) {
+        return NULL;
+    }
+
+    CXPLAT_POOL_SLAB* Slab =
+        CXPLAT_CONTAINING_RECORD(Pool->Slabs.Flink, CXPLAT_POOL_SLAB, Link);
+    CXPLAT_POOL_HEADER* Header;
+    if (Slab->FreeCount > 0) {
+        Header = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Slab->FreeList);
+        Slab->FreeCount--;
+    } else if (Slab->CarvedCount < Pool->SlabEntryCount) {
+        Header =
+            (CXPLAT_POOL_HEADER*)((uint8_t*)Slab + CXPLAT_POOL_SLAB_HEADER_SIZE +
+                (size_t)Slab->CarvedCount * CXPLAT_POOL_SLAB_STRIDE(Pool->Size));
+        Slab->CarvedCount++;
+        Header->Slab = Slab;
+#if DEBUG
+        Header->SpecialFlag = CXPLAT_POOL_FREE_FLAG;
+#endif
+    } else {
+        return NULL; // Full slabs are last, so none has a free entry.
+    }
+
+    CXPLAT_DBG_ASSERT(Pool->SlabFreeCount > 0);
+    Pool->SlabFreeCount--;
+    InterlockedIncrement(&Slab->RefCount);
+    if (CXPLAT_POOL_SLAB_AVAILABLE(Pool, Slab) == 0) {
+        CxPlatListEntryRemove(&Slab->Link);
+        CxPlatListInsertTail(&Pool->Slabs, &Slab->Link);
+    }
+    return Header;
+}
+
+//
+// Returns an entry to its slab. Called with the pool's lock held. If the slab
+// is no longer in use, and the pool has enough free entries without it, it is
+// removed from the pool and returned, to be released outside the lock.
+//
+static
+CXPLAT_POOL_SLAB*
+CxPlatPoolSlabFree(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_HEADER* Header
+    )
+{
+    CXPLAT_POOL_SLAB* Slab = Header->Slab;
+    if (CXPLAT_POOL_SLAB_AVAILABLE(Pool, Slab) == 0) {
+        CxPlatListEntryRemove(&Slab->Link);
+        CxPlatListInsertHead(&Pool->Slabs, &Slab->Link);
+    }
+    CxPlatListPushEntry(&Slab->FreeList, &Header->Entry);
+    Slab->FreeCount++;
+    Pool->SlabFreeCount++;
+
+    //
+    // Entries are only taken from the slab under the lock, so once only the
+    // pool's reference is left, nothing else can change it.
+    //
+    if (InterlockedDecrement(&Slab->RefCount) == 1 &&
+        Pool->SlabFreeCount - CXPLAT_POOL_SLAB_AVAILABLE(Pool, Slab) >= Pool->SlabEntryCount) {
+        CxPlatListEntryRemove(&Slab->Link);
+        Pool->SlabFreeCount -= CXPLAT_POOL_SLAB_AVAILABLE(Pool, Slab);
+        return Slab;
+    }
+    return NULL;
+}
+
+void
+CxPlatPoolFreeSlabs(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    while (!CxPlatListIsEmpty(&Pool->Slabs)) {
+        CXPLAT_POOL_SLAB* Slab =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Pool->Slabs), CXPLAT_POOL_SLAB, Link);
+        CxPlatPoolSlabRelease(Slab);
+    }
+    Pool->SlabFreeCount = 0;
+}
+
+BOOLEAN
+CxPlatPoolPruneSlab(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CXPLAT_POOL_SLAB* Slab = NULL;
+    CxPlatLockAcquire(&Pool->Lock);
+    for (CXPLAT_LIST_ENTRY* Link = Pool->Slabs.Flink;
+         Link != &Pool->Slabs;
+         Link = Link->Flink) {
+        CXPLAT_POOL_SLAB* Candidate = CXPLAT_CONTAINING_RECORD(Link, CXPLAT_POOL_SLAB, Link);
+        if (Candidate->RefCount == 1) {
+            CxPlatListEntryRemove(&Candidate->Link);
+            Pool->SlabFreeCount -= CXPLAT_POOL_SLAB_AVAILABLE(Pool, Candidate);
+            Slab = Candidate;
+            break;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+
+    if (Slab == NULL) {
+        return FALSE;
+    }
+    CxPlatPoolSlabRelease(Slab);
+    return TRUE;
+}
+
+QUIC_STATUS
+CxPlatPoolReserve(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ uint32_t Count,
+    _In_ uint16_t NumaNode
+    )
+{
+#if CXPLAT_POOL_MAXIMUM_DEPTH == 0
+    UNREFERENCED_PARAMETER(Pool);
+    UNREFERENCED_PARAMETER(Count);
+    UNREFERENCED_PARAMETER(NumaNode);
+    return QUIC_STATUS_SUCCESS;
+#else
+    if (Pool->SlabEntryCount == 0) {
+        //
+        // Entries too large for slabs are kept on the list, as many as it
+        // holds.
+        //
+        Count = CXPLAT_MIN(Count, CXPLAT_POOL_MAXIMUM_DEPTH);
+        UNREFERENCED_PARAMETER(NumaNode);
+        while (Pool->ListDepth < Count) {
+            CXPLAT_POOL_HEADER* Header =
+                (CXPLAT_POOL_HEADER*)CxPlatAlloc(Pool->Size, Pool->Tag);
+            if (Header == NULL) {
+                return QUIC_STATUS_OUT_OF_MEMORY;
+            }
+            CxPlatZeroMemory(Header, Pool->Size); // Fault in its pages.
+            Header->Slab = NULL;
+#if DEBUG
+            Header->SpecialFlag = CXPLAT_POOL_FREE_FLAG;
+#endif
+            CxPlatLockAcquire(&Pool->Lock);
+            CxPlatListPushEntry(&Pool->ListHead, &Header->Entry);
+            Pool->ListDepth++;
+            CxPlatLockRelease(&Pool->Lock);
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    while (Pool->SlabFreeCount < Count) {
+        CXPLAT_POOL_SLAB* Slab = CxPlatPoolSlabCreate(Pool->SlabSize);
+        if (Slab == NULL) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+
+        uint8_t* Entries = (uint8_t*)Slab + CXPLAT_POOL_SLAB_HEADER_SIZE;
+        const size_t EntriesLength = Pool->SlabSize - CXPLAT_POOL_SLAB_HEADER_SIZE;
+#ifdef CXPLAT_NUMA_AWARE
+        //
+        // Prefer the node for the slab's pages not faulted in yet. The header
+        // page already is, on the calling thread's node.
+        //
+        if (CxPlatNumaNodeCount > 1 && NumaNode < sizeof(unsigned long) * 8) {
+            const uintptr_t PageSize = (uintptr_t)getpagesize();
+            uint8_t* Start =
+                (uint8_t*)(((uintptr_t)Entries + PageSize - 1) & ~(PageSize - 1));
+            unsigned long NodeMask = 1ul << NumaNode;
+            if (Start < Entries + EntriesLength &&
+                mbind(
+                    Start,
+                    (size_t)(Entries + EntriesLength - Start),
+                    MPOL_PREFERRED,
+                    &NodeMask,
+                    sizeof(NodeMask) * 8,
+                    0) != 0) {
+                QuicTraceEvent(
+                    LibraryErrorStatus,
+                    "[ lib] ERROR, %u, %s.",
+                    errno,
+                    "mbind failed");
+            }
+        }
+#else
+        UNREFERENCED_PARAMETER(NumaNode);
+#endif
+        CxPlatZeroMemory(Entries, EntriesLength); // Fault in its pages.
+
+        CxPlatLockAcquire(&Pool->Lock);
+        CxPlatListInsertHead(&Pool->Slabs, &Slab->Link);
+        Pool->SlabFreeCount += Pool->SlabEntryCount;
+        CxPlatLockRelease(&Pool->Lock);
+    }
+    return QUIC_STATUS_SUCCESS;
+#endif
+}
+
+__thread CXPLAT_POOL_MAGAZINE CxPlatPoolMagazines[CXPLAT_POOL_MAGAZINE_COUNT];
+static __thread BOOLEAN CxPlatPoolMagazinesRegistered;
+static uint64_t CxPlatPoolGeneration;
+static pthread_key_t CxPlatPoolMagazinesKey;
+static pthread_once_t CxPlatPoolMagazinesKeyOnce = PTHREAD_ONCE_INIT;
+static BOOLEAN CxPlatPoolMagazinesKeyCreated;
+
+uint64_t
+CxPlatPoolNextGeneration(
+    void
+    )
+{
+    return (uint64_t)InterlockedIncrement64((int64_t*)&CxPlatPoolGeneration);
+}
+
+void
+CxPlatPoolEmptyMagazine(
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    //
+    // Entries of a slab only drop their reference on it; the slab is freed
+    // with the last of them, or by its pool once no longer used.
+    //
+    while (Magazine->Count > 0) {
+        CXPLAT_POOL_HEADER* Header = Magazine->Entries[--Magazine->Count];
+        if (Header->Slab != NULL) {
+            CxPlatPoolSlabRelease(Header->Slab);
+        } else {
+            CxPlatFree(Header, 0);
+        }
+    }
+    Magazine->Pool = NULL;
+    Magazine->Generation = 0;
+}
+
+//
+// Frees the entries in the exiting thread's magazines.
+//
+static
+void
+CxPlatPoolMagazinesCleanup(
+    _In_ void* Context
+    )
+{
+    CXPLAT_POOL_MAGAZINE* Magazines = (CXPLAT_POOL_MAGAZINE*)Context;
+    for (uint32_t i = 0; i < CXPLAT_POOL_MAGAZINE_COUNT; ++i) {
+        CxPlatPoolEmptyMagazine(&Magazines[i]);
+    }
+}
+
+static
+void
+CxPlatPoolMagazinesKeyCreate(
+    void
+    )
+{
+    CXPLAT_FRE_ASSERT(
+        pthread_key_create(&CxPlatPoolMagazinesKey, CxPlatPoolMagazinesCleanup) == 0);
+    CxPlatPoolMagazinesKeyCreated = TRUE;
+}
+
+//
+// Threads may outlive the library, so they must not call back into it when
+// they exit. Their magazines' entries are leaked instead.
+//
+static
+void
+CxPlatPoolMagazinesUnload(
+    void
+    )
+{
+    if (CxPlatPoolMagazinesKeyCreated) {
+        pthread_key_delete(CxPlatPoolMagazinesKey);
+        CxPlatPoolMagazinesKeyCreated = FALSE;
+    }
+}
+
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolClaimMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    if (!CxPlatPoolMagazinesRegistered) {
+        pthread_once(&CxPlatPoolMagazinesKeyOnce, CxPlatPoolMagazinesKeyCreate);
+        CXPLAT_FRE_ASSERT(
+            pthread_setspecific(CxPlatPoolMagazinesKey, CxPlatPoolMagazines) == 0);
+        CxPlatPoolMagazinesRegistered = TRUE;
+    }
+
+    //
+    // The magazine's previous pool may already be gone, so its entries can't
+    // be returned to it.
+    //
+    CxPlatPoolEmptyMagazine(Magazine);
+    Magazine->Pool = Pool;
+    Magazine->Generation = Pool->Generation;
+    return Magazine;
+}
+
+void
+CxPlatPoolRefillMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    CXPLAT_DBG_ASSERT(Magazine->Count == 0);
+    if (Pool->ListDepth == 0 && Pool->SlabEntryCount == 0) {
+        return; // Racy check, to avoid the lock when there is nothing to take.
+    }
+
+    CxPlatLockAcquire(&Pool->Lock);
+    while (Magazine->Count < CXPLAT_POOL_MAGAZINE_SIZE / 2) {
+        CXPLAT_POOL_HEADER* Header =
+            (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead);
+        if (Header == NULL) {
+            break;
+        }
+        CXPLAT_DBG_ASSERT(Pool->ListDepth > 0);
+        Pool->ListDepth--;
+        Magazine->Entries[Magazine->Count++] = Header;
+    }
+
+    if (Pool->SlabEntryCount != 0) {
+        if (Pool->SlabFreeCount == 0 && Magazine->Count == 0) {
+            //
+            // Map a new slab outside the lock. Another thread may add one in
+            // the meantime, and the pool then simply has one more.
+            //
+            CxPlatLockRelease(&Pool->Lock);
+            CXPLAT_POOL_SLAB* Slab = CxPlatPoolSlabCreate(Pool->SlabSize);
+            CxPlatLockAcquire(&Pool->Lock);
+            if (Slab != NULL) {
+                CxPlatListInsertHead(&Pool->Slabs, &Slab->Link);
+                Pool->SlabFreeCount += Pool->SlabEntryCount;
+            }
+        }
+        while (Magazine->Count < CXPLAT_POOL_MAGAZINE_SIZE / 2) {
+            CXPLAT_POOL_HEADER* Header = CxPlatPoolSlabAlloc(Pool);
+            if (Header == NULL) {
+                break;
+            }
+            Magazine->Entries[Magazine->Count++] = Header;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+}
+
+void
+CxPlatPoolFlushMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    CXPLAT_DBG_ASSERT(Magazine->Count == CXPLAT_POOL_MAGAZINE_SIZE);
+
+    //
+    // Whatever can't be kept by the pool is freed after releasing the lock.
+    //
+    void* ToFree[CXPLAT_POOL_MAGAZINE_SIZE / 2];
+    uint32_t FreeCount = 0;
+    CXPLAT_POOL_SLAB* ToRelease[CXPLAT_POOL_MAGAZINE_SIZE / 2];
+    uint32_t ReleaseCount = 0;
+
+    CxPlatLockAcquire(&Pool->Lock);
+    while (Magazine->Count > CXPLAT_POOL_MAGAZINE_SIZE / 2) {
+        CXPLAT_POOL_HEADER* Header = Magazine->Entries[--Magazine->Count];
+        if (Header->Slab != NULL) {
+            CXPLAT_POOL_SLAB* Slab = CxPlatPoolSlabFree(Pool, Header);
+            if (Slab != NULL) {
+                ToRelease[ReleaseCount++] = Slab;
+            }
+        } else if (Pool->ListDepth < CXPLAT_POOL_MAXIMUM_DEPTH) {
+            CxPlatListPushEntry(&Pool->ListHead, &Header->Entry);
+            Pool->ListDepth++;
+        } else {
+            ToFree[FreeCount++] = Header;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+
+    while (FreeCount > 0) {
+        CxPlatFree(ToFree[--FreeCount], Pool->Tag);
+    }
+    while (ReleaseCount > 0) {
+        CxPlatPoolSlabRelease(ToRelease[--ReleaseCount]);
+    }
+}
+
 void
 CxPlatRefInitialize(
     _Inout_ CXPLAT_REF_COUNT* RefCount
@@ -545,6 +1201,23 @@ CxPlatProcCurrentNumber(
 #endif // CX_PLATFORM_DARWIN
 }
 
+uint16_t
+CxPlatProcNumaNode(
+    _In_ uint32_t Index
+    )
+{
+#ifdef CXPLAT_NUMA_AWARE
+    for (uint32_t n = 0; n < CxPlatNumaNodeCount; ++n) {
+        if (CPU_ISSET(Index, &CxPlatNumaNodeMasks[n])) {
+            return (uint16_t)n;
+        }
+    }
+#else
+    UNREFERENCED_PARAMETER(Index);
+#endif // CXPLAT_NUMA_AWARE
+    return 0;
+}
+
 QUIC_STATUS
 CxPlatRandom(
     _In_ uint32_t BufferLen,
@@ -557,6 +1230,43 @@ CxPlatRandom(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatFileRead(
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _Out_writes_bytes_to_(Length, *BytesRead) uint8_t* Buffer,
+    _Out_ uint32_t* BytesRead
+    )
+{
+    *BytesRead = 0;
+    while (*BytesRead < Length) {
+        ssize_t Result =
+            pread(
+                File,
+                Buffer + *BytesRead,
+                Length - *BytesRead,
+                (off_t)(Offset + *BytesRead));
+        if (Result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                errno,
+                "pread failed");
+            return (QUIC_STATUS)errno;
+        }
+        if (Result == 0) {
+            break; // End of file.
+        }
+        *BytesRead += (uint32_t)Result;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
 void
 CxPlatConvertToMappedV6(
     _In_ const QUIC_ADDR* InAddr,
@@ -437,6 +437,56 @@ CxPlatRandom(
 
 #endif
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatFileRead(
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _Out_writes_bytes_to_(Length, *BytesRead) uint8_t* Buffer,
+    _Out_ uint32_t* BytesRead
+    )
+{
+    *BytesRead = 0;
+    while (*BytesRead < Length) {
+        //
+        // The offset is passed in the OVERLAPPED so the file position isn't
+        // used. A handle opened for overlapped I/O may complete asynchronously,
+        // in which case the read is waited on.
+        //
+        const uint64_t ReadOffset = Offset + *BytesRead;
+        OVERLAPPED Overlapped = {0};
+        Overlapped.Offset = (DWORD)ReadOffset;
+        Overlapped.OffsetHigh = (DWORD)(ReadOffset >> 32);
+        DWORD Result = 0;
+        if (!ReadFile(File, Buffer + *BytesRead, Length - *BytesRead, &Result, &Overlapped)) {
+            DWORD Error = GetLastError();
+            if (Error == ERROR_IO_PENDING &&
+                GetOverlappedResult(File, &Overlapped, &Result, TRUE)) {
+                Error = NO_ERROR;
+            } else if (Error == ERROR_IO_PENDING) {
+                Error = GetLastError();
+            }
+            if (Error == ERROR_HANDLE_EOF) {
+                break;
+            }
+            if (Error != NO_ERROR) {
+                QuicTraceEvent(
+                    LibraryErrorStatus,
+                    "[ lib] ERROR, %u, %s.",
+                    Error,
+                    "ReadFile failed");
+                return HRESULT_FROM_WIN32(Error);
+            }
+        }
+        if (Result == 0) {
+            break; // End of file.
+        }
+        *BytesRead += Result;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
 #ifdef DEBUG
 #define AllocOffset (sizeof(void*) * 2)
 #endif
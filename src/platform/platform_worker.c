@@ -53,6 +53,12 @@ typedef struct QUIC_CACHEALIGN CXPLAT_WORKER {
     //
     CXPLAT_EXECUTION_STATE State;
 
+    //
+    // The earliest time (in us) an execution context needs to run again, as of
+    // the last run. 0 if one is ready now, or UINT64_MAX if none is scheduled.
+    //
+    uint64_t NextTimeUs;
+
     //
     // List of dynamic pools to manage.
     //
@@ -271,7 +277,7 @@ CxPlatWorkerPoolCreate(
 {
     //
     // Build up the processor list either from the config or default to one per
-    // system processor.
+    // processor the process is allowed to use.
     //
     const uint16_t* ProcessorList;
     uint32_t ProcessorCount;
@@ -279,8 +285,8 @@ CxPlatWorkerPoolCreate(
         ProcessorCount = Config->ProcessorCount;
         ProcessorList = Config->ProcessorList;
     } else {
-        ProcessorCount = CxPlatProcCount();
-        ProcessorList = NULL;
+        ProcessorCount = CxPlatProcDefaultCount();
+        ProcessorList = CxPlatProcDefaultList();
     }
     CXPLAT_DBG_ASSERT(ProcessorCount > 0 && ProcessorCount <= UINT16_MAX);
 
@@ -592,20 +598,22 @@ CxPlatUpdateExecutionContexts(
     }
 }
 
-void
+uint32_t
 CxPlatRunExecutionContexts(
     _In_ CXPLAT_WORKER* Worker
     )
 {
     if (Worker->ExecutionContexts == NULL) {
         Worker->State.WaitTime = UINT32_MAX;
-        return;
+        Worker->NextTimeUs = UINT64_MAX;
+        return 0;
     }
 
 #if DEBUG // Debug statistics
     ++Worker->EcPollCount;
 #endif
 
+    uint32_t RunCount = 0;
     uint64_t NextTime = UINT64_MAX;
     CXPLAT_SLIST_ENTRY** EC = &Worker->ExecutionContexts;
     do {
@@ -616,6 +624,7 @@ CxPlatRunExecutionContexts(
 #if DEBUG // Debug statistics
             ++Worker->EcRunCount;
 #endif
+            ++RunCount;
             CXPLAT_SLIST_ENTRY* Next = Context->Entry.Next;
             if (!Context->Callback(Context->Context, &Worker->State)) {
                 *EC = Next; // Remove Context from the list.
@@ -631,6 +640,7 @@ CxPlatRunExecutionContexts(
         EC = &Context->Entry.Next;
     } while (*EC != NULL);
 
+    Worker->NextTimeUs = NextTime;
     if (NextTime == 0) {
         Worker->State.WaitTime = 0;
     } else if (NextTime != UINT64_MAX) {
@@ -646,6 +656,8 @@ CxPlatRunExecutionContexts(
     } else {
         Worker->State.WaitTime = UINT32_MAX;
     }
+
+    return RunCount;
 }
 
 uint32_t
@@ -666,6 +678,55 @@ CxPlatWorkerPoolWorkerPoll(
     return Worker->State.WaitTime;
 }
 
+uint32_t
+CxPlatWorkerPoolWorkerPollBatch(
+    _In_ uint32_t Count,
+    _In_reads_(Count) QUIC_EXECUTION** Executions,
+    _In_ uint32_t TimeBudgetUs,
+    _In_ uint32_t RunBudget
+    )
+{
+    const uint64_t StartTime = CxPlatTimeUs64();
+    uint64_t TimeNow = StartTime;
+    uint64_t NextTime;
+    uint32_t RunCount = 0;
+
+    do {
+        //
+        // Give each execution context a turn, so none of them starve the
+        // others of the budget.
+        //
+        NextTime = UINT64_MAX;
+        for (uint32_t i = 0; i < Count; ++i) {
+            CXPLAT_WORKER* Worker = (CXPLAT_WORKER*)Executions[i];
+            Worker->State.TimeNow = TimeNow;
+            Worker->State.ThreadID = CxPlatCurThreadID();
+
+            RunCount += CxPlatRunExecutionContexts(Worker);
+            if (Worker->State.WaitTime && InterlockedFetchAndClearBoolean(&Worker->Running)) {
+                Worker->State.TimeNow = CxPlatTimeUs64();
+                RunCount += CxPlatRunExecutionContexts(Worker); // Run once more to handle race conditions
+            }
+
+            if (Worker->NextTimeUs < NextTime) {
+                NextTime = Worker->NextTimeUs;
+            }
+        }
+        TimeNow = CxPlatTimeUs64();
+
+    } while (NextTime <= TimeNow &&
+             (TimeBudgetUs == 0 || TimeNow - StartTime < TimeBudgetUs) &&
+             (RunBudget == 0 || RunCount < RunBudget));
+
+    if (NextTime <= TimeNow) {
+        return 0;
+    }
+    if (NextTime == UINT64_MAX) {
+        return UINT32_MAX;
+    }
+    return (uint32_t)CXPLAT_MIN(NextTime - TimeNow, UINT32_MAX - 1);
+}
+
 #define DYNAMIC_POOL_PROCESSING_PERIOD  1000000 // 1 second
 #define DYNAMIC_POOL_PRUNE_COUNT        8
 
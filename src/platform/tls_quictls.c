@@ -30,10 +30,24 @@ Abstract:
 #ifdef _WIN32
 #pragma warning(pop)
 #endif
+#ifndef _WIN32
+#include <poll.h>
+#endif
 #ifdef QUIC_CLOG
 #include "tls_quictls.c.clog.h"
 #endif
 
+//
+// The maximum number of wait fds an async crypto engine may expose for a
+// single paused handshake job.
+//
+#define CXPLAT_TLS_MAX_ASYNC_FDS 4
+
+//
+// Length of the digest identifying shared credential material (SHA-256).
+//
+#define CXPLAT_TLS_CREDENTIAL_HASH_LENGTH 32
+
 #ifdef IS_OPENSSL_3
 __owur uint16_t tls1_nid2group_id(int nid); // Not currently public API
 #endif
@@ -77,6 +91,11 @@ typedef struct CXPLAT_SEC_CONFIG {
     //
     CXPLAT_TLS_CREDENTIAL_FLAGS TlsFlags;
 
+    //
+    // Shared credential cache entry for file and PKCS#12 credentials.
+    //
+    struct CXPLAT_TLS_CREDENTIAL* Credential;
+
 } CXPLAT_SEC_CONFIG;
 
 //
@@ -915,6 +934,593 @@ CXPLAT_STATIC_ASSERT(
     FIELD_OFFSET(QUIC_CERTIFICATE_FILE, CertificateFile) == FIELD_OFFSET(QUIC_CERTIFICATE_FILE_PROTECTED, CertificateFile),
     "Mismatch (certificate file) in certificate file structs");
 
+//
+// @struct CXPLAT_TLS_CREDENTIAL
+// @brief A parsed private key, certificate and chain shared by every security
+// configuration that loads identical credential material.
+//
+// Entries are keyed by a SHA-256 digest of the credential bytes (and password)
+// rather than by file name, so replacing a certificate file in place results
+// in a new entry instead of serving the stale one.
+//
+typedef struct CXPLAT_TLS_CREDENTIAL {
+
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // Number of security configurations referencing this entry. Protected by
+    // CxPlatTlsCredentialCacheLock.
+    //
+    uint32_t RefCount;
+
+    uint8_t Hash[CXPLAT_TLS_CREDENTIAL_HASH_LENGTH];
+
+    EVP_PKEY* PrivateKey;
+    X509* Certificate;
+    STACK_OF(X509)* Chain;
+
+} CXPLAT_TLS_CREDENTIAL;
+
+static CRYPTO_ONCE CxPlatTlsCredentialCacheOnce = CRYPTO_ONCE_STATIC_INIT;
+static CXPLAT_LOCK CxPlatTlsCredentialCacheLock;
+static CXPLAT_LIST_ENTRY CxPlatTlsCredentialCache;
+
+static
+void
+CxPlatTlsCredentialCacheInitialize(
+    void
+    )
+{
+    CxPlatLockInitialize(&CxPlatTlsCredentialCacheLock);
+    CxPlatListInitializeHead(&CxPlatTlsCredentialCache);
+}
+
+static
+void
+CxPlatTlsCredentialFree(
+    _In_ CXPLAT_TLS_CREDENTIAL* Credential
+    )
+{
+    if (Credential->PrivateKey != NULL) {
+        EVP_PKEY_free(Credential->PrivateKey);
+    }
+    if (Credential->Certificate != NULL) {
+        X509_free(Credential->Certificate);
+    }
+    if (Credential->Chain != NULL) {
+        sk_X509_pop_free(Credential->Chain, X509_free);
+    }
+    CXPLAT_FREE(Credential, QUIC_POOL_TLS_CREDENTIAL);
+}
+
+//
+// Hashes a length-prefixed component of the credential material, so that
+// moving bytes between adjacent components cannot produce the same digest.
+//
+static
+BOOLEAN
+CxPlatTlsCredentialHashComponent(
+    _In_ EVP_MD_CTX* HashCtx,
+    _In_reads_bytes_opt_(Length) const void* Buffer,
+    _In_ uint32_t Length
+    )
+{
+    return
+        EVP_DigestUpdate(HashCtx, &Length, sizeof(Length)) == 1 &&
+        (Length == 0 || EVP_DigestUpdate(HashCtx, Buffer, Length) == 1);
+}
+
+//
+// Reads a file into a memory BIO, so the same bytes are both hashed for the
+// cache lookup and parsed on a miss.
+//
+static
+BIO*
+CxPlatTlsReadFile(
+    _In_z_ const char* FileName
+    )
+{
+    char Buffer[4096];
+    int Read;
+    BIO* File = BIO_new_file(FileName, "rb");
+    BIO* Mem = NULL;
+
+    if (File == NULL) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "BIO_new_file failed");
+        goto Exit;
+    }
+
+    Mem = BIO_new(BIO_s_mem());
+    if (Mem == NULL) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "BIO_new failed");
+        goto Exit;
+    }
+
+    while ((Read = BIO_read(File, Buffer, sizeof(Buffer))) > 0) {
+        if (BIO_write(Mem, Buffer, Read) != Read) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "BIO_write failed");
+            BIO_free(Mem);
+            Mem = NULL;
+            goto Exit;
+        }
+    }
+
+Exit:
+
+    if (File != NULL) {
+        BIO_free(File);
+    }
+
+    return Mem;
+}
+
+//
+// Parses a PKCS#12 blob into its private key, leaf certificate and CA chain.
+//
+static
+QUIC_STATUS
+CxPlatTlsParsePkcs12(
+    _In_reads_bytes_(BlobLength) const uint8_t* Blob,
+    _In_ uint32_t BlobLength,
+    _In_opt_z_ const char* Password,
+    _Out_ EVP_PKEY** PrivateKey,
+    _Out_ X509** Certificate,
+    _Out_ STACK_OF(X509)** Chain
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    BIO* Bio = BIO_new(BIO_s_mem());
+    PKCS12 *Pkcs12 = NULL;
+    STACK_OF(X509) *CaCertificates = NULL;
+    int Ret;
+
+    *PrivateKey = NULL;
+    *Certificate = NULL;
+    *Chain = NULL;
+
+    if (!Bio) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "BIO_new failed");
+        Status = QUIC_STATUS_TLS_ERROR;
+        goto Exit;
+    }
+
+    BIO_set_mem_eof_return(Bio, 0);
+
+    Ret = BIO_write(Bio, Blob, BlobLength);
+    if (Ret < 0) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "BIO_write failed");
+        Status = QUIC_STATUS_TLS_ERROR;
+        goto Exit;
+    }
+
+    Pkcs12 = d2i_PKCS12_bio(Bio, NULL);
+    if (!Pkcs12) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "d2i_PKCS12_bio failed");
+        Status = QUIC_STATUS_TLS_ERROR;
+        goto Exit;
+    }
+
+    Ret = PKCS12_parse(Pkcs12, Password, PrivateKey, Certificate, &CaCertificates);
+    if (Ret != 1) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "PKCS12_parse failed");
+        Status = QUIC_STATUS_TLS_ERROR;
+        goto Exit;
+    }
+
+    if (CaCertificates) {
+        //
+        // The CA certificates used to be popped into the extra chain one by
+        // one; keep that (reversed) order for the shared chain.
+        //
+        *Chain = sk_X509_new_null();
+        if (*Chain == NULL) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "sk_X509_new_null failed");
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+        X509* CaCert;
+        while ((CaCert = sk_X509_pop(CaCertificates)) != NULL) {
+            if (!sk_X509_push(*Chain, CaCert)) {
+                X509_free(CaCert);
+                QuicTraceEvent(
+                    LibraryErrorStatus,
+                    "[ lib] ERROR, %u, %s.",
+                    ERR_get_error(),
+                    "sk_X509_push failed");
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+                goto Exit;
+            }
+        }
+    }
+
+Exit:
+
+    if (CaCertificates) {
+        sk_X509_pop_free(CaCertificates, X509_free);
+    }
+    if (Pkcs12) {
+        PKCS12_free(Pkcs12);
+    }
+    if (Bio) {
+        BIO_free(Bio);
+    }
+    if (QUIC_FAILED(Status)) {
+        if (*PrivateKey != NULL) {
+            EVP_PKEY_free(*PrivateKey);
+            *PrivateKey = NULL;
+        }
+        if (*Certificate != NULL) {
+            X509_free(*Certificate);
+            *Certificate = NULL;
+        }
+        if (*Chain != NULL) {
+            sk_X509_pop_free(*Chain, X509_free);
+            *Chain = NULL;
+        }
+    }
+
+    return Status;
+}
+
+//
+// Parses a PEM private key and a PEM certificate chain file (leaf first), the
+// same way SSL_CTX_use_certificate_chain_file does.
+//
+static
+QUIC_STATUS
+CxPlatTlsParsePem(
+    _In_ BIO* KeyBio,
+    _In_ BIO* CertBio,
+    _In_opt_z_ const char* Password,
+    _Inout_ CXPLAT_TLS_CREDENTIAL* Credential
+    )
+{
+    X509* CaCert;
+    unsigned long Error;
+
+    Credential->PrivateKey =
+        PEM_read_bio_PrivateKey(KeyBio, NULL, NULL, (void*)Password);
+    if (Credential->PrivateKey == NULL) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "PEM_read_bio_PrivateKey failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    Credential->Certificate = PEM_read_bio_X509_AUX(CertBio, NULL, NULL, NULL);
+    if (Credential->Certificate == NULL) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "PEM_read_bio_X509_AUX failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    Credential->Chain = sk_X509_new_null();
+    if (Credential->Chain == NULL) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "sk_X509_new_null failed");
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    while ((CaCert = PEM_read_bio_X509(CertBio, NULL, NULL, NULL)) != NULL) {
+        if (!sk_X509_push(Credential->Chain, CaCert)) {
+            X509_free(CaCert);
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "sk_X509_push failed");
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    //
+    // Running out of certificates is the expected way to end the chain.
+    //
+    Error = ERR_peek_last_error();
+    if (ERR_GET_LIB(Error) != ERR_LIB_PEM ||
+        ERR_GET_REASON(Error) != PEM_R_NO_START_LINE) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "PEM_read_bio_X509 failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+    ERR_clear_error();
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Looks up (or parses and inserts) the shared credential for certificate
+// file and PKCS#12 credential configurations.
+//
+static
+QUIC_STATUS
+CxPlatTlsCredentialAcquire(
+    _In_ const QUIC_CREDENTIAL_CONFIG* CredConfig,
+    _Out_ CXPLAT_TLS_CREDENTIAL** Credential
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    const char* Password = NULL;
+    BIO* KeyBio = NULL;
+    BIO* CertBio = NULL;
+    EVP_MD_CTX* HashCtx = NULL;
+    uint8_t Hash[CXPLAT_TLS_CREDENTIAL_HASH_LENGTH];
+    uint32_t CredType = (uint32_t)CredConfig->Type;
+    CXPLAT_TLS_CREDENTIAL* NewCredential = NULL;
+    CXPLAT_LIST_ENTRY* Entry;
+
+    *Credential = NULL;
+
+    CRYPTO_THREAD_run_once(
+        &CxPlatTlsCredentialCacheOnce,
+        CxPlatTlsCredentialCacheInitialize);
+
+    HashCtx = EVP_MD_CTX_new();
+    if (HashCtx == NULL ||
+        EVP_DigestInit_ex(HashCtx, EVP_sha256(), NULL) != 1 ||
+        EVP_DigestUpdate(HashCtx, &CredType, sizeof(CredType)) != 1) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "EVP_DigestInit_ex failed");
+        Status = QUIC_STATUS_TLS_ERROR;
+        goto Exit;
+    }
+
+    if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_PKCS12) {
+        Password = CredConfig->CertificatePkcs12->PrivateKeyPassword;
+        if (!CxPlatTlsCredentialHashComponent(
+                HashCtx,
+                CredConfig->CertificatePkcs12->Asn1Blob,
+                CredConfig->CertificatePkcs12->Asn1BlobLength)) {
+            goto HashError;
+        }
+    } else {
+        char* KeyData;
+        char* CertData;
+        long KeyLength, CertLength;
+
+        if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED) {
+            Password = CredConfig->CertificateFileProtected->PrivateKeyPassword;
+        }
+
+        KeyBio = CxPlatTlsReadFile(CredConfig->CertificateFile->PrivateKeyFile);
+        CertBio = CxPlatTlsReadFile(CredConfig->CertificateFile->CertificateFile);
+        if (KeyBio == NULL || CertBio == NULL) {
+            Status = QUIC_STATUS_TLS_ERROR;
+            goto Exit;
+        }
+
+        KeyLength = BIO_get_mem_data(KeyBio, &KeyData);
+        CertLength = BIO_get_mem_data(CertBio, &CertData);
+        if (!CxPlatTlsCredentialHashComponent(HashCtx, KeyData, (uint32_t)KeyLength) ||
+            !CxPlatTlsCredentialHashComponent(HashCtx, CertData, (uint32_t)CertLength)) {
+            goto HashError;
+        }
+    }
+
+    if (!CxPlatTlsCredentialHashComponent(
+            HashCtx,
+            Password,
+            Password == NULL ? 0 : (uint32_t)strlen(Password)) ||
+        EVP_DigestFinal_ex(HashCtx, Hash, NULL) != 1) {
+        goto HashError;
+    }
+
+    CxPlatLockAcquire(&CxPlatTlsCredentialCacheLock);
+    for (Entry = CxPlatTlsCredentialCache.Flink;
+         Entry != &CxPlatTlsCredentialCache;
+         Entry = Entry->Flink) {
+        CXPLAT_TLS_CREDENTIAL* Cached =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_TLS_CREDENTIAL, Link);
+        if (memcmp(Cached->Hash, Hash, sizeof(Hash)) == 0) {
+            Cached->RefCount++;
+            *Credential = Cached;
+            break;
+        }
+    }
+    CxPlatLockRelease(&CxPlatTlsCredentialCacheLock);
+
+    if (*Credential != NULL) {
+        goto Exit;
+    }
+
+    NewCredential =
+        CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_TLS_CREDENTIAL), QUIC_POOL_TLS_CREDENTIAL);
+    if (NewCredential == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_TLS_CREDENTIAL",
+            sizeof(CXPLAT_TLS_CREDENTIAL));
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+    CxPlatZeroMemory(NewCredential, sizeof(CXPLAT_TLS_CREDENTIAL));
+    NewCredential->RefCount = 1;
+    CxPlatCopyMemory(NewCredential->Hash, Hash, sizeof(Hash));
+
+    if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_PKCS12) {
+        Status =
+            CxPlatTlsParsePkcs12(
+                CredConfig->CertificatePkcs12->Asn1Blob,
+                CredConfig->CertificatePkcs12->Asn1BlobLength,
+                Password,
+                &NewCredential->PrivateKey,
+                &NewCredential->Certificate,
+                &NewCredential->Chain);
+    } else {
+        Status = CxPlatTlsParsePem(KeyBio, CertBio, Password, NewCredential);
+    }
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    //
+    // Another configuration may have parsed the same material concurrently;
+    // the first one inserted wins.
+    //
+    CxPlatLockAcquire(&CxPlatTlsCredentialCacheLock);
+    for (Entry = CxPlatTlsCredentialCache.Flink;
+         Entry != &CxPlatTlsCredentialCache;
+         Entry = Entry->Flink) {
+        CXPLAT_TLS_CREDENTIAL* Cached =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_TLS_CREDENTIAL, Link);
+        if (memcmp(Cached->Hash, Hash, sizeof(Hash)) == 0) {
+            Cached->RefCount++;
+            *Credential = Cached;
+            break;
+        }
+    }
+    if (*Credential == NULL) {
+        CxPlatListInsertTail(&CxPlatTlsCredentialCache, &NewCredential->Link);
+        *Credential = NewCredential;
+        NewCredential = NULL;
+    }
+    CxPlatLockRelease(&CxPlatTlsCredentialCacheLock);
+
+    goto Exit;
+
+HashError:
+
+    QuicTraceEvent(
+        LibraryErrorStatus,
+        "[ lib] ERROR, %u, %s.",
+        ERR_get_error(),
+        "EVP_DigestUpdate failed");
+    Status = QUIC_STATUS_TLS_ERROR;
+
+Exit:
+
+    if (NewCredential != NULL) {
+        CxPlatTlsCredentialFree(NewCredential);
+    }
+    if (HashCtx != NULL) {
+        EVP_MD_CTX_free(HashCtx);
+    }
+    if (KeyBio != NULL) {
+        BIO_free(KeyBio);
+    }
+    if (CertBio != NULL) {
+        BIO_free(CertBio);
+    }
+
+    return Status;
+}
+
+static
+void
+CxPlatTlsCredentialRelease(
+    _In_ CXPLAT_TLS_CREDENTIAL* Credential
+    )
+{
+    BOOLEAN Free;
+
+    CxPlatLockAcquire(&CxPlatTlsCredentialCacheLock);
+    CXPLAT_DBG_ASSERT(Credential->RefCount > 0);
+    Free = --Credential->RefCount == 0;
+    if (Free) {
+        CxPlatListEntryRemove(&Credential->Link);
+    }
+    CxPlatLockRelease(&CxPlatTlsCredentialCacheLock);
+
+    if (Free) {
+        CxPlatTlsCredentialFree(Credential);
+    }
+}
+
+//
+// Installs a private key, certificate and chain on the SSL context. OpenSSL
+// takes its own references, so the objects stay shared with the cache.
+//
+static
+QUIC_STATUS
+CxPlatTlsUseCredential(
+    _In_ SSL_CTX* SSLCtx,
+    _In_ EVP_PKEY* PrivateKey,
+    _In_ X509* Certificate,
+    _In_opt_ STACK_OF(X509)* Chain
+    )
+{
+    int Ret = SSL_CTX_use_PrivateKey(SSLCtx, PrivateKey);
+    if (Ret != 1) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "SSL_CTX_use_PrivateKey failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    Ret = SSL_CTX_use_certificate(SSLCtx, Certificate);
+    if (Ret != 1) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            ERR_get_error(),
+            "SSL_CTX_use_certificate failed");
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (Chain != NULL && sk_X509_num(Chain) > 0) {
+        Ret = (int)SSL_CTX_set1_chain(SSLCtx, Chain);
+        if (Ret != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "SSL_CTX_set1_chain failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_TLS_PROVIDER
 CxPlatTlsGetProvider(
@@ -1048,6 +1654,7 @@ CxPlatTlsSecConfigCreate(
     CXPLAT_SEC_CONFIG* SecurityConfig = NULL;
     X509* X509Cert = NULL;
     EVP_PKEY* PrivateKey = NULL;
+    STACK_OF(X509)* CaChain = NULL;
     char* CipherSuiteString = NULL;
 
     //
@@ -1292,197 +1899,113 @@ CxPlatTlsSecConfigCreate(
     //
 
     if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE ||
-        CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED) {
+        CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED ||
+        CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_PKCS12) {
 
-        if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED) {
-            SSL_CTX_set_default_passwd_cb_userdata(
-                SecurityConfig->SSLCtx, (void*)CredConfig->CertificateFileProtected->PrivateKeyPassword);
-        }
-
-        Ret =
-            SSL_CTX_use_PrivateKey_file(
-                SecurityConfig->SSLCtx,
-                CredConfig->CertificateFile->PrivateKeyFile,
-                SSL_FILETYPE_PEM);
-        if (Ret != 1) {
-            QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                ERR_get_error(),
-                "SSL_CTX_use_PrivateKey_file failed");
-            Status = QUIC_STATUS_TLS_ERROR;
+        //
+        // Credentials passed by value are parsed once and shared with every
+        // other configuration loading the same bytes.
+        //
+        Status =
+            CxPlatTlsCredentialAcquire(
+                CredConfig,
+                &SecurityConfig->Credential);
+        if (QUIC_FAILED(Status)) {
             goto Exit;
         }
 
-        Ret =
-            SSL_CTX_use_certificate_chain_file(
+        Status =
+            CxPlatTlsUseCredential(
                 SecurityConfig->SSLCtx,
-                CredConfig->CertificateFile->CertificateFile);
-        if (Ret != 1) {
-            QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                ERR_get_error(),
-                "SSL_CTX_use_certificate_chain_file failed");
-            Status = QUIC_STATUS_TLS_ERROR;
+                SecurityConfig->Credential->PrivateKey,
+                SecurityConfig->Credential->Certificate,
+                SecurityConfig->Credential->Chain);
+        if (QUIC_FAILED(Status)) {
             goto Exit;
         }
+
     } else if (CredConfig->Type != QUIC_CREDENTIAL_TYPE_NONE) {
-        BIO* Bio = BIO_new(BIO_s_mem());
-        PKCS12 *Pkcs12 = NULL;
-        const char* Password = NULL;
+        uint8_t* PfxBlob = NULL;
+        uint32_t PfxSize = 0;
         char PasswordBuffer[PFX_PASSWORD_LENGTH];
+        CxPlatRandom(sizeof(PasswordBuffer), PasswordBuffer);
 
-        if (!Bio) {
-            QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                ERR_get_error(),
-                "BIO_new failed");
-            Status = QUIC_STATUS_TLS_ERROR;
-            goto Exit;
-        }
-
-        BIO_set_mem_eof_return(Bio, 0);
-
-        if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_PKCS12) {
-            Password = CredConfig->CertificatePkcs12->PrivateKeyPassword;
-            Ret =
-                BIO_write(
-                    Bio,
-                    CredConfig->CertificatePkcs12->Asn1Blob,
-                    CredConfig->CertificatePkcs12->Asn1BlobLength);
-            if (Ret < 0) {
-                QuicTraceEvent(
-                    LibraryErrorStatus,
-                    "[ lib] ERROR, %u, %s.",
-                    ERR_get_error(),
-                    "BIO_write failed");
-                Status = QUIC_STATUS_TLS_ERROR;
-                goto Exit;
-            }
-        } else {
-            uint8_t* PfxBlob = NULL;
-            uint32_t PfxSize = 0;
-            CxPlatRandom(sizeof(PasswordBuffer), PasswordBuffer);
-
-            //
-            // Fixup password to printable characters
-            //
-            for (uint32_t idx = 0; idx < sizeof(PasswordBuffer); ++idx) {
-                PasswordBuffer[idx] = ((uint8_t)PasswordBuffer[idx] % 94) + 32;
-            }
-            PasswordBuffer[PFX_PASSWORD_LENGTH - 1] = 0;
-            Password = PasswordBuffer;
-
-            Status =
-                CxPlatCertExtractPrivateKey(
-                    CredConfig,
-                    PasswordBuffer,
-                    &PfxBlob,
-                    &PfxSize);
-            if (QUIC_FAILED(Status)) {
-                goto Exit;
-            }
-
-            Ret = BIO_write(Bio, PfxBlob, PfxSize);
-            CXPLAT_FREE(PfxBlob, QUIC_POOL_TLS_PFX);
-            if (Ret < 0) {
-                QuicTraceEvent(
-                    LibraryErrorStatus,
-                    "[ lib] ERROR, %u, %s.",
-                    ERR_get_error(),
-                    "BIO_write failed");
-                Status = QUIC_STATUS_TLS_ERROR;
-                goto Exit;
-            }
-        }
-
-        Pkcs12 = d2i_PKCS12_bio(Bio, NULL);
-        BIO_free(Bio);
-        Bio = NULL;
-
-        if (!Pkcs12) {
-            QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                ERR_get_error(),
-                "d2i_PKCS12_bio failed");
-            Status = QUIC_STATUS_TLS_ERROR;
-            goto Exit;
+        //
+        // Fixup password to printable characters
+        //
+        for (uint32_t idx = 0; idx < sizeof(PasswordBuffer); ++idx) {
+            PasswordBuffer[idx] = ((uint8_t)PasswordBuffer[idx] % 94) + 32;
         }
+        PasswordBuffer[PFX_PASSWORD_LENGTH - 1] = 0;
 
-        STACK_OF(X509) *CaCertificates = NULL;
-        Ret =
-            PKCS12_parse(Pkcs12, Password, &PrivateKey, &X509Cert, &CaCertificates);
-        if (CaCertificates) {
-            X509* CaCert;
-            while ((CaCert = sk_X509_pop(CaCertificates)) != NULL) {
-                //
-                // This transfers ownership to SSLCtx and CaCert does not need to be freed.
-                //
-                SSL_CTX_add_extra_chain_cert(SecurityConfig->SSLCtx, CaCert);
-            }
-            sk_X509_free(CaCertificates);
-        }
-        if (Pkcs12) {
-            PKCS12_free(Pkcs12);
-        }
-        if (Password == PasswordBuffer) {
+        Status =
+            CxPlatCertExtractPrivateKey(
+                CredConfig,
+                PasswordBuffer,
+                &PfxBlob,
+                &PfxSize);
+        if (QUIC_FAILED(Status)) {
             CxPlatZeroMemory(PasswordBuffer, sizeof(PasswordBuffer));
+            goto Exit;
         }
 
-        if (Ret != 1) {
-            QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                ERR_get_error(),
-                "PKCS12_parse failed");
-            Status = QUIC_STATUS_TLS_ERROR;
+        Status =
+            CxPlatTlsParsePkcs12(
+                PfxBlob,
+                PfxSize,
+                PasswordBuffer,
+                &PrivateKey,
+                &X509Cert,
+                &CaChain);
+        CXPLAT_FREE(PfxBlob, QUIC_POOL_TLS_PFX);
+        CxPlatZeroMemory(PasswordBuffer, sizeof(PasswordBuffer));
+        if (QUIC_FAILED(Status)) {
             goto Exit;
         }
 
-        Ret =
-            SSL_CTX_use_PrivateKey(
+        Status =
+            CxPlatTlsUseCredential(
                 SecurityConfig->SSLCtx,
-                PrivateKey);
-        if (Ret != 1) {
-            QuicTraceEvent(
-                LibraryErrorStatus,
-                "[ lib] ERROR, %u, %s.",
-                ERR_get_error(),
-                "SSL_CTX_use_PrivateKey_file failed");
-            Status = QUIC_STATUS_TLS_ERROR;
+                PrivateKey,
+                X509Cert,
+                CaChain);
+        if (QUIC_FAILED(Status)) {
             goto Exit;
         }
+    }
 
-        Ret =
-            SSL_CTX_use_certificate(
-                SecurityConfig->SSLCtx,
-                X509Cert);
+    if (CredConfig->Type != QUIC_CREDENTIAL_TYPE_NONE) {
+        Ret = SSL_CTX_check_private_key(SecurityConfig->SSLCtx);
         if (Ret != 1) {
             QuicTraceEvent(
                 LibraryErrorStatus,
                 "[ lib] ERROR, %u, %s.",
                 ERR_get_error(),
-                "SSL_CTX_use_certificate failed");
+                "SSL_CTX_check_private_key failed");
             Status = QUIC_STATUS_TLS_ERROR;
             goto Exit;
         }
     }
 
-    if (CredConfig->Type != QUIC_CREDENTIAL_TYPE_NONE) {
-        Ret = SSL_CTX_check_private_key(SecurityConfig->SSLCtx);
-        if (Ret != 1) {
+#if OPENSSL_VERSION_NUMBER >= 0x30200000L && !defined(OPENSSL_NO_COMP_ALG)
+    if (!(CredConfigFlags & QUIC_CREDENTIAL_FLAG_CLIENT) &&
+        CredConfig->Type != QUIC_CREDENTIAL_TYPE_NONE) {
+        //
+        // Certificate compression (RFC 8879) is negotiated by default; compress
+        // the chain once here so each handshake only copies the cached result.
+        // A smaller first flight is more likely to fit in the anti-amplification
+        // limit. Failure (e.g. no algorithm built in) only disables the cache.
+        //
+        if (SSL_CTX_compress_certs(SecurityConfig->SSLCtx, 0) != 1) {
             QuicTraceEvent(
                 LibraryErrorStatus,
                 "[ lib] ERROR, %u, %s.",
                 ERR_get_error(),
-                "SSL_CTX_check_private_key failed");
-            Status = QUIC_STATUS_TLS_ERROR;
-            goto Exit;
+                "SSL_CTX_compress_certs failed");
+            ERR_clear_error();
         }
     }
+#endif
 
     if (CredConfigFlags & QUIC_CREDENTIAL_FLAG_SET_CA_CERTIFICATE_FILE &&
         CredConfig->CaCertificateFile) {
@@ -1523,6 +2046,12 @@ CxPlatTlsSecConfigCreate(
             SSL_OP_NO_ANTI_REPLAY);
         SSL_CTX_clear_options(SecurityConfig->SSLCtx, SSL_OP_ENABLE_MIDDLEBOX_COMPAT);
         SSL_CTX_set_mode(SecurityConfig->SSLCtx, SSL_MODE_RELEASE_BUFFERS);
+        if (TlsCredFlags & CXPLAT_TLS_CREDENTIAL_FLAG_ASYNC_CRYPTO) {
+            //
+            // Lets an async engine (e.g. QAT) park the signing operation.
+            //
+            SSL_CTX_set_mode(SecurityConfig->SSLCtx, SSL_MODE_ASYNC);
+        }
 
         if (CredConfigFlags & QUIC_CREDENTIAL_FLAG_INDICATE_CERTIFICATE_RECEIVED ||
             CredConfigFlags & QUIC_CREDENTIAL_FLAG_REQUIRE_CLIENT_AUTHENTICATION) {
@@ -1586,6 +2115,10 @@ Exit:
         EVP_PKEY_free(PrivateKey);
     }
 
+    if (CaChain != NULL) {
+        sk_X509_pop_free(CaChain, X509_free);
+    }
+
     return Status;
 }
 
@@ -1600,6 +2133,10 @@ CxPlatTlsSecConfigDelete(
         SSL_CTX_free(SecurityConfig->SSLCtx);
     }
 
+    if (SecurityConfig->Credential != NULL) {
+        CxPlatTlsCredentialRelease(SecurityConfig->Credential);
+    }
+
     if (SecurityConfig->TicketKey != NULL) {
         CXPLAT_FREE(SecurityConfig->TicketKey, QUIC_POOL_TLS_TICKET_KEY);
     }
@@ -1868,6 +2405,55 @@ CxPlatTlsUpdateHkdfLabels(
     TlsContext->HkdfLabels = Labels;
 }
 
+//
+// Waits for the async crypto engine to signal that the job paused inside
+// SSL_do_handshake can resume. This blocks the calling thread, so the server
+// only enables async mode when the first flight runs on handshake threads.
+//
+static
+BOOLEAN
+CxPlatTlsWaitForAsyncJob(
+    _In_ CXPLAT_TLS* TlsContext
+    )
+{
+    OSSL_ASYNC_FD Fds[CXPLAT_TLS_MAX_ASYNC_FDS];
+    size_t FdCount = 0;
+    if (!SSL_get_all_async_fds(TlsContext->Ssl, NULL, &FdCount) ||
+        FdCount > ARRAYSIZE(Fds) ||
+        !SSL_get_all_async_fds(TlsContext->Ssl, Fds, &FdCount)) {
+        QuicTraceEvent(
+            TlsError,
+            "[ tls][%p] ERROR, %s.",
+            TlsContext->Connection,
+            "SSL_get_all_async_fds failed");
+        return FALSE;
+    }
+
+    if (FdCount == 0) {
+        //
+        // The engine doesn't expose a wait fd, so just retry.
+        //
+        CxPlatSchedulerYield();
+        return TRUE;
+    }
+
+#ifdef _WIN32
+    return WaitForMultipleObjects((DWORD)FdCount, Fds, FALSE, INFINITE) != WAIT_FAILED;
+#else
+    struct pollfd PollFds[CXPLAT_TLS_MAX_ASYNC_FDS];
+    for (size_t i = 0; i < FdCount; ++i) {
+        PollFds[i].fd = Fds[i];
+        PollFds[i].events = POLLIN;
+        PollFds[i].revents = 0;
+    }
+    int Result;
+    do {
+        Result = poll(PollFds, (nfds_t)FdCount, -1);
+    } while (Result < 0 && errno == EINTR);
+    return Result > 0;
+#endif
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 CXPLAT_TLS_RESULT_FLAGS
 CxPlatTlsProcessData(
@@ -1962,10 +2548,22 @@ CxPlatTlsProcessData(
     }
 
     if (!State->HandshakeComplete) {
-        int Ret = SSL_do_handshake(TlsContext->Ssl);
+        int Ret;
+more_handshake:
+        Ret = SSL_do_handshake(TlsContext->Ssl);
         if (Ret <= 0) {
             int Err = SSL_get_error(TlsContext->Ssl, Ret);
             switch (Err) {
+            case SSL_ERROR_WANT_ASYNC:
+            case SSL_ERROR_WANT_ASYNC_JOB:
+                if (Err == SSL_ERROR_WANT_ASYNC_JOB) {
+                    CxPlatSchedulerYield(); // The async job pool is exhausted.
+                } else if (!CxPlatTlsWaitForAsyncJob(TlsContext)) {
+                    TlsContext->ResultFlags |= CXPLAT_TLS_RESULT_ERROR;
+                    goto Exit;
+                }
+                goto more_handshake;
+
             case SSL_ERROR_WANT_READ:
             case SSL_ERROR_WANT_WRITE:
                 //
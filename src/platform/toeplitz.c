@@ -38,6 +38,15 @@ Notes:
     at a time. This requires us to maintain a lookup table of 16 32-bit entries
     for each nibble of the hash input.
 
+    On x64 CPUs with carry-less multiplication (PCLMULQDQ), the input is
+    instead processed eight bytes at a time. If A is a 64-bit chunk of input,
+    MSB first, and W is the key window starting at the chunk's first bit with
+    the key's bits reversed (bit m of W is key bit m), then bit (63 + j) of
+    the carry-less product A * W is the XOR over the set input bits i of key
+    bit (i + j), which is bit j of the hash counted from the left. Each chunk
+    needs two multiplies (W is 95 bits), and the result, accumulated with its
+    bits reversed, is reversed once at the end.
+
     This implementation assumes that the output of the hash is always 32-bit.
     It also assumes that the caller will pass in a array of bytes to hash, and
     the number of bits in the hash input will always be a multiple of 8 -- that
@@ -51,6 +60,108 @@ Notes:
 #include "toeplitz.c.clog.h"
 #endif
 
+#if (defined(_M_X64) && !defined(_KERNEL_MODE)) || defined(__x86_64__)
+#define CXPLAT_TOEPLITZ_CLMUL 1
+#ifdef _WIN32
+#include <intrin.h>
+#define CXPLAT_TOEPLITZ_CLMUL_TARGET
+#else
+#include <immintrin.h>
+#define CXPLAT_TOEPLITZ_CLMUL_TARGET __attribute__((target("pclmul")))
+#endif
+#endif
+
+static
+uint8_t
+CxPlatToeplitzReverseByte(
+    _In_ uint8_t Byte
+    )
+{
+    Byte = (uint8_t)(((Byte & 0xF0) >> 4) | ((Byte & 0x0F) << 4));
+    Byte = (uint8_t)(((Byte & 0xCC) >> 2) | ((Byte & 0x33) << 2));
+    return (uint8_t)(((Byte & 0xAA) >> 1) | ((Byte & 0x55) << 1));
+}
+
+#ifdef CXPLAT_TOEPLITZ_CLMUL
+
+static
+BOOLEAN
+CxPlatToeplitzClmulSupported(
+    void
+    )
+{
+#ifdef _WIN32
+    int CpuInfo[4];
+    __cpuid(CpuInfo, 1);
+    return (CpuInfo[2] & (1 << 1)) != 0; // ECX.PCLMULQDQ
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") != 0;
+#endif
+}
+
+static
+uint32_t
+CxPlatToeplitzReverse32(
+    _In_ uint32_t Value
+    )
+{
+    Value = ((Value >> 1) & 0x55555555) | ((Value & 0x55555555) << 1);
+    Value = ((Value >> 2) & 0x33333333) | ((Value & 0x33333333) << 2);
+    Value = ((Value >> 4) & 0x0F0F0F0F) | ((Value & 0x0F0F0F0F) << 4);
+    Value = ((Value >> 8) & 0x00FF00FF) | ((Value & 0x00FF00FF) << 8);
+    return (Value >> 16) | (Value << 16);
+}
+
+CXPLAT_TOEPLITZ_CLMUL_TARGET
+static
+uint32_t
+CxPlatToeplitzHashComputeClmul(
+    _In_ const CXPLAT_TOEPLITZ_HASH* Toeplitz,
+    _In_reads_(HashInputLength)
+        const uint8_t* HashInput,
+    _In_ uint32_t HashInputLength,
+    _In_ uint32_t HashInputOffset
+    )
+{
+    uint32_t ReversedResult = 0;
+
+    for (uint32_t i = 0; i < HashInputLength; i += 8) {
+        //
+        // Load up to eight input bytes, MSB first, zero padded.
+        //
+        uint64_t Chunk = 0;
+        if (HashInputLength - i >= 8) {
+            CxPlatCopyMemory(&Chunk, HashInput + i, sizeof(Chunk));
+            Chunk = CxPlatByteSwapUint64(Chunk); // x64 is little endian
+        } else {
+            for (uint32_t j = 0; j < HashInputLength - i; j++) {
+                Chunk |= (uint64_t)HashInput[i + j] << (56 - 8 * j);
+            }
+        }
+
+        const __m128i Input = _mm_cvtsi64_si128((long long)Chunk);
+        const __m128i Window =
+            _mm_loadu_si128(
+                (const __m128i*)(Toeplitz->ReversedKey + HashInputOffset + i));
+        const __m128i Low = _mm_clmulepi64_si128(Input, Window, 0x00);
+        const __m128i High = _mm_clmulepi64_si128(Input, Window, 0x10);
+
+        //
+        // Take bits 63..94 of Input * Window.
+        //
+        const uint64_t Product =
+            ((uint64_t)_mm_cvtsi128_si64(Low) >> 63) ^
+            ((uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(Low, Low)) << 1) ^
+            ((uint64_t)_mm_cvtsi128_si64(High) << 1);
+        ReversedResult ^= (uint32_t)Product;
+    }
+
+    return CxPlatToeplitzReverse32(ReversedResult);
+}
+
+#endif // CXPLAT_TOEPLITZ_CLMUL
+
 //
 // Initializes the state required for a Toeplitz hash computation. We
 // maintain per-nibble lookup tables, and we initialize them here.
@@ -72,6 +183,20 @@ CxPlatToeplitzHashInitialize(
     // table.
     //
 
+    //
+    // Initialize the reversed key for the carry-less multiply path.
+    //
+    const uint32_t KeySize = (uint32_t)Toeplitz->InputSize + CXPLAT_TOEPLITZ_OUPUT_SIZE;
+    CxPlatZeroMemory(Toeplitz->ReversedKey, sizeof(Toeplitz->ReversedKey));
+    for (uint32_t i = 0; i < KeySize; i++) {
+        Toeplitz->ReversedKey[i] = CxPlatToeplitzReverseByte(Toeplitz->HashKey[i]);
+    }
+#ifdef CXPLAT_TOEPLITZ_CLMUL
+    Toeplitz->UseClmul = CxPlatToeplitzClmulSupported();
+#else
+    Toeplitz->UseClmul = FALSE;
+#endif
+
     //
     // Initialize the Toeplitz->LookupTables.
     //
@@ -156,6 +281,14 @@ CxPlatToeplitzHashCompute(
     CXPLAT_DBG_ASSERT(
         (BaseOffset + HashInputLength * NIBBLES_PER_BYTE) <= (uint32_t)(Toeplitz->InputSize * NIBBLES_PER_BYTE));
 
+#ifdef CXPLAT_TOEPLITZ_CLMUL
+    if (Toeplitz->UseClmul) {
+        return
+            CxPlatToeplitzHashComputeClmul(
+                Toeplitz, HashInput, HashInputLength, HashInputOffset);
+    }
+#endif
+
     for (uint32_t i = 0; i < HashInputLength; i++) {
         Result ^= Toeplitz->LookupTableArray[BaseOffset].Table[(HashInput[i] >> 4) & 0xf];
         BaseOffset++;
@@ -421,6 +421,51 @@ TEST_F(CryptTest, WellKnownClientInitialv2)
         nullptr);
 }
 
+TEST_F(CryptTest, RekeyInitial)
+{
+    const QuicBuffer Salt("38762cf7f55934b34d179ae6a4c80cadccbb7f0a");
+    const QUIC_HKDF_LABELS HkdfLabels = { "quic key", "quic iv", "quic hp", "quic ku" };
+    const uint8_t OldCid[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const uint8_t NewCid[8] = { 8, 7, 6, 5, 4, 3, 2, 1 };
+    QUIC_PACKET_KEY* ReadKey = nullptr, *WriteKey = nullptr;
+    QUIC_PACKET_KEY* ExpectedReadKey = nullptr, *ExpectedWriteKey = nullptr;
+
+    VERIFY_QUIC_SUCCESS(
+        QuicPacketKeyCreateInitial(
+            TRUE, &HkdfLabels, Salt.Data, sizeof(OldCid), OldCid, &ReadKey, &WriteKey));
+    VERIFY_QUIC_SUCCESS(
+        QuicPacketKeyCreateInitial(
+            TRUE, &HkdfLabels, Salt.Data, sizeof(NewCid), NewCid, &ExpectedReadKey, &ExpectedWriteKey));
+
+    //
+    // Keys re-keyed in place for a new CID must match freshly created ones.
+    //
+    VERIFY_QUIC_SUCCESS(
+        QuicPacketKeyRekeyInitial(
+            TRUE, &HkdfLabels, Salt.Data, sizeof(NewCid), NewCid, ReadKey, WriteKey));
+
+    QUIC_PACKET_KEY* Keys[2][2] = { { ReadKey, ExpectedReadKey }, { WriteKey, ExpectedWriteKey } };
+    for (auto& Pair : Keys) {
+        uint8_t Sample[CXPLAT_HP_SAMPLE_LENGTH] = {0};
+        uint8_t Mask[2][16];
+        uint8_t Buffer[2][64] = {};
+
+        ASSERT_EQ(0, memcmp(Pair[0]->Iv, Pair[1]->Iv, CXPLAT_IV_LENGTH));
+        for (uint8_t i = 0; i < 2; ++i) {
+            VERIFY_QUIC_SUCCESS(CxPlatHpComputeMask(Pair[i]->HeaderKey, 1, Sample, Mask[i]));
+            VERIFY_QUIC_SUCCESS(
+                CxPlatEncrypt(Pair[i]->PacketKey, Pair[i]->Iv, 0, NULL, sizeof(Buffer[i]), Buffer[i]));
+        }
+        ASSERT_EQ(0, memcmp(Mask[0], Mask[1], sizeof(Mask[0])));
+        ASSERT_EQ(0, memcmp(Buffer[0], Buffer[1], sizeof(Buffer[0])));
+    }
+
+    QuicPacketKeyFree(ReadKey);
+    QuicPacketKeyFree(WriteKey);
+    QuicPacketKeyFree(ExpectedReadKey);
+    QuicPacketKeyFree(ExpectedWriteKey);
+}
+
 #ifndef QUIC_DISABLE_CHACHA20_TESTS
 TEST_F(CryptTest, WellKnownChaChaPolyv1)
 {
@@ -475,6 +520,47 @@ TEST_F(CryptTest, HpMaskChaCha20)
 
     CxPlatHpKeyFree(HpKey);
 }
+
+TEST_F(CryptTest, HpMaskChaCha20Batch)
+{
+    const uint8_t RawKey[] =
+        {0x25, 0xa2, 0x82, 0xb9, 0xe8, 0x2f, 0x06, 0xf2,
+        0x1f, 0x48, 0x89, 0x17, 0xa4, 0xfc, 0x8f, 0x1b,
+        0x73, 0x57, 0x36, 0x85, 0x60, 0x85, 0x97, 0xd0,
+        0xef, 0xcb, 0x07, 0x6b, 0x0a, 0xb7, 0xa7, 0xa4};
+    const uint8_t Sample[] =
+        {0x5e, 0x5c, 0xd5, 0x5c, 0x41, 0xf6, 0x90, 0x80,
+        0x57, 0x5d, 0x79, 0x99, 0xc2, 0x5a, 0x5b, 0xfb};
+    const uint8_t ExpectedMask[] = {0xae, 0xfe, 0xfe, 0x7d, 0x03};
+
+    //
+    // More samples than fit in one pass of the kernel, with the known sample
+    // in both the first and the last slot.
+    //
+    const uint8_t BatchSize = 10;
+    uint8_t Samples[CXPLAT_HP_SAMPLE_LENGTH * BatchSize];
+    uint8_t Mask[CXPLAT_HP_SAMPLE_LENGTH * BatchSize];
+    uint8_t SingleMask[CXPLAT_HP_SAMPLE_LENGTH];
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        memset(Samples + i * CXPLAT_HP_SAMPLE_LENGTH, i, CXPLAT_HP_SAMPLE_LENGTH);
+    }
+    memcpy(Samples, Sample, sizeof(Sample));
+    memcpy(Samples + (BatchSize - 1) * CXPLAT_HP_SAMPLE_LENGTH, Sample, sizeof(Sample));
+
+    CXPLAT_HP_KEY* HpKey = nullptr;
+    VERIFY_QUIC_SUCCESS(CxPlatHpKeyCreate(CXPLAT_AEAD_CHACHA20_POLY1305, RawKey, &HpKey));
+    VERIFY_QUIC_SUCCESS(CxPlatHpComputeMask(HpKey, BatchSize, Samples, Mask));
+
+    ASSERT_EQ(0, memcmp(ExpectedMask, Mask, sizeof(ExpectedMask)));
+    ASSERT_EQ(0, memcmp(ExpectedMask, Mask + (BatchSize - 1) * CXPLAT_HP_SAMPLE_LENGTH, sizeof(ExpectedMask)));
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        VERIFY_QUIC_SUCCESS(
+            CxPlatHpComputeMask(HpKey, 1, Samples + i * CXPLAT_HP_SAMPLE_LENGTH, SingleMask));
+        ASSERT_EQ(0, memcmp(SingleMask, Mask + i * CXPLAT_HP_SAMPLE_LENGTH, sizeof(ExpectedMask)));
+    }
+
+    CxPlatHpKeyFree(HpKey);
+}
 #endif // QUIC_DISABLE_CHACHA20_TESTS
 
 TEST_F(CryptTest, HpMaskAes256)
@@ -619,6 +705,200 @@ TEST_P(CryptTest, Encryption)
     ASSERT_FALSE(Key.Decrypt(Iv, sizeof(AuthData), AuthData, sizeof(Buffer), Buffer));
 }
 
+TEST_P(CryptTest, EncryptionBatch)
+{
+    int AEAD = GetParam();
+
+    const uint8_t BatchSize = 4;
+    uint8_t RawKey[32] = {0};
+    uint8_t Iv[BatchSize][CXPLAT_IV_LENGTH];
+    uint8_t AuthData[BatchSize][12];
+    uint8_t Buffer[BatchSize][128];
+    uint8_t Expected[BatchSize][128];
+    CXPLAT_CRYPT_PACKET Packets[BatchSize];
+    QUIC_STATUS Results[BatchSize];
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        memset(Iv[i], i, sizeof(Iv[i]));
+        memset(AuthData[i], 0x10 + i, sizeof(AuthData[i]));
+        memset(Buffer[i], 0x20 + i, sizeof(Buffer[i]));
+        memcpy(Expected[i], Buffer[i], sizeof(Buffer[i]));
+        Packets[i].Iv = Iv[i];
+        Packets[i].AuthData = AuthData[i];
+        Packets[i].AuthDataLength = sizeof(AuthData[i]);
+        Packets[i].Buffer = Buffer[i];
+        Packets[i].BufferLength = sizeof(Buffer[i]);
+        Packets[i].Segments = NULL;
+        Packets[i].SegmentCount = 0;
+    }
+
+    //
+    // The batch must produce exactly what individual calls produce.
+    //
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_TRUE(Key.Encrypt(Iv[i], sizeof(AuthData[i]), AuthData[i], sizeof(Expected[i]), Expected[i]));
+    }
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatEncryptBatch(Key.Ptr, BatchSize, Packets));
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_EQ(0, memcmp(Expected[i], Buffer[i], sizeof(Buffer[i])));
+    }
+
+    //
+    // A single corrupted packet only fails itself.
+    //
+    Buffer[1][0] ^= 1;
+    ASSERT_TRUE(QUIC_FAILED(CxPlatDecryptBatch(Key.Ptr, BatchSize, Packets, Results)));
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_EQ(i != 1, QUIC_SUCCEEDED(Results[i]));
+    }
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        if (i == 1) continue;
+        for (uint8_t j = 0; j < sizeof(Buffer[i]) - CXPLAT_ENCRYPTION_OVERHEAD; ++j) {
+            ASSERT_EQ(0x20 + i, Buffer[i][j]);
+        }
+    }
+}
+
+TEST_P(CryptTest, EncryptionSegments)
+{
+    int AEAD = GetParam();
+
+    uint8_t RawKey[32] = {0};
+    uint8_t Iv[CXPLAT_IV_LENGTH] = {0};
+    uint8_t AuthData[12] = {0};
+    uint8_t Buffer[128];
+    uint8_t Expected[128];
+    uint8_t Source[2][32];
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    memset(Source[0], 0x33, sizeof(Source[0]));
+    memset(Source[1], 0x44, sizeof(Source[1]));
+
+    //
+    // Two external ranges, with in place plaintext before, between and after.
+    //
+    const CXPLAT_CRYPT_SEGMENT Segments[2] = {
+        { Source[0], 5, sizeof(Source[0]) },
+        { Source[1], 40, sizeof(Source[1]) }
+    };
+
+    memset(Expected, 0x22, sizeof(Expected));
+    for (uint8_t i = 0; i < 2; ++i) {
+        memcpy(Expected + Segments[i].Offset, Segments[i].Source, Segments[i].Length);
+    }
+    memset(Buffer, 0x22, sizeof(Buffer));
+    for (uint8_t i = 0; i < 2; ++i) {
+        memset(Buffer + Segments[i].Offset, 0xFF, Segments[i].Length); // Never read
+    }
+
+    CXPLAT_CRYPT_PACKET Packet;
+    Packet.Iv = Iv;
+    Packet.AuthData = AuthData;
+    Packet.AuthDataLength = sizeof(AuthData);
+    Packet.Buffer = Buffer;
+    Packet.BufferLength = sizeof(Buffer);
+    Packet.Segments = Segments;
+    Packet.SegmentCount = 2;
+
+    ASSERT_TRUE(Key.Encrypt(Iv, sizeof(AuthData), AuthData, sizeof(Expected), Expected));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatEncryptBatch(Key.Ptr, 1, &Packet));
+    ASSERT_EQ(0, memcmp(Expected, Buffer, sizeof(Buffer)));
+}
+
+TEST_P(CryptTest, DecryptionSegments)
+{
+    int AEAD = GetParam();
+
+    uint8_t RawKey[32] = {0};
+    uint8_t Iv[CXPLAT_IV_LENGTH] = {0};
+    uint8_t AuthData[12] = {0};
+    uint8_t Buffer[128];
+    uint8_t Destination[2][32];
+    uint8_t Prefix[24];
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    for (uint8_t i = 0; i < sizeof(Buffer); ++i) {
+        Buffer[i] = i;
+    }
+    ASSERT_TRUE(Key.Encrypt(Iv, sizeof(AuthData), AuthData, sizeof(Buffer), Buffer));
+
+    //
+    // The start of the plaintext can be peeked at without touching the buffer.
+    //
+    QUIC_STATUS Status = CxPlatDecryptPrefix(Key.Ptr, Iv, sizeof(Prefix), Buffer, Prefix);
+    if (Status != QUIC_STATUS_NOT_SUPPORTED) {
+        ASSERT_EQ(QUIC_STATUS_SUCCESS, Status);
+        for (uint8_t i = 0; i < sizeof(Prefix); ++i) {
+            ASSERT_EQ(i, Prefix[i]);
+        }
+    }
+
+    //
+    // Two external ranges, with in place plaintext before, between and after.
+    //
+    const CXPLAT_CRYPT_SEGMENT Segments[2] = {
+        { Destination[0], 5, sizeof(Destination[0]) },
+        { Destination[1], 40, sizeof(Destination[1]) }
+    };
+
+    CXPLAT_CRYPT_PACKET Packet;
+    Packet.Iv = Iv;
+    Packet.AuthData = AuthData;
+    Packet.AuthDataLength = sizeof(AuthData);
+    Packet.Buffer = Buffer;
+    Packet.BufferLength = sizeof(Buffer);
+    Packet.Segments = Segments;
+    Packet.SegmentCount = 2;
+
+    QUIC_STATUS Result;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatDecryptBatch(Key.Ptr, 1, &Packet, &Result));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Result);
+
+    for (uint8_t i = 0; i < sizeof(Buffer) - CXPLAT_ENCRYPTION_OVERHEAD; ++i) {
+        if (i >= Segments[0].Offset && i < Segments[0].Offset + Segments[0].Length) {
+            ASSERT_EQ(i, Destination[0][i - Segments[0].Offset]);
+        } else if (i >= Segments[1].Offset && i < Segments[1].Offset + Segments[1].Length) {
+            ASSERT_EQ(i, Destination[1][i - Segments[1].Offset]);
+        } else {
+            ASSERT_EQ(i, Buffer[i]);
+        }
+    }
+}
+
+TEST_P(CryptTest, Rekey)
+{
+    int AEAD = GetParam();
+
+    uint8_t RawKey[32] = {0};
+    uint8_t NewRawKey[32];
+    uint8_t Iv[CXPLAT_IV_LENGTH] = {0};
+    uint8_t Buffer[128] = {0};
+    uint8_t Expected[128] = {0};
+
+    memset(NewRawKey, 0x5A, sizeof(NewRawKey));
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+    QuicKey NewKey((CXPLAT_AEAD_TYPE)AEAD, NewRawKey);
+    if (NewKey.Ptr == NULL) return;
+
+    //
+    // A re-keyed key must behave exactly like a freshly created one.
+    //
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatKeyRekey((CXPLAT_AEAD_TYPE)AEAD, NewRawKey, &Key.Ptr));
+    ASSERT_TRUE(Key.Encrypt(Iv, 0, NULL, sizeof(Buffer), Buffer));
+    ASSERT_TRUE(NewKey.Encrypt(Iv, 0, NULL, sizeof(Expected), Expected));
+    ASSERT_EQ(0, memcmp(Expected, Buffer, sizeof(Buffer)));
+    ASSERT_TRUE(NewKey.Decrypt(Iv, 0, NULL, sizeof(Buffer), Buffer));
+}
+
 TEST_P(CryptTest, HashWellKnown)
 {
     int HASH = GetParam();
@@ -92,6 +92,9 @@ struct UdpRecvContext {
     CXPLAT_DSCP_TYPE Dscp {CXPLAT_DSCP_CS0};
     bool TtlSupported;
     bool DscpSupported;
+    bool RecvTimestampsSupported {false};
+    long ClientRecvCount {0};
+    long ExpectedClientRecvCount {1};
     UdpRecvContext() {
         CxPlatEventInitialize(&ClientCompletion, FALSE, FALSE);
     }
@@ -310,6 +313,11 @@ protected:
                 ASSERT_EQ(CXPLAT_DSCP_FROM_TOS(RecvData->TypeOfService), 0);
             }
 
+            if (RecvContext->RecvTimestampsSupported) {
+                ASSERT_NE(0ull, RecvData->RecvTime);
+                ASSERT_TRUE(CxPlatTimeAtOrBefore64(RecvData->RecvTime, CxPlatTimeUs64()));
+            }
+
             if (RecvData->Route->LocalAddress.Ipv4.sin_port == RecvContext->DestinationAddress.Ipv4.sin_port) {
 
                 ASSERT_EQ(CXPLAT_ECN_FROM_TOS(RecvData->TypeOfService), RecvContext->EcnType);
@@ -324,7 +332,10 @@ protected:
                 CxPlatSocketSend(Socket, RecvData->Route, ServerSendData);
 
             } else if (RecvData->Route->RemoteAddress.Ipv4.sin_port == RecvContext->DestinationAddress.Ipv4.sin_port) {
-                CxPlatEventSet(RecvContext->ClientCompletion);
+                if (InterlockedIncrement(&RecvContext->ClientRecvCount) >=
+                    RecvContext->ExpectedClientRecvCount) {
+                    CxPlatEventSet(RecvContext->ClientCompletion);
+                }
 
             } else {
                 GTEST_NONFATAL_FAILURE_("Received on unexpected address!");
@@ -814,6 +825,9 @@ TEST_P(DataPathTest, UdpData)
     CxPlatDataPath Datapath(&UdpRecvCallbacks);
     RecvContext.TtlSupported = Datapath.IsSupported(CXPLAT_DATAPATH_FEATURE_TTL);
     RecvContext.DscpSupported = Datapath.IsDscpSupported();
+    RecvContext.RecvTimestampsSupported =
+        Datapath.IsSupported(CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS) &&
+        !Datapath.IsSupported(CXPLAT_DATAPATH_FEATURE_RAW); // XDP doesn't timestamp
     VERIFY_QUIC_SUCCESS(Datapath.GetInitStatus());
     ASSERT_NE(nullptr, Datapath.Datapath);
 
@@ -848,6 +862,51 @@ TEST_P(DataPathTest, UdpData)
     ASSERT_TRUE(CxPlatEventWaitWithTimeout(RecvContext.ClientCompletion, 2000));
 }
 
+TEST_P(DataPathTest, UdpDataBatch)
+{
+    const uint32_t BatchCount = 4;
+    UdpRecvContext RecvContext;
+    RecvContext.ExpectedClientRecvCount = BatchCount;
+    CxPlatDataPath Datapath(&UdpRecvCallbacks);
+    RecvContext.TtlSupported = Datapath.IsSupported(CXPLAT_DATAPATH_FEATURE_TTL);
+    RecvContext.DscpSupported = Datapath.IsDscpSupported();
+    VERIFY_QUIC_SUCCESS(Datapath.GetInitStatus());
+    ASSERT_NE(nullptr, Datapath.Datapath);
+
+    auto unspecAddress = GetNewUnspecAddr();
+    CxPlatSocket Server(Datapath, &unspecAddress.SockAddr, nullptr, &RecvContext);
+    while (Server.GetInitStatus() == QUIC_STATUS_ADDRESS_IN_USE) {
+        unspecAddress.SockAddr.Ipv4.sin_port = GetNextPort();
+        Server.CreateUdp(Datapath, &unspecAddress.SockAddr, nullptr, &RecvContext);
+    }
+    VERIFY_QUIC_SUCCESS(Server.GetInitStatus());
+    ASSERT_NE(nullptr, Server.Socket);
+
+    auto serverAddress = GetNewLocalAddr();
+    RecvContext.DestinationAddress = serverAddress.SockAddr;
+    RecvContext.DestinationAddress.Ipv4.sin_port = Server.GetLocalAddress().Ipv4.sin_port;
+    ASSERT_NE(RecvContext.DestinationAddress.Ipv4.sin_port, (uint16_t)0);
+
+    CxPlatSocket Client(Datapath, nullptr, &RecvContext.DestinationAddress, &RecvContext);
+    VERIFY_QUIC_SUCCESS(Client.GetInitStatus());
+    ASSERT_NE(nullptr, Client.Socket);
+
+    CXPLAT_ROUTE Routes[BatchCount];
+    CXPLAT_SEND_DATA* SendData[BatchCount];
+    for (uint32_t i = 0; i < BatchCount; ++i) {
+        Routes[i] = Client.Route;
+        CXPLAT_SEND_CONFIG SendConfig = { &Routes[i], 0, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0 };
+        SendData[i] = CxPlatSendDataAlloc(Client, &SendConfig);
+        ASSERT_NE(nullptr, SendData[i]);
+        auto ClientBuffer = CxPlatSendDataAllocBuffer(SendData[i], ExpectedDataSize);
+        ASSERT_NE(nullptr, ClientBuffer);
+        memcpy(ClientBuffer->Buffer, ExpectedData, ExpectedDataSize);
+    }
+
+    CxPlatSocketSendBatch(Client, Routes, SendData, BatchCount);
+    ASSERT_TRUE(CxPlatEventWaitWithTimeout(RecvContext.ClientCompletion, 2000));
+}
+
 TEST_P(DataPathTest, UdpDataPolling)
 {
     QUIC_GLOBAL_EXECUTION_CONFIG Config = { QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_NONE, UINT32_MAX, 0 };
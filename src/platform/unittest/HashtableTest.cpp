@@ -0,0 +1,142 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the hash table, in both its chained and open addressing
+    variants.
+
+--*/
+
+#include "main.h"
+#include "quic_hashtable.h"
+#include <vector>
+
+#ifdef QUIC_CLOG
+#include "HashtableTest.cpp.clog.h"
+#endif
+
+struct HashtableTest : public ::testing::TestWithParam<uint32_t>
+{
+    struct TestEntry {
+        CXPLAT_HASHTABLE_ENTRY Entry;
+        uint64_t Key;
+        bool Inserted;
+    };
+
+    struct TestTable {
+        CXPLAT_HASHTABLE* Raw {nullptr};
+        TestTable(uint32_t Flags) {
+            EXPECT_TRUE(CxPlatHashtableInitializeWithFlags(&Raw, CXPLAT_HASH_MIN_SIZE, Flags));
+        }
+        ~TestTable() {
+            if (Raw) {
+                CxPlatHashtableUninitialize(Raw);
+            }
+        }
+        uint32_t Count(uint64_t Key) {
+            uint32_t Found = 0;
+            CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+            CXPLAT_HASHTABLE_ENTRY* Entry = CxPlatHashtableLookup(Raw, Key, &Context);
+            while (Entry != nullptr) {
+                EXPECT_EQ(Key, CXPLAT_CONTAINING_RECORD(Entry, TestEntry, Entry)->Key);
+                Found++;
+                Entry = CxPlatHashtableLookupNext(Raw, &Context);
+            }
+            return Found;
+        }
+    };
+};
+
+TEST_P(HashtableTest, InsertLookupRemove)
+{
+    const uint32_t EntryCount = 5000;
+    std::vector<TestEntry> Entries(EntryCount);
+    TestTable Table(GetParam());
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        Entries[i].Key = i / 2 + 1; // Two entries per key. Zero is reserved.
+        CxPlatHashtableInsert(Table.Raw, &Entries[i].Entry, Entries[i].Key, nullptr);
+    }
+    ASSERT_EQ(EntryCount, Table.Raw->NumEntries);
+
+    for (uint32_t i = 1; i <= EntryCount / 2; ++i) {
+        ASSERT_EQ(2u, Table.Count(i));
+    }
+    ASSERT_EQ(0u, Table.Count(EntryCount));
+
+    for (uint32_t i = 0; i < EntryCount; i += 2) {
+        CxPlatHashtableRemove(Table.Raw, &Entries[i].Entry, nullptr);
+    }
+    ASSERT_EQ(EntryCount / 2, Table.Raw->NumEntries);
+
+    for (uint32_t i = 1; i <= EntryCount / 2; ++i) {
+        ASSERT_EQ(1u, Table.Count(i));
+    }
+
+    for (uint32_t i = 1; i < EntryCount; i += 2) {
+        CxPlatHashtableRemove(Table.Raw, &Entries[i].Entry, nullptr);
+    }
+    ASSERT_EQ(0u, Table.Raw->NumEntries);
+}
+
+TEST_P(HashtableTest, EnumerateAndRemove)
+{
+    const uint32_t EntryCount = 3000;
+    std::vector<TestEntry> Entries(EntryCount);
+    TestTable Table(GetParam());
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        Entries[i].Key = i + 1;
+        Entries[i].Inserted = true;
+        CxPlatHashtableInsert(Table.Raw, &Entries[i].Entry, Entries[i].Key, nullptr);
+    }
+
+    //
+    // Remove every other entry while enumerating, and insert new ones, which
+    // may or may not be returned by the enumeration.
+    //
+    std::vector<TestEntry> Extra(EntryCount);
+    uint32_t Enumerated = 0;
+    CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+    CXPLAT_HASHTABLE_ENTRY* Entry;
+    CxPlatHashtableEnumerateBegin(Table.Raw, &Enumerator);
+    while ((Entry = CxPlatHashtableEnumerateNext(Table.Raw, &Enumerator)) != nullptr) {
+        TestEntry* Test = CXPLAT_CONTAINING_RECORD(Entry, TestEntry, Entry);
+        if (Test >= &Entries[0] && Test < &Entries[0] + EntryCount) {
+            ASSERT_TRUE(Test->Inserted);
+            Test->Inserted = false; // Each original entry is returned once.
+            if (Test->Key % 2 == 0) {
+                CxPlatHashtableRemove(Table.Raw, Entry, nullptr);
+            }
+        }
+        if (Enumerated < EntryCount) {
+            Extra[Enumerated].Key = EntryCount + Enumerated + 1;
+            CxPlatHashtableInsert(
+                Table.Raw, &Extra[Enumerated].Entry, Extra[Enumerated].Key, nullptr);
+        }
+        Enumerated++;
+    }
+    CxPlatHashtableEnumerateEnd(Table.Raw, &Enumerator);
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        ASSERT_FALSE(Entries[i].Inserted);
+        ASSERT_EQ(Entries[i].Key % 2 == 0 ? 0u : 1u, Table.Count(Entries[i].Key));
+        ASSERT_EQ(1u, Table.Count(Extra[i].Key));
+    }
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        if (Entries[i].Key % 2 != 0) {
+            CxPlatHashtableRemove(Table.Raw, &Entries[i].Entry, nullptr);
+        }
+        CxPlatHashtableRemove(Table.Raw, &Extra[i].Entry, nullptr);
+    }
+    ASSERT_EQ(0u, Table.Raw->NumEntries);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    HashtableTest,
+    HashtableTest,
+    ::testing::Values(0u, (uint32_t)CXPLAT_HASH_OPEN_ADDRESSING));
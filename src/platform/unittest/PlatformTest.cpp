@@ -12,6 +12,7 @@ Abstract:
 #include "main.h"
 
 #include "msquic.h"
+#include <vector>
 #ifdef QUIC_CLOG
 #include "PlatformTest.cpp.clog.h"
 #endif
@@ -231,3 +232,174 @@ TEST(PlatformTest, EventQueueWorker)
 
     CxPlatEventQCleanup(&queue);
 }
+
+TEST(PlatformTest, PoolAllocFree)
+{
+    const uint32_t EntryCount = 1000;
+    void* Entries[EntryCount];
+
+    struct PoolContext {
+        CXPLAT_POOL* Pool;
+        void** Entries;
+        uint32_t Count;
+        uint32_t Size;
+        static CXPLAT_THREAD_CALLBACK(FreeEntries, Context) {
+            auto ctx = (PoolContext*)Context;
+            for (uint32_t i = 0; i < ctx->Count; ++i) {
+                CxPlatPoolFree(ctx->Entries[i]);
+            }
+            CXPLAT_THREAD_RETURN(0);
+        }
+        static CXPLAT_THREAD_CALLBACK(AllocFreeEntries, Context) {
+            auto ctx = (PoolContext*)Context;
+            for (uint32_t i = 0; i < ctx->Count; ++i) {
+                ctx->Entries[i] = CxPlatPoolAlloc(ctx->Pool);
+                if (ctx->Entries[i] != NULL) {
+                    CxPlatZeroMemory(ctx->Entries[i], ctx->Size);
+                }
+            }
+            for (uint32_t i = 0; i < ctx->Count; ++i) {
+                if (ctx->Entries[i] != NULL) {
+                    CxPlatPoolFree(ctx->Entries[i]);
+                }
+            }
+            CXPLAT_THREAD_RETURN(0);
+        }
+    };
+
+    CXPLAT_POOL Pool;
+    CxPlatPoolInitialize(FALSE, 64, QUIC_POOL_TEST, &Pool);
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        Entries[i] = CxPlatPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+        CxPlatZeroMemory(Entries[i], 64);
+    }
+
+    //
+    // Free half of the entries on this thread, and half on another one.
+    //
+    for (uint32_t i = 0; i < EntryCount / 2; ++i) {
+        CxPlatPoolFree(Entries[i]);
+    }
+    PoolContext Context = { &Pool, Entries + EntryCount / 2, EntryCount / 2, 64 };
+    CXPLAT_THREAD_CONFIG Config = { 0, 0, NULL, PoolContext::FreeEntries, &Context };
+    CXPLAT_THREAD Thread;
+    ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatThreadCreate(&Config, &Thread)));
+    CxPlatThreadWait(&Thread);
+    CxPlatThreadDelete(&Thread);
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        Entries[i] = CxPlatPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+    }
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        CxPlatPoolFree(Entries[i]);
+    }
+    CxPlatPoolUninitialize(&Pool);
+
+    //
+    // A new pool at the same address, with larger entries, used from another
+    // thread.
+    //
+    CxPlatPoolInitialize(FALSE, 256, QUIC_POOL_TEST, &Pool);
+    Context = { &Pool, Entries, EntryCount, 256 };
+    Config.Callback = PoolContext::AllocFreeEntries;
+    ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatThreadCreate(&Config, &Thread)));
+    CxPlatThreadWait(&Thread);
+    CxPlatThreadDelete(&Thread);
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        ASSERT_NE(nullptr, Entries[i]);
+    }
+    CxPlatPoolUninitialize(&Pool);
+}
+
+#ifndef _KERNEL_MODE
+TEST(PlatformTest, PoolPrune)
+{
+    const uint32_t EntryCount = 10000;
+    std::vector<void*> Entries(EntryCount);
+
+    //
+    // Small entries are carved from slabs, and large ones allocated one by
+    // one. Either way, pruning eventually runs out of unused memory to free,
+    // and the pool keeps working afterwards.
+    //
+    for (uint32_t Size : { 64u, 32 * 1024u }) {
+        CXPLAT_POOL Pool;
+        CxPlatPoolInitialize(FALSE, Size, QUIC_POOL_TEST, &Pool);
+        for (uint32_t Round = 0; Round < 2; ++Round) {
+            for (uint32_t i = 0; i < EntryCount; ++i) {
+                Entries[i] = CxPlatPoolAlloc(&Pool);
+                ASSERT_NE(nullptr, Entries[i]);
+                CxPlatZeroMemory(Entries[i], Size);
+            }
+            for (uint32_t i = 0; i < EntryCount; ++i) {
+                CxPlatPoolFree(Entries[EntryCount - 1 - i]);
+            }
+            uint32_t Pruned = 0;
+            while (CxPlatPoolPrune(&Pool)) {
+                ASSERT_LT(++Pruned, EntryCount);
+            }
+        }
+        CxPlatPoolUninitialize(&Pool);
+    }
+}
+#endif
+
+#ifndef _KERNEL_MODE
+TEST(PlatformTest, PoolReserve)
+{
+    const uint32_t EntryCount = 1000;
+    std::vector<void*> Entries(EntryCount);
+
+    for (uint32_t Size : { 64u, 32 * 1024u }) {
+        CXPLAT_POOL Pool;
+        CxPlatPoolInitialize(FALSE, Size, QUIC_POOL_TEST, &Pool);
+        ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatPoolReserve(&Pool, EntryCount, 0)));
+#ifndef _WIN32
+        if (Pool.SlabEntryCount != 0) {
+            ASSERT_GE(Pool.SlabFreeCount, EntryCount);
+        } else {
+            ASSERT_EQ((uint32_t)CXPLAT_MIN(EntryCount, CXPLAT_POOL_MAXIMUM_DEPTH), Pool.ListDepth);
+        }
+#endif
+        //
+        // Reserving again, or less, is a no-op.
+        //
+        ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatPoolReserve(&Pool, EntryCount / 2, 0)));
+        for (uint32_t i = 0; i < EntryCount; ++i) {
+            Entries[i] = CxPlatPoolAlloc(&Pool);
+            ASSERT_NE(nullptr, Entries[i]);
+            CxPlatZeroMemory(Entries[i], Size);
+        }
+        for (uint32_t i = 0; i < EntryCount; ++i) {
+            CxPlatPoolFree(Entries[i]);
+        }
+        CxPlatPoolUninitialize(&Pool);
+    }
+}
+#endif
+
+#if !defined(_WIN32) && !defined(_KERNEL_MODE)
+TEST(PlatformTest, PoolHugePages)
+{
+    const uint32_t EntryCount = 10000;
+    const uint32_t Size = 1500;
+    std::vector<void*> Entries(EntryCount);
+
+    CXPLAT_POOL Pool;
+    CxPlatPoolInitializeHugePages(Size, QUIC_POOL_TEST, &Pool);
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        Entries[i] = CxPlatPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+        CxPlatZeroMemory(Entries[i], Size);
+    }
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        CxPlatPoolFree(Entries[i]);
+    }
+    while (CxPlatPoolPrune(&Pool)) {
+    }
+    CxPlatPoolUninitialize(&Pool);
+}
+#endif
@@ -169,3 +169,28 @@ TEST_F(ToeplitzTest, IPv6WithTcp)
             QUIC_ADDRESS_FAMILY_INET6);
     }
 }
+
+TEST_F(ToeplitzTest, ClmulMatchesLookupTables)
+{
+    CXPLAT_TOEPLITZ_HASH ToeplitzHash{};
+    for (uint32_t i = 0; i < 1000; i++) {
+        ToeplitzHash.InputSize =
+            (i % 2 == 0) ? CXPLAT_TOEPLITZ_INPUT_SIZE_IP : CXPLAT_TOEPLITZ_INPUT_SIZE_QUIC;
+        CxPlatRandom(sizeof(ToeplitzHash.HashKey), ToeplitzHash.HashKey);
+        CxPlatToeplitzHashInitialize(&ToeplitzHash);
+        if (!ToeplitzHash.UseClmul) {
+            GTEST_SKIP() << "Carry-less multiplication not supported";
+        }
+
+        uint8_t Input[CXPLAT_TOEPLITZ_INPUT_SIZE_MAX];
+        CxPlatRandom(sizeof(Input), Input);
+        uint32_t Offset = 0;
+        CxPlatRandom(sizeof(Offset), &Offset);
+        Offset %= (uint32_t)ToeplitzHash.InputSize;
+        const uint32_t Length = (uint32_t)ToeplitzHash.InputSize - Offset;
+
+        const uint32_t Hash = CxPlatToeplitzHashCompute(&ToeplitzHash, Input, Length, Offset);
+        ToeplitzHash.UseClmul = FALSE;
+        ASSERT_EQ(Hash, CxPlatToeplitzHashCompute(&ToeplitzHash, Input, Length, Offset));
+    }
+}
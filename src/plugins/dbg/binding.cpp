@@ -71,14 +71,14 @@ EXT_COMMAND(
             Conn.TypeStr());
     } else {
         for (UCHAR i = 0; i < PartitionCount; i++) {
-            HashTable Hash(Lookup.GetLookupTable(i).GetTablePtr());
-            Dml("\t<link cmd=\"dt msquic!CXPLAT_HASHTABLE 0x%I64X\">Hash Table %d</link> (%u entries)\n",
+            LookupHashTable Hash = Lookup.GetLookupTable(i);
+            Dml("\t<link cmd=\"dt msquic!QUIC_PARTITIONED_HASHTABLE 0x%I64X\">Hash Table %d</link> (%u entries)\n",
                 Hash.Addr,
                 i,
-                Hash.NumEntries());
+                Hash.EntryCount());
             ULONG64 EntryPtr;
             while (!CheckControlC() && Hash.GetNextEntry(&EntryPtr)) {
-                CidHashEntry Entry = CidHashEntry::FromEntry(EntryPtr);
+                CidHashEntry Entry(EntryPtr);
                 Cid Cid(Entry.GetCid());
                 Connection Conn(Entry.GetConnection());
                 Dml("\t  <link cmd=\"!quicconnection 0x%I64X\">Connection 0x%I64X</link> [%s] [%s]\n",
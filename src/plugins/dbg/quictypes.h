@@ -80,6 +80,8 @@ typedef union QUIC_STREAM_FLAGS {
         BOOLEAN InStreamTable           : 1;    // The stream is currently in the connection's table.
         BOOLEAN InWaitingList           : 1;    // The stream is currently in the waiting list for stream id FC.
         BOOLEAN DelayIdFcUpdate         : 1;    // Delay stream ID FC updates to StreamClose.
+        BOOLEAN SendIncremental         : 1;    // Send data is interleaved with streams of the same urgency.
+        BOOLEAN SendFileFailed          : 1;    // A file backed send couldn't be read; sending is aborted.
     };
 } QUIC_STREAM_FLAGS;
 
@@ -198,6 +200,18 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN UseRoundRobinStreamScheduling : 1;
 
+        //
+        // Indicates the connection is using the RFC 9218 extensible priority
+        // stream scheduling scheme.
+        //
+        BOOLEAN UseExtensibleStreamScheduling : 1;
+
+        //
+        // Indicates the connection is using the weighted (deficit round robin)
+        // stream scheduling scheme.
+        //
+        BOOLEAN UseWeightedStreamScheduling : 1;
+
         //
         // Indicates that this connection has resumption enabled and needs to
         // keep the TLS state and transport parameters until it is done sending
@@ -320,6 +334,7 @@ struct LinkedList : ListEntry {
 
 #define KDEXT_RTL_HT_SECOND_LEVEL_DIR_SHIFT      7
 #define KDEXT_RTL_HT_SECOND_LEVEL_DIR_SIZE   (1 << KDEXT_RTL_HT_SECOND_LEVEL_DIR_SHIFT)
+#define KDEXT_CXPLAT_HASH_OPEN_ADDRESSING    0x00000002
 
 static
 void
@@ -351,9 +366,14 @@ struct HashTable : Struct {
     ULONG64 BucketHead;
     ULONG64 Entry;
 
+    bool OpenAddressing;
+    bool InOverflow;
+
     HashTable(ULONG64 addr) : Struct("msquic!CXPLAT_HASHTABLE", addr) {
         TableSize = ReadType<ULONG>("TableSize");
         Directory = ReadPointer("Directory");
+        OpenAddressing = (ReadType<ULONG>("Flags") & KDEXT_CXPLAT_HASH_OPEN_ADDRESSING) != 0;
+        InOverflow = false;
         GetFieldOffset("msquic!CXPLAT_HASHTABLE_ENTRY", "Linkage", &EntryLinksOffset);
         Indirection = (TableSize <= KDEXT_RTL_HT_SECOND_LEVEL_DIR_SIZE) ? 1 : 2;
 
@@ -369,6 +389,10 @@ struct HashTable : Struct {
     }
 
     bool GetNextEntry(ULONG64* EntryAddress) {
+        if (OpenAddressing) {
+            return GetNextOpenEntry(EntryAddress);
+        }
+
         for (Bucket; Bucket < TableSize; Bucket++) {
 
             if (ReadBucketHead) {
@@ -411,6 +435,48 @@ struct HashTable : Struct {
 
         return false;
     }
+
+    //
+    // Open addressing tables have a flat array of entry pointers (the
+    // "Directory"), NULL for free slots, and an overflow list.
+    //
+    bool GetNextOpenEntry(ULONG64* EntryAddress) {
+        while (!InOverflow && Bucket < TableSize) {
+            if (!ReadPointerAtAddr(
+                    Directory + Bucket * g_ExtInstance.m_PtrSize,
+                    &Entry)) {
+                dprintf("Failed to read slot %u\n", Bucket);
+                return false;
+            }
+            Bucket++;
+            if (Entry != 0) {
+                *EntryAddress = Entry;
+                return true;
+            }
+        }
+
+        if (!InOverflow) {
+            InOverflow = true;
+            BucketHead = AddrOf("Overflow");
+            Entry = BucketHead;
+        }
+
+        if (!ReadPointerFromStructAddr(
+                Entry,
+                "msquic!CXPLAT_LIST_ENTRY",
+                "Flink",
+                &Entry)) {
+            dprintf("Failed to walk overflow list at %p\n", BucketHead);
+            return false;
+        }
+
+        if (IsEqualPointer(Entry, BucketHead)) {
+            return false;
+        }
+
+        *EntryAddress = Entry - EntryLinksOffset;
+        return true;
+    }
 };
 
 // End of magic
@@ -463,10 +529,6 @@ struct CidHashEntry : Struct {
 
     CidHashEntry(ULONG64 Addr) : Struct("msquic!QUIC_CID_HASH_ENTRY", Addr) { }
 
-    static CidHashEntry FromEntry(ULONG64 EntryAddr) {
-        return CidHashEntry(LinkEntryToType(EntryAddr, "msquic!QUIC_CID_HASH_ENTRY", "Entry"));
-    }
-
     static CidHashEntry FromLink(ULONG64 LinkAddr) {
         return CidHashEntry(LinkEntryToType(LinkAddr, "msquic!QUIC_CID_HASH_ENTRY", "Link"));
     }
@@ -571,8 +633,10 @@ typedef enum QUIC_RECV_BUF_MODE {
     QUIC_RECV_BUF_MODE_SINGLE,      // Only one receive with a single contiguous buffer at a time.
     QUIC_RECV_BUF_MODE_CIRCULAR,    // Only one receive that may indicate two contiguous buffers at a time.
     QUIC_RECV_BUF_MODE_MULTIPLE,    // Multiple independent receives that may indicate up to two contiguous buffers at a time.
-    QUIC_RECV_BUF_MODE_APP_OWNED    // Uses memory buffers provided by the app. Only one receive at a time,
+    QUIC_RECV_BUF_MODE_APP_OWNED,   // Uses memory buffers provided by the app. Only one receive at a time,
                                     //   that may indicate up to the number of provided buffers.
+    QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE // Uses memory buffers provided by the app. Multiple independent
+                                    //   receives that may indicate up to the number of provided buffers.
 } QUIC_RECV_BUF_MODE;
 
 struct RecvBuffer : Struct {
@@ -592,6 +656,8 @@ struct RecvBuffer : Struct {
             return "Multiple";
         case QUIC_RECV_BUF_MODE_APP_OWNED:
             return "App Owned";
+        case QUIC_RECV_BUF_MODE_APP_OWNED_MULTIPLE:
+            return "App Owned Multiple";
         default:
             return "Unknown";
         }
@@ -1376,6 +1442,54 @@ struct CxPlatExecutionContext : Struct {
     }
 };
 
+#define QUIC_WORKER_FLIGHT_RECORDER_SIZE 512
+
+struct FlightRecord : Struct {
+
+    FlightRecord(ULONG64 Addr) : Struct("msquic!QUIC_FLIGHT_RECORD", Addr) { }
+
+    ULONG64 TimeUs() {
+        return ReadType<ULONG64>("TimeUs");
+    }
+
+    ULONG DurationUs() {
+        return ReadType<ULONG>("DurationUs");
+    }
+
+    USHORT Type() {
+        return ReadType<USHORT>("Type");
+    }
+
+    PSTR TypeStr() {
+        switch (Type()) {
+        case 1:  return "LOOP";
+        case 2:  return "CONNECTION";
+        case 3:  return "IDLE";
+        default: return "INVALID";
+        }
+    }
+
+    ULONG QueuedOperations() {
+        return ReadType<ULONG>("LOOP.QueuedOperations");
+    }
+
+    ULONG QueuedHandshakes() {
+        return ReadType<ULONG>("LOOP.QueuedHandshakes");
+    }
+
+    ULONG TimerConnections() {
+        return ReadType<ULONG>("LOOP.TimerConnections");
+    }
+
+    ULONG64 CorrelationId() {
+        return ReadType<ULONG64>("CONNECTION.CorrelationId");
+    }
+
+    ULONG QueueDelayUs() {
+        return ReadType<ULONG>("CONNECTION.QueueDelayUs");
+    }
+};
+
 struct Worker : Struct {
 
     Worker(ULONG64 Addr) : Struct("msquic!QUIC_WORKER", Addr) { }
@@ -1423,6 +1537,16 @@ struct Worker : Struct {
     LinkedList GetOperations() {
         return LinkedList(AddrOf("Operations"));
     }
+
+    ULONG FlightRecorderNext() {
+        return ReadType<ULONG>("FlightRecorder.Next");
+    }
+
+    FlightRecord GetFlightRecord(ULONG Index) {
+        ULONG64 ArrayAddr = AddrOf("FlightRecorder.Records");
+        ULONG TypeSize = GetTypeSize("msquic!QUIC_FLIGHT_RECORD");
+        return FlightRecord(ArrayAddr + (Index % QUIC_WORKER_FLIGHT_RECORDER_SIZE) * TypeSize);
+    }
 };
 
 struct WorkerPool : Struct {
@@ -1528,10 +1652,40 @@ struct Registration : Struct {
 
 struct LookupHashTable : Struct {
 
-    LookupHashTable(ULONG64 Addr) : Struct("msquic!QUIC_PARTITIONED_HASHTABLE", Addr) { }
+    ULONG64 Slots;
+    ULONG SlotCount;
+    ULONG Index;
+
+    LookupHashTable(ULONG64 Addr) : Struct("msquic!QUIC_PARTITIONED_HASHTABLE", Addr) {
+        Slots = ReadPointer("Slots");
+        ULONG Mask = 0;
+        ReadTypeAtAddr(Slots, &Mask);
+        SlotCount = Mask + 1;
+        Index = 0;
+    }
 
-    ULONG64 GetTablePtr() {
-        return AddrOf("Table"); // TODO - Need Hash Table Enumeration.
+    ULONG EntryCount() {
+        return ReadType<ULONG>("EntryCount");
+    }
+
+    //
+    // Returns the next CID hash entry in the slot array, skipping empty slots
+    // and tombstones.
+    //
+    bool GetNextEntry(ULONG64* EntryAddress) {
+        ULONG EntriesOffset;
+        GetFieldOffset("msquic!QUIC_CID_SLOTS", "Entries", &EntriesOffset);
+        while (Index < SlotCount) {
+            ULONG64 Entry;
+            ReadPointerAtAddr(
+                Slots + EntriesOffset + (ULONG64)Index++ * g_ExtInstance.m_PtrSize,
+                &Entry);
+            if (Entry > 1) {
+                *EntryAddress = Entry;
+                return true;
+            }
+        }
+        return false;
     }
 };
 
@@ -1552,11 +1706,11 @@ struct Lookup : Struct {
     }
 
     ULONG64 GetLookupPtr() {
-        return ReadPointer("LookupTable");
+        return ReadPointer("SINGLE.Connection");
     }
 
     LookupHashTable GetLookupTable(UCHAR Index) {
-        ULONG64 ArrayAddr = ReadPointer("LookupTable");
+        ULONG64 ArrayAddr = ReadPointer("HASH.Tables");
         ULONG TypeSize = GetTypeSize("msquic!QUIC_PARTITIONED_HASHTABLE");
         return LookupHashTable(ArrayAddr + Index * TypeSize);
     }
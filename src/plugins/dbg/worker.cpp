@@ -66,5 +66,34 @@ EXT_COMMAND(
         Dml("\tNo Work\n");
     }
 
+    Dml("\n<u>FLIGHT RECORDER</u> (newest first)\n"
+        "\n");
+
+    ULONG Next = Work.FlightRecorderNext();
+    ULONG Count = min(Next, (ULONG)QUIC_WORKER_FLIGHT_RECORDER_SIZE);
+    for (ULONG i = 1; i <= Count; ++i) {
+        FlightRecord Record = Work.GetFlightRecord(Next - i);
+        if (Record.Type() == 2) {
+            Dml("\t%I64u us  %-10s %6u us  Conn=%I64u QueueDelay=%u us\n",
+                Record.TimeUs(),
+                Record.TypeStr(),
+                Record.DurationUs(),
+                Record.CorrelationId(),
+                Record.QueueDelayUs());
+        } else {
+            Dml("\t%I64u us  %-10s %6u us  Ops=%u Handshakes=%u Timers=%u\n",
+                Record.TimeUs(),
+                Record.TypeStr(),
+                Record.DurationUs(),
+                Record.QueuedOperations(),
+                Record.QueuedHandshakes(),
+                Record.TimerConnections());
+        }
+    }
+
+    if (Count == 0) {
+        Dml("\tEmpty\n");
+    }
+
     Dml("\n");
 }
@@ -0,0 +1,746 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+//! Runtime agnostic async wrappers over the callback based handles.
+//!
+//! Each wrapper installs its own callback handler, which records the event in
+//! state shared with the futures and wakes the [Waker] of the task waiting on
+//! it, if any. There are no channels and no per-event allocations, and any
+//! executor can drive the futures.
+//!
+//! Received data is not copied: [AsyncStream::recv] hands out the buffers
+//! MsQuic indicated, and the receive is only completed (via
+//! `StreamReceiveComplete`) when the returned [RecvBuffers] is dropped.
+
+use crate::ffi::QUIC_BUFFER;
+use crate::{
+    BufferRef, Configuration, Connection, ConnectionEvent, ConnectionShutdownFlags, Listener,
+    ListenerEvent, Registration, SendFlags, Status, StatusCode, Stream, StreamEvent,
+    StreamOpenFlags, StreamShutdownFlags, StreamStartFlags,
+};
+use libc::c_void;
+use std::collections::VecDeque;
+use std::future::Future;
+use std::pin::Pin;
+use std::sync::{Arc, Mutex};
+use std::task::{Context, Poll, Waker};
+
+/// Registers the task's waker, unless it is already registered.
+fn register_waker(slot: &mut Option<Waker>, cx: &Context<'_>) {
+    match slot {
+        Some(waker) if waker.will_wake(cx.waker()) => {}
+        _ => *slot = Some(cx.waker().clone()),
+    }
+}
+
+fn wake(waker: Option<Waker>) {
+    if let Some(waker) = waker {
+        waker.wake();
+    }
+}
+
+fn aborted() -> Status {
+    Status::new(StatusCode::QUIC_STATUS_ABORTED)
+}
+
+struct ListenerState {
+    backlog: VecDeque<AsyncConnection>,
+    accept_waker: Option<Waker>,
+    stopped: bool,
+}
+
+/// A listener whose new connections are accepted with [AsyncListener::accept].
+pub struct AsyncListener {
+    // Declared first so the listener is closed before the backlog is dropped.
+    listener: Listener,
+    state: Arc<Mutex<ListenerState>>,
+}
+
+impl AsyncListener {
+    /// Opens a listener that accepts connections with the given configuration.
+    pub fn open(
+        registration: &Registration,
+        configuration: Arc<Configuration>,
+    ) -> Result<Self, Status> {
+        let state = Arc::new(Mutex::new(ListenerState {
+            backlog: VecDeque::new(),
+            accept_waker: None,
+            stopped: true,
+        }));
+        let handler_state = state.clone();
+        let listener = Listener::open(registration, move |_, ev| {
+            let waker = match ev {
+                ListenerEvent::NewConnection {
+                    info: _,
+                    connection,
+                } => {
+                    // The handler must be set before the configuration, which
+                    // lets the handshake (and its events) proceed.
+                    let connection = AsyncConnection::from_connection(connection);
+                    if let Err(e) = connection.connection.set_configuration(&configuration) {
+                        // MsQuic cleans up a rejected connection without
+                        // indicating any more events, so just release it.
+                        let AsyncConnection { connection, .. } = connection;
+                        connection.consume_callback_ctx();
+                        let _ = unsafe { connection.into_raw() };
+                        return Err(e);
+                    }
+                    let mut state = handler_state.lock().unwrap();
+                    state.backlog.push_back(connection);
+                    state.accept_waker.take()
+                }
+                ListenerEvent::StopComplete { .. } => {
+                    let mut state = handler_state.lock().unwrap();
+                    state.stopped = true;
+                    state.accept_waker.take()
+                }
+            };
+            wake(waker);
+            Ok(())
+        })?;
+        Ok(Self { listener, state })
+    }
+
+    pub fn start(
+        &self,
+        alpn: &[BufferRef],
+        local_address: Option<&crate::Addr>,
+    ) -> Result<(), Status> {
+        self.state.lock().unwrap().stopped = false;
+        self.listener.start(alpn, local_address)
+    }
+
+    pub fn stop(&self) {
+        self.listener.stop();
+    }
+
+    /// Resolves to the next new connection, which may still be handshaking,
+    /// or to `None` once the listener has stopped.
+    pub fn accept(&self) -> Accept<'_> {
+        Accept { listener: self }
+    }
+
+    /// The underlying listener, for the rest of its API.
+    pub fn listener(&self) -> &Listener {
+        &self.listener
+    }
+}
+
+pub struct Accept<'a> {
+    listener: &'a AsyncListener,
+}
+
+impl Future for Accept<'_> {
+    type Output = Option<AsyncConnection>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.listener.state.lock().unwrap();
+        if let Some(connection) = state.backlog.pop_front() {
+            return Poll::Ready(Some(connection));
+        }
+        if state.stopped {
+            return Poll::Ready(None);
+        }
+        register_waker(&mut state.accept_waker, cx);
+        Poll::Pending
+    }
+}
+
+#[derive(Default)]
+struct ConnectionState {
+    handshake: Option<Result<(), Status>>,
+    handshake_waker: Option<Waker>,
+    peer_streams: VecDeque<AsyncStream>,
+    stream_waker: Option<Waker>,
+    shutdown_complete: bool,
+    shutdown_waker: Option<Waker>,
+}
+
+impl ConnectionState {
+    fn set_handshake(&mut self, result: Result<(), Status>) -> Option<Waker> {
+        if self.handshake.is_none() {
+            self.handshake = Some(result);
+        }
+        self.handshake_waker.take()
+    }
+}
+
+/// A connection whose handshake, streams and shutdown can be awaited.
+/// Dropping it closes the connection.
+pub struct AsyncConnection {
+    connection: Connection,
+    state: Arc<Mutex<ConnectionState>>,
+}
+
+impl AsyncConnection {
+    /// Opens a client connection.
+    pub fn open(registration: &Registration) -> Result<Self, Status> {
+        let state = Arc::new(Mutex::new(ConnectionState::default()));
+        let connection = Connection::open(registration, Self::handler(state.clone()))?;
+        Ok(Self { connection, state })
+    }
+
+    /// Takes over a connection indicated by a listener.
+    fn from_connection(connection: Connection) -> Self {
+        let state = Arc::new(Mutex::new(ConnectionState::default()));
+        connection.set_callback_handler(Self::handler(state.clone()));
+        Self { connection, state }
+    }
+
+    fn handler(
+        state: Arc<Mutex<ConnectionState>>,
+    ) -> impl FnMut(crate::ConnectionRef, ConnectionEvent) -> Result<(), Status> + 'static {
+        move |_, ev| {
+            let mut wakers: [Option<Waker>; 3] = [None, None, None];
+            {
+                let mut state = state.lock().unwrap();
+                match ev {
+                    ConnectionEvent::Connected { .. } => {
+                        wakers[0] = state.set_handshake(Ok(()));
+                    }
+                    ConnectionEvent::ShutdownInitiatedByTransport { status, .. } => {
+                        wakers[0] = state.set_handshake(Err(status));
+                    }
+                    ConnectionEvent::ShutdownInitiatedByPeer { .. } => {
+                        wakers[0] = state.set_handshake(Err(aborted()));
+                    }
+                    ConnectionEvent::PeerStreamStarted { stream, flags: _ } => {
+                        // The stream callback handler must be set before returning.
+                        let stream =
+                            AsyncStream::from_stream(unsafe { Stream::from_raw(stream.as_raw()) });
+                        state.peer_streams.push_back(stream);
+                        wakers[0] = state.stream_waker.take();
+                    }
+                    ConnectionEvent::ShutdownComplete { .. } => {
+                        state.shutdown_complete = true;
+                        wakers[0] = state.set_handshake(Err(aborted()));
+                        wakers[1] = state.stream_waker.take();
+                        wakers[2] = state.shutdown_waker.take();
+                    }
+                    _ => {}
+                }
+            }
+            wakers.into_iter().for_each(wake);
+            Ok(())
+        }
+    }
+
+    pub fn start(
+        &self,
+        configuration: &Configuration,
+        server_name: &str,
+        server_port: u16,
+    ) -> Result<(), Status> {
+        self.connection
+            .start(configuration, server_name, server_port)
+    }
+
+    pub fn shutdown(&self, flags: ConnectionShutdownFlags, error_code: crate::u62) {
+        self.connection.shutdown(flags, error_code);
+    }
+
+    /// Resolves once the handshake completes, or with the reason the
+    /// connection shut down before it could.
+    pub fn connected(&self) -> Connected<'_> {
+        Connected { connection: self }
+    }
+
+    /// Opens and starts a local stream. Resolves once the start completes.
+    pub fn open_stream(&self, flags: StreamOpenFlags) -> OpenStream {
+        OpenStream {
+            stream: AsyncStream::open(&self.connection, flags).map(Some),
+            started: false,
+        }
+    }
+
+    /// Resolves to the next stream started by the peer, or to `None` once the
+    /// connection has shut down.
+    pub fn accept_stream(&self) -> AcceptStream<'_> {
+        AcceptStream { connection: self }
+    }
+
+    /// Resolves once the connection has completely shut down.
+    pub fn shutdown_complete(&self) -> ConnectionShutdownComplete<'_> {
+        ConnectionShutdownComplete { connection: self }
+    }
+
+    /// The underlying connection, for the rest of its API.
+    pub fn connection(&self) -> &Connection {
+        &self.connection
+    }
+}
+
+pub struct Connected<'a> {
+    connection: &'a AsyncConnection,
+}
+
+impl Future for Connected<'_> {
+    type Output = Result<(), Status>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.connection.state.lock().unwrap();
+        if let Some(result) = &state.handshake {
+            return Poll::Ready(result.clone());
+        }
+        register_waker(&mut state.handshake_waker, cx);
+        Poll::Pending
+    }
+}
+
+pub struct OpenStream {
+    stream: Result<Option<AsyncStream>, Status>,
+    started: bool,
+}
+
+impl Future for OpenStream {
+    type Output = Result<AsyncStream, Status>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let this = self.get_mut();
+        let stream = match &mut this.stream {
+            Ok(Some(stream)) => stream,
+            Ok(None) => panic!("OpenStream polled after completion"),
+            Err(e) => return Poll::Ready(Err(e.clone())),
+        };
+        {
+            let mut state = stream.state.lock().unwrap();
+            match &state.start {
+                Some(Ok(())) => {}
+                Some(Err(e)) => return Poll::Ready(Err(e.clone())),
+                None => {
+                    register_waker(&mut state.start_waker, cx);
+                    if this.started {
+                        return Poll::Pending;
+                    }
+                }
+            }
+        }
+        if !this.started {
+            // The waker is registered before starting, so the completion
+            // can't be missed.
+            this.started = true;
+            // With SHUTDOWN_ON_FAIL, a failed start still completes the
+            // shutdown, so the stream can be closed from any thread.
+            if let Err(e) = stream
+                .stream
+                .start(StreamStartFlags::NONE | StreamStartFlags::SHUTDOWN_ON_FAIL)
+            {
+                return Poll::Ready(Err(e));
+            }
+            return Poll::Pending;
+        }
+        Poll::Ready(Ok(this.stream.as_mut().unwrap().take().unwrap()))
+    }
+}
+
+pub struct AcceptStream<'a> {
+    connection: &'a AsyncConnection,
+}
+
+impl Future for AcceptStream<'_> {
+    type Output = Option<AsyncStream>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.connection.state.lock().unwrap();
+        if let Some(stream) = state.peer_streams.pop_front() {
+            return Poll::Ready(Some(stream));
+        }
+        if state.shutdown_complete {
+            return Poll::Ready(None);
+        }
+        register_waker(&mut state.stream_waker, cx);
+        Poll::Pending
+    }
+}
+
+pub struct ConnectionShutdownComplete<'a> {
+    connection: &'a AsyncConnection,
+}
+
+impl Future for ConnectionShutdownComplete<'_> {
+    type Output = ();
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.connection.state.lock().unwrap();
+        if state.shutdown_complete {
+            return Poll::Ready(());
+        }
+        register_waker(&mut state.shutdown_waker, cx);
+        Poll::Pending
+    }
+}
+
+/// An in flight send. The data and its descriptor are owned by the stream
+/// until MsQuic is done with them, so dropping a [StreamSendFuture] early is safe.
+struct SendSlot {
+    data: Vec<u8>,
+    buffer: QUIC_BUFFER,
+    result: Option<Result<(), Status>>,
+    waker: Option<Waker>,
+    abandoned: bool,
+}
+
+struct Indication {
+    total_length: u64,
+    fin: bool,
+}
+
+struct StreamState {
+    start: Option<Result<(), Status>>,
+    start_waker: Option<Waker>,
+    // MsQuic's QUIC_BUFFER array is only valid during the RECEIVE callback,
+    // so the descriptors (not the data) are copied here. The vector is lent
+    // to RecvBuffers while the receive is outstanding and then given back.
+    buffers: Vec<QUIC_BUFFER>,
+    indication: Option<Indication>,
+    peer_send: Option<Result<(), Status>>,
+    recv_waker: Option<Waker>,
+    // Boxed so the QUIC_BUFFER passed to MsQuic doesn't move. Completed slots
+    // are reused, so steady state sends don't allocate.
+    #[allow(clippy::vec_box)]
+    sends: Vec<Box<SendSlot>>,
+    free_sends: Vec<usize>,
+    shutdown_complete: bool,
+    shutdown_waker: Option<Waker>,
+}
+
+// The raw pointers only refer to MsQuic's receive buffers, which stay valid
+// until the receive is completed, and to the send slots' own data.
+unsafe impl Send for StreamState {}
+
+impl StreamState {
+    fn new(started: bool) -> Self {
+        Self {
+            start: if started { Some(Ok(())) } else { None },
+            start_waker: None,
+            buffers: Vec::new(),
+            indication: None,
+            peer_send: None,
+            recv_waker: None,
+            sends: Vec::new(),
+            free_sends: Vec::new(),
+            shutdown_complete: false,
+            shutdown_waker: None,
+        }
+    }
+
+    fn finish_receive(&mut self, result: Result<(), Status>) -> Option<Waker> {
+        if self.peer_send.is_none() {
+            self.peer_send = Some(result);
+        }
+        self.recv_waker.take()
+    }
+
+    fn complete_send(&mut self, index: usize, result: Result<(), Status>) -> Option<Waker> {
+        let slot = &mut self.sends[index];
+        if slot.abandoned {
+            slot.abandoned = false;
+            slot.data = Vec::new();
+            self.free_sends.push(index);
+            return None;
+        }
+        slot.result = Some(result);
+        slot.waker.take()
+    }
+}
+
+/// A stream with awaitable sends and zero copy receives. Dropping it closes
+/// the stream, aborting it if it hasn't shut down yet; await
+/// [AsyncStream::shutdown_complete] first for a graceful close.
+pub struct AsyncStream {
+    stream: Stream,
+    state: Arc<Mutex<StreamState>>,
+}
+
+impl AsyncStream {
+    fn open(connection: &Connection, flags: StreamOpenFlags) -> Result<Self, Status> {
+        let state = Arc::new(Mutex::new(StreamState::new(false)));
+        let stream = Stream::open(connection, flags, Self::handler(state.clone()))?;
+        Ok(Self { stream, state })
+    }
+
+    /// Takes over a stream started by the peer.
+    fn from_stream(stream: Stream) -> Self {
+        let state = Arc::new(Mutex::new(StreamState::new(true)));
+        stream.set_callback_handler(Self::handler(state.clone()));
+        Self { stream, state }
+    }
+
+    fn handler(
+        state: Arc<Mutex<StreamState>>,
+    ) -> impl FnMut(crate::StreamRef, StreamEvent) -> Result<(), Status> + 'static {
+        move |_, ev| {
+            let mut wakers: [Option<Waker>; 2] = [None, None];
+            let mut result = Ok(());
+            {
+                let mut state = state.lock().unwrap();
+                match ev {
+                    StreamEvent::StartComplete { status, .. } => {
+                        state.start = Some(Status::ok_from_raw(status.0));
+                        wakers[0] = state.start_waker.take();
+                    }
+                    StreamEvent::Receive {
+                        total_buffer_length,
+                        buffers,
+                        flags,
+                        ..
+                    } => {
+                        // A FIN with no data is handled by PeerSendShutdown.
+                        if *total_buffer_length != 0 {
+                            state.buffers.clear();
+                            state.buffers.extend(buffers.iter().map(|b| b.0));
+                            state.indication = Some(Indication {
+                                total_length: *total_buffer_length,
+                                fin: flags.contains(crate::ReceiveFlags::FIN),
+                            });
+                            wakers[0] = state.recv_waker.take();
+                            // Completed by StreamReceiveComplete when the
+                            // RecvBuffers is dropped.
+                            result = Err(Status::new(StatusCode::QUIC_STATUS_PENDING));
+                        }
+                    }
+                    StreamEvent::SendComplete {
+                        cancelled,
+                        client_context,
+                    } => {
+                        let index = client_context as usize - 1;
+                        let result = if cancelled { Err(aborted()) } else { Ok(()) };
+                        wakers[0] = state.complete_send(index, result);
+                    }
+                    StreamEvent::PeerSendShutdown => {
+                        wakers[0] = state.finish_receive(Ok(()));
+                    }
+                    StreamEvent::PeerSendAborted { .. } => {
+                        wakers[0] = state.finish_receive(Err(aborted()));
+                    }
+                    StreamEvent::ShutdownComplete { .. } => {
+                        state.shutdown_complete = true;
+                        wakers[0] = state.finish_receive(Err(aborted()));
+                        wakers[1] = state.shutdown_waker.take();
+                    }
+                    _ => {}
+                }
+            }
+            wakers.into_iter().for_each(wake);
+            result
+        }
+    }
+
+    /// Resolves to the next received data, to `Ok(None)` once the peer has
+    /// finished sending, or to an error if it aborted. The data is borrowed
+    /// from MsQuic until the returned [RecvBuffers] is dropped.
+    pub fn recv(&mut self) -> Recv<'_> {
+        Recv { stream: &*self }
+    }
+
+    /// Sends `data`, resolving once MsQuic no longer needs it. The data is
+    /// handed back so its allocation can be reused.
+    pub fn send(&self, data: Vec<u8>, flags: SendFlags) -> StreamSendFuture<'_> {
+        StreamSendFuture {
+            stream: self,
+            data: Some(data),
+            flags,
+            index: None,
+        }
+    }
+
+    pub fn shutdown(
+        &self,
+        flags: StreamShutdownFlags,
+        error_code: crate::u62,
+    ) -> Result<(), Status> {
+        self.stream.shutdown(flags, error_code)
+    }
+
+    /// Resolves once the stream has completely shut down.
+    pub fn shutdown_complete(&self) -> StreamShutdownComplete<'_> {
+        StreamShutdownComplete { stream: self }
+    }
+
+    /// The underlying stream, for the rest of its API.
+    pub fn stream(&self) -> &Stream {
+        &self.stream
+    }
+}
+
+/// Data received on an [AsyncStream]. Dropping it completes the receive,
+/// which lets MsQuic indicate more data and reuse the memory.
+pub struct RecvBuffers<'a> {
+    stream: &'a AsyncStream,
+    buffers: Vec<QUIC_BUFFER>,
+    total_length: u64,
+    fin: bool,
+}
+
+unsafe impl Send for RecvBuffers<'_> {}
+unsafe impl Sync for RecvBuffers<'_> {}
+
+impl RecvBuffers<'_> {
+    pub fn buffers(&self) -> &[BufferRef] {
+        BufferRef::slice_from_ffi_ref(&self.buffers)
+    }
+
+    pub fn total_length(&self) -> u64 {
+        self.total_length
+    }
+
+    /// True if this is the last data the peer will send.
+    pub fn is_fin(&self) -> bool {
+        self.fin
+    }
+}
+
+impl Drop for RecvBuffers<'_> {
+    fn drop(&mut self) {
+        // Hand the descriptor vector back before completing, as completing
+        // may trigger the next indication right away.
+        let buffers = std::mem::take(&mut self.buffers);
+        self.stream.state.lock().unwrap().buffers = buffers;
+        self.stream.stream.receive_complete(self.total_length);
+    }
+}
+
+pub struct Recv<'a> {
+    // Borrowed from a mutable borrow of the stream, so there is at most one
+    // outstanding RecvBuffers.
+    stream: &'a AsyncStream,
+}
+
+impl<'a> Future for Recv<'a> {
+    type Output = Result<Option<RecvBuffers<'a>>, Status>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let stream = self.stream;
+        let mut state = stream.state.lock().unwrap();
+        if let Some(indication) = state.indication.take() {
+            return Poll::Ready(Ok(Some(RecvBuffers {
+                stream,
+                buffers: std::mem::take(&mut state.buffers),
+                total_length: indication.total_length,
+                fin: indication.fin,
+            })));
+        }
+        match &state.peer_send {
+            Some(Ok(())) => Poll::Ready(Ok(None)),
+            Some(Err(e)) => Poll::Ready(Err(e.clone())),
+            None => {
+                register_waker(&mut state.recv_waker, cx);
+                Poll::Pending
+            }
+        }
+    }
+}
+
+pub struct StreamSendFuture<'a> {
+    stream: &'a AsyncStream,
+    data: Option<Vec<u8>>,
+    flags: SendFlags,
+    index: Option<usize>,
+}
+
+impl Future for StreamSendFuture<'_> {
+    type Output = (Result<(), Status>, Vec<u8>);
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let this = self.get_mut();
+        let mut state = this.stream.state.lock().unwrap();
+        if let Some(index) = this.index {
+            let slot = &mut state.sends[index];
+            return match slot.result.take() {
+                Some(result) => {
+                    let data = std::mem::take(&mut slot.data);
+                    state.free_sends.push(index);
+                    this.index = None;
+                    Poll::Ready((result, data))
+                }
+                None => {
+                    register_waker(&mut slot.waker, cx);
+                    Poll::Pending
+                }
+            };
+        }
+
+        let data = this
+            .data
+            .take()
+            .expect("StreamSendFuture polled after completion");
+        let index = match state.free_sends.pop() {
+            Some(index) => index,
+            None => {
+                state.sends.push(Box::new(SendSlot {
+                    data: Vec::new(),
+                    buffer: QUIC_BUFFER {
+                        Length: 0,
+                        Buffer: std::ptr::null_mut(),
+                    },
+                    result: None,
+                    waker: None,
+                    abandoned: false,
+                }));
+                state.sends.len() - 1
+            }
+        };
+        let slot = &mut state.sends[index];
+        slot.data = data;
+        slot.buffer = QUIC_BUFFER {
+            Length: slot.data.len() as u32,
+            Buffer: slot.data.as_mut_ptr(),
+        };
+        slot.result = None;
+        slot.waker = Some(cx.waker().clone());
+        let buffer = BufferRef::from_ffi_ref(&slot.buffer) as *const BufferRef;
+        drop(state);
+
+        // The slot is boxed, so the descriptor stays put until SendComplete.
+        let status = unsafe {
+            this.stream.stream.send(
+                std::slice::from_ref(&*buffer),
+                this.flags,
+                (index + 1) as *const c_void,
+            )
+        };
+        if let Err(e) = status {
+            let mut state = this.stream.state.lock().unwrap();
+            let data = std::mem::take(&mut state.sends[index].data);
+            state.free_sends.push(index);
+            return Poll::Ready((Err(e), data));
+        }
+        this.index = Some(index);
+        Poll::Pending
+    }
+}
+
+impl Drop for StreamSendFuture<'_> {
+    fn drop(&mut self) {
+        if let Some(index) = self.index {
+            let mut state = self.stream.state.lock().unwrap();
+            let slot = &mut state.sends[index];
+            if slot.result.is_some() {
+                slot.result = None;
+                slot.data = Vec::new();
+                state.free_sends.push(index);
+            } else {
+                // Still in flight; freed by SendComplete.
+                slot.abandoned = true;
+                slot.waker = None;
+            }
+        }
+    }
+}
+
+pub struct StreamShutdownComplete<'a> {
+    stream: &'a AsyncStream,
+}
+
+impl Future for StreamShutdownComplete<'_> {
+    type Output = ();
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.stream.state.lock().unwrap();
+        if state.shutdown_complete {
+            return Poll::Ready(());
+        }
+        register_waker(&mut state.shutdown_waker, cx);
+        Poll::Pending
+    }
+}
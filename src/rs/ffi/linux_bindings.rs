@@ -219,6 +219,8 @@ pub const QUIC_PARAM_STREAM_IDEAL_SEND_BUFFER_SIZE: u32 = 134217730;
 pub const QUIC_PARAM_STREAM_PRIORITY: u32 = 134217731;
 pub const QUIC_PARAM_STREAM_STATISTICS: u32 = 134217732;
 pub const QUIC_PARAM_STREAM_RELIABLE_OFFSET: u32 = 134217733;
+pub const QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY: u32 = 134217734;
+pub const QUIC_PARAM_STREAM_WEIGHT: u32 = 134217735;
 pub const QUIC_API_VERSION_1: u32 = 1;
 pub const QUIC_API_VERSION_2: u32 = 2;
 pub type BOOLEAN = ::std::os::raw::c_uchar;
@@ -235,6 +237,7 @@ const _: () = {
     ["Offset of field: QUIC_ADDR_STR::Address"]
         [::std::mem::offset_of!(QUIC_ADDR_STR, Address) - 0usize];
 };
+pub type QUIC_FILE_HANDLE = ::std::os::raw::c_int;
 pub type QUIC_EVENTQ = ::std::os::raw::c_int;
 pub type QUIC_CQE = epoll_event;
 pub type QUIC_EVENT_COMPLETION = ::std::option::Option<unsafe extern "C" fn(Cqe: *mut QUIC_CQE)>;
@@ -273,7 +276,9 @@ pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_DISABLED: QUIC_LOAD_BALAN
 pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_IP: QUIC_LOAD_BALANCING_MODE = 1;
 pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_FIXED: QUIC_LOAD_BALANCING_MODE =
     2;
-pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_COUNT: QUIC_LOAD_BALANCING_MODE = 3;
+pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_QUIC_LB:
+    QUIC_LOAD_BALANCING_MODE = 3;
+pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_COUNT: QUIC_LOAD_BALANCING_MODE = 4;
 pub type QUIC_LOAD_BALANCING_MODE = ::std::os::raw::c_uint;
 pub const QUIC_TLS_ALERT_CODES_QUIC_TLS_ALERT_CODE_SUCCESS: QUIC_TLS_ALERT_CODES = 65535;
 pub const QUIC_TLS_ALERT_CODES_QUIC_TLS_ALERT_CODE_UNEXPECTED_MESSAGE: QUIC_TLS_ALERT_CODES = 10;
@@ -376,8 +381,12 @@ pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_FIFO:
     QUIC_STREAM_SCHEDULING_SCHEME = 0;
 pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN:
     QUIC_STREAM_SCHEDULING_SCHEME = 1;
-pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_COUNT:
+pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE:
     QUIC_STREAM_SCHEDULING_SCHEME = 2;
+pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_WEIGHTED:
+    QUIC_STREAM_SCHEDULING_SCHEME = 3;
+pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_COUNT:
+    QUIC_STREAM_SCHEDULING_SCHEME = 4;
 pub type QUIC_STREAM_SCHEDULING_SCHEME = ::std::os::raw::c_uint;
 pub const QUIC_STREAM_OPEN_FLAGS_QUIC_STREAM_OPEN_FLAG_NONE: QUIC_STREAM_OPEN_FLAGS = 0;
 pub const QUIC_STREAM_OPEN_FLAGS_QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL: QUIC_STREAM_OPEN_FLAGS = 1;
@@ -424,6 +433,7 @@ pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_DELAY_SEND: QUIC_SEND_FLAGS = 16;
 pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_CANCEL_ON_LOSS: QUIC_SEND_FLAGS = 32;
 pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_PRIORITY_WORK: QUIC_SEND_FLAGS = 64;
 pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_CANCEL_ON_BLOCKED: QUIC_SEND_FLAGS = 128;
+pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_DGRAM_LOW_PRIORITY: QUIC_SEND_FLAGS = 256;
 pub type QUIC_SEND_FLAGS = ::std::os::raw::c_uint;
 pub const QUIC_DATAGRAM_SEND_STATE_QUIC_DATAGRAM_SEND_UNKNOWN: QUIC_DATAGRAM_SEND_STATE = 0;
 pub const QUIC_DATAGRAM_SEND_STATE_QUIC_DATAGRAM_SEND_SENT: QUIC_DATAGRAM_SEND_STATE = 1;
@@ -500,6 +510,14 @@ pub type QUIC_EXECUTION_DELETE_FN =
     ::std::option::Option<unsafe extern "C" fn(Count: u32, Executions: *mut *mut QUIC_EXECUTION)>;
 pub type QUIC_EXECUTION_POLL_FN =
     ::std::option::Option<unsafe extern "C" fn(Execution: *mut QUIC_EXECUTION) -> u32>;
+pub type QUIC_EXECUTION_POLL_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Count: u32,
+        Executions: *mut *mut QUIC_EXECUTION,
+        TimeBudgetUs: u32,
+        RunBudget: u32,
+    ) -> u32,
+>;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct QUIC_REGISTRATION_CONFIG {
@@ -1195,10 +1213,22 @@ pub struct QUIC_STATISTICS_V2 {
     pub SendEcnCongestionCount: u32,
     pub HandshakeHopLimitTTL: u8,
     pub RttVariance: u32,
+    pub SendDeliveryRate: u64,
+    pub ProcessingTime: u64,
+    pub SendBlockedBySchedulingUs: u64,
+    pub SendBlockedByPacingUs: u64,
+    pub SendBlockedByAmplificationProtUs: u64,
+    pub SendBlockedByCongestionControlUs: u64,
+    pub SendBlockedByConnFlowControlUs: u64,
+    pub SendBlockedByStreamFlowControlUs: u64,
+    pub SendBlockedByStreamIdFlowControlUs: u64,
+    pub SpinRttSampleCount: u64,
+    pub SpinRttLatestUs: u32,
+    pub SpinRttMinUs: u32,
 }
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_STATISTICS_V2"][::std::mem::size_of::<QUIC_STATISTICS_V2>() - 208usize];
+    ["Size of QUIC_STATISTICS_V2"][::std::mem::size_of::<QUIC_STATISTICS_V2>() - 296usize];
     ["Alignment of QUIC_STATISTICS_V2"][::std::mem::align_of::<QUIC_STATISTICS_V2>() - 8usize];
     ["Offset of field: QUIC_STATISTICS_V2::CorrelationId"]
         [::std::mem::offset_of!(QUIC_STATISTICS_V2, CorrelationId) - 0usize];
@@ -1266,6 +1296,30 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_STATISTICS_V2, HandshakeHopLimitTTL) - 200usize];
     ["Offset of field: QUIC_STATISTICS_V2::RttVariance"]
         [::std::mem::offset_of!(QUIC_STATISTICS_V2, RttVariance) - 204usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendDeliveryRate"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendDeliveryRate) - 208usize];
+    ["Offset of field: QUIC_STATISTICS_V2::ProcessingTime"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, ProcessingTime) - 216usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedBySchedulingUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedBySchedulingUs) - 224usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedByPacingUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedByPacingUs) - 232usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedByAmplificationProtUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedByAmplificationProtUs) - 240usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedByCongestionControlUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedByCongestionControlUs) - 248usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedByConnFlowControlUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedByConnFlowControlUs) - 256usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedByStreamFlowControlUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedByStreamFlowControlUs) - 264usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendBlockedByStreamIdFlowControlUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendBlockedByStreamIdFlowControlUs) - 272usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SpinRttSampleCount"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SpinRttSampleCount) - 280usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SpinRttLatestUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SpinRttLatestUs) - 288usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SpinRttMinUs"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SpinRttMinUs) - 292usize];
 };
 impl QUIC_STATISTICS_V2 {
     #[inline]
@@ -1683,7 +1737,21 @@ pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_CONN_LOAD_REJECT: QUIC_PER
     31;
 pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH:
     QUIC_PERFORMANCE_COUNTERS = 32;
-pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MAX: QUIC_PERFORMANCE_COUNTERS = 33;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_WORK_BUSY_TIME: QUIC_PERFORMANCE_COUNTERS =
+    33;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MEMORY_USAGE: QUIC_PERFORMANCE_COUNTERS =
+    34;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_CONN_HIBERNATING:
+    QUIC_PERFORMANCE_COUNTERS = 35;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_ZERORTT_REPLAY_REJECT:
+    QUIC_PERFORMANCE_COUNTERS = 36;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_XDP_BUSY_POLL_TIME:
+    QUIC_PERFORMANCE_COUNTERS = 37;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_XDP_SLEEP_TIME: QUIC_PERFORMANCE_COUNTERS =
+    38;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_XDP_INTERRUPT_TIME:
+    QUIC_PERFORMANCE_COUNTERS = 39;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MAX: QUIC_PERFORMANCE_COUNTERS = 40;
 pub type QUIC_PERFORMANCE_COUNTERS = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -3467,18 +3535,18 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         }
     }
     #[inline]
-    pub fn ReservedRioEnabled(&self) -> u64 {
+    pub fn RioEnabled(&self) -> u64 {
         unsafe { ::std::mem::transmute(self._bitfield_1.get(45usize, 1u8) as u64) }
     }
     #[inline]
-    pub fn set_ReservedRioEnabled(&mut self, val: u64) {
+    pub fn set_RioEnabled(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             self._bitfield_1.set(45usize, 1u8, val as u64)
         }
     }
     #[inline]
-    pub unsafe fn ReservedRioEnabled_raw(this: *const Self) -> u64 {
+    pub unsafe fn RioEnabled_raw(this: *const Self) -> u64 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
@@ -3488,7 +3556,7 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         }
     }
     #[inline]
-    pub unsafe fn set_ReservedRioEnabled_raw(this: *mut Self, val: u64) {
+    pub unsafe fn set_RioEnabled_raw(this: *mut Self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
@@ -3579,7 +3647,7 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         StreamMultiReceiveEnabled: u64,
         XdpEnabled: u64,
         QTIPEnabled: u64,
-        ReservedRioEnabled: u64,
+        RioEnabled: u64,
         RESERVED: u64,
     ) -> __BindgenBitfieldUnit<[u8; 8usize]> {
         let mut __bindgen_bitfield_unit: __BindgenBitfieldUnit<[u8; 8usize]> = Default::default();
@@ -3786,8 +3854,8 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
             QTIPEnabled as u64
         });
         __bindgen_bitfield_unit.set(45usize, 1u8, {
-            let ReservedRioEnabled: u64 = unsafe { ::std::mem::transmute(ReservedRioEnabled) };
-            ReservedRioEnabled as u64
+            let RioEnabled: u64 = unsafe { ::std::mem::transmute(RioEnabled) };
+            RioEnabled as u64
         });
         __bindgen_bitfield_unit.set(46usize, 18u8, {
             let RESERVED: u64 = unsafe { ::std::mem::transmute(RESERVED) };
@@ -4092,18 +4160,18 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
         }
     }
     #[inline]
-    pub fn ReservedRioEnabled(&self) -> u64 {
+    pub fn RioEnabled(&self) -> u64 {
         unsafe { ::std::mem::transmute(self._bitfield_1.get(8usize, 1u8) as u64) }
     }
     #[inline]
-    pub fn set_ReservedRioEnabled(&mut self, val: u64) {
+    pub fn set_RioEnabled(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             self._bitfield_1.set(8usize, 1u8, val as u64)
         }
     }
     #[inline]
-    pub unsafe fn ReservedRioEnabled_raw(this: *const Self) -> u64 {
+    pub unsafe fn RioEnabled_raw(this: *const Self) -> u64 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
@@ -4113,7 +4181,7 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
         }
     }
     #[inline]
-    pub unsafe fn set_ReservedRioEnabled_raw(this: *mut Self, val: u64) {
+    pub unsafe fn set_RioEnabled_raw(this: *mut Self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
@@ -4167,7 +4235,7 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
         StreamMultiReceiveEnabled: u64,
         XdpEnabled: u64,
         QTIPEnabled: u64,
-        ReservedRioEnabled: u64,
+        RioEnabled: u64,
         ReservedFlags: u64,
     ) -> __BindgenBitfieldUnit<[u8; 8usize]> {
         let mut __bindgen_bitfield_unit: __BindgenBitfieldUnit<[u8; 8usize]> = Default::default();
@@ -4206,8 +4274,8 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
             QTIPEnabled as u64
         });
         __bindgen_bitfield_unit.set(8usize, 1u8, {
-            let ReservedRioEnabled: u64 = unsafe { ::std::mem::transmute(ReservedRioEnabled) };
-            ReservedRioEnabled as u64
+            let RioEnabled: u64 = unsafe { ::std::mem::transmute(RioEnabled) };
+            RioEnabled as u64
         });
         __bindgen_bitfield_unit.set(9usize, 55u8, {
             let ReservedFlags: u64 = unsafe { ::std::mem::transmute(ReservedFlags) };
@@ -4888,6 +4956,23 @@ const _: () = {
     ["Offset of field: QUIC_STREAM_STATISTICS::StreamBlockedByAppUs"]
         [::std::mem::offset_of!(QUIC_STREAM_STATISTICS, StreamBlockedByAppUs) - 56usize];
 };
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_STREAM_EXTENSIBLE_PRIORITY {
+    pub Urgency: u8,
+    pub Incremental: BOOLEAN,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_STREAM_EXTENSIBLE_PRIORITY"]
+        [::std::mem::size_of::<QUIC_STREAM_EXTENSIBLE_PRIORITY>() - 2usize];
+    ["Alignment of QUIC_STREAM_EXTENSIBLE_PRIORITY"]
+        [::std::mem::align_of::<QUIC_STREAM_EXTENSIBLE_PRIORITY>() - 1usize];
+    ["Offset of field: QUIC_STREAM_EXTENSIBLE_PRIORITY::Urgency"]
+        [::std::mem::offset_of!(QUIC_STREAM_EXTENSIBLE_PRIORITY, Urgency) - 0usize];
+    ["Offset of field: QUIC_STREAM_EXTENSIBLE_PRIORITY::Incremental"]
+        [::std::mem::offset_of!(QUIC_STREAM_EXTENSIBLE_PRIORITY, Incremental) - 1usize];
+};
 pub const QUIC_AEAD_ALGORITHM_TYPE_QUIC_AEAD_ALGORITHM_AES_128_GCM: QUIC_AEAD_ALGORITHM_TYPE = 0;
 pub const QUIC_AEAD_ALGORITHM_TYPE_QUIC_AEAD_ALGORITHM_AES_256_GCM: QUIC_AEAD_ALGORITHM_TYPE = 1;
 pub type QUIC_AEAD_ALGORITHM_TYPE = ::std::os::raw::c_uint;
@@ -6537,6 +6622,92 @@ pub type QUIC_STREAM_SEND_FN = ::std::option::Option<
         ClientSendContext: *mut ::std::os::raw::c_void,
     ) -> ::std::os::raw::c_uint,
 >;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_SEND_BATCH_ENTRY {
+    pub Stream: HQUIC,
+    pub Buffers: *const QUIC_BUFFER,
+    pub BufferCount: u32,
+    pub Flags: QUIC_SEND_FLAGS,
+    pub ClientSendContext: *mut ::std::os::raw::c_void,
+    pub Status: ::std::os::raw::c_uint,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_SEND_BATCH_ENTRY"][::std::mem::size_of::<QUIC_SEND_BATCH_ENTRY>() - 40usize];
+    ["Alignment of QUIC_SEND_BATCH_ENTRY"][::std::mem::align_of::<QUIC_SEND_BATCH_ENTRY>() - 8usize];
+    ["Offset of field: QUIC_SEND_BATCH_ENTRY::Stream"]
+        [::std::mem::offset_of!(QUIC_SEND_BATCH_ENTRY, Stream) - 0usize];
+    ["Offset of field: QUIC_SEND_BATCH_ENTRY::Buffers"]
+        [::std::mem::offset_of!(QUIC_SEND_BATCH_ENTRY, Buffers) - 8usize];
+    ["Offset of field: QUIC_SEND_BATCH_ENTRY::BufferCount"]
+        [::std::mem::offset_of!(QUIC_SEND_BATCH_ENTRY, BufferCount) - 16usize];
+    ["Offset of field: QUIC_SEND_BATCH_ENTRY::Flags"]
+        [::std::mem::offset_of!(QUIC_SEND_BATCH_ENTRY, Flags) - 20usize];
+    ["Offset of field: QUIC_SEND_BATCH_ENTRY::ClientSendContext"]
+        [::std::mem::offset_of!(QUIC_SEND_BATCH_ENTRY, ClientSendContext) - 24usize];
+    ["Offset of field: QUIC_SEND_BATCH_ENTRY::Status"]
+        [::std::mem::offset_of!(QUIC_SEND_BATCH_ENTRY, Status) - 32usize];
+};
+pub type QUIC_CONNECTION_SEND_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Connection: HQUIC,
+        EntryCount: u32,
+        Entries: *mut QUIC_SEND_BATCH_ENTRY,
+    ) -> ::std::os::raw::c_uint,
+>;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_STREAM_OPEN_BATCH_ENTRY {
+    pub Context: *mut ::std::os::raw::c_void,
+    pub Buffers: *const QUIC_BUFFER,
+    pub BufferCount: u32,
+    pub Flags: QUIC_SEND_FLAGS,
+    pub ClientSendContext: *mut ::std::os::raw::c_void,
+    pub Stream: HQUIC,
+    pub Status: ::std::os::raw::c_uint,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_STREAM_OPEN_BATCH_ENTRY"]
+        [::std::mem::size_of::<QUIC_STREAM_OPEN_BATCH_ENTRY>() - 48usize];
+    ["Alignment of QUIC_STREAM_OPEN_BATCH_ENTRY"]
+        [::std::mem::align_of::<QUIC_STREAM_OPEN_BATCH_ENTRY>() - 8usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::Context"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, Context) - 0usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::Buffers"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, Buffers) - 8usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::BufferCount"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, BufferCount) - 16usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::Flags"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, Flags) - 20usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::ClientSendContext"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, ClientSendContext) - 24usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::Stream"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, Stream) - 32usize];
+    ["Offset of field: QUIC_STREAM_OPEN_BATCH_ENTRY::Status"]
+        [::std::mem::offset_of!(QUIC_STREAM_OPEN_BATCH_ENTRY, Status) - 40usize];
+};
+pub type QUIC_STREAM_OPEN_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Connection: HQUIC,
+        OpenFlags: QUIC_STREAM_OPEN_FLAGS,
+        StartFlags: QUIC_STREAM_START_FLAGS,
+        Handler: QUIC_STREAM_CALLBACK_HANDLER,
+        EntryCount: u32,
+        Entries: *mut QUIC_STREAM_OPEN_BATCH_ENTRY,
+    ) -> ::std::os::raw::c_uint,
+>;
+pub type QUIC_STREAM_SEND_FILE_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Stream: HQUIC,
+        File: QUIC_FILE_HANDLE,
+        FileOffset: u64,
+        Length: u64,
+        Flags: QUIC_SEND_FLAGS,
+        ClientSendContext: *mut ::std::os::raw::c_void,
+    ) -> ::std::os::raw::c_uint,
+>;
 pub type QUIC_STREAM_RECEIVE_COMPLETE_FN =
     ::std::option::Option<unsafe extern "C" fn(Stream: HQUIC, BufferLength: u64)>;
 pub type QUIC_STREAM_RECEIVE_SET_ENABLED_FN = ::std::option::Option<
@@ -6655,10 +6826,14 @@ pub struct QUIC_API_TABLE {
     pub ExecutionDelete: QUIC_EXECUTION_DELETE_FN,
     pub ExecutionPoll: QUIC_EXECUTION_POLL_FN,
     pub RegistrationClose2: QUIC_REGISTRATION_CLOSE2_FN,
+    pub ExecutionPollBatch: QUIC_EXECUTION_POLL_BATCH_FN,
+    pub ConnectionSendBatch: QUIC_CONNECTION_SEND_BATCH_FN,
+    pub StreamOpenBatch: QUIC_STREAM_OPEN_BATCH_FN,
+    pub StreamSendFile: QUIC_STREAM_SEND_FILE_FN,
 }
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_API_TABLE"][::std::mem::size_of::<QUIC_API_TABLE>() - 304usize];
+    ["Size of QUIC_API_TABLE"][::std::mem::size_of::<QUIC_API_TABLE>() - 336usize];
     ["Alignment of QUIC_API_TABLE"][::std::mem::align_of::<QUIC_API_TABLE>() - 8usize];
     ["Offset of field: QUIC_API_TABLE::SetContext"]
         [::std::mem::offset_of!(QUIC_API_TABLE, SetContext) - 0usize];
@@ -6740,6 +6915,14 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_API_TABLE, ExecutionPoll) - 288usize];
     ["Offset of field: QUIC_API_TABLE::RegistrationClose2"]
         [::std::mem::offset_of!(QUIC_API_TABLE, RegistrationClose2) - 296usize];
+    ["Offset of field: QUIC_API_TABLE::ExecutionPollBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ExecutionPollBatch) - 304usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionSendBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionSendBatch) - 312usize];
+    ["Offset of field: QUIC_API_TABLE::StreamOpenBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, StreamOpenBatch) - 320usize];
+    ["Offset of field: QUIC_API_TABLE::StreamSendFile"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, StreamSendFile) - 328usize];
 };
 pub const QUIC_STATUS_SUCCESS: QUIC_STATUS = 0;
 pub const QUIC_STATUS_PENDING: QUIC_STATUS = 4294967294;
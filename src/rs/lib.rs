@@ -36,6 +36,12 @@ pub use config::{
     CertificateHashStore, CertificateHashStoreFlags, CertificatePkcs12, Credential,
     CredentialConfig, CredentialFlags, ExecutionProfile, RegistrationConfig,
 };
+mod async_io;
+pub use async_io::{
+    Accept, AcceptStream, AsyncConnection, AsyncListener, AsyncStream, Connected,
+    ConnectionShutdownComplete, OpenStream, Recv, RecvBuffers, StreamSendFuture,
+    StreamShutdownComplete,
+};
 
 //
 // The following starts the C interop layer of MsQuic API.
@@ -164,7 +170,9 @@ pub const SEND_RESUMPTION_FLAG_FINAL: SendResumptionFlags = 1;
 pub type StreamSchedulingScheme = u32;
 pub const STREAM_SCHEDULING_SCHEME_FIFO: StreamSchedulingScheme = 0;
 pub const STREAM_SCHEDULING_SCHEME_ROUND_ROBIN: StreamSchedulingScheme = 1;
-pub const STREAM_SCHEDULING_SCHEME_COUNT: StreamSchedulingScheme = 2;
+pub const STREAM_SCHEDULING_SCHEME_EXTENSIBLE: StreamSchedulingScheme = 2;
+pub const STREAM_SCHEDULING_SCHEME_WEIGHTED: StreamSchedulingScheme = 3;
+pub const STREAM_SCHEDULING_SCHEME_COUNT: StreamSchedulingScheme = 4;
 
 /// Key information for TLS session ticket encryption.
 #[repr(C)]
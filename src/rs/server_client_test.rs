@@ -420,3 +420,99 @@ fn connection_ref_callback_cleanup() {
     );
     listener.stop();
 }
+
+/// Minimal executor for the async tests, so they don't need a runtime.
+fn block_on<F: std::future::Future>(future: F) -> F::Output {
+    struct ThreadWaker(std::thread::Thread);
+    impl std::task::Wake for ThreadWaker {
+        fn wake(self: Arc<Self>) {
+            self.0.unpark();
+        }
+    }
+    let waker = std::task::Waker::from(Arc::new(ThreadWaker(std::thread::current())));
+    let mut cx = std::task::Context::from_waker(&waker);
+    let mut future = std::pin::pin!(future);
+    loop {
+        if let std::task::Poll::Ready(output) = future.as_mut().poll(&mut cx) {
+            return output;
+        }
+        std::thread::park_timeout(Duration::from_secs(1));
+    }
+}
+
+async fn recv_to_string(stream: &mut crate::AsyncStream) -> Result<String, Status> {
+    let mut v = Vec::new();
+    while let Some(data) = stream.recv().await? {
+        for b in data.buffers() {
+            v.extend_from_slice(b.as_bytes());
+        }
+    }
+    Ok(String::from_utf8_lossy(&v).to_string())
+}
+
+#[test]
+fn test_async_server_client() {
+    let cred = get_test_cred();
+
+    let reg = Registration::new(&RegistrationConfig::default()).unwrap();
+    let alpn = [BufferRef::from("qtest")];
+    let settings = Settings::new().set_PeerBidiStreamCount(1);
+    let server_config = Configuration::open(&reg, &alpn, Some(&settings)).unwrap();
+    let cred_config = CredentialConfig::new()
+        .set_credential_flags(CredentialFlags::NO_CERTIFICATE_VALIDATION)
+        .set_credential(cred);
+    server_config.load_credential(&cred_config).unwrap();
+
+    let listener = crate::AsyncListener::open(&reg, Arc::new(server_config)).unwrap();
+    let local_address = Addr::from(SocketAddr::new(IpAddr::V4(Ipv4Addr::LOCALHOST), 0));
+    listener.start(&alpn, Some(&local_address)).unwrap();
+    let port = listener
+        .listener()
+        .get_local_addr()
+        .unwrap()
+        .as_socket()
+        .unwrap()
+        .port();
+
+    let client_settings = Settings::new().set_IdleTimeoutMs(1000);
+    let client_config = Configuration::open(&reg, &alpn, Some(&client_settings)).unwrap();
+    let cred_config = CredentialConfig::new_client()
+        .set_credential_flags(CredentialFlags::NO_CERTIFICATE_VALIDATION);
+    client_config.load_credential(&cred_config).unwrap();
+
+    std::thread::scope(|s| {
+        // Echoes the request back with a prefix.
+        s.spawn(|| {
+            block_on(async {
+                let conn = listener.accept().await.expect("listener stopped");
+                conn.connected().await.unwrap();
+                let mut stream = conn.accept_stream().await.expect("no peer stream");
+                let request = recv_to_string(&mut stream).await.unwrap();
+                let reply = format!("echo: {request}").into_bytes();
+                let (result, _) = stream.send(reply, crate::SendFlags::FIN).await;
+                result.unwrap();
+                stream.shutdown_complete().await;
+                conn.shutdown_complete().await;
+            })
+        });
+
+        let reply = block_on(async {
+            let conn = crate::AsyncConnection::open(&reg).unwrap();
+            conn.start(&client_config, "127.0.0.1", port).unwrap();
+            conn.connected().await.unwrap();
+            let mut stream = conn
+                .open_stream(crate::StreamOpenFlags::NONE)
+                .await
+                .unwrap();
+            let (result, _) = stream.send(b"hello".to_vec(), crate::SendFlags::FIN).await;
+            result.unwrap();
+            let reply = recv_to_string(&mut stream).await.unwrap();
+            stream.shutdown_complete().await;
+            conn.shutdown(ConnectionShutdownFlags::NONE, 0);
+            conn.shutdown_complete().await;
+            reply
+        });
+        assert_eq!(reply, "echo: hello");
+    });
+    listener.stop();
+}
@@ -532,6 +532,7 @@ bitflags::bitflags! {
         const CANCEL_ON_LOSS           = crate::ffi::QUIC_SEND_FLAGS_QUIC_SEND_FLAG_CANCEL_ON_LOSS;
         const PRIORITY_WORK            = crate::ffi::QUIC_SEND_FLAGS_QUIC_SEND_FLAG_PRIORITY_WORK;
         const CANCEL_ON_BLOCKED        = crate::ffi::QUIC_SEND_FLAGS_QUIC_SEND_FLAG_CANCEL_ON_BLOCKED;
+        const DGRAM_LOW_PRIORITY       = crate::ffi::QUIC_SEND_FLAGS_QUIC_SEND_FLAG_DGRAM_LOW_PRIORITY;
     }
 }
 
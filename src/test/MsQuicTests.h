@@ -64,6 +64,7 @@ void QuicTestValidateListener();
 void QuicTestValidateConnection();
 void QuicTestValidateStream(const bool& Connect);
 void QuicTestCloseConnBeforeStreamFlush();
+void QuicTestInlineApiFromCallback();
 void QuicTestGlobalParam();
 void QuicTestCommonParam();
 void QuicTestRegistrationParam();
@@ -473,6 +474,16 @@ QuicTestConnectionPoolCreate(
     _In_ bool XdpSupported,
     _In_ bool TestCibirSupport
     );
+
+void
+QuicTestConnectionPoolManaged(
+    const FamilyArgs& Params
+    );
+
+void
+QuicTestClientTicketCache(
+    const FamilyArgs& Params
+    );
 #endif
 
 //
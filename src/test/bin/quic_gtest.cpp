@@ -478,6 +478,15 @@ TEST(ParameterValidation, CloseConnBeforeStreamFlush) {
     }
 }
 
+TEST(ParameterValidation, InlineApiFromCallback) {
+    TestLogger Logger("QuicTestInlineApiFromCallback");
+    if (TestingKernelMode) {
+        ASSERT_TRUE(InvokeKernelTest(FUNC(QuicTestInlineApiFromCallback)));
+    } else {
+        QuicTestInlineApiFromCallback();
+    }
+}
+
 struct WithValidateConnectionEventArgs :
     public testing::TestWithParam<ValidateConnectionEventArgs> {
     static ::std::vector<ValidateConnectionEventArgs> Generate() {
@@ -1833,6 +1842,24 @@ TEST_P(WithHandshakeArgs12, ConnectionPoolCreate) {
             GetParam().TestCibirSupport);
     }
 }
+
+TEST_P(WithFamilyArgs, ConnectionPoolManaged) {
+    TestLoggerT<ParamType> Logger("QuicTestConnectionPoolManaged", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(InvokeKernelTest(FUNC(QuicTestConnectionPoolManaged), GetParam()));
+    } else {
+        QuicTestConnectionPoolManaged(GetParam());
+    }
+}
+
+TEST_P(WithFamilyArgs, ClientTicketCache) {
+    TestLoggerT<ParamType> Logger("QuicTestClientTicketCache", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(InvokeKernelTest(FUNC(QuicTestClientTicketCache), GetParam()));
+    } else {
+        QuicTestClientTicketCache(GetParam());
+    }
+}
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
 
 TEST_P(WithSendArgs1, Send) {
@@ -95,7 +95,7 @@ struct HandshakeArgs10 {
         ::std::vector<HandshakeArgs10> list;
         for (int Family : { 4, 6 })
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
-        for (auto CcAlgo : { QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, QUIC_CONGESTION_CONTROL_ALGORITHM_BBR })
+        for (auto CcAlgo : { QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, QUIC_CONGESTION_CONTROL_ALGORITHM_BBR, QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3, QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE })
 #else
         for (auto CcAlgo : { QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC })
 #endif
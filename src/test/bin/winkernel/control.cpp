@@ -667,6 +667,7 @@ ExecuteTestRequest(
     RegisterTestFunction(QuicTestConnectionCloseBeforeStreamClose);
     RegisterTestFunction(QuicTestValidateStream);
     RegisterTestFunction(QuicTestCloseConnBeforeStreamFlush);
+    RegisterTestFunction(QuicTestInlineApiFromCallback);
     RegisterTestFunction(QuicTestValidateConnectionEvents);
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
     RegisterTestFunction(QuicTestValidateNetStatsConnEvent);
@@ -730,6 +731,8 @@ ExecuteTestRequest(
     RegisterTestFunction(QuicTestFailedVersionNegotiation);
     RegisterTestFunction(QuicTestReliableResetNegotiation);
     RegisterTestFunction(QuicTestOneWayDelayNegotiation);
+    RegisterTestFunction(QuicTestConnectionPoolManaged);
+    RegisterTestFunction(QuicTestClientTicketCache);
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
     RegisterTestFunction(QuicTestCustomServerCertificateValidation);
     RegisterTestFunction(QuicTestCustomClientCertificateValidation);
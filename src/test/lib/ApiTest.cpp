@@ -1634,6 +1634,162 @@ void QuicTestValidateStream(const bool& Connect)
                         nullptr));
             }
 
+            //
+            // Batched sends.
+            //
+            {
+                TestScopeLogger logScope("Batched sends");
+                StreamScope Stream1;
+                StreamScope Stream2;
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->StreamOpen(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_NONE | QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL,
+                        AllowSendCompleteStreamCallback,
+                        nullptr,
+                        &Stream1.Handle));
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->StreamOpen(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_NONE | QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL,
+                        AllowSendCompleteStreamCallback,
+                        nullptr,
+                        &Stream2.Handle));
+
+                QUIC_SEND_BATCH_ENTRY Entries[3] = {};
+                Entries[0].Stream = Stream1.Handle;
+                Entries[0].Buffers = Buffers;
+                Entries[0].BufferCount = ARRAYSIZE(Buffers);
+                Entries[0].Flags = QUIC_SEND_FLAG_START | QUIC_SEND_FLAG_FIN;
+                Entries[1].Stream = Stream2.Handle;
+                Entries[1].Buffers = Buffers;
+                Entries[1].BufferCount = ARRAYSIZE(Buffers);
+                Entries[1].Flags = QUIC_SEND_FLAG_START | QUIC_SEND_FLAG_FIN;
+                Entries[2].Stream = nullptr;
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->ConnectionSendBatch(
+                        Client.GetConnection(),
+                        0,
+                        Entries));
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->ConnectionSendBatch(
+                        Client.GetConnection(),
+                        ARRAYSIZE(Entries),
+                        Entries));
+                TEST_QUIC_STATUS(QUIC_STATUS_PENDING, Entries[0].Status);
+                TEST_QUIC_STATUS(QUIC_STATUS_PENDING, Entries[1].Status);
+                TEST_QUIC_STATUS(QUIC_STATUS_INVALID_PARAMETER, Entries[2].Status);
+            }
+
+            //
+            // Batched opens.
+            //
+            {
+                TestScopeLogger logScope("Batched opens");
+                StreamScope Stream1;
+                StreamScope Stream2;
+                StreamScope Stream3;
+
+                QUIC_STREAM_OPEN_BATCH_ENTRY Entries[3] = {};
+                Entries[0].Buffers = Buffers;
+                Entries[0].BufferCount = ARRAYSIZE(Buffers);
+                Entries[0].Flags = QUIC_SEND_FLAG_FIN;
+                Entries[1].Flags = QUIC_SEND_FLAG_FIN;
+                Entries[2].Buffers = nullptr;
+                Entries[2].BufferCount = ARRAYSIZE(Buffers);
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->StreamOpenBatch(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL,
+                        QUIC_STREAM_START_FLAG_NONE,
+                        AllowSendCompleteStreamCallback,
+                        0,
+                        Entries));
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->StreamOpenBatch(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL,
+                        QUIC_STREAM_START_FLAG_NONE,
+                        nullptr,
+                        ARRAYSIZE(Entries),
+                        Entries));
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->StreamOpenBatch(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL,
+                        QUIC_STREAM_START_FLAG_NONE,
+                        AllowSendCompleteStreamCallback,
+                        ARRAYSIZE(Entries),
+                        Entries));
+                Stream1.Handle = Entries[0].Stream;
+                Stream2.Handle = Entries[1].Stream;
+                Stream3.Handle = Entries[2].Stream;
+                TEST_QUIC_STATUS(QUIC_STATUS_PENDING, Entries[0].Status);
+                TEST_QUIC_STATUS(QUIC_STATUS_PENDING, Entries[1].Status);
+                TEST_QUIC_STATUS(QUIC_STATUS_INVALID_PARAMETER, Entries[2].Status);
+                TEST_NOT_EQUAL(nullptr, Stream1.Handle);
+                TEST_NOT_EQUAL(nullptr, Stream2.Handle);
+                TEST_EQUAL(nullptr, Stream3.Handle);
+            }
+
+#ifndef _KERNEL_MODE
+            //
+            // File sends.
+            //
+            {
+                TestScopeLogger logScope("File sends");
+                StreamScope Stream;
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->StreamOpen(
+                        Client.GetConnection(),
+                        QUIC_STREAM_OPEN_FLAG_NONE | QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL,
+                        AllowSendCompleteStreamCallback,
+                        nullptr,
+                        &Stream.Handle));
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->StreamSendFile(
+                        Stream.Handle,
+                        QUIC_FILE_HANDLE_INVALID,
+                        0,
+                        100,
+                        QUIC_SEND_FLAG_NONE,
+                        nullptr));
+
+                const QUIC_FILE_HANDLE File = (QUIC_FILE_HANDLE)1; // Never read.
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->StreamSendFile(
+                        Stream.Handle,
+                        File,
+                        0,
+                        (uint64_t)UINT32_MAX + 1,
+                        QUIC_SEND_FLAG_NONE,
+                        nullptr));
+
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->StreamSendFile(
+                        Stream.Handle,
+                        File,
+                        UINT64_MAX,
+                        100,
+                        QUIC_SEND_FLAG_NONE,
+                        nullptr));
+            }
+#endif // !_KERNEL_MODE
+
             //
             // Zero-length buffers.
             //
@@ -1915,6 +2071,88 @@ void QuicTestCloseConnBeforeStreamFlush()
     CxPlatSleep(50);
 }
 
+struct InlineApiFromCallbackContext {
+    CxPlatEvent SendCompleteEvent;
+    QUIC_STATUS StartStatus { QUIC_STATUS_INVALID_STATE };
+    bool InCallback { false };
+    bool StartCompleteIndicated { false };
+    bool StartCompleteBeforeReturn { false };
+    bool SendCompleteInline { false };
+
+    static QUIC_STATUS StreamCallback(_In_ MsQuicStream*, _In_opt_ void* Context, _Inout_ QUIC_STREAM_EVENT* Event) {
+        auto Ctx = (InlineApiFromCallbackContext*)Context;
+        if (Event->Type == QUIC_STREAM_EVENT_START_COMPLETE) {
+            Ctx->StartCompleteIndicated = true;
+        } else if (Event->Type == QUIC_STREAM_EVENT_SEND_COMPLETE) {
+            Ctx->SendCompleteInline = Ctx->InCallback;
+            Ctx->SendCompleteEvent.Set();
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    static QUIC_STATUS ServerCallback(_In_ MsQuicConnection*, _In_opt_ void*, _Inout_ QUIC_CONNECTION_EVENT* Event) {
+        if (Event->Type == QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED) {
+            new(std::nothrow) MsQuicStream(Event->PEER_STREAM_STARTED.Stream, CleanUpAutoDelete);
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    static QUIC_STATUS ClientCallback(_In_ MsQuicConnection* Conn, _In_opt_ void* Context, _Inout_ QUIC_CONNECTION_EVENT* Event) {
+        auto Ctx = (InlineApiFromCallbackContext*)Context;
+        if (Event->Type == QUIC_CONNECTION_EVENT_CONNECTED) {
+            Ctx->InCallback = true;
+            auto Stream = new(std::nothrow) MsQuicStream(*Conn, QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL, CleanUpAutoDelete, StreamCallback, Context);
+            if (QUIC_FAILED(Stream->GetInitStatus()) || QUIC_FAILED(Ctx->StartStatus = Stream->Start())) {
+                delete Stream;
+            } else {
+                Ctx->StartCompleteBeforeReturn = Ctx->StartCompleteIndicated;
+                (void)Stream->Send(&NoopBuffer, 1, QUIC_SEND_FLAG_FIN);
+            }
+            Ctx->InCallback = false;
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+void QuicTestInlineApiFromCallback()
+{
+    MsQuicRegistration Registration(true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    MsQuicConfiguration ServerConfiguration(Registration, "MsQuicTest",
+        MsQuicSettings()
+            .SetPeerUnidiStreamCount(1),
+        ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest",
+        MsQuicSettings()
+            .SetSendBufferingEnabled(true),
+        MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+    InlineApiFromCallbackContext Context;
+
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, InlineApiFromCallbackContext::ServerCallback);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Listener.Start("MsQuicTest"));
+    QuicAddr ServerLocalAddr;
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    MsQuicConnection Connection(Registration, CleanUpManual, InlineApiFromCallbackContext::ClientCallback, &Context);
+    TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Connection.Start(ClientConfiguration, ServerLocalAddr.GetFamily(), QUIC_TEST_LOOPBACK_FOR_AF(ServerLocalAddr.GetFamily()), ServerLocalAddr.GetPort()));
+
+    //
+    // A start from the callback completes before returning, but a buffered
+    // send is only completed once the callback has returned.
+    //
+    TEST_TRUE(Context.SendCompleteEvent.WaitTimeout(TestWaitTimeout));
+    TEST_QUIC_SUCCEEDED(Context.StartStatus);
+    TEST_TRUE(Context.StartCompleteBeforeReturn);
+    TEST_FALSE(Context.SendCompleteInline);
+}
+
 class SecConfigTestContext {
 public:
     CXPLAT_EVENT Event;
@@ -2896,7 +3134,10 @@ void QuicTestGlobalParam()
             QUIC_STATISTICS_V2_SIZE_1,
             QUIC_STATISTICS_V2_SIZE_2,
             QUIC_STATISTICS_V2_SIZE_3,
-            QUIC_STATISTICS_V2_SIZE_4
+            QUIC_STATISTICS_V2_SIZE_4,
+            QUIC_STATISTICS_V2_SIZE_5,
+            QUIC_STATISTICS_V2_SIZE_6,
+            QUIC_STATISTICS_V2_SIZE_7
         };
 
         //
@@ -3070,127 +3311,344 @@ void QuicTestRegistrationParam()
 {
     MsQuicRegistration Registration;
     TEST_TRUE(Registration.IsValid());
+
+#ifdef QUIC_PARAM_REGISTRATION_PATH_TELEMETRY
     //
-    // No parameter for Registration
+    // QUIC_PARAM_REGISTRATION_PATH_TELEMETRY
     //
     {
-        uint32_t Dummy = 0;
+        TestScopeLogger logScope("QUIC_PARAM_REGISTRATION_PATH_TELEMETRY");
+        {
+            uint32_t Dummy = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Registration.Handle,
+                    QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
+                    sizeof(Dummy),
+                    &Dummy));
+        }
+
+        QUIC_PATH_TELEMETRY_CONFIG Config = {};
+        Config.Callback =
+            [](void*, uint32_t, const QUIC_PATH_TELEMETRY*) { };
+
+        //
+        // Needs an interval.
+        //
         TEST_QUIC_STATUS(
             QUIC_STATUS_INVALID_PARAMETER,
             MsQuic->SetParam(
                 Registration.Handle,
-                QUIC_PARAM_PREFIX_REGISTRATION,
-                sizeof(Dummy),
-                &Dummy));
-    }
+                QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
+                sizeof(Config),
+                &Config));
 
-    {
-        uint32_t Length = 65535;
-        uint32_t Buffer = 65535;
+        Config.IntervalMs = 100;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
+                sizeof(Config),
+                &Config));
+
+        uint32_t Length = 0;
         TEST_QUIC_STATUS(
-            QUIC_STATUS_INVALID_PARAMETER,
+            QUIC_STATUS_BUFFER_TOO_SMALL,
             MsQuic->GetParam(
                 Registration.Handle,
-                QUIC_PARAM_PREFIX_REGISTRATION,
+                QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
                 &Length,
-                &Buffer));
-        TEST_EQUAL(Length, 65535);
-        TEST_EQUAL(Buffer, 65535);
-    }
-}
-
-#define SETTINGS_SIZE_THRU_FIELD(SettingsType, Field) \
-    (FIELD_OFFSET(SettingsType, Field) + sizeof(((SettingsType*)0)->Field))
-
-void QuicTestConfigurationParam()
-{
-    MsQuicRegistration Registration;
-    TEST_TRUE(Registration.IsValid());
-    MsQuicAlpn Alpn("MsQuicTest");
-
-    //
-    // QUIC_PARAM_CONFIGURATION_SETTINGS
-    //
-    {
-        TestScopeLogger LogScope0("QUIC_PARAM_CONFIGURATION_SETTINGS");
-        {
-            TestScopeLogger LogScope1("SetParam");
-            //
-            // QuicSettingsSettingsToInternal fail
-            //
-            {
-                TestScopeLogger LogScope2("QuicSettingsSettingsToInternal fail");
-                MsQuicConfiguration Configuration(Registration, Alpn);
-                QUIC_SETTINGS Settings{0};
-                TEST_QUIC_STATUS(
-                    QUIC_STATUS_INVALID_PARAMETER,
-                    MsQuic->SetParam(
-                        nullptr,
-                        QUIC_PARAM_CONFIGURATION_SETTINGS,
-                        sizeof(QUIC_SETTINGS)-8,
-                        &Settings));
-            }
+                nullptr));
+        TEST_EQUAL(Length, sizeof(QUIC_PATH_TELEMETRY_CONFIG));
 
-            //
-            // QuicSettingApply fail
-            //
-            {
-                TestScopeLogger LogScope2("QuicSettingApply fail");
-                MsQuicConfiguration Configuration(Registration, Alpn);
-                SettingApplyTests(Configuration.Handle, QUIC_PARAM_CONFIGURATION_SETTINGS);
-            }
-        }
+        QUIC_PATH_TELEMETRY_CONFIG Get = {};
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
+                &Length,
+                &Get));
+        TEST_EQUAL(Get.Callback, Config.Callback);
+        TEST_EQUAL(Get.IntervalMs, 100u);
 
         //
-        // GetParam
+        // Can't change while there are connections.
         //
         {
-            TestScopeLogger LogScope1("GetParam");
-            MsQuicConfiguration Configuration(Registration, Alpn);
-            uint32_t Length = 0;
-            TEST_QUIC_STATUS(
-                QUIC_STATUS_BUFFER_TOO_SMALL,
-                MsQuic->GetParam(
-                    Configuration.Handle,
-                    QUIC_PARAM_CONFIGURATION_SETTINGS,
-                    &Length,
-                    nullptr));
-            TEST_TRUE(Length >= sizeof(QUIC_SETTINGS));
-
-            Length = 1;
+            MsQuicConnection Connection(Registration);
+            TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
             TEST_QUIC_STATUS(
-                QUIC_STATUS_BUFFER_TOO_SMALL,
-                MsQuic->GetParam(
-                    Configuration.Handle,
-                    QUIC_PARAM_CONFIGURATION_SETTINGS,
-                    &Length,
-                    nullptr));
-            TEST_EQUAL(Length, SETTINGS_SIZE_THRU_FIELD(QUIC_SETTINGS, MtuDiscoveryMissingProbeCount));
-
-            QUIC_SETTINGS Settings{0};
-            TEST_QUIC_SUCCEEDED(
-                MsQuic->GetParam(
-                    Configuration.Handle,
-                    QUIC_PARAM_CONFIGURATION_SETTINGS,
-                    &Length,
-                    &Settings));
-            // TODO: how to compare with default?
-            //       QuicSettingsSetDefault is not accessible from test
+                QUIC_STATUS_INVALID_STATE,
+                MsQuic->SetParam(
+                    Registration.Handle,
+                    QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
+                    sizeof(Config),
+                    &Config));
         }
+
+        Config.Callback = nullptr;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_PATH_TELEMETRY,
+                sizeof(Config),
+                &Config));
     }
+#endif
 
+#ifdef QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE
     //
-    // QUIC_PARAM_CONFIGURATION_TICKET_KEYS
+    // QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE
     //
     {
-        TestScopeLogger LogScope0("QUIC_PARAM_CONFIGURATION_TICKET_KEYS");
+        TestScopeLogger logScope("QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE");
         {
-            TestScopeLogger LogScope1("SetParam");
-            //
-            // Set before MsQuic->ConfigurationLoadCredential which is Configuration->SecurityConfig == NULL
-            //
-            {
-                TestScopeLogger LogScope2("Set before MsQuic->ConfigurationLoadCredential which is Configuration->SecurityConfig == NULL");
+            uint32_t Dummy = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Registration.Handle,
+                    QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE,
+                    sizeof(Dummy),
+                    &Dummy));
+        }
+
+        QUIC_CLIENT_TICKET_CACHE_CONFIG Config = {};
+        Config.MaxEntries = 16;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE,
+                sizeof(Config),
+                &Config));
+
+        uint32_t Length = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_BUFFER_TOO_SMALL,
+            MsQuic->GetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE,
+                &Length,
+                nullptr));
+        TEST_EQUAL(Length, sizeof(QUIC_CLIENT_TICKET_CACHE_CONFIG));
+
+        //
+        // Zero limits are replaced with the defaults.
+        //
+        QUIC_CLIENT_TICKET_CACHE_CONFIG Get = {};
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE,
+                &Length,
+                &Get));
+        TEST_EQUAL(Get.MaxEntries, 16u);
+        TEST_NOT_EQUAL(Get.MaxBytes, 0u);
+        TEST_NOT_EQUAL(Get.LifetimeMs, 0u);
+
+        QUIC_CLIENT_TICKET_CACHE_STATISTICS Stats = {};
+        Length = sizeof(Stats);
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE_STATS,
+                &Length,
+                &Stats));
+        TEST_EQUAL(Stats.Entries, 0u);
+
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE_STATS,
+                sizeof(Stats),
+                &Stats));
+
+        Config.MaxEntries = 0;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE,
+                sizeof(Config),
+                &Config));
+    }
+#endif
+
+#ifdef QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY
+    //
+    // QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY
+    //
+    {
+        TestScopeLogger logScope("QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY");
+        QUIC_ZERORTT_ANTI_REPLAY_CONFIG Config = {};
+
+        //
+        // Too small to split over the filter's shards.
+        //
+        Config.FilterBytes = 1;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY,
+                sizeof(Config),
+                &Config));
+
+        Config.FilterBytes = 64 * 1024;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY,
+                sizeof(Config),
+                &Config));
+
+        QUIC_ZERORTT_ANTI_REPLAY_CONFIG Get = {};
+        uint32_t Length = sizeof(Get);
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->GetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY,
+                &Length,
+                &Get));
+        TEST_EQUAL(Get.FilterBytes, 64u * 1024);
+        TEST_NOT_EQUAL(Get.WindowMs, 0u);
+
+        //
+        // Can't change while there are connections.
+        //
+        {
+            MsQuicConnection Connection(Registration);
+            TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_STATE,
+                MsQuic->SetParam(
+                    Registration.Handle,
+                    QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY,
+                    sizeof(Config),
+                    &Config));
+        }
+
+        Config.FilterBytes = 0;
+        TEST_QUIC_SUCCEEDED(
+            MsQuic->SetParam(
+                Registration.Handle,
+                QUIC_PARAM_REGISTRATION_ZERORTT_ANTI_REPLAY,
+                sizeof(Config),
+                &Config));
+    }
+#endif
+
+    //
+    // Unknown parameter
+    //
+    {
+        uint32_t Length = 65535;
+        uint32_t Buffer = 65535;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->GetParam(
+                Registration.Handle,
+                QUIC_PARAM_PREFIX_REGISTRATION | 0xFFFF,
+                &Length,
+                &Buffer));
+        TEST_EQUAL(Length, 65535);
+        TEST_EQUAL(Buffer, 65535);
+    }
+}
+
+#define SETTINGS_SIZE_THRU_FIELD(SettingsType, Field) \
+    (FIELD_OFFSET(SettingsType, Field) + sizeof(((SettingsType*)0)->Field))
+
+void QuicTestConfigurationParam()
+{
+    MsQuicRegistration Registration;
+    TEST_TRUE(Registration.IsValid());
+    MsQuicAlpn Alpn("MsQuicTest");
+
+    //
+    // QUIC_PARAM_CONFIGURATION_SETTINGS
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_CONFIGURATION_SETTINGS");
+        {
+            TestScopeLogger LogScope1("SetParam");
+            //
+            // QuicSettingsSettingsToInternal fail
+            //
+            {
+                TestScopeLogger LogScope2("QuicSettingsSettingsToInternal fail");
+                MsQuicConfiguration Configuration(Registration, Alpn);
+                QUIC_SETTINGS Settings{0};
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        nullptr,
+                        QUIC_PARAM_CONFIGURATION_SETTINGS,
+                        sizeof(QUIC_SETTINGS)-8,
+                        &Settings));
+            }
+
+            //
+            // QuicSettingApply fail
+            //
+            {
+                TestScopeLogger LogScope2("QuicSettingApply fail");
+                MsQuicConfiguration Configuration(Registration, Alpn);
+                SettingApplyTests(Configuration.Handle, QUIC_PARAM_CONFIGURATION_SETTINGS);
+            }
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            MsQuicConfiguration Configuration(Registration, Alpn);
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Configuration.Handle,
+                    QUIC_PARAM_CONFIGURATION_SETTINGS,
+                    &Length,
+                    nullptr));
+            TEST_TRUE(Length >= sizeof(QUIC_SETTINGS));
+
+            Length = 1;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Configuration.Handle,
+                    QUIC_PARAM_CONFIGURATION_SETTINGS,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, SETTINGS_SIZE_THRU_FIELD(QUIC_SETTINGS, MtuDiscoveryMissingProbeCount));
+
+            QUIC_SETTINGS Settings{0};
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Configuration.Handle,
+                    QUIC_PARAM_CONFIGURATION_SETTINGS,
+                    &Length,
+                    &Settings));
+            // TODO: how to compare with default?
+            //       QuicSettingsSetDefault is not accessible from test
+        }
+    }
+
+    //
+    // QUIC_PARAM_CONFIGURATION_TICKET_KEYS
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_CONFIGURATION_TICKET_KEYS");
+        {
+            TestScopeLogger LogScope1("SetParam");
+            //
+            // Set before MsQuic->ConfigurationLoadCredential which is Configuration->SecurityConfig == NULL
+            //
+            {
+                TestScopeLogger LogScope2("Set before MsQuic->ConfigurationLoadCredential which is Configuration->SecurityConfig == NULL");
                 MsQuicConfiguration Configuration(Registration, Alpn);
                 QUIC_TICKET_KEY_CONFIG Config{0};
                 TEST_QUIC_STATUS(
@@ -3625,47 +4083,198 @@ void QuicTestListenerParam()
             TEST_EQUAL(Length, sizeof(BOOLEAN)); //sizeof (((QUIC_LISTENER *)0)->DosModeEventsEnabled)
         }
     }
-#endif
-
-}
 
-void QuicTest_QUIC_PARAM_CONN_QUIC_VERSION(MsQuicRegistration& Registration, MsQuicConfiguration& ClientConfiguration)
-{
-    TestScopeLogger LogScope0("QUIC_PARAM_CONN_QUIC_VERSION");
-    MsQuicConnection Connection(Registration);
-    TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
     //
-    // SetParam
+    // QUIC_PARAM_LISTENER_PREFERRED_ADDRESS
     //
     {
-        TestScopeLogger LogScope1("SetParam is not allowed");
-        uint32_t Dummy = 0;
+        TestScopeLogger LogScope0("QUIC_PARAM_LISTENER_PREFERRED_ADDRESS");
+        MsQuicListener Listener(Registration, CleanUpManual, DummyListenerCallback<MsQuicListener*>, nullptr);
+        TEST_TRUE(Listener.IsValid());
+
+        uint32_t Length = 65535;
+        TEST_QUIC_SUCCEEDED(
+            Listener.GetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                &Length,
+                nullptr));
+        TEST_EQUAL(Length, 0);
+
+        QUIC_ADDR Wildcard = {0};
+        QuicAddrSetFamily(&Wildcard, QUIC_ADDRESS_FAMILY_INET);
+        QuicAddrSetPort(&Wildcard, 4433);
         TEST_QUIC_STATUS(
             QUIC_STATUS_INVALID_PARAMETER,
-            Connection.SetParam(
-                QUIC_PARAM_CONN_QUIC_VERSION,
-                sizeof(Dummy),
-                &Dummy));
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                sizeof(Wildcard),
+                &Wildcard));
+
+        QUIC_ADDR NoPort;
+        TEST_TRUE(QuicAddrFromString("127.0.0.1", 0, &NoPort));
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                sizeof(NoPort),
+                &NoPort));
+
+        QUIC_ADDR Expected;
+        TEST_TRUE(QuicAddrFromString("127.0.0.1", 4433, &Expected));
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                sizeof(Expected) - 1,
+                &Expected));
+        TEST_QUIC_SUCCEEDED(
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                sizeof(Expected),
+                &Expected));
+
+        QUIC_ADDR Actual = {0};
+        Length = sizeof(Actual);
+        TEST_QUIC_SUCCEEDED(
+            Listener.GetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                &Length,
+                &Actual));
+        TEST_EQUAL(Length, sizeof(Actual));
+        TEST_TRUE(QuicAddrCompare(&Expected, &Actual));
+
+        TEST_QUIC_SUCCEEDED(
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                0,
+                nullptr));
+        Length = sizeof(Actual);
+        TEST_QUIC_SUCCEEDED(
+            Listener.GetParam(
+                QUIC_PARAM_LISTENER_PREFERRED_ADDRESS,
+                &Length,
+                &Actual));
+        TEST_EQUAL(Length, 0);
     }
 
     //
-    // GetParam
+    // QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS
     //
     {
-        TestScopeLogger LogScope1("GetParam");
-        uint32_t Length = 0;
+        TestScopeLogger LogScope0("QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS");
+        MsQuicListener Listener(Registration, CleanUpManual, DummyListenerCallback<MsQuicListener*>, nullptr);
+        TEST_TRUE(Listener.IsValid());
+        MsQuicConfiguration Configuration(Registration, Alpn);
+        TEST_TRUE(Configuration.IsValid());
+        MsQuicRegistration OtherRegistration;
+        TEST_TRUE(OtherRegistration.IsValid());
+        MsQuicConfiguration OtherConfiguration(OtherRegistration, Alpn);
+        TEST_TRUE(OtherConfiguration.IsValid());
+
+        QUIC_LISTENER_SNI_CONFIGURATION Configs[] = {
+            { "www.example.com", Configuration.Handle },
+            { "*.example.com", Configuration.Handle },
+            { "example.org", Configuration.Handle },
+        };
         TEST_QUIC_STATUS(
-            QUIC_STATUS_BUFFER_TOO_SMALL,
-            Connection.GetParam(
-                QUIC_PARAM_CONN_QUIC_VERSION,
-                &Length,
-                nullptr));
-        TEST_EQUAL(Length, sizeof(uint32_t));
+            QUIC_STATUS_INVALID_PARAMETER,
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                sizeof(Configs) - 1,
+                Configs));
 
-        uint32_t Version = 65535;
-        {
-            TestScopeLogger LogScope2("Version == 0 before start");
-            TEST_QUIC_SUCCEEDED(
+        const char* InvalidNames[] = { "", "*", "*.", "www.*.com", "w*.example.com" };
+        for (auto Name : InvalidNames) {
+            QUIC_LISTENER_SNI_CONFIGURATION Invalid = { Name, Configuration.Handle };
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                Listener.SetParam(
+                    QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                    sizeof(Invalid),
+                    &Invalid));
+        }
+
+        QUIC_LISTENER_SNI_CONFIGURATION Duplicates[] = {
+            { "www.example.com", Configuration.Handle },
+            { "WWW.Example.com", Configuration.Handle },
+        };
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                sizeof(Duplicates),
+                Duplicates));
+
+        QUIC_LISTENER_SNI_CONFIGURATION OtherRegistrationConfig = {
+            "www.example.com", OtherConfiguration.Handle };
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                sizeof(OtherRegistrationConfig),
+                &OtherRegistrationConfig));
+
+        TEST_QUIC_SUCCEEDED(
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                sizeof(Configs),
+                Configs));
+        TEST_QUIC_SUCCEEDED(
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                0,
+                nullptr));
+
+        //
+        // The listener keeps its configurations alive until it's closed.
+        //
+        TEST_QUIC_SUCCEEDED(
+            Listener.SetParam(
+                QUIC_PARAM_LISTENER_SNI_CONFIGURATIONS,
+                sizeof(Configs),
+                Configs));
+    }
+#endif
+
+}
+
+void QuicTest_QUIC_PARAM_CONN_QUIC_VERSION(MsQuicRegistration& Registration, MsQuicConfiguration& ClientConfiguration)
+{
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_QUIC_VERSION");
+    MsQuicConnection Connection(Registration);
+    TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+    //
+    // SetParam
+    //
+    {
+        TestScopeLogger LogScope1("SetParam is not allowed");
+        uint32_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_QUIC_VERSION,
+                sizeof(Dummy),
+                &Dummy));
+    }
+
+    //
+    // GetParam
+    //
+    {
+        TestScopeLogger LogScope1("GetParam");
+        uint32_t Length = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_BUFFER_TOO_SMALL,
+            Connection.GetParam(
+                QUIC_PARAM_CONN_QUIC_VERSION,
+                &Length,
+                nullptr));
+        TEST_EQUAL(Length, sizeof(uint32_t));
+
+        uint32_t Version = 65535;
+        {
+            TestScopeLogger LogScope2("Version == 0 before start");
+            TEST_QUIC_SUCCEEDED(
                 Connection.GetParam(
                     QUIC_PARAM_CONN_QUIC_VERSION,
                     &Length,
@@ -4972,11 +5581,465 @@ void QuicTest_QUIC_PARAM_CONN_CLOSE_ASYNC(MsQuicRegistration& Registration)
         TEST_QUIC_STATUS(
             QUIC_STATUS_SUCCESS,
             Connection.GetParam(
-                QUIC_PARAM_CONN_CLOSE_ASYNC,
-                &BufferSize,
-                &GetValue));
-        TEST_EQUAL(BufferSize, sizeof(GetValue));
-        TEST_EQUAL(GetValue, CloseAsync);
+                QUIC_PARAM_CONN_CLOSE_ASYNC,
+                &BufferSize,
+                &GetValue));
+        TEST_EQUAL(BufferSize, sizeof(GetValue));
+        TEST_EQUAL(GetValue, CloseAsync);
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT");
+    {
+        TestScopeLogger LogScope1("SetParam null buffer");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT,
+                sizeof(Dummy),
+                nullptr));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam wrong length");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint8_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT,
+                sizeof(Dummy),
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("GetParam Default");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t TimeoutMs = 0;
+        SimpleGetParamTest(Connection.Handle, QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT, sizeof(TimeoutMs), &TimeoutMs);
+    }
+    {
+        TestScopeLogger LogScope1("SetParam/GetParam");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t TimeoutMs = 150;
+        uint32_t GetValue = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_SUCCESS,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT,
+                sizeof(TimeoutMs),
+                &TimeoutMs));
+        uint32_t BufferSize = sizeof(GetValue);
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_SUCCESS,
+            Connection.GetParam(
+                QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT,
+                &BufferSize,
+                &GetValue));
+        TEST_EQUAL(BufferSize, sizeof(GetValue));
+        TEST_EQUAL(GetValue, TimeoutMs);
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS");
+    {
+        TestScopeLogger LogScope1("SetParam wrong length");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint8_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS,
+                sizeof(Dummy),
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam before handshake confirmed");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        QuicAddr LocalAddr(QUIC_ADDRESS_FAMILY_INET, true);
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_STATE,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS,
+                sizeof(LocalAddr.SockAddr),
+                &LocalAddr.SockAddr));
+    }
+    {
+        TestScopeLogger LogScope1("GetParam is not supported");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        QUIC_ADDR Addr = {0};
+        uint32_t BufferSize = sizeof(Addr);
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.GetParam(
+                QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS,
+                &BufferSize,
+                &Addr));
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_HANDOFF_STATE(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_HANDOFF_STATE");
+    {
+        TestScopeLogger LogScope1("GetParam before connected");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t BufferSize = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_STATE,
+            Connection.GetParam(
+                QUIC_PARAM_CONN_HANDOFF_STATE,
+                &BufferSize,
+                nullptr));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam empty");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint8_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_HANDOFF_STATE,
+                0,
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam truncated");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        const uint8_t State[] = { 1, 0, 0, 0, 1 }; // Format and QUIC version only.
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_HANDOFF_STATE,
+                sizeof(State),
+                State));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam unknown format version");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        const uint8_t State[] = { 2, 0, 0, 0, 1 };
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_HANDOFF_STATE,
+                sizeof(State),
+                State));
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_PARTITION_INDEX(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_PARTITION_INDEX");
+    {
+        TestScopeLogger LogScope1("SetParam is not allowed");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint16_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_PARTITION_INDEX,
+                sizeof(Dummy),
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("GetParam");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        SimpleGetParamTest(Connection.Handle, QUIC_PARAM_CONN_PARTITION_INDEX, sizeof(uint16_t), nullptr);
+    }
+    {
+        TestScopeLogger LogScope1("Matches ConnectionOpenInPartition");
+        MsQuicConnection Connection(Registration, 0);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint16_t PartitionIndex = UINT16_MAX;
+        uint32_t Length = sizeof(PartitionIndex);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_PARTITION_INDEX,
+                &Length,
+                &PartitionIndex));
+        TEST_EQUAL(PartitionIndex, 0);
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_SEND_RATE_LIMIT(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_SEND_RATE_LIMIT");
+    {
+        TestScopeLogger LogScope1("SetParam wrong length");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_SEND_RATE_LIMIT,
+                sizeof(Dummy),
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("GetParam Default");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint64_t Rate = 0;
+        SimpleGetParamTest(Connection.Handle, QUIC_PARAM_CONN_SEND_RATE_LIMIT, sizeof(Rate), &Rate);
+    }
+    {
+        TestScopeLogger LogScope1("SetParam/GetParam");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint64_t Rate = 1000000;
+        TEST_QUIC_SUCCEEDED(
+            Connection.SetParam(
+                QUIC_PARAM_CONN_SEND_RATE_LIMIT,
+                sizeof(Rate),
+                &Rate));
+        uint64_t GetValue = 0;
+        uint32_t Length = sizeof(GetValue);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_SEND_RATE_LIMIT,
+                &Length,
+                &GetValue));
+        TEST_EQUAL(GetValue, Rate);
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY");
+    {
+        TestScopeLogger LogScope1("SetParam wrong length");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint64_t Dummy = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY,
+                sizeof(Dummy),
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam below minimum");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t DelayMs = 1;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY,
+                sizeof(DelayMs),
+                &DelayMs));
+    }
+    {
+        TestScopeLogger LogScope1("GetParam Default");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t DelayMs = 0;
+        SimpleGetParamTest(Connection.Handle, QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY, sizeof(DelayMs), &DelayMs);
+    }
+    {
+        TestScopeLogger LogScope1("SetParam/GetParam");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint32_t DelayMs = 250;
+        TEST_QUIC_SUCCEEDED(
+            Connection.SetParam(
+                QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY,
+                sizeof(DelayMs),
+                &DelayMs));
+        uint32_t GetValue = 0;
+        uint32_t Length = sizeof(GetValue);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY,
+                &Length,
+                &GetValue));
+        TEST_EQUAL(GetValue, DelayMs);
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+void QuicTest_QUIC_PARAM_CONN_ACK_ONLY_DSCP(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_ACK_ONLY_DSCP");
+    {
+        TestScopeLogger LogScope1("SetParam non-DSCP number");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint8_t Dummy = 64;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_ACK_ONLY_DSCP,
+                sizeof(Dummy),
+                &Dummy));
+    }
+    {
+        TestScopeLogger LogScope1("GetParam follows SEND_DSCP");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint8_t Dscp = CXPLAT_DSCP_EF;
+        TEST_QUIC_SUCCEEDED(
+            Connection.SetParam(
+                QUIC_PARAM_CONN_SEND_DSCP,
+                sizeof(Dscp),
+                &Dscp));
+        uint8_t GetValue = 0;
+        uint32_t Length = sizeof(GetValue);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_ACK_ONLY_DSCP,
+                &Length,
+                &GetValue));
+        TEST_EQUAL(GetValue, Dscp);
+    }
+    {
+        TestScopeLogger LogScope1("SetParam/GetParam");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        uint8_t Dscp = CXPLAT_DSCP_LE;
+        TEST_QUIC_SUCCEEDED(
+            Connection.SetParam(
+                QUIC_PARAM_CONN_ACK_ONLY_DSCP,
+                sizeof(Dscp),
+                &Dscp));
+        uint8_t GetValue = 0;
+        uint32_t Length = sizeof(GetValue);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_ACK_ONLY_DSCP,
+                &Length,
+                &GetValue));
+        TEST_EQUAL(GetValue, Dscp);
+    }
+#else
+    UNREFERENCED_PARAMETER(Registration);
+#endif
+}
+
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+static
+QUIC_STATUS
+QUIC_API
+DummyPeerStreamCallback(
+    _In_ HQUIC,
+    _In_opt_ void*,
+    _Inout_ QUIC_STREAM_EVENT*
+    )
+{
+    return QUIC_STATUS_SUCCESS;
+}
+#endif
+
+void QuicTest_QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE(MsQuicRegistration& Registration)
+{
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    TestScopeLogger LogScope0("QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE");
+    {
+        TestScopeLogger LogScope1("SetParam unsupported flags");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        QUIC_PEER_STREAM_TEMPLATE Template = {
+            DummyPeerStreamCallback, nullptr, nullptr, QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL };
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE,
+                sizeof(Template),
+                &Template));
+    }
+    {
+        TestScopeLogger LogScope1("SetParam/GetParam");
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+
+        QUIC_PEER_STREAM_TEMPLATE Template = {0};
+        uint32_t Length = sizeof(Template);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE,
+                &Length,
+                &Template));
+        TEST_EQUAL(Length, sizeof(Template));
+        TEST_EQUAL(Template.Handler, nullptr);
+
+        Template.Handler = DummyPeerStreamCallback;
+        Template.Context = &Connection;
+        Template.Flags = QUIC_STREAM_OPEN_FLAG_DELAY_ID_FC_UPDATES;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            Connection.SetParam(
+                QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE,
+                sizeof(Template) - 1,
+                &Template));
+        TEST_QUIC_SUCCEEDED(
+            Connection.SetParam(
+                QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE,
+                sizeof(Template),
+                &Template));
+
+        QUIC_PEER_STREAM_TEMPLATE Actual = {0};
+        Length = sizeof(Actual);
+        TEST_QUIC_SUCCEEDED(
+            Connection.GetParam(
+                QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE,
+                &Length,
+                &Actual));
+        TEST_EQUAL(Actual.Handler, Template.Handler);
+        TEST_EQUAL(Actual.Context, Template.Context);
+        TEST_EQUAL(Actual.Flags, Template.Flags);
+
+        QUIC_PEER_STREAM_TEMPLATE Cleared = {0};
+        TEST_QUIC_SUCCEEDED(
+            Connection.SetParam(
+                QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE,
+                sizeof(Cleared),
+                &Cleared));
     }
 #else
     UNREFERENCED_PARAMETER(Registration);
@@ -5019,6 +6082,14 @@ void QuicTestConnectionParam()
     QuicTest_QUIC_PARAM_CONN_SEND_DSCP(Registration);
     QuicTest_QUIC_PARAM_CONN_NETWORK_STATISTICS(Registration);
     QuicTest_QUIC_PARAM_CONN_CLOSE_ASYNC(Registration);
+    QuicTest_QUIC_PARAM_CONN_DATAGRAM_SEND_TIMEOUT(Registration);
+    QuicTest_QUIC_PARAM_CONN_STANDBY_LOCAL_ADDRESS(Registration);
+    QuicTest_QUIC_PARAM_CONN_HANDOFF_STATE(Registration);
+    QuicTest_QUIC_PARAM_CONN_PARTITION_INDEX(Registration);
+    QuicTest_QUIC_PARAM_CONN_SEND_RATE_LIMIT(Registration);
+    QuicTest_QUIC_PARAM_CONN_HAPPY_EYEBALLS_DELAY(Registration);
+    QuicTest_QUIC_PARAM_CONN_ACK_ONLY_DSCP(Registration);
+    QuicTest_QUIC_PARAM_CONN_PEER_STREAM_TEMPLATE(Registration);
 }
 
 //
@@ -5628,6 +6699,306 @@ void QuicTestStreamParam()
         }
     }
 
+#ifdef QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY
+    //
+    // QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY");
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
+        Stream.Start(QUIC_STREAM_START_FLAG_IMMEDIATE); // IMMEDIATE to set Stream->SendFlags != 0
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            QUIC_STREAM_EXTENSIBLE_PRIORITY Invalid = { 8, FALSE };
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    sizeof(Invalid),
+                    &Invalid));
+
+            QUIC_STREAM_EXTENSIBLE_PRIORITY Expected = { 1, TRUE };
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    sizeof(Expected),
+                    &Expected));
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY));
+
+            QUIC_STREAM_EXTENSIBLE_PRIORITY Priority = { 0, FALSE };
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    &Length,
+                    &Priority));
+            TEST_EQUAL(Priority.Urgency, 1);
+            TEST_TRUE(Priority.Incremental);
+
+            //
+            // Urgency 1 sorts above the default priority.
+            //
+            uint16_t SendPriority = 0;
+            Length = sizeof(SendPriority);
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_PRIORITY,
+                    &Length,
+                    &SendPriority));
+            TEST_TRUE(SendPriority > 0x7FFF);
+        }
+    }
+#endif
+
+#ifdef QUIC_PARAM_STREAM_WEIGHT
+    //
+    // QUIC_PARAM_STREAM_WEIGHT
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_STREAM_WEIGHT");
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            uint16_t Weight = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_WEIGHT,
+                    sizeof(Weight),
+                    &Weight));
+
+            Weight = 100;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_WEIGHT,
+                    sizeof(Weight),
+                    &Weight));
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_WEIGHT,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, sizeof(uint16_t));
+
+            uint16_t Weight = 0;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_WEIGHT,
+                    &Length,
+                    &Weight));
+            TEST_EQUAL(Weight, 100);
+        }
+    }
+#endif
+
+#ifdef QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING
+    //
+    // QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING");
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            uint16_t Invalid = 1;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING,
+                    sizeof(Invalid),
+                    &Invalid));
+
+            uint32_t Interval = 10;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING,
+                    sizeof(Interval),
+                    &Interval));
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, sizeof(uint32_t));
+
+            uint32_t Interval = 0;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_LATENCY_SAMPLING,
+                    &Length,
+                    &Interval));
+            TEST_EQUAL(Interval, 10u);
+        }
+    }
+#endif
+
+#ifdef QUIC_PARAM_STREAM_SEND_TIMEOUT
+    //
+    // QUIC_PARAM_STREAM_SEND_TIMEOUT
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_STREAM_SEND_TIMEOUT");
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            uint16_t Invalid = 1;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_TIMEOUT,
+                    sizeof(Invalid),
+                    &Invalid));
+
+            uint32_t TimeoutMs = 100;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_TIMEOUT,
+                    sizeof(TimeoutMs),
+                    &TimeoutMs));
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_TIMEOUT,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, sizeof(uint32_t));
+
+            uint32_t TimeoutMs = 0;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_TIMEOUT,
+                    &Length,
+                    &TimeoutMs));
+            TEST_EQUAL(TimeoutMs, 100u);
+        }
+    }
+#endif
+
+#ifdef QUIC_PARAM_STREAM_SEND_RATE_LIMIT
+    //
+    // QUIC_PARAM_STREAM_SEND_RATE_LIMIT
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_STREAM_SEND_RATE_LIMIT");
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            uint32_t Invalid = 1;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_RATE_LIMIT,
+                    sizeof(Invalid),
+                    &Invalid));
+
+            uint64_t Rate = 125000;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_RATE_LIMIT,
+                    sizeof(Rate),
+                    &Rate));
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_RATE_LIMIT,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, sizeof(uint64_t));
+
+            uint64_t Rate = 0;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_SEND_RATE_LIMIT,
+                    &Length,
+                    &Rate));
+            TEST_EQUAL(Rate, 125000u);
+        }
+    }
+#endif
+
     //
     // QUIC_PARAM_STREAM_STATISTICS
     //
@@ -6774,6 +8145,40 @@ QuicTestValidateExecutionContext(const uint32_t EcCount)
         }
     }
 
+    //
+    // Verify ECs can be polled together within a budget.
+    //
+    {
+        MsQuicExecution Execution(EventQs.get(), EcCount, QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_NONE);
+        TEST_TRUE(Execution.IsValid());
+
+        MsQuicRegistration Registration;
+        TEST_TRUE(Registration.IsValid());
+
+        for (uint32_t i = 0; i < PollCount; i++) {
+            MsQuic->ExecutionPollBatch(EcCount, Execution.Executions, 1000, 0);
+            MsQuic->ExecutionPollBatch(EcCount, Execution.Executions, 0, 1);
+            for (uint32_t j = 0; j < EcCount; j++) {
+                QuicTestProcessEventQ(EventQs[j], 0);
+            }
+        }
+
+        RegistrationCloseContext CloseContext;
+        Registration.CloseAsync(RegistrationCloseCallback, &CloseContext);
+        TEST_QUIC_SUCCEEDED(
+            TryUntil(1, TestWaitTimeout, [&](){
+                MsQuic->ExecutionPollBatch(EcCount, Execution.Executions, 1000, 0);
+                for (uint32_t i = 0; i < EcCount; i++) {
+                    QuicTestProcessEventQ(EventQs[i], 0);
+                }
+                if (CloseContext.Event.WaitTimeout(0)) {
+                    return QUIC_STATUS_SUCCESS;
+                }
+                return QUIC_STATUS_CONTINUE;
+            })
+        );
+    }
+
     //
     // Verify EC interaction with registrations: registrations can be opened and
     // closed while running in EC mode.
@@ -4477,4 +4477,189 @@ QuicTestConnectionPoolCreate(
         }
     }
 }
+
+struct ManagedConnectionPoolContext {
+    CxPlatEvent ShutdownCompleteEvent;
+    long ConnectedCount {0};
+
+    static QUIC_STATUS QUIC_API ConnCallback(_In_ MsQuicPooledConnection*, _In_opt_ void* Context, _Inout_ QUIC_CONNECTION_EVENT* Event) {
+        auto* This = (ManagedConnectionPoolContext*)Context;
+        if (Event->Type == QUIC_CONNECTION_EVENT_CONNECTED) {
+            InterlockedIncrement(&This->ConnectedCount);
+        } else if (Event->Type == QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE) {
+            This->ShutdownCompleteEvent.Set();
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    bool WaitForConnected(long Count) {
+        for (uint32_t i = 0; i < TestWaitTimeout / 10; ++i) {
+            if (ConnectedCount >= Count) {
+                return true;
+            }
+            CxPlatSleep(10);
+        }
+        return false;
+    }
+};
+
+void
+QuicTestConnectionPoolManaged(
+    const FamilyArgs& Params
+    )
+{
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Params.Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+    const uint16_t NumberOfConnections = 4;
+
+    MsQuicRegistration Registration(true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+    MsQuicAlpn Alpn("MsQuicTest");
+
+    MsQuicSettings Settings;
+    Settings.SetIdleTimeoutMs(TestWaitTimeout);
+    Settings.SetPeerBidiStreamCount(1);
+
+    MsQuicConfiguration ServerConfiguration(Registration, Alpn, Settings, ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicConfiguration ClientConfiguration(Registration, Alpn, Settings, MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, MsQuicConnection::NoOpCallback);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    QuicAddr ServerAddr(QuicAddrFamily);
+    TEST_QUIC_SUCCEEDED(Listener.Start(Alpn, ServerAddr));
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerAddr));
+
+    ManagedConnectionPoolContext Context;
+    MsQuicConnectionPool Pool(
+        Registration,
+        ClientConfiguration,
+        QUIC_LOCALHOST_FOR_AF(QuicAddrFamily),
+        ServerAddr.GetPort(),
+        NumberOfConnections,
+        QuicAddrFamily,
+        true,
+        ManagedConnectionPoolContext::ConnCallback,
+        &Context);
+    TEST_QUIC_SUCCEEDED(Pool.GetInitStatus());
+    TEST_TRUE(Context.WaitForConnected(NumberOfConnections));
+
+    //
+    // Each lease goes to the least loaded connection.
+    //
+    MsQuicPooledConnection* Leases[NumberOfConnections];
+    for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+        TEST_QUIC_SUCCEEDED(Pool.Acquire(&Leases[i]));
+        for (uint16_t j = 0; j < i; ++j) {
+            TEST_NOT_EQUAL(Leases[i], Leases[j]);
+        }
+    }
+
+    //
+    // A connection that goes away is replaced on the next Acquire. Its handle
+    // stays valid until its lease is released.
+    //
+    MsQuic->ConnectionShutdown(*Leases[0], QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    TEST_TRUE(Context.ShutdownCompleteEvent.WaitTimeout(TestWaitTimeout));
+    for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+        Pool.Release(Leases[i]);
+    }
+
+    MsQuicPooledConnection* Connection;
+    TEST_QUIC_SUCCEEDED(Pool.Acquire(&Connection));
+    Pool.Release(Connection);
+    TEST_TRUE(Context.WaitForConnected(NumberOfConnections + 1));
+}
+
+void
+QuicTestClientTicketCache(
+    const FamilyArgs& Params
+    )
+{
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Params.Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+
+    MsQuicRegistration Registration(true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    QUIC_CLIENT_TICKET_CACHE_CONFIG CacheConfig = {};
+    CacheConfig.MaxEntries = 4;
+    TEST_QUIC_SUCCEEDED(
+        MsQuic->SetParam(
+            Registration,
+            QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE,
+            sizeof(CacheConfig),
+            &CacheConfig));
+
+    MsQuicAlpn Alpn("MsQuicTest");
+    MsQuicSettings Settings;
+    Settings.SetIdleTimeoutMs(TestWaitTimeout);
+    Settings.SetServerResumptionLevel(QUIC_SERVER_RESUME_AND_ZERORTT);
+
+    MsQuicConfiguration ServerConfiguration(Registration, Alpn, Settings, ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicConfiguration ClientConfiguration(Registration, Alpn, Settings, MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+    MsQuicAutoAcceptListener Listener(
+        Registration,
+        ServerConfiguration,
+        [](MsQuicConnection* Conn, void*, QUIC_CONNECTION_EVENT* Event) {
+            if (Event->Type == QUIC_CONNECTION_EVENT_CONNECTED) {
+                MsQuic->ConnectionSendResumptionTicket(Conn->Handle, QUIC_SEND_RESUMPTION_FLAG_FINAL, 0, nullptr);
+            }
+            return QUIC_STATUS_SUCCESS;
+        });
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    QuicAddr ServerAddr(QuicAddrFamily);
+    TEST_QUIC_SUCCEEDED(Listener.Start(Alpn, ServerAddr));
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerAddr));
+
+    //
+    // The first connection saves the server's ticket, and the second resumes
+    // with it without the test setting it.
+    //
+    for (uint32_t i = 0; i < 2; ++i) {
+        TestConnection Client(Registration);
+        TEST_TRUE(Client.IsValid());
+
+        if (UseDuoNic) {
+            QuicAddr RemoteAddr{QuicAddrFamily, ServerAddr.GetPort()};
+            QuicAddrSetToDuoNic(&RemoteAddr.SockAddr);
+            TEST_QUIC_SUCCEEDED(Client.SetRemoteAddr(RemoteAddr));
+        }
+
+        TEST_QUIC_SUCCEEDED(
+            Client.Start(
+                ClientConfiguration,
+                QuicAddrFamily,
+                QUIC_LOCALHOST_FOR_AF(QuicAddrFamily),
+                ServerAddr.GetPort()));
+        TEST_TRUE(Client.WaitForConnectionComplete());
+        TEST_TRUE(Client.GetIsConnected());
+        TEST_EQUAL(Client.GetResumed(), (i != 0));
+
+        QUIC_BUFFER* ResumptionTicket = Client.WaitForResumptionTicket();
+        TEST_NOT_EQUAL(nullptr, ResumptionTicket);
+        CXPLAT_FREE(ResumptionTicket, QUIC_POOL_TEST);
+
+        Client.Shutdown(QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+        TEST_TRUE(Client.WaitForShutdownComplete());
+    }
+
+    QUIC_CLIENT_TICKET_CACHE_STATISTICS Stats = {};
+    uint32_t Length = sizeof(Stats);
+    TEST_QUIC_SUCCEEDED(
+        MsQuic->GetParam(
+            Registration,
+            QUIC_PARAM_REGISTRATION_CLIENT_TICKET_CACHE_STATS,
+            &Length,
+            &Stats));
+    TEST_EQUAL(Stats.Hits, 1u);
+    TEST_EQUAL(Stats.Misses, 1u);
+    TEST_EQUAL(Stats.Stored, 2u);
+    TEST_EQUAL(Stats.Entries, 1u);
+    TEST_EQUAL(Stats.VersionEntries, 1u);
+}
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
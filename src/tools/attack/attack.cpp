@@ -15,6 +15,7 @@
 #include "msquichelper.h"
 
 #include "packet_writer.h"
+#include "resilience.h"
 
 #define US_TO_MS(x) ((x) / 1000)
 
@@ -28,6 +29,14 @@
 
 #define ATTACK_PORT_DEFAULT 443
 
+#define BENCH_ALPN_DEFAULT "perf"
+
+#define BENCH_RESPONSE_SIZE_DEFAULT 65536
+
+#define BENCH_PARALLEL_DEFAULT 1
+
+#define BENCH_REQUEST_TIMEOUT_MS 5000
+
 const QUIC_HKDF_LABELS HkdfLabels = { "quic key", "quic iv", "quic hp", "quic ku" };
 
 static CXPLAT_DATAPATH* Datapath;
@@ -47,13 +56,30 @@ static uint64_t TimeStart;
 static int64_t TotalPacketCount;
 static int64_t TotalByteCount;
 
+//
+// Resilience benchmark mode: legitimate traffic is measured for BenchPhaseMs
+// without, and then with, the attack running.
+//
+static uint64_t BenchPhaseMs;
+static const char* BenchTarget;
+static QUIC_ADDR BenchAddress;
+static const char* BenchAlpn = BENCH_ALPN_DEFAULT;
+static uint64_t BenchResponseSize = BENCH_RESPONSE_SIZE_DEFAULT;
+static uint32_t BenchParallel = BENCH_PARALLEL_DEFAULT;
+
 void PrintUsage()
 {
     printf("quicattack is used for generating attack traffic towards a designated server.\n\n");
 
     printf("Usage:\n");
     printf("  quicattack.exe -list\n\n");
-    printf("  quicattack.exe -type:<number> -ip:<ip_address_and_port> [-alpn:<protocol_name>] [-sni:<host_name>] [-timeout:<ms>] [-threads:<count>] [-rate:<packet_rate>]\n\n");
+    printf("  quicattack.exe -type:<number> -ip:<ip_address_and_port> [-alpn:<protocol_name>] [-sni:<host_name>] [-timeout:<ms>] [-threads:<count>] [-rate:<packet_rate>]\n");
+    printf("                 [-bench:<phase_ms>] [-target:<ip_address_and_port>] [-benchalpn:<protocol_name>] [-respsize:<bytes>] [-parallel:<count>]\n\n");
+
+    printf("With -bench, legitimate request/response traffic (the secnetperf protocol, so\n");
+    printf("against a secnetperf server) is measured for phase_ms before the attack, and\n");
+    printf("again for phase_ms while it runs, and the goodput and latency degradation is\n");
+    printf("reported. -target defaults to the attacked address.\n\n");
 }
 
 void PrintUsageList()
@@ -64,7 +90,10 @@ void PrintUsageList()
     printf("#1 - Random UDP 1 byte UDP packets.\n");
     printf("#2 - Random UDP full length UDP packets.\n");
     printf("#3 - Random QUIC initial packets.\n");
-    printf("#4 - Valid QUIC initial packets.\n\n");
+    printf("#4 - Valid QUIC initial packets.\n");
+    printf("#5 - Random QUIC short header packets.\n");
+    printf("#6 - Fragmented QUIC initial packets (only the start of the ClientHello).\n");
+    printf("#7 - Replayed QUIC initial packets (the same valid packet repeatedly).\n\n");
 }
 
 struct CallbackContext {
@@ -115,7 +144,7 @@ ResolveRouteComplete(
     CxPlatEventSet(CContext->Event);
 }
 
-void RunAttackRandom(CXPLAT_SOCKET* Binding, uint16_t DatagramLength, bool ValidQuic, bool TCP = false)
+void RunAttackRandom(CXPLAT_SOCKET* Binding, uint16_t DatagramLength, bool ValidQuic, bool TCP = false, bool ShortHeader = false)
 {
     const uint16_t HeadersLength = ((TCP)? 20 : ((ValidQuic)? 8 + MIN_LONG_HEADER_LENGTH_V1 : 8)) + 20;
 
@@ -182,6 +211,12 @@ void RunAttackRandom(CXPLAT_SOCKET* Binding, uint16_t DatagramLength, bool Valid
                 QuicVarIntEncode(
                     DatagramLength - (MIN_LONG_HEADER_LENGTH_V1 + 19),
                     Header->DestCid + 18);
+            } else if (ShortHeader) {
+                //
+                // Short header with the fixed bit set, and a random
+                // destination CID, key phase and "encrypted" payload.
+                //
+                SendBuffer->Buffer[0] = (SendBuffer->Buffer[0] & 0x3F) | 0x40;
             }
 
             InterlockedExchangeAdd64(&TotalPacketCount, 1);
@@ -203,7 +238,66 @@ void RunAttackRandom(CXPLAT_SOCKET* Binding, uint16_t DatagramLength, bool Valid
     }
 }
 
-void RunAttackValidInitial(CXPLAT_SOCKET* Binding)
+void
+EncryptInitial(
+    _In_reads_(PacketLength) const uint8_t* Packet,
+    _In_ uint16_t PacketLength,
+    _In_ uint16_t HeaderLength,
+    _In_ uint16_t PacketNumberOffset,
+    _In_ uint64_t PacketNumber,
+    _In_ const StrBuffer& InitialSalt,
+    _Inout_ uint64_t* DestCid,
+    _Inout_ uint64_t* SrcCid,
+    _Inout_opt_ uint64_t* OrigSrcCid,
+    _Out_writes_(PacketLength) uint8_t* Buffer
+    )
+{
+    (*DestCid)++; (*SrcCid)++;
+    if (OrigSrcCid) {
+        *OrigSrcCid = *SrcCid;
+    }
+    memcpy(Buffer, Packet, PacketLength);
+
+    QUIC_PACKET_KEY* WriteKey;
+    VERIFY(
+    QUIC_SUCCEEDED(
+    QuicPacketKeyCreateInitial(
+        FALSE,
+        &HkdfLabels,
+        InitialSalt.Data,
+        sizeof(uint64_t),
+        (uint8_t*)DestCid,
+        nullptr,
+        &WriteKey)));
+
+    uint8_t Iv[CXPLAT_IV_LENGTH];
+    QuicCryptoCombineIvAndPacketNumber(
+        WriteKey->Iv, (uint8_t*)&PacketNumber, Iv);
+
+    CxPlatEncrypt(
+        WriteKey->PacketKey,
+        Iv,
+        HeaderLength,
+        Buffer,
+        PacketLength - HeaderLength,
+        Buffer + HeaderLength);
+
+    uint8_t HpMask[16];
+    CxPlatHpComputeMask(
+        WriteKey->HeaderKey,
+        1,
+        Buffer + HeaderLength,
+        HpMask);
+
+    QuicPacketKeyFree(WriteKey);
+
+    Buffer[0] ^= HpMask[0] & 0x0F;
+    for (uint8_t i = 0; i < 4; ++i) {
+        Buffer[PacketNumberOffset + i] ^= HpMask[i + 1];
+    }
+}
+
+void RunAttackValidInitial(CXPLAT_SOCKET* Binding, bool Fragment = false, bool Replay = false)
 {
     const StrBuffer InitialSalt("38762cf7f55934b34d179ae6a4c80cadccbb7f0a");
     const uint16_t DatagramLength = QUIC_MIN_INITIAL_LENGTH;
@@ -232,7 +326,8 @@ void RunAttackValidInitial(CXPLAT_SOCKET* Binding)
         sizeof(Packet),
         Packet,
         &PacketLength,
-        &HeaderLength);
+        &HeaderLength,
+        Fragment);
     uint16_t PacketNumberOffset = HeaderLength - sizeof(uint32_t);
 
     uint64_t* DestCid = (uint64_t*)(Packet + sizeof(QUIC_LONG_HEADER_V1));
@@ -244,7 +339,7 @@ void RunAttackValidInitial(CXPLAT_SOCKET* Binding)
             OrigSrcCid = (uint64_t*)&Packet[i];
         }
     }
-    if (!OrigSrcCid) {
+    if (!OrigSrcCid && !Fragment) {
         printf("Failed to find OrigSrcCid!\n");
         return;
     }
@@ -252,6 +347,12 @@ void RunAttackValidInitial(CXPLAT_SOCKET* Binding)
     CxPlatRandom(sizeof(uint64_t), DestCid);
     CxPlatRandom(sizeof(uint64_t), SrcCid);
 
+    //
+    // Replays send the same encrypted packet over and over.
+    //
+    uint8_t EncryptedPacket[sizeof(Packet)];
+    bool Encrypted = false;
+
     uint64_t BucketTime = CxPlatTimeMs64(), CurTime;
     uint64_t BucketCount = 0;
     uint64_t BucketThreshold = CXPLAT_MAX(1, AttackRate / ThreadCount);
@@ -280,47 +381,14 @@ void RunAttackValidInitial(CXPLAT_SOCKET* Binding)
                 continue;
             }
 
-            (*DestCid)++; (*SrcCid)++;
-            *OrigSrcCid = *SrcCid;
-            memcpy(SendBuffer->Buffer, Packet, PacketLength);
-
-            QUIC_PACKET_KEY* WriteKey;
-            VERIFY(
-            QUIC_SUCCEEDED(
-            QuicPacketKeyCreateInitial(
-                FALSE,
-                &HkdfLabels,
-                InitialSalt.Data,
-                sizeof(uint64_t),
-                (uint8_t*)DestCid,
-                nullptr,
-                &WriteKey)));
-
-            uint8_t Iv[CXPLAT_IV_LENGTH];
-            QuicCryptoCombineIvAndPacketNumber(
-                WriteKey->Iv, (uint8_t*)&PacketNumber, Iv);
-
-            CxPlatEncrypt(
-                WriteKey->PacketKey,
-                Iv,
-                HeaderLength,
-                SendBuffer->Buffer,
-                PacketLength - HeaderLength,
-                SendBuffer->Buffer + HeaderLength);
-
-            uint8_t HpMask[16];
-            CxPlatHpComputeMask(
-                WriteKey->HeaderKey,
-                1,
-                SendBuffer->Buffer + HeaderLength,
-                HpMask);
-
-            QuicPacketKeyFree(WriteKey);
-
-            SendBuffer->Buffer[0] ^= HpMask[0] & 0x0F;
-            for (uint8_t i = 0; i < 4; ++i) {
-                SendBuffer->Buffer[PacketNumberOffset + i] ^= HpMask[i + 1];
+            if (!Replay || !Encrypted) {
+                EncryptInitial(
+                    Packet, PacketLength, HeaderLength, PacketNumberOffset,
+                    PacketNumber, InitialSalt, DestCid, SrcCid, OrigSrcCid,
+                    EncryptedPacket);
+                Encrypted = true;
             }
+            memcpy(SendBuffer->Buffer, EncryptedPacket, PacketLength);
 
             InterlockedExchangeAdd64(&TotalPacketCount, 1);
             InterlockedExchangeAdd64(&TotalByteCount, DatagramLength + MIN_LONG_HEADER_LENGTH_V1);
@@ -371,6 +439,15 @@ CXPLAT_THREAD_CALLBACK(RunAttackThread, /* Context */)
     case 4:
         RunAttackValidInitial(Binding);
         break;
+    case 5:
+        RunAttackRandom(Binding, QUIC_MIN_INITIAL_LENGTH, false, false, true);
+        break;
+    case 6:
+        RunAttackValidInitial(Binding, true);
+        break;
+    case 7:
+        RunAttackValidInitial(Binding, false, true);
+        break;
     default:
         break;
     }
@@ -380,7 +457,7 @@ CXPLAT_THREAD_CALLBACK(RunAttackThread, /* Context */)
     CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
 }
 
-void RunAttack()
+void RunAttack(const ResilienceResults* Baseline)
 {
     Writer = new PacketWriter(Version, Alpn, ServerName);
     CXPLAT_THREAD* Threads =
@@ -400,6 +477,17 @@ void RunAttack()
         CxPlatThreadCreate(&ThreadConfig, &Threads[i]);
     }
 
+    ResilienceResults Results;
+    if (Baseline != nullptr) {
+        RunResilienceWorkload(
+            &BenchAddress,
+            ServerName ? ServerName : "localhost",
+            TimeoutMs,
+            BenchResponseSize,
+            BenchParallel,
+            &Results);
+    }
+
     for (uint32_t i = 0; i < ThreadCount; ++i) {
         CxPlatThreadWait(&Threads[i]);
         CxPlatThreadDelete(&Threads[i]);
@@ -410,9 +498,40 @@ void RunAttack()
     printf("Bit Rate: %llu mbps\n", (unsigned long long)(8 * TotalByteCount) / (1000 * CxPlatTimeDiff64(TimeStart, TimeEnd)));
     CXPLAT_FREE(Threads, QUIC_POOL_TOOL);
 
+    if (Baseline != nullptr) {
+        PrintResilienceResults("Attack", &Results, Baseline);
+    }
+
     delete Writer;
 }
 
+bool RunBenchmark()
+{
+    if (!ResilienceInitialize(BenchAlpn, BENCH_REQUEST_TIMEOUT_MS)) {
+        ResilienceUninitialize();
+        return false;
+    }
+
+    TimeoutMs = BenchPhaseMs;
+
+    ResilienceResults Baseline;
+    printf("Measuring the baseline for %llu ms.\n", (unsigned long long)BenchPhaseMs);
+    RunResilienceWorkload(
+        &BenchAddress,
+        ServerName ? ServerName : "localhost",
+        BenchPhaseMs,
+        BenchResponseSize,
+        BenchParallel,
+        &Baseline);
+    PrintResilienceResults("Baseline", &Baseline, nullptr);
+
+    printf("Measuring under attack for %llu ms.\n", (unsigned long long)BenchPhaseMs);
+    RunAttack(&Baseline);
+
+    ResilienceUninitialize();
+    return true;
+}
+
 int
 QUIC_MAIN_EXPORT
 main(
@@ -428,7 +547,7 @@ main(
         PrintUsageList();
         ErrorCode = 0;
     } else if (!TryGetValue(argc, argv, "type", &AttackType) ||
-        (AttackType <= 0 || AttackType > 4)) {
+        (AttackType <= 0 || AttackType > 7)) {
         PrintUsage();
     } else {
         const CXPLAT_UDP_DATAPATH_CALLBACKS DatapathCallbacks = {
@@ -455,6 +574,14 @@ main(
         if (!TryGetValue(argc, argv, "threads", &ThreadCount)) {
             ThreadCount = ATTACK_THREADS_DEFAULT;
         };
+        TryGetValue(argc, argv, "bench", &BenchPhaseMs);
+        TryGetValue(argc, argv, "target", &BenchTarget);
+        TryGetValue(argc, argv, "benchalpn", &BenchAlpn);
+        TryGetValue(argc, argv, "respsize", &BenchResponseSize);
+        TryGetValue(argc, argv, "parallel", &BenchParallel);
+        if (BenchParallel == 0) {
+            BenchParallel = BENCH_PARALLEL_DEFAULT;
+        }
 
         if (IpAddress == nullptr) {
             if (ServerName == nullptr) {
@@ -482,7 +609,21 @@ main(
             goto Error;
         }
 
-        RunAttack();
+        BenchAddress = ServerAddress;
+        if (BenchTarget != nullptr &&
+            (!QuicAddrFromString(BenchTarget, ATTACK_PORT_DEFAULT, &BenchAddress) ||
+             QuicAddrGetPort(&BenchAddress) == 0)) {
+            printf("Invalid -target:'%s' specified!\n", BenchTarget);
+            goto Error;
+        }
+
+        if (BenchPhaseMs != 0) {
+            if (!RunBenchmark()) {
+                goto Error;
+            }
+        } else {
+            RunAttack(nullptr);
+        }
         ErrorCode = 0;
 
         Error:
@@ -218,20 +218,13 @@ PacketWriter::PacketWriter(
     )
 {
     QuicVersion = Version;
-    uint16_t BufferSize = sizeof(CryptoBuffer);
-    CryptoBufferLength = 0;
-    WriteInitialCryptoFrame(
-        Alpn, Sni, &CryptoBufferLength, BufferSize, CryptoBuffer);
+    WriteInitialCryptoFrames(Alpn, Sni);
 }
 
 void
-PacketWriter::WriteInitialCryptoFrame(
+PacketWriter::WriteInitialCryptoFrames(
     _In_z_ const char* Alpn,
-    _In_z_ const char* Sni,
-    _Inout_ uint16_t* Offset,
-    _In_ uint16_t BufferLength,
-    _Out_writes_to_(BufferLength, *Offset)
-        uint8_t* Buffer
+    _In_z_ const char* Sni
     )
 {
     TlsContext ClientContext(Alpn, Sni);
@@ -241,11 +234,27 @@ PacketWriter::WriteInitialCryptoFrame(
         0, ClientContext.State.BufferLength, ClientContext.State.Buffer
     };
 
+    CryptoBufferLength = 0;
     if (!QuicCryptoFrameEncode(
             &Frame,
-            Offset,
-            BufferLength,
-            Buffer)) {
+            &CryptoBufferLength,
+            sizeof(CryptoBuffer),
+            CryptoBuffer)) {
+        printf("QuicCryptoFrameEncode failure!\n");
+        exit(0);
+    }
+
+    //
+    // Only the start of the ClientHello, so the server has to hold on to it
+    // while it waits for the rest.
+    //
+    Frame.Length = CXPLAT_MIN(Frame.Length, FRAGMENT_CRYPTO_LENGTH);
+    FragmentBufferLength = 0;
+    if (!QuicCryptoFrameEncode(
+            &Frame,
+            &FragmentBufferLength,
+            sizeof(FragmentBuffer),
+            FragmentBuffer)) {
         printf("QuicCryptoFrameEncode failure!\n");
         exit(0);
     }
@@ -259,9 +268,13 @@ PacketWriter::WriteClientInitialPacket(
     _Out_writes_to_(BufferLength, *PacketLength)
         uint8_t* Buffer,
     _Out_ uint16_t* PacketLength,
-    _Out_ uint16_t* HeaderLength
+    _Out_ uint16_t* HeaderLength,
+    _In_ bool Fragment
     )
 {
+    const uint8_t* Payload = Fragment ? FragmentBuffer : CryptoBuffer;
+    const uint16_t PayloadLength = Fragment ? FragmentBufferLength : CryptoBufferLength;
+
     uint8_t CidBuffer[sizeof(QUIC_CID) + 256] = {0};
     QUIC_CID* Cid = (QUIC_CID*)CidBuffer;
     Cid->IsInitial = TRUE;
@@ -283,17 +296,17 @@ PacketWriter::WriteClientInitialPacket(
             Buffer,
             &PayloadLengthOffset,
             &PacketNumberLength);
-    if (*PacketLength + CryptoBufferLength > BufferLength) {
+    if (*PacketLength + PayloadLength > BufferLength) {
         printf("Crypto Too Big!\n");
         exit(0);
     }
 
     QuicVarIntEncode2Bytes(
-        PacketNumberLength + CryptoBufferLength + CXPLAT_ENCRYPTION_OVERHEAD,
+        PacketNumberLength + PayloadLength + CXPLAT_ENCRYPTION_OVERHEAD,
         Buffer + PayloadLengthOffset);
     *HeaderLength = *PacketLength;
 
-    CxPlatCopyMemory(Buffer + *PacketLength, CryptoBuffer, CryptoBufferLength);
-    *PacketLength += CryptoBufferLength;
+    CxPlatCopyMemory(Buffer + *PacketLength, Payload, PayloadLength);
+    *PacketLength += PayloadLength;
     *PacketLength += CXPLAT_ENCRYPTION_OVERHEAD;
 }
@@ -11,21 +11,23 @@
 
 extern const QUIC_HKDF_LABELS HkdfLabels;
 
+//
+// The number of ClientHello bytes carried by a fragmented Initial packet.
+//
+#define FRAGMENT_CRYPTO_LENGTH 64
+
 class PacketWriter
 {
     uint32_t QuicVersion;
     uint8_t CryptoBuffer[4096];
     uint16_t CryptoBufferLength;
+    uint8_t FragmentBuffer[128];        // CRYPTO frame with just the start of the ClientHello
+    uint16_t FragmentBufferLength;
 
-    static
     void
-    WriteInitialCryptoFrame(
+    WriteInitialCryptoFrames(
         _In_z_ const char* Alpn,
-        _In_z_ const char* Sni,
-        _Inout_ uint16_t* Offset,
-        _In_ uint16_t BufferLength,
-        _Out_writes_to_(BufferLength, *Offset)
-            uint8_t* Buffer
+        _In_z_ const char* Sni
         );
 
 public:
@@ -44,6 +46,7 @@ public:
         _Out_writes_to_(BufferLength, *PacketLength)
             uint8_t* Buffer,
         _Out_ uint16_t* PacketLength,
-        _Out_ uint16_t* HeaderLength
+        _Out_ uint16_t* HeaderLength,
+        _In_ bool Fragment = false
         );
 };
@@ -0,0 +1,277 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Legitimate request/response traffic (the secnetperf protocol) run against
+    the server, so its goodput and latency can be compared with and without an
+    attack running.
+
+--*/
+
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+#include "quic_datapath.h"
+#include "msquic.hpp"
+#include "msquichelper.h"
+
+#include "resilience.h"
+
+const MsQuicApi* MsQuic;
+static MsQuicRegistration* Registration;
+static MsQuicConfiguration* Configuration;
+
+struct ResilienceRequest {
+    CxPlatEvent Complete;
+    uint64_t ResponseSize;
+    uint64_t StartTime {0};
+    uint64_t Latency {0};
+    uint64_t BytesReceived {0};
+    bool Succeeded {false};
+};
+
+struct ResilienceWorker {
+    QuicAddr Target;
+    const char* ServerName;
+    uint64_t ResponseSize;
+    uint64_t EndTime;
+    std::vector<uint64_t> Latencies;
+    uint64_t Failures {0};
+    uint64_t Bytes {0};
+    CxPlatThread Thread;
+};
+
+static
+QUIC_STATUS
+QUIC_API
+RequestStreamCallback(
+    _In_ MsQuicStream* Stream,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_STREAM_EVENT* Event
+    )
+{
+    auto Request = (ResilienceRequest*)Context;
+    switch (Event->Type) {
+    case QUIC_STREAM_EVENT_RECEIVE:
+        Request->BytesReceived += Event->RECEIVE.TotalBufferLength;
+        break;
+    case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
+        if (Request->BytesReceived == Request->ResponseSize) {
+            Request->Latency = CxPlatTimeUs64() - Request->StartTime;
+            Request->Succeeded = true;
+        }
+        break;
+    case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+        Stream->ConnectionShutdown(0);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+static
+QUIC_STATUS
+QUIC_API
+RequestConnectionCallback(
+    _In_ MsQuicConnection* /* Connection */,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    )
+{
+    if (Event->Type == QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE) {
+        ((ResilienceRequest*)Context)->Complete.Set();
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Opens a new connection, sends one request for ResponseSize bytes and waits
+// for the connection to be shut down. The connection's idle timeouts bound
+// how long this takes.
+//
+static
+bool
+RunRequest(
+    _In_ ResilienceWorker* Worker
+    )
+{
+    ResilienceRequest Request;
+    Request.ResponseSize = Worker->ResponseSize;
+    uint64_t RequestHeader = CxPlatByteSwapUint64(Worker->ResponseSize);
+    QUIC_BUFFER Buffer = { sizeof(RequestHeader), (uint8_t*)&RequestHeader };
+
+    MsQuicConnection Connection(*Registration, CleanUpManual, RequestConnectionCallback, &Request);
+    MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE, CleanUpManual, RequestStreamCallback, &Request);
+    if (!Stream.IsValid() || QUIC_FAILED(Connection.SetRemoteAddr(Worker->Target))) {
+        return false;
+    }
+
+    Request.StartTime = CxPlatTimeUs64();
+    if (QUIC_FAILED(Connection.Start(*Configuration, Worker->ServerName, Worker->Target.GetPort()))) {
+        return false;
+    }
+    if (QUIC_FAILED(Stream.Send(&Buffer, 1, QUIC_SEND_FLAG_START | QUIC_SEND_FLAG_FIN))) {
+        Connection.Shutdown(0);
+    }
+    Request.Complete.WaitForever();
+
+    Worker->Bytes += Request.BytesReceived;
+    if (Request.Succeeded) {
+        Worker->Latencies.push_back(Request.Latency);
+    }
+    return Request.Succeeded;
+}
+
+CXPLAT_THREAD_CALLBACK(ResilienceWorkerThread, Context)
+{
+    auto Worker = (ResilienceWorker*)Context;
+    while (CxPlatTimeUs64() < Worker->EndTime) {
+        if (!RunRequest(Worker)) {
+            Worker->Failures++;
+        }
+    }
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
+bool
+ResilienceInitialize(
+    _In_z_ const char* Alpn,
+    _In_ uint32_t TimeoutMs
+    )
+{
+    MsQuic = new(std::nothrow) MsQuicApi();
+    if (MsQuic == nullptr || QUIC_FAILED(MsQuic->GetInitStatus())) {
+        printf("MsQuicOpen2 failed!\n");
+        return false;
+    }
+
+    Registration = new(std::nothrow) MsQuicRegistration("quicattack");
+    if (Registration == nullptr || !Registration->IsValid()) {
+        printf("RegistrationOpen failed!\n");
+        return false;
+    }
+
+    MsQuicSettings Settings;
+    Settings.SetHandshakeIdleTimeoutMs(TimeoutMs);
+    Settings.SetIdleTimeoutMs(TimeoutMs);
+    MsQuicCredentialConfig CredConfig(
+        QUIC_CREDENTIAL_FLAG_CLIENT | QUIC_CREDENTIAL_FLAG_NO_CERTIFICATE_VALIDATION);
+    Configuration =
+        new(std::nothrow) MsQuicConfiguration(
+            *Registration, MsQuicAlpn(Alpn), Settings, CredConfig);
+    if (Configuration == nullptr || !Configuration->IsValid()) {
+        printf("ConfigurationOpen failed!\n");
+        return false;
+    }
+
+    return true;
+}
+
+void
+ResilienceUninitialize(
+    void
+    )
+{
+    delete Configuration;
+    Configuration = nullptr;
+    delete Registration;
+    Registration = nullptr;
+    delete MsQuic;
+    MsQuic = nullptr;
+}
+
+void
+RunResilienceWorkload(
+    _In_ const QUIC_ADDR* Target,
+    _In_z_ const char* ServerName,
+    _In_ uint64_t DurationMs,
+    _In_ uint64_t ResponseSize,
+    _In_ uint32_t Parallel,
+    _Out_ ResilienceResults* Results
+    )
+{
+    CxPlatZeroMemory(Results, sizeof(*Results));
+    std::vector<ResilienceWorker> Workers(Parallel);
+
+    const uint64_t StartTime = CxPlatTimeUs64();
+    for (auto& Worker : Workers) {
+        Worker.Target.SockAddr = *Target;
+        Worker.ServerName = ServerName;
+        Worker.ResponseSize = ResponseSize;
+        Worker.EndTime = StartTime + MS_TO_US(DurationMs);
+        CXPLAT_THREAD_CONFIG ThreadConfig = {
+            0,
+            0,
+            "ResilienceWorker",
+            ResilienceWorkerThread,
+            &Worker
+        };
+        if (QUIC_FAILED(Worker.Thread.Create(&ThreadConfig))) {
+            printf("Failed to create workload thread!\n");
+        }
+    }
+
+    std::vector<uint64_t> Latencies;
+    for (auto& Worker : Workers) {
+        Worker.Thread.Wait();
+        Latencies.insert(Latencies.end(), Worker.Latencies.begin(), Worker.Latencies.end());
+        Results->Failures += Worker.Failures;
+        Results->Bytes += Worker.Bytes;
+    }
+    Results->DurationUs = CxPlatTimeUs64() - StartTime;
+    Results->Requests = Latencies.size();
+
+    if (!Latencies.empty()) {
+        std::sort(Latencies.begin(), Latencies.end());
+        Results->LatencyP50Us = Latencies[Latencies.size() / 2];
+        Results->LatencyP99Us = Latencies[(Latencies.size() * 99) / 100];
+        Results->LatencyMaxUs = Latencies.back();
+    }
+}
+
+static
+double
+PercentChange(
+    _In_ uint64_t Value,
+    _In_ uint64_t Baseline
+    )
+{
+    return Baseline == 0 ? 0.0 : 100.0 * ((double)Value - (double)Baseline) / (double)Baseline;
+}
+
+void
+PrintResilienceResults(
+    _In_z_ const char* Name,
+    _In_ const ResilienceResults* Results,
+    _In_opt_ const ResilienceResults* Baseline
+    )
+{
+    const uint64_t DurationUs = CXPLAT_MAX(1, Results->DurationUs);
+    const uint64_t Goodput = (8 * Results->Bytes * 1000000) / DurationUs; // bps
+    printf(
+        "%s: %llu requests (%llu failed), %llu req/s, goodput %llu kbps, latency p50 %llu us, p99 %llu us, max %llu us\n",
+        Name,
+        (unsigned long long)Results->Requests,
+        (unsigned long long)Results->Failures,
+        (unsigned long long)((Results->Requests * 1000000) / DurationUs),
+        (unsigned long long)(Goodput / 1000),
+        (unsigned long long)Results->LatencyP50Us,
+        (unsigned long long)Results->LatencyP99Us,
+        (unsigned long long)Results->LatencyMaxUs);
+
+    if (Baseline != nullptr) {
+        const uint64_t BaselineGoodput =
+            (8 * Baseline->Bytes * 1000000) / CXPLAT_MAX(1, Baseline->DurationUs);
+        printf(
+            "Degradation: goodput %+.1f%%, latency p50 %+.1f%%, p99 %+.1f%%, failures %llu -> %llu\n",
+            PercentChange(Goodput, BaselineGoodput),
+            PercentChange(Results->LatencyP50Us, Baseline->LatencyP50Us),
+            PercentChange(Results->LatencyP99Us, Baseline->LatencyP99Us),
+            (unsigned long long)Baseline->Failures,
+            (unsigned long long)Results->Failures);
+    }
+}
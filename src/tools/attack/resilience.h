@@ -0,0 +1,54 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Legitimate request/response traffic (the secnetperf protocol) run against
+    the server, so its goodput and latency can be compared with and without an
+    attack running.
+
+--*/
+
+struct ResilienceResults {
+    uint64_t DurationUs;
+    uint64_t Requests;          // Requests that got their full response.
+    uint64_t Failures;          // Connections that failed or timed out.
+    uint64_t Bytes;             // Response bytes received.
+    uint64_t LatencyP50Us;      // From connection start to the full response.
+    uint64_t LatencyP99Us;
+    uint64_t LatencyMaxUs;
+};
+
+bool
+ResilienceInitialize(
+    _In_z_ const char* Alpn,
+    _In_ uint32_t TimeoutMs
+    );
+
+void
+ResilienceUninitialize(
+    void
+    );
+
+//
+// Runs Parallel loops, each opening a new connection per request, for
+// DurationMs.
+//
+void
+RunResilienceWorkload(
+    _In_ const QUIC_ADDR* Target,
+    _In_z_ const char* ServerName,
+    _In_ uint64_t DurationMs,
+    _In_ uint64_t ResponseSize,
+    _In_ uint32_t Parallel,
+    _Out_ ResilienceResults* Results
+    );
+
+void
+PrintResilienceResults(
+    _In_z_ const char* Name,
+    _In_ const ResilienceResults* Results,
+    _In_opt_ const ResilienceResults* Baseline
+    );
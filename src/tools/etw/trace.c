@@ -314,6 +314,27 @@ QuicTraceGlobalEvent(
             case QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH:
                 printf("    Current listeners queued for processing:            ");
                 break;
+            case QUIC_PERF_COUNTER_WORK_BUSY_TIME:
+                printf("    Total worker time processing connections (us):      ");
+                break;
+            case QUIC_PERF_COUNTER_MEMORY_USAGE:
+                printf("    Current buffer and connection memory (bytes):       ");
+                break;
+            case QUIC_PERF_COUNTER_CONN_HIBERNATING:
+                printf("    Current connections hibernating:                    ");
+                break;
+            case QUIC_PERF_COUNTER_ZERORTT_REPLAY_REJECT:
+                printf("    Total resumptions refused as replays:               ");
+                break;
+            case QUIC_PERF_COUNTER_XDP_BUSY_POLL_TIME:
+                printf("    Total XDP busy poll time (us):                      ");
+                break;
+            case QUIC_PERF_COUNTER_XDP_SLEEP_TIME:
+                printf("    Total XDP sleep between polls time (us):            ");
+                break;
+            case QUIC_PERF_COUNTER_XDP_INTERRUPT_TIME:
+                printf("    Total XDP wait for notification time (us):          ");
+                break;
             default:
                 printf("    Unknown:                                            ");
                 break;
@@ -8,7 +8,18 @@ Abstract:
     This tool creates a terminating QUIC proxy to forward all incoming traffic
     to a specified target.
 
-    N.B. Better synchronization between peer objects is needed around teardown.
+    By default, received data isn't copied: the receive buffers are passed
+    directly to the outbound send, and the receive is only completed once that
+    send completes. Each back-end connection is opened on the same partition
+    (worker) as its front-end connection, so both legs of every stream are
+    processed by the same thread. Each outbound leg stops receiving on its
+    inbound leg while it has at least its ideal send buffer size
+    (QUIC_STREAM_EVENT_IDEAL_SEND_BUFFER_SIZE) outstanding, which bounds the
+    data held by the proxy regardless of the flow control windows.
+
+    N.B. Better synchronization between peer objects is needed around teardown
+    if the two legs end up on different workers (e.g. after the front-end
+    connection is moved to another worker).
 
 --*/
 
@@ -16,13 +27,15 @@ Abstract:
 
 #include "msquichelper.h"
 #include "msquic.hpp"
+#include <atomic>
+#include <mutex>
 
 const char* Alpn;
 uint16_t FrontEndPort;
 const char* BackEndTarget;
 uint16_t BackEndPort;
 QUIC_CERTIFICATE_HASH Cert;
-bool BufferedMode = true;
+bool BufferedMode = false;
 uint32_t FlowControlWindow = 0;
 
 const MsQuicApi* MsQuic;
@@ -31,7 +44,7 @@ MsQuicConfiguration* FrontEndConfiguration;
 MsQuicConfiguration* BackEndConfiguration;
 
 #define USAGE \
-    "Usage: quicforward <alpn> <local-port> <target-name/ip>:<target-port> <thumbprint> [0/1-buffered-mode] [fc-window]\n"
+    "Usage: quicforward <alpn> <local-port> <target-name/ip>:<target-port> <thumbprint> [0/1-buffered-mode (def 0)] [fc-window]\n"
 
 bool ParseArgs(int argc, char **argv) {
     if (argc < 5) {
@@ -60,13 +73,21 @@ bool ParseArgs(int argc, char **argv) {
     return true;
 }
 
+//
+// The initial ideal send buffer size, until the outbound leg indicates its own.
+//
+#define INITIAL_IDEAL_SEND_BUFFER_SIZE 0x20000 // 128 KB
+
 struct ForwardedSend {
     uint64_t TotalLength;
-    QUIC_BUFFER Buffers[3];
+    uint32_t BufferCount;
+    QUIC_BUFFER Buffers[1]; // BufferCount long in zero-copy mode.
     static ForwardedSend* New(QUIC_STREAM_EVENT* Event) {
         if (BufferedMode) {
             auto SendContext = (ForwardedSend*)malloc(sizeof(ForwardedSend) + (size_t)Event->RECEIVE.TotalBufferLength);
+            if (!SendContext) { return nullptr; }
             SendContext->TotalLength = Event->RECEIVE.TotalBufferLength;
+            SendContext->BufferCount = 1;
             SendContext->Buffers[0].Buffer = (uint8_t*)SendContext + sizeof(ForwardedSend);
             SendContext->Buffers[0].Length = 0;
             for (uint32_t i = 0; i < Event->RECEIVE.BufferCount; ++i) {
@@ -78,8 +99,11 @@ struct ForwardedSend {
             }
             return SendContext;
         }
-        auto SendContext = new(std::nothrow) ForwardedSend;
+        auto SendContext =
+            (ForwardedSend*)malloc(sizeof(ForwardedSend) + (Event->RECEIVE.BufferCount - 1) * sizeof(QUIC_BUFFER));
+        if (!SendContext) { return nullptr; }
         SendContext->TotalLength = Event->RECEIVE.TotalBufferLength;
+        SendContext->BufferCount = Event->RECEIVE.BufferCount;
         for (uint32_t i = 0; i < Event->RECEIVE.BufferCount; ++i) {
             SendContext->Buffers[i].Length = Event->RECEIVE.Buffers[i].Length;
             SendContext->Buffers[i].Buffer = Event->RECEIVE.Buffers[i].Buffer;
@@ -87,18 +111,69 @@ struct ForwardedSend {
         return SendContext;
     }
     static void Delete(ForwardedSend* SendContext) {
-        if (BufferedMode) { free(SendContext); }
-        else { delete SendContext; }
+        free(SendContext);
     }
 };
 
+//
+// The state shared by the two legs of a forwarded stream. Both legs' context is
+// the same object, which is freed once both legs are shut down.
+//
+struct ForwardedStream {
+    struct Leg {
+        std::atomic<MsQuicStream*> Stream {nullptr};
+        std::atomic<uint64_t> SendOutstanding {0};  // Sent on this leg, not yet complete.
+        std::atomic<uint64_t> IdealSendBufferSize {INITIAL_IDEAL_SEND_BUFFER_SIZE};
+        std::mutex Lock;
+        bool PeerReceivePaused {false}; // This leg paused receives on the other leg.
+
+        //
+        // Called after receiving on Inbound: pauses further receives while
+        // this (outbound) leg has enough data outstanding.
+        //
+        void PausePeerReceive(MsQuicStream* Inbound) {
+            std::lock_guard<std::mutex> Guard(Lock);
+            if (SendOutstanding >= IdealSendBufferSize) {
+                PeerReceivePaused = true;
+                Inbound->ReceiveSetEnabled(false);
+            }
+        }
+
+        //
+        // Called after sends complete or the ideal send buffer size grows:
+        // resumes receives on Inbound once this leg has room again.
+        //
+        void ResumePeerReceive(MsQuicStream* Inbound) {
+            std::lock_guard<std::mutex> Guard(Lock);
+            if (PeerReceivePaused && SendOutstanding < IdealSendBufferSize) {
+                PeerReceivePaused = false;
+                Inbound->ReceiveSetEnabled(true);
+            }
+        }
+    } Legs[2];
+    std::atomic<uint32_t> RefCount {2};
+
+    Leg& Self(MsQuicStream* Stream) { return Legs[Legs[0].Stream == Stream ? 0 : 1]; }
+    Leg& Peer(MsQuicStream* Stream) { return Legs[Legs[0].Stream == Stream ? 1 : 0]; }
+    void Release() { if (--RefCount == 0) { delete this; } }
+};
+
 QUIC_STATUS StreamCallback(
-    _In_ struct MsQuicStream* /* Stream */,
+    _In_ struct MsQuicStream* Stream,
     _In_opt_ void* Context,
     _Inout_ QUIC_STREAM_EVENT* Event
     )
 {
-    auto PeerStream = (MsQuicStream*)Context;
+    auto Forwarded = (ForwardedStream*)Context;
+    auto& Self = Forwarded->Self(Stream);
+    auto& Peer = Forwarded->Peer(Stream);
+    MsQuicStream* PeerStream = Peer.Stream;
+    if (Event->Type == QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE) {
+        //printf("s[%p] Shutdown complete\n", Stream);
+        Self.Stream = nullptr;
+        Forwarded->Release();
+        return QUIC_STATUS_SUCCESS;
+    }
     if (!PeerStream || !PeerStream->Handle) { return QUIC_STATUS_SUCCESS; }
     switch (Event->Type) {
     case QUIC_STREAM_EVENT_RECEIVE: {
@@ -110,38 +185,48 @@ QUIC_STATUS StreamCallback(
             return QUIC_STATUS_SUCCESS;
         }
         auto SendContext = ForwardedSend::New(Event);
+        if (!SendContext) {
+            Stream->Shutdown(0);
+            PeerStream->Shutdown(0);
+            return QUIC_STATUS_SUCCESS;
+        }
         QUIC_SEND_FLAGS Flags = QUIC_SEND_FLAG_START;
         if (Event->RECEIVE.Flags & QUIC_RECEIVE_FLAG_FIN)   { Flags |= QUIC_SEND_FLAG_FIN; }
         if (Event->RECEIVE.Flags & QUIC_RECEIVE_FLAG_0_RTT) { Flags |= QUIC_SEND_FLAG_ALLOW_0_RTT; }
+        Peer.SendOutstanding += SendContext->TotalLength;
         auto Status =
-            PeerStream->Send(SendContext->Buffers, Event->RECEIVE.BufferCount, Flags, SendContext);
+            PeerStream->Send(SendContext->Buffers, SendContext->BufferCount, Flags, SendContext);
         if (Status == QUIC_STATUS_ABORTED || Status == QUIC_STATUS_INVALID_STATE) {
+            Peer.SendOutstanding -= SendContext->TotalLength;
             ForwardedSend::Delete(SendContext);
             return QUIC_STATUS_SUCCESS;
         }
         CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(Status));
+        Peer.PausePeerReceive(Stream);
         return BufferedMode ? QUIC_STATUS_SUCCESS : QUIC_STATUS_PENDING;
     }
     case QUIC_STREAM_EVENT_SEND_COMPLETE: {
         auto SendContext = (ForwardedSend*)Event->SEND_COMPLETE.ClientContext;
         //printf("s[%p] Sent %llu bytes\n", Stream, SendContext->TotalLength);
-        if (!BufferedMode && !Event->SEND_COMPLETE.Canceled && PeerStream) {
+        Self.SendOutstanding -= SendContext->TotalLength;
+        if (!BufferedMode && !Event->SEND_COMPLETE.Canceled) {
             PeerStream->ReceiveComplete(SendContext->TotalLength);
         }
+        Self.ResumePeerReceive(PeerStream);
         ForwardedSend::Delete(SendContext);
         break;
     }
+    case QUIC_STREAM_EVENT_IDEAL_SEND_BUFFER_SIZE:
+        Self.IdealSendBufferSize = Event->IDEAL_SEND_BUFFER_SIZE.ByteCount;
+        Self.ResumePeerReceive(PeerStream);
+        break;
     case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
         //printf("s[%p] Peer aborted send\n", Stream);
-        if (PeerStream) PeerStream->Shutdown(Event->PEER_SEND_ABORTED.ErrorCode, QUIC_STREAM_SHUTDOWN_FLAG_ABORT_SEND);
+        PeerStream->Shutdown(Event->PEER_SEND_ABORTED.ErrorCode, QUIC_STREAM_SHUTDOWN_FLAG_ABORT_SEND);
         break;
     case QUIC_STREAM_EVENT_PEER_RECEIVE_ABORTED:
         //printf("s[%p] Peer aborted recv\n", Stream);
-        if (PeerStream) PeerStream->Shutdown(Event->PEER_RECEIVE_ABORTED.ErrorCode, QUIC_STREAM_SHUTDOWN_FLAG_ABORT_RECEIVE);
-        break;
-    case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
-        //printf("s[%p] Shutdown complete\n", Stream);
-        if (PeerStream) PeerStream->Context = nullptr;
+        PeerStream->Shutdown(Event->PEER_RECEIVE_ABORTED.ErrorCode, QUIC_STREAM_SHUTDOWN_FLAG_ABORT_RECEIVE);
         break;
     default:
         break;
@@ -170,9 +255,26 @@ QUIC_STATUS ConnectionCallback(
         break;
     case QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED: {
         //printf("c[%p] Peer stream started\n", Connection);
-        auto PeerStream = new(std::nothrow) MsQuicStream(*PeerConn, Event->PEER_STREAM_STARTED.Flags, CleanUpAutoDelete, StreamCallback);
-        auto LocalStream = new(std::nothrow) MsQuicStream(Event->PEER_STREAM_STARTED.Stream, CleanUpAutoDelete, StreamCallback, PeerStream);
-        PeerStream->Context = LocalStream;
+        auto Forwarded = new(std::nothrow) ForwardedStream;
+        if (!Forwarded) {
+            MsQuic->StreamClose(Event->PEER_STREAM_STARTED.Stream);
+            break;
+        }
+        auto LocalStream = new(std::nothrow) MsQuicStream(Event->PEER_STREAM_STARTED.Stream, CleanUpAutoDelete, StreamCallback, Forwarded);
+        if (!LocalStream) {
+            delete Forwarded;
+            MsQuic->StreamClose(Event->PEER_STREAM_STARTED.Stream);
+            break;
+        }
+        Forwarded->Legs[0].Stream = LocalStream;
+        auto PeerStream = new(std::nothrow) MsQuicStream(*PeerConn, Event->PEER_STREAM_STARTED.Flags, CleanUpAutoDelete, StreamCallback, Forwarded);
+        if (!PeerStream || !PeerStream->IsValid()) {
+            delete PeerStream;
+            Forwarded->RefCount = 1; // Only the local leg will complete shutdown.
+            LocalStream->Shutdown(0);
+            break;
+        }
+        Forwarded->Legs[1].Stream = PeerStream;
         //printf("s[%p] Started -> [%p]\n", LocalStream, PeerStream);
         break;
     }
@@ -193,7 +295,21 @@ QUIC_STATUS ListenerCallback(
     )
 {
     if (Event->Type == QUIC_LISTENER_EVENT_NEW_CONNECTION) {
-        auto BackEndConn = new(std::nothrow) MsQuicConnection(*Registration, CleanUpAutoDelete, ConnectionCallback);
+        //
+        // Open the back-end connection on the front-end connection's partition
+        // so both legs run on the same worker.
+        //
+        uint16_t PartitionIndex;
+        uint32_t PartitionIndexLength = sizeof(PartitionIndex);
+        auto BackEndConn =
+            QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Event->NEW_CONNECTION.Connection,
+                    QUIC_PARAM_CONN_PARTITION_INDEX,
+                    &PartitionIndexLength,
+                    &PartitionIndex)) ?
+                new(std::nothrow) MsQuicConnection(*Registration, PartitionIndex, CleanUpAutoDelete, ConnectionCallback) :
+                new(std::nothrow) MsQuicConnection(*Registration, CleanUpAutoDelete, ConnectionCallback);
         auto FrontEndConn = new(std::nothrow) MsQuicConnection(Event->NEW_CONNECTION.Connection, CleanUpAutoDelete, ConnectionCallback, BackEndConn);
         BackEndConn->Context = FrontEndConn;
         //printf("c[%p] Created -> [%p]\n", FrontEndConn, BackEndConn);
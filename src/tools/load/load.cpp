@@ -6,13 +6,150 @@
 --*/
 
 #include <stdio.h>
+#include <vector>
 #include "quic_datapath.h"
 #include "msquic.hpp"
+#include "msquichelper.h"
 
 const MsQuicApi* MsQuic;
 volatile long ConnectedCount;
 volatile long ConnectionsActive;
 
+//
+// Churn mode: connections are opened open loop at a target rate, and each is
+// closed as soon as its handshake completes.
+//
+
+//
+// Handshake latencies (us) in log-linear buckets: 8 per power of 2, so each
+// bucket is within 12.5% of its values.
+//
+struct LatencyHistogram {
+    static const uint32_t SubBuckets = 8;
+    static const uint32_t BucketCount = 40 * SubBuckets;
+    volatile int64_t Buckets[BucketCount];
+    volatile int64_t Count;
+    volatile int64_t Max;
+
+    static uint32_t Index(uint64_t Value) {
+        if (Value < SubBuckets) {
+            return (uint32_t)Value;
+        }
+        uint32_t Msb = 63;
+        while (!(Value & (1ull << Msb))) {
+            Msb--;
+        }
+        uint32_t i = (Msb - 2) * SubBuckets + (uint32_t)((Value >> (Msb - 3)) & (SubBuckets - 1));
+        return i < BucketCount ? i : BucketCount - 1;
+    }
+    static uint64_t LowerBound(uint32_t i) {
+        if (i < SubBuckets) {
+            return i;
+        }
+        const uint32_t Msb = i / SubBuckets + 2;
+        return (1ull << Msb) | ((uint64_t)(i % SubBuckets) << (Msb - 3));
+    }
+    void Add(uint64_t Value) {
+        InterlockedIncrement64(&Buckets[Index(Value)]);
+        InterlockedIncrement64(&Count);
+        int64_t Current = Max;
+        while ((int64_t)Value > Current &&
+               InterlockedCompareExchange64(&Max, (int64_t)Value, Current) != Current) {
+            Current = Max;
+        }
+    }
+    uint64_t Percentile(double Pct) const {
+        const int64_t Target = (int64_t)(Count * Pct / 100.0 + 0.5);
+        int64_t Sum = 0;
+        for (uint32_t i = 0; i < BucketCount; ++i) {
+            Sum += Buckets[i];
+            if (Sum >= Target && Sum != 0) {
+                return i + 1 < BucketCount ? LowerBound(i + 1) : (uint64_t)Max; // Upper bound
+            }
+        }
+        return (uint64_t)Max;
+    }
+    void Print(const char* Name) const {
+        if (Count == 0) {
+            printf("%s: none\n", Name);
+            return;
+        }
+        printf(
+            "%s: %lld handshakes, p50 %llu us, p90 %llu us, p99 %llu us, p99.9 %llu us, max %llu us\n",
+            Name, (long long)Count,
+            (unsigned long long)Percentile(50), (unsigned long long)Percentile(90),
+            (unsigned long long)Percentile(99), (unsigned long long)Percentile(99.9),
+            (unsigned long long)Max);
+        int64_t Sum = 0;
+        for (uint32_t i = 0; i < BucketCount; ++i) {
+            if (Buckets[i] == 0) continue;
+            Sum += Buckets[i];
+            printf(
+                "  [%8llu, %8llu) us %10lld %6.2f%%\n",
+                (unsigned long long)LowerBound(i), (unsigned long long)LowerBound(i + 1),
+                (long long)Buckets[i], 100.0 * Sum / Count);
+        }
+    }
+};
+
+struct ChurnStats {
+    volatile long Started;
+    volatile long Skipped;      // Not started because MaxActive were still open
+    volatile long Connected;
+    volatile long Resumed;
+    volatile long ResumeAttempts;
+    volatile long ZeroRttAttempts;
+    volatile long Refused;      // Refused by the server (or its app)
+    volatile long TimedOut;
+    volatile long Failed;
+    volatile long Active;
+    LatencyHistogram Full;
+    LatencyHistogram Resumption;
+} Churn;
+
+//
+// Resumption tickets from completed handshakes. Each is used once, since the
+// server may reject 0-RTT on a replayed ticket.
+//
+struct TicketStore {
+    CxPlatLock Lock;
+    std::vector<std::vector<uint8_t>> Tickets;
+    static const size_t MaxTickets = 4096;
+
+    void Push(const uint8_t* Ticket, uint32_t Length) {
+        Lock.Acquire();
+        if (Tickets.size() < MaxTickets) {
+            Tickets.emplace_back(Ticket, Ticket + Length);
+        }
+        Lock.Release();
+    }
+    bool Pop(std::vector<uint8_t>& Ticket) {
+        Lock.Acquire();
+        const bool Found = !Tickets.empty();
+        if (Found) {
+            Ticket.swap(Tickets.back());
+            Tickets.pop_back();
+        }
+        Lock.Release();
+        return Found;
+    }
+} *Tickets;
+
+//
+// Set when resuming, so connections stay open until the server's ticket
+// (sent after the handshake) arrives.
+//
+bool WaitForTicket;
+
+struct ChurnContext {
+    uint64_t StartTime;
+    bool Resuming;
+    bool Connected {false};
+};
+
+const uint8_t ZeroRttRequest[64] = {0};
+const QUIC_BUFFER ZeroRttBuffer = { sizeof(ZeroRttRequest), (uint8_t*)ZeroRttRequest };
+
 void ResolveServerAddress(const char* ServerName, QUIC_ADDR& ServerAddress) {
     CxPlatSystemLoad();
     CxPlatInitialize();
@@ -42,9 +179,229 @@ QUIC_STATUS ConnectionCallback(_In_ struct MsQuicConnection* , _In_opt_ void* ,
     return QUIC_STATUS_SUCCESS;
 }
 
+QUIC_STATUS ChurnConnectionCallback(_In_ struct MsQuicConnection* Connection, _In_opt_ void* Context, _Inout_ QUIC_CONNECTION_EVENT* Event) {
+    auto Ctx = (ChurnContext*)Context;
+    switch (Event->Type) {
+    case QUIC_CONNECTION_EVENT_CONNECTED: {
+        const uint64_t Latency = CxPlatTimeUs64() - Ctx->StartTime;
+        Ctx->Connected = true;
+        InterlockedIncrement(&Churn.Connected);
+        if (Event->CONNECTED.SessionResumed) {
+            InterlockedIncrement(&Churn.Resumed);
+            Churn.Resumption.Add(Latency);
+        } else {
+            Churn.Full.Add(Latency);
+        }
+        if (!WaitForTicket) {
+            Connection->Shutdown(0);
+        }
+        break;
+    }
+    case QUIC_CONNECTION_EVENT_RESUMPTION_TICKET_RECEIVED:
+        Tickets->Push(
+            Event->RESUMPTION_TICKET_RECEIVED.ResumptionTicket,
+            Event->RESUMPTION_TICKET_RECEIVED.ResumptionTicketLength);
+        Connection->Shutdown(0);
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT:
+        if (!Ctx->Connected) {
+            if (Event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status == QUIC_STATUS_CONNECTION_REFUSED) {
+                InterlockedIncrement(&Churn.Refused);
+            } else if (Event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status == QUIC_STATUS_CONNECTION_TIMEOUT ||
+                       Event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status == QUIC_STATUS_CONNECTION_IDLE) {
+                InterlockedIncrement(&Churn.TimedOut);
+            } else {
+                InterlockedIncrement(&Churn.Failed);
+            }
+        }
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_PEER:
+        if (!Ctx->Connected) {
+            InterlockedIncrement(&Churn.Failed);
+        }
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+        delete Ctx;
+        InterlockedDecrement(&Churn.Active);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+void PrintChurnInterval(uint64_t ElapsedMs, long& LastStarted, long& LastConnected, uint64_t IntervalMs) {
+    const long Started = Churn.Started;
+    const long Connected = Churn.Connected;
+    printf(
+        "%6.1f: %6.0f started/s, %6.0f connected/s, %ld resumed, %ld refused, %ld timed out, %ld failed, %ld skipped, %ld active\n",
+        ElapsedMs / 1000.0,
+        (Started - LastStarted) * 1000.0 / IntervalMs,
+        (Connected - LastConnected) * 1000.0 / IntervalMs,
+        (long)Churn.Resumed, (long)Churn.Refused, (long)Churn.TimedOut, (long)Churn.Failed,
+        (long)Churn.Skipped, (long)Churn.Active);
+    LastStarted = Started;
+    LastConnected = Connected;
+}
+
+int RunChurn(int argc, char** argv, const char* ServerName, const QuicAddr& ServerAddress) {
+    uint32_t Rate = 0;
+    uint32_t DurationSec = 10;
+    uint32_t ResumePct = 0;
+    uint32_t ZeroRttPct = 0;
+    uint32_t MaxActive = 10000;
+    uint32_t TimeoutMs = 10000;
+    uint32_t PollMs = 1000;
+    uint16_t Port = 443;
+    const char* Alpn = "h3";
+    TryGetValue(argc, argv, "rate", &Rate);
+    TryGetValue(argc, argv, "duration", &DurationSec);
+    TryGetValue(argc, argv, "resume", &ResumePct);
+    TryGetValue(argc, argv, "zerortt", &ZeroRttPct);
+    TryGetValue(argc, argv, "maxactive", &MaxActive);
+    TryGetValue(argc, argv, "timeout", &TimeoutMs);
+    TryGetValue(argc, argv, "poll", &PollMs);
+    TryGetValue(argc, argv, "port", &Port);
+    TryGetValue(argc, argv, "alpn", &Alpn);
+    if (Rate == 0 || ResumePct > 100 || ZeroRttPct > 100 || PollMs == 0) {
+        printf("Invalid churn options!\n");
+        return 1;
+    }
+
+    MsQuicRegistration Registration("quicload", QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT, true);
+    MsQuicAlpn Alpns(Alpn);
+    MsQuicSettings Settings;
+    Settings.SetPeerUnidiStreamCount(3);
+    Settings.SetHandshakeIdleTimeoutMs(TimeoutMs);
+    Settings.SetIdleTimeoutMs(TimeoutMs);
+    MsQuicConfiguration Config(
+        Registration, Alpns, Settings,
+        MsQuicCredentialConfig(QUIC_CREDENTIAL_FLAG_CLIENT | QUIC_CREDENTIAL_FLAG_NO_CERTIFICATE_VALIDATION));
+    if (!Config.IsValid()) {
+        printf("Failed to create configuration, 0x%x\n", Config.GetInitStatus());
+        return 1;
+    }
+    Tickets = new(std::nothrow) TicketStore;
+    WaitForTicket = ResumePct != 0;
+
+    QUIC_ADDR_STR AddrStr;
+    QuicAddrToString(&ServerAddress.SockAddr, &AddrStr);
+    printf(
+        "Churning %u connections/s to %s [%s]:%hu for %u s, %u%% resumed, %u%% of those with 0-RTT\n\n",
+        Rate, ServerName, AddrStr.Address, Port, DurationSec, ResumePct, ZeroRttPct);
+
+    uint64_t RandomState = 0x9E3779B97F4A7C15ull;
+    auto Random100 = [&RandomState]() {
+        RandomState ^= RandomState << 13;
+        RandomState ^= RandomState >> 7;
+        RandomState ^= RandomState << 17;
+        return (uint32_t)(RandomState % 100);
+    };
+
+    //
+    // Open loop: connections due by now are started, whether or not earlier
+    // ones finished, so a slow server shows up as latency and rejections
+    // rather than a lower offered rate.
+    //
+    const uint64_t Start = CxPlatTimeUs64();
+    const uint64_t End = Start + (uint64_t)DurationSec * 1000 * 1000;
+    uint64_t NextPrint = Start + (uint64_t)PollMs * 1000;
+    uint64_t Due = 0;
+    long LastStarted = 0, LastConnected = 0;
+    std::vector<uint8_t> Ticket;
+    uint64_t Now;
+    while ((Now = CxPlatTimeUs64()) < End) {
+        const uint64_t DueNow = (Now - Start) * Rate / (1000 * 1000);
+        while (Due < DueNow) {
+            Due++;
+            if ((uint32_t)Churn.Active >= MaxActive) {
+                InterlockedIncrement(&Churn.Skipped);
+                continue;
+            }
+            auto Ctx = new(std::nothrow) ChurnContext;
+            auto Connection =
+                new(std::nothrow) MsQuicConnection(
+                    Registration, CleanUpAutoDelete, ChurnConnectionCallback, Ctx);
+            if (!Connection || !Connection->IsValid()) {
+                delete Ctx;
+                delete Connection;
+                InterlockedIncrement(&Churn.Failed);
+                continue;
+            }
+            Connection->SetRemoteAddr(ServerAddress);
+            Ctx->Resuming = Random100() < ResumePct && Tickets->Pop(Ticket);
+            if (Ctx->Resuming) {
+                InterlockedIncrement(&Churn.ResumeAttempts);
+                Connection->SetResumptionTicket(Ticket.data(), (uint32_t)Ticket.size());
+                if (Random100() < ZeroRttPct) {
+                    auto Stream =
+                        new(std::nothrow) MsQuicStream(
+                            *Connection, QUIC_STREAM_OPEN_FLAG_NONE, CleanUpAutoDelete);
+                    if (Stream && Stream->IsValid() &&
+                        QUIC_SUCCEEDED(
+                        Stream->Send(
+                            &ZeroRttBuffer, 1,
+                            QUIC_SEND_FLAG_ALLOW_0_RTT | QUIC_SEND_FLAG_START | QUIC_SEND_FLAG_FIN))) {
+                        InterlockedIncrement(&Churn.ZeroRttAttempts);
+                    }
+                }
+            }
+            InterlockedIncrement(&Churn.Active);
+            InterlockedIncrement(&Churn.Started);
+            Ctx->StartTime = CxPlatTimeUs64();
+            if (QUIC_FAILED(Connection->Start(Config, ServerName, Port))) {
+                delete Connection; // No more callbacks once closed.
+                delete Ctx;
+                InterlockedDecrement(&Churn.Active);
+                InterlockedIncrement(&Churn.Failed);
+            }
+        }
+        if (Now >= NextPrint) {
+            PrintChurnInterval((Now - Start) / 1000, LastStarted, LastConnected, PollMs);
+            NextPrint += (uint64_t)PollMs * 1000;
+        }
+        CxPlatSleep(1);
+    }
+
+    const uint64_t DrainEnd = CxPlatTimeUs64() + (uint64_t)TimeoutMs * 1000;
+    while (Churn.Active != 0 && CxPlatTimeUs64() < DrainEnd) {
+        CxPlatSleep(10);
+    }
+
+    printf(
+        "\n%ld started (%ld skipped), %ld connected (%ld of %ld resumption attempts resumed, %ld with 0-RTT), "
+        "%ld refused, %ld timed out, %ld failed\n\n",
+        (long)Churn.Started, (long)Churn.Skipped, (long)Churn.Connected, (long)Churn.Resumed,
+        (long)Churn.ResumeAttempts, (long)Churn.ZeroRttAttempts, (long)Churn.Refused,
+        (long)Churn.TimedOut, (long)Churn.Failed);
+    Churn.Full.Print("Full handshakes");
+    Churn.Resumption.Print("Resumed handshakes");
+
+    Registration.Shutdown(QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT, 0);
+    return 0;
+}
+
 int QUIC_MAIN_EXPORT main(int argc, char **argv) {
     if (argc < 2) {
-        printf("Usage: quicload.exe <server_name> [conn_count] [keep_alive_ms] [poll_ms] [share_udp]\n");
+        printf(
+            "Usage: quicload.exe <server_name> [conn_count] [keep_alive_ms] [poll_ms] [share_udp]\n"
+            "       quicload.exe <server_name> -rate:<conns_per_sec> [options]\n"
+            "\n"
+            "Churn options:\n"
+            "  -rate:<####>        Connections to open per second, each closed once connected.\n"
+            "  -duration:<####>    Seconds to open connections for. (def:10)\n"
+            "  -resume:<0-100>     Percent of connections that resume a previous session. (def:0)\n"
+            "  -zerortt:<0-100>    Percent of resumed connections that also send 0-RTT data. (def:0)\n"
+            "  -maxactive:<####>   Skip starting connections while this many are open. (def:10000)\n"
+            "  -timeout:<####>     Handshake timeout in ms. (def:10000)\n"
+            "  -poll:<####>        Progress print interval in ms. (def:1000)\n"
+            "  -port:<####>        The server's UDP port. (def:443)\n"
+            "  -alpn:<alpn>        The ALPN to negotiate. (def:h3)\n"
+            "\n"
+            "Resumption needs a server that sends tickets (QUIC_SERVER_RESUME_AND_ZERORTT for 0-RTT);\n"
+            "with -resume, connections stay open until their ticket arrives.\n"
+            "An overloaded server drops new Initials, which shows up as handshake latency\n"
+            "(retransmissions) and then timeouts, rather than as refusals.\n");
         return 1;
     }
 
@@ -52,6 +409,14 @@ int QUIC_MAIN_EXPORT main(int argc, char **argv) {
     QuicAddr ServerAddress = {0};
     ResolveServerAddress(ServerName, ServerAddress.SockAddr);
 
+    if (GetValue(argc, argv, "rate") != nullptr) {
+        MsQuic = new(std::nothrow) MsQuicApi;
+        const int Result = RunChurn(argc, argv, ServerName, ServerAddress);
+        delete Tickets;
+        delete MsQuic;
+        return Result;
+    }
+
     const uint32_t ConnectionCount = argc > 2 ? atoi(argv[2]) : 100;
     const uint32_t KeepAliveMs = argc > 3 ? atoi(argv[3]) : 60 * 1000;
     const uint32_t PollMs = argc > 4 ? atoi(argv[4]) : 10 * 1000;
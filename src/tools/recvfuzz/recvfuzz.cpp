@@ -23,6 +23,10 @@ Abstract:
     continues the handshake from there. It does a similar mutation of subsequent
     packets at the handshake stages.
 
+    When built with FUZZING (libFuzzer), the listener and client socket are
+    created once per process and each input only drives one iteration of the
+    above against the already running server.
+
 Future:
 
     Add fuzzing for 1-RTT packets.
@@ -512,6 +516,7 @@ void WriteAckFrame(
     CXPLAT_FRE_ASSERT(
         QuicAckFrameEncode(
             &AckRange,
+            nullptr,
             AckDelay,
             nullptr,
             Offset,
@@ -988,6 +993,35 @@ void FuzzHandshake(
     }
 }
 
+//
+// Drops any packets still queued from the previous iteration and stops
+// accepting packets for its connection.
+//
+void ResetReceiveState() {
+    CurrSrcCid = 0xFFFFFFFFFFFFFFFF; // Reset the CID to ignore old packets
+
+    PacketQueueLock.Acquire();
+    QUIC_RX_PACKET* PacketQueueCopy = PacketQueue;
+    PacketQueue = nullptr;
+    PacketQueueTail = &PacketQueue;
+    PacketQueueLock.Release();
+    while (PacketQueueCopy != nullptr) {
+        QUIC_RX_PACKET* Packet = PacketQueueCopy;
+        PacketQueueCopy = (QUIC_RX_PACKET*)Packet->_.Next;
+        CXPLAT_FREE(Packet, QUIC_POOL_TOOL);
+    }
+    RecvPacketEvent.Reset();
+}
+
+void FuzzIteration(CXPLAT_SOCKET* Binding, CXPLAT_ROUTE* Route, uint64_t StartTimeMs) {
+    if (GetRandom<uint8_t>(16) == 0) {
+        FuzzInitial(Binding, Route);
+    } else {
+        FuzzHandshake(Binding, Route, StartTimeMs);
+    }
+    ResetReceiveState();
+}
+
 void FuzzReceivePath(CXPLAT_SOCKET* Binding, CXPLAT_ROUTE* Route) {
     uint64_t StartTimeMs = CxPlatTimeMs64(), LastPrintTimeMs = StartTimeMs, CurrentTimeMs;
     while (CxPlatTimeDiff64(StartTimeMs, (CurrentTimeMs = CxPlatTimeMs64())) < RunTimeMs) {
@@ -995,53 +1029,47 @@ void FuzzReceivePath(CXPLAT_SOCKET* Binding, CXPLAT_ROUTE* Route) {
             LastPrintTimeMs = CurrentTimeMs;
             Stats.Print();
         }
-
-        if (GetRandom<uint8_t>(16) == 0) {
-            FuzzInitial(Binding, Route);
-        } else {
-            FuzzHandshake(Binding, Route, StartTimeMs);
-        }
-
-        CurrSrcCid = 0xFFFFFFFFFFFFFFFF; // Reset the CID to ignore old packets
-
-        //
-        // Drain any leftovers
-        //
-        PacketQueueLock.Acquire();
-        QUIC_RX_PACKET* PacketQueueCopy = PacketQueue;
-        PacketQueue = nullptr;
-        PacketQueueTail = &PacketQueue;
-        PacketQueueLock.Release();
-        while (PacketQueueCopy != nullptr) {
-            QUIC_RX_PACKET* Packet = PacketQueueCopy;
-            PacketQueueCopy = (QUIC_RX_PACKET*)Packet->_.Next;
-            CXPLAT_FREE(Packet, QUIC_POOL_TOOL);
-        }
-        RecvPacketEvent.Reset();
+        FuzzIteration(Binding, Route, StartTimeMs);
     }
 
     Stats.Print();
 }
 
-void SetupAndFuzz() {
+//
+// Everything that outlives a single fuzz iteration: the client socket used to
+// send the packets and the MsQuic server (registration, configuration and
+// listener) receiving them.
+//
+struct FuzzServer {
+    CXPLAT_WORKER_POOL* WorkerPool {nullptr};
+    CXPLAT_DATAPATH* Datapath {nullptr};
+    CXPLAT_SOCKET* Binding {nullptr};
+    CXPLAT_ROUTE Route {};
+    MsQuicRegistration* Registration {nullptr};
+    MsQuicConfiguration* Configuration {nullptr};
+    MsQuicAutoAcceptListener* Listener {nullptr};
+};
+
+static FuzzServer Server;
+
+void FuzzSetup() {
     CxPlatSystemLoad();
     CxPlatInitialize();
 
-    CXPLAT_DATAPATH* Datapath;
     const CXPLAT_UDP_DATAPATH_CALLBACKS DatapathCallbacks = {
         UdpRecvCallback,
         UdpUnreachCallback,
     };
-    CXPLAT_WORKER_POOL* WorkerPool = CxPlatWorkerPoolCreate(nullptr, CXPLAT_WORKER_POOL_REF_TOOL);
+    Server.WorkerPool = CxPlatWorkerPoolCreate(nullptr, CXPLAT_WORKER_POOL_REF_TOOL);
     CXPLAT_DATAPATH_INIT_CONFIG InitConfig = {0};
     MUST_SUCCEED(
         CxPlatDataPathInitialize(
             0,
             &DatapathCallbacks,
             NULL,
-            WorkerPool,
+            Server.WorkerPool,
             &InitConfig,
-            &Datapath));
+            &Server.Datapath));
     QUIC_ADDRESS_FAMILY Family =
         GetRandom<uint8_t>(2) == 0 ?
             QUIC_ADDRESS_FAMILY_INET6 : QUIC_ADDRESS_FAMILY_INET;
@@ -1049,7 +1077,7 @@ void SetupAndFuzz() {
     QuicAddrSetFamily(&sockAddr, Family);
     MUST_SUCCEED(
         CxPlatDataPathResolveAddress(
-            Datapath,
+            Server.Datapath,
             Sni,
             &sockAddr));
     QuicAddrSetPort(&sockAddr, 9999);
@@ -1057,7 +1085,6 @@ void SetupAndFuzz() {
     //
     // Create a client socket to send fuzzed packets to the server
     //
-    CXPLAT_SOCKET* Binding;
     CXPLAT_UDP_CONFIG UdpConfig = {0};
     UdpConfig.LocalAddress = nullptr;
     UdpConfig.RemoteAddress = &sockAddr;
@@ -1066,48 +1093,63 @@ void SetupAndFuzz() {
     UdpConfig.CallbackContext = nullptr;
     MUST_SUCCEED(
         CxPlatSocketCreateUdp(
-            Datapath,
+            Server.Datapath,
             &UdpConfig,
-            &Binding));
+            &Server.Binding));
 
-    CXPLAT_ROUTE Route = {0};
-    CxPlatSocketGetLocalAddress(Binding, &Route.LocalAddress);
-    Route.RemoteAddress = sockAddr;
+    CxPlatSocketGetLocalAddress(Server.Binding, &Server.Route.LocalAddress);
+    Server.Route.RemoteAddress = sockAddr;
 
     MsQuic = new MsQuicApi();
 
-    {
-        //
-        // Set up a QUIC server and fuzz it.
-        //
-        uint16_t RetryPercent = 0xFFFF; // Disable retry for now
-        MUST_SUCCEED(
-            MsQuic->SetParam(
-                nullptr,
-                QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT,
-                sizeof(uint16_t),
-                &RetryPercent));
-        MsQuicRegistration Registration(true);
-        MUST_SUCCEED(Registration.GetInitStatus());
-        auto CredConfig = CxPlatGetSelfSignedCert(CXPLAT_SELF_SIGN_CERT_USER, FALSE, NULL);
-        MsQuicSettings Settings;
-        Settings.SetPeerBidiStreamCount(10);
-        Settings.SetPeerUnidiStreamCount(10);
-        MsQuicConfiguration ServerConfiguration(Registration, Alpn, Settings, *CredConfig);
-        MUST_SUCCEED(ServerConfiguration.GetInitStatus());
-        MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, MsQuicConnection::NoOpCallback);
-        MUST_SUCCEED(Listener.Start(Alpn, &sockAddr));
-        MUST_SUCCEED(Listener.GetInitStatus());
-
-        FuzzReceivePath(Binding, &Route);
-    }
+    //
+    // Set up a QUIC server to fuzz.
+    //
+    uint16_t RetryPercent = 0xFFFF; // Disable retry for now
+    MUST_SUCCEED(
+        MsQuic->SetParam(
+            nullptr,
+            QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT,
+            sizeof(uint16_t),
+            &RetryPercent));
+    Server.Registration = new MsQuicRegistration(true);
+    MUST_SUCCEED(Server.Registration->GetInitStatus());
+    auto CredConfig = CxPlatGetSelfSignedCert(CXPLAT_SELF_SIGN_CERT_USER, FALSE, NULL);
+    MsQuicSettings Settings;
+    Settings.SetPeerBidiStreamCount(10);
+    Settings.SetPeerUnidiStreamCount(10);
+#ifdef FUZZING
+    //
+    // Every iteration abandons its connection, so don't let them pile up on
+    // the long lived server.
+    //
+    Settings.SetHandshakeIdleTimeoutMs(1000);
+    Settings.SetIdleTimeoutMs(1000);
+#endif
+    Server.Configuration =
+        new MsQuicConfiguration(*Server.Registration, Alpn, Settings, *CredConfig);
+    MUST_SUCCEED(Server.Configuration->GetInitStatus());
+    Server.Listener =
+        new MsQuicAutoAcceptListener(
+            *Server.Registration, *Server.Configuration, MsQuicConnection::NoOpCallback);
+    MUST_SUCCEED(Server.Listener->Start(Alpn, &sockAddr));
+    MUST_SUCCEED(Server.Listener->GetInitStatus());
+}
+
+void FuzzCleanup() {
+    delete Server.Listener;
+    Server.Listener = nullptr;
+    delete Server.Configuration;
+    Server.Configuration = nullptr;
+    delete Server.Registration;
+    Server.Registration = nullptr;
 
     delete MsQuic;
     MsQuic = nullptr;
 
-    CxPlatSocketDelete(Binding);
-    CxPlatDataPathUninitialize(Datapath);
-    CxPlatWorkerPoolDelete(WorkerPool, CXPLAT_WORKER_POOL_REF_TOOL);
+    CxPlatSocketDelete(Server.Binding);
+    CxPlatDataPathUninitialize(Server.Datapath);
+    CxPlatWorkerPoolDelete(Server.WorkerPool, CXPLAT_WORKER_POOL_REF_TOOL);
 
     while (PacketQueue != nullptr) {
         QUIC_RX_PACKET* packet = PacketQueue;
@@ -1121,10 +1163,26 @@ void SetupAndFuzz() {
 
 #ifdef FUZZING
 
+//
+// The server is set up once per fuzzer process (persistent mode) and each
+// input only drives a single connection attempt against it. Inputs that leave
+// a connection behind rely on the short idle timeouts to clean it up.
+//
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+    RunTimeMs = 1000; // Bounds the wait for the server's first flight.
+    FuzzSetup();
+    atexit(FuzzCleanup);
+    return 0;
+}
+
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
-    FuzzData = new FuzzingData(data, size);
-    SetupAndFuzz();
-    delete FuzzData;
+    if (size == 0) {
+        return 0;
+    }
+    FuzzingData Data(data, size);
+    FuzzData = &Data;
+    FuzzIteration(Server.Binding, &Server.Route, CxPlatTimeMs64());
+    FuzzData = nullptr;
     return 0;
 }
 
@@ -1140,7 +1198,9 @@ main(int argc, char **argv) {
     }
     printf("Using seed value: %u\n", RngSeed);
     srand(RngSeed);
-    SetupAndFuzz();
+    FuzzSetup();
+    FuzzReceivePath(Server.Binding, &Server.Route);
+    FuzzCleanup();
     return 0;
 }
 
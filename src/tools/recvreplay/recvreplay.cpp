@@ -0,0 +1,372 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Replays datagrams recorded with QUIC_PARAM_GLOBAL_RECV_CAPTURE against a
+    server, at their recorded timing, so receive path changes can be profiled
+    and compared on real traffic mixes.
+
+    Each remote address in the capture gets its own UDP socket, so the server
+    sees the same number of distinct peers as the original. Anything the
+    server sends back is counted and dropped.
+
+    Note: replayed packets are only as useful as the server's ability to
+    process them. Initial packets are fully processed (their keys only depend
+    on the connection ID), but packets protected by keys negotiated during the
+    original handshakes can't be decrypted, and exercise the receive path only
+    up to decryption.
+
+--*/
+
+#pragma warning(disable:4200)  // nonstandard extension used: bit field types other than int
+#pragma warning(disable:4201)  // nonstandard extension used: nameless struct/union
+#pragma warning(disable:4204)  // nonstandard extension used: non-constant aggregate initializer
+#pragma warning(disable:4214)  // nonstandard extension used: zero-sized array in struct/union
+
+#include "precomp.h" // from 'core' dir
+#include "msquichelper.h"
+
+#include <vector>
+#include <map>
+
+#define REPLAY_PORT_DEFAULT 443
+
+#define REPLAY_MAX_SOCKETS 1024
+
+//
+// The time to spin, instead of sleep, waiting for the next datagram to be due.
+//
+#define REPLAY_SPIN_US 2000
+
+struct ReplayDatagram {
+    const QUIC_RECV_CAPTURE_RECORD* Record;
+    const uint8_t* Buffer;
+    uint32_t SocketIndex;
+};
+
+struct ReplaySocket {
+    CXPLAT_SOCKET* Socket;
+    CXPLAT_ROUTE Route;
+};
+
+struct CallbackContext {
+    CXPLAT_ROUTE* Route;
+    CXPLAT_EVENT Event;
+};
+
+static CXPLAT_DATAPATH* Datapath;
+static QUIC_ADDR ServerAddress;
+static const char* FilePath;
+static const char* IpAddress;
+static uint32_t SpeedPercent = 100;
+static uint32_t LoopCount = 1;
+
+static std::vector<uint8_t> FileBuffer;
+static std::vector<ReplayDatagram> Datagrams;
+static std::vector<ReplaySocket> Sockets;
+
+static int64_t SentDatagrams;
+static int64_t SentBytes;
+static int64_t DroppedDatagrams;
+static int64_t ReceivedDatagrams;
+
+void PrintUsage()
+{
+    printf("quicrecvreplay replays datagrams captured with QUIC_PARAM_GLOBAL_RECV_CAPTURE against a server.\n\n");
+
+    printf("Usage:\n");
+    printf("  quicrecvreplay -file:<capture_file> -ip:<ip_address_and_port> [-speed:<percent>] [-loops:<count>]\n\n");
+    printf("  -speed:0 replays as fast as possible. The default is 100, the recorded timing.\n");
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(CXPLAT_DATAPATH_RECEIVE_CALLBACK)
+void
+UdpRecvCallback(
+    _In_ CXPLAT_SOCKET* /* Binding */,
+    _In_ void* /* Context */,
+    _In_ CXPLAT_RECV_DATA* RecvBufferChain
+    )
+{
+    int64_t Count = 0;
+    for (CXPLAT_RECV_DATA* Datagram = RecvBufferChain; Datagram != nullptr; Datagram = Datagram->Next) {
+        Count++;
+    }
+    InterlockedExchangeAdd64(&ReceivedDatagrams, Count);
+    CxPlatRecvDataReturn(RecvBufferChain);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(CXPLAT_DATAPATH_UNREACHABLE_CALLBACK)
+void
+UdpUnreachCallback(
+    _In_ CXPLAT_SOCKET* /* Binding */,
+    _In_ void* /* Context */,
+    _In_ const QUIC_ADDR* /* RemoteAddress */
+    )
+{
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(CXPLAT_ROUTE_RESOLUTION_CALLBACK)
+void
+ResolveRouteComplete(
+    _Inout_ void* Context,
+    _When_(Succeeded == FALSE, _Reserved_)
+    _When_(Succeeded == TRUE, _In_reads_bytes_(6))
+        const uint8_t* PhysicalAddress,
+    _In_ uint8_t PathId,
+    _In_ BOOLEAN Succeeded
+    )
+{
+    UNREFERENCED_PARAMETER(PathId);
+    CallbackContext* CContext = (CallbackContext*) Context;
+    if (Succeeded) {
+        CxPlatResolveRouteComplete(nullptr, CContext->Route, PhysicalAddress, 0);
+    }
+    CxPlatEventSet(CContext->Event);
+}
+
+bool LoadCapture()
+{
+    FILE* File = fopen(FilePath, "rb");
+    if (File == nullptr) {
+        printf("Failed to open '%s'.\n", FilePath);
+        return false;
+    }
+    uint8_t Chunk[64 * 1024];
+    size_t Read;
+    while ((Read = fread(Chunk, 1, sizeof(Chunk), File)) != 0) {
+        FileBuffer.insert(FileBuffer.end(), Chunk, Chunk + Read);
+    }
+    fclose(File);
+
+    QUIC_RECV_CAPTURE_FILE_HEADER Header;
+    if (FileBuffer.size() < sizeof(Header)) {
+        printf("'%s' is too short.\n", FilePath);
+        return false;
+    }
+    CxPlatCopyMemory(&Header, FileBuffer.data(), sizeof(Header));
+    if (Header.Magic != QUIC_RECV_CAPTURE_MAGIC ||
+        Header.Version != QUIC_RECV_CAPTURE_VERSION) {
+        printf("'%s' isn't a supported capture file.\n", FilePath);
+        return false;
+    }
+
+    //
+    // Assign each distinct remote address a socket, wrapping around if there
+    // are too many.
+    //
+    std::map<std::vector<uint8_t>, uint32_t> Peers;
+    size_t Offset = sizeof(Header);
+    while (Offset < FileBuffer.size()) {
+        if (FileBuffer.size() - Offset < sizeof(QUIC_RECV_CAPTURE_RECORD)) {
+            printf("Ignoring truncated record at offset %llu.\n", (unsigned long long)Offset);
+            break;
+        }
+        const QUIC_RECV_CAPTURE_RECORD* Record =
+            (const QUIC_RECV_CAPTURE_RECORD*)(FileBuffer.data() + Offset);
+        Offset += sizeof(QUIC_RECV_CAPTURE_RECORD);
+        if (FileBuffer.size() - Offset < Record->BufferLength) {
+            printf("Ignoring truncated record at offset %llu.\n", (unsigned long long)Offset);
+            break;
+        }
+
+        const uint8_t* PeerKey = (const uint8_t*)&Record->RemoteAddress;
+        auto Peer =
+            Peers.emplace(
+                std::vector<uint8_t>(PeerKey, PeerKey + sizeof(Record->RemoteAddress)),
+                (uint32_t)(Peers.size() % REPLAY_MAX_SOCKETS)).first;
+
+        Datagrams.push_back({ Record, FileBuffer.data() + Offset, Peer->second });
+        Offset += Record->BufferLength;
+    }
+
+    printf("Loaded %llu datagrams from %llu peers, spanning %llu ms.\n",
+        (unsigned long long)Datagrams.size(),
+        (unsigned long long)Peers.size(),
+        Datagrams.empty() ? 0ull : (unsigned long long)US_TO_MS(Datagrams.back().Record->TimeUs));
+
+    Sockets.resize(CXPLAT_MIN(Peers.size(), (size_t)REPLAY_MAX_SOCKETS));
+    return !Datagrams.empty();
+}
+
+bool CreateSockets()
+{
+    for (ReplaySocket& Socket : Sockets) {
+        CXPLAT_UDP_CONFIG UdpConfig = {0};
+        UdpConfig.LocalAddress = nullptr;
+        UdpConfig.RemoteAddress = &ServerAddress;
+        UdpConfig.Flags = CXPLAT_SOCKET_FLAG_NONE;
+        UdpConfig.InterfaceIndex = 0;
+        UdpConfig.CallbackContext = nullptr;
+        QUIC_STATUS Status =
+            CxPlatSocketCreateUdp(
+                Datapath,
+                &UdpConfig,
+                &Socket.Socket);
+        if (QUIC_FAILED(Status)) {
+            printf("CxPlatSocketCreateUdp failed, 0x%x\n", Status);
+            Socket.Socket = nullptr;
+            return false;
+        }
+
+        CxPlatSocketGetLocalAddress(Socket.Socket, &Socket.Route.LocalAddress);
+        CxPlatSocketGetRemoteAddress(Socket.Socket, &Socket.Route.RemoteAddress);
+        CallbackContext Context = {&Socket.Route, };
+        Status = CxPlatResolveRoute(Socket.Socket, &Socket.Route, 0, &Context, ResolveRouteComplete);
+        if (Status == QUIC_STATUS_PENDING) {
+            CxPlatEventInitialize(&(Context.Event), FALSE, FALSE);
+            BOOLEAN EventSet = CxPlatEventWaitWithTimeout(Context.Event, 1000);
+            CxPlatEventUninitialize(Context.Event);
+            if (!EventSet) {
+                printf("Failed to CxPlatResolveRoute before timeout!\n");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DeleteSockets()
+{
+    for (ReplaySocket& Socket : Sockets) {
+        if (Socket.Socket != nullptr) {
+            CxPlatSocketDelete(Socket.Socket);
+        }
+    }
+    Sockets.clear();
+}
+
+void ReplayOnce()
+{
+    const uint64_t StartTimeUs = CxPlatTimeUs64();
+
+    for (const ReplayDatagram& Datagram : Datagrams) {
+        const QUIC_RECV_CAPTURE_RECORD* Record = Datagram.Record;
+
+        if (SpeedPercent != 0) {
+            const uint64_t DueTimeUs = (Record->TimeUs * 100) / SpeedPercent;
+            uint64_t ElapsedUs;
+            while ((ElapsedUs = CxPlatTimeDiff64(StartTimeUs, CxPlatTimeUs64())) < DueTimeUs) {
+                if (DueTimeUs - ElapsedUs > REPLAY_SPIN_US) {
+                    CxPlatSleep((uint32_t)US_TO_MS(DueTimeUs - ElapsedUs - REPLAY_SPIN_US));
+                }
+            }
+        }
+
+        ReplaySocket& Socket = Sockets[Datagram.SocketIndex];
+        CXPLAT_SEND_CONFIG SendConfig = {
+            &Socket.Route,
+            Record->BufferLength,
+            (uint8_t)(Record->TypeOfService & 0x3),
+            0,
+            (uint8_t)(Record->TypeOfService >> 2)
+        };
+        CXPLAT_SEND_DATA* SendData = CxPlatSendDataAlloc(Socket.Socket, &SendConfig);
+        if (SendData == nullptr) {
+            DroppedDatagrams++;
+            continue;
+        }
+        QUIC_BUFFER* SendBuffer = CxPlatSendDataAllocBuffer(SendData, Record->BufferLength);
+        if (SendBuffer == nullptr) {
+            CxPlatSendDataFree(SendData);
+            DroppedDatagrams++;
+            continue;
+        }
+        CxPlatCopyMemory(SendBuffer->Buffer, Datagram.Buffer, Record->BufferLength);
+        CxPlatSocketSend(Socket.Socket, &Socket.Route, SendData);
+
+        SentDatagrams++;
+        SentBytes += Record->BufferLength;
+    }
+}
+
+void RunReplay()
+{
+    if (!CreateSockets()) {
+        return;
+    }
+
+    const uint64_t StartTimeMs = CxPlatTimeMs64();
+    for (uint32_t i = 0; i < LoopCount; ++i) {
+        ReplayOnce();
+    }
+    const uint64_t ElapsedMs = CXPLAT_MAX(1, CxPlatTimeDiff64(StartTimeMs, CxPlatTimeMs64()));
+
+    //
+    // Give the server a moment to respond to the last datagrams.
+    //
+    CxPlatSleep(100);
+
+    printf("Sent %lld datagrams (%lld bytes) in %llu ms, %lld dropped locally.\n",
+        (long long)SentDatagrams,
+        (long long)SentBytes,
+        (unsigned long long)ElapsedMs,
+        (long long)DroppedDatagrams);
+    printf("Datagram Rate: %llu KHz\n", (unsigned long long)SentDatagrams / ElapsedMs);
+    printf("Received %lld datagrams from the server.\n", (long long)ReceivedDatagrams);
+
+    DeleteSockets();
+}
+
+int
+QUIC_MAIN_EXPORT
+main(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    int ErrorCode = -1;
+
+    TryGetValue(argc, argv, "file", &FilePath);
+    TryGetValue(argc, argv, "ip", &IpAddress);
+    TryGetValue(argc, argv, "speed", &SpeedPercent);
+    TryGetValue(argc, argv, "loops", &LoopCount);
+
+    if (FilePath == nullptr || IpAddress == nullptr) {
+        PrintUsage();
+        return ErrorCode;
+    }
+
+    if (!QuicAddrFromString(IpAddress, REPLAY_PORT_DEFAULT, &ServerAddress)) {
+        printf("Invalid -ip:'%s' specified!\n", IpAddress);
+        return ErrorCode;
+    }
+
+    if (!LoadCapture()) {
+        return ErrorCode;
+    }
+
+    const CXPLAT_UDP_DATAPATH_CALLBACKS DatapathCallbacks = {
+        UdpRecvCallback,
+        UdpUnreachCallback,
+    };
+    CxPlatSystemLoad();
+    CxPlatInitialize();
+    CXPLAT_WORKER_POOL* WorkerPool = CxPlatWorkerPoolCreate(nullptr, CXPLAT_WORKER_POOL_REF_TOOL);
+    CXPLAT_DATAPATH_INIT_CONFIG InitConfig = {0};
+    QUIC_STATUS Status =
+        CxPlatDataPathInitialize(
+            0,
+            &DatapathCallbacks,
+            NULL,
+            WorkerPool,
+            &InitConfig,
+            &Datapath);
+    if (QUIC_SUCCEEDED(Status)) {
+        RunReplay();
+        CxPlatDataPathUninitialize(Datapath);
+        ErrorCode = 0;
+    } else {
+        printf("CxPlatDataPathInitialize failed, 0x%x\n", Status);
+    }
+    CxPlatWorkerPoolDelete(WorkerPool, CXPLAT_WORKER_POOL_REF_TOOL);
+    CxPlatUninitialize();
+    CxPlatSystemUnload();
+
+    return ErrorCode;
+}
@@ -837,8 +837,9 @@ void SpinQuicSetRandomConnectionParam(HQUIC Connection, uint16_t ThreadID)
 void SpinQuicSetRandomStreamParam(HQUIC Stream, uint16_t ThreadID)
 {
     SetParamHelper Helper;
+    QUIC_STREAM_EXTENSIBLE_PRIORITY ExtensiblePriority;
 
-    switch (0x08000000 | (GetRandom(6))) {
+    switch (0x08000000 | (GetRandom(8))) {
     case QUIC_PARAM_STREAM_ID:                                      // QUIC_UINT62
         break; // Get Only
     case QUIC_PARAM_STREAM_0RTT_LENGTH:                             // QUIC_ADDR
@@ -852,6 +853,15 @@ void SpinQuicSetRandomStreamParam(HQUIC Stream, uint16_t ThreadID)
         break; // Get Only
     case QUIC_PARAM_STREAM_RELIABLE_OFFSET:
         Helper.SetUint64(QUIC_PARAM_STREAM_RELIABLE_OFFSET, (uint64_t)GetRandom(UINT64_MAX));
+        break;
+    case QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY:                     // QUIC_STREAM_EXTENSIBLE_PRIORITY
+        ExtensiblePriority.Urgency = (uint8_t)GetRandom(8);
+        ExtensiblePriority.Incremental = (BOOLEAN)GetRandom(2);
+        Helper.SetPtr(QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY, &ExtensiblePriority, sizeof(ExtensiblePriority));
+        break;
+    case QUIC_PARAM_STREAM_WEIGHT:                                  // uint16_t
+        Helper.SetUint16(QUIC_PARAM_STREAM_WEIGHT, (uint16_t)(GetRandom(UINT16_MAX) + 1));
+        break;
     default:
         break;
     }